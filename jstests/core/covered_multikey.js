@@ -106,4 +106,24 @@
     ixscanStage = getPlanStage(explainRes.queryPlanner.winningPlan, "IXSCAN");
     assert.neq(null, ixscanStage);
     assert.eq(true, ixscanStage.isMultiKey);
+
+    // Verify that a predicate which cannot be answered by index bounds alone is evaluated against
+    // the index keys when its field has no multikey components, so that the query stays covered.
+    coll.drop();
+    assert.writeOK(coll.insert({a: [1, 2], b: "foo"}));
+    assert.writeOK(coll.insert({a: [1, 3], b: "bar"}));
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    assert.eq([{b: "foo"}], coll.find({a: 1, b: /oo/}, {_id: 0, b: 1}).toArray());
+    explainRes = coll.explain("queryPlanner").find({a: 1, b: /oo/}, {_id: 0, b: 1}).finish();
+    assert(isIxscan(db, explainRes.queryPlanner.winningPlan));
+    assert(!planHasStage(db, explainRes.queryPlanner.winningPlan, "FETCH"));
+
+    // Such a predicate over a multikey field must still be evaluated against the document.
+    assert.eq([{a: [1, 2]}], coll.find({b: "foo", a: {$mod: [2, 0]}}, {_id: 0, a: 1}).toArray());
+    coll.drop();
+    assert.writeOK(coll.insert({a: 1, b: ["x", "foo"]}));
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    assert.eq([{a: 1}], coll.find({a: 1, b: /^f|oo/}, {_id: 0, a: 1}).toArray());
+    explainRes = coll.explain("queryPlanner").find({a: 1, b: /^f|oo/}, {_id: 0, a: 1}).finish();
+    assert(planHasStage(db, explainRes.queryPlanner.winningPlan, "FETCH"));
 }());
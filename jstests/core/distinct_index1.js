@@ -46,9 +46,10 @@ assert.eq(10, x.executionStats.nReturned);
 assert.lte(10, x.executionStats.totalKeysExamined);
 
 x = d("a", {a: {$gt: 5}});
-// Only 4 values of a are >= 5 and we use the fast distinct hack.
+// Only 4 values of a are >= 5 and we use the fast distinct hack. Each value has many duplicates,
+// so the 3 keys stepped over after each value don't reach the next one and we seek to it instead.
 assert.eq(4, x.executionStats.nReturned);
-assert.eq(4, x.executionStats.totalKeysExamined);
+assert.eq(16, x.executionStats.totalKeysExamined);
 assert.eq(0, x.executionStats.totalDocsExamined);
 
 x = d("b", {a: {$gt: 5}});
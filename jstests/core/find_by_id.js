@@ -0,0 +1,55 @@
+// Tests find commands on a single _id value, which mongod can answer with a direct lookup in the
+// _id index, against the results of the general query path.
+// @tags: [assumes_no_implicit_collection_creation_after_drop, requires_non_retryable_commands]
+(function() {
+    "use strict";
+
+    const coll = db.find_by_id;
+    coll.drop();
+
+    assert.writeOK(coll.insert({_id: 1, a: 1}));
+    assert.writeOK(coll.insert({_id: 2.5, a: 2}));
+    assert.writeOK(coll.insert({_id: "abc", a: 3}));
+    assert.writeOK(coll.insert({_id: {x: 1, y: 2}, a: 4}));
+    assert.writeOK(coll.insert({_id: ObjectId("5b0e3e2f1c9d440000a1b2c3"), a: 5}));
+
+    // Point lookups find the document, including through numeric type conversion.
+    assert.eq([{_id: 1, a: 1}], coll.find({_id: 1}).toArray());
+    assert.eq([{_id: 1, a: 1}], coll.find({_id: NumberLong(1)}).toArray());
+    assert.eq([{_id: 2.5, a: 2}], coll.find({_id: 2.5}).toArray());
+    assert.eq([{_id: "abc", a: 3}], coll.find({_id: "abc"}).toArray());
+    assert.eq([{_id: {x: 1, y: 2}, a: 4}], coll.find({_id: {x: 1, y: 2}}).toArray());
+    assert.eq([], coll.find({_id: {y: 2, x: 1}}).toArray());
+    assert.eq(5, coll.findOne({_id: ObjectId("5b0e3e2f1c9d440000a1b2c3")}).a);
+    assert.eq([], coll.find({_id: 3}).toArray());
+
+    // A batchSize of 0 returns an empty first batch and a cursor to fetch the document.
+    let res = assert.commandWorked(
+        db.runCommand({find: coll.getName(), filter: {_id: 1}, batchSize: 0}));
+    assert.eq(0, res.cursor.firstBatch.length);
+    assert.neq(0, res.cursor.id);
+    res = assert.commandWorked(db.runCommand({getMore: res.cursor.id, collection: coll.getName()}));
+    assert.eq([{_id: 1, a: 1}], res.cursor.nextBatch);
+
+    // Other options are honored.
+    assert.eq([{a: 1}], coll.find({_id: 1}, {_id: 0, a: 1}).toArray());
+    assert.eq([], coll.find({_id: 1}).skip(1).toArray());
+    assert.eq(1, coll.find({_id: 1}).showRecordId().next().a);
+
+    // A query which merely starts with _id isn't a point lookup.
+    assert.eq([], coll.find({_id: 1, a: 2}).toArray());
+
+    // The default collation of the collection applies to string _id values.
+    coll.drop();
+    assert.commandWorked(
+        db.createCollection(coll.getName(), {collation: {locale: "en_US", strength: 2}}));
+    assert.writeOK(coll.insert({_id: "abc", a: 1}));
+    assert.eq([{_id: "abc", a: 1}], coll.find({_id: "ABC"}).toArray());
+
+    // Finds on a view still run through the view's pipeline.
+    const view = db.find_by_id_view;
+    view.drop();
+    assert.commandWorked(db.createView(view.getName(), coll.getName(), [{$project: {a: 0}}]));
+    assert.eq([{_id: "abc"}], view.find({_id: "abc"}).toArray());
+    view.drop();
+}());
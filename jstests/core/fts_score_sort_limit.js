@@ -0,0 +1,68 @@
+// Tests that sorting $text results by score with a limit returns the same documents and scores as
+// scoring every match, while the TEXT_OR stage stops reading postings early.
+// @tags: [assumes_no_implicit_index_creation]
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    const coll = db.fts_score_sort_limit;
+    coll.drop();
+    assert.commandWorked(coll.createIndex({content: "text"}, {default_language: "none"}));
+
+    // Give each document a different mix of the query terms so that scores vary widely.
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 500; ++i) {
+        const words = [];
+        for (let j = 0; j < i % 7; ++j) {
+            words.push("apple");
+        }
+        for (let j = 0; j < i % 5; ++j) {
+            words.push("banana");
+        }
+        words.push("filler" + i, "apple");
+        bulk.insert({_id: i, content: words.join(" ")});
+    }
+    assert.writeOK(bulk.execute());
+
+    const query = {$text: {$search: "apple banana"}};
+    const proj = {score: {$meta: "textScore"}};
+    const sort = {score: {$meta: "textScore"}};
+
+    const allScores =
+        coll.find(query, proj).toArray().map(doc => doc.score).sort((a, b) => b - a);
+    assert.eq(500, allScores.length);
+
+    for (let limit of [1, 10, 50]) {
+        const topScores =
+            coll.find(query, proj).sort(sort).limit(limit).toArray().map(doc => doc.score);
+        assert.eq(allScores.slice(0, limit), topScores, "limit " + limit);
+    }
+
+    // A skip is satisfied by asking the text stage for skip + limit results.
+    const skipped =
+        coll.find(query, proj).sort(sort).skip(5).limit(5).toArray().map(doc => doc.score);
+    assert.eq(allScores.slice(5, 10), skipped);
+
+    // The limit is pushed into the TEXT_OR stage, which needs to fetch only some of the matches
+    // and returns no more than the limit.
+    const explain = coll.find(query, proj).sort(sort).limit(10).explain("executionStats");
+    const textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    if (textOr !== null) {
+        assert.eq(10, textOr.limit, tojson(textOr));
+        assert(textOr.earlyTermination, tojson(textOr));
+        assert.lt(textOr.docsExamined, 500, tojson(textOr));
+        // Documents displaced from the best 10 are released rather than returned.
+        assert.lte(textOr.nReturned, 10, tojson(textOr));
+    }
+
+    // Negations must be checked by TEXT_MATCH, so every match is scored.
+    const negated = coll.find({$text: {$search: "apple banana -filler3"}}, proj)
+                        .sort(sort)
+                        .limit(10)
+                        .explain("executionStats");
+    const negatedTextOr = getPlanStage(negated.executionStats.executionStages, "TEXT_OR");
+    if (negatedTextOr !== null) {
+        assert(!negatedTextOr.hasOwnProperty("limit"), tojson(negatedTextOr));
+    }
+})();
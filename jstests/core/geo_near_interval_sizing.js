@@ -0,0 +1,46 @@
+// Tests that near searches return results in order of distance when the search annuli are sized
+// from the density of earlier annuli, across regions of very different density, and that a query
+// with a small limit does not search the whole collection.
+(function() {
+    "use strict";
+
+    const t = db.jstests_geo_near_interval_sizing;
+    t.drop();
+
+    // A dense cluster next to the query point and a sparse spread of points further out.
+    const docs = [];
+    for (let i = 0; i < 300; i++) {
+        docs.push({_id: i, loc: {type: "Point", coordinates: [10 + i * 0.0005, 10]}});
+    }
+    for (let i = 0; i < 100; i++) {
+        docs.push({_id: 300 + i, loc: {type: "Point", coordinates: [12 + i * 0.4, 10]}});
+    }
+    assert.writeOK(t.insert(docs));
+    assert.commandWorked(t.ensureIndex({loc: "2dsphere"}));
+
+    const near = {loc: {$nearSphere: {type: "Point", coordinates: [10, 10]}}};
+
+    // Every document comes back, nearest first.
+    const all = t.find(near).toArray();
+    assert.eq(docs.length, all.length);
+    for (let i = 0; i < all.length; i++) {
+        assert.eq(i, all[i]._id, tojson(all[i]));
+    }
+
+    // The same holds when the limit reaches into the sparse region.
+    const limited = t.find(near).limit(320).toArray();
+    assert.eq(320, limited.length);
+    for (let i = 0; i < limited.length; i++) {
+        assert.eq(i, limited[i]._id, tojson(limited[i]));
+    }
+
+    // A small limit is satisfied without buffering the sparse region.
+    const explain = t.find(near).limit(5).explain("executionStats");
+    const nearStage = explain.executionStats.executionStages.inputStage;
+    assert.eq(nearStage.inputStages.length, nearStage.searchIntervals.length, tojson(nearStage));
+    let buffered = 0;
+    nearStage.searchIntervals.forEach(function(interval) {
+        buffered += interval.nBuffered;
+    });
+    assert.lt(buffered, docs.length, tojson(nearStage));
+})();
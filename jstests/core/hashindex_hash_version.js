@@ -0,0 +1,40 @@
+// Tests hashed indexes created with {hashVersion: 1}, which hash with MurmurHash3 rather than MD5.
+//
+// @tags: [assumes_no_implicit_index_creation]
+(function() {
+    "use strict";
+
+    const coll = db.hashindex_hash_version;
+    coll.drop();
+
+    assert.commandFailedWithCode(coll.createIndex({a: "hashed"}, {hashVersion: 2}),
+                                 ErrorCodes.CannotCreateIndex);
+
+    const spec = {a: "hashed"};
+    assert.commandWorked(coll.createIndex(spec, {hashVersion: 1}));
+
+    for (let i = 0; i < 20; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+    assert.writeOK(coll.insert({_id: 100, a: 3.1}));
+    assert.writeOK(coll.insert({_id: 101, a: null}));
+    assert.writeOK(coll.insert({_id: 102}));
+    assert.writeOK(coll.insert({_id: 103, a: {b: "x"}}));
+
+    // Every lookup through the index must agree with a collection scan.
+    function checkLookup(query) {
+        const expected = coll.find(query).hint({_id: 1}).sort({_id: 1}).toArray();
+        const actual = coll.find(query).hint(spec).sort({_id: 1}).toArray();
+        assert.eq(expected, actual, tojson(query));
+        return actual.length;
+    }
+
+    assert.eq(1, checkLookup({a: 3}));
+    assert.eq(1, checkLookup({a: 3.1}));
+    assert.eq(3, checkLookup({a: {$in: [5, 7, 9]}}));
+    assert.eq(2, checkLookup({a: null}));
+    assert.eq(1, checkLookup({a: {b: "x"}}));
+    assert.eq(0, checkLookup({a: 1000}));
+
+    assert.commandWorked(coll.validate(true));
+})();
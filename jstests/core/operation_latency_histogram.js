@@ -189,4 +189,24 @@
     // Test non-command.
     assert.commandFailed(testColl.runCommand("IHopeNobodyEverMakesThisACommand"));
     lastHistogram = assertHistogramDiffEq(testColl, lastHistogram, 0, 0, 0);
+
+    // Only the server-wide histograms track percentiles.
+    for (let key of ["reads", "writes", "commands"]) {
+        assert(!lastHistogram[key].hasOwnProperty("percentiles"), tojson(lastHistogram));
+    }
+
+    // Every server-wide histogram that has counted an operation reports its percentiles in
+    // increasing order.
+    const opLatencies = assert.commandWorked(testDB.serverStatus()).opLatencies;
+    for (let key of ["reads", "writes", "commands"]) {
+        if (!opLatencies || !opLatencies[key] || opLatencies[key].ops == 0) {
+            continue;
+        }
+        const percentiles = opLatencies[key].percentiles;
+        assert(percentiles, tojson(opLatencies));
+        assert.lte(percentiles.p50, percentiles.p90, tojson(percentiles));
+        assert.lte(percentiles.p90, percentiles.p99, tojson(percentiles));
+        assert.lte(percentiles.p99, percentiles.p999, tojson(percentiles));
+        assert.lte(percentiles.p999, percentiles.max, tojson(percentiles));
+    }
 }());
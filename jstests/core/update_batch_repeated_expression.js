@@ -0,0 +1,58 @@
+// Tests that the statements of an update batch which share an update expression produce the same
+// results as when each is executed on its own, including across upserts and collations.
+(function() {
+    "use strict";
+
+    const coll = db.update_batch_repeated_expression;
+    coll.drop();
+
+    assert.writeOK(coll.insert([{_id: 0, n: 0}, {_id: 1, n: 0}, {_id: 2, n: 0, s: "a"}]));
+
+    // A run of identical $inc statements, interrupted by an upsert which briefly puts the update
+    // into insert mode, must keep counting and logging every statement.
+    let res = assert.commandWorked(db.runCommand({
+        update: coll.getName(),
+        updates: [
+            {q: {_id: 0}, u: {$inc: {n: 1}}},
+            {q: {_id: 1}, u: {$inc: {n: 1}}},
+            {q: {_id: 3}, u: {$inc: {n: 1}}, upsert: true},
+            {q: {_id: 0}, u: {$inc: {n: 1}}},
+            {q: {_id: 3}, u: {$inc: {n: 1}}},
+            {q: {}, u: {$inc: {n: 1}}, multi: true},
+            {q: {_id: 1}, u: {$inc: {n: 1}}},
+        ]
+    }));
+    assert.eq(res.n, 1 + 1 + 1 + 1 + 1 + 4 + 1, tojson(res));
+    assert.eq(res.nModified, res.n - 1, tojson(res));
+    assert.eq(res.upserted, [{index: 2, _id: 3}], tojson(res));
+    assert.eq(coll.find().sort({_id: 1}).toArray(), [
+        {_id: 0, n: 3},
+        {_id: 1, n: 3},
+        {_id: 2, n: 1, s: "a"},
+        {_id: 3, n: 3},
+    ]);
+
+    // Statements with a collation or array filters are parsed on their own even when the update
+    // expression matches the preceding statement.
+    res = assert.commandWorked(db.runCommand({
+        update: coll.getName(),
+        updates: [
+            {q: {_id: 2}, u: {$max: {s: "A"}}},
+            {q: {_id: 2}, u: {$max: {s: "A"}}, collation: {locale: "en_US", strength: 2}},
+            {q: {_id: 2}, u: {$max: {s: "A"}}},
+        ]
+    }));
+    assert.eq(res.n, 3, tojson(res));
+    assert.eq(coll.findOne({_id: 2}).s, "a");
+
+    assert.writeOK(coll.insert({_id: 4, arr: [1, 2, 3]}));
+    res = assert.commandWorked(db.runCommand({
+        update: coll.getName(),
+        updates: [
+            {q: {_id: 4}, u: {$inc: {"arr.$[i]": 10}}, arrayFilters: [{i: {$gt: 1}}]},
+            {q: {_id: 4}, u: {$inc: {"arr.$[i]": 10}}, arrayFilters: [{i: {$gt: 12}}]},
+        ]
+    }));
+    assert.eq(res.nModified, 2, tojson(res));
+    assert.eq(coll.findOne({_id: 4}).arr, [1, 12, 23]);
+})();
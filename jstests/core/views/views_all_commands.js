@@ -110,6 +110,7 @@
         addShard: {skip: isUnrelated},
         addShardToZone: {skip: isUnrelated},
         aggregate: {command: {aggregate: "view", pipeline: [{$match: {}}], cursor: {}}},
+        analyze: {command: {analyze: "view"}, expectFailure: true, skipSharded: true},
         appendOplogNote: {skip: isUnrelated},
         applyOps: {
             command: {applyOps: [{op: "i", o: {_id: 1}, ns: "test.view"}]},
@@ -403,6 +404,7 @@
         planCacheSetFilter: {command: {planCacheSetFilter: "view"}, expectFailure: true},
         prepareTransaction: {skip: isUnrelated},
         profile: {skip: isUnrelated},
+        profileCpu: {skip: isUnrelated},
         refreshLogicalSessionCacheNow: {skip: isAnInternalCommand},
         reapLogicalSessionCacheNow: {skip: isAnInternalCommand},
         refreshSessions: {skip: isUnrelated},
@@ -0,0 +1,72 @@
+// Tests that an aggregation returns the same results whether or not the documents its plan fetches
+// are trimmed to the pipeline's dependencies, for pipelines depending on dotted paths, _id and
+// metadata, and for filters on fields the pipeline doesn't depend on.
+(function() {
+    "use strict";
+
+    load("jstests/aggregation/extras/utils.js");  // For arrayEq.
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const coll = db.agg_fetch_projects_to_dependencies;
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < 100; ++i) {
+        bulk.insert({
+            _id: i,
+            x: i,
+            y: i % 7,
+            z: i % 3 === 0 ? null : i,
+            a: {b: i % 5, c: "c" + (i % 4), d: [i, i + 1]},
+            arr: [{b: i}, {b: i + 1, c: i}],
+            t: i % 2 === 0 ? "even words" : "odd words",
+            padding: "x".repeat(100),
+        });
+    }
+    assert.writeOK(bulk.execute());
+
+    // The pipelines below can't be covered by these indexes, so their plans fetch the documents.
+    assert.commandWorked(coll.createIndex({x: 1}));
+    assert.commandWorked(coll.createIndex({t: "text"}));
+
+    const pipelines = [
+        [{$match: {x: {$gte: 10}}}, {$project: {"a.b": 1, y: 1}}],
+        [{$match: {x: {$gte: 10}}}, {$project: {_id: 0, "a.d": 1, "arr.b": 1}}],
+        [{$match: {x: {$lt: 50}, z: {$ne: null}}}, {$project: {_id: 0, y: 1}}],
+        [
+          {$match: {x: {$gte: 5}}},
+          {
+            $group:
+                {_id: "$a.c", count: {$sum: 1}, total: {$sum: "$a.b"}, maxId: {$max: "$_id"}}
+          }
+        ],
+        [{$match: {x: {$gte: 0}}}, {$group: {_id: {$mod: ["$_id", 10]}, y: {$sum: "$y"}}}],
+        [{$match: {x: {$gte: 90}}}, {$skip: 2}, {$limit: 5}, {$project: {"a.c": 1}}],
+        [{$match: {$or: [{x: {$lt: 5}}, {x: {$gt: 95}}]}}, {$project: {y: 1, z: 1}}],
+        [
+          {$match: {$text: {$search: "even"}}},
+          {$project: {t: 1, score: {$meta: "textScore"}}}
+        ],
+        [{$match: {x: {$gte: 10}}}, {$addFields: {sum: {$add: ["$x", "$y"]}}}],
+    ];
+
+    const setTrimming = function(enabled) {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalQueryExecProjectFetchedDocumentsToDependencies: enabled}));
+    };
+
+    for (let pipeline of pipelines) {
+        setTrimming(false);
+        const expected = coll.aggregate(pipeline).toArray();
+        setTrimming(true);
+        const actual = coll.aggregate(pipeline).toArray();
+
+        assert.gt(expected.length, 0, tojson(pipeline));
+        assert(arrayEq(expected, actual),
+               "pipeline " + tojson(pipeline) + " returned " + tojson(actual) + " instead of " +
+                   tojson(expected));
+    }
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,47 @@
+/**
+ * Tests that a capped collection created with 'cappedAsyncDeletes' is brought back under its size
+ * limit by the background capped deleter, and that the option is validated and persisted.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+
+    assert.commandFailedWithCode(db.runCommand({create: "notCapped", cappedAsyncDeletes: true}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        db.runCommand(
+            {create: "withMax", capped: true, size: 4096, max: 10, cappedAsyncDeletes: true}),
+        ErrorCodes.BadValue);
+
+    const maxSize = 64 * 1024;
+    assert.commandWorked(
+        db.runCommand({create: "capped", capped: true, size: maxSize, cappedAsyncDeletes: true}));
+
+    const infos = db.getCollectionInfos({name: "capped"});
+    assert.eq(1, infos.length, tojson(infos));
+    assert.eq(true, infos[0].options.cappedAsyncDeletes, tojson(infos));
+
+    const coll = db.capped;
+    const padding = "x".repeat(1024);
+    for (let i = 0; i < 500; i++) {
+        assert.writeOK(coll.insert({_id: i, padding: padding}));
+    }
+
+    // The background deleter eventually removes the oldest documents.
+    assert.soon(function() {
+        const stats = assert.commandWorked(coll.stats());
+        return stats.size <= maxSize;
+    }, "capped collection was not reclaimed: " + tojson(coll.stats()));
+
+    const stats = assert.commandWorked(coll.stats());
+    assert.eq(true, stats.asyncDeletes, tojson(stats));
+    assert.eq(499, coll.find().sort({$natural: -1}).limit(1).next()._id);
+    assert.eq(null, coll.findOne({_id: 0}));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,72 @@
+/**
+ * Tests that a collection created with 'clusteredIndex' stores documents keyed by their integral
+ * _id, has no separate _id index, enforces _id uniqueness and answers _id lookups with IDHACK.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");  // For isIdhack.
+    load("jstests/libs/feature_compatibility_version.js");
+
+    const conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+
+    assert.commandFailedWithCode(
+        db.runCommand({create: "cappedClustered", capped: true, size: 4096, clusteredIndex: true}),
+        ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        db.runCommand({create: "noIdIndex", autoIndexId: false, clusteredIndex: true}),
+        ErrorCodes.BadValue);
+
+    // Clustered collections can't be created until the feature compatibility version is 4.2.
+    const adminDB = conn.getDB("admin");
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: lastStableFCV}));
+    assert.commandFailedWithCode(db.runCommand({create: "clustered", clusteredIndex: true}),
+                                 ErrorCodes.InvalidOptions);
+    assert.commandWorked(adminDB.runCommand({setFeatureCompatibilityVersion: latestFCV}));
+
+    assert.commandWorked(db.runCommand({create: "clustered", clusteredIndex: true}));
+    const infos = db.getCollectionInfos({name: "clustered"});
+    assert.eq(1, infos.length, tojson(infos));
+    assert.eq(true, infos[0].options.clusteredIndex, tojson(infos));
+
+    const coll = db.clustered;
+    assert.eq(0, coll.getIndexes().length, tojson(coll.getIndexes()));
+
+    // Insert out of order; a collection scan returns documents in _id order.
+    [5, 1, 4, 2, 3].forEach(i => assert.writeOK(coll.insert({_id: i, x: i})));
+    assert.eq([1, 2, 3, 4, 5], coll.find().toArray().map(doc => doc._id));
+
+    // _id must be a positive integer and remains unique across numeric types.
+    assert.writeErrorWithCode(coll.insert({_id: NumberLong(3)}), ErrorCodes.DuplicateKey);
+    assert.writeErrorWithCode(coll.insert({_id: 3.0}), ErrorCodes.DuplicateKey);
+    assert.writeErrorWithCode(coll.insert({_id: "a"}), ErrorCodes.BadValue);
+    assert.writeErrorWithCode(coll.insert({_id: 1.5}), ErrorCodes.BadValue);
+    assert.writeErrorWithCode(coll.insert({_id: -1}), ErrorCodes.BadValue);
+    assert.eq(5, coll.find().itcount());
+
+    // Point lookups, updates and deletes by _id go straight to the record store.
+    const explain = assert.commandWorked(coll.find({_id: 4}).explain());
+    assert(isIdhack(db, explain.queryPlanner.winningPlan), tojson(explain));
+    assert.eq({_id: 4, x: 4}, coll.findOne({_id: 4}));
+    assert.eq({_id: 4, x: 4}, coll.findOne({_id: NumberLong(4)}));
+    assert.eq(null, coll.findOne({_id: 6}));
+    assert.eq(null, coll.findOne({_id: "a"}));
+
+    assert.writeOK(coll.update({_id: 2}, {$set: {x: 20}}));
+    assert.eq({_id: 2, x: 20}, coll.findOne({_id: 2}));
+    assert.writeOK(coll.update({_id: 6}, {$set: {x: 6}}, {upsert: true}));
+    assert.eq({_id: 6, x: 6}, coll.findOne({_id: 6}));
+    assert.writeOK(coll.remove({_id: 1}));
+    assert.eq(null, coll.findOne({_id: 1}));
+
+    // Other predicates are still answered by scanning the collection.
+    assert.eq([3, 4], coll.find({_id: {$gte: 3, $lt: 5}}).toArray().map(doc => doc._id));
+    assert.eq(5, coll.find().itcount());
+
+    assert.commandWorked(coll.validate(true));
+    MongoRunner.stopMongod(conn);
+})();
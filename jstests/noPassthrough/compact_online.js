@@ -0,0 +1,54 @@
+// Tests that the online mode of the compact command compacts in steps, reports what it reclaimed
+// and does not block writes to the collection while it runs.
+// @tags: [requires_wiredtiger, requires_persistence]
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const coll = testDB.compact_online;
+    coll.drop();
+
+    const bulk = coll.initializeUnorderedBulkOp();
+    const padding = 'x'.repeat(1024);
+    for (let i = 0; i < 20000; i++) {
+        bulk.insert({_id: i, x: i, padding: padding});
+    }
+    assert.commandWorked(bulk.execute());
+    assert.commandWorked(coll.createIndex({x: 1}));
+    assert.commandWorked(coll.remove({_id: {$mod: [10, 0]}}));
+
+    assert.commandFailedWithCode(coll.runCommand("compact", {online: true, stepSecs: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(coll.runCommand("compact", {online: true, pauseMillis: -1}),
+                                 ErrorCodes.BadValue);
+
+    // Writes keep going while compaction runs, since it only takes intent locks.
+    const awaitWrites = startParallelShell(function() {
+        const coll = db.getSiblingDB("test").compact_online;
+        for (let i = 20000; i < 20100; i++) {
+            assert.writeOK(coll.insert({_id: i, x: i}));
+        }
+    }, conn.port);
+
+    const res = coll.runCommand("compact", {online: true, stepSecs: 1, pauseMillis: 10});
+    assert.commandWorked(res);
+    assert.gte(res.steps, 3, tojson(res));  // At least one step for the data and one per index.
+    assert.gte(res.bytesReclaimed, 0, tojson(res));
+
+    awaitWrites();
+
+    assert.eq(3, coll.getIndexes().length);
+    assert.eq(18100, coll.find().itcount());
+    assert.eq(18100, coll.find().hint({x: 1}).itcount());
+
+    // Running it again simply continues from whatever space is left to reclaim.
+    assert.commandWorked(coll.runCommand("compact", {online: true}));
+
+    assert.commandFailedWithCode(testDB.runCommand({compact: "doesNotExist", online: true}),
+                                 ErrorCodes.NamespaceNotFound);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,61 @@
+// Tests that dbHash gives the same answer whether it hashes collections serially or in parallel,
+// and that the murmur3 hash does not depend on how large collections are split into _id ranges.
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+
+    const testDB = conn.getDB("test");
+    const adminDB = conn.getDB("admin");
+
+    for (let c = 0; c < 4; c++) {
+        const bulk = testDB["coll" + c].initializeUnorderedBulkOp();
+        for (let i = 0; i < 5000 * c; i++) {
+            bulk.insert({_id: i, x: "doc" + i});
+        }
+        if (c > 0) {
+            assert.commandWorked(bulk.execute());
+        }
+    }
+    assert.commandWorked(testDB.createCollection("capped", {capped: true, size: 4096}));
+    assert.commandWorked(testDB.capped.insert({a: 1}));
+
+    function dbHash(params, algorithm) {
+        assert.commandWorked(adminDB.runCommand(Object.merge({setParameter: 1}, params)));
+        const cmd = {dbHash: 1};
+        if (algorithm) {
+            cmd.hashAlgorithm = algorithm;
+        }
+        const res = assert.commandWorked(testDB.runCommand(cmd));
+        delete res.timeMillis;
+        delete res.operationTime;
+        delete res.$clusterTime;
+        return res;
+    }
+
+    // md5 hashes each collection on one thread, in _id order.
+    const serialMD5 = dbHash({dbHashMaxThreads: 1});
+    assert.eq(serialMD5, dbHash({dbHashMaxThreads: 4}));
+    assert(serialMD5.hasOwnProperty("md5"), tojson(serialMD5));
+
+    // murmur3 may also split the larger collections into _id ranges.
+    const serialMurmur = dbHash({dbHashMaxThreads: 1}, "murmur3");
+    assert.eq("murmur3", serialMurmur.hashAlgorithm, tojson(serialMurmur));
+    assert(!serialMurmur.hasOwnProperty("md5"), tojson(serialMurmur));
+    assert.eq(Object.keys(serialMD5.collections).sort(),
+              Object.keys(serialMurmur.collections).sort());
+    assert.eq(serialMurmur, dbHash({dbHashMaxThreads: 4, dbHashRangeSplitDocs: 1000}, "murmur3"));
+    assert.eq(serialMurmur, dbHash({dbHashMaxThreads: 8, dbHashRangeSplitDocs: 2000}, "murmur3"));
+
+    // A changed document changes the hash of its collection only.
+    assert.commandWorked(testDB.coll3.update({_id: 7777}, {$set: {x: "changed"}}));
+    const changed = dbHash({dbHashMaxThreads: 4, dbHashRangeSplitDocs: 1000}, "murmur3");
+    assert.neq(serialMurmur.hash, changed.hash);
+    assert.neq(serialMurmur.collections.coll3, changed.collections.coll3);
+    assert.eq(serialMurmur.collections.coll2, changed.collections.coll2);
+
+    assert.commandFailed(testDB.runCommand({dbHash: 1, hashAlgorithm: "sha1"}));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,48 @@
+// Tests that the plan cache snapshot job persists the active plan cache entries to
+// config.planCacheSnapshot and restores them into the plan cache after a restart.
+(function() {
+    "use strict";
+
+    const dbName = "plan_cache_snapshot_restart";
+    const options = {
+        setParameter: {planCacheSnapshotEnabled: true, planCacheSnapshotIntervalSecs: 1}
+    };
+
+    let conn = MongoRunner.runMongod(options);
+    assert.neq(null, conn, "mongod was unable to start up");
+    let coll = conn.getDB(dbName).test;
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({a: i, b: i % 10}));
+    }
+
+    // Running the query twice creates an active plan cache entry for its shape.
+    const query = {a: {$gte: 50}, b: 5};
+    assert.eq(5, coll.find(query).itcount());
+    assert.eq(5, coll.find(query).itcount());
+
+    function shapeIsCached(coll) {
+        const res = assert.commandWorked(coll.runCommand("planCacheListQueryShapes"));
+        return res.shapes.some(shape => bsonWoCompare(shape.query, query) === 0);
+    }
+    assert(shapeIsCached(coll));
+
+    const snapshotColl = conn.getDB("config").planCacheSnapshot;
+    assert.soon(() => snapshotColl.find({ns: coll.getFullName()}).itcount() === 1,
+                () => "plan cache snapshot not written: " + tojson(snapshotColl.find().toArray()));
+
+    const dbpath = conn.dbpath;
+    MongoRunner.stopMongod(conn);
+
+    conn = MongoRunner.runMongod(Object.merge(options, {dbpath: dbpath, noCleanData: true}));
+    assert.neq(null, conn, "mongod was unable to restart");
+    coll = conn.getDB(dbName).test;
+
+    // The shape is restored without running the query against the restarted node.
+    assert.soon(() => shapeIsCached(coll), "plan cache entry not restored after restart");
+    assert.eq(1, conn.getDB("admin").serverStatus().metrics.planCacheSnapshot.shapesRehydrated);
+
+    MongoRunner.stopMongod(conn);
+})();
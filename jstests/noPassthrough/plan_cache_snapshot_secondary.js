@@ -0,0 +1,55 @@
+// Tests that a secondary restores the query shapes of the plan cache snapshot replicated from its
+// primary, and does not re-plan a shape it has already restored on the following passes.
+(function() {
+    "use strict";
+
+    const rst = new ReplSetTest({
+        nodes: [{}, {rsConfig: {priority: 0}}],
+        nodeOptions: {
+            setParameter: {planCacheSnapshotEnabled: true, planCacheSnapshotIntervalSecs: 1}
+        }
+    });
+    rst.startSet();
+    rst.initiate();
+
+    const primaryDB = rst.getPrimary().getDB("plan_cache_snapshot_secondary");
+    const secondary = rst.getSecondary();
+    const secondaryColl = secondary.getDB(primaryDB.getName()).test;
+    secondaryColl.getMongo().setSlaveOk();
+
+    const coll = primaryDB.test;
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({a: i, b: i % 10}));
+    }
+
+    const query = {a: {$gte: 50}, b: 5};
+    assert.eq(5, coll.find(query).itcount());
+    assert.eq(5, coll.find(query).itcount());
+
+    function shapeIsCached(coll) {
+        const res = assert.commandWorked(coll.runCommand("planCacheListQueryShapes"));
+        return res.shapes.some(shape => bsonWoCompare(shape.query, query) === 0);
+    }
+
+    function getMetrics() {
+        return assert.commandWorked(secondary.adminCommand({serverStatus: 1}))
+            .metrics.planCacheSnapshot;
+    }
+
+    // The secondary restores the shape from the replicated snapshot.
+    assert.soon(() => shapeIsCached(secondaryColl), "plan cache entry not restored on secondary");
+    const rehydrated = getMetrics().shapesRehydrated;
+    assert.eq(1, rehydrated);
+
+    // Once restored, the entry belongs to the secondary's plan cache: clearing it must not make
+    // the following passes plan the shape again, even though the primary keeps publishing it.
+    assert.commandWorked(secondaryColl.runCommand("planCacheClear"));
+    const passes = getMetrics().passes;
+    assert.soon(() => getMetrics().passes >= passes + 3, "plan cache snapshot job did not run");
+    assert.eq(rehydrated, getMetrics().shapesRehydrated);
+    assert(!shapeIsCached(secondaryColl));
+
+    rst.stopSet();
+})();
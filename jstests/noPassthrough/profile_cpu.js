@@ -0,0 +1,65 @@
+/**
+ * Tests the profileCpu command, which samples the stacks of the threads using the CPU.
+ */
+(function() {
+    'use strict';
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod was unable to start up");
+    const admin = conn.getDB("admin");
+    const testDB = conn.getDB("test");
+
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(testDB.coll.insert({_id: i, x: i}));
+    }
+
+    // Keep the server busy while the profile runs.
+    const awaitShell = startParallelShell(function() {
+        const deadline = Date.now() + 3000;
+        while (Date.now() < deadline) {
+            db.getSiblingDB("test").coll.find({x: {$gte: 0}}).sort({x: -1}).itcount();
+        }
+    }, conn.port);
+
+    let res = assert.commandWorked(
+        admin.runCommand({profileCpu: 1, durationMillis: 1000, samplesPerSecond: 1000}));
+    assert.gt(res.samples, 0, tojson(res));
+    assert.eq(false, res.truncated, tojson(res));
+    assert.gt(res.stacks.length, 0, tojson(res));
+
+    let previousCount = Infinity;
+    let totalCount = 0;
+    res.stacks.forEach(function(stack) {
+        assert.eq("string", typeof stack.stack, tojson(stack));
+        assert.gt(stack.count, 0, tojson(stack));
+        assert.lte(stack.count, previousCount, "stacks should be sorted by count");
+        previousCount = stack.count;
+        totalCount += stack.count;
+    });
+    assert.eq(res.samples, totalCount, tojson(res));
+
+    // The profile can also be written to the diagnostic data directory.
+    res = assert.commandWorked(
+        admin.runCommand({profileCpu: 1, durationMillis: 500, writeToDiagnosticDirectory: true}));
+    assert(res.hasOwnProperty("file"), tojson(res));
+    const dbPath = assert.commandWorked(admin.runCommand("getCmdLineOpts")).parsed.storage.dbPath;
+    const files = listFiles(dbPath + "/diagnostic.data");
+    assert(files.some((file) => res.file.endsWith("/" + file.baseName)), tojson(files));
+
+    awaitShell();
+
+    // Invalid arguments.
+    assert.commandFailedWithCode(admin.runCommand({profileCpu: 1, durationMillis: 0}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(admin.runCommand({profileCpu: 1, samplesPerSecond: 100000}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        admin.runCommand({profileCpu: 1, writeToDiagnosticDirectory: "yes"}),
+        ErrorCodes.TypeMismatch);
+
+    // Must be run against the admin database.
+    assert.commandFailedWithCode(testDB.runCommand({profileCpu: 1, durationMillis: 10}),
+                                 ErrorCodes.Unauthorized);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,64 @@
+/**
+ * Tests for the $queryStats aggregation metadata source.
+ */
+(function() {
+    "use strict";
+
+    const conn = MongoRunner.runMongod();
+    assert.neq(null, conn, "mongod failed to start up");
+
+    const testDb = conn.getDB("test");
+    const coll = testDb.query_stats_agg_source;
+    coll.drop();
+
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.writeOK(coll.insert([{a: 1, b: 1}, {a: 2, b: 1}, {a: 3, b: 2}]));
+
+    // Nothing has been queried yet.
+    assert.eq(0, coll.aggregate([{$queryStats: {}}]).itcount());
+
+    // Run one shape three times with different constants, and a second shape once.
+    for (let i = 1; i <= 3; ++i) {
+        assert.eq(1, coll.find({a: i}).itcount());
+    }
+    assert.eq(2, coll.find({b: 1}).itcount());
+
+    let stats = coll.aggregate([{$queryStats: {}}, {$sort: {count: -1}}]).toArray();
+    assert.eq(2, stats.length, tojson(stats));
+
+    assert.eq(coll.getFullName(), stats[0].ns, tojson(stats));
+    assert.eq(3, stats[0].count, tojson(stats));
+    assert.eq("IXSCAN { a: 1 }", stats[0].planSummary, tojson(stats));
+    assert.gte(stats[0].keysExamined, 3, tojson(stats));
+    assert.eq(3, stats[0].nreturned, tojson(stats));
+    assert.gte(stats[0].durationMicros.max, stats[0].durationMicros.p50, tojson(stats));
+
+    assert.eq(1, stats[1].count, tojson(stats));
+    assert.eq("COLLSCAN", stats[1].planSummary, tojson(stats));
+    assert.eq(3, stats[1].docsExamined, tojson(stats));
+    assert.eq(2, stats[1].nreturned, tojson(stats));
+
+    // The stage only takes an empty specification and must be the first stage.
+    assert.commandFailedWithCode(
+        testDb.runCommand(
+            {aggregate: coll.getName(), pipeline: [{$queryStats: {a: 1}}], cursor: {}}),
+        ErrorCodes.FailedToParse);
+    assert.commandFailedWithCode(
+        testDb.runCommand(
+            {aggregate: coll.getName(), pipeline: [{$match: {}}, {$queryStats: {}}], cursor: {}}),
+        40602);
+
+    // The shape is identified by the hash explain reports for it. Explaining runs the planner, so
+    // it counts as one more execution of the shape.
+    assert.eq(coll.find({a: 1}).explain().queryPlanner.queryHash, stats[0].queryHash);
+    stats = coll.aggregate([{$queryStats: {}}, {$sort: {count: -1}}]).toArray();
+    const countBeforeDisabling = stats[0].count;
+
+    // Setting the maximum number of shapes to zero turns recording off.
+    assert.commandWorked(testDb.adminCommand({setParameter: 1, queryStatsMaxShapes: 0}));
+    assert.eq(1, coll.find({a: 1}).itcount());
+    stats = coll.aggregate([{$queryStats: {}}, {$sort: {count: -1}}]).toArray();
+    assert.eq(countBeforeDisabling, stats[0].count, tojson(stats));
+
+    MongoRunner.stopMongod(conn);
+}());
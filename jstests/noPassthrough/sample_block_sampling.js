@@ -0,0 +1,82 @@
+/**
+ * Tests that block sampling for an optimized $sample is off by default, and that once enabled it
+ * returns the requested number of distinct documents, read in runs of neighbouring records.
+ *
+ * @tags: [requires_wiredtiger]
+ */
+(function() {
+    "use strict";
+
+    const blockSize = 16;
+    const conn = MongoRunner.runMongod({
+        setParameter: {
+            internalDocumentSourceSampleBlockSize: blockSize,
+            internalDocumentSourceSampleMinSizeForBlockSampling: 10
+        }
+    });
+    assert.neq(null, conn, "mongod was unable to start up");
+    const db = conn.getDB("test");
+    const coll = db.sample_block_sampling;
+
+    const nDocs = 5000;
+    const bulk = coll.initializeUnorderedBulkOp();
+    for (let i = 0; i < nDocs; i++) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Small enough for the random cursor to be used rather than a random sort.
+    const sampleSize = 200;
+
+    // Returns the number of results whose _id directly follows the _id of the previous result.
+    function countConsecutive(results) {
+        let consecutive = 0;
+        for (let i = 1; i < results.length; i++) {
+            if (results[i]._id === results[i - 1]._id + 1) {
+                consecutive++;
+            }
+        }
+        return consecutive;
+    }
+
+    const cumulativeSeenIds = {};
+    let totalConsecutive = 0;
+    for (let i = 0; i < nDocs / sampleSize; i++) {
+        const results = coll.aggregate([{$sample: {size: sampleSize}}]).toArray();
+        assert.eq(sampleSize, results.length, tojson(results));
+
+        const idsThisSample = {};
+        results.forEach(function(result) {
+            assert.gte(result._id, 0, tojson(result));
+            assert.lt(result._id, nDocs, tojson(result));
+            assert(!idsThisSample[result._id], "duplicate document in sample: " + result._id);
+            idsThisSample[result._id] = true;
+            cumulativeSeenIds[result._id] = true;
+        });
+        totalConsecutive += countConsecutive(results);
+    }
+
+    // Most results continue a block.
+    assert.gt(totalConsecutive, nDocs / 2, "$sample did not read blocks of documents");
+
+    // The block starts are still random, so repeated samples cover much of the collection.
+    assert.gte(Object.keys(cumulativeSeenIds).length, nDocs / 4);
+
+    // Block sampling is opt-in.
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalDocumentSourceSampleBlockSize: 1}));
+    const results = coll.aggregate([{$sample: {size: sampleSize}}]).toArray();
+    assert.eq(sampleSize, results.length, tojson(results));
+    assert.lt(countConsecutive(results), blockSize, tojson(results));
+
+    MongoRunner.stopMongod(conn);
+
+    const defaultConn = MongoRunner.runMongod({});
+    assert.neq(null, defaultConn, "mongod was unable to start up");
+    assert.eq(1,
+              assert
+                  .commandWorked(defaultConn.adminCommand(
+                      {getParameter: 1, internalDocumentSourceSampleBlockSize: 1}))
+                  .internalDocumentSourceSampleBlockSize);
+    MongoRunner.stopMongod(defaultConn);
+})();
@@ -0,0 +1,60 @@
+// Tests that the TTL monitor spreads the deletes of a TTL index over several passes when it is
+// limited by ttlMonitorMaxDeletesPerIndexPerPass, processes several indexes concurrently, and
+// reports per-index statistics in serverStatus.
+(function() {
+    "use strict";
+
+    const maxDeletes = 10;
+    const runner = MongoRunner.runMongod({
+        setParameter: {
+            ttlMonitorSleepSecs: 1,
+            ttlMonitorThreads: 4,
+            ttlMonitorMaxDeletesPerIndexPerPass: maxDeletes
+        }
+    });
+    const db = runner.getDB("test");
+
+    // Pause the TTL monitor while setting up, by making it skip its passes.
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: false}));
+
+    const numColls = 6;
+    const numDocs = 35;
+    const expired = new Date(0);
+    for (let i = 0; i < numColls; ++i) {
+        const coll = db["ttl_pass_budgets_" + i];
+        assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let j = 0; j < numDocs; ++j) {
+            bulk.insert({x: expired});
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: true}));
+
+    // Each pass deletes at most 'maxDeletes' documents per index, so emptying the collections
+    // takes several passes.
+    assert.soon(function() {
+        for (let i = 0; i < numColls; ++i) {
+            if (db["ttl_pass_budgets_" + i].find().itcount() !== 0) {
+                return false;
+            }
+        }
+        return true;
+    }, "TTL monitor didn't delete the expired documents before timing out.");
+
+    const stats = assert.commandWorked(db.serverStatus({ttl: 1})).ttl;
+    assert.eq(numColls, stats.indexes.length, tojson(stats));
+    stats.indexes.forEach(function(index) {
+        assert.eq("x_1", index.name, tojson(index));
+        assert.lte(index.deletedLastPass, maxDeletes, tojson(index));
+    });
+
+    assert.gte(db.serverStatus().metrics.ttl.deletedDocuments, numColls * numDocs);
+
+    // Emptying a collection takes at least Math.ceil(numDocs / maxDeletes) passes.
+    assert.gte(db.serverStatus().metrics.ttl.passes, Math.ceil(numDocs / maxDeletes));
+
+    MongoRunner.stopMongod(runner);
+})();
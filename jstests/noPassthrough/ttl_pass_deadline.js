@@ -0,0 +1,53 @@
+// Tests that a TTL pass stops at ttlMonitorMaxPassTimeMS, reports that it ran out of time in
+// serverStatus, and that later passes still delete all the expired documents.
+(function() {
+    "use strict";
+
+    const runner = MongoRunner.runMongod({
+        setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorThreads: 2, ttlMonitorMaxPassTimeMS: 1}
+    });
+    const db = runner.getDB("test");
+
+    // Pause the TTL monitor while setting up, by making it skip its passes.
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: false}));
+
+    const numColls = 4;
+    const numDocs = 5000;
+    const expired = new Date(0);
+    for (let i = 0; i < numColls; ++i) {
+        const coll = db["ttl_pass_deadline_" + i];
+        assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 0}));
+
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let j = 0; j < numDocs; ++j) {
+            bulk.insert({x: expired});
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    const countDocs = function() {
+        let count = 0;
+        for (let i = 0; i < numColls; ++i) {
+            count += db["ttl_pass_deadline_" + i].find().itcount();
+        }
+        return count;
+    };
+
+    // Let one pass run. Deleting every document takes far longer than the 1ms it is allowed.
+    const passes = db.serverStatus().metrics.ttl.passes;
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: true}));
+    assert.soon(() => db.serverStatus().metrics.ttl.passes > passes);
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: false}));
+
+    assert.gt(countDocs(), 0);
+    const stats = assert.commandWorked(db.serverStatus({ttl: 1})).ttl;
+    assert(stats.indexes.some((index) => index.budgetExhausted), tojson(stats));
+
+    // Every pass runs out of time, but starts where the last one stopped, so the expired
+    // documents of every index are eventually deleted.
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorEnabled: true}));
+    assert.soon(() => countDocs() === 0,
+                "TTL monitor didn't delete the expired documents before timing out.");
+
+    MongoRunner.stopMongod(runner);
+})();
@@ -0,0 +1,47 @@
+// Tests validating a collection with { background: true }, on a standalone and on a replica set
+// member, where the indexes are traversed concurrently from a timestamped snapshot.
+// @tags: [requires_replication]
+(function() {
+    "use strict";
+
+    const count = 1000;
+
+    function testValidateBackground(db) {
+        const coll = db.validate_background;
+        coll.drop();
+
+        const bulk = coll.initializeUnorderedBulkOp();
+        for (let i = 0; i < count; ++i) {
+            bulk.insert({a: i, b: [i, i + count], c: i % 10});
+        }
+        assert.writeOK(bulk.execute());
+        assert.commandWorked(coll.createIndex({a: 1}));
+        assert.commandWorked(coll.createIndex({b: 1}));
+        assert.commandWorked(coll.createIndex({c: 1, a: -1}));
+
+        for (let threads of[1, 4]) {
+            assert.commandWorked(
+                db.adminCommand({setParameter: 1, maxValidateIndexThreads: threads}));
+
+            const res = assert.commandWorked(coll.validate({background: true}));
+            assert(res.valid, tojson(res));
+            assert.eq(count, res.nrecords, tojson(res));
+            assert.eq(4, res.nIndexes, tojson(res));
+            assert.eq(count, res.keysPerIndex[coll.getFullName() + ".$a_1"], tojson(res));
+            assert.eq(2 * count, res.keysPerIndex[coll.getFullName() + ".$b_1"], tojson(res));
+        }
+
+        assert.commandFailedWithCode(coll.validate({background: true, full: true}),
+                                     ErrorCodes.InvalidOptions);
+    }
+
+    const conn = MongoRunner.runMongod();
+    testValidateBackground(conn.getDB("test"));
+    MongoRunner.stopMongod(conn);
+
+    const rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+    testValidateBackground(rst.getPrimary().getDB("test"));
+    rst.stopSet();
+})();
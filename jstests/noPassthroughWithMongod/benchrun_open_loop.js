@@ -0,0 +1,56 @@
+/**
+ * Tests benchRun's open-loop mode, warm-up period and per-operation latency percentiles.
+ */
+(function() {
+    "use strict";
+
+    const coll = db.benchrun_open_loop;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 1, x: 0}));
+
+    const ops = [
+        {op: "findOne", ns: coll.getFullName(), query: {_id: 1}},
+        {op: "update", ns: coll.getFullName(), query: {_id: 1}, update: {$inc: {x: 1}}},
+    ];
+
+    function checkLatencies(res, opName) {
+        const latencies = res.opLatencyMicros[opName];
+        assert(latencies, () => "no latencies for " + opName + ": " + tojson(res));
+        assert.gt(latencies.count, 0, () => tojson(res));
+        assert.lte(latencies.p50, latencies.p90, () => tojson(res));
+        assert.lte(latencies.p90, latencies.p99, () => tojson(res));
+        assert.lte(latencies.p99, latencies.p999, () => tojson(res));
+        assert.lte(latencies.p999, latencies.max, () => tojson(res));
+    }
+
+    // Closed-loop runs report percentiles as well.
+    let res = benchRun({ops: ops, parallel: 2, seconds: 2, host: db.getMongo().host});
+    checkLatencies(res, "findOne");
+    checkLatencies(res, "update");
+    assert(!res.hasOwnProperty("targetOpsPerSecond"), tojson(res));
+
+    // An open-loop run holds the requested rate, which is far below what the server can serve.
+    const opsPerSecond = 100;
+    const seconds = 4;
+    res = benchRun({
+        ops: ops,
+        parallel: 2,
+        seconds: seconds,
+        warmupSeconds: 1,
+        opsPerSecond: opsPerSecond,
+        host: db.getMongo().host
+    });
+    assert.eq(opsPerSecond, res.targetOpsPerSecond, tojson(res));
+    checkLatencies(res, "findOne");
+    checkLatencies(res, "update");
+
+    const opsMeasured = res.opLatencyMicros.findOne.count + res.opLatencyMicros.update.count;
+    assert.lte(opsMeasured, opsPerSecond * seconds * 1.2, tojson(res));
+    assert.gte(opsMeasured, opsPerSecond * seconds * 0.5, tojson(res));
+
+    // The workers run during the warm-up period, but the updates they make then aren't measured.
+    assert.gt(coll.findOne({_id: 1}).x, res.opLatencyMicros.update.count, tojson(res));
+
+    assert.throws(() => benchRun({ops: ops, opsPerSecond: -1, host: db.getMongo().host}));
+    assert.throws(() => benchRun({ops: ops, warmupSeconds: -1, host: db.getMongo().host}));
+})();
@@ -0,0 +1,48 @@
+// Tests the "hardwareCounters" explain verbosity, which reports the hardware performance counters
+// of executing the winning plan on top of the "allPlansExecution" output.
+(function() {
+    'use strict';
+
+    const coll = db.explain_hardware_counters;
+    coll.drop();
+    for (let i = 0; i < 100; ++i) {
+        assert.writeOK(coll.insert({a: i, b: i % 10}));
+    }
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({b: 1}));
+
+    function checkCounters(explain) {
+        assert(explain.hasOwnProperty("hardwareCounters"), tojson(explain));
+        const counters = explain.hardwareCounters;
+
+        // The counters are disabled unless hardwareCountersEnabled is set, and most virtual
+        // machines do not expose them, in which case we only get the reason.
+        if (counters.hasOwnProperty("errorMessage")) {
+            assert.eq("string", typeof counters.errorMessage, tojson(counters));
+            return;
+        }
+        assert.gt(counters.instructions, 0, tojson(counters));
+        assert.gt(counters.cycles, 0, tojson(counters));
+        assert.gte(counters.cacheMisses, 0, tojson(counters));
+        assert.gte(counters.branchMisses, 0, tojson(counters));
+        assert.gt(counters.instructionsPerCycle, 0, tojson(counters));
+    }
+
+    let explain = coll.find({a: {$gte: 10}, b: 5}).explain("hardwareCounters");
+    assert.commandWorked(explain);
+    checkCounters(explain);
+
+    // Everything at the allPlansExecution verbosity is still reported.
+    assert(explain.executionStats.hasOwnProperty("allPlansExecution"), tojson(explain));
+    assert.eq(9, explain.executionStats.nReturned, tojson(explain));
+
+    explain = assert.commandWorked(coll.explain("hardwareCounters").count({b: 5}));
+    checkCounters(explain);
+
+    explain = assert.commandWorked(coll.explain("hardwareCounters").distinct("a", {b: 5}));
+    checkCounters(explain);
+
+    // The counters are only measured at this verbosity.
+    explain = assert.commandWorked(coll.find({b: 5}).explain("allPlansExecution"));
+    assert(!explain.hasOwnProperty("hardwareCounters"), tojson(explain));
+})();
@@ -27,9 +27,9 @@
  *    then also delete it in the license file.
  */
 
+#include <boost/container/small_vector.hpp>
 #include <cstring>
 #include <limits>
-#include <vector>
 
 #include "mongo/base/data_view.h"
 #include "mongo/bson/bson_depth.h"
@@ -37,6 +37,7 @@
 #include "mongo/bson/oid.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/platform/bits.h"
 #include "mongo/platform/decimal128.h"
 
 namespace mongo {
@@ -89,10 +90,9 @@ public:
      * reading, if it exists. Otherwise, it should be empty.
      */
     Status readCString(StringData elemName, StringData* out) {
-        const void* x = memchr(_buffer + _position, 0, _maxLength - _position);
-        if (!x)
+        uint64_t len = findNul();
+        if (len == kNotFound)
             return makeError("no end of c-string", _idElem, elemName);
-        uint64_t len = static_cast<uint64_t>(static_cast<const char*>(x) - (_buffer + _position));
 
         StringData data(_buffer + _position, len);
         _position += len + 1;
@@ -160,6 +160,36 @@ public:
     }
 
 private:
+    static constexpr uint64_t kNotFound = std::numeric_limits<uint64_t>::max();
+
+    /**
+     * Returns the distance from the current position to the next NUL byte in the buffer, or
+     * kNotFound if there is none. Field names are usually shorter than eight bytes, so the first
+     * word is tested for a zero byte in registers before falling back to memchr, whose fixed
+     * per-call cost dominates such short scans.
+     */
+    uint64_t findNul() const {
+        const char* start = _buffer + _position;
+        const uint64_t remaining = _maxLength - _position;
+        uint64_t scanned = 0;
+
+        if (remaining >= sizeof(uint64_t)) {
+            const uint64_t word = ConstDataView(start).read<LittleEndian<uint64_t>>();
+            // Sets the high bit of each zero byte. Bits above the first zero byte may be set
+            // spuriously by the borrow, but the lowest set bit always marks the first zero byte.
+            const uint64_t zeroBytes =
+                (word - 0x0101010101010101ULL) & ~word & 0x8080808080808080ULL;
+            if (zeroBytes)
+                return countTrailingZeros64(zeroBytes) / 8;
+            scanned = sizeof(uint64_t);
+        }
+
+        const void* x = memchr(start + scanned, 0, remaining - scanned);
+        if (!x)
+            return kNotFound;
+        return static_cast<uint64_t>(static_cast<const char*>(x) - start);
+    }
+
     const char* _buffer;
     uint64_t _position;
     uint64_t _maxLength;
@@ -308,8 +338,9 @@ Status validateElementInfo(Buffer* buffer,
 }
 
 Status validateBSONIterative(Buffer* buffer) {
-    std::vector<ValidationObjectFrame> frames;
-    frames.reserve(16);
+    // Almost all documents nest far less deeply than this, so validation normally completes
+    // without allocating.
+    boost::container::small_vector<ValidationObjectFrame, 32> frames;
     ValidationObjectFrame* curr = NULL;
     ValidationState::State state = ValidationState::BeginObj;
 
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/base/status.h"
+#include "mongo/bson/bson_validate.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Builds a flat document resembling a typical insert, with 'numFields' fields of mixed types.
+BSONObj makeFlatDocument(int numFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < numFields; ++i) {
+        const std::string fieldName = str::stream() << "field" << i;
+        switch (i % 4) {
+            case 0:
+                bob.append(fieldName, i);
+                break;
+            case 1:
+                bob.append(fieldName, static_cast<double>(i));
+                break;
+            case 2:
+                bob.append(fieldName, "a short string value");
+                break;
+            default:
+                bob.append(fieldName, static_cast<long long>(i));
+        }
+    }
+    return bob.obj();
+}
+
+// Builds a document whose subdocuments are nested 'depth' levels deep.
+BSONObj makeNestedDocument(int depth) {
+    BSONObj obj = BSON("leaf" << 1);
+    for (int i = 0; i < depth; ++i) {
+        obj = BSON("level" << obj << "value" << i);
+    }
+    return obj;
+}
+
+}  // namespace
+
+void BM_validateFlat(benchmark::State& state) {
+    const BSONObj obj = makeFlatDocument(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+BENCHMARK(BM_validateFlat)->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
+void BM_validateNested(benchmark::State& state) {
+    const BSONObj obj = makeNestedDocument(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validateBSON(obj.objdata(), obj.objsize(), BSONVersion::kLatest));
+    }
+    state.SetBytesProcessed(state.iterations() * obj.objsize());
+}
+
+BENCHMARK(BM_validateNested)->Arg(1)->Arg(16)->Arg(64);
+
+}  // namespace mongo
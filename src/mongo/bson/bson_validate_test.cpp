@@ -333,6 +333,30 @@ TEST(BSONValidateFast, StringHasSomething) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
 }
 
+TEST(BSONValidateFast, FieldNamesOfEveryShortLength) {
+    for (size_t len = 0; len < 24; ++len) {
+        const std::string fieldName(len, 'a');
+        const BSONObj x = BSON(fieldName << 1 << "b" << fieldName);
+        ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
+    }
+}
+
+TEST(BSONValidateFast, FieldNameEndingPastMaxLength) {
+    const BSONObj x = BSON("abcdefghijklmnop" << 1);
+    // Every prefix stops inside or just after the field name, before its terminating NUL.
+    for (int maxLength = 5; maxLength <= 4 + 1 + 16; ++maxLength) {
+        ASSERT_NOT_OK(validateBSON(x.objdata(), maxLength, BSONVersion::kLatest));
+    }
+}
+
+TEST(BSONValidateFast, DeeplyNestedObject) {
+    BSONObj x = BSON("x" << 1);
+    for (int i = 0; i < 100; ++i) {
+        x = BSON("a" << x << "b" << BSON_ARRAY(i));
+    }
+    ASSERT_OK(validateBSON(x.objdata(), x.objsize(), BSONVersion::kLatest));
+}
+
 TEST(BSONValidateBool, BoolValuesAreValidated) {
     BSONObjBuilder bob;
     bob.append("x", false);
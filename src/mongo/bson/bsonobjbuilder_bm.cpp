@@ -49,4 +49,27 @@ void BM_arrayBuilder(benchmark::State& state) {
 
 BENCHMARK(BM_arrayBuilder)->Ranges({{{1}, {100'000}}});
 
+// Builds a cursor-style reply holding 'state.range(0)' documents of about 1KB, the way find and
+// getMore replies are built. Large buffers released by one iteration are reused by the next.
+void BM_largeReplyBuilder(benchmark::State& state) {
+    const std::string payload(1000, 'x');
+    const BSONObj doc = BSON("_id" << 1 << "payload" << payload);
+    size_t totalBytes = 0;
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        BSONObjBuilder reply;
+        {
+            BSONObjBuilder cursor(reply.subobjStart("cursor"));
+            BSONArrayBuilder batch(cursor.subarrayStart("firstBatch"));
+            for (auto j = 0; j < state.range(0); j++)
+                batch.append(doc);
+        }
+        totalBytes += reply.len();
+        benchmark::DoNotOptimize(reply.done());
+    }
+    state.SetBytesProcessed(totalBytes);
+}
+
+BENCHMARK(BM_largeReplyBuilder)->Arg(16)->Arg(1024)->Arg(15 * 1024);
+
 }  // namespace mongo
@@ -1099,6 +1099,16 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
     if (_input >= _input_end) {
         return parseError("Unexpected end of input");
     }
+
+    // Quoted strings and regexes end at a single terminal character and accept anything else, so
+    // runs of characters which are neither the terminal, a backslash nor a control character can
+    // be copied into 'result' at once instead of one at a time.
+    const bool singleTerminal =
+        allowedSet == NULL && terminalSet[0] != '\0' && terminalSet[1] == '\0';
+    const auto isPlainChar = [terminal = terminalSet[0]](char c) {
+        return static_cast<unsigned char>(c) > 0x1F && c != '\\' && c != terminal;
+    };
+
     const char* q = _input;
     while (q < _input_end && !match(*q, terminalSet)) {
         MONGO_JSON_DEBUG("q: " << q);
@@ -1183,6 +1193,13 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
                     // TODO: check for escaped control characters
             }
             ++q;
+        } else if (singleTerminal) {
+            const char* runEnd = q + 1;
+            while (runEnd < _input_end && isPlainChar(*runEnd)) {
+                ++runEnd;
+            }
+            result->append(q, runEnd);
+            q = runEnd;
         } else {
             result->push_back(*q++);
         }
@@ -1119,8 +1119,77 @@ private:
     // Queue of damage events and status bit for whether  in-place updates are possible.
     DamageVector _damages;
     Document::InPlaceMode _inPlaceMode;
+
+public:
+    // Returns true if this implementation has not grown so large that keeping it around for
+    // reuse would pin an unreasonable amount of memory.
+    bool isWorthRecycling() const {
+        const size_t kMaxRecycledSlowReps = 1024;
+        const size_t kMaxRecycledFieldNameBytes = 16 * 1024;
+        const int kMaxRecycledLeafBytes = 64 * 1024;
+        return _slowElements.capacity() <= kMaxRecycledSlowReps &&
+            _fieldNames.capacity() <= kMaxRecycledFieldNameBytes &&
+            _leafBuf.getSize() <= kMaxRecycledLeafBytes;
+    }
 };
 
+namespace {
+// The implementation cache is a function-local thread_local, so it may already be gone when a
+// Document is destroyed by another thread_local destructor. This flag has no destructor, so it
+// stays readable until the thread's storage is gone.
+thread_local bool implCacheDestroyed = false;
+}  // namespace
+
+class Document::ImplCache {
+public:
+    ~ImplCache() {
+        for (size_t i = 0; i < _size; ++i)
+            delete _impls[i];
+        implCacheDestroyed = true;
+    }
+
+    static Impl* make(Document::InPlaceMode inPlaceMode) {
+        if (!implCacheDestroyed) {
+            ImplCache& cache = get();
+            if (cache._size > 0) {
+                Impl* impl = cache._impls[--cache._size];
+                impl->reset(inPlaceMode);
+                return impl;
+            }
+        }
+        return new Impl(inPlaceMode);
+    }
+
+    static void recycle(Impl* impl) {
+        if (!implCacheDestroyed && impl->isWorthRecycling()) {
+            ImplCache& cache = get();
+            if (cache._size < kMaxCachedImpls) {
+                // Drop the references to any BSONObj buffers the Document was built from now,
+                // rather than when the implementation is next handed out.
+                impl->reset(Document::kInPlaceDisabled);
+                cache._impls[cache._size++] = impl;
+                return;
+            }
+        }
+        delete impl;
+    }
+
+private:
+    static const size_t kMaxCachedImpls = 4;
+
+    static ImplCache& get() {
+        thread_local ImplCache cache;
+        return cache;
+    }
+
+    Impl* _impls[kMaxCachedImpls];
+    size_t _size = 0;
+};
+
+void Document::ImplDeleter::operator()(Impl* impl) const {
+    ImplCache::recycle(impl);
+}
+
 Status Element::addSiblingLeft(Element e) {
     invariant(ok());
     invariant(e.ok());
@@ -2252,12 +2321,13 @@ void Document::Impl::writeChildren(Element::RepIdx repIdx, Builder* builder) con
     }
 }
 
-Document::Document() : _impl(new Impl(Document::kInPlaceDisabled)), _root(makeRootElement()) {
+Document::Document()
+    : _impl(ImplCache::make(Document::kInPlaceDisabled)), _root(makeRootElement()) {
     dassert(_root._repIdx == kRootRepIdx);
 }
 
 Document::Document(const BSONObj& value, InPlaceMode inPlaceMode)
-    : _impl(new Impl(inPlaceMode)), _root(makeRootElement(value)) {
+    : _impl(ImplCache::make(inPlaceMode)), _root(makeRootElement(value)) {
     dassert(_root._repIdx == kRootRepIdx);
 }
 
@@ -506,11 +506,18 @@ private:
     inline Impl& getImpl();
     inline const Impl& getImpl() const;
 
+    // Implementations are recycled through a small per-thread cache rather than freed, since
+    // many callers construct and destroy a Document for every operation they process.
+    class ImplCache;
+    struct ImplDeleter {
+        void operator()(Impl* impl) const;
+    };
+
     Element makeRootElement();
     Element makeRootElement(const BSONObj& value);
     Element makeElement(ConstElement element, const StringData* fieldName);
 
-    const std::unique_ptr<Impl> _impl;
+    const std::unique_ptr<Impl, ImplDeleter> _impl;
 
     // The root element of this document.
     const Element _root;
@@ -1082,6 +1082,27 @@ TEST(Document, LifecycleConstructDefault) {
     ASSERT_FALSE(doc.root().hasValue());
 }
 
+TEST(Document, LifecycleConstructAfterDestroyingPopulatedDocument) {
+    // Documents reuse the implementations of destroyed ones, which must not leak any state.
+    {
+        mmb::Document doc(mongo::fromjson("{a: 1, b: {c: 'x'}}"), mmb::Document::kInPlaceEnabled);
+        ASSERT_OK(doc.root().appendString("d", "leaf"));
+        ASSERT_OK(doc.root().leftChild().setValueInt(2));
+    }
+
+    mmb::Document doc;
+    ASSERT_FALSE(doc.isInPlaceModeEnabled());
+    ASSERT_FALSE(doc.root().hasChildren());
+    ASSERT_BSONOBJ_EQ(mongo::BSONObj(), doc.getObject());
+
+    mmb::Document inPlaceDoc(mongo::fromjson("{e: 5}"), mmb::Document::kInPlaceEnabled);
+    mmb::DamageVector damages;
+    const char* source = nullptr;
+    ASSERT_TRUE(inPlaceDoc.getInPlaceUpdates(&damages, &source));
+    ASSERT_TRUE(damages.empty());
+    ASSERT_BSONOBJ_EQ(mongo::fromjson("{e: 5}"), inPlaceDoc.getObject());
+}
+
 TEST(Document, LifecycleConstructEmptyBSONObj) {
     // Verify the state of a newly created empty Document where the construction argument
     // is an empty BSONObj.
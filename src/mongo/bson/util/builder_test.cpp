@@ -84,6 +84,33 @@ TEST(Builder, StackAllocatorShouldNotLeak) {
     // Let the builder go out of scope. If this leaks, it will trip the ASAN leak detector.
 }
 
+TEST(Builder, LargeBuffersAreReusedWithinAThread) {
+    SharedBuffer::releaseCachedAllocations();
+
+    const int kBytes = 1 << 20;
+    const char* firstBuffer;
+    {
+        BufBuilder bb;
+        for (int i = 0; i < kBytes; ++i) {
+            bb.appendChar(static_cast<char>(i));
+        }
+        firstBuffer = bb.buf();
+    }
+
+    // Growing a second builder through the same sizes should pick up the buffers the first one
+    // released, and growth through cached buffers must preserve the contents written so far.
+    BufBuilder bb;
+    for (int i = 0; i < kBytes; ++i) {
+        bb.appendChar(static_cast<char>(i));
+    }
+    ASSERT_EQ(static_cast<const void*>(firstBuffer), static_cast<const void*>(bb.buf()));
+    for (int i = 0; i < kBytes; ++i) {
+        ASSERT_EQ(bb.buf()[i], static_cast<char>(i));
+    }
+
+    SharedBuffer::releaseCachedAllocations();
+}
+
 template <typename T>
 void testStringBuilderIntegral() {
     auto check = [](T num) { ASSERT_EQ(std::string(str::stream() << num), std::to_string(num)); };
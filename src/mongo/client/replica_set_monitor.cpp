@@ -350,6 +350,36 @@ bool ReplicaSetMonitor::isHostUp(const HostAndPort& host) const {
     return node ? node->isUp : false;
 }
 
+void ReplicaSetMonitor::noteCommandStarted(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (node)
+        ++node->outstandingCommands;
+}
+
+void ReplicaSetMonitor::noteCommandFinished(const HostAndPort& host,
+                                            boost::optional<Microseconds> latency) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (!node)
+        return;
+
+    // The node may have been recreated by a reconfig while the command was outstanding.
+    if (node->outstandingCommands > 0)
+        --node->outstandingCommands;
+
+    if (!latency)
+        return;
+
+    if (node->commandLatencyMicros == unknownLatency) {
+        node->commandLatencyMicros = durationCount<Microseconds>(*latency);
+    } else {
+        // same smoothing as the ping latency
+        node->commandLatencyMicros +=
+            (durationCount<Microseconds>(*latency) - node->commandLatencyMicros) / 4;
+    }
+}
+
 int ReplicaSetMonitor::getMinWireVersion() const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     int minVersion = 0;
@@ -936,7 +966,8 @@ void IsMasterReply::parse(const BSONObj& obj) {
     }
 }
 
-Node::Node(const HostAndPort& host) : host(host), latencyMicros(unknownLatency) {}
+Node::Node(const HostAndPort& host)
+    : host(host), latencyMicros(unknownLatency), commandLatencyMicros(unknownLatency) {}
 
 void Node::markFailed(const Status& status) {
     if (isUp) {
@@ -1010,6 +1041,14 @@ void Node::update(const IsMasterReply& reply) {
     lastWriteDateUpdateTime = Date_t::now();
 }
 
+double Node::loadScore() const {
+    const int64_t latency =
+        commandLatencyMicros != unknownLatency ? commandLatencyMicros : latencyMicros;
+
+    // Keep commands which complete faster than the latency is measured from hiding the load.
+    return static_cast<double>(std::max<int64_t>(latency, 1)) * (1 + outstandingCommands);
+}
+
 SetState::SetState(StringData name, const std::set<HostAndPort>& seedNodes)
     : name(name.toString()),
       consecutiveFailedScans(0),
@@ -1174,10 +1213,21 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                 if (ReplicaSetMonitor::useDeterministicHostSelection) {
                     // only in tests
                     return matchingNodes[roundRobin++ % matchingNodes.size()]->host;
-                } else {
-                    // normal case
-                    return matchingNodes[rand.nextInt32(matchingNodes.size())]->host;
-                };
+                }
+                if (matchingNodes.size() == 1) {
+                    return matchingNodes.front()->host;
+                }
+
+                // normal case: of two distinct random nodes take the less loaded one, which
+                // steers commands away from slow or busy members without sending them all to
+                // whichever member currently looks best
+                const int32_t numNodes = matchingNodes.size();
+                const int32_t firstIndex = rand.nextInt32(numNodes);
+                const int32_t secondIndex =
+                    (firstIndex + 1 + rand.nextInt32(numNodes - 1)) % numNodes;
+                const Node* first = matchingNodes[firstIndex];
+                const Node* second = matchingNodes[secondIndex];
+                return (second->loadScore() < first->loadScore() ? second : first)->host;
             }
 
             return HostAndPort();
@@ -131,6 +131,15 @@ public:
      */
     bool isHostUp(const HostAndPort& host) const;
 
+    /**
+     * Notifies this Monitor that a command was sent to 'host', or that the response to one arrived
+     * after 'latency'. 'latency' is boost::none if the command failed without a response. Host
+     * selection for the non-primary read preferences uses this to steer commands away from members
+     * which are slow or already busy.
+     */
+    void noteCommandStarted(const HostAndPort& host);
+    void noteCommandFinished(const HostAndPort& host, boost::optional<Microseconds> latency);
+
     /**
      * Returns the minimum wire version supported across the replica set.
      */
@@ -122,6 +122,13 @@ public:
          */
         void update(const IsMasterReply& reply);
 
+        /**
+         * Returns how loaded this node looks to callers: the smoothed latency of the commands sent
+         * to it, or the ping latency if none has completed yet, scaled by the number of commands
+         * still outstanding. Lower is better.
+         */
+        double loadScore() const;
+
         HostAndPort host;
         bool isUp{false};
         bool isMaster{false};
@@ -133,6 +140,8 @@ public:
         Date_t lastWriteDateUpdateTime{};  // set to the local system's time at the time of updating
                                            // lastWriteDate
         repl::OpTime opTime{};             // from isMasterReply
+        int64_t commandLatencyMicros{};    // smoothed over the commands sent through this process
+        int outstandingCommands{};
     };
 
     typedef std::vector<Node> Nodes;
@@ -298,6 +298,43 @@ TEST(ReplSetMonitorReadPref, NearestOneLocal) {
     ASSERT(!isPrimarySelected);
 }
 
+TEST(ReplSetMonitorReadPref, NearestAvoidsBusyHost) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    nodes[1].isUp = false;
+
+    nodes[0].latencyMicros = 1 * 1000;
+    nodes[2].latencyMicros = 1 * 1000;
+    nodes[0].commandLatencyMicros = 5 * 1000;
+    nodes[2].commandLatencyMicros = 5 * 1000;
+    nodes[0].outstandingCommands = 10;
+
+    // Both candidates are always compared, so the idle one always wins.
+    for (int i = 0; i < 20; i++) {
+        HostAndPort host = selectNode(nodes, mongo::ReadPreference::Nearest, tags, 3, nullptr);
+        ASSERT_EQUALS("c", host.host());
+    }
+}
+
+TEST(ReplSetMonitorReadPref, NearestAvoidsSlowHost) {
+    vector<Node> nodes = getThreeMemberWithTags();
+    TagSet tags(getDefaultTagSet());
+
+    nodes[1].isUp = false;
+
+    // The ping latencies are equal, but commands to "c" have been much slower.
+    nodes[0].latencyMicros = 1 * 1000;
+    nodes[2].latencyMicros = 1 * 1000;
+    nodes[0].commandLatencyMicros = 2 * 1000;
+    nodes[2].commandLatencyMicros = 50 * 1000;
+
+    for (int i = 0; i < 20; i++) {
+        HostAndPort host = selectNode(nodes, mongo::ReadPreference::Nearest, tags, 3, nullptr);
+        ASSERT_EQUALS("a", host.host());
+    }
+}
+
 TEST(ReplSetMonitorReadPref, PriOnlyWithTagsNoMatch) {
     vector<Node> nodes = getThreeMemberWithTags();
     TagSet tags(getP2TagSet());
@@ -217,15 +217,36 @@ void asyncSaslConversation(auth::RunCommandHook runCommand,
                 return handler(status);
             }
 
+            bool isServerDone = serverResponse[saslCommandDoneFieldName].trueValue();
+
             // Exit if we have finished
             if (session->isDone()) {
-                bool isServerDone = serverResponse[saslCommandDoneFieldName].trueValue();
                 if (!isServerDone) {
                     return handler({ErrorCodes::ProtocolError, "Client finished before server."});
                 }
                 return handler(std::move(response));
             }
 
+            // A server honoring skipEmptyExchange finishes along with its final message. Verify
+            // that message locally rather than sending an empty reply to it.
+            if (isServerDone) {
+                std::string payload;
+                BSONType type;
+                status = saslExtractPayload(serverResponse, &payload, &type);
+                if (!status.isOK())
+                    return handler(std::move(status));
+
+                std::string unusedOutput;
+                status = session->step(payload, &unusedOutput);
+                if (!status.isOK())
+                    return handler(std::move(status));
+
+                if (!session->isDone()) {
+                    return handler({ErrorCodes::ProtocolError, "Server finished before client."});
+                }
+                return handler(std::move(response));
+            }
+
             BSONObj saslFollowupCommandPrefix = BSON(saslContinueCommandName << 1);
             asyncSaslConversation(runCommand,
                                   session,
@@ -271,9 +292,16 @@ void saslClientAuthenticateImpl(auth::RunCommandHook runCommand,
     if (!status.isOK())
         return handler(std::move(status));
 
-    BSONObj saslFirstCommandPrefix =
-        BSON(saslStartCommandName << 1 << saslCommandMechanismFieldName
-                                  << session->getParameter(SaslClientSession::parameterMechanism));
+    BSONObjBuilder saslFirstCommandBuilder;
+    saslFirstCommandBuilder.append(saslStartCommandName, 1);
+    saslFirstCommandBuilder.append(saslCommandMechanismFieldName,
+                                   session->getParameter(SaslClientSession::parameterMechanism));
+    if (mechanism == "SCRAM-SHA-1" || mechanism == "SCRAM-SHA-256") {
+        // Saves the final round trip against servers that support it. Older servers ignore it.
+        saslFirstCommandBuilder.append(saslCommandOptionsFieldName,
+                                       BSON(saslCommandSkipEmptyExchangeFieldName << true));
+    }
+    BSONObj saslFirstCommandPrefix = saslFirstCommandBuilder.obj();
     BSONObj inputObj = BSON(saslCommandPayloadFieldName << "");
     asyncSaslConversation(runCommand,
                           session,
@@ -648,6 +648,7 @@ bool AuthorizationSessionImpl::isAuthorizedForActionsOnNamespace(const Namespace
 }
 
 static const int resourceSearchListCapacity = 5;
+static const size_t privilegeCheckCacheCapacity = 1024;
 /**
  * Builds from "target" an exhaustive list of all ResourcePatterns that match "target".
  *
@@ -827,6 +828,7 @@ void AuthorizationSessionImpl::_refreshUserInfoAsNeeded(OperationContext* opCtx)
 }
 
 void AuthorizationSessionImpl::_buildAuthenticatedRolesVector() {
+    _privilegeCheckCache.clear();
     _authenticatedRoleNames.clear();
     for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
          ++it) {
@@ -905,6 +907,45 @@ bool AuthorizationSessionImpl::isAuthorizedForAnyActionOnResource(const Resource
 
 
 bool AuthorizationSessionImpl::_isAuthorizedForPrivilege(const Privilege& privilege) {
+    // The localhost exception grants default privileges that can go away without any
+    // authenticated user changing, so checks that may depend on them are not cached.
+    if (_externalState->shouldAllowLocalhost() || !_allAuthenticatedUsersValid()) {
+        return _checkPrivilege(privilege);
+    }
+
+    const ResourcePattern& target = privilege.getResourcePattern();
+    const ActionSet& actions = privilege.getActions();
+
+    auto it = _privilegeCheckCache.find(target);
+    if (it != _privilegeCheckCache.end()) {
+        for (const auto& entry : it->second) {
+            if (entry.first == actions) {
+                return entry.second;
+            }
+        }
+    }
+
+    const bool isAuthorized = _checkPrivilege(privilege);
+
+    // A session that touches many namespaces would otherwise grow the cache without bound.
+    if (it == _privilegeCheckCache.end() &&
+        _privilegeCheckCache.size() >= privilegeCheckCacheCapacity) {
+        _privilegeCheckCache.clear();
+    }
+    _privilegeCheckCache[target].emplace_back(actions, isAuthorized);
+    return isAuthorized;
+}
+
+bool AuthorizationSessionImpl::_allAuthenticatedUsersValid() {
+    for (const auto& user : _authenticatedUsers) {
+        if (!user->isValid()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool AuthorizationSessionImpl::_checkPrivilege(const Privilege& privilege) {
     const ResourcePattern& target(privilege.getResourcePattern());
 
     ResourcePattern resourceSearchList[resourceSearchListCapacity];
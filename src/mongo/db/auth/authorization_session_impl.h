@@ -32,6 +32,7 @@
 
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -41,9 +42,11 @@
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authz_session_external_state.h"
 #include "mongo/db/auth/privilege.h"
+#include "mongo/db/auth/resource_pattern.h"
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/stdx/unordered_map.h"
 
 namespace mongo {
 
@@ -199,6 +202,7 @@ protected:
     // Builds a vector of all roles held by users who are authenticated on this connection. The
     // vector is stored in _authenticatedRoleNames. This function is called when users are
     // logged in or logged out, as well as when the user cache is determined to be out of date.
+    // It also clears _privilegeCheckCache, since its results depend on the same set of users.
     void _buildAuthenticatedRolesVector();
 
     // All Users who have been authenticated on this connection.
@@ -219,6 +223,13 @@ private:
     // lock on the admin database (to update out-of-date user privilege information).
     bool _isAuthorizedForPrivilege(const Privilege& privilege);
 
+    // Does the work of _isAuthorizedForPrivilege, without consulting _privilegeCheckCache.
+    bool _checkPrivilege(const Privilege& privilege);
+
+    // Returns true if none of the authenticated users has been marked out of date by the
+    // AuthorizationManager.
+    bool _allAuthenticatedUsersValid();
+
     std::tuple<std::vector<UserName>*, std::vector<RoleName>*> _getImpersonations() override {
         return std::make_tuple(&_impersonatedUserNames, &_impersonatedRoleNames);
     }
@@ -230,5 +241,14 @@ private:
     std::vector<UserName> _impersonatedUserNames;
     std::vector<RoleName> _impersonatedRoleNames;
     bool _impersonationFlag;
+
+    // Results of _checkPrivilege for the current set of authenticated users, keyed by resource
+    // and then by the set of actions checked on it. Commands check the same few privileges on
+    // every request, so this saves resolving them against every user's privileges each time.
+    // Only used while all authenticated users are valid; when the AuthorizationManager marks
+    // one out of date, the next request refreshes it and rebuilds the roles vector, which clears
+    // this cache.
+    stdx::unordered_map<ResourcePattern, std::vector<std::pair<ActionSet, bool>>>
+        _privilegeCheckCache;
 };
 }  // namespace mongo
@@ -481,6 +481,36 @@ TEST_F(AuthorizationSessionTest, InvalidateUser) {
     ASSERT_FALSE(authzSession->lookupUser(UserName("spencer", "test")));
 }
 
+TEST_F(AuthorizationSessionTest, RepeatedPrivilegeChecksFollowLogout) {
+    ASSERT_OK(managerState->insertPrivilegeDocument(_opCtx.get(),
+                                                    BSON("user"
+                                                         << "spencer"
+                                                         << "db"
+                                                         << "test"
+                                                         << "credentials"
+                                                         << credentials
+                                                         << "roles"
+                                                         << BSON_ARRAY(BSON("role"
+                                                                            << "readWrite"
+                                                                            << "db"
+                                                                            << "test"))),
+                                                    BSONObj()));
+    ASSERT_OK(authzSession->addAndAuthorizeUser(_opCtx.get(), UserName("spencer", "test")));
+
+    // Asking the same question twice must give the same answer.
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_TRUE(
+            authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+        ASSERT_FALSE(authzSession->isAuthorizedForActionsOnResource(otherFooCollResource,
+                                                                    ActionType::find));
+    }
+
+    // Results remembered for the logged-out user must not be reused.
+    authzSession->logoutDatabase("test");
+    ASSERT_FALSE(
+        authzSession->isAuthorizedForActionsOnResource(testFooCollResource, ActionType::find));
+}
+
 TEST_F(AuthorizationSessionTest, UseOldUserInfoInFaceOfConnectivityProblems) {
     // Add a readWrite user
     ASSERT_OK(managerState->insertPrivilegeDocument(_opCtx.get(),
@@ -88,4 +88,11 @@ constexpr auto saslDefaultServiceName = "mongodb"_sd;
 // be digested.
 constexpr auto saslCommandDigestPasswordFieldName = "digestPassword"_sd;
 
+/// Field containing an object of mechanism specific options in saslStart commands.
+constexpr auto saslCommandOptionsFieldName = "options"_sd;
+
+/// Option asking the server to finish the conversation as soon as it has sent its final
+/// message, rather than waiting for an empty client message in reply.
+constexpr auto saslCommandSkipEmptyExchangeFieldName = "skipEmptyExchange"_sd;
+
 }  // namespace mongo
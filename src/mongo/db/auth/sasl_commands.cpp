@@ -238,6 +238,11 @@ StatusWith<std::unique_ptr<AuthenticationSession>> doSaslStart(OperationContext*
         return swMech.getStatus();
     }
 
+    auto optionsElem = cmdObj[saslCommandOptionsFieldName];
+    if (optionsElem.type() == Object) {
+        swMech.getValue()->setOptions(optionsElem.Obj());
+    }
+
     auto session = std::make_unique<AuthenticationSession>(std::move(swMech.getValue()));
     Status statusStep = doSaslStep(opCtx, session.get(), cmdObj, result);
     if (!statusStep.isOK()) {
@@ -135,6 +135,12 @@ public:
         return requestedUser == authenticatedUser;
     }
 
+    /**
+     * Applies the mechanism specific options passed with saslStart. Mechanisms ignore options
+     * they don't know, so that clients may offer them to any server.
+     */
+    virtual void setOptions(const BSONObj& options) {}
+
     /**
      * Performs a single step of a SASL exchange. Takes an input provided by a client,
      * and either returns an error, or a response to be sent back.
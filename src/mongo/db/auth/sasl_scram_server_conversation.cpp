@@ -41,6 +41,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/crypto/mechanism_scram.h"
 #include "mongo/crypto/sha1_block.h"
+#include "mongo/db/auth/sasl_command_constants.h"
 #include "mongo/db/auth/sasl_mechanism_policies.h"
 #include "mongo/db/auth/sasl_mechanism_registry.h"
 #include "mongo/db/auth/sasl_options.h"
@@ -74,6 +75,11 @@ StatusWith<std::tuple<bool, std::string>> SaslSCRAMServerMechanism<Policy>::step
     return std::make_tuple(true, std::string{});
 }
 
+template <typename Policy>
+void SaslSCRAMServerMechanism<Policy>::setOptions(const BSONObj& options) {
+    _skipEmptyExchange = options[saslCommandSkipEmptyExchangeFieldName].trueValue();
+}
+
 /*
  * RFC 5802 specifies that in SCRAM user names characters ',' and '=' are encoded as
  * =2C and =3D respectively.
@@ -334,7 +340,8 @@ StatusWith<std::tuple<bool, std::string>> SaslSCRAMServerMechanism<Policy>::_sec
     // ServerSignature := HMAC(ServerKey, AuthMessage)
     sb << "v=" << _secrets.generateServerSignature(_authMessage);
 
-    return std::make_tuple(false, sb.str());
+    // The client has proven its identity, so if it asked to skip the empty exchange we're done.
+    return std::make_tuple(_skipEmptyExchange, sb.str());
 }
 
 template class SaslSCRAMServerMechanism<SCRAMSHA1Policy>;
@@ -58,6 +58,8 @@ public:
     StatusWith<std::tuple<bool, std::string>> stepImpl(OperationContext* opCtx,
                                                        StringData inputData);
 
+    void setOptions(const BSONObj& options) final;
+
     StatusWith<std::string> saslPrep(StringData str) const {
         if (std::is_same<SHA1Block, HashBlock>::value) {
             return str.toString();
@@ -79,6 +81,7 @@ private:
                                                           StringData input);
 
     int _step{0};
+    bool _skipEmptyExchange{false};
     std::string _authMessage;
     User::SCRAMCredentials<HashBlock> _scramCredentials;
     scram::Secrets<HashBlock> _secrets;
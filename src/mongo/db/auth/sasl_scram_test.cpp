@@ -404,6 +404,33 @@ TEST_F(SCRAMFixture, testSCRAM) {
     ASSERT_EQ(goalState, runSteps());
 }
 
+TEST_F(SCRAMFixture, testSCRAMSkipEmptyExchange) {
+    ASSERT_OK(authzManagerExternalState->insertPrivilegeDocument(
+        opCtx.get(), generateSCRAMUserDocument("sajack", "sajack"), BSONObj()));
+
+    saslClientSession->setParameter(NativeSaslClientSession::parameterUser, "sajack");
+    saslClientSession->setParameter(NativeSaslClientSession::parameterPassword,
+                                    createPasswordDigest("sajack", "sajack"));
+
+    ASSERT_OK(saslClientSession->initialize());
+    saslServerSession->setOptions(BSON("skipEmptyExchange" << true));
+
+    std::string clientOutput;
+    std::string serverOutput;
+    for (int step = 1; step <= 2; step++) {
+        ASSERT_OK(saslClientSession->step(serverOutput, &clientOutput));
+        auto swServerOutput = saslServerSession->step(opCtx.get(), clientOutput);
+        ASSERT_OK(swServerOutput.getStatus());
+        serverOutput = std::move(swServerOutput.getValue());
+    }
+
+    // The server is done as soon as it has sent its signature, which the client still verifies
+    ASSERT_TRUE(saslServerSession->isDone());
+    ASSERT_FALSE(saslClientSession->isDone());
+    ASSERT_OK(saslClientSession->step(serverOutput, &clientOutput));
+    ASSERT_TRUE(saslClientSession->isDone());
+}
+
 TEST_F(SCRAMFixture, testSCRAMWithChannelBindingSupportedByClient) {
     ASSERT_OK(authzManagerExternalState->insertPrivilegeDocument(
         opCtx.get(), generateSCRAMUserDocument("sajack", "sajack"), BSONObj()));
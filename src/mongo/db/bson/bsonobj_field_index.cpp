@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/bson/bsonobj_field_index.h"
+
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+constexpr size_t BSONObjFieldIndex::kMaxLinearLookups;
+
+BSONElement BSONObjFieldIndex::getField(StringData name) const {
+    if (!_fields) {
+        if (_numLookups++ < kMaxLinearLookups) {
+            return _obj.getField(name);
+        }
+        _buildIndex();
+    }
+
+    auto it = _fields->find(name);
+    return it == _fields->end() ? BSONElement() : it->second;
+}
+
+BSONElement BSONObjFieldIndex::extractElementAtPath(StringData path) const {
+    BSONElement elem = getField(path);
+    if (!elem.eoo()) {
+        return elem;
+    }
+
+    const size_t dotOffset = path.find('.');
+    if (dotOffset == std::string::npos) {
+        return elem;
+    }
+
+    BSONElement left = getField(path.substr(0, dotOffset));
+    if (left.type() != BSONType::Object && left.type() != BSONType::Array) {
+        return BSONElement();
+    }
+
+    BSONObj sub = left.embeddedObject();
+    if (sub.isEmpty()) {
+        return BSONElement();
+    }
+    return dotted_path_support::extractElementAtPath(sub, path.substr(dotOffset + 1));
+}
+
+void BSONObjFieldIndex::_buildIndex() const {
+    _fields = stdx::make_unique<FieldMap>();
+    for (auto&& elem : _obj) {
+        // Keep the first of any duplicates, to match BSONObj::getField().
+        _fields->try_emplace(elem.fieldNameStringData(), elem);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * Answers repeated top-level field lookups against a single BSONObj without rescanning the object
+ * for each one.
+ *
+ * The first kMaxLinearLookups lookups scan the object exactly as BSONObj::getField() does. The next
+ * lookup builds a hash table from field name to element in a single pass, and every lookup after
+ * that is a hash probe. Callers which only fetch one or two fields therefore pay nothing extra,
+ * while callers which fetch many fields from a wide document avoid a quadratic number of element
+ * comparisons.
+ *
+ * As with BSONObj::getField(), the first of several elements with the same name is returned. The
+ * object must outlive the index.
+ */
+class BSONObjFieldIndex {
+    MONGO_DISALLOW_COPYING(BSONObjFieldIndex);
+
+public:
+    static constexpr size_t kMaxLinearLookups = 4;
+
+    explicit BSONObjFieldIndex(const BSONObj& obj) : _obj(obj) {}
+
+    /**
+     * Returns the first top-level element named 'name', or EOO if there is none.
+     */
+    BSONElement getField(StringData name) const;
+
+    /**
+     * Equivalent to dotted_path_support::extractElementAtPath() on the indexed object, except
+     * that the top-level field along 'path' is found through the index.
+     */
+    BSONElement extractElementAtPath(StringData path) const;
+
+private:
+    // Keys are views of the field names in '_obj', so building the table copies no strings.
+    struct FieldNameTraits : public StringMapTraits {
+        static StringData toStorage(StringData s) {
+            return s;
+        }
+
+        static StringData toLookup(StringData s) {
+            return s;
+        }
+    };
+
+    using FieldMap = UnorderedFastKeyTable<StringData, StringData, BSONElement, FieldNameTraits>;
+
+    void _buildIndex() const;
+
+    const BSONObj& _obj;
+
+    mutable size_t _numLookups = 0;
+    mutable std::unique_ptr<FieldMap> _fields;
+};
+
+}  // namespace mongo
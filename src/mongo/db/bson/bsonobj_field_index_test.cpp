@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/db/bson/bsonobj_field_index.h"
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makeWideObject(int numFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < numFields; ++i) {
+        bob.append(str::stream() << "f" << i, i);
+    }
+    return bob.obj();
+}
+
+TEST(BSONObjFieldIndex, LookupsMatchGetFieldBeforeAndAfterIndexing) {
+    const int numFields = 100;
+    BSONObj obj = makeWideObject(numFields);
+    BSONObjFieldIndex fieldIndex(obj);
+
+    // Run enough lookups to cross from linear scans to the hash table.
+    for (int i = numFields - 1; i >= 0; --i) {
+        const std::string name = str::stream() << "f" << i;
+        BSONElement elem = fieldIndex.getField(name);
+        ASSERT_EQ(elem.rawdata(), obj.getField(name).rawdata());
+        ASSERT_EQ(elem.numberInt(), i);
+    }
+    ASSERT(fieldIndex.getField("missing").eoo());
+    ASSERT(fieldIndex.getField("").eoo());
+}
+
+TEST(BSONObjFieldIndex, DuplicateFieldNamesReturnFirstElement) {
+    BSONObj obj = BSON("a" << 1 << "b" << 2 << "a" << 3);
+    BSONObjFieldIndex fieldIndex(obj);
+    for (size_t i = 0; i < BSONObjFieldIndex::kMaxLinearLookups + 2; ++i) {
+        ASSERT_EQ(fieldIndex.getField("a").numberInt(), 1);
+    }
+}
+
+TEST(BSONObjFieldIndex, ExtractElementAtPathMatchesDottedPathSupport) {
+    BSONObj obj = fromjson(
+        "{a: 1, b: {a: 2, c: {d: 3}}, c: [{a: 4}, {a: 5}], 'e.f': 6, e: {f: 7}, g: {}, h: 'x'}");
+    BSONObjFieldIndex fieldIndex(obj);
+
+    const std::vector<std::string> paths{
+        "a", "b.a", "b.c.d", "b.c", "c.a", "c.1.a", "e.f", "g.a", "h.a", "missing", "b.missing"};
+    // Loop twice so that the second pass is served by the hash table.
+    for (int pass = 0; pass < 2; ++pass) {
+        for (auto&& path : paths) {
+            BSONElement expected = dotted_path_support::extractElementAtPath(obj, path);
+            BSONElement actual = fieldIndex.extractElementAtPath(path);
+            ASSERT_EQ(expected.eoo(), actual.eoo()) << path;
+            if (!expected.eoo()) {
+                ASSERT_EQ(expected.rawdata(), actual.rawdata()) << path;
+            }
+        }
+    }
+}
+
+}  // namespace
+}  // namespace mongo
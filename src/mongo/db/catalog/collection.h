@@ -259,7 +259,8 @@ public:
 
         virtual Status insertDocument(OperationContext* opCtx,
                                       const BSONObj& doc,
-                                      const std::vector<MultiIndexBlock*>& indexBlocks) = 0;
+                                      const std::vector<MultiIndexBlock*>& indexBlocks,
+                                      RecordStoreBulkBuilder* bulkBuilder) = 0;
 
         virtual RecordId updateDocument(OperationContext* opCtx,
                                         const RecordId& oldLocation,
@@ -500,14 +501,17 @@ public:
     }
 
     /**
-     * Inserts a document into the record store and adds it to the MultiIndexBlocks passed in.
+     * Inserts a document into the record store and adds it to the MultiIndexBlocks passed in. If
+     * 'bulkBuilder' is not null, the record is appended through it rather than inserted in the
+     * current unit of work.
      *
      * NOTE: It is up to caller to commit the indexes.
      */
     inline Status insertDocument(OperationContext* const opCtx,
                                  const BSONObj& doc,
-                                 const std::vector<MultiIndexBlock*>& indexBlocks) {
-        return this->_impl().insertDocument(opCtx, doc, indexBlocks);
+                                 const std::vector<MultiIndexBlock*>& indexBlocks,
+                                 RecordStoreBulkBuilder* const bulkBuilder = nullptr) {
+        return this->_impl().insertDocument(opCtx, doc, indexBlocks, bulkBuilder);
     }
 
     /**
@@ -572,6 +576,9 @@ public:
      * @return OK if the validate run successfully
      *         OK will be returned even if corruption is found
      *         deatils will be in result.
+     *
+     * With 'background', 'collLk' may be held in MODE_IS rather than MODE_X, in which case the
+     * records and indexes are all read from the snapshot of 'opCtx'.
      */
     inline Status validate(OperationContext* const opCtx,
                            const ValidateCmdLevel level,
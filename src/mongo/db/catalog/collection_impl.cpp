@@ -49,6 +49,7 @@
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/catalog/namespace_uuid_cache.h"
 #include "mongo/db/catalog/uuid_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
@@ -66,6 +67,10 @@
 #include "mongo/db/storage/key_string.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/update/update_driver.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/rpc/object_check.h"
@@ -204,6 +209,11 @@ bool CollectionImpl::requiresIdIndex() const {
         return false;
     }
 
+    if (_recordStore->isClustered()) {
+        // The record store itself is keyed and deduplicated by _id.
+        return false;
+    }
+
     if (_ns.isSystem()) {
         StringData shortName = _ns.coll().substr(_ns.coll().find('.') + 1);
         if (shortName == "indexes" || shortName == "namespaces" || shortName == "profile") {
@@ -345,7 +355,7 @@ Status CollectionImpl::insertDocuments(OperationContext* opCtx,
     const bool hasIdIndex = _indexCatalog.findIdIndex(opCtx);
 
     for (auto it = begin; it != end; it++) {
-        if (hasIdIndex && it->doc["_id"].eoo()) {
+        if ((hasIdIndex || _recordStore->isClustered()) && it->doc["_id"].eoo()) {
             return Status(ErrorCodes::InternalError,
                           str::stream()
                               << "Collection::insertDocument got document without _id for ns:"
@@ -398,7 +408,8 @@ Status CollectionImpl::insertDocument(OperationContext* opCtx,
 
 Status CollectionImpl::insertDocument(OperationContext* opCtx,
                                       const BSONObj& doc,
-                                      const std::vector<MultiIndexBlock*>& indexBlocks) {
+                                      const std::vector<MultiIndexBlock*>& indexBlocks,
+                                      RecordStoreBulkBuilder* bulkBuilder) {
 
     MONGO_FAIL_POINT_BLOCK(failCollectionInserts, extraData) {
         const BSONObj& data = extraData.getData();
@@ -423,8 +434,9 @@ Status CollectionImpl::insertDocument(OperationContext* opCtx,
 
     // TODO SERVER-30638: using timestamp 0 for these inserts, which are non-oplog so we don't yet
     // care about their correct timestamps.
-    StatusWith<RecordId> loc =
-        _recordStore->insertRecord(opCtx, doc.objdata(), doc.objsize(), Timestamp());
+    StatusWith<RecordId> loc = bulkBuilder
+        ? bulkBuilder->addRecord(doc.objdata(), doc.objsize())
+        : _recordStore->insertRecord(opCtx, doc.objdata(), doc.objsize(), Timestamp());
 
     if (!loc.isOK())
         return loc.getStatus();
@@ -982,29 +994,209 @@ const CollatorInterface* CollectionImpl::getDefaultCollator() const {
 
 namespace {
 
+const int kMaxValidateIndexThreads = 16;
+
+}  // namespace
+
+// The number of indexes that validate traverses at once.
+MONGO_EXPORT_SERVER_PARAMETER(maxValidateIndexThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > kMaxValidateIndexThreads) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "maxValidateIndexThreads must be between 1 and "
+                                        << kMaxValidateIndexThreads);
+        }
+        return Status::OK();
+    });
+
+namespace {
+
 using ValidateResultsMap = std::map<std::string, ValidateResults>;
 
+ThreadPool* getValidateThreadPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "Validate";
+        options.minThreads = 0;
+        options.maxThreads = kMaxValidateIndexThreads - 1;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+
+        auto newPool = new ThreadPool(options);
+        newPool->startup();
+        return newPool;
+    }();
+    return pool;
+}
+
 void _validateRecordStore(OperationContext* opCtx,
                           RecordStore* recordStore,
                           ValidateCmdLevel level,
                           bool background,
                           RecordStoreValidateAdaptor* indexValidator,
                           ValidateResults* results,
-                          BSONObjBuilder* output) {
+                          BSONObjBuilder* output,
+                          long long* numRecords) {
 
     // Validate RecordStore and, if `level == kValidateFull`, use the RecordStore's validate
     // function.
     if (background) {
-        indexValidator->traverseRecordStore(recordStore, level, results, output);
+        indexValidator->traverseRecordStore(recordStore, level, results, output, numRecords);
     } else {
         auto status = recordStore->validate(opCtx, level, indexValidator, results, output);
         // RecordStore::validate always returns Status::OK(). Errors are reported through
         // `results`.
         dassert(status.isOK());
+        *numRecords = recordStore->numRecords(opCtx);
+    }
+}
+
+/**
+ * The traversal of one index, which may run on another thread than the validation.
+ */
+struct IndexTraversal {
+    const IndexDescriptor* descriptor;
+    IndexAccessMethod* iam;
+    ValidateResults* results;
+    bool checkCounts = false;
+    int64_t numValidatedKeys = 0;
+    int64_t numTraversedKeys = 0;
+};
+
+void _traverseIndex(OperationContext* opCtx,
+                    RecordStoreValidateAdaptor* indexValidator,
+                    ValidateCmdLevel level,
+                    IndexTraversal* traversal) {
+    log(LogComponent::kIndex) << "validating index " << traversal->descriptor->indexNamespace()
+                              << endl;
+
+    if (level == kValidateFull) {
+        traversal->iam->validate(opCtx, &traversal->numValidatedKeys, traversal->results);
+        traversal->checkCounts = true;
+    }
+
+    if (traversal->results->valid) {
+        indexValidator->traverseIndex(opCtx,
+                                      traversal->iam,
+                                      traversal->descriptor,
+                                      traversal->results,
+                                      &traversal->numTraversedKeys);
+    }
+}
+
+/**
+ * Traverses the indexes on up to maxValidateIndexThreads threads. Each thread other than this one
+ * reads through an operation of its own, so the traversals only see the same data as this
+ * operation if nothing can write to the collection, or if they all read at the same timestamp.
+ */
+void _traverseIndexes(OperationContext* opCtx,
+                      const NamespaceString& nss,
+                      RecordStoreValidateAdaptor* indexValidator,
+                      ValidateCmdLevel level,
+                      std::vector<IndexTraversal>* traversals) {
+    size_t numThreads =
+        std::min(static_cast<size_t>(maxValidateIndexThreads.load()), traversals->size());
+
+    const auto readTimestamp = opCtx->recoveryUnit()->getPointInTimeReadTimestamp();
+    if (!readTimestamp && !opCtx->lockState()->isCollectionLockedForMode(nss.ns(), MODE_X)) {
+        // Only this operation's snapshot is consistent with the documents that were validated.
+        numThreads = 1;
+    }
+
+    if (numThreads <= 1) {
+        for (auto& traversal : *traversals) {
+            opCtx->checkForInterrupt();
+            _traverseIndex(opCtx, indexValidator, level, &traversal);
+        }
+        return;
+    }
+
+    // Each thread claims the next index that no other thread has started on.
+    AtomicWord<size_t> nextIndex(0);
+    auto runTraversals = [&](OperationContext* traversalOpCtx) {
+        try {
+            for (size_t i = nextIndex.fetchAndAdd(1); i < traversals->size();
+                 i = nextIndex.fetchAndAdd(1)) {
+                if (traversalOpCtx == opCtx) {
+                    opCtx->checkForInterrupt();
+                } else {
+                    stdx::lock_guard<Client> lk(*opCtx->getClient());
+                    const auto killStatus = opCtx->getKillStatus();
+                    uassert(killStatus, "validate was interrupted", killStatus == ErrorCodes::OK);
+                }
+                _traverseIndex(traversalOpCtx, indexValidator, level, &(*traversals)[i]);
+            }
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+        return Status::OK();
+    };
+
+    stdx::mutex mutex;
+    stdx::condition_variable threadsFinished;
+    size_t numRunning = 0;
+    std::vector<Status> statuses(numThreads, Status::OK());
+
+    for (size_t thread = 1; thread < numThreads; ++thread) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ++numRunning;
+        }
+        auto scheduleStatus = getValidateThreadPool()->schedule([&, thread] {
+            Status status = [&] {
+                auto traversalOpCtx = cc().makeOperationContext();
+
+                // The validation holds the locks that protect the collection and its indexes. This
+                // thread only takes what reading from the storage engine requires, and never
+                // waits for it, since it could be queued behind a request that conflicts with
+                // the locks of the validation, which in turn waits for this thread.
+                traversalOpCtx->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+                Lock::GlobalLock globalLock(traversalOpCtx.get(),
+                                            MODE_IS,
+                                            Date_t::now(),
+                                            Lock::InterruptBehavior::kLeaveUnlocked);
+                if (!globalLock.isLocked()) {
+                    // The traversals are left to the other threads.
+                    return Status::OK();
+                }
+
+                if (readTimestamp) {
+                    traversalOpCtx->recoveryUnit()->setTimestampReadSource(
+                        RecoveryUnit::ReadSource::kProvided, *readTimestamp);
+                }
+                return runTraversals(traversalOpCtx.get());
+            }();
+
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            statuses[thread] = std::move(status);
+            --numRunning;
+            threadsFinished.notify_all();
+        });
+
+        if (!scheduleStatus.isOK()) {
+            // The threads already running, including this one, pick up the slack.
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            --numRunning;
+        }
+    }
+
+    statuses[0] = runTraversals(opCtx);
+
+    // The traversals refer to the locals above and to the validation's state, so they must all
+    // finish regardless of interruption.
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        threadsFinished.wait(lk, [&] { return numRunning == 0; });
+    }
+
+    for (auto& status : statuses) {
+        uassertStatusOK(status);
     }
 }
 
 void _validateIndexes(OperationContext* opCtx,
+                      const NamespaceString& nss,
                       IndexCatalog* indexCatalog,
                       BSONObjBuilder* keysPerIndex,
                       RecordStoreValidateAdaptor* indexValidator,
@@ -1012,27 +1204,29 @@ void _validateIndexes(OperationContext* opCtx,
                       ValidateResultsMap* indexNsResultsMap,
                       ValidateResults* results) {
 
+    // Look up every index's results before any traversal starts, since the traversals may run
+    // concurrently.
+    std::vector<IndexTraversal> traversals;
     IndexCatalog::IndexIterator i = indexCatalog->getIndexIterator(opCtx, false);
+    while (i.more()) {
+        IndexTraversal traversal;
+        traversal.descriptor = i.next();
+        traversal.iam = indexCatalog->getIndex(traversal.descriptor);
+        traversal.results = &(*indexNsResultsMap)[traversal.descriptor->indexNamespace()];
+        traversals.push_back(traversal);
+    }
 
     // Validate Indexes.
-    while (i.more()) {
-        opCtx->checkForInterrupt();
-        const IndexDescriptor* descriptor = i.next();
-        log(LogComponent::kIndex) << "validating index " << descriptor->indexNamespace() << endl;
-        IndexAccessMethod* iam = indexCatalog->getIndex(descriptor);
-        ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexNamespace()];
-        bool checkCounts = false;
-        int64_t numTraversedKeys;
-        int64_t numValidatedKeys;
+    _traverseIndexes(opCtx, nss, indexValidator, level, &traversals);
 
-        if (level == kValidateFull) {
-            iam->validate(opCtx, &numValidatedKeys, &curIndexResults);
-            checkCounts = true;
-        }
+    for (const auto& traversal : traversals) {
+        const IndexDescriptor* descriptor = traversal.descriptor;
+        ValidateResults& curIndexResults = *traversal.results;
+        const bool checkCounts = traversal.checkCounts;
+        const int64_t numTraversedKeys = traversal.numTraversedKeys;
+        const int64_t numValidatedKeys = traversal.numValidatedKeys;
 
         if (curIndexResults.valid) {
-            indexValidator->traverseIndex(iam, descriptor, &curIndexResults, &numTraversedKeys);
-
             if (checkCounts && (numValidatedKeys != numTraversedKeys)) {
                 curIndexResults.valid = false;
                 string msg = str::stream()
@@ -1072,7 +1266,7 @@ void _markIndexEntriesInvalid(ValidateResultsMap* indexNsResultsMap, ValidateRes
 
 void _validateIndexKeyCount(OperationContext* opCtx,
                             IndexCatalog* indexCatalog,
-                            RecordStore* recordStore,
+                            long long numRecords,
                             RecordStoreValidateAdaptor* indexValidator,
                             ValidateResultsMap* indexNsResultsMap) {
 
@@ -1082,8 +1276,7 @@ void _validateIndexKeyCount(OperationContext* opCtx,
         ValidateResults& curIndexResults = (*indexNsResultsMap)[descriptor->indexNamespace()];
 
         if (curIndexResults.valid) {
-            indexValidator->validateIndexKeyCount(
-                descriptor, recordStore->numRecords(opCtx), curIndexResults);
+            indexValidator->validateIndexKeyCount(descriptor, numRecords, curIndexResults);
         }
     }
 }
@@ -1204,8 +1397,9 @@ Status CollectionImpl::validate(OperationContext* opCtx,
             << " (UUID: " << (uuid() ? uuid()->toString() : "none") << ")";
         log(LogComponent::kIndex) << "validating collection " << ns().toString() << uuidString
                                   << endl;
+        long long numRecords = 0;
         _validateRecordStore(
-            opCtx, _recordStore, level, background, &indexValidator, results, output);
+            opCtx, _recordStore, level, background, &indexValidator, results, output, &numRecords);
 
         // Validate in-memory catalog information with the persisted info.
         _validateCatalogEntry(opCtx, this, _validatorDoc, results);
@@ -1213,6 +1407,7 @@ Status CollectionImpl::validate(OperationContext* opCtx,
         // Validate indexes and check for mismatches.
         if (results->valid) {
             _validateIndexes(opCtx,
+                             ns(),
                              &_indexCatalog,
                              &keysPerIndex,
                              &indexValidator,
@@ -1228,7 +1423,7 @@ Status CollectionImpl::validate(OperationContext* opCtx,
         // Validate index key count.
         if (results->valid) {
             _validateIndexKeyCount(
-                opCtx, &_indexCatalog, _recordStore, &indexValidator, &indexNsResultsMap);
+                opCtx, &_indexCatalog, numRecords, &indexValidator, &indexNsResultsMap);
         }
 
         // Report the validation results for the user to see
@@ -184,7 +184,8 @@ public:
      */
     Status insertDocument(OperationContext* opCtx,
                           const BSONObj& doc,
-                          const std::vector<MultiIndexBlock*>& indexBlocks) final;
+                          const std::vector<MultiIndexBlock*>& indexBlocks,
+                          RecordStoreBulkBuilder* bulkBuilder) final;
 
     /**
      * Updates the document @ oldLocation with newDoc.
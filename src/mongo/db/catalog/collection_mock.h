@@ -148,7 +148,8 @@ public:
 
     Status insertDocument(OperationContext* opCtx,
                           const BSONObj& doc,
-                          const std::vector<MultiIndexBlock*>& indexBlocks) {
+                          const std::vector<MultiIndexBlock*>& indexBlocks,
+                          RecordStoreBulkBuilder* bulkBuilder) {
         std::abort();
     }
 
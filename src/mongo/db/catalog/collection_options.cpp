@@ -156,6 +156,10 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
             if (!validMaxCappedDocs(&cappedMaxDocs))
                 return Status(ErrorCodes::BadValue,
                               "max in a capped collection has to be < 2^31 or not set");
+        } else if (fieldName == "cappedAsyncDeletes") {
+            cappedAsyncDeletes = e.trueValue();
+        } else if (fieldName == "clusteredIndex") {
+            clusteredIndex = e.trueValue();
         } else if (fieldName == "$nExtents") {
             if (e.type() == Array) {
                 BSONObjIterator j(e.Obj());
@@ -266,6 +270,28 @@ Status CollectionOptions::parse(const BSONObj& options, ParseKind kind) {
         return Status(ErrorCodes::BadValue, "'pipeline' cannot be specified without 'viewOn'");
     }
 
+    if (cappedAsyncDeletes) {
+        if (!capped) {
+            return Status(ErrorCodes::BadValue,
+                          "'cappedAsyncDeletes' can only be specified for capped collections");
+        }
+        if (cappedMaxDocs) {
+            return Status(ErrorCodes::BadValue,
+                          "'cappedAsyncDeletes' cannot be combined with 'max'");
+        }
+    }
+
+    if (clusteredIndex) {
+        if (capped) {
+            return Status(ErrorCodes::BadValue,
+                          "'clusteredIndex' cannot be specified for capped collections");
+        }
+        if (autoIndexId != DEFAULT) {
+            return Status(ErrorCodes::BadValue,
+                          "'clusteredIndex' cannot be combined with 'autoIndexId'");
+        }
+    }
+
     return Status::OK();
 }
 
@@ -286,8 +312,14 @@ void CollectionOptions::appendBSON(BSONObjBuilder* builder) const {
 
         if (cappedMaxDocs)
             builder->appendNumber("max", cappedMaxDocs);
+
+        if (cappedAsyncDeletes)
+            builder->appendBool("cappedAsyncDeletes", true);
     }
 
+    if (clusteredIndex)
+        builder->appendBool("clusteredIndex", true);
+
     if (initialNumExtents)
         builder->appendNumber("$nExtents", initialNumExtents);
     if (!initialExtentSizes.empty())
@@ -353,6 +385,14 @@ bool CollectionOptions::matchesStorageOptions(const CollectionOptions& other,
         return false;
     }
 
+    if (cappedAsyncDeletes != other.cappedAsyncDeletes) {
+        return false;
+    }
+
+    if (clusteredIndex != other.clusteredIndex) {
+        return false;
+    }
+
     if (initialNumExtents != other.initialNumExtents) {
         return false;
     }
@@ -102,6 +102,16 @@ struct CollectionOptions {
     long long cappedSize = 0;
     long long cappedMaxDocs = 0;
 
+    // When set, documents beyond the size limit of a capped collection are removed by a
+    // background thread rather than by the inserting operation. The collection may temporarily
+    // exceed 'cappedSize' by a bounded amount. Incompatible with 'cappedMaxDocs'.
+    bool cappedAsyncDeletes = false;
+
+    // When set, documents are stored keyed by their _id, which must be a positive integer, and the
+    // collection has no separate _id index. Point lookups by _id go straight to the record store.
+    // Incompatible with 'capped' and 'autoIndexId'.
+    bool clusteredIndex = false;
+
     // (MMAPv1) The following 2 are mutually exclusive, can only have one set.
     long long initialNumExtents = 0;
     std::vector<long long> initialExtentSizes;
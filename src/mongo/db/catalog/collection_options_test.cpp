@@ -380,4 +380,31 @@ TEST(CollectionOptions, NExtentsNumberLimits) {
     ASSERT_OK(options.parse(fromjson("{$nExtents: 9999999999999999999999999999999}")));
     ASSERT_EQ(options.initialNumExtents, LLONG_MAX);
 }
+
+TEST(CollectionOptions, CappedAsyncDeletesRoundTrip) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{capped: true, size: 4096, cappedAsyncDeletes: true}")));
+    ASSERT_TRUE(options.cappedAsyncDeletes);
+    checkRoundTrip(options);
+}
+
+TEST(CollectionOptions, CappedAsyncDeletesRequiresCappedWithoutMax) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{cappedAsyncDeletes: true}")));
+    ASSERT_NOT_OK(
+        options.parse(fromjson("{capped: true, size: 4096, max: 10, cappedAsyncDeletes: true}")));
+}
+
+TEST(CollectionOptions, ClusteredIndexRoundTrip) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{clusteredIndex: true}")));
+    ASSERT_TRUE(options.clusteredIndex);
+    checkRoundTrip(options);
+}
+
+TEST(CollectionOptions, ClusteredIndexRejectsCappedAndAutoIndexId) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{capped: true, size: 4096, clusteredIndex: true}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{autoIndexId: false, clusteredIndex: true}")));
+}
 }  // namespace mongo
@@ -31,8 +31,10 @@
 #include "mongo/db/catalog/capped_utils.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_access_method.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_impl.h"
@@ -238,4 +240,52 @@ TEST_F(CollectionTest, AsynchronouslyNotifyCappedWaitersIfNeeded) {
     thread.join();
     ASSERT_EQ(notifier->getVersion(), thisVersion);
 }
+
+TEST_F(CollectionTest, InsertDocumentsIndexesEveryKeyOfTheBatch) {
+    NamespaceString nss("test.t");
+    ASSERT_OK(_storage->createCollection(_opCtx, nss, CollectionOptions()));
+
+    AutoGetCollection autoColl(_opCtx, nss, MODE_X);
+    Collection* coll = autoColl.getCollection();
+    {
+        WriteUnitOfWork wuow(_opCtx);
+        auto spec = BSON("v" << 2 << "key" << BSON("a" << 1) << "name"
+                             << "a_1"
+                             << "ns"
+                             << nss.ns());
+        ASSERT_OK(coll->getIndexCatalog()->createIndexOnEmptyCollection(_opCtx, spec).getStatus());
+        wuow.commit();
+    }
+
+    // None of the documents has a timestamp, so their keys are generated and written as a batch.
+    // The array makes the index multikey.
+    std::vector<InsertStatement> inserts;
+    inserts.emplace_back(BSON("_id" << 0 << "a" << 3));
+    inserts.emplace_back(BSON("_id" << 1 << "a" << BSON_ARRAY(5 << 1)));
+    inserts.emplace_back(BSON("_id" << 2 << "a" << 3));
+    inserts.emplace_back(BSON("_id" << 3));
+    {
+        WriteUnitOfWork wuow(_opCtx);
+        ASSERT_OK(coll->insertDocuments(_opCtx, inserts.begin(), inserts.end(), nullptr, false));
+        wuow.commit();
+    }
+
+    auto desc = coll->getIndexCatalog()->findIndexByName(_opCtx, "a_1");
+    ASSERT(desc);
+    ASSERT(desc->isMultikey(_opCtx));
+
+    std::vector<BSONObj> expectedKeys{BSON("" << BSONNULL),
+                                      BSON("" << 1),
+                                      BSON("" << 3),
+                                      BSON("" << 3),
+                                      BSON("" << 5)};
+    auto cursor = coll->getIndexCatalog()->getIndex(desc)->newCursor(_opCtx);
+    auto entry = cursor->seek(BSON("" << MINKEY), true);
+    for (const auto& expectedKey : expectedKeys) {
+        ASSERT(entry);
+        ASSERT_BSONOBJ_EQ(expectedKey, entry->key);
+        entry = cursor->next();
+    }
+    ASSERT_FALSE(entry);
+}
 }  // namespace
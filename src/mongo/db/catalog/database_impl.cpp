@@ -743,6 +743,10 @@ void DatabaseImpl::_checkCanCreateCollection(OperationContext* opCtx,
 
     uassert(17316, "cannot create a blank collection", nss.coll() > 0);
     uassert(28838, "cannot create a non-capped oplog collection", options.capped || !nss.isOplog());
+    uassert(ErrorCodes::InvalidOptions,
+            "the storage engine does not support clustered collections",
+            !options.clusteredIndex ||
+                opCtx->getServiceContext()->getStorageEngine()->supportsClusteredCollections());
     uassert(ErrorCodes::DatabaseDropPending,
             str::stream() << "Cannot create collection " << nss.ns()
                           << " - database is in the process of being dropped.",
@@ -1040,6 +1044,15 @@ MONGO_REGISTER_SHIM(Database::userCreateNS)
         }
     }
 
+    // Older versions can't read a collection keyed by its _id, so ban creating one as master
+    // until the feature compatibility version is 4.2.
+    if (collectionOptions.clusteredIndex && serverGlobalParams.validateFeaturesAsMaster.load() &&
+        serverGlobalParams.featureCompatibility.getVersion() !=
+            ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42) {
+        return Status(ErrorCodes::InvalidOptions,
+                      "'clusteredIndex' requires featureCompatibilityVersion 4.2");
+    }
+
     Status status = validateStorageOptions(
         opCtx->getServiceContext(),
         collectionOptions.storageEngine,
@@ -35,6 +35,7 @@
 #include "mongo/base/shim.h"
 #include "mongo/bson/ordering.h"
 #include "mongo/bson/timestamp.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
@@ -105,6 +106,13 @@ public:
         virtual boost::optional<Timestamp> getMinimumVisibleSnapshot() = 0;
 
         virtual void setMinimumVisibleSnapshot(Timestamp name) = 0;
+
+        virtual IndexBuildInterceptor* indexBuildInterceptor() = 0;
+
+        virtual void setIndexBuildInterceptor(
+            std::unique_ptr<IndexBuildInterceptor> interceptor) = 0;
+
+        virtual std::unique_ptr<IndexBuildInterceptor> releaseIndexBuildInterceptor() = 0;
     };
 
 public:
@@ -251,6 +259,23 @@ public:
         return this->_impl().setMinimumVisibleSnapshot(name);
     }
 
+    /**
+     * If not null, the index is being built by a hybrid index build, and writes to the index
+     * must be recorded with the returned interceptor rather than applied to the index directly.
+     * Changing it requires an exclusive lock on the collection.
+     */
+    IndexBuildInterceptor* indexBuildInterceptor() {
+        return this->_impl().indexBuildInterceptor();
+    }
+
+    void setIndexBuildInterceptor(std::unique_ptr<IndexBuildInterceptor> interceptor) {
+        return this->_impl().setIndexBuildInterceptor(std::move(interceptor));
+    }
+
+    std::unique_ptr<IndexBuildInterceptor> releaseIndexBuildInterceptor() {
+        return this->_impl().releaseIndexBuildInterceptor();
+    }
+
 private:
     // This structure exists to give us a customization point to decide how to force users of this
     // class to depend upon the corresponding `index_catalog_entry.cpp` Translation Unit (TU).  All
@@ -41,6 +41,7 @@
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/matcher/expression_parser.h"
@@ -230,6 +231,16 @@ void IndexCatalogEntryImpl::setIsReady(bool newIsReady) {
     _isReady = newIsReady;
 }
 
+void IndexCatalogEntryImpl::setIndexBuildInterceptor(
+    std::unique_ptr<IndexBuildInterceptor> interceptor) {
+    invariant(!_indexBuildInterceptor);
+    _indexBuildInterceptor = std::move(interceptor);
+}
+
+std::unique_ptr<IndexBuildInterceptor> IndexCatalogEntryImpl::releaseIndexBuildInterceptor() {
+    return std::move(_indexBuildInterceptor);
+}
+
 class IndexCatalogEntryImpl::SetHeadChange : public RecoveryUnit::Change {
 public:
     SetHeadChange(IndexCatalogEntryImpl* ice, RecordId oldHead) : _ice(ice), _oldHead(oldHead) {}
@@ -169,6 +169,14 @@ public:
         _minVisibleSnapshot = name;
     }
 
+    IndexBuildInterceptor* indexBuildInterceptor() final {
+        return _indexBuildInterceptor.get();
+    }
+
+    void setIndexBuildInterceptor(std::unique_ptr<IndexBuildInterceptor> interceptor) final;
+
+    std::unique_ptr<IndexBuildInterceptor> releaseIndexBuildInterceptor() final;
+
 private:
     class SetMultikeyChange;
     class SetHeadChange;
@@ -198,6 +206,9 @@ private:
 
     std::unique_ptr<IndexAccessMethod> _accessMethod;
 
+    // Set while a hybrid index build records the writes to this index on the side.
+    std::unique_ptr<IndexBuildInterceptor> _indexBuildInterceptor;
+
     // Owned here.
     std::unique_ptr<HeadManager> _headManager;
     std::unique_ptr<CollatorInterface> _collator;
@@ -32,6 +32,7 @@
 
 #include "mongo/db/catalog/index_catalog_impl.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -1307,6 +1308,24 @@ Status IndexCatalogImpl::_indexFilteredRecords(OperationContext* opCtx,
     InsertDeleteOptions options;
     prepareInsertDeleteOptions(opCtx, index->descriptor(), &options);
 
+    // Records that need no timestamp of their own are indexed together, in index key order.
+    const bool canInsertAsBatch = bsonRecords.size() > 1 &&
+        std::all_of(bsonRecords.begin(), bsonRecords.end(), [](const BsonRecord& bsonRecord) {
+            return bsonRecord.ts.isNull();
+        });
+    if (canInsertAsBatch) {
+        int64_t inserted;
+        Status status =
+            index->accessMethod()->insertBatch(opCtx, bsonRecords, options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
@@ -30,6 +30,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -50,6 +52,12 @@ namespace {
 // The number of items we can scan before we must yield.
 static const int kScanLimit = 1000;
 
+// Bounds on the number of hash buckets. Between them, there are about as many buckets as there are
+// keys expected in all of the indexes, so that collections with few keys use little memory and
+// the mismatches in large collections are unlikely to cancel each other out.
+const size_t kMinHashBuckets = 1U << 10;
+const size_t kMaxHashBuckets = 1U << 22;
+
 // TODO SERVER-36385: Completely remove the key size check in 4.4
 bool largeKeyDisallowed() {
     return (serverGlobalParams.featureCompatibility.getVersion() ==
@@ -75,6 +83,15 @@ IndexConsistency::IndexConsistency(OperationContext* opCtx,
     IndexCatalog* indexCatalog = _collection->getIndexCatalog();
     IndexCatalog::IndexIterator indexIterator = indexCatalog->getIndexIterator(_opCtx, false);
 
+    const long long numRecords = std::max(recordStore->numRecords(opCtx), 0LL);
+    const size_t expectedKeys =
+        static_cast<size_t>(numRecords) * std::max(indexCatalog->numIndexesTotal(opCtx), 1);
+    size_t numBuckets = kMinHashBuckets;
+    while (numBuckets < expectedKeys && numBuckets < kMaxHashBuckets) {
+        numBuckets <<= 1;
+    }
+    _indexKeyCount.resize(numBuckets, 0);
+
     int indexNumber = 0;
     while (indexIterator.more()) {
 
@@ -124,6 +141,18 @@ void IndexConsistency::addIndexKey(const KeyString& ks, int indexNumber) {
     _addIndexKey_inlock(ks, indexNumber);
 }
 
+void IndexConsistency::addIndexKeyHashes(const std::vector<uint32_t>& hashes, int indexNumber) {
+
+    if (indexNumber < 0 || indexNumber >= static_cast<int>(_indexesInfo.size())) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lock(_classMutex);
+    for (uint32_t hash : hashes) {
+        _addIndexKeyHash_inlock(hash, indexNumber);
+    }
+}
+
 void IndexConsistency::addMultikeyMetadataPath(const KeyString& ks, int indexNumber) {
     if (indexNumber < 0) {
         return;
@@ -131,7 +160,7 @@ void IndexConsistency::addMultikeyMetadataPath(const KeyString& ks, int indexNum
     invariant(static_cast<size_t>(indexNumber) < _indexesInfo.size());
 
     stdx::lock_guard<stdx::mutex> lock(_classMutex);
-    _indexesInfo[indexNumber].hashedMultikeyMetadataPaths.emplace(_hashKeyString(ks, indexNumber));
+    _indexesInfo[indexNumber].hashedMultikeyMetadataPaths.emplace(hashKeyString(ks, indexNumber));
 }
 
 void IndexConsistency::removeMultikeyMetadataPath(const KeyString& ks, int indexNumber) {
@@ -141,7 +170,7 @@ void IndexConsistency::removeMultikeyMetadataPath(const KeyString& ks, int index
     invariant(static_cast<size_t>(indexNumber) < _indexesInfo.size());
 
     stdx::lock_guard<stdx::mutex> lock(_classMutex);
-    _indexesInfo[indexNumber].hashedMultikeyMetadataPaths.erase(_hashKeyString(ks, indexNumber));
+    _indexesInfo[indexNumber].hashedMultikeyMetadataPaths.erase(hashKeyString(ks, indexNumber));
 }
 
 size_t IndexConsistency::getMultikeyMetadataPathCount(int indexNumber) {
@@ -198,13 +227,9 @@ int64_t IndexConsistency::getNumRecords(int indexNumber) const {
 bool IndexConsistency::haveEntryMismatch() const {
 
     stdx::lock_guard<stdx::mutex> lock(_classMutex);
-    for (auto iterator = _indexKeyCount.begin(); iterator != _indexKeyCount.end(); iterator++) {
-        if (iterator->second != 0) {
-            return true;
-        }
-    }
-
-    return false;
+    return std::any_of(_indexKeyCount.begin(), _indexKeyCount.end(), [](uint32_t count) {
+        return count != 0;
+    });
 }
 
 int64_t IndexConsistency::getNumExtraIndexKeys(int indexNumber) const {
@@ -250,29 +275,33 @@ void IndexConsistency::_addDocKey_inlock(const KeyString& ks, int indexNumber) {
         return;
     }
 
-    const uint32_t hash = _hashKeyString(ks, indexNumber);
+    const uint32_t hash = hashKeyString(ks, indexNumber);
     _indexKeyCount[hash]++;
     _indexesInfo.at(indexNumber).numRecords++;
 }
 
 void IndexConsistency::_addIndexKey_inlock(const KeyString& ks, int indexNumber) {
+    _addIndexKeyHash_inlock(hashKeyString(ks, indexNumber), indexNumber);
+}
+
+void IndexConsistency::_addIndexKeyHash_inlock(uint32_t hash, int indexNumber) {
 
     // Ignore indexes that weren't ready before we started validation.
     if (!_indexesInfo.at(indexNumber).isReady) {
         return;
     }
 
-    const uint32_t hash = _hashKeyString(ks, indexNumber);
     _indexKeyCount[hash]--;
     _indexesInfo.at(indexNumber).numKeys++;
 }
 
-uint32_t IndexConsistency::_hashKeyString(const KeyString& ks, int indexNumber) const {
+uint32_t IndexConsistency::hashKeyString(const KeyString& ks, int indexNumber) const {
 
+    // Neither '_indexesInfo' nor the size of '_indexKeyCount' change after construction.
     uint32_t indexNsHash = _indexesInfo.at(indexNumber).indexNsHash;
     MurmurHash3_x86_32(
         ks.getTypeBits().getBuffer(), ks.getTypeBits().getSize(), indexNsHash, &indexNsHash);
     MurmurHash3_x86_32(ks.getBuffer(), ks.getSize(), indexNsHash, &indexNsHash);
-    return indexNsHash % (1U << 22);
+    return indexNsHash % _indexKeyCount.size();
 }
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/storage/key_string.h"
@@ -98,6 +100,19 @@ public:
     void addDocKey(const KeyString& ks, int indexNumber);
     void addIndexKey(const KeyString& ks, int indexNumber);
 
+    /**
+     * Same as calling `addIndexKey` for each of the index entries that 'hashes' were computed from
+     * with `hashKeyString`, but only takes the mutex once. Lets several index traversals run at
+     * once, each buffering a bounded number of hashes between calls.
+     */
+    void addIndexKeyHashes(const std::vector<uint32_t>& hashes, int indexNumber);
+
+    /**
+     * Returns the bucket that the given KeyString of the given index hashes to. Safe to call
+     * without synchronization.
+     */
+    uint32_t hashKeyString(const KeyString& ks, int indexNumber) const;
+
     /**
      * To validate $** multikey metadata paths, we first scan the collection and add a hash of all
      * multikey paths encountered to a set. We then scan the index for multikey metadata path
@@ -172,7 +187,8 @@ private:
     ElapsedTracker _tracker;
 
     // We map the hashed KeyString values to a bucket which contain the count of how many
-    // index keys and document keys we've seen in each bucket.
+    // index keys and document keys we've seen in each bucket. The number of buckets is fixed when
+    // the validation starts, so that the memory used doesn't depend on the number of keys.
     // Count rules:
     //     - If the count is 0 in the bucket, we have index consistency for
     //       KeyStrings that mapped to it
@@ -180,7 +196,7 @@ private:
     //       are too few index entries.
     //     - If the count is < 0 in the bucket at the end of the validation pass, then there
     //       are too many index entries.
-    std::map<uint32_t, uint32_t> _indexKeyCount;
+    std::vector<uint32_t> _indexKeyCount;
 
     // Contains the corresponding index number for each index namespace
     std::map<std::string, int> _indexNumber;
@@ -214,10 +230,6 @@ private:
      * by hashing it.
      */
     void _addIndexKey_inlock(const KeyString& ks, int indexNumber);
-
-    /**
-     * Returns a hashed value from the given KeyString and index namespace.
-     */
-    uint32_t _hashKeyString(const KeyString& ks, int indexNumbers) const;
+    void _addIndexKeyHash_inlock(uint32_t hash, int indexNumber);
 };  // IndexConsistency
 }  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/index_catalog_impl.h"
 #include "mongo/db/index/index_access_method.h"
@@ -47,6 +48,12 @@ class BSONObj;
 class Collection;
 class OperationContext;
 
+/**
+ * The directory under the dbpath where foreground index builds periodically checkpoint their
+ * progress, in a subdirectory named after the UUID of the collection being indexed.
+ */
+constexpr StringData kIndexBuildCheckpointsDirName = "_indexBuildCheckpoints"_sd;
+
 /**
  * Builds one or more indexes.
  *
@@ -70,6 +77,8 @@ public:
 
         virtual void ignoreUniqueConstraint() = 0;
 
+        virtual void allowResumingFromCheckpoint() = 0;
+
         virtual void removeExistingIndexes(std::vector<BSONObj>* specs) const = 0;
 
         virtual StatusWith<std::vector<BSONObj>> init(const std::vector<BSONObj>& specs) = 0;
@@ -159,6 +168,17 @@ public:
         return this->_impl().ignoreUniqueConstraint();
     }
 
+    /**
+     * If this is called before init(), and a previous build of the same indexes on this
+     * collection left a checkpoint behind (see 'indexBuildCheckpointIntervalSecs'), the build
+     * resumes the collection scan after the last checkpointed document instead of starting over.
+     * Only valid when the collection cannot have changed since the checkpoint was taken, such as
+     * when rebuilding interrupted indexes on startup.
+     */
+    inline void allowResumingFromCheckpoint() {
+        return this->_impl().allowResumingFromCheckpoint();
+    }
+
     /**
      * Removes pre-existing indexes from 'specs'. If this isn't done, init() may fail with
      * IndexAlreadyExists.
@@ -32,8 +32,12 @@
 
 #include "mongo/db/catalog/index_create_impl.h"
 
+#include <boost/filesystem/operations.hpp>
+#include <fstream>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/base/init.h"
+#include "mongo/bson/bson_validate.h"
 #include "mongo/db/audit.h"
 #include "mongo/db/background.h"
 #include "mongo/db/catalog/collection.h"
@@ -42,6 +46,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/multi_key_path_tracker.h"
 #include "mongo/db/op_observer.h"
@@ -49,15 +54,22 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/encryption_hooks.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
+#include "mongo/util/file.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/progress_meter.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -71,6 +83,8 @@ MONGO_FAIL_POINT_DEFINE(hangAfterStartingIndexBuildUnlocked);
 MONGO_FAIL_POINT_DEFINE(slowBackgroundIndexBuild);
 MONGO_FAIL_POINT_DEFINE(hangBeforeIndexBuildOf);
 MONGO_FAIL_POINT_DEFINE(hangAfterIndexBuildOf);
+// Checkpoints a foreground build after it has scanned 'numDocs' documents, then interrupts it.
+MONGO_FAIL_POINT_DEFINE(checkpointAndInterruptIndexBuild);
 
 AtomicInt32 maxIndexBuildMemoryUsageMegabytes(500);
 
@@ -101,6 +115,107 @@ public:
 
 } exportedMaxIndexBuildMemoryUsageParameter;
 
+namespace {
+
+// The upper bound on 'maxIndexBuildKeyGenerationThreads'.
+constexpr int kMaxKeyGenerationThreads = 64;
+
+MONGO_EXPORT_SERVER_PARAMETER(maxIndexBuildKeyGenerationThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > kMaxKeyGenerationThreads) {
+            return Status(ErrorCodes::BadValue,
+                          "maxIndexBuildKeyGenerationThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+// Limits on the documents buffered by a foreground build generating keys on several threads. The
+// buffer counts against 'maxIndexBuildMemoryUsageMegabytes'.
+constexpr size_t kKeyGenerationBatchMaxDocs = 10 * 1000;
+constexpr size_t kKeyGenerationBatchMaxBytes = 16 * 1024 * 1024;
+
+ThreadPool* getKeyGenerationThreadPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "IndexBuildKeyGeneration";
+        options.minThreads = 0;
+        options.maxThreads = kMaxKeyGenerationThreads;
+
+        auto newPool = new ThreadPool(options);
+        newPool->startup();
+        return newPool;
+    }();
+    return pool;
+}
+
+// Whether background index builds bulk load the indexes they can, while recording the writes
+// concurrent with the collection scan on the side, rather than insert into them key by key.
+MONGO_EXPORT_SERVER_PARAMETER(enableHybridIndexBuilds, bool, true);
+
+// How often a foreground index build persists its progress, so that the build can resume from
+// there if the node restarts before it completes. Zero disables checkpointing.
+MONGO_EXPORT_SERVER_PARAMETER(indexBuildCheckpointIntervalSecs, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "indexBuildCheckpointIntervalSecs must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
+// The file, in the checkpoint directory of a build, describing the latest checkpoint. It is
+// written next to it first and then renamed into place, so it is always complete.
+constexpr StringData kCheckpointFileName = "checkpoint"_sd;
+constexpr StringData kCheckpointTempFileName = "checkpoint.tmp"_sd;
+
+// The fields of a checkpoint.
+constexpr StringData kLastRecordIdFieldName = "lastRecordId"_sd;
+constexpr StringData kNumRecordsFieldName = "numRecords"_sd;
+constexpr StringData kIndexesFieldName = "indexes"_sd;
+constexpr StringData kSpecFieldName = "spec"_sd;
+constexpr StringData kBulkFieldName = "bulk"_sd;
+
+/**
+ * Returns the document stored in 'fileName', or an empty document if there is no such file.
+ */
+BSONObj readCheckpointFile(const std::string& fileName) {
+    if (!boost::filesystem::exists(fileName)) {
+        return BSONObj();
+    }
+
+    std::ifstream file(fileName, std::ios::in | std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    uassert(ErrorCodes::FileStreamFailed,
+            str::stream() << "error reading index build checkpoint " << fileName,
+            !file.bad());
+    uassertStatusOK(validateBSON(contents.data(), contents.size(), BSONVersion::kLatest));
+    return BSONObj(contents.data()).getOwned();
+}
+
+/**
+ * Durably replaces the contents of 'fileName' with 'obj'.
+ */
+void writeCheckpointFile(const std::string& dir, StringData fileName, const BSONObj& obj) {
+    const std::string tempFileName = dir + "/" + kCheckpointTempFileName;
+    boost::filesystem::remove(tempFileName);
+
+    File file;
+    file.open(tempFileName.c_str());
+    if (!file.bad()) {
+        file.write(0, obj.objdata(), obj.objsize());
+    }
+    if (!file.bad()) {
+        file.fsync();
+    }
+    uassert(ErrorCodes::FileNotOpen,
+            str::stream() << "error writing index build checkpoint " << tempFileName,
+            !file.bad());
+
+    boost::filesystem::rename(tempFileName, dir + "/" + fileName);
+}
+
+}  // namespace
+
 
 /**
  * On rollback sets MultiIndexBlockImpl::_needToCleanup to true.
@@ -145,6 +260,19 @@ MultiIndexBlockImpl::MultiIndexBlockImpl(OperationContext* opCtx, Collection* co
       _needToCleanup(true) {}
 
 MultiIndexBlockImpl::~MultiIndexBlockImpl() {
+    for (auto& interceptor : _finishedInterceptors) {
+        interceptor->deleteTemporaryTable(_opCtx);
+    }
+
+    if (!_checkpointDir.empty() && !_keepCheckpoint) {
+        boost::system::error_code ec;
+        boost::filesystem::remove_all(_checkpointDir, ec);
+        if (ec) {
+            warning() << "Failed to remove index build checkpoint " << _checkpointDir << ": "
+                      << ec.message();
+        }
+    }
+
     if (!_needToCleanup && !_indexes.empty()) {
         _collection->infoCache()->clearQueryCache();
     }
@@ -155,6 +283,12 @@ MultiIndexBlockImpl::~MultiIndexBlockImpl() {
     // Make lock acquisition uninterruptible because onOpMessage() can take locks.
     UninterruptibleLockGuard noInterrupt(_opCtx->lockState());
 
+    for (auto& index : _indexes) {
+        if (auto interceptor = index.block->getEntry()->releaseIndexBuildInterceptor()) {
+            interceptor->deleteTemporaryTable(_opCtx);
+        }
+    }
+
     while (true) {
         try {
             WriteUnitOfWork wunit(_opCtx);
@@ -233,13 +367,36 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         _buildInBackground = (_buildInBackground && info["background"].trueValue());
     }
 
+    // Generating the keys on several threads only helps when there are several indexes to split
+    // among them, and is only possible when all of them are built in bulk.
+    _keyGenerationThreads = _buildInBackground
+        ? 1
+        : std::min(static_cast<size_t>(maxIndexBuildKeyGenerationThreads.load()),
+                   indexSpecs.size());
+
+    // Only foreground builds can checkpoint, since a checkpoint holds the keys of all the
+    // documents scanned so far, which requires the collection not to change under the build.
+    // The sorter encrypts its files with keys that do not survive a restart.
+    const auto storageEngine = _opCtx->getServiceContext()->getStorageEngine();
+    if (!_buildInBackground && !indexSpecs.empty() && _collection->uuid() &&
+        !storageEngine->isEphemeral() &&
+        !EncryptionHooks::get(_opCtx->getServiceContext())->enabled()) {
+        _checkpointDir = str::stream() << storageGlobalParams.dbpath << "/"
+                                       << kIndexBuildCheckpointsDirName << "/"
+                                       << _collection->uuid()->toString();
+        _loadCheckpoint(indexSpecs);
+    }
+
     std::vector<BSONObj> indexInfoObjs;
     indexInfoObjs.reserve(indexSpecs.size());
     std::size_t eachIndexBuildMaxMemoryUsageBytes = 0;
     if (!indexSpecs.empty()) {
-        eachIndexBuildMaxMemoryUsageBytes =
-            static_cast<std::size_t>(maxIndexBuildMemoryUsageMegabytes.load()) * 1024 * 1024 /
-            indexSpecs.size();
+        std::size_t maxMemoryUsageBytes =
+            static_cast<std::size_t>(maxIndexBuildMemoryUsageMegabytes.load()) * 1024 * 1024;
+        if (_keyGenerationThreads > 1) {
+            maxMemoryUsageBytes -= kKeyGenerationBatchMaxBytes;
+        }
+        eachIndexBuildMaxMemoryUsageBytes = maxMemoryUsageBytes / indexSpecs.size();
     }
 
     for (size_t i = 0; i < indexSpecs.size(); i++) {
@@ -263,10 +420,23 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (!status.isOK())
             return status;
 
-        if (!_buildInBackground) {
+        if (!_checkpointDir.empty()) {
+            index.bulk = _initiateResumableBulk(index.real, i, eachIndexBuildMaxMemoryUsageBytes);
+        } else if (!_buildInBackground) {
             // Bulk build process requires foreground building as it assumes nothing is changing
             // under it.
             index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
+        } else if (enableHybridIndexBuilds.load() &&
+                   !index.block->getEntry()->descriptor()->unique()) {
+            // A hybrid build bulk loads the index from a yielding collection scan, and applies
+            // the writes made since init() afterwards. A unique index could see transient
+            // duplicates in the scan, so it is built by inserting into it directly.
+            index.block->getEntry()->setIndexBuildInterceptor(
+                stdx::make_unique<IndexBuildInterceptor>(_opCtx));
+            index.bulk = index.real->initiateBulk(eachIndexBuildMaxMemoryUsageBytes);
+        }
+        if (!index.bulk) {
+            _keyGenerationThreads = 1;
         }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
@@ -281,6 +451,8 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         if (index.bulk)
             log() << "\t building index using bulk method; build may temporarily use up to "
                   << eachIndexBuildMaxMemoryUsageBytes / 1024 / 1024 << " megabytes of RAM";
+        if (index.block->getEntry()->indexBuildInterceptor())
+            log() << "\t recording concurrent writes to the index on the side";
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
 
@@ -290,6 +462,9 @@ StatusWith<std::vector<BSONObj>> MultiIndexBlockImpl::init(const std::vector<BSO
         _indexes.push_back(std::move(index));
     }
 
+    if (_keyGenerationThreads > 1)
+        log() << "\t generating index keys on " << _keyGenerationThreads << " threads";
+
     if (_buildInBackground)
         _backgroundOperation.reset(new BackgroundOperation(ns));
 
@@ -359,8 +534,22 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
     } else {
         yieldPolicy = PlanExecutor::WRITE_CONFLICT_RETRY_ONLY;
     }
-    auto exec =
-        InternalPlanner::collectionScan(_opCtx, _collection->ns().ns(), _collection, yieldPolicy);
+    // A resumed build picks the scan up at the last document the bulk builders already have.
+    auto exec = InternalPlanner::collectionScan(_opCtx,
+                                                _collection->ns().ns(),
+                                                _collection,
+                                                yieldPolicy,
+                                                InternalPlanner::FORWARD,
+                                                _resumeAfter.value_or(RecordId()));
+
+    const int checkpointIntervalSecs =
+        _checkpointDir.empty() ? 0 : indexBuildCheckpointIntervalSecs.load();
+    Timer sinceCheckpoint;
+
+    // Documents scanned but not yet handed to the bulk builders, when generating keys on several
+    // threads.
+    std::vector<std::pair<BSONObj, RecordId>> keyGenerationBatch;
+    size_t keyGenerationBatchBytes = 0;
 
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
@@ -381,6 +570,11 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
                 continue;
             }
 
+            if (_resumeAfter && loc <= *_resumeAfter) {
+                retries = 0;
+                continue;
+            }
+
             // Make sure we are working with the latest version of the document.
             if (objToIndex.snapshotId() != _opCtx->recoveryUnit()->getSnapshotId() &&
                 !_collection->findDoc(_opCtx, loc, &objToIndex)) {
@@ -394,19 +588,35 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
 
             failPointHangDuringBuild(&hangBeforeIndexBuildOf, "before", objToIndex.value());
 
-            WriteUnitOfWork wunit(_opCtx);
-            Status ret = insert(objToIndex.value(), loc);
-            if (_buildInBackground)
-                exec->saveState();
-            if (!ret.isOK()) {
-                // Fail the index build hard.
-                return ret;
-            }
-            wunit.commit();
-            if (_buildInBackground) {
-                auto restoreStatus = exec->restoreState();  // Handles any WCEs internally.
-                if (!restoreStatus.isOK()) {
-                    return restoreStatus;
+            if (_keyGenerationThreads > 1) {
+                // Foreground builds only feed bulk builders, which do not write to storage, so
+                // no unit of work is needed.
+                keyGenerationBatchBytes += objToIndex.value().objsize();
+                keyGenerationBatch.emplace_back(objToIndex.value().getOwned(), loc);
+                if (keyGenerationBatch.size() >= kKeyGenerationBatchMaxDocs ||
+                    keyGenerationBatchBytes >= kKeyGenerationBatchMaxBytes) {
+                    Status ret = _insertBatchIntoBulkBuilders(keyGenerationBatch);
+                    if (!ret.isOK()) {
+                        return ret;
+                    }
+                    keyGenerationBatch.clear();
+                    keyGenerationBatchBytes = 0;
+                }
+            } else {
+                WriteUnitOfWork wunit(_opCtx);
+                Status ret = insert(objToIndex.value(), loc);
+                if (_buildInBackground)
+                    exec->saveState();
+                if (!ret.isOK()) {
+                    // Fail the index build hard.
+                    return ret;
+                }
+                wunit.commit();
+                if (_buildInBackground) {
+                    auto restoreStatus = exec->restoreState();  // Handles any WCEs internally.
+                    if (!restoreStatus.isOK()) {
+                        return restoreStatus;
+                    }
                 }
             }
 
@@ -416,6 +626,32 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
             progress->hit();
             n++;
             retries = 0;
+
+            bool interruptAfterCheckpoint = false;
+            MONGO_FAIL_POINT_BLOCK(checkpointAndInterruptIndexBuild, data) {
+                interruptAfterCheckpoint = !_checkpointDir.empty() &&
+                    n == static_cast<unsigned long long>(data.getData()["numDocs"].numberLong());
+            }
+
+            const bool checkpointDue = checkpointIntervalSecs > 0 &&
+                sinceCheckpoint.seconds() >= checkpointIntervalSecs;
+            if (checkpointDue || interruptAfterCheckpoint) {
+                if (!keyGenerationBatch.empty()) {
+                    Status ret = _insertBatchIntoBulkBuilders(keyGenerationBatch);
+                    if (!ret.isOK()) {
+                        return ret;
+                    }
+                    keyGenerationBatch.clear();
+                    keyGenerationBatchBytes = 0;
+                }
+                _writeCheckpoint(loc);
+                sinceCheckpoint.reset();
+
+                if (interruptAfterCheckpoint) {
+                    return Status(ErrorCodes::Interrupted,
+                                  "checkpointAndInterruptIndexBuild fail point enabled");
+                }
+            }
         } catch (const WriteConflictException&) {
             CurOp::get(_opCtx)->debug().additiveMetrics.incrementWriteConflicts(1);
             retries++;  // logAndBackoff expects this to be 1 on first call.
@@ -437,6 +673,13 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
         return WorkingSetCommon::getMemberObjectStatus(objToIndex.value());
     }
 
+    if (!keyGenerationBatch.empty()) {
+        Status ret = _insertBatchIntoBulkBuilders(keyGenerationBatch);
+        if (!ret.isOK()) {
+            return ret;
+        }
+    }
+
     if (MONGO_FAIL_POINT(hangAfterStartingIndexBuildUnlocked)) {
         // Unlock before hanging so replication recognizes we've completed.
         Locker::LockSnapshot lockInfo;
@@ -464,6 +707,12 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
     if (!ret.isOK())
         return ret;
 
+    // Catch the hybrid indexes up with the writes made during the scan, so that only the writes
+    // made since are left to apply under the exclusive lock in commit().
+    ret = _drainSideWrites();
+    if (!ret.isOK())
+        return ret;
+
     log() << "build index done.  scanned " << n << " total records. " << t.seconds() << " secs";
 
     return Status::OK();
@@ -471,24 +720,219 @@ Status MultiIndexBlockImpl::insertAllDocumentsInCollection() {
 
 Status MultiIndexBlockImpl::insert(const BSONObj& doc, const RecordId& loc) {
     for (size_t i = 0; i < _indexes.size(); i++) {
-        if (_indexes[i].filterExpression && !_indexes[i].filterExpression->matchesBSON(doc)) {
-            continue;
+        Status idxStatus = _insertIntoIndex(&_indexes[i], doc, loc);
+        if (!idxStatus.isOK())
+            return idxStatus;
+    }
+    return Status::OK();
+}
+
+Status MultiIndexBlockImpl::_insertIntoIndex(IndexToBuild* index,
+                                             const BSONObj& doc,
+                                             const RecordId& loc) {
+    if (index->filterExpression && !index->filterExpression->matchesBSON(doc)) {
+        return Status::OK();
+    }
+
+    if (index->bulk) {
+        return index->bulk->insert(_opCtx, doc, loc, index->options);
+    }
+
+    int64_t unused;
+    return index->real->insert(_opCtx, doc, loc, index->options, &unused);
+}
+
+Status MultiIndexBlockImpl::_insertBatchIntoBulkBuilders(
+    const std::vector<std::pair<BSONObj, RecordId>>& batch) {
+    // Every task generates the keys of the whole batch for its own share of the indexes, so no
+    // two threads ever use the same BulkBuilder.
+    const size_t numTasks = std::min(_keyGenerationThreads, _indexes.size());
+    auto runTask = [this, &batch, numTasks](size_t task) {
+        try {
+            for (size_t i = task; i < _indexes.size(); i += numTasks) {
+                invariant(_indexes[i].bulk);
+                for (const auto& docAndLoc : batch) {
+                    Status status =
+                        _insertIntoIndex(&_indexes[i], docAndLoc.first, docAndLoc.second);
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+            }
+        } catch (const DBException& ex) {
+            return ex.toStatus();
         }
+        return Status::OK();
+    };
 
-        int64_t unused;
-        Status idxStatus(ErrorCodes::InternalError, "");
-        if (_indexes[i].bulk) {
-            idxStatus = _indexes[i].bulk->insert(_opCtx, doc, loc, _indexes[i].options);
-        } else {
-            idxStatus = _indexes[i].real->insert(_opCtx, doc, loc, _indexes[i].options, &unused);
+    stdx::mutex mutex;
+    stdx::condition_variable tasksFinished;
+    size_t numRunning = 0;
+    std::vector<Status> statuses(numTasks, Status::OK());
+
+    for (size_t task = 1; task < numTasks; ++task) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ++numRunning;
         }
+        auto scheduleStatus = getKeyGenerationThreadPool()->schedule([&, task] {
+            Status status = runTask(task);
+
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            statuses[task] = std::move(status);
+            --numRunning;
+            tasksFinished.notify_all();
+        });
+
+        if (!scheduleStatus.isOK()) {
+            // Fall back to generating this share of the keys on this thread.
+            {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                --numRunning;
+            }
+            statuses[task] = runTask(task);
+        }
+    }
 
-        if (!idxStatus.isOK())
-            return idxStatus;
+    statuses[0] = runTask(0);
+
+    // The tasks refer to 'batch' and to the locals above, so they must all finish regardless of
+    // interruption. Each only has one batch worth of work left.
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        tasksFinished.wait(lk, [&] { return numRunning == 0; });
+    }
+
+    for (auto& status : statuses) {
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    return Status::OK();
+}
+
+Status MultiIndexBlockImpl::_drainSideWrites() {
+    for (auto& index : _indexes) {
+        if (auto interceptor = index.block->getEntry()->indexBuildInterceptor()) {
+            Status status = interceptor->drainWritesIntoIndex(_opCtx, index.real, index.options);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
     }
     return Status::OK();
 }
 
+void MultiIndexBlockImpl::_loadCheckpoint(const std::vector<BSONObj>& indexSpecs) {
+    _resumeAfter = boost::none;
+    _resumedBulkStates.clear();
+
+    if (_allowResume) {
+        try {
+            const BSONObj checkpoint =
+                readCheckpointFile(_checkpointDir + "/" + kCheckpointFileName);
+            if (!checkpoint.isEmpty()) {
+                const RecordId lastRecordId(checkpoint[kLastRecordIdFieldName].numberLong());
+                const auto indexes = checkpoint[kIndexesFieldName].Array();
+
+                // The collection cannot have changed since the checkpoint, or the keys it holds
+                // would be stale.
+                bool matches = indexes.size() == indexSpecs.size() &&
+                    checkpoint[kNumRecordsFieldName].numberLong() ==
+                        static_cast<long long>(_collection->numRecords(_opCtx));
+                for (size_t i = 0; matches && i < indexes.size(); i++) {
+                    matches = indexes[i].Obj()[kSpecFieldName].Obj().woCompare(indexSpecs[i]) == 0;
+                }
+                Snapshotted<BSONObj> lastDoc;
+                matches = matches && _collection->findDoc(_opCtx, lastRecordId, &lastDoc);
+
+                if (matches) {
+                    for (const auto& index : indexes) {
+                        _resumedBulkStates.push_back(index.Obj()[kBulkFieldName].Obj().getOwned());
+                    }
+                    _resumeAfter = lastRecordId;
+                    log() << "resuming index build on " << _collection->ns()
+                          << " from checkpoint after " << lastRecordId;
+                    return;
+                }
+
+                log() << "not resuming index build on " << _collection->ns()
+                      << " from a checkpoint of a different build: " << redact(checkpoint);
+            }
+        } catch (const DBException& ex) {
+            warning() << "Failed to read index build checkpoint " << _checkpointDir << ": "
+                      << redact(ex);
+        } catch (const std::exception& ex) {
+            warning() << "Failed to read index build checkpoint " << _checkpointDir << ": "
+                      << ex.what();
+        }
+    }
+
+    // Whatever a previous build left behind is of no use to this one.
+    _resumedBulkStates.clear();
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(_checkpointDir, ec);
+}
+
+std::unique_ptr<IndexAccessMethod::BulkBuilder> MultiIndexBlockImpl::_initiateResumableBulk(
+    IndexAccessMethod* index, size_t indexNum, size_t maxMemoryUsageBytes) {
+    if (_resumeAfter) {
+        try {
+            return index->initiateResumableBulk(
+                maxMemoryUsageBytes, _checkpointDir, _resumedBulkStates[indexNum]);
+        } catch (const DBException& ex) {
+            warning() << "Failed to resume index build from checkpoint " << _checkpointDir << ": "
+                      << redact(ex);
+        } catch (const std::exception& ex) {
+            warning() << "Failed to resume index build from checkpoint " << _checkpointDir << ": "
+                      << ex.what();
+        }
+
+        // Start the whole build over, including the indexes already resumed.
+        _resumeAfter = boost::none;
+        _resumedBulkStates.clear();
+        for (auto& built : _indexes) {
+            built.bulk =
+                built.real->initiateResumableBulk(maxMemoryUsageBytes, _checkpointDir, BSONObj());
+        }
+        boost::system::error_code ec;
+        boost::filesystem::remove(_checkpointDir + "/" + kCheckpointFileName, ec);
+    }
+
+    return index->initiateResumableBulk(maxMemoryUsageBytes, _checkpointDir, BSONObj());
+}
+
+void MultiIndexBlockImpl::_writeCheckpoint(const RecordId& lastRecordId) {
+    try {
+        BSONObjBuilder builder;
+        builder.append(kLastRecordIdFieldName, static_cast<long long>(lastRecordId.repr()));
+        builder.append(kNumRecordsFieldName,
+                       static_cast<long long>(_collection->numRecords(_opCtx)));
+        {
+            BSONArrayBuilder indexes(builder.subarrayStart(kIndexesFieldName));
+            for (const auto& index : _indexes) {
+                BSONObjBuilder indexBuilder(indexes.subobjStart());
+                indexBuilder.append(kSpecFieldName, index.block->getSpec());
+                indexBuilder.append(kBulkFieldName, index.bulk->persistState());
+            }
+        }
+
+        // The scanned documents must survive a restart as long as the checkpoint does.
+        _opCtx->recoveryUnit()->waitUntilDurable();
+
+        boost::filesystem::create_directories(_checkpointDir);
+        writeCheckpointFile(_checkpointDir, kCheckpointFileName, builder.obj());
+        LOG(1) << "checkpointed index build on " << _collection->ns() << " after "
+               << lastRecordId;
+    } catch (const DBException& ex) {
+        warning() << "Failed to checkpoint index build on " << _collection->ns() << ": "
+                  << redact(ex);
+    } catch (const std::exception& ex) {
+        warning() << "Failed to checkpoint index build on " << _collection->ns() << ": "
+                  << ex.what();
+    }
+}
+
 Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
     invariant(!_opCtx->lockState()->inAWriteUnitOfWork());
     for (size_t i = 0; i < _indexes.size(); i++) {
@@ -510,6 +954,16 @@ Status MultiIndexBlockImpl::doneInserting(std::set<RecordId>* dupsOut) {
 }
 
 void MultiIndexBlockImpl::abortWithoutCleanup() {
+    // Leave the latest checkpoint for the next attempt at this build.
+    if (!_checkpointDir.empty()) {
+        for (auto& index : _indexes) {
+            if (index.bulk) {
+                index.bulk->keepPersistedState();
+            }
+        }
+        _keepCheckpoint = true;
+    }
+
     _indexes.clear();
     _needToCleanup = false;
 }
@@ -523,6 +977,18 @@ void MultiIndexBlockImpl::commit(stdx::function<void(const BSONObj& spec)> onCre
     }
     MultikeyPathTracker::get(_opCtx).stopTrackingMultikeyPathInfo();
 
+    // No more writes can be recorded on the side once the caller has an exclusive lock.
+    uassertStatusOK(_drainSideWrites());
+    for (auto& index : _indexes) {
+        auto entry = index.block->getEntry();
+        if (auto interceptor = entry->indexBuildInterceptor()) {
+            invariant(interceptor->areAllWritesApplied(_opCtx));
+            _opCtx->recoveryUnit()->onCommit([this, entry](boost::optional<Timestamp>) {
+                _finishedInterceptors.push_back(entry->releaseIndexBuildInterceptor());
+            });
+        }
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (onCreateFn) {
             onCreateFn(_indexes[i].block->getSpec());
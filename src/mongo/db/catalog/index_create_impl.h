@@ -33,8 +33,11 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/index_catalog.h"
@@ -47,6 +50,7 @@ namespace mongo {
 class BackgroundOperation;
 class BSONObj;
 class Collection;
+class IndexBuildInterceptor;
 class OperationContext;
 
 /**
@@ -101,6 +105,14 @@ public:
         _ignoreUnique = true;
     }
 
+    /**
+     * If this is called before init(), the build resumes from the checkpoint left by an earlier
+     * build of the same indexes on this collection, if there is a usable one.
+     */
+    void allowResumingFromCheckpoint() override {
+        _allowResume = true;
+    }
+
     /**
      * Removes pre-existing indexes from 'specs'. If this isn't done, init() may fail with
      * IndexAlreadyExists.
@@ -200,8 +212,63 @@ private:
         InsertDeleteOptions options;
     };
 
+    /**
+     * Inserts 'doc' into 'index', unless it is excluded by the index's filter.
+     */
+    Status _insertIntoIndex(IndexToBuild* index, const BSONObj& doc, const RecordId& loc);
+
+    /**
+     * Generates the keys of every document in 'batch' into the bulk builders of all the indexes,
+     * with up to '_keyGenerationThreads' threads each taking a share of the indexes.
+     */
+    Status _insertBatchIntoBulkBuilders(const std::vector<std::pair<BSONObj, RecordId>>& batch);
+
+    /**
+     * Reads the checkpoint in '_checkpointDir' and, if it was taken by a build of 'indexSpecs' on
+     * the collection as it is now, fills in '_resumeAfter' and '_resumedBulkStates'. Otherwise
+     * removes whatever a previous build left in '_checkpointDir'.
+     */
+    void _loadCheckpoint(const std::vector<BSONObj>& indexSpecs);
+
+    /**
+     * Applies the writes recorded on the side so far to the indexes built by a hybrid build.
+     */
+    Status _drainSideWrites();
+
+    /**
+     * Returns a bulk builder for the 'indexNum'th index, spilling to '_checkpointDir' and
+     * starting out from that index's checkpointed state when resuming. If that state cannot be
+     * loaded, gives up on resuming, for the indexes already initialized as well.
+     */
+    std::unique_ptr<IndexAccessMethod::BulkBuilder> _initiateResumableBulk(
+        IndexAccessMethod* index, size_t indexNum, size_t maxMemoryUsageBytes);
+
+    /**
+     * Persists the state of every bulk builder, which must have been given every document up to
+     * and including 'lastRecordId', to '_checkpointDir'.
+     */
+    void _writeCheckpoint(const RecordId& lastRecordId);
+
     std::vector<IndexToBuild> _indexes;
 
+    // The number of threads generating keys for a foreground build. If greater than one, the
+    // collection scan buffers documents and hands them to the bulk builders in batches.
+    size_t _keyGenerationThreads = 1;
+
+    // Where this build checkpoints its progress, or empty if it does not.
+    std::string _checkpointDir;
+
+    // If resuming from a checkpoint, the last document the checkpointed build had scanned, and
+    // the bulk builder states it persisted, one per index.
+    boost::optional<RecordId> _resumeAfter;
+    std::vector<BSONObj> _resumedBulkStates;
+
+    // The interceptors of the hybrid indexes, once committed, whose tables are left to drop.
+    std::vector<std::unique_ptr<IndexBuildInterceptor>> _finishedInterceptors;
+
+    // Set by abortWithoutCleanup() to leave the checkpoint for the next attempt at this build.
+    bool _keepCheckpoint = false;
+
     std::unique_ptr<BackgroundOperation> _backgroundOperation;
 
     // Pointers not owned here and must outlive 'this'
@@ -211,6 +278,7 @@ private:
     bool _buildInBackground;
     bool _allowInterruption;
     bool _ignoreUnique;
+    bool _allowResume = false;
 
     bool _needToCleanup;
 };
@@ -0,0 +1,176 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/catalog/online_compact.h"
+
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/curop.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/progress_meter.h"
+
+namespace mongo {
+
+namespace {
+
+struct StepResult {
+    bool complete = true;
+    long long bytesReclaimed = 0;
+};
+
+/**
+ * Runs one compaction step on the record store of the collection, or on the index named
+ * 'indexName' if set, under intent locks. An index that has been dropped since compaction started
+ * counts as complete.
+ */
+StatusWith<StepResult> runStep(OperationContext* opCtx,
+                               const NamespaceString& nss,
+                               const OptionalCollectionUUID& uuid,
+                               const boost::optional<std::string>& indexName,
+                               Seconds stepTimeout) {
+    AutoGetCollection autoColl(opCtx, nss, MODE_IX);
+    Collection* collection = autoColl.getCollection();
+    if (!collection || collection->uuid() != uuid) {
+        return {ErrorCodes::NamespaceNotFound,
+                str::stream() << "collection " << nss.ns() << " was dropped during compact"};
+    }
+
+    StepResult result;
+    if (!indexName) {
+        RecordStore* rs = collection->getRecordStore();
+        const auto sizeBefore = rs->storageSize(opCtx);
+        auto swComplete = rs->compactStep(opCtx, stepTimeout);
+        if (!swComplete.isOK()) {
+            return swComplete.getStatus();
+        }
+        result.complete = swComplete.getValue();
+        result.bytesReclaimed = std::max<long long>(0, sizeBefore - rs->storageSize(opCtx));
+        return result;
+    }
+
+    IndexCatalog* indexCatalog = collection->getIndexCatalog();
+    IndexDescriptor* descriptor = indexCatalog->findIndexByName(opCtx, *indexName);
+    if (!descriptor) {
+        return result;
+    }
+
+    IndexAccessMethod* index = indexCatalog->getIndex(descriptor);
+    const auto sizeBefore = index->getSpaceUsedBytes(opCtx);
+    auto swComplete = index->compactStep(opCtx, stepTimeout);
+    if (!swComplete.isOK()) {
+        return swComplete.getStatus();
+    }
+    result.complete = swComplete.getValue();
+    result.bytesReclaimed = std::max<long long>(0, sizeBefore - index->getSpaceUsedBytes(opCtx));
+    return result;
+}
+
+}  // namespace
+
+StatusWith<OnlineCompactStats> compactCollectionOnline(OperationContext* opCtx,
+                                                       const NamespaceString& nss,
+                                                       const OnlineCompactOptions& options) {
+    OptionalCollectionUUID uuid;
+    std::vector<boost::optional<std::string>> targets{boost::none};
+    {
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return {ErrorCodes::NamespaceNotFound, "collection does not exist"};
+        }
+
+        RecordStore* rs = collection->getRecordStore();
+        if (!rs->compactSupported() || !rs->compactsInPlace()) {
+            return {ErrorCodes::CommandNotSupported,
+                    str::stream() << "cannot compact collection online with record store: "
+                                  << rs->name()};
+        }
+
+        uuid = collection->uuid();
+        IndexCatalog::IndexIterator ii(
+            collection->getIndexCatalog()->getIndexIterator(opCtx, false));
+        while (ii.more()) {
+            targets.push_back(ii.next()->indexName());
+        }
+    }
+
+    const char* curopMessage = "Online Compact";
+    stdx::unique_lock<Client> lk(*opCtx->getClient());
+    ProgressMeterHolder progress(
+        CurOp::get(opCtx)->setMessage_inlock(curopMessage, curopMessage, targets.size()));
+    lk.unlock();
+
+    OnlineCompactStats stats;
+    for (const auto& target : targets) {
+        const std::string targetName = target ? *target : std::string("collection");
+        LOG(1) << "online compact of " << nss << " starting on " << targetName;
+
+        for (bool complete = false; !complete;) {
+            if (stats.steps > 0) {
+                opCtx->sleepFor(options.pauseBetweenSteps);
+            }
+            opCtx->checkForInterrupt();
+
+            auto swStep = runStep(opCtx, nss, uuid, target, options.stepTimeout);
+            if (!swStep.isOK()) {
+                return swStep.getStatus();
+            }
+
+            complete = swStep.getValue().complete;
+            stats.steps++;
+            stats.bytesReclaimed += swStep.getValue().bytesReclaimed;
+
+            stdx::lock_guard<Client> lk(*opCtx->getClient());
+            CurOp::get(opCtx)->setProgressDetails_inlock(
+                BSON("target" << targetName << "steps" << stats.steps << "bytesReclaimed"
+                              << stats.bytesReclaimed));
+        }
+
+        progress.hit();
+    }
+
+    return stats;
+}
+
+}  // namespace mongo
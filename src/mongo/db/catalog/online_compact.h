@@ -0,0 +1,67 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+#include "mongo/util/duration.h"
+
+namespace mongo {
+
+class NamespaceString;
+class OperationContext;
+
+struct OnlineCompactOptions {
+    // Longest time a single compaction step may run before giving its locks back.
+    Seconds stepTimeout{1};
+
+    // Time to sleep between steps, which bounds the share of the storage engine's I/O that
+    // compaction may take from other operations.
+    Milliseconds pauseBetweenSteps{100};
+};
+
+struct OnlineCompactStats {
+    long long steps = 0;
+    long long bytesReclaimed = 0;
+};
+
+/**
+ * Compacts the collection 'nss' and its finished indexes in place without blocking other
+ * operations. Each step holds only intent locks and ends after about options.stepTimeout, and the
+ * operation sleeps for options.pauseBetweenSteps between steps. currentOp reports which part of the
+ * collection is being compacted and how many bytes have been reclaimed so far.
+ *
+ * No progress is persisted: every step begins by looking for reclaimable space, so running this
+ * again after an interruption or a restart continues where the previous run stopped.
+ */
+StatusWith<OnlineCompactStats> compactCollectionOnline(OperationContext* opCtx,
+                                                       const NamespaceString& nss,
+                                                       const OnlineCompactOptions& options);
+
+}  // namespace mongo
@@ -54,6 +54,10 @@ bool isLargeKeyDisallowed() {
         ServerGlobalParams::FeatureCompatibility::Version::kFullyDowngradedTo40;
 }
 
+// The number of index key hashes that an index traversal buffers before adding them to the
+// IndexConsistency.
+const size_t kIndexKeyHashBatchSize = 1024;
+
 KeyString makeWildCardMultikeyMetadataKeyString(const BSONObj& indexKey) {
     const auto multikeyMetadataOrd = Ordering::make(BSON("" << 1 << "" << 1));
     const RecordId multikeyMetadataRecordId(RecordId::ReservedId::kAllPathsMultikeyMetadataId);
@@ -140,7 +144,8 @@ Status RecordStoreValidateAdaptor::validate(const RecordId& recordId,
     return status;
 }
 
-void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
+void RecordStoreValidateAdaptor::traverseIndex(OperationContext* opCtx,
+                                               const IndexAccessMethod* iam,
                                                const IndexDescriptor* descriptor,
                                                ValidateResults* results,
                                                int64_t* numTraversedKeys) {
@@ -154,7 +159,10 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
     std::unique_ptr<KeyString> prevIndexKeyString = nullptr;
     bool isFirstEntry = true;
 
-    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(_opCtx, true);
+    std::vector<uint32_t> keyHashes;
+    keyHashes.reserve(kIndexKeyHashBatchSize);
+
+    std::unique_ptr<SortedDataInterface::Cursor> cursor = iam->newCursor(opCtx, true);
     // Seeking to BSONObj() is equivalent to seeking to the first entry of an index.
     for (auto indexEntry = cursor->seek(BSONObj(), true); indexEntry; indexEntry = cursor->next()) {
 
@@ -181,12 +189,17 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
             continue;
         }
 
-        _indexConsistency->addIndexKey(*indexKeyString, indexNumber);
+        keyHashes.push_back(_indexConsistency->hashKeyString(*indexKeyString, indexNumber));
+        if (keyHashes.size() == kIndexKeyHashBatchSize) {
+            _indexConsistency->addIndexKeyHashes(keyHashes, indexNumber);
+            keyHashes.clear();
+        }
 
         numKeys++;
         isFirstEntry = false;
         prevIndexKeyString.swap(indexKeyString);
     }
+    _indexConsistency->addIndexKeyHashes(keyHashes, indexNumber);
 
     if (_indexConsistency->getMultikeyMetadataPathCount(indexNumber) > 0) {
         results->errors.push_back(
@@ -201,7 +214,8 @@ void RecordStoreValidateAdaptor::traverseIndex(const IndexAccessMethod* iam,
 void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
                                                      ValidateCmdLevel level,
                                                      ValidateResults* results,
-                                                     BSONObjBuilder* output) {
+                                                     BSONObjBuilder* output,
+                                                     long long* numRecords) {
     long long nrecords = 0;
     long long dataSizeTotal = 0;
     long long nInvalid = 0;
@@ -243,12 +257,15 @@ void RecordStoreValidateAdaptor::traverseRecordStore(RecordStore* recordStore,
         prevRecordId = record->id;
     }
 
-    if (results->valid) {
+    // Without an exclusive lock, writes may have happened since the snapshot that was traversed.
+    if (results->valid &&
+        _opCtx->lockState()->isCollectionLockedForMode(recordStore->ns(), MODE_X)) {
         recordStore->updateStatsAfterRepair(_opCtx, nrecords, dataSizeTotal);
     }
 
     output->append("nInvalidDocuments", nInvalid);
     output->appendNumber("nrecords", nrecords);
+    *numRecords = nrecords;
 }
 
 void RecordStoreValidateAdaptor::validateIndexKeyCount(IndexDescriptor* idx,
@@ -71,20 +71,26 @@ public:
     /**
      * Traverses the index getting index entriess to validate them and keep track of the index keys
      * for index consistency.
+     *
+     * Reads the index through 'opCtx', which may be another operation than the one this adaptor
+     * was created with, so that several indexes can be traversed at once.
      */
-    void traverseIndex(const IndexAccessMethod* iam,
+    void traverseIndex(OperationContext* opCtx,
+                       const IndexAccessMethod* iam,
                        const IndexDescriptor* descriptor,
                        ValidateResults* results,
                        int64_t* numTraversedKeys);
 
     /**
      * Traverses the record store to retrieve every record and go through its document key
-     * set to keep track of the index consistency during a validation.
+     * set to keep track of the index consistency during a validation. Sets 'numRecords' to the
+     * number of records traversed.
      */
     void traverseRecordStore(RecordStore* recordStore,
                              ValidateCmdLevel level,
                              ValidateResults* results,
-                             BSONObjBuilder* output);
+                             BSONObjBuilder* output,
+                             long long* numRecords);
 
     /**
      * Validate that the number of document keys matches the number of index keys.
@@ -119,6 +119,12 @@ void UUIDCatalogObserver::postRenameCollection(OperationContext* opCtx,
     onRenameCollection(opCtx, fromCollection, toCollection, uuid, dropTargetUUID, stayTemp);
 }
 
+UUIDCatalog::UUIDCatalog() {
+    for (auto& partition : _catalog) {
+        partition = std::make_shared<const CollectionMap>();
+    }
+}
+
 UUIDCatalog& UUIDCatalog::get(ServiceContext* svcCtx) {
     return getCatalog(svcCtx);
 }
@@ -165,38 +171,59 @@ void UUIDCatalog::onCloseCatalog(OperationContext* opCtx) {
     invariant(opCtx->lockState()->isW());
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     invariant(!_shadowCatalog);
-    _shadowCatalog.emplace();
-    for (auto entry : _catalog)
-        _shadowCatalog->insert({entry.first, entry.second->ns()});
+    auto shadowCatalog = std::make_shared<ShadowCatalog>();
+    for (size_t partition = 0; partition < kNumPartitions; ++partition) {
+        for (auto&& entry : *_loadPartition(partition))
+            shadowCatalog->insert({entry.first, entry.second->ns()});
+    }
+    std::atomic_store(&_shadowCatalog, std::shared_ptr<const ShadowCatalog>(shadowCatalog));
 }
 
 void UUIDCatalog::onOpenCatalog(OperationContext* opCtx) {
     invariant(opCtx->lockState()->isW());
     stdx::lock_guard<stdx::mutex> lock(_catalogLock);
     invariant(_shadowCatalog);
-    _shadowCatalog.reset();
+    std::atomic_store(&_shadowCatalog, std::shared_ptr<const ShadowCatalog>());
+}
+
+size_t UUIDCatalog::_partitionOf(CollectionUUID uuid) {
+    return CollectionUUID::Hash()(uuid) % kNumPartitions;
+}
+
+std::shared_ptr<const UUIDCatalog::CollectionMap> UUIDCatalog::_loadPartition(
+    size_t partition) const {
+    return std::atomic_load(&_catalog[partition]);
 }
 
 Collection* UUIDCatalog::lookupCollectionByUUID(CollectionUUID uuid) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    return foundIt == _catalog.end() ? nullptr : foundIt->second;
+    const auto catalog = _loadPartition(_partitionOf(uuid));
+    auto foundIt = catalog->find(uuid);
+    return foundIt == catalog->end() ? nullptr : foundIt->second;
 }
 
 NamespaceString UUIDCatalog::lookupNSSByUUID(CollectionUUID uuid) const {
-    stdx::lock_guard<stdx::mutex> lock(_catalogLock);
-    auto foundIt = _catalog.find(uuid);
-    if (foundIt != _catalog.end())
+    const auto partition = _partitionOf(uuid);
+    auto catalog = _loadPartition(partition);
+    auto foundIt = catalog->find(uuid);
+    if (foundIt != catalog->end())
         return foundIt->second->ns();
 
     // Only in the case that the catalog is closed and a UUID is currently unknown, resolve it
     // using the pre-close state. This ensures that any tasks reloading the catalog can see their
     // own updates.
-    if (_shadowCatalog) {
-        auto shadowIt = _shadowCatalog->find(uuid);
-        if (shadowIt != _shadowCatalog->end())
+    const auto shadowCatalog = std::atomic_load(&_shadowCatalog);
+    if (shadowCatalog) {
+        auto shadowIt = shadowCatalog->find(uuid);
+        if (shadowIt != shadowCatalog->end())
             return shadowIt->second;
     }
+
+    // The catalog may have been reopened, and the shadow catalog discarded, after the first
+    // lookup. Collections are registered before the catalog is reopened, so look again.
+    catalog = _loadPartition(partition);
+    foundIt = catalog->find(uuid);
+    if (foundIt != catalog->end())
+        return foundIt->second->ns();
     return NamespaceString();
 }
 
@@ -254,9 +281,11 @@ const std::vector<CollectionUUID>& UUIDCatalog::_getOrdering_inlock(
 
     // Otherwise, get all of the UUIDs for this database,
     auto& newOrdering = _orderedCollections[db];
-    for (const auto& pair : _catalog) {
-        if (pair.second->ns().db() == db) {
-            newOrdering.push_back(pair.first);
+    for (size_t partition = 0; partition < kNumPartitions; ++partition) {
+        for (const auto& pair : *_loadPartition(partition)) {
+            if (pair.second->ns().db() == db) {
+                newOrdering.push_back(pair.first);
+            }
         }
     }
 
@@ -266,18 +295,25 @@ const std::vector<CollectionUUID>& UUIDCatalog::_getOrdering_inlock(
     return newOrdering;
 }
 void UUIDCatalog::_registerUUIDCatalogEntry_inlock(CollectionUUID uuid, Collection* coll) {
-    if (coll && !_catalog.count(uuid)) {
+    const auto partition = _partitionOf(uuid);
+    const auto catalog = _loadPartition(partition);
+    if (coll && !catalog->count(uuid)) {
         // Invalidate this database's ordering, since we're adding a new UUID.
         _orderedCollections.erase(coll->ns().db());
 
         std::pair<CollectionUUID, Collection*> entry = std::make_pair(uuid, coll);
         LOG(2) << "registering collection " << coll->ns() << " with UUID " << uuid.toString();
-        invariant(_catalog.insert(entry).second == true);
+        auto newCatalog = std::make_shared<CollectionMap>(*catalog);
+        invariant(newCatalog->insert(entry).second == true);
+        std::atomic_store(&_catalog[partition],
+                          std::shared_ptr<const CollectionMap>(std::move(newCatalog)));
     }
 }
 Collection* UUIDCatalog::_removeUUIDCatalogEntry_inlock(CollectionUUID uuid) {
-    auto foundIt = _catalog.find(uuid);
-    if (foundIt == _catalog.end())
+    const auto partition = _partitionOf(uuid);
+    const auto catalog = _loadPartition(partition);
+    auto foundIt = catalog->find(uuid);
+    if (foundIt == catalog->end())
         return nullptr;
 
     // Invalidate this database's ordering, since we're deleting a UUID.
@@ -285,7 +321,10 @@ Collection* UUIDCatalog::_removeUUIDCatalogEntry_inlock(CollectionUUID uuid) {
 
     auto foundCol = foundIt->second;
     LOG(2) << "unregistering collection " << foundCol->ns() << " with UUID " << uuid.toString();
-    _catalog.erase(foundIt);
+    auto newCatalog = std::make_shared<CollectionMap>(*catalog);
+    newCatalog->erase(uuid);
+    std::atomic_store(&_catalog[partition],
+                      std::shared_ptr<const CollectionMap>(std::move(newCatalog)));
     return foundCol;
 }
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
 #include <unordered_map>
 
 #include "mongo/base/disallow_copying.h"
@@ -126,6 +128,11 @@ public:
 /**
  * This class comprises a UUID to collection catalog, allowing for efficient
  * collection lookup by UUID.
+ *
+ * Lookups by UUID do not take '_catalogLock': the catalog is published as copy-on-write maps,
+ * partitioned by UUID hash, and readers load the current map of a partition with
+ * std::atomic_load(). Writers serialize on '_catalogLock', copy the partition they change and
+ * publish the copy with std::atomic_store(). A published map is never modified.
  */
 using CollectionUUID = UUID;
 class Database;
@@ -136,7 +143,7 @@ class UUIDCatalog {
 public:
     static UUIDCatalog& get(ServiceContext* svcCtx);
     static UUIDCatalog& get(OperationContext* opCtx);
-    UUIDCatalog() = default;
+    UUIDCatalog();
 
     /**
      * This function inserts the entry for uuid, coll into the UUID Collection. It is called by
@@ -213,19 +220,29 @@ public:
     boost::optional<CollectionUUID> next(const StringData& db, CollectionUUID uuid);
 
 private:
+    using CollectionMap = stdx::unordered_map<CollectionUUID, Collection*, CollectionUUID::Hash>;
+    using ShadowCatalog =
+        stdx::unordered_map<CollectionUUID, NamespaceString, CollectionUUID::Hash>;
+
+    static const size_t kNumPartitions = 64;
+
+    static size_t _partitionOf(CollectionUUID uuid);
+
+    std::shared_ptr<const CollectionMap> _loadPartition(size_t partition) const;
+
     const std::vector<CollectionUUID>& _getOrdering_inlock(const StringData& db,
                                                            const stdx::lock_guard<stdx::mutex>&);
     void _registerUUIDCatalogEntry_inlock(CollectionUUID uuid, Collection* coll);
     Collection* _removeUUIDCatalogEntry_inlock(CollectionUUID uuid);
 
+    // Serializes writers. Lookups by UUID do not take it.
     mutable mongo::stdx::mutex _catalogLock;
+
     /**
-     * When present, indicates that the catalog is in closed state, and contains a map from UUID
-     * to pre-close NSS. See also onCloseCatalog.
+     * When non-null, indicates that the catalog is in closed state, and contains a map from UUID
+     * to pre-close NSS. See also onCloseCatalog. Published like the partitions of '_catalog'.
      */
-    boost::optional<
-        mongo::stdx::unordered_map<CollectionUUID, NamespaceString, CollectionUUID::Hash>>
-        _shadowCatalog;
+    std::shared_ptr<const ShadowCatalog> _shadowCatalog;
 
     /**
      * Map from database names to ordered `vector`s of their UUIDs.
@@ -234,7 +251,7 @@ private:
      * not all databases are guaranteed to have an ordering in it.
      */
     StringMap<std::vector<CollectionUUID>> _orderedCollections;
-    mongo::stdx::unordered_map<CollectionUUID, Collection*, CollectionUUID::Hash> _catalog;
+    std::array<std::shared_ptr<const CollectionMap>, kNumPartitions> _catalog;
 };
 
 }  // namespace mongo
@@ -243,4 +243,42 @@ TEST_F(UUIDCatalogTest, LookupNSSByUUIDForClosedCatalogReturnsFreshestNSS) {
     ASSERT_EQUALS(catalog.lookupCollectionByUUID(colUUID), &newCol);
     ASSERT_EQUALS(catalog.lookupNSSByUUID(colUUID), newNss);
 }
+
+TEST_F(UUIDCatalogTest, ManyCollections) {
+    // Enough collections to populate every partition of the catalog several times over.
+    const int kNumCollections = 1000;
+    std::vector<std::unique_ptr<Collection>> collections;
+    std::vector<CollectionUUID> uuids;
+    for (int i = 0; i < kNumCollections; i++) {
+        NamespaceString collNss(nss.db(), str::stream() << "coll" << i);
+        collections.push_back(
+            stdx::make_unique<Collection>(stdx::make_unique<CollectionMock>(collNss)));
+        uuids.push_back(CollectionUUID::gen());
+        catalog.onCreateCollection(&opCtx, collections.back().get(), uuids.back());
+    }
+
+    for (int i = 0; i < kNumCollections; i++) {
+        ASSERT_EQUALS(catalog.lookupCollectionByUUID(uuids[i]), collections[i].get());
+    }
+
+    // Dropping every other collection leaves the rest in place.
+    for (int i = 0; i < kNumCollections; i += 2) {
+        catalog.onDropCollection(&opCtx, uuids[i]);
+    }
+    for (int i = 0; i < kNumCollections; i++) {
+        ASSERT_EQUALS(catalog.lookupCollectionByUUID(uuids[i]),
+                      i % 2 ? collections[i].get() : nullptr);
+    }
+
+    // The ordering spans all partitions.
+    std::vector<CollectionUUID> remaining{colUUID};
+    for (int i = 1; i < kNumCollections; i += 2) {
+        remaining.push_back(uuids[i]);
+    }
+    std::sort(remaining.begin(), remaining.end());
+    for (size_t i = 0; i + 1 < remaining.size(); i++) {
+        ASSERT_EQUALS(*catalog.next(nss.db(), remaining[i]), remaining[i + 1]);
+    }
+    ASSERT_FALSE(catalog.next(nss.db(), remaining.back()));
+}
 }  // namespace
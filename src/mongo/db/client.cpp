@@ -101,7 +101,8 @@ int64_t generateSeed(const std::string& desc) {
 }  // namespace
 
 Client::Client(std::string desc, ServiceContext* serviceContext, transport::SessionHandle session)
-    : _serviceContext(serviceContext),
+    : Decorable(serviceContext ? &serviceContext->_clientDecorationStorage : nullptr),
+      _serviceContext(serviceContext),
       _session(std::move(session)),
       _desc(std::move(desc)),
       _connectionId(_session ? _session->id() : 0),
@@ -217,6 +217,7 @@ public:
     }
 
 private:
+    friend class OperationContext;
     friend class ServiceContext;
     explicit Client(std::string desc,
                     ServiceContext* serviceContext,
@@ -240,6 +241,11 @@ private:
     // If != NULL, then contains the currently active OperationContext
     OperationContext* _opCtx = nullptr;
 
+    // Decoration storage of this client's last OperationContext, reused by the next one. Only
+    // touched while constructing or destroying this client's OperationContexts, which happens on
+    // the thread the client is bound to.
+    DecorationStorageCache _opCtxDecorationStorage;
+
     PseudoRandom _prng;
 };
 
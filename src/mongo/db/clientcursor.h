@@ -186,6 +186,24 @@ public:
         _pos = n;
     }
 
+    /**
+     * Records that a batch of 'numDocs' documents occupying 'numBytes' was returned by this cursor.
+     */
+    void recordBatch(long long numDocs, size_t numBytes) {
+        _numDocsInRecordedBatches += numDocs;
+        _numBytesInRecordedBatches += numBytes;
+    }
+
+    /**
+     * Returns the average size of the documents in the batches passed to recordBatch(), or 0 if no
+     * documents have been recorded. Used to size the reply buffer for later batches.
+     */
+    size_t averageReturnedDocumentSize() const {
+        return _numDocsInRecordedBatches > 0
+            ? _numBytesInRecordedBatches / static_cast<size_t>(_numDocsInRecordedBatches)
+            : 0;
+    }
+
     //
     // Timing.
     //
@@ -300,6 +318,10 @@ private:
     // Tracks the number of results returned by this cursor so far.
     long long _pos = 0;
 
+    // The number of documents, and their total size in bytes, passed to recordBatch().
+    long long _numDocsInRecordedBatches = 0;
+    size_t _numBytesInRecordedBatches = 0;
+
     // Holds an owned copy of the command specification received from the client.
     const BSONObj _originatingCommand;
 
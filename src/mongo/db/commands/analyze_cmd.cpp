@@ -0,0 +1,209 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace {
+
+const long long kDefaultSampleSize = 10000;
+const long long kDefaultNumBuckets = 100;
+const long long kMaxNumBuckets = 1000;
+
+/**
+ * Returns the fields of every btree index of 'collection', which are the fields whose statistics
+ * the planner can use.
+ */
+std::set<std::string> getIndexedFields(OperationContext* opCtx, Collection* collection) {
+    std::set<std::string> fields;
+    IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+    while (ii.more()) {
+        const IndexDescriptor* descriptor = ii.next();
+        if (!IndexNames::findPluginName(descriptor->keyPattern()).empty()) {
+            continue;
+        }
+        for (auto&& elem : descriptor->keyPattern()) {
+            fields.insert(elem.fieldName());
+        }
+    }
+    return fields;
+}
+
+/**
+ * Reads up to 'sampleSize' documents of 'collection'. The documents are chosen at random unless the
+ * sample would cover the whole collection or its record store cannot return random records, in
+ * which case the first documents are read in order.
+ */
+std::vector<BSONObj> sampleDocuments(OperationContext* opCtx,
+                                     Collection* collection,
+                                     long long sampleSize) {
+    std::unique_ptr<RecordCursor> cursor;
+    if (static_cast<uint64_t>(sampleSize) < collection->numRecords(opCtx)) {
+        cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    }
+    if (!cursor) {
+        cursor = collection->getCursor(opCtx);
+    }
+
+    std::vector<BSONObj> sample;
+    while (static_cast<long long>(sample.size()) < sampleSize) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        sample.push_back(record->data.toBson().getOwned());
+
+        if (sample.size() % 128 == 0) {
+            opCtx->checkForInterrupt();
+        }
+    }
+    return sample;
+}
+
+class AnalyzeCmd : public BasicCommand {
+public:
+    AnalyzeCmd() : BasicCommand("analyze") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kOptIn;
+    }
+
+    std::string help() const override {
+        return "Gathers statistics about the values of fields of a collection from a random sample "
+               "of its documents, for the query planner to estimate the cost of plans with.\n"
+               "{analyze: <collection>, keys: [<field>, ...], sampleSize: <n>, buckets: <n>}\n"
+               "Analyzes every field of a btree index if 'keys' is omitted.";
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::planCacheWrite);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        const NamespaceString nss(CommandHelpers::parseNsCollectionRequired(dbname, cmdObj));
+
+        long long sampleSize = kDefaultSampleSize;
+        if (auto elem = cmdObj["sampleSize"]) {
+            uassert(ErrorCodes::TypeMismatch, "sampleSize must be a number", elem.isNumber());
+            sampleSize = elem.safeNumberLong();
+            uassert(ErrorCodes::BadValue, "sampleSize must be positive", sampleSize > 0);
+        }
+
+        long long numBuckets = kDefaultNumBuckets;
+        if (auto elem = cmdObj["buckets"]) {
+            uassert(ErrorCodes::TypeMismatch, "buckets must be a number", elem.isNumber());
+            numBuckets = elem.safeNumberLong();
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "buckets must be between 1 and " << kMaxNumBuckets,
+                    numBuckets > 0 && numBuckets <= kMaxNumBuckets);
+        }
+
+        std::set<std::string> keys;
+        if (auto elem = cmdObj["keys"]) {
+            uassert(ErrorCodes::TypeMismatch, "keys must be an array", elem.type() == Array);
+            for (auto&& key : elem.Obj()) {
+                uassert(ErrorCodes::TypeMismatch,
+                        "keys must be an array of field names",
+                        key.type() == String && !key.valueStringData().empty());
+                keys.insert(key.str());
+            }
+        }
+
+        AutoGetCollectionForReadCommand ctx(opCtx, nss);
+        Collection* collection = ctx.getCollection();
+        if (!collection) {
+            uassert(ErrorCodes::CommandNotSupportedOnView,
+                    "Cannot analyze a view",
+                    !(ctx.getDb() && ctx.getDb()->getViewCatalog()->lookup(opCtx, nss.ns())));
+            uasserted(ErrorCodes::NamespaceNotFound, "ns not found");
+        }
+
+        if (!cmdObj.hasField("keys")) {
+            keys = getIndexedFields(opCtx, collection);
+        }
+
+        const long long numRecords = collection->numRecords(opCtx);
+        const std::vector<BSONObj> sample = sampleDocuments(opCtx, collection, sampleSize);
+
+        CollectionStatistics* stats = collection->infoCache()->getCollectionStatistics();
+        BSONObjBuilder fieldsBuilder(result.subobjStart("fields"));
+        for (auto&& key : keys) {
+            FieldStatistics fieldStats =
+                FieldStatistics::build(sample, key, numRecords, numBuckets);
+
+            BSONObjBuilder fieldBuilder(fieldsBuilder.subobjStart(key));
+            fieldStats.serialize(&fieldBuilder);
+            fieldBuilder.doneFast();
+
+            stats->setFieldStatistics(key, std::move(fieldStats));
+        }
+        fieldsBuilder.doneFast();
+
+        // Plans were cached under the old statistics.
+        collection->infoCache()->getPlanCache()->clear();
+
+        LOG(1) << "analyzed " << keys.size() << " fields of " << nss.ns() << " from a sample of "
+               << sample.size() << " documents";
+
+        result.append("ns", nss.ns());
+        result.appendNumber("numRecords", numRecords);
+        result.appendNumber("sampleSize", static_cast<long long>(sample.size()));
+        return true;
+    }
+} analyzeCmd;
+
+}  // namespace
+}  // namespace mongo
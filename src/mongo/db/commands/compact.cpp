@@ -39,6 +39,7 @@
 #include "mongo/db/background.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/online_compact.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/curop.h"
@@ -82,7 +83,14 @@ public:
                "  [paddingFactor:<num>], [paddingBytes:<num>] }\n"
                "  force - allows to run on a replica set primary\n"
                "  validate - check records are noncorrupt before adding to newly compacting "
-               "extents. slower but safer (defaults to true in this version)\n";
+               "extents. slower but safer (defaults to true in this version)\n"
+               "{ compact : <collection_name>, online : true, [stepSecs:<num>],\n"
+               "  [pauseMillis:<num>] }\n"
+               "  online - compact in place in short steps under intent locks, without blocking "
+               "the collection. may be run again to continue after an interruption\n"
+               "  stepSecs - longest time a single step may run (defaults to 1)\n"
+               "  pauseMillis - pause between steps to leave I/O to other operations "
+               "(defaults to 100)\n";
     }
     CompactCmd() : ErrmsgCommandDeprecated("compact") {}
 
@@ -93,6 +101,10 @@ public:
                            BSONObjBuilder& result) {
         NamespaceString nss = CommandHelpers::parseNsCollectionRequired(db, cmdObj);
 
+        if (cmdObj["online"].trueValue()) {
+            return runOnline(opCtx, nss, cmdObj, result);
+        }
+
         repl::ReplicationCoordinator* replCoord = repl::ReplicationCoordinator::get(opCtx);
         if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
             errmsg =
@@ -172,6 +184,49 @@ public:
 
         return true;
     }
+
+private:
+    /**
+     * Online compaction does not block the collection, so unlike the offline mode it may run on
+     * a primary without 'force'.
+     */
+    bool runOnline(OperationContext* opCtx,
+                   const NamespaceString& nss,
+                   const BSONObj& cmdObj,
+                   BSONObjBuilder& result) {
+        uassert(ErrorCodes::InvalidNamespace, "bad namespace name", nss.isNormal());
+        uassert(ErrorCodes::InvalidNamespace, "can't compact a system namespace", !nss.isSystem());
+
+        OnlineCompactOptions options;
+        if (cmdObj.hasElement("stepSecs")) {
+            const long long stepSecs = cmdObj["stepSecs"].safeNumberLong();
+            uassert(ErrorCodes::BadValue,
+                    "stepSecs must be between 1 and 3600",
+                    stepSecs >= 1 && stepSecs <= 3600);
+            options.stepTimeout = Seconds(stepSecs);
+        }
+        if (cmdObj.hasElement("pauseMillis")) {
+            const long long pauseMillis = cmdObj["pauseMillis"].safeNumberLong();
+            uassert(ErrorCodes::BadValue, "pauseMillis must be >= 0", pauseMillis >= 0);
+            options.pauseBetweenSteps = Milliseconds(pauseMillis);
+        }
+
+        BackgroundOperation::assertNoBgOpInProgForNs(nss.ns());
+
+        log() << "online compact " << nss.ns() << " begin, step: " << options.stepTimeout
+              << ", pause: " << options.pauseBetweenSteps;
+
+        auto swStats = compactCollectionOnline(opCtx, nss, options);
+        uassertStatusOK(swStats.getStatus());
+
+        result.append("steps", swStats.getValue().steps);
+        result.append("bytesReclaimed", swStats.getValue().bytesReclaimed);
+
+        log() << "online compact " << nss.ns() << " end, reclaimed "
+              << swStats.getValue().bytesReclaimed << " bytes";
+
+        return true;
+    }
 };
 static CompactCmd compactCmd;
 }
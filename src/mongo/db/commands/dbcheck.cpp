@@ -44,6 +44,8 @@
 #include "mongo/db/repl/dbcheck.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/optime.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/background.h"
 
 #include "mongo/util/log.h"
@@ -51,8 +53,24 @@
 namespace mongo {
 
 namespace {
-constexpr uint64_t kBatchDocs = 5'000;
-constexpr uint64_t kBatchBytes = 20'000'000;
+constexpr int64_t kBatchDocs = 5'000;
+constexpr int64_t kBatchBytes = 20'000'000;
+
+// Bounds for the batch size as it adapts to replication lag.
+constexpr int64_t kMinBatchDocs = 100;
+constexpr int64_t kMaxBatchDocs = 4 * kBatchDocs;
+
+// Secondaries hash each dbCheck batch as they apply it. While the majority commit point lags this
+// node's last applied optime by more than this many seconds, dbCheck halves its batch size, and it
+// grows the batches back while the lag is under half of it. 0 keeps the batch size fixed.
+MONGO_EXPORT_SERVER_PARAMETER(dbCheckTargetReplicationLagSecs, int, 5)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "dbCheckTargetReplicationLagSecs must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
 
 
 /**
@@ -65,6 +83,7 @@ struct DbCheckCollectionInfo {
     int64_t maxCount;
     int64_t maxSize;
     int64_t maxRate;
+    DbCheckHashAlgorithmEnum hashAlgorithm;
 };
 
 /**
@@ -116,7 +135,8 @@ std::unique_ptr<DbCheckRun> singleCollectionRun(OperationContext* opCtx,
     auto maxCount = invocation.getMaxCount();
     auto maxSize = invocation.getMaxSize();
     auto maxRate = invocation.getMaxCountPerSecond();
-    auto info = DbCheckCollectionInfo{nss, start, end, maxCount, maxSize, maxRate};
+    auto hashAlgorithm = invocation.getHashAlgorithm();
+    auto info = DbCheckCollectionInfo{nss, start, end, maxCount, maxSize, maxRate, hashAlgorithm};
     auto result = stdx::make_unique<DbCheckRun>();
     result->push_back(info);
     return result;
@@ -137,9 +157,11 @@ std::unique_ptr<DbCheckRun> fullDatabaseRun(OperationContext* opCtx,
 
     int64_t max = std::numeric_limits<int64_t>::max();
     auto rate = invocation.getMaxCountPerSecond();
+    auto hashAlgorithm = invocation.getHashAlgorithm();
 
     for (Collection* coll : *db) {
-        DbCheckCollectionInfo info{coll->ns(), BSONKey::min(), BSONKey::max(), max, max, rate};
+        DbCheckCollectionInfo info{
+            coll->ns(), BSONKey::min(), BSONKey::max(), max, max, rate, hashAlgorithm};
         result->push_back(info);
     }
 
@@ -236,6 +258,9 @@ private:
         TimePoint lastStart = Clock::now();
         int64_t docsInCurrentInterval = 0;
 
+        // Batches shrink and grow with replication lag; the byte limit scales with the doc limit.
+        int64_t batchDocs = kBatchDocs;
+
         do {
             using namespace std::literals::chrono_literals;
 
@@ -244,7 +269,7 @@ private:
                 docsInCurrentInterval = 0;
             }
 
-            auto result = _runBatch(info, start, kBatchDocs, kBatchBytes);
+            auto result = _runBatch(info, start, batchDocs, batchDocs * (kBatchBytes / kBatchDocs));
 
             if (_done) {
                 return;
@@ -292,9 +317,49 @@ private:
 
                 stdx::this_thread::sleep_for(timesExceeded * 1s - (Clock::now() - lastStart));
             }
+
+            if (!reachedEnd) {
+                batchDocs = _nextBatchDocs(info, batchDocs);
+            }
         } while (!reachedEnd);
     }
 
+    /**
+     * Returns the number of documents for the batch after one of 'batchDocs' documents, based on
+     * how far the majority commit point lags behind this node. When the batches are already as
+     * small as they go and the lag is still too high, waits a second for the secondaries to catch
+     * up.
+     */
+    int64_t _nextBatchDocs(const DbCheckCollectionInfo& info, int64_t batchDocs) {
+        const int targetLagSecs = dbCheckTargetReplicationLagSecs.load();
+        if (targetLagSecs == 0) {
+            return kBatchDocs;
+        }
+
+        auto replCoord = repl::ReplicationCoordinator::get(getGlobalServiceContext());
+        const auto lastApplied = replCoord->getMyLastAppliedOpTime().getTimestamp().getSecs();
+        const auto lastCommitted = replCoord->getLastCommittedOpTime().getTimestamp().getSecs();
+        const int64_t lagSecs = lastApplied > lastCommitted ? lastApplied - lastCommitted : 0;
+
+        int64_t nextBatchDocs = batchDocs;
+        if (lagSecs > targetLagSecs) {
+            if (batchDocs == kMinBatchDocs) {
+                using namespace std::literals::chrono_literals;
+                stdx::this_thread::sleep_for(1s);
+            }
+            nextBatchDocs = std::max(batchDocs / 2, kMinBatchDocs);
+        } else if (lagSecs * 2 < targetLagSecs) {
+            nextBatchDocs = std::min(batchDocs + batchDocs / 4, kMaxBatchDocs);
+        }
+
+        if (nextBatchDocs != batchDocs) {
+            LOG(1) << "dbCheck on " << info.nss << " changing batch size from " << batchDocs
+                   << " to " << nextBatchDocs << " documents, replication lag is " << lagSecs
+                   << "s";
+        }
+        return nextBatchDocs;
+    }
+
     /**
      * For organizing the results of batches.
      */
@@ -407,7 +472,8 @@ private:
                            first,
                            info.end,
                            std::min(batchDocs, info.maxCount),
-                           std::min(batchBytes, info.maxSize));
+                           std::min(batchBytes, info.maxSize),
+                           info.hashAlgorithm);
         } catch (const DBException& e) {
             return e.toStatus();
         }
@@ -425,6 +491,9 @@ private:
         batch.setMd5(md5);
         batch.setMinKey(first);
         batch.setMaxKey(BSONKey(hasher->lastKey()));
+        if (info.hashAlgorithm != DbCheckHashAlgorithmEnum::md5) {
+            batch.setHashAlgorithm(info.hashAlgorithm);
+        }
 
         BatchStats result;
 
@@ -513,7 +582,8 @@ public:
                "              maxKey: <last key, inclusive>,\n"
                "              maxCount: <max number of docs>,\n"
                "              maxSize: <max size of docs>,\n"
-               "              maxCountPerSecond: <max rate in docs/sec> } "
+               "              maxCountPerSecond: <max rate in docs/sec>,\n"
+               "              hashAlgorithm: <\"md5\" (default) or \"murmur3\"> } "
                "to check a collection.\n"
                "Invoke with {dbCheck: 1} to check all collections in the database.";
     }
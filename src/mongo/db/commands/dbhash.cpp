@@ -40,15 +40,20 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_catalog_entry.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
+#include "mongo/util/multiset_hash.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/timer.h"
 
@@ -56,6 +61,171 @@ namespace mongo {
 
 namespace {
 
+// Number of threads dbHash uses to hash collections when not running in a multi-statement
+// transaction. A value of 1 hashes the collections one at a time on the command's own thread.
+MONGO_EXPORT_SERVER_PARAMETER(dbHashMaxThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue, "dbHashMaxThreads must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+// With {hashAlgorithm: "murmur3"}, collections with more documents than this are hashed in _id
+// ranges of roughly this many documents, so that a single large collection can use several
+// threads.
+MONGO_EXPORT_SERVER_PARAMETER(dbHashRangeSplitDocs, long long, 1'000'000)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 1000) {
+            return Status(ErrorCodes::BadValue, "dbHashRangeSplitDocs must be at least 1000");
+        }
+        return Status::OK();
+    });
+
+// The command holds the database lock in MODE_S while the hashing threads take their own intent
+// locks. A thread that cannot get its locks within this time, because a conflicting request has
+// queued up behind the command, leaves its remaining work to the command's thread.
+const Milliseconds kHashThreadLockTimeout{100};
+
+// Range split points are picked from this many random samples per range.
+const int kSamplesPerRange = 10;
+const long long kMaxRangesPerCollection = 64;
+
+enum class HashAlgorithm { kMD5, kMurmur3 };
+
+/**
+ * A piece of hashing work: a whole collection, or for the murmur3 algorithm, a range of its _id
+ * index.
+ */
+struct HashTask {
+    size_t collIndex;
+    NamespaceString nss;
+
+    // Bounds on the _id index. Both are empty when hashing the whole collection.
+    BSONObj startKey;
+    BSONObj endKey;
+    BoundInclusion boundInclusion;
+};
+
+/**
+ * The hash of the documents covered by one HashTask. With md5 each collection is a single task
+ * and 'md5' holds its digest; with murmur3 the tasks of a collection are combined through
+ * 'multiset'.
+ */
+struct PartialHash {
+    std::string md5;
+    MultisetHash multiset;
+};
+
+PartialHash hashDocuments(OperationContext* opCtx,
+                          Collection* collection,
+                          const HashTask& task,
+                          HashAlgorithm algorithm) {
+    std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
+    if (IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx)) {
+        exec = InternalPlanner::indexScan(opCtx,
+                                          collection,
+                                          desc,
+                                          task.startKey,
+                                          task.endKey,
+                                          task.boundInclusion,
+                                          PlanExecutor::NO_YIELD,
+                                          InternalPlanner::FORWARD,
+                                          InternalPlanner::IXSCAN_FETCH);
+    } else {
+        // Clustered collections are scanned in _id order, like their missing _id index would be.
+        invariant(collection->isCapped() || collection->getRecordStore()->isClustered());
+        exec = InternalPlanner::collectionScan(
+            opCtx, task.nss.ns(), collection, PlanExecutor::NO_YIELD);
+    }
+
+    PartialHash hash;
+    md5_state_t st;
+    md5_init(&st);
+
+    PlanExecutor::ExecState state;
+    BSONObj c;
+    verify(NULL != exec.get());
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
+        if (algorithm == HashAlgorithm::kMD5) {
+            md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
+        } else {
+            hash.multiset.add(c.objdata(), c.objsize());
+        }
+    }
+    if (PlanExecutor::IS_EOF != state) {
+        warning() << "error while hashing, db dropped? ns=" << task.nss;
+        uasserted(34371,
+                  "Plan executor error while running dbHash command: " +
+                      WorkingSetCommon::toStatusString(c));
+    }
+
+    if (algorithm == HashAlgorithm::kMD5) {
+        md5digest d;
+        md5_finish(&st, d);
+        hash.md5 = digestToString(d);
+    }
+    return hash;
+}
+
+/**
+ * Appends the work of hashing 'collection' to 'tasks'. With murmur3, a large collection with a
+ * simple-collation _id index is split into _id ranges whose bounds are chosen by sampling
+ * documents with a random cursor. The split points need not match across nodes, since the range
+ * hashes combine to the same collection hash however the collection is split.
+ */
+void addHashTasks(OperationContext* opCtx,
+                  Collection* collection,
+                  size_t collIndex,
+                  HashAlgorithm algorithm,
+                  std::vector<HashTask>* tasks) {
+    const NamespaceString& nss = collection->ns();
+    HashTask wholeCollection{
+        collIndex, nss, BSONObj(), BSONObj(), BoundInclusion::kIncludeStartKeyOnly};
+
+    IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
+    if (algorithm != HashAlgorithm::kMurmur3 || !desc || desc->infoObj().hasField("collation")) {
+        tasks->push_back(std::move(wholeCollection));
+        return;
+    }
+
+    const long long numRecords = collection->numRecords(opCtx);
+    const long long numRanges =
+        std::min(numRecords / dbHashRangeSplitDocs.load(), kMaxRangesPerCollection);
+    auto cursor = numRanges > 1 ? collection->getRecordStore()->getRandomCursor(opCtx) : nullptr;
+    if (!cursor) {
+        tasks->push_back(std::move(wholeCollection));
+        return;
+    }
+
+    BSONObjSet samples = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    for (long long i = 0; i < numRanges * kSamplesPerRange; ++i) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        BSONElement id = record->data.toBson()["_id"];
+        if (!id.eoo()) {
+            samples.insert(id.wrap(""));
+        }
+    }
+
+    BSONObj startKey = BSON("" << MINKEY);
+    int sampleNum = 0;
+    for (const auto& key : samples) {
+        if (++sampleNum % kSamplesPerRange != 0) {
+            continue;
+        }
+        tasks->push_back({collIndex, nss, startKey, key, BoundInclusion::kIncludeStartKeyOnly});
+        startKey = key;
+    }
+    tasks->push_back({collIndex,
+                      nss,
+                      startKey,
+                      BSON("" << MAXKEY),
+                      BoundInclusion::kIncludeBothStartAndEndKeys});
+}
+
 class DBHashCmd : public ErrmsgCommandDeprecated {
 public:
     DBHashCmd() : ErrmsgCommandDeprecated("dbHash", "dbhash") {}
@@ -107,6 +277,22 @@ public:
             }
         }
 
+        // The default md5 hash is computed in _id order. The faster murmur3 hash sums per-document
+        // hashes instead, which lets large collections be hashed in _id ranges.
+        HashAlgorithm algorithm = HashAlgorithm::kMD5;
+        if (BSONElement algorithmElem = cmdObj["hashAlgorithm"]) {
+            if (algorithmElem.type() != String) {
+                errmsg = "hashAlgorithm has to be a string";
+                return false;
+            }
+            if (algorithmElem.valueStringData() == "murmur3") {
+                algorithm = HashAlgorithm::kMurmur3;
+            } else if (algorithmElem.valueStringData() != "md5") {
+                errmsg = str::stream() << "unknown hashAlgorithm: " << algorithmElem.String();
+                return false;
+            }
+        }
+
         const std::string ns = parseNs(dbname, cmdObj);
         uassert(ErrorCodes::InvalidNamespace,
                 str::stream() << "Invalid db name: " << ns,
@@ -116,7 +302,9 @@ public:
         // change for the snapshot.
         auto lockMode = LockMode::MODE_S;
         auto txnParticipant = TransactionParticipant::get(opCtx);
-        if (txnParticipant && txnParticipant->inMultiDocumentTransaction()) {
+        const bool inMultiDocumentTransaction =
+            txnParticipant && txnParticipant->inMultiDocumentTransaction();
+        if (inMultiDocumentTransaction) {
             // However, if we are inside a multi-statement transaction, then we only need to lock
             // the database in intent mode to ensure that none of the collections get dropped.
             lockMode = getLockModeForQuery(opCtx);
@@ -131,9 +319,6 @@ public:
 
         result.append("host", prettyHostName());
 
-        md5_state_t globalState;
-        md5_init(&globalState);
-
         // A set of 'system' collections that are replicated, and therefore included in the db hash.
         const std::set<StringData> replicatedSystemCollections{"system.backup_users",
                                                                "system.js",
@@ -146,7 +331,7 @@ public:
         BSONArrayBuilder cappedCollections;
         BSONObjBuilder collectionsByUUID;
 
-        BSONObjBuilder bb(result.subobjStart("collections"));
+        std::vector<NamespaceString> toHash;
         for (const auto& collectionName : colls) {
 
             NamespaceString collNss(collectionName);
@@ -185,22 +370,49 @@ public:
                 }
             }
 
-            // Compute the hash for this collection.
-            std::string hash = _hashCollection(opCtx, db, collNss.toString());
+            toHash.push_back(std::move(collNss));
+        }
+
+        // Compute the hash for each collection. Inside a multi-statement transaction the reads
+        // must come from the transaction's own snapshot, so they stay on this thread.
+        std::vector<std::string> hashes;
+        if (inMultiDocumentTransaction || dbHashMaxThreads.load() <= 1) {
+            for (const auto& collNss : toHash) {
+                hashes.push_back(_hashCollection(opCtx, db, collNss.toString(), algorithm));
+            }
+        } else {
+            hashes = _hashCollectionsInParallel(opCtx, db, toHash, algorithm);
+        }
+
+        md5_state_t globalState;
+        md5_init(&globalState);
+        MultisetHash globalMultiset;
 
-            bb.append(collNss.coll(), hash);
-            md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
+        BSONObjBuilder bb(result.subobjStart("collections"));
+        for (size_t i = 0; i < toHash.size(); ++i) {
+            const std::string& hash = hashes[i];
+            bb.append(toHash[i].coll(), hash);
+            if (algorithm == HashAlgorithm::kMD5) {
+                md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
+            } else {
+                // The multiset sum does not see collection order, so bind each hash to its name.
+                const std::string entry = toHash[i].coll().toString() + '\0' + hash;
+                globalMultiset.add(entry.data(), entry.size());
+            }
         }
         bb.done();
 
         result.append("capped", BSONArray(cappedCollections.done()));
         result.append("uuids", collectionsByUUID.done());
 
-        md5digest d;
-        md5_finish(&globalState, d);
-        std::string hash = digestToString(d);
-
-        result.append("md5", hash);
+        if (algorithm == HashAlgorithm::kMD5) {
+            md5digest d;
+            md5_finish(&globalState, d);
+            result.append("md5", digestToString(d));
+        } else {
+            result.append("hashAlgorithm", "murmur3");
+            result.append("hash", globalMultiset.toString());
+        }
         result.appendNumber("timeMillis", timer.millis());
 
         return 1;
@@ -209,7 +421,8 @@ public:
 private:
     std::string _hashCollection(OperationContext* opCtx,
                                 Database* db,
-                                const std::string& fullCollectionName) {
+                                const std::string& fullCollectionName,
+                                HashAlgorithm algorithm) {
 
         NamespaceString ns(fullCollectionName);
 
@@ -244,49 +457,107 @@ private:
             invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_S));
         }
 
-        IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
-
-        std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> exec;
-        if (desc) {
-            exec = InternalPlanner::indexScan(opCtx,
-                                              collection,
-                                              desc,
-                                              BSONObj(),
-                                              BSONObj(),
-                                              BoundInclusion::kIncludeStartKeyOnly,
-                                              PlanExecutor::NO_YIELD,
-                                              InternalPlanner::FORWARD,
-                                              InternalPlanner::IXSCAN_FETCH);
-        } else if (collection->isCapped()) {
-            exec = InternalPlanner::collectionScan(
-                opCtx, fullCollectionName, collection, PlanExecutor::NO_YIELD);
-        } else {
+        if (!collection->getIndexCatalog()->findIdIndex(opCtx) && !collection->isCapped() &&
+            !collection->getRecordStore()->isClustered()) {
             log() << "can't find _id index for: " << fullCollectionName;
             return "no _id _index";
         }
 
-        md5_state_t st;
-        md5_init(&st);
+        HashTask task{0, ns, BSONObj(), BSONObj(), BoundInclusion::kIncludeStartKeyOnly};
+        PartialHash hash = hashDocuments(opCtx, collection, task, algorithm);
+        return algorithm == HashAlgorithm::kMD5 ? hash.md5 : hash.multiset.toString();
+    }
 
-        long long n = 0;
-        PlanExecutor::ExecState state;
-        BSONObj c;
-        verify(NULL != exec.get());
-        while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
-            md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
-            n++;
+    /**
+     * Hashes 'namespaces' on up to dbHashMaxThreads threads. Each thread reads under its own
+     * intent locks, which is consistent with this thread's reads because the database lock held
+     * here in MODE_S keeps out every writer. Any work a thread fails to do, for instance because
+     * it timed out waiting for its locks, is redone on this thread.
+     */
+    std::vector<std::string> _hashCollectionsInParallel(
+        OperationContext* opCtx,
+        Database* db,
+        const std::vector<NamespaceString>& namespaces,
+        HashAlgorithm algorithm) {
+        invariant(opCtx->lockState()->isDbLockedForMode(db->name(), MODE_S));
+
+        std::vector<std::string> hashes(namespaces.size());
+        std::vector<HashTask> tasks;
+        for (size_t i = 0; i < namespaces.size(); ++i) {
+            Collection* collection = db->getCollection(opCtx, namespaces[i]);
+            if (!collection) {
+                continue;
+            }
+            if (!collection->getIndexCatalog()->findIdIndex(opCtx) && !collection->isCapped() &&
+            !collection->getRecordStore()->isClustered()) {
+                log() << "can't find _id index for: " << namespaces[i];
+                hashes[i] = "no _id _index";
+                continue;
+            }
+            addHashTasks(opCtx, collection, i, algorithm, &tasks);
         }
-        if (PlanExecutor::IS_EOF != state) {
-            warning() << "error while hashing, db dropped? ns=" << fullCollectionName;
-            uasserted(34371,
-                      "Plan executor error while running dbHash command: " +
-                          WorkingSetCommon::toStatusString(c));
+
+        std::vector<boost::optional<PartialHash>> results(tasks.size());
+        const size_t numThreads = std::min(static_cast<size_t>(dbHashMaxThreads.load()),
+                                           tasks.size());
+        if (numThreads > 1) {
+            ThreadPool::Options poolOptions;
+            poolOptions.poolName = "dbHash";
+            poolOptions.minThreads = 0;
+            poolOptions.maxThreads = numThreads;
+            poolOptions.onCreateThread = [](const std::string& threadName) {
+                Client::initThread(threadName.c_str());
+            };
+            ThreadPool pool(poolOptions);
+            pool.startup();
+
+            AtomicUInt64 nextTask;
+            for (size_t thread = 0; thread < numThreads; ++thread) {
+                fassert(50970, pool.schedule([&] {
+                    auto threadOpCtx = cc().makeOperationContext();
+                    ShouldNotConflictWithSecondaryBatchApplicationBlock noPBWMBlock(
+                        threadOpCtx->lockState());
+                    for (size_t i = nextTask.fetchAndAdd(1); i < tasks.size();
+                         i = nextTask.fetchAndAdd(1)) {
+                        try {
+                            AutoGetCollection autoColl(threadOpCtx.get(),
+                                                       tasks[i].nss,
+                                                       MODE_IS,
+                                                       AutoGetCollection::kViewsForbidden,
+                                                       Date_t::now() + kHashThreadLockTimeout);
+                            if (Collection* collection = autoColl.getCollection()) {
+                                results[i] = hashDocuments(
+                                    threadOpCtx.get(), collection, tasks[i], algorithm);
+                            }
+                        } catch (const ExceptionFor<ErrorCodes::LockTimeout>&) {
+                            // Leave this and any further work to the command's thread.
+                            return;
+                        } catch (const DBException& ex) {
+                            LOG(1) << "Failed to hash " << tasks[i].nss
+                                   << " in parallel, retrying serially: " << redact(ex);
+                        }
+                    }
+                }));
+            }
+            pool.shutdown();
+            pool.join();
         }
-        md5digest d;
-        md5_finish(&st, d);
-        std::string hash = digestToString(d);
 
-        return hash;
+        std::vector<MultisetHash> multisets(namespaces.size());
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            if (!results[i]) {
+                Collection* collection = db->getCollection(opCtx, tasks[i].nss);
+                results[i] = hashDocuments(opCtx, collection, tasks[i], algorithm);
+            }
+            const size_t collIndex = tasks[i].collIndex;
+            if (algorithm == HashAlgorithm::kMD5) {
+                hashes[collIndex] = results[i]->md5;
+            } else {
+                multisets[collIndex].combine(results[i]->multiset);
+                hashes[collIndex] = multisets[collIndex].toString();
+            }
+        }
+        return hashes;
     }
 
 } dbhashCmd;
@@ -34,18 +34,26 @@
 #include "mongo/db/client.h"
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/commands/run_aggregate.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/curop_failpoint_helpers.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
@@ -58,6 +66,18 @@ namespace {
 
 const auto kTermField = "term"_sd;
 
+/**
+ * Returns true if 'qr' asks for the document with a single _id value, and for nothing that needs a
+ * query plan to provide. Such a find can be answered with one lookup in the _id index.
+ */
+bool isIdPointFind(const QueryRequest& qr) {
+    return CanonicalQuery::isSimpleIdQuery(qr.getFilter()) && qr.getProj().isEmpty() &&
+        qr.getSort().isEmpty() && qr.getHint().isEmpty() && qr.getCollation().isEmpty() &&
+        qr.getMin().isEmpty() && qr.getMax().isEmpty() && !qr.getSkip() &&
+        qr.getBatchSize().value_or(1) != 0 && !qr.isTailable() && !qr.isOplogReplay() &&
+        !qr.showRecordId() && !qr.returnKey();
+}
+
 /**
  * A command for running .find() queries.
  */
@@ -159,12 +179,15 @@ public:
             // Finish the parsing step by using the QueryRequest to create a CanonicalQuery.
             const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
             const boost::intrusive_ptr<ExpressionContext> expCtx;
-            auto cq = uassertStatusOK(
-                CanonicalQuery::canonicalize(opCtx,
-                                             std::move(qr),
-                                             expCtx,
-                                             extensionsCallback,
-                                             MatchExpressionParser::kAllowAllSpecialFeatures));
+            auto cq = [&] {
+                ScopedPhaseTimer parseTimer(opCtx, OpDebug::Phase::kParse);
+                return uassertStatusOK(
+                    CanonicalQuery::canonicalize(opCtx,
+                                                 std::move(qr),
+                                                 expCtx,
+                                                 extensionsCallback,
+                                                 MatchExpressionParser::kAllowAllSpecialFeatures));
+            }();
 
             if (ctx->getView()) {
                 // Relinquish locks. The aggregation command will re-acquire them.
@@ -263,15 +286,22 @@ public:
             const int ntoskip = -1;
             beginQueryOp(opCtx, nss, _request.body, ntoreturn, ntoskip);
 
+            if (!ctx->getView() && runIdPointFind(opCtx, ctx->getCollection(), nss, *qr, result)) {
+                return;
+            }
+
             // Finish the parsing step by using the QueryRequest to create a CanonicalQuery.
             const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
             const boost::intrusive_ptr<ExpressionContext> expCtx;
-            auto cq = uassertStatusOK(
-                CanonicalQuery::canonicalize(opCtx,
-                                             std::move(qr),
-                                             expCtx,
-                                             extensionsCallback,
-                                             MatchExpressionParser::kAllowAllSpecialFeatures));
+            auto cq = [&] {
+                ScopedPhaseTimer parseTimer(opCtx, OpDebug::Phase::kParse);
+                return uassertStatusOK(
+                    CanonicalQuery::canonicalize(opCtx,
+                                                 std::move(qr),
+                                                 expCtx,
+                                                 extensionsCallback,
+                                                 MatchExpressionParser::kAllowAllSpecialFeatures));
+            }();
 
             if (ctx->getView()) {
                 // Relinquish locks. The aggregation command will re-acquire them.
@@ -385,6 +415,7 @@ public:
                         opCtx->getRemainingMaxTimeMicros());
                 }
                 pinnedCursor.getCursor()->setPos(numResults);
+                pinnedCursor.getCursor()->recordBatch(numResults, firstBatch.bytesUsed());
 
                 // Fill out curop based on the results.
                 endQueryOp(opCtx, collection, *cursorExec, numResults, cursorId);
@@ -397,6 +428,82 @@ public:
         }
 
     private:
+        /**
+         * Answers a find on a single _id value by looking the document up in the _id index, without
+         * building a CanonicalQuery or a PlanExecutor. Returns false, having done nothing, if the
+         * find needs the general path: for example if the collection has a default collation, is
+         * sharded, or if the operation is to be profiled.
+         */
+        bool runIdPointFind(OperationContext* opCtx,
+                            Collection* collection,
+                            const NamespaceString& nss,
+                            const QueryRequest& qr,
+                            rpc::ReplyBuilderInterface* result) {
+            if (!internalQueryExecEnableIdPointFindFastPath.load() || !collection ||
+                !isIdPointFind(qr) || collection->getDefaultCollator() ||
+                CurOp::get(opCtx)->shouldDBProfile()) {
+                return false;
+            }
+
+            // Orphaned documents must be filtered out on sharded collections.
+            if (ShardingState::get(opCtx)->needCollectionMetadata(opCtx, nss.ns()) &&
+                CollectionShardingState::get(opCtx, nss)->getMetadata(opCtx)->isSharded()) {
+                return false;
+            }
+
+            const IndexDescriptor* idIndex = collection->getIndexCatalog()->findIdIndex(opCtx);
+            if (!idIndex) {
+                return false;
+            }
+
+            {
+                stdx::lock_guard<Client> lk(*opCtx->getClient());
+                CurOp::get(opCtx)->setPlanSummary_inlock("IDHACK"_sd);
+            }
+
+            const BSONObj key = qr.getFilter()["_id"].wrap();
+            const IndexAccessMethod* iam = collection->getIndexCatalog()->getIndex(idIndex);
+            boost::optional<BSONObj> doc;
+            writeConflictRetry(opCtx, "find", nss.ns(), [&] {
+                doc = boost::none;
+                RecordId recordId = iam->findSingle(opCtx, key);
+                Snapshotted<BSONObj> snapshotted;
+                if (!recordId.isNull() && collection->findDoc(opCtx, recordId, &snapshotted)) {
+                    doc = snapshotted.value();
+                }
+            });
+
+            CurOpFailpointHelpers::waitWhileFailPointEnabled(
+                &waitInFindBeforeMakingBatch, opCtx, "waitInFindBeforeMakingBatch");
+
+            CursorResponseBuilder::Options options;
+            options.isInitialResponse = true;
+            CursorResponseBuilder firstBatch(result, options);
+            if (doc) {
+                firstBatch.append(*doc);
+            }
+
+            auto css = CollectionShardingState::get(opCtx, nss);
+            css->checkShardVersionOrThrow(opCtx);
+
+            // Fill out curop as endQueryOp() would for an IDHACK plan.
+            const long long numResults = doc ? 1 : 0;
+            auto curOp = CurOp::get(opCtx);
+            curOp->debug().nreturned = numResults;
+            curOp->debug().cursorid = -1;
+            curOp->debug().cursorExhausted = true;
+
+            PlanSummaryStats summaryStats;
+            summaryStats.totalKeysExamined = numResults;
+            summaryStats.totalDocsExamined = numResults;
+            summaryStats.indexesUsed.insert(idIndex->indexName());
+            curOp->debug().setPlanSummaryMetrics(summaryStats);
+            collection->infoCache()->notifyOfQuery(opCtx, summaryStats.indexesUsed);
+
+            firstBatch.done(0, nss.ns());
+            return true;
+        }
+
         const OpMsgRequest& _request;
         const StringData _dbName;
     };
@@ -44,6 +44,7 @@
 #include "mongo/db/cursor_manager.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/pipeline/document.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
@@ -129,6 +130,31 @@ void validateTxnNumber(OperationContext* opCtx,
                 (*opCtx->getTxnNumber() == *cursor->getTxnNumber()));
 }
 
+/**
+ * Returns the number of bytes to reserve for the reply to a getMore on 'cursor'. When the request
+ * has a batch size and the cursor has already returned documents, the reply is sized from their
+ * average size; otherwise room is made for the largest batch a getMore can return.
+ */
+std::size_t expectedReplySize(const ClientCursor& cursor, const GetMoreRequest& request) {
+    // The extra 1K is an artifact of how we construct batches. We consider a batch to be full
+    // when it exceeds the goal batch size. In the case that we are just below the limit and
+    // then read a large document, the extra 1K helps prevent a final realloc+memcpy.
+    const std::size_t maxReplySize = FindCommon::kMaxBytesToReturnToClientAtOnce + 1024u;
+
+    const std::size_t averageDocSize = cursor.averageReturnedDocumentSize();
+    if (!request.batchSize || *request.batchSize <= 0 || averageDocSize == 0) {
+        return maxReplySize;
+    }
+
+    // Allow for the per-document array index and type bytes, and the cursor response envelope.
+    const std::size_t perDocSize = averageDocSize + 16u;
+    const auto batchSize = static_cast<std::size_t>(*request.batchSize);
+    if (batchSize > maxReplySize / perDocSize) {
+        return maxReplySize;
+    }
+    return std::min(maxReplySize, batchSize * perDocSize + 1024u);
+}
+
 /**
  * A command for running getMore() against an existing cursor registered with a CursorManager.
  * Used to generate the next batch of results for a ClientCursor.
@@ -428,6 +454,10 @@ public:
 
             CursorId respondWithId = 0;
 
+            // Reserve room for the whole batch up front, so that building it does not repeatedly
+            // grow and copy the reply.
+            reply->reserveBytes(expectedReplySize(*cursor, _request));
+
             CursorResponseBuilder nextBatch(reply, CursorResponseBuilder::Options());
             BSONObj obj;
             PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
@@ -493,12 +523,17 @@ public:
 
                 cursor->setLeftoverMaxTimeMicros(opCtx->getRemainingMaxTimeMicros());
                 cursor->incPos(numResults);
+                cursor->recordBatch(numResults, nextBatch.bytesUsed());
             } else {
                 curOp->debug().cursorExhausted = true;
             }
 
             nextBatch.done(respondWithId, _request.nss.ns());
 
+            // The documents of this batch are gone, so the memory cached for building them by an
+            // aggregation can go too.
+            Document::releaseCachedMemory();
+
             // Ensure log and profiler include the number of results returned in this getMore's
             // response
             // batch.
@@ -548,10 +583,8 @@ public:
     }
 
     std::size_t reserveBytesForReply() const override {
-        // The extra 1K is an artifact of how we construct batches. We consider a batch to be full
-        // when it exceeds the goal batch size. In the case that we are just below the limit and
-        // then read a large document, the extra 1K helps prevent a final realloc+memcpy.
-        return FindCommon::kMaxBytesToReturnToClientAtOnce + 1024u;
+        // The reply is sized once the cursor is known; see expectedReplySize().
+        return FindCommon::kInitReplyBufferSize;
     }
 
     /**
@@ -32,6 +32,8 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <regex>
+
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connpool.h"
@@ -57,13 +59,16 @@
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/catalog_cache.h"
 #include "mongo/s/client/parallel.h"
 #include "mongo/s/client/shard_connection.h"
@@ -93,6 +98,12 @@ namespace dps = ::mongo::dotted_path_support;
 namespace mr {
 namespace {
 
+// When true, inline mapReduce commands whose map and reduce functions are recognized by
+// translateToAggregation() run as an aggregation instead of through the JavaScript engine.
+// Keys are grouped with aggregation semantics, so documents missing the emitted field are
+// grouped under null rather than undefined.
+MONGO_EXPORT_SERVER_PARAMETER(mapReduceUseAggregationWhenPossible, bool, false);
+
 /**
  * Runs a count against the namespace specified by 'ns'. If the caller holds the global write lock,
  * then this function does not acquire any additional locks.
@@ -1343,6 +1354,123 @@ void State::reduceAndSpillInMemoryStateIfNeeded() {
     }
 }
 
+namespace {
+
+// function() { emit(this.<field>, <number>); }
+const std::regex kSumMapRegex(
+    R"(^\s*function\s*\(\s*\)\s*\{\s*emit\s*\(\s*this\.([A-Za-z_][A-Za-z0-9_]*)\s*,)"
+    R"(\s*(-?[0-9]+(?:\.[0-9]+)?)\s*\)\s*;?\s*\}\s*$)");
+
+// function(<key>, <values>) { return Array.sum(<values>); }
+const std::regex kSumReduceRegex(
+    R"(^\s*function\s*\(\s*[A-Za-z_$][A-Za-z0-9_$]*\s*,\s*([A-Za-z_$][A-Za-z0-9_$]*)\s*\))"
+    R"(\s*\{\s*return\s+Array\.sum\s*\(\s*\1\s*\)\s*;?\s*\}\s*$)");
+
+boost::optional<std::string> getFunctionSource(const BSONElement& elem) {
+    if (elem.type() != String && elem.type() != Code) {
+        return boost::none;
+    }
+    return elem._asCode();
+}
+
+/**
+ * Runs 'pipeline', built by translateToAggregation(), and appends the results and counts to
+ * 'result' in the shape of an inline mapReduce response.
+ */
+void runAsAggregation(OperationContext* opCtx,
+                      const Config& config,
+                      const std::vector<BSONObj>& pipeline,
+                      BSONObjBuilder& result,
+                      BSONObjBuilder& countsBuilder) {
+    BSONObjBuilder aggCmd;
+    aggCmd.append("aggregate", config.nss.coll());
+    aggCmd.append("pipeline", pipeline);
+    aggCmd.append("cursor", BSONObj());
+    if (!config.collation.isEmpty()) {
+        aggCmd.append("collation", config.collation);
+    }
+
+    DBDirectClient client(opCtx);
+    BSONObj response;
+    client.runCommand(config.dbname, aggCmd.obj(), response);
+    uassertStatusOK(getStatusFromCommandResult(response));
+    auto cursorResponse = uassertStatusOK(CursorResponse::parseFromBSON(response));
+
+    DBClientCursor cursor(&client,
+                          cursorResponse.getNSS(),
+                          cursorResponse.getCursorId(),
+                          0,
+                          0,
+                          cursorResponse.releaseBatch());
+
+    long long numEmits = 0;
+    long long numReduces = 0;
+    long long numOutputs = 0;
+    BSONArrayBuilder results(result.subarrayStart("results"));
+    while (cursor.more()) {
+        BSONObj group = cursor.next();
+        const long long emits = group["emits"].safeNumberLong();
+        numEmits += emits;
+        if (emits > 1)
+            numReduces++;
+        numOutputs++;
+
+        BSONObjBuilder doc(results.subobjStart());
+        doc.append(group["_id"]);
+        doc.append(group["value"]);
+    }
+    results.done();
+
+    countsBuilder.appendNumber("input", numEmits);
+    countsBuilder.appendNumber("emit", numEmits);
+    countsBuilder.appendNumber("reduce", numReduces);
+    countsBuilder.appendNumber("output", numOutputs);
+}
+
+}  // namespace
+
+boost::optional<std::vector<BSONObj>> translateToAggregation(const Config& config,
+                                                             const BSONObj& cmd) {
+    if (config.outputOptions.outType != Config::INMEMORY || config.finalizer ||
+        !config.scopeSetup.isEmpty() || config.shardedFirstPass) {
+        return boost::none;
+    }
+
+    auto mapSource = getFunctionSource(cmd["map"]);
+    auto reduceSource = getFunctionSource(cmd["reduce"]);
+    if (!mapSource || !reduceSource) {
+        return boost::none;
+    }
+
+    std::smatch mapMatch;
+    if (!std::regex_match(*mapSource, mapMatch, kSumMapRegex) ||
+        !std::regex_match(*reduceSource, kSumReduceRegex)) {
+        return boost::none;
+    }
+    const std::string keyPath = "$" + mapMatch[1].str();
+    // JavaScript numbers are doubles, so summing the emitted number as a double matches the values
+    // the JavaScript reduce would produce.
+    const double emitted = std::stod(mapMatch[2].str());
+
+    std::vector<BSONObj> pipeline;
+    if (!config.filter.isEmpty()) {
+        pipeline.push_back(BSON("$match" << config.filter));
+    }
+    if (!config.sort.isEmpty()) {
+        pipeline.push_back(BSON("$sort" << config.sort));
+    }
+    if (config.limit) {
+        pipeline.push_back(BSON("$limit" << config.limit));
+    }
+    pipeline.push_back(BSON("$group" << BSON("_id" << keyPath << "value"
+                                                   << BSON("$sum" << emitted)
+                                                   << "emits"
+                                                   << BSON("$sum" << 1))));
+    // Inline mapReduce returns its results ordered by key.
+    pipeline.push_back(BSON("$sort" << BSON("_id" << 1)));
+    return pipeline;
+}
+
 /**
  * This class represents a map/reduce command executed on a single server
  */
@@ -1418,6 +1546,22 @@ public:
 
         BSONObjBuilder countsBuilder;
         BSONObjBuilder timingBuilder;
+
+        if (mapReduceUseAggregationWhenPossible.load() && !collMetadata->isSharded()) {
+            if (auto pipeline = translateToAggregation(config, cmd)) {
+                LOG(1) << "mr running as aggregation: " << redact(cmd);
+                runAsAggregation(opCtx, config, *pipeline, result, countsBuilder);
+                result.appendNumber("timeMillis", t.millis());
+                if (config.verbose) {
+                    timingBuilder.append("mode", "aggregation");
+                    timingBuilder.appendNumber("total", t.millis());
+                    result.append("timing", timingBuilder.obj());
+                }
+                result.append("counts", countsBuilder.obj());
+                return true;
+            }
+        }
+
         try {
             State state(opCtx, config);
             if (!state.sourceExists()) {
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <string>
 #include <vector>
 
@@ -411,5 +412,15 @@ void addPrivilegesRequiredForMapReduce(const BasicCommand* commandTemplate,
  */
 bool mrSupportsWriteConcern(const BSONObj& cmd);
 
+/**
+ * Returns an aggregation pipeline producing the same results as the inline mapReduce 'cmd',
+ * described by 'config', or boost::none if it can't be expressed as one. Only maps of the form
+ * 'function() { emit(this.<field>, <number>); }' combined with reduces of the form
+ * 'function(key, values) { return Array.sum(values); }' are recognized, with no finalize or
+ * scope. Each output document carries an extra 'emits' field, the number of inputs in the group.
+ */
+boost::optional<std::vector<BSONObj>> translateToAggregation(const Config& config,
+                                                             const BSONObj& cmd);
+
 }  // namespace mr
 }  // namespace mongo
@@ -270,6 +270,56 @@ TEST(ConfigTest, CollationNotAnObjectFailsToParse) {
     ASSERT_THROWS(mr::Config(dbname, cmdObj), AssertionException);
 }
 
+/**
+ * Returns the result of mr::translateToAggregation() for the command 'cmdObj'.
+ */
+boost::optional<std::vector<BSONObj>> _translate(const BSONObj& cmdObj) {
+    mr::Config config("myDB", cmdObj);
+    return mr::translateToAggregation(config, cmdObj);
+}
+
+TEST(TranslateToAggregationTest, TranslatesCountingMapReduce) {
+    auto pipeline = _translate(fromjson(
+        "{mapReduce: 'coll', map: 'function() { emit(this.category, 1); }',"
+        " reduce: 'function(key, values) { return Array.sum(values); }',"
+        " query: {x: {$gt: 3}}, limit: 10, out: {inline: 1}}"));
+    ASSERT(pipeline);
+    ASSERT_EQ(4U, pipeline->size());
+    ASSERT_BSONOBJ_EQ(fromjson("{$match: {x: {$gt: 3}}}"), (*pipeline)[0]);
+    ASSERT_BSONOBJ_EQ(BSON("$limit" << 10LL), (*pipeline)[1]);
+    ASSERT_BSONOBJ_EQ(
+        fromjson("{$group: {_id: '$category', value: {$sum: 1.0}, emits: {$sum: 1}}}"),
+        (*pipeline)[2]);
+    ASSERT_BSONOBJ_EQ(fromjson("{$sort: {_id: 1}}"), (*pipeline)[3]);
+}
+
+TEST(TranslateToAggregationTest, DoesNotTranslateUnrecognizedFunctions) {
+    // A map that emits more than once per document.
+    ASSERT_FALSE(_translate(fromjson(
+        "{mapReduce: 'coll', map: 'function() { emit(this.a, 1); emit(this.b, 1); }',"
+        " reduce: 'function(key, values) { return Array.sum(values); }', out: {inline: 1}}")));
+    // A reduce that isn't a sum.
+    ASSERT_FALSE(_translate(fromjson(
+        "{mapReduce: 'coll', map: 'function() { emit(this.a, 1); }',"
+        " reduce: 'function(key, values) { return values.length; }', out: {inline: 1}}")));
+    // A reduce that sums something other than its values argument.
+    ASSERT_FALSE(_translate(fromjson(
+        "{mapReduce: 'coll', map: 'function() { emit(this.a, 1); }',"
+        " reduce: 'function(key, values) { return Array.sum(key); }', out: {inline: 1}}")));
+}
+
+TEST(TranslateToAggregationTest, DoesNotTranslateUnsupportedOptions) {
+    const std::string functions =
+        "map: 'function() { emit(this.a, 1); }',"
+        " reduce: 'function(key, values) { return Array.sum(values); }'";
+    ASSERT_FALSE(_translate(fromjson("{mapReduce: 'coll', " + functions + ", out: 'outColl'}")));
+    ASSERT_FALSE(_translate(fromjson("{mapReduce: 'coll', " + functions +
+                                     ", finalize: 'function(key, value) { return value; }',"
+                                     " out: {inline: 1}}")));
+    ASSERT_FALSE(_translate(
+        fromjson("{mapReduce: 'coll', " + functions + ", scope: {x: 1}, out: {inline: 1}}")));
+}
+
 /**
  * OpObserver for mapReduce test fixture.
  */
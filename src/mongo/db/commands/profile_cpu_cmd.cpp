@@ -0,0 +1,178 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * The profileCpu command runs the built-in sampling CPU profiler for a while and returns the
+ * sampled stacks in the folded format understood by flame graph tools.
+ *
+ *     { profileCpu: 1, durationMillis: 10000, samplesPerSecond: 100 }
+ *
+ * With writeToDiagnosticDirectory: true, the folded stacks are instead written to a
+ * "cpuprofile.<time>.folded" file in the diagnostic data directory, which FTDC does not manage or
+ * remove.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/ftdc/constants.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/util/sampling_cpu_profiler.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+constexpr long long kDefaultDurationMillis = 10 * 1000;
+constexpr long long kMaxDurationMillis = 5 * 60 * 1000;
+constexpr long long kDefaultSamplesPerSecond = 100;
+constexpr long long kMaxSamplesPerSecond = 1000;
+
+class ProfileCpuCommand : public BasicCommand {
+public:
+    ProfileCpuCommand() : BasicCommand("profileCpu") {}
+
+    AllowedOnSecondary secondaryAllowed(ServiceContext*) const override {
+        return AllowedOnSecondary::kAlways;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    std::string help() const override {
+        return "{ profileCpu: 1, durationMillis: 10000, samplesPerSecond: 100, "
+               "writeToDiagnosticDirectory: false } samples the stacks of the threads using the "
+               "CPU for durationMillis and returns them as folded stacks for flame graph tools";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) const override {
+        ActionSet actions;
+        actions.addAction(ActionType::cpuProfiler);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* opCtx,
+             const std::string& dbname,
+             const BSONObj& cmdObj,
+             BSONObjBuilder& result) override {
+        long long durationMillis;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(
+            cmdObj, "durationMillis", kDefaultDurationMillis, &durationMillis));
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "durationMillis must be between 1 and " << kMaxDurationMillis,
+                durationMillis > 0 && durationMillis <= kMaxDurationMillis);
+
+        long long samplesPerSecond;
+        uassertStatusOK(bsonExtractIntegerFieldWithDefault(
+            cmdObj, "samplesPerSecond", kDefaultSamplesPerSecond, &samplesPerSecond));
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "samplesPerSecond must be between 1 and " << kMaxSamplesPerSecond,
+                samplesPerSecond > 0 && samplesPerSecond <= kMaxSamplesPerSecond);
+
+        bool writeToDiagnosticDirectory;
+        uassertStatusOK(bsonExtractBooleanFieldWithDefault(
+            cmdObj, "writeToDiagnosticDirectory", false, &writeToDiagnosticDirectory));
+
+        uassertStatusOK(SamplingCpuProfiler::start(static_cast<int>(samplesPerSecond)));
+        auto stopGuard = MakeGuard([] { SamplingCpuProfiler::stop(); });
+
+        opCtx->sleepFor(Milliseconds(durationMillis));
+
+        stopGuard.Dismiss();
+        auto profile = SamplingCpuProfiler::stop();
+
+        result.append("samples", profile.samples);
+        result.append("droppedSamples", profile.droppedSamples);
+
+        // Most sampled stacks first, so a truncated response keeps the ones that matter.
+        std::vector<std::pair<long long, const std::string*>> stacks;
+        stacks.reserve(profile.foldedStacks.size());
+        for (auto&& foldedStack : profile.foldedStacks) {
+            stacks.emplace_back(foldedStack.second, &foldedStack.first);
+        }
+        std::sort(stacks.begin(), stacks.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.first > rhs.first;
+        });
+
+        if (writeToDiagnosticDirectory) {
+            boost::filesystem::path dir(storageGlobalParams.dbpath);
+            dir /= kFTDCDefaultDirectory.toString();
+            boost::filesystem::create_directories(dir);
+
+            const auto file = dir / ("cpuprofile." + terseCurrentTime(false) + ".folded");
+            std::ofstream out(file.string());
+            for (auto&& stack : stacks) {
+                out << *stack.second << ' ' << stack.first << '\n';
+            }
+            out.close();
+            uassert(ErrorCodes::FileStreamFailed,
+                    str::stream() << "Failed to write the CPU profile to " << file.string(),
+                    out.good());
+
+            result.append("file", file.string());
+            return true;
+        }
+
+        bool truncated = false;
+        {
+            BSONArrayBuilder stacksBuilder(result.subarrayStart("stacks"));
+            for (auto&& stack : stacks) {
+                // The array shares the reply's buffer. Leave room for the rest of the reply.
+                if (result.len() + stack.second->size() > BSONObjMaxUserSize / 2) {
+                    truncated = true;
+                    break;
+                }
+                stacksBuilder.append(BSON("stack" << *stack.second << "count" << stack.first));
+            }
+        }
+        result.append("truncated", truncated);
+        return true;
+    }
+
+} profileCpuCmd;
+
+}  // namespace
+}  // namespace mongo
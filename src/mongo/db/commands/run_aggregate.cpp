@@ -195,6 +195,9 @@ bool handleCursorCommand(OperationContext* opCtx,
     const CursorId cursorId = cursor ? cursor->cursorid() : 0LL;
     responseBuilder.done(cursorId, nsForCursor.ns());
 
+    // The documents of this batch are gone, so the memory cached for building them can go too.
+    Document::releaseCachedMemory();
+
     return static_cast<bool>(cursor);
 }
 
@@ -484,7 +487,10 @@ Status runAggregate(OperationContext* opCtx,
         invariant(collatorToUse);
         expCtx = makeExpressionContext(opCtx, request, std::move(*collatorToUse), uuid);
 
-        auto pipeline = uassertStatusOK(Pipeline::parse(request.getPipeline(), expCtx));
+        auto pipeline = [&] {
+            ScopedPhaseTimer parseTimer(opCtx, OpDebug::Phase::kParse);
+            return uassertStatusOK(Pipeline::parse(request.getPipeline(), expCtx));
+        }();
 
         // Check that the view's collation matches the collation of any views involved in the
         // pipeline.
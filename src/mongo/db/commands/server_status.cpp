@@ -163,6 +163,11 @@ public:
         _sections[section->getSectionName()] = section;
     }
 
+    ServerStatusSection* findSection(StringData sectionName) const {
+        auto it = _sections.find(sectionName.toString());
+        return it == _sections.end() ? nullptr : it->second;
+    }
+
 private:
     const Date_t _started;
     bool _runCalled;
@@ -193,6 +198,10 @@ ServerStatusSection::ServerStatusSection(const string& sectionName) : _sectionNa
     CmdServerStatusInstantiator::getInstance().addSection(this);
 }
 
+ServerStatusSection* findServerStatusSection(StringData sectionName) {
+    return CmdServerStatusInstantiator::getInstance().findSection(sectionName);
+}
+
 OpCounterServerStatusSection::OpCounterServerStatusSection(const string& sectionName,
                                                            OpCounters* counters)
     : ServerStatusSection(sectionName), _counters(counters) {}
@@ -108,6 +108,11 @@ private:
     const std::string _sectionName;
 };
 
+/**
+ * Returns the registered section named 'sectionName', or nullptr if there is none.
+ */
+ServerStatusSection* findServerStatusSection(StringData sectionName);
+
 class OpCounterServerStatusSection : public ServerStatusSection {
 public:
     OpCounterServerStatusSection(const std::string& sectionName, OpCounters* counters);
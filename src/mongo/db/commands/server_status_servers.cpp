@@ -37,6 +37,7 @@
 #include "mongo/util/net/hostname_canonicalization.h"
 #include "mongo/util/net/socket_utils.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/numa_placement.h"
 
 namespace mongo {
 
@@ -90,6 +91,21 @@ public:
 
 } network;
 
+class Numa : public ServerStatusSection {
+public:
+    Numa() : ServerStatusSection("numa") {}
+    virtual bool includeByDefault() const {
+        return NumaPlacement::get().isEnabled();
+    }
+
+    BSONObj generateSection(OperationContext* opCtx, const BSONElement& configElement) const {
+        BSONObjBuilder b;
+        NumaPlacement::get().appendStats(&b);
+        return b.obj();
+    }
+
+} numa;
+
 #ifdef MONGO_CONFIG_SSL
 class Security : public ServerStatusSection {
 public:
@@ -38,7 +38,10 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/storage_engine.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -76,7 +79,9 @@ public:
                "Slow.\n"
                "Add full:true option to do a more thorough check\n"
                "Add scandata:false to skip the scan of the collection data without skipping scans "
-               "of any indexes";
+               "of any indexes\n"
+               "Add background:true to validate a snapshot of the collection without blocking "
+               "writes to it";
     }
 
     virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
@@ -89,7 +94,8 @@ public:
         actions.addAction(ActionType::validate);
         out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
     }
-    //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool> } */
+    //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool> ]
+    //  [, background: <bool>] } */
 
     bool run(OperationContext* opCtx,
              const string& dbname,
@@ -104,6 +110,7 @@ public:
 
         const bool full = cmdObj["full"].trueValue();
         const bool scanData = cmdObj["scandata"].trueValue();
+        const bool background = cmdObj["background"].trueValue();
 
         ValidateCmdLevel level = kValidateIndex;
 
@@ -118,12 +125,33 @@ public:
                       "Can only run full validate on a regular collection");
         }
 
+        // A full validation verifies the storage engine's data structures, which requires exclusive
+        // access to them.
+        if (background && full) {
+            uasserted(ErrorCodes::InvalidOptions,
+                      "Running the validate command with { background: true } cannot be done "
+                      "with { full: true }");
+        }
+
         if (!serverGlobalParams.quiet.load()) {
-            LOG(0) << "CMD: validate " << nss.ns();
+            LOG(0) << "CMD: validate " << nss.ns() << (background ? " in the background" : "");
+        }
+
+        // A background validation reads all of the collection and its indexes from one snapshot,
+        // while writes to the collection continue. When the writes are timestamped, the snapshot
+        // is taken at a timestamp, so that the indexes can be read from several threads.
+        if (background &&
+            repl::ReplicationCoordinator::get(opCtx)->getReplicationMode() ==
+                repl::ReplicationCoordinator::modeReplSet &&
+            opCtx->getServiceContext()->getStorageEngine()->supportsReadConcernSnapshot()) {
+            opCtx->recoveryUnit()->setTimestampReadSource(
+                RecoveryUnit::ReadSource::kAllCommittedSnapshot);
         }
 
-        AutoGetDb ctx(opCtx, nss.db(), MODE_IX);
-        auto collLk = stdx::make_unique<Lock::CollectionLock>(opCtx->lockState(), nss.ns(), MODE_X);
+        const LockMode collLockMode = background ? MODE_IS : MODE_X;
+        AutoGetDb ctx(opCtx, nss.db(), background ? MODE_IS : MODE_IX);
+        auto collLk =
+            stdx::make_unique<Lock::CollectionLock>(opCtx->lockState(), nss.ns(), collLockMode);
         Collection* collection = ctx.getDb() ? ctx.getDb()->getCollection(opCtx, nss) : NULL;
         if (!collection) {
             if (ctx.getDb() && ctx.getDb()->getViewCatalog()->lookup(opCtx, nss.ns())) {
@@ -133,6 +161,13 @@ public:
             uasserted(ErrorCodes::NamespaceNotFound, "ns not found");
         }
 
+        // A background validation checks that the records come back in increasing RecordId order.
+        if (background && !collection->getRecordStore()->isInRecordIdOrder()) {
+            uasserted(ErrorCodes::CommandNotSupported,
+                      "Running the validate command with { background: true } is not supported "
+                      "by this collection's storage engine");
+        }
+
         result.append("ns", nss.ns());
 
         // Only one validation per collection can be in progress, the rest wait in order.
@@ -159,9 +194,6 @@ public:
             _validationNotifier.notify_all();
         });
 
-        // TODO SERVER-30357: Add support for background validation.
-        const bool background = false;
-
         ValidateResults results;
         Status status =
             collection->validate(opCtx, level, background, std::move(collLk), &results, &result);
@@ -414,6 +414,22 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     invariant((LockConflictsTable[request->mode] | LockConflictsTable[newMode]) ==
               LockConflictsTable[newMode]);
 
+    // Fast path for upgrading a partitioned request from MODE_IS to MODE_IX. A partitioned lock
+    // only ever has intent modes granted, which do not conflict with each other, so the upgrade is
+    // granted by just changing the mode of the request under the partition mutex. Should the lock
+    // be migrated later, the request moves to the LockHead in its new mode. This keeps a single
+    // upgrade from migrating every other intent request on the resource.
+    if (request->partitioned && (newMode == MODE_IX || newMode == MODE_IS)) {
+        Partition* partition = _getPartition(request);
+        stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
+        if (request->partitionedLock) {
+            request->mode = newMode;
+            return LOCK_OK;
+        }
+
+        // The lock was migrated since the request was granted, fall through to regular case
+    }
+
     LockBucket* bucket = _getBucket(resId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
@@ -567,6 +583,19 @@ void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     _onLockModeChanged(lock, true);
 }
 
+bool LockManager::hasWaiters(ResourceId resId) const {
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    const auto it = bucket->data.find(resId);
+    if (it == bucket->data.end()) {
+        return false;
+    }
+
+    const LockHead* lock = it->second;
+    return lock->conflictModes != 0 || lock->conversionsCount != 0;
+}
+
 void LockManager::cleanupUnusedLocks() {
     for (unsigned i = 0; i < _numLockBuckets; i++) {
         LockBucket* bucket = &_lockBuckets[i];
@@ -114,6 +114,12 @@ public:
      */
     void downgrade(LockRequest* request, LockMode newMode);
 
+    /**
+     * Returns true if there are requests for "resId" waiting to be granted or converted. Locks
+     * that are only held through partitions never have waiters.
+     */
+    bool hasWaiters(ResourceId resId) const;
+
     /**
      * Iterates through all buckets and deletes all locks, which have no requests on them. This
      * call is kind of expensive and should only be used for reducing the memory footprint of
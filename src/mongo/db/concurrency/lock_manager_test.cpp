@@ -349,6 +349,39 @@ TEST(LockManager, MultipleConflict) {
     }
 }
 
+TEST(LockManager, HasWaiters) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerImpl locker1;
+    TrackingLockGrantNotification notify1;
+
+    LockerImpl locker2;
+    TrackingLockGrantNotification notify2;
+
+    LockRequest request1;
+    request1.initNew(&locker1, &notify1);
+
+    LockRequest request2;
+    request2.initNew(&locker2, &notify2);
+
+    ASSERT_FALSE(lockMgr.hasWaiters(resId));
+
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_S));
+    ASSERT_FALSE(lockMgr.hasWaiters(resId));
+
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request2, MODE_X));
+    ASSERT_TRUE(lockMgr.hasWaiters(resId));
+
+    // Once the holder goes away the waiter is granted and nobody is left waiting
+    lockMgr.unlock(&request1);
+    ASSERT(notify2.numNotifies == 1);
+    ASSERT_FALSE(lockMgr.hasWaiters(resId));
+
+    lockMgr.unlock(&request2);
+    ASSERT_FALSE(lockMgr.hasWaiters(resId));
+}
+
 TEST(LockManager, ConflictCancelWaiting) {
     LockManager lockMgr;
     const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
@@ -573,6 +606,37 @@ TEST(LockManager, ConvertUpgrade) {
     ASSERT(lockMgr.unlock(&request2));
 }
 
+TEST(LockManager, ConvertUpgradeIntentModes) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IS));
+
+    LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IS));
+
+    // Upgrading IS to IX does not conflict with the other intent lock
+    ASSERT(LOCK_OK == lockMgr.convert(resId, &request1, MODE_IX));
+    ASSERT(request1.mode == MODE_IX);
+
+    // S conflicts with the upgraded request, but not with the IS request
+    LockerImpl locker3;
+    LockRequestCombo request3(&locker3);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request3, MODE_S));
+
+    ASSERT(!lockMgr.unlock(&request1));
+    ASSERT(request3.lastResult == LOCK_INVALID);
+
+    ASSERT(lockMgr.unlock(&request1));
+    ASSERT(request3.lastResult == LOCK_OK);
+
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT(lockMgr.unlock(&request3));
+}
+
 TEST(LockManager, Downgrade) {
     LockManager lockMgr;
     const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
@@ -32,13 +32,16 @@
 
 #include "mongo/db/concurrency/lock_state.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/db/concurrency/replication_lock_manager_manipulator.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/compiler.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/stdx/new.h"
+#include "mongo/stdx/unordered_set.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/debug_util.h"
@@ -51,6 +54,10 @@ namespace {
 
 /**
  * Partitioned global lock statistics, so we don't hit the same bucket.
+ *
+ * Each live Locker accumulates its statistics privately and registers them here, so that they
+ * are included when the per-instance statistics are read. The Locker folds them into its
+ * partition's counters once, when it is destroyed.
  */
 class PartitionedInstanceWideLockStats {
     MONGO_DISALLOW_COPYING(PartitionedInstanceWideLockStats);
@@ -58,50 +65,59 @@ class PartitionedInstanceWideLockStats {
 public:
     PartitionedInstanceWideLockStats() {}
 
-    void recordAcquisition(LockerId id, ResourceId resId, LockMode mode) {
-        _get(id).recordAcquisition(resId, mode);
-    }
-
-    void recordWait(LockerId id, ResourceId resId, LockMode mode) {
-        _get(id).recordWait(resId, mode);
+    void registerLocker(LockerId id, AtomicLockStats* stats) {
+        Partition& partition = _get(id);
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.liveLockerStats.insert(stats);
     }
 
-    void recordWaitTime(LockerId id, ResourceId resId, LockMode mode, uint64_t waitMicros) {
-        _get(id).recordWaitTime(resId, mode, waitMicros);
+    void unregisterLocker(LockerId id, AtomicLockStats* stats) {
+        Partition& partition = _get(id);
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.stats.append(*stats);
+        partition.liveLockerStats.erase(stats);
     }
 
-    void recordDeadlock(ResourceId resId, LockMode mode) {
-        _get(resId).recordDeadlock(resId, mode);
-    }
-
-    void report(SingleThreadedLockStats* outStats) const {
+    void report(SingleThreadedLockStats* outStats) {
         for (int i = 0; i < NumPartitions; i++) {
+            stdx::lock_guard<stdx::mutex> lk(_partitions[i].mutex);
             outStats->append(_partitions[i].stats);
+            for (auto&& stats : _partitions[i].liveLockerStats) {
+                outStats->append(*stats);
+            }
         }
     }
 
     void reset() {
         for (int i = 0; i < NumPartitions; i++) {
+            stdx::lock_guard<stdx::mutex> lk(_partitions[i].mutex);
             _partitions[i].stats.reset();
+            for (auto&& stats : _partitions[i].liveLockerStats) {
+                stats->reset();
+            }
         }
     }
 
 private:
     // This alignment is a best effort approach to ensure that each partition falls on a
     // separate page/cache line in order to avoid false sharing.
-    struct alignas(stdx::hardware_destructive_interference_size) AlignedLockStats {
+    struct alignas(stdx::hardware_destructive_interference_size) Partition {
+        // Protects the registration of Lockers and the folding of their statistics, so that a
+        // reader never counts the statistics of a Locker twice.
+        stdx::mutex mutex;
         AtomicLockStats stats;
+        stdx::unordered_set<AtomicLockStats*> liveLockerStats;
     };
 
     enum { NumPartitions = 8 };
 
 
-    AtomicLockStats& _get(LockerId id) {
-        return _partitions[id % NumPartitions].stats;
+    Partition& _get(LockerId id) {
+        return _partitions[id % NumPartitions];
     }
 
 
-    AlignedLockStats _partitions[NumPartitions];
+    Partition _partitions[NumPartitions];
 };
 
 
@@ -249,7 +265,9 @@ void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder
 }
 
 LockerImpl::LockerImpl()
-    : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _threadId(stdx::this_thread::get_id()) {}
+    : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _threadId(stdx::this_thread::get_id()) {
+    globalStats.registerLocker(_id, &_instanceStats);
+}
 
 stdx::thread::id LockerImpl::getThreadId() const {
     return _threadId;
@@ -273,6 +291,8 @@ LockerImpl::~LockerImpl() {
     invariant(_modeForTicket == MODE_NONE,
               str::stream() << "_modeForTicket found: " << _modeForTicket);
 
+    globalStats.unregisterLocker(_id, &_instanceStats);
+
     // Reset the locking statistics so the object can be reused
     _stats.reset();
 }
@@ -334,11 +354,21 @@ LockResult LockerImpl::_acquireTicket(OperationContext* opCtx, LockMode mode, Da
         // If the ticket wait is interrupted, restore the state of the client.
         auto restoreStateOnErrorGuard = MakeGuard([&] { _clientState.store(kInactive); });
 
-        OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
-        if (deadline == Date_t::max()) {
-            holder->waitForTicket(interruptible);
-        } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
-            return LOCK_TIMEOUT;
+        if (!holder->tryAcquire()) {
+            // Account for the time spent queued for the ticket, whether or not it was acquired.
+            const uint64_t startOfQueueTimeMicros = curTimeMicros64();
+            ON_BLOCK_EXIT([&] {
+                const int64_t queueTimeMicros = curTimeMicros64() - startOfQueueTimeMicros;
+                _stats.recordTicketWait(mode, queueTimeMicros);
+                _instanceStats.recordTicketWait(mode, queueTimeMicros);
+            });
+
+            OperationContext* interruptible = _uninterruptibleLocksRequested ? nullptr : opCtx;
+            if (deadline == Date_t::max()) {
+                holder->waitForTicket(interruptible);
+            } else if (!holder->waitForTicketUntil(interruptible, deadline)) {
+                return LOCK_TIMEOUT;
+            }
         }
         restoreStateOnErrorGuard.Dismiss();
     }
@@ -546,6 +576,29 @@ ResourceId LockerImpl::getWaitingResource() const {
     return ResourceId();
 }
 
+bool LockerImpl::hasWaitersForHeldResources() const {
+    if (_modeForTicket != MODE_NONE && shouldAcquireTicket()) {
+        auto holder = ticketHolders[_modeForTicket];
+        if (holder && holder->queued() > 0) {
+            return true;
+        }
+    }
+
+    std::vector<ResourceId> heldResources;
+    {
+        scoped_spinlock scopedLock(_lock);
+        for (auto it = _requests.begin(); !it.finished(); it.next()) {
+            if (it->status == LockRequest::STATUS_GRANTED) {
+                heldResources.push_back(it.key());
+            }
+        }
+    }
+
+    return std::any_of(heldResources.begin(), heldResources.end(), [](ResourceId resId) {
+        return globalLockManager.hasWaiters(resId);
+    });
+}
+
 void LockerImpl::getLockerInfo(LockerInfo* lockerInfo,
                                const boost::optional<SingleThreadedLockStats> lockStatsBase) const {
     invariant(lockerInfo);
@@ -730,8 +783,8 @@ LockResult LockerImpl::lockBegin(OperationContext* opCtx, ResourceId resId, Lock
     }
 
     // Making this call here will record lock re-acquisitions and conversions as well.
-    globalStats.recordAcquisition(_id, resId, mode);
     _stats.recordAcquisition(resId, mode);
+    _instanceStats.recordAcquisition(resId, mode);
 
     // Give priority to the full modes for global, parallel batch writer mode,
     // and flush lock so we don't stall global operations such as shutdown or flush.
@@ -772,8 +825,8 @@ LockResult LockerImpl::lockBegin(OperationContext* opCtx, ResourceId resId, Lock
     }
 
     if (result == LOCK_WAITING) {
-        globalStats.recordWait(_id, resId, mode);
         _stats.recordWait(resId, mode);
+        _instanceStats.recordWait(resId, mode);
     } else if (result == LOCK_OK && opCtx && _uninterruptibleLocksRequested == 0) {
         // Lock acquisitions are not allowed to succeed when opCtx is marked as interrupted, unless
         // the caller requested an uninterruptible lock.
@@ -838,8 +891,8 @@ LockResult LockerImpl::lockComplete(
         const uint64_t elapsedTimeMicros = curTimeMicros - startOfCurrentWaitTime;
         startOfCurrentWaitTime = curTimeMicros;
 
-        globalStats.recordWaitTime(_id, resId, mode, elapsedTimeMicros);
         _stats.recordWaitTime(resId, mode, elapsedTimeMicros);
+        _instanceStats.recordWaitTime(resId, mode, elapsedTimeMicros);
 
         if (result == LOCK_OK)
             break;
@@ -849,8 +902,8 @@ LockResult LockerImpl::lockComplete(
             if (wfg.check().hasCycle()) {
                 warning() << "Deadlock found: " << wfg.toString();
 
-                globalStats.recordDeadlock(resId, mode);
                 _stats.recordDeadlock(resId, mode);
+                _instanceStats.recordDeadlock(resId, mode);
 
                 result = LOCK_DEADLOCK;
                 break;
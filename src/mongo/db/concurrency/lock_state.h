@@ -323,6 +323,11 @@ private:
     // db.currentOp. Complementary to the per-instance locking statistics.
     SingleThreadedLockStats _stats;
 
+    // This Locker's share of the per-instance locking statistics. Only this Locker writes to
+    // them, so acquisitions do not contend on shared counters. They are included whenever the
+    // per-instance statistics are read, and folded into the shared counters on destruction.
+    AtomicLockStats _instanceStats;
+
     // Delays release of exclusive/intent-exclusive locked resources until the write unit of
     // work completes. Value of 0 means we are not inside a write unit of work.
     int _wuowNestingLevel;
@@ -365,6 +370,8 @@ public:
     virtual bool hasLockPending() const {
         return getWaitingResource().isValid();
     }
+
+    bool hasWaitersForHeldResources() const override;
 };
 
 /**
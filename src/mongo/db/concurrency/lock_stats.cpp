@@ -48,6 +48,7 @@ void LockStats<CounterType>::report(BSONObjBuilder* builder) const {
     }
 
     _report(builder, "oplog", _oplogStats);
+    _report(builder, "ticketQueue", _ticketQueueStats);
 }
 
 template <typename CounterType>
@@ -143,6 +144,7 @@ void LockStats<CounterType>::reset() {
 
     for (int mode = 0; mode < LockModesCount; mode++) {
         _oplogStats.modeStats[mode].reset();
+        _ticketQueueStats.modeStats[mode].reset();
     }
 }
 
@@ -65,7 +65,15 @@ struct CounterOps {
     }
 
     static void add(AtomicInt64& counter, int64_t value) {
-        counter.addAndFetch(value);
+        // Lockers fold their statistics into the shared atomic counters in bulk, and most of
+        // the counters they carry are zero, so skip the write for those.
+        if (value != 0) {
+            counter.addAndFetch(value);
+        }
+    }
+
+    static void add(AtomicInt64& counter, const AtomicInt64& value) {
+        add(counter, value.load());
     }
 };
 
@@ -137,6 +145,20 @@ public:
         CounterOps::add(get(resId, mode).numDeadlocks, 1);
     }
 
+    /**
+     * Records time spent queued for a storage engine ticket before acquiring the global lock in
+     * 'mode'. These are reported separately from the lock waits.
+     */
+    void recordTicketWait(LockMode mode, int64_t waitMicros) {
+        LockStatCountersType& stats = getTicketQueue(mode);
+        CounterOps::add(stats.numWaits, 1);
+        CounterOps::add(stats.combinedWaitTimeMicros, waitMicros);
+    }
+
+    LockStatCountersType& getTicketQueue(LockMode mode) {
+        return _ticketQueueStats.modeStats[mode];
+    }
+
     LockStatCountersType& get(ResourceId resId, LockMode mode) {
         if (resId == resourceIdOplog) {
             return _oplogStats.modeStats[mode];
@@ -164,6 +186,11 @@ public:
             LockStatCountersType& thisStats = _oplogStats.modeStats[mode];
             thisStats.append(otherStats);
         }
+
+        // Append the ticket queue stats
+        for (int mode = 0; mode < LockModesCount; mode++) {
+            _ticketQueueStats.modeStats[mode].append(other._ticketQueueStats.modeStats[mode]);
+        }
     }
 
     template <typename OtherType>
@@ -183,6 +210,10 @@ public:
             LockStatCountersType& thisStats = _oplogStats.modeStats[mode];
             thisStats.subtract(otherStats);
         }
+
+        for (int mode = 0; mode < LockModesCount; mode++) {
+            _ticketQueueStats.modeStats[mode].subtract(other._ticketQueueStats.modeStats[mode]);
+        }
     }
 
     void report(BSONObjBuilder* builder) const;
@@ -211,6 +242,9 @@ private:
     // more detailed stats for it.
     PerModeLockStatCounters _stats[ResourceTypesCount];
     PerModeLockStatCounters _oplogStats;
+
+    // Time spent queued for storage engine tickets, which are taken before the global lock.
+    PerModeLockStatCounters _ticketQueueStats;
 };
 
 typedef LockStats<int64_t> SingleThreadedLockStats;
@@ -31,6 +31,8 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -84,6 +86,63 @@ TEST(LockStats, Wait) {
     ASSERT_GREATER_THAN(stats.get(resId, MODE_S).combinedWaitTimeMicros, 0);
 }
 
+TEST(LockStats, ReportedWhileLockerIsAlive) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.Alive"));
+    const ResourceId globalResId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+
+    resetGlobalLockStats();
+
+    {
+        LockerImpl locker;
+        locker.lockGlobal(MODE_IX);
+        locker.lock(resId, MODE_IX);
+
+        // The statistics of a Locker still holding its locks are included
+        SingleThreadedLockStats stats;
+        reportGlobalLockingStats(&stats);
+        ASSERT_EQUALS(1, stats.get(resId, MODE_IX).numAcquisitions);
+        ASSERT_EQUALS(1, stats.get(globalResId, MODE_IX).numAcquisitions);
+
+        locker.unlock(resId);
+        locker.unlockGlobal();
+    }
+
+    // Destroying the Locker folds its statistics in exactly once
+    SingleThreadedLockStats stats;
+    reportGlobalLockingStats(&stats);
+    ASSERT_EQUALS(1, stats.get(resId, MODE_IX).numAcquisitions);
+    ASSERT_EQUALS(1, stats.get(globalResId, MODE_IX).numAcquisitions);
+}
+
+TEST(LockStats, TicketQueueWait) {
+    const ResourceId globalResId(RESOURCE_GLOBAL, ResourceId::SINGLETON_GLOBAL);
+
+    TicketHolder tickets(1);
+    Locker::setGlobalThrottling(&tickets, &tickets);
+    ON_BLOCK_EXIT([] { Locker::setGlobalThrottling(nullptr, nullptr); });
+
+    // Takes the only ticket
+    LockerImpl lockerWithTicket;
+    ASSERT_EQUALS(LOCK_OK, lockerWithTicket.lockGlobal(MODE_IX));
+
+    {
+        LockerImpl locker;
+        ASSERT_EQUALS(LOCK_TIMEOUT,
+                      locker.lockGlobalBegin(MODE_IS, Date_t::now() + Milliseconds(1)));
+
+        // The time spent queued for the ticket is not a wait for the global lock
+        Locker::LockerInfo lockerInfo;
+        locker.getLockerInfo(&lockerInfo, boost::none);
+        ASSERT_EQUALS(1, lockerInfo.stats.getTicketQueue(MODE_IS).numWaits);
+        ASSERT_GREATER_THAN(lockerInfo.stats.getTicketQueue(MODE_IS).combinedWaitTimeMicros, 0);
+        ASSERT_EQUALS(0, lockerInfo.stats.get(globalResId, MODE_IS).numAcquisitions);
+        ASSERT_EQUALS(0, lockerInfo.stats.get(globalResId, MODE_IS).numWaits);
+    }
+
+    lockerWithTicket.unlockGlobal();
+    ASSERT_EQUALS(0, tickets.used());
+}
+
 TEST(LockStats, Reporting) {
     const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.Reporting"));
 
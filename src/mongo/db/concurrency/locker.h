@@ -420,6 +420,12 @@ public:
      */
     virtual bool hasLockPending() const = 0;
 
+    /**
+     * Returns true if another operation is waiting for a lock held by this locker, or for a
+     * ticket of the kind this locker holds, so that releasing them would let it make progress.
+     */
+    virtual bool hasWaitersForHeldResources() const = 0;
+
     /**
      * If set to false, this opts out of conflicting with replication's use of the
      * ParallelBatchWriterMode lock. Code that opts-out must be ok with seeing an inconsistent view
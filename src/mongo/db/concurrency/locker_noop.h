@@ -228,6 +228,10 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    bool hasWaitersForHeldResources() const override {
+        return false;
+    }
+
     bool isGlobalLockedRecursively() override {
         return false;
     }
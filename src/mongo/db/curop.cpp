@@ -34,6 +34,7 @@
 
 #include "mongo/db/curop.h"
 
+#include <algorithm>
 #include <iomanip>
 
 #include "mongo/base/disallow_copying.h"
@@ -44,8 +45,10 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/json.h"
+#include "mongo/db/operation_memory_usage.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/stats/query_stats_store.h"
 #include "mongo/rpc/metadata/client_metadata.h"
 #include "mongo/rpc/metadata/client_metadata_ismaster.h"
 #include "mongo/rpc/metadata/impersonated_user_metadata.h"
@@ -289,6 +292,7 @@ void CurOp::reportCurrentOpForClient(OperationContext* opCtx,
         }
 
         CurOp::get(clientOpCtx)->reportState(infoBuilder, truncateOps);
+        OperationMemoryUsage::get(clientOpCtx).report(infoBuilder);
     }
 }
 
@@ -348,6 +352,7 @@ ProgressMeter& CurOp::setMessage_inlock(const char* msg,
         _progressMeter.finished();
     }
     _message = msg;
+    _progressDetails = BSONObj();
     return _progressMeter;
 }
 
@@ -393,6 +398,18 @@ bool CurOp::completeAndLogOperation(OperationContext* opCtx,
     _end = curTimeMicros64();
     _debug.executionTimeMicros = durationCount<Microseconds>(elapsedTimeExcludingPauses());
 
+    // Aggregate the statistics of every operation which was planned for a known query shape.
+    if (_debug.queryHash) {
+        QueryStatsStore::Sample sample;
+        sample.durationMicros = _debug.executionTimeMicros;
+        sample.docsExamined = _debug.additiveMetrics.docsExamined.value_or(0);
+        sample.keysExamined = _debug.additiveMetrics.keysExamined.value_or(0);
+        sample.nreturned = std::max(0LL, _debug.nreturned);
+        sample.bytesReturned = std::max(0, _debug.responseLength);
+        QueryStatsStore::get(opCtx->getServiceContext())
+            .record(_ns, *_debug.queryHash, _planSummary, sample);
+    }
+
     const bool shouldSample =
         client->getPrng().nextCanonicalDouble() < serverGlobalParams.sampleRate;
 
@@ -505,7 +522,12 @@ void CurOp::reportState(BSONObjBuilder* builder, bool truncateOps) {
         }
     }
 
+    if (!_progressDetails.isEmpty()) {
+        builder->append("progressDetails", _progressDetails);
+    }
+
     builder->append("numYields", _numYields);
+    _debug.appendPhaseTimes(builder);
 }
 
 namespace {
@@ -580,6 +602,9 @@ string OpDebug::report(Client* client,
     }
 
     OPDEBUG_TOSTRING_HELP(nShards);
+    if (!cursorEstablishMillis.isEmpty()) {
+        s << " cursorEstablishMillis:" << cursorEstablishMillis.toString();
+    }
     OPDEBUG_TOSTRING_HELP(cursorid);
     OPDEBUG_TOSTRING_HELP(ntoreturn);
     OPDEBUG_TOSTRING_HELP(ntoskip);
@@ -630,6 +655,15 @@ string OpDebug::report(Client* client,
         s << " locks:" << locks.obj().toString();
     }
 
+    {
+        BSONObjBuilder phases;
+        appendPhaseTimes(&phases);
+        auto phasesObj = phases.obj();
+        if (!phasesObj.isEmpty()) {
+            s << " " << phasesObj.firstElement().toString();
+        }
+    }
+
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
@@ -667,6 +701,9 @@ void OpDebug::append(const CurOp& curop,
     }
 
     OPDEBUG_APPEND_NUMBER(nShards);
+    if (!cursorEstablishMillis.isEmpty()) {
+        b.append("cursorEstablishMillis", cursorEstablishMillis);
+    }
     OPDEBUG_APPEND_NUMBER(cursorid);
     OPDEBUG_APPEND_BOOL(exhaust);
 
@@ -701,6 +738,7 @@ void OpDebug::append(const CurOp& curop,
         BSONObjBuilder locks(b.subobjStart("locks"));
         lockStats.report(&locks);
     }
+    appendPhaseTimes(&b);
 
     if (!errInfo.isOK()) {
         b.appendNumber("ok", 0.0);
@@ -726,6 +764,24 @@ void OpDebug::append(const CurOp& curop,
     }
 }
 
+void OpDebug::appendPhaseTimes(BSONObjBuilder* builder) const {
+    static const std::array<StringData, static_cast<size_t>(Phase::kNumPhases)> kPhaseNames{
+        {"parse"_sd, "planning"_sd, "writeConcernWait"_sd}};
+
+    if (std::none_of(phaseTimeMicros.begin(), phaseTimeMicros.end(), [](long long micros) {
+            return micros > 0;
+        })) {
+        return;
+    }
+
+    BSONObjBuilder phases(builder->subobjStart("phaseTimesMicros"));
+    for (size_t i = 0; i < phaseTimeMicros.size(); ++i) {
+        if (phaseTimeMicros[i] > 0) {
+            phases.appendNumber(kPhaseNames[i], phaseTimeMicros[i]);
+        }
+    }
+}
+
 void OpDebug::setPlanSummaryMetrics(const PlanSummaryStats& planSummaryStats) {
     additiveMetrics.keysExamined = planSummaryStats.totalKeysExamined;
     additiveMetrics.docsExamined = planSummaryStats.totalDocsExamined;
@@ -836,4 +892,13 @@ string OpDebug::AdditiveMetrics::report() {
     return s.str();
 }
 
+ScopedPhaseTimer::ScopedPhaseTimer(OperationContext* opCtx, OpDebug::Phase phase)
+    : _opCtx(opCtx), _curOp(CurOp::get(opCtx)), _phase(phase), _startMicros(curTimeMicros64()) {}
+
+ScopedPhaseTimer::~ScopedPhaseTimer() {
+    const long long elapsedMicros = static_cast<long long>(curTimeMicros64() - _startMicros);
+    stdx::lock_guard<Client> lk(*_opCtx->getClient());
+    _curOp->debug().phaseTimeMicros[static_cast<size_t>(_phase)] += elapsedMicros;
+}
+
 }  // namespace mongo
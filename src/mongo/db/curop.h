@@ -31,6 +31,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/cursor_id.h"
@@ -126,8 +128,21 @@ public:
         boost::optional<long long> writeConflicts;
     };
 
+    /**
+     * The phases of an operation whose duration is tracked apart from its total execution time.
+     * Lock acquisition and ticket queueing are not among them, as the lock statistics already
+     * report the time spent waiting on each resource.
+     */
+    enum class Phase { kParse, kPlanning, kWriteConcernWait, kNumPhases };
+
     OpDebug() = default;
 
+    /**
+     * Appends a "phaseTimesMicros" subobject holding the time spent in each phase that took any
+     * time. Appends nothing if no phase did.
+     */
+    void appendPhaseTimes(BSONObjBuilder* builder) const;
+
     std::string report(Client* client,
                        const CurOp& curop,
                        const SingleThreadedLockStats* lockStats) const;
@@ -195,8 +210,16 @@ public:
     // Shard targeting info.
     int nShards{-1};
 
+    // The milliseconds each shard took to respond to the request establishing its cursors, keyed by
+    // shard id. Owned here.
+    BSONObj cursorEstablishMillis;
+
     // Stores additive metrics.
     AdditiveMetrics additiveMetrics;
+
+    // Time spent in each Phase. Only modified with the client lock held, so that $currentOp can
+    // report it while the operation runs.
+    std::array<long long, static_cast<size_t>(Phase::kNumPhases)> phaseTimeMicros{};
 };
 
 /**
@@ -515,6 +538,14 @@ public:
                                      unsigned long long progressMeterTotal = 0,
                                      int secondsBetween = 3);
 
+    /**
+     * Attaches operation specific progress information, reported by currentOp as
+     * "progressDetails". Cleared by the next call to setMessage_inlock().
+     */
+    void setProgressDetails_inlock(BSONObj details) {
+        _progressDetails = details.getOwned();
+    }
+
     /**
      * Gets the message for this CurOp.
      */
@@ -601,6 +632,7 @@ private:
     OpDebug _debug;
     std::string _message;
     ProgressMeter _progressMeter;
+    BSONObj _progressDetails;
     int _numYields{0};
 
     std::string _planSummary;
@@ -608,6 +640,24 @@ private:
         _lockStatsBase;  // This is the snapshot of lock stats taken when curOp is constructed.
 };
 
+/**
+ * Adds the time between its construction and its destruction to a phase of the operation at the
+ * top of the CurOp stack of 'opCtx' when it is constructed.
+ */
+class ScopedPhaseTimer {
+    MONGO_DISALLOW_COPYING(ScopedPhaseTimer);
+
+public:
+    ScopedPhaseTimer(OperationContext* opCtx, OpDebug::Phase phase);
+    ~ScopedPhaseTimer();
+
+private:
+    OperationContext* const _opCtx;
+    CurOp* const _curOp;
+    const OpDebug::Phase _phase;
+    const unsigned long long _startMicros;
+};
+
 /**
  * Upconverts a legacy query object such that it matches the format of the find command.
  */
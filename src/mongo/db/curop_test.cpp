@@ -168,5 +168,20 @@ TEST(CurOpTest, AdditiveMetricsFieldsShouldIncrementByN) {
     ASSERT_EQ(*additiveMetrics.prepareReadConflicts, 8);
 }
 
+TEST(CurOpTest, AppendPhaseTimesOmitsPhasesThatTookNoTime) {
+    OpDebug opDebug;
+
+    BSONObjBuilder empty;
+    opDebug.appendPhaseTimes(&empty);
+    ASSERT_BSONOBJ_EQ(BSONObj(), empty.obj());
+
+    opDebug.phaseTimeMicros[static_cast<size_t>(OpDebug::Phase::kParse)] = 5;
+    opDebug.phaseTimeMicros[static_cast<size_t>(OpDebug::Phase::kWriteConcernWait)] = 1000;
+    BSONObjBuilder phases;
+    opDebug.appendPhaseTimes(&phases);
+    ASSERT_BSONOBJ_EQ(BSON("phaseTimesMicros" << BSON("parse" << 5 << "writeConcernWait" << 1000)),
+                      phases.obj());
+}
+
 }  // namespace
 }  // namespace mongo
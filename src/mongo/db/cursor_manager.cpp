@@ -32,6 +32,9 @@
 
 #include "mongo/db/cursor_manager.h"
 
+#include <algorithm>
+#include <functional>
+
 #include "mongo/base/data_cursor.h"
 #include "mongo/base/init.h"
 #include "mongo/db/audit.h"
@@ -486,6 +489,16 @@ void CursorManager::invalidateAll(OperationContext* opCtx,
     }
 }
 
+void CursorManager::enqueueForTimeout_inlock(std::size_t partitionId, const ClientCursor* cursor) {
+    if (cursor->isNoTimeout()) {
+        return;
+    }
+
+    auto& queue = _timeoutQueues[partitionId];
+    queue.emplace_back(cursor->_lastUseDate, cursor->cursorid());
+    std::push_heap(queue.begin(), queue.end(), std::greater<TimeoutEntry>());
+}
+
 bool CursorManager::cursorShouldTimeout_inlock(const ClientCursor* cursor, Date_t now) {
     if (cursor->isNoTimeout() || cursor->_operationUsingCursor) {
         return false;
@@ -495,17 +508,45 @@ bool CursorManager::cursorShouldTimeout_inlock(const ClientCursor* cursor, Date_
 
 std::size_t CursorManager::timeoutCursors(OperationContext* opCtx, Date_t now) {
     std::vector<std::unique_ptr<ClientCursor, ClientCursor::Deleter>> toDisposeWithoutMutex;
+    const Milliseconds timeout(getCursorTimeoutMillis());
 
     for (size_t partitionId = 0; partitionId < kNumPartitions; ++partitionId) {
         auto lockedPartition = _cursorMap->lockOnePartitionById(partitionId);
-        for (auto it = lockedPartition->begin(); it != lockedPartition->end();) {
+        auto& queue = _timeoutQueues[partitionId];
+
+        // Entries to put back once we are done popping, so that a pinned cursor is not visited
+        // twice in one pass.
+        std::vector<TimeoutEntry> requeue;
+        while (!queue.empty() && (now - queue.front().first) >= timeout) {
+            std::pop_heap(queue.begin(), queue.end(), std::greater<TimeoutEntry>());
+            const TimeoutEntry entry = queue.back();
+            queue.pop_back();
+
+            auto it = lockedPartition->find(entry.second);
+            if (it == lockedPartition->end()) {
+                // The cursor has already been destroyed.
+                continue;
+            }
+
             auto* cursor = it->second;
-            if (cursorShouldTimeout_inlock(cursor, now)) {
-                toDisposeWithoutMutex.emplace_back(cursor);
-                it = lockedPartition->erase(it);
-            } else {
-                ++it;
+            if (cursor->_lastUseDate != entry.first) {
+                // The cursor was used since it was queued. Its entry moves to the new date.
+                requeue.emplace_back(cursor->_lastUseDate, entry.second);
+                continue;
             }
+            if (!cursorShouldTimeout_inlock(cursor, now)) {
+                // The cursor is pinned. It gets a new last use date when it is unpinned.
+                requeue.push_back(entry);
+                continue;
+            }
+
+            toDisposeWithoutMutex.emplace_back(cursor);
+            lockedPartition->erase(it);
+        }
+
+        for (auto&& entry : requeue) {
+            queue.push_back(entry);
+            std::push_heap(queue.begin(), queue.end(), std::greater<TimeoutEntry>());
         }
     }
 
@@ -727,9 +768,24 @@ ClientCursorPin CursorManager::registerCursor(OperationContext* opCtx,
     }
 
     // Transfer ownership of the cursor to '_cursorMap'.
-    auto partition = _cursorMap->lockOnePartition(cursorId);
+    const auto partitionId = partitionIdOf(cursorId);
+    auto partition = _cursorMap->lockOnePartitionById(partitionId);
     ClientCursor* unownedCursor = clientCursor.release();
     partition->emplace(cursorId, unownedCursor);
+
+    // Entries for destroyed cursors are only dropped once they reach the top of the timeout queue.
+    // Rebuild the queue from the live cursors when they make up most of it.
+    auto& queue = _timeoutQueues[partitionId];
+    if (queue.size() >= 2 * partition->size() + kNumPartitions) {
+        queue.clear();
+        for (auto&& idAndCursor : *partition) {
+            if (idAndCursor.second != unownedCursor) {
+                enqueueForTimeout_inlock(partitionId, idAndCursor.second);
+            }
+        }
+    }
+    enqueueForTimeout_inlock(partitionId, unownedCursor);
+
     return ClientCursorPin(opCtx, unownedCursor);
 }
 
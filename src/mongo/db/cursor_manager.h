@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <array>
 #include <utility>
+#include <vector>
 
 #include "mongo/db/catalog/util/partitioned.h"
 #include "mongo/db/clientcursor.h"
@@ -128,7 +130,8 @@ public:
                        const std::string& reason);
 
     /**
-     * Destroys cursors that have been inactive for too long.
+     * Destroys cursors that have been inactive for too long. Only visits cursors whose last use is
+     * old enough for them to have expired, plus any pinned cursors among those.
      *
      * Returns the number of cursors that were timed out.
      */
@@ -280,6 +283,19 @@ private:
 
     bool cursorShouldTimeout_inlock(const ClientCursor* cursor, Date_t now);
 
+    /**
+     * Returns the partition of '_cursorMap', and of '_timeoutQueues', that holds 'id'.
+     */
+    static std::size_t partitionIdOf(CursorId id) {
+        return Partitioner<CursorId>()(id, kNumPartitions);
+    }
+
+    /**
+     * Adds 'cursor' to the timeout queue of partition 'partitionId', under its last use date. Must
+     * hold the lock on that partition of '_cursorMap'.
+     */
+    void enqueueForTimeout_inlock(std::size_t partitionId, const ClientCursor* cursor);
+
     bool isGlobalManager() const {
         return _nss.isEmpty();
     }
@@ -313,5 +329,13 @@ private:
         _registeredPlanExecutors;
     std::unique_ptr<Partitioned<stdx::unordered_map<CursorId, ClientCursor*>, kNumPartitions>>
         _cursorMap;
+
+    // For each partition of '_cursorMap', a min-heap of (last use date, cursor id) pairs, guarded
+    // by the mutex of that partition. Every registered cursor that can time out has one entry,
+    // whose date is no later than the cursor's last use. An entry that turns out to be out of date
+    // when it reaches the top is pushed back with the cursor's current last use date, and entries
+    // for destroyed cursors are dropped lazily.
+    using TimeoutEntry = std::pair<Date_t, CursorId>;
+    std::array<std::vector<TimeoutEntry>, kNumPartitions> _timeoutQueues;
 };
 }  // namespace mongo
@@ -31,6 +31,7 @@
 #include "mongo/db/cursor_server_params.h"
 
 #include "mongo/db/server_parameters.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 namespace {
@@ -42,6 +43,20 @@ MONGO_EXPORT_SERVER_PARAMETER(cursorTimeoutMillis,
                               long long,
                               durationCount<Milliseconds>(kDefaultCursorTimeoutMinutes));
 
+// The most memory the per-thread caches of large reply buffers may hold in total.
+BoundServerParameter<long long> sharedBufferCacheMaxBytes(
+    "sharedBufferCacheMaxBytes",
+    [](const long long& bytes) {
+        if (bytes < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "sharedBufferCacheMaxBytes must be greater than or equal to 0");
+        }
+        SharedBuffer::setMaxCachedBytes(bytes);
+        return Status::OK();
+    },
+    [] { return SharedBuffer::getMaxCachedBytes(); },
+    ServerParameterType::kStartupAndRuntime);
+
 }  // namespace
 
 int getClientCursorMonitorFrequencySecs() {
@@ -69,6 +69,7 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/exec/plan_evaluation_thread_pool.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/free_mon/free_mon_mongod.h"
 #include "mongo/db/ftdc/ftdc_mongod.h"
@@ -95,6 +96,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/periodic_runner_job_abort_expired_transactions.h"
 #include "mongo/db/periodic_runner_job_decrease_snapshot_cache_pressure.h"
+#include "mongo/db/plan_cache_snapshot.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repair_database_and_check_version.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
@@ -600,6 +602,8 @@ ExitCode _initAndListen(int listenPort) {
             startTTLBackgroundJob();
         }
 
+        startPlanCacheSnapshotJob();
+
         if (replSettings.usingReplSets() || !internalValidateFeaturesAsMaster) {
             serverGlobalParams.validateFeaturesAsMaster.store(false);
         }
@@ -904,6 +908,9 @@ void shutdownTask() {
         runner->shutdown();
     }
 
+    // The queries working their plans on this pool have been killed above, so it drains quickly.
+    PlanEvaluationThreadPool::get(serviceContext).shutdown();
+
     ReplicaSetMonitor::shutdown();
 
     if (auto sr = Grid::get(serviceContext)->shardRegistry()) {
@@ -55,11 +55,13 @@
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_id.h"
 #include "mongo/db/storage/data_protector.h"
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
@@ -139,6 +141,27 @@ RecordId Helpers::findOne(OperationContext* opCtx,
     return RecordId();
 }
 
+namespace {
+
+/**
+ * Returns the RecordId of the document with _id 'id' in a collection clustered by _id, or a null
+ * RecordId if there is no such document.
+ */
+RecordId findClusteredId(OperationContext* opCtx,
+                         Collection* collection,
+                         const BSONElement& id) {
+    auto swRecordId = clustered_id::keyForId(id);
+    if (!swRecordId.isOK())
+        return RecordId();
+
+    RecordData unused;
+    if (!collection->getRecordStore()->findRecord(opCtx, swRecordId.getValue(), &unused))
+        return RecordId();
+    return swRecordId.getValue();
+}
+
+}  // namespace
+
 bool Helpers::findById(OperationContext* opCtx,
                        Database* database,
                        StringData ns,
@@ -158,14 +181,16 @@ bool Helpers::findById(OperationContext* opCtx,
 
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
+    const bool isClustered = collection->getRecordStore()->isClustered();
 
-    if (!desc)
+    if (!desc && !isClustered)
         return false;
 
     if (indexFound)
         *indexFound = 1;
 
-    RecordId loc = catalog->getIndex(desc)->findSingle(opCtx, query["_id"].wrap());
+    RecordId loc = desc ? catalog->getIndex(desc)->findSingle(opCtx, query["_id"].wrap())
+                        : findClusteredId(opCtx, collection, query["_id"]);
     if (loc.isNull())
         return false;
     result = collection->docFor(opCtx, loc).value();
@@ -176,6 +201,9 @@ RecordId Helpers::findById(OperationContext* opCtx,
                            Collection* collection,
                            const BSONObj& idquery) {
     verify(collection);
+    if (collection->getRecordStore()->isClustered())
+        return findClusteredId(opCtx, collection, idquery["_id"]);
+
     IndexCatalog* catalog = collection->getIndexCatalog();
     const IndexDescriptor* desc = catalog->findIdIndex(opCtx);
     uassert(13430, "no _id index", desc);
@@ -355,7 +383,14 @@ Status Helpers::RemoveSaver::goingToDelete(const BSONObj& o) {
         // this anyway as per SERVER-26412.
         invariant(!_root.empty());
         boost::filesystem::create_directories(_root);
-        _out.reset(new ofstream(_file.string().c_str(), ios_base::out | ios_base::binary));
+        // Documents are written one at a time, often many small ones, so give the stream a buffer
+        // large enough to turn them into few large writes.
+        const std::size_t kOutBufferSize = 1024 * 1024;
+        _outBuffer.reset(new char[kOutBufferSize]);
+        auto out = stdx::make_unique<ofstream>();
+        out->rdbuf()->pubsetbuf(_outBuffer.get(), kOutBufferSize);
+        out->open(_file.string().c_str(), ios_base::out | ios_base::binary);
+        _out = std::move(out);
         if (_out->fail()) {
             string msg = str::stream() << "couldn't create file: " << _file.string()
                                        << " for remove saving: " << redact(errnoWithDescription());
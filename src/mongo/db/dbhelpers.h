@@ -186,6 +186,8 @@ struct Helpers {
         boost::filesystem::path _root;
         boost::filesystem::path _file;
         std::unique_ptr<DataProtector> _protector;
+        // Buffers the writes to '_out', which is destroyed before it.
+        std::unique_ptr<char[]> _outBuffer;
         std::unique_ptr<std::ostream> _out;
     };
 };
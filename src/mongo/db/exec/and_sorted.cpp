@@ -29,6 +29,7 @@
 #include "mongo/db/exec/and_sorted.h"
 
 #include "mongo/db/exec/and_common-inl.h"
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/stdx/memory.h"
@@ -41,6 +42,15 @@ using std::numeric_limits;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// A child that falls behind the target is first stepped this many times, which is cheaper than a
+// seek when the target is close, and then seeks straight to the target. PlanCostEstimator costs
+// AND_SORTED plans assuming the same number of steps.
+const size_t kStepsBeforeSkip = 2;
+
+}  // namespace
+
 // static
 const char* AndSortedStage::kStageType = "AND_SORTED";
 
@@ -70,6 +80,18 @@ PlanStage::StageState AndSortedStage::doWork(WorkingSetID* out) {
 
     if (0 == _specificStats.failedAnd.size()) {
         _specificStats.failedAnd.resize(_children.size());
+
+        _stepsBehind.resize(_children.size());
+        for (auto&& child : _children) {
+            IndexScan* ixscan = nullptr;
+            if (STAGE_IXSCAN == child->stageType()) {
+                ixscan = static_cast<IndexScan*>(child.get());
+                if (!ixscan->canSkipToRecordId()) {
+                    ixscan = nullptr;
+                }
+            }
+            _skippableChildren.push_back(ixscan);
+        }
     }
 
     // If we don't have any nodes that we're work()-ing until they hit a certain RecordId...
@@ -163,6 +185,7 @@ PlanStage::StageState AndSortedStage::moveTowardTargetRecordId(WorkingSetID* out
             // The front element has hit _targetRecordId.  Don't move it forward anymore/work on
             // another element.
             _workingTowardRep.pop();
+            _stepsBehind[workingChildNumber] = 0;
             AndCommon::mergeFrom(_ws, _targetId, *member);
             _ws->free(id);
 
@@ -182,12 +205,14 @@ PlanStage::StageState AndSortedStage::moveTowardTargetRecordId(WorkingSetID* out
             // The front element of _workingTowardRep hasn't hit the thing we're AND-ing with
             // yet.  Try again later.
             _ws->free(id);
+            childBehindTarget(workingChildNumber);
             return PlanStage::NEED_TIME;
         } else {
             // member->recordId > _targetRecordId.
             // _targetRecordId wasn't successfully AND-ed with the other sub-plans.  We toss it and
             // try AND-ing with the next value.
             _specificStats.failedAnd[_targetNode]++;
+            _stepsBehind[workingChildNumber] = 0;
 
             _ws->free(_targetId);
             _targetNode = workingChildNumber;
@@ -227,6 +252,17 @@ PlanStage::StageState AndSortedStage::moveTowardTargetRecordId(WorkingSetID* out
     }
 }
 
+void AndSortedStage::childBehindTarget(size_t childNumber) {
+    IndexScan* ixscan = _skippableChildren[childNumber];
+    if (!ixscan || ++_stepsBehind[childNumber] < kStepsBeforeSkip) {
+        return;
+    }
+
+    ixscan->skipToRecordId(_targetRecordId);
+    _stepsBehind[childNumber] = 0;
+    ++_specificStats.skips;
+}
+
 unique_ptr<PlanStageStats> AndSortedStage::getStats() {
     _commonStats.isEOF = isEOF();
 
@@ -38,10 +38,15 @@
 
 namespace mongo {
 
+class IndexScan;
+
 /**
  * Reads from N children, each of which must have a valid RecordId. Assumes each child produces
  * RecordIds in sorted order. Outputs the intersection of the RecordIds outputted by the children.
  *
+ * A child that is an index scan over a single point, and falls behind the RecordId being
+ * intersected, is told to seek ahead to it rather than return every entry in between.
+ *
  * Preconditions: Valid RecordId. More than one child.
  */
 class AndSortedStage final : public PlanStage {
@@ -71,6 +76,9 @@ private:
     // Returns the target node in 'out' if all children successfully advance to it.
     PlanStage::StageState moveTowardTargetRecordId(WorkingSetID* out);
 
+    // Called when child 'childNumber' returned a RecordId behind the target.
+    void childBehindTarget(size_t childNumber);
+
     // Not owned by us.
     const Collection* _collection;
 
@@ -90,6 +98,12 @@ private:
     // If any child hits EOF or if we have any errors, we're EOF.
     bool _isEOF;
 
+    // For each child, the index scan it can seek, or nullptr if it can only be stepped.
+    std::vector<IndexScan*> _skippableChildren;
+
+    // For each child, how many results in a row it has returned behind the target.
+    std::vector<size_t> _stepsBehind;
+
     // Stats
     AndSortedStats _specificStats;
 };
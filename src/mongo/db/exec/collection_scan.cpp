@@ -61,6 +61,7 @@ CollectionScan::CollectionScan(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _workingSet(workingSet),
       _filter(filter),
+      _compiledFilter(CompiledMatchExpression::compile(filter)),
       _params(params),
       _isDead(false) {
     // Explain reports the direction of the collection scan.
@@ -117,6 +118,10 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
             _cursor = _params.collection->getCursor(getOpCtx(), forward);
 
+            if (forward && !_params.tailable && _params.readAheadRecords > 0) {
+                _specificStats.readAhead = _cursor->enableReadAhead(_params.readAheadRecords);
+            }
+
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
                 // Seek to where we were last time. If it no longer exists, mark us as dead since we
@@ -184,6 +189,19 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     return returnIfMatches(member, id, out);
 }
 
+PlanStage::StageState CollectionScan::doWorkBatch(size_t maxBatchSize,
+                                                  std::vector<WorkingSetID>* out,
+                                                  WorkingSetID* statusOut) {
+    // Drive doWork() directly rather than through work() so that the per-result virtual call and
+    // timer are paid once per batch instead.
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    return workBatchLoop(maxBatchSize, out, statusOut, [this](WorkingSetID* id) {
+        const StageState state = CollectionScan::doWork(id);
+        recordWork(state);
+        return state;
+    });
+}
+
 Status CollectionScan::setLatestOplogEntryTimestamp(const Record& record) {
     auto tsElem = record.data.toBson()[repl::OpTime::kTimestampFieldName];
     if (tsElem.type() != BSONType::bsonTimestamp) {
@@ -202,9 +220,10 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
+            _compiledFilter.reset();
         }
         *out = memberID;
         return PlanStage::ADVANCED;
@@ -254,6 +273,12 @@ unique_ptr<PlanStageStats> CollectionScan::getStats() {
         _commonStats.filter = bob.obj();
     }
 
+    if (_cursor && _specificStats.readAhead) {
+        const auto readAheadStats = _cursor->getReadAheadStats();
+        _specificStats.readAheadHits = readAheadStats.hits;
+        _specificStats.readAheadStalls = readAheadStats.stalls;
+    }
+
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_COLLSCAN);
     ret->specific = make_unique<CollectionScanStats>(_specificStats);
     return ret;
@@ -68,6 +68,9 @@ struct CollectionScanParams {
 
     // Whether or not to wait for oplog visibility on oplog collection scans.
     bool shouldWaitForOplogVisibility = false;
+
+    // If positive, a forward scan asks the storage engine to read this many records ahead of it.
+    long long readAheadRecords = 0;
 };
 
 }  // namespace mongo
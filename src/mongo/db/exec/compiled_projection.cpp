@@ -0,0 +1,232 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/compiled_projection.h"
+
+namespace mongo {
+
+namespace {
+
+const StringData kIdField = "_id"_sd;
+
+}  // namespace
+
+/**
+ * Appends whole elements to a builder, merging elements that are adjacent in the input document
+ * into a single copy. Must be flushed before anything else is appended to the builder.
+ */
+class CompiledProjection::ElementRunAppender {
+public:
+    explicit ElementRunAppender(BSONObjBuilder* bob) : _buf(bob->bb()) {}
+
+    void append(const BSONElement& elt) {
+        if (elt.rawdata() != _end) {
+            flush();
+            _begin = elt.rawdata();
+        }
+        _end = elt.rawdata() + elt.size();
+    }
+
+    void flush() {
+        if (_begin != _end) {
+            _buf.appendBuf(_begin, _end - _begin);
+        }
+        _begin = _end = nullptr;
+    }
+
+private:
+    BufBuilder& _buf;
+    const char* _begin = nullptr;
+    const char* _end = nullptr;
+};
+
+CompiledProjection::CompiledProjection() : _nodes(1) {}
+
+std::unique_ptr<CompiledProjection> CompiledProjection::compile(const BSONObj& spec) {
+    if (spec.isEmpty()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CompiledProjection> projection(new CompiledProjection());
+    for (auto&& elt : spec) {
+        if (!elt.isNumber() && elt.type() != Bool) {
+            return nullptr;
+        }
+
+        // Rules out the positional operator.
+        const StringData path = elt.fieldNameStringData();
+        if (path.empty() || path.find('$') != std::string::npos) {
+            return nullptr;
+        }
+
+        if (path == kIdField && !elt.trueValue()) {
+            projection->_includeId = false;
+            continue;
+        }
+
+        projection->_add(0, path, elt.trueValue());
+        if (path.find('.') != std::string::npos) {
+            projection->_topLevelOnly = false;
+        }
+    }
+    return projection;
+}
+
+void CompiledProjection::_add(size_t nodeIndex, StringData path, bool include) {
+    if (path.empty()) {
+        _nodes[nodeIndex].include = include;
+        return;
+    }
+    _nodes[nodeIndex].include = !include;
+
+    const size_t dot = path.find('.');
+    const StringData field = path.substr(0, dot);
+    const StringData rest = dot == std::string::npos ? StringData() : path.substr(dot + 1);
+
+    size_t childIndex;
+    auto it = _nodes[nodeIndex].children.find(field);
+    if (it == _nodes[nodeIndex].children.end()) {
+        // Adding a node may reallocate '_nodes', so refer to nodes by index only.
+        childIndex = _nodes.size();
+        _nodes.emplace_back();
+        _nodes[nodeIndex].children[field] = childIndex;
+    } else {
+        childIndex = it->second;
+    }
+    _add(childIndex, rest, include);
+}
+
+void CompiledProjection::transform(const BSONObj& in, BSONObjBuilder* bob) const {
+    if (_topLevelOnly) {
+        _transformTopLevel(in, bob);
+        return;
+    }
+
+    ElementRunAppender run(bob);
+    for (auto&& elt : in) {
+        if (elt.fieldNameStringData() == kIdField) {
+            if (_includeId) {
+                run.append(elt);
+            }
+            continue;
+        }
+        _append(0, elt, bob, &run);
+    }
+    run.flush();
+}
+
+void CompiledProjection::_transformTopLevel(const BSONObj& in, BSONObjBuilder* bob) const {
+    // Every field is either kept or dropped whole, so the output is a series of element runs.
+    const Node& root = _nodes[0];
+    ElementRunAppender run(bob);
+    for (auto&& elt : in) {
+        const StringData field = elt.fieldNameStringData();
+        bool include;
+        if (field == kIdField) {
+            include = _includeId;
+        } else {
+            auto it = root.children.find(field);
+            include = it == root.children.end() ? root.include : _nodes[it->second].include;
+        }
+
+        if (include) {
+            run.append(elt);
+        }
+    }
+    run.flush();
+}
+
+void CompiledProjection::_append(size_t nodeIndex,
+                                 const BSONElement& elt,
+                                 BSONObjBuilder* bob,
+                                 ElementRunAppender* run) const {
+    const Node& node = _nodes[nodeIndex];
+    auto it = node.children.find(elt.fieldNameStringData());
+    if (it == node.children.end()) {
+        if (node.include) {
+            run->append(elt);
+        }
+        return;
+    }
+
+    const size_t subIndex = it->second;
+    const Node& sub = _nodes[subIndex];
+    if (sub.children.empty() || (elt.type() != Object && elt.type() != Array)) {
+        if (sub.include) {
+            run->append(elt);
+        }
+        return;
+    }
+
+    run->flush();
+    if (elt.type() == Object) {
+        BSONObjBuilder subBob(bob->subobjStart(elt.fieldNameStringData()));
+        ElementRunAppender subRun(&subBob);
+        for (auto&& subElt : elt.embeddedObject()) {
+            _append(subIndex, subElt, &subBob, &subRun);
+        }
+        subRun.flush();
+    } else {
+        BSONObjBuilder subBob(bob->subarrayStart(elt.fieldNameStringData()));
+        _appendArray(subIndex, elt.embeddedObject(), &subBob);
+    }
+}
+
+void CompiledProjection::_appendArray(size_t nodeIndex,
+                                      const BSONObj& array,
+                                      BSONObjBuilder* bob) const {
+    const Node& node = _nodes[nodeIndex];
+    int index = 0;
+    for (auto&& elt : array) {
+        switch (elt.type()) {
+            case Array: {
+                BSONObjBuilder subBob(bob->subarrayStart(bob->numStr(index++)));
+                _appendArray(nodeIndex, elt.embeddedObject(), &subBob);
+                break;
+            }
+            case Object: {
+                BSONObjBuilder subBob(bob->subobjStart(bob->numStr(index++)));
+                ElementRunAppender subRun(&subBob);
+                for (auto&& subElt : elt.embeddedObject()) {
+                    _append(nodeIndex, subElt, &subBob, &subRun);
+                }
+                subRun.flush();
+                break;
+            }
+            default:
+                if (node.include) {
+                    bob->appendAs(elt, bob->numStr(index++));
+                }
+        }
+    }
+}
+
+}  // namespace mongo
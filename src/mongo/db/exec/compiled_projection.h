@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * A find projection made only of field inclusions and exclusions, compiled ahead of time into a
+ * trie of field names.
+ *
+ * ProjectionExec walks a tree of ProjectionExec objects for every document and rechecks the
+ * array operators and $meta fields at each level. A compiled projection only has to look up each
+ * field name in the current trie node, and it copies runs of adjacent whole elements from the
+ * input into the output with a single buffer append. It produces the same documents as
+ * ProjectionExec for the projections it accepts.
+ */
+class CompiledProjection {
+public:
+    /**
+     * Compiles 'spec', or returns nullptr if it uses anything besides inclusion and exclusion of
+     * field paths, such as $slice, $elemMatch, $meta or the positional operator.
+     */
+    static std::unique_ptr<CompiledProjection> compile(const BSONObj& spec);
+
+    /**
+     * Appends the projection of 'in' to 'bob'.
+     */
+    void transform(const BSONObj& in, BSONObjBuilder* bob) const;
+
+    /**
+     * True if every path in the projection is a top-level field.
+     */
+    bool isTopLevelOnly() const {
+        return _topLevelOnly;
+    }
+
+private:
+    class ElementRunAppender;
+
+    struct Node {
+        // Whether fields without a child node are kept. The same meaning as
+        // ProjectionExec::_include.
+        bool include = true;
+
+        // Indexes into '_nodes' of the nodes for each named subfield.
+        StringMap<size_t> children;
+    };
+
+    CompiledProjection();
+
+    /**
+     * Adds 'path' below node 'nodeIndex', in the same way as ProjectionExec::add().
+     */
+    void _add(size_t nodeIndex, StringData path, bool include);
+
+    /**
+     * Appends the projection of 'elt' through node 'nodeIndex', as ProjectionExec::append().
+     */
+    void _append(size_t nodeIndex,
+                 const BSONElement& elt,
+                 BSONObjBuilder* bob,
+                 ElementRunAppender* run) const;
+
+    /**
+     * Appends the projection of the array 'array' through node 'nodeIndex', as
+     * ProjectionExec::appendArray() without $slice.
+     */
+    void _appendArray(size_t nodeIndex, const BSONObj& array, BSONObjBuilder* bob) const;
+
+    void _transformTopLevel(const BSONObj& in, BSONObjBuilder* bob) const;
+
+    // The trie. The root is at index 0.
+    std::vector<Node> _nodes;
+
+    bool _includeId = true;
+    bool _topLevelOnly = true;
+};
+
+}  // namespace mongo
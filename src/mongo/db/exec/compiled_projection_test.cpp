@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/compiled_projection.h"
+
+#include "mongo/db/exec/projection_exec.h"
+#include "mongo/db/json.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Checks that the compiled form of 'specStr' projects 'objStr' to 'expectedStr', and that it
+ * agrees with ProjectionExec.
+ */
+void assertProjects(const char* specStr, const char* objStr, const char* expectedStr) {
+    BSONObj spec = fromjson(specStr);
+    BSONObj obj = fromjson(objStr);
+
+    auto compiled = CompiledProjection::compile(spec);
+    ASSERT(compiled) << specStr;
+    BSONObjBuilder bob;
+    compiled->transform(obj, &bob);
+    BSONObj result = bob.obj();
+    ASSERT_BSONOBJ_EQ(fromjson(expectedStr), result);
+
+    QueryTestServiceContext serviceCtx;
+    auto opCtx = serviceCtx.makeOperationContext();
+    ProjectionExec exec(opCtx.get(), spec, nullptr, nullptr);
+    WorkingSetMember wsm;
+    wsm.obj = Snapshotted<BSONObj>(SnapshotId(), obj);
+    wsm.transitionToOwnedObj();
+    ASSERT_OK(exec.transform(&wsm));
+    ASSERT_BSONOBJ_EQ(wsm.obj.value(), result);
+}
+
+TEST(CompiledProjectionTest, RejectsNonSimpleProjections) {
+    ASSERT_FALSE(CompiledProjection::compile(BSONObj()));
+    ASSERT_FALSE(CompiledProjection::compile(fromjson("{a: {$slice: 1}}")));
+    ASSERT_FALSE(CompiledProjection::compile(fromjson("{a: {$elemMatch: {b: 1}}}")));
+    ASSERT_FALSE(CompiledProjection::compile(fromjson("{a: {$meta: 'textScore'}}")));
+    ASSERT_FALSE(CompiledProjection::compile(fromjson("{'a.$': 1}")));
+}
+
+TEST(CompiledProjectionTest, TopLevelInclusion) {
+    assertProjects("{a: 1, c: 1}", "{_id: 0, a: 1, b: 2, c: 3, d: 4}", "{_id: 0, a: 1, c: 3}");
+    assertProjects("{a: 1, _id: 0}", "{_id: 0, a: 1, b: 2}", "{a: 1}");
+    assertProjects("{a: 1}", "{b: 2}", "{}");
+    ASSERT_TRUE(CompiledProjection::compile(fromjson("{a: 1, b: true}"))->isTopLevelOnly());
+}
+
+TEST(CompiledProjectionTest, TopLevelExclusion) {
+    assertProjects("{b: 0}", "{_id: 0, a: 1, b: 2, c: 3, d: 4}", "{_id: 0, a: 1, c: 3, d: 4}");
+    assertProjects("{_id: 0}", "{_id: 0, a: 1}", "{a: 1}");
+    assertProjects("{b: false, _id: 0}", "{_id: 0, a: 1, b: 2}", "{a: 1}");
+}
+
+TEST(CompiledProjectionTest, DottedInclusion) {
+    ASSERT_FALSE(CompiledProjection::compile(fromjson("{'a.b': 1}"))->isTopLevelOnly());
+    assertProjects("{'a.b': 1}", "{_id: 1, a: {b: 1, c: 2}, d: 3}", "{_id: 1, a: {b: 1}}");
+    assertProjects("{'a.b': 1}", "{a: {c: 2}}", "{a: {}}");
+    assertProjects("{'a.b': 1}", "{a: 5}", "{}");
+    assertProjects("{'a.b.c': 1, 'a.d': 1}",
+                   "{a: {b: {c: 1, x: 2}, d: 3, e: 4}}",
+                   "{a: {b: {c: 1}, d: 3}}");
+}
+
+TEST(CompiledProjectionTest, DottedExclusion) {
+    assertProjects("{'a.b': 0}", "{_id: 1, a: {b: 1, c: 2}, d: 3}", "{_id: 1, a: {c: 2}, d: 3}");
+    assertProjects("{'a.b': 0}", "{a: 5}", "{a: 5}");
+}
+
+TEST(CompiledProjectionTest, DottedPathsThroughArrays) {
+    assertProjects("{'a.b': 1}",
+                   "{a: [{b: 1, c: 2}, 3, {c: 4}, [{b: 5}]]}",
+                   "{a: [{b: 1}, {}, [{b: 5}]]}");
+    assertProjects("{'a.b': 0}",
+                   "{a: [{b: 1, c: 2}, 3, [{b: 5, c: 6}]]}",
+                   "{a: [{c: 2}, 3, [{c: 6}]]}");
+}
+
+}  // namespace
+}  // namespace mongo
@@ -74,7 +74,6 @@ const char* CountScan::kStageType = "COUNT_SCAN";
 // from the descriptor's contents.
 CountScan::CountScan(OperationContext* opCtx, CountScanParams params, WorkingSet* workingSet)
     : PlanStage(kStageType, opCtx),
-      _workingSet(workingSet),
       _iam(params.accessMethod),
       _shouldDedup(params.isMultiKey),
       _params(std::move(params)) {
@@ -135,9 +134,9 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
-    WorkingSetID id = _workingSet->allocate();
-    _workingSet->transitionToRecordIdAndObj(id);
-    *out = id;
+    // The parent only counts how often we advance, so there is no need to spend a working set
+    // member on each key.
+    *out = WorkingSet::INVALID_ID;
     return PlanStage::ADVANCED;
 }
 
@@ -93,10 +93,9 @@ struct CountScanParams {
 };
 
 /**
- * Used by the count command. Scans an index from a start key to an end key. Creates a
- * WorkingSetMember for each matching index key in RID_AND_OBJ state. It has a null record id and an
- * empty object with a null snapshot id rather than real data. Returning real data is unnecessary
- * since all we need is the count.
+ * Used by the count command. Scans an index from a start key to an end key. Returns ADVANCED for
+ * each matching index key, but without a WorkingSetMember: returning data is unnecessary since all
+ * we need is the count.
  *
  * Only created through the getExecutorCount() path, as count is the only operation that doesn't
  * care about its data.
@@ -123,9 +122,6 @@ public:
     static const char* kStageType;
 
 private:
-    // The WorkingSet we annotate with results.  Not owned by us.
-    WorkingSet* _workingSet;
-
     // Index access. The pointer below is owned by Collection -> IndexCatalog.
     const IndexAccessMethod* _iam;
 
@@ -43,6 +43,28 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// The number of keys stepped over with next() looking for the next distinct value, before seeking.
+const size_t kMaxNextsBeforeSeek = 3;
+
+/**
+ * Returns true if the first 'prefixLen' fields of the index keys 'lhs' and 'rhs' are equal.
+ */
+bool keyPrefixesEqual(const BSONObj& lhs, const BSONObj& rhs, int prefixLen) {
+    BSONObjIterator lhsIt(lhs);
+    BSONObjIterator rhsIt(rhs);
+    for (int i = 0; i < prefixLen; ++i) {
+        invariant(lhsIt.more() && rhsIt.more());
+        if (lhsIt.next().woCompare(rhsIt.next(), false) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 // static
 const char* DistinctScan::kStageType = "DISTINCT_SCAN";
 
@@ -81,19 +103,41 @@ PlanStage::StageState DistinctScan::doWork(WorkingSetID* out) {
     try {
         if (!_cursor)
             _cursor = _iam->newCursor(getOpCtx(), _params.direction == 1);
-        kv = _cursor->seek(_seekPoint);
+
+        // Step over the remaining keys for the value returned last, as long as there are only a
+        // few of them. '_seekPoint' holds that key, which must be owned.
+        bool reachedNextValue = false;
+        for (size_t i = 0; _cursorPositionedOnLastKey && i < kMaxNextsBeforeSeek; ++i) {
+            kv = _cursor->next();
+            if (!kv) {
+                _commonStats.isEOF = true;
+                _cursorPositionedOnLastKey = false;
+                return PlanStage::IS_EOF;
+            }
+            ++_specificStats.keysExamined;
+            if (!keyPrefixesEqual(kv->key, _seekPoint.keyPrefix, _seekPoint.prefixLen)) {
+                reachedNextValue = true;
+                break;
+            }
+        }
+        _cursorPositionedOnLastKey = false;
+
+        if (!reachedNextValue) {
+            kv = _cursor->seek(_seekPoint);
+            ++_specificStats.seeks;
+            if (!kv) {
+                _commonStats.isEOF = true;
+                return PlanStage::IS_EOF;
+            }
+            ++_specificStats.keysExamined;
+        }
     } catch (const WriteConflictException&) {
+        // The cursor position is unknown, so the next attempt must seek.
+        _cursorPositionedOnLastKey = false;
         *out = WorkingSet::INVALID_ID;
         return PlanStage::NEED_YIELD;
     }
 
-    if (!kv) {
-        _commonStats.isEOF = true;
-        return PlanStage::IS_EOF;
-    }
-
-    ++_specificStats.keysExamined;
-
     switch (_checker.checkKey(kv->key, &_seekPoint)) {
         case IndexBoundsChecker::MUST_ADVANCE:
             // Try again next time. The checker has adjusted the _seekPoint.
@@ -114,6 +158,7 @@ PlanStage::StageState DistinctScan::doWork(WorkingSetID* out) {
             _seekPoint.keyPrefix = kv->key;
             _seekPoint.prefixLen = _params.fieldNo + 1;
             _seekPoint.prefixExclusive = true;
+            _cursorPositionedOnLastKey = true;
 
             // Package up the result for the caller.
             WorkingSetID id = _workingSet->allocate();
@@ -133,7 +178,8 @@ bool DistinctScan::isEOF() {
 }
 
 void DistinctScan::doSaveState() {
-    // We always seek, so we don't care where the cursor is.
+    // We always seek after restoring, so we don't care where the cursor is.
+    _cursorPositionedOnLastKey = false;
     if (_cursor)
         _cursor->saveUnpositioned();
 }
@@ -71,6 +71,9 @@ struct DistinctParams {
  * for that field, so there is no point in examining all keys with the same value for that
  * field.
  *
+ * When there are only a handful of keys per distinct value, advancing the cursor past them is
+ * cheaper than seeking, so a few keys are stepped over before falling back to a seek.
+ *
  * Only created through the getExecutorDistinct path.  See db/query/get_executor.cpp
  */
 class DistinctScan final : public PlanStage {
@@ -111,6 +114,10 @@ private:
     IndexBoundsChecker _checker;
     IndexSeekPoint _seekPoint;
 
+    // True if '_cursor' is positioned on the key last returned, in which case the next distinct
+    // value may be reached by advancing the cursor a few times rather than seeking past it.
+    bool _cursorPositionedOnLastKey = false;
+
     // Stats
     DistinctScanStats _specificStats;
 };
@@ -57,6 +57,7 @@ FetchStage::FetchStage(OperationContext* opCtx,
       _collection(collection),
       _ws(ws),
       _filter(filter),
+      _compiledFilter(CompiledMatchExpression::compile(filter)),
       _idRetrying(WorkingSet::INVALID_ID) {
     _children.emplace_back(child);
 }
@@ -69,7 +70,13 @@ bool FetchStage::isEOF() {
         return false;
     }
 
-    return child()->isEOF();
+    if (_childBatchPos < _childBatch.size()) {
+        // We still have results from our child's last batch to fetch.
+        return false;
+    }
+
+    // The state which cut our child's last batch short has yet to be reported.
+    return child()->isEOF() && !child()->hasPendingBatchState();
 }
 
 PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
@@ -77,47 +84,23 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
-    // Either retry the last WSM we worked on or get a new one from our child.
+    // Either retry the last WSM we worked on, continue with the remainder of the last batch or
+    // get a new one from our child.
     WorkingSetID id;
     StageState status;
-    if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
-    } else {
+    if (_idRetrying != WorkingSet::INVALID_ID) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+    } else if (_childBatchPos < _childBatch.size()) {
+        status = ADVANCED;
+        id = _childBatch[_childBatchPos++];
+    } else {
+        status = child()->work(&id);
     }
 
     if (PlanStage::ADVANCED == status) {
-        WorkingSetMember* member = _ws->get(id);
-
-        // If there's an obj there, there is no fetching to perform.
-        if (member->hasObj()) {
-            ++_specificStats.alreadyHasObj;
-        } else {
-            // We need a valid RecordId to fetch from and this is the only state that has one.
-            verify(WorkingSetMember::RID_AND_IDX == member->getState());
-            verify(member->hasRecordId());
-
-            try {
-                if (!_cursor)
-                    _cursor = _collection->getCursor(getOpCtx());
-
-                if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
-                    _ws->free(id);
-                    return NEED_TIME;
-                }
-            } catch (const WriteConflictException&) {
-                // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
-                // be freed when we yield.
-                member->makeObjOwnedIfNeeded();
-                _idRetrying = id;
-                *out = WorkingSet::INVALID_ID;
-                return NEED_YIELD;
-            }
-        }
-
-        return returnIfMatches(member, id, out);
+        return fetchMember(id, out);
     } else if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
         // The stage which produces a failure is responsible for allocating a working set member
         // with error details.
@@ -131,7 +114,95 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkBatch(size_t maxBatchSize,
+                                              std::vector<WorkingSetID>* out,
+                                              WorkingSetID* statusOut) {
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+
+    if (isEOF()) {
+        recordWork(PlanStage::IS_EOF);
+        return PlanStage::IS_EOF;
+    }
+
+    if (_idRetrying == WorkingSet::INVALID_ID && _childBatchPos == _childBatch.size()) {
+        _childBatch.clear();
+        _childBatchPos = 0;
+
+        const StageState childStatus = child()->workBatch(maxBatchSize, &_childBatch);
+        if (PlanStage::ADVANCED != childStatus) {
+            if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
+                *statusOut = _childBatch.front();
+            }
+            _childBatch.clear();
+            recordWork(childStatus);
+            return childStatus;
+        }
+    }
+
+    while (out->size() < maxBatchSize &&
+           (_idRetrying != WorkingSet::INVALID_ID || _childBatchPos < _childBatch.size())) {
+        WorkingSetID id;
+        if (_idRetrying != WorkingSet::INVALID_ID) {
+            id = _idRetrying;
+            _idRetrying = WorkingSet::INVALID_ID;
+        } else {
+            id = _childBatch[_childBatchPos++];
+        }
+
+        WorkingSetID resultId = WorkingSet::INVALID_ID;
+        const StageState status = fetchMember(id, &resultId);
+        recordWork(status);
+
+        if (PlanStage::ADVANCED == status) {
+            out->push_back(resultId);
+        } else if (PlanStage::NEED_YIELD == status) {
+            // 'id' is now held in '_idRetrying'; the rest of the batch waits behind it.
+            *statusOut = resultId;
+            return status;
+        }
+    }
+
+    return out->empty() ? PlanStage::NEED_TIME : PlanStage::ADVANCED;
+}
+
+PlanStage::StageState FetchStage::fetchMember(WorkingSetID id, WorkingSetID* out) {
+    WorkingSetMember* member = _ws->get(id);
+
+    // If there's an obj there, there is no fetching to perform.
+    if (member->hasObj()) {
+        ++_specificStats.alreadyHasObj;
+    } else {
+        // We need a valid RecordId to fetch from and this is the only state that has one.
+        verify(WorkingSetMember::RID_AND_IDX == member->getState());
+        verify(member->hasRecordId());
+
+        try {
+            if (!_cursor)
+                _cursor = _collection->getCursor(getOpCtx());
+
+            if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
+                _ws->free(id);
+                return NEED_TIME;
+            }
+        } catch (const WriteConflictException&) {
+            // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
+            // be freed when we yield.
+            member->makeObjOwnedIfNeeded();
+            _idRetrying = id;
+            *out = WorkingSet::INVALID_ID;
+            return NEED_YIELD;
+        }
+    }
+
+    return returnIfMatches(member, id, out);
+}
+
 void FetchStage::doSaveState() {
+    // Members from our child's last batch which we have yet to fetch must survive the yield.
+    for (size_t i = _childBatchPos; i < _childBatch.size(); ++i) {
+        _ws->get(_childBatch[i])->makeObjOwnedIfNeeded();
+    }
+
     if (_cursor)
         _cursor->saveUnpositioned();
 }
@@ -170,7 +241,10 @@ PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
     // predicate.
     ++_specificStats.docsExamined;
 
-    if (Filter::passes(member, _filter)) {
+    if (Filter::passes(member, _filter, _compiledFilter.get())) {
+        if (!_fieldsToReturn.empty()) {
+            projectToFieldsToReturn(member);
+        }
         *out = memberID;
         return PlanStage::ADVANCED;
     } else {
@@ -179,6 +253,32 @@ PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
     }
 }
 
+void FetchStage::setFieldsToReturn(const std::set<std::string>& fieldNames) {
+    _fieldsToReturn.clear();
+    for (auto&& fieldName : fieldNames) {
+        _fieldsToReturn[fieldName] = true;
+    }
+}
+
+void FetchStage::projectToFieldsToReturn(WorkingSetMember* member) {
+    // Only members holding a whole record are trimmed.
+    if (member->getState() != WorkingSetMember::RID_AND_OBJ) {
+        return;
+    }
+
+    BSONObjBuilder bob;
+    size_t fieldsLeft = _fieldsToReturn.size();
+    for (auto&& elem : member->obj.value()) {
+        if (_fieldsToReturn.count(elem.fieldNameStringData())) {
+            bob.append(elem);
+            if (--fieldsLeft == 0) {
+                break;
+            }
+        }
+    }
+    member->obj.setValue(bob.obj());
+}
+
 unique_ptr<PlanStageStats> FetchStage::getStats() {
     _commonStats.isEOF = isEOF();
 
@@ -29,11 +29,16 @@
 #pragma once
 
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -46,6 +51,9 @@ class SeekableRecordCursor;
  * the record at the provided RecordId.  Returns verbatim any data that already has an object.
  *
  * Preconditions: Valid RecordId.
+ *
+ * If given fields to return, the documents which pass the filter are then trimmed down to those
+ * top-level fields, so that nothing above this stage holds on to the rest of the record.
  */
 class FetchStage : public PlanStage {
 public:
@@ -59,6 +67,9 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxBatchSize,
+                           std::vector<WorkingSetID>* out,
+                           WorkingSetID* statusOut) final;
 
     void doSaveState() final;
     void doRestoreState() final;
@@ -69,6 +80,12 @@ public:
         return STAGE_FETCH;
     }
 
+    /**
+     * Makes this stage return only the top-level fields 'fieldNames' of the documents it fetches.
+     * The filter is still applied to the whole documents.
+     */
+    void setFieldsToReturn(const std::set<std::string>& fieldNames);
+
     std::unique_ptr<PlanStageStats> getStats();
 
     const SpecificStats* getSpecificStats() const final;
@@ -76,12 +93,24 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Fetches the document for the member with id 'id' produced by our child, if it does not
+     * already have one, and then applies our filter. If the fetch hits a write conflict, the
+     * member is held in '_idRetrying' and NEED_YIELD is returned.
+     */
+    StageState fetchMember(WorkingSetID id, WorkingSetID* out);
+
     /**
      * If the member (with id memberID) passes our filter, set *out to memberID and return that
      * ADVANCED.  Otherwise, free memberID and return NEED_TIME.
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Replaces the document of 'member' with one holding only the fields in '_fieldsToReturn'.
+     */
+    void projectToFieldsToReturn(WorkingSetMember* member);
+
     // Collection which is used by this stage. Used to resolve record ids retrieved by child
     // stages. The lifetime of the collection must supersede that of the stage.
     const Collection* _collection;
@@ -94,9 +123,20 @@ private:
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // '_filter' compiled for evaluation against whole documents, if possible.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
+    // The top-level fields to keep in the documents we return. Empty to return whole documents.
+    StringMap<bool> _fieldsToReturn;
+
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // Results of our child's last workBatch(). Those at or after '_childBatchPos' have not yet
+    // been fetched and are consumed before asking our child for more.
+    std::vector<WorkingSetID> _childBatch;
+    size_t _childBatchPos = 0;
+
     // Stats
     FetchStats _specificStats;
 };
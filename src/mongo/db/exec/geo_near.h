@@ -58,6 +58,10 @@ struct GeoNearParams {
     const GeoNearExpression* nearQuery;
     bool addPointMeta;
     bool addDistMeta;
+
+    // If positive, how many results the query is expected to consume. Used to size the search
+    // annuli so that a query with a small limit stops after a small scan.
+    long long limitHint = 0;
 };
 
 /**
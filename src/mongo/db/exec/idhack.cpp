@@ -38,6 +38,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/index/btree_access_method.h"
+#include "mongo/db/storage/clustered_id.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -48,6 +49,7 @@ using stdx::make_unique;
 
 // static
 const char* IDHackStage::kStageType = "IDHACK";
+const char* IDHackStage::kClusteredIndexName = "clustered";
 
 IDHackStage::IDHackStage(OperationContext* opCtx,
                          const Collection* collection,
@@ -59,9 +61,7 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
       _workingSet(ws),
       _key(query->getQueryObj()["_id"].wrap()),
       _done(false) {
-    const IndexCatalog* catalog = _collection->getIndexCatalog();
-    _specificStats.indexName = descriptor->indexName();
-    _accessMethod = catalog->getIndex(descriptor);
+    _initAccessMethod(descriptor);
 
     if (NULL != query->getProj()) {
         _addKeyMetadata = query->getProj()->wantIndexKey();
@@ -81,13 +81,31 @@ IDHackStage::IDHackStage(OperationContext* opCtx,
       _key(key),
       _done(false),
       _addKeyMetadata(false) {
-    const IndexCatalog* catalog = _collection->getIndexCatalog();
-    _specificStats.indexName = descriptor->indexName();
-    _accessMethod = catalog->getIndex(descriptor);
+    _initAccessMethod(descriptor);
 }
 
 IDHackStage::~IDHackStage() {}
 
+void IDHackStage::_initAccessMethod(const IndexDescriptor* descriptor) {
+    if (!descriptor) {
+        invariant(_collection->getRecordStore()->isClustered());
+        _specificStats.indexName = kClusteredIndexName;
+        _accessMethod = nullptr;
+        return;
+    }
+    _specificStats.indexName = descriptor->indexName();
+    _accessMethod = _collection->getIndexCatalog()->getIndex(descriptor);
+}
+
+RecordId IDHackStage::_findRecordId() {
+    if (_accessMethod) {
+        return _accessMethod->findSingle(getOpCtx(), _key);
+    }
+    // An _id that cannot be a clustered key cannot be stored in the collection either.
+    auto swRecordId = clustered_id::keyForId(_key.firstElement());
+    return swRecordId.isOK() ? swRecordId.getValue() : RecordId();
+}
+
 bool IDHackStage::isEOF() {
     return _done;
 }
@@ -99,8 +117,8 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
 
     WorkingSetID id = WorkingSet::INVALID_ID;
     try {
-        // Look up the key by going directly to the index.
-        RecordId recordId = _accessMethod->findSingle(getOpCtx(), _key);
+        // Look up the key by going directly to the index, or to the record store if clustered.
+        RecordId recordId = _findRecordId();
 
         // Key not found.
         if (recordId.isNull()) {
@@ -108,7 +126,8 @@ PlanStage::StageState IDHackStage::doWork(WorkingSetID* out) {
             return PlanStage::IS_EOF;
         }
 
-        ++_specificStats.keysExamined;
+        if (_accessMethod)
+            ++_specificStats.keysExamined;
         ++_specificStats.docsExamined;
 
         // Create a new WSM for the result document.
@@ -44,6 +44,9 @@ class RecordCursor;
  * A standalone stage implementing the fast path for key-value retrievals via the _id index. Since
  * the _id index always has the collection default collation, the IDHackStage can only be used when
  * the query's collation is equal to the collection default.
+ *
+ * For a clustered collection, which has no _id index, 'descriptor' is null and the RecordId is
+ * computed directly from the _id value.
  */
 class IDHackStage final : public PlanStage {
 public:
@@ -85,7 +88,18 @@ public:
 
     static const char* kStageType;
 
+    // Reported as the index name in the stats of a lookup on a clustered collection.
+    static const char* kClusteredIndexName;
+
 private:
+    void _initAccessMethod(const IndexDescriptor* descriptor);
+
+    /**
+     * Returns the RecordId of the document whose _id is '_key', or a null RecordId if there is
+     * none. A non-null result may still refer to a missing record on a clustered collection.
+     */
+    RecordId _findRecordId();
+
     /**
      * Marks this stage as done, optionally adds key metadata, and returns PlanStage::ADVANCED.
      *
@@ -101,7 +115,7 @@ private:
     // The WorkingSet we annotate with results.  Not owned by us.
     WorkingSet* _workingSet;
 
-    // Not owned here.
+    // Not owned here. Null when the collection is clustered by _id.
     const IndexAccessMethod* _accessMethod;
 
     // The value to match against the _id field.
@@ -72,6 +72,7 @@ IndexScan::IndexScan(OperationContext* opCtx,
       _shouldDedup(true),
       _forward(params.direction == 1),
       _params(std::move(params)),
+      _pointScan(_forward && _params.bounds.isSinglePoint(_keyPattern)),
       _startKeyInclusive(IndexBounds::isStartIncludedInBound(_params.bounds.boundInclusion)),
       _endKeyInclusive(IndexBounds::isEndIncludedInBound(_params.bounds.boundInclusion)) {
     _specificStats.indexName = _params.name;
@@ -138,6 +139,10 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
                 ++_specificStats.seeks;
                 kv = _indexCursor->seek(_seekPoint);
                 break;
+            case NEED_SKIP:
+                ++_specificStats.seeks;
+                kv = _indexCursor->seekAtOrPast(_startKey, _skipTarget);
+                break;
             case HIT_END:
                 return PlanStage::IS_EOF;
         }
@@ -227,15 +232,40 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
+PlanStage::StageState IndexScan::doWorkBatch(size_t maxBatchSize,
+                                             std::vector<WorkingSetID>* out,
+                                             WorkingSetID* statusOut) {
+    // Each key is still produced by doWork(); only the dispatch through work() is batched.
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    return workBatchLoop(maxBatchSize, out, statusOut, [this](WorkingSetID* id) {
+        const StageState state = IndexScan::doWork(id);
+        recordWork(state);
+        return state;
+    });
+}
+
 bool IndexScan::isEOF() {
     return _commonStats.isEOF;
 }
 
+void IndexScan::skipToRecordId(const RecordId& target) {
+    invariant(_pointScan);
+
+    // Skipping relies on the cursor being bounded by _startKey and _endKey, which are equal for a
+    // point scan, rather than by the bounds checker.
+    if ((_scanState != GETTING_NEXT && _scanState != NEED_SKIP) || _checker) {
+        return;
+    }
+
+    _skipTarget = target;
+    _scanState = NEED_SKIP;
+}
+
 void IndexScan::doSaveState() {
     if (!_indexCursor)
         return;
 
-    if (_scanState == NEED_SEEK) {
+    if (_scanState == NEED_SEEK || _scanState == NEED_SKIP) {
         _indexCursor->saveUnpositioned();
         return;
     }
@@ -117,6 +117,9 @@ public:
         // Retrieving the next key, and applying the filter if necessary.
         GETTING_NEXT,
 
+        // Seeking forward to _skipTarget as requested by skipToRecordId().
+        NEED_SKIP,
+
         // The index scan is finished.
         HIT_END
     };
@@ -127,6 +130,9 @@ public:
               const MatchExpression* filter);
 
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxBatchSize,
+                           std::vector<WorkingSetID>* out,
+                           WorkingSetID* statusOut) final;
     bool isEOF() final;
     void doSaveState() final;
     void doRestoreState() final;
@@ -137,6 +143,21 @@ public:
         return STAGE_IXSCAN;
     }
 
+    /**
+     * Returns true if this is a forward scan over a single point of the index. Such a scan
+     * returns RecordIds in increasing order and supports skipToRecordId().
+     */
+    bool canSkipToRecordId() const {
+        return _pointScan;
+    }
+
+    /**
+     * Makes the next call to work() seek ahead to the first entry whose RecordId is at least
+     * 'target', rather than returning the entries in between one at a time. Has no effect unless
+     * the scan has started and has not yet hit the end. Requires canSkipToRecordId().
+     */
+    void skipToRecordId(const RecordId& target);
+
     std::unique_ptr<PlanStageStats> getStats() final;
 
     const SpecificStats* getSpecificStats() const final;
@@ -172,6 +193,10 @@ private:
     const bool _forward;
     const IndexScanParams _params;
 
+    // Set when the scan is forward and its bounds are a single point.
+    const bool _pointScan;
+    RecordId _skipTarget;
+
     // Stats
     IndexScanStats _specificStats;
 
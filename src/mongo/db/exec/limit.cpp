@@ -51,7 +51,7 @@ LimitStage::LimitStage(OperationContext* opCtx, long long limit, WorkingSet* ws,
 LimitStage::~LimitStage() {}
 
 bool LimitStage::isEOF() {
-    return (0 == _numToReturn) || child()->isEOF();
+    return (0 == _numToReturn) || (child()->isEOF() && !child()->hasPendingBatchState());
 }
 
 PlanStage::StageState LimitStage::doWork(WorkingSetID* out) {
@@ -78,6 +78,35 @@ PlanStage::StageState LimitStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState LimitStage::doWorkBatch(size_t maxBatchSize,
+                                              std::vector<WorkingSetID>* out,
+                                              WorkingSetID* statusOut) {
+    if (0 == _numToReturn) {
+        recordWork(PlanStage::IS_EOF);
+        return PlanStage::IS_EOF;
+    }
+
+    // Never ask our child for more than we are still allowed to return, so that nothing it
+    // produces has to be thrown away.
+    const size_t batchSize = std::min(maxBatchSize, static_cast<size_t>(_numToReturn));
+    StageState status = child()->workBatch(batchSize, out);
+
+    if (PlanStage::ADVANCED == status) {
+        _numToReturn -= out->size();
+        for (size_t i = 0; i < out->size(); ++i) {
+            recordWork(PlanStage::ADVANCED);
+        }
+        return status;
+    }
+
+    if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *statusOut = out->front();
+        out->clear();
+    }
+    recordWork(status);
+    return status;
+}
+
 unique_ptr<PlanStageStats> LimitStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_LIMIT);
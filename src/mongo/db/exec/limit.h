@@ -49,6 +49,9 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxBatchSize,
+                           std::vector<WorkingSetID>* out,
+                           WorkingSetID* statusOut) final;
 
     StageType stageType() const final {
         return STAGE_LIMIT;
@@ -38,14 +38,21 @@
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog_raii.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/plan_evaluation_thread_pool.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/query/stage_builder.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -57,6 +64,20 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+/**
+ * The outcome of the parallel trial period of one candidate plan.
+ */
+struct TrialOutcome {
+    std::unique_ptr<PlanStageStats> stats;
+    size_t numResults = 0;
+    bool failed = false;
+    Status failureStatus = Status::OK();
+};
+
+}  // namespace
+
 // static
 const char* MultiPlanStage::kStageType = "MULTI_PLAN";
 
@@ -205,9 +226,16 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
+    bool workedInParallel = false;
+    const size_t parallelism = internalQueryPlanEvaluationParallelism.load();
+    if (parallelism > 1 && _candidates.size() > 1 && canWorkPlansInParallel()) {
+        workedInParallel = workAllPlansInParallel(
+            numWorks, numResults, std::min(parallelism, _candidates.size()));
+    }
+
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
-    for (size_t ix = 0; ix < numWorks; ++ix) {
+    for (size_t ix = 0; !workedInParallel && ix < numWorks; ++ix) {
         bool moreToDo = workAllPlans(numResults, yieldPolicy);
         if (!moreToDo) {
             break;
@@ -223,7 +251,15 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // After picking best plan, ranking will own plan stats from
     // candidate solutions (winner and losers).
     std::unique_ptr<PlanRankingDecision> ranking(new PlanRankingDecision);
-    _bestPlanIdx = PlanRanker::pickBestPlan(_candidates, ranking.get());
+    if (workedInParallel) {
+        std::vector<std::unique_ptr<PlanStageStats>> statTrees;
+        for (auto&& stats : _trialStats) {
+            statTrees.emplace_back(stats->clone());
+        }
+        _bestPlanIdx = PlanRanker::pickBestPlan(_candidates, std::move(statTrees), ranking.get());
+    } else {
+        _bestPlanIdx = PlanRanker::pickBestPlan(_candidates, ranking.get());
+    }
     verify(_bestPlanIdx >= 0 && _bestPlanIdx < static_cast<int>(_candidates.size()));
 
     // Copy candidate order. We will need this to sort candidate stats for explain
@@ -231,14 +267,18 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     std::vector<size_t> candidateOrder = ranking->candidateOrder;
 
     CandidatePlan& bestCandidate = _candidates[_bestPlanIdx];
-    const auto& alreadyProduced = bestCandidate.results;
     const auto& bestSolution = bestCandidate.solution;
 
+    // After a parallel trial period the winner starts over, but whether it produced results
+    // during the trial still tells us whether it is blocked.
+    const size_t numProducedDuringTrial =
+        workedInParallel ? _trialNumResults[_bestPlanIdx] : bestCandidate.results.size();
+
     LOG(5) << "Winning solution:\n" << redact(bestSolution->toString());
     LOG(2) << "Winning plan: " << Explain::getPlanSummary(bestCandidate.root);
 
     _backupPlanIdx = kNoSuchPlan;
-    if (bestSolution->hasBlockingStage && (0 == alreadyProduced.size())) {
+    if (bestSolution->hasBlockingStage && (0 == numProducedDuringTrial)) {
         LOG(5) << "Winner has blocking stage, looking for backup plan...";
         for (size_t ix = 0; ix < _candidates.size(); ++ix) {
             if (!_candidates[ix].solution->hasBlockingStage) {
@@ -278,7 +318,7 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
                    << Explain::getPlanSummary(_candidates[runnerUpIdx].root);
         }
 
-        if (alreadyProduced.empty()) {
+        if (0 == numProducedDuringTrial) {
             // We're using the "sometimes cache" mode, and the winning plan produced no results
             // during the plan ranking trial period. We will not write a plan cache entry.
             canCache = false;
@@ -400,6 +440,205 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
     return !doneWorking;
 }
 
+bool MultiPlanStage::canWorkPlansInParallel() const {
+    // Each worker takes its own intent lock on the collection, which would conflict with an
+    // exclusive lock held by this operation.
+    if (getOpCtx()->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_X)) {
+        return false;
+    }
+
+    // $where and $expr evaluate against state tied to the operation which created them, which the
+    // workers cannot share.
+    return !QueryPlannerCommon::hasNode(_query->root(), MatchExpression::WHERE) &&
+        !QueryPlannerCommon::hasNode(_query->root(), MatchExpression::EXPRESSION);
+}
+
+bool MultiPlanStage::workAllPlansInParallel(size_t numWorks,
+                                            size_t numResults,
+                                            size_t numWorkers) {
+    std::vector<TrialOutcome> outcomes(_candidates.size());
+    std::vector<Status> workerStatuses(numWorkers, Status::OK());
+    AtomicBool stopWorking(false);
+
+    stdx::mutex mutex;
+    stdx::condition_variable workerDone;
+    size_t numRunning = 0;
+
+    auto runWorker = [&](size_t workerIdx) {
+        workerStatuses[workerIdx] = [&]() -> Status {
+            try {
+                auto opCtxHolder = cc().makeOperationContext();
+                OperationContext* opCtx = opCtxHolder.get();
+
+                // Never wait for the lock: the request could be queued behind a conflicting one
+                // which is itself waiting for the locks held by this operation.
+                AutoGetCollection autoColl(opCtx,
+                                           _collection->ns(),
+                                           MODE_IS,
+                                           AutoGetCollection::kViewsForbidden,
+                                           Date_t::now());
+                Collection* collection = autoColl.getCollection();
+                if (collection != _collection) {
+                    return {ErrorCodes::QueryPlanKilled,
+                            "collection changed during parallel plan evaluation"};
+                }
+
+                // Worker 'w' works candidates w, w + numWorkers, w + 2 * numWorkers, and so on,
+                // round-robin like the serial trial period does.
+                WorkingSet ws;
+                std::vector<size_t> candidateIdxs;
+                std::vector<std::unique_ptr<PlanStage>> roots;
+                for (size_t ix = workerIdx; ix < _candidates.size(); ix += numWorkers) {
+                    PlanStage* root;
+                    if (!StageBuilder::build(
+                            opCtx, collection, *_query, *_candidates[ix].solution, &ws, &root)) {
+                        return {ErrorCodes::InternalError,
+                                str::stream() << "unable to build candidate plan " << ix
+                                              << " for parallel evaluation"};
+                    }
+                    candidateIdxs.push_back(ix);
+                    roots.emplace_back(root);
+                }
+
+                std::vector<bool> done(roots.size(), false);
+                size_t numDone = 0;
+                for (size_t round = 0; round < numWorks && numDone < roots.size(); ++round) {
+                    for (size_t i = 0; i < roots.size(); ++i) {
+                        if (stopWorking.load()) {
+                            break;
+                        }
+                        if (done[i]) {
+                            continue;
+                        }
+
+                        TrialOutcome& outcome = outcomes[candidateIdxs[i]];
+                        WorkingSetID id = WorkingSet::INVALID_ID;
+                        PlanStage::StageState state = roots[i]->work(&id);
+
+                        if (PlanStage::ADVANCED == state) {
+                            // Only the number of results matters to the ranking.
+                            ws.free(id);
+                            if (++outcome.numResults >= numResults) {
+                                stopWorking.store(true);
+                            }
+                        } else if (PlanStage::IS_EOF == state) {
+                            stopWorking.store(true);
+                        } else if (PlanStage::NEED_YIELD == state) {
+                            // Workers cannot yield, so the trial of this candidate ends here.
+                            done[i] = true;
+                            ++numDone;
+                        } else if (PlanStage::NEED_TIME != state) {
+                            outcome.failed = true;
+                            if (PlanStage::FAILURE == state && WorkingSet::INVALID_ID != id) {
+                                outcome.failureStatus =
+                                    WorkingSetCommon::getMemberStatus(*ws.get(id));
+                            }
+                            done[i] = true;
+                            ++numDone;
+                        }
+                    }
+
+                    if (stopWorking.load()) {
+                        break;
+                    }
+                }
+
+                for (size_t i = 0; i < roots.size(); ++i) {
+                    outcomes[candidateIdxs[i]].stats = roots[i]->getStats();
+                }
+                return Status::OK();
+            } catch (const DBException& ex) {
+                return ex.toStatus();
+            }
+        }();
+
+        // A worker which could not run leaves the other candidates without a fair comparison.
+        if (!workerStatuses[workerIdx].isOK()) {
+            stopWorking.store(true);
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (--numRunning == 0) {
+            workerDone.notify_all();
+        }
+    };
+
+    auto& pool = PlanEvaluationThreadPool::get(getOpCtx()->getServiceContext());
+    Status scheduleStatus = Status::OK();
+    for (size_t workerIdx = 0; workerIdx < numWorkers; ++workerIdx) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ++numRunning;
+        }
+        scheduleStatus = pool.schedule([&runWorker, workerIdx] { runWorker(workerIdx); });
+        if (!scheduleStatus.isOK()) {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            --numRunning;
+            stopWorking.store(true);
+            break;
+        }
+    }
+
+    // Wait for the workers to finish, stopping them early if this operation is interrupted.
+    Status interruptStatus = Status::OK();
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        while (numRunning > 0) {
+            workerDone.wait_for(lk, Milliseconds(10).toSystemDuration());
+            if (interruptStatus.isOK()) {
+                interruptStatus = getOpCtx()->checkForInterruptNoAssert();
+                if (!interruptStatus.isOK()) {
+                    stopWorking.store(true);
+                }
+            }
+        }
+    }
+
+    if (!interruptStatus.isOK()) {
+        _failure = true;
+        _statusMemberId =
+            WorkingSetCommon::allocateStatusMember(_candidates[0].ws, interruptStatus);
+        return true;
+    }
+
+    if (!scheduleStatus.isOK()) {
+        LOG(1) << "Unable to evaluate plans in parallel, falling back to serial evaluation: "
+               << redact(scheduleStatus);
+        return false;
+    }
+    for (auto&& status : workerStatuses) {
+        if (!status.isOK()) {
+            LOG(1) << "Unable to evaluate plans in parallel, falling back to serial evaluation: "
+                   << redact(status);
+            return false;
+        }
+    }
+
+    Status lastFailure = Status::OK();
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        TrialOutcome& outcome = outcomes[ix];
+        if (outcome.failed) {
+            _candidates[ix].failed = true;
+            ++_failureCount;
+            if (!outcome.failureStatus.isOK()) {
+                lastFailure = outcome.failureStatus;
+            }
+        }
+        _trialStats.push_back(std::move(outcome.stats));
+        _trialNumResults.push_back(outcome.numResults);
+    }
+
+    if (_failureCount == _candidates.size()) {
+        _failure = true;
+        if (lastFailure.isOK()) {
+            lastFailure = {ErrorCodes::InternalError, "all candidate plans failed"};
+        }
+        _statusMemberId = WorkingSetCommon::allocateStatusMember(_candidates[0].ws, lastFailure);
+    }
+
+    return true;
+}
+
 bool MultiPlanStage::hasBackupPlan() const {
     return kNoSuchPlan != _backupPlanIdx;
 }
@@ -419,6 +658,14 @@ QuerySolution* MultiPlanStage::bestSolution() {
     return _candidates[_bestPlanIdx].solution.get();
 }
 
+unique_ptr<PlanStageStats> MultiPlanStage::getCandidateTrialStats(size_t candidateIdx) {
+    invariant(candidateIdx < _candidates.size());
+    if (!_trialStats.empty()) {
+        return unique_ptr<PlanStageStats>(_trialStats[candidateIdx]->clone());
+    }
+    return _candidates[candidateIdx].root->getStats();
+}
+
 unique_ptr<PlanStageStats> MultiPlanStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_MULTI_PLAN);
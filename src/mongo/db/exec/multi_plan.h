@@ -145,6 +145,13 @@ public:
      */
     bool hasBackupPlan() const;
 
+    /**
+     * Returns the stats gathered for candidate 'candidateIdx' during the trial period. When the
+     * trial period ran in parallel these are the stats of the copy of the plan that was worked by
+     * the trial, otherwise they are the current stats of the candidate's PlanStage tree.
+     */
+    std::unique_ptr<PlanStageStats> getCandidateTrialStats(size_t candidateIdx);
+
     //
     // Used by explain.
     //
@@ -166,6 +173,24 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Runs the trial period of the candidates concurrently on up to 'numWorkers' threads. Each
+     * worker plans its candidates anew from their QuerySolutions under its own OperationContext,
+     * and works them until any candidate hits EOF or returns 'numResults' results, or has been
+     * worked 'numWorks' times. The candidates' own PlanStage trees are left untouched, so the
+     * winner runs from the start once chosen.
+     *
+     * Fills out '_trialStats' and '_trialNumResults', or sets '_failure' if all candidates failed
+     * or the query was interrupted. Returns false if the trial could not run in parallel, in
+     * which case nothing has been modified and the caller should work the plans serially.
+     */
+    bool workAllPlansInParallel(size_t numWorks, size_t numResults, size_t numWorkers);
+
+    /**
+     * Returns true if this query may have its trial period run by workAllPlansInParallel().
+     */
+    bool canWorkPlansInParallel() const;
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -220,6 +245,11 @@ private:
     // returned by ::work()
     WorkingSetID _statusMemberId;
 
+    // Stats of each candidate at the end of a parallel trial period, and the number of results it
+    // produced. Both are empty unless the trial period ran in parallel.
+    std::vector<std::unique_ptr<PlanStageStats>> _trialStats;
+    std::vector<size_t> _trialNumResults;
+
     // Stats
     MultiPlanStats _specificStats;
 };
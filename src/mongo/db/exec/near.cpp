@@ -30,6 +30,8 @@
 
 #include "mongo/db/exec/near.h"
 
+#include <cmath>
+
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/stdx/memory.h"
@@ -41,6 +43,23 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// How many results each search annulus is sized to hold once the query's limit, if any, is used
+// up. Larger annuli amortize the cost of building the covering and the index scan, but every
+// result in an annulus is buffered before the first of them can be returned.
+const double kTargetResultsPerInterval = 400;
+
+// Lower bound on that target when sizing for a small limit, so that a sparse estimate doesn't
+// lead to many tiny annuli.
+const double kMinTargetResultsPerInterval = 16;
+
+// The most the width may grow or shrink from one annulus to the next, since the density seen in
+// a single annulus is a noisy estimate.
+const double kMaxWidthChangeFactor = 4;
+
+}  // namespace
+
 NearStage::NearStage(OperationContext* opCtx,
                      const char* typeName,
                      StageType type,
@@ -273,12 +292,43 @@ PlanStage::StageState NearStage::advanceNext(WorkingSetID* toReturn) {
         _seenDocuments.erase(member->recordId);
     }
 
-    // This value is used by nextInterval() to determine the size of the next interval.
     ++_nextIntervalStats->numResultsReturned;
+    ++_numResultsReturned;
 
     return PlanStage::ADVANCED;
 }
 
+double NearStage::nextAnnulusWidth(double lastWidth) const {
+    invariant(!_specificStats.intervalStats.empty());
+    const IntervalStats& last = _specificStats.intervalStats.back();
+
+    double target = kTargetResultsPerInterval;
+    const long long remaining = _limitHint - _numResultsReturned;
+    if (_limitHint > 0 && remaining > 0) {
+        target = std::max(std::min(target, static_cast<double>(remaining)),
+                          kMinTargetResultsPerInterval);
+    }
+
+    // Nothing was found, so there is no density to go by. Widen as fast as allowed.
+    if (last.numResultsBuffered == 0) {
+        return lastWidth * kMaxWidthChangeFactor;
+    }
+
+    // Results per unit of area in the last annulus. The factor of pi cancels out below.
+    const double inner = std::max(last.minDistanceAllowed, 0.0);
+    const double outer = last.maxDistanceAllowed;
+    const double lastArea = outer * outer - inner * inner;
+    if (lastArea <= 0) {
+        return lastWidth;
+    }
+    const double density = last.numResultsBuffered / lastArea;
+
+    // Solve for the outer radius of an annulus starting at 'outer' that holds 'target' results.
+    const double width = std::sqrt(outer * outer + target / density) - outer;
+    return std::min(std::max(width, lastWidth / kMaxWidthChangeFactor),
+                    lastWidth * kMaxWidthChangeFactor);
+}
+
 bool NearStage::isEOF() {
     return SearchState_Finished == _searchState;
 }
@@ -144,9 +144,21 @@ protected:
                                   Collection* collection,
                                   WorkingSetID* out) = 0;
 
+    /**
+     * Returns the width for the next search annulus, given that the last one was 'lastWidth'
+     * wide. The width is chosen so that, at the density of results found in the last annulus,
+     * the next one holds about as many results as the query still needs. Must only be called
+     * once an interval has been searched.
+     */
+    double nextAnnulusWidth(double lastWidth) const;
+
     // Filled in by subclasses.
     NearStats _specificStats;
 
+    // If positive, the number of results the query is expected to consume, as given by its
+    // limit. Only used to size the search annuli; results past it are still returned.
+    long long _limitHint = 0;
+
 private:
     //
     // Generic methods for progressive search functionality
@@ -182,6 +194,9 @@ private:
     struct SearchResult;
     std::priority_queue<SearchResult> _resultBuffer;
 
+    // Total number of results returned to the parent stage.
+    long long _numResultsReturned = 0;
+
     // Stats
     const StageType _stageType;
 
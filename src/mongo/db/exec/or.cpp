@@ -75,16 +75,13 @@ PlanStage::StageState OrStage::doWork(WorkingSetID* out) {
         if (_dedup && member->hasRecordId()) {
             ++_specificStats.dupsTested;
 
-            // ...and we've seen the RecordId before
-            if (_seen.end() != _seen.find(member->recordId)) {
-                // ...drop it.
+            // ...and we've seen the RecordId before, drop it. Otherwise, note that we've seen it.
+            if (!_seen.insert(member->recordId)) {
                 ++_specificStats.dupsDropped;
                 _ws->free(id);
                 return PlanStage::NEED_TIME;
-            } else {
-                // Otherwise, note that we've seen it.
-                _seen.insert(member->recordId);
             }
+            _specificStats.dedupMemUsage = _seen.memUsageBytes();
         }
 
         if (Filter::passes(member, _filter)) {
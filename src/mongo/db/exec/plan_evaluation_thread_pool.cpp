@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/plan_evaluation_thread_pool.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(internalQueryPlanEvaluationMaxThreads, int, 64)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryPlanEvaluationMaxThreads must be at least 1");
+        }
+        return Status::OK();
+    });
+
+const auto getPlanEvaluationThreadPool =
+    ServiceContext::declareDecoration<PlanEvaluationThreadPool>();
+
+}  // namespace
+
+PlanEvaluationThreadPool::~PlanEvaluationThreadPool() {
+    shutdown();
+}
+
+PlanEvaluationThreadPool& PlanEvaluationThreadPool::get(ServiceContext* serviceContext) {
+    return getPlanEvaluationThreadPool(serviceContext);
+}
+
+Status PlanEvaluationThreadPool::schedule(ThreadPool::Task task) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_inShutdown) {
+        return {ErrorCodes::ShutdownInProgress, "plan evaluation thread pool is shut down"};
+    }
+
+    if (!_pool) {
+        ThreadPool::Options options;
+        options.poolName = "PlanEvaluation";
+        options.minThreads = 0;
+        options.maxThreads = internalQueryPlanEvaluationMaxThreads;
+
+        // Ensure all threads have a client
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+
+        _pool = stdx::make_unique<ThreadPool>(options);
+        _pool->startup();
+    }
+    return _pool->schedule(std::move(task));
+}
+
+void PlanEvaluationThreadPool::shutdown() {
+    std::unique_ptr<ThreadPool> pool;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inShutdown = true;
+        pool = std::move(_pool);
+    }
+
+    // The queries waiting on the tasks still scheduled are only released once they have run.
+    if (pool) {
+        pool->shutdown();
+        pool->join();
+    }
+}
+
+}  // namespace mongo
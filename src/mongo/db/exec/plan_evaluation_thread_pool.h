@@ -0,0 +1,77 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * The pool of threads which MultiPlanStage shares between all queries on a ServiceContext to work
+ * the candidate plans of a query in parallel during its trial period. The pool starts no threads
+ * until the first trial period is scheduled on it, and runs at most
+ * 'internalQueryPlanEvaluationMaxThreads' threads at once.
+ */
+class PlanEvaluationThreadPool {
+    MONGO_DISALLOW_COPYING(PlanEvaluationThreadPool);
+
+public:
+    PlanEvaluationThreadPool() = default;
+    ~PlanEvaluationThreadPool();
+
+    static PlanEvaluationThreadPool& get(ServiceContext* serviceContext);
+
+    /**
+     * Schedules 'task' to run on the pool. Returns ShutdownInProgress once shutdown() has been
+     * called, in which case 'task' is never run.
+     */
+    Status schedule(ThreadPool::Task task);
+
+    /**
+     * Stops accepting tasks, and waits for the tasks already scheduled to finish.
+     */
+    void shutdown();
+
+private:
+    stdx::mutex _mutex;
+    bool _inShutdown = false;
+
+    // Created by the first call to schedule().
+    std::unique_ptr<ThreadPool> _pool;
+};
+
+}  // namespace mongo
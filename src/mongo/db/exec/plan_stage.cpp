@@ -40,6 +40,15 @@ namespace mongo {
 
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
+    if (_pendingBatchState) {
+        // A previous workBatch() ended early; report the state that ended it first.
+        const StageState pending = *_pendingBatchState;
+        _pendingBatchState = boost::none;
+        *out = _pendingBatchStatusId;
+        _pendingBatchStatusId = WorkingSet::INVALID_ID;
+        return pending;
+    }
+
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
     ++_commonStats.works;
 
@@ -56,6 +65,47 @@ PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     return workResult;
 }
 
+PlanStage::StageState PlanStage::workBatch(size_t maxBatchSize, std::vector<WorkingSetID>* out) {
+    invariant(_opCtx);
+    invariant(maxBatchSize > 0);
+    invariant(out->empty());
+
+    if (_pendingBatchState) {
+        const StageState pending = *_pendingBatchState;
+        _pendingBatchState = boost::none;
+        if (WorkingSet::INVALID_ID != _pendingBatchStatusId) {
+            out->push_back(_pendingBatchStatusId);
+            _pendingBatchStatusId = WorkingSet::INVALID_ID;
+        }
+        return pending;
+    }
+
+    WorkingSetID statusId = WorkingSet::INVALID_ID;
+    StageState batchResult = doWorkBatch(maxBatchSize, out, &statusId);
+
+    if (!out->empty()) {
+        if (StageState::ADVANCED != batchResult && StageState::NEED_TIME != batchResult) {
+            _pendingBatchState = batchResult;
+            _pendingBatchStatusId = statusId;
+        }
+        return StageState::ADVANCED;
+    }
+
+    invariant(StageState::ADVANCED != batchResult);
+    if (StageState::DEAD == batchResult || StageState::FAILURE == batchResult) {
+        invariant(WorkingSet::INVALID_ID != statusId);
+        out->push_back(statusId);
+    }
+    return batchResult;
+}
+
+PlanStage::StageState PlanStage::doWorkBatch(size_t maxBatchSize,
+                                             std::vector<WorkingSetID>* out,
+                                             WorkingSetID* statusOut) {
+    return workBatchLoop(
+        maxBatchSize, out, statusOut, [this](WorkingSetID* id) { return work(id); });
+}
+
 void PlanStage::saveState() {
     ++_commonStats.yields;
     for (auto&& child : _children) {
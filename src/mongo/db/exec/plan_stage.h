@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <memory>
 #include <vector>
 
@@ -187,6 +188,35 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Batched variant of work(). Asks the stage to perform up to 'maxBatchSize' units of work and
+     * to return every result produced along the way, in order, in 'out'. 'out' must be empty on
+     * entry.
+     *
+     * Returns ADVANCED if 'out' holds at least one result. Otherwise returns the state that ended
+     * the batch, with the same meaning as for work(): NEED_TIME if the work budget ran out
+     * without producing results, or IS_EOF, NEED_YIELD, DEAD or FAILURE. For DEAD and FAILURE,
+     * 'out' holds exactly one WorkingSetID referring to the status member describing the error.
+     *
+     * If the batch is cut short by anything other than NEED_TIME after some results were
+     * produced, the results are returned as ADVANCED and the terminating state is reported by the
+     * next call to workBatch().
+     *
+     * Stages which do not provide a native implementation fall back to calling work() in a loop,
+     * so work() and workBatch() may be freely interleaved on the same tree.
+     */
+    StageState workBatch(size_t maxBatchSize, std::vector<WorkingSetID>* out);
+
+    /**
+     * Returns true if a workBatch() was cut short by a state other than IS_EOF, such as a
+     * FAILURE, which the next call to work() or workBatch() has yet to report. isEOF() may
+     * already return true in that case, so callers deciding whether a stage is done must check
+     * this as well.
+     */
+    bool hasPendingBatchState() const {
+        return _pendingBatchState && StageState::IS_EOF != *_pendingBatchState;
+    }
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -331,6 +361,56 @@ protected:
      */
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxBatchSize' units of work, appending each result to 'out'. Returns
+     * ADVANCED if the batch filled up, NEED_TIME if the work budget ran out, or the state which
+     * ended the batch early. If that state is DEAD or FAILURE, '*statusOut' must be set to the
+     * status member as work() would set its out parameter.
+     *
+     * Stages which override this must keep their common stats up to date, typically with
+     * recordWork(). The default implementation calls work() once per unit.
+     */
+    virtual StageState doWorkBatch(size_t maxBatchSize,
+                                   std::vector<WorkingSetID>* out,
+                                   WorkingSetID* statusOut);
+
+    /**
+     * Drives 'workOne', a callable with the signature of doWork(), for up to 'maxBatchSize' units
+     * of work following the contract of doWorkBatch(). Leaf stages use this to call their own
+     * doWork() directly, without the per-result virtual dispatch and timer of work().
+     */
+    template <typename WorkOneFn>
+    StageState workBatchLoop(size_t maxBatchSize,
+                             std::vector<WorkingSetID>* out,
+                             WorkingSetID* statusOut,
+                             WorkOneFn&& workOne) {
+        for (size_t works = 0; works < maxBatchSize; ++works) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            const StageState state = workOne(&id);
+            if (ADVANCED == state) {
+                out->push_back(id);
+            } else if (NEED_TIME != state) {
+                *statusOut = id;
+                return state;
+            }
+        }
+        return out->empty() ? NEED_TIME : ADVANCED;
+    }
+
+    /**
+     * Accounts for one unit of work performed outside of work(), as work() itself would.
+     */
+    void recordWork(StageState state) {
+        ++_commonStats.works;
+        if (ADVANCED == state) {
+            ++_commonStats.advanced;
+        } else if (NEED_TIME == state) {
+            ++_commonStats.needTime;
+        } else if (NEED_YIELD == state) {
+            ++_commonStats.needYield;
+        }
+    }
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -376,6 +456,11 @@ protected:
 
 private:
     OperationContext* _opCtx;
+
+    // When a batch ends early in a state other than NEED_TIME after producing results, that
+    // state (and its status member, if any) is held here and reported by the next workBatch().
+    boost::optional<StageState> _pendingBatchState;
+    WorkingSetID _pendingBatchStatusId = WorkingSet::INVALID_ID;
 };
 
 }  // namespace mongo
@@ -0,0 +1,340 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/projection.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+
+#ifdef MONGO_PLAN_STAGE_BM_HAVE_MALLOC_HOOK
+#include <gperftools/malloc_hook.h>
+#endif
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("plan_stage_bm.coll");
+constexpr int kNumDocuments = 10 * 1000;
+
+/**
+ * Returns a document with 'numFields' top level fields besides _id, 'a', which is indexed and
+ * unique, 'b', which takes 100 distinct values, and a small nested document.
+ */
+BSONObj makeDocument(int i, int numFields) {
+    BSONObjBuilder builder;
+    builder.append("_id", i);
+    builder.append("a", (i * 7919) % kNumDocuments);
+    builder.append("b", i % 100);
+    for (int j = 0; j < numFields; ++j) {
+        const std::string fieldName = "f" + std::to_string(j);
+        if (j % 2) {
+            builder.append(fieldName, "value" + std::to_string(i + j));
+        } else {
+            builder.append(fieldName, i + j);
+        }
+    }
+    builder.append("nested", BSON("x" << i << "y" << BSON("z" << "text" << "w" << i % 7)));
+    return builder.obj();
+}
+
+/**
+ * Starts a standalone storage layer on the default test engine with a single collection of
+ * kNumDocuments documents of the requested shape, indexed on 'a' in addition to _id.
+ */
+class PlanStageBenchmarkFixture final : public ServiceContextMongoDTest {
+public:
+    explicit PlanStageBenchmarkFixture(int numFields) {
+        auto service = getServiceContext();
+        auto replCoord =
+            stdx::make_unique<repl::ReplicationCoordinatorMock>(service, repl::ReplSettings());
+        replCoord->alwaysAllowWrites(true);
+        repl::ReplicationCoordinator::set(service, std::move(replCoord));
+
+        _opCtx = makeOperationContext();
+        {
+            AutoGetOrCreateDb autoDb(_opCtx.get(), kNss.db(), MODE_X);
+            WriteUnitOfWork wuow(_opCtx.get());
+            Collection* coll = autoDb.getDb()->createCollection(_opCtx.get(), kNss.ns());
+            invariant(coll);
+            auto spec = BSON("v" << 2 << "key" << BSON("a" << 1) << "name"
+                                 << "a_1"
+                                 << "ns"
+                                 << kNss.ns());
+            uassertStatusOK(
+                coll->getIndexCatalog()->createIndexOnEmptyCollection(_opCtx.get(), spec));
+
+            for (int i = 0; i < kNumDocuments; ++i) {
+                uassertStatusOK(coll->insertDocument(
+                    _opCtx.get(), InsertStatement(makeDocument(i, numFields)), nullptr, false));
+            }
+            wuow.commit();
+        }
+
+        _autoColl.emplace(_opCtx.get(), kNss, MODE_IS);
+        _expCtx = new ExpressionContext(_opCtx.get(), nullptr);
+    }
+
+    OperationContext* getOperationContext() {
+        return _opCtx.get();
+    }
+
+    Collection* getCollection() {
+        return _autoColl->getCollection();
+    }
+
+    IndexScanParams makeIndexScanParams(int lowKey, int highKey) {
+        auto descriptor =
+            getCollection()->getIndexCatalog()->findIndexByName(_opCtx.get(), "a_1");
+        invariant(descriptor);
+
+        IndexScanParams params(_opCtx.get(), *descriptor);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << lowKey);
+        params.bounds.endKey = BSON("" << highKey);
+        params.bounds.boundInclusion = BoundInclusion::kIncludeStartKeyOnly;
+        return params;
+    }
+
+    std::unique_ptr<MatchExpression> parseFilter(const char* json) {
+        _filterObjs.push_back(fromjson(json));
+        return uassertStatusOK(MatchExpressionParser::parse(_filterObjs.back(), _expCtx));
+    }
+
+private:
+    void _doTest() override {}
+
+    ServiceContext::UniqueOperationContext _opCtx;
+    boost::optional<AutoGetCollection> _autoColl;
+    boost::intrusive_ptr<ExpressionContext> _expCtx;
+
+    // The parsed filters point into these.
+    std::vector<BSONObj> _filterObjs;
+};
+
+#ifdef MONGO_PLAN_STAGE_BM_HAVE_MALLOC_HOOK
+AtomicUInt64 allocations;
+
+void countAllocation(const void* ptr, size_t size) {
+    allocations.fetchAndAdd(1);
+}
+
+/**
+ * Counts the allocations made by every thread while in scope.
+ */
+class AllocationCounter {
+public:
+    AllocationCounter() : _start(allocations.load()) {
+        invariant(MallocHook::AddNewHook(&countAllocation));
+    }
+
+    ~AllocationCounter() {
+        invariant(MallocHook::RemoveNewHook(&countAllocation));
+    }
+
+    void report(benchmark::State& state, long long numDocuments) {
+        if (numDocuments > 0) {
+            state.counters["allocsPerDoc"] =
+                static_cast<double>(allocations.load() - _start) / numDocuments;
+        }
+    }
+
+private:
+    const unsigned long long _start;
+};
+#else
+/**
+ * Allocations are only counted in tcmalloc builds, which provide the hooks to count them with.
+ */
+class AllocationCounter {
+public:
+    void report(benchmark::State& state, long long numDocuments) {}
+};
+#endif
+
+/**
+ * Works 'root' until EOF and returns the number of results.
+ */
+long long runToEOF(PlanStage* root, WorkingSet* ws) {
+    long long numResults = 0;
+    while (true) {
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        const auto state = root->work(&id);
+        if (state == PlanStage::ADVANCED) {
+            ws->free(id);
+            ++numResults;
+        } else if (state == PlanStage::IS_EOF) {
+            return numResults;
+        } else {
+            invariant(state == PlanStage::NEED_TIME);
+        }
+    }
+}
+
+/**
+ * Runs the plan made by 'makePlan' to EOF on every iteration, and reports the number of documents
+ * examined per second, and the number of allocations per document where they are counted.
+ */
+template <typename MakePlan>
+void runPlan(benchmark::State& state, long long docsExaminedPerRun, MakePlan makePlan) {
+    long long numRuns = 0;
+    AllocationCounter allocationCounter;
+    for (auto _ : state) {
+        WorkingSet ws;
+        auto root = makePlan(&ws);
+        benchmark::DoNotOptimize(runToEOF(root.get(), &ws));
+        ++numRuns;
+    }
+    state.SetItemsProcessed(numRuns * docsExaminedPerRun);
+    allocationCounter.report(state, numRuns * docsExaminedPerRun);
+}
+
+std::unique_ptr<PlanStage> makeCollectionScan(PlanStageBenchmarkFixture& fixture,
+                                              WorkingSet* ws,
+                                              const MatchExpression* filter) {
+    CollectionScanParams params;
+    params.collection = fixture.getCollection();
+    return stdx::make_unique<CollectionScan>(fixture.getOperationContext(), params, ws, filter);
+}
+
+const char* const kFilters[] = {
+    // A selective equality.
+    "{b: 5}",
+    // A conjunction on top level and nested fields which half of the documents pass.
+    "{b: {$lt: 50}, 'nested.y.w': {$gte: 0}, f0: {$exists: true}}",
+};
+
+// Arguments are the number of extra fields in the documents, and for filters and projections the
+// index of the one to use.
+void BM_CollectionScan(benchmark::State& state) {
+    PlanStageBenchmarkFixture fixture(state.range(0));
+    runPlan(state, kNumDocuments, [&](WorkingSet* ws) {
+        return makeCollectionScan(fixture, ws, nullptr);
+    });
+}
+
+void BM_CollectionScanWithFilter(benchmark::State& state) {
+    PlanStageBenchmarkFixture fixture(state.range(0));
+    const auto filter = fixture.parseFilter(kFilters[state.range(1)]);
+    runPlan(state, kNumDocuments, [&](WorkingSet* ws) {
+        return makeCollectionScan(fixture, ws, filter.get());
+    });
+}
+
+void BM_IndexScan(benchmark::State& state) {
+    PlanStageBenchmarkFixture fixture(4);
+    const int numKeys = state.range(0);
+    runPlan(state, numKeys, [&](WorkingSet* ws) {
+        return stdx::make_unique<IndexScan>(fixture.getOperationContext(),
+                                            fixture.makeIndexScanParams(0, numKeys),
+                                            ws,
+                                            nullptr);
+    });
+}
+
+void BM_IndexScanFetch(benchmark::State& state) {
+    PlanStageBenchmarkFixture fixture(state.range(0));
+    const auto filter = fixture.parseFilter(kFilters[state.range(1)]);
+    runPlan(state, kNumDocuments, [&](WorkingSet* ws) {
+        auto ixscan = stdx::make_unique<IndexScan>(fixture.getOperationContext(),
+                                                   fixture.makeIndexScanParams(0, kNumDocuments),
+                                                   ws,
+                                                   nullptr);
+        return stdx::make_unique<FetchStage>(fixture.getOperationContext(),
+                                             ws,
+                                             ixscan.release(),
+                                             filter.get(),
+                                             fixture.getCollection());
+    });
+}
+
+const struct {
+    const char* projection;
+    ProjectionStageParams::ProjectionImplementation projImpl;
+} kProjections[] = {
+    {"{a: 1, b: 1}", ProjectionStageParams::SIMPLE_DOC},
+    {"{f0: 0, nested: 0}", ProjectionStageParams::NO_FAST_PATH},
+    {"{a: 1, 'nested.y.z': 1}", ProjectionStageParams::NO_FAST_PATH},
+};
+
+void BM_Projection(benchmark::State& state) {
+    PlanStageBenchmarkFixture fixture(state.range(0));
+    const auto& projection = kProjections[state.range(1)];
+
+    ProjectionStageParams params;
+    params.projObj = fromjson(projection.projection);
+    params.projImpl = projection.projImpl;
+    runPlan(state, kNumDocuments, [&](WorkingSet* ws) {
+        auto collScan = makeCollectionScan(fixture, ws, nullptr);
+        return stdx::make_unique<ProjectionStage>(
+            fixture.getOperationContext(), params, ws, collScan.release());
+    });
+}
+
+void BM_CoveredProjection(benchmark::State& state) {
+    PlanStageBenchmarkFixture fixture(4);
+
+    ProjectionStageParams params;
+    params.projObj = BSON("_id" << 0 << "a" << 1);
+    params.projImpl = ProjectionStageParams::COVERED_ONE_INDEX;
+    params.coveredKeyObj = BSON("a" << 1);
+    runPlan(state, kNumDocuments, [&](WorkingSet* ws) {
+        auto ixscan = stdx::make_unique<IndexScan>(fixture.getOperationContext(),
+                                                   fixture.makeIndexScanParams(0, kNumDocuments),
+                                                   ws,
+                                                   nullptr);
+        return stdx::make_unique<ProjectionStage>(
+            fixture.getOperationContext(), params, ws, ixscan.release());
+    });
+}
+
+BENCHMARK(BM_CollectionScan)->Arg(4)->Arg(64);
+BENCHMARK(BM_CollectionScanWithFilter)->Args({4, 0})->Args({4, 1})->Args({64, 0})->Args({64, 1});
+BENCHMARK(BM_IndexScan)->Arg(100)->Arg(kNumDocuments);
+BENCHMARK(BM_IndexScanFetch)->Args({4, 0})->Args({64, 1});
+BENCHMARK(BM_Projection)->Args({4, 0})->Args({4, 1})->Args({4, 2})->Args({64, 0})->Args({64, 1});
+BENCHMARK(BM_CoveredProjection);
+
+}  // namespace
+}  // namespace mongo
@@ -156,6 +156,9 @@ struct AndHashStats : public SpecificStats {
 
     // What's our memory limit?
     size_t memLimit = 0u;
+
+    // Largest number of bytes used to track which buffered RecordIds a child has produced.
+    size_t seenMemUsage = 0u;
 };
 
 struct AndSortedStats : public SpecificStats {
@@ -168,6 +171,9 @@ struct AndSortedStats : public SpecificStats {
 
     // How many results from each child did not pass the AND?
     std::vector<size_t> failedAnd;
+
+    // How many times a child index scan was told to seek ahead to the target RecordId.
+    size_t skips = 0u;
 };
 
 struct CachedPlanStats : public SpecificStats {
@@ -199,6 +205,13 @@ struct CollectionScanStats : public SpecificStats {
     // sees a document that does not pass the filter and has a "ts" Timestamp field greater than
     // 'maxTs'.
     boost::optional<Timestamp> maxTs;
+
+    // Whether the storage engine is reading ahead of this scan. If so, 'readAheadHits' counts the
+    // records that had already been read ahead when the scan reached them and 'readAheadStalls'
+    // the records it reached first.
+    bool readAhead = false;
+    long long readAheadHits = 0;
+    long long readAheadStalls = 0;
 };
 
 struct CountStats : public SpecificStats {
@@ -291,6 +304,10 @@ struct DistinctScanStats : public SpecificStats {
     // How many keys did we look at while distinct-ing?
     size_t keysExamined = 0;
 
+    // How many times did we seek the index cursor? Keys for the next distinct value which were
+    // reached by advancing the cursor instead of seeking it are not counted.
+    size_t seeks = 0;
+
     BSONObj keyPattern;
 
     BSONObj collation;
@@ -472,6 +489,9 @@ struct OrStats : public SpecificStats {
 
     size_t dupsTested = 0u;
     size_t dupsDropped = 0u;
+
+    // Bytes used to remember the RecordIds already returned.
+    size_t dedupMemUsage = 0u;
 };
 
 struct ProjectionStats : public SpecificStats {
@@ -644,6 +664,12 @@ struct TextOrStats : public SpecificStats {
     }
 
     size_t fetches;
+
+    // The number of best-scoring documents requested in top-k mode, or zero.
+    size_t limit = 0;
+
+    // True if top-k mode stopped reading postings before the index scans were exhausted.
+    bool earlyTermination = false;
 };
 
 }  // namespace mongo
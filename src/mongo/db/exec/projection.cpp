@@ -59,6 +59,7 @@ ProjectionStage::ProjectionStage(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx), _ws(ws), _projImpl(params.projImpl) {
     _children.emplace_back(child);
     _projObj = params.projObj;
+    _compiled = CompiledProjection::compile(_projObj);
 
     if (ProjectionStageParams::NO_FAST_PATH == _projImpl) {
         _exec.reset(
@@ -143,15 +144,16 @@ void ProjectionStage::transformSimpleInclusion(const BSONObj& in,
 }
 
 Status ProjectionStage::transform(WorkingSetMember* member) {
-    // The default no-fast-path case.
-    if (ProjectionStageParams::NO_FAST_PATH == _projImpl) {
-        return _exec->transform(member);
-    }
-
     BSONObjBuilder bob;
 
-    // SIMPLE_DOC implies that we expect an object so it's kind of redundant.
-    if ((ProjectionStageParams::SIMPLE_DOC == _projImpl) || member->hasObj()) {
+    if (_compiled && member->hasObj()) {
+        // Plain inclusions and exclusions of a document, whichever path the planner chose.
+        _compiled->transform(member->obj.value(), &bob);
+    } else if (ProjectionStageParams::NO_FAST_PATH == _projImpl) {
+        // The default no-fast-path case.
+        return _exec->transform(member);
+    } else if ((ProjectionStageParams::SIMPLE_DOC == _projImpl) || member->hasObj()) {
+        // SIMPLE_DOC implies that we expect an object so it's kind of redundant.
         // If we got here because of SIMPLE_DOC the planner shouldn't have messed up.
         invariant(member->hasObj());
 
@@ -184,7 +186,7 @@ Status ProjectionStage::transform(WorkingSetMember* member) {
 }
 
 bool ProjectionStage::isEOF() {
-    return child()->isEOF();
+    return child()->isEOF() && !child()->hasPendingBatchState();
 }
 
 PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
@@ -216,6 +218,39 @@ PlanStage::StageState ProjectionStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState ProjectionStage::doWorkBatch(size_t maxBatchSize,
+                                                   std::vector<WorkingSetID>* out,
+                                                   WorkingSetID* statusOut) {
+    StageState status = child()->workBatch(maxBatchSize, out);
+
+    if (PlanStage::ADVANCED == status) {
+        for (size_t i = 0; i < out->size(); ++i) {
+            Status projStatus = transform(_ws->get((*out)[i]));
+            if (!projStatus.isOK()) {
+                warning() << "Couldn't execute projection, status = " << redact(projStatus);
+
+                // Results ahead of the failing one are still returned; the rest are dropped.
+                for (size_t j = i; j < out->size(); ++j) {
+                    _ws->free((*out)[j]);
+                }
+                out->resize(i);
+                *statusOut = WorkingSetCommon::allocateStatusMember(_ws, projStatus);
+                recordWork(PlanStage::FAILURE);
+                return PlanStage::FAILURE;
+            }
+            recordWork(PlanStage::ADVANCED);
+        }
+        return status;
+    }
+
+    if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *statusOut = out->front();
+        out->clear();
+    }
+    recordWork(status);
+    return status;
+}
+
 unique_ptr<PlanStageStats> ProjectionStage::getStats() {
     _commonStats.isEOF = isEOF();
     unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_PROJECTION);
@@ -29,6 +29,7 @@
 #pragma once
 
 
+#include "mongo/db/exec/compiled_projection.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/projection_exec.h"
 #include "mongo/db/jsobj.h"
@@ -82,6 +83,9 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxBatchSize,
+                           std::vector<WorkingSetID>* out,
+                           WorkingSetID* statusOut) final;
 
     StageType stageType() const final {
         return STAGE_PROJECTION;
@@ -117,6 +121,10 @@ private:
 
     std::unique_ptr<ProjectionExec> _exec;
 
+    // Set when the projection only includes or excludes fields. Used in place of _exec and the
+    // SIMPLE_DOC path whenever the member has a document.
+    std::unique_ptr<CompiledProjection> _compiled;
+
     // _ws is not owned by us.
     WorkingSet* _ws;
 
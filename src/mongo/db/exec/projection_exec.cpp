@@ -421,18 +421,15 @@ Status ProjectionExec::transform(const BSONObj& in,
             BSONArrayBuilder arrBuilder;
             BSONObjBuilder subBob;
 
-            if (in.getField(elt.fieldName()).eoo()) {
-                return Status(ErrorCodes::InternalError,
-                              "$elemMatch called on document element with eoo");
-            }
-
-            if (in.getField(elt.fieldName()).Obj().getField(arrayDetails.elemMatchKey()).eoo()) {
+            // 'elt' is the field being projected, so there is no need to look it up in 'in'
+            // again. Doing so would rescan the document once per $elemMatch field.
+            BSONElement matchedElt = elt.Obj().getField(arrayDetails.elemMatchKey());
+            if (matchedElt.eoo()) {
                 return Status(ErrorCodes::InternalError,
                               "$elemMatch called on array element with eoo");
             }
 
-            arrBuilder.append(
-                in.getField(elt.fieldName()).Obj().getField(arrayDetails.elemMatchKey()));
+            arrBuilder.append(matchedElt);
             subBob.appendArray(matcher->first, arrBuilder.arr());
             Status status = append(bob, subBob.done().firstElement(), details, arrayOpType);
             if (!status.isOK()) {
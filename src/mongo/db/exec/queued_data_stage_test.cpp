@@ -123,4 +123,72 @@ TEST_F(QueuedDataStageTest, validateStats) {
     unique_ptr<PlanStageStats> allStats(mock->getStats());
     ASSERT_TRUE(stats->isEOF);
 }
+
+//
+// Test that workBatch() falls back to work() and gathers results across NEED_TIME.
+//
+TEST_F(QueuedDataStageTest, workBatchCollectsResultsAcrossNeedTime) {
+    WorkingSet ws;
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+
+    WorkingSetID first = ws.allocate();
+    WorkingSetID second = ws.allocate();
+    mock->pushBack(first);
+    mock->pushBack(PlanStage::NEED_TIME);
+    mock->pushBack(second);
+
+    std::vector<WorkingSetID> batch;
+    ASSERT_EQUALS(PlanStage::ADVANCED, mock->workBatch(10, &batch));
+    ASSERT_EQUALS(2U, batch.size());
+    ASSERT_EQUALS(first, batch[0]);
+    ASSERT_EQUALS(second, batch[1]);
+
+    const CommonStats* stats = mock->getCommonStats();
+    ASSERT_EQUALS(stats->works, 4U);
+    ASSERT_EQUALS(stats->advanced, 2U);
+    ASSERT_EQUALS(stats->needTime, 1U);
+
+    batch.clear();
+    ASSERT_EQUALS(PlanStage::IS_EOF, mock->workBatch(10, &batch));
+    ASSERT_TRUE(batch.empty());
+}
+
+//
+// Test that workBatch() does no more than 'maxBatchSize' units of work.
+//
+TEST_F(QueuedDataStageTest, workBatchRespectsMaxBatchSize) {
+    WorkingSet ws;
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    mock->pushBack(PlanStage::NEED_TIME);
+    mock->pushBack(PlanStage::NEED_TIME);
+    mock->pushBack(ws.allocate());
+
+    std::vector<WorkingSetID> batch;
+    ASSERT_EQUALS(PlanStage::NEED_TIME, mock->workBatch(2, &batch));
+    ASSERT_TRUE(batch.empty());
+
+    ASSERT_EQUALS(PlanStage::ADVANCED, mock->workBatch(2, &batch));
+    ASSERT_EQUALS(1U, batch.size());
+}
+
+//
+// Test that a failure after some results is reported on the call after those results.
+//
+TEST_F(QueuedDataStageTest, workBatchDefersFailureUntilNextCall) {
+    WorkingSet ws;
+    auto mock = make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    WorkingSetID id = ws.allocate();
+    mock->pushBack(id);
+    mock->pushBack(PlanStage::FAILURE);
+
+    std::vector<WorkingSetID> batch;
+    ASSERT_EQUALS(PlanStage::ADVANCED, mock->workBatch(10, &batch));
+    ASSERT_EQUALS(1U, batch.size());
+    ASSERT_EQUALS(id, batch[0]);
+
+    batch.clear();
+    ASSERT_EQUALS(PlanStage::FAILURE, mock->workBatch(10, &batch));
+    ASSERT_EQUALS(1U, batch.size());
+    ASSERT_EQUALS(WorkingSetMember::OWNED_OBJ, ws.get(batch[0])->getState());
+}
 }
@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_set.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+namespace {
+
+// Approximate cost of a chunk's node in the hash table.
+const size_t kChunkOverhead = 64;
+
+}  // namespace
+
+constexpr int RecordIdSet::kChunkBits;
+constexpr size_t RecordIdSet::kChunkSize;
+constexpr size_t RecordIdSet::kBitmapWords;
+constexpr size_t RecordIdSet::kMaxArraySize;
+
+bool RecordIdSet::insert(RecordId id) {
+    const int64_t high = id.repr() >> kChunkBits;
+    const uint16_t low = static_cast<uint16_t>(id.repr() & (kChunkSize - 1));
+    Chunk* chunk = _findChunk(high, true);
+
+    if (chunk->isBitmap()) {
+        uint64_t& word = chunk->bitmap[low / 64];
+        const uint64_t bit = uint64_t(1) << (low % 64);
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+        ++_size;
+        return true;
+    }
+
+    auto& array = chunk->array;
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) {
+        return false;
+    }
+
+    if (array.size() == kMaxArraySize) {
+        _convertToBitmap(chunk);
+        chunk->bitmap[low / 64] |= uint64_t(1) << (low % 64);
+    } else {
+        const size_t capacityBefore = array.capacity();
+        array.insert(it, low);
+        _memUsage += (array.capacity() - capacityBefore) * sizeof(uint16_t);
+    }
+    ++_size;
+    return true;
+}
+
+bool RecordIdSet::contains(RecordId id) const {
+    const int64_t high = id.repr() >> kChunkBits;
+    const uint16_t low = static_cast<uint16_t>(id.repr() & (kChunkSize - 1));
+    const Chunk* chunk = _findChunk(high);
+    if (!chunk) {
+        return false;
+    }
+
+    if (chunk->isBitmap()) {
+        return chunk->bitmap[low / 64] & (uint64_t(1) << (low % 64));
+    }
+    return std::binary_search(chunk->array.begin(), chunk->array.end(), low);
+}
+
+void RecordIdSet::clear() {
+    _chunks.clear();
+    _lastChunk = nullptr;
+    _size = 0;
+    _memUsage = 0;
+}
+
+RecordIdSet::Chunk* RecordIdSet::_findChunk(int64_t high, bool create) {
+    if (_lastChunk && _lastHigh == high) {
+        return _lastChunk;
+    }
+
+    auto it = _chunks.find(high);
+    if (it == _chunks.end()) {
+        if (!create) {
+            return nullptr;
+        }
+        it = _chunks.emplace(high, Chunk()).first;
+        _memUsage += kChunkOverhead;
+    }
+
+    // Pointers to elements of an unordered_map stay valid when it rehashes.
+    _lastHigh = high;
+    _lastChunk = &it->second;
+    return _lastChunk;
+}
+
+const RecordIdSet::Chunk* RecordIdSet::_findChunk(int64_t high) const {
+    if (_lastChunk && _lastHigh == high) {
+        return _lastChunk;
+    }
+
+    auto it = _chunks.find(high);
+    if (it == _chunks.end()) {
+        return nullptr;
+    }
+
+    _lastHigh = high;
+    _lastChunk = const_cast<Chunk*>(&it->second);
+    return _lastChunk;
+}
+
+void RecordIdSet::_convertToBitmap(Chunk* chunk) {
+    chunk->bitmap.assign(kBitmapWords, 0);
+    for (uint16_t low : chunk->array) {
+        chunk->bitmap[low / 64] |= uint64_t(1) << (low % 64);
+    }
+
+    _memUsage -= chunk->array.capacity() * sizeof(uint16_t);
+    _memUsage += kBitmapWords * sizeof(uint64_t);
+    std::vector<uint16_t>().swap(chunk->array);
+}
+
+}  // namespace mongo
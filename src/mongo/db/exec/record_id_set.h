@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/unordered_map.h"
+
+namespace mongo {
+
+/**
+ * A compact set of RecordIds, used by query stages that deduplicate or intersect large streams of
+ * RecordIds.
+ *
+ * The 64-bit RecordId space is split into chunks of 2^16 consecutive ids keyed by the high 48
+ * bits. A chunk holds a sorted array of the low 16 bits of its members while it is sparse and
+ * switches to a 2^16-bit bitmap once that becomes smaller, as in a roaring bitmap. Ids produced by
+ * an index scan over a collection are usually dense within a few chunks, so this takes a small
+ * fraction of the memory of a hash set and avoids a node allocation per member.
+ */
+class RecordIdSet {
+public:
+    /**
+     * Adds 'id' to the set. Returns true if it was not already a member.
+     */
+    bool insert(RecordId id);
+
+    bool contains(RecordId id) const;
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    void clear();
+
+    /**
+     * Approximate number of bytes of memory held by the set.
+     */
+    size_t memUsageBytes() const {
+        return _memUsage;
+    }
+
+private:
+    // Number of ids covered by a chunk.
+    static constexpr int kChunkBits = 16;
+    static constexpr size_t kChunkSize = size_t(1) << kChunkBits;
+
+    // A chunk switches from an array to a bitmap once its array would be larger than the bitmap.
+    static constexpr size_t kBitmapWords = kChunkSize / 64;
+    static constexpr size_t kMaxArraySize = kBitmapWords * sizeof(uint64_t) / sizeof(uint16_t);
+
+    struct Chunk {
+        // Sorted low bits of the members, used while the chunk has at most kMaxArraySize members.
+        std::vector<uint16_t> array;
+
+        // One bit per id in the chunk, used once the chunk has outgrown 'array'.
+        std::vector<uint64_t> bitmap;
+
+        bool isBitmap() const {
+            return !bitmap.empty();
+        }
+    };
+
+    /**
+     * Returns the chunk for 'high', creating it if 'create' is true, or nullptr.
+     */
+    Chunk* _findChunk(int64_t high, bool create);
+    const Chunk* _findChunk(int64_t high) const;
+
+    /**
+     * Converts 'chunk' from the array to the bitmap representation.
+     */
+    void _convertToBitmap(Chunk* chunk);
+
+    stdx::unordered_map<int64_t, Chunk> _chunks;
+
+    // Consecutive ids usually fall in the same chunk, so remember the last one used.
+    mutable int64_t _lastHigh = 0;
+    mutable Chunk* _lastChunk = nullptr;
+
+    size_t _size = 0;
+    size_t _memUsage = 0;
+};
+
+}  // namespace mongo
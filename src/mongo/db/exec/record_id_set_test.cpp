@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_set.h"
+
+#include <limits>
+
+#include "mongo/stdx/unordered_set.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordIdSetTest, InsertAndContains) {
+    RecordIdSet set;
+    ASSERT_TRUE(set.empty());
+    ASSERT_FALSE(set.contains(RecordId(1)));
+
+    ASSERT_TRUE(set.insert(RecordId(1)));
+    ASSERT_TRUE(set.insert(RecordId(100)));
+    ASSERT_TRUE(set.insert(RecordId(3)));
+    ASSERT_EQ(3U, set.size());
+
+    ASSERT_TRUE(set.contains(RecordId(1)));
+    ASSERT_TRUE(set.contains(RecordId(3)));
+    ASSERT_TRUE(set.contains(RecordId(100)));
+    ASSERT_FALSE(set.contains(RecordId(2)));
+    ASSERT_FALSE(set.contains(RecordId(101)));
+}
+
+TEST(RecordIdSetTest, DuplicateInsertIsRejected) {
+    RecordIdSet set;
+    ASSERT_TRUE(set.insert(RecordId(42)));
+    ASSERT_FALSE(set.insert(RecordId(42)));
+    ASSERT_EQ(1U, set.size());
+}
+
+TEST(RecordIdSetTest, IdsInDifferentChunks) {
+    RecordIdSet set;
+    const int64_t ids[] = {1,
+                           65535,
+                           65536,
+                           -1,
+                           -65537,
+                           std::numeric_limits<int64_t>::max(),
+                           std::numeric_limits<int64_t>::min()};
+    for (auto id : ids) {
+        ASSERT_TRUE(set.insert(RecordId(id)));
+    }
+    for (auto id : ids) {
+        ASSERT_TRUE(set.contains(RecordId(id)));
+        ASSERT_FALSE(set.insert(RecordId(id)));
+    }
+    ASSERT_EQ(sizeof(ids) / sizeof(ids[0]), set.size());
+    ASSERT_FALSE(set.contains(RecordId(65537)));
+    ASSERT_FALSE(set.contains(RecordId(-2)));
+}
+
+TEST(RecordIdSetTest, DenseChunkSwitchesToBitmap) {
+    RecordIdSet set;
+    // Insert every other id of a chunk in descending order so that the array form is exercised
+    // with out-of-order inserts before the chunk becomes a bitmap.
+    for (int64_t id = 2 * 20000; id > 0; id -= 2) {
+        ASSERT_TRUE(set.insert(RecordId(id)));
+    }
+    ASSERT_EQ(20000U, set.size());
+    for (int64_t id = 1; id <= 2 * 20000; ++id) {
+        ASSERT_EQ(id % 2 == 0, set.contains(RecordId(id)));
+    }
+    ASSERT_FALSE(set.insert(RecordId(2)));
+    ASSERT_TRUE(set.insert(RecordId(3)));
+    ASSERT_EQ(20001U, set.size());
+
+    // A full chunk is a single 8KB bitmap.
+    ASSERT_LT(set.memUsageBytes(), 9 * 1024U);
+}
+
+TEST(RecordIdSetTest, SmallerThanHashSet) {
+    RecordIdSet set;
+    const size_t n = 100000;
+    for (size_t i = 0; i < n; ++i) {
+        set.insert(RecordId(static_cast<int64_t>(i * 3)));
+    }
+    ASSERT_EQ(n, set.size());
+    // A node-based hash set needs at least a pointer, a hash and the RecordId for each member.
+    ASSERT_LT(set.memUsageBytes(), n * (sizeof(RecordId) + 2 * sizeof(void*)));
+}
+
+TEST(RecordIdSetTest, Clear) {
+    RecordIdSet set;
+    for (int64_t id = 0; id < 10000; ++id) {
+        set.insert(RecordId(id));
+    }
+    set.clear();
+    ASSERT_TRUE(set.empty());
+    ASSERT_EQ(0U, set.memUsageBytes());
+    ASSERT_FALSE(set.contains(RecordId(5)));
+    ASSERT_TRUE(set.insert(RecordId(5)));
+    ASSERT_EQ(1U, set.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -28,8 +28,11 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/s/scoped_collection_metadata.h"
+#include "mongo/s/shard_key_pattern.h"
 
 namespace mongo {
 
@@ -65,6 +68,10 @@ namespace mongo {
  *
  * END NOTE FROM GREG
  *
+ * If the planner has established that every document the child can produce falls within chunks
+ * owned by this shard, 'allResultsOwned' may be set, in which case results pass through without
+ * their shard key being extracted.
+ *
  * Preconditions: Child must be fetched.  TODO: when covering analysis is in just build doc
  * and check that against shard key.  See SERVER-5022.
  */
@@ -73,7 +80,8 @@ public:
     ShardFilterStage(OperationContext* opCtx,
                      ScopedCollectionMetadata metadata,
                      WorkingSet* ws,
-                     PlanStage* child);
+                     PlanStage* child,
+                     bool allResultsOwned = false);
     ~ShardFilterStage();
 
     bool isEOF() final;
@@ -98,6 +106,10 @@ private:
     // Note: it is important that this is the metadata from the time this stage is constructed.
     // See class comment for details.
     ScopedCollectionMetadata _metadata;
+
+    // Parsed once from '_metadata' rather than for every document. Unset if the collection is not
+    // sharded or if no result needs to be checked.
+    boost::optional<ShardKeyPattern> _shardKeyPattern;
 };
 
 }  // namespace mongo
@@ -49,7 +49,7 @@ SkipStage::SkipStage(OperationContext* opCtx, long long toSkip, WorkingSet* ws,
 SkipStage::~SkipStage() {}
 
 bool SkipStage::isEOF() {
-    return child()->isEOF();
+    return child()->isEOF() && !child()->hasPendingBatchState();
 }
 
 PlanStage::StageState SkipStage::doWork(WorkingSetID* out) {
@@ -81,6 +81,36 @@ PlanStage::StageState SkipStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState SkipStage::doWorkBatch(size_t maxBatchSize,
+                                             std::vector<WorkingSetID>* out,
+                                             WorkingSetID* statusOut) {
+    StageState status = child()->workBatch(maxBatchSize, out);
+
+    if (PlanStage::ADVANCED == status) {
+        // Drop results from the front of the batch while we're still skipping.
+        size_t numSkipped = 0;
+        while (_toSkip > 0 && numSkipped < out->size()) {
+            _ws->free((*out)[numSkipped]);
+            --_toSkip;
+            ++numSkipped;
+            recordWork(PlanStage::NEED_TIME);
+        }
+        out->erase(out->begin(), out->begin() + numSkipped);
+
+        for (size_t i = 0; i < out->size(); ++i) {
+            recordWork(PlanStage::ADVANCED);
+        }
+        return out->empty() ? PlanStage::NEED_TIME : PlanStage::ADVANCED;
+    }
+
+    if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *statusOut = out->front();
+        out->clear();
+    }
+    recordWork(status);
+    return status;
+}
+
 unique_ptr<PlanStageStats> SkipStage::getStats() {
     _commonStats.isEOF = isEOF();
     _specificStats.skip = _toSkip;
@@ -41,6 +41,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -51,15 +52,34 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// An Ordering can describe the direction of at most this many sort key fields.
+const int kMaxEncodedSortKeyFields = 32;
+
+/**
+ * Returns the KeyString encoding of 'sortKey'. Comparing the encodings of two sort keys with
+ * memcmp orders them the same way as BSONObj::woCompare() does with the sort pattern that
+ * 'ordering' was made from.
+ */
+std::string encodeSortKey(const BSONObj& sortKey, Ordering ordering) {
+    KeyString ks(KeyString::Version::V1, sortKey, ordering);
+    return {ks.getBuffer(), ks.getSize()};
+}
+
+}  // namespace
+
 // static
 const char* SortStage::kStageType = "SORT";
 
-SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
+SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p, bool useEncodedSortKeys)
+    : pattern(p), useEncodedSortKeys(useEncodedSortKeys) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
                                                  const SortableDataItem& rhs) const {
     // False means ignore field names.
-    int result = lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
+    int result = useEncodedSortKeys ? lhs.encodedSortKey.compare(rhs.encodedSortKey)
+                                    : lhs.sortKey.woCompare(rhs.sortKey, pattern, false);
     if (0 != result) {
         return result < 0;
     }
@@ -75,14 +95,22 @@ SortStage::SortStage(OperationContext* opCtx,
       _collection(params.collection),
       _ws(ws),
       _pattern(params.pattern),
+      _encodeSortKeys(_pattern.nFields() <= kMaxEncodedSortKeyFields),
+      _sortKeyOrdering(Ordering::make(BSONObj())),
       _limit(params.limit),
       _sorted(false),
       _resultIterator(_data.end()),
-      _memUsage(0) {
+      _memUsage(0),
+      _memoryTracker(opCtx) {
     _children.emplace_back(child);
 
     BSONObj sortComparator = FindCommon::transformSortSpec(_pattern);
-    _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator);
+    if (_encodeSortKeys) {
+        // The directions must come from the transformed pattern, in which a text score sorts
+        // descending, rather than from the raw one, in which its {$meta: ...} reads as ascending.
+        _sortKeyOrdering = Ordering::make(sortComparator);
+    }
+    _sortKeyComparator = stdx::make_unique<WorkingSetComparator>(sortComparator, _encodeSortKeys);
 
     // If limit > 1, we need to initialize _dataSet here to maintain ordered set of data items while
     // fetching from the child stage.
@@ -111,6 +139,16 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
         return PlanStage::FAILURE;
     }
 
+    // A blocking sort cannot spill, so if the server is over its query memory budget, fail rather
+    // than keep buffering.
+    if (!_sorted && OperationMemoryUsage::shouldReleaseMemory(_memUsage)) {
+        Status status(ErrorCodes::ExceededMemoryLimit,
+                      "Sort operation aborted because the server exceeded its query memory "
+                      "budget. Add an index, or specify a smaller limit.");
+        *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        return PlanStage::FAILURE;
+    }
+
     if (isEOF()) {
         return PlanStage::IS_EOF;
     }
@@ -134,6 +172,9 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
             auto sortKeyComputedData =
                 static_cast<const SortKeyComputedData*>(member->getComputed(WSM_SORT_KEY));
             item.sortKey = sortKeyComputedData->getSortKey();
+            if (_encodeSortKeys) {
+                item.encodedSortKey = encodeSortKey(item.sortKey, _sortKeyOrdering);
+            }
 
             if (member->hasRecordId()) {
                 // The RecordId breaks ties when sorting two WSMs with the same sort key.
@@ -141,6 +182,7 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
             }
 
             addToBuffer(item);
+            _memoryTracker.set(_memUsage);
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
@@ -172,6 +214,14 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
+void SortStage::doDetachFromOperationContext() {
+    _memoryTracker.detachFromOperationContext();
+}
+
+void SortStage::doReattachToOperationContext() {
+    _memoryTracker.reattachToOperationContext(getOpCtx());
+}
+
 unique_ptr<PlanStageStats> SortStage::getStats() {
     _commonStats.isEOF = isEOF();
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes.load());
@@ -190,6 +240,10 @@ const SpecificStats* SortStage::getSpecificStats() const {
     return &_specificStats;
 }
 
+size_t SortStage::getMemUsage(const SortableDataItem& item) const {
+    return _ws->get(item.wsid)->getMemUsage() + item.encodedSortKey.size();
+}
+
 /**
  * addToBuffer() and sortBuffer() work differently based on the
  * configured limit. addToBuffer() is also responsible for
@@ -219,12 +273,12 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
         member->makeObjOwnedIfNeeded();
         _data.push_back(item);
-        _memUsage += member->getMemUsage();
+        _memUsage += getMemUsage(item);
     } else if (_limit == 1) {
         if (_data.empty()) {
             member->makeObjOwnedIfNeeded();
             _data.push_back(item);
-            _memUsage = member->getMemUsage();
+            _memUsage = getMemUsage(item);
             return;
         }
         wsidToFree = item.wsid;
@@ -234,7 +288,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             wsidToFree = _data[0].wsid;
             member->makeObjOwnedIfNeeded();
             _data[0] = item;
-            _memUsage = member->getMemUsage();
+            _memUsage = getMemUsage(item);
         }
     } else {
         // Update data item set instead of vector
@@ -243,7 +297,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         if (_dataSet->size() < limit) {
             member->makeObjOwnedIfNeeded();
             _dataSet->insert(item);
-            _memUsage += member->getMemUsage();
+            _memUsage += getMemUsage(item);
             return;
         }
         // Limit will be exceeded - compare with item with lowest key
@@ -254,8 +308,8 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
         const SortableDataItem& lastItem = *lastItemIt;
         const WorkingSetComparator& cmp = *_sortKeyComparator;
         if (cmp(item, lastItem)) {
-            _memUsage -= _ws->get(lastItem.wsid)->getMemUsage();
-            _memUsage += member->getMemUsage();
+            _memUsage -= getMemUsage(lastItem);
+            _memUsage += getMemUsage(item);
             wsidToFree = lastItem.wsid;
             // According to std::set iterator validity rules,
             // it does not matter which of erase()/insert() happens first.
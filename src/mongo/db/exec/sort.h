@@ -31,10 +31,12 @@
 #include <set>
 #include <vector>
 
+#include "mongo/bson/ordering.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_memory_usage.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
 #include "mongo/stdx/unordered_map.h"
@@ -77,6 +79,9 @@ public:
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
 
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+
     StageType stageType() const final {
         return STAGE_SORT;
     }
@@ -101,6 +106,15 @@ private:
     // The raw sort _pattern as expressed by the user
     BSONObj _pattern;
 
+    // Whether each buffered sort key is encoded once as a KeyString, so that comparisons are a
+    // memcmp rather than a BSONObj::woCompare(). Patterns with more fields than an Ordering can
+    // describe keep the BSON comparison.
+    bool _encodeSortKeys;
+
+    // The directions of the fields in '_pattern', with a text score sorting descending. Only
+    // meaningful when '_encodeSortKeys' is set.
+    Ordering _sortKeyOrdering;
+
     // Equal to 0 for no limit.
     size_t _limit;
 
@@ -116,6 +130,9 @@ private:
     struct SortableDataItem {
         WorkingSetID wsid;
         BSONObj sortKey;
+        // The KeyString encoding of 'sortKey'. Only populated when the stage compares encoded
+        // sort keys.
+        std::string encodedSortKey;
         // Since we must replicate the behavior of a covered sort as much as possible we use the
         // RecordId to break sortKey ties.
         // See sorta.js.
@@ -123,19 +140,27 @@ private:
     };
 
     // Comparison object for data buffers (vector and set). Items are compared on (sortKey, loc).
-    // This is also how the items are ordered in the indices. Keys are compared using
-    // BSONObj::woCompare() with RecordId as a tie-breaker.
+    // This is also how the items are ordered in the indices. Keys are compared by their KeyString
+    // encodings with memcmp when 'useEncodedSortKeys' is set, and using BSONObj::woCompare()
+    // otherwise, with RecordId as a tie-breaker.
     //
     // We are comparing keys generated by the SortKeyGenerator, which are already ordered with
     // respect the collation. Therefore, we explicitly avoid comparing using a collator here.
     struct WorkingSetComparator {
-        explicit WorkingSetComparator(BSONObj p);
+        WorkingSetComparator(BSONObj p, bool useEncodedSortKeys);
 
         bool operator()(const SortableDataItem& lhs, const SortableDataItem& rhs) const;
 
         BSONObj pattern;
+        bool useEncodedSortKeys;
     };
 
+    /**
+     * Returns the memory accounted to 'item' while it is buffered: the size of its working set
+     * member plus the size of its encoded sort key.
+     */
+    size_t getMemUsage(const SortableDataItem& item) const;
+
     /**
      * Inserts one item into data buffer (vector or set).
      * If limit is exceeded, remove item with lowest key.
@@ -172,6 +197,9 @@ private:
 
     // The usage in bytes of all buffered data that we're sorting.
     size_t _memUsage;
+
+    // Reports '_memUsage' to the operation's and the server's memory accounting.
+    OperationMemoryUsage::Tracker _memoryTracker;
 };
 
 }  // namespace mongo
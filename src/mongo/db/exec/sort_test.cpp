@@ -35,6 +35,7 @@
 #include <boost/optional.hpp>
 
 #include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_factory_mock.h"
@@ -289,4 +290,44 @@ TEST_F(SortStageTest, SortDescendingWithCollation) {
              "{input: [{a: 'ba'}, {a: 'aa'}, {a: 'ab'}]}",
              "{output: [{a: 'ab'}, {a: 'ba'}, {a: 'aa'}]}");
 }
+
+TEST_F(SortStageTest, SortCompoundMixedDirectionsAcrossTypes) {
+    testWork("{a: 1, b: -1}",
+             nullptr,
+             0,
+             "{input: [{a: 'x', b: 1}, {a: 2, b: 1}, {a: 2.0, b: 3}, {a: null, b: 'z'}, "
+             "{a: 1, b: 1}]}",
+             "{output: [{a: null, b: 'z'}, {a: 1, b: 1}, {a: 2.0, b: 3}, {a: 2, b: 1}, "
+             "{a: 'x', b: 1}]}");
+}
+TEST_F(SortStageTest, SortByTextScoreIsDescending) {
+    WorkingSet ws;
+
+    // QueuedDataStage will be owned by SortStage.
+    auto queuedDataStage = stdx::make_unique<QueuedDataStage>(getOpCtx(), &ws);
+    for (double score : {1.5, 3.0, 0.5, 2.0}) {
+        WorkingSetID id = ws.allocate();
+        WorkingSetMember* wsm = ws.get(id);
+        wsm->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("score" << score));
+        wsm->transitionToOwnedObj();
+        wsm->addComputed(new TextScoreComputedData(score));
+        queuedDataStage->pushBack(id);
+    }
+
+    SortStageParams params;
+    params.pattern = fromjson("{score: {$meta: 'textScore'}}");
+    auto sortKeyGen = stdx::make_unique<SortKeyGeneratorStage>(
+        getOpCtx(), queuedDataStage.release(), &ws, params.pattern, nullptr);
+    SortStage sort(getOpCtx(), params, &ws, sortKeyGen.release());
+
+    std::vector<double> scores;
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    PlanStage::StageState state;
+    while ((state = sort.work(&id)) != PlanStage::IS_EOF) {
+        if (state == PlanStage::ADVANCED) {
+            scores.push_back(ws.get(id)->obj.value()["score"].numberDouble());
+        }
+    }
+    ASSERT(scores == std::vector<double>({3.0, 2.0, 1.5, 0.5}));
+}
 }  // namespace
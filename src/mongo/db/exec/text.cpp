@@ -123,6 +123,17 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* opCtx,
 
         textScorer->addChildren(std::move(indexScanList));
 
+        // The TEXT_MATCH stage must pass every document when the TEXT_OR stage only returns the
+        // best-scoring ones. That holds when there are no negations or phrases to check and the
+        // index scans alone establish that a positive term is present, which is the case unless
+        // the query is case or diacritic sensitive.
+        const auto& query = _params.query;
+        if (_params.limit && query.getNegatedTerms().empty() && query.getPositivePhr().empty() &&
+            query.getNegatedPhr().empty() && !query.getCaseSensitive() &&
+            !query.getDiacriticSensitive()) {
+            textScorer->setTopK(_params.limit, query.getTermsForBounds());
+        }
+
         textMatchStage = make_unique<TextMatchStage>(
             opCtx, std::move(textScorer), _params.query, _params.spec, ws);
     } else {
@@ -29,6 +29,7 @@
 #include "mongo/db/exec/text_or.h"
 
 #include <map>
+#include <numeric>
 #include <vector>
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -50,6 +51,8 @@ using std::string;
 using stdx::make_unique;
 
 using fts::FTSSpec;
+using fts::MAX_WEIGHT;
+using fts::TermFrequencyMap;
 
 const char* TextOrStage::kStageType = "TEXT_OR";
 
@@ -78,6 +81,14 @@ void TextOrStage::addChildren(Children childrenToAdd) {
                      std::make_move_iterator(childrenToAdd.end()));
 }
 
+void TextOrStage::setTopK(size_t limit, const std::set<std::string>& terms) {
+    invariant(_internalState == State::kInit);
+    invariant(limit > 0);
+    _limit = limit;
+    _terms.assign(terms.begin(), terms.end());
+    _specificStats.limit = limit;
+}
+
 bool TextOrStage::isEOF() {
     return _internalState == State::kDone;
 }
@@ -139,7 +150,7 @@ PlanStage::StageState TextOrStage::doWork(WorkingSetID* out) {
             stageState = initStage(out);
             break;
         case State::kReadingTerms:
-            stageState = readFromChildren(out);
+            stageState = _limit ? readFromChildrenTopK(out) : readFromChildren(out);
             break;
         case State::kReturningResults:
             stageState = returnResults(out);
@@ -221,6 +232,75 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 }
 
+PlanStage::StageState TextOrStage::readFromChildrenTopK(WorkingSetID* out) {
+    if (_maxRemainingScores.empty()) {
+        _maxRemainingScores.assign(_children.size(), MAX_WEIGHT);
+    }
+
+    // No document we have yet to see can score higher than the sum of what the children may still
+    // return. Once the best '_limit' scores reach that bound the rest of the postings don't matter.
+    const double threshold =
+        std::accumulate(_maxRemainingScores.begin(), _maxRemainingScores.end(), 0.0);
+    if (_numExhaustedChildren == _children.size() ||
+        (_topScores.size() >= _limit && _topScores.top().first >= threshold)) {
+        if (_numExhaustedChildren < _children.size()) {
+            _specificStats.earlyTermination = true;
+        }
+        _scoreIterator = _scores.begin();
+        _internalState = State::kReturningResults;
+        return PlanStage::NEED_TIME;
+    }
+
+    // Skip past the children that have run out of postings.
+    while (_maxRemainingScores[_currentChild] == 0) {
+        _currentChild = (_currentChild + 1) % _children.size();
+    }
+
+    WorkingSetID id;
+    StageState childState;
+    if (_idRetrying == WorkingSet::INVALID_ID) {
+        childState = _children[_currentChild]->work(&id);
+    } else {
+        childState = ADVANCED;
+        id = _idRetrying;
+        _idRetrying = WorkingSet::INVALID_ID;
+    }
+
+    if (PlanStage::ADVANCED == childState) {
+        WorkingSetMember* wsm = _ws->get(id);
+        invariant(1 == wsm->keyData.size());
+
+        // The child scans in descending score order, so nothing it returns later scores higher.
+        // The score is positive for every key, which keeps it distinct from an exhausted child.
+        _maxRemainingScores[_currentChild] = getKeyScore(wsm->keyData.back().keyData);
+
+        StageState state = addDocumentTopK(id, out);
+        if (PlanStage::NEED_YIELD != state) {
+            _currentChild = (_currentChild + 1) % _children.size();
+        }
+        return state;
+    } else if (PlanStage::IS_EOF == childState) {
+        _maxRemainingScores[_currentChild] = 0;
+        ++_numExhaustedChildren;
+        _currentChild = (_currentChild + 1) % _children.size();
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::FAILURE == childState) {
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "TEXT_OR stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        } else {
+            *out = id;
+        }
+        return PlanStage::FAILURE;
+    } else {
+        // Propagate WSID from below.
+        *out = id;
+        return childState;
+    }
+}
+
 PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     if (_scoreIterator == _scores.end()) {
         _internalState = State::kDone;
@@ -263,32 +343,15 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         // We haven't seen this RecordId before.
         invariant(textRecordData->score == 0);
 
-        if (!Filter::passes(newKeyData.keyData, newKeyData.indexKeyPattern, _filter)) {
-            _ws->free(wsid);
+        StageState fetchState = filterAndFetch(wsid, newKeyData, out);
+        if (PlanStage::NEED_TIME == fetchState) {
             textRecordData->score = -1;
             return NEED_TIME;
-        }
-
-        // Our parent expects RID_AND_OBJ members, so we fetch the document here if we haven't
-        // already.
-        try {
-            if (!WorkingSetCommon::fetch(getOpCtx(), _ws, wsid, _recordCursor)) {
-                _ws->free(wsid);
-                textRecordData->score = -1;
-                return NEED_TIME;
-            }
-            ++_specificStats.fetches;
-        } catch (const WriteConflictException&) {
-            wsm->makeObjOwnedIfNeeded();
-            _idRetrying = wsid;
-            *out = WorkingSet::INVALID_ID;
+        } else if (PlanStage::NEED_YIELD == fetchState) {
             return NEED_YIELD;
         }
 
         textRecordData->wsid = wsid;
-
-        // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
-        wsm->makeObjOwnedIfNeeded();
     } else {
         // We already have a working set member for this RecordId. Free the new WSM and retrieve the
         // old one. Note that since we don't keep all index keys, we could get a score that doesn't
@@ -299,8 +362,92 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
+    // Aggregate relevance score, term keys.
+    textRecordData->score += getKeyScore(newKeyData.keyData);
+    return NEED_TIME;
+}
+
+PlanStage::StageState TextOrStage::addDocumentTopK(WorkingSetID wsid, WorkingSetID* out) {
+    WorkingSetMember* wsm = _ws->get(wsid);
+    invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
+    const IndexKeyDatum newKeyData = wsm->keyData.back();  // copy to keep it around.
+    TextRecordData* textRecordData = &_scores[wsm->recordId];
+
+    if (textRecordData->score < 0 || WorkingSet::INVALID_ID != textRecordData->wsid) {
+        // We have already rejected this document, or already scored it in full.
+        _ws->free(wsid);
+        return NEED_TIME;
+    }
+
+    StageState fetchState = filterAndFetch(wsid, newKeyData, out);
+    if (PlanStage::NEED_TIME == fetchState) {
+        textRecordData->score = -1;
+        return NEED_TIME;
+    } else if (PlanStage::NEED_YIELD == fetchState) {
+        return NEED_YIELD;
+    }
+
+    // Rather than wait for this document's other postings, score it from its contents so that its
+    // final score is known now.
+    const double score = scoreDocument(wsm->obj.value());
+
+    if (_topScores.size() >= _limit && score <= _topScores.top().first) {
+        // The best '_limit' scores only ever increase, so this document can never place among
+        // them. Release it now, and remember to skip its other postings.
+        _ws->free(wsid);
+        textRecordData->score = -1;
+        return NEED_TIME;
+    }
+
+    textRecordData->wsid = wsid;
+    textRecordData->score = score;
+
+    _topScores.emplace(score, wsm->recordId);
+    if (_topScores.size() > _limit) {
+        // Release the document this one displaced from the best '_limit', so that no more than
+        // '_limit' documents are held at a time.
+        TextRecordData* displaced = &_scores[_topScores.top().second];
+        _ws->free(displaced->wsid);
+        displaced->wsid = WorkingSet::INVALID_ID;
+        displaced->score = -1;
+        _topScores.pop();
+    }
+    return NEED_TIME;
+}
+
+PlanStage::StageState TextOrStage::filterAndFetch(WorkingSetID wsid,
+                                                  const IndexKeyDatum& keyData,
+                                                  WorkingSetID* out) {
+    WorkingSetMember* wsm = _ws->get(wsid);
+
+    if (!Filter::passes(keyData.keyData, keyData.indexKeyPattern, _filter)) {
+        _ws->free(wsid);
+        return NEED_TIME;
+    }
+
+    // Our parent expects RID_AND_OBJ members, so we fetch the document here if we haven't
+    // already.
+    try {
+        if (!WorkingSetCommon::fetch(getOpCtx(), _ws, wsid, _recordCursor)) {
+            _ws->free(wsid);
+            return NEED_TIME;
+        }
+        ++_specificStats.fetches;
+    } catch (const WriteConflictException&) {
+        wsm->makeObjOwnedIfNeeded();
+        _idRetrying = wsid;
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    }
+
+    // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
+    wsm->makeObjOwnedIfNeeded();
+    return ADVANCED;
+}
+
+double TextOrStage::getKeyScore(const BSONObj& key) const {
     // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
+    BSONObjIterator keyIt(key);
     for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
         keyIt.next();
     }
@@ -308,11 +455,21 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     keyIt.next();  // Skip past 'term'.
 
     BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
+    return scoreElement.number();
+}
 
-    // Aggregate relevance score, term keys.
-    textRecordData->score += documentTermScore;
-    return NEED_TIME;
+double TextOrStage::scoreDocument(const BSONObj& obj) const {
+    TermFrequencyMap termFreqs;
+    _ftsSpec.scoreDocument(obj, &termFreqs);
+
+    double score = 0;
+    for (const auto& term : _terms) {
+        auto it = termFreqs.find(term);
+        if (it != termFreqs.end()) {
+            score += it->second;
+        }
+    }
+    return score;
 }
 
 }  // namespace mongo
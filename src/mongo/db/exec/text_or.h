@@ -28,7 +28,13 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
+#include <queue>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -47,6 +53,9 @@ class OperationContext;
  * A blocking stage that returns the set of WSMs with RecordIDs of all of the documents that contain
  * the positive terms in the search query, as well as their scores.
  *
+ * In top-k mode (see setTopK()) it instead returns only the 'k' highest-scoring such documents,
+ * usually after reading only a fraction of the postings.
+ *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
  */
 class TextOrStage final : public PlanStage {
@@ -79,6 +88,19 @@ public:
 
     void addChildren(Children childrenToAdd);
 
+    /**
+     * Enables top-k mode, in which the caller only needs the 'limit' highest-scoring documents.
+     *
+     * Every child must scan the postings of one of 'terms' in descending score order, so that the
+     * score of the last key read from a child bounds the scores of all the keys it has yet to
+     * return. The children are read in turn, and each newly seen document is scored in full from
+     * its contents. Reading stops once the 'limit'-th best score is no lower than the sum of those
+     * bounds, since no unseen document can score higher (the threshold algorithm). Documents
+     * displaced from the best 'limit' are released as soon as that happens. Ties for the last place
+     * are broken arbitrarily.
+     */
+    void setTopK(size_t limit, const std::set<std::string>& terms);
+
     bool isEOF() final;
 
     StageState doWork(WorkingSetID* out) final;
@@ -111,12 +133,41 @@ private:
      */
     StageState readFromChildren(WorkingSetID* out);
 
+    /**
+     * Worker for kReadingTerms in top-k mode. Reads from the children in turn until no unseen
+     * document can score among the best '_limit'.
+     */
+    StageState readFromChildrenTopK(WorkingSetID* out);
+
     /**
      * Helper called from readFromChildren to update aggregate score with a newfound (term, score)
      * pair for this document.
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Helper called from readFromChildrenTopK to fetch and fully score a document the first time
+     * one of its postings is read.
+     */
+    StageState addDocumentTopK(WorkingSetID wsid, WorkingSetID* out);
+
+    /**
+     * Filters and fetches the document for a newly seen RecordId. Returns ADVANCED if the document
+     * was fetched into 'wsid', NEED_TIME if it was rejected and 'wsid' freed, and NEED_YIELD if
+     * the fetch must be retried.
+     */
+    StageState filterAndFetch(WorkingSetID wsid, const IndexKeyDatum& keyData, WorkingSetID* out);
+
+    /**
+     * Returns the score stored in a text index key: {prefix,term,score,suffix}.
+     */
+    double getKeyScore(const BSONObj& key) const;
+
+    /**
+     * Returns the text score of 'obj' for '_terms', as the sum of its index keys' scores would be.
+     */
+    double scoreDocument(const BSONObj& obj) const;
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
@@ -149,6 +200,20 @@ private:
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // Top-k mode state. '_limit' is zero unless top-k mode is enabled.
+    size_t _limit = 0;
+    std::vector<std::string> _terms;
+
+    // Upper bound on the scores of the keys that each child has yet to return; zero once the child
+    // is exhausted.
+    std::vector<double> _maxRemainingScores;
+    size_t _numExhaustedChildren = 0;
+
+    // Min-heap of the best '_limit' documents seen so far, by score.
+    using ScoredRecord = std::pair<double, RecordId>;
+    std::priority_queue<ScoredRecord, std::vector<ScoredRecord>, std::greater<ScoredRecord>>
+        _topScores;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
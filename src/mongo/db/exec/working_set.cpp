@@ -43,21 +43,25 @@ WorkingSet::MemberHolder::~MemberHolder() {}
 
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
-}
+WorkingSet::~WorkingSet() {}
 
 WorkingSetID WorkingSet::allocate() {
     if (_freeList == INVALID_ID) {
         // The free list is empty so we need to make a single new WSM to return. This relies on
         // vector::resize being amortized O(1) for efficient allocation. Note that the free list
         // remains empty until something is returned by a call to free().
+        if (_lastBlockUsed == _lastBlockSize) {
+            _lastBlockSize = _memberBlocks.empty()
+                ? kMinMemberBlockSize
+                : std::min(_lastBlockSize * 2, kMaxMemberBlockSize);
+            _memberBlocks.emplace_back(new WorkingSetMember[_lastBlockSize]);
+            _lastBlockUsed = 0;
+        }
+
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = &_memberBlocks.back()[_lastBlockUsed++];
         return id;
     }
 
@@ -80,10 +84,10 @@ void WorkingSet::free(WorkingSetID i) {
 }
 
 void WorkingSet::clear() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
     _data.clear();
+    _memberBlocks.clear();
+    _lastBlockSize = 0;
+    _lastBlockUsed = 0;
 
     // Since working set is now empty, the free list pointer should
     // point to nothing.
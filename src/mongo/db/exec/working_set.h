@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -120,10 +121,17 @@ private:
         // Free list link if freed. Points to self if in use.
         WorkingSetID nextFreeOrSelf;
 
-        // Owning pointer
+        // Points into one of '_memberBlocks'.
         WorkingSetMember* member;
     };
 
+    // Members are constructed a block at a time, so that allocate() only touches the heap when
+    // every member of every block is in use. Block sizes double from kMinMemberBlockSize up to
+    // kMaxMemberBlockSize. Blocks are only released by clear() or destruction; freed members are
+    // recycled through '_freeList' instead.
+    static const size_t kMinMemberBlockSize = 16;
+    static const size_t kMaxMemberBlockSize = 1024;
+
     // All WorkingSetIDs are indexes into this, except for INVALID_ID.
     // Elements are added to _freeList rather than removed when freed.
     std::vector<MemberHolder> _data;
@@ -133,6 +141,13 @@ private:
     // If _freeList == INVALID_ID, the free list is empty and all elements in _data are in use.
     WorkingSetID _freeList;
 
+    // Storage for all members referenced from '_data'.
+    std::vector<std::unique_ptr<WorkingSetMember[]>> _memberBlocks;
+
+    // Number of members in the last block of '_memberBlocks', and how many of them are in use.
+    size_t _lastBlockSize = 0;
+    size_t _lastBlockUsed = 0;
+
     // Contains ids of WSMs that may need to be adjusted when we next yield.
     std::vector<WorkingSetID> _yieldSensitiveIds;
 };
@@ -154,4 +154,38 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST(WorkingSetTest, MembersAreStableAndRecycled) {
+    WorkingSet ws;
+
+    // Allocate enough members to span several blocks, remembering where each one lives.
+    std::vector<WorkingSetID> ids;
+    std::vector<WorkingSetMember*> members;
+    for (int i = 0; i < 5000; ++i) {
+        WorkingSetID id = ws.allocate();
+        ids.push_back(id);
+        members.push_back(ws.get(id));
+        members.back()->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("x" << i));
+        ws.transitionToOwnedObj(id);
+    }
+
+    // Growing the working set must not move members which are already in use.
+    for (size_t i = 0; i < ids.size(); ++i) {
+        ASSERT_EQUALS(members[i], ws.get(ids[i]));
+        ASSERT_EQUALS(static_cast<int>(i), members[i]->obj.value()["x"].numberInt());
+    }
+
+    // A freed member is cleared and handed out again by the next allocation.
+    ws.free(ids[42]);
+    WorkingSetID reused = ws.allocate();
+    ASSERT_EQUALS(ids[42], reused);
+    ASSERT_EQUALS(members[42], ws.get(reused));
+    ASSERT_EQUALS(WorkingSetMember::INVALID, ws.get(reused)->getState());
+    ASSERT_FALSE(ws.get(reused)->hasObj());
+
+    ws.clear();
+    WorkingSetID fresh = ws.allocate();
+    ASSERT_EQUALS(0U, fresh);
+    ASSERT_EQUALS(WorkingSetMember::INVALID, ws.get(fresh)->getState());
+}
+
 }  // namespace
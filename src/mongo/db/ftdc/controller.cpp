@@ -68,6 +68,12 @@ void FTDCController::setPeriod(Milliseconds millis) {
     _condvar.notify_one();
 }
 
+void FTDCController::setHighFrequencyPeriod(Milliseconds millis) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _configTemp.highFrequencyPeriod = millis;
+    _condvar.notify_one();
+}
+
 void FTDCController::setMaxDirectorySizeBytes(std::uint64_t size) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _configTemp.maxDirectorySizeBytes = size;
@@ -118,6 +124,16 @@ void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface
     }
 }
 
+void FTDCController::addHighFrequencyCollector(
+    std::unique_ptr<FTDCCollectorInterface> collector) {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(_state == State::kNotStarted);
+
+        _highFrequencyCollectors.add(std::move(collector));
+    }
+}
+
 void FTDCController::addOnRotateCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
@@ -202,13 +218,22 @@ void FTDCController::doLoop() {
             // Get next time to run at
             auto next_time = FTDCUtil::roundTime(now, _config.period);
 
+            // High frequency samples are taken in between the periodic ones, when enabled.
+            auto next_high_frequency_time = Date_t::max();
+            if (_config.enabled && _config.highFrequencyPeriod > Milliseconds(0) &&
+                _config.highFrequencyPeriod < _config.period) {
+                next_high_frequency_time = FTDCUtil::roundTime(now, _config.highFrequencyPeriod);
+            }
+            const bool periodic = next_time <= next_high_frequency_time;
+
             // Wait for the next run or signal to shutdown
             {
                 stdx::unique_lock<stdx::mutex> lock(_mutex);
                 MONGO_IDLE_THREAD_BLOCK;
 
                 // We ignore spurious wakeups by just doing an iteration of the loop
-                auto status = _condvar.wait_until(lock, next_time.toSystemTimePoint());
+                auto status = _condvar.wait_until(
+                    lock, std::min(next_time, next_high_frequency_time).toSystemTimePoint());
 
                 // Are we done running?
                 if (_state == State::kStopRequested) {
@@ -241,17 +266,47 @@ void FTDCController::doLoop() {
                     _mgr = uassertStatusOK(std::move(swMgr));
                 }
 
+                if (next_high_frequency_time != Date_t::max()) {
+                    auto highFrequencySample =
+                        std::get<0>(_highFrequencyCollectors.collect(client));
+                    if (!highFrequencySample.isEmpty()) {
+                        _highFrequencyMaxima = FTDCBSONUtil::mergeMetricMaxima(
+                            _highFrequencyMaxima, highFrequencySample);
+                        ++_highFrequencySampleCount;
+                    }
+                }
+
+                if (!periodic) {
+                    continue;
+                }
+
                 auto collectSample = _periodicCollectors.collect(client);
+                BSONObj sample = std::get<0>(collectSample);
+
+                if (_highFrequencySampleCount > 0) {
+                    BSONObjBuilder builder;
+                    builder.appendElements(sample);
+                    {
+                        BSONObjBuilder highFrequencyBuilder(builder.subobjStart("highFrequency"));
+                        highFrequencyBuilder.appendNumber(
+                            "samples", static_cast<long long>(_highFrequencySampleCount));
+                        highFrequencyBuilder.appendElements(_highFrequencyMaxima);
+                    }
+                    sample = builder.obj();
+
+                    _highFrequencyMaxima = BSONObj();
+                    _highFrequencySampleCount = 0;
+                }
 
-                Status s = _mgr->writeSampleAndRotateIfNeeded(
-                    client, std::get<0>(collectSample), std::get<1>(collectSample));
+                Status s =
+                    _mgr->writeSampleAndRotateIfNeeded(client, sample, std::get<1>(collectSample));
 
                 uassertStatusOK(s);
 
                 // Store a reference to the most recent document from the periodic collectors
                 {
                     stdx::lock_guard<stdx::mutex> lock(_mutex);
-                    _mostRecentPeriodicDocument = std::get<0>(collectSample);
+                    _mostRecentPeriodicDocument = sample;
                 }
             }
         }
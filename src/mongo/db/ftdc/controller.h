@@ -74,6 +74,11 @@ public:
      */
     void setPeriod(Milliseconds millis);
 
+    /**
+     * Set the period for high frequency data collection. Zero stops it.
+     */
+    void setHighFrequencyPeriod(Milliseconds millis);
+
     /**
      * Set the maximum directory size in bytes.
      */
@@ -110,6 +115,14 @@ public:
      */
     void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
 
+    /**
+     * Add a metric collector to collect on the high frequency period. i.e., globalLock queues
+     *
+     * Only the largest value each metric reaches between two periodic samples is stored, in the
+     * "highFrequency" field of the periodic sample, so these should be cheap gauges.
+     */
+    void addHighFrequencyCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
      *
@@ -203,6 +216,14 @@ private:
     // Owned
     BSONObj _mostRecentPeriodicDocument;
 
+    // Set of high frequency collectors
+    FTDCCollectorCollection _highFrequencyCollectors;
+
+    // Largest values reached by the high frequency metrics since the last periodic sample, and the
+    // number of samples they were taken from. Only used by the background thread.
+    BSONObj _highFrequencyMaxima;
+    std::size_t _highFrequencySampleCount{0};
+
     // Set of file rotation collectors
     FTDCCollectorCollection _rotateCollectors;
 
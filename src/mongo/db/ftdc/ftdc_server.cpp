@@ -37,6 +37,7 @@
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
@@ -45,6 +46,7 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/stringutils.h"
 
 namespace mongo {
 
@@ -110,6 +112,41 @@ public:
 
 } exportedFTDCPeriodParameter;
 
+AtomicInt32 localHighFrequencyPeriodMillis(FTDCConfig::kHighFrequencyPeriodMillisDefault);
+
+class ExportedFTDCHighFrequencyPeriodParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighFrequencyPeriodParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighFrequencyPeriodMillis",
+              &localHighFrequencyPeriodMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue != 0 && potentialNewValue < 10) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighFrequencyPeriodMillis must be 0 or greater "
+                          "than or equal to 10ms");
+        }
+
+        auto controller = getGlobalFTDCController();
+        if (controller) {
+            controller->setHighFrequencyPeriod(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighFrequencyPeriodParameter;
+
+// Comma separated list of the serverStatus sections sampled on the high frequency period.
+std::string localHighFrequencySections = "globalLock,connections";
+ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>
+    exportedFTDCHighFrequencySectionsParameter(ServerParameterSet::getGlobal(),
+                                               "diagnosticDataCollectionHighFrequencySections",
+                                               &localHighFrequencySections);
+
 // Scale the values down since are defaults are in bytes, but the user interface is MB
 AtomicInt32 localMaxDirectorySizeMB(FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024));
 
@@ -261,6 +298,23 @@ std::string FTDCSimpleInternalCommandCollector::name() const {
     return _name;
 }
 
+FTDCServerStatusSectionsCollector::FTDCServerStatusSectionsCollector(
+    StringData name, std::vector<std::string> sectionNames)
+    : _name(name.toString()), _sectionNames(std::move(sectionNames)) {}
+
+void FTDCServerStatusSectionsCollector::collect(OperationContext* opCtx, BSONObjBuilder& builder) {
+    for (const auto& sectionName : _sectionNames) {
+        auto section = findServerStatusSection(sectionName);
+        if (section) {
+            section->appendSection(opCtx, BSONElement(), &builder);
+        }
+    }
+}
+
+std::string FTDCServerStatusSectionsCollector::name() const {
+    return _name;
+}
+
 // Register the FTDC system
 // Note: This must be run before the server parameters are parsed during startup
 // so that the FTDCController is initialized.
@@ -270,6 +324,7 @@ void startFTDC(boost::filesystem::path& path,
                RegisterCollectorsFunction registerCollectors) {
     FTDCConfig config;
     config.period = Milliseconds(localPeriodMillis.load());
+    config.highFrequencyPeriod = Milliseconds(localHighFrequencyPeriodMillis.load());
     // Only enable FTDC if our caller says to enable FTDC, MongoS may not have a valid path to write
     // files to so update the diagnosticDataCollectionEnabled set parameter to reflect that.
     localEnabledFlag.store(startupMode == FTDCStartMode::kStart && localEnabledFlag.load());
@@ -298,6 +353,13 @@ void startFTDC(boost::filesystem::path& path,
         "",
         BSON("serverStatus" << 1 << "tcMalloc" << true << "sharding" << false)));
 
+    // High frequency collectors
+    // Only the maxima of these are recorded, in the "highFrequency" field of each periodic sample.
+    std::vector<std::string> highFrequencySections;
+    splitStringDelim(localHighFrequencySections, &highFrequencySections, ',');
+    controller->addHighFrequencyCollector(stdx::make_unique<FTDCServerStatusSectionsCollector>(
+        "serverStatus", std::move(highFrequencySections)));
+
     registerCollectors(controller.get());
 
     // Install System Metric Collector as a periodic collector
@@ -96,4 +96,22 @@ private:
     const OpMsgRequest _request;
 };
 
+/**
+ * An FTDC Collector that appends a fixed list of serverStatus sections.
+ *
+ * Unlike running the serverStatus command, this skips the sections that were not asked for, which
+ * keeps it cheap enough for the high frequency collection period. Unknown sections are ignored.
+ */
+class FTDCServerStatusSectionsCollector : public FTDCCollectorInterface {
+public:
+    FTDCServerStatusSectionsCollector(StringData name, std::vector<std::string> sectionNames);
+
+    void collect(OperationContext* opCtx, BSONObjBuilder& builder) override;
+    std::string name() const override;
+
+private:
+    std::string _name;
+    const std::vector<std::string> _sectionNames;
+};
+
 }  // namespace mongo
@@ -39,6 +39,7 @@
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/hardware_counters.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/procparser.h"
 
@@ -79,6 +80,15 @@ public:
         for (const auto& disk : _disks) {
             _disksStringData.emplace_back(disk);
         }
+
+        // The counters count every thread started after this point, which includes all the
+        // threads running operations, but not the threads started before FTDC. They are only
+        // opened when enabled with the hardwareCountersEnabled startup parameter.
+        auto swHardwareCounters =
+            HardwareCounters::open(HardwareCounters::Scope::kThreadAndDescendants);
+        if (swHardwareCounters.isOK()) {
+            _hardwareCounters = std::move(swHardwareCounters.getValue());
+        }
     }
 
     void collect(OperationContext* opCtx, BSONObjBuilder& builder) override {
@@ -123,6 +133,13 @@ public:
                                 &subObjBuilder);
             subObjBuilder.doneFast();
         }
+
+        // Skip the hardware counters section if the counters are not available.
+        if (_hardwareCounters) {
+            BSONObjBuilder subObjBuilder(builder.subobjStart("hardwareCounters"_sd));
+            _hardwareCounters->read().append(&subObjBuilder);
+            subObjBuilder.doneFast();
+        }
     }
 
 private:
@@ -131,6 +148,9 @@ private:
 
     // List of physical disks to collect stats from as StringData to pass to parseProcDiskStatsFile.
     std::vector<StringData> _disksStringData;
+
+    // Counters of the process's threads, or null if they are not available.
+    std::unique_ptr<HardwareCounters> _hardwareCounters;
 };
 
 }  // namespace
@@ -294,6 +294,87 @@ StatusWith<bool> extractMetricsFromDocument(const BSONObj& referenceDoc,
     return extractMetricsFromDocument(referenceDoc, currentDoc, metrics, true, 0);
 }
 
+namespace {
+bool mergeMetricMaxima(const BSONObj& maxima,
+                       const BSONObj& doc,
+                       BSONObjBuilder* builder,
+                       size_t recursion) {
+    if (recursion > kMaxRecursion) {
+        return false;
+    }
+
+    BSONObjIterator itMaxima(maxima);
+    for (auto&& element : doc) {
+        if (!itMaxima.more()) {
+            return false;
+        }
+
+        auto maximaElement = itMaxima.next();
+        const auto fieldName = element.fieldNameStringData();
+        if (maximaElement.fieldNameStringData() != fieldName) {
+            return false;
+        }
+
+        // As when extracting metrics, any numeric type matches any other numeric type.
+        if (element.isNumber() && maximaElement.isNumber()) {
+            builder->append(element.woCompare(maximaElement, false) >= 0 ? element
+                                                                          : maximaElement);
+            continue;
+        }
+
+        if (element.type() != maximaElement.type()) {
+            return false;
+        }
+
+        switch (element.type()) {
+            case Bool:
+                builder->appendBool(fieldName, element.Bool() || maximaElement.Bool());
+                break;
+
+            case Date:
+            case bsonTimestamp:
+                builder->append(element.woCompare(maximaElement, false) >= 0 ? element
+                                                                              : maximaElement);
+                break;
+
+            case Object: {
+                BSONObjBuilder subBuilder(builder->subobjStart(fieldName));
+                if (!mergeMetricMaxima(
+                        maximaElement.Obj(), element.Obj(), &subBuilder, recursion + 1)) {
+                    return false;
+                }
+            } break;
+
+            case Array: {
+                BSONObjBuilder subBuilder(builder->subarrayStart(fieldName));
+                if (!mergeMetricMaxima(
+                        maximaElement.Obj(), element.Obj(), &subBuilder, recursion + 1)) {
+                    return false;
+                }
+            } break;
+
+            default:
+                builder->append(element);
+                break;
+        }
+    }
+
+    return !itMaxima.more();
+}
+}  // namespace
+
+BSONObj mergeMetricMaxima(const BSONObj& maxima, const BSONObj& doc) {
+    if (maxima.isEmpty()) {
+        return doc.getOwned();
+    }
+
+    BSONObjBuilder builder;
+    if (!mergeMetricMaxima(maxima, doc, &builder, 0)) {
+        return doc.getOwned();
+    }
+    return builder.obj();
+}
+
 namespace {
 Status constructDocumentFromMetrics(const BSONObj& referenceDocument,
                                     BSONObjBuilder& builder,
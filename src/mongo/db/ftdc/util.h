@@ -169,6 +169,16 @@ StatusWith<BSONObj> getBSONDocumentFromMetadataDoc(const BSONObj& obj);
 StatusWith<std::vector<BSONObj>> getMetricsFromMetricDoc(const BSONObj& obj,
                                                          FTDCDecompressor* decompressor);
 
+/**
+ * Returns a document of the same schema as 'doc' holding, for each metric, the larger of its values
+ * in 'maxima' and 'doc'. Booleans are combined with a logical or, and fields that are not metrics
+ * are taken from 'doc'.
+ *
+ * Returns a copy of 'doc' if 'maxima' is empty, or if the two documents differ in schema as
+ * defined for extractMetricsFromDocument, except that every field is compared.
+ */
+BSONObj mergeMetricMaxima(const BSONObj& maxima, const BSONObj& doc);
+
 /**
  * Is this a type that FTDC find's interesting? I.e. is this a numeric or container type?
  */
@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/unittest/unittest.h"
 
@@ -69,4 +71,42 @@ TEST(FTDCUtilTest, TestMongoSPath) {
     }
 }
 
+// Validate metric maxima are tracked per field, including in nested documents and arrays.
+TEST(FTDCUtilTest, TestMergeMetricMaxima) {
+    auto first = BSON("name"
+                      << "joe"
+                      << "a" << 5 << "b" << 2LL << "flag" << false << "sub"
+                      << BSON("c" << 1.5 << "d" << 10)
+                      << "arr" << BSON_ARRAY(3 << 1));
+    auto second = BSON("name"
+                       << "jane"
+                       << "a" << 3 << "b" << 7LL << "flag" << true << "sub"
+                       << BSON("c" << 2.5 << "d" << 4)
+                       << "arr" << BSON_ARRAY(2 << 6));
+
+    // The first sample is taken as is.
+    auto maxima = FTDCBSONUtil::mergeMetricMaxima(BSONObj(), first);
+    ASSERT_BSONOBJ_EQ(maxima, first);
+
+    maxima = FTDCBSONUtil::mergeMetricMaxima(maxima, second);
+    ASSERT_BSONOBJ_EQ(maxima,
+                      BSON("name"
+                           << "jane"
+                           << "a" << 5 << "b" << 7LL << "flag" << true << "sub"
+                           << BSON("c" << 2.5 << "d" << 10)
+                           << "arr" << BSON_ARRAY(3 << 6)));
+}
+
+// Validate a schema change restarts the maxima from the new document.
+TEST(FTDCUtilTest, TestMergeMetricMaximaSchemaChange) {
+    auto maxima = BSON("a" << 10 << "b" << 20);
+
+    ASSERT_BSONOBJ_EQ(FTDCBSONUtil::mergeMetricMaxima(maxima, BSON("a" << 1)), BSON("a" << 1));
+    ASSERT_BSONOBJ_EQ(FTDCBSONUtil::mergeMetricMaxima(maxima, BSON("a" << 1 << "c" << 2)),
+                      BSON("a" << 1 << "c" << 2));
+    ASSERT_BSONOBJ_EQ(
+        FTDCBSONUtil::mergeMetricMaxima(maxima, BSON("a" << 1 << "b" << BSON("x" << 1))),
+        BSON("a" << 1 << "b" << BSON("x" << 1)));
+}
+
 }  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/fts/fts_index_format.h"
+#include "mongo/db/fts/fts_language.h"
+#include "mongo/db/fts/fts_spec.h"
+#include "mongo/db/fts/fts_unicode_tokenizer.h"
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+namespace fts {
+namespace {
+
+const char kEnglishText[] =
+    "The quick brown fox jumps over the lazy dog while the dogs keep running and jumping "
+    "around the fox, which is running faster than any of the jumping dogs could ever run. ";
+
+std::string makeText(int64_t copies) {
+    std::string text;
+    for (int64_t i = 0; i < copies; ++i) {
+        text += kEnglishText;
+    }
+    return text;
+}
+
+// Tokenizes 'state.range(0)' copies of a short English paragraph, filtering stop words.
+void BM_UnicodeTokenizerEnglish(benchmark::State& state) {
+    const std::string text = makeText(state.range(0));
+    StatusWithFTSLanguage swl = FTSLanguage::make("english", TEXT_INDEX_VERSION_3);
+    invariant(swl.isOK());
+    UnicodeFTSTokenizer tokenizer(swl.getValue());
+
+    for (auto keepRunning : state) {
+        tokenizer.reset(text, FTSTokenizer::kFilterStopWords);
+        while (tokenizer.moveNext()) {
+            benchmark::DoNotOptimize(tokenizer.get());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_UnicodeTokenizerEnglish)->Arg(1)->Arg(100);
+
+// Generates text index keys for a document with 'state.range(0)' text fields.
+void BM_FTSGetKeysManyFields(benchmark::State& state) {
+    BSONObjBuilder specKey;
+    BSONObjBuilder docBuilder;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        const std::string field = str::stream() << "f" << i;
+        specKey.append(field, "text");
+        docBuilder.append(field, kEnglishText);
+    }
+    auto swSpec = FTSSpec::fixSpec(BSON("key" << specKey.obj()));
+    invariant(swSpec.isOK());
+    FTSSpec spec(swSpec.getValue());
+    const BSONObj doc = docBuilder.obj();
+
+    for (auto keepRunning : state) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        FTSIndexFormat::getKeys(spec, doc, &keys);
+        benchmark::DoNotOptimize(keys);
+    }
+}
+
+BENCHMARK(BM_FTSGetKeysManyFields)->Arg(1)->Arg(20);
+
+}  // namespace
+}  // namespace fts
+}  // namespace mongo
@@ -31,6 +31,8 @@
 
 #include "mongo/db/fts/fts_spec.h"
 
+#include <algorithm>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/fts/fts_element_iterator.h"
@@ -181,10 +183,23 @@ void FTSSpec::scoreDocument(const BSONObj& obj, TermFrequencyMap* term_freqs) co
 
     FTSElementIterator it(*this, obj);
 
+    // Creating a tokenizer allocates a stemmer, so share one tokenizer among all the strings of a
+    // language in this document. That also lets its stemmer's memoized stems carry over.
+    std::vector<std::pair<const FTSLanguage*, std::unique_ptr<FTSTokenizer>>> tokenizers;
+
     while (it.more()) {
         FTSIteratorValue val = it.next();
-        std::unique_ptr<FTSTokenizer> tokenizer(val._language->createTokenizer());
-        _scoreStringV2(tokenizer.get(), val._text, term_freqs, val._weight);
+
+        auto tokenizerIt =
+            std::find_if(tokenizers.begin(), tokenizers.end(), [&](const auto& tokenizer) {
+                return tokenizer.first == val._language;
+            });
+        if (tokenizerIt == tokenizers.end()) {
+            tokenizers.emplace_back(val._language, val._language->createTokenizer());
+            tokenizerIt = tokenizers.end() - 1;
+        }
+
+        _scoreStringV2(tokenizerIt->second.get(), val._text, term_freqs, val._weight);
     }
 }
 
@@ -54,6 +54,11 @@ StringData Stemmer::stem(StringData word) const {
     if (!_stemmer)
         return word;
 
+    auto cached = _stemCache.find(word);
+    if (cached != _stemCache.end()) {
+        return cached->second;
+    }
+
     const sb_symbol* sb_sym =
         sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
@@ -62,7 +67,13 @@ StringData Stemmer::stem(StringData word) const {
         MONGO_UNREACHABLE;
     }
 
-    return StringData((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    if (_stemCache.size() >= kMaxCachedStems) {
+        _stemCache.clear();
+    }
+
+    std::string& stemmed = _stemCache[word];
+    stemmed.assign(reinterpret_cast<const char*>(sb_sym), sb_stemmer_length(_stemmer));
+    return stemmed;
 }
 }
 }
@@ -31,8 +31,11 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
+#include "mongo/util/string_map.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
 
 namespace mongo {
@@ -57,11 +60,19 @@ public:
      * The returned StringData is valid until the next call to any method on this object. Since the
      * input may be returned unmodified, the output's lifetime may also expire when the input's
      * does.
+     *
+     * Natural language text repeats a small vocabulary, so stems are memoized for the lifetime of
+     * this object, up to kMaxCachedStems words.
      */
     StringData stem(StringData word) const;
 
+    static const size_t kMaxCachedStems = 1024;
+
 private:
     struct sb_stemmer* _stemmer;
+
+    // Maps words to their stems. Cleared when it reaches kMaxCachedStems entries.
+    mutable StringMap<std::string> _stemCache;
 };
 }
 }
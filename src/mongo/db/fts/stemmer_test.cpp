@@ -33,6 +33,7 @@
 
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/stemmer.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 namespace fts {
@@ -48,5 +49,19 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+
+TEST(English, MemoizedStems) {
+    Stemmer s(&languageEnglishV2);
+    ASSERT_EQUALS("run", s.stem("running"));
+    ASSERT_EQUALS("run", s.stem("running"));
+
+    // Overflowing the stem cache must not change the results.
+    for (size_t i = 0; i <= Stemmer::kMaxCachedStems; ++i) {
+        std::string word = str::stream() << "running" << i;
+        ASSERT_EQUALS(word, s.stem(word));
+    }
+    ASSERT_EQUALS("run", s.stem("running"));
+    ASSERT_EQUALS("jump", s.stem("jumping"));
+}
 }
 }
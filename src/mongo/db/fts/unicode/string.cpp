@@ -60,7 +60,33 @@ inline void appendUtf8Codepoint(char32_t codepoint, OutputIterator* outputIt) {
         *(*outputIt)++ = (((codepoint >> (6 * 0)) & 0x3f) | 0x80);
     }
 }
+
+/**
+ * Returns the length of the longest prefix of 'utf8' made up of non-NUL ASCII bytes. Each of those
+ * bytes is a complete codepoint, so the prefix can be widened to UTF-32 without decoding.
+ */
+size_t asciiPrefixLength(StringData utf8) {
+    const char* const begin = utf8.rawData();
+    const char* const end = begin + utf8.size();
+    const char* it = begin;
+
+#ifdef MONGO_HAVE_FAST_BYTE_VECTOR
+    while (size_t(end - it) >= ByteVector::size) {
+        auto word = ByteVector::load(it);
+        uint32_t asciiBytes =
+            ByteVector::countInitialZeros(word.maskHigh() | word.compareEQ(0).maskAny());
+        it += asciiBytes;
+        if (asciiBytes != ByteVector::size)
+            return it - begin;
+    }
+#endif
+
+    while (it != end && uint8_t(*it) != 0 && uint8_t(*it) <= 0x7f) {
+        ++it;
+    }
+    return it - begin;
 }
+}  // namespace
 
 using linenoise_utf8::copyString32to8;
 using linenoise_utf8::copyString8to32;
@@ -82,17 +108,26 @@ void String::setData(const StringData utf8_src) {
     // plus a null character if there isn't one.
     _data.resize(utf8_src.size() + 1);
 
+    // Most text is ASCII, so widen the leading ASCII run directly and only hand the remainder to
+    // the general decoder. The decoder stops at the first NUL, which the ASCII run never includes.
+    const size_t asciiLength = asciiPrefixLength(utf8_src);
+    std::copy(utf8_src.rawData(), utf8_src.rawData() + asciiLength, _data.begin());
+
     int result = 0;
-    size_t resultSize = 0;
-
-    // Although utf8_src.rawData() is not guaranteed to be null-terminated, copyString8to32 won't
-    // access bad memory because it is limited by the size of its output buffer, which is set to the
-    // size of utf8_src.
-    copyString8to32(&_data[0],
-                    reinterpret_cast<const unsigned char*>(&utf8_src.rawData()[0]),
-                    _data.size(),
-                    resultSize,
-                    result);
+    size_t resultSize = asciiLength;
+
+    if (asciiLength < utf8_src.size()) {
+        // Although utf8_src.rawData() is not guaranteed to be null-terminated, copyString8to32
+        // won't access bad memory because it is limited by the size of its output buffer, which is
+        // set to the size of the rest of utf8_src.
+        size_t remainderSize = 0;
+        copyString8to32(&_data[asciiLength],
+                        reinterpret_cast<const unsigned char*>(&utf8_src.rawData()[asciiLength]),
+                        _data.size() - asciiLength,
+                        remainderSize,
+                        result);
+        resultSize += remainderSize;
+    }
 
     uassert(28755, "text contains invalid UTF-8", result == 0);
 
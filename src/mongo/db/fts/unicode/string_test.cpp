@@ -84,6 +84,27 @@ TEST(UnicodeString, SubstrTest) {
     ASSERT_EQ("", indexes.substrToBuf(&buf, 1, 0));   // len == 0.
 }
 
+TEST(UnicodeString, AsciiPrefixThenMultibyte) {
+    StackBufBuilder buf;
+
+    // The ASCII prefix is long enough to be widened by the vectored implementation before the
+    // multibyte codepoints are decoded.
+    const std::string ascii = filler + "abc";
+    String mixed(ascii + UTF8("éß") + "d");
+    ASSERT_EQ(ascii.size() + 3, mixed.size());
+    ASSERT_EQ(ascii, mixed.substrToBuf(&buf, 0, ascii.size()));
+    ASSERT_EQ(UTF8("éß") + std::string("d"), mixed.substrToBuf(&buf, ascii.size(), 3));
+
+    String allAscii(filler + filler);
+    ASSERT_EQ(filler.size() * 2, allAscii.size());
+    ASSERT_EQ(filler + filler, allAscii.toString());
+}
+
+TEST(UnicodeString, ConversionStopsAtNul) {
+    const std::string withNul = filler + std::string(1, '\0') + filler;
+    ASSERT_EQ(filler.size(), String(withNul).size());
+}
+
 TEST(UnicodeString, RemoveDiacritics) {
     // Test all ascii chars.
     for (unsigned char ch = 0; ch <= 0x7F; ch++) {
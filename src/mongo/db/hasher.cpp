@@ -35,9 +35,12 @@
 #include "mongo/db/hasher.h"
 
 
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/startup_test.h"
+#include <third_party/murmurhash3/MurmurHash3.h>
 
 namespace mongo {
 
@@ -79,7 +82,33 @@ void Hasher::finish(HashDigest out) {
     md5_finish(&_md5State, out);
 }
 
-void recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
+/**
+ * Collects the canonical form of an element in a buffer, and hashes it in one go with
+ * MurmurHash3.
+ */
+class MurmurHasher {
+    MONGO_DISALLOW_COPYING(MurmurHasher);
+
+public:
+    explicit MurmurHasher(HashSeed seed) : _seed(seed) {}
+
+    void addData(const void* keyData, size_t numBytes) {
+        _buf.appendBuf(keyData, numBytes);
+    }
+
+    long long int finish() {
+        char digest[16];
+        MurmurHash3_x64_128(_buf.buf(), _buf.len(), static_cast<uint32_t>(_seed), digest);
+        return ConstDataView(digest).read<LittleEndian<long long int>>();
+    }
+
+private:
+    StackBufBuilder _buf;
+    HashSeed _seed;
+};
+
+template <typename HasherType>
+void recursiveHash(HasherType* h, const BSONElement& e, bool includeFieldName) {
     int canonicalType = endian::nativeToLittle(e.canonicalType());
     h->addData(&canonicalType, sizeof(canonicalType));
 
@@ -122,6 +151,9 @@ struct HasherUnitTest : public StartupTest {
         // Hard-coded check to ensure the hash function is consistent across platforms
         BSONObj o = BSON("check" << 42);
         verify(BSONElementHasher::hash64(o.firstElement(), 0) == -944302157085130861LL);
+        verify(BSONElementHasher::hash64(
+                   o.firstElement(), 0, BSONElementHasher::kMurmurHashVersion) ==
+               8715208212397937794LL);
     }
 } hasherUnitTest;
 
@@ -137,4 +169,15 @@ long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
     return digestView.read<LittleEndian<long long int>>();
 }
 
+long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed, int hashVersion) {
+    if (hashVersion == kMD5HashVersion) {
+        return hash64(e, seed);
+    }
+
+    invariant(hashVersion == kMurmurHashVersion);
+    MurmurHasher h(seed);
+    recursiveHash(&h, e, false);
+    return h.finish();
+}
+
 }  // namespace mongo
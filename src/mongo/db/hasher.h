@@ -54,6 +54,19 @@ public:
      */
     static const int DEFAULT_HASH_SEED = 0;
 
+    /* The hash functions a hashed index can use, recorded as "hashVersion" in the
+     * index spec. Both hash the same canonical form of the element.
+     *
+     * kMD5HashVersion is the original, and the only one hashed shard keys use.
+     * kMurmurHashVersion uses 64 bits of MurmurHash3_x64_128, which is several times
+     * cheaper to compute than MD5.
+     */
+    enum HashVersion : int { kMD5HashVersion = 0, kMurmurHashVersion = 1 };
+
+    static bool isSupportedHashVersion(int hashVersion) {
+        return hashVersion == kMD5HashVersion || hashVersion == kMurmurHashVersion;
+    }
+
     /* This computes a 64-bit hash of the value part of BSONElement "e",
      * preceded by the seed "seed".  Squashes element (and any sub-elements)
      * of the same canonical type, so hash({a:{b:4}}) will be the same
@@ -68,6 +81,10 @@ public:
      */
     static long long int hash64(const BSONElement& e, HashSeed seed);
 
+    /* As above, using the given hash function, which must be a supported version.
+     */
+    static long long int hash64(const BSONElement& e, HashSeed seed, int hashVersion);
+
 private:
     BSONElementHasher();
 };
@@ -359,5 +359,40 @@ TEST(BSONElementHasher, HashCodeWScope) {
     ASSERT_EQUALS(hashIt(o), 501342939894575968LL);
 }
 
+long long murmurHashIt(const BSONObj& object, int seed = 0) {
+    return BSONElementHasher::hash64(
+        object.firstElement(), seed, BSONElementHasher::kMurmurHashVersion);
+}
+
+TEST(BSONElementHasher, MurmurHashVersionIsStable) {
+    ASSERT_EQUALS(murmurHashIt(BSON("check" << 42)), 8715208212397937794LL);
+}
+
+TEST(BSONElementHasher, MurmurHashVersionDiffersFromMD5) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_NOT_EQUALS(murmurHashIt(o), hashIt(o));
+    ASSERT_EQUALS(BSONElementHasher::hash64(
+                      o.firstElement(), 0, BSONElementHasher::kMD5HashVersion),
+                  hashIt(o));
+}
+
+TEST(BSONElementHasher, MurmurHashVersionSquashesNumbersAndHonorsSeed) {
+    ASSERT_EQUALS(murmurHashIt(BSON("a" << 3)), murmurHashIt(BSON("a" << 3LL)));
+    ASSERT_EQUALS(murmurHashIt(BSON("a" << 3)), murmurHashIt(BSON("a" << 3.1)));
+    ASSERT_EQUALS(murmurHashIt(BSON("a" << BSON("b" << 4))),
+                  murmurHashIt(BSON("a" << BSON("b" << 4.1))));
+    ASSERT_NOT_EQUALS(murmurHashIt(BSON("a" << 3)), murmurHashIt(BSON("a" << 4)));
+    ASSERT_NOT_EQUALS(murmurHashIt(BSON("a" << 3), 0), murmurHashIt(BSON("a" << 3), 1));
+    ASSERT_NOT_EQUALS(murmurHashIt(BSON("a" << BSON_ARRAY(1 << 2))),
+                      murmurHashIt(BSON("a" << BSON("0" << 1 << "1" << 2))));
+}
+
+TEST(BSONElementHasher, MurmurHashVersionHandlesLargeElements) {
+    // Larger than the stack buffer the hasher starts with.
+    const std::string big(4096, 'x');
+    ASSERT_EQUALS(murmurHashIt(BSON("a" << big)), murmurHashIt(BSON("b" << big)));
+    ASSERT_NOT_EQUALS(murmurHashIt(BSON("a" << big)), murmurHashIt(BSON("a" << (big + "y"))));
+}
+
 }  // namespace
 }  // namespace mongo
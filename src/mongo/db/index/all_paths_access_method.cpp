@@ -51,9 +51,39 @@ void AllPathsAccessMethod::doGetKeys(const BSONObj& obj,
                                      BSONObjSet* multikeyMetadataKeys,
                                      MultikeyPaths* multikeyPaths) const {
     _keyGen.generateKeys(obj, keys, multikeyMetadataKeys);
+
+    // Record any multikey paths before they are written, so that a concurrent planner can never
+    // observe a committed metadata key whose path is absent from the in-memory set.
+    if (multikeyMetadataKeys && !multikeyMetadataKeys->empty()) {
+        stdx::lock_guard<stdx::mutex> lk(_knownMultikeyPathsMutex);
+        for (auto&& metadataKey : *multikeyMetadataKeys) {
+            BSONObjIterator iter(metadataKey);
+            iter.next();
+            _knownMultikeyPaths.emplace(iter.next().valueStringData());
+        }
+    }
 }
 
 std::set<FieldRef> AllPathsAccessMethod::getMultikeyPathSet(OperationContext* opCtx) const {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_knownMultikeyPathsMutex);
+        if (_knownMultikeyPathsLoaded) {
+            return _knownMultikeyPaths;
+        }
+    }
+
+    // Scan without holding the mutex. Writers which race with the scan add their paths to the
+    // in-memory set directly, so merging the two cannot lose a path.
+    auto multikeyPathsInIndex = _getMultikeyPathSetFromIndex(opCtx);
+
+    stdx::lock_guard<stdx::mutex> lk(_knownMultikeyPathsMutex);
+    _knownMultikeyPaths.insert(multikeyPathsInIndex.begin(), multikeyPathsInIndex.end());
+    _knownMultikeyPathsLoaded = true;
+    return _knownMultikeyPaths;
+}
+
+std::set<FieldRef> AllPathsAccessMethod::_getMultikeyPathSetFromIndex(
+    OperationContext* opCtx) const {
     auto cursor = newCursor(opCtx);
     // All of the keys storing multikeyness metadata are prefixed by a value of 1. Establish an
     // index cursor which will scan this range.
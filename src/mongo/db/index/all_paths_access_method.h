@@ -31,6 +31,7 @@
 #include "mongo/db/index/all_paths_key_generator.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -58,6 +59,11 @@ public:
 
     /**
      * Returns the set of paths included in this $** index that could be multikey.
+     *
+     * The metadata keys are read from the index only on the first call. Thereafter the result is
+     * served from an in-memory set which is extended whenever keys are generated for a document
+     * containing an array path; since paths are recorded before the writing operation commits, the
+     * set is always a superset of the multikey paths visible to any snapshot.
      */
     std::set<FieldRef> getMultikeyPathSet(OperationContext*) const final;
 
@@ -67,6 +73,18 @@ private:
                    BSONObjSet* multikeyMetadataKeys,
                    MultikeyPaths* multikeyPaths) const final;
 
+    // Scans the metadata keys in the index and returns the set of paths they record.
+    std::set<FieldRef> _getMultikeyPathSetFromIndex(OperationContext* opCtx) const;
+
     const AllPathsKeyGenerator _keyGen;
+
+    // Protects '_knownMultikeyPaths' and '_knownMultikeyPathsLoaded'.
+    mutable stdx::mutex _knownMultikeyPathsMutex;
+
+    // Every path which has been observed to be multikey by this access method.
+    mutable std::set<FieldRef> _knownMultikeyPaths;
+
+    // Whether '_knownMultikeyPaths' has been seeded with the metadata keys already in the index.
+    mutable bool _knownMultikeyPathsLoaded = false;
 };
 }  // namespace mongo
@@ -42,19 +42,24 @@ static const BSONObj kDefaultProjection = BSON("_id"_sd << 0);
 
 // If the enclosing object is an array, then the current element's fieldname is the array index, so
 // we omit this when computing the full path. Otherwise, the full path is the pathPrefix plus the
-// element's fieldname.
-void pushPathComponent(BSONElement elem, bool enclosingObjIsArray, FieldRef* pathPrefix) {
+// element's fieldname. The path is built in a single buffer which is reused for the whole document,
+// so that descending into a field does not allocate once its capacity has grown to fit. Every
+// component, including the first, is preceded by a '.' so that empty field names are preserved.
+void pushPathComponent(BSONElement elem, bool enclosingObjIsArray, std::string* pathPrefix) {
     if (!enclosingObjIsArray) {
-        pathPrefix->appendPart(elem.fieldNameStringData());
+        pathPrefix->push_back('.');
+        pathPrefix->append(elem.fieldName(), elem.fieldNameSize() - 1);
     }
 }
 
 // If the enclosing object is not an array, then the final path component should be its field name.
-// Verify that this is the case and then pop it off the FieldRef.
-void popPathComponent(BSONElement elem, bool enclosingObjIsArray, FieldRef* pathToElem) {
+// Verify that this is the case and then truncate it, along with its separator, from the buffer.
+void popPathComponent(BSONElement elem, bool enclosingObjIsArray, std::string* pathToElem) {
     if (!enclosingObjIsArray) {
-        invariant(pathToElem->getPart(pathToElem->numParts() - 1) == elem.fieldNameStringData());
-        pathToElem->removeLastPart();
+        const auto fieldName = elem.fieldNameStringData();
+        invariant(pathToElem->size() > fieldName.size() &&
+                  StringData(*pathToElem).endsWith(fieldName));
+        pathToElem->resize(pathToElem->size() - fieldName.size() - 1);
     }
 }
 }  // namespace
@@ -100,13 +105,13 @@ AllPathsKeyGenerator::AllPathsKeyGenerator(BSONObj keyPattern,
 void AllPathsKeyGenerator::generateKeys(BSONObj inputDoc,
                                         BSONObjSet* keys,
                                         BSONObjSet* multikeyPaths) const {
-    FieldRef rootPath;
+    std::string rootPath;
     _traverseAllPaths(_projExec->applyProjection(inputDoc), false, &rootPath, keys, multikeyPaths);
 }
 
 void AllPathsKeyGenerator::_traverseAllPaths(BSONObj obj,
                                              bool objIsArray,
-                                             FieldRef* path,
+                                             std::string* path,
                                              BSONObjSet* keys,
                                              BSONObjSet* multikeyPaths) const {
     for (const auto elem : obj) {
@@ -116,18 +121,19 @@ void AllPathsKeyGenerator::_traverseAllPaths(BSONObj obj,
 
         // Append the element's fieldname to the path, if the enclosing object is not an array.
         pushPathComponent(elem, objIsArray, path);
+        const auto fullPath = StringData(*path).substr(1);
 
         switch (elem.type()) {
             case BSONType::Array:
                 // If this is a nested array, we don't descend it but instead index it as a value.
-                if (_addKeyForNestedArray(elem, *path, objIsArray, keys))
+                if (_addKeyForNestedArray(elem, fullPath, objIsArray, keys))
                     break;
 
                 // Add an entry for the multi-key path, and then fall through to BSONType::Object.
-                _addMultiKey(*path, multikeyPaths);
+                _addMultiKey(fullPath, multikeyPaths);
 
             case BSONType::Object:
-                if (_addKeyForEmptyLeaf(elem, *path, keys))
+                if (_addKeyForEmptyLeaf(elem, fullPath, keys))
                     break;
 
                 _traverseAllPaths(
@@ -135,7 +141,7 @@ void AllPathsKeyGenerator::_traverseAllPaths(BSONObj obj,
                 break;
 
             default:
-                _addKey(elem, *path, keys);
+                _addKey(elem, fullPath, keys);
         }
 
         // Remove the element's fieldname from the path, if it was pushed onto it earlier.
@@ -144,7 +150,7 @@ void AllPathsKeyGenerator::_traverseAllPaths(BSONObj obj,
 }
 
 bool AllPathsKeyGenerator::_addKeyForNestedArray(BSONElement elem,
-                                                 const FieldRef& fullPath,
+                                                 StringData fullPath,
                                                  bool enclosingObjIsArray,
                                                  BSONObjSet* keys) const {
     // If this element is an array whose parent is also an array, index it as a value.
@@ -156,7 +162,7 @@ bool AllPathsKeyGenerator::_addKeyForNestedArray(BSONElement elem,
 }
 
 bool AllPathsKeyGenerator::_addKeyForEmptyLeaf(BSONElement elem,
-                                               const FieldRef& fullPath,
+                                               StringData fullPath,
                                                BSONObjSet* keys) const {
     invariant(elem.isABSONObj());
     if (elem.embeddedObject().isEmpty()) {
@@ -169,11 +175,11 @@ bool AllPathsKeyGenerator::_addKeyForEmptyLeaf(BSONElement elem,
 }
 
 void AllPathsKeyGenerator::_addKey(BSONElement elem,
-                                   const FieldRef& fullPath,
+                                   StringData fullPath,
                                    BSONObjSet* keys) const {
     // AllPaths keys are of the form { "": "path.to.field", "": <collation-aware value> }.
     BSONObjBuilder bob;
-    bob.append("", fullPath.dottedField());
+    bob.append("", fullPath);
     if (elem) {
         CollationIndexKey::collationAwareIndexKeyAppend(elem, _collator, &bob);
     } else {
@@ -182,12 +188,12 @@ void AllPathsKeyGenerator::_addKey(BSONElement elem,
     keys->insert(bob.obj());
 }
 
-void AllPathsKeyGenerator::_addMultiKey(const FieldRef& fullPath, BSONObjSet* multikeyPaths) const {
+void AllPathsKeyGenerator::_addMultiKey(StringData fullPath, BSONObjSet* multikeyPaths) const {
     // Multikey paths are denoted by a key of the form { "": 1, "": "path.to.array" }. The argument
     // 'multikeyPaths' may be nullptr if the access method is being used in an operation which does
     // not require multikey path generation.
     if (multikeyPaths) {
-        multikeyPaths->insert(BSON("" << 1 << "" << fullPath.dottedField()));
+        multikeyPaths->insert(BSON("" << 1 << "" << fullPath));
     }
 }
 
@@ -69,20 +69,20 @@ private:
     // Traverses every path of the post-projection document, adding keys to the set as it goes.
     void _traverseAllPaths(BSONObj obj,
                            bool objIsArray,
-                           FieldRef* path,
+                           std::string* path,
                            BSONObjSet* keys,
                            BSONObjSet* multikeyPaths) const;
 
     // Helper functions to format the entry appropriately before adding it to the key/path tracker.
-    void _addMultiKey(const FieldRef& fullPath, BSONObjSet* multikeyPaths) const;
-    void _addKey(BSONElement elem, const FieldRef& fullPath, BSONObjSet* keys) const;
+    void _addMultiKey(StringData fullPath, BSONObjSet* multikeyPaths) const;
+    void _addKey(BSONElement elem, StringData fullPath, BSONObjSet* keys) const;
 
     // Helper to check whether the element is a nested array, and conditionally add it to 'keys'.
     bool _addKeyForNestedArray(BSONElement elem,
-                               const FieldRef& fullPath,
+                               StringData fullPath,
                                bool enclosingObjIsArray,
                                BSONObjSet* keys) const;
-    bool _addKeyForEmptyLeaf(BSONElement elem, const FieldRef& fullPath, BSONObjSet* keys) const;
+    bool _addKeyForEmptyLeaf(BSONElement elem, StringData fullPath, BSONObjSet* keys) const;
 
     std::unique_ptr<ProjectionExecAgg> _projExec;
     const CollatorInterface* _collator;
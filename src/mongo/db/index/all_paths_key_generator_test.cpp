@@ -107,6 +107,26 @@ TEST(AllPathsKeyGeneratorFullDocumentTest, ExtractKeysFromNestedObject) {
     ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
 }
 
+TEST(AllPathsKeyGeneratorFullDocumentTest, ExtractKeysFromSiblingsOfNestedObjects) {
+    AllPathsKeyGenerator keyGen{fromjson("{'$**': 1}"), {}, nullptr};
+    auto inputDoc = fromjson("{a: {b: {c: 1}, d: [2, {e: 3}]}, f: 4, '': {g: 5}}");
+
+    auto expectedKeys = makeKeySet({fromjson("{'': 'a.b.c', '': 1}"),
+                                    fromjson("{'': 'a.d', '': 2}"),
+                                    fromjson("{'': 'a.d.e', '': 3}"),
+                                    fromjson("{'': 'f', '': 4}"),
+                                    fromjson("{'': '.g', '': 5}")});
+
+    auto expectedMultikeyPaths = makeKeySet({fromjson("{'': 1, '': 'a.d'}")});
+
+    auto outputKeys = makeKeySet();
+    auto multikeyMetadataKeys = makeKeySet();
+    keyGen.generateKeys(inputDoc, &outputKeys, &multikeyMetadataKeys);
+
+    ASSERT(assertKeysetsEqual(expectedKeys, outputKeys));
+    ASSERT(assertKeysetsEqual(expectedMultikeyPaths, multikeyMetadataKeys));
+}
+
 TEST(AllPathsKeyGeneratorFullDocumentTest, ShouldIndexEmptyObject) {
     AllPathsKeyGenerator keyGen{fromjson("{'$**': 1}"), {}, nullptr};
     auto inputDoc = fromjson("{a: 1, b: {}}");
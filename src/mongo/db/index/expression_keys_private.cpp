@@ -90,9 +90,6 @@ Status S2GetKeysForElement(const BSONElement& element,
     if (!status.isOK())
         return status;
 
-    S2RegionCoverer coverer;
-    params.configureCoverer(geoContainer, &coverer);
-
     // Don't index big polygon
     if (geoContainer.getNativeCRS() == STRICT_SPHERE) {
         return Status(ErrorCodes::BadValue, "can't index geometry with strict winding order");
@@ -115,6 +112,16 @@ Status S2GetKeysForElement(const BSONElement& element,
 
     invariant(geoContainer.hasS2Region());
 
+    // Points are indexed at the leaf level in S2_INDEX_VERSION_3 and later, and the region of a
+    // projected point is already the leaf cell containing it. Its covering is the cell itself, so
+    // skip the region coverer, which dominates key generation for point-heavy workloads.
+    if (params.indexVersion >= S2_INDEX_VERSION_3 && geoContainer.isPoint()) {
+        out->push_back(static_cast<const S2Cell&>(geoContainer.getS2Region()).id());
+        return Status::OK();
+    }
+
+    S2RegionCoverer coverer;
+    params.configureCoverer(geoContainer, &coverer);
     coverer.GetCovering(geoContainer.getS2Region(), out);
     return Status::OK();
 }
@@ -371,8 +378,10 @@ void ExpressionKeysPrivate::getHashKeys(const BSONObj& obj,
 
 // static
 long long int ExpressionKeysPrivate::makeSingleHashKey(const BSONElement& e, HashSeed seed, int v) {
-    massert(16767, "Only HashVersion 0 has been defined", v == 0);
-    return BSONElementHasher::hash64(e, seed);
+    massert(16767,
+            "Only HashVersion 0 and 1 have been defined",
+            BSONElementHasher::isSupportedHashVersion(v));
+    return BSONElementHasher::hash64(e, seed, v);
 }
 
 // static
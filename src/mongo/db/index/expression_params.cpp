@@ -84,11 +84,13 @@ void ExpressionParams::parseHashParams(const BSONObj& infoObj,
         *seedOut = infoObj["seed"].numberInt();
     }
 
-    // In case we have hashed indexes based on other hash functions in the future, we store
-    // a hashVersion number. If hashVersion changes, "makeSingleHashKey" will need to change
-    // accordingly.  Defaults to 0 if "hashVersion" is not included in the index spec or if
-    // the value of "hashversion" is not a number
+    // Hashed indexes record which hash function they use as a hashVersion number, see
+    // BSONElementHasher::HashVersion. Defaults to 0 (MD5) if "hashVersion" is not included in the
+    // index spec or if the value of "hashversion" is not a number
     *versionOut = infoObj["hashVersion"].numberInt();
+    uassert(ErrorCodes::CannotCreateIndex,
+            str::stream() << "unsupported hashVersion " << *versionOut << " for hashed index",
+            BSONElementHasher::isSupportedHashVersion(*versionOut));
 
     // Get the hashfield name
     BSONElement firstElt = infoObj.getObjectField("key").firstElement();
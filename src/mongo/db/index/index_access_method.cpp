@@ -32,6 +32,8 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
+#include <boost/filesystem/path.hpp>
 #include <utility>
 #include <vector>
 
@@ -43,6 +45,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/index/index_build_interceptor.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
@@ -183,7 +186,6 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
                                  int64_t* numInserted) {
     invariant(numInserted);
     *numInserted = 0;
-    bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
     BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
     MultikeyPaths multikeyPaths;
@@ -195,18 +197,9 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     // the multikey metadata keys, they should point to the reserved 'kMultikeyMetadataKeyId'.
     for (const auto keySet : {&keys, &multikeyMetadataKeys}) {
         const auto& recordId = (keySet == &keys ? loc : kMultikeyMetadataKeyId);
-        for (const auto& key : *keySet) {
-            Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
-            if (status.isOK()) {
-                StatusWith<SpecialFormatInserted> ret =
-                    _newInterface->insert(opCtx, key, recordId, options.dupsAllowed);
-                status = ret.getStatus();
-                if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
-                    _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
-            }
-            if (isFatalError(opCtx, status, key)) {
-                return status;
-            }
+        Status status = _insertKeysOrSideWrite(opCtx, asVector(*keySet), recordId, options);
+        if (!status.isOK()) {
+            return status;
         }
     }
 
@@ -219,6 +212,96 @@ Status IndexAccessMethod::insert(OperationContext* opCtx,
     return Status::OK();
 }
 
+Status IndexAccessMethod::insertBatch(OperationContext* opCtx,
+                                      const std::vector<BsonRecord>& bsonRecords,
+                                      const InsertDeleteOptions& options,
+                                      int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+
+    // Writes recorded on the side during an index build are applied in their own order anyway.
+    if (_btreeState->indexBuildInterceptor()) {
+        for (const auto& bsonRecord : bsonRecords) {
+            int64_t inserted;
+            Status status = insert(opCtx, *bsonRecord.docPtr, bsonRecord.id, options, &inserted);
+            if (!status.isOK()) {
+                return status;
+            }
+            *numInserted += inserted;
+        }
+        return Status::OK();
+    }
+
+    using KeyEntry = std::pair<BSONObj, RecordId>;
+    std::vector<KeyEntry> keyEntries;
+    keyEntries.reserve(bsonRecords.size());
+    BSONObjSet multikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    MultikeyPaths multikeyPaths;
+    bool markMultikey = false;
+
+    BSONObjSet docKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    BSONObjSet docMultikeyMetadataKeys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+    MultikeyPaths docMultikeyPaths;
+    for (const auto& bsonRecord : bsonRecords) {
+        docKeys.clear();
+        docMultikeyMetadataKeys.clear();
+        docMultikeyPaths.clear();
+        getKeys(*bsonRecord.docPtr,
+                options.getKeysMode,
+                &docKeys,
+                &docMultikeyMetadataKeys,
+                &docMultikeyPaths);
+
+        if (shouldMarkIndexAsMultikey(docKeys, docMultikeyMetadataKeys, docMultikeyPaths)) {
+            markMultikey = true;
+            if (multikeyPaths.empty()) {
+                multikeyPaths = docMultikeyPaths;
+            } else if (!docMultikeyPaths.empty()) {
+                invariant(multikeyPaths.size() == docMultikeyPaths.size());
+                for (size_t i = 0; i < docMultikeyPaths.size(); ++i) {
+                    multikeyPaths[i].insert(docMultikeyPaths[i].begin(),
+                                            docMultikeyPaths[i].end());
+                }
+            }
+        }
+
+        for (const auto& key : docKeys) {
+            keyEntries.emplace_back(key, bsonRecord.id);
+        }
+        multikeyMetadataKeys.insert(docMultikeyMetadataKeys.begin(),
+                                    docMultikeyMetadataKeys.end());
+    }
+
+    const Ordering ordering = Ordering::make(_descriptor->keyPattern());
+    std::sort(keyEntries.begin(), keyEntries.end(), [&](const KeyEntry& lhs, const KeyEntry& rhs) {
+        const int cmp = lhs.first.woCompare(rhs.first, ordering, false);
+        return cmp < 0 || (cmp == 0 && lhs.second < rhs.second);
+    });
+
+    const bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
+    for (const auto& keyEntry : keyEntries) {
+        Status status =
+            _insertKey(opCtx, keyEntry.first, keyEntry.second, options, checkIndexKeySize);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+    for (const auto& key : multikeyMetadataKeys) {
+        Status status = _insertKey(opCtx, key, kMultikeyMetadataKeyId, options, checkIndexKeySize);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    *numInserted = keyEntries.size() + multikeyMetadataKeys.size();
+
+    if (markMultikey) {
+        _btreeState->setMultikey(opCtx, multikeyPaths);
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* opCtx,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -259,15 +342,95 @@ Status IndexAccessMethod::remove(OperationContext* opCtx,
     getKeys(
         obj, GetKeysMode::kRelaxConstraintsUnfiltered, &keys, multikeyMetadataKeys, multikeyPaths);
 
+    if (auto interceptor = _btreeState->indexBuildInterceptor()) {
+        Status status =
+            interceptor->sideWrite(opCtx, asVector(keys), loc, IndexBuildInterceptor::Op::kDelete);
+        if (!status.isOK()) {
+            return status;
+        }
+        *numDeleted = keys.size();
+        return Status::OK();
+    }
+
+    removeKeys(opCtx, asVector(keys), loc, options, numDeleted);
+
+    return Status::OK();
+}
+
+Status IndexAccessMethod::insertKeys(OperationContext* opCtx,
+                                     const std::vector<BSONObj>& keys,
+                                     const RecordId& loc,
+                                     const InsertDeleteOptions& options,
+                                     int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+    bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
+
     for (const auto& key : keys) {
-        removeOneKey(opCtx, key, loc, options.dupsAllowed);
+        Status status = _insertKey(opCtx, key, loc, options, checkIndexKeySize);
+        if (!status.isOK()) {
+            return status;
+        }
     }
 
-    *numDeleted = keys.size();
+    *numInserted = keys.size();
+    return Status::OK();
+}
 
+Status IndexAccessMethod::_insertKey(OperationContext* opCtx,
+                                     const BSONObj& key,
+                                     const RecordId& loc,
+                                     const InsertDeleteOptions& options,
+                                     bool checkIndexKeySize) {
+    Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
+    if (status.isOK()) {
+        StatusWith<SpecialFormatInserted> ret =
+            _newInterface->insert(opCtx, key, loc, options.dupsAllowed);
+        status = ret.getStatus();
+        if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
+            _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
+    }
+    if (isFatalError(opCtx, status, key)) {
+        return status;
+    }
     return Status::OK();
 }
 
+void IndexAccessMethod::removeKeys(OperationContext* opCtx,
+                                   const std::vector<BSONObj>& keys,
+                                   const RecordId& loc,
+                                   const InsertDeleteOptions& options,
+                                   int64_t* numDeleted) {
+    invariant(numDeleted);
+    for (const auto& key : keys) {
+        removeOneKey(opCtx, key, loc, options.dupsAllowed);
+    }
+    *numDeleted = keys.size();
+}
+
+Status IndexAccessMethod::_insertKeysOrSideWrite(OperationContext* opCtx,
+                                                 const std::vector<BSONObj>& keys,
+                                                 const RecordId& loc,
+                                                 const InsertDeleteOptions& options) {
+    auto interceptor = _btreeState->indexBuildInterceptor();
+    if (!interceptor) {
+        int64_t unused;
+        return insertKeys(opCtx, keys, loc, options, &unused);
+    }
+
+    // Fail the write the same way as inserting into the index would have, rather than the index
+    // build once the key is applied.
+    if (shouldCheckIndexKeySize(opCtx)) {
+        for (const auto& key : keys) {
+            Status status = checkKeySize(key);
+            if (isFatalError(opCtx, status, key)) {
+                return status;
+            }
+        }
+    }
+    return interceptor->sideWrite(opCtx, keys, loc, IndexBuildInterceptor::Op::kInsert);
+}
+
 Status IndexAccessMethod::initializeAsEmpty(OperationContext* opCtx) {
     return _newInterface->initAsEmpty(opCtx);
 }
@@ -431,11 +594,20 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
         return Status(ErrorCodes::InternalError, "Invalid UpdateTicket in update");
     }
 
-    for (const auto& remKey : ticket.removed) {
-        _newInterface->unindex(opCtx, remKey, ticket.loc, ticket.dupsAllowed);
+    if (auto interceptor = _btreeState->indexBuildInterceptor()) {
+        Status status = interceptor->sideWrite(
+            opCtx, ticket.removed, ticket.loc, IndexBuildInterceptor::Op::kDelete);
+        if (!status.isOK()) {
+            return status;
+        }
+    } else {
+        for (const auto& remKey : ticket.removed) {
+            _newInterface->unindex(opCtx, remKey, ticket.loc, ticket.dupsAllowed);
+        }
     }
 
-    bool checkIndexKeySize = shouldCheckIndexKeySize(opCtx);
+    InsertDeleteOptions options;
+    options.dupsAllowed = ticket.dupsAllowed;
 
     // Add all new data keys, and all new multikey metadata keys, into the index. When iterating
     // over the data keys, each of them should point to the doc's RecordId. When iterating over
@@ -443,18 +615,9 @@ Status IndexAccessMethod::update(OperationContext* opCtx,
     const auto newMultikeyMetadataKeys = asVector(ticket.newMultikeyMetadataKeys);
     for (const auto keySet : {&ticket.added, &newMultikeyMetadataKeys}) {
         const auto& recordId = (keySet == &ticket.added ? ticket.loc : kMultikeyMetadataKeyId);
-        for (const auto& key : *keySet) {
-            Status status = checkIndexKeySize ? checkKeySize(key) : Status::OK();
-            if (status.isOK()) {
-                StatusWith<SpecialFormatInserted> ret =
-                    _newInterface->insert(opCtx, key, recordId, ticket.dupsAllowed);
-                status = ret.getStatus();
-                if (status.isOK() && ret.getValue() == SpecialFormatInserted::LongTypeBitsInserted)
-                    _btreeState->setIndexKeyStringWithLongTypeBitsExistsOnDisk(opCtx);
-            }
-            if (isFatalError(opCtx, status, key)) {
-                return status;
-            }
+        Status status = _insertKeysOrSideWrite(opCtx, *keySet, recordId, options);
+        if (!status.isOK()) {
+            return status;
         }
     }
 
@@ -473,21 +636,99 @@ Status IndexAccessMethod::compact(OperationContext* opCtx) {
     return this->_newInterface->compact(opCtx);
 }
 
+StatusWith<bool> IndexAccessMethod::compactStep(OperationContext* opCtx, Seconds timeout) {
+    return this->_newInterface->compactStep(opCtx, timeout);
+}
+
 std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateBulk(
     size_t maxMemoryUsageBytes) {
-    return std::unique_ptr<BulkBuilder>(new BulkBuilder(this, _descriptor, maxMemoryUsageBytes));
+    return std::unique_ptr<BulkBuilder>(new BulkBuilder(
+        this, _descriptor, maxMemoryUsageBytes, storageGlobalParams.dbpath + "/_tmp", BSONObj()));
+}
+
+std::unique_ptr<IndexAccessMethod::BulkBuilder> IndexAccessMethod::initiateResumableBulk(
+    size_t maxMemoryUsageBytes, const std::string& tempDir, const BSONObj& persistedState) {
+    return std::unique_ptr<BulkBuilder>(
+        new BulkBuilder(this, _descriptor, maxMemoryUsageBytes, tempDir, persistedState));
 }
 
+namespace {
+
+// The fields of a persisted BulkBuilder state.
+constexpr StringData kRunsFieldName = "runs"_sd;
+constexpr StringData kKeysInsertedFieldName = "keysInserted"_sd;
+constexpr StringData kIsMultikeyFieldName = "isMultikey"_sd;
+constexpr StringData kMultikeyPathsFieldName = "multikeyPaths"_sd;
+constexpr StringData kMultikeyMetadataKeysFieldName = "multikeyMetadataKeys"_sd;
+
+}  // namespace
+
 IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
                                             const IndexDescriptor* descriptor,
-                                            size_t maxMemoryUsageBytes)
-    : _sorter(Sorter::make(
-          SortOptions()
-              .TempDir(storageGlobalParams.dbpath + "/_tmp")
-              .ExtSortAllowed()
-              .MaxMemoryUsageBytes(maxMemoryUsageBytes),
-          BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
-      _real(index) {}
+                                            size_t maxMemoryUsageBytes,
+                                            const std::string& tempDir,
+                                            const BSONObj& persistedState)
+    : _tempDir(tempDir), _real(index) {
+    const auto sortOptions =
+        SortOptions().TempDir(_tempDir).ExtSortAllowed().MaxMemoryUsageBytes(maxMemoryUsageBytes);
+    const BtreeExternalSortComparison comparison(descriptor->keyPattern(), descriptor->version());
+
+    if (persistedState.isEmpty()) {
+        _sorter.reset(Sorter::make(sortOptions, comparison));
+        return;
+    }
+
+    // The runs are recorded relative to the temporary directory.
+    std::vector<std::string> runFileNames;
+    for (const auto& run : persistedState[kRunsFieldName].Array()) {
+        runFileNames.push_back(_tempDir + "/" + run.String());
+    }
+    _sorter.reset(Sorter::makeFromSpilledRuns(runFileNames, sortOptions, comparison));
+
+    _keysInserted = persistedState[kKeysInsertedFieldName].numberLong();
+    _isMultiKey = persistedState[kIsMultikeyFieldName].trueValue();
+    for (const auto& path : persistedState[kMultikeyPathsFieldName].Array()) {
+        _indexMultikeyPaths.emplace_back();
+        for (const auto& component : path.Array()) {
+            _indexMultikeyPaths.back().insert(static_cast<size_t>(component.numberLong()));
+        }
+    }
+    for (const auto& key : persistedState[kMultikeyMetadataKeysFieldName].Array()) {
+        _multikeyMetadataKeys.insert(key.Obj().getOwned());
+    }
+}
+
+BSONObj IndexAccessMethod::BulkBuilder::persistState() {
+    BSONObjBuilder builder;
+    {
+        BSONArrayBuilder runs(builder.subarrayStart(kRunsFieldName));
+        for (const auto& fileName : _sorter->persistSpilledRuns()) {
+            runs.append(boost::filesystem::path(fileName).filename().string());
+        }
+    }
+    builder.append(kKeysInsertedFieldName, static_cast<long long>(_keysInserted));
+    builder.append(kIsMultikeyFieldName, _isMultiKey);
+    {
+        BSONArrayBuilder paths(builder.subarrayStart(kMultikeyPathsFieldName));
+        for (const auto& path : _indexMultikeyPaths) {
+            BSONArrayBuilder components(paths.subarrayStart());
+            for (const auto component : path) {
+                components.append(static_cast<long long>(component));
+            }
+        }
+    }
+    {
+        BSONArrayBuilder keys(builder.subarrayStart(kMultikeyMetadataKeysFieldName));
+        for (const auto& key : _multikeyMetadataKeys) {
+            keys.append(key);
+        }
+    }
+    return builder.obj();
+}
+
+void IndexAccessMethod::BulkBuilder::keepPersistedState() {
+    _sorter->keepSpilledRuns();
+}
 
 Status IndexAccessMethod::BulkBuilder::insert(OperationContext* opCtx,
                                               const BSONObj& obj,
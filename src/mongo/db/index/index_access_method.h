@@ -46,6 +46,7 @@ namespace mongo {
 
 class BSONObjBuilder;
 class MatchExpression;
+struct BsonRecord;
 class UpdateTicket;
 struct InsertDeleteOptions;
 
@@ -86,6 +87,19 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted);
 
+    /**
+     * Inserts the keys of every record in 'bsonRecords', as calling insert() for each of them
+     * would. The keys of the whole batch are generated first and then written in index order, so
+     * that consecutive writes land next to one another in the index.
+     *
+     * The timestamps of 'bsonRecords' are not applied; the caller must not need the writes of
+     * different records to be timestamped individually.
+     */
+    Status insertBatch(OperationContext* opCtx,
+                       const std::vector<BsonRecord>& bsonRecords,
+                       const InsertDeleteOptions& options,
+                       int64_t* numInserted);
+
     /**
      * Analogous to above, but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
@@ -96,6 +110,22 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numDeleted);
 
+    /**
+     * Inserts 'keys' pointing to 'loc' into the index, or removes them from it, as is. Unlike
+     * insert() and remove(), these always write to the index itself, even while an index build
+     * is recording the writes to the index on the side.
+     */
+    Status insertKeys(OperationContext* opCtx,
+                      const std::vector<BSONObj>& keys,
+                      const RecordId& loc,
+                      const InsertDeleteOptions& options,
+                      int64_t* numInserted);
+    void removeKeys(OperationContext* opCtx,
+                    const std::vector<BSONObj>& keys,
+                    const RecordId& loc,
+                    const InsertDeleteOptions& options,
+                    int64_t* numDeleted);
+
     /**
      * Checks whether the index entries for the document 'from', which is placed at location
      * 'loc' on disk, can be changed to the index entries for the doc 'to'. Provides a ticket
@@ -188,6 +218,12 @@ public:
      */
     Status compact(OperationContext* opCtx);
 
+    /**
+     * Performs a bounded amount of in-place compaction. Returns true if compaction ran to
+     * completion, or false if it gave up after roughly 'timeout' and may be continued.
+     */
+    StatusWith<bool> compactStep(OperationContext* opCtx, Seconds timeout);
+
     /**
      * Sets this index as multikey with the provided paths.
      */
@@ -223,12 +259,31 @@ public:
          */
         Sorter::Iterator* done();
 
+        /**
+         * Forces every key inserted so far to disk in this BulkBuilder's temporary directory, and
+         * returns a description of them from which initiateResumableBulk() can start another
+         * BulkBuilder for the same index. Only valid for a BulkBuilder from
+         * initiateResumableBulk(), before done() is called.
+         */
+        BSONObj persistState();
+
+        /**
+         * Leaves the files described by persistState() in place when this BulkBuilder is
+         * destroyed, instead of deleting them.
+         */
+        void keepPersistedState();
+
     private:
         friend class IndexAccessMethod;
 
         BulkBuilder(const IndexAccessMethod* index,
                     const IndexDescriptor* descriptor,
-                    size_t maxMemoryUsageBytes);
+                    size_t maxMemoryUsageBytes,
+                    const std::string& tempDir,
+                    const BSONObj& persistedState);
+
+        // Where the sorter spills its runs.
+        const std::string _tempDir;
 
         std::unique_ptr<Sorter> _sorter;
         const IndexAccessMethod* _real;
@@ -259,6 +314,15 @@ public:
      */
     std::unique_ptr<BulkBuilder> initiateBulk(size_t maxMemoryUsageBytes);
 
+    /**
+     * Like initiateBulk(), but with the sorter spilling to 'tempDir', so that the BulkBuilder can
+     * later persist its state. Unless 'persistedState' is empty, the BulkBuilder starts out with
+     * the keys described by it, as returned by BulkBuilder::persistState() for this index.
+     */
+    std::unique_ptr<BulkBuilder> initiateResumableBulk(size_t maxMemoryUsageBytes,
+                                                       const std::string& tempDir,
+                                                       const BSONObj& persistedState);
+
     /**
      * Call this when you are ready to finish your bulk work.
      * Pass in the BulkBuilder returned from initiateBulk.
@@ -390,6 +454,24 @@ private:
      */
     bool shouldCheckIndexKeySize(OperationContext* opCtx);
 
+    /**
+     * Inserts a single key pointing to 'loc', returning an error only if it should fail the write.
+     */
+    Status _insertKey(OperationContext* opCtx,
+                      const BSONObj& key,
+                      const RecordId& loc,
+                      const InsertDeleteOptions& options,
+                      bool checkIndexKeySize);
+
+    /**
+     * Inserts 'keys' into the index, or records them with the index build interceptor when there
+     * is one.
+     */
+    Status _insertKeysOrSideWrite(OperationContext* opCtx,
+                                  const std::vector<BSONObj>& keys,
+                                  const RecordId& loc,
+                                  const InsertDeleteOptions& options);
+
     void removeOneKey(OperationContext* opCtx,
                       const BSONObj& key,
                       const RecordId& loc,
@@ -0,0 +1,165 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kIndex
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/index/index_build_interceptor.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/write_unit_of_work.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+// The fields of a side write.
+constexpr StringData kOpFieldName = "op"_sd;
+constexpr StringData kKeyFieldName = "key"_sd;
+constexpr StringData kRecordIdFieldName = "recordId"_sd;
+
+constexpr StringData kInsertOp = "i"_sd;
+constexpr StringData kDeleteOp = "d"_sd;
+
+// The number of side writes applied per unit of work when draining.
+constexpr int kDrainBatchSize = 1000;
+
+}  // namespace
+
+IndexBuildInterceptor::IndexBuildInterceptor(OperationContext* opCtx)
+    : _sideWritesTable(
+          opCtx->getServiceContext()->getStorageEngine()->makeTemporaryRecordStore(opCtx)) {}
+
+Status IndexBuildInterceptor::sideWrite(OperationContext* opCtx,
+                                        const std::vector<BSONObj>& keys,
+                                        const RecordId& loc,
+                                        Op op) {
+    invariant(opCtx->lockState()->inAWriteUnitOfWork());
+
+    for (const auto& key : keys) {
+        BSONObjBuilder builder;
+        builder.append(kOpFieldName, op == Op::kInsert ? kInsertOp : kDeleteOp);
+        builder.append(kKeyFieldName, key);
+        builder.append(kRecordIdFieldName, static_cast<long long>(loc.repr()));
+        const BSONObj sideWrite = builder.done();
+
+        // The write takes the timestamp of the unit of work it is part of, if any.
+        auto status = _sideWritesTable->rs()->insertRecord(
+            opCtx, sideWrite.objdata(), sideWrite.objsize(), Timestamp());
+        if (!status.isOK()) {
+            return status.getStatus();
+        }
+    }
+
+    _sideWritesCounter.fetchAndAdd(keys.size());
+    return Status::OK();
+}
+
+Status IndexBuildInterceptor::drainWritesIntoIndex(OperationContext* opCtx,
+                                                   IndexAccessMethod* indexAccessMethod,
+                                                   const InsertDeleteOptions& options) {
+    const int64_t appliedAtStart = _numApplied;
+    RecordStore* const rs = _sideWritesTable->rs();
+
+    // Every batch starts over from the oldest side write left, since applied ones are removed.
+    // A side write older than those already applied can only become visible if its unit of work
+    // commits late, in which case no other write to the same document can come before it.
+    while (true) {
+        int batchSize = 0;
+        Status status = writeConflictRetry(opCtx, "index build drain", rs->ns(), [&] {
+            WriteUnitOfWork wunit(opCtx);
+            batchSize = 0;
+
+            std::vector<RecordId> applied;
+            auto cursor = rs->getCursor(opCtx);
+            while (batchSize < kDrainBatchSize) {
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+
+                const BSONObj sideWrite = record->data.releaseToBson();
+                const std::vector<BSONObj> keys{sideWrite[kKeyFieldName].Obj()};
+                const RecordId loc(sideWrite[kRecordIdFieldName].numberLong());
+
+                int64_t numKeys;
+                if (sideWrite[kOpFieldName].valueStringData() == kInsertOp) {
+                    Status status =
+                        indexAccessMethod->insertKeys(opCtx, keys, loc, options, &numKeys);
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                } else {
+                    invariant(sideWrite[kOpFieldName].valueStringData() == kDeleteOp);
+                    indexAccessMethod->removeKeys(opCtx, keys, loc, options, &numKeys);
+                }
+
+                applied.push_back(record->id);
+                batchSize++;
+            }
+
+            for (const auto& id : applied) {
+                rs->deleteRecord(opCtx, id);
+            }
+
+            wunit.commit();
+            return Status::OK();
+        });
+        if (!status.isOK()) {
+            return status;
+        }
+
+        if (batchSize == 0) {
+            break;
+        }
+        _numApplied += batchSize;
+    }
+
+    LOG(1) << "applied " << (_numApplied - appliedAtStart) << " index build side writes, "
+           << _sideWritesCounter.load() << " recorded in total";
+    return Status::OK();
+}
+
+bool IndexBuildInterceptor::areAllWritesApplied(OperationContext* opCtx) const {
+    auto cursor = _sideWritesTable->rs()->getCursor(opCtx);
+    return !cursor->next();
+}
+
+void IndexBuildInterceptor::deleteTemporaryTable(OperationContext* opCtx) {
+    _sideWritesTable->deleteTemporaryTable(opCtx);
+}
+
+}  // namespace mongo
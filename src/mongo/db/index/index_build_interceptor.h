@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/temporary_record_store.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class IndexAccessMethod;
+class OperationContext;
+struct InsertDeleteOptions;
+
+/**
+ * Buffers the writes to an index that is being bulk loaded by a hybrid index build, in a
+ * temporary table, while the build scans the collection without holding the collection lock.
+ *
+ * Each key inserted into or removed from the index is recorded as part of the unit of work of the
+ * write that caused it, in the order the writes happen. Once the bulk load is done, the build
+ * applies them to the index, first while writes continue and last under an exclusive lock.
+ */
+class IndexBuildInterceptor {
+    MONGO_DISALLOW_COPYING(IndexBuildInterceptor);
+
+public:
+    enum class Op { kInsert, kDelete };
+
+    /**
+     * Creates the temporary table for the side writes.
+     */
+    explicit IndexBuildInterceptor(OperationContext* opCtx);
+
+    /**
+     * Records that 'keys' pointing to 'loc' are to be inserted into or removed from the index.
+     * Must be called inside of the WriteUnitOfWork of the write to the collection.
+     */
+    Status sideWrite(OperationContext* opCtx,
+                     const std::vector<BSONObj>& keys,
+                     const RecordId& loc,
+                     Op op);
+
+    /**
+     * Applies the side writes committed so far to 'indexAccessMethod', oldest first, and removes
+     * them from the temporary table. Writes that commit while this runs may be left for the next
+     * call.
+     *
+     * Does not need to be called inside of a WriteUnitOfWork, but can be due to nesting.
+     */
+    Status drainWritesIntoIndex(OperationContext* opCtx,
+                                IndexAccessMethod* indexAccessMethod,
+                                const InsertDeleteOptions& options);
+
+    /**
+     * Returns true if every side write visible to 'opCtx' has been applied.
+     */
+    bool areAllWritesApplied(OperationContext* opCtx) const;
+
+    /**
+     * Drops the temporary table. Must not be called inside of a WriteUnitOfWork.
+     */
+    void deleteTemporaryTable(OperationContext* opCtx);
+
+private:
+    std::unique_ptr<TemporaryRecordStore> _sideWritesTable;
+
+    // The number of keys recorded and applied, for logging.
+    AtomicInt64 _sideWritesCounter{0};
+    int64_t _numApplied = 0;
+};
+
+}  // namespace mongo
@@ -77,8 +77,15 @@ SortKeyGenerator::SortKeyGenerator(const BSONObj& sortSpec, const CollatorInterf
         fixed.push_back(BSONElement());
     }
 
+    // Sorts tend to see the same strings many times, so remember their comparison keys rather than
+    // asking the collator for every document.
+    if (_collator) {
+        _cachingCollator = stdx::make_unique<CollatorInterfaceCaching>(_collator);
+    }
+
     constexpr bool isSparse = false;
-    _indexKeyGen = stdx::make_unique<BtreeKeyGenerator>(fieldNames, fixed, isSparse, _collator);
+    _indexKeyGen =
+        stdx::make_unique<BtreeKeyGenerator>(fieldNames, fixed, isSparse, _cachingCollator.get());
 }
 
 StatusWith<BSONObj> SortKeyGenerator::getSortKey(const BSONObj& obj,
@@ -32,6 +32,7 @@
 #include "mongo/db/index/btree_key_generator.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/collation/collator_interface_caching.h"
 
 namespace mongo {
 
@@ -51,6 +52,9 @@ public:
      * Constructs a sort key generator which will generate keys for sort pattern 'sortSpec'. The
      * keys will incorporate the collation given by 'collator', and thus when actually compared to
      * one another should use the simple collation.
+     *
+     * The comparison keys of strings are cached for the lifetime of the generator, so a generator
+     * must not be shared between threads.
      */
     SortKeyGenerator(const BSONObj& sortSpec, const CollatorInterface* collator);
 
@@ -84,6 +88,10 @@ private:
 
     const CollatorInterface* _collator = nullptr;
 
+    // Caches the comparison keys of '_collator' for the index key generator. Null when sorting
+    // with the simple collation.
+    std::unique_ptr<CollatorInterfaceCaching> _cachingCollator;
+
     // The sort pattern with any $meta sort components stripped out, since the underlying index key
     // generator does not understand $meta sort.
     BSONObj _sortSpecWithoutMeta;
@@ -32,6 +32,7 @@
 
 #include "mongo/db/index_rebuilder.h"
 
+#include <boost/filesystem/operations.hpp>
 #include <list>
 #include <string>
 
@@ -45,6 +46,7 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -81,6 +83,9 @@ void checkNS(OperationContext* opCtx, const std::list<std::string>& nsToCheck) {
 
 
         MultiIndexBlock indexer(opCtx, collection);
+        // Nothing has written to the collection since the interrupted build, so its checkpoint,
+        // if any, is still valid.
+        indexer.allowResumingFromCheckpoint();
 
         {
             WriteUnitOfWork wunit(opCtx);
@@ -159,6 +164,14 @@ void restartInProgressIndexesFromLastShutdown(OperationContext* opCtx) {
             db->getDatabaseCatalogEntry()->getCollectionNamespaces(&collNames);
         }
         checkNS(opCtx, collNames);
+
+        // Any checkpoint left now belongs to an index build that is not going to be retried.
+        if (serverGlobalParams.indexBuildRetry) {
+            boost::system::error_code ec;
+            const std::string checkpointsDir = str::stream()
+                << storageGlobalParams.dbpath << "/" << kIndexBuildCheckpointsDirName;
+            boost::filesystem::remove_all(checkpointsDir, ec);
+        }
     } catch (const DBException& e) {
         error() << "Index verification did not complete: " << redact(e);
         fassertFailedNoTrace(18643);
@@ -53,6 +53,7 @@
 #include "mongo/db/auth/security_key.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_appender.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -212,6 +213,20 @@ void forkServerOrDie() {
 }
 
 MONGO_EXPORT_SERVER_PARAMETER(maxLogSizeKB, int, logger::LogContext::kDefaultMaxLogSizeKB);
+
+// When set, the log file is written from a background thread. See logger::AsyncAppender.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogging, bool, false);
+
+// The memory available for buffering log messages when asyncLogging is set. Messages logged while
+// the buffer is full are dropped, and the number dropped is reported in the log.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLoggingBufferSizeKB, int, 16 * 1024)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue, "asyncLoggingBufferSizeKB must be at least 1");
+        }
+        return Status::OK();
+    });
+
 MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
                           ("GlobalLogManager", "EndStartupOptionHandling", "ForkServer"),
                           ("default"))
@@ -299,9 +314,14 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
-                std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
+        auto fileAppender = std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
+            std::make_unique<MessageEventDetailsEncoder>(), writer.getValue());
+        if (asyncLogging) {
+            manager->getGlobalDomain()->attachAppender(std::make_unique<logger::AsyncAppender>(
+                std::move(fileAppender), static_cast<size_t>(asyncLoggingBufferSizeKB) * 1024));
+        } else {
+            manager->getGlobalDomain()->attachAppender(std::move(fileAppender));
+        }
         manager->getNamedDomain("javascriptOutput")
             ->attachAppender(std::make_unique<RotatableFileAppender<MessageEventEphemeral>>(
                 std::make_unique<MessageEventDetailsEncoder>(), writer.getValue()));
@@ -55,6 +55,15 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(disableLogicalSessionCacheRefresh, bool, f
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(maxSessions, int, 1'000'000);
 
 constexpr Milliseconds LogicalSessionCacheImpl::kLogicalSessionDefaultRefresh;
+constexpr size_t LogicalSessionCacheImpl::kNumPartitions;
+
+namespace {
+
+size_t numWriteBatches(size_t numRecords) {
+    return (numRecords + SessionsCollection::kMaxBatchSize - 1) / SessionsCollection::kMaxBatchSize;
+}
+
+}  // namespace
 
 LogicalSessionCacheImpl::LogicalSessionCacheImpl(
     std::unique_ptr<ServiceLiaison> service,
@@ -70,9 +79,12 @@ LogicalSessionCacheImpl::LogicalSessionCacheImpl(
     _stats.setLastTransactionReaperJobTimestamp(now());
 
     if (!disableLogicalSessionCacheRefresh) {
-        _service->scheduleJob({"LogicalSessionCacheRefresh",
-                               [this](Client* client) { _periodicRefresh(client); },
-                               _refreshInterval});
+        // Each run refreshes one partition, so that every partition is refreshed once per
+        // interval.
+        _service->scheduleJob(
+            {"LogicalSessionCacheRefresh",
+             [this](Client* client) { _periodicRefresh(client); },
+             std::max(Milliseconds(1), _refreshInterval / static_cast<long long>(kNumPartitions))});
         if (_transactionReaper) {
             _service->scheduleJob({"LogicalSessionCacheReap",
                                    [this](Client* client) { _periodicReap(client); },
@@ -92,9 +104,10 @@ LogicalSessionCacheImpl::~LogicalSessionCacheImpl() {
 }
 
 Status LogicalSessionCacheImpl::promote(LogicalSessionId lsid) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    auto it = _activeSessions.find(lsid);
-    if (it == _activeSessions.end()) {
+    auto& partition = _partitionFor(lsid);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.activeSessions.find(lsid);
+    if (it == partition.activeSessions.end()) {
         return {ErrorCodes::NoSuchSession, "no matching session record found in the cache"};
     }
 
@@ -151,7 +164,7 @@ Status LogicalSessionCacheImpl::vivify(OperationContext* opCtx, const LogicalSes
 
 Status LogicalSessionCacheImpl::refreshNow(Client* client) {
     try {
-        _refresh(client);
+        _refresh(client, 0, kNumPartitions);
     } catch (...) {
         return exceptionToStatus();
     }
@@ -167,13 +180,23 @@ Date_t LogicalSessionCacheImpl::now() {
 }
 
 size_t LogicalSessionCacheImpl::size() {
-    stdx::lock_guard<stdx::mutex> lock(_cacheMutex);
-    return _activeSessions.size();
+    return _activeSessionsCount.load();
+}
+
+size_t LogicalSessionCacheImpl::_partitionIndexFor(const LogicalSessionId& lsid) {
+    return LogicalSessionIdHash{}(lsid) % kNumPartitions;
 }
 
 void LogicalSessionCacheImpl::_periodicRefresh(Client* client) {
+    size_t partition;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+        partition = _nextPartitionToRefresh;
+        _nextPartitionToRefresh = (partition + 1) % kNumPartitions;
+    }
+
     try {
-        _refresh(client);
+        _refresh(client, partition, 1);
     } catch (...) {
         log() << "Failed to refresh session cache: " << exceptionToStatus();
     }
@@ -248,7 +271,15 @@ Status LogicalSessionCacheImpl::_reap(Client* client) {
     return Status::OK();
 }
 
-void LogicalSessionCacheImpl::_refresh(Client* client) {
+void LogicalSessionCacheImpl::_refresh(Client* client,
+                                       size_t firstPartition,
+                                       size_t numPartitions) {
+    invariant(firstPartition + numPartitions <= kNumPartitions);
+    const auto isBeingRefreshed = [&](const LogicalSessionId& lsid) {
+        const auto partition = _partitionIndexFor(lsid);
+        return partition >= firstPartition && partition < firstPartition + numPartitions;
+    };
+
     // Stats for serverStatus:
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
@@ -258,6 +289,8 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         _stats.setLastSessionsCollectionJobEntriesRefreshed(0);
         _stats.setLastSessionsCollectionJobEntriesEnded(0);
         _stats.setLastSessionsCollectionJobCursorsClosed(0);
+        _stats.setLastSessionsCollectionJobBatchCount(0);
+        _stats.setLastSessionsCollectionJobPartitionsRefreshed(numPartitions);
 
         // Start the new run.
         _stats.setLastSessionsCollectionJobTimestamp(now());
@@ -269,8 +302,19 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         auto millis = now() - _stats.getLastSessionsCollectionJobTimestamp();
         _stats.setLastSessionsCollectionJobDurationMillis(millis.count());
+        _stats.setSessionsCollectionJobTotalDurationMillis(
+            _stats.getSessionsCollectionJobTotalDurationMillis() + millis.count());
     });
 
+    const auto recordBatches = [this](size_t numRecords) {
+        const auto batches = numWriteBatches(numRecords);
+        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+        _stats.setLastSessionsCollectionJobBatchCount(
+            _stats.getLastSessionsCollectionJobBatchCount() + batches);
+        _stats.setSessionsCollectionJobBatchCount(_stats.getSessionsCollectionJobBatchCount() +
+                                                  batches);
+    };
+
     // get or make an opCtx
     boost::optional<ServiceContext::UniqueOperationContext> uniqueCtx;
     auto* const opCtx = [&client, &uniqueCtx] {
@@ -289,39 +333,47 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
         return;
     }
 
-    LogicalSessionIdSet staleSessions;
     LogicalSessionIdSet explicitlyEndingSessions;
-    LogicalSessionIdMap<LogicalSessionRecord> activeSessions;
-
-    // backSwapper creates a guard that in the case of a exception
-    // replaces the ending or active sessions that swapped out of of LogicalSessionCache,
-    // and merges in any records that had been added since we swapped them
-    // out.
-    auto backSwapper = [this](auto& member, auto& temp) {
-        return MakeGuard([this, &member, &temp] {
-            stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-            using std::swap;
-            swap(member, temp);
-            for (const auto& it : temp) {
-                member.emplace(it);
-            }
-        });
-    };
+    std::vector<LogicalSessionIdMap<LogicalSessionRecord>> activeSessions(numPartitions);
 
     {
         using std::swap;
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         swap(explicitlyEndingSessions, _endingSessions);
-        swap(activeSessions, _activeSessions);
     }
-    auto activeSessionsBackSwapper = backSwapper(_activeSessions, activeSessions);
-    auto explicitlyEndingBackSwaper = backSwapper(_endingSessions, explicitlyEndingSessions);
-
-    // remove all explicitlyEndingSessions from activeSessions
-    for (const auto& lsid : explicitlyEndingSessions) {
-        activeSessions.erase(lsid);
+    for (size_t i = 0; i < numPartitions; ++i) {
+        using std::swap;
+        auto& partition = _partitions[firstPartition + i];
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        _activeSessionsCount.subtractAndFetch(partition.activeSessions.size());
+        swap(activeSessions[i], partition.activeSessions);
     }
 
+    // In the case of an exception, these guards replace the ending or active sessions that were
+    // swapped out of the LogicalSessionCache, and merge in any records that had been added since
+    // we swapped them out.
+    auto activeSessionsBackSwapper = MakeGuard([this, &activeSessions, firstPartition] {
+        for (size_t i = 0; i < activeSessions.size(); ++i) {
+            using std::swap;
+            auto& partition = _partitions[firstPartition + i];
+            stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+            const auto sizeBefore = partition.activeSessions.size();
+            swap(partition.activeSessions, activeSessions[i]);
+            for (const auto& it : activeSessions[i]) {
+                partition.activeSessions.emplace(it);
+            }
+            _activeSessionsCount.addAndFetch(partition.activeSessions.size() - sizeBefore);
+        }
+    });
+    auto explicitlyEndingBackSwaper = MakeGuard([this, &explicitlyEndingSessions] {
+        using std::swap;
+        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+        swap(_endingSessions, explicitlyEndingSessions);
+        for (const auto& it : explicitlyEndingSessions) {
+            _endingSessions.emplace(it);
+        }
+    });
+
     // refresh all recently active sessions as well as for sessions attached to running ops
 
     LogicalSessionRecordSet activeSessionRecords{};
@@ -330,18 +382,25 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
 
     for (const auto& it : runningOpSessions) {
         // if a running op is the cause of an upsert, we won't have a user name for the record
-        if (explicitlyEndingSessions.count(it) > 0) {
+        if (explicitlyEndingSessions.count(it) > 0 || !isBeingRefreshed(it)) {
             continue;
         }
         activeSessionRecords.insert(makeLogicalSessionRecord(it, now()));
     }
-    for (const auto& it : activeSessions) {
-        activeSessionRecords.insert(it.second);
+    for (auto& partitionSessions : activeSessions) {
+        // remove all explicitlyEndingSessions from activeSessions
+        for (const auto& lsid : explicitlyEndingSessions) {
+            partitionSessions.erase(lsid);
+        }
+        for (const auto& it : partitionSessions) {
+            activeSessionRecords.insert(it.second);
+        }
     }
 
     // Refresh the active sessions in the sessions collection.
     uassertStatusOK(_sessionsColl->refreshSessions(opCtx, activeSessionRecords));
     activeSessionsBackSwapper.Dismiss();
+    recordBatches(activeSessionRecords.size());
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         _stats.setLastSessionsCollectionJobEntriesRefreshed(activeSessionRecords.size());
@@ -350,6 +409,7 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     // Remove the ending sessions from the sessions collection.
     uassertStatusOK(_sessionsColl->removeRecords(opCtx, explicitlyEndingSessions));
     explicitlyEndingBackSwaper.Dismiss();
+    recordBatches(explicitlyEndingSessions.size());
     {
         stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
         _stats.setLastSessionsCollectionJobEntriesEnded(explicitlyEndingSessions.size());
@@ -361,12 +421,21 @@ void LogicalSessionCacheImpl::_refresh(Client* client) {
     KillAllSessionsByPatternSet patterns;
 
     auto openCursorSessions = _service->getOpenCursorSessions();
-    // Exclude sessions added to _activeSessions from the openCursorSession to avoid race between
+    // Sessions in the other partitions are checked when their partition is refreshed.
+    for (auto it = openCursorSessions.begin(); it != openCursorSessions.end();) {
+        if (isBeingRefreshed(*it)) {
+            ++it;
+        } else {
+            it = openCursorSessions.erase(it);
+        }
+    }
+    // Exclude sessions added to the cache from the openCursorSession to avoid race between
     // killing cursors on the removed sessions and creating sessions.
-    {
-        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+    for (size_t i = 0; i < numPartitions; ++i) {
+        const auto& partition = _partitions[firstPartition + i];
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
 
-        for (const auto& it : _activeSessions) {
+        for (const auto& it : partition.activeSessions) {
             auto newSessionIt = openCursorSessions.find(it.first);
             if (newSessionIt != openCursorSessions.end()) {
                 openCursorSessions.erase(newSessionIt);
@@ -406,37 +475,45 @@ void LogicalSessionCacheImpl::endSessions(const LogicalSessionIdSet& sessions) {
 
 LogicalSessionCacheStats LogicalSessionCacheImpl::getStats() {
     stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    _stats.setActiveSessionsCount(_activeSessions.size());
+    _stats.setActiveSessionsCount(size());
     return _stats;
 }
 
 Status LogicalSessionCacheImpl::_addToCache(LogicalSessionRecord record) {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    if (_activeSessions.size() >= static_cast<size_t>(maxSessions)) {
+    auto& partition = _partitionFor(record.getId());
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    // Concurrent adds to other partitions may overshoot the limit by a few sessions.
+    if (size() >= static_cast<size_t>(maxSessions)) {
         return {ErrorCodes::TooManyLogicalSessions, "cannot add session into the cache"};
     }
-    _activeSessions.insert(std::make_pair(record.getId(), record));
+    if (partition.activeSessions.insert(std::make_pair(record.getId(), record)).second) {
+        _activeSessionsCount.addAndFetch(1);
+    }
     return Status::OK();
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds() const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    ret.reserve(_activeSessions.size());
-    for (const auto& id : _activeSessions) {
-        ret.push_back(id.first);
+    ret.reserve(_activeSessionsCount.load());
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& id : partition.activeSessions) {
+            ret.push_back(id.first);
+        }
     }
     return ret;
 }
 
 std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
     const std::vector<SHA256Block>& userDigests) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
     std::vector<LogicalSessionId> ret;
-    for (const auto& it : _activeSessions) {
-        if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
-            userDigests.cend()) {
-            ret.push_back(it.first);
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& it : partition.activeSessions) {
+            if (std::find(userDigests.cbegin(), userDigests.cend(), it.first.getUid()) !=
+                userDigests.cend()) {
+                ret.push_back(it.first);
+            }
         }
     }
     return ret;
@@ -444,9 +521,10 @@ std::vector<LogicalSessionId> LogicalSessionCacheImpl::listIds(
 
 boost::optional<LogicalSessionRecord> LogicalSessionCacheImpl::peekCached(
     const LogicalSessionId& id) const {
-    stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
-    const auto it = _activeSessions.find(id);
-    if (it == _activeSessions.end()) {
+    const auto& partition = _partitionFor(id);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    const auto it = partition.activeSessions.find(id);
+    if (it == partition.activeSessions.end()) {
         return boost::none;
     }
     return it->second;
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/db/logical_session_cache.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/refresh_sessions_gen.h"
@@ -57,6 +59,13 @@ class LogicalSessionCacheImpl final : public LogicalSessionCache {
 public:
     static constexpr Milliseconds kLogicalSessionDefaultRefresh = Milliseconds(5 * 60 * 1000);
 
+    /**
+     * The cache is split into this many partitions by session id hash. The periodic refresh writes
+     * one partition at a time, spreading the writes to the sessions collection over the refresh
+     * interval instead of rewriting every record at once.
+     */
+    static constexpr size_t kNumPartitions = 16;
+
     /**
      * An Options type to support the LogicalSessionCacheImpl.
      */
@@ -133,7 +142,12 @@ private:
      * session records contained within the cache.
      */
     void _periodicRefresh(Client* client);
-    void _refresh(Client* client);
+
+    /**
+     * Refreshes the sessions in the partitions [firstPartition, firstPartition + numPartitions) and
+     * removes all explicitly ended sessions.
+     */
+    void _refresh(Client* client, size_t firstPartition, size_t numPartitions);
 
     void _periodicReap(Client* client);
     Status _reap(Client* client);
@@ -148,6 +162,20 @@ private:
      */
     Status _addToCache(LogicalSessionRecord record);
 
+    struct Partition {
+        mutable stdx::mutex mutex;
+        LogicalSessionIdMap<LogicalSessionRecord> activeSessions;
+    };
+
+    static size_t _partitionIndexFor(const LogicalSessionId& lsid);
+
+    Partition& _partitionFor(const LogicalSessionId& lsid) {
+        return _partitions[_partitionIndexFor(lsid)];
+    }
+    const Partition& _partitionFor(const LogicalSessionId& lsid) const {
+        return _partitions[_partitionIndexFor(lsid)];
+    }
+
     const Milliseconds _refreshInterval;
     const Minutes _sessionTimeout;
 
@@ -161,12 +189,19 @@ private:
     mutable stdx::mutex _reaperMutex;
     std::shared_ptr<TransactionReaper> _transactionReaper;
 
-    mutable stdx::mutex _cacheMutex;
+    std::array<Partition, kNumPartitions> _partitions;
 
-    LogicalSessionIdMap<LogicalSessionRecord> _activeSessions;
+    // The number of sessions across all partitions, updated under the lock of the partition that
+    // changed.
+    AtomicInt64 _activeSessionsCount{0};
+
+    // Guards _stats, _endingSessions and _nextPartitionToRefresh.
+    mutable stdx::mutex _cacheMutex;
 
     LogicalSessionIdSet _endingSessions;
 
+    size_t _nextPartitionToRefresh = 0;
+
     Date_t lastRefreshTime;
 };
 
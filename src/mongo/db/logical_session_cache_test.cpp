@@ -246,6 +246,28 @@ TEST_F(LogicalSessionCacheTest, ManySignedLsidsInCacheRefresh) {
     ASSERT(cache()->refreshNow(getClient()).isOK());
 }
 
+// Test that the refresh stats count the partitions and write batches of the last run
+TEST_F(LogicalSessionCacheTest, RefreshReportsBatchCount) {
+    const size_t count = SessionsCollection::kMaxBatchSize * 2 + 1;
+    for (size_t i = 0; i < count; i++) {
+        ASSERT_OK(cache()->startSession(opCtx(), makeLogicalSessionRecordForTest()));
+    }
+    ASSERT_EQ(count, cache()->size());
+
+    clearOpCtx();
+    ASSERT(cache()->refreshNow(getClient()).isOK());
+
+    auto stats = cache()->getStats();
+    ASSERT_EQ(static_cast<int>(count), stats.getLastSessionsCollectionJobEntriesRefreshed());
+    ASSERT_EQ(static_cast<int>(LogicalSessionCacheImpl::kNumPartitions),
+              stats.getLastSessionsCollectionJobPartitionsRefreshed());
+    ASSERT_EQ(3, stats.getLastSessionsCollectionJobBatchCount());
+    ASSERT_EQ(3, stats.getSessionsCollectionJobBatchCount());
+
+    // Refreshed sessions are dropped from the cache until they are used again.
+    ASSERT_EQ(0U, cache()->size());
+}
+
 //
 TEST_F(LogicalSessionCacheTest, RefreshMatrixSessionState) {
     const std::vector<std::vector<std::string>> stateNames = {
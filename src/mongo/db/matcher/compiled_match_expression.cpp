@@ -0,0 +1,269 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <limits>
+
+#include "mongo/db/field_ref.h"
+#include "mongo/db/query/query_knobs.h"
+
+namespace mongo {
+
+namespace {
+
+// Documents are matched against programs with up to this many paths without allocating memory.
+const size_t kInlinePaths = 8;
+
+}  // namespace
+
+const size_t CompiledMatchExpression::kNoParent = std::numeric_limits<size_t>::max();
+
+// static
+std::unique_ptr<CompiledMatchExpression> CompiledMatchExpression::compile(
+    const MatchExpression* root) {
+    if (!root || !internalQueryExecEnableCompiledMatchExpressions.load()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CompiledMatchExpression> compiled(new CompiledMatchExpression());
+    compiled->compileNode(root);
+
+    // A program which only hands the document to 'root' would just add overhead.
+    if (compiled->_program.size() == 1 && compiled->_program[0].op == OpCode::kMatchTree) {
+        return nullptr;
+    }
+
+    return compiled;
+}
+
+void CompiledMatchExpression::compileNode(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+            compileChildren(expr, OpCode::kJumpIfFalse, true);
+            return;
+        case MatchExpression::OR:
+            compileChildren(expr, OpCode::kJumpIfTrue, false);
+            return;
+        case MatchExpression::NOR:
+            compileChildren(expr, OpCode::kJumpIfTrue, false);
+            emit(OpCode::kNegate);
+            return;
+        case MatchExpression::NOT:
+            compileNode(expr->getChild(0));
+            emit(OpCode::kNegate);
+            return;
+        case MatchExpression::ALWAYS_TRUE:
+            emit(OpCode::kPushTrue);
+            return;
+        case MatchExpression::ALWAYS_FALSE:
+            emit(OpCode::kPushFalse);
+            return;
+        default:
+            break;
+    }
+
+    // Leaf and array matching expressions are the PathMatchExpressions. Their matches() is a
+    // final method which feeds the elements found along the path to matchesSingleElement(), and
+    // finds exactly the element at the end of the path if the path crosses no array.
+    const auto category = expr->getCategory();
+    if ((category == MatchExpression::MatchCategory::kLeaf ||
+         category == MatchExpression::MatchCategory::kArrayMatching) &&
+        !expr->path().empty()) {
+        emit(OpCode::kMatchPath, expr, internPath(expr->path()));
+        return;
+    }
+
+    emit(OpCode::kMatchTree, expr);
+}
+
+void CompiledMatchExpression::compileChildren(const MatchExpression* expr,
+                                              OpCode shortCircuit,
+                                              bool valueIfEmpty) {
+    const size_t numChildren = expr->numChildren();
+    if (numChildren == 0) {
+        emit(valueIfEmpty ? OpCode::kPushTrue : OpCode::kPushFalse);
+        return;
+    }
+
+    std::vector<size_t> jumps;
+    for (size_t i = 0; i < numChildren; ++i) {
+        compileNode(expr->getChild(i));
+        if (i + 1 < numChildren) {
+            jumps.push_back(_program.size());
+            emit(shortCircuit);
+        }
+    }
+
+    // The result of the child which short-circuited, or of the last child, is the result of the
+    // whole sequence.
+    for (auto&& jump : jumps) {
+        _program[jump].target = _program.size();
+    }
+}
+
+void CompiledMatchExpression::emit(OpCode op, const MatchExpression* expr, size_t path) {
+    _program.push_back({op, expr, path, 0});
+}
+
+size_t CompiledMatchExpression::internPath(StringData dottedPath) {
+    FieldRef fieldRef(dottedPath);
+
+    size_t parent = kNoParent;
+    for (size_t part = 0; part < fieldRef.numParts(); ++part) {
+        const StringData fieldName = fieldRef.getPart(part);
+
+        size_t pathIdx = kNoParent;
+        for (size_t i = 0; i < _paths.size(); ++i) {
+            if (_paths[i].parent == parent && _paths[i].fieldName == fieldName) {
+                pathIdx = i;
+                break;
+            }
+        }
+
+        if (pathIdx == kNoParent) {
+            pathIdx = _paths.size();
+            _paths.push_back({parent, fieldName.toString()});
+            if (parent == kNoParent) {
+                _topLevelPaths.push_back(pathIdx);
+            }
+        }
+
+        parent = pathIdx;
+    }
+
+    invariant(parent != kNoParent);
+    return parent;
+}
+
+void CompiledMatchExpression::resolvePath(const BSONObj& doc,
+                                          size_t pathIdx,
+                                          ResolvedPath* resolved) const {
+    if (resolved[pathIdx].state != ResolvedPath::State::kUnresolved) {
+        return;
+    }
+
+    const Path& path = _paths[pathIdx];
+    if (path.parent == kNoParent) {
+        // Look up every top-level field the program may need in a single pass over the document.
+        // Like BSONObj::getField(), the first of several fields with the same name wins.
+        for (auto&& topLevelIdx : _topLevelPaths) {
+            resolved[topLevelIdx].state = ResolvedPath::State::kResolved;
+        }
+
+        size_t numRemaining = _topLevelPaths.size();
+        BSONObjIterator it(doc);
+        while (numRemaining > 0 && it.more()) {
+            const BSONElement elem = it.next();
+            const StringData fieldName = elem.fieldNameStringData();
+            for (auto&& topLevelIdx : _topLevelPaths) {
+                if (resolved[topLevelIdx].element.eoo() &&
+                    fieldName == _paths[topLevelIdx].fieldName) {
+                    resolved[topLevelIdx].element = elem;
+                    --numRemaining;
+                    break;
+                }
+            }
+        }
+        return;
+    }
+
+    resolvePath(doc, path.parent, resolved);
+    const ResolvedPath& parent = resolved[path.parent];
+    if (parent.state == ResolvedPath::State::kCrossesArray || parent.element.type() == Array) {
+        resolved[pathIdx].state = ResolvedPath::State::kCrossesArray;
+        return;
+    }
+
+    resolved[pathIdx].state = ResolvedPath::State::kResolved;
+    if (parent.element.type() == Object) {
+        resolved[pathIdx].element = parent.element.embeddedObject().getField(path.fieldName);
+    }
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+    ResolvedPath inlinePaths[kInlinePaths];
+    std::unique_ptr<ResolvedPath[]> allocatedPaths;
+    ResolvedPath* resolved = inlinePaths;
+    if (_paths.size() > kInlinePaths) {
+        allocatedPaths.reset(new ResolvedPath[_paths.size()]);
+        resolved = allocatedPaths.get();
+    }
+
+    bool result = true;
+    size_t pc = 0;
+    while (pc < _program.size()) {
+        const Instruction& instruction = _program[pc];
+        switch (instruction.op) {
+            case OpCode::kPushTrue:
+                result = true;
+                break;
+            case OpCode::kPushFalse:
+                result = false;
+                break;
+            case OpCode::kMatchPath: {
+                resolvePath(doc, instruction.path, resolved);
+                const ResolvedPath& path = resolved[instruction.path];
+                if (path.state == ResolvedPath::State::kCrossesArray ||
+                    path.element.type() == Array) {
+                    // Arrays are traversed by the leaf itself.
+                    result = instruction.expr->matchesBSON(doc);
+                } else {
+                    result = instruction.expr->matchesSingleElement(path.element);
+                }
+                break;
+            }
+            case OpCode::kMatchTree:
+                result = instruction.expr->matchesBSON(doc);
+                break;
+            case OpCode::kNegate:
+                result = !result;
+                break;
+            case OpCode::kJumpIfTrue:
+                if (result) {
+                    pc = instruction.target;
+                    continue;
+                }
+                break;
+            case OpCode::kJumpIfFalse:
+                if (!result) {
+                    pc = instruction.target;
+                    continue;
+                }
+                break;
+        }
+        ++pc;
+    }
+
+    return result;
+}
+
+}  // namespace mongo
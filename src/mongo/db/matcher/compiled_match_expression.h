@@ -0,0 +1,165 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+/**
+ * A MatchExpression flattened into a linear program, for evaluating the same filter against many
+ * documents.
+ *
+ * Logical nodes become conditional jumps, so evaluation short-circuits without recursing through
+ * the tree. Leaves which operate on a field path ($eq, $lt, $in, $exists, $elemMatch, ...) read
+ * their element from a table of paths which is shared by all of the leaves. The table is filled
+ * lazily for each document: all of the top-level fields the program needs are found in a single
+ * pass over the document, and each dotted path is resolved at most once, starting from the
+ * already resolved parent path. As long as a path crosses no arrays, the leaf is then evaluated
+ * directly against the resolved element with matchesSingleElement(). Otherwise, as for any other
+ * kind of node, the program falls back to the leaf's own matches(), which gives the exact array
+ * traversal semantics of the tree walker.
+ *
+ * The program points into the MatchExpression it was compiled from, which must outlive it and
+ * must not be modified while it is in use.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    /**
+     * Compiles 'root'. Returns nullptr if 'root' is null, if compiled evaluation is disabled by
+     * 'internalQueryExecEnableCompiledMatchExpressions', or if no part of 'root' can be evaluated
+     * faster than by 'root' itself.
+     */
+    static std::unique_ptr<CompiledMatchExpression> compile(const MatchExpression* root);
+
+    /**
+     * Returns whether 'doc' matches the MatchExpression this program was compiled from. Equivalent
+     * to calling matchesBSON() on that MatchExpression without MatchDetails.
+     */
+    bool matchesBSON(const BSONObj& doc) const;
+
+    /**
+     * Returns the number of instructions in the program. Exposed for testing.
+     */
+    size_t numInstructions() const {
+        return _program.size();
+    }
+
+    /**
+     * Returns the number of distinct paths, including prefixes of dotted paths, which the program
+     * resolves. Exposed for testing.
+     */
+    size_t numPaths() const {
+        return _paths.size();
+    }
+
+private:
+    enum class OpCode {
+        // Sets the result register to a constant.
+        kPushTrue,
+        kPushFalse,
+
+        // Sets the result register to whether the leaf 'expr' matches the element at 'path'.
+        kMatchPath,
+
+        // Sets the result register to whether the subtree 'expr' matches the document.
+        kMatchTree,
+
+        // Negates the result register.
+        kNegate,
+
+        // Continue at instruction 'target' if the result register is true or false respectively.
+        kJumpIfTrue,
+        kJumpIfFalse,
+    };
+
+    struct Instruction {
+        OpCode op;
+        const MatchExpression* expr;
+        size_t path;
+        size_t target;
+    };
+
+    struct Path {
+        // Index of the path this one extends by one field, or kNoParent for top-level fields.
+        size_t parent;
+
+        // The last field of the path.
+        std::string fieldName;
+    };
+
+    // The lookup state of one path for the document being matched.
+    struct ResolvedPath {
+        enum class State { kUnresolved, kResolved, kCrossesArray };
+
+        State state = State::kUnresolved;
+        BSONElement element;
+    };
+
+    static const size_t kNoParent;
+
+    CompiledMatchExpression() = default;
+
+    void compileNode(const MatchExpression* expr);
+
+    /**
+     * Emits the children of logical node 'expr', joined by jumps to the end of the sequence with
+     * opcode 'shortCircuit'. An empty sequence evaluates to 'valueIfEmpty'.
+     */
+    void compileChildren(const MatchExpression* expr, OpCode shortCircuit, bool valueIfEmpty);
+
+    void emit(OpCode op, const MatchExpression* expr = nullptr, size_t path = 0);
+
+    /**
+     * Returns the index of the path 'dottedPath' in '_paths', adding it and its prefixes as needed.
+     */
+    size_t internPath(StringData dottedPath);
+
+    void resolvePath(const BSONObj& doc, size_t pathIdx, ResolvedPath* resolved) const;
+
+    std::vector<Instruction> _program;
+
+    // Every path, along with every prefix of a dotted path, appears exactly once. A path always
+    // comes after its parent.
+    std::vector<Path> _paths;
+
+    // Indexes into '_paths' of the top-level fields.
+    std::vector<size_t> _topLevelPaths;
+};
+
+}  // namespace mongo
@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+
+namespace mongo {
+
+namespace {
+
+const char* const kFilters[] = {
+    // A single equality on a top-level field.
+    "{status: 'active'}",
+    // A conjunction of top-level and dotted paths which share a prefix.
+    "{status: 'active', 'address.city': 'Paris', 'address.zip': {$gt: 75000}, age: {$gte: 21}}",
+    // A disjunction which is usually decided by its last branch.
+    "{$or: [{age: {$lt: 18}}, {'address.city': 'Lyon'}, {tags: 'vip'}]}",
+};
+
+BSONObj makeDocument() {
+    return fromjson(
+        "{_id: 1, name: 'Jane', status: 'active', age: 34, score: 87.5, "
+        "address: {street: '10 rue de Rivoli', city: 'Paris', zip: 75004, country: 'FR'}, "
+        "tags: ['new', 'vip'], created: {$date: 0}, visits: 17, notes: 'none'}");
+}
+
+std::unique_ptr<MatchExpression> parseFilter(int filterIdx) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    return uassertStatusOK(MatchExpressionParser::parse(fromjson(kFilters[filterIdx]), expCtx));
+}
+
+void BM_TreeWalker(benchmark::State& state) {
+    const BSONObj doc = makeDocument();
+    const auto expr = parseFilter(state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(expr->matchesBSON(doc));
+    }
+}
+
+void BM_Compiled(benchmark::State& state) {
+    const BSONObj doc = makeDocument();
+    const auto expr = parseFilter(state.range(0));
+    const auto compiled = CompiledMatchExpression::compile(expr.get());
+    invariant(compiled);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(compiled->matchesBSON(doc));
+    }
+}
+
+BENCHMARK(BM_TreeWalker)->DenseRange(0, 2);
+BENCHMARK(BM_Compiled)->DenseRange(0, 2);
+
+}  // namespace
+
+}  // namespace mongo
@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    StatusWithMatchExpression result = MatchExpressionParser::parse(
+        filter, expCtx, ExtensionsCallbackNoop(), MatchExpressionParser::kAllowAllSpecialFeatures);
+    ASSERT_OK(result.getStatus());
+    return std::move(result.getValue());
+}
+
+/**
+ * Asserts that the compiled form of 'filter' agrees with the tree walker on every document in
+ * 'docs'.
+ */
+void assertMatchesLikeTree(const char* filter, const std::vector<const char*>& docs) {
+    auto expr = parse(fromjson(filter));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled) << filter;
+
+    for (auto&& docStr : docs) {
+        const BSONObj doc = fromjson(docStr);
+        ASSERT_EQ(expr->matchesBSON(doc), compiled->matchesBSON(doc)) << filter << " on " << doc;
+    }
+}
+
+const std::vector<const char*> kDocs = {
+    "{}",
+    "{a: 1}",
+    "{a: 5, b: 'x'}",
+    "{a: null}",
+    "{a: [1, 5, 9]}",
+    "{a: []}",
+    "{a: {b: 1}}",
+    "{a: {b: [1, 2]}}",
+    "{a: [{b: 1}, {b: 3}]}",
+    "{a: {b: {c: 4}}, d: 2}",
+    "{a: 3, a: 7}",
+    "{b: 1, a: {b: 2, c: 'y'}}",
+    "{a: 'abc', b: {c: null}}",
+    "{a: {0: 5}}",
+    "{a: [[1], 2]}",
+};
+
+TEST(CompiledMatchExpressionTest, ComparisonsMatchLikeTree) {
+    assertMatchesLikeTree("{a: 1}", kDocs);
+    assertMatchesLikeTree("{a: {$gt: 2}}", kDocs);
+    assertMatchesLikeTree("{a: {$lte: 5}}", kDocs);
+    assertMatchesLikeTree("{a: null}", kDocs);
+    assertMatchesLikeTree("{'a.b': 1}", kDocs);
+    assertMatchesLikeTree("{'a.b.c': {$gte: 4}}", kDocs);
+    assertMatchesLikeTree("{'a.0': 5}", kDocs);
+    assertMatchesLikeTree("{'b.c': null}", kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, OtherLeavesMatchLikeTree) {
+    assertMatchesLikeTree("{a: {$exists: true}}", kDocs);
+    assertMatchesLikeTree("{'a.b': {$exists: false}}", kDocs);
+    assertMatchesLikeTree("{a: {$in: [1, 9, null]}}", kDocs);
+    assertMatchesLikeTree("{a: {$type: 'array'}}", kDocs);
+    assertMatchesLikeTree("{a: {$size: 0}}", kDocs);
+    assertMatchesLikeTree("{a: {$elemMatch: {$gt: 4}}}", kDocs);
+    assertMatchesLikeTree("{a: {$elemMatch: {b: 3}}}", kDocs);
+    assertMatchesLikeTree("{a: /^ab/}", kDocs);
+    assertMatchesLikeTree("{a: {$mod: [2, 1]}}", kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, LogicalNodesMatchLikeTree) {
+    assertMatchesLikeTree("{a: {$gt: 0}, b: 'x'}", kDocs);
+    assertMatchesLikeTree("{$or: [{a: 1}, {'a.b': 2}, {d: 2}]}", kDocs);
+    assertMatchesLikeTree("{$nor: [{a: 1}, {b: 'x'}]}", kDocs);
+    assertMatchesLikeTree("{a: {$not: {$gt: 2}}}", kDocs);
+    assertMatchesLikeTree("{$and: [{$or: [{a: 5}, {a: 3}]}, {$nor: [{b: 1}]}]}", kDocs);
+    assertMatchesLikeTree("{$or: [{'a.b': {$exists: true}}, {$alwaysFalse: 1}]}", kDocs);
+    assertMatchesLikeTree("{$and: [{$alwaysTrue: 1}, {'a.c': 'y'}]}", kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, SubtreesWhichCannotBeCompiledAreEvaluatedByTheTree) {
+    assertMatchesLikeTree("{a: 1, $expr: {$eq: ['$d', 2]}}", kDocs);
+    assertMatchesLikeTree("{$or: [{$expr: {$eq: ['$a', 1]}}, {'a.b.c': 4}]}", kDocs);
+}
+
+TEST(CompiledMatchExpressionTest, SharesPathsAndPrefixesBetweenLeaves) {
+    auto expr = parse(fromjson("{'a.b': 1, 'a.c': 2, a: {$exists: true}, d: 3}"));
+    auto compiled = CompiledMatchExpression::compile(expr.get());
+    ASSERT(compiled);
+
+    // The paths are 'a', 'a.b', 'a.c' and 'd'.
+    ASSERT_EQ(compiled->numPaths(), 4U);
+
+    // Four leaves joined by three short-circuit jumps.
+    ASSERT_EQ(compiled->numInstructions(), 7U);
+}
+
+TEST(CompiledMatchExpressionTest, DoesNotCompileWhenNothingCanBeCompiled) {
+    auto expr = parse(fromjson("{$expr: {$eq: ['$a', 1]}}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(expr.get()));
+    ASSERT_FALSE(CompiledMatchExpression::compile(nullptr));
+}
+
+TEST(CompiledMatchExpressionTest, DoesNotCompileWhenDisabled) {
+    internalQueryExecEnableCompiledMatchExpressions.store(false);
+    ON_BLOCK_EXIT([] { internalQueryExecEnableCompiledMatchExpressions.store(true); });
+
+    auto expr = parse(fromjson("{a: 1}"));
+    ASSERT_FALSE(CompiledMatchExpression::compile(expr.get()));
+}
+
+TEST(CompiledMatchExpressionTest, MatchesWithMorePathsThanFitInline) {
+    assertMatchesLikeTree(
+        "{a: 1, b: 2, c: 3, d: 4, e: 5, f: 6, g: 7, h: 8, i: 9, j: 10}",
+        {"{}",
+         "{a: 1, b: 2, c: 3, d: 4, e: 5, f: 6, g: 7, h: 8, i: 9, j: 10}",
+         "{j: 10, i: 9, h: 8, g: 7, f: 6, e: 5, d: 4, c: 3, b: 2, a: 1}",
+         "{a: 1, b: 2, c: 3, d: 4, e: 5, f: 6, g: 7, h: 8, i: 9, j: 11}"});
+}
+
+}  // namespace
+
+}  // namespace mongo
@@ -30,7 +30,9 @@
 
 #include "mongo/db/matcher/expression_leaf.h"
 
+#include <boost/optional.hpp>
 #include <cmath>
+#include <limits>
 #include <pcrecpp.h>
 
 #include "mongo/bson/bsonelement_comparator.h"
@@ -42,6 +44,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/path.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -394,6 +397,7 @@ std::unique_ptr<MatchExpression> InMatchExpression::shallowClone() const {
     next->_hasEmptyArray = _hasEmptyArray;
     next->_equalitySet = _equalitySet;
     next->_originalEqualityVector = _originalEqualityVector;
+    next->_hashedEqualities = _hashedEqualities;
     for (auto&& regex : _regexes) {
         std::unique_ptr<RegexMatchExpression> clonedRegex(
             static_cast<RegexMatchExpression*>(regex->shallowClone().release()));
@@ -406,7 +410,15 @@ bool InMatchExpression::matchesSingleElement(const BSONElement& e, MatchDetails*
     if (_hasNull && e.eoo()) {
         return true;
     }
-    if (_equalitySet.find(e) != _equalitySet.end()) {
+    if (_hashedEqualities) {
+        bool needsFallback = false;
+        if (_hashedEqualities->contains(e, &needsFallback)) {
+            return true;
+        }
+        if (needsFallback && _equalitySet.find(e) != _equalitySet.end()) {
+            return true;
+        }
+    } else if (_equalitySet.find(e) != _equalitySet.end()) {
         return true;
     }
     for (auto&& regex : _regexes) {
@@ -507,6 +519,7 @@ void InMatchExpression::_doSetCollator(const CollatorInterface* collator) {
 
     // We need to re-compute '_equalitySet', since our set comparator has changed.
     _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    buildHashedEqualities();
 }
 
 Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
@@ -536,10 +549,202 @@ Status InMatchExpression::setEqualities(std::vector<BSONElement> equalities) {
     }
 
     _equalitySet = _eltCmp.makeBSONEltFlatSet(_originalEqualityVector);
+    buildHashedEqualities();
 
     return Status::OK();
 }
 
+void InMatchExpression::buildHashedEqualities() {
+    _hashedEqualities.reset();
+
+    const auto minSize = internalQueryMinInListSizeForHashedLookup.load();
+    if (minSize <= 0 || _equalitySet.size() < static_cast<size_t>(minSize)) {
+        return;
+    }
+
+    // Build from the deduplicated set so that the table holds each key once.
+    std::vector<BSONElement> distinct(_equalitySet.begin(), _equalitySet.end());
+    _hashedEqualities = HashedEqualitySet::make(distinct, _collator);
+}
+
+namespace {
+
+// Finalizer from MurmurHash3, used to spread the bits of integer keys over the table.
+uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+// FNV-1a over the bytes of 'key', followed by the integer finalizer.
+uint64_t hashBytes(StringData key) {
+    uint64_t h = 0xcbf29ce484222325ULL;
+    for (char c : key) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 0x100000001b3ULL;
+    }
+    return mixHash(h);
+}
+
+/**
+ * Returns the value of 'd' as a long long if it is an integer exactly representable as one.
+ */
+boost::optional<long long> doubleToExactInt64(double d) {
+    // 2^63 is exactly representable as a double, while 2^63 - 1 is not.
+    if (!(d >= -9223372036854775808.0 && d < 9223372036854775808.0) || std::trunc(d) != d) {
+        return boost::none;
+    }
+    return static_cast<long long>(d);
+}
+
+StringData objectIdBytes(const BSONElement& elem) {
+    return StringData(elem.value(), OID::kOIDSize);
+}
+
+}  // namespace
+
+std::unique_ptr<InMatchExpression::HashedEqualitySet> InMatchExpression::HashedEqualitySet::make(
+    const std::vector<BSONElement>& equalities, const CollatorInterface* collator) {
+    if (equalities.empty() || equalities.size() >= std::numeric_limits<uint32_t>::max() / 2) {
+        return nullptr;
+    }
+
+    KeyKind kind;
+    switch (equalities.front().type()) {
+        case BSONType::NumberInt:
+        case BSONType::NumberLong:
+            kind = KeyKind::kInt64;
+            break;
+        case BSONType::jstOID:
+            kind = KeyKind::kObjectId;
+            break;
+        case BSONType::String:
+            if (collator) {
+                return nullptr;
+            }
+            kind = KeyKind::kString;
+            break;
+        default:
+            return nullptr;
+    }
+
+    for (auto&& elem : equalities) {
+        const auto type = elem.type();
+        const bool sameKind = (kind == KeyKind::kInt64 &&
+                               (type == BSONType::NumberInt || type == BSONType::NumberLong)) ||
+            (kind == KeyKind::kObjectId && type == BSONType::jstOID) ||
+            (kind == KeyKind::kString && type == BSONType::String);
+        if (!sameKind) {
+            return nullptr;
+        }
+    }
+
+    std::unique_ptr<HashedEqualitySet> set(new HashedEqualitySet(kind));
+    set->allocateSlots(equalities.size());
+    for (auto&& elem : equalities) {
+        switch (kind) {
+            case KeyKind::kInt64:
+                set->insertInt64(elem.safeNumberLong());
+                break;
+            case KeyKind::kObjectId:
+                set->insertBytes(objectIdBytes(elem));
+                break;
+            case KeyKind::kString:
+                set->insertBytes(elem.valueStringData());
+                break;
+        }
+    }
+    return set;
+}
+
+void InMatchExpression::HashedEqualitySet::allocateSlots(size_t numKeys) {
+    size_t numSlots = 16;
+    while (numSlots < 2 * numKeys) {
+        numSlots *= 2;
+    }
+    _slots.assign(numSlots, 0);
+    _slotMask = numSlots - 1;
+}
+
+void InMatchExpression::HashedEqualitySet::insertInt64(long long key) {
+    if (containsInt64(key)) {
+        return;
+    }
+    _intKeys.push_back(key);
+    for (size_t i = mixHash(static_cast<uint64_t>(key)) & _slotMask;; i = (i + 1) & _slotMask) {
+        if (!_slots[i]) {
+            _slots[i] = _intKeys.size();
+            return;
+        }
+    }
+}
+
+void InMatchExpression::HashedEqualitySet::insertBytes(StringData key) {
+    if (containsBytes(key)) {
+        return;
+    }
+    _byteKeys.push_back(key);
+    for (size_t i = hashBytes(key) & _slotMask;; i = (i + 1) & _slotMask) {
+        if (!_slots[i]) {
+            _slots[i] = _byteKeys.size();
+            return;
+        }
+    }
+}
+
+bool InMatchExpression::HashedEqualitySet::containsInt64(long long key) const {
+    // The table is never more than half full, so every probe sequence reaches an empty slot.
+    for (size_t i = mixHash(static_cast<uint64_t>(key)) & _slotMask; _slots[i];
+         i = (i + 1) & _slotMask) {
+        if (_intKeys[_slots[i] - 1] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool InMatchExpression::HashedEqualitySet::containsBytes(StringData key) const {
+    for (size_t i = hashBytes(key) & _slotMask; _slots[i]; i = (i + 1) & _slotMask) {
+        if (_byteKeys[_slots[i] - 1] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool InMatchExpression::HashedEqualitySet::contains(const BSONElement& elem,
+                                                    bool* needsFallback) const {
+    switch (_kind) {
+        case KeyKind::kInt64:
+            // Numbers of all types compare equal by value, so an int or long in the set may match
+            // an integral double. Decimals are rare enough to defer to the comparator.
+            switch (elem.type()) {
+                case BSONType::NumberInt:
+                case BSONType::NumberLong:
+                    return containsInt64(elem.safeNumberLong());
+                case BSONType::NumberDouble: {
+                    auto asInt = doubleToExactInt64(elem._numberDouble());
+                    return asInt && containsInt64(*asInt);
+                }
+                case BSONType::NumberDecimal:
+                    *needsFallback = true;
+                    return false;
+                default:
+                    return false;
+            }
+        case KeyKind::kObjectId:
+            return elem.type() == BSONType::jstOID && containsBytes(objectIdBytes(elem));
+        case KeyKind::kString:
+            // Symbols compare equal to strings with the same contents.
+            return (elem.type() == BSONType::String || elem.type() == BSONType::Symbol) &&
+                containsBytes(elem.valueStringData());
+    }
+    MONGO_UNREACHABLE;
+}
+
 Status InMatchExpression::addRegex(std::unique_ptr<RegexMatchExpression> expr) {
     _regexes.push_back(std::move(expr));
     return Status::OK();
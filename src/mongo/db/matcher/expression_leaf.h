@@ -440,7 +440,66 @@ public:
         return _hasEmptyArray;
     }
 
+    /**
+     * Returns true if equality lookups are answered by a hash table specialized for the type of
+     * the equalities rather than by a search of '_equalitySet'. Exposed for testing.
+     */
+    bool usesHashedEqualityLookup() const {
+        return static_cast<bool>(_hashedEqualities);
+    }
+
 private:
+    /**
+     * Open-addressing hash set used for large $in lists whose equalities are all of a single
+     * "simple" kind: integral numbers (NumberInt or NumberLong), ObjectIds, or strings compared
+     * without a collator. It answers exactly the same question as '_equalitySet.find()' for such
+     * lists, but without the O(log n) BSONElement comparisons.
+     */
+    class HashedEqualitySet {
+    public:
+        /**
+         * Returns a set containing 'equalities', or nullptr if the equalities are not homogeneous
+         * in one of the supported kinds or if 'collator' is non-null and they are strings.
+         */
+        static std::unique_ptr<HashedEqualitySet> make(const std::vector<BSONElement>& equalities,
+                                                       const CollatorInterface* collator);
+
+        /**
+         * Returns true if 'elem' compares equal to one of the equalities in this set. If the answer
+         * cannot be computed from the hash table, sets '*needsFallback' to true; the caller must
+         * then consult '_equalitySet'.
+         */
+        bool contains(const BSONElement& elem, bool* needsFallback) const;
+
+    private:
+        enum class KeyKind { kInt64, kObjectId, kString };
+
+        explicit HashedEqualitySet(KeyKind kind) : _kind(kind) {}
+
+        void insertInt64(long long key);
+        void insertBytes(StringData key);
+        bool containsInt64(long long key) const;
+        bool containsBytes(StringData key) const;
+        void allocateSlots(size_t numKeys);
+
+        const KeyKind _kind;
+
+        // Each slot holds 1 + the position of its key in '_intKeys' or '_byteKeys', or 0 if the
+        // slot is empty. The number of slots is a power of two at least twice the number of keys.
+        std::vector<uint32_t> _slots;
+        size_t _slotMask = 0;
+
+        std::vector<long long> _intKeys;
+
+        // Points into the BSONElements in '_originalEqualityVector', which are owned by the caller.
+        std::vector<StringData> _byteKeys;
+    };
+
+    /**
+     * Rebuilds '_hashedEqualities' from '_originalEqualityVector' and '_collator'.
+     */
+    void buildHashedEqualities();
+
     ExpressionOptimizerFunc getOptimizer() const final;
 
     // Whether or not '_equalities' has a jstNULL element in it.
@@ -469,6 +528,10 @@ private:
     // for this set.
     BSONEltFlatSet _equalitySet;
 
+    // Hash table over the same equalities as '_equalitySet', or nullptr if the list is too small or
+    // not homogeneous enough to benefit. Immutable once built, so it is shared between clones.
+    std::shared_ptr<const HashedEqualitySet> _hashedEqualities;
+
     // Container of regex elements this object owns.
     std::vector<std::unique_ptr<RegexMatchExpression>> _regexes;
 };
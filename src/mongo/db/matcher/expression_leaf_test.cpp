@@ -1350,6 +1350,142 @@ TEST(InMatchExpression, ChangingCollationAfterAddingEqualitiesPreservesEqualitie
     ASSERT(in.getEqualities().count(obj2.firstElement()));
 }
 
+BSONArray makeIntRange(int n) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < n; ++i) {
+        if (i % 2) {
+            bab.append(static_cast<long long>(i));
+        } else {
+            bab.append(i);
+        }
+    }
+    return bab.arr();
+}
+
+TEST(InMatchExpression, LargeIntegralListUsesHashedLookup) {
+    BSONArray operand = makeIntRange(100);
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(in.usesHashedEqualityLookup());
+
+    ASSERT(in.matchesSingleElement(BSON("" << 0).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << 99LL).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << 42.0).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << Decimal128(17)).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << 100).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << -1LL).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << 42.5).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << std::nan("")).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON(""
+                                         << "42")
+                                        .firstElement()));
+}
+
+TEST(InMatchExpression, HashedLookupHandlesInt64Extremes) {
+    BSONArrayBuilder bab;
+    bab.append(std::numeric_limits<long long>::max());
+    bab.append(std::numeric_limits<long long>::min());
+    for (int i = 0; i < 30; ++i) {
+        bab.append(i);
+    }
+    BSONArray operand = bab.arr();
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(in.usesHashedEqualityLookup());
+
+    ASSERT(in.matchesSingleElement(
+        BSON("" << std::numeric_limits<long long>::min()).firstElement()));
+    ASSERT(in.matchesSingleElement(
+        BSON("" << static_cast<double>(std::numeric_limits<long long>::min())).firstElement()));
+    // 2^63 is the closest double to the maximum long long, but is not equal to it.
+    ASSERT(!in.matchesSingleElement(
+        BSON("" << static_cast<double>(std::numeric_limits<long long>::max())).firstElement()));
+}
+
+TEST(InMatchExpression, LargeStringListUsesHashedLookupOnlyWithoutCollator) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 50; ++i) {
+        bab.append("str" + std::to_string(i));
+    }
+    BSONArray operand = bab.arr();
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(in.usesHashedEqualityLookup());
+
+    ASSERT(in.matchesSingleElement(BSON(""
+                                        << "str7")
+                                       .firstElement()));
+    BSONObjBuilder symbolBob;
+    symbolBob.appendSymbol("", "str49");
+    ASSERT(in.matchesSingleElement(symbolBob.obj().firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON(""
+                                         << "str50")
+                                        .firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << 7).firstElement()));
+
+    auto clone = in.shallowClone();
+    ASSERT(static_cast<InMatchExpression*>(clone.get())->usesHashedEqualityLookup());
+    ASSERT(clone->matchesSingleElement(BSON(""
+                                            << "str7")
+                                           .firstElement()));
+
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    in.setCollator(&collator);
+    ASSERT(!in.usesHashedEqualityLookup());
+    ASSERT(in.matchesSingleElement(BSON(""
+                                        << "STR7")
+                                       .firstElement()));
+}
+
+TEST(InMatchExpression, LargeObjectIdListUsesHashedLookup) {
+    std::vector<OID> oids;
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 40; ++i) {
+        oids.push_back(OID::gen());
+        bab.append(oids.back());
+    }
+    BSONArray operand = bab.arr();
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(in.usesHashedEqualityLookup());
+
+    ASSERT(in.matchesSingleElement(BSON("" << oids[13]).firstElement()));
+    ASSERT(!in.matchesSingleElement(BSON("" << OID::gen()).firstElement()));
+}
+
+TEST(InMatchExpression, MixedTypeListDoesNotUseHashedLookup) {
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 40; ++i) {
+        bab.append(i);
+    }
+    bab.append(2.5);
+    BSONArray operand = bab.arr();
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(!in.usesHashedEqualityLookup());
+    ASSERT(in.matchesSingleElement(BSON("" << 2.5).firstElement()));
+    ASSERT(in.matchesSingleElement(BSON("" << 39).firstElement()));
+}
+
+TEST(InMatchExpression, SmallListDoesNotUseHashedLookup) {
+    BSONArray operand = makeIntRange(4);
+    InMatchExpression in("");
+    std::vector<BSONElement> equalities;
+    operand.elems(equalities);
+    ASSERT_OK(in.setEqualities(std::move(equalities)));
+    ASSERT(!in.usesHashedEqualityLookup());
+}
+
 std::vector<uint32_t> bsonArrayToBitPositions(const BSONArray& ba) {
     std::vector<uint32_t> bitPositions;
 
@@ -30,6 +30,8 @@
 
 #include "mongo/db/op_observer_impl.h"
 
+#include <limits>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
@@ -51,6 +53,7 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/transaction_participant.h"
 #include "mongo/db/views/durable_view_catalog.h"
@@ -64,6 +67,20 @@ namespace {
 
 MONGO_FAIL_POINT_DEFINE(failCollectionUpdates);
 
+// The largest total size of the operations packed into a single 'applyOps' oplog entry of an
+// unprepared transaction. Transactions whose operations exceed it are written as a chain of
+// 'applyOps' entries linked by their prevOpTime, so they are not bounded by the BSON size limit.
+MONGO_EXPORT_SERVER_PARAMETER(maxSizeOfTransactionOplogEntryBytes, int, 8 * 1024 * 1024)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > BSONObjMaxUserSize) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "maxSizeOfTransactionOplogEntryBytes must be between 1 "
+                                           "and "
+                                        << BSONObjMaxUserSize);
+        }
+        return Status::OK();
+    });
+
 const auto documentKeyDecoration = OperationContext::declareDecoration<BSONObj>();
 
 repl::OpTime logOperation(OperationContext* opCtx,
@@ -917,17 +934,44 @@ void OpObserverImpl::onEmptyCapped(OperationContext* opCtx,
 
 namespace {
 
+/**
+ * Splits the operations of a transaction, in order, into arrays whose total BSON size stays under
+ * 'maxGroupSize'. Each array becomes the operations of one 'applyOps' oplog entry. An operation
+ * that is larger than the limit by itself is put into an array of its own.
+ */
+std::vector<BSONArray> groupTransactionOperations(const std::vector<repl::ReplOperation>& stmts,
+                                                  int maxGroupSize) {
+    std::vector<BSONArray> groups;
+    std::vector<BSONObj> group;
+    int groupSize = 0;
+
+    auto flushGroup = [&] {
+        BSONArrayBuilder opsArray;
+        for (const auto& stmtObj : group) {
+            opsArray.append(stmtObj);
+        }
+        groups.push_back(opsArray.arr());
+        group.clear();
+        groupSize = 0;
+    };
+
+    for (const auto& stmt : stmts) {
+        auto stmtObj = stmt.toBSON();
+        if (!group.empty() && groupSize + stmtObj.objsize() > maxGroupSize) {
+            flushGroup();
+        }
+        groupSize += stmtObj.objsize();
+        group.push_back(std::move(stmtObj));
+    }
+    flushGroup();
+
+    return groups;
+}
+
 OpTimeBundle logApplyOpsForTransaction(OperationContext* opCtx,
                                        Session* const session,
                                        std::vector<repl::ReplOperation> stmts,
                                        const OplogSlot& prepareOplogSlot) {
-    BSONObjBuilder applyOpsBuilder;
-    BSONArrayBuilder opsArray(applyOpsBuilder.subarrayStart("applyOps"_sd));
-    for (auto& stmt : stmts) {
-        opsArray.append(stmt.toBSON());
-    }
-    opsArray.done();
-
     const NamespaceString cmdNss{"admin", "$cmd"};
 
     OperationSessionInfo sessionInfo;
@@ -936,19 +980,46 @@ OpTimeBundle logApplyOpsForTransaction(OperationContext* opCtx,
     sessionInfo.setTxnNumber(*opCtx->getTxnNumber());
     StmtId stmtId(0);
     oplogLink.prevOpTime = session->getLastWriteOpTime(*opCtx->getTxnNumber());
-    // Until we support multiple oplog entries per transaction, prevOpTime should always be null.
+    // A transaction's oplog entries are all written here, so nothing can precede the first one.
     invariant(oplogLink.prevOpTime.isNull());
 
     try {
         // We are only given an oplog slot for prepared transactions.
         auto prepare = !prepareOplogSlot.opTime.isNull();
-        if (prepare) {
-            // TODO: SERVER-36814 Remove "prepare" field on applyOps.
-            applyOpsBuilder.append("prepare", true);
+
+        // A prepared transaction must be a single entry, since the prepare oplog slot has already
+        // been reserved. Unprepared transactions write every group but the last as a partial
+        // 'applyOps' entry, and the last one, which carries the commit, links back to them through
+        // prevOpTime. All of the entries become visible together when the transaction commits.
+        const auto groups = groupTransactionOperations(
+            stmts,
+            prepare ? std::numeric_limits<int>::max()
+                    : maxSizeOfTransactionOplogEntryBytes.load());
+
+        OpTimeBundle times;
+        for (size_t i = 0; i < groups.size(); ++i) {
+            const bool isLastEntry = i == groups.size() - 1;
+
+            BSONObjBuilder applyOpsBuilder;
+            applyOpsBuilder.append("applyOps"_sd, groups[i]);
+            if (prepare) {
+                // TODO: SERVER-36814 Remove "prepare" field on applyOps.
+                applyOpsBuilder.append("prepare", true);
+            }
+            if (!isLastEntry) {
+                applyOpsBuilder.append(OplogEntry::kPartialTxnFieldName, true);
+            }
+            auto applyOpCmd = applyOpsBuilder.done();
+            times = replLogApplyOps(opCtx,
+                                    cmdNss,
+                                    applyOpCmd,
+                                    sessionInfo,
+                                    stmtId,
+                                    oplogLink,
+                                    prepare,
+                                    prepareOplogSlot);
+            oplogLink.prevOpTime = times.writeOpTime;
         }
-        auto applyOpCmd = applyOpsBuilder.done();
-        auto times = replLogApplyOps(
-            opCtx, cmdNss, applyOpCmd, sessionInfo, stmtId, oplogLink, prepare, prepareOplogSlot);
 
         auto txnState = prepare ? DurableTxnStateEnum::kPrepared : DurableTxnStateEnum::kCommitted;
         onWriteOpCompleted(
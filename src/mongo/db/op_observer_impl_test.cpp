@@ -398,8 +398,9 @@ private:
     }
 };
 
-// Tests that a transaction aborts if it becomes too large only during the commit.
-TEST_F(OpObserverLargeTransactionTest, TransactionTooLargeWhileCommitting) {
+// Tests that a transaction too large for a single oplog entry is written as a chain of 'applyOps'
+// entries, with only the last one committing it.
+TEST_F(OpObserverLargeTransactionTest, LargeTransactionIsWrittenAsChainOfApplyOpsEntries) {
     OpObserverImpl opObserver;
     auto opCtx = cc().makeOperationContext();
     const NamespaceString nss("testDB", "testColl");
@@ -421,7 +422,7 @@ TEST_F(OpObserverLargeTransactionTest, TransactionTooLargeWhileCommitting) {
 
     // This size is crafted such that two operations of this size are not too big to fit in a single
     // oplog entry, but two operations plus oplog overhead are too big to fit in a single oplog
-    // entry.
+    // entry. Each of them is also larger than the default 'maxSizeOfTransactionOplogEntryBytes'.
     constexpr size_t kHalfTransactionSize = BSONObjMaxInternalSize / 2 - 175;
     std::unique_ptr<uint8_t[]> halfTransactionData(new uint8_t[kHalfTransactionSize]());
     auto operation = repl::OplogEntry::makeInsertOperation(
@@ -432,9 +433,25 @@ TEST_F(OpObserverLargeTransactionTest, TransactionTooLargeWhileCommitting) {
                   << BSONBinData(halfTransactionData.get(), kHalfTransactionSize, BinDataGeneral)));
     txnParticipant->addTransactionOperation(opCtx.get(), operation);
     txnParticipant->addTransactionOperation(opCtx.get(), operation);
-    ASSERT_THROWS_CODE(opObserver.onTransactionCommit(opCtx.get(), boost::none, boost::none),
-                       AssertionException,
-                       ErrorCodes::TransactionTooLarge);
+    opObserver.onTransactionCommit(opCtx.get(), boost::none, boost::none);
+
+    repl::OplogInterfaceLocal oplogInterface(opCtx.get(), NamespaceString::kRsOplogNamespace.ns());
+    auto oplogIter = oplogInterface.makeIterator();
+    auto commitEntry =
+        assertGet(OplogEntry::parse(unittest::assertGet(oplogIter->next()).first));
+    auto partialEntry =
+        assertGet(OplogEntry::parse(unittest::assertGet(oplogIter->next()).first));
+    ASSERT_EQUALS(ErrorCodes::CollectionIsEmpty, oplogIter->next().getStatus());
+
+    ASSERT_TRUE(partialEntry.isPartialTransaction());
+    ASSERT_EQ(1, partialEntry.getObject()["applyOps"].Obj().nFields());
+    ASSERT_EQ(repl::OpTime(), *partialEntry.getPrevWriteOpTimeInTransaction());
+
+    ASSERT_FALSE(commitEntry.isPartialTransaction());
+    ASSERT_EQ(1, commitEntry.getObject()["applyOps"].Obj().nFields());
+    ASSERT_EQ(partialEntry.getOpTime(), *commitEntry.getPrevWriteOpTimeInTransaction());
+    ASSERT_EQ(*commitEntry.getTxnNumber(), *partialEntry.getTxnNumber());
+    ASSERT_EQ(commitEntry.getOpTime(), session->getLastWriteOpTime(txnNum));
 }
 
 TEST_F(OpObserverTest, OnRollbackInvalidatesAuthCacheWhenAuthNamespaceRolledBack) {
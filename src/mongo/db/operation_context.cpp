@@ -75,10 +75,16 @@ MONGO_FAIL_POINT_DEFINE(maxTimeNeverTimeOut);
 // inclusive.
 MONGO_FAIL_POINT_DEFINE(checkForInterruptFail);
 
+// checkForInterruptNoAssert() reads the clock on at most one in this many calls while the deadline
+// is more than kDeadlineSamplingHorizon away. Closer to the deadline every call reads the clock.
+const int kDeadlineCheckInterval = 16;
+const Milliseconds kDeadlineSamplingHorizon = Seconds(1);
+
 }  // namespace
 
 OperationContext::OperationContext(Client* client, unsigned int opId)
-    : _client(client),
+    : Decorable(client ? &client->_opCtxDecorationStorage : nullptr),
+      _client(client),
       _opId(opId),
       _elapsedTime(client ? client->getServiceContext()->getTickSource()
                           : SystemTickSource::get()) {}
@@ -94,6 +100,7 @@ void OperationContext::setDeadlineAndMaxTime(Date_t when,
     _deadline = when;
     _maxTime = maxTime;
     _timeoutError = timeoutError;
+    _deadlineChecksUntilClockRead = 0;
 }
 
 Microseconds OperationContext::computeMaxTimeFromDeadline(Date_t when) {
@@ -131,6 +138,28 @@ void OperationContext::setDeadlineAfterNowBy(Microseconds maxTime, ErrorCodes::E
 }
 
 bool OperationContext::hasDeadlineExpired() const {
+    Milliseconds remaining{0};
+    return _hasDeadlineExpired(&remaining);
+}
+
+bool OperationContext::_hasDeadlineExpiredSampled() {
+    if (_deadlineChecksUntilClockRead > 0 && !MONGO_FAIL_POINT(maxTimeAlwaysTimeOut)) {
+        --_deadlineChecksUntilClockRead;
+        return false;
+    }
+
+    Milliseconds remaining{0};
+    if (_hasDeadlineExpired(&remaining)) {
+        return true;
+    }
+
+    if (remaining > kDeadlineSamplingHorizon) {
+        _deadlineChecksUntilClockRead = kDeadlineCheckInterval - 1;
+    }
+    return false;
+}
+
+bool OperationContext::_hasDeadlineExpired(Milliseconds* remaining) const {
     if (!hasDeadline()) {
         return false;
     }
@@ -147,8 +176,16 @@ bool OperationContext::hasDeadlineExpired() const {
         return false;
     }
 
-    const auto now = getServiceContext()->getFastClockSource()->now();
-    return now >= getDeadline();
+    const auto clock = getServiceContext()->getFastClockSource();
+    const auto now = clock->now();
+    if (now >= getDeadline()) {
+        return true;
+    }
+
+    if (clock->tracksSystemClock()) {
+        *remaining = getDeadline() - now;
+    }
+    return false;
 }
 
 Milliseconds OperationContext::getRemainingMaxTimeMillis() const {
@@ -196,7 +233,9 @@ Status OperationContext::checkForInterruptNoAssert() noexcept {
         return Status(ErrorCodes::InterruptedAtShutdown, "interrupted at shutdown");
     }
 
-    if (hasDeadlineExpired()) {
+    // Operations without a deadline skip the clock entirely. The remaining checks are plain or
+    // relaxed loads, so an operation which has not been interrupted never takes a lock here.
+    if (hasDeadline() && _hasDeadlineExpiredSampled()) {
         if (!_hasArtificialDeadline) {
             markKilled(_timeoutError);
         }
@@ -378,6 +378,19 @@ private:
      */
     bool hasDeadlineExpired() const;
 
+    /**
+     * Variant of hasDeadlineExpired() used by checkForInterruptNoAssert(). While the deadline is
+     * far away on a clock that tracks the system clock, only every kDeadlineCheckInterval-th call
+     * reads the clock; the others return false straight away.
+     */
+    bool _hasDeadlineExpiredSampled();
+
+    /**
+     * Implements hasDeadlineExpired(). If the clock was read and it tracks the system clock, sets
+     * "remaining" to the time left until the deadline, otherwise leaves it unchanged.
+     */
+    bool _hasDeadlineExpired(Milliseconds* remaining) const;
+
     /**
      * Sets the deadline and maxTime as described. It is up to the caller to ensure that
      * these correctly correspond.
@@ -448,6 +461,11 @@ private:
         Date_t::max();  // The timepoint at which this operation exceeds its time limit.
 
     ErrorCodes::Error _timeoutError = ErrorCodes::ExceededTimeLimit;
+
+    // Number of upcoming calls to _hasDeadlineExpiredSampled() that may skip reading the clock.
+    // Reset whenever the deadline changes.
+    int _deadlineChecksUntilClockRead = 0;
+
     bool _ignoreInterrupts = false;
     bool _hasArtificialDeadline = false;
 
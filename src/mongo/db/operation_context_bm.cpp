@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 16;
+
+/**
+ * Measures the cost of checkForInterruptNoAssert() on an operation which is not interrupted. With
+ * an argument of 0 the operation has no deadline; otherwise it has a deadline that many seconds in
+ * the future, so every call also has to consider the clock.
+ */
+void BM_CheckForInterrupt(benchmark::State& state) {
+    auto client = getGlobalServiceContext()->makeClient(str::stream() << "interrupt bm "
+                                                                      << state.thread_index);
+    auto opCtx = client->makeOperationContext();
+    if (state.range(0) > 0) {
+        opCtx->setDeadlineAfterNowBy(Seconds(state.range(0)), ErrorCodes::ExceededTimeLimit);
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(opCtx->checkForInterruptNoAssert());
+    }
+}
+
+BENCHMARK(BM_CheckForInterrupt)->Arg(0)->Arg(3600)->ThreadRange(1, kMaxPerfThreads);
+
+/**
+ * Measures creating and destroying an OperationContext, as is done for every request. After the
+ * first iteration the decoration storage comes from the client's cache.
+ */
+void BM_MakeOperationContext(benchmark::State& state) {
+    auto client = getGlobalServiceContext()->makeClient(str::stream() << "make opCtx bm "
+                                                                      << state.thread_index);
+
+    for (auto keepRunning : state) {
+        auto opCtx = client->makeOperationContext();
+        benchmark::DoNotOptimize(opCtx.get());
+    }
+}
+
+BENCHMARK(BM_MakeOperationContext)->ThreadRange(1, kMaxPerfThreads);
+
+/**
+ * Measures creating a Client and an OperationContext for one unit of internal work, as background
+ * tasks which do not keep a Client per thread do. The Client decoration storage comes from the
+ * ServiceContext's cache, shared by all threads.
+ */
+void BM_MakeClientAndOperationContext(benchmark::State& state) {
+    auto serviceContext = getGlobalServiceContext();
+
+    for (auto keepRunning : state) {
+        auto client = serviceContext->makeClient("internal task bm");
+        auto opCtx = client->makeOperationContext();
+        benchmark::DoNotOptimize(opCtx.get());
+    }
+}
+
+BENCHMARK(BM_MakeClientAndOperationContext)->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace mongo
@@ -43,6 +43,7 @@
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/fail_point_service.h"
 #include "mongo/util/tick_source_mock.h"
 #include "mongo/util/time_support.h"
 
@@ -219,6 +220,22 @@ TEST(OperationContextTest, IgnoreInterruptsWorks) {
     ASSERT_EQUALS(opCtx->getKillStatus(), ErrorCodes::BadValue);
 }
 
+TEST(OperationContextTest, SampledDeadlineCheckHonorsMaxTimeAlwaysTimeOut) {
+    auto serviceCtx = ServiceContext::make();
+    auto client = serviceCtx->makeClient("OperationContextTest");
+    auto opCtx = client->makeOperationContext();
+
+    // A far away deadline lets checkForInterruptNoAssert() skip most clock reads, but must not
+    // delay the fail point.
+    opCtx->setDeadlineAfterNowBy(Hours(1), ErrorCodes::ExceededTimeLimit);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_OK(opCtx->checkForInterruptNoAssert());
+    }
+
+    FailPointEnableBlock failPoint("maxTimeAlwaysTimeOut");
+    ASSERT_EQ(ErrorCodes::ExceededTimeLimit, opCtx->checkForInterruptNoAssert());
+}
+
 class OperationDeadlineTests : public unittest::Test {
 public:
     void setUp() {
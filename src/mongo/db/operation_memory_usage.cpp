@@ -0,0 +1,152 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_memory_usage.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+
+namespace {
+
+// Upper bound on the memory tracked across all operations. Zero means unlimited.
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxTrackedMemoryBytes, long long, 0)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "internalQueryMaxTrackedMemoryBytes must be >= 0");
+        }
+        return Status::OK();
+    });
+
+AtomicInt64 serverTrackedBytes{0};
+
+const auto getOperationMemoryUsage = OperationContext::declareDecoration<OperationMemoryUsage>();
+
+}  // namespace
+
+OperationMemoryUsage::OperationMemoryUsage() : _counters(std::make_shared<Counters>()) {}
+
+OperationMemoryUsage& OperationMemoryUsage::get(OperationContext* opCtx) {
+    return getOperationMemoryUsage(opCtx);
+}
+
+int64_t OperationMemoryUsage::getCurrentBytes() const {
+    return _counters->currentBytes.loadRelaxed();
+}
+
+int64_t OperationMemoryUsage::getPeakBytes() const {
+    return _counters->peakBytes.loadRelaxed();
+}
+
+void OperationMemoryUsage::report(BSONObjBuilder* builder) const {
+    const auto peakBytes = getPeakBytes();
+    if (peakBytes == 0) {
+        return;
+    }
+
+    BSONObjBuilder sub(builder->subobjStart("memUsage"));
+    sub.append("currentBytes", static_cast<long long>(getCurrentBytes()));
+    sub.append("peakBytes", static_cast<long long>(peakBytes));
+}
+
+int64_t OperationMemoryUsage::getServerTrackedBytes() {
+    return serverTrackedBytes.loadRelaxed();
+}
+
+bool OperationMemoryUsage::serverBudgetExceeded() {
+    const auto budget = internalQueryMaxTrackedMemoryBytes.load();
+    return budget > 0 && serverTrackedBytes.loadRelaxed() > budget;
+}
+
+bool OperationMemoryUsage::shouldReleaseMemory(size_t bytesHeld) {
+    return static_cast<int64_t>(bytesHeld) >= Tracker::kPublishGranularityBytes &&
+        serverBudgetExceeded();
+}
+
+OperationMemoryUsage::Tracker::Tracker(OperationContext* opCtx) {
+    if (opCtx) {
+        _counters = get(opCtx)._counters;
+    }
+}
+
+OperationMemoryUsage::Tracker::~Tracker() {
+    _publish(0);
+}
+
+void OperationMemoryUsage::Tracker::set(size_t bytes) {
+    _bytes = static_cast<int64_t>(bytes);
+
+    const auto delta = _bytes - _publishedBytes;
+    if (_bytes == 0 || delta >= kPublishGranularityBytes || -delta >= kPublishGranularityBytes) {
+        _publish(_bytes);
+    }
+}
+
+void OperationMemoryUsage::Tracker::detachFromOperationContext() {
+    if (_counters) {
+        _counters->currentBytes.fetchAndSubtract(_publishedBytes);
+        _counters.reset();
+    }
+}
+
+void OperationMemoryUsage::Tracker::reattachToOperationContext(OperationContext* opCtx) {
+    detachFromOperationContext();
+    _counters = get(opCtx)._counters;
+
+    const auto current = _counters->currentBytes.addAndFetch(_publishedBytes);
+    if (current > _counters->peakBytes.loadRelaxed()) {
+        _counters->peakBytes.store(current);
+    }
+}
+
+void OperationMemoryUsage::Tracker::_publish(int64_t bytes) {
+    const auto delta = bytes - _publishedBytes;
+    if (delta == 0) {
+        return;
+    }
+    _publishedBytes = bytes;
+
+    serverTrackedBytes.addAndFetch(delta);
+    if (!_counters) {
+        return;
+    }
+
+    // Only the thread running the operation updates its counters, so a plain store is enough to
+    // maintain the peak.
+    const auto current = _counters->currentBytes.addAndFetch(delta);
+    if (current > _counters->peakBytes.loadRelaxed()) {
+        _counters->peakBytes.store(current);
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+
+/**
+ * Accounts for the memory that the execution machinery of an operation (blocking sorts, $group
+ * tables and the like) is holding on to. Usage is tracked per operation, for reporting in
+ * currentOp, and summed over the whole process so that memory hungry stages can spill or fail
+ * once the server-wide budget set by internalQueryMaxTrackedMemoryBytes is exhausted.
+ *
+ * Consumers report their usage through an OperationMemoryUsage::Tracker.
+ */
+class OperationMemoryUsage {
+    MONGO_DISALLOW_COPYING(OperationMemoryUsage);
+
+public:
+    class Tracker;
+
+    OperationMemoryUsage();
+
+    static OperationMemoryUsage& get(OperationContext* opCtx);
+
+    /**
+     * Bytes currently tracked by the operation, and the largest value this reached. May be read
+     * from threads other than the one running the operation.
+     */
+    int64_t getCurrentBytes() const;
+    int64_t getPeakBytes() const;
+
+    /**
+     * Appends a "memUsage" subobject to 'builder' if this operation ever tracked any memory.
+     */
+    void report(BSONObjBuilder* builder) const;
+
+    /**
+     * Returns the sum of the memory reported by all live Trackers in the process.
+     */
+    static int64_t getServerTrackedBytes();
+
+    /**
+     * Returns true if a server-wide budget is configured and the tracked total is above it. Stages
+     * that are still growing should spill to disk if they can, and fail otherwise.
+     */
+    static bool serverBudgetExceeded();
+
+    /**
+     * Returns true if a consumer currently holding 'bytesHeld' bytes should spill or fail because
+     * the server is over its budget. Consumers holding too little to matter are left alone.
+     */
+    static bool shouldReleaseMemory(size_t bytesHeld);
+
+private:
+    struct Counters {
+        AtomicInt64 currentBytes{0};
+        AtomicInt64 peakBytes{0};
+    };
+
+    // Shared with the Trackers attributed to this operation, so that a Tracker which outlives the
+    // operation (for example in a cursor that is destroyed later) never touches freed memory.
+    const std::shared_ptr<Counters> _counters;
+};
+
+/**
+ * Reports the memory held by a single consumer. The usage is charged to the server-wide total for
+ * as long as the Tracker lives, and to the operation it is attached to, if any.
+ *
+ * To keep the shared counters cold, changes are only published once they add up to
+ * kPublishGranularityBytes, or when the usage drops back to zero.
+ */
+class OperationMemoryUsage::Tracker {
+    MONGO_DISALLOW_COPYING(Tracker);
+
+public:
+    static constexpr int64_t kPublishGranularityBytes = 64 * 1024;
+
+    explicit Tracker(OperationContext* opCtx);
+    ~Tracker();
+
+    /**
+     * Records that the consumer now holds 'bytes' bytes.
+     */
+    void set(size_t bytes);
+
+    /**
+     * Stops charging the operation for this usage. The server-wide total is unaffected, since the
+     * memory is still held.
+     */
+    void detachFromOperationContext();
+
+    /**
+     * Charges the usage to 'opCtx' from now on.
+     */
+    void reattachToOperationContext(OperationContext* opCtx);
+
+private:
+    void _publish(int64_t bytes);
+
+    std::shared_ptr<Counters> _counters;
+    int64_t _bytes = 0;
+    int64_t _publishedBytes = 0;
+};
+
+}  // namespace mongo
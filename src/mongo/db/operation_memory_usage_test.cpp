@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/operation_memory_usage.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+const int64_t kChunk = OperationMemoryUsage::Tracker::kPublishGranularityBytes;
+
+class OperationMemoryUsageTest : public unittest::Test {
+public:
+    void setUp() override {
+        service = ServiceContext::make();
+        client = service->makeClient("OperationMemoryUsageTest");
+    }
+
+    ServiceContext::UniqueServiceContext service;
+    ServiceContext::UniqueClient client;
+};
+
+void setBudget(StringData value) {
+    ASSERT_OK(ServerParameterSet::getGlobal()
+                  ->getMap()
+                  .find("internalQueryMaxTrackedMemoryBytes")
+                  ->second->setFromString(value.toString()));
+}
+
+TEST_F(OperationMemoryUsageTest, SmallChangesAreNotPublished) {
+    auto opCtx = client->makeOperationContext();
+    const auto serverBytesBefore = OperationMemoryUsage::getServerTrackedBytes();
+
+    OperationMemoryUsage::Tracker tracker(opCtx.get());
+    tracker.set(kChunk - 1);
+    ASSERT_EQ(0, OperationMemoryUsage::get(opCtx.get()).getCurrentBytes());
+    ASSERT_EQ(serverBytesBefore, OperationMemoryUsage::getServerTrackedBytes());
+
+    tracker.set(kChunk);
+    ASSERT_EQ(kChunk, OperationMemoryUsage::get(opCtx.get()).getCurrentBytes());
+    ASSERT_EQ(serverBytesBefore + kChunk, OperationMemoryUsage::getServerTrackedBytes());
+}
+
+TEST_F(OperationMemoryUsageTest, ReleasingAllMemoryIsPublishedImmediately) {
+    auto opCtx = client->makeOperationContext();
+    const auto serverBytesBefore = OperationMemoryUsage::getServerTrackedBytes();
+
+    OperationMemoryUsage::Tracker tracker(opCtx.get());
+    tracker.set(3 * kChunk);
+    tracker.set(0);
+    ASSERT_EQ(0, OperationMemoryUsage::get(opCtx.get()).getCurrentBytes());
+    ASSERT_EQ(3 * kChunk, OperationMemoryUsage::get(opCtx.get()).getPeakBytes());
+    ASSERT_EQ(serverBytesBefore, OperationMemoryUsage::getServerTrackedBytes());
+}
+
+TEST_F(OperationMemoryUsageTest, DestroyingTrackerReleasesItsMemory) {
+    auto opCtx = client->makeOperationContext();
+    const auto serverBytesBefore = OperationMemoryUsage::getServerTrackedBytes();
+
+    {
+        OperationMemoryUsage::Tracker first(opCtx.get());
+        OperationMemoryUsage::Tracker second(opCtx.get());
+        first.set(kChunk);
+        second.set(2 * kChunk);
+        ASSERT_EQ(3 * kChunk, OperationMemoryUsage::get(opCtx.get()).getCurrentBytes());
+    }
+
+    ASSERT_EQ(0, OperationMemoryUsage::get(opCtx.get()).getCurrentBytes());
+    ASSERT_EQ(serverBytesBefore, OperationMemoryUsage::getServerTrackedBytes());
+}
+
+TEST_F(OperationMemoryUsageTest, ReattachMovesUsageToNewOperation) {
+    auto firstOpCtx = client->makeOperationContext();
+    OperationMemoryUsage::Tracker tracker(firstOpCtx.get());
+    tracker.set(kChunk);
+
+    tracker.detachFromOperationContext();
+    ASSERT_EQ(0, OperationMemoryUsage::get(firstOpCtx.get()).getCurrentBytes());
+    firstOpCtx.reset();
+
+    auto secondOpCtx = client->makeOperationContext();
+    tracker.reattachToOperationContext(secondOpCtx.get());
+    ASSERT_EQ(kChunk, OperationMemoryUsage::get(secondOpCtx.get()).getCurrentBytes());
+    ASSERT_EQ(kChunk, OperationMemoryUsage::get(secondOpCtx.get()).getPeakBytes());
+}
+
+TEST_F(OperationMemoryUsageTest, TrackerOutlivingItsOperationIsSafe) {
+    const auto serverBytesBefore = OperationMemoryUsage::getServerTrackedBytes();
+    boost::optional<OperationMemoryUsage::Tracker> tracker;
+    {
+        auto opCtx = client->makeOperationContext();
+        tracker.emplace(opCtx.get());
+        tracker->set(kChunk);
+    }
+
+    tracker = boost::none;
+    ASSERT_EQ(serverBytesBefore, OperationMemoryUsage::getServerTrackedBytes());
+}
+
+TEST_F(OperationMemoryUsageTest, ShouldReleaseMemoryOnlyWhenOverBudget) {
+    auto opCtx = client->makeOperationContext();
+    ON_BLOCK_EXIT([] { setBudget("0"); });
+
+    OperationMemoryUsage::Tracker tracker(opCtx.get());
+    tracker.set(2 * kChunk);
+
+    // No budget means no limit.
+    ASSERT_FALSE(OperationMemoryUsage::shouldReleaseMemory(2 * kChunk));
+
+    setBudget(std::to_string(OperationMemoryUsage::getServerTrackedBytes() + kChunk));
+    ASSERT_FALSE(OperationMemoryUsage::shouldReleaseMemory(2 * kChunk));
+
+    tracker.set(4 * kChunk);
+    ASSERT_TRUE(OperationMemoryUsage::serverBudgetExceeded());
+    ASSERT_TRUE(OperationMemoryUsage::shouldReleaseMemory(4 * kChunk));
+
+    // Consumers holding less than a publishing chunk are not asked to give anything back.
+    ASSERT_FALSE(OperationMemoryUsage::shouldReleaseMemory(kChunk - 1));
+}
+
+TEST_F(OperationMemoryUsageTest, ReportOmitsOperationsThatNeverTrackedMemory) {
+    auto opCtx = client->makeOperationContext();
+
+    BSONObjBuilder emptyBuilder;
+    OperationMemoryUsage::get(opCtx.get()).report(&emptyBuilder);
+    ASSERT_BSONOBJ_EQ(BSONObj(), emptyBuilder.obj());
+
+    OperationMemoryUsage::Tracker tracker(opCtx.get());
+    tracker.set(kChunk);
+
+    BSONObjBuilder builder;
+    OperationMemoryUsage::get(opCtx.get()).report(&builder);
+    ASSERT_BSONOBJ_EQ(BSON("memUsage" << BSON("currentBytes" << kChunk << "peakBytes" << kChunk)),
+                      builder.obj());
+}
+
+}  // namespace
+}  // namespace mongo
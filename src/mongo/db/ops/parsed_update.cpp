@@ -36,15 +36,28 @@
 #include "mongo/db/query/collation/collator_factory_interface.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/server_options.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
 ParsedUpdate::ParsedUpdate(OperationContext* opCtx, const UpdateRequest* request)
     : _opCtx(opCtx),
       _request(request),
-      _driver(new ExpressionContext(opCtx, nullptr)),
+      _driver(stdx::make_unique<UpdateDriver>(new ExpressionContext(opCtx, nullptr))),
+      _driverIsParsed(false),
       _canonicalQuery() {}
 
+ParsedUpdate::ParsedUpdate(OperationContext* opCtx,
+                           const UpdateRequest* request,
+                           std::unique_ptr<UpdateDriver> parsedDriver)
+    : _opCtx(opCtx),
+      _request(request),
+      _driver(std::move(parsedDriver)),
+      _driverIsParsed(true),
+      _canonicalQuery() {
+    invariant(_driver);
+}
+
 Status ParsedUpdate::parseRequest() {
     // It is invalid to request that the UpdateStage return the prior or newly-updated version
     // of a document during a multi-update.
@@ -82,7 +95,7 @@ Status ParsedUpdate::parseRequest() {
 Status ParsedUpdate::parseQuery() {
     dassert(!_canonicalQuery.get());
 
-    if (!_driver.needMatchDetails() && CanonicalQuery::isSimpleIdQuery(_request->getQuery())) {
+    if (!_driver->needMatchDetails() && CanonicalQuery::isSimpleIdQuery(_request->getQuery())) {
         return Status::OK();
     }
 
@@ -138,11 +151,22 @@ Status ParsedUpdate::parseQueryToCQ() {
 }
 
 void ParsedUpdate::parseUpdate() {
-    _driver.setCollator(_collator.get());
-    _driver.setLogOp(true);
-    _driver.setFromOplogApplication(_request->isFromOplogApplication());
+    if (_driverIsParsed) {
+        // Only a driver without a collation or array filters is ever handed over, so it is enough
+        // to undo whatever the previous execution changed. An upsert turns off logging and
+        // switches the driver into insert mode.
+        invariant(!_collator && _arrayFilters.empty());
+        _driver->setLogOp(true);
+        _driver->setInsert(false);
+        _driver->setFromOplogApplication(_request->isFromOplogApplication());
+        return;
+    }
 
-    _driver.parse(_request->getUpdates(), _arrayFilters, _request->isMulti());
+    _driver->setCollator(_collator.get());
+    _driver->setLogOp(true);
+    _driver->setFromOplogApplication(_request->isFromOplogApplication());
+
+    _driver->parse(_request->getUpdates(), _arrayFilters, _request->isMulti());
 }
 
 Status ParsedUpdate::parseArrayFilters() {
@@ -201,13 +225,20 @@ const UpdateRequest* ParsedUpdate::getRequest() const {
 }
 
 UpdateDriver* ParsedUpdate::getDriver() {
-    return &_driver;
+    return _driver.get();
+}
+
+std::unique_ptr<UpdateDriver> ParsedUpdate::releaseReusableDriver() {
+    if (_collator || !_arrayFilters.empty()) {
+        return nullptr;
+    }
+    return std::move(_driver);
 }
 
 void ParsedUpdate::setCollator(std::unique_ptr<CollatorInterface> collator) {
     _collator = std::move(collator);
 
-    _driver.setCollator(_collator.get());
+    _driver->setCollator(_collator.get());
 
     for (auto&& arrayFilter : _arrayFilters) {
         arrayFilter.second->getFilter()->setCollator(_collator.get());
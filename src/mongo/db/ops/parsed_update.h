@@ -67,6 +67,17 @@ public:
      */
     ParsedUpdate(OperationContext* opCtx, const UpdateRequest* request);
 
+    /**
+     * Constructs a parsed update which adopts 'parsedDriver' instead of parsing the update
+     * expression again. 'parsedDriver' must have been obtained from releaseReusableDriver() on a
+     * ParsedUpdate whose request had the same update expression and multi flag as 'request', and
+     * that update expression must still be in scope. 'request' may not specify a collation or
+     * array filters.
+     */
+    ParsedUpdate(OperationContext* opCtx,
+                 const UpdateRequest* request,
+                 std::unique_ptr<UpdateDriver> parsedDriver);
+
     /**
      * Parses the update request to a canonical query and an update driver. On success, the
      * parsed update can be used to create a PlanExecutor for this update.
@@ -91,6 +102,15 @@ public:
      */
     UpdateDriver* getDriver();
 
+    /**
+     * Releases the update driver so that a later ParsedUpdate of an identical update expression
+     * can skip parsing it. Returns nullptr if the driver depends on a collation or array filters
+     * owned by this ParsedUpdate, in which case it cannot outlive it.
+     *
+     * No PlanExecutor created from this ParsedUpdate may be used afterwards.
+     */
+    std::unique_ptr<UpdateDriver> releaseReusableDriver();
+
     /**
      * Get the YieldPolicy, adjusted for GodMode.
      */
@@ -151,7 +171,10 @@ private:
     std::map<StringData, std::unique_ptr<ExpressionWithPlaceholder>> _arrayFilters;
 
     // Driver for processing updates on matched documents.
-    UpdateDriver _driver;
+    std::unique_ptr<UpdateDriver> _driver;
+
+    // True if '_driver' was handed over already parsed, so parseUpdate() must not parse it again.
+    const bool _driverIsParsed;
 
     // Parsed query object, or NULL if the query proves to be an id hack query.
     std::unique_ptr<CanonicalQuery> _canonicalQuery;
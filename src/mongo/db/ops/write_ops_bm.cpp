@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/ops/write_ops_exec.h"
+#include "mongo/db/ops/write_ops_gen.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("write_ops_bm.coll");
+
+/**
+ * Starts a standalone storage layer on the default test engine with a single collection, indexed
+ * on 'a' in addition to _id.
+ */
+class WriteOpsBenchmarkFixture final : public ServiceContextMongoDTest {
+public:
+    WriteOpsBenchmarkFixture() {
+        auto service = getServiceContext();
+        auto replCoord =
+            stdx::make_unique<repl::ReplicationCoordinatorMock>(service, repl::ReplSettings());
+        replCoord->alwaysAllowWrites(true);
+        repl::ReplicationCoordinator::set(service, std::move(replCoord));
+
+        _opCtx = makeOperationContext();
+        AutoGetOrCreateDb autoDb(_opCtx.get(), kNss.db(), MODE_X);
+        WriteUnitOfWork wuow(_opCtx.get());
+        Collection* coll = autoDb.getDb()->createCollection(_opCtx.get(), kNss.ns());
+        invariant(coll);
+        auto spec = BSON("v" << 2 << "key" << BSON("a" << 1) << "name"
+                             << "a_1"
+                             << "ns"
+                             << kNss.ns());
+        uassertStatusOK(coll->getIndexCatalog()->createIndexOnEmptyCollection(_opCtx.get(), spec));
+        wuow.commit();
+    }
+
+    OperationContext* getOperationContext() {
+        return _opCtx.get();
+    }
+
+private:
+    void _doTest() override {}
+
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+void BM_performInserts(benchmark::State& state) {
+    WriteOpsBenchmarkFixture fixture;
+    const int batchSize = state.range(0);
+
+    // The documents have no _id, so every iteration inserts them again under fresh ObjectIds.
+    // Their values of 'a' are spread out so that a batch writes all over the secondary index.
+    std::vector<BSONObj> docs;
+    for (int i = 0; i < batchSize; ++i) {
+        docs.push_back(BSON("a" << (i * 7919) % 100003 << "payload" << std::string(100, 'x')));
+    }
+    write_ops::Insert op(kNss, std::move(docs));
+
+    for (auto _ : state) {
+        auto result = performInserts(fixture.getOperationContext(), op);
+        invariant(result.results.size() == static_cast<size_t>(batchSize));
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+
+BENCHMARK(BM_performInserts)->Arg(1)->Arg(64)->Arg(512);
+
+}  // namespace
+}  // namespace mongo
@@ -553,10 +553,36 @@ WriteResult performInserts(OperationContext* opCtx,
     return out;
 }
 
+namespace {
+
+/**
+ * The update driver parsed for an earlier statement of an update batch. Batches often repeat the
+ * same update expression, for example to bump a counter in many documents, and reusing the
+ * driver saves parsing and validating that expression for every statement.
+ */
+struct CachedUpdateDriver {
+    static bool canReuse(const write_ops::UpdateOpEntry& op) {
+        return write_ops::collationOf(op).isEmpty() && write_ops::arrayFiltersOf(op).empty();
+    }
+
+    bool matches(const write_ops::UpdateOpEntry& op) const {
+        return driver && multi == op.getMulti() && updates.binaryEqual(op.getU()) && canReuse(op);
+    }
+
+    // The update expression 'driver' was parsed from. The driver refers into it, so it must stay
+    // in scope for as long as the driver is used.
+    BSONObj updates;
+    bool multi = false;
+    std::unique_ptr<UpdateDriver> driver;
+};
+
+}  // namespace
+
 static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
                                                const NamespaceString& ns,
                                                StmtId stmtId,
-                                               const write_ops::UpdateOpEntry& op) {
+                                               const write_ops::UpdateOpEntry& op,
+                                               CachedUpdateDriver* cachedDriver) {
     auto txnParticipant = TransactionParticipant::get(opCtx);
     uassert(ErrorCodes::InvalidOptions,
             "Cannot use (or request) retryable writes with multi=true",
@@ -591,8 +617,10 @@ static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
                                ? PlanExecutor::INTERRUPT_ONLY
                                : PlanExecutor::YIELD_AUTO);
 
-    ParsedUpdate parsedUpdate(opCtx, &request);
-    uassertStatusOK(parsedUpdate.parseRequest());
+    auto parsedUpdate = cachedDriver->matches(op)
+        ? stdx::make_unique<ParsedUpdate>(opCtx, &request, std::move(cachedDriver->driver))
+        : stdx::make_unique<ParsedUpdate>(opCtx, &request);
+    uassertStatusOK(parsedUpdate->parseRequest());
 
     boost::optional<AutoGetCollection> collection;
     while (true) {
@@ -618,7 +646,7 @@ static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
     assertCanWrite_inlock(opCtx, ns);
 
     auto exec = uassertStatusOK(
-        getExecutorUpdate(opCtx, &curOp.debug(), collection->getCollection(), &parsedUpdate));
+        getExecutorUpdate(opCtx, &curOp.debug(), collection->getCollection(), parsedUpdate.get()));
 
     {
         stdx::lock_guard<Client> lk(*opCtx->getClient());
@@ -653,6 +681,15 @@ static SingleWriteResult performSingleUpdateOp(OperationContext* opCtx,
     result.setNModified(res.numDocsModified);
     result.setUpsertedId(res.upserted);
 
+    exec.reset();
+    if (CachedUpdateDriver::canReuse(op)) {
+        if (auto driver = parsedUpdate->releaseReusableDriver()) {
+            cachedDriver->updates = op.getU();
+            cachedDriver->multi = op.getMulti();
+            cachedDriver->driver = std::move(driver);
+        }
+    }
+
     return result;
 }
 
@@ -675,6 +712,7 @@ WriteResult performUpdates(OperationContext* opCtx, const write_ops::Update& who
     WriteResult out;
     out.results.reserve(wholeOp.getUpdates().size());
 
+    CachedUpdateDriver cachedDriver;
     for (auto&& singleOp : wholeOp.getUpdates()) {
         const auto stmtId = getStmtIdForWriteOp(opCtx, wholeOp, stmtIdIndex++);
         if (opCtx->getTxnNumber()) {
@@ -702,8 +740,8 @@ WriteResult performUpdates(OperationContext* opCtx, const write_ops::Update& who
         ON_BLOCK_EXIT([&] { finishCurOp(opCtx, &curOp); });
         try {
             lastOpFixer.startingOp();
-            out.results.emplace_back(
-                performSingleUpdateOp(opCtx, wholeOp.getNamespace(), stmtId, singleOp));
+            out.results.emplace_back(performSingleUpdateOp(
+                opCtx, wholeOp.getNamespace(), stmtId, singleOp, &cachedDriver));
             lastOpFixer.finishedOpSuccessfully();
         } catch (const DBException& ex) {
             const bool canContinue =
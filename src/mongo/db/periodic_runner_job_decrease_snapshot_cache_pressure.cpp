@@ -75,7 +75,7 @@ void startPeriodicThreadToDecreaseSnapshotHistoryCachePressure(ServiceContext* s
                 // (The PeriodicRunnerASIO's Client must be reset before returning.)
                 auto opCtx = client->makeOperationContext();
 
-                SnapshotWindowUtil::decreaseTargetSnapshotWindowSize(opCtx.get());
+                SnapshotWindowUtil::adjustTargetSnapshotWindowSize(opCtx.get());
             } catch (const DBException& ex) {
                 if (!ErrorCodes::isShutdownError(ex.toStatus().code())) {
                     warning() << "Periodic task to check for and decrease cache pressure caused by "
@@ -35,7 +35,8 @@ class ServiceContext;
 /**
  * Periodically checks for storage engine cache pressure to determine whether the maintained
  * snapshot history window target setting should be decreased. Maintaining too much snapshot and
- * write history can slow down the system. Runs once every checkCachePressurePeriodSeconds.
+ * write history can slow down the system. Absent cache pressure, the target is resized to fit the
+ * snapshot read durations recently observed. Runs once every checkCachePressurePeriodSeconds.
  *
  * This function should only ever be called once, during mongod server startup (db.cpp).
  * The PeriodicRunner will handle shutting down the job on shutdown, no extra handling necessary.
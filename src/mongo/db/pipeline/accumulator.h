@@ -60,6 +60,14 @@ public:
         processInternal(input, merging);
     }
 
+    /**
+     * Processes each of 'inputs' in order, with the same result as calling process(input, false) on
+     * each of them.
+     */
+    void processBatch(const std::vector<Value>& inputs) {
+        processBatchInternal(inputs);
+    }
+
     /** Marks the end of the evaluate() phase and return accumulated result.
      *  toBeMerged should be true when the outputs will be merged by process().
      */
@@ -89,6 +97,17 @@ protected:
     /// Update subclass's internal state based on input
     virtual void processInternal(const Value& input, bool merging) = 0;
 
+    /**
+     * Update subclass's internal state based on a batch of non-merging inputs. Subclasses with a
+     * cheaper way to consume many values at once than one processInternal() call per value should
+     * override this.
+     */
+    virtual void processBatchInternal(const std::vector<Value>& inputs) {
+        for (auto&& input : inputs) {
+            processInternal(input, false);
+        }
+    }
+
     const boost::intrusive_ptr<ExpressionContext>& getExpressionContext() const {
         return _expCtx;
     }
@@ -166,6 +185,7 @@ public:
     explicit AccumulatorSum(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
@@ -198,6 +218,7 @@ public:
     AccumulatorMinMax(const boost::intrusive_ptr<ExpressionContext>& expCtx, Sense sense);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
@@ -254,6 +275,7 @@ public:
     explicit AccumulatorAvg(const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
@@ -280,6 +302,7 @@ public:
     AccumulatorStdDev(const boost::intrusive_ptr<ExpressionContext>& expCtx, bool isSamp);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatchInternal(const std::vector<Value>& inputs) final;
     Value getValue(bool toBeMerged) final;
     const char* getOpName() const final;
     void reset() final;
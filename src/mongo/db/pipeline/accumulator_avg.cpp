@@ -30,6 +30,8 @@
 
 #include "mongo/db/pipeline/accumulator.h"
 
+#include <array>
+
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
@@ -52,6 +54,9 @@ namespace {
 const char subTotalName[] = "subTotal";
 const char subTotalErrorName[] = "subTotalError";  // Used for extra precision
 const char countName[] = "count";
+
+// The number of integers a batch collects before adding them to the total at once.
+const size_t kLongBufferSize = 128;
 }  // namespace
 
 void AccumulatorAvg::processInternal(const Value& input, bool merging) {
@@ -92,6 +97,42 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     _count++;
 }
 
+void AccumulatorAvg::processBatchInternal(const std::vector<Value>& inputs) {
+    // Integers are buffered and added to the total together. The buffer is flushed before each
+    // double, so that doubles are still added in input order relative to the integers before them.
+    std::array<long long, kLongBufferSize> longs;
+    size_t numLongs = 0;
+    auto flushLongs = [&] {
+        _nonDecimalTotal.addLongs(longs.data(), numLongs);
+        numLongs = 0;
+    };
+
+    for (auto&& input : inputs) {
+        switch (input.getType()) {
+            case NumberDecimal:
+                _decimalTotal = _decimalTotal.add(input.getDecimal());
+                _isDecimal = true;
+                break;
+            case NumberLong:
+            case NumberInt:
+                longs[numLongs++] = input.coerceToLong();
+                if (numLongs == longs.size()) {
+                    flushLongs();
+                }
+                break;
+            case NumberDouble:
+                flushLongs();
+                _nonDecimalTotal.addDouble(input.getDouble());
+                break;
+            default:
+                dassert(!input.numeric());
+                continue;
+        }
+        _count++;
+    }
+    flushLongs();
+}
+
 intrusive_ptr<Accumulator> AccumulatorAvg::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorAvg(expCtx);
@@ -61,6 +61,21 @@ void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorMinMax::processBatchInternal(const std::vector<Value>& inputs) {
+    // Find the extreme value of the batch first, so that '_val' is replaced at most once.
+    const auto& comparator = getExpressionContext()->getValueComparator();
+    const Value* extreme = nullptr;
+    for (auto&& input : inputs) {
+        if (!input.nullish() && (!extreme || comparator.compare(*extreme, input) * _sense > 0)) {
+            extreme = &input;
+        }
+    }
+
+    if (extreme) {
+        processInternal(*extreme, false);
+    }
+}
+
 Value AccumulatorMinMax::getValue(bool toBeMerged) {
     if (_val.missing()) {
         return Value(BSONNULL);
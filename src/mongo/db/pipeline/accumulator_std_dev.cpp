@@ -83,6 +83,15 @@ void AccumulatorStdDev::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorStdDev::processBatchInternal(const std::vector<Value>& inputs) {
+    // processInternal() is final, so this loop makes no virtual calls.
+    for (auto&& input : inputs) {
+        if (input.numeric()) {
+            AccumulatorStdDev::processInternal(input, false);
+        }
+    }
+}
+
 Value AccumulatorStdDev::getValue(bool toBeMerged) {
     if (!toBeMerged) {
         const long long adjustedCount = (_isSamp ? _count - 1 : _count);
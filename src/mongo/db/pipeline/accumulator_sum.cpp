@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <array>
 #include <cmath>
 #include <limits>
 
@@ -52,6 +53,9 @@ const char* AccumulatorSum::getOpName() const {
 namespace {
 const char subTotalName[] = "subTotal";
 const char subTotalErrorName[] = "subTotalError";  // Used for extra precision.
+
+// The number of integers a batch collects before adding them to the sum at once.
+const size_t kLongBufferSize = 128;
 }  // namespace
 
 
@@ -84,6 +88,44 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorSum::processBatchInternal(const std::vector<Value>& inputs) {
+    // Integers are buffered and added to the sum together. The buffer is flushed before each
+    // double, so that doubles are still added in input order relative to the integers before them.
+    std::array<long long, kLongBufferSize> longs;
+    size_t numLongs = 0;
+    auto flushLongs = [&] {
+        nonDecimalTotal.addLongs(longs.data(), numLongs);
+        numLongs = 0;
+    };
+
+    for (auto&& input : inputs) {
+        if (!input.numeric()) {
+            continue;
+        }
+
+        totalType = Value::getWidestNumeric(totalType, input.getType());
+        switch (input.getType()) {
+            case NumberInt:
+            case NumberLong:
+                longs[numLongs++] = input.coerceToLong();
+                if (numLongs == longs.size()) {
+                    flushLongs();
+                }
+                break;
+            case NumberDouble:
+                flushLongs();
+                nonDecimalTotal.addDouble(input.getDouble());
+                break;
+            case NumberDecimal:
+                decimalTotal = decimalTotal.add(input.coerceToDecimal());
+                break;
+            default:
+                MONGO_UNREACHABLE;
+        }
+    }
+    flushLongs();
+}
+
 intrusive_ptr<Accumulator> AccumulatorSum::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx) {
     return new AccumulatorSum(expCtx);
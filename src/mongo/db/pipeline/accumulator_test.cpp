@@ -66,6 +66,15 @@ static void assertExpectedResults(
                 ASSERT_EQUALS(op.second.getType(), result.getType());
             }
 
+            // Asserts that result equals expected result when the input is processed as a batch.
+            {
+                boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
+                accum->processBatch(op.first);
+                Value result = accum->getValue(false);
+                ASSERT_VALUE_EQ(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+            }
+
             // Asserts that result equals expected result when all input is on one shard.
             {
                 boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
@@ -334,6 +343,26 @@ TEST(Accumulators, Sum) {
          {{Value(9), Value()}, Value(9)}});
 }
 
+TEST(Accumulators, SumOfLargeBatchIsExact) {
+    intrusive_ptr<ExpressionContext> expCtx(new ExpressionContextForTest());
+    auto factory = AccumulationStatement::getFactory("$sum");
+
+    // Enough large integers to fill several batch buffers, with the positive and negative terms
+    // only cancelling out once all of them are summed.
+    std::vector<Value> inputs;
+    for (int i = 0; i < 1000; ++i) {
+        inputs.push_back(Value(numeric_limits<long long>::max()));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        inputs.push_back(Value(-numeric_limits<long long>::max()));
+    }
+    inputs.push_back(Value(3));
+
+    boost::intrusive_ptr<Accumulator> accum(factory(expCtx));
+    accum->processBatch(inputs);
+    ASSERT_VALUE_EQ(accum->getValue(false), Value(3LL));
+}
+
 TEST(Accumulators, AddToSetRespectsCollation) {
     intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
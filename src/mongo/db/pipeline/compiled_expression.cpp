@@ -0,0 +1,412 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/compiled_expression.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/platform/overflow_arithmetic.h"
+#include "mongo/util/summation.h"
+
+namespace mongo {
+
+namespace {
+
+bool isFastNumeric(const Value& val) {
+    const BSONType type = val.getType();
+    return type == NumberInt || type == NumberLong || type == NumberDouble;
+}
+
+}  // namespace
+
+const size_t CompiledExpression::kNoParent = std::numeric_limits<size_t>::max();
+
+// static
+std::unique_ptr<CompiledExpression> CompiledExpression::compile(
+    const std::vector<const Expression*>& roots) {
+    if (!internalQueryExecEnableCompiledAggregationExpressions.load()) {
+        return nullptr;
+    }
+
+    std::unique_ptr<CompiledExpression> compiled(new CompiledExpression());
+    for (auto&& root : roots) {
+        invariant(root);
+        compiled->_resultRegisters.push_back(compiled->compileNode(root));
+    }
+
+    // A program which only hands each root to its own evaluate() would just add overhead.
+    if (compiled->numFallbacks() == compiled->_program.size()) {
+        return nullptr;
+    }
+
+    compiled->_resolvedPaths.resize(compiled->_paths.size());
+    return compiled;
+}
+
+// static
+bool CompiledExpression::passesGuard(const Value& val, OpCode guard) {
+    return guard == OpCode::kGuardNumeric ? isFastNumeric(val) : val.getType() == String;
+}
+
+size_t CompiledExpression::numFallbacks() const {
+    return std::count_if(_program.begin(), _program.end(), [](const Instruction& instr) {
+        return instr.op == OpCode::kFallback;
+    });
+}
+
+size_t CompiledExpression::compileNode(const Expression* expr) {
+    if (auto constant = dynamic_cast<const ExpressionConstant*>(expr)) {
+        return newRegister(constant->getValue());
+    }
+
+    if (auto fieldPathExpr = dynamic_cast<const ExpressionFieldPath*>(expr)) {
+        if (!fieldPathExpr->isRootFieldPath() ||
+            fieldPathExpr->getFieldPath().getPathLength() == 1) {
+            return _program[emit(OpCode::kFallback, expr, newRegister())].dst;
+        }
+
+        const size_t pathIdx = internPath(fieldPathExpr->getFieldPath());
+        Instruction& instr = _program[emit(OpCode::kLoadPath, expr, newRegister())];
+        instr.target = pathIdx;
+        return instr.dst;
+    }
+
+    if (auto addExpr = dynamic_cast<const ExpressionAdd*>(expr)) {
+        return compileNary(addExpr, OpCode::kAdd, OpCode::kGuardNumeric);
+    }
+    if (auto subtractExpr = dynamic_cast<const ExpressionSubtract*>(expr)) {
+        return compileNary(subtractExpr, OpCode::kSubtract, OpCode::kGuardNumeric);
+    }
+    if (auto multiplyExpr = dynamic_cast<const ExpressionMultiply*>(expr)) {
+        return compileNary(multiplyExpr, OpCode::kMultiply, OpCode::kGuardNumeric);
+    }
+    if (auto concatExpr = dynamic_cast<const ExpressionConcat*>(expr)) {
+        return compileNary(concatExpr, OpCode::kConcat, OpCode::kGuardString);
+    }
+    if (auto compareExpr = dynamic_cast<const ExpressionCompare*>(expr)) {
+        const size_t dst = compileNary(compareExpr, OpCode::kCompare, boost::none);
+        _program.back().cmpOp = compareExpr->getOp();
+        return dst;
+    }
+
+    return _program[emit(OpCode::kFallback, expr, newRegister())].dst;
+}
+
+size_t CompiledExpression::compileNary(const ExpressionNary* expr,
+                                       OpCode op,
+                                       boost::optional<OpCode> guard) {
+    const auto& operandList = expr->getOperandList();
+
+    // A constant operand which fails the guard would send every document to the node's own
+    // evaluate().
+    if (guard) {
+        for (auto&& operandExpr : operandList) {
+            auto constant = dynamic_cast<const ExpressionConstant*>(operandExpr.get());
+            if (constant && !passesGuard(constant->getValue(), *guard)) {
+                return _program[emit(OpCode::kFallback, expr, newRegister())].dst;
+            }
+        }
+    }
+
+    const size_t dst = newRegister();
+    std::vector<size_t> operandRegisters;
+    std::vector<size_t> guards;
+    for (auto&& operandExpr : operandList) {
+        const size_t reg = compileNode(operandExpr.get());
+        operandRegisters.push_back(reg);
+
+        // Guarding each operand as soon as it has been evaluated means that no later operand is
+        // evaluated by the program when the node falls back, as in the tree walker.
+        if (guard && !dynamic_cast<const ExpressionConstant*>(operandExpr.get())) {
+            guards.push_back(emit(*guard, expr, dst));
+            _program.back().src = reg;
+        }
+    }
+
+    Instruction& instr = _program[emit(op, expr, dst)];
+    instr.src = _operands.size();
+    instr.numOperands = operandRegisters.size();
+    _operands.insert(_operands.end(), operandRegisters.begin(), operandRegisters.end());
+
+    for (auto&& guardIdx : guards) {
+        _program[guardIdx].target = _program.size();
+    }
+    return dst;
+}
+
+size_t CompiledExpression::emit(OpCode op, const Expression* expr, size_t dst) {
+    _program.push_back({op, expr, dst, 0, 0, 0, ExpressionCompare::EQ});
+    return _program.size() - 1;
+}
+
+size_t CompiledExpression::newRegister(Value initialValue) {
+    _registers.push_back(std::move(initialValue));
+    return _registers.size() - 1;
+}
+
+size_t CompiledExpression::internPath(const FieldPath& fieldPath) {
+    // The first field of 'fieldPath' names the variable, ROOT or CURRENT.
+    size_t parent = kNoParent;
+    for (size_t part = 1; part < fieldPath.getPathLength(); ++part) {
+        const StringData fieldName = fieldPath.getFieldName(part);
+
+        size_t pathIdx = kNoParent;
+        for (size_t i = 0; i < _paths.size(); ++i) {
+            if (_paths[i].parent == parent && _paths[i].fieldName == fieldName) {
+                pathIdx = i;
+                break;
+            }
+        }
+
+        if (pathIdx == kNoParent) {
+            pathIdx = _paths.size();
+            _paths.push_back({parent, fieldName.toString()});
+        }
+
+        parent = pathIdx;
+    }
+
+    invariant(parent != kNoParent);
+    return parent;
+}
+
+void CompiledExpression::evaluate(const Document& root) const {
+    size_t pc = 0;
+    while (pc < _program.size()) {
+        const Instruction& instr = _program[pc++];
+        switch (instr.op) {
+            case OpCode::kLoadPath: {
+                const Value& value = resolvePath(root, instr.target);
+                if (_resolvedPaths[instr.target].state == ResolvedPath::State::kCrossesArray) {
+                    _registers[instr.dst] = instr.expr->evaluate(root);
+                } else {
+                    _registers[instr.dst] = value;
+                }
+                break;
+            }
+            case OpCode::kGuardNumeric:
+            case OpCode::kGuardString:
+                if (!passesGuard(_registers[instr.src], instr.op)) {
+                    _registers[instr.dst] = instr.expr->evaluate(root);
+                    pc = instr.target;
+                }
+                break;
+            case OpCode::kAdd:
+                _registers[instr.dst] = add(instr);
+                break;
+            case OpCode::kSubtract:
+                _registers[instr.dst] = subtract(instr);
+                break;
+            case OpCode::kMultiply:
+                _registers[instr.dst] = multiply(instr);
+                break;
+            case OpCode::kConcat:
+                _registers[instr.dst] = concat(instr);
+                break;
+            case OpCode::kCompare:
+                _registers[instr.dst] = compare(instr);
+                break;
+            case OpCode::kFallback:
+                _registers[instr.dst] = instr.expr->evaluate(root);
+                break;
+        }
+    }
+
+    // Don't hold on to parts of 'root' beyond the results.
+    for (auto&& resolved : _resolvedPaths) {
+        resolved = ResolvedPath();
+    }
+}
+
+const Value& CompiledExpression::resolvePath(const Document& root, size_t pathIdx) const {
+    ResolvedPath& resolved = _resolvedPaths[pathIdx];
+    if (resolved.state != ResolvedPath::State::kUnresolved) {
+        return resolved.value;
+    }
+
+    const Path& path = _paths[pathIdx];
+    if (path.parent == kNoParent) {
+        resolved.value = root[path.fieldName];
+        resolved.state = ResolvedPath::State::kResolved;
+        return resolved.value;
+    }
+
+    const Value& parentValue = resolvePath(root, path.parent);
+    if (_resolvedPaths[path.parent].state == ResolvedPath::State::kCrossesArray ||
+        parentValue.getType() == Array) {
+        resolved.state = ResolvedPath::State::kCrossesArray;
+        return resolved.value;
+    }
+
+    if (parentValue.getType() == Object) {
+        resolved.value = parentValue.getDocument()[path.fieldName];
+    }
+    resolved.state = ResolvedPath::State::kResolved;
+    return resolved.value;
+}
+
+Value CompiledExpression::add(const Instruction& instr) const {
+    // Sums of integers which fit in a long are computed exactly as ExpressionAdd would compute
+    // them, without a compensated sum.
+    long long longTotal = 0;
+    bool overflow = false;
+    BSONType totalType = NumberInt;
+    for (size_t i = 0; i < instr.numOperands; ++i) {
+        const Value& val = operand(instr, i);
+        switch (val.getType()) {
+            case NumberDouble:
+                totalType = NumberDouble;
+                break;
+            case NumberLong:
+                if (totalType == NumberInt)
+                    totalType = NumberLong;
+            // Fallthrough.
+            default:
+                overflow = overflow ||
+                    mongoSignedAddOverflow64(longTotal, val.coerceToLong(), &longTotal);
+                break;
+        }
+    }
+
+    if (totalType != NumberDouble && !overflow) {
+        return totalType == NumberLong ? Value(longTotal) : Value::createIntOrLong(longTotal);
+    }
+
+    // Otherwise, follow ExpressionAdd::evaluate().
+    DoubleDoubleSummation nonDecimalTotal;
+    for (size_t i = 0; i < instr.numOperands; ++i) {
+        const Value& val = operand(instr, i);
+        switch (val.getType()) {
+            case NumberDouble:
+                nonDecimalTotal.addDouble(val.getDouble());
+                break;
+            case NumberLong:
+                nonDecimalTotal.addLong(val.getLong());
+                break;
+            default:
+                nonDecimalTotal.addDouble(val.getInt());
+                break;
+        }
+    }
+
+    switch (totalType) {
+        case NumberLong:
+            if (nonDecimalTotal.fitsLong())
+                return Value(nonDecimalTotal.getLong());
+        // Fallthrough.
+        case NumberInt:
+            if (nonDecimalTotal.fitsLong())
+                return Value::createIntOrLong(nonDecimalTotal.getLong());
+        // Fallthrough.
+        default:
+            return Value(nonDecimalTotal.getDouble());
+    }
+}
+
+Value CompiledExpression::subtract(const Instruction& instr) const {
+    const Value& lhs = operand(instr, 0);
+    const Value& rhs = operand(instr, 1);
+
+    switch (Value::getWidestNumeric(rhs.getType(), lhs.getType())) {
+        case NumberDouble:
+            return Value(lhs.coerceToDouble() - rhs.coerceToDouble());
+        case NumberLong:
+            return Value(lhs.coerceToLong() - rhs.coerceToLong());
+        default:
+            return Value::createIntOrLong(lhs.coerceToLong() - rhs.coerceToLong());
+    }
+}
+
+Value CompiledExpression::multiply(const Instruction& instr) const {
+    // Follows ExpressionMultiply::evaluate() for operands of non-decimal numeric types.
+    double doubleProduct = 1;
+    long long longProduct = 1;
+    BSONType productType = NumberInt;
+    for (size_t i = 0; i < instr.numOperands; ++i) {
+        const Value& val = operand(instr, i);
+        productType = Value::getWidestNumeric(productType, val.getType());
+        doubleProduct *= val.coerceToDouble();
+        if (mongoSignedMultiplyOverflow64(longProduct, val.coerceToLong(), &longProduct)) {
+            productType = NumberDouble;
+        }
+    }
+
+    switch (productType) {
+        case NumberDouble:
+            return Value(doubleProduct);
+        case NumberLong:
+            return Value(longProduct);
+        default:
+            return Value::createIntOrLong(longProduct);
+    }
+}
+
+Value CompiledExpression::concat(const Instruction& instr) const {
+    size_t length = 0;
+    for (size_t i = 0; i < instr.numOperands; ++i) {
+        length += operand(instr, i).getStringData().size();
+    }
+
+    std::string result;
+    result.reserve(length);
+    for (size_t i = 0; i < instr.numOperands; ++i) {
+        const StringData str = operand(instr, i).getStringData();
+        result.append(str.rawData(), str.size());
+    }
+    return Value(std::move(result));
+}
+
+Value CompiledExpression::compare(const Instruction& instr) const {
+    const int cmp = instr.expr->getExpressionContext()->getValueComparator().compare(
+        operand(instr, 0), operand(instr, 1));
+    switch (instr.cmpOp) {
+        case ExpressionCompare::EQ:
+            return Value(cmp == 0);
+        case ExpressionCompare::NE:
+            return Value(cmp != 0);
+        case ExpressionCompare::GT:
+            return Value(cmp > 0);
+        case ExpressionCompare::GTE:
+            return Value(cmp >= 0);
+        case ExpressionCompare::LT:
+            return Value(cmp < 0);
+        case ExpressionCompare::LTE:
+            return Value(cmp <= 0);
+        case ExpressionCompare::CMP:
+            return Value(cmp < 0 ? -1 : cmp > 0 ? 1 : 0);
+    }
+    MONGO_UNREACHABLE;
+}
+
+}  // namespace mongo
@@ -0,0 +1,227 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * A list of aggregation Expression trees flattened into a single register program, for evaluating
+ * the same expressions against many documents.
+ *
+ * Every node of the trees writes its result to a register. $add, $subtract and $multiply over
+ * int, long and double operands, $concat over strings and the comparison expressions are
+ * evaluated directly by the program, without a virtual call per node and without recursion. Field
+ * paths off of $$ROOT or $$CURRENT read their value from a table of paths which is shared by all
+ * of the expressions and filled lazily for each document: each dotted path is resolved at most
+ * once, starting from the already resolved parent path. Constants are loaded into their
+ * registers once, when the program is compiled.
+ *
+ * Whenever an operand turns out not to have a type handled by the program, or a path crosses an
+ * array, the program falls back to the node's own evaluate(), which re-evaluates the node from
+ * scratch and so gives exactly the results and errors of the tree walker. Any other kind of node
+ * is always evaluated this way.
+ *
+ * The program points into the expressions it was compiled from, which must outlive it and must
+ * not be modified or optimized while it is in use. Since evaluation uses registers owned by the
+ * program, a program may only be used by one thread at a time.
+ */
+class CompiledExpression {
+    MONGO_DISALLOW_COPYING(CompiledExpression);
+
+public:
+    /**
+     * Compiles 'roots'. Returns nullptr if compiled evaluation is disabled by
+     * 'internalQueryExecEnableCompiledAggregationExpressions', or if no part of 'roots' can be
+     * evaluated faster than by the expressions themselves.
+     */
+    static std::unique_ptr<CompiledExpression> compile(const std::vector<const Expression*>& roots);
+
+    /**
+     * Evaluates every root against 'root'. The result for each is then available from
+     * getResult() until the next call to evaluate().
+     */
+    void evaluate(const Document& root) const;
+
+    /**
+     * Returns the value of the i-th root for the last document passed to evaluate(). Equivalent
+     * to the value that root's own evaluate() returns for that document.
+     */
+    const Value& getResult(size_t i) const {
+        return _registers[_resultRegisters[i]];
+    }
+
+    /**
+     * Returns the number of instructions in the program. Exposed for testing.
+     */
+    size_t numInstructions() const {
+        return _program.size();
+    }
+
+    /**
+     * Returns the number of instructions which hand a node to its own evaluate(). Exposed for
+     * testing.
+     */
+    size_t numFallbacks() const;
+
+    /**
+     * Returns the number of distinct paths, including prefixes of dotted paths, which the program
+     * resolves. Exposed for testing.
+     */
+    size_t numPaths() const {
+        return _paths.size();
+    }
+
+private:
+    enum class OpCode {
+        // Sets register 'dst' to the value of path 'path', or to the result of evaluating the
+        // field path 'expr' if the path crosses an array.
+        kLoadPath,
+
+        // If register 'src' does not hold an int, long or double (or a string, respectively), sets
+        // register 'dst' to the result of evaluating 'expr' and continues at instruction 'target'.
+        kGuardNumeric,
+        kGuardString,
+
+        // Set register 'dst' to the sum, difference, product or concatenation of the operands.
+        kAdd,
+        kSubtract,
+        kMultiply,
+        kConcat,
+
+        // Sets register 'dst' to the result of comparing the operands with the comparison
+        // operator 'cmpOp'.
+        kCompare,
+
+        // Sets register 'dst' to the result of evaluating 'expr'.
+        kFallback,
+    };
+
+    struct Instruction {
+        OpCode op;
+        const Expression* expr;
+        size_t dst;
+
+        // kGuard*: the register to check. Otherwise, the index in '_operands' of the first
+        // operand register.
+        size_t src;
+
+        // The number of operand registers.
+        size_t numOperands;
+
+        // kLoadPath: the index of the path. kGuard*: the instruction to continue at.
+        size_t target;
+
+        ExpressionCompare::CmpOp cmpOp;
+    };
+
+    struct Path {
+        // Index of the path this one extends by one field, or kNoParent for top-level fields.
+        size_t parent;
+
+        // The last field of the path.
+        std::string fieldName;
+    };
+
+    // The lookup state of one path for the document being evaluated.
+    struct ResolvedPath {
+        enum class State { kUnresolved, kResolved, kCrossesArray };
+
+        State state = State::kUnresolved;
+        Value value;
+    };
+
+    static const size_t kNoParent;
+
+    CompiledExpression() = default;
+
+    /**
+     * Emits the instructions for 'expr' and returns the register which holds its result.
+     */
+    size_t compileNode(const Expression* expr);
+
+    /**
+     * Emits the instructions for n-ary node 'expr', which is evaluated by 'op' once each of its
+     * operands has passed 'guard', if any. Returns the register which holds its result.
+     */
+    size_t compileNary(const ExpressionNary* expr, OpCode op, boost::optional<OpCode> guard);
+
+    size_t emit(OpCode op, const Expression* expr, size_t dst);
+
+    static bool passesGuard(const Value& val, OpCode guard);
+
+    size_t newRegister(Value initialValue = Value());
+
+    /**
+     * Returns the index in '_paths' of the path which 'fieldPath' names below its variable, adding
+     * it and its prefixes as needed.
+     */
+    size_t internPath(const FieldPath& fieldPath);
+
+    const Value& resolvePath(const Document& root, size_t pathIdx) const;
+
+    Value add(const Instruction& instr) const;
+    Value subtract(const Instruction& instr) const;
+    Value multiply(const Instruction& instr) const;
+    Value concat(const Instruction& instr) const;
+    Value compare(const Instruction& instr) const;
+
+    const Value& operand(const Instruction& instr, size_t i) const {
+        return _registers[_operands[instr.src + i]];
+    }
+
+    std::vector<Instruction> _program;
+
+    // The operand registers of all of the instructions, in order.
+    std::vector<size_t> _operands;
+
+    // The register which holds the result of each root.
+    std::vector<size_t> _resultRegisters;
+
+    // Registers which hold constants are filled in by compile() and never written by the program.
+    mutable std::vector<Value> _registers;
+
+    // Every path, along with every prefix of a dotted path, appears exactly once. A path always
+    // comes after its parent.
+    std::vector<Path> _paths;
+
+    mutable std::vector<ResolvedPath> _resolvedPaths;
+};
+
+}  // namespace mongo
@@ -0,0 +1,216 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/compiled_expression.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+boost::intrusive_ptr<Expression> parse(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                       const char* expr) {
+    const BSONObj spec = fromjson(std::string("{e: ") + expr + "}");
+    VariablesParseState vps = expCtx->variablesParseState;
+    return Expression::parseOperand(expCtx, spec.firstElement(), vps);
+}
+
+/**
+ * Evaluates 'expr' against 'doc', returning either the result or the code of the error it throws.
+ */
+StatusWith<Value> evaluateTree(const Expression& expr, const Document& doc) {
+    try {
+        return expr.evaluate(doc);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+StatusWith<Value> evaluateCompiled(const CompiledExpression& compiled,
+                                   size_t i,
+                                   const Document& doc) {
+    try {
+        compiled.evaluate(doc);
+        return compiled.getResult(i);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
+const std::vector<const char*> kExpressions = {
+    "{$add: ['$a', 1]}",
+    "{$add: ['$a', '$b', '$c.d']}",
+    "{$add: ['$a', {$multiply: ['$b', 2]}]}",
+    "{$add: ['$a', {$cond: ['$b', 1, 2]}]}",
+    "{$subtract: ['$a', '$b']}",
+    "{$subtract: ['$c.d', 1.5]}",
+    "{$multiply: ['$a', '$b', '$c.d']}",
+    "{$concat: ['$s', '-', '$t']}",
+    "{$concat: ['$s', {$concat: ['$t', '$s']}]}",
+    "{$eq: ['$a', '$b']}",
+    "{$ne: ['$a', 1]}",
+    "{$gt: ['$a', '$c.d']}",
+    "{$gte: [{$add: ['$a', '$b']}, 10]}",
+    "{$lt: ['$s', '$t']}",
+    "{$lte: ['$a', null]}",
+    "{$cmp: ['$a', '$b']}",
+    "{$cmp: ['$c', {d: 2}]}",
+    "{$add: ['$s', {$concat: [1]}]}",
+    "{$add: ['$$ROOT.a', '$$CURRENT.b']}",
+};
+
+const std::vector<const char*> kDocs = {
+    "{}",
+    "{a: 1, b: 2, c: {d: 3}}",
+    "{a: 1, b: {$numberLong: '2'}, c: {d: 3.5}}",
+    "{a: {$numberLong: '9223372036854775807'}, b: {$numberLong: '9223372036854775807'}, c: {d: 1}}",
+    "{a: 2147483647, b: 2147483647, c: {d: 2147483647}}",
+    "{a: 1.5, b: {$numberDecimal: '2.5'}, c: {d: 1}}",
+    "{a: null, b: 1, c: {d: null}}",
+    "{a: 1, b: 'x', c: [{d: 1}, {d: 2}], s: 'x', t: 'y'}",
+    "{a: [1, 2], b: 1, c: 1, s: null, t: 'y'}",
+    "{a: {$date: 0}, b: 1, c: {d: 1}, s: 'abc', t: 1}",
+    "{a: 5, b: 5, c: {d: 5, e: 1}, s: 'ab', t: 'abc'}",
+};
+
+TEST(CompiledExpressionTest, ResultsMatchTreeWalker) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+
+    std::vector<boost::intrusive_ptr<Expression>> exprs;
+    std::vector<const Expression*> roots;
+    for (auto&& exprStr : kExpressions) {
+        exprs.push_back(parse(expCtx, exprStr));
+        roots.push_back(exprs.back().get());
+    }
+    auto compiled = CompiledExpression::compile(roots);
+    ASSERT(compiled);
+
+    for (auto&& docStr : kDocs) {
+        const Document doc(fromjson(docStr));
+        for (size_t i = 0; i < exprs.size(); ++i) {
+            // Compile each expression on its own too, so that an error in one does not hide the
+            // results of the others.
+            auto single = CompiledExpression::compile({exprs[i].get()});
+            ASSERT(single) << kExpressions[i];
+
+            const auto expected = evaluateTree(*exprs[i], doc);
+            const auto actual = evaluateCompiled(*single, 0, doc);
+            ASSERT_EQ(expected.getStatus().code(), actual.getStatus().code())
+                << kExpressions[i] << " on " << docStr;
+            if (expected.isOK()) {
+                ASSERT_VALUE_EQ(expected.getValue(), actual.getValue());
+                ASSERT_EQ(expected.getValue().getType(), actual.getValue().getType())
+                    << kExpressions[i] << " on " << docStr;
+            }
+        }
+    }
+}
+
+TEST(CompiledExpressionTest, EvaluatesAllRootsAtOnce) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto sum = parse(expCtx, "{$add: ['$a.b', '$a.c']}");
+    auto concat = parse(expCtx, "{$concat: ['$s', '$s']}");
+    auto constant = parse(expCtx, "{$literal: 7}");
+    auto path = parse(expCtx, "'$a.b'");
+
+    auto compiled =
+        CompiledExpression::compile({sum.get(), concat.get(), constant.get(), path.get()});
+    ASSERT(compiled);
+
+    // The paths 'a', 'a.b', 'a.c' and 's' are resolved once each.
+    ASSERT_EQ(4U, compiled->numPaths());
+    ASSERT_EQ(0U, compiled->numFallbacks());
+
+    compiled->evaluate(Document(fromjson("{a: {b: 1, c: 2}, s: 'x'}")));
+    ASSERT_VALUE_EQ(Value(3), compiled->getResult(0));
+    ASSERT_VALUE_EQ(Value("xx"_sd), compiled->getResult(1));
+    ASSERT_VALUE_EQ(Value(7), compiled->getResult(2));
+    ASSERT_VALUE_EQ(Value(1), compiled->getResult(3));
+}
+
+TEST(CompiledExpressionTest, PathsThroughArraysFallBackToTree) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto concat = parse(expCtx, "{$concat: ['$s', '$s']}");
+    auto path = parse(expCtx, "'$a.b'");
+    auto sum = parse(expCtx, "{$add: ['$a.b', 1]}");
+
+    auto compiled = CompiledExpression::compile({concat.get(), path.get()});
+    ASSERT(compiled);
+
+    const Document doc(fromjson("{a: [{b: 1, c: 2}, {b: 3}], s: 'y'}"));
+    compiled->evaluate(doc);
+    ASSERT_VALUE_EQ(Value("yy"_sd), compiled->getResult(0));
+    ASSERT_VALUE_EQ(Value(std::vector<Value>{Value(1), Value(3)}), compiled->getResult(1));
+
+    auto compiledSum = CompiledExpression::compile({sum.get()});
+    ASSERT(compiledSum);
+    ASSERT_EQ(16554, evaluateCompiled(*compiledSum, 0, doc).getStatus().code());
+}
+
+TEST(CompiledExpressionTest, ComparisonsRespectCollation) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kToLowerString);
+    expCtx->setCollator(&collator);
+
+    auto eq = parse(expCtx, "{$eq: ['$s', 'ABC']}");
+    auto compiled = CompiledExpression::compile({eq.get()});
+    ASSERT(compiled);
+
+    compiled->evaluate(Document(fromjson("{s: 'abc'}")));
+    ASSERT_VALUE_EQ(Value(true), compiled->getResult(0));
+}
+
+TEST(CompiledExpressionTest, NotCompiledWhenNothingIsFaster) {
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto toUpper = parse(expCtx, "{$toUpper: '$s'}");
+    auto constant = parse(expCtx, "{$literal: 1}");
+    auto variable = parse(expCtx, "'$$ROOT'");
+    ASSERT_FALSE(CompiledExpression::compile({toUpper.get(), constant.get(), variable.get()}));
+}
+
+TEST(CompiledExpressionTest, NotCompiledWhenDisabled) {
+    internalQueryExecEnableCompiledAggregationExpressions.store(false);
+    ON_BLOCK_EXIT([] { internalQueryExecEnableCompiledAggregationExpressions.store(true); });
+
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto sum = parse(expCtx, "{$add: ['$a', 1]}");
+    ASSERT_FALSE(CompiledExpression::compile({sum.get()}));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,11 +30,13 @@
 
 #include "mongo/db/pipeline/document.h"
 
+#include <array>
 #include <boost/functional/hash.hpp>
 
 #include "mongo/bson/bson_depth.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/field_path.h"
+#include "mongo/util/allocator.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -43,8 +45,155 @@ using boost::intrusive_ptr;
 using std::string;
 using std::vector;
 
+namespace {
+
+/**
+ * A cache of freed DocumentStorage objects and buffers, kept per thread so that it needs no
+ * synchronization. Blocks of up to kMaxCachedBlockBytes bytes are rounded up to a power of two and
+ * kept on one free list per size, threaded through the free blocks themselves.
+ */
+class DocumentStorageCache {
+public:
+    ~DocumentStorageCache() {
+        release();
+    }
+
+    void* allocate(size_t bytes) {
+        if (bytes <= kMaxCachedBlockBytes) {
+            const size_t sizeClass = sizeClassFor(bytes);
+            if (FreeBlock* block = _freeLists[sizeClass]) {
+                _freeLists[sizeClass] = block->next;
+                _cachedBytes -= blockBytes(sizeClass);
+                return block;
+            }
+        }
+        return allocateUncached(bytes);
+    }
+
+    void deallocate(void* ptr, size_t bytes) {
+        if (bytes > kMaxCachedBlockBytes) {
+            free(ptr);
+            return;
+        }
+
+        const size_t sizeClass = sizeClassFor(bytes);
+        if (_cachedBytes + blockBytes(sizeClass) > kMaxCachedBytes) {
+            free(ptr);
+            return;
+        }
+        _freeLists[sizeClass] = new (ptr) FreeBlock{_freeLists[sizeClass]};
+        _cachedBytes += blockBytes(sizeClass);
+    }
+
+    void release() {
+        for (auto&& freeList : _freeLists) {
+            while (FreeBlock* block = freeList) {
+                freeList = block->next;
+                free(block);
+            }
+        }
+        _cachedBytes = 0;
+    }
+
+    /**
+     * Allocates a block without going through any cache. Blocks are always allocated with the
+     * full size of their size class, since they may end up cached by another thread.
+     */
+    static void* allocateUncached(size_t bytes) {
+        return mongoMalloc(bytes <= kMaxCachedBlockBytes ? blockBytes(sizeClassFor(bytes)) : bytes);
+    }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    // The smallest block kept is the smallest buffer DocumentStorage::alloc() asks for.
+    static constexpr size_t kMinCachedBlockBytesLog2 = 7;
+    static constexpr size_t kMaxCachedBlockBytesLog2 = 12;
+    static constexpr size_t kMaxCachedBlockBytes = size_t(1) << kMaxCachedBlockBytesLog2;
+    static constexpr size_t kNumSizeClasses =
+        kMaxCachedBlockBytesLog2 - kMinCachedBlockBytesLog2 + 1;
+
+    // The most memory a thread holds on to between calls to release().
+    static constexpr size_t kMaxCachedBytes = 256 * 1024;
+
+    static size_t sizeClassFor(size_t bytes) {
+        size_t sizeClass = 0;
+        while (blockBytes(sizeClass) < bytes) {
+            ++sizeClass;
+        }
+        return sizeClass;
+    }
+
+    static size_t blockBytes(size_t sizeClass) {
+        return size_t(1) << (kMinCachedBlockBytesLog2 + sizeClass);
+    }
+
+    std::array<FreeBlock*, kNumSizeClasses> _freeLists{};
+    size_t _cachedBytes = 0;
+};
+
+// The cache is created on first use and destroyed with its thread. Blocks freed on a thread after
+// its cache is destroyed, such as by destructors of static objects, bypass the cache.
+thread_local DocumentStorageCache* threadStorageCache = nullptr;
+thread_local bool threadStorageCacheDestroyed = false;
+
+struct DocumentStorageCacheReaper {
+    ~DocumentStorageCacheReaper() {
+        delete threadStorageCache;
+        threadStorageCache = nullptr;
+        threadStorageCacheDestroyed = true;
+    }
+};
+
+DocumentStorageCache* getThreadStorageCache() {
+    if (!threadStorageCache && !threadStorageCacheDestroyed) {
+        static thread_local DocumentStorageCacheReaper reaper;
+        threadStorageCache = new DocumentStorageCache();
+    }
+    return threadStorageCache;
+}
+
+}  // namespace
+
 const DocumentStorage DocumentStorage::kEmptyDoc;
 
+void Document::releaseCachedMemory() {
+    DocumentStorage::releaseCachedMemory();
+}
+
+void* DocumentStorage::operator new(size_t size) {
+    if (auto cache = getThreadStorageCache()) {
+        return cache->allocate(size);
+    }
+    return DocumentStorageCache::allocateUncached(size);
+}
+
+void DocumentStorage::operator delete(void* ptr, size_t size) {
+    if (auto cache = getThreadStorageCache()) {
+        cache->deallocate(ptr, size);
+        return;
+    }
+    free(ptr);
+}
+
+void DocumentStorage::releaseCachedMemory() {
+    if (threadStorageCache) {
+        threadStorageCache->release();
+    }
+}
+
+char* DocumentStorage::allocateBuffer(size_t bytes) {
+    return static_cast<char*>(operator new(bytes));
+}
+
+void DocumentStorage::freeBuffer(char* buffer, size_t bytes) {
+    if (buffer) {
+        operator delete(buffer, bytes);
+    }
+}
+
 const std::vector<StringData> Document::allMetadataFieldNames = {Document::metaFieldTextScore,
                                                                  Document::metaFieldRandVal,
                                                                  Document::metaFieldSortKey,
@@ -139,6 +288,7 @@ void DocumentStorage::alloc(unsigned newSize) {
     const bool firstAlloc = !_buffer;
     const bool doingRehash = needRehash();
     const size_t oldCapacity = _bufferEnd - _buffer;
+    const size_t oldAllocatedBytes = allocatedBytes();
 
     // make new bucket count big enough
     while (needRehash() || hashTabBuckets() < HASH_TAB_INIT_SIZE)
@@ -151,13 +301,13 @@ void DocumentStorage::alloc(unsigned newSize) {
 
     uassert(16490, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    std::unique_ptr<char[]> oldBuf(_buffer);
-    _buffer = new char[capacity];
+    char* const oldBuf = _buffer;
+    _buffer = allocateBuffer(capacity);
     _bufferEnd = _buffer + capacity - hashTabBytes();
 
     if (!firstAlloc) {
         // This just copies the elements
-        memcpy(_buffer, oldBuf.get(), _usedBytes);
+        memcpy(_buffer, oldBuf, _usedBytes);
 
         if (_numFields >= HASH_TAB_MIN) {
             // if we were hashing, deal with the hash table
@@ -165,10 +315,12 @@ void DocumentStorage::alloc(unsigned newSize) {
                 rehash();
             } else {
                 // no rehash needed so just slide table down to new position
-                memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                memcpy(_hashTab, oldBuf + oldCapacity, hashTabBytes());
             }
         }
     }
+
+    freeBuffer(oldBuf, oldAllocatedBytes);
 }
 
 void DocumentStorage::reserveFields(size_t expectedFields) {
@@ -184,7 +336,7 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 
     uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
 
-    _buffer = new char[newSize + hashTabBytes()];
+    _buffer = allocateBuffer(newSize + hashTabBytes());
     _bufferEnd = _buffer + newSize;
 }
 
@@ -194,9 +346,9 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     // Make a copy of the buffer.
     // It is very important that the positions of each field are the same after cloning.
     const size_t bufferBytes = allocatedBytes();
-    out->_buffer = new char[bufferBytes];
-    out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
     if (bufferBytes > 0) {
+        out->_buffer = allocateBuffer(bufferBytes);
+        out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
         memcpy(out->_buffer, _buffer, bufferBytes);
     }
 
@@ -220,11 +372,11 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 }
 
 DocumentStorage::~DocumentStorage() {
-    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
-
     for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
     }
+
+    freeBuffer(_buffer, allocatedBytes());
 }
 
 Document::Document(const BSONObj& bson) {
@@ -104,6 +104,13 @@ public:
     /// Create a new Document deep-converted from the given BSONObj.
     explicit Document(const BSONObj& bson);
 
+    /**
+     * Freed document storage is cached per thread for reuse by the next documents built on that
+     * thread. This frees the calling thread's cache; it is called once a batch of results has been
+     * sent, so that threads between batches do not hold on to memory.
+     */
+    static void releaseCachedMemory();
+
     /**
      * Create a new document from key, value pairs. Enables constructing a document using this
      * syntax:
@@ -194,6 +194,19 @@ public:
 
     ~DocumentStorage();
 
+    /**
+     * DocumentStorage objects, and the buffers holding their fields, are allocated through a
+     * per-thread cache of recently freed blocks, since pipelines tend to build and destroy many
+     * documents of similar sizes on the same thread.
+     */
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr, size_t size);
+
+    /**
+     * Frees the blocks cached for reuse by the calling thread.
+     */
+    static void releaseCachedMemory();
+
     enum MetaType : char {
         TEXT_SCORE,
         RAND_VAL,
@@ -360,6 +373,10 @@ private:
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
+    /// Allocate and free '_buffer' through the per-thread cache.
+    static char* allocateBuffer(size_t bytes);
+    static void freeBuffer(char* buffer, size_t bytes);
+
     /// Call after adding field to _buffer and increasing _numFields
     void addFieldToHashTable(Position pos);
 
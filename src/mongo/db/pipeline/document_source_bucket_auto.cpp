@@ -44,6 +44,8 @@ REGISTER_DOCUMENT_SOURCE(bucketAuto,
                          LiteParsedDocumentSourceDefault::parse,
                          DocumentSourceBucketAuto::createFromBson);
 
+const int DocumentSourceBucketAuto::kApproximateBucketsPerBucket = 32;
+
 const char* DocumentSourceBucketAuto::getSourceName() const {
     return "$bucketAuto";
 }
@@ -52,13 +54,18 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::getNext() {
     pExpCtx->checkForInterrupt();
 
     if (!_populated) {
-        const auto populationResult = populateSorter();
+        const auto populationResult =
+            _approximate ? populateApproximateBuckets() : populateSorter();
         if (populationResult.isPaused()) {
             return populationResult;
         }
         invariant(populationResult.isEOF());
 
-        populateBuckets();
+        if (_approximate) {
+            populateBucketsFromApproximateBuckets();
+        } else {
+            populateBuckets();
+        }
 
         _populated = true;
         _bucketsIterator = _buckets.begin();
@@ -91,7 +98,7 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::populateSorter() {
     if (!_sorter) {
         SortOptions opts;
         opts.maxMemoryUsageBytes = _maxMemoryUsageBytes;
-        if (pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
+        if (pExpCtx->canSpillToDisk()) {
             opts.extSortAllowed = true;
             opts.tempDir = pExpCtx->tempDir;
         }
@@ -113,6 +120,142 @@ DocumentSource::GetNextResult DocumentSourceBucketAuto::populateSorter() {
     return next;
 }
 
+DocumentSource::GetNextResult DocumentSourceBucketAuto::populateApproximateBuckets() {
+    if (!_approximateBuckets) {
+        _approximateBuckets = pExpCtx->getValueComparator().makeOrderedValueMap<Bucket>();
+    }
+
+    const size_t maxApproximateBuckets = 2 * kApproximateBucketsPerBucket * size_t(_nBuckets);
+    auto next = pSource->getNext();
+    for (; next.isAdvanced(); next = pSource->getNext()) {
+        auto nextDoc = next.releaseDocument();
+        addDocumentToApproximateBucket(extractKey(nextDoc), nextDoc);
+        _nDocuments++;
+
+        if (_approximateBuckets->size() >= maxApproximateBuckets) {
+            compactApproximateBuckets();
+        }
+    }
+    return next;
+}
+
+void DocumentSourceBucketAuto::addDocumentToApproximateBucket(const Value& key,
+                                                              const Document& doc) {
+    // Find the last bucket whose minimum is not greater than 'key', and use it if 'key' is within
+    // its range.
+    auto it = _approximateBuckets->upper_bound(key);
+    if (it != _approximateBuckets->begin() &&
+        pExpCtx->getValueComparator().evaluate(key <= std::prev(it)->second._max)) {
+        --it;
+    } else {
+        it = _approximateBuckets->emplace_hint(
+            it, key, Bucket(pExpCtx, key, key, _accumulatedFields));
+    }
+
+    Bucket& bucket = it->second;
+    const size_t numAccumulators = _accumulatedFields.size();
+    for (size_t k = 0; k < numAccumulators; k++) {
+        bucket._accums[k]->process(_accumulatedFields[k].expression->evaluate(doc), false);
+    }
+    bucket._count++;
+}
+
+void DocumentSourceBucketAuto::compactApproximateBuckets() {
+    // Greedily merge neighbours whose combined count stays within twice the average count of the
+    // buckets we want to keep. Any two neighbours left afterwards hold more than that many
+    // documents between them, so at most about 'kApproximateBucketsPerBucket * _nBuckets' buckets
+    // remain.
+    const long long maxMergedCount =
+        std::max(1LL, 2 * _nDocuments / (kApproximateBucketsPerBucket * _nBuckets));
+
+    uint64_t memUsageBytes = 0;
+    auto it = _approximateBuckets->begin();
+    while (it != _approximateBuckets->end()) {
+        auto next = std::next(it);
+        if (next != _approximateBuckets->end() &&
+            it->second._count + next->second._count <= maxMergedCount) {
+            mergeBucket(it->second, next->second);
+            _approximateBuckets->erase(next);
+            continue;
+        }
+
+        memUsageBytes += it->second._min.getApproximateSize() +
+            it->second._max.getApproximateSize();
+        for (auto&& accum : it->second._accums) {
+            memUsageBytes += accum->memUsageForSorter();
+        }
+        it = next;
+    }
+
+    uassert(50965,
+            str::stream() << "$bucketAuto with 'approximate' exceeded the memory limit of "
+                          << _maxMemoryUsageBytes
+                          << " bytes",
+            memUsageBytes <= _maxMemoryUsageBytes);
+}
+
+void DocumentSourceBucketAuto::mergeBucket(Bucket& into, const Bucket& from) {
+    into._max = from._max;
+    into._count += from._count;
+
+    const bool toBeMerged = true;
+    const size_t numAccumulators = into._accums.size();
+    for (size_t k = 0; k < numAccumulators; k++) {
+        into._accums[k]->process(from._accums[k]->getValue(toBeMerged), true);
+    }
+}
+
+void DocumentSourceBucketAuto::populateBucketsFromApproximateBuckets() {
+    invariant(_approximateBuckets);
+    auto approximateBuckets = std::move(*_approximateBuckets);
+    _approximateBuckets = boost::none;
+
+    // Fill each bucket with about this many documents, as populateBuckets() does.
+    long long approxBucketSize = std::round(double(_nDocuments) / double(_nBuckets));
+    if (approxBucketSize < 1) {
+        approxBucketSize = 1;
+    }
+
+    auto it = approximateBuckets.begin();
+    for (int i = 0; i < _nBuckets && it != approximateBuckets.end(); i++) {
+        bool isLastBucket = (i == _nBuckets - 1);
+
+        Bucket currentBucket = it->second;
+        ++it;
+
+        if (isLastBucket) {
+            for (; it != approximateBuckets.end(); ++it) {
+                mergeBucket(currentBucket, it->second);
+            }
+        } else {
+            // Take the next fine-grained bucket whenever that brings the size of this bucket
+            // closer to 'approxBucketSize'.
+            while (it != approximateBuckets.end() &&
+                   2 * currentBucket._count + it->second._count <= 2 * approxBucketSize) {
+                mergeBucket(currentBucket, it->second);
+                ++it;
+            }
+
+            if (_granularityRounder) {
+                // Absorb the fine-grained buckets starting below the rounded boundary.
+                Value boundaryValue = _granularityRounder->roundUp(currentBucket._max);
+                while (it != approximateBuckets.end() &&
+                       pExpCtx->getValueComparator().evaluate(boundaryValue > it->second._min)) {
+                    mergeBucket(currentBucket, it->second);
+                    ++it;
+                }
+                if (it != approximateBuckets.end()) {
+                    currentBucket._max = boundaryValue;
+                }
+            }
+        }
+
+        addBucket(currentBucket);
+    }
+
+    roundOuterBoundariesToGranularity();
+}
+
 Value DocumentSourceBucketAuto::extractKey(const Document& doc) {
     if (!_groupByExpression) {
         return Value(BSONNULL);
@@ -148,6 +291,7 @@ void DocumentSourceBucketAuto::addDocumentToBucket(const pair<Value, Document>&
                                                    Bucket& bucket) {
     invariant(pExpCtx->getValueComparator().evaluate(entry.first >= bucket._max));
     bucket._max = entry.first;
+    bucket._count++;
 
     const size_t numAccumulators = _accumulatedFields.size();
     for (size_t k = 0; k < numAccumulators; k++) {
@@ -254,6 +398,10 @@ void DocumentSourceBucketAuto::populateBuckets() {
         addBucket(currentBucket);
     }
 
+    roundOuterBoundariesToGranularity();
+}
+
+void DocumentSourceBucketAuto::roundOuterBoundariesToGranularity() {
     if (!_buckets.empty() && _granularityRounder) {
         // If we we have a granularity, we round the first bucket's minimum down and the last
         // bucket's maximum up. This way all of the bucket boundaries are rounded to numbers in the
@@ -328,6 +476,7 @@ Document DocumentSourceBucketAuto::makeDocument(const Bucket& bucket) {
 
 void DocumentSourceBucketAuto::doDispose() {
     _sortedInput.reset();
+    _approximateBuckets = boost::none;
     _bucketsIterator = _buckets.end();
 }
 
@@ -342,6 +491,10 @@ Value DocumentSourceBucketAuto::serialize(
         insides["granularity"] = Value(_granularityRounder->getName());
     }
 
+    if (_approximate) {
+        insides["approximate"] = Value(true);
+    }
+
     MutableDocument outputSpec(_accumulatedFields.size());
     for (auto&& accumulatedField : _accumulatedFields) {
         intrusive_ptr<Accumulator> accum = accumulatedField.makeAccumulator(pExpCtx);
@@ -360,7 +513,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes) {
+    uint64_t maxMemoryUsageBytes,
+    bool approximate) {
     uassert(40243,
             str::stream() << "The $bucketAuto 'buckets' field must be greater than 0, but found: "
                           << numBuckets,
@@ -376,7 +530,8 @@ intrusive_ptr<DocumentSourceBucketAuto> DocumentSourceBucketAuto::create(
                                         numBuckets,
                                         accumulationStatements,
                                         granularityRounder,
-                                        maxMemoryUsageBytes);
+                                        maxMemoryUsageBytes,
+                                        approximate);
 }
 
 DocumentSourceBucketAuto::DocumentSourceBucketAuto(
@@ -385,12 +540,14 @@ DocumentSourceBucketAuto::DocumentSourceBucketAuto(
     int numBuckets,
     std::vector<AccumulationStatement> accumulationStatements,
     const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-    uint64_t maxMemoryUsageBytes)
+    uint64_t maxMemoryUsageBytes,
+    bool approximate)
     : DocumentSource(pExpCtx),
       _nBuckets(numBuckets),
       _maxMemoryUsageBytes(maxMemoryUsageBytes),
       _groupByExpression(groupByExpression),
-      _granularityRounder(granularityRounder) {
+      _granularityRounder(granularityRounder),
+      _approximate(approximate) {
 
     invariant(!accumulationStatements.empty());
     for (auto&& accumulationStatement : accumulationStatements) {
@@ -432,6 +589,7 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
     boost::intrusive_ptr<Expression> groupByExpression;
     boost::optional<int> numBuckets;
     boost::intrusive_ptr<GranularityRounder> granularityRounder;
+    bool approximate = false;
 
     for (auto&& argument : elem.Obj()) {
         const auto argName = argument.fieldNameStringData();
@@ -472,6 +630,13 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
                         << typeName(argument.type()),
                     argument.type() == BSONType::String);
             granularityRounder = GranularityRounder::getGranularityRounder(pExpCtx, argument.str());
+        } else if ("approximate" == argName) {
+            uassert(50964,
+                    str::stream()
+                        << "The $bucketAuto 'approximate' field must be a boolean, but found type: "
+                        << typeName(argument.type()),
+                    argument.type() == BSONType::Bool);
+            approximate = argument.boolean();
         } else {
             uasserted(40245, str::stream() << "Unrecognized option to $bucketAuto: " << argName);
         }
@@ -481,8 +646,13 @@ intrusive_ptr<DocumentSource> DocumentSourceBucketAuto::createFromBson(
             "$bucketAuto requires 'groupBy' and 'buckets' to be specified",
             groupByExpression && numBuckets);
 
-    return DocumentSourceBucketAuto::create(
-        pExpCtx, groupByExpression, numBuckets.get(), accumulationStatements, granularityRounder);
+    return DocumentSourceBucketAuto::create(pExpCtx,
+                                            groupByExpression,
+                                            numBuckets.get(),
+                                            accumulationStatements,
+                                            granularityRounder,
+                                            kDefaultMaxMemoryUsageBytes,
+                                            approximate);
 }
 }  // namespace mongo
 
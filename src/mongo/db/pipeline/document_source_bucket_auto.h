@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/granularity_rounder.h"
+#include "mongo/db/pipeline/value_comparator.h"
 #include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
@@ -40,6 +41,13 @@ namespace mongo {
 /**
  * The $bucketAuto stage takes a user-specified number of buckets and automatically determines
  * boundaries such that the values are approximately equally distributed between those buckets.
+ *
+ * By default the stage sorts all of its input by the 'groupBy' value to find the boundaries. With
+ * 'approximate: true', it instead makes a single pass over its input, accumulating documents into
+ * a bounded number of fine-grained buckets whose neighbours are merged as the input grows, and
+ * then combines those into the requested number of buckets. This never sorts or spills, but the
+ * buckets are only approximately equal in size, and accumulators which depend on the order of
+ * their input, such as $first and $push, see documents in input order rather than 'groupBy' order.
  */
 class DocumentSourceBucketAuto final : public DocumentSource, public NeedsMergerDocumentSource {
 public:
@@ -81,7 +89,8 @@ public:
         int numBuckets,
         std::vector<AccumulationStatement> accumulationStatements = {},
         const boost::intrusive_ptr<GranularityRounder>& granularityRounder = nullptr,
-        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes);
+        uint64_t maxMemoryUsageBytes = kDefaultMaxMemoryUsageBytes,
+        bool approximate = false);
 
     /**
      * Parses a $bucketAuto stage from the user-supplied BSON.
@@ -98,7 +107,8 @@ private:
                              int numBuckets,
                              std::vector<AccumulationStatement> accumulationStatements,
                              const boost::intrusive_ptr<GranularityRounder>& granularityRounder,
-                             uint64_t maxMemoryUsageBytes);
+                             uint64_t maxMemoryUsageBytes,
+                             bool approximate);
 
     // struct for holding information about a bucket.
     struct Bucket {
@@ -109,8 +119,12 @@ private:
         Value _min;
         Value _max;
         std::vector<boost::intrusive_ptr<Accumulator>> _accums;
+        long long _count = 0;
     };
 
+    // In approximate mode, the number of fine-grained buckets kept per requested bucket.
+    static const int kApproximateBucketsPerBucket;
+
     /**
      * Consumes all of the documents from the source in the pipeline and sorts them by their
      * 'groupBy' value. This method might not be able to finish populating the sorter in a single
@@ -119,6 +133,41 @@ private:
      */
     GetNextResult populateSorter();
 
+    /**
+     * Consumes all of the documents from the source in the pipeline in approximate mode, adding
+     * each of them to the fine-grained bucket for its 'groupBy' value. Like populateSorter(), this
+     * returns the last GetNextResult encountered, which may be either kEOF or kPauseExecution.
+     */
+    GetNextResult populateApproximateBuckets();
+
+    /**
+     * Adds 'doc' to the fine-grained bucket whose range contains 'key', creating a bucket for
+     * 'key' alone if there is none.
+     */
+    void addDocumentToApproximateBucket(const Value& key, const Document& doc);
+
+    /**
+     * Merges runs of adjacent fine-grained buckets, so that about half as many buckets as allowed
+     * remain. Throws if the buckets are using more memory than allowed.
+     */
+    void compactApproximateBuckets();
+
+    /**
+     * Combines the fine-grained buckets into the requested number of buckets.
+     */
+    void populateBucketsFromApproximateBuckets();
+
+    /**
+     * Merges 'from', which must hold values greater than those in 'into', into 'into'.
+     */
+    void mergeBucket(Bucket& into, const Bucket& from);
+
+    /**
+     * Rounds the minimum of the first bucket and the maximum of the last bucket to the
+     * granularity.
+     */
+    void roundOuterBoundariesToGranularity();
+
     /**
      * Computes the 'groupBy' expression value for 'doc'.
      */
@@ -158,6 +207,12 @@ private:
     boost::intrusive_ptr<Expression> _groupByExpression;
     boost::intrusive_ptr<GranularityRounder> _granularityRounder;
     long long _nDocuments = 0;
+
+    // Whether boundaries are computed in a single pass rather than by sorting the input.
+    const bool _approximate;
+
+    // In approximate mode, the fine-grained buckets, keyed by their minimum values.
+    boost::optional<ValueMap<Bucket>> _approximateBuckets;
 };
 
 }  // namespace mongo
@@ -802,5 +802,77 @@ TEST_F(BucketAutoTests, ShouldFailOnNegativeNumbersWhenGranularitySpecified) {
         AssertionException,
         40260);
 }
+
+TEST_F(BucketAutoTests, SerializesApproximateFieldIfSpecified) {
+    BSONObj spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : true}}");
+    BSONObj expected = fromjson(
+        "{groupBy : '$x', buckets : 2, approximate : true, output : {count : {$sum : {$const : "
+        "1}}}}");
+
+    testSerialize(spec, expected);
+
+    spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : false}}");
+    expected = fromjson("{groupBy : '$x', buckets : 2, output : {count : {$sum : {$const : 1}}}}");
+
+    testSerialize(spec, expected);
+}
+
+TEST_F(BucketAutoTests, FailsWithNonBooleanApproximate) {
+    auto spec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 2, approximate : 1}}");
+    ASSERT_THROWS_CODE(createBucketAuto(spec), AssertionException, 50964);
+}
+
+TEST_F(BucketAutoTests, ApproximateMatchesExactResultsOnSmallInput) {
+    auto exactSpec = fromjson("{$bucketAuto : {groupBy : '$x', buckets : 3}}");
+    auto approximateSpec =
+        fromjson("{$bucketAuto : {groupBy : '$x', buckets : 3, approximate : true}}");
+    deque<Document> inputs = {Document{{"x", 4}},
+                              Document{{"x", 0}},
+                              Document{{"x", 2}},
+                              Document{{"x", 1}},
+                              Document{{"x", 5}},
+                              Document{{"x", 3}}};
+
+    auto exactResults = getResults(exactSpec, inputs);
+    auto approximateResults = getResults(approximateSpec, inputs);
+
+    ASSERT_EQUALS(approximateResults.size(), exactResults.size());
+    for (size_t i = 0; i < exactResults.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(approximateResults[i], exactResults[i]);
+    }
+}
+
+TEST_F(BucketAutoTests, ApproximateProducesEvenContiguousBucketsOverManyDocuments) {
+    const int numDocuments = 20000;
+    const int numBuckets = 4;
+    auto bucketAutoSpec =
+        fromjson("{$bucketAuto : {groupBy : '$x', buckets : 4, approximate : true}}");
+
+    // Feed the values in an order that is far from sorted.
+    deque<Document> inputs;
+    for (int i = 0; i < numDocuments; ++i) {
+        inputs.push_back(Document{{"x", (i * 7919) % numDocuments}});
+    }
+
+    auto results = getResults(bucketAutoSpec, inputs);
+    ASSERT_EQUALS(results.size(), size_t(numBuckets));
+
+    long long totalCount = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        auto count = results[i]["count"].coerceToLong();
+        totalCount += count;
+
+        // Each bucket should hold roughly a quarter of the documents.
+        ASSERT_GT(count, numDocuments / numBuckets / 2);
+        ASSERT_LT(count, numDocuments / numBuckets * 3 / 2);
+
+        if (i > 0) {
+            ASSERT_VALUE_EQ(results[i]["_id"]["min"], results[i - 1]["_id"]["max"]);
+        }
+    }
+    ASSERT_EQUALS(totalCount, numDocuments);
+    ASSERT_VALUE_EQ(results.front()["_id"]["min"], Value(0));
+    ASSERT_VALUE_EQ(results.back()["_id"]["max"], Value(numDocuments - 1));
+}
 }  // namespace
 }  // namespace mongo
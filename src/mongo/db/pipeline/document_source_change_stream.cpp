@@ -131,11 +131,22 @@ StageConstraints DocumentSourceOplogMatch::constraints(Pipeline::SplitState pipe
  */
 Value DocumentSourceOplogMatch::serialize(optional<ExplainOptions::Verbosity> explain) const {
     if (explain) {
+        if (!_rewrittenUserFilter.isEmpty()) {
+            return Value(
+                Document{{kOplogMatchExplainName, Document{{"userFilter", _rewrittenUserFilter}}}});
+        }
         return Value(Document{{kOplogMatchExplainName, Document{}}});
     }
     return Value();
 }
 
+void DocumentSourceOplogMatch::addRewrittenUserFilter(const BSONObj& filter) {
+    joinMatchWith(DocumentSourceMatch::create(filter, pExpCtx));
+    _rewrittenUserFilter = _rewrittenUserFilter.isEmpty()
+        ? filter.getOwned()
+        : BSON("$and" << BSON_ARRAY(_rewrittenUserFilter << filter));
+}
+
 DocumentSourceOplogMatch::DocumentSourceOplogMatch(BSONObj filter,
                                                    const intrusive_ptr<ExpressionContext>& expCtx)
     : DocumentSourceMatch(std::move(filter), expCtx) {}
@@ -156,6 +167,136 @@ void DocumentSourceChangeStream::checkValueType(const Value v,
 //
 namespace {
 
+/**
+ * Returns true if an equality predicate on 'value' compares the same way against the raw oplog,
+ * which is always matched with the simple collation, as it does against the change event.
+ */
+bool isRewritableEqualityValue(const intrusive_ptr<ExpressionContext>& expCtx,
+                               const BSONElement& value) {
+    switch (value.type()) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case NumberDecimal:
+        case jstOID:
+        case Bool:
+        case Date:
+        case bsonTimestamp:
+        case BinData:
+            return true;
+        case String:
+            return !expCtx->getCollator();
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns the oplog 'op' values that can produce a change event with operation type 'opType', or
+ * an empty array if 'opType' is not a string.
+ */
+std::vector<std::string> getOplogOpTypesFor(const BSONElement& opType) {
+    if (opType.type() != String) {
+        return {};
+    }
+    const auto type = opType.valueStringData();
+    if (type == DocumentSourceChangeStream::kInsertOpType) {
+        return {"i"};
+    } else if (type == DocumentSourceChangeStream::kUpdateOpType ||
+               type == DocumentSourceChangeStream::kReplaceOpType) {
+        return {"u"};
+    } else if (type == DocumentSourceChangeStream::kDeleteOpType) {
+        return {"d"};
+    }
+    // Everything else, including unknown types, can only come from a command.
+    return {"c"};
+}
+
+/**
+ * Returns the rewrite of a single user predicate 'pred', or an empty object if it can't be
+ * rewritten.
+ */
+BSONObj rewritePredicateForOplog(const intrusive_ptr<ExpressionContext>& expCtx,
+                                 const BSONElement& pred,
+                                 bool lookingUpPostImage) {
+    // Commands and transactions may produce any kind of event, and no-ops signal new shards to
+    // mongos, so none of them can be discarded based on the event they would produce.
+    const auto commandOrNoop = BSON("op" << BSON("$in" << BSON_ARRAY("c"
+                                                                      << "n")));
+
+    // Unwrap {$eq: <value>}.
+    BSONElement value = pred;
+    if (pred.type() == Object && pred.Obj().nFields() == 1 &&
+        pred.Obj().firstElement().fieldNameStringData() == "$eq"_sd) {
+        value = pred.Obj().firstElement();
+    }
+    const auto fieldName = pred.fieldNameStringData();
+
+    if (fieldName == DocumentSourceChangeStream::kOperationTypeField) {
+        std::set<std::string> ops = {"c", "n"};
+        if (value.type() == Object && value.Obj().nFields() == 1 &&
+            value.Obj().firstElement().fieldNameStringData() == "$in"_sd &&
+            value.Obj().firstElement().type() == Array) {
+            for (auto&& opType : value.Obj().firstElement().Obj()) {
+                auto opsForType = getOplogOpTypesFor(opType);
+                if (opsForType.empty()) {
+                    return BSONObj();
+                }
+                ops.insert(opsForType.begin(), opsForType.end());
+            }
+        } else {
+            auto opsForType = getOplogOpTypesFor(value);
+            if (opsForType.empty()) {
+                return BSONObj();
+            }
+            ops.insert(opsForType.begin(), opsForType.end());
+        }
+        BSONArrayBuilder opsBuilder;
+        for (auto&& op : ops) {
+            opsBuilder.append(op);
+        }
+        return BSON("op" << BSON("$in" << opsBuilder.arr()));
+    }
+
+    if (!isRewritableEqualityValue(expCtx, value)) {
+        return BSONObj();
+    }
+
+    if (fieldName == DocumentSourceChangeStream::kDocumentKeyField + "._id") {
+        // Inserts and deletes carry the _id in 'o', updates in 'o2'.
+        return BSON(OR(BSON("o._id" << value), BSON("o2._id" << value), commandOrNoop));
+    }
+
+    if (fieldName.startsWith(DocumentSourceChangeStream::kFullDocumentField + ".")) {
+        // Inserts and replacements store the full document in 'o'. For other updates 'o' holds
+        // the update modifiers, whose field names start with '$', so only an updateLookup can
+        // produce a matching 'fullDocument'.
+        const auto path =
+            "o" + fieldName.substr(DocumentSourceChangeStream::kFullDocumentField.size());
+        auto fullDocumentMatch = BSON("op" << BSON("$in" << BSON_ARRAY("i"
+                                                                        << "u"))
+                                           << path
+                                           << value);
+        if (lookingUpPostImage) {
+            return BSON(OR(fullDocumentMatch,
+                           BSON("op"
+                                << "u"),
+                           commandOrNoop));
+        }
+        return BSON(OR(fullDocumentMatch, commandOrNoop));
+    }
+
+    if (fieldName == DocumentSourceChangeStream::kNamespaceField + ".coll" &&
+        value.type() == String &&
+        DocumentSourceChangeStream::getChangeStreamType(expCtx->ns) ==
+            DocumentSourceChangeStream::ChangeStreamType::kSingleDatabase) {
+        return BSON(OR(BSON("ns" << expCtx->ns.db() + "." + value.valueStringData()),
+                       commandOrNoop));
+    }
+
+    return BSONObj();
+}
+
 /**
  * Constructs the filter which will match 'applyOps' oplog entries that are:
  * 1) Part of a transaction
@@ -246,8 +387,16 @@ BSONObj DocumentSourceChangeStream::buildMatchFilter(
     auto commandsOnTargetDb =
         BSON("$and" << BSON_ARRAY(cmdNsFilter << BSON("$or" << relevantCommands.arr())));
 
+    // Every open change stream evaluates this filter against each new oplog entry, so when
+    // watching a single collection compare namespaces for equality rather than running a regex.
+    auto nsMatchFor = [&](StringData fieldName) {
+        return sourceType == ChangeStreamType::kSingleCollection
+            ? BSON(fieldName << nss.ns())
+            : BSON(fieldName << BSONRegEx(getNsRegexForChangeStream(nss)));
+    };
+
     // 1.2) Supported commands that have arbitrary db namespaces in "ns" field.
-    auto renameDropTarget = BSON("o.to" << BSONRegEx(getNsRegexForChangeStream(nss)));
+    auto renameDropTarget = nsMatchFor("o.to");
 
     // All supported commands that are either (1.1) or (1.2).
     BSONObj commandMatch = BSON("op"
@@ -264,7 +413,7 @@ BSONObj DocumentSourceChangeStream::buildMatchFilter(
                                    << "migrateChunkToNewShard");
 
     // 2) Supported operations on the target namespace.
-    BSONObj nsMatch = BSON("ns" << BSONRegEx(getNsRegexForChangeStream(nss)));
+    BSONObj nsMatch = nsMatchFor("ns");
     auto opMatch = BSON(nsMatch["ns"] << OR(normalOpTypeMatch, chunkMigratedMatch));
 
     // 3) Look for 'applyOps' which were created as part of a transaction.
@@ -278,6 +427,38 @@ BSONObj DocumentSourceChangeStream::buildMatchFilter(
                                      << BSON("fromMigrate" << NE << true)));
 }
 
+BSONObj DocumentSourceChangeStream::rewriteFilterForOplog(
+    const intrusive_ptr<ExpressionContext>& expCtx,
+    const BSONObj& userFilter,
+    bool lookingUpPostImage) {
+    BSONArrayBuilder rewritten;
+    int numRewritten = 0;
+    auto rewritePredicates = [&](const BSONObj& predicates, auto& rewritePredicatesRef) -> void {
+        for (auto&& pred : predicates) {
+            if (pred.fieldNameStringData() == "$and"_sd && pred.type() == Array) {
+                for (auto&& conjunct : pred.Obj()) {
+                    if (conjunct.type() == Object) {
+                        rewritePredicatesRef(conjunct.Obj(), rewritePredicatesRef);
+                    }
+                }
+                continue;
+            }
+            // Dropping a conjunct which can't be rewritten only makes the filter less selective.
+            auto rewrittenPred = rewritePredicateForOplog(expCtx, pred, lookingUpPostImage);
+            if (!rewrittenPred.isEmpty()) {
+                rewritten.append(rewrittenPred);
+                ++numRewritten;
+            }
+        }
+    };
+    rewritePredicates(userFilter, rewritePredicates);
+
+    if (numRewritten == 0) {
+        return BSONObj();
+    }
+    return BSON("$and" << rewritten.arr());
+}
+
 namespace {
 
 /**
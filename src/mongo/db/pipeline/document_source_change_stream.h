@@ -169,6 +169,20 @@ public:
                                     Timestamp startFrom,
                                     bool startFromInclusive);
 
+    /**
+     * Rewrites the predicates of 'userFilter', a $match on change events, which can be expressed
+     * on raw oplog fields into a filter which every oplog entry that can produce a matching event
+     * also matches. Handles equality on 'operationType' (or $in), on 'documentKey._id', on
+     * 'fullDocument' paths and, for whole-database streams, on 'ns.coll'. Returns an empty object
+     * if no predicate can be rewritten. The user's $match must still be applied to the events;
+     * this only lets oplog entries be discarded before they are transformed.
+     *
+     * 'lookingUpPostImage' must be true if 'fullDocument' is populated by an updateLookup.
+     */
+    static BSONObj rewriteFilterForOplog(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                         const BSONObj& userFilter,
+                                         bool lookingUpPostImage);
+
     /**
      * Parses a $changeStream stage from 'elem' and produces the $match and transformation
      * stages required.
@@ -229,8 +243,16 @@ public:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain) const final;
 
+    /**
+     * Adds 'filter', a user $match rewritten by rewriteFilterForOplog(), to the filter applied to
+     * the oplog scan. It is reported in explain output.
+     */
+    void addRewrittenUserFilter(const BSONObj& filter);
+
 private:
     DocumentSourceOplogMatch(BSONObj filter, const boost::intrusive_ptr<ExpressionContext>& expCtx);
+
+    BSONObj _rewrittenUserFilter;
 };
 
 }  // namespace mongo
@@ -855,6 +855,66 @@ TEST_F(ChangeStreamStageTest, TransformApplyOpsWithEntriesOnDifferentNs) {
     ASSERT_EQ(results.size(), 0u);
 }
 
+TEST_F(ChangeStreamStageTest, TransformApplyOpsSkipsEntriesOnNamespaceDifferingOnlyAtDot) {
+    // The watched namespace has to match exactly, so a '.' in it must not match any character.
+    Document applyOpsDoc{
+        {"applyOps",
+         Value{std::vector<Document>{
+             Document{{"op", "i"_sd},
+                      {"ns", "unittestsXchange_stream"_sd},
+                      {"ui", UUID::gen()},
+                      {"o", Value{Document{{"_id", 123}, {"x", "hallo"_sd}}}}},
+         }}},
+    };
+    LogicalSessionFromClient lsid = testLsid();
+    vector<Document> results = getApplyOpsResults(applyOpsDoc, lsid);
+
+    ASSERT_EQ(results.size(), 0u);
+}
+
+TEST_F(ChangeStreamStageTest, RewriteFilterForOplogRewritesOperationType) {
+    auto rewritten = DSChangeStream::rewriteFilterForOplog(
+        getExpCtx(), fromjson("{operationType: 'insert'}"), false);
+    ASSERT_BSONOBJ_EQ(fromjson("{$and: [{op: {$in: ['c', 'i', 'n']}}]}"), rewritten);
+
+    rewritten = DSChangeStream::rewriteFilterForOplog(
+        getExpCtx(), fromjson("{operationType: {$in: ['update', 'drop']}}"), false);
+    ASSERT_BSONOBJ_EQ(fromjson("{$and: [{op: {$in: ['c', 'n', 'u']}}]}"), rewritten);
+}
+
+TEST_F(ChangeStreamStageTest, RewriteFilterForOplogRewritesDocumentKeyAndFullDocument) {
+    auto rewritten = DSChangeStream::rewriteFilterForOplog(
+        getExpCtx(), fromjson("{$and: [{'documentKey._id': 5}, {'fullDocument.x': 'a'}]}"), false);
+    ASSERT_BSONOBJ_EQ(fromjson("{$and: [{$or: [{'o._id': 5}, {'o2._id': 5},"
+                               "                  {op: {$in: ['c', 'n']}}]},"
+                               "         {$or: [{op: {$in: ['i', 'u']}, 'o.x': 'a'},"
+                               "                  {op: {$in: ['c', 'n']}}]}]}"),
+                      rewritten);
+
+    // With an updateLookup, any update may end up with a matching 'fullDocument'.
+    rewritten = DSChangeStream::rewriteFilterForOplog(
+        getExpCtx(), fromjson("{'fullDocument.x': 'a'}"), true);
+    ASSERT_BSONOBJ_EQ(fromjson("{$and: [{$or: [{op: {$in: ['i', 'u']}, 'o.x': 'a'}, {op: 'u'},"
+                               "                  {op: {$in: ['c', 'n']}}]}]}"),
+                      rewritten);
+}
+
+TEST_F(ChangeStreamStageTest, RewriteFilterForOplogIgnoresPredicatesItCannotRewrite) {
+    // Predicates on fields that don't map onto the oplog, and comparisons other than equality.
+    ASSERT_BSONOBJ_EQ(BSONObj(),
+                      DSChangeStream::rewriteFilterForOplog(
+                          getExpCtx(),
+                          fromjson("{'updateDescription.updatedFields.x': 1,"
+                                   " 'fullDocument.y': {$gt: 3}, 'documentKey._id': {a: 1}}"),
+                          false));
+
+    // Only the rewritable conjunct is kept.
+    ASSERT_BSONOBJ_EQ(
+        fromjson("{$and: [{op: {$in: ['c', 'd', 'n']}}]}"),
+        DSChangeStream::rewriteFilterForOplog(
+            getExpCtx(), fromjson("{operationType: 'delete', 'fullDocument.y': {$gt: 3}}"), false));
+}
+
 
 TEST_F(ChangeStreamStageTest, TransformApplyOps) {
     // Doesn't use the checkTransformation() pattern that other tests use since we expect multiple
@@ -41,6 +41,8 @@
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
+#include "mongo/db/pipeline/document_source_change_stream_close_cursor.h"
+#include "mongo/db/pipeline/document_source_check_invalidate.h"
 #include "mongo/db/pipeline/document_source_check_resume_token.h"
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
@@ -84,7 +86,10 @@ DocumentSourceChangeStreamTransform::DocumentSourceChangeStreamTransform(
       _isIndependentOfAnyCollection(expCtx->ns.isCollectionlessAggregateNS()),
       _fcv(fcv) {
 
-    _nsRegex.emplace(DocumentSourceChangeStream::getNsRegexForChangeStream(expCtx->ns));
+    if (DocumentSourceChangeStream::getChangeStreamType(expCtx->ns) !=
+        DocumentSourceChangeStream::ChangeStreamType::kSingleCollection) {
+        _nsRegex.emplace(DocumentSourceChangeStream::getNsRegexForChangeStream(expCtx->ns));
+    }
 
     auto spec = DocumentSourceChangeStreamSpec::parse(IDLParserErrorContext("$changeStream"),
                                                       _changeStreamSpec);
@@ -96,6 +101,7 @@ DocumentSourceChangeStreamTransform::DocumentSourceChangeStreamTransform(
     if (resumeAfter || startAfter) {
         ResumeToken token = resumeAfter ? resumeAfter.get() : startAfter.get();
         ResumeTokenData tokenData = token.getData();
+        _resumeTokenClusterTime = tokenData.clusterTime;
 
         if (!tokenData.documentKey.missing() && tokenData.uuid) {
             std::vector<FieldPath> docKeyFields;
@@ -451,6 +457,55 @@ DocumentSource::GetNextResult DocumentSourceChangeStreamTransform::getNext() {
     return applyTransformation(input.releaseDocument());
 }
 
+Pipeline::SourceContainer::iterator DocumentSourceChangeStreamTransform::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    // The oplog match only precedes this stage where the pipeline reads the oplog directly.
+    if (_pushedDownUserMatch || itr == container->begin()) {
+        return std::next(itr);
+    }
+    auto oplogMatch = dynamic_cast<DocumentSourceOplogMatch*>(std::prev(itr)->get());
+    if (!oplogMatch) {
+        return std::next(itr);
+    }
+
+    // Skip over the other stages that $changeStream expands to. None of them drops or changes
+    // events for reasons that depend on the user's filter, except that a post-image lookup
+    // replaces 'fullDocument'.
+    bool lookingUpPostImage = false;
+    auto nextStage = std::next(itr);
+    for (; nextStage != container->end(); ++nextStage) {
+        auto stage = nextStage->get();
+        if (dynamic_cast<DocumentSourceLookupChangePostImage*>(stage)) {
+            lookingUpPostImage = true;
+        } else if (!dynamic_cast<DocumentSourceCheckInvalidate*>(stage) &&
+                   !dynamic_cast<DocumentSourceEnsureResumeTokenPresent*>(stage) &&
+                   !dynamic_cast<DocumentSourceShardCheckResumability*>(stage) &&
+                   !dynamic_cast<DocumentSourceCloseCursor*>(stage)) {
+            break;
+        }
+    }
+    if (nextStage == container->end()) {
+        return std::next(itr);
+    }
+    auto userMatch = dynamic_cast<DocumentSourceMatch*>(nextStage->get());
+    if (!userMatch || dynamic_cast<DocumentSourceOplogMatch*>(userMatch)) {
+        return std::next(itr);
+    }
+
+    auto rewritten = DocumentSourceChangeStream::rewriteFilterForOplog(
+        pExpCtx, userMatch->getQuery(), lookingUpPostImage);
+    if (!rewritten.isEmpty()) {
+        if (_resumeTokenClusterTime) {
+            rewritten = BSON(OR(BSON("ts" << *_resumeTokenClusterTime), rewritten));
+        }
+        oplogMatch->addRewrittenUserFilter(rewritten);
+    }
+    _pushedDownUserMatch = true;
+    return std::next(itr);
+}
+
 bool DocumentSourceChangeStreamTransform::isDocumentRelevant(const Document& d) {
     invariant(
         d["op"].getType() == BSONType::String,
@@ -463,6 +518,9 @@ bool DocumentSourceChangeStreamTransform::isDocumentRelevant(const Document& d)
     Value nsField = d["ns"];
     invariant(!nsField.missing());
 
+    if (!_nsRegex) {
+        return nsField.getStringData() == pExpCtx->ns.ns();
+    }
     return _nsRegex->PartialMatch(nsField.getString());
 }
 
@@ -57,6 +57,15 @@ public:
         return DocumentSourceChangeStream::kStageName.rawData();
     }
 
+protected:
+    /**
+     * Rewrites the user $match which follows the change stream stages, if any, into a filter on
+     * raw oplog fields and adds it to the preceding DocumentSourceOplogMatch, so that oplog entries
+     * which can't produce a matching event are discarded by the oplog scan.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
     // This constructor is private, callers should use the 'create()' method above.
     DocumentSourceChangeStreamTransform(const boost::intrusive_ptr<ExpressionContext>&,
@@ -147,6 +156,13 @@ private:
     // Represents if the current 'applyOps' we're unwinding, if any.
     boost::optional<TransactionContext> _txnContext;
 
+    // The cluster time of the resume token this stream was opened with, if any. The oplog entries
+    // at this time must reach the resume stage even if they don't match the user's filter.
+    boost::optional<Timestamp> _resumeTokenClusterTime;
+
+    // Set to true once a user $match has been rewritten into the oplog scan.
+    bool _pushedDownUserMatch = false;
+
     // Set to true if this transformation stage can be run on the collectionless namespace.
     bool _isIndependentOfAnyCollection;
 
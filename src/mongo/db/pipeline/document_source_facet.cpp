@@ -30,6 +30,7 @@
 
 #include "mongo/db/pipeline/document_source_facet.h"
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/client.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_tee_consumer.h"
 #include "mongo/db/pipeline/expression_context.h"
@@ -44,7 +46,10 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -55,6 +60,70 @@ using std::pair;
 using std::string;
 using std::vector;
 
+namespace {
+
+// The upper bound on 'internalQueryFacetParallelism', and so on the number of threads any one
+// $facet uses.
+constexpr size_t kMaxFacetParallelism = 64;
+
+/**
+ * The state shared between a $facet and the worker threads running its facets.
+ */
+struct ParallelFacetExecution {
+    // A copy of each facet, reading from its own consumer of the $facet's TeeBuffer.
+    std::vector<std::unique_ptr<Pipeline, PipelineDeleter>> pipelines;
+
+    // The results of each facet, each written only by the worker running that facet.
+    std::vector<std::vector<Value>> results;
+
+    // Guards the members below, which are written by the worker threads.
+    stdx::mutex mutex;
+    stdx::condition_variable workerFinished;
+    size_t numRunning = 0;
+    Status status = Status::OK();
+
+    // The threads of the workers. Released once none of them is running.
+    ParallelWorkerPool::Reservation workers;
+};
+
+/**
+ * Runs the facets 'facetIds' of 'parallel' until they are all exhausted, consuming each batch of
+ * 'teeBuffer' as soon as it is loaded. Throws if 'opCtx' is interrupted while waiting for a batch.
+ */
+void runParallelFacets(OperationContext* opCtx,
+                       ParallelFacetExecution* parallel,
+                       TeeBuffer* teeBuffer,
+                       std::vector<size_t> facetIds) {
+    uint64_t generation = 0;
+    while (!facetIds.empty()) {
+        generation = teeBuffer->waitForBatchAfter(opCtx, generation);
+
+        for (auto it = facetIds.begin(); it != facetIds.end();) {
+            const auto& pipeline = parallel->pipelines[*it];
+            auto next = pipeline->getSources().back()->getNext();
+            for (; next.isAdvanced(); next = pipeline->getSources().back()->getNext()) {
+                parallel->results[*it].emplace_back(next.releaseDocument());
+            }
+
+            if (next.isEOF()) {
+                // Some facets, such as those ending in a $limit, stop before consuming all input.
+                teeBuffer->dispose(*it);
+                it = facetIds.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+}  // namespace
+
+ParallelWorkerPool* DocumentSourceFacet::getParallelWorkerPool() {
+    static ParallelWorkerPool* const pool =
+        new ParallelWorkerPool("ParallelFacet", kMaxFacetParallelism);
+    return pool;
+}
+
 DocumentSourceFacet::DocumentSourceFacet(std::vector<FacetPipeline> facetPipelines,
                                          const intrusive_ptr<ExpressionContext>& expCtx)
     : DocumentSource(expCtx),
@@ -175,8 +244,20 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
         return GetNextResult::makeEOF();
     }
 
+    // Every worker must be running for the facets to consume a batch, so only run them in parallel
+    // if the pool can spare a thread for each worker right now.
+    boost::optional<ParallelWorkerPool::Reservation> workers;
+    const size_t parallelism = parallelismForExecution();
+    if (parallelism > 1) {
+        workers = getParallelWorkerPool()->tryReserve(parallelism);
+    }
+
     vector<vector<Value>> results(_facets.size());
-    bool allPipelinesEOF = false;
+    if (workers) {
+        results = runFacetsInParallel(std::move(*workers));
+    }
+
+    bool allPipelinesEOF = static_cast<bool>(workers);
     while (!allPipelinesEOF) {
         allPipelinesEOF = true;  // Set this to false if any pipeline isn't EOF.
         for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
@@ -198,6 +279,155 @@ DocumentSource::GetNextResult DocumentSourceFacet::getNext() {
     return resultDoc.freeze();
 }
 
+size_t DocumentSourceFacet::parallelismForExecution() const {
+    const int parallelism = internalQueryFacetParallelism.load();
+    if (parallelism <= 1 || _facets.size() < 2 || !pExpCtx->opCtx || pExpCtx->inMongos ||
+        pExpCtx->explain) {
+        return 1;
+    }
+
+    // A facet which optimized away all of its stages could not be reparsed.
+    if (std::any_of(_facets.begin(), _facets.end(), [](const FacetPipeline& facet) {
+            return facet.pipeline->getSources().empty();
+        })) {
+        return 1;
+    }
+
+    // The workers do not run as part of this operation, so they must not read from any other
+    // collection.
+    vector<NamespaceString> involvedCollections;
+    addInvolvedCollections(&involvedCollections);
+    if (!involvedCollections.empty()) {
+        return 1;
+    }
+
+    // Each facet is reparsed in its own ExpressionContext, in which variables defined outside of
+    // the $facet would not be available.
+    DepsTracker deps;
+    getDependencies(&deps);
+    if (!deps.vars.empty()) {
+        return 1;
+    }
+
+    return std::min(static_cast<size_t>(parallelism), _facets.size());
+}
+
+vector<vector<Value>> DocumentSourceFacet::runFacetsInParallel(
+    ParallelWorkerPool::Reservation workers) {
+    const size_t parallelism = workers.size();
+    auto parallel = std::make_shared<ParallelFacetExecution>();
+    parallel->workers = std::move(workers);
+    parallel->results.resize(_facets.size());
+    for (size_t facetId = 0; facetId < _facets.size(); ++facetId) {
+        vector<BSONObj> rawPipeline;
+        for (auto&& stage : _facets[facetId].pipeline->serialize()) {
+            rawPipeline.push_back(stage.getDocument().toBson());
+        }
+
+        auto facetExpCtx = pExpCtx->copyWith(pExpCtx->ns);
+        auto pipeline = uassertStatusOK(Pipeline::parseFacetPipeline(rawPipeline, facetExpCtx));
+        pipeline->addInitialSource(
+            DocumentSourceTeeConsumer::create(facetExpCtx, facetId, _teeBuffer));
+        pipeline->optimizePipeline();
+        facetExpCtx->opCtx = nullptr;
+        parallel->pipelines.push_back(std::move(pipeline));
+    }
+
+    // The copies are disposed of and destroyed here, on the thread owning this operation, once
+    // their workers are done.
+    auto cleanUp = [&] {
+        for (auto&& pipeline : parallel->pipelines) {
+            _usedDisk = _usedDisk || pipeline->usedDisk();
+            pipeline->getContext()->opCtx = pExpCtx->opCtx;
+        }
+        parallel->pipelines.clear();
+        _teeBuffer->endConcurrentConsumption();
+    };
+
+    auto abandon = [&] {
+        _teeBuffer->cancelConcurrentConsumption();
+        stdx::unique_lock<stdx::mutex> lk(parallel->mutex);
+        parallel->workerFinished.wait(lk, [&] { return parallel->numRunning == 0; });
+        lk.unlock();
+        parallel->workers.release();
+        cleanUp();
+    };
+
+    _teeBuffer->beginConcurrentConsumption();
+    auto serviceContext = pExpCtx->opCtx->getServiceContext();
+    auto teeBuffer = _teeBuffer.get();
+    for (size_t worker = 0; worker < parallelism; ++worker) {
+        vector<size_t> facetIds;
+        for (size_t facetId = worker; facetId < _facets.size(); facetId += parallelism) {
+            facetIds.push_back(facetId);
+        }
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(parallel->mutex);
+            ++parallel->numRunning;
+        }
+        auto scheduleStatus = parallel->workers.schedule(
+            [parallel, serviceContext, teeBuffer, facetIds] {
+                Status status = Status::OK();
+                {
+                    auto client = serviceContext->makeClient("ParallelFacet");
+                    AlternativeClientRegion acr(client);
+                    auto opCtx = cc().makeOperationContext();
+
+                    for (auto facetId : facetIds) {
+                        parallel->pipelines[facetId]->getContext()->opCtx = opCtx.get();
+                    }
+                    try {
+                        runParallelFacets(opCtx.get(), parallel.get(), teeBuffer, facetIds);
+                    } catch (const DBException& ex) {
+                        status = ex.toStatus();
+                        teeBuffer->cancelConcurrentConsumption();
+                    }
+                    for (auto facetId : facetIds) {
+                        parallel->pipelines[facetId]->getContext()->opCtx = nullptr;
+                    }
+                }
+
+                // The $facet may go away as soon as the count drops to zero, so this must be the
+                // last access to anything it owns.
+                stdx::lock_guard<stdx::mutex> lk(parallel->mutex);
+                if (!status.isOK() && parallel->status.isOK()) {
+                    parallel->status = status;
+                }
+                --parallel->numRunning;
+                parallel->workerFinished.notify_all();
+            });
+
+        if (!scheduleStatus.isOK()) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(parallel->mutex);
+                --parallel->numRunning;
+            }
+            abandon();
+            uassertStatusOK(scheduleStatus);
+        }
+    }
+
+    // Read the input on this thread, handing the next batch to the facets once they have all
+    // consumed the previous one.
+    try {
+        while (_teeBuffer->loadNextBatchWhenConsumed(pExpCtx->opCtx)) {
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(parallel->mutex);
+        pExpCtx->opCtx->waitForConditionOrInterrupt(
+            parallel->workerFinished, lk, [&] { return parallel->numRunning == 0; });
+    } catch (const DBException&) {
+        abandon();
+        throw;
+    }
+
+    parallel->workers.release();
+    cleanUp();
+    uassertStatusOK(parallel->status);
+    return std::move(parallel->results);
+}
+
 Value DocumentSourceFacet::serialize(boost::optional<ExplainOptions::Verbosity> explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facets) {
@@ -275,6 +505,9 @@ StageConstraints DocumentSourceFacet::constraints(Pipeline::SplitState) const {
 }
 
 bool DocumentSourceFacet::usedDisk() {
+    if (_usedDisk) {
+        return true;
+    }
     for (auto&& facet : _facets) {
         if (facet.pipeline->usedDisk())
             return true;
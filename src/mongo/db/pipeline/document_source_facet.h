@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/lite_parsed_pipeline.h"
+#include "mongo/db/pipeline/parallel_worker_pool.h"
 #include "mongo/db/pipeline/pipeline.h"
 
 namespace mongo {
@@ -94,6 +95,11 @@ public:
         std::vector<FacetPipeline> facetPipelines,
         const boost::intrusive_ptr<ExpressionContext>& expCtx);
 
+    /**
+     * Returns the pool whose threads run the facets of $facet stages executing in parallel.
+     */
+    static ParallelWorkerPool* getParallelWorkerPool();
+
     /**
      * Blocking call. Will consume all input and produces one output document.
      */
@@ -151,9 +157,24 @@ private:
 
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
 
+    /**
+     * Returns the number of threads which should run the facets, or 1 if they should all be run
+     * on the calling thread.
+     */
+    size_t parallelismForExecution() const;
+
+    /**
+     * Runs a copy of every facet on the threads reserved by 'workers', while this thread feeds them
+     * their input through '_teeBuffer'. Returns the results of each facet.
+     */
+    std::vector<std::vector<Value>> runFacetsInParallel(ParallelWorkerPool::Reservation workers);
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     std::vector<FacetPipeline> _facets;
 
     bool _done = false;
+
+    // Whether one of the facets run by runFacetsInParallel() used disk.
+    bool _usedDisk = false;
 };
 }  // namespace mongo
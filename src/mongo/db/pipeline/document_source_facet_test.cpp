@@ -43,8 +43,13 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_skip.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 using std::deque;
@@ -427,6 +432,161 @@ TEST_F(DocumentSourceFacetTest, ShouldPropagateDisposeThroughToSource) {
     ASSERT_TRUE(mockSource->isDisposed);
 }
 
+Document runFacetOverRange(const boost::intrusive_ptr<ExpressionContext>& ctx,
+                           BSONObj spec,
+                           int nDocs,
+                           boost::intrusive_ptr<DocumentSourceMock>* source) {
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < nDocs; ++i) {
+        inputs.emplace_back(Document{{"_id", i}, {"mod", i % 7}});
+    }
+    *source = DocumentSourceMock::create(inputs);
+
+    auto facetStage = DocumentSourceFacet::createFromBson(spec.firstElement(), ctx);
+    facetStage->setSource(source->get());
+
+    auto output = facetStage->getNext();
+    ASSERT(output.isAdvanced());
+    ASSERT(facetStage->getNext().isEOF());
+    facetStage->dispose();
+    return output.releaseDocument();
+}
+
+TEST_F(DocumentSourceFacetTest, ParallelFacetsShouldProduceSameResultsAsSerialFacets) {
+    auto ctx = getExpCtx();
+
+    // Use a small buffer so that the facets see their input over many batches.
+    const auto originalBufferSize = internalQueryFacetBufferSizeBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryFacetBufferSizeBytes.store(originalBufferSize); });
+    internalQueryFacetBufferSizeBytes.store(1024);
+
+    const auto spec = fromjson(
+        "{$facet: {"
+        "  all: [{$skip: 0}],"
+        "  first: [{$limit: 3}],"
+        "  counts: [{$group: {_id: '$mod', count: {$sum: 1}}}, {$sort: {_id: 1}}],"
+        "  odd: [{$match: {_id: {$mod: [2, 1]}}}, {$skip: 100}, {$project: {_id: 1}}]"
+        "}}");
+
+    boost::intrusive_ptr<DocumentSourceMock> serialSource;
+    auto serialResult = runFacetOverRange(ctx, spec, 1000, &serialSource);
+    ASSERT_TRUE(serialSource->isDisposed);
+
+    const auto originalParallelism = internalQueryFacetParallelism.load();
+    ON_BLOCK_EXIT([&] { internalQueryFacetParallelism.store(originalParallelism); });
+    for (int parallelism : {2, 3, 4, 8}) {
+        internalQueryFacetParallelism.store(parallelism);
+
+        boost::intrusive_ptr<DocumentSourceMock> parallelSource;
+        auto parallelResult = runFacetOverRange(ctx, spec, 1000, &parallelSource);
+        ASSERT_DOCUMENT_EQ(parallelResult, serialResult);
+        ASSERT_TRUE(parallelSource->isDisposed);
+    }
+}
+
+TEST_F(DocumentSourceFacetTest, ParallelFacetsShouldHandleEmptyInput) {
+    const auto originalParallelism = internalQueryFacetParallelism.load();
+    ON_BLOCK_EXIT([&] { internalQueryFacetParallelism.store(originalParallelism); });
+    internalQueryFacetParallelism.store(4);
+
+    boost::intrusive_ptr<DocumentSourceMock> source;
+    auto result = runFacetOverRange(
+        getExpCtx(), fromjson("{$facet: {a: [{$skip: 1}], b: [{$limit: 1}]}}"), 0, &source);
+    ASSERT_DOCUMENT_EQ(result, Document(fromjson("{a: [], b: []}")));
+    ASSERT_TRUE(source->isDisposed);
+}
+
+TEST_F(DocumentSourceFacetTest, ParallelFacetsShouldPropagateErrors) {
+    const auto originalParallelism = internalQueryFacetParallelism.load();
+    ON_BLOCK_EXIT([&] { internalQueryFacetParallelism.store(originalParallelism); });
+    internalQueryFacetParallelism.store(2);
+
+    auto ctx = getExpCtx();
+    deque<DocumentSource::GetNextResult> inputs = {Document{{"_id", 0}, {"x", "a"_sd}}};
+    auto source = DocumentSourceMock::create(inputs);
+
+    auto facetStage = DocumentSourceFacet::createFromBson(
+        fromjson("{$facet: {ok: [{$skip: 0}], bad: [{$project: {y: {$add: ['$x', 1]}}}]}}")
+            .firstElement(),
+        ctx);
+    facetStage->setSource(source.get());
+
+    ASSERT_THROWS_CODE(facetStage->getNext(), AssertionException, 16554);
+    facetStage->dispose();
+    ASSERT_TRUE(source->isDisposed);
+}
+
+TEST_F(DocumentSourceFacetTest, ParallelFacetsShouldRunSeriallyWhenWorkersAreBusy) {
+    const auto originalParallelism = internalQueryFacetParallelism.load();
+    ON_BLOCK_EXIT([&] { internalQueryFacetParallelism.store(originalParallelism); });
+    internalQueryFacetParallelism.store(2);
+
+    // Leave one thread fewer than the $facet needs.
+    auto pool = DocumentSourceFacet::getParallelWorkerPool();
+    const size_t poolSize = pool->numAvailable();
+    auto busyWorkers = pool->tryReserve(poolSize - 1);
+    ASSERT(busyWorkers);
+
+    boost::intrusive_ptr<DocumentSourceMock> source;
+    auto result = runFacetOverRange(
+        getExpCtx(), fromjson("{$facet: {a: [{$skip: 8}], b: [{$limit: 1}]}}"), 10, &source);
+    ASSERT_DOCUMENT_EQ(result,
+                       Document(fromjson("{a: [{_id: 8, mod: 1}, {_id: 9, mod: 2}],"
+                                         " b: [{_id: 0, mod: 0}]}")));
+    ASSERT_TRUE(source->isDisposed);
+    ASSERT_EQ(pool->numAvailable(), 1UL);
+
+    busyWorkers->release();
+    ASSERT_EQ(pool->numAvailable(), poolSize);
+}
+
+TEST_F(DocumentSourceFacetTest, ConcurrentParallelFacetsShouldAllFinishWhenWorkersRunOut) {
+    // Every $facet wants every thread of the pool, so most of them must run serially.
+    auto pool = DocumentSourceFacet::getParallelWorkerPool();
+    const size_t poolSize = pool->numAvailable();
+    const auto originalParallelism = internalQueryFacetParallelism.load();
+    ON_BLOCK_EXIT([&] { internalQueryFacetParallelism.store(originalParallelism); });
+    internalQueryFacetParallelism.store(static_cast<int>(poolSize));
+
+    const auto originalBufferSize = internalQueryFacetBufferSizeBytes.load();
+    ON_BLOCK_EXIT([&] { internalQueryFacetBufferSizeBytes.store(originalBufferSize); });
+    internalQueryFacetBufferSizeBytes.store(1024);
+
+    const auto countAll =
+        BSON_ARRAY(BSON("$group" << BSON("_id" << BSONNULL << "n" << BSON("$sum" << 1))));
+    BSONObjBuilder facets;
+    for (size_t i = 0; i < poolSize; ++i) {
+        facets.append(str::stream() << "f" << i, countAll);
+    }
+    const auto spec = BSON("$facet" << facets.obj());
+
+    const size_t kNumThreads = 8;
+    const size_t kFacetsPerThread = 4;
+    std::vector<size_t> numCorrect(kNumThreads, 0);
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < kFacetsPerThread; ++i) {
+                boost::intrusive_ptr<ExpressionContextForTest> ctx = new ExpressionContextForTest();
+                boost::intrusive_ptr<DocumentSourceMock> source;
+                auto result = runFacetOverRange(ctx, spec, 200, &source);
+                if (result.size() == poolSize &&
+                    result["f0"][0]["n"].getInt() == 200 && source->isDisposed) {
+                    ++numCorrect[t];
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        ASSERT_EQ(numCorrect[t], kFacetsPerThread);
+    }
+    ASSERT_EQ(pool->numAvailable(), poolSize);
+}
+
 // TODO: DocumentSourceFacet will have to propagate pauses if we ever allow nested $facets.
 DEATH_TEST_F(DocumentSourceFacetTest,
              ShouldFailIfGivenPausedInput,
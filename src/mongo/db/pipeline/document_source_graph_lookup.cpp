@@ -39,6 +39,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/stdx/memory.h"
 
@@ -48,6 +49,24 @@ using boost::intrusive_ptr;
 
 namespace dps = ::mongo::dotted_path_support;
 
+namespace {
+
+class FrontierComparator {
+public:
+    typedef std::pair<Value, Value> Data;
+
+    FrontierComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
+
+    int operator()(const Data& lhs, const Data& rhs) const {
+        return _valueComparator.compare(lhs.first, rhs.first);
+    }
+
+private:
+    ValueComparator _valueComparator;
+};
+
+}  // namespace
+
 std::unique_ptr<LiteParsedDocumentSourceForeignCollections> DocumentSourceGraphLookUp::liteParse(
     const AggregationRequest& request, const BSONElement& spec) {
     uassert(ErrorCodes::FailedToParse,
@@ -104,11 +123,9 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNext() {
     performSearch();
 
     std::vector<Value> results;
-    while (!_visited.empty()) {
+    while (hasVisited()) {
         // Remove elements one at a time to avoid consuming more memory.
-        auto it = _visited.begin();
-        results.push_back(Value(it->second));
-        _visited.erase(it);
+        results.push_back(Value(popVisited()));
     }
 
     MutableDocument output(*_input);
@@ -127,7 +144,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
     // If the unwind is not preserving empty arrays, we might have to process multiple inputs before
     // we get one that will produce an output.
     while (true) {
-        if (_visited.empty()) {
+        if (!hasVisited()) {
             // No results are left for the current input, so we should move on to the next one and
             // perform a new search.
 
@@ -143,7 +160,7 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
         }
         MutableDocument unwound(*_input);
 
-        if (_visited.empty()) {
+        if (!hasVisited()) {
             if ((*_unwind)->preserveNullAndEmptyArrays()) {
                 // Since "preserveNullAndEmptyArrays" was specified, output a document even though
                 // we had no result.
@@ -157,13 +174,11 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
                 continue;
             }
         } else {
-            auto it = _visited.begin();
-            unwound.setNestedField(_as, Value(it->second));
+            unwound.setNestedField(_as, Value(popVisited()));
             if (indexPath) {
                 unwound.setNestedField(*indexPath, Value(_outputIndex));
                 ++_outputIndex;
             }
-            _visited.erase(it);
         }
 
         return unwound.freeze();
@@ -173,53 +188,92 @@ DocumentSource::GetNextResult DocumentSourceGraphLookUp::getNextUnwound() {
 void DocumentSourceGraphLookUp::doDispose() {
     _cache.clear();
     _frontier.clear();
+    _frontierSpills.clear();
     _visited.clear();
+    _visitedSpills.clear();
+    _spilledVisitedIds.clear();
+}
+
+bool DocumentSourceGraphLookUp::hasVisited() {
+    while (!_visitedSpills.empty() && !_visitedSpills.front()->more()) {
+        _visitedSpills.erase(_visitedSpills.begin());
+    }
+    return !_visitedSpills.empty() || !_visited.empty();
+}
+
+Document DocumentSourceGraphLookUp::popVisited() {
+    invariant(hasVisited());
+    if (!_visitedSpills.empty()) {
+        return _visitedSpills.front()->next().second;
+    }
+
+    auto it = _visited.begin();
+    Document result = std::move(it->second);
+    _visited.erase(it);
+    return result;
 }
 
 void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
+    const size_t batchSize = internalDocumentSourceGraphLookupFrontierBatchSize.load();
+    const auto& valueComparator = pExpCtx->getValueComparator();
+
     long long depth = 0;
     bool shouldPerformAnotherQuery;
     do {
         shouldPerformAnotherQuery = false;
 
-        // Check whether each key in the frontier exists in the cache or needs to be queried.
-        auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
-        auto matchStage = makeMatchStageFromFrontier(&cached);
-
-        ValueUnorderedSet queried = pExpCtx->getValueComparator().makeUnorderedValueSet();
-        _frontier.swap(queried);
+        // Take over the frontier for this level of the search, so that '_frontier' can collect
+        // the frontier for the next one.
+        ValueUnorderedSet frontier = valueComparator.makeUnorderedValueSet();
+        _frontier.swap(frontier);
         _frontierUsageBytes = 0;
 
-        // Process cached values, populating '_frontier' for the next iteration of search.
-        while (!cached.empty()) {
-            auto doc = *cached.begin();
-            cached.erase(cached.begin());
-            shouldPerformAnotherQuery =
-                addToVisitedAndFrontier(std::move(doc), depth) || shouldPerformAnotherQuery;
-            checkMemoryUsage();
-        }
+        std::vector<std::shared_ptr<FrontierIterator>> frontierSpills;
+        frontierSpills.swap(_frontierSpills);
+
+        // Look up the frontier in batches of at most 'batchSize' values.
+        ValueUnorderedSet batch = valueComparator.makeUnorderedValueSet();
+        auto lookUpBatch = [&] {
+            shouldPerformAnotherQuery = lookUpFrontier(&batch, depth) || shouldPerformAnotherQuery;
+            batch.clear();
+        };
+
+        if (frontierSpills.empty()) {
+            for (auto it = frontier.begin(); it != frontier.end(); it = frontier.erase(it)) {
+                batch.insert(*it);
+                if (batch.size() >= batchSize) {
+                    lookUpBatch();
+                }
+            }
+        } else {
+            // Spill what is left in memory as well, and merge the runs. Since the merged values
+            // come out sorted, the copies of a value which was spilled more than once are adjacent.
+            if (!frontier.empty()) {
+                _frontier.swap(frontier);
+                spillFrontier();
+                frontierSpills.push_back(std::move(_frontierSpills.back()));
+                _frontierSpills.clear();
+            }
 
-        if (matchStage) {
-            // Query for all keys that were in the frontier and not in the cache, populating
-            // '_frontier' for the next iteration of search.
-
-            // We've already allocated space for the trailing $match stage in '_fromPipeline'.
-            _fromPipeline.back() = *matchStage;
-            auto pipeline = uassertStatusOK(
-                pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx));
-            while (auto next = pipeline->getNext()) {
-                uassert(40271,
-                        str::stream()
-                            << "Documents in the '"
-                            << _from.ns()
-                            << "' namespace must contain an _id for de-duplication in $graphLookup",
-                        !(*next)["_id"].missing());
-
-                shouldPerformAnotherQuery =
-                    addToVisitedAndFrontier(*next, depth) || shouldPerformAnotherQuery;
-                addToCache(std::move(*next), queried);
+            std::unique_ptr<FrontierIterator> merged(FrontierIterator::merge(
+                frontierSpills, SortOptions(), FrontierComparator(valueComparator)));
+            boost::optional<Value> previous;
+            while (merged->more()) {
+                Value value = merged->next().first;
+                if (previous && valueComparator.evaluate(*previous == value)) {
+                    continue;
+                }
+                previous = value;
+
+                batch.insert(std::move(value));
+                if (batch.size() >= batchSize) {
+                    lookUpBatch();
+                }
             }
-            checkMemoryUsage();
+        }
+
+        if (!batch.empty()) {
+            lookUpBatch();
         }
 
         ++depth;
@@ -227,13 +281,56 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
              (!_maxDepth || depth <= *_maxDepth));
 
     _frontier.clear();
+    _frontierSpills.clear();
     _frontierUsageBytes = 0;
+    _spilledVisitedIds.clear();
+}
+
+bool DocumentSourceGraphLookUp::lookUpFrontier(ValueUnorderedSet* frontier, long long depth) {
+    bool visitedUpdated = false;
+
+    // Check whether each key in the frontier exists in the cache or needs to be queried.
+    auto cached = pExpCtx->getDocumentComparator().makeUnorderedDocumentSet();
+    auto matchStage = makeMatchStageFromFrontier(frontier, &cached);
+
+    // Process cached values, populating '_frontier' for the next iteration of search.
+    while (!cached.empty()) {
+        auto doc = *cached.begin();
+        cached.erase(cached.begin());
+        visitedUpdated = addToVisitedAndFrontier(std::move(doc), depth) || visitedUpdated;
+        checkMemoryUsage();
+    }
+
+    if (matchStage) {
+        // Query for all keys that were in the frontier and not in the cache, populating
+        // '_frontier' for the next iteration of search.
+
+        // We've already allocated space for the trailing $match stage in '_fromPipeline'.
+        _fromPipeline.back() = *matchStage;
+        auto pipeline = uassertStatusOK(
+            pExpCtx->mongoProcessInterface->makePipeline(_fromPipeline, _fromExpCtx));
+        while (auto next = pipeline->getNext()) {
+            uassert(40271,
+                    str::stream()
+                        << "Documents in the '"
+                        << _from.ns()
+                        << "' namespace must contain an _id for de-duplication in $graphLookup",
+                    !(*next)["_id"].missing());
+
+            visitedUpdated = addToVisitedAndFrontier(*next, depth) || visitedUpdated;
+            addToCache(std::move(*next), *frontier);
+            checkMemoryUsage();
+        }
+    }
+
+    return visitedUpdated;
 }
 
 bool DocumentSourceGraphLookUp::addToVisitedAndFrontier(Document result, long long depth) {
     auto id = result.getField("_id");
 
-    if (_visited.find(id) != _visited.end()) {
+    if (_visited.find(id) != _visited.end() ||
+        _spilledVisitedIds.find(id) != _spilledVisitedIds.end()) {
         // We've already seen this object, don't repeat any work.
         return false;
     }
@@ -281,18 +378,12 @@ void DocumentSourceGraphLookUp::addToCache(const Document& result,
 }
 
 boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
-    DocumentUnorderedSet* cached) {
-    // Add any cached values to 'cached' and remove them from '_frontier'.
-    for (auto it = _frontier.begin(); it != _frontier.end();) {
+    ValueUnorderedSet* frontier, DocumentUnorderedSet* cached) {
+    // Add any cached values to 'cached' and remove them from 'frontier'.
+    for (auto it = frontier->begin(); it != frontier->end();) {
         if (auto entry = _cache[*it]) {
             cached->insert(entry->begin(), entry->end());
-            size_t valueSize = it->getApproximateSize();
-            it = _frontier.erase(it);
-
-            // If the cached value increased in size while in the cache, we don't want to underflow
-            // '_frontierUsageBytes'.
-            invariant(valueSize <= _frontierUsageBytes);
-            _frontierUsageBytes -= valueSize;
+            it = frontier->erase(it);
         } else {
             ++it;
         }
@@ -317,7 +408,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
                     BSONObjBuilder subObj(connectToObj.subobjStart(_connectToField.fullPath()));
                     {
                         BSONArrayBuilder in(subObj.subarrayStart("$in"));
-                        for (auto&& value : _frontier) {
+                        for (auto&& value : *frontier) {
                             in << value;
                         }
                     }
@@ -326,7 +417,7 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::makeMatchStageFromFrontier(
         }
     }
 
-    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(match.obj());
+    return frontier->empty() ? boost::none : boost::optional<BSONObj>(match.obj());
 }
 
 void DocumentSourceGraphLookUp::performSearch() {
@@ -367,7 +458,8 @@ Pipeline::SourceContainer::iterator DocumentSourceGraphLookUp::doOptimizeAt(
     // If we are not already handling an $unwind stage internally, we can combine with the following
     // $unwind stage.
     auto nextUnwind = dynamic_cast<DocumentSourceUnwind*>((*std::next(itr)).get());
-    if (nextUnwind && !_unwind && nextUnwind->getUnwindPath() == _as.fullPath()) {
+    if (nextUnwind && !_unwind && !nextUnwind->hasAbsorbedMatch() &&
+        nextUnwind->getUnwindPath() == _as.fullPath()) {
         _unwind = std::move(nextUnwind);
         container->erase(std::next(itr));
         return itr;
@@ -388,13 +480,62 @@ BSONObjSet DocumentSourceGraphLookUp::getOutputSorts() {
 }
 
 void DocumentSourceGraphLookUp::checkMemoryUsage() {
-    // TODO SERVER-23980: Implement spilling to disk if allowDiskUse is specified.
+    if (_allowDiskUse && (_visitedUsageBytes + _frontierUsageBytes) >= _maxMemoryUsageBytes) {
+        // Only the _id values of the visited documents stay in memory.
+        if (!_visited.empty()) {
+            spillVisited();
+        }
+        if (!_frontier.empty()) {
+            spillFrontier();
+        }
+    }
+
     uassert(40099,
             "$graphLookup reached maximum memory consumption",
             (_visitedUsageBytes + _frontierUsageBytes) < _maxMemoryUsageBytes);
     _cache.evictDownTo(_maxMemoryUsageBytes - _frontierUsageBytes - _visitedUsageBytes);
 }
 
+void DocumentSourceGraphLookUp::spillVisited() {
+    std::vector<std::pair<Value, Document>> visited;
+    visited.reserve(_visited.size());
+    for (auto&& entry : _visited) {
+        visited.emplace_back(entry.first, std::move(entry.second));
+    }
+    _visited.clear();
+
+    // '_visited' compares _id values with the simple collation.
+    const auto& idComparator = ValueComparator::kInstance;
+    std::sort(visited.begin(),
+              visited.end(),
+              [&idComparator](const std::pair<Value, Document>& lhs,
+                              const std::pair<Value, Document>& rhs) {
+                  return idComparator.evaluate(lhs.first < rhs.first);
+              });
+
+    SortedFileWriter<Value, Document> writer(SortOptions().TempDir(pExpCtx->tempDir));
+    for (auto&& entry : visited) {
+        _visitedUsageBytes -= std::min(_visitedUsageBytes, entry.second.getApproximateSize());
+        writer.addAlreadySorted(entry.first, entry.second);
+        _spilledVisitedIds.insert(std::move(entry.first));
+    }
+    _visitedSpills.emplace_back(writer.done());
+}
+
+void DocumentSourceGraphLookUp::spillFrontier() {
+    std::vector<Value> frontier(_frontier.begin(), _frontier.end());
+    _frontier.clear();
+    _frontierUsageBytes = 0;
+
+    std::sort(frontier.begin(), frontier.end(), pExpCtx->getValueComparator().getLessThan());
+
+    SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
+    for (auto&& value : frontier) {
+        writer.addAlreadySorted(value, Value());
+    }
+    _frontierSpills.emplace_back(writer.done());
+}
+
 void DocumentSourceGraphLookUp::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     // Serialize default options.
@@ -464,8 +605,11 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _additionalFilter(additionalFilter),
       _depthField(depthField),
       _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(internalDocumentSourceGraphLookupMaxMemoryBytes.load()),
+      _allowDiskUse(pExpCtx->canSpillToDisk()),
       _frontier(pExpCtx->getValueComparator().makeUnorderedValueSet()),
       _visited(ValueComparator::kInstance.makeUnorderedValueMap<Document>()),
+      _spilledVisitedIds(ValueComparator::kInstance.makeUnorderedValueSet()),
       _cache(pExpCtx->getValueComparator()),
       _unwind(unwindSrc) {
     const auto& resolvedNamespace = pExpCtx->getResolvedNamespace(_from);
@@ -602,3 +746,6 @@ intrusive_ptr<DocumentSource> DocumentSourceGraphLookUp::createFromBson(
     return std::move(newSource);
 }
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lookup_set_cache.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
@@ -57,7 +58,7 @@ public:
         StageConstraints constraints(StreamType::kStreaming,
                                      PositionRequirement::kNone,
                                      HostTypeRequirement::kPrimaryShard,
-                                     DiskUseRequirement::kNoDiskUse,
+                                     DiskUseRequirement::kWritesTmpData,
                                      FacetRequirement::kAllowed,
                                      TransactionRequirement::kAllowed);
 
@@ -103,6 +104,9 @@ protected:
                                                      Pipeline::SourceContainer* container) final;
 
 private:
+    using FrontierIterator = Sorter<Value, Value>::Iterator;
+    using VisitedIterator = Sorter<Value, Document>::Iterator;
+
     DocumentSourceGraphLookUp(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         NamespaceString from,
@@ -122,14 +126,24 @@ private:
 
     /**
      * Prepares the query to execute on the 'from' collection wrapped in a $match by using the
-     * contents of '_frontier'.
+     * contents of 'frontier'.
      *
-     * Fills 'cached' with any values that were retrieved from the cache.
+     * Fills 'cached' with any values that were retrieved from the cache, and removes their keys
+     * from 'frontier'.
      *
      * Returns boost::none if no query is necessary, i.e., all values were retrieved from the cache.
      * Otherwise, returns a query object.
      */
-    boost::optional<BSONObj> makeMatchStageFromFrontier(DocumentUnorderedSet* cached);
+    boost::optional<BSONObj> makeMatchStageFromFrontier(ValueUnorderedSet* frontier,
+                                                        DocumentUnorderedSet* cached);
+
+    /**
+     * Looks up the values in 'frontier', which are at depth 'depth' of the search, populating
+     * '_frontier' for the next iteration of search. Consumes the contents of 'frontier'.
+     *
+     * Returns whether '_visited' was updated, and thus, whether the search should recurse.
+     */
+    bool lookUpFrontier(ValueUnorderedSet* frontier, long long depth);
 
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
@@ -156,11 +170,35 @@ private:
     void addToCache(const Document& result, const ValueUnorderedSet& queried);
 
     /**
-     * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, and then
-     * evict from '_cache' until this source is using less than '_maxMemoryUsageBytes'.
+     * Assert that '_visited' and '_frontier' have not exceeded the maximum meory usage, spilling
+     * them to disk first if that is allowed, and then evict from '_cache' until this source is
+     * using less than '_maxMemoryUsageBytes'.
      */
     void checkMemoryUsage();
 
+    /**
+     * Moves the documents in '_visited' to disk as a run sorted by _id. Their _id values stay in
+     * memory in '_spilledVisitedIds'.
+     */
+    void spillVisited();
+
+    /**
+     * Moves the values in '_frontier' to disk as a run sorted by the collation of the query.
+     */
+    void spillFrontier();
+
+    /**
+     * Returns whether there are visited documents left to return for the current input, whether in
+     * memory or on disk.
+     */
+    bool hasVisited();
+
+    /**
+     * Removes and returns one of the visited documents for the current input. Must only be called
+     * when hasVisited() is true.
+     */
+    Document popVisited();
+
     /**
      * Process 'result', adding it to '_visited' with the given 'depth', and updating '_frontier'
      * with the object's 'connectTo' values.
@@ -186,7 +224,8 @@ private:
     // The aggregation pipeline to perform against the '_from' namespace.
     std::vector<BSONObj> _fromPipeline;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    const size_t _maxMemoryUsageBytes;
+    const bool _allowDiskUse;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -195,11 +234,21 @@ private:
     // Only used during the breadth-first search, tracks the set of values on the current frontier.
     ValueUnorderedSet _frontier;
 
+    // Sorted runs of values of the frontier for the next level of the search which were spilled
+    // to disk. A value may appear in more than one run, and also in '_frontier'.
+    std::vector<std::shared_ptr<FrontierIterator>> _frontierSpills;
+
     // Tracks nodes that have been discovered for a given input. Keys are the '_id' value of the
     // document from the foreign collection, value is the document itself.  The keys are compared
     // using the simple collation.
     ValueUnorderedMap<Document> _visited;
 
+    // Documents which were discovered for the current input but spilled to disk, in runs sorted by
+    // '_id', along with their '_id' values. A document is either in '_visited' or in one of the
+    // runs. The '_id' values are only needed until the search is done.
+    std::vector<std::shared_ptr<VisitedIterator>> _visitedSpills;
+    ValueUnorderedSet _spilledVisitedIds;
+
     // Caches query results to avoid repeating any work. This structure is maintained across calls
     // to getNext().
     LookupSetCache _cache;
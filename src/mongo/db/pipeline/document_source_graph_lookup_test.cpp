@@ -37,9 +37,12 @@
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -615,5 +618,133 @@ TEST_F(DocumentSourceGraphLookUpTest, ShouldNotExpandArraysWithinArraysAtEndOfCo
     ASSERT(graphLookupStage->getNext().isEOF());
 }
 
+/**
+ * Makes a graph where the document with _id 0 connects to 'numLeaves' documents, all of which
+ * connect to one more document. Each document is padded to about 'padding' bytes.
+ */
+std::vector<Document> makeStarGraph(int numLeaves, size_t padding) {
+    const std::string pad(padding, 'x');
+
+    std::vector<Value> leafIds;
+    for (int i = 1; i <= numLeaves; ++i) {
+        leafIds.push_back(Value(i));
+    }
+
+    std::vector<Document> graph{Document{{"_id", 0}, {"to", leafIds}, {"pad", pad}}};
+    for (int i = 1; i <= numLeaves; ++i) {
+        graph.push_back(Document{{"_id", i}, {"to", numLeaves + 1}, {"pad", pad}});
+    }
+    graph.push_back(Document{{"_id", numLeaves + 1}, {"pad", pad}});
+    return graph;
+}
+
+boost::intrusive_ptr<DocumentSourceGraphLookUp> makeStarGraphLookUp(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const std::vector<Document>& graph,
+    boost::optional<boost::intrusive_ptr<DocumentSourceUnwind>> unwind = boost::none) {
+    std::deque<DocumentSource::GetNextResult> fromContents;
+    for (auto&& doc : graph) {
+        fromContents.push_back(Document(doc));
+    }
+
+    NamespaceString fromNs("test", "graph_lookup");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface = std::make_shared<MockMongoInterface>(std::move(fromContents));
+    return DocumentSourceGraphLookUp::create(expCtx,
+                                             fromNs,
+                                             "results",
+                                             "to",
+                                             "_id",
+                                             ExpressionFieldPath::create(expCtx, "startVal"),
+                                             boost::none,
+                                             boost::none,
+                                             boost::none,
+                                             unwind);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldFailWhenExceedingMemoryLimitWithoutAllowDiskUse) {
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(4 * 1024);
+    ON_BLOCK_EXIT([] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(100 * 1024 * 1024); });
+
+    auto expCtx = getExpCtx();
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", 0}});
+    auto graphLookupStage = makeStarGraphLookUp(expCtx, makeStarGraph(40, 512));
+    graphLookupStage->setSource(inputMock.get());
+
+    ASSERT_THROWS_CODE(graphLookupStage->getNext(), AssertionException, 40099);
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldSpillToDiskWhenExceedingMemoryLimitWithAllowDiskUse) {
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(4 * 1024);
+    ON_BLOCK_EXIT([] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(100 * 1024 * 1024); });
+
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const auto graph = makeStarGraph(40, 512);
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", 0}});
+    auto graphLookupStage = makeStarGraphLookUp(expCtx, graph);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(graph.size(), resultsArray.size());
+    for (auto&& doc : graph) {
+        ASSERT(arrayContains(expCtx, resultsArray, Value(doc)));
+    }
+    ASSERT(graphLookupStage->getNext().isEOF());
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldReturnSpilledDocumentsWhileUnwinding) {
+    internalDocumentSourceGraphLookupMaxMemoryBytes.store(4 * 1024);
+    ON_BLOCK_EXIT([] { internalDocumentSourceGraphLookupMaxMemoryBytes.store(100 * 1024 * 1024); });
+
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceGraphLookUpTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+
+    const auto graph = makeStarGraph(40, 512);
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", 0}});
+    auto unwindStage = DocumentSourceUnwind::create(expCtx, "results", false, boost::none);
+    auto graphLookupStage = makeStarGraphLookUp(expCtx, graph, unwindStage);
+    graphLookupStage->setSource(inputMock.get());
+
+    std::vector<Value> results;
+    for (auto next = graphLookupStage->getNext(); next.isAdvanced();
+         next = graphLookupStage->getNext()) {
+        results.push_back(next.getDocument().getField("results"));
+    }
+
+    ASSERT_EQ(graph.size(), results.size());
+    for (auto&& doc : graph) {
+        ASSERT(arrayContains(expCtx, results, Value(doc)));
+    }
+}
+
+TEST_F(DocumentSourceGraphLookUpTest, ShouldLookUpLargeFrontiersInBatches) {
+    internalDocumentSourceGraphLookupFrontierBatchSize.store(3);
+    ON_BLOCK_EXIT([] { internalDocumentSourceGraphLookupFrontierBatchSize.store(10000); });
+
+    auto expCtx = getExpCtx();
+    const auto graph = makeStarGraph(10, 0);
+    auto inputMock = DocumentSourceMock::create(Document{{"_id", 0}, {"startVal", 0}});
+    auto graphLookupStage = makeStarGraphLookUp(expCtx, graph);
+    graphLookupStage->setSource(inputMock.get());
+
+    auto next = graphLookupStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+
+    auto resultsArray = next.getDocument().getField("results").getArray();
+    ASSERT_EQ(graph.size(), resultsArray.size());
+    for (auto&& doc : graph) {
+        ASSERT(arrayContains(expCtx, resultsArray, Value(doc)));
+    }
+}
+
 }  // namespace
 }  // namespace mongo
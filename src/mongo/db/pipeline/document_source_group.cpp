@@ -28,17 +28,27 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <deque>
+#include <limits>
+
+#include "mongo/db/client.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_exchange.h"
 #include "mongo/db/pipeline/document_source_group.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
+#include "mongo/db/pipeline/parallel_worker_pool.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -55,6 +65,482 @@ const char* DocumentSourceGroup::getSourceName() const {
     return "$group";
 }
 
+namespace {
+
+// The name of the fields of the documents handed to the Exchange of a parallel $group, holding the
+// group key and the input document respectively.
+constexpr StringData kParallelKeyField = "k"_sd;
+constexpr StringData kParallelDocField = "d"_sd;
+
+// The upper bound on 'internalDocumentSourceGroupParallelism' and its mongos counterpart, and so on
+// the number of threads any one parallel $group uses.
+constexpr size_t kMaxGroupParallelism = 64;
+
+/**
+ * A bounded, thread-safe queue through which the thread executing a parallel $group hands its
+ * input to the Exchange that partitions it. The queue keeps storage access on the thread that owns
+ * the operation: the partitions only ever see documents which have already been read.
+ */
+class ParallelGroupInputQueue {
+public:
+    explicit ParallelGroupInputQueue(size_t maxBytes) : _maxBytes(maxBytes) {}
+
+    /**
+     * Appends 'doc', blocking while the queue is full. Throws if 'opCtx' is interrupted while
+     * waiting. Returns false, dropping 'doc', if the queue has been cancelled.
+     */
+    bool push(Document doc, OperationContext* opCtx) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        opCtx->waitForConditionOrInterrupt(
+            _notFull, lk, [&] { return _cancelled || _bytes < _maxBytes; });
+        if (_cancelled) {
+            return false;
+        }
+
+        const size_t size = doc.getApproximateSize();
+        _bytes += size;
+        _docs.emplace_back(std::move(doc), size);
+        _notEmpty.notify_one();
+        return true;
+    }
+
+    /**
+     * Marks the end of the input. Documents already queued are still delivered.
+     */
+    void close() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _closed = true;
+        _notEmpty.notify_all();
+    }
+
+    /**
+     * Discards any queued documents and makes every subsequent pop() return EOF and every push()
+     * return false.
+     */
+    void cancel() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _cancelled = true;
+        _docs.clear();
+        _bytes = 0;
+        _notEmpty.notify_all();
+        _notFull.notify_all();
+    }
+
+    /**
+     * Blocks until a document is available or the input has ended.
+     */
+    DocumentSource::GetNextResult pop() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _notEmpty.wait(lk, [&] { return _cancelled || _closed || !_docs.empty(); });
+        if (_docs.empty()) {
+            return DocumentSource::GetNextResult::makeEOF();
+        }
+
+        auto next = std::move(_docs.front());
+        _docs.pop_front();
+        _bytes -= next.second;
+        _notFull.notify_one();
+        return std::move(next.first);
+    }
+
+private:
+    const size_t _maxBytes;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _notEmpty;
+    stdx::condition_variable _notFull;
+
+    std::deque<std::pair<Document, size_t>> _docs;
+    size_t _bytes = 0;
+    bool _closed = false;
+    bool _cancelled = false;
+};
+
+/**
+ * The source of the pipeline feeding the Exchange of a parallel $group.
+ */
+class DocumentSourceParallelGroupInput final : public DocumentSource {
+public:
+    DocumentSourceParallelGroupInput(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                     std::shared_ptr<ParallelGroupInputQueue> queue)
+        : DocumentSource(expCtx), _queue(std::move(queue)) {}
+
+    GetNextResult getNext() final {
+        return _queue->pop();
+    }
+
+    const char* getSourceName() const final {
+        return "$_internalParallelGroupInput";
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kNone,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kAllowed);
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final {
+        return Value(Document{{getSourceName(), Document()}});
+    }
+
+private:
+    std::shared_ptr<ParallelGroupInputQueue> _queue;
+};
+
+/**
+ * The source of one partition of a parallel $group. Unwraps the documents handed out by the
+ * Exchange, and disposes of its consumer exactly once, since the Exchange only tolerates one
+ * disposal per consumer.
+ */
+class DocumentSourceParallelGroupPartition final : public DocumentSource {
+public:
+    DocumentSourceParallelGroupPartition(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                         boost::intrusive_ptr<DocumentSourceExchange> exchange)
+        : DocumentSource(expCtx), _exchange(std::move(exchange)) {}
+
+    GetNextResult getNext() final {
+        auto next = _exchange->getNext();
+        if (!next.isAdvanced()) {
+            return next;
+        }
+        return next.getDocument()[kParallelDocField].getDocument();
+    }
+
+    const char* getSourceName() const final {
+        return "$_internalParallelGroupPartition";
+    }
+
+    StageConstraints constraints(Pipeline::SplitState pipeState) const final {
+        StageConstraints constraints(StreamType::kStreaming,
+                                     PositionRequirement::kFirst,
+                                     HostTypeRequirement::kNone,
+                                     DiskUseRequirement::kNoDiskUse,
+                                     FacetRequirement::kNotAllowed,
+                                     TransactionRequirement::kAllowed);
+        constraints.requiresInputDocSource = false;
+        return constraints;
+    }
+
+    Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final {
+        return Value(Document{{getSourceName(), Document()}});
+    }
+
+protected:
+    void doDispose() final {
+        if (!_disposed) {
+            _disposed = true;
+            _exchange->dispose();
+        }
+    }
+
+private:
+    boost::intrusive_ptr<DocumentSourceExchange> _exchange;
+    bool _disposed = false;
+};
+
+/**
+ * Returns the Exchange boundaries which split the range of 64-bit hashes evenly among
+ * 'numPartitions' consumers.
+ */
+std::vector<BSONObj> makeHashBoundaries(size_t numPartitions) {
+    std::vector<BSONObj> boundaries;
+    boundaries.push_back(BSON("" << MINKEY));
+    const uint64_t step = std::numeric_limits<uint64_t>::max() / numPartitions;
+    for (size_t i = 1; i < numPartitions; ++i) {
+        // Offset from the smallest long long, computed in unsigned arithmetic to avoid overflow.
+        const uint64_t offset = step * i;
+        boundaries.push_back(BSON(
+            "" << static_cast<long long>(offset + static_cast<uint64_t>(
+                                                      std::numeric_limits<long long>::min()))));
+    }
+    boundaries.push_back(BSON("" << MAXKEY));
+    return boundaries;
+}
+
+}  // namespace
+
+struct DocumentSourceGroup::ParallelExecution {
+    explicit ParallelExecution(size_t maxQueueBytes)
+        : input(std::make_shared<ParallelGroupInputQueue>(maxQueueBytes)) {}
+
+    std::shared_ptr<ParallelGroupInputQueue> input;
+
+    // One $group per partition, each reading from its own consumer of the Exchange.
+    std::vector<boost::intrusive_ptr<DocumentSourceGroup>> partitions;
+    std::vector<boost::intrusive_ptr<DocumentSourceParallelGroupPartition>> partitionSources;
+
+    // Guards the members below, which are written by the worker threads.
+    stdx::mutex mutex;
+    stdx::condition_variable partitionFinished;
+    size_t numRunning = 0;
+    Status status = Status::OK();
+
+    // The first result of each partition, produced on its worker thread by the call to getNext()
+    // which consumes all of its input.
+    std::vector<boost::optional<GetNextResult>> firstResults;
+
+    // Whether the input has been fully handed to the partitions.
+    bool inputExhausted = false;
+
+    // The partition whose results getNextParallel() is currently returning.
+    size_t outputPartition = 0;
+
+    // The worker threads of the partitions. Released once none of them is running.
+    ParallelWorkerPool::Reservation workers;
+};
+
+ParallelWorkerPool* DocumentSourceGroup::getParallelWorkerPool() {
+    static ParallelWorkerPool* const pool =
+        new ParallelWorkerPool("ParallelGroup", kMaxGroupParallelism);
+    return pool;
+}
+
+DocumentSourceGroup::~DocumentSourceGroup() {
+    abandonParallelExecution();
+}
+
+bool DocumentSourceGroup::anyPartitionRunningInParallelForTest() const {
+    if (!_parallel) {
+        return false;
+    }
+    return std::any_of(_parallel->partitions.begin(),
+                       _parallel->partitions.end(),
+                       [](const auto& partition) { return partition->isRunningInParallel(); });
+}
+
+size_t DocumentSourceGroup::parallelismForExecution() const {
+    // The partitions already run on the worker threads of their parallel $group. Letting them
+    // partition their input again would multiply the number of workers a query needs.
+    if (_isParallelPartition) {
+        return 1;
+    }
+
+    // On mongos the input comes from the shards' cursors, which remain on the thread that owns the
+    // operation, and only the merging of their partial groups is spread over the workers.
+    const int parallelism = pExpCtx->inMongos ? internalDocumentSourceGroupMongosParallelism.load()
+                                              : internalDocumentSourceGroupParallelism.load();
+    if (parallelism <= 1 || !pExpCtx->opCtx) {
+        return 1;
+    }
+
+    // The partitions are routed documents by a binary hash of the group key, which only agrees
+    // with the simple collation's notion of equality.
+    if (pExpCtx->getCollator()) {
+        return 1;
+    }
+
+    // Each partition reparses this $group in its own ExpressionContext, in which variables defined
+    // outside of the $group would not be available.
+    DepsTracker deps;
+    getDependencies(&deps);
+    if (!deps.vars.empty()) {
+        return 1;
+    }
+
+    return static_cast<size_t>(parallelism);
+}
+
+void DocumentSourceGroup::tryStartParallelExecution() {
+    const size_t parallelism = parallelismForExecution();
+    if (parallelism <= 1) {
+        return;
+    }
+
+    // The partitions block on each other through the Exchange, so they must all run at once. If
+    // the pool cannot spare a thread for each of them right now, group serially instead.
+    auto workers = getParallelWorkerPool()->tryReserve(parallelism);
+    if (!workers) {
+        return;
+    }
+
+    auto parallel = std::make_shared<ParallelExecution>(
+        static_cast<size_t>(internalDocumentSourceGroupParallelBufferBytes.load()));
+
+    ExchangeSpec spec;
+    spec.setPolicy(ExchangePolicyEnum::kHash);
+    spec.setConsumers(parallelism);
+    spec.setBufferSize(internalDocumentSourceGroupParallelBufferBytes.load());
+    spec.setKey(BSON(kParallelKeyField << "hashed"));
+    spec.setBoundaries(makeHashBoundaries(parallelism));
+
+    auto exchangeExpCtx = pExpCtx->copyWith(pExpCtx->ns);
+    auto exchangePipeline = uassertStatusOK(Pipeline::create(
+        {new DocumentSourceParallelGroupInput(exchangeExpCtx, parallel->input)},
+        exchangeExpCtx));
+    // The Exchange disposes of its pipeline once all of its consumers are disposed.
+    exchangePipeline.get_deleter().dismissDisposal();
+    boost::intrusive_ptr<Exchange> exchange = new Exchange(spec, std::move(exchangePipeline));
+
+    // Every partition groups its share of the input independently. Since equal keys are always
+    // routed to the same partition, the partitions' results are disjoint and need no further
+    // merging. They share this $group's memory budget.
+    const auto groupSpec = serialize().getDocument().toBson();
+    for (size_t i = 0; i < parallelism; ++i) {
+        auto partitionExpCtx = pExpCtx->copyWith(pExpCtx->ns);
+        partitionExpCtx->opCtx = nullptr;
+
+        auto partition = static_cast<DocumentSourceGroup*>(
+            createFromBson(groupSpec.firstElement(), partitionExpCtx).get());
+        partition->_isParallelPartition = true;
+        partition->_maxMemoryUsageBytes = std::max<size_t>(1, _maxMemoryUsageBytes / parallelism);
+
+        boost::intrusive_ptr<DocumentSourceParallelGroupPartition> partitionSource =
+            new DocumentSourceParallelGroupPartition(
+                partitionExpCtx, new DocumentSourceExchange(partitionExpCtx, exchange, i));
+        partition->setSource(partitionSource.get());
+
+        parallel->partitions.emplace_back(partition);
+        parallel->partitionSources.push_back(std::move(partitionSource));
+    }
+    parallel->firstResults.resize(parallelism);
+    parallel->workers = std::move(*workers);
+
+    auto serviceContext = pExpCtx->opCtx->getServiceContext();
+    for (size_t i = 0; i < parallelism; ++i) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(parallel->mutex);
+            ++parallel->numRunning;
+        }
+        auto scheduleStatus = parallel->workers.schedule([parallel, serviceContext, i] {
+            boost::optional<GetNextResult> firstResult;
+            Status status = Status::OK();
+            {
+                auto client = serviceContext->makeClient("ParallelGroup");
+                AlternativeClientRegion acr(client);
+                auto opCtx = cc().makeOperationContext();
+
+                auto& partition = parallel->partitions[i];
+                partition->pExpCtx->opCtx = opCtx.get();
+                try {
+                    firstResult = partition->getNext();
+                } catch (const DBException& ex) {
+                    status = ex.toStatus();
+                }
+
+                if (!status.isOK()) {
+                    // Stop the input, and keep draining this partition's share of whatever
+                    // was already queued so that the Exchange does not wait on it forever.
+                    parallel->input->cancel();
+                    try {
+                        while (parallel->partitionSources[i]->getNext().isAdvanced()) {
+                        }
+                    } catch (const DBException&) {
+                    }
+                }
+                partition->pExpCtx->opCtx = nullptr;
+            }
+
+            // The owner of this $group may go away as soon as the count drops to zero, so
+            // this must be the last access to anything it owns.
+            stdx::lock_guard<stdx::mutex> lk(parallel->mutex);
+            parallel->firstResults[i] = std::move(firstResult);
+            if (!status.isOK() && parallel->status.isOK()) {
+                parallel->status = status;
+            }
+            --parallel->numRunning;
+            parallel->partitionFinished.notify_all();
+        });
+
+        if (!scheduleStatus.isOK()) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(parallel->mutex);
+                --parallel->numRunning;
+            }
+            _parallel = std::move(parallel);
+            abandonParallelExecution();
+            uassertStatusOK(scheduleStatus);
+        }
+    }
+
+    _parallel = std::move(parallel);
+}
+
+DocumentSource::GetNextResult DocumentSourceGroup::initializeParallel() {
+    // Hand the input to the partitions, computing each document's group key on this thread.
+    GetNextResult input = GetNextResult::makeEOF();
+    try {
+        if (!_parallel->inputExhausted) {
+            for (input = pSource->getNext(); input.isAdvanced(); input = pSource->getNext()) {
+                auto rootDocument = input.releaseDocument();
+                Value id = computeId(rootDocument);
+                if (!_parallel->input->push(
+                        Document{{kParallelKeyField, std::move(id)},
+                                 {kParallelDocField, std::move(rootDocument)}},
+                        pExpCtx->opCtx)) {
+                    // A partition failed. Its error is reported below.
+                    input = GetNextResult::makeEOF();
+                    break;
+                }
+            }
+            if (input.isPaused()) {
+                return input;
+            }
+            _parallel->inputExhausted = true;
+            _parallel->input->close();
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_parallel->mutex);
+        pExpCtx->opCtx->waitForConditionOrInterrupt(
+            _parallel->partitionFinished, lk, [&] { return _parallel->numRunning == 0; });
+        _parallel->workers.release();
+    } catch (const DBException&) {
+        abandonParallelExecution();
+        throw;
+    }
+
+    uassertStatusOK(_parallel->status);
+    for (auto&& partition : _parallel->partitions) {
+        _usedDisk = _usedDisk || partition->usedDisk();
+    }
+
+    _initialized = true;
+    return input;
+}
+
+void DocumentSourceGroup::abandonParallelExecution() {
+    if (!_parallel) {
+        return;
+    }
+
+    _parallel->input->cancel();
+
+    stdx::unique_lock<stdx::mutex> lk(_parallel->mutex);
+    _parallel->partitionFinished.wait(lk, [&] { return _parallel->numRunning == 0; });
+    _parallel->workers.release();
+}
+
+DocumentSource::GetNextResult DocumentSourceGroup::getNextParallel() {
+    // Return each partition's results in turn. The first result of each was already produced on
+    // its worker thread; the rest can be produced here since all input has been consumed.
+    while (_parallel->outputPartition < _parallel->partitions.size()) {
+        const size_t i = _parallel->outputPartition;
+        auto& partition = _parallel->partitions[i];
+
+        boost::optional<GetNextResult> next;
+        if (_parallel->firstResults[i]) {
+            next = std::move(_parallel->firstResults[i]);
+            _parallel->firstResults[i] = boost::none;
+        } else {
+            partition->pExpCtx->opCtx = pExpCtx->opCtx;
+            next = partition->getNext();
+            partition->pExpCtx->opCtx = nullptr;
+        }
+
+        if (next->isAdvanced()) {
+            return std::move(*next);
+        }
+        invariant(next->isEOF());
+        ++_parallel->outputPartition;
+    }
+
+    return GetNextResult::makeEOF();
+}
+
 DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
     pExpCtx->checkForInterrupt();
 
@@ -66,6 +552,10 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNext() {
         invariant(initializationResult.isEOF());
     }
 
+    if (_parallel) {
+        return getNextParallel();
+    }
+
     for (auto&& accum : _currentAccumulators) {
         accum->reset();  // Prep accumulators for a new group.
     }
@@ -115,12 +605,12 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextSpilled() {
 
 DocumentSource::GetNextResult DocumentSourceGroup::getNextStandard() {
     // Not spilled, and not streaming.
-    if (_groups->empty())
+    if (!_groups || _nextGroupRow >= _groups->size())
         return GetNextResult::makeEOF();
 
-    Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->needsMerge);
+    Document out = makeDocument(_nextGroupRow, pExpCtx->needsMerge);
 
-    if (++groupsIterator == _groups->end())
+    if (++_nextGroupRow == _groups->size())
         dispose();
 
     return std::move(out);
@@ -164,13 +654,30 @@ DocumentSource::GetNextResult DocumentSourceGroup::getNextStreaming() {
     return std::move(out);
 }
 
+void DocumentSourceGroup::detachFromOperationContext() {
+    _memoryTracker.detachFromOperationContext();
+}
+
+void DocumentSourceGroup::reattachToOperationContext(OperationContext* opCtx) {
+    _memoryTracker.reattachToOperationContext(opCtx);
+}
+
 void DocumentSourceGroup::doDispose() {
-    // Free our resources.
-    _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
-    _sorterIterator.reset();
+    if (_parallel) {
+        abandonParallelExecution();
+        for (auto&& partition : _parallel->partitions) {
+            partition->pExpCtx->opCtx = pExpCtx->opCtx;
+            partition->dispose();
+            partition->pExpCtx->opCtx = nullptr;
+        }
+        _parallel->outputPartition = _parallel->partitions.size();
+    }
 
-    // Make us look done.
-    groupsIterator = _groups->end();
+    // Free our resources, which also makes us look done.
+    _groups = boost::none;
+    _nextGroupRow = 0;
+    _sorterIterator.reset();
+    _memoryTracker.set(0);
 
     _firstDocOfNextGroup = boost::none;
 }
@@ -186,6 +693,7 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::optimize() {
     for (auto&& accumulatedField : _accumulatedFields) {
         accumulatedField.expression = accumulatedField.expression->optimize();
     }
+    _compiledExpressions.reset();
 
     return this;
 }
@@ -283,12 +791,12 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       _doingMerge(false),
       _maxMemoryUsageBytes(maxMemoryUsageBytes ? *maxMemoryUsageBytes
                                                : internalDocumentSourceGroupMaxMemoryBytes.load()),
+      _memoryTracker(pExpCtx->opCtx),
       _inputSort(BSONObj()),
       _streaming(false),
       _initialized(false),
-      _groups(pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>()),
       _spilled(false),
-      _allowDiskUse(pExpCtx->allowDiskUse && !pExpCtx->inMongos) {}
+      _allowDiskUse(pExpCtx->canSpillToDisk()) {}
 
 void DocumentSourceGroup::addAccumulator(AccumulationStatement accumulationStatement) {
     _accumulatedFields.push_back(accumulationStatement);
@@ -379,8 +887,6 @@ intrusive_ptr<DocumentSource> DocumentSourceGroup::createFromBson(
 
 namespace {
 
-using GroupsMap = DocumentSourceGroup::GroupsMap;
-
 class SorterComparator {
 public:
     typedef pair<Value, Value> Data;
@@ -397,13 +903,15 @@ private:
 
 class SpillSTLComparator {
 public:
-    SpillSTLComparator(ValueComparator valueComparator) : _valueComparator(valueComparator) {}
+    SpillSTLComparator(const GroupTable& groups, ValueComparator valueComparator)
+        : _groups(groups), _valueComparator(valueComparator) {}
 
-    bool operator()(const GroupsMap::value_type* lhs, const GroupsMap::value_type* rhs) const {
-        return _valueComparator.evaluate(lhs->first < rhs->first);
+    bool operator()(size_t lhs, size_t rhs) const {
+        return _valueComparator.evaluate(_groups.getKey(lhs) < _groups.getKey(rhs));
     }
 
 private:
+    const GroupTable& _groups;
     ValueComparator _valueComparator;
 };
 
@@ -499,6 +1007,26 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
         return DocumentSource::GetNextResult::makeEOF();
     }
 
+    // A $group which has started grouping serially must carry on serially after a pause.
+    if (!_parallel && !_groups) {
+        tryStartParallelExecution();
+    }
+    if (_parallel) {
+        return initializeParallel();
+    }
+
+    if (!_groups) {
+        _groups.emplace(pExpCtx, _accumulatedFields);
+
+        std::vector<const Expression*> roots;
+        for (auto&& idExpression : _idExpressions) {
+            roots.push_back(idExpression.get());
+        }
+        for (auto&& accumulatedField : _accumulatedFields) {
+            roots.push_back(accumulatedField.expression.get());
+        }
+        _compiledExpressions = CompiledExpression::compile(roots);
+    }
 
     // Barring any pausing, this loop exhausts 'pSource' and populates '_groups'.
     GetNextResult input = pSource->getNext();
@@ -510,44 +1038,55 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                     _allowDiskUse);
             _sortedFiles.push_back(spill());
             _memoryUsageBytes = 0;
+            _memoryTracker.set(0);
+        } else if (OperationMemoryUsage::shouldReleaseMemory(_memoryUsageBytes)) {
+            uassert(ErrorCodes::ExceededMemoryLimit,
+                    "$group aborted because the server exceeded its query memory budget."
+                    " Pass allowDiskUse:true to let it spill to disk instead.",
+                    _allowDiskUse);
+            _sortedFiles.push_back(spill());
+            _memoryUsageBytes = 0;
+            _memoryTracker.set(0);
         }
 
         // We release the result document here so that it does not outlive the end of this loop
         // iteration. Not releasing could lead to an array copy when this group follows an unwind.
         auto rootDocument = input.releaseDocument();
-        Value id = computeId(rootDocument);
+        Value id;
+        if (_compiledExpressions) {
+            _compiledExpressions->evaluate(rootDocument);
+            id = computeId(*_compiledExpressions);
+        } else {
+            id = computeId(rootDocument);
+        }
 
-        // Look for the _id value in the map. If it's not there, add a new entry with a blank
-        // accumulator. This is done in a somewhat odd way in order to avoid hashing 'id' and
-        // looking it up in '_groups' multiple times.
-        const size_t oldSize = _groups->size();
-        vector<intrusive_ptr<Accumulator>>& group = (*_groups)[id];
-        const bool inserted = _groups->size() != oldSize;
+        // Look for the _id value in the table. If it's not there, a new row with blank
+        // accumulators is added.
+        const auto found = _groups->findOrInsert(id);
+        const size_t row = found.first;
+        const bool inserted = found.second;
 
         if (inserted) {
             _memoryUsageBytes += id.getApproximateSize();
-
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (auto&& accumulatedField : _accumulatedFields) {
-                group.push_back(accumulatedField.makeAccumulator(pExpCtx));
-            }
         } else {
-            for (auto&& groupObj : group) {
+            for (size_t i = 0; i < numAccumulators; i++) {
                 // subtract old mem usage. New usage added back after processing.
-                _memoryUsageBytes -= groupObj->memUsageForSorter();
+                _memoryUsageBytes -= _groups->getAccumulator(row, i)->memUsageForSorter();
             }
         }
 
         /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-
         for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(_accumulatedFields[i].expression->evaluate(rootDocument),
-                              _doingMerge);
-
-            _memoryUsageBytes += group[i]->memUsageForSorter();
+            Accumulator* accumulator = _groups->getAccumulator(row, i);
+            accumulator->process(
+                _compiledExpressions
+                    ? _compiledExpressions->getResult(_idExpressions.size() + i)
+                    : _accumulatedFields[i].expression->evaluate(rootDocument),
+                _doingMerge);
+
+            _memoryUsageBytes += accumulator->memUsageForSorter();
         }
+        _memoryTracker.set(_memoryUsageBytes);
 
         if (kDebugBuild && !storageGlobalParams.readOnly) {
             // In debug mode, spill every time we have a duplicate id to stress merge logic.
@@ -577,7 +1116,8 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 }
 
                 // We won't be using groups again so free its memory.
-                _groups = pExpCtx->getValueComparator().makeUnorderedValueMap<Accumulators>();
+                _groups = boost::none;
+                _memoryTracker.set(0);
 
                 _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
                     _sortedFiles, SortOptions(), SorterComparator(pExpCtx->getValueComparator())));
@@ -592,7 +1132,7 @@ DocumentSource::GetNextResult DocumentSourceGroup::initialize() {
                 _firstPartOfNextGroup = _sorterIterator->next();
             } else {
                 // start the group iterator
-                groupsIterator = _groups->begin();
+                _nextGroupRow = 0;
             }
 
             // This must happen last so that, unless control gets here, we will re-enter
@@ -610,36 +1150,39 @@ bool DocumentSourceGroup::usedDisk() {
 
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
     _usedDisk = true;
-    vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
-    ptrs.reserve(_groups->size());
-    for (GroupsMap::const_iterator it = _groups->begin(), end = _groups->end(); it != end; ++it) {
-        ptrs.push_back(&*it);
+    vector<size_t> rows;  // using row numbers to speed sorting
+    rows.reserve(_groups->size());
+    for (size_t row = 0; row < _groups->size(); ++row) {
+        rows.push_back(row);
     }
 
-    stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator(pExpCtx->getValueComparator()));
+    stable_sort(
+        rows.begin(), rows.end(), SpillSTLComparator(*_groups, pExpCtx->getValueComparator()));
 
     SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
-    switch (_accumulatedFields.size()) {  // same as ptrs[i]->second.size() for all i.
-        case 0:                           // no values, essentially a distinct
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first, Value());
+    switch (_accumulatedFields.size()) {
+        case 0:  // no values, essentially a distinct
+            for (size_t i = 0; i < rows.size(); i++) {
+                writer.addAlreadySorted(_groups->getKey(rows[i]), Value());
             }
             break;
 
         case 1:  // just one value, use optimized serialization as single Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
-                writer.addAlreadySorted(ptrs[i]->first,
-                                        ptrs[i]->second[0]->getValue(/*toBeMerged=*/true));
+            for (size_t i = 0; i < rows.size(); i++) {
+                writer.addAlreadySorted(
+                    _groups->getKey(rows[i]),
+                    _groups->getAccumulator(rows[i], 0)->getValue(/*toBeMerged=*/true));
             }
             break;
 
         default:  // multiple values, serialize as array-typed Value
-            for (size_t i = 0; i < ptrs.size(); i++) {
+            for (size_t i = 0; i < rows.size(); i++) {
                 vector<Value> accums;
-                for (size_t j = 0; j < ptrs[i]->second.size(); j++) {
-                    accums.push_back(ptrs[i]->second[j]->getValue(/*toBeMerged=*/true));
+                for (size_t j = 0; j < _accumulatedFields.size(); j++) {
+                    accums.push_back(
+                        _groups->getAccumulator(rows[i], j)->getValue(/*toBeMerged=*/true));
                 }
-                writer.addAlreadySorted(ptrs[i]->first, Value(std::move(accums)));
+                writer.addAlreadySorted(_groups->getKey(rows[i]), Value(std::move(accums)));
             }
             break;
     }
@@ -812,6 +1355,20 @@ Value DocumentSourceGroup::computeId(const Document& root) {
     return Value(std::move(vals));
 }
 
+Value DocumentSourceGroup::computeId(const CompiledExpression& compiled) {
+    if (_idExpressions.size() == 1) {
+        const Value& retValue = compiled.getResult(0);
+        return retValue.missing() ? Value(BSONNULL) : retValue;
+    }
+
+    vector<Value> vals;
+    vals.reserve(_idExpressions.size());
+    for (size_t i = 0; i < _idExpressions.size(); i++) {
+        vals.push_back(compiled.getResult(i));
+    }
+    return Value(std::move(vals));
+}
+
 Value DocumentSourceGroup::expandId(const Value& val) {
     // _id doesn't get wrapped in a document
     if (_idFieldNames.empty())
@@ -831,8 +1388,9 @@ Value DocumentSourceGroup::expandId(const Value& val) {
     return md.freezeToValue();
 }
 
+template <typename AccumulatorForField>
 Document DocumentSourceGroup::makeDocument(const Value& id,
-                                           const Accumulators& accums,
+                                           const AccumulatorForField& accumulatorForField,
                                            bool mergeableOutput) {
     const size_t n = _accumulatedFields.size();
     MutableDocument out(1 + n);
@@ -842,7 +1400,7 @@ Document DocumentSourceGroup::makeDocument(const Value& id,
 
     /* add the rest of the fields */
     for (size_t i = 0; i < n; ++i) {
-        Value val = accums[i]->getValue(mergeableOutput);
+        Value val = accumulatorForField(i)->getValue(mergeableOutput);
         if (val.missing()) {
             // we return null in this case so return objects are predictable
             out.addField(_accumulatedFields[i].fieldName, Value(BSONNULL));
@@ -854,6 +1412,18 @@ Document DocumentSourceGroup::makeDocument(const Value& id,
     return out.freeze();
 }
 
+Document DocumentSourceGroup::makeDocument(const Value& id,
+                                           const Accumulators& accums,
+                                           bool mergeableOutput) {
+    return makeDocument(id, [&](size_t i) { return accums[i].get(); }, mergeableOutput);
+}
+
+Document DocumentSourceGroup::makeDocument(size_t row, bool mergeableOutput) {
+    return makeDocument(_groups->getKey(row),
+                        [&](size_t i) { return _groups->getAccumulator(row, i); },
+                        mergeableOutput);
+}
+
 intrusive_ptr<DocumentSource> DocumentSourceGroup::getShardSource() {
     return this;  // No modifications necessary when on shard
 }
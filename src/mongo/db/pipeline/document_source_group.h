@@ -33,15 +33,21 @@
 
 #include "mongo/db/pipeline/accumulation_statement.h"
 #include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/compiled_expression.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/operation_memory_usage.h"
+#include "mongo/db/pipeline/group_table.h"
 #include "mongo/db/sorter/sorter.h"
 
 namespace mongo {
 
+class ParallelWorkerPool;
+
 class DocumentSourceGroup final : public DocumentSource, public NeedsMergerDocumentSource {
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
-    using GroupsMap = ValueUnorderedMap<Accumulators>;
+
+    ~DocumentSourceGroup();
 
     boost::intrusive_ptr<DocumentSource> optimize() final;
     DepsTracker::State getDependencies(DepsTracker* deps) const final;
@@ -50,6 +56,8 @@ public:
     const char* getSourceName() const final;
     BSONObjSet getOutputSorts() final;
     GetModPathsReturn getModifiedPaths() const final;
+    void detachFromOperationContext() final;
+    void reattachToOperationContext(OperationContext* opCtx) final;
 
     /**
      * Convenience method for creating a new $group stage. If maxMemoryUsageBytes is boost::none,
@@ -106,6 +114,25 @@ public:
         return _streaming;
     }
 
+    /**
+     * Returns true if this $group has partitioned its input across several threads. Only
+     * meaningful once execution has begun.
+     */
+    bool isRunningInParallel() const {
+        return static_cast<bool>(_parallel);
+    }
+
+    /**
+     * Returns true if any partition of this parallel $group has in turn partitioned its share of
+     * the input. Only used for testing.
+     */
+    bool anyPartitionRunningInParallelForTest() const;
+
+    /**
+     * Returns the pool whose threads run the partitions of parallel $group stages.
+     */
+    static ParallelWorkerPool* getParallelWorkerPool();
+
     /**
      * Returns true if this $group stage used disk during execution and false otherwise.
      */
@@ -121,6 +148,12 @@ protected:
     void doDispose() final;
 
 private:
+    /**
+     * State of a $group whose input is hash partitioned on the group key by an Exchange, with each
+     * partition grouped by its own DocumentSourceGroup on a separate thread. Defined in the .cpp.
+     */
+    struct ParallelExecution;
+
     explicit DocumentSourceGroup(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                                  boost::optional<size_t> maxMemoryUsageBytes = boost::none);
 
@@ -132,6 +165,36 @@ private:
     GetNextResult getNextStreaming();
     GetNextResult getNextSpilled();
     GetNextResult getNextStandard();
+    GetNextResult getNextParallel();
+
+    /**
+     * Returns the number of threads among which to partition this $group's input, or 1 if it must
+     * run serially: the parallelism knob for this process (internalDocumentSourceGroupParallelism,
+     * or internalDocumentSourceGroupMongosParallelism for the merging half of a pipeline on mongos)
+     * is 1, the grouping is collation-aware, the expressions reference variables that would not be
+     * visible to the partitions, or this $group is itself a partition.
+     */
+    size_t parallelismForExecution() const;
+
+    /**
+     * Called by initialize() before grouping any input. If this $group may run in parallel and the
+     * worker pool has a free thread for every partition, creates the partitions and schedules them
+     * on those threads. Otherwise leaves this $group to run serially.
+     */
+    void tryStartParallelExecution();
+
+    /**
+     * Parallel counterpart of initialize(), once tryStartParallelExecution() has started the
+     * partitions. Feeds 'pSource' to them, and waits for them to finish consuming their input. Like
+     * initialize(), returns kPauseExecution if 'pSource' pauses.
+     */
+    GetNextResult initializeParallel();
+
+    /**
+     * Stops feeding the partitions and waits for their threads to finish, without checking for
+     * interrupt. Safe to call more than once.
+     */
+    void abandonParallelExecution();
 
     /**
      * Attempt to identify an input sort order that allows us to turn into a streaming $group. If we
@@ -160,11 +223,31 @@ private:
 
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
+    /**
+     * Builds the output document for the group stored in row 'row' of '_groups'.
+     */
+    Document makeDocument(size_t row, bool mergeableOutput);
+
+    /**
+     * Builds an output document from the group key 'id', where 'accumulatorForField(i)' returns
+     * the accumulator for the i'th accumulated field.
+     */
+    template <typename AccumulatorForField>
+    Document makeDocument(const Value& id,
+                          const AccumulatorForField& accumulatorForField,
+                          bool mergeableOutput);
+
     /**
      * Computes the internal representation of the group key.
      */
     Value computeId(const Document& root);
 
+    /**
+     * Computes the internal representation of the group key from the results of
+     * '_compiledExpressions' for the last document it evaluated.
+     */
+    Value computeId(const CompiledExpression& compiled);
+
     /**
      * Converts the internal representation of the group key to the _id shape specified by the
      * user.
@@ -182,9 +265,16 @@ private:
     bool _doingMerge;
     size_t _memoryUsageBytes = 0;
     size_t _maxMemoryUsageBytes;
+
+    // Reports '_memoryUsageBytes' to the operation's and the server's memory accounting.
+    OperationMemoryUsage::Tracker _memoryTracker;
     std::vector<std::string> _idFieldNames;  // used when id is a document
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
 
+    // The '_idExpressions', followed by the expression of each accumulated field, compiled for a
+    // blocking $group. Null if they are evaluated one by one.
+    std::unique_ptr<CompiledExpression> _compiledExpressions;
+
     BSONObj _inputSort;
     bool _streaming;
     bool _initialized;
@@ -194,20 +284,27 @@ private:
 
     // We use boost::optional to defer initialization until the ExpressionContext containing the
     // correct comparator is injected, since the groups must be built using the comparator's
-    // definition of equality.
-    boost::optional<GroupsMap> _groups;
+    // definition of equality. It is also built only once all of the accumulators are known.
+    boost::optional<GroupTable> _groups;
 
     std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _sortedFiles;
     bool _spilled;
 
-    // Only used when '_spilled' is false.
-    GroupsMap::iterator groupsIterator;
+    // Only used when '_spilled' is false. The row of '_groups' to return next.
+    size_t _nextGroupRow = 0;
 
     // Only used when '_spilled' is true.
     std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
     const bool _allowDiskUse;
 
     std::pair<Value, Value> _firstPartOfNextGroup;
+
+    // Only set when this $group runs in parallel. Shared with the worker threads.
+    std::shared_ptr<ParallelExecution> _parallel;
+
+    // Whether this $group is one of the partitions of a parallel $group, and so must run serially.
+    bool _isParallelPartition = false;
+
     // Only used when '_sorted' is true.
     boost::optional<Document> _firstDocOfNextGroup;
 };
@@ -46,13 +46,18 @@
 #include "mongo/db/pipeline/document_value_test_util.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/parallel_worker_pool.h"
 #include "mongo/db/pipeline/value_comparator.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_test_service_context.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/stdx/unordered_set.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -227,6 +232,209 @@ TEST_F(DocumentSourceGroupTest, ShouldNotReportDottedGroupKeyAsARename) {
     ASSERT_EQ(modifiedPathsRet.renames.size(), 0UL);
 }
 
+/**
+ * Runs a $group on 'x' computing a count and a sum over 'inputs', returning its results sorted by
+ * _id. If 'partitionRanInParallel' is given, reports whether any partition of the $group was itself
+ * partitioned.
+ */
+vector<Document> runCountAndSumGroup(const intrusive_ptr<ExpressionContext>& expCtx,
+                                      const deque<DocumentSource::GetNextResult>& inputs,
+                                      bool* ranInParallel,
+                                      bool* partitionRanInParallel = nullptr) {
+    auto spec = BSON("$group" << BSON("_id"
+                                      << "$x"
+                                      << "count"
+                                      << BSON("$sum" << 1)
+                                      << "total"
+                                      << BSON("$sum"
+                                              << "$y")));
+    auto group = DocumentSourceGroup::createFromBson(spec.firstElement(), expCtx);
+    auto mock = DocumentSourceMock::create(inputs);
+    group->setSource(mock.get());
+
+    vector<Document> results;
+    for (auto next = group->getNext(); !next.isEOF(); next = group->getNext()) {
+        if (next.isAdvanced()) {
+            results.push_back(next.releaseDocument());
+        }
+    }
+    auto groupStage = static_cast<DocumentSourceGroup*>(group.get());
+    *ranInParallel = groupStage->isRunningInParallel();
+    if (partitionRanInParallel) {
+        *partitionRanInParallel = groupStage->anyPartitionRunningInParallelForTest();
+    }
+    group->dispose();
+
+    std::sort(results.begin(), results.end(), [](const Document& lhs, const Document& rhs) {
+        return ValueComparator().evaluate(lhs["_id"] < rhs["_id"]);
+    });
+    return results;
+}
+
+TEST_F(DocumentSourceGroupTest, ParallelGroupShouldProduceSameResultsAsSerialGroup) {
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 1000; ++i) {
+        // Mix numeric types so that equal group keys of different types must meet in the same
+        // partition.
+        Value key = (i % 3 == 0) ? Value(static_cast<long long>(i % 37)) : Value(i % 37);
+        inputs.emplace_back(Document{{"x", key}, {"y", i}});
+        if (i % 100 == 0) {
+            inputs.emplace_back(DocumentSource::GetNextResult::makePauseExecution());
+        }
+    }
+
+    bool ranInParallel = true;
+    auto serialResults = runCountAndSumGroup(getExpCtx(), inputs, &ranInParallel);
+    ASSERT_FALSE(ranInParallel);
+    ASSERT_EQ(serialResults.size(), 37UL);
+
+    const auto originalParallelism = internalDocumentSourceGroupParallelism.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(originalParallelism); });
+    internalDocumentSourceGroupParallelism.store(4);
+
+    auto parallelResults = runCountAndSumGroup(getExpCtx(), inputs, &ranInParallel);
+    ASSERT_TRUE(ranInParallel);
+    ASSERT_EQ(parallelResults.size(), serialResults.size());
+    for (size_t i = 0; i < serialResults.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(parallelResults[i], serialResults[i]);
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, ParallelGroupOnMongosShouldFollowMongosParallelism) {
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 1000; ++i) {
+        inputs.emplace_back(Document{{"x", i % 37}, {"y", i}});
+    }
+
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;
+
+    // The knob for shards does not apply to mongos.
+    const auto originalParallelism = internalDocumentSourceGroupParallelism.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(originalParallelism); });
+    internalDocumentSourceGroupParallelism.store(4);
+
+    bool ranInParallel = true;
+    auto serialResults = runCountAndSumGroup(expCtx, inputs, &ranInParallel);
+    ASSERT_FALSE(ranInParallel);
+    ASSERT_EQ(serialResults.size(), 37UL);
+
+    const auto originalMongosParallelism = internalDocumentSourceGroupMongosParallelism.load();
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceGroupMongosParallelism.store(originalMongosParallelism); });
+    internalDocumentSourceGroupMongosParallelism.store(4);
+
+    auto parallelResults = runCountAndSumGroup(expCtx, inputs, &ranInParallel);
+    ASSERT_TRUE(ranInParallel);
+    ASSERT_EQ(parallelResults.size(), serialResults.size());
+    for (size_t i = 0; i < serialResults.size(); ++i) {
+        ASSERT_DOCUMENT_EQ(parallelResults[i], serialResults[i]);
+    }
+}
+
+TEST_F(DocumentSourceGroupTest, PartitionsOfParallelGroupShouldRunSerially) {
+    const auto originalParallelism = internalDocumentSourceGroupParallelism.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(originalParallelism); });
+    internalDocumentSourceGroupParallelism.store(2);
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 100; ++i) {
+        inputs.emplace_back(Document{{"x", i % 10}, {"y", i}});
+    }
+
+    bool ranInParallel = false;
+    bool partitionRanInParallel = true;
+    auto results =
+        runCountAndSumGroup(getExpCtx(), inputs, &ranInParallel, &partitionRanInParallel);
+    ASSERT_TRUE(ranInParallel);
+    ASSERT_FALSE(partitionRanInParallel);
+    ASSERT_EQ(results.size(), 10UL);
+}
+
+TEST_F(DocumentSourceGroupTest, ParallelGroupShouldRunSeriallyWhenWorkersAreBusy) {
+    const auto originalParallelism = internalDocumentSourceGroupParallelism.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(originalParallelism); });
+    internalDocumentSourceGroupParallelism.store(4);
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 100; ++i) {
+        inputs.emplace_back(Document{{"x", i % 10}, {"y", i}});
+    }
+
+    // Leave one thread fewer than the $group needs.
+    auto pool = DocumentSourceGroup::getParallelWorkerPool();
+    auto busyWorkers = pool->tryReserve(pool->numAvailable() - 3);
+    ASSERT(busyWorkers);
+
+    bool ranInParallel = true;
+    auto results = runCountAndSumGroup(getExpCtx(), inputs, &ranInParallel);
+    ASSERT_FALSE(ranInParallel);
+    ASSERT_EQ(results.size(), 10UL);
+
+    busyWorkers->release();
+    results = runCountAndSumGroup(getExpCtx(), inputs, &ranInParallel);
+    ASSERT_TRUE(ranInParallel);
+    ASSERT_EQ(results.size(), 10UL);
+}
+
+TEST_F(DocumentSourceGroupTest, ConcurrentParallelGroupsShouldAllFinishWhenWorkersRunOut) {
+    // Every $group wants every thread of the pool, so most of them must run serially.
+    auto pool = DocumentSourceGroup::getParallelWorkerPool();
+    const auto originalParallelism = internalDocumentSourceGroupParallelism.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(originalParallelism); });
+    const size_t poolSize = pool->numAvailable();
+    internalDocumentSourceGroupParallelism.store(static_cast<int>(poolSize));
+
+    deque<DocumentSource::GetNextResult> inputs;
+    for (int i = 0; i < 2000; ++i) {
+        inputs.emplace_back(Document{{"x", i % 100}, {"y", i}});
+    }
+
+    const size_t kNumThreads = 8;
+    const size_t kGroupsPerThread = 4;
+    std::vector<size_t> numCorrect(kNumThreads, 0);
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (size_t i = 0; i < kGroupsPerThread; ++i) {
+                intrusive_ptr<ExpressionContextForTest> expCtx = new ExpressionContextForTest();
+                bool ranInParallel = false;
+                auto results = runCountAndSumGroup(expCtx, inputs, &ranInParallel);
+                if (results.size() == 100UL && results[0]["count"].getInt() == 20) {
+                    ++numCorrect[t];
+                }
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    for (size_t t = 0; t < kNumThreads; ++t) {
+        ASSERT_EQ(numCorrect[t], kGroupsPerThread);
+    }
+    ASSERT_EQ(pool->numAvailable(), poolSize);
+}
+
+TEST_F(DocumentSourceGroupTest, ParallelGroupShouldNotBeUsedWithCollation) {
+    const auto originalParallelism = internalDocumentSourceGroupParallelism.load();
+    ON_BLOCK_EXIT([&] { internalDocumentSourceGroupParallelism.store(originalParallelism); });
+    internalDocumentSourceGroupParallelism.store(4);
+
+    auto expCtx = getExpCtx();
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx->setCollator(&collator);
+
+    bool ranInParallel = true;
+    auto results = runCountAndSumGroup(expCtx,
+                                       {Document{{"x", "a"_sd}, {"y", 1}},
+                                        Document{{"x", "b"_sd}, {"y", 2}}},
+                                       &ranInParallel);
+    ASSERT_FALSE(ranInParallel);
+    ASSERT_EQ(results.size(), 1UL);
+    ASSERT_VALUE_EQ(results[0]["count"], Value(2));
+}
+
 BSONObj toBson(const intrusive_ptr<DocumentSource>& source) {
     vector<Value> arr;
     source->serializeToArray(arr);
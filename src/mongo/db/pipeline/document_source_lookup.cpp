@@ -30,9 +30,12 @@
 
 #include "mongo/db/pipeline/document_source_lookup.h"
 
+#include <numeric>
+
 #include "mongo/base/init.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
+#include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
@@ -40,6 +43,7 @@
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -67,6 +71,18 @@ std::string pipelineToString(const vector<BSONObj>& pipeline) {
 
 constexpr size_t DocumentSourceLookUp::kMaxSubPipelineDepth;
 
+StringData DocumentSourceLookUp::joinStrategyToString(JoinStrategy strategy) {
+    switch (strategy) {
+        case JoinStrategy::kNestedLoop:
+            return "nestedLoop"_sd;
+        case JoinStrategy::kBatchedNestedLoop:
+            return "batchedNestedLoop"_sd;
+        case JoinStrategy::kHashJoin:
+            return "hashJoin"_sd;
+    }
+    MONGO_UNREACHABLE;
+}
+
 DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
                                            std::string as,
                                            const boost::intrusive_ptr<ExpressionContext>& pExpCtx)
@@ -226,6 +242,59 @@ BSONObj buildEqualityOrQuery(const std::string& fieldName, const BSONArray& valu
     return orBuilder.obj();
 }
 
+/**
+ * Calls 'callback' with every value that an equality predicate on 'path' could match within
+ * 'value', starting at the path component 'index': the value at the end of the path, each element
+ * of it if it is an array, and likewise through any arrays of subdocuments along the way. This is
+ * a superset of what the match language considers, so candidates must still be verified.
+ */
+template <typename Callback>
+void visitJoinKeys(const Value& value, const FieldPath& path, size_t index, Callback&& callback) {
+    if (index == path.getPathLength()) {
+        if (value.missing()) {
+            return;
+        }
+        callback(value);
+        if (value.isArray()) {
+            for (auto&& elem : value.getArray()) {
+                callback(elem);
+            }
+        }
+        return;
+    }
+
+    if (value.getType() == BSONType::Object) {
+        visitJoinKeys(value.getDocument().getField(path.getFieldName(index)),
+                      path,
+                      index + 1,
+                      std::forward<Callback>(callback));
+    } else if (value.isArray()) {
+        for (auto&& elem : value.getArray()) {
+            if (elem.getType() == BSONType::Object) {
+                visitJoinKeys(elem.getDocument().getField(path.getFieldName(index)),
+                              path,
+                              index + 1,
+                              std::forward<Callback>(callback));
+            }
+        }
+    }
+}
+
+/**
+ * Returns true if any component of 'path' could be interpreted as an array index by the match
+ * language, in which case the join keys computed by visitJoinKeys() would not be a superset of the
+ * matching values.
+ */
+bool hasPositionalComponent(const FieldPath& path) {
+    for (size_t i = 0; i < path.getPathLength(); ++i) {
+        auto component = path.getFieldName(i);
+        if (std::all_of(component.begin(), component.end(), [](char c) { return isdigit(c); })) {
+            return true;
+        }
+    }
+    return false;
+}
+
 }  // namespace
 
 DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
@@ -235,7 +304,8 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
-    auto nextInput = pSource->getNext();
+    boost::optional<std::vector<Document>> joinedMatches;
+    auto nextInput = nextLocalInput(&joinedMatches);
     if (!nextInput.isAdvanced()) {
         return nextInput;
     }
@@ -246,30 +316,40 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     // '_unwindSrc' would be non-null, and we would not have made it here.
     invariant(!_matchSrc);
 
-    if (!wasConstructedWithPipelineSyntax()) {
-        auto matchStage =
-            makeMatchStageFromInput(inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
-        // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-        _resolvedPipeline.back() = matchStage;
-    }
-
-    auto pipeline = buildPipeline(inputDoc);
-
     std::vector<Value> results;
     int objsize = 0;
-    while (auto result = pipeline->getNext()) {
-        objsize += result->getApproximateSize();
+    auto appendResult = [&](Document&& result) {
+        objsize += result.getApproximateSize();
         uassert(4568,
                 str::stream() << "Total size of documents in " << _fromNs.coll()
                               << " matching pipeline "
                               << getUserPipelineDefinition()
                               << " exceeds maximum document size",
                 objsize <= BSONObjMaxInternalSize);
-        results.emplace_back(std::move(*result));
-    }
-    for (auto&& source : pipeline->getSources()) {
-        if (source->usedDisk())
-            _usedDisk = true;
+        results.emplace_back(std::move(result));
+    };
+
+    if (joinedMatches) {
+        for (auto&& result : *joinedMatches) {
+            appendResult(std::move(result));
+        }
+    } else {
+        if (!wasConstructedWithPipelineSyntax()) {
+            auto matchStage = makeMatchStageFromInput(
+                inputDoc, *_localField, _foreignField->fullPath(), BSONObj());
+            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
+            _resolvedPipeline.back() = matchStage;
+        }
+
+        auto pipeline = buildPipeline(inputDoc);
+
+        while (auto result = pipeline->getNext()) {
+            appendResult(std::move(*result));
+        }
+        for (auto&& source : pipeline->getSources()) {
+            if (source->usedDisk())
+                _usedDisk = true;
+        }
     }
 
     MutableDocument output(std::move(inputDoc));
@@ -277,6 +357,309 @@ DocumentSource::GetNextResult DocumentSourceLookUp::getNext() {
     return output.freeze();
 }
 
+DocumentSource::GetNextResult DocumentSourceLookUp::nextLocalInput(
+    boost::optional<std::vector<Document>>* matches) {
+    if (_batchedJoins.empty()) {
+        if (_batchEndResult) {
+            auto result = std::move(*_batchEndResult);
+            _batchEndResult = boost::none;
+            return result;
+        }
+
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            return nextInput;
+        }
+
+        auto localDoc = nextInput.releaseDocument();
+        *matches = hashJoinLookup(localDoc);
+        if (*matches || !canBatchProbes()) {
+            return std::move(localDoc);
+        }
+        loadLookupBatch(std::move(localDoc));
+    }
+
+    auto join = std::move(_batchedJoins.front());
+    _batchedJoins.pop_front();
+    *matches = std::move(join.matches);
+    return std::move(join.localDoc);
+}
+
+bool DocumentSourceLookUp::canBatchProbes() const {
+    return !wasConstructedWithPipelineSyntax() && _joinStrategy != JoinStrategy::kHashJoin &&
+        !_batchedProbesAbandoned && internalDocumentSourceLookupBatchSize.load() > 1;
+}
+
+void DocumentSourceLookUp::loadLookupBatch(Document firstLocalDoc) {
+    invariant(_batchedJoins.empty());
+
+    // The values of each local document are gathered into a single query, so the batch is also
+    // bounded by their size to keep that query well below the maximum BSON object size.
+    const size_t maxProbes = internalDocumentSourceLookupBatchSize.load();
+    const int maxKeyBytes = BSONObjMaxUserSize / 2;
+    size_t numProbes = 0;
+    int keyBytes = 0;
+    auto addProbe = [&](Document localDoc) {
+        document_path_support::visitAllValuesAtPath(
+            localDoc, *_localField, [&](const Value& value) {
+                keyBytes += value.getApproximateSize();
+            });
+        ++numProbes;
+        _batchedJoins.push_back({std::move(localDoc), boost::none});
+    };
+
+    addProbe(std::move(firstLocalDoc));
+    while (numProbes < maxProbes && keyBytes < maxKeyBytes) {
+        auto nextInput = pSource->getNext();
+        if (!nextInput.isAdvanced()) {
+            // Join what we have so far, and hand this result back once the batch is drained.
+            _batchEndResult = std::move(nextInput);
+            break;
+        }
+
+        auto localDoc = nextInput.releaseDocument();
+        if (auto matches = hashJoinLookup(localDoc)) {
+            // The stage switched to the hash join strategy while filling the batch, so there is no
+            // need to read any further ahead.
+            _batchedJoins.push_back({std::move(localDoc), std::move(matches)});
+            break;
+        }
+        addProbe(std::move(localDoc));
+    }
+
+    probeLookupBatch();
+}
+
+void DocumentSourceLookUp::probeLookupBatch() {
+    // Gather the values to join on from every local document that has not been joined yet.
+    BSONArrayBuilder localValuesBuilder;
+    bool containsRegex = false;
+    bool containsNullish = false;
+    for (auto&& join : _batchedJoins) {
+        if (join.matches) {
+            continue;
+        }
+        bool isMissing = true;
+        document_path_support::visitAllValuesAtPath(
+            join.localDoc, *_localField, [&](const Value& value) {
+                localValuesBuilder << value;
+                isMissing = false;
+                containsRegex = containsRegex || value.getType() == BSONType::RegEx;
+                containsNullish = containsNullish || value.nullish();
+            });
+        if (isMissing) {
+            // Missing values are treated as null.
+            localValuesBuilder << BSONNULL;
+            containsNullish = true;
+        }
+    }
+    const auto localValues = localValuesBuilder.arr();
+
+    // Issue a single query of the form
+    //
+    //   {$and: [{<foreignField>: {$in: [<value>, <value>, ...]}}, <additionalFilter>]}
+    //
+    // for the whole batch. Regular expressions only match other regular expressions in a $lookup,
+    // so if there are any we use a $or of equalities instead of $in, as
+    // makeMatchStageFromInput() does. Every batch has the same shape, which lets the foreign query
+    // reuse a single cached plan across the whole join.
+    const auto& foreignFieldName = _foreignField->fullPath();
+    BSONObjBuilder match;
+    {
+        BSONObjBuilder query(match.subobjStart("$match"));
+        BSONArrayBuilder andObj(query.subarrayStart("$and"));
+        if (containsRegex) {
+            andObj.append(buildEqualityOrQuery(foreignFieldName, localValues));
+        } else {
+            andObj.append(BSON(foreignFieldName << BSON("$in" << localValues)));
+        }
+        andObj.append(_additionalFilter.value_or(BSONObj()));
+    }
+    _resolvedPipeline.back() = match.obj();
+    auto pipeline = buildPipeline(Document());
+
+    const long long maxMemoryBytes = internalDocumentSourceLookupBatchMaxMemoryBytes.load();
+    long long memoryBytes = 0;
+    std::vector<BSONObj> foreignDocs;
+    while (auto result = pipeline->getNext()) {
+        pExpCtx->checkForInterrupt();
+
+        foreignDocs.push_back(result->toBson());
+        memoryBytes += foreignDocs.back().objsize();
+        if (memoryBytes > maxMemoryBytes) {
+            // The matches for the batch do not fit in memory. Join these local documents, and all
+            // that follow, with one query each.
+            _batchedProbesAbandoned = true;
+            _usedDisk = _usedDisk || pipeline->usedDisk();
+            return;
+        }
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+    _joinStrategy = JoinStrategy::kBatchedNestedLoop;
+
+    // Index the foreign documents by their join keys, unless a local value is nullish or the
+    // foreign path could be positional, in which case the keys would not find every match and
+    // each local document is checked against all foreign documents of the batch instead.
+    const bool useKeyIndex = !containsNullish && !hasPositionalComponent(*_foreignField);
+    auto keyIndex = _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+    if (useKeyIndex) {
+        for (size_t position = 0; position < foreignDocs.size(); ++position) {
+            visitJoinKeys(Value(foreignDocs[position]), *_foreignField, 0, [&](const Value& key) {
+                auto& positions = keyIndex[key];
+                if (positions.empty() || positions.back() != position) {
+                    positions.push_back(position);
+                }
+            });
+        }
+    }
+
+    // Hand each local document the foreign documents its own query would have returned, in the
+    // order the batch query returned them. '_additionalFilter' has already been applied.
+    for (auto&& join : _batchedJoins) {
+        if (join.matches) {
+            continue;
+        }
+
+        std::vector<size_t> candidates;
+        if (useKeyIndex) {
+            document_path_support::visitAllValuesAtPath(
+                join.localDoc, *_localField, [&](const Value& value) {
+                    auto it = keyIndex.find(value);
+                    if (it != keyIndex.end()) {
+                        candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+                    }
+                });
+            std::sort(candidates.begin(), candidates.end());
+            candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+        } else {
+            candidates.resize(foreignDocs.size());
+            std::iota(candidates.begin(), candidates.end(), 0);
+        }
+
+        join.matches.emplace();
+        if (candidates.empty()) {
+            continue;
+        }
+
+        auto matchStage =
+            makeMatchStageFromInput(join.localDoc, *_localField, foreignFieldName, BSONObj());
+        auto joinPredicate = uassertStatusOK(
+            MatchExpressionParser::parse(matchStage.firstElement().embeddedObject(), _fromExpCtx));
+        for (auto&& candidate : candidates) {
+            if (joinPredicate->matchesBSON(foreignDocs[candidate])) {
+                join.matches->emplace_back(foreignDocs[candidate]);
+            }
+        }
+    }
+}
+
+boost::optional<std::vector<Document>> DocumentSourceLookUp::hashJoinLookup(
+    const Document& localDoc) {
+    if (wasConstructedWithPipelineSyntax()) {
+        return boost::none;
+    }
+
+    if (_joinStrategy != JoinStrategy::kHashJoin) {
+        const auto minLocalDocs = internalDocumentSourceLookupHashJoinMinLocalDocs.load();
+        if (_hashJoinAttempted || minLocalDocs <= 0 || _numNestedLoopJoins < minLocalDocs ||
+            internalDocumentSourceLookupHashJoinMaxMemoryBytes.load() <= 0 ||
+            hasPositionalComponent(*_foreignField) || !buildHashJoinTable()) {
+            ++_numNestedLoopJoins;
+            return boost::none;
+        }
+    }
+
+    // Gather the local values to join on. An equality to null also matches documents in which the
+    // foreign field is missing or undefined, which the hash table does not index, so such inputs
+    // are joined with a query instead.
+    std::vector<Value> localValues;
+    bool needsNestedLoop = false;
+    document_path_support::visitAllValuesAtPath(localDoc, *_localField, [&](const Value& value) {
+        if (value.nullish()) {
+            needsNestedLoop = true;
+        }
+        localValues.push_back(value);
+    });
+    if (localValues.empty() || needsNestedLoop) {
+        ++_numNestedLoopJoins;
+        return boost::none;
+    }
+
+    std::vector<size_t> candidates;
+    for (auto&& value : localValues) {
+        auto it = _hashJoinTable->find(value);
+        if (it != _hashJoinTable->end()) {
+            candidates.insert(candidates.end(), it->second.begin(), it->second.end());
+        }
+    }
+
+    // Return matches in the order they were read from the foreign collection, without duplicates.
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::vector<Document> matches;
+    if (candidates.empty()) {
+        return matches;
+    }
+
+    // The hash table over-approximates the documents matched by the equality predicate, for
+    // example by treating every level of nested arrays the same way. Confirm each candidate with
+    // the predicate the nested loop strategy would have used. '_additionalFilter' has already been
+    // applied while building the table.
+    auto matchStage =
+        makeMatchStageFromInput(localDoc, *_localField, _foreignField->fullPath(), BSONObj());
+    auto joinPredicate = uassertStatusOK(
+        MatchExpressionParser::parse(matchStage.firstElement().embeddedObject(), _fromExpCtx));
+
+    for (auto&& candidate : candidates) {
+        const auto& foreignDoc = _hashJoinForeignDocs[candidate];
+        if (joinPredicate->matchesBSON(foreignDoc)) {
+            matches.emplace_back(foreignDoc);
+        }
+    }
+    return matches;
+}
+
+bool DocumentSourceLookUp::buildHashJoinTable() {
+    invariant(!wasConstructedWithPipelineSyntax());
+    _hashJoinAttempted = true;
+
+    // Read every foreign document which passes any $match absorbed from later in the pipeline.
+    _resolvedPipeline.back() = BSON("$match" << _additionalFilter.value_or(BSONObj()));
+    auto pipeline = buildPipeline(Document());
+
+    const long long maxMemoryBytes = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    long long memoryBytes = 0;
+    std::vector<BSONObj> foreignDocs;
+    auto table = _fromExpCtx->getValueComparator().makeUnorderedValueMap<std::vector<size_t>>();
+
+    while (auto result = pipeline->getNext()) {
+        pExpCtx->checkForInterrupt();
+
+        auto foreignDoc = result->toBson();
+        memoryBytes += foreignDoc.objsize();
+        if (memoryBytes > maxMemoryBytes) {
+            // The foreign side does not fit in memory. Stick with one query per local document.
+            return false;
+        }
+
+        const size_t position = foreignDocs.size();
+        visitJoinKeys(Value(*result), *_foreignField, 0, [&](const Value& key) {
+            auto& positions = table[key];
+            if (positions.empty() || positions.back() != position) {
+                positions.push_back(position);
+            }
+        });
+        foreignDocs.push_back(std::move(foreignDoc));
+    }
+    _usedDisk = _usedDisk || pipeline->usedDisk();
+
+    _hashJoinForeignDocs = std::move(foreignDocs);
+    _hashJoinTable.emplace(std::move(table));
+    _joinStrategy = JoinStrategy::kHashJoin;
+    return true;
+}
+
 std::unique_ptr<Pipeline, PipelineDeleter> DocumentSourceLookUp::buildPipeline(
     const Document& inputDoc) {
     // Copy all 'let' variables into the foreign pipeline's expression context.
@@ -342,7 +725,8 @@ Pipeline::SourceContainer::iterator DocumentSourceLookUp::doOptimizeAt(
 
     // If we are not already handling an $unwind stage internally, we can combine with the
     // following $unwind stage.
-    if (nextUnwind && !_unwindSrc && nextUnwind->getUnwindPath() == _as.fullPath()) {
+    if (nextUnwind && !_unwindSrc && !nextUnwind->hasAbsorbedMatch() &&
+        nextUnwind->getUnwindPath() == _as.fullPath()) {
         _unwindSrc = std::move(nextUnwind);
         container->erase(std::next(itr));
         return itr;
@@ -463,6 +847,8 @@ bool DocumentSourceLookUp::usedDisk() {
 }
 
 void DocumentSourceLookUp::doDispose() {
+    _batchedJoins.clear();
+    _batchEndResult = boost::none;
     if (_pipeline) {
         _usedDisk = _usedDisk || _pipeline->usedDisk();
         _pipeline->dispose(pExpCtx->opCtx);
@@ -557,39 +943,61 @@ BSONObj DocumentSourceLookUp::makeMatchStageFromInput(const Document& input,
 DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
     const boost::optional<FieldPath> indexPath(_unwindSrc->indexPath());
 
+    // Returns the next foreign match for '_input', from '_pipeline' if it was joined with a query
+    // of its own and from '_bufferedMatches' otherwise.
+    auto nextForeignMatch = [this]() -> boost::optional<Document> {
+        if (_pipeline) {
+            return _pipeline->getNext();
+        }
+        if (_bufferedMatches.empty()) {
+            return boost::none;
+        }
+        auto match = std::move(_bufferedMatches.front());
+        _bufferedMatches.pop_front();
+        return match;
+    };
+
     // Loop until we get a document that has at least one match.
     // Note we may return early from this loop if our source stage is exhausted or if the unwind
     // source was asked to return empty arrays and we get a document without a match.
-    while (!_pipeline || !_nextValue) {
-        auto nextInput = pSource->getNext();
+    while (!_nextValue) {
+        boost::optional<std::vector<Document>> joinedMatches;
+        auto nextInput = nextLocalInput(&joinedMatches);
         if (!nextInput.isAdvanced()) {
             return nextInput;
         }
 
         _input = nextInput.releaseDocument();
 
-        if (!wasConstructedWithPipelineSyntax()) {
-            BSONObj filter = _additionalFilter.value_or(BSONObj());
-            auto matchStage =
-                makeMatchStageFromInput(*_input, *_localField, _foreignField->fullPath(), filter);
-            // We've already allocated space for the trailing $match stage in '_resolvedPipeline'.
-            _resolvedPipeline.back() = matchStage;
-        }
-
         if (_pipeline) {
             _usedDisk = _usedDisk || _pipeline->usedDisk();
             _pipeline->dispose(pExpCtx->opCtx);
+            _pipeline.reset();
         }
 
-        _pipeline = buildPipeline(*_input);
+        if (joinedMatches) {
+            _bufferedMatches.assign(std::make_move_iterator(joinedMatches->begin()),
+                                    std::make_move_iterator(joinedMatches->end()));
+        } else {
+            if (!wasConstructedWithPipelineSyntax()) {
+                BSONObj filter = _additionalFilter.value_or(BSONObj());
+                auto matchStage = makeMatchStageFromInput(
+                    *_input, *_localField, _foreignField->fullPath(), filter);
+                // We've already allocated space for the trailing $match stage in
+                // '_resolvedPipeline'.
+                _resolvedPipeline.back() = matchStage;
+            }
 
-        // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
-        // potentially be used by multiple OperationContexts, and the $lookup stage is part of an
-        // outer Pipeline that will propagate dispose() calls before being destroyed.
-        _pipeline.get_deleter().dismissDisposal();
+            _pipeline = buildPipeline(*_input);
+
+            // The $lookup stage takes responsibility for disposing of its Pipeline, since it will
+            // potentially be used by multiple OperationContexts, and the $lookup stage is part of
+            // an outer Pipeline that will propagate dispose() calls before being destroyed.
+            _pipeline.get_deleter().dismissDisposal();
+        }
 
         _cursorIndex = 0;
-        _nextValue = _pipeline->getNext();
+        _nextValue = nextForeignMatch();
 
         if (_unwindSrc->preserveNullAndEmptyArrays() && !_nextValue) {
             // There were no results for this cursor, but the $unwind was asked to preserve empty
@@ -607,7 +1015,7 @@ DocumentSource::GetNextResult DocumentSourceLookUp::unwindResult() {
 
     invariant(bool(_input) && bool(_nextValue));
     auto currentValue = *_nextValue;
-    _nextValue = _pipeline->getNext();
+    _nextValue = nextForeignMatch();
 
     // Move input document into output if this is the last or only result, otherwise perform a copy.
     MutableDocument output(_nextValue ? *_input : std::move(*_input));
@@ -698,6 +1106,13 @@ void DocumentSourceLookUp::serializeToArray(
             output[getSourceName()]["matching"] = Value(*_additionalFilter);
         }
 
+        if (!wasConstructedWithPipelineSyntax() &&
+            *explain >= ExplainOptions::Verbosity::kExecStats) {
+            // The strategy is chosen during execution, so it is only reported alongside execution
+            // statistics.
+            output[getSourceName()]["strategy"] = Value(joinStrategyToString(_joinStrategy));
+        }
+
         array.push_back(Value(output.freeze()));
     } else {
         array.push_back(Value(output.freeze()));
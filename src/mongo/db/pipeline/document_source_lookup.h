@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_match.h"
@@ -181,6 +182,14 @@ public:
         return buildPipeline(inputDoc);
     }
 
+    /**
+     * Returns true if this stage has switched to joining via an in-memory hash table of the
+     * foreign collection.
+     */
+    bool isUsingHashJoin_forTest() const {
+        return _joinStrategy == JoinStrategy::kHashJoin;
+    }
+
 protected:
     void doDispose() final;
 
@@ -192,6 +201,28 @@ protected:
                                                      Pipeline::SourceContainer* container) final;
 
 private:
+    /**
+     * How the foreign documents for each local document are found. A $lookup always starts with
+     * kNestedLoop, which issues one query against the foreign collection per local document. A
+     * $lookup with localField/foreignField syntax instead uses kBatchedNestedLoop, which issues one
+     * query for a batch of local documents and distributes its results among them, and switches
+     * to kHashJoin once enough local documents have been seen, provided the foreign side fits in
+     * memory.
+     */
+    enum class JoinStrategy { kNestedLoop, kBatchedNestedLoop, kHashJoin };
+
+    /**
+     * A local document read ahead into a batch, along with its foreign matches once they are
+     * known. 'matches' is boost::none if the local document must be joined with a query of its
+     * own.
+     */
+    struct BatchedJoin {
+        Document localDoc;
+        boost::optional<std::vector<Document>> matches;
+    };
+
+    static StringData joinStrategyToString(JoinStrategy strategy);
+
     struct LetVariable {
         LetVariable(std::string name, boost::intrusive_ptr<Expression> expression, Variables::Id id)
             : name(std::move(name)), expression(std::move(expression)), id(id) {}
@@ -238,6 +269,49 @@ private:
 
     GetNextResult unwindResult();
 
+    /**
+     * Returns the next local document to join. If its foreign matches have already been computed,
+     * by the hash join or as part of a batch, they are stored in 'matches'; otherwise 'matches' is
+     * left as boost::none and the caller must query the foreign collection for it.
+     */
+    GetNextResult nextLocalInput(boost::optional<std::vector<Document>>* matches);
+
+    /**
+     * Returns true if local documents which are not joined by the hash join may be joined in
+     * batches, with a single foreign query per batch.
+     */
+    bool canBatchProbes() const;
+
+    /**
+     * Reads up to internalDocumentSourceLookupBatchSize local documents, starting with
+     * 'firstLocalDoc', into '_batchedJoins' and joins them via probeLookupBatch(). A non-advanced
+     * result which ends the batch early is held in '_batchEndResult'.
+     */
+    void loadLookupBatch(Document firstLocalDoc);
+
+    /**
+     * Queries the foreign collection once for all local documents in '_batchedJoins' without
+     * matches, and distributes the results among them. If the results would exceed
+     * internalDocumentSourceLookupBatchMaxMemoryBytes, leaves those documents to be joined one at
+     * a time and stops batching.
+     */
+    void probeLookupBatch();
+
+    /**
+     * Returns the foreign documents matching 'localDoc', computed by probing the hash table of the
+     * foreign collection, or boost::none if the nested loop strategy must be used for 'localDoc'.
+     * Builds the hash table first if this is the point at which the stage should switch to the
+     * hash join strategy.
+     */
+    boost::optional<std::vector<Document>> hashJoinLookup(const Document& localDoc);
+
+    /**
+     * Reads the foreign collection, applying '_additionalFilter', into '_hashJoinForeignDocs' and
+     * '_hashJoinTable'. Returns false, leaving the stage with the nested loop strategy, if the
+     * foreign documents would exceed internalDocumentSourceLookupHashJoinMaxMemoryBytes.
+     */
+    bool buildHashJoinTable();
+
     /**
      * Copies 'vars' and 'vps' to the Variables and VariablesParseState objects in 'expCtx'. These
      * copies provide access to 'let' defined variables in sub-pipeline execution.
@@ -326,6 +400,24 @@ private:
     std::unique_ptr<Pipeline, PipelineDeleter> _pipeline;
     boost::optional<Document> _input;
     boost::optional<Document> _nextValue;
+
+    // The following members implement the hash join strategy. '_hashJoinTable' maps each value at
+    // the 'foreignField' path of a foreign document (including each element of an array value) to
+    // the positions of the documents holding it within '_hashJoinForeignDocs'.
+    JoinStrategy _joinStrategy = JoinStrategy::kNestedLoop;
+    bool _hashJoinAttempted = false;
+    long long _numNestedLoopJoins = 0;
+    std::vector<BSONObj> _hashJoinForeignDocs;
+    boost::optional<ValueUnorderedMap<std::vector<size_t>>> _hashJoinTable;
+
+    // Remaining hash join or batched matches for '_input' when '_unwindSrc' is not null.
+    std::deque<Document> _bufferedMatches;
+
+    // The following members implement the batched nested loop strategy. '_batchedJoins' holds the
+    // local documents read ahead of the one being returned.
+    bool _batchedProbesAbandoned = false;
+    std::deque<BatchedJoin> _batchedJoins;
+    boost::optional<GetNextResult> _batchEndResult;
 };
 
 }  // namespace mongo
@@ -31,11 +31,13 @@
 #include "mongo/db/pipeline/document_source_lookup_change_post_image.h"
 
 #include "mongo/bson/simple_bsonelement_comparator.h"
+#include "mongo/util/uuid.h"
 
 namespace mongo {
 
 constexpr StringData DocumentSourceLookupChangePostImage::kStageName;
 constexpr StringData DocumentSourceLookupChangePostImage::kFullDocumentFieldName;
+constexpr size_t DocumentSourceLookupChangePostImage::kMaxLookupBatchSize;
 
 namespace {
 Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType expectedType) {
@@ -58,19 +60,41 @@ Value assertFieldHasType(const Document& fullDoc, StringData fieldName, BSONType
 DocumentSource::GetNextResult DocumentSourceLookupChangePostImage::getNext() {
     pExpCtx->checkForInterrupt();
 
-    auto input = pSource->getNext();
-    if (!input.isAdvanced()) {
-        return input;
-    }
-    auto opTypeVal = assertFieldHasType(
-        input.getDocument(), DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
-    if (opTypeVal.getString() != DocumentSourceChangeStream::kUpdateOpType) {
-        return input;
+    if (_buffer.empty()) {
+        if (_pendingResult) {
+            auto pending = std::move(*_pendingResult);
+            _pendingResult = boost::none;
+            return pending;
+        }
+
+        auto input = pSource->getNext();
+        if (!input.isAdvanced() || !isUpdate(input.getDocument())) {
+            return input;
+        }
+        _buffer.push_back(input.releaseDocument());
+
+        // Only read ahead what the previous stage returns without pausing or reaching the end of
+        // the current batch, so that no event is delayed waiting for more to arrive.
+        while (_buffer.size() < kMaxLookupBatchSize) {
+            auto next = pSource->getNext();
+            if (!next.isAdvanced()) {
+                _pendingResult = std::move(next);
+                break;
+            }
+            _buffer.push_back(next.releaseDocument());
+        }
+        lookupPostImages();
     }
 
-    MutableDocument output(input.releaseDocument());
-    output[kFullDocumentFieldName] = lookupPostImage(output.peek());
-    return output.freeze();
+    auto next = std::move(_buffer.front());
+    _buffer.pop_front();
+    return next;
+}
+
+bool DocumentSourceLookupChangePostImage::isUpdate(const Document& event) {
+    auto opTypeVal = assertFieldHasType(
+        event, DocumentSourceChangeStream::kOperationTypeField, BSONType::String);
+    return opTypeVal.getString() == DocumentSourceChangeStream::kUpdateOpType;
 }
 
 NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
@@ -95,32 +119,66 @@ NamespaceString DocumentSourceLookupChangePostImage::assertValidNamespace(
     return nss;
 }
 
-Value DocumentSourceLookupChangePostImage::lookupPostImage(const Document& updateOp) const {
-    // Make sure we have a well-formed input.
-    auto nss = assertValidNamespace(updateOp);
-
-    auto documentKey = assertFieldHasType(updateOp,
-                                          DocumentSourceChangeStream::kDocumentKeyField,
-                                          BSONType::Object)
-                           .getDocument();
-
-    // Extract the UUID from resume token and do change stream lookups by UUID.
-    auto resumeToken =
-        ResumeToken::parse(updateOp[DocumentSourceChangeStream::kIdField].getDocument());
-
-    const auto readConcern = pExpCtx->inMongos
-        ? boost::optional<BSONObj>(BSON("level"
-                                        << "majority"
-                                        << "afterClusterTime"
-                                        << resumeToken.getData().clusterTime))
-        : boost::none;
-    invariant(resumeToken.getData().uuid);
-    auto lookedUpDoc = pExpCtx->mongoProcessInterface->lookupSingleDocument(
-        pExpCtx, nss, *resumeToken.getData().uuid, documentKey, readConcern);
-
-    // Check whether the lookup returned any documents. Even if the lookup itself succeeded, it may
-    // not have returned any results if the document was deleted in the time since the update op.
-    return (lookedUpDoc ? Value(*lookedUpDoc) : Value(BSONNULL));
+void DocumentSourceLookupChangePostImage::lookupPostImages() {
+    // The updates in '_buffer' whose documents live in one collection.
+    struct LookupBatch {
+        NamespaceString nss;
+        std::vector<size_t> positions;
+        std::vector<Document> documentKeys;
+        Timestamp latestClusterTime;
+    };
+    std::map<UUID, LookupBatch> batches;
+
+    for (size_t i = 0; i < _buffer.size(); ++i) {
+        const auto& updateOp = _buffer[i];
+        if (!isUpdate(updateOp)) {
+            continue;
+        }
+
+        // Make sure we have a well-formed input.
+        auto nss = assertValidNamespace(updateOp);
+
+        auto documentKey = assertFieldHasType(updateOp,
+                                              DocumentSourceChangeStream::kDocumentKeyField,
+                                              BSONType::Object)
+                               .getDocument();
+
+        // Extract the UUID from resume token and do change stream lookups by UUID.
+        auto resumeToken =
+            ResumeToken::parse(updateOp[DocumentSourceChangeStream::kIdField].getDocument());
+        invariant(resumeToken.getData().uuid);
+
+        auto& batch = batches[*resumeToken.getData().uuid];
+        batch.nss = std::move(nss);
+        batch.positions.push_back(i);
+        batch.documentKeys.push_back(std::move(documentKey));
+        batch.latestClusterTime =
+            std::max(batch.latestClusterTime, resumeToken.getData().clusterTime);
+    }
+
+    for (auto&& uuidAndBatch : batches) {
+        auto& batch = uuidAndBatch.second;
+
+        // Reading after the latest update of the batch also reads after each of the others.
+        const auto readConcern = pExpCtx->inMongos
+            ? boost::optional<BSONObj>(BSON("level"
+                                            << "majority"
+                                            << "afterClusterTime"
+                                            << batch.latestClusterTime))
+            : boost::none;
+        auto lookedUpDocs = pExpCtx->mongoProcessInterface->lookupDocuments(
+            pExpCtx, batch.nss, uuidAndBatch.first, batch.documentKeys, readConcern);
+        invariant(lookedUpDocs.size() == batch.positions.size());
+
+        for (size_t i = 0; i < batch.positions.size(); ++i) {
+            // Even if the lookup itself succeeded, it may not have returned any results if the
+            // document was deleted in the time since the update op.
+            MutableDocument output(std::move(_buffer[batch.positions[i]]));
+            output[kFullDocumentFieldName] =
+                (lookedUpDocs[i] ? Value(*lookedUpDocs[i]) : Value(BSONNULL));
+            _buffer[batch.positions[i]] = output.freeze();
+        }
+    }
 }
 
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <deque>
+
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_change_stream.h"
 
@@ -43,6 +45,10 @@ public:
     static constexpr StringData kFullDocumentFieldName =
         DocumentSourceChangeStream::kFullDocumentField;
 
+    // The maximum number of events read ahead so that their post-images can be looked up
+    // together.
+    static constexpr size_t kMaxLookupBatchSize = 100;
+
     /**
      * Creates a DocumentSourceLookupChangePostImage stage.
      */
@@ -88,7 +94,9 @@ public:
     }
 
     /**
-     * Performs the lookup to retrieve the full document.
+     * Performs the lookup to retrieve the full document. Events which are already available from
+     * the previous stage are read ahead, so that the lookups for all updates among them are done
+     * with one query per collection.
      */
     GetNextResult getNext() final;
 
@@ -108,10 +116,16 @@ private:
         : DocumentSource(expCtx) {}
 
     /**
-     * Uses the "documentKey" field from 'updateOp' to look up the current version of the document.
-     * Returns Value(BSONNULL) if the document couldn't be found.
+     * Uses the "documentKey" field of each update in '_buffer' to look up the current version of
+     * its document, and sets it as the "fullDocument" of the update, or BSONNULL if the document
+     * couldn't be found.
      */
-    Value lookupPostImage(const Document& updateOp) const;
+    void lookupPostImages();
+
+    /**
+     * Returns true if 'event' is an update, the only operation type whose post-image is looked up.
+     */
+    static bool isUpdate(const Document& event);
 
     /**
      * Throws a AssertionException if the namespace found in 'inputDoc' doesn't match the one on the
@@ -119,6 +133,13 @@ private:
      * function verifies that the only the database names match.
      */
     NamespaceString assertValidNamespace(const Document& inputDoc) const;
+
+    // Events read from the previous stage which have not been returned yet, in order.
+    std::deque<Document> _buffer;
+
+    // A non-advanced result from the previous stage which ended the read-ahead. It is returned
+    // once '_buffer' has been drained.
+    boost::optional<GetNextResult> _pendingResult;
 };
 
 }  // namespace mongo
@@ -393,5 +393,79 @@ TEST_F(DocumentSourceLookupChangePostImageTest, ShouldPropagatePauses) {
     ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
 }
 
+TEST_F(DocumentSourceLookupChangePostImageTest, ShouldLookUpEachUpdateReadAheadInOrder) {
+    auto expCtx = getExpCtx();
+
+    // Set up the lookup change post image stage.
+    auto lookupChangeStage = DocumentSourceLookupChangePostImage::create(expCtx);
+
+    // Mock its input with consecutive updates around an insert, one of them for a deleted document.
+    const auto ns = Document{{"db", expCtx->ns.db()}, {"coll", expCtx->ns.coll()}};
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"_id", makeResumeToken(0)},
+                                             {"documentKey", Document{{"_id", 0}}},
+                                             {"operationType", "update"_sd},
+                                             {"ns", ns}},
+                                    Document{{"_id", makeResumeToken(1)},
+                                             {"documentKey", Document{{"_id", 1}}},
+                                             {"operationType", "insert"_sd},
+                                             {"ns", ns},
+                                             {"fullDocument", Document{{"_id", 1}}}},
+                                    Document{{"_id", makeResumeToken(2)},
+                                             {"documentKey", Document{{"_id", 2}}},
+                                             {"operationType", "update"_sd},
+                                             {"ns", ns}},
+                                    Document{{"_id", makeResumeToken(3)},
+                                             {"documentKey", Document{{"_id", 1}}},
+                                             {"operationType", "update"_sd},
+                                             {"ns", ns}}});
+
+    lookupChangeStage->setSource(mockLocalSource.get());
+
+    // Mock out the foreign collection, which no longer contains the document with _id 2.
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}},
+                                                             Document{{"_id", 1}}};
+    getExpCtx()->mongoProcessInterface =
+        stdx::make_unique<MockMongoInterface>(std::move(mockForeignContents));
+
+    auto next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", makeResumeToken(0)},
+                                 {"documentKey", Document{{"_id", 0}}},
+                                 {"operationType", "update"_sd},
+                                 {"ns", ns},
+                                 {"fullDocument", Document{{"_id", 0}}}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", makeResumeToken(1)},
+                                 {"documentKey", Document{{"_id", 1}}},
+                                 {"operationType", "insert"_sd},
+                                 {"ns", ns},
+                                 {"fullDocument", Document{{"_id", 1}}}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", makeResumeToken(2)},
+                                 {"documentKey", Document{{"_id", 2}}},
+                                 {"operationType", "update"_sd},
+                                 {"ns", ns},
+                                 {"fullDocument", BSONNULL}}));
+
+    next = lookupChangeStage->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"_id", makeResumeToken(3)},
+                                 {"documentKey", Document{{"_id", 1}}},
+                                 {"operationType", "update"_sd},
+                                 {"ns", ns},
+                                 {"fullDocument", Document{{"_id", 1}}}}));
+
+    ASSERT_TRUE(lookupChangeStage->getNext().isEOF());
+}
+
 }  // namespace
 }  // namespace mongo
@@ -47,6 +47,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/storage_interface_mock.h"
 #include "mongo/db/server_options.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -546,6 +547,7 @@ public:
         const std::vector<BSONObj>& rawPipeline,
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         const MakePipelineOptions opts) final {
+        ++_numPipelinesMade;
         auto pipeline = Pipeline::parse(rawPipeline, expCtx);
         if (!pipeline.isOK()) {
             return pipeline.getStatus();
@@ -576,9 +578,14 @@ public:
         return Status::OK();
     }
 
+    int numPipelinesMade() const {
+        return _numPipelinesMade;
+    }
+
 private:
     deque<DocumentSource::GetNextResult> _mockResults;
     bool _removeLeadingQueryStages = false;
+    int _numPipelinesMade = 0;
 };
 
 TEST_F(DocumentSourceLookUpTest, ShouldPropagatePauses) {
@@ -735,6 +742,339 @@ TEST_F(DocumentSourceLookUpTest, LookupReportsFieldsModifiedByAbsorbedUnwind) {
     lookup->dispose();
 }
 
+TEST_F(DocumentSourceLookUpTest, SwitchesToHashJoinAfterEnoughLocalDocuments) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    // Join one local document at a time, so that the switch to the hash join is observable.
+    const auto originalMinLocalDocs = internalDocumentSourceLookupHashJoinMinLocalDocs.load();
+    const auto originalBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupHashJoinMinLocalDocs.store(1);
+    internalDocumentSourceLookupBatchSize.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupHashJoinMinLocalDocs.store(originalMinLocalDocs);
+        internalDocumentSourceLookupBatchSize.store(originalBatchSize);
+    });
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    const Value zeroAndOne(vector<Value>{Value(0), Value(1)});
+    const Value oneAndThree(vector<Value>{Value(1), Value(3)});
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"foreignId", 0}},
+                                                       Document{{"foreignId", 1}},
+                                                       Document{{"foreignId", zeroAndOne}},
+                                                       Document{{"foreignId", 2}},
+                                                       Document{{"foreignId", Value(BSONNULL)}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document foreign0{{"_id", 0}, {"key", 0}};
+    const Document foreign1{{"_id", 1}, {"key", oneAndThree}};
+    const Document foreign2{{"_id", 2}, {"key", 1.0}};
+    const Document foreign3{{"_id", 3}};
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document(foreign0), Document(foreign1), Document(foreign2), Document(foreign3)};
+    expCtx->mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+
+    // The first local document is joined with a query against the foreign collection.
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_FALSE(lookup->isUsingHashJoin_forTest());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 0}, {"foreignDocs", vector<Value>{Value(foreign0)}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_TRUE(lookup->isUsingHashJoin_forTest());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1},
+                  {"foreignDocs", vector<Value>{Value(foreign1), Value(foreign2)}}}));
+
+    // Each foreign document is returned once, in foreign collection order.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{
+            {"foreignId", zeroAndOne},
+            {"foreignDocs", vector<Value>{Value(foreign0), Value(foreign1), Value(foreign2)}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 2}, {"foreignDocs", vector<Value>{}}}));
+
+    // An equality to null also matches a missing foreign field.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", Value(BSONNULL)},
+                  {"foreignDocs", vector<Value>{Value(foreign3)}}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    vector<Value> explainedStages;
+    lookup->serializeToArray(explainedStages, ExplainOptions::Verbosity::kExecStats);
+    ASSERT_EQ(explainedStages.size(), 1UL);
+    ASSERT_VALUE_EQ(explainedStages[0]["$lookup"]["strategy"], Value("hashJoin"_sd));
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, HashJoinIsAbandonedIfForeignSideExceedsMemoryLimit) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    const auto originalMinLocalDocs = internalDocumentSourceLookupHashJoinMinLocalDocs.load();
+    const auto originalMaxMemory = internalDocumentSourceLookupHashJoinMaxMemoryBytes.load();
+    const auto originalBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupHashJoinMinLocalDocs.store(1);
+    internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(1);
+    internalDocumentSourceLookupBatchSize.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupHashJoinMinLocalDocs.store(originalMinLocalDocs);
+        internalDocumentSourceLookupHashJoinMaxMemoryBytes.store(originalMaxMemory);
+        internalDocumentSourceLookupBatchSize.store(originalBatchSize);
+    });
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"foreignId", 0}}, Document{{"foreignId", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}},
+                                                             Document{{"_id", 1}}};
+    expCtx->mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+
+    ASSERT_TRUE(lookup->getNext().isAdvanced());
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_FALSE(lookup->isUsingHashJoin_forTest());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 1}})}}}));
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    vector<Value> explainedStages;
+    lookup->serializeToArray(explainedStages, ExplainOptions::Verbosity::kExecStats);
+    ASSERT_VALUE_EQ(explainedStages[0]["$lookup"]["strategy"], Value("nestedLoop"_sd));
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldJoinLocalDocumentsInBatchesWithOneQueryEach) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    const auto originalMinLocalDocs = internalDocumentSourceLookupHashJoinMinLocalDocs.load();
+    const auto originalBatchSize = internalDocumentSourceLookupBatchSize.load();
+    internalDocumentSourceLookupHashJoinMinLocalDocs.store(0);
+    internalDocumentSourceLookupBatchSize.store(3);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupHashJoinMinLocalDocs.store(originalMinLocalDocs);
+        internalDocumentSourceLookupBatchSize.store(originalBatchSize);
+    });
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "key"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    const Value zeroAndOne(vector<Value>{Value(0), Value(1)});
+    const Value oneAndThree(vector<Value>{Value(1), Value(3)});
+    auto mockLocalSource = DocumentSourceMock::create({Document{{"foreignId", 0}},
+                                                       Document{{"foreignId", zeroAndOne}},
+                                                       Document{{"other", 1}},
+                                                       Document{{"foreignId", 5}},
+                                                       Document{{"foreignId", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    const Document foreign0{{"_id", 0}, {"key", 0}};
+    const Document foreign1{{"_id", 1}, {"key", oneAndThree}};
+    const Document foreign2{{"_id", 2}, {"key", 1.0}};
+    const Document foreign3{{"_id", 3}};
+    deque<DocumentSource::GetNextResult> mockForeignContents{
+        Document(foreign0), Document(foreign1), Document(foreign2), Document(foreign3)};
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoInterface;
+
+    // The first three local documents are joined with a single query.
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQ(mongoInterface->numPipelinesMade(), 1);
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 0}, {"foreignDocs", vector<Value>{Value(foreign0)}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{
+            {"foreignId", zeroAndOne},
+            {"foreignDocs", vector<Value>{Value(foreign0), Value(foreign1), Value(foreign2)}}}));
+
+    // A missing local field matches a missing foreign field.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"other", 1}, {"foreignDocs", vector<Value>{Value(foreign3)}}}));
+    ASSERT_EQ(mongoInterface->numPipelinesMade(), 1);
+
+    // The remaining two are joined with a second query.
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_EQ(mongoInterface->numPipelinesMade(), 2);
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", 5}, {"foreignDocs", vector<Value>{}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1},
+                  {"foreignDocs", vector<Value>{Value(foreign1), Value(foreign2)}}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    ASSERT_EQ(mongoInterface->numPipelinesMade(), 2);
+
+    vector<Value> explainedStages;
+    lookup->serializeToArray(explainedStages, ExplainOptions::Verbosity::kExecStats);
+    ASSERT_VALUE_EQ(explainedStages[0]["$lookup"]["strategy"], Value("batchedNestedLoop"_sd));
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, ShouldJoinBatchesWhileUnwinding) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    const auto originalMinLocalDocs = internalDocumentSourceLookupHashJoinMinLocalDocs.load();
+    internalDocumentSourceLookupHashJoinMinLocalDocs.store(0);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceLookupHashJoinMinLocalDocs.store(originalMinLocalDocs); });
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDoc"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    const bool preserveNullAndEmptyArrays = true;
+    const boost::optional<std::string> includeArrayIndex = boost::none;
+    lookup->setUnwindStage(DocumentSourceUnwind::create(
+        expCtx, "foreignDoc", preserveNullAndEmptyArrays, includeArrayIndex));
+
+    const Value zeroAndOne(vector<Value>{Value(0), Value(1)});
+    auto mockLocalSource = DocumentSourceMock::create(
+        {Document{{"foreignId", zeroAndOne}}, Document{{"foreignId", 2}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}},
+                                                             Document{{"_id", 1}}};
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoInterface;
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", zeroAndOne}, {"foreignDoc", Document{{"_id", 0}}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(),
+                       (Document{{"foreignId", zeroAndOne}, {"foreignDoc", Document{{"_id", 1}}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), (Document{{"foreignId", 2}}));
+
+    ASSERT_TRUE(lookup->getNext().isEOF());
+    ASSERT_EQ(mongoInterface->numPipelinesMade(), 1);
+    lookup->dispose();
+}
+
+TEST_F(DocumentSourceLookUpTest, BatchesAreAbandonedIfMatchesExceedMemoryLimit) {
+    auto expCtx = getExpCtx();
+    NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+
+    const auto originalMinLocalDocs = internalDocumentSourceLookupHashJoinMinLocalDocs.load();
+    const auto originalMaxMemory = internalDocumentSourceLookupBatchMaxMemoryBytes.load();
+    internalDocumentSourceLookupHashJoinMinLocalDocs.store(0);
+    internalDocumentSourceLookupBatchMaxMemoryBytes.store(1);
+    ON_BLOCK_EXIT([&] {
+        internalDocumentSourceLookupHashJoinMinLocalDocs.store(originalMinLocalDocs);
+        internalDocumentSourceLookupBatchMaxMemoryBytes.store(originalMaxMemory);
+    });
+
+    auto lookupSpec = Document{{"$lookup",
+                                Document{{"from", fromNs.coll()},
+                                         {"localField", "foreignId"_sd},
+                                         {"foreignField", "_id"_sd},
+                                         {"as", "foreignDocs"_sd}}}}
+                          .toBson();
+    auto parsed = DocumentSourceLookUp::createFromBson(lookupSpec.firstElement(), expCtx);
+    auto lookup = static_cast<DocumentSourceLookUp*>(parsed.get());
+
+    auto mockLocalSource =
+        DocumentSourceMock::create({Document{{"foreignId", 0}}, Document{{"foreignId", 1}}});
+    lookup->setSource(mockLocalSource.get());
+
+    deque<DocumentSource::GetNextResult> mockForeignContents{Document{{"_id", 0}},
+                                                             Document{{"_id", 1}}};
+    auto mongoInterface = std::make_shared<MockMongoInterface>(std::move(mockForeignContents));
+    expCtx->mongoProcessInterface = mongoInterface;
+
+    auto next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 0}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 0}})}}}));
+
+    next = lookup->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(
+        next.releaseDocument(),
+        (Document{{"foreignId", 1}, {"foreignDocs", vector<Value>{Value(Document{{"_id", 1}})}}}));
+    ASSERT_TRUE(lookup->getNext().isEOF());
+
+    // One query for the abandoned batch, then one for each of its local documents.
+    ASSERT_EQ(mongoInterface->numPipelinesMade(), 3);
+
+    vector<Value> explainedStages;
+    lookup->serializeToArray(explainedStages, ExplainOptions::Verbosity::kExecStats);
+    ASSERT_VALUE_EQ(explainedStages[0]["$lookup"]["strategy"], Value("nestedLoop"_sd));
+    lookup->dispose();
+}
+
 BSONObj sequentialCacheStageObj(const StringData status = "kBuilding"_sd,
                                 const long long maxSizeBytes = kDefaultMaxCacheSize) {
     return BSON("$sequentialCache" << BSON("maxSizeBytes" << maxSizeBytes << "status" << status));
@@ -74,6 +74,8 @@ intrusive_ptr<DocumentSource> DocumentSourceMatch::optimize() {
     }
 
     _expression = MatchExpression::optimize(std::move(_expression));
+    _compiledExpression.reset();
+    _attemptedCompilation = false;
 
     return this;
 }
@@ -84,6 +86,11 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
     // The user facing error should have been generated earlier.
     massert(17309, "Should never call getNext on a $match stage with $text clause", !_isTextQuery);
 
+    if (!_attemptedCompilation) {
+        _compiledExpression = CompiledMatchExpression::compile(_expression.get());
+        _attemptedCompilation = true;
+    }
+
     auto nextInput = pSource->getNext();
     for (; nextInput.isAdvanced(); nextInput = pSource->getNext()) {
         // MatchExpression only takes BSON documents, so we have to make one. As an optimization,
@@ -93,7 +100,9 @@ DocumentSource::GetNextResult DocumentSourceMatch::getNext() {
             : document_path_support::documentToBsonWithPaths(nextInput.getDocument(),
                                                              _dependencies.fields);
 
-        if (_expression->matchesBSON(toMatch)) {
+        const bool matches = _compiledExpression ? _compiledExpression->matchesBSON(toMatch)
+                                                 : _expression->matchesBSON(toMatch);
+        if (matches) {
             return nextInput;
         }
 
@@ -377,6 +386,8 @@ void DocumentSourceMatch::joinMatchWith(intrusive_ptr<DocumentSourceMatch> other
     StatusWithMatchExpression status = uassertStatusOK(MatchExpressionParser::parse(
         _predicate, pExpCtx, ExtensionsCallbackNoop(), Pipeline::kAllowedMatcherFeatures));
     _expression = std::move(status.getValue());
+    _compiledExpression.reset();
+    _attemptedCompilation = false;
     _dependencies = DepsTracker(_dependencies.getMetadataAvailable());
     getDependencies(&_dependencies);
 }
@@ -384,6 +395,8 @@ void DocumentSourceMatch::joinMatchWith(intrusive_ptr<DocumentSourceMatch> other
 pair<intrusive_ptr<DocumentSourceMatch>, intrusive_ptr<DocumentSourceMatch>>
 DocumentSourceMatch::splitSourceBy(const std::set<std::string>& fields,
                                    const StringMap<std::string>& renames) {
+    _compiledExpression.reset();
+    _attemptedCompilation = false;
     pair<unique_ptr<MatchExpression>, unique_ptr<MatchExpression>> newExpr(
         expression::splitMatchExpressionBy(std::move(_expression), fields, renames));
 
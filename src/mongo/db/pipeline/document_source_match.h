@@ -32,6 +32,7 @@
 #include <utility>
 
 #include "mongo/client/connpool.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/matcher.h"
 #include "mongo/db/pipeline/document_source.h"
 
@@ -167,6 +168,11 @@ protected:
 private:
     std::unique_ptr<MatchExpression> _expression;
 
+    // '_expression' compiled for matching, built on the first call to getNext(). Reset whenever
+    // '_expression' is replaced.
+    std::unique_ptr<CompiledMatchExpression> _compiledExpression;
+    bool _attemptedCompilation = false;
+
     BSONObj _predicate;
     const bool _isTextQuery;
 
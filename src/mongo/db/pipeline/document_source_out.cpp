@@ -28,11 +28,13 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/curop.h"
 #include "mongo/db/ops/write_ops.h"
 #include "mongo/db/pipeline/document_source_out.h"
 #include "mongo/db/pipeline/document_source_out_gen.h"
 #include "mongo/db/pipeline/document_source_out_in_place.h"
 #include "mongo/db/pipeline/document_source_out_replace_coll.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -169,6 +171,23 @@ BSONObj extractUniqueKeyFromDoc(const Document& doc, const std::set<FieldPath>&
 }
 }  // namespace
 
+void DocumentSourceOut::writeBatch(BatchedObjects&& batch, int batchBytes) {
+    const long long batchSize = batch.size();
+
+    Timer timer;
+    spill(std::move(batch));
+
+    _writeStats.writeTime += Microseconds(timer.micros());
+    _writeStats.nDocsWritten += batchSize;
+    _writeStats.nBatchesWritten++;
+    _writeStats.nBytesWritten += batchBytes;
+
+    // Each batch is written as a separate insert or update operation, and those report only their
+    // own document counts against the aggregate's CurOp. Restate the running total so that the
+    // slow query log and the profiler describe the $out as a whole.
+    CurOp::get(pExpCtx->opCtx)->debug().additiveMetrics.ninserted = _writeStats.nDocsWritten;
+}
+
 DocumentSource::GetNextResult DocumentSourceOut::getNext() {
     pExpCtx->checkForInterrupt();
 
@@ -202,14 +221,14 @@ DocumentSource::GetNextResult DocumentSourceOut::getNext() {
         bufferedBytes += insertObj.objsize();
         if (!batch.empty() &&
             (bufferedBytes > BSONObjMaxUserSize || batch.size() >= write_ops::kMaxWriteBatchSize)) {
-            spill(std::move(batch));
+            writeBatch(std::move(batch), bufferedBytes - insertObj.objsize());
             batch.clear();
             bufferedBytes = insertObj.objsize();
         }
         batch.emplace(std::move(insertObj), std::move(uniqueKey));
     }
     if (!batch.empty()) {
-        spill(std::move(batch));
+        writeBatch(std::move(batch), bufferedBytes);
         batch.clear();
     }
 
@@ -357,6 +376,14 @@ Value DocumentSourceOut::serialize(boost::optional<ExplainOptions::Verbosity> ex
         uniqueKeyBob.append(path.fullPath(), 1);
     }
     serialized[DocumentSourceOutSpec::kUniqueKeyFieldName] = Value(uniqueKeyBob.done());
+
+    if (explain && *explain >= ExplainOptions::Verbosity::kExecStats) {
+        const auto writeTimeMillis = durationCount<Milliseconds>(_writeStats.writeTime);
+        serialized["writeStats"] = Value(Document{{"nDocsWritten", _writeStats.nDocsWritten},
+                                                  {"nBatchesWritten", _writeStats.nBatchesWritten},
+                                                  {"nBytesWritten", _writeStats.nBytesWritten},
+                                                  {"writeTimeMillis", writeTimeMillis}});
+    }
     return Value(Document{{getSourceName(), serialized.freeze()}});
 }
 
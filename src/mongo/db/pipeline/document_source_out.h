@@ -171,6 +171,20 @@ public:
      */
     virtual void finalize() = 0;
 
+    /**
+     * Statistics about the writes performed by this stage so far.
+     */
+    struct WriteStats {
+        long long nDocsWritten = 0;
+        long long nBatchesWritten = 0;
+        long long nBytesWritten = 0;
+        Microseconds writeTime{0};
+    };
+
+    const WriteStats& getWriteStats() const {
+        return _writeStats;
+    }
+
     /**
      * Creates a new $out stage from the given arguments.
      */
@@ -187,6 +201,11 @@ public:
         BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
 
 private:
+    /**
+     * Writes 'batch' with spill(), recording its size and the time spent in 'writeStats'.
+     */
+    void writeBatch(BatchedObjects&& batch, int batchBytes);
+
     bool _initialized = false;
     bool _done = false;
 
@@ -201,6 +220,8 @@ private:
     // True if '_uniqueKeyFields' contains the _id. We store this as a separate boolean to avoid
     // repeated lookups into the set.
     bool _uniqueKeyIncludesId;
+
+    WriteStats _writeStats;
 };
 
 }  // namespace mongo
@@ -93,6 +93,21 @@ void DocumentSourceOutReplaceColl::initializeWriteNs() {
     }
 };
 
+void DocumentSourceOutReplaceColl::spill(BatchedObjects&& batch) {
+    // The temp collection starts out empty and is written only by this stage, so inserting each
+    // batch in _id order turns the _id index maintenance into mostly appends to the same few
+    // leaves instead of a random insertion per document. The unique keys are not needed by the
+    // insert, so they are left behind rather than permuted along with the objects.
+    std::stable_sort(batch.objects.begin(),
+                     batch.objects.end(),
+                     [](const BSONObj& lhs, const BSONObj& rhs) {
+                         return lhs["_id"].woCompare(rhs["_id"], false) < 0;
+                     });
+    batch.uniqueKeys.clear();
+
+    DocumentSourceOut::spill(std::move(batch));
+}
+
 void DocumentSourceOutReplaceColl::finalize() {
     const auto& outputNs = getOutputNs();
     auto renameCommandObj =
@@ -63,6 +63,11 @@ public:
      */
     void finalize() final;
 
+    /**
+     * Inserts the documents in 'batch' into the temp collection in _id order.
+     */
+    void spill(BatchedObjects&& batch) final;
+
     const NamespaceString& getWriteNs() const final {
         return _tempNs;
     };
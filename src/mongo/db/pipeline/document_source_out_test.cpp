@@ -31,7 +31,9 @@
 #include <boost/intrusive_ptr.hpp>
 
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_out.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
 
@@ -64,6 +66,16 @@ public:
         OperationContext* opCtx, NamespaceStringOrUUID nssOrUUID) const override {
         return {{"_id"}, false};
     }
+
+    void insert(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                const NamespaceString& ns,
+                std::vector<BSONObj>&& objs) override {
+        for (auto&& obj : objs) {
+            inserted.push_back(std::move(obj));
+        }
+    }
+
+    std::vector<BSONObj> inserted;
 };
 
 class DocumentSourceOutTest : public AggregationContextFixture {
@@ -357,5 +369,40 @@ TEST_F(DocumentSourceOutTest, CorrectlyUsesForeignTargetDb) {
 
     ASSERT_THROWS_CODE(createOutStage(spec), AssertionException, 50939);
 }
+
+TEST_F(DocumentSourceOutTest, TracksWriteStatsAcrossBatches) {
+    auto processInterface = std::make_shared<MongoProcessInterfaceForTest>();
+    getExpCtx()->mongoProcessInterface = processInterface;
+
+    BSONObj spec = BSON("$out" << BSON("to"
+                                       << "target"
+                                       << "mode"
+                                       << kInsertDocumentsMode));
+    auto outStage = createOutStage(spec);
+    auto mock = DocumentSourceMock::create({Document{{"_id", 0}},
+                                            DocumentSource::GetNextResult::makePauseExecution(),
+                                            Document{{"_id", 1}},
+                                            Document{{"_id", 2}}});
+    outStage->setSource(mock.get());
+
+    // Each pause flushes the documents buffered so far as a batch.
+    ASSERT_TRUE(outStage->getNext().isPaused());
+    ASSERT_EQ(outStage->getWriteStats().nDocsWritten, 1);
+    ASSERT_EQ(outStage->getWriteStats().nBatchesWritten, 1);
+
+    ASSERT_TRUE(outStage->getNext().isEOF());
+    const auto& stats = outStage->getWriteStats();
+    ASSERT_EQ(stats.nDocsWritten, 3);
+    ASSERT_EQ(stats.nBatchesWritten, 2);
+    ASSERT_EQ(stats.nBytesWritten, 3 * BSON("_id" << 0).objsize());
+    ASSERT_EQ(processInterface->inserted.size(), 3UL);
+
+    // The aggregate's CurOp reports the documents written over all batches.
+    ASSERT_EQ(*CurOp::get(getExpCtx()->opCtx)->debug().additiveMetrics.ninserted, 3);
+
+    auto explained = outStage->serialize(ExplainOptions::Verbosity::kExecStats).getDocument();
+    ASSERT_EQ(explained["$out"]["writeStats"]["nDocsWritten"].getLong(), 3);
+    ASSERT_TRUE(outStage->serialize().getDocument()["$out"]["writeStats"].missing());
+}
 }  // namespace
 }  // namespace mongo
@@ -33,6 +33,7 @@
 namespace mongo {
 
 const char* DocumentSourcePlanCacheStats::kStageName = "$planCacheStats";
+constexpr StringData DocumentSourcePlanCacheStats::kPartitionStatsFieldName;
 
 REGISTER_DOCUMENT_SOURCE(planCacheStats,
                          DocumentSourcePlanCacheStats::LiteParsed::parse,
@@ -45,31 +46,45 @@ boost::intrusive_ptr<DocumentSource> DocumentSourcePlanCacheStats::createFromBso
         str::stream() << kStageName << " value must be an object. Found: " << typeName(spec.type()),
         spec.type() == BSONType::Object);
 
-    uassert(ErrorCodes::FailedToParse,
-            str::stream() << kStageName << " parameters object must be empty. Found: "
-                          << typeName(spec.type()),
-            spec.embeddedObject().isEmpty());
+    bool partitionStats = false;
+    for (auto&& option : spec.embeddedObject()) {
+        uassert(ErrorCodes::FailedToParse,
+                str::stream() << kStageName << " parameters object may only contain '"
+                              << kPartitionStatsFieldName
+                              << "'. Found: "
+                              << option.fieldNameStringData(),
+                option.fieldNameStringData() == kPartitionStatsFieldName);
+        uassert(ErrorCodes::FailedToParse,
+                str::stream() << kStageName << " '" << kPartitionStatsFieldName
+                              << "' option must be a boolean. Found: "
+                              << typeName(option.type()),
+                option.type() == BSONType::Bool);
+        partitionStats = option.Bool();
+    }
 
     uassert(50932,
             str::stream() << kStageName << " cannot be executed against a MongoS.",
             !pExpCtx->inMongos && !pExpCtx->fromMongos && !pExpCtx->needsMerge);
 
-    return new DocumentSourcePlanCacheStats(pExpCtx);
+    return new DocumentSourcePlanCacheStats(pExpCtx, partitionStats);
 }
 
 DocumentSourcePlanCacheStats::DocumentSourcePlanCacheStats(
-    const boost::intrusive_ptr<ExpressionContext>& expCtx)
-    : DocumentSource(expCtx) {}
+    const boost::intrusive_ptr<ExpressionContext>& expCtx, bool partitionStats)
+    : DocumentSource(expCtx), _partitionStats(partitionStats) {}
 
 void DocumentSourcePlanCacheStats::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    MutableDocument spec;
+    if (_partitionStats) {
+        spec[kPartitionStatsFieldName] = Value(true);
+    }
+
     if (explain) {
-        array.push_back(Value{
-            Document{{kStageName,
-                      Document{{"match"_sd,
-                                _absorbedMatch ? Value{_absorbedMatch->getQuery()} : Value{}}}}}});
+        spec["match"_sd] = _absorbedMatch ? Value{_absorbedMatch->getQuery()} : Value{};
+        array.push_back(Value{Document{{kStageName, spec.freeze()}}});
     } else {
-        array.push_back(Value{Document{{kStageName, Document{}}}});
+        array.push_back(Value{Document{{kStageName, spec.freeze()}}});
         if (_absorbedMatch) {
             _absorbedMatch->serializeToArray(array);
         }
@@ -95,8 +110,13 @@ Pipeline::SourceContainer::iterator DocumentSourcePlanCacheStats::doOptimizeAt(
 DocumentSource::GetNextResult DocumentSourcePlanCacheStats::getNext() {
     if (!_haveRetrievedStats) {
         const auto matchExpr = _absorbedMatch ? _absorbedMatch->getMatchExpression() : nullptr;
-        _results = pExpCtx->mongoProcessInterface->getMatchingPlanCacheEntryStats(
-            pExpCtx->opCtx, pExpCtx->ns, matchExpr);
+        if (_partitionStats) {
+            _results = pExpCtx->mongoProcessInterface->getMatchingPlanCachePartitionStats(
+                pExpCtx->opCtx, pExpCtx->ns, matchExpr);
+        } else {
+            _results = pExpCtx->mongoProcessInterface->getMatchingPlanCacheEntryStats(
+                pExpCtx->opCtx, pExpCtx->ns, matchExpr);
+        }
 
         _resultsIter = _results.begin();
         _haveRetrievedStats = true;
@@ -37,6 +37,10 @@ class DocumentSourcePlanCacheStats final : public DocumentSource {
 public:
     static const char* kStageName;
 
+    // When this option is true, the stage returns one document describing each partition of the
+    // plan cache instead of one document per cache entry.
+    static constexpr StringData kPartitionStatsFieldName = "partitionStats"_sd;
+
     class LiteParsed final : public LiteParsedDocumentSource {
     public:
         static std::unique_ptr<LiteParsed> parse(const AggregationRequest& request,
@@ -119,7 +123,8 @@ public:
         boost::optional<ExplainOptions::Verbosity> explain = boost::none) const override;
 
 private:
-    DocumentSourcePlanCacheStats(const boost::intrusive_ptr<ExpressionContext>& expCtx);
+    DocumentSourcePlanCacheStats(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                 bool partitionStats);
 
     Value serialize(
         boost::optional<ExplainOptions::Verbosity> explain = boost::none) const override {
@@ -130,6 +135,9 @@ private:
     // call to getNext(), and then held by this data member.
     std::vector<BSONObj> _results;
 
+    // Whether to report the partitions of the plan cache rather than its entries.
+    const bool _partitionStats;
+
     // Whether '_results' has been populated yet.
     bool _haveRetrievedStats = false;
 
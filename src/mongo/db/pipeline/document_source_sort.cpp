@@ -40,6 +40,7 @@
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/stdx/memory.h"
 
 namespace mongo {
 
@@ -126,10 +127,15 @@ DocumentSource::GetNextResult DocumentSourceSort::getNext() {
 void DocumentSourceSort::serializeToArray(
     std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
     if (explain) {  // always one Value for combined $sort + $limit
-        array.push_back(
-            Value(DOC(kStageName << DOC(
-                          "sortKey" << sortKeyPattern(SortKeySerialization::kForExplain) << "limit"
-                                    << (_limitSrc ? Value(_limitSrc->getLimit()) : Value())))));
+        MutableDocument inner(
+            DOC("sortKey" << sortKeyPattern(SortKeySerialization::kForExplain) << "limit"
+                          << (_limitSrc ? Value(_limitSrc->getLimit()) : Value())));
+        if (*explain >= ExplainOptions::Verbosity::kExecStats) {
+            inner["usedDisk"] = Value(_usedDisk);
+            inner["bytesSpilled"] = Value(static_cast<long long>(_bytesSpilled));
+            inner["numRunsDiscarded"] = Value(static_cast<long long>(_numRunsDiscarded));
+        }
+        array.push_back(Value(DOC(kStageName << inner.freeze())));
     } else {  // one Value for $sort and maybe a Value for $limit
         MutableDocument inner(sortKeyPattern(SortKeySerialization::kForPipelineSerialization));
         array.push_back(Value(DOC(kStageName << inner.freeze())));
@@ -291,6 +297,11 @@ intrusive_ptr<DocumentSourceSort> DocumentSourceSort::create(
         pSort->sortKeyPattern(SortKeySerialization::kForPipelineSerialization).toBson(),
         pExpCtx->getCollator()};
 
+    if (pExpCtx->getCollator()) {
+        pSort->_cachingCollator =
+            stdx::make_unique<CollatorInterfaceCaching>(pExpCtx->getCollator());
+    }
+
     if (limit > 0) {
         pSort->setLimitSrc(DocumentSourceLimit::create(pExpCtx, limit));
     }
@@ -307,9 +318,11 @@ SortOptions DocumentSourceSort::makeSortOptions() const {
         opts.limit = _limitSrc->getLimit();
 
     opts.maxMemoryUsageBytes = _maxMemoryUsageBytes;
-    if (pExpCtx->allowDiskUse && !pExpCtx->inMongos) {
+    opts.parallelism = internalDocumentSourceSortParallelism.load();
+    if (pExpCtx->canSpillToDisk()) {
         opts.extSortAllowed = true;
         opts.tempDir = pExpCtx->tempDir;
+        opts.readAheadBytes = internalDocumentSourceSortReadAheadBytes.load();
     }
 
     return opts;
@@ -347,6 +360,8 @@ void DocumentSourceSort::loadingDone() {
     }
     _output.reset(_sorter->done());
     _usedDisk = _sorter->usedDisk() || _usedDisk;
+    _bytesSpilled += _sorter->bytesSpilled();
+    _numRunsDiscarded += _sorter->numRunsDiscarded();
     _sorter.reset();
     _populated = true;
 }
@@ -356,13 +371,17 @@ bool DocumentSourceSort::usedDisk() {
 }
 
 Value DocumentSourceSort::getCollationComparisonKey(const Value& val) const {
-    const auto collator = pExpCtx->getCollator();
+    const CollatorInterface* collator = pExpCtx->getCollator();
 
     // If the collation is the simple collation, the value itself is the comparison key.
     if (!collator) {
         return val;
     }
 
+    if (_cachingCollator && _cachingCollator->getUnderlying() == collator) {
+        collator = _cachingCollator.get();
+    }
+
     // If 'val' is not a collatable type, there's no need to do any work.
     if (!CollationIndexKey::isCollatableType(val.getType())) {
         return val;
@@ -32,6 +32,7 @@
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/document_source_limit.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/query/collation/collator_interface_caching.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/sorter/sorter.h"
 
@@ -250,6 +251,10 @@ private:
 
     boost::optional<SortKeyGenerator> _sortKeyGen;
 
+    // Caches the comparison keys of the strings sorted on with the collation of the
+    // ExpressionContext at creation time. Null when that collation is the simple collation.
+    std::unique_ptr<CollatorInterfaceCaching> _cachingCollator;
+
     SortPattern _sortPattern;
 
     // The set of paths on which we're sorting.
@@ -262,6 +267,10 @@ private:
     std::unique_ptr<MySorter> _sorter;
     std::unique_ptr<MySorter::Iterator> _output;
     bool _usedDisk = false;
+
+    // Statistics of the sorter gathered once it is done, reported by explain.
+    unsigned long long _bytesSpilled = 0;
+    size_t _numRunsDiscarded = 0;
 };
 
 }  // namespace mongo
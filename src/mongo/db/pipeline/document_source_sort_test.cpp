@@ -434,6 +434,83 @@ TEST_F(DocumentSourceSortExecutionTest, ShouldBeAbleToPauseLoadingWhileSpilled)
     ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(0));
 }
 
+TEST_F(DocumentSourceSortExecutionTest, ShouldSpillInMongoSOnlyWithTempDir) {
+    auto expCtx = getExpCtx();
+    expCtx->inMongos = true;
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+
+    string largeStr(maxMemoryUsageBytes, 'x');
+    auto makeInput = [&] {
+        return DocumentSourceMock::create({Document{{"_id", 0}, {"largeStr", largeStr}},
+                                           Document{{"_id", 1}, {"largeStr", largeStr}}});
+    };
+
+    // Without a temporary directory, mongoS has nowhere to spill to.
+    auto sort = DocumentSourceSort::create(expCtx, BSON("_id" << -1), -1, maxMemoryUsageBytes);
+    auto mock = makeInput();
+    sort->setSource(mock.get());
+    ASSERT_THROWS_CODE(sort->getNext(), AssertionException, 16819);
+
+    unittest::TempDir tempDir("DocumentSourceSortTest");
+    expCtx->tempDir = tempDir.path();
+
+    sort = DocumentSourceSort::create(expCtx, BSON("_id" << -1), -1, maxMemoryUsageBytes);
+    mock = makeInput();
+    sort->setSource(mock.get());
+
+    auto next = sort->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(1));
+    next = sort->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(0));
+    ASSERT_TRUE(sort->getNext().isEOF());
+    ASSERT_TRUE(sort->usedDisk());
+}
+
+TEST_F(DocumentSourceSortExecutionTest, TopKSortShouldDiscardSpilledRunsBeyondTheCutoff) {
+    auto expCtx = getExpCtx();
+    unittest::TempDir tempDir("DocumentSourceSortTest");
+    expCtx->tempDir = tempDir.path();
+    expCtx->allowDiskUse = true;
+    const size_t maxMemoryUsageBytes = 1000;
+    const long long limit = 20;
+
+    auto sort = DocumentSourceSort::create(expCtx, BSON("_id" << 1), limit, maxMemoryUsageBytes);
+
+    // Feed the input in the opposite order, so that the best documents arrive last and the runs
+    // spilled early on fall behind the cutoff.
+    std::deque<DocumentSource::GetNextResult> inputs;
+    string str(50, 'x');
+    for (int i = 199; i >= 0; --i) {
+        inputs.emplace_back(Document{{"_id", i}, {"str", str}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    sort->setSource(mock.get());
+
+    for (int i = 0; i < limit; ++i) {
+        auto next = sort->getNext();
+        ASSERT_TRUE(next.isAdvanced());
+        ASSERT_VALUE_EQ(next.releaseDocument()["_id"], Value(i));
+    }
+    ASSERT_TRUE(sort->getNext().isEOF());
+    ASSERT_TRUE(sort->usedDisk());
+
+    vector<Value> explained;
+    sort->serializeToArray(explained, ExplainOptions::Verbosity::kExecStats);
+    ASSERT_EQ(explained.size(), 1UL);
+    auto stats = explained[0].getDocument()["$sort"].getDocument();
+    ASSERT_VALUE_EQ(stats["usedDisk"], Value(true));
+    ASSERT_GT(stats["bytesSpilled"].getLong(), 0LL);
+    ASSERT_GT(stats["numRunsDiscarded"].getLong(), 0LL);
+
+    // Execution statistics are only reported alongside execution.
+    explained.clear();
+    sort->serializeToArray(explained, ExplainOptions::Verbosity::kQueryPlanner);
+    ASSERT_TRUE(explained[0].getDocument()["$sort"]["usedDisk"].missing());
+}
+
 TEST_F(DocumentSourceSortExecutionTest,
        ShouldErrorIfNotAllowedToSpillToDiskAndResultSetIsTooLarge) {
     auto expCtx = getExpCtx();
@@ -31,7 +31,10 @@
 #include "mongo/db/pipeline/document_source_unwind.h"
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_path_support.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/lite_parsed_document_source.h"
 #include "mongo/db/pipeline/value.h"
@@ -59,7 +62,24 @@ public:
      */
     DocumentSource::GetNextResult getNext();
 
+    /**
+     * Only returns documents which match 'filter'. Every path 'filter' depends on, listed in
+     * 'filterPaths', must be the unwound path or within it. Does not take ownership of 'filter'.
+     */
+    void setFilter(const MatchExpression* filter, std::set<std::string> filterPaths);
+
 private:
+    /**
+     * Returns whether the document which would result from setting the unwound path to 'element'
+     * matches '_filter'. Only builds the unwound path, since '_filter' depends on nothing else.
+     */
+    bool elementMatchesFilter(const Value& element) const;
+
+    /**
+     * Returns whether 'doc' matches '_filter'.
+     */
+    bool documentMatchesFilter(const Document& doc) const;
+
     // Tracks whether or not we can possibly return any more documents. Note we may return
     // boost::none even if this is true.
     bool _haveNext = false;
@@ -84,6 +104,11 @@ private:
 
     // Index into the _inputArray to return next.
     size_t _index;
+
+    // If set, the documents which do not match this filter are not returned.
+    const MatchExpression* _filter = nullptr;
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+    std::set<std::string> _filterPaths;
 };
 
 DocumentSourceUnwind::Unwinder::Unwinder(const FieldPath& unwindPath,
@@ -93,6 +118,43 @@ DocumentSourceUnwind::Unwinder::Unwinder(const FieldPath& unwindPath,
       _preserveNullAndEmptyArrays(preserveNullAndEmptyArrays),
       _indexPath(indexPath) {}
 
+void DocumentSourceUnwind::Unwinder::setFilter(const MatchExpression* filter,
+                                               std::set<std::string> filterPaths) {
+    _filter = filter;
+    _compiledFilter = CompiledMatchExpression::compile(_filter);
+    _filterPaths = std::move(filterPaths);
+}
+
+namespace {
+/**
+ * Appends 'value' to 'builder' at the components of 'path' starting with 'pathIndex', nesting an
+ * object for each component but the last.
+ */
+void appendAtPath(BSONObjBuilder* builder,
+                  const FieldPath& path,
+                  size_t pathIndex,
+                  const Value& value) {
+    if (pathIndex + 1 == path.getPathLength()) {
+        value.addToBsonObj(builder, path.getFieldName(pathIndex));
+        return;
+    }
+    BSONObjBuilder subBuilder(builder->subobjStart(path.getFieldName(pathIndex)));
+    appendAtPath(&subBuilder, path, pathIndex + 1, value);
+}
+}  // namespace
+
+bool DocumentSourceUnwind::Unwinder::elementMatchesFilter(const Value& element) const {
+    BSONObjBuilder builder;
+    appendAtPath(&builder, _unwindPath, 0, element);
+    BSONObj toMatch = builder.obj();
+    return _compiledFilter ? _compiledFilter->matchesBSON(toMatch) : _filter->matchesBSON(toMatch);
+}
+
+bool DocumentSourceUnwind::Unwinder::documentMatchesFilter(const Document& doc) const {
+    BSONObj toMatch = document_path_support::documentToBsonWithPaths(doc, _filterPaths);
+    return _compiledFilter ? _compiledFilter->matchesBSON(toMatch) : _filter->matchesBSON(toMatch);
+}
+
 void DocumentSourceUnwind::Unwinder::resetDocument(const Document& document) {
     // Reset document specific attributes.
     _output.reset(document);
@@ -125,6 +187,19 @@ DocumentSource::GetNextResult DocumentSourceUnwind::Unwinder::getNext() {
             }
             _output.removeNestedField(_unwindPathFieldIndexes);
         } else {
+            if (_filter) {
+                // Skip the elements the filter rejects without building documents for them. The
+                // path to the array only goes through objects, so an element matches exactly when
+                // the output document for it would.
+                while (_index < length && !elementMatchesFilter(_inputArray[_index])) {
+                    ++_index;
+                }
+                if (_index == length) {
+                    _haveNext = false;
+                    return GetNextResult::makeEOF();
+                }
+            }
+
             // Set field to be the next element in the array. If needed, this will automatically
             // clone all the documents along the field path so that the end values are not shared
             // across documents that have come out of this pipeline operator. This is a partial deep
@@ -152,6 +227,12 @@ DocumentSource::GetNextResult DocumentSourceUnwind::Unwinder::getNext() {
             indexForOutput ? Value(*indexForOutput) : Value(BSONNULL);
     }
 
+    // A document which did not come from an array element keeps whatever was on the path to the
+    // unwound field, so the filter has to see the document itself.
+    if (_filter && !indexForOutput && !documentMatchesFilter(_output.peek())) {
+        return GetNextResult::makeEOF();
+    }
+
     return _haveNext ? _output.peek() : _output.freeze();
 }
 
@@ -247,6 +328,46 @@ Value DocumentSourceUnwind::serialize(boost::optional<ExplainOptions::Verbosity>
                                 << (_indexPath ? Value((*_indexPath).fullPath()) : Value()))));
 }
 
+void DocumentSourceUnwind::serializeToArray(
+    std::vector<Value>& array, boost::optional<ExplainOptions::Verbosity> explain) const {
+    array.push_back(serialize(explain));
+    if (_absorbedMatch) {
+        _absorbedMatch->serializeToArray(array, explain);
+    }
+}
+
+Pipeline::SourceContainer::iterator DocumentSourceUnwind::doOptimizeAt(
+    Pipeline::SourceContainer::iterator itr, Pipeline::SourceContainer* container) {
+    invariant(*itr == this);
+
+    auto nextMatch = dynamic_cast<DocumentSourceMatch*>((*std::next(itr)).get());
+
+    // The generic $match swapping has already moved any part of 'nextMatch' which does not depend
+    // on the paths we modify before ourselves. We cannot absorb a $match on the 'includeArrayIndex'
+    // path, and only attempt to absorb one when we have no index path at all.
+    if (!nextMatch || nextMatch->isTextQuery() || _absorbedMatch || _indexPath) {
+        return std::next(itr);
+    }
+
+    DepsTracker deps(DepsTracker::kAllMetadataAvailable);
+    nextMatch->getDependencies(&deps);
+    if (deps.needWholeDocument) {
+        return std::next(itr);
+    }
+
+    const auto unwindPath = _unwindPath.fullPath();
+    for (auto&& field : deps.fields) {
+        if (field != unwindPath && !expression::isPathPrefixOf(unwindPath, field)) {
+            return std::next(itr);
+        }
+    }
+
+    _absorbedMatch = nextMatch;
+    _unwinder->setFilter(_absorbedMatch->getMatchExpression(), std::move(deps.fields));
+    container->erase(std::next(itr));
+    return itr;
+}
+
 DepsTracker::State DocumentSourceUnwind::getDependencies(DepsTracker* deps) const {
     deps->fields.insert(_unwindPath.fullPath());
     return DepsTracker::State::SEE_NEXT;
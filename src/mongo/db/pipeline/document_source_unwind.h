@@ -29,6 +29,7 @@
 #pragma once
 
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/field_path.h"
 
 namespace mongo {
@@ -39,6 +40,9 @@ public:
     GetNextResult getNext() final;
     const char* getSourceName() const final;
     Value serialize(boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
+    void serializeToArray(
+        std::vector<Value>& array,
+        boost::optional<ExplainOptions::Verbosity> explain = boost::none) const final;
     BSONObjSet getOutputSorts() final;
 
     /**
@@ -84,6 +88,23 @@ public:
         return _indexPath;
     }
 
+    /**
+     * Returns whether this stage has absorbed the $match which followed it. Stages which take over
+     * the unwinding of an $unwind must not absorb one which has.
+     */
+    bool hasAbsorbedMatch() const {
+        return static_cast<bool>(_absorbedMatch);
+    }
+
+protected:
+    /**
+     * Attempts to absorb an immediately following $match which only depends on the unwound path,
+     * so that array elements the $match would reject are skipped before a document is built for
+     * them.
+     */
+    Pipeline::SourceContainer::iterator doOptimizeAt(Pipeline::SourceContainer::iterator itr,
+                                                     Pipeline::SourceContainer* container) final;
+
 private:
     DocumentSourceUnwind(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
                          const FieldPath& fieldPath,
@@ -99,6 +120,10 @@ private:
     // existing value, setting to null when the value was a non-array or empty array.
     const boost::optional<FieldPath> _indexPath;
 
+    // A $match which followed this stage and only depends on '_unwindPath'. Documents which it
+    // rejects are not returned.
+    boost::intrusive_ptr<DocumentSourceMatch> _absorbedMatch;
+
     // Iteration state.
     class Unwinder;
     std::unique_ptr<Unwinder> _unwinder;
@@ -39,6 +39,7 @@
 #include "mongo/bson/json.h"
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/dependencies.h"
+#include "mongo/db/pipeline/document_source_match.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_source_unwind.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
@@ -744,6 +745,77 @@ TEST_F(UnwindStageTest, UnwindIncludesIndexPathWhenIncludingIndex) {
     ASSERT_EQUALS(1U, modifiedPaths.paths.count("arrIndex"));
 }
 
+TEST_F(UnwindStageTest, AbsorbsFollowingMatchOnUnwoundPath) {
+    auto unwind = DocumentSourceUnwind::create(getExpCtx(), "a", false, boost::none);
+    auto match = DocumentSourceMatch::create(fromjson("{'a.b': {$gt: 1}}"), getExpCtx());
+    Pipeline::SourceContainer container{unwind, match};
+    unwind->optimizeAt(container.begin(), &container);
+    ASSERT_EQUALS(1U, container.size());
+    ASSERT_TRUE(unwind->hasAbsorbedMatch());
+
+    // The absorbed $match is serialized as a separate stage again.
+    vector<Value> serialized;
+    unwind->serializeToArray(serialized);
+    ASSERT_EQUALS(2U, serialized.size());
+    ASSERT_VALUE_EQ(serialized[1], Value(fromjson("{$match: {'a.b': {$gt: 1}}}")));
+
+    auto source = DocumentSourceMock::create({"{_id: 0, a: [{b: 1}, {b: 2}, {b: 0}, {b: 3}]}",
+                                              "{_id: 1, a: [{b: 0}]}",
+                                              "{_id: 2, a: {b: 5}}",
+                                              "{_id: 3, a: {b: 1}}",
+                                              "{_id: 4, a: []}"});
+    unwind->setSource(source.get());
+
+    auto next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{_id: 0, a: {b: 2}}")));
+    next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{_id: 0, a: {b: 3}}")));
+    next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{_id: 2, a: {b: 5}}")));
+    ASSERT_TRUE(unwind->getNext().isEOF());
+}
+
+TEST_F(UnwindStageTest, AbsorbedMatchSeesWholeDocumentForPreservedDocuments) {
+    auto unwind = DocumentSourceUnwind::create(getExpCtx(), "a.b", true, boost::none);
+    auto match = DocumentSourceMatch::create(fromjson("{'a.b': 1}"), getExpCtx());
+    Pipeline::SourceContainer container{unwind, match};
+    unwind->optimizeAt(container.begin(), &container);
+    ASSERT_EQUALS(1U, container.size());
+
+    // The value at 'a.b' is missing in both documents, since 'a' is an array, but only the first
+    // one matches the $match.
+    auto source =
+        DocumentSourceMock::create({"{_id: 0, a: [{b: 2}, {b: 1}]}", "{_id: 1, a: [{b: 2}]}"});
+    unwind->setSource(source.get());
+
+    auto next = unwind->getNext();
+    ASSERT_TRUE(next.isAdvanced());
+    ASSERT_DOCUMENT_EQ(next.releaseDocument(), Document(fromjson("{_id: 0, a: [{b: 2}, {b: 1}]}")));
+    ASSERT_TRUE(unwind->getNext().isEOF());
+}
+
+TEST_F(UnwindStageTest, DoesNotAbsorbMatchOnOtherPaths) {
+    auto unwind = DocumentSourceUnwind::create(getExpCtx(), "a.b", false, boost::none);
+    auto match = DocumentSourceMatch::create(fromjson("{a: {$size: 1}}"), getExpCtx());
+    Pipeline::SourceContainer container{unwind, match};
+    unwind->optimizeAt(container.begin(), &container);
+    ASSERT_EQUALS(2U, container.size());
+    ASSERT_FALSE(unwind->hasAbsorbedMatch());
+}
+
+TEST_F(UnwindStageTest, DoesNotAbsorbMatchWhenIncludingArrayIndex) {
+    auto unwind =
+        DocumentSourceUnwind::create(getExpCtx(), "a", false, boost::optional<string>("index"));
+    auto match = DocumentSourceMatch::create(fromjson("{a: 1}"), getExpCtx());
+    Pipeline::SourceContainer container{unwind, match};
+    unwind->optimizeAt(container.begin(), &container);
+    ASSERT_EQUALS(2U, container.size());
+    ASSERT_FALSE(unwind->hasAbsorbedMatch());
+}
+
 //
 // Error cases.
 //
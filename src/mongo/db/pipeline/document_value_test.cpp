@@ -111,6 +111,34 @@ TEST(DocumentConstruction, FromEmptyDocumentClone) {
     ASSERT_DOCUMENT_EQ(document, documentClone);
 }
 
+TEST(DocumentConstruction, DocumentsSurviveReleaseOfCachedMemory) {
+    // Build and destroy documents of many sizes, so that freed storage is cached and reused.
+    std::vector<Document> retained;
+    for (int round = 0; round < 3; ++round) {
+        for (int numFields = 1; numFields < 200; numFields += 7) {
+            MutableDocument md;
+            for (int i = 0; i < numFields; ++i) {
+                md.addField(str::stream() << "field" << i, mongo::Value(i));
+            }
+            Document document = md.freeze();
+            if (numFields % 3 == 0) {
+                retained.push_back(document);
+            }
+        }
+        Document::releaseCachedMemory();
+    }
+
+    for (auto&& document : retained) {
+        const size_t numFields = document.size();
+        for (size_t i = 0; i < numFields; ++i) {
+            ASSERT_EQUALS(static_cast<int>(i), getNthField(document, i).second.getInt());
+        }
+    }
+
+    Document clone = retained.front().clone();
+    ASSERT_DOCUMENT_EQ(clone, retained.front());
+}
+
 /**
  * Appends to 'builder' an object nested 'depth' levels deep.
  */
@@ -248,6 +248,9 @@ protected:
     virtual void _doAddDependencies(DepsTracker* deps) const = 0;
 
 private:
+    // Evaluates compiled comparisons with the ValueComparator of the comparison's context.
+    friend class CompiledExpression;
+
     boost::optional<Variables::Id> _boundaryVariableId;
     boost::intrusive_ptr<ExpressionContext> _expCtx;
 };
@@ -391,9 +394,7 @@ public:
         if (n == 1) {
             Value singleVal = this->vpOperand[0]->evaluate(root);
             if (singleVal.getType() == Array) {
-                for (const Value& val : singleVal.getArray()) {
-                    accum.process(val, false);
-                }
+                accum.processBatch(singleVal.getArray());
             } else {
                 accum.process(singleVal, false);
             }
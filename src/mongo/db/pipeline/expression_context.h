@@ -139,6 +139,14 @@ public:
         return !ns.isCollectionlessAggregateNS();
     }
 
+    /**
+     * Returns true if stages which exceed their memory limits may spill to files under 'tempDir'.
+     * On mongoS this also requires that a temporary directory has been configured.
+     */
+    bool canSpillToDisk() const {
+        return allowDiskUse && (!inMongos || !tempDir.empty());
+    }
+
     const CollatorInterface* getCollator() const {
         return _collator;
     }
@@ -213,7 +221,9 @@ public:
     // If known, the UUID of the execution namespace for this aggregation command.
     boost::optional<UUID> uuid;
 
-    std::string tempDir;  // Defaults to empty to prevent external sorting in mongos.
+    // Defaults to empty to prevent external sorting in mongos, unless mongos has been configured
+    // with 'internalQueryMongosTempDir'.
+    std::string tempDir;
 
     OperationContext* opCtx;
 
@@ -0,0 +1,294 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_table.h"
+
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <typeinfo>
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Stores an accumulator of type 'AccumulatorType' directly in a row.
+ */
+template <typename AccumulatorType>
+struct InlineStorage {
+    static_assert(alignof(AccumulatorType) <= alignof(std::max_align_t),
+                  "accumulators stored in a row may not be over-aligned");
+
+    static void construct(char* slot,
+                          const AccumulationStatement& statement,
+                          const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+        new (slot) AccumulatorType(expCtx);
+    }
+
+    static Accumulator* get(char* slot) {
+        return reinterpret_cast<AccumulatorType*>(slot);
+    }
+
+    static void destroy(char* slot) {
+        reinterpret_cast<AccumulatorType*>(slot)->~AccumulatorType();
+    }
+};
+
+/**
+ * Stores a reference to a separately allocated accumulator in a row.
+ */
+struct OutOfLineStorage {
+    using Pointer = boost::intrusive_ptr<Accumulator>;
+
+    static void construct(char* slot,
+                          const AccumulationStatement& statement,
+                          const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+        new (slot) Pointer(statement.makeAccumulator(expCtx));
+    }
+
+    static Accumulator* get(char* slot) {
+        return reinterpret_cast<Pointer*>(slot)->get();
+    }
+
+    static void destroy(char* slot) {
+        reinterpret_cast<Pointer*>(slot)->~Pointer();
+    }
+};
+
+struct StorageTraits {
+    size_t size;
+    size_t alignment;
+    bool isInline;
+    void (*construct)(char*,
+                      const AccumulationStatement&,
+                      const boost::intrusive_ptr<ExpressionContext>&);
+    Accumulator* (*get)(char*);
+    void (*destroy)(char*);
+};
+
+template <typename AccumulatorType>
+StorageTraits inlineStorageTraits() {
+    using Storage = InlineStorage<AccumulatorType>;
+    return {sizeof(AccumulatorType),
+            alignof(AccumulatorType),
+            true,
+            &Storage::construct,
+            &Storage::get,
+            &Storage::destroy};
+}
+
+template <typename AccumulatorType, typename... Others>
+struct InlineStorageSelector {
+    static boost::optional<StorageTraits> select(const Accumulator& prototype) {
+        if (typeid(prototype) == typeid(AccumulatorType)) {
+            return inlineStorageTraits<AccumulatorType>();
+        }
+        return InlineStorageSelector<Others...>::select(prototype);
+    }
+};
+
+template <typename AccumulatorType>
+struct InlineStorageSelector<AccumulatorType> {
+    static boost::optional<StorageTraits> select(const Accumulator& prototype) {
+        if (typeid(prototype) == typeid(AccumulatorType)) {
+            return inlineStorageTraits<AccumulatorType>();
+        }
+        return boost::none;
+    }
+};
+
+/**
+ * Chooses how to store the accumulators built by 'statement'. Only accumulators whose state does
+ * not grow with their input are stored inline, so that a row never holds more than a few dozen
+ * bytes per accumulator.
+ */
+StorageTraits selectStorage(const AccumulationStatement& statement,
+                            const boost::intrusive_ptr<ExpressionContext>& expCtx) {
+    auto prototype = statement.makeAccumulator(expCtx);
+    auto inlineTraits = InlineStorageSelector<AccumulatorSum,
+                                              AccumulatorAvg,
+                                              AccumulatorMin,
+                                              AccumulatorMax,
+                                              AccumulatorFirst,
+                                              AccumulatorLast>::select(*prototype);
+    if (inlineTraits) {
+        return *inlineTraits;
+    }
+    return {sizeof(OutOfLineStorage::Pointer),
+            alignof(OutOfLineStorage::Pointer),
+            false,
+            &OutOfLineStorage::construct,
+            &OutOfLineStorage::get,
+            &OutOfLineStorage::destroy};
+}
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+/**
+ * Scrambles the bits of a Value hash, which are often poorly distributed in their low bits, for
+ * use as an index into a power-of-two sized table.
+ */
+uint32_t mixHash(size_t hash) {
+    uint64_t h = hash;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<uint32_t>(h);
+}
+
+}  // namespace
+
+constexpr size_t GroupTable::kRowsPerBlockLog2;
+constexpr size_t GroupTable::kRowsPerBlock;
+constexpr size_t GroupTable::kInitialCapacity;
+
+GroupTable::GroupTable(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                       const std::vector<AccumulationStatement>& accumulatedFields)
+    : _expCtx(expCtx), _accumulatedFields(accumulatedFields), _slots(kInitialCapacity) {
+    size_t rowAlignment = 1;
+    for (auto&& statement : _accumulatedFields) {
+        const auto traits = selectStorage(statement, _expCtx);
+        _rowSize = alignUp(_rowSize, traits.alignment);
+        _fieldLayouts.push_back(
+            {_rowSize, traits.isInline, traits.construct, traits.get, traits.destroy});
+        _rowSize += traits.size;
+        rowAlignment = std::max(rowAlignment, traits.alignment);
+    }
+    _rowSize = alignUp(_rowSize, rowAlignment);
+}
+
+GroupTable::~GroupTable() {
+    destroyRows();
+}
+
+std::pair<size_t, bool> GroupTable::findOrInsert(const Value& key) {
+    const auto& comparator = _expCtx->getValueComparator();
+    const uint32_t hash = mixHash(comparator.getHasher()(key));
+
+    size_t mask = _slots.size() - 1;
+    size_t index = hash & mask;
+    while (_slots[index].rowPlusOne != 0) {
+        const auto& slot = _slots[index];
+        if (slot.hash == hash && comparator.evaluate(_keys[slot.rowPlusOne - 1] == key)) {
+            return {slot.rowPlusOne - 1, false};
+        }
+        index = (index + 1) & mask;
+    }
+
+    // Keep the index at most three quarters full, so that probe sequences stay short.
+    if ((_keys.size() + 1) * 4 > _slots.size() * 3) {
+        grow();
+        mask = _slots.size() - 1;
+        index = hash & mask;
+        while (_slots[index].rowPlusOne != 0) {
+            index = (index + 1) & mask;
+        }
+    }
+
+    const size_t row = appendRow(key);
+    _hashes.push_back(hash);
+    _slots[index] = {static_cast<uint32_t>(row + 1), hash};
+    return {row, true};
+}
+
+size_t GroupTable::appendRow(const Value& key) {
+    const size_t row = _keys.size();
+    uassert(ErrorCodes::ExceededMemoryLimit,
+            "Too many groups for a single $group",
+            row < std::numeric_limits<uint32_t>::max());
+
+    if (_rowSize > 0 && (row >> kRowsPerBlockLog2) == _blocks.size()) {
+        _blocks.emplace_back(new char[_rowSize * kRowsPerBlock]);
+    }
+
+    char* storage = _rowSize > 0 ? rowStorage(row) : nullptr;
+    size_t constructed = 0;
+    try {
+        for (; constructed < _fieldLayouts.size(); ++constructed) {
+            const auto& layout = _fieldLayouts[constructed];
+            layout.construct(storage + layout.offset, _accumulatedFields[constructed], _expCtx);
+        }
+        _keys.push_back(key);
+    } catch (...) {
+        while (constructed > 0) {
+            --constructed;
+            _fieldLayouts[constructed].destroy(storage + _fieldLayouts[constructed].offset);
+        }
+        throw;
+    }
+    return row;
+}
+
+void GroupTable::grow() {
+    std::vector<Slot> slots(_slots.size() * 2);
+    const size_t mask = slots.size() - 1;
+    for (size_t row = 0; row < _keys.size(); ++row) {
+        size_t index = _hashes[row] & mask;
+        while (slots[index].rowPlusOne != 0) {
+            index = (index + 1) & mask;
+        }
+        slots[index] = {static_cast<uint32_t>(row + 1), _hashes[row]};
+    }
+    _slots = std::move(slots);
+}
+
+void GroupTable::destroyRows() {
+    if (_rowSize == 0) {
+        return;
+    }
+    for (size_t row = 0; row < _keys.size(); ++row) {
+        char* storage = rowStorage(row);
+        for (auto&& layout : _fieldLayouts) {
+            layout.destroy(storage + layout.offset);
+        }
+    }
+}
+
+void GroupTable::clear() {
+    destroyRows();
+
+    // Swap with empty containers, rather than clearing, so that the memory is actually released.
+    std::vector<Value>().swap(_keys);
+    std::vector<uint32_t>().swap(_hashes);
+    std::vector<std::unique_ptr<char[]>>().swap(_blocks);
+    std::vector<Slot>(kInitialCapacity).swap(_slots);
+}
+
+}  // namespace mongo
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/pipeline/accumulation_statement.h"
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * The in-memory hash table of a blocking $group, mapping each group key to the accumulators for
+ * that group.
+ *
+ * Keys are kept in one contiguous array, and are found through an open-addressing index which
+ * stores a fragment of each key's hash next to its row number, so that a miss rarely needs to look
+ * at the key itself. The accumulators of a group live in a fixed-size row carved out of large
+ * blocks: the accumulators whose state has a fixed size ($sum, $avg, $min, $max, $first and $last)
+ * are constructed directly inside the row, while any others are allocated separately and
+ * referenced from it.
+ *
+ * Accumulators constructed inside a row are not reference counted, so the pointers returned by
+ * getAccumulator() must never be wrapped in a boost::intrusive_ptr, and are invalidated by
+ * clear().
+ *
+ * Keys are compared and hashed according to the ExpressionContext's ValueComparator.
+ */
+class GroupTable {
+    MONGO_DISALLOW_COPYING(GroupTable);
+
+public:
+    GroupTable(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+               const std::vector<AccumulationStatement>& accumulatedFields);
+    ~GroupTable();
+
+    /**
+     * Returns the row holding the group for 'key', and whether it had to be inserted. A newly
+     * inserted row holds freshly constructed accumulators.
+     */
+    std::pair<size_t, bool> findOrInsert(const Value& key);
+
+    size_t size() const {
+        return _keys.size();
+    }
+
+    bool empty() const {
+        return _keys.empty();
+    }
+
+    const Value& getKey(size_t row) const {
+        return _keys[row];
+    }
+
+    /**
+     * Returns the accumulator for the 'field'th accumulated field of the group in 'row'.
+     */
+    Accumulator* getAccumulator(size_t row, size_t field) const {
+        const auto& layout = _fieldLayouts[field];
+        return layout.get(rowStorage(row) + layout.offset);
+    }
+
+    /**
+     * Returns whether the accumulators for the 'field'th accumulated field are stored inside the
+     * rows of this table.
+     */
+    bool isStoredInline(size_t field) const {
+        return _fieldLayouts[field].isInline;
+    }
+
+    /**
+     * Destroys every group, releasing the memory held by the table.
+     */
+    void clear();
+
+private:
+    struct FieldLayout {
+        size_t offset;
+        bool isInline;
+        void (*construct)(char* slot,
+                          const AccumulationStatement& statement,
+                          const boost::intrusive_ptr<ExpressionContext>& expCtx);
+        Accumulator* (*get)(char* slot);
+        void (*destroy)(char* slot);
+    };
+
+    // An entry of the index. A 'rowPlusOne' of zero marks an empty entry.
+    struct Slot {
+        uint32_t rowPlusOne;
+        uint32_t hash;
+    };
+
+    static constexpr size_t kRowsPerBlockLog2 = 10;
+    static constexpr size_t kRowsPerBlock = size_t(1) << kRowsPerBlockLog2;
+    static constexpr size_t kInitialCapacity = 16;
+
+    char* rowStorage(size_t row) const {
+        return _blocks[row >> kRowsPerBlockLog2].get() + (row & (kRowsPerBlock - 1)) * _rowSize;
+    }
+
+    /**
+     * Appends a row for 'key', constructing its accumulators. Returns the new row's number.
+     */
+    size_t appendRow(const Value& key);
+
+    /**
+     * Destroys the accumulators of every row.
+     */
+    void destroyRows();
+
+    /**
+     * Doubles the capacity of the index and reinserts every row.
+     */
+    void grow();
+
+    const boost::intrusive_ptr<ExpressionContext> _expCtx;
+    const std::vector<AccumulationStatement> _accumulatedFields;
+
+    std::vector<FieldLayout> _fieldLayouts;
+    size_t _rowSize = 0;
+
+    std::vector<Value> _keys;
+    std::vector<uint32_t> _hashes;
+    std::vector<std::unique_ptr<char[]>> _blocks;
+
+    std::vector<Slot> _slots;
+};
+
+}  // namespace mongo
@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_table.h"
+
+#include "mongo/db/pipeline/aggregation_context_fixture.h"
+#include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using GroupTableTest = AggregationContextFixture;
+
+AccumulationStatement makeStatement(const boost::intrusive_ptr<ExpressionContext>& expCtx,
+                                    StringData accumulatorName) {
+    return {accumulatorName.toString(),
+            ExpressionConstant::create(expCtx, Value(1)),
+            AccumulationStatement::getFactory(accumulatorName)};
+}
+
+TEST_F(GroupTableTest, FindsExistingGroupsAndInsertsNewOnes) {
+    auto expCtx = getExpCtx();
+    GroupTable table(expCtx, {makeStatement(expCtx, "$sum")});
+    ASSERT_TRUE(table.empty());
+
+    // Enough keys to grow the index and to span several blocks of rows.
+    const int numKeys = 5000;
+    for (int i = 0; i < numKeys; ++i) {
+        auto found = table.findOrInsert(Value(i));
+        ASSERT_TRUE(found.second);
+        ASSERT_EQ(found.first, static_cast<size_t>(i));
+        table.getAccumulator(found.first, 0)->process(Value(i), false);
+    }
+
+    for (int i = 0; i < numKeys; ++i) {
+        // Equal numbers of a different type belong to the same group.
+        auto found = table.findOrInsert(Value(static_cast<double>(i)));
+        ASSERT_FALSE(found.second);
+        ASSERT_EQ(found.first, static_cast<size_t>(i));
+        table.getAccumulator(found.first, 0)->process(Value(1), false);
+    }
+
+    ASSERT_EQ(table.size(), static_cast<size_t>(numKeys));
+    for (int i = 0; i < numKeys; ++i) {
+        ASSERT_VALUE_EQ(table.getKey(i), Value(i));
+        ASSERT_VALUE_EQ(table.getAccumulator(i, 0)->getValue(false), Value(i + 1));
+    }
+}
+
+TEST_F(GroupTableTest, StoresFixedSizeAccumulatorsInline) {
+    auto expCtx = getExpCtx();
+    GroupTable table(expCtx,
+                     {makeStatement(expCtx, "$sum"),
+                      makeStatement(expCtx, "$avg"),
+                      makeStatement(expCtx, "$min"),
+                      makeStatement(expCtx, "$max"),
+                      makeStatement(expCtx, "$first"),
+                      makeStatement(expCtx, "$last"),
+                      makeStatement(expCtx, "$push"),
+                      makeStatement(expCtx, "$addToSet")});
+    for (size_t i = 0; i < 6; ++i) {
+        ASSERT_TRUE(table.isStoredInline(i));
+    }
+    ASSERT_FALSE(table.isStoredInline(6));
+    ASSERT_FALSE(table.isStoredInline(7));
+
+    for (int i = 0; i < 10; ++i) {
+        auto row = table.findOrInsert(Value(i % 2)).first;
+        for (size_t field = 0; field < 8; ++field) {
+            table.getAccumulator(row, field)->process(Value(i), false);
+        }
+    }
+
+    ASSERT_EQ(table.size(), 2UL);
+    auto row = table.findOrInsert(Value(1)).first;
+    ASSERT_VALUE_EQ(table.getAccumulator(row, 0)->getValue(false), Value(25));
+    ASSERT_VALUE_EQ(table.getAccumulator(row, 1)->getValue(false), Value(5.0));
+    ASSERT_VALUE_EQ(table.getAccumulator(row, 2)->getValue(false), Value(1));
+    ASSERT_VALUE_EQ(table.getAccumulator(row, 3)->getValue(false), Value(9));
+    ASSERT_VALUE_EQ(table.getAccumulator(row, 4)->getValue(false), Value(1));
+    ASSERT_VALUE_EQ(table.getAccumulator(row, 5)->getValue(false), Value(9));
+    ASSERT_VALUE_EQ(table.getAccumulator(row, 6)->getValue(false),
+                    Value(std::vector<Value>{Value(1), Value(3), Value(5), Value(7), Value(9)}));
+}
+
+TEST_F(GroupTableTest, ClearRemovesAllGroups) {
+    auto expCtx = getExpCtx();
+    GroupTable table(expCtx, {makeStatement(expCtx, "$push")});
+    for (int i = 0; i < 100; ++i) {
+        table.findOrInsert(Value(i));
+    }
+    table.clear();
+    ASSERT_TRUE(table.empty());
+
+    auto found = table.findOrInsert(Value(7));
+    ASSERT_TRUE(found.second);
+    ASSERT_EQ(found.first, 0UL);
+}
+
+TEST_F(GroupTableTest, GroupsKeysAccordingToCollation) {
+    auto expCtx = getExpCtx();
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    expCtx->setCollator(&collator);
+
+    GroupTable table(expCtx, {});
+    ASSERT_TRUE(table.findOrInsert(Value("a"_sd)).second);
+    ASSERT_FALSE(table.findOrInsert(Value("b"_sd)).second);
+    ASSERT_EQ(table.size(), 1UL);
+}
+
+}  // namespace
+}  // namespace mongo
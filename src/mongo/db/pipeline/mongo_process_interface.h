@@ -223,6 +223,26 @@ public:
         const Document& documentKey,
         boost::optional<BSONObj> readConcern) = 0;
 
+    /**
+     * Looks up the document with each of the document keys in 'documentKeys', as
+     * lookupSingleDocument() does, and returns the results in the same order. The default
+     * implementation performs one lookup per key; implementations may look them up together.
+     */
+    virtual std::vector<boost::optional<Document>> lookupDocuments(
+        const boost::intrusive_ptr<ExpressionContext>& expCtx,
+        const NamespaceString& nss,
+        UUID collectionUUID,
+        const std::vector<Document>& documentKeys,
+        boost::optional<BSONObj> readConcern) {
+        std::vector<boost::optional<Document>> results;
+        results.reserve(documentKeys.size());
+        for (auto&& documentKey : documentKeys) {
+            results.push_back(
+                lookupSingleDocument(expCtx, nss, collectionUUID, documentKey, readConcern));
+        }
+        return results;
+    }
+
     /**
      * Returns a vector of all idle (non-pinned) local cursors.
      */
@@ -246,6 +266,20 @@ public:
                                                                 const NamespaceString&,
                                                                 const MatchExpression*) const = 0;
 
+    /**
+     * Returns a vector of BSON objects, where each entry in the vector describes the size and
+     * lookup counters of one partition of the plan cache for the given namespace. Only those
+     * entries which match the supplied MatchExpression are returned.
+     */
+    virtual std::vector<BSONObj> getMatchingPlanCachePartitionStats(
+        OperationContext*, const NamespaceString&, const MatchExpression*) const = 0;
+
+    /**
+     * Returns a vector of BSON objects, where each entry in the vector describes the aggregated
+     * execution statistics of one query shape on the given namespace.
+     */
+    virtual std::vector<BSONObj> getQueryStats(OperationContext*, const NamespaceString&) const = 0;
+
     /**
      * Returns true if there is an index on 'nss' with properties that will guarantee that a
      * document with non-array values for each of 'uniqueKeyPaths' will have at most one matching
@@ -32,6 +32,7 @@
 
 #include "mongo/db/pipeline/mongod_process_interface.h"
 
+#include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database_holder.h"
@@ -48,6 +49,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/stats/fill_locker_info.h"
+#include "mongo/db/stats/query_stats_store.h"
 #include "mongo/db/stats/storage_stats.h"
 #include "mongo/db/storage/backup_cursor_hooks.h"
 #include "mongo/db/transaction_participant.h"
@@ -438,6 +440,104 @@ boost::optional<Document> MongoDInterface::lookupSingleDocument(
     return lookedUpDocument;
 }
 
+std::vector<boost::optional<Document>> MongoDInterface::lookupDocuments(
+    const boost::intrusive_ptr<ExpressionContext>& expCtx,
+    const NamespaceString& nss,
+    UUID collectionUUID,
+    const std::vector<Document>& documentKeys,
+    boost::optional<BSONObj> readConcern) {
+    invariant(!readConcern);  // As for lookupSingleDocument(), only expected on mongos.
+
+    if (documentKeys.size() <= 1) {
+        return MongoProcessInterface::lookupDocuments(
+            expCtx, nss, collectionUUID, documentKeys, readConcern);
+    }
+
+    // Results are joined back to their keys by the values of the key fields, which requires all
+    // keys to have the same fields. That only fails to hold across a shardCollection.
+    std::vector<FieldPath> keyFields;
+    for (auto it = documentKeys.front().fieldIterator(); it.more();) {
+        keyFields.emplace_back(it.next().first);
+    }
+    auto keyFieldsMatch = [&](const Document& documentKey) {
+        if (documentKey.size() != keyFields.size()) {
+            return false;
+        }
+        size_t i = 0;
+        for (auto it = documentKey.fieldIterator(); it.more(); ++i) {
+            if (it.next().first != keyFields[i].fullPath()) {
+                return false;
+            }
+        }
+        return true;
+    };
+    if (!std::all_of(documentKeys.begin(), documentKeys.end(), keyFieldsMatch)) {
+        return MongoProcessInterface::lookupDocuments(
+            expCtx, nss, collectionUUID, documentKeys, readConcern);
+    }
+
+    BSONObj filter;
+    if (keyFields.size() == 1 && keyFields.front().fullPath() == "_id") {
+        BSONArrayBuilder ids;
+        for (auto&& documentKey : documentKeys) {
+            documentKey["_id"].addToBsonArray(&ids);
+        }
+        filter = BSON("_id" << BSON("$in" << ids.arr()));
+    } else {
+        BSONArrayBuilder keys;
+        for (auto&& documentKey : documentKeys) {
+            keys.append(documentKey.toBson());
+        }
+        filter = BSON("$or" << keys.arr());
+    }
+
+    std::unique_ptr<Pipeline, PipelineDeleter> pipeline;
+    try {
+        // Be sure to do the lookup using the collection default collation
+        auto foreignExpCtx = expCtx->copyWith(
+            nss,
+            collectionUUID,
+            _getCollectionDefaultCollator(expCtx->opCtx, nss.db(), collectionUUID));
+        pipeline = uassertStatusOK(makePipeline({BSON("$match" << filter)}, foreignExpCtx));
+    } catch (const ExceptionFor<ErrorCodes::NamespaceNotFound>&) {
+        return std::vector<boost::optional<Document>>(documentKeys.size());
+    }
+
+    auto foundByKey =
+        SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<boost::optional<Document>>();
+    while (auto lookedUpDocument = pipeline->getNext()) {
+        MutableDocument key;
+        for (auto&& field : keyFields) {
+            key.addField(field.fullPath(), lookedUpDocument->getNestedField(field));
+        }
+        auto& found = foundByKey[key.freeze().toBson()];
+        uassert(ErrorCodes::TooManyMatchingDocuments,
+                str::stream() << "found more than one document with the same document key ["
+                              << found->toString()
+                              << ", "
+                              << lookedUpDocument->toString()
+                              << "]",
+                !found);
+        found = std::move(lookedUpDocument);
+    }
+
+    // A key without a result may belong to a document that was deleted, or whose key fields only
+    // compare equal under the collection's collation. Look those up individually so that the
+    // result is the same as for lookupSingleDocument().
+    std::vector<boost::optional<Document>> results;
+    results.reserve(documentKeys.size());
+    for (auto&& documentKey : documentKeys) {
+        auto it = foundByKey.find(documentKey.toBson());
+        if (it != foundByKey.end()) {
+            results.push_back(it->second);
+        } else {
+            results.push_back(
+                lookupSingleDocument(expCtx, nss, collectionUUID, documentKey, readConcern));
+        }
+    }
+    return results;
+}
+
 BackupCursorState MongoDInterface::openBackupCursor(OperationContext* opCtx) {
     auto backupCursorHooks = BackupCursorHooks::get(opCtx->getServiceContext());
     if (backupCursorHooks->enabled()) {
@@ -481,6 +581,42 @@ std::vector<BSONObj> MongoDInterface::getMatchingPlanCacheEntryStats(
     return planCache->getMatchingStats(serializer, predicate);
 }
 
+std::vector<BSONObj> MongoDInterface::getMatchingPlanCachePartitionStats(
+    OperationContext* opCtx, const NamespaceString& nss, const MatchExpression* matchExp) const {
+    AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+    const auto collection = autoColl.getCollection();
+    uassert(
+        50972, str::stream() << "collection '" << nss.toString() << "' does not exist", collection);
+
+    const auto infoCache = collection->infoCache();
+    invariant(infoCache);
+    const auto planCache = infoCache->getPlanCache();
+    invariant(planCache);
+
+    std::vector<BSONObj> results;
+    const auto partitions = planCache->getPartitionStats();
+    for (size_t i = 0; i < partitions.size(); ++i) {
+        BSONObjBuilder out;
+        out.appendNumber("partition", static_cast<long long>(i));
+        out.appendNumber("numEntries", static_cast<long long>(partitions[i].numEntries));
+        out.appendNumber("capacity", static_cast<long long>(partitions[i].capacity));
+        out.appendNumber("hits", partitions[i].hits);
+        out.appendNumber("misses", partitions[i].misses);
+        out.appendNumber("evictions", partitions[i].evictions);
+
+        auto serialized = out.obj();
+        if (!matchExp || matchExp->matchesBSON(serialized)) {
+            results.push_back(std::move(serialized));
+        }
+    }
+    return results;
+}
+
+std::vector<BSONObj> MongoDInterface::getQueryStats(OperationContext* opCtx,
+                                                    const NamespaceString& nss) const {
+    return QueryStatsStore::get(opCtx->getServiceContext()).getStats(nss.ns());
+}
+
 bool MongoDInterface::uniqueKeyIsSupportedByIndex(
     const boost::intrusive_ptr<ExpressionContext>& expCtx,
     const NamespaceString& nss,
@@ -155,6 +155,16 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::vector<BSONObj> getMatchingPlanCachePartitionStats(OperationContext*,
+                                                            const NamespaceString&,
+                                                            const MatchExpression*) const final {
+        MONGO_UNREACHABLE;
+    }
+
+    std::vector<BSONObj> getQueryStats(OperationContext*, const NamespaceString&) const final {
+        MONGO_UNREACHABLE;
+    }
+
     bool uniqueKeyIsSupportedByIndex(const boost::intrusive_ptr<ExpressionContext>&,
                                      const NamespaceString&,
                                      const std::set<FieldPath>& uniqueKeyPaths) const final;
@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/parallel_worker_pool.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+ThreadPool::Options makeOptions(std::string name, size_t maxThreads) {
+    ThreadPool::Options options;
+    options.poolName = std::move(name);
+    options.minThreads = 0;
+    options.maxThreads = maxThreads;
+    return options;
+}
+
+}  // namespace
+
+ParallelWorkerPool::ParallelWorkerPool(std::string name, size_t maxThreads)
+    : _pool(makeOptions(std::move(name), maxThreads)), _maxThreads(maxThreads) {
+    _pool.startup();
+}
+
+boost::optional<ParallelWorkerPool::Reservation> ParallelWorkerPool::tryReserve(
+    size_t numThreads) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (numThreads > _maxThreads - _numReserved) {
+            return boost::none;
+        }
+        _numReserved += numThreads;
+    }
+    return Reservation(this, numThreads);
+}
+
+size_t ParallelWorkerPool::numAvailable() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _maxThreads - _numReserved;
+}
+
+void ParallelWorkerPool::_release(size_t numThreads) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_numReserved >= numThreads);
+    _numReserved -= numThreads;
+}
+
+ParallelWorkerPool::Reservation::Reservation(ParallelWorkerPool* pool, size_t numThreads)
+    : _pool(pool), _numThreads(numThreads) {}
+
+ParallelWorkerPool::Reservation::Reservation(Reservation&& other)
+    : _pool(other._pool), _numThreads(other._numThreads), _numScheduled(other._numScheduled) {
+    other._pool = nullptr;
+    other._numThreads = 0;
+    other._numScheduled = 0;
+}
+
+ParallelWorkerPool::Reservation& ParallelWorkerPool::Reservation::operator=(Reservation&& other) {
+    if (this != &other) {
+        release();
+        _pool = other._pool;
+        _numThreads = other._numThreads;
+        _numScheduled = other._numScheduled;
+        other._pool = nullptr;
+        other._numThreads = 0;
+        other._numScheduled = 0;
+    }
+    return *this;
+}
+
+ParallelWorkerPool::Reservation::~Reservation() {
+    release();
+}
+
+Status ParallelWorkerPool::Reservation::schedule(ThreadPool::Task task) {
+    invariant(_pool);
+    invariant(_numScheduled < _numThreads);
+    ++_numScheduled;
+    // Since no more tasks than there are reserved threads are ever scheduled, the pool always has a
+    // thread to start for 'task', or one about to become idle.
+    return _pool->_pool.schedule(std::move(task));
+}
+
+void ParallelWorkerPool::Reservation::release() {
+    if (!_pool) {
+        return;
+    }
+    _pool->_release(_numThreads);
+    _pool = nullptr;
+    _numThreads = 0;
+    _numScheduled = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+
+namespace mongo {
+
+/**
+ * A pool of threads on which a pipeline stage runs the parts of its work that must all make
+ * progress at the same time, such as the partitions of a parallel $group. Such parts block on each
+ * other, so a stage which got threads for only some of them while the rest waited in the queue of a
+ * busy pool would never finish. Stages therefore reserve a thread for each part up front, and are
+ * either granted all of them or none.
+ */
+class ParallelWorkerPool {
+    MONGO_DISALLOW_COPYING(ParallelWorkerPool);
+
+public:
+    /**
+     * A number of threads of a ParallelWorkerPool set aside for one stage. Returns them to the pool
+     * when released or destroyed.
+     */
+    class Reservation {
+        MONGO_DISALLOW_COPYING(Reservation);
+
+    public:
+        Reservation() = default;
+        Reservation(Reservation&& other);
+        Reservation& operator=(Reservation&& other);
+        ~Reservation();
+
+        /**
+         * Runs 'task' on one of the reserved threads. At most as many tasks as there are reserved
+         * threads may be scheduled, and each must have finished before the reservation is released.
+         */
+        Status schedule(ThreadPool::Task task);
+
+        /**
+         * Returns the reserved threads to the pool. Safe to call more than once.
+         */
+        void release();
+
+        size_t size() const {
+            return _numThreads;
+        }
+
+    private:
+        friend class ParallelWorkerPool;
+
+        Reservation(ParallelWorkerPool* pool, size_t numThreads);
+
+        ParallelWorkerPool* _pool = nullptr;
+        size_t _numThreads = 0;
+        size_t _numScheduled = 0;
+    };
+
+    /**
+     * Creates a pool named 'name' of up to 'maxThreads' threads, which are started on demand.
+     */
+    ParallelWorkerPool(std::string name, size_t maxThreads);
+
+    /**
+     * Reserves 'numThreads' threads, or returns boost::none if fewer than that are currently
+     * unreserved. Never blocks.
+     */
+    boost::optional<Reservation> tryReserve(size_t numThreads);
+
+    /**
+     * Returns the number of threads not currently reserved.
+     */
+    size_t numAvailable() const;
+
+private:
+    void _release(size_t numThreads);
+
+    ThreadPool _pool;
+    const size_t _maxThreads;
+
+    mutable stdx::mutex _mutex;
+    size_t _numReserved = 0;
+};
+
+}  // namespace mongo
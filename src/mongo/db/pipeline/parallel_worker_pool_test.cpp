@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/parallel_worker_pool.h"
+
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(ParallelWorkerPoolTest, ShouldGrantReservationsWhileThreadsRemain) {
+    ParallelWorkerPool pool("ParallelWorkerPoolTest", 4);
+    auto first = pool.tryReserve(3);
+    ASSERT(first);
+    ASSERT_EQ(first->size(), 3UL);
+    ASSERT_EQ(pool.numAvailable(), 1UL);
+
+    auto second = pool.tryReserve(1);
+    ASSERT(second);
+    ASSERT_EQ(pool.numAvailable(), 0UL);
+}
+
+TEST(ParallelWorkerPoolTest, ShouldRefuseReservationLargerThanAvailableThreads) {
+    ParallelWorkerPool pool("ParallelWorkerPoolTest", 4);
+    auto first = pool.tryReserve(3);
+    ASSERT(first);
+
+    // A partial reservation is never granted.
+    ASSERT_FALSE(pool.tryReserve(2));
+    ASSERT_EQ(pool.numAvailable(), 1UL);
+    ASSERT_FALSE(pool.tryReserve(5));
+}
+
+TEST(ParallelWorkerPoolTest, ShouldReturnThreadsOnReleaseAndDestruction) {
+    ParallelWorkerPool pool("ParallelWorkerPoolTest", 4);
+    {
+        auto reservation = pool.tryReserve(4);
+        ASSERT(reservation);
+        ASSERT_EQ(pool.numAvailable(), 0UL);
+    }
+    ASSERT_EQ(pool.numAvailable(), 4UL);
+
+    auto reservation = pool.tryReserve(2);
+    ASSERT(reservation);
+    reservation->release();
+    reservation->release();
+    ASSERT_EQ(pool.numAvailable(), 4UL);
+}
+
+TEST(ParallelWorkerPoolTest, ShouldTransferThreadsOnMove) {
+    ParallelWorkerPool pool("ParallelWorkerPoolTest", 4);
+    ParallelWorkerPool::Reservation moved;
+    {
+        auto reservation = pool.tryReserve(3);
+        ASSERT(reservation);
+        moved = std::move(*reservation);
+    }
+    ASSERT_EQ(moved.size(), 3UL);
+    ASSERT_EQ(pool.numAvailable(), 1UL);
+
+    moved.release();
+    ASSERT_EQ(pool.numAvailable(), 4UL);
+}
+
+TEST(ParallelWorkerPoolTest, ShouldRunAllReservedTasksAtOnce) {
+    const size_t kNumTasks = 4;
+    ParallelWorkerPool pool("ParallelWorkerPoolTest", kNumTasks);
+    auto reservation = pool.tryReserve(kNumTasks);
+    ASSERT(reservation);
+
+    // Every task waits for all of the others to have started, so this only finishes if each of
+    // them got a thread of its own.
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    size_t numStarted = 0;
+    size_t numFinished = 0;
+    for (size_t i = 0; i < kNumTasks; ++i) {
+        ASSERT_OK(reservation->schedule([&] {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            ++numStarted;
+            cv.notify_all();
+            cv.wait(lk, [&] { return numStarted == kNumTasks; });
+            ++numFinished;
+            cv.notify_all();
+        }));
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    cv.wait(lk, [&] { return numFinished == kNumTasks; });
+    lk.unlock();
+    reservation->release();
+    ASSERT_EQ(pool.numAvailable(), kNumTasks);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -50,6 +50,8 @@ void InclusionNode::optimize() {
     for (auto&& expressionIt : _expressions) {
         _expressions[expressionIt.first] = expressionIt.second->optimize();
     }
+    _compiledExpressions.reset();
+    _attemptedCompilation = false;
     for (auto&& childPair : _children) {
         childPair.second->optimize();
     }
@@ -147,11 +149,19 @@ Value InclusionNode::applyInclusionsToValue(Value inputValue) const {
 }
 
 void InclusionNode::addComputedFields(MutableDocument* outputDoc, const Document& root) const {
+    const CompiledExpression* compiled = getCompiledExpressions();
+    if (compiled) {
+        compiled->evaluate(root);
+    }
+
+    size_t expressionIdx = 0;
     for (auto&& field : _orderToProcessAdditionsAndChildren) {
         auto childIt = _children.find(field);
         if (childIt != _children.end()) {
             outputDoc->setField(field,
                                 childIt->second->addComputedFields(outputDoc->peek()[field], root));
+        } else if (compiled) {
+            outputDoc->setField(field, compiled->getResult(expressionIdx++));
         } else {
             auto expressionIt = _expressions.find(field);
             invariant(expressionIt != _expressions.end());
@@ -160,6 +170,24 @@ void InclusionNode::addComputedFields(MutableDocument* outputDoc, const Document
     }
 }
 
+const CompiledExpression* InclusionNode::getCompiledExpressions() const {
+    if (!_attemptedCompilation) {
+        _attemptedCompilation = true;
+
+        std::vector<const Expression*> roots;
+        for (auto&& field : _orderToProcessAdditionsAndChildren) {
+            auto expressionIt = _expressions.find(field);
+            if (expressionIt != _expressions.end()) {
+                roots.push_back(expressionIt->second.get());
+            }
+        }
+        if (!roots.empty()) {
+            _compiledExpressions = CompiledExpression::compile(roots);
+        }
+    }
+    return _compiledExpressions.get();
+}
+
 Value InclusionNode::addComputedFields(Value inputValue, const Document& root) const {
     if (inputValue.getType() == BSONType::Object) {
         MutableDocument outputDoc(inputValue.getDocument());
@@ -30,6 +30,7 @@
 
 #include <memory>
 
+#include "mongo/db/pipeline/compiled_expression.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/parsed_aggregation_projection.h"
@@ -159,6 +160,12 @@ private:
      */
     bool subtreeContainsComputedFields() const;
 
+    /**
+     * Compiles the expressions of this node, if that has not been attempted yet since the last
+     * call to optimize(). Returns nullptr if they are evaluated one by one instead.
+     */
+    const CompiledExpression* getCompiledExpressions() const;
+
     ProjectionArrayRecursionPolicy _arrayRecursionPolicy;
 
     std::string _pathToNode;
@@ -176,6 +183,12 @@ private:
     StringMap<boost::intrusive_ptr<Expression>> _expressions;
     stdx::unordered_set<std::string> _inclusions;
 
+    // The expressions in '_expressions', in the order they appear in
+    // '_orderToProcessAdditionsAndChildren'. Compiled when a document is first projected, since
+    // the expressions may still be optimized until then.
+    mutable std::unique_ptr<CompiledExpression> _compiledExpressions;
+    mutable bool _attemptedCompilation = false;
+
     // TODO use StringMap once SERVER-23700 is resolved.
     stdx::unordered_map<std::string, std::unique_ptr<InclusionNode>> _children;
 };
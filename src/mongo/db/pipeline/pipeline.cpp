@@ -592,8 +592,10 @@ Status Pipeline::_pipelineCanRunOnMongoS() const {
 
         const bool mustWriteToDisk =
             (constraints.diskRequirement == DiskUseRequirement::kWritesPersistentData);
+        // A stage which may spill to disk can still run on a mongoS which has somewhere to spill.
+        const bool mongosCanSpill = pCtx->inMongos && pCtx->canSpillToDisk();
         const bool mayWriteTmpDataAndDiskUseIsAllowed =
-            (pCtx->allowDiskUse &&
+            (pCtx->allowDiskUse && !mongosCanSpill &&
              constraints.diskRequirement == DiskUseRequirement::kWritesTmpData);
         const bool needsDisk = (mustWriteToDisk || mayWriteTmpDataAndDiskUseIsAllowed);
 
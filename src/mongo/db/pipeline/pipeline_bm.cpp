@@ -0,0 +1,307 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <deque>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_source_group.h"
+#include "mongo/db/pipeline/document_source_lookup.h"
+#include "mongo/db/pipeline/document_source_mock.h"
+#include "mongo/db/pipeline/document_source_project.h"
+#include "mongo/db/pipeline/document_source_sort.h"
+#include "mongo/db/pipeline/document_source_unwind.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/db/pipeline/pipeline.h"
+#include "mongo/db/pipeline/stub_mongo_process_interface.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+namespace {
+
+using boost::intrusive_ptr;
+
+constexpr int kNumDocuments = 10 * 1000;
+
+/**
+ * Returns a document shaped like a typical application document. 'key' takes 'cardinality'
+ * distinct values, and 'value' is a permutation of [0, kNumDocuments).
+ */
+Document makeDocument(int i, int cardinality, int arraySize) {
+    MutableDocument doc;
+    doc.addField("_id", Value(i));
+    doc.addField("key", Value(i % cardinality));
+    doc.addField("value", Value((i * 7919) % kNumDocuments));
+    doc.addField("name", Value("user" + std::to_string(i)));
+    doc.addField("score", Value(i * 0.5));
+    doc.addField("nested", Value(Document{{"a", i}, {"b", "text"_sd}, {"c", true}}));
+
+    std::vector<Value> tags;
+    for (int j = 0; j < arraySize; ++j) {
+        tags.push_back(Value(j));
+    }
+    doc.addField("tags", Value(std::move(tags)));
+    return doc.freeze();
+}
+
+std::deque<DocumentSource::GetNextResult> makeDocuments(int numDocuments,
+                                                        int cardinality,
+                                                        int arraySize = 3) {
+    std::deque<DocumentSource::GetNextResult> docs;
+    for (int i = 0; i < numDocuments; ++i) {
+        docs.emplace_back(makeDocument(i, cardinality, arraySize));
+    }
+    return docs;
+}
+
+/**
+ * Runs 'stage' over 'input' until it is exhausted. The mock source only shares the already built
+ * documents, so the time is spent in 'stage'.
+ */
+void drain(const intrusive_ptr<DocumentSource>& stage,
+           const std::deque<DocumentSource::GetNextResult>& input) {
+    auto source = DocumentSourceMock::create(input);
+    stage->setSource(source.get());
+    for (auto next = stage->getNext(); !next.isEOF(); next = stage->getNext()) {
+        benchmark::DoNotOptimize(next);
+    }
+    stage->dispose();
+}
+
+intrusive_ptr<DocumentSource> parseStage(const char* json,
+                                         const intrusive_ptr<ExpressionContext>& expCtx) {
+    auto spec = fromjson(json);
+    auto stages = DocumentSource::parse(expCtx, spec);
+    invariant(stages.size() == 1);
+    return stages.front();
+}
+
+//
+// Document and Value construction.
+//
+
+void BM_DocumentFromBson(benchmark::State& state) {
+    BSONObjBuilder builder;
+    makeDocument(1, 10, state.range(0)).toBson(&builder);
+    const BSONObj obj = builder.obj();
+    for (auto _ : state) {
+        Document doc(obj);
+        // Documents are built from BSON lazily, so look up the last field.
+        benchmark::DoNotOptimize(doc["tags"]);
+    }
+}
+
+void BM_MutableDocumentBuild(benchmark::State& state) {
+    int i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(makeDocument(i++, 10, state.range(0)));
+    }
+}
+
+void BM_DocumentToBson(benchmark::State& state) {
+    const Document doc = makeDocument(1, 10, state.range(0));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(doc.toBson());
+    }
+}
+
+void BM_DocumentFieldLookup(benchmark::State& state) {
+    const Document doc = makeDocument(1, 10, 3);
+    const FieldPath path("nested.b");
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(doc.getNestedField(path));
+    }
+}
+
+BENCHMARK(BM_DocumentFromBson)->Arg(0)->Arg(16);
+BENCHMARK(BM_MutableDocumentBuild)->Arg(0)->Arg(16);
+BENCHMARK(BM_DocumentToBson)->Arg(0)->Arg(16);
+BENCHMARK(BM_DocumentFieldLookup);
+
+//
+// Expression evaluation.
+//
+
+const char* const kExpressions[] = {
+    // Arithmetic on top-level fields.
+    "{e: {$add: ['$value', {$multiply: ['$score', 2]}]}}",
+    // A conditional on a dotted path.
+    "{e: {$cond: [{$gt: ['$nested.a', 5000]}, 'high', 'low']}}",
+    // String building.
+    "{e: {$concat: ['$name', '-', {$toUpper: '$nested.b'}]}}",
+    // Array processing with a variable.
+    "{e: {$sum: {$map: {input: '$tags', as: 't', in: {$multiply: ['$$t', '$key']}}}}}",
+};
+
+void BM_ExpressionEvaluate(benchmark::State& state) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const BSONObj spec = fromjson(kExpressions[state.range(0)]);
+    auto expression =
+        Expression::parseOperand(expCtx, spec.firstElement(), expCtx->variablesParseState);
+    expression = expression->optimize();
+
+    const Document doc = makeDocument(4321, 10, 8);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(expression->evaluate(doc));
+    }
+}
+
+BENCHMARK(BM_ExpressionEvaluate)->DenseRange(0, 3);
+
+//
+// Stages. Each iteration runs the stage over kNumDocuments documents.
+//
+
+void BM_Group(benchmark::State& state) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto input = makeDocuments(kNumDocuments, state.range(0));
+    for (auto _ : state) {
+        drain(parseStage("{$group: {_id: '$key', total: {$sum: '$value'}, avg: {$avg: '$score'}, "
+                         "last: {$last: '$name'}}}",
+                         expCtx),
+              input);
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocuments);
+}
+
+void BM_Sort(benchmark::State& state) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto input = makeDocuments(kNumDocuments, 10);
+    const auto spec = state.range(0) ? "{$sort: {key: 1, value: -1}}" : "{$sort: {value: 1}}";
+    for (auto _ : state) {
+        drain(parseStage(spec, expCtx), input);
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocuments);
+}
+
+void BM_SortWithLimit(benchmark::State& state) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto input = makeDocuments(kNumDocuments, 10);
+    for (auto _ : state) {
+        drain(DocumentSourceSort::create(expCtx, BSON("value" << 1), state.range(0)), input);
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocuments);
+}
+
+void BM_Unwind(benchmark::State& state) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto input = makeDocuments(kNumDocuments, 10, state.range(0));
+    for (auto _ : state) {
+        drain(parseStage("{$unwind: '$tags'}", expCtx), input);
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocuments * state.range(0));
+}
+
+void BM_Project(benchmark::State& state) {
+    const char* const specs[] = {
+        "{$project: {name: 1, 'nested.a': 1}}",
+        "{$project: {tags: 0, nested: 0}}",
+        "{$project: {name: 1, total: {$add: ['$value', '$key']}, flag: '$nested.c'}}",
+    };
+
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const auto input = makeDocuments(kNumDocuments, 10);
+    for (auto _ : state) {
+        drain(parseStage(specs[state.range(0)], expCtx), input);
+    }
+    state.SetItemsProcessed(state.iterations() * kNumDocuments);
+}
+
+BENCHMARK(BM_Group)->Arg(1)->Arg(100)->Arg(kNumDocuments);
+BENCHMARK(BM_Sort)->Arg(0)->Arg(1);
+BENCHMARK(BM_SortWithLimit)->Arg(10)->Arg(1000);
+BENCHMARK(BM_Unwind)->Arg(1)->Arg(10);
+BENCHMARK(BM_Project)->DenseRange(0, 2);
+
+/**
+ * Serves the foreign collection of a $lookup from memory. The $match on the foreign field stays in
+ * the sub-pipeline, so each lookup scans all of the foreign documents, as it would without an
+ * index on the foreign field.
+ */
+class MockMongoInterface final : public StubMongoProcessInterface {
+public:
+    explicit MockMongoInterface(std::deque<DocumentSource::GetNextResult> foreignDocuments)
+        : _foreignDocuments(std::move(foreignDocuments)) {}
+
+    bool isSharded(OperationContext* opCtx, const NamespaceString& ns) final {
+        return false;
+    }
+
+    StatusWith<std::unique_ptr<Pipeline, PipelineDeleter>> makePipeline(
+        const std::vector<BSONObj>& rawPipeline,
+        const intrusive_ptr<ExpressionContext>& expCtx,
+        const MakePipelineOptions opts) final {
+        auto pipeline = uassertStatusOK(Pipeline::parse(rawPipeline, expCtx));
+        if (opts.optimize) {
+            pipeline->optimizePipeline();
+        }
+        if (opts.attachCursorSource) {
+            uassertStatusOK(attachCursorSourceToPipeline(expCtx, pipeline.get()));
+        }
+        return std::move(pipeline);
+    }
+
+    Status attachCursorSourceToPipeline(const intrusive_ptr<ExpressionContext>& expCtx,
+                                        Pipeline* pipeline) final {
+        pipeline->addInitialSource(DocumentSourceMock::create(_foreignDocuments));
+        return Status::OK();
+    }
+
+private:
+    const std::deque<DocumentSource::GetNextResult> _foreignDocuments;
+};
+
+void BM_Lookup(benchmark::State& state) {
+    intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    const NamespaceString fromNs("test", "foreign");
+    expCtx->setResolvedNamespace_forTest(fromNs, {fromNs, std::vector<BSONObj>{}});
+    expCtx->mongoProcessInterface =
+        std::make_shared<MockMongoInterface>(makeDocuments(state.range(0), state.range(0)));
+
+    // Fewer local documents, as each one runs a sub-pipeline over all of the foreign documents.
+    const int numLocalDocuments = 1000;
+    const auto input = makeDocuments(numLocalDocuments, state.range(0));
+    for (auto _ : state) {
+        drain(parseStage("{$lookup: {from: 'foreign', localField: 'key', foreignField: '_id', "
+                         "as: 'joined'}}",
+                         expCtx),
+              input);
+    }
+    state.SetItemsProcessed(state.iterations() * numLocalDocuments);
+}
+
+BENCHMARK(BM_Lookup)->Arg(10)->Arg(1000);
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,8 @@
 
 #include "mongo/db/pipeline/pipeline_d.h"
 
+#include <map>
+
 #include "mongo/bson/simple_bsonobj_comparator.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
@@ -65,6 +67,7 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
@@ -93,6 +96,99 @@ using write_ops::Insert;
 
 namespace {
 
+/**
+ * A RecordCursor which samples a record store in blocks. It uses a random cursor to choose a
+ * record, then returns that record followed by up to 'blockSize - 1' of the records after it in
+ * RecordId order. Neighbouring records usually share a storage page, so a large sample costs one
+ * random seek per block rather than one per document, at the price of a clustered sample. A block
+ * ends early when it reaches a record which this cursor has already returned, and a random pick
+ * which falls inside an earlier block is returned on its own, for $sample to skip as a duplicate.
+ */
+class BlockSamplingCursor final : public RecordCursor {
+public:
+    BlockSamplingCursor(std::unique_ptr<RecordCursor> randomCursor,
+                        std::unique_ptr<SeekableRecordCursor> forwardCursor,
+                        long long blockSize)
+        : _randomCursor(std::move(randomCursor)),
+          _forwardCursor(std::move(forwardCursor)),
+          _blockSize(blockSize) {}
+
+    boost::optional<Record> next() final {
+        if (_remainingInBlock > 0) {
+            auto record = _forwardCursor->next();
+            if (record && !_wasReturned(record->id)) {
+                --_remainingInBlock;
+                _currentBlock->second = record->id;
+                return record;
+            }
+            _remainingInBlock = 0;
+        }
+
+        auto blockStart = _randomCursor->next();
+        if (!blockStart || _wasReturned(blockStart->id)) {
+            return blockStart;
+        }
+
+        // Position the forward cursor on the chosen record so that the rest of the block can be
+        // read from there. If the record cannot be found, return it as a block of one.
+        if (auto seeked = _forwardCursor->seekExact(blockStart->id)) {
+            _currentBlock = _returnedBlocks.emplace(seeked->id, seeked->id).first;
+            _remainingInBlock = _blockSize - 1;
+            return seeked;
+        }
+        _returnedBlocks.emplace(blockStart->id, blockStart->id);
+        return blockStart;
+    }
+
+    void save() final {
+        _randomCursor->save();
+        _forwardCursor->save();
+    }
+
+    bool restore() final {
+        const bool randomCursorRestored = _randomCursor->restore();
+        const bool forwardCursorRestored = _forwardCursor->restore();
+        return randomCursorRestored && forwardCursorRestored;
+    }
+
+    void detachFromOperationContext() final {
+        _randomCursor->detachFromOperationContext();
+        _forwardCursor->detachFromOperationContext();
+    }
+
+    void reattachToOperationContext(OperationContext* opCtx) final {
+        _randomCursor->reattachToOperationContext(opCtx);
+        _forwardCursor->reattachToOperationContext(opCtx);
+    }
+
+private:
+    using BlockMap = std::map<RecordId, RecordId>;
+
+    /**
+     * Returns true if 'id' lies within a block which this cursor has already returned.
+     */
+    bool _wasReturned(const RecordId& id) const {
+        auto it = _returnedBlocks.upper_bound(id);
+        if (it == _returnedBlocks.begin()) {
+            return false;
+        }
+        --it;
+        return id <= it->second;
+    }
+
+    std::unique_ptr<RecordCursor> _randomCursor;
+    std::unique_ptr<SeekableRecordCursor> _forwardCursor;
+    const long long _blockSize;
+
+    // The first and last RecordId of each block returned so far. Holds one entry per random seek,
+    // rather than one per returned record.
+    BlockMap _returnedBlocks;
+
+    // The block being read, and how many more records it may hold.
+    BlockMap::iterator _currentBlock;
+    long long _remainingInBlock = 0;
+};
+
 /**
  * Returns a PlanExecutor which uses a random cursor to sample documents if successful. Returns {}
  * if the storage engine doesn't support random cursors, or if 'sampleSize' is a large enough
@@ -112,6 +208,14 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> createRandomCursorEx
         return {nullptr};
     }
 
+    // If enabled, a large sample reads blocks of neighbouring records rather than making a random
+    // seek for every document.
+    const long long blockSize = internalDocumentSourceSampleBlockSize.load();
+    if (blockSize > 1 && sampleSize >= internalDocumentSourceSampleMinSizeForBlockSampling.load()) {
+        rsRandCursor = stdx::make_unique<BlockSamplingCursor>(
+            std::move(rsRandCursor), collection->getRecordStore()->getCursor(opCtx), blockSize);
+    }
+
     auto ws = stdx::make_unique<WorkingSet>();
     auto stage = stdx::make_unique<MultiIteratorStage>(opCtx, ws.get(), collection);
     stage->addIterator(std::move(rsRandCursor));
@@ -195,6 +299,31 @@ BSONObj removeSortKeyMetaProjection(BSONObj projectionObj) {
     return projectionObj.removeField(Document::metaFieldSortKey);
 }
 
+/**
+ * Makes the FETCH stages at the top of the plan rooted at 'root' return only the top-level fields
+ * 'fieldNames', provided that no stage between them and the root looks at the documents.
+ */
+void pushDownFieldsToReturn(PlanStage* root, const std::set<std::string>& fieldNames) {
+    switch (root->stageType()) {
+        case STAGE_FETCH:
+            static_cast<FetchStage*>(root)->setFieldsToReturn(fieldNames);
+            return;
+        case STAGE_CACHED_PLAN:
+        case STAGE_LIMIT:
+        case STAGE_MULTI_PLAN:
+        case STAGE_OR:
+        case STAGE_SKIP:
+        case STAGE_SUBPLAN:
+            for (auto&& child : root->getChildren()) {
+                pushDownFieldsToReturn(child.get(), fieldNames);
+            }
+            return;
+        default:
+            // Stages such as SHARDING_FILTER or TEXT_MATCH need fields the pipeline may not.
+            return;
+    }
+}
+
 /**
  * Examines the indexes in 'collection' and returns the field name of a geo-indexed field suitable
  * for use in $geoNear. 2d indexes are given priority over 2dsphere indexes.
@@ -364,6 +493,18 @@ void PipelineD::prepareGenericCursorSource(Collection* collection,
         }
     }
 
+    // If the query system could not cover the projection, the documents will be fetched in full.
+    // Trim them to the fields the pipeline needs as they are fetched, rather than once they reach
+    // the pipeline, so that the plan and its yields only ever hold on to those fields.
+    if (projForQuery.isEmpty() && !deps.needWholeDocument && !deps.getNeedsAnyMetadata() &&
+        !deps.fields.empty() && internalQueryExecProjectFetchedDocumentsToDependencies.load()) {
+        std::set<std::string> topLevelFields;
+        for (auto&& field : deps.fields) {
+            topLevelFields.insert(field.substr(0, field.find('.')));
+        }
+        pushDownFieldsToReturn(exec->getRootStage(), topLevelFields);
+    }
+
     addCursorSource(pipeline,
                     DocumentSourceCursor::create(collection, std::move(exec), expCtx),
                     deps,
@@ -2222,6 +2222,24 @@ TEST_F(PipelineMustRunOnMongoSTest, UnsplittableMongoSPipelineAssertsIfDisallowe
         pipeline->requiredToRunOnMongos(), AssertionException, ErrorCodes::IllegalOperation);
 }
 
+TEST_F(PipelineMustRunOnMongoSTest, UnsplittableMongoSPipelineCanSpillWithTempDir) {
+    auto expCtx = getExpCtx();
+
+    expCtx->allowDiskUse = true;
+    expCtx->inMongos = true;
+    expCtx->tempDir = "/tmp/mongos_spill";
+
+    auto match = DocumentSourceMatch::create(fromjson("{x: 5}"), expCtx);
+    auto runOnMongoS = DocumentSourceMustRunOnMongoS::create();
+    auto sort = DocumentSourceSort::create(expCtx, fromjson("{x: 1}"));
+
+    auto pipeline = uassertStatusOK(Pipeline::create({match, runOnMongoS, sort}, expCtx));
+    pipeline->optimizePipeline();
+
+    // With a temporary directory to spill to, $sort may run on mongoS even with 'allowDiskUse'.
+    ASSERT_TRUE(pipeline->requiredToRunOnMongos());
+}
+
 DEATH_TEST_F(PipelineMustRunOnMongoSTest,
              SplittablePipelineMustMergeOnMongoSAfterSplit,
              "invariant") {
@@ -168,6 +168,15 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    std::vector<BSONObj> getMatchingPlanCachePartitionStats(
+        OperationContext*, const NamespaceString&, const MatchExpression*) const override {
+        MONGO_UNREACHABLE;
+    }
+
+    std::vector<BSONObj> getQueryStats(OperationContext*, const NamespaceString&) const override {
+        MONGO_UNREACHABLE;
+    }
+
     bool uniqueKeyIsSupportedByIndex(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                      const NamespaceString& nss,
                                      const std::set<FieldPath>& uniqueKeyPaths) const override {
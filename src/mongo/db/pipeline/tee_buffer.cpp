@@ -32,6 +32,7 @@
 
 #include <algorithm>
 
+#include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/document.h"
 
 namespace mongo {
@@ -49,6 +50,10 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(size_t nConsumers, int bufferS
 }
 
 DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
+    if (_concurrent) {
+        return getNextConcurrent(consumerId);
+    }
+
     size_t nConsumersStillProcessingThisBatch =
         std::count_if(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
             return info.nLeftToReturn > 0;
@@ -75,14 +80,122 @@ DocumentSource::GetNextResult TeeBuffer::getNext(size_t consumerId) {
     return _buffer[bufferIndex];
 }
 
+DocumentSource::GetNextResult TeeBuffer::getNextConcurrent(size_t consumerId) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto& consumer = _consumers[consumerId];
+    if (consumer.nLeftToReturn == 0) {
+        return (_exhausted || _cancelled) ? DocumentSource::GetNextResult::makeEOF()
+                                          : DocumentSource::GetNextResult::makePauseExecution();
+    }
+
+    const size_t bufferIndex = _buffer.size() - consumer.nLeftToReturn;
+    if (--consumer.nLeftToReturn == 0) {
+        _batchConsumed.notify_all();
+    }
+
+    return _buffer[bufferIndex];
+}
+
+void TeeBuffer::beginConcurrentConsumption() {
+    invariant(!_concurrent);
+    invariant(std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+        return info.nLeftToReturn > 0;
+    }));
+    _concurrent = true;
+    _exhausted = false;
+    _cancelled = false;
+}
+
+bool TeeBuffer::loadNextBatchWhenConsumed(OperationContext* opCtx) {
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        opCtx->waitForConditionOrInterrupt(_batchConsumed, lk, [&] {
+            return _cancelled ||
+                std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+                       return info.nLeftToReturn > 0;
+                   });
+        });
+        if (_cancelled || _exhausted ||
+            std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+                return info.stillInUse;
+            })) {
+            return false;
+        }
+    }
+
+    // No consumer touches the buffer until the next batch is published, so the source can be read
+    // without holding the mutex.
+    auto batch = readNextBatch();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _buffer = std::move(batch);
+    _exhausted = _buffer.empty();
+    for (auto&& consumer : _consumers) {
+        if (consumer.stillInUse && !_cancelled) {
+            consumer.nLeftToReturn = _buffer.size();
+        }
+    }
+    ++_generation;
+    _batchLoaded.notify_all();
+    return !_exhausted && !_cancelled;
+}
+
+uint64_t TeeBuffer::waitForBatchAfter(OperationContext* opCtx, uint64_t generation) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    opCtx->waitForConditionOrInterrupt(
+        _batchLoaded, lk, [&] { return _cancelled || _exhausted || _generation > generation; });
+    return _generation;
+}
+
+void TeeBuffer::cancelConcurrentConsumption() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _cancelled = true;
+    for (auto&& consumer : _consumers) {
+        consumer.nLeftToReturn = 0;
+    }
+    _batchConsumed.notify_all();
+    _batchLoaded.notify_all();
+}
+
+void TeeBuffer::endConcurrentConsumption() {
+    invariant(_concurrent);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _concurrent = false;
+        for (auto&& consumer : _consumers) {
+            consumer.nLeftToReturn = 0;
+        }
+    }
+
+    if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
+            return info.stillInUse;
+        })) {
+        _buffer.clear();
+        if (_source) {
+            _source->dispose();
+        }
+    }
+}
+
 void TeeBuffer::loadNextBatch() {
-    _buffer.clear();
+    _buffer = readNextBatch();
+
+    // Populate the pending returns.
+    for (size_t consumerId = 0; consumerId < _consumers.size(); ++consumerId) {
+        if (_consumers[consumerId].stillInUse) {
+            _consumers[consumerId].nLeftToReturn = _buffer.size();
+        }
+    }
+}
+
+std::vector<DocumentSource::GetNextResult> TeeBuffer::readNextBatch() {
+    std::vector<DocumentSource::GetNextResult> batch;
     size_t bytesInBuffer = 0;
 
     auto input = _source->getNext();
     for (; input.isAdvanced(); input = _source->getNext()) {
         bytesInBuffer += input.getDocument().getApproximateSize();
-        _buffer.push_back(std::move(input));
+        batch.push_back(std::move(input));
 
         if (bytesInBuffer >= _bufferSizeBytes) {
             break;  // Need to break here so we don't get the next input and accidentally ignore it.
@@ -95,12 +208,7 @@ void TeeBuffer::loadNextBatch() {
     //   - We currently disallow nested $facet stages.
     invariant(!input.isPaused());
 
-    // Populate the pending returns.
-    for (size_t consumerId = 0; consumerId < _consumers.size(); ++consumerId) {
-        if (_consumers[consumerId].stillInUse) {
-            _consumers[consumerId].nLeftToReturn = _buffer.size();
-        }
-    }
+    return batch;
 }
 
 }  // namespace mongo
@@ -35,15 +35,23 @@
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
 
+class OperationContext;
+
 /**
  * This stage takes a stream of input documents and makes them available to multiple consumers. To
  * do so, it will batch incoming documents and allow each consumer to consume one batch at a time.
  * As a consequence, consumers must be able to pause their execution to allow other consumers to
  * process the batch before moving to the next batch.
+ *
+ * By default the consumers are driven one after another by the thread which owns the source. After
+ * beginConcurrentConsumption() they may instead run on other threads, while the owning thread
+ * loads each batch once every consumer has finished the previous one.
  */
 class TeeBuffer : public RefCountable {
 public:
@@ -63,6 +71,16 @@ public:
      * consumer will not consume all input.
      */
     void dispose(size_t consumerId) {
+        if (_concurrent) {
+            // The source belongs to another thread, it is disposed of by
+            // endConcurrentConsumption() instead.
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _consumers[consumerId].stillInUse = false;
+            _consumers[consumerId].nLeftToReturn = 0;
+            _batchConsumed.notify_all();
+            return;
+        }
+
         _consumers[consumerId].stillInUse = false;
         _consumers[consumerId].nLeftToReturn = 0;
         if (std::none_of(_consumers.begin(), _consumers.end(), [](const ConsumerInfo& info) {
@@ -82,6 +100,40 @@ public:
      */
     DocumentSource::GetNextResult getNext(size_t consumerId);
 
+    /**
+     * Allows the consumers to run on threads other than the one owning the source. From then on,
+     * getNext() never reads from the source: a consumer which has reached the end of the current
+     * batch is paused until the owning thread calls loadNextBatchWhenConsumed(), which consumers
+     * can wait for with waitForBatchAfter().
+     */
+    void beginConcurrentConsumption();
+
+    /**
+     * Waits until every consumer still in use has consumed the current batch, then loads the next
+     * one. Returns false once the input is exhausted, once no consumer is in use anymore, or once
+     * consumption has been cancelled. Throws if 'opCtx' is interrupted while waiting.
+     */
+    bool loadNextBatchWhenConsumed(OperationContext* opCtx);
+
+    /**
+     * Blocks until a batch newer than the one numbered 'generation' has been loaded, the input is
+     * exhausted, or consumption has been cancelled. Returns the number of the current batch. Throws
+     * if 'opCtx' is interrupted while waiting.
+     */
+    uint64_t waitForBatchAfter(OperationContext* opCtx, uint64_t generation);
+
+    /**
+     * Makes every consumer reach EOF and wakes up all threads waiting on this buffer.
+     */
+    void cancelConcurrentConsumption();
+
+    /**
+     * Returns to driving the consumers from the thread owning the source, disposing of the source
+     * if no consumer is in use anymore. Must be called by that thread once no consumer runs
+     * concurrently.
+     */
+    void endConcurrentConsumption();
+
 private:
     TeeBuffer(size_t nConsumers, size_t bufferSizeBytes);
 
@@ -92,6 +144,14 @@ private:
      */
     void loadNextBatch();
 
+    /**
+     * Requests results from '_source' until more than '_bufferSizeBytes' of documents have been
+     * returned, or until '_source' is exhausted, and returns them.
+     */
+    std::vector<DocumentSource::GetNextResult> readNextBatch();
+
+    DocumentSource::GetNextResult getNextConcurrent(size_t consumerId);
+
     DocumentSource* _source = nullptr;
 
     const size_t _bufferSizeBytes;
@@ -102,5 +162,14 @@ private:
         int nLeftToReturn = 0;
     };
     std::vector<ConsumerInfo> _consumers;
+
+    // Protects the buffer and the consumers while they run concurrently.
+    bool _concurrent = false;
+    stdx::mutex _mutex;
+    stdx::condition_variable _batchConsumed;
+    stdx::condition_variable _batchLoaded;
+    uint64_t _generation = 0;
+    bool _exhausted = false;
+    bool _cancelled = false;
 };
 }  // namespace mongo
@@ -33,6 +33,7 @@
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/document_source_mock.h"
 #include "mongo/db/pipeline/document_value_test_util.h"
+#include "mongo/db/query/query_test_service_context.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 
@@ -166,5 +167,53 @@ TEST(TeeBufferTest, ShouldAllowOtherConsumersToAdvanceOnceTrailingConsumerIsDisp
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
     ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
 }
+
+TEST(TeeBufferTest, ConcurrentConsumersShouldNotReadFromTheSource) {
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"a", 1}}};
+    auto mock = DocumentSourceMock::create(inputs);
+
+    auto teeBuffer = TeeBuffer::create(2);
+    teeBuffer->setSource(mock.get());
+    teeBuffer->beginConcurrentConsumption();
+
+    // No batch has been loaded by the thread owning the source yet.
+    ASSERT_TRUE(teeBuffer->getNext(0).isPaused());
+    ASSERT_TRUE(teeBuffer->getNext(1).isPaused());
+    ASSERT_EQ(mock->queue.size(), 1UL);
+
+    teeBuffer->cancelConcurrentConsumption();
+    ASSERT_TRUE(teeBuffer->getNext(0).isEOF());
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    ASSERT_EQ(teeBuffer->waitForBatchAfter(opCtx.get(), 0), 0UL);
+
+    // The source is only disposed of once the consumers are disposed.
+    teeBuffer->dispose(0);
+    teeBuffer->dispose(1);
+    ASSERT_FALSE(mock->isDisposed);
+    teeBuffer->endConcurrentConsumption();
+    ASSERT_TRUE(mock->isDisposed);
+}
+
+TEST(TeeBufferTest, WaitingForConcurrentBatchShouldBeInterruptible) {
+    std::deque<DocumentSource::GetNextResult> inputs{Document{{"a", 1}}};
+    auto mock = DocumentSourceMock::create(inputs);
+
+    auto teeBuffer = TeeBuffer::create(1);
+    teeBuffer->setSource(mock.get());
+    teeBuffer->beginConcurrentConsumption();
+
+    // No batch will ever be loaded, so only the interrupt can end the wait.
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+    opCtx->markKilled(ErrorCodes::Interrupted);
+    ASSERT_THROWS_CODE(
+        teeBuffer->waitForBatchAfter(opCtx.get(), 0), AssertionException, ErrorCodes::Interrupted);
+
+    teeBuffer->cancelConcurrentConsumption();
+    teeBuffer->dispose(0);
+    teeBuffer->endConcurrentConsumption();
+    ASSERT_TRUE(mock->isDisposed);
+}
 }  // namespace
 }  // namespace mongo
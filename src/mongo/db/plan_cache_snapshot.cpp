@@ -0,0 +1,365 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/plan_cache_snapshot.h"
+
+#include <set>
+
+#include "mongo/base/counter.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_info_cache.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/util/background.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+const NamespaceString kPlanCacheSnapshotNamespace(NamespaceString::kConfigDb, "planCacheSnapshot");
+
+const char kNsField[] = "ns";
+const char kQueryField[] = "query";
+const char kSortField[] = "sort";
+const char kProjectionField[] = "projection";
+const char kCollationField[] = "collation";
+const char kWorksField[] = "works";
+const char kIndexesField[] = "indexes";
+const char kSnapshotTimeField[] = "snapshotTime";
+
+Counter64 planCacheSnapshotPasses;
+Counter64 planCacheSnapshotEntriesWritten;
+Counter64 planCacheSnapshotShapesRehydrated;
+
+ServerStatusMetricField<Counter64> planCacheSnapshotPassesDisplay("planCacheSnapshot.passes",
+                                                                  &planCacheSnapshotPasses);
+ServerStatusMetricField<Counter64> planCacheSnapshotEntriesWrittenDisplay(
+    "planCacheSnapshot.entriesWritten", &planCacheSnapshotEntriesWritten);
+ServerStatusMetricField<Counter64> planCacheSnapshotShapesRehydratedDisplay(
+    "planCacheSnapshot.shapesRehydrated", &planCacheSnapshotShapesRehydrated);
+
+MONGO_EXPORT_SERVER_PARAMETER(planCacheSnapshotEnabled, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(planCacheSnapshotIntervalSecs, int, 60)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0)
+            return Status(ErrorCodes::BadValue,
+                          "planCacheSnapshotIntervalSecs must be strictly positive");
+        return Status::OK();
+    });
+
+// When true, secondaries re-plan the new shapes found in the snapshot replicated from the primary,
+// so that their plan caches are already warm if they are elected.
+MONGO_EXPORT_SERVER_PARAMETER(planCacheSnapshotWarmSecondaries, bool, true);
+
+/**
+ * Appends the catalog names of every index referenced by 'tree' to 'indexNames'.
+ */
+void collectIndexNames(const PlanCacheIndexTree* tree, std::set<std::string>* indexNames) {
+    if (!tree) {
+        return;
+    }
+
+    if (tree->entry) {
+        indexNames->insert(tree->entry->identifier.catalogName);
+    }
+
+    for (auto&& child : tree->children) {
+        collectIndexNames(child, indexNames);
+    }
+}
+
+/**
+ * Builds the document persisted for 'entry', a plan cache entry on collection 'nss'.
+ */
+BSONObj makeSnapshotDocument(const NamespaceString& nss,
+                             const PlanCacheEntry& entry,
+                             Date_t snapshotTime) {
+    std::set<std::string> indexNames;
+    if (!entry.plannerData.empty()) {
+        collectIndexNames(entry.plannerData[0]->tree.get(), &indexNames);
+    }
+
+    BSONObjBuilder bob;
+    bob.append("_id",
+               BSON(kNsField << nss.ns() << "queryHash"
+                             << unsignedIntToFixedLengthHex(entry.queryHash)));
+    bob.append(kNsField, nss.ns());
+    bob.append(kQueryField, entry.query);
+    bob.append(kSortField, entry.sort);
+    bob.append(kProjectionField, entry.projection);
+    bob.append(kCollationField, entry.collation);
+    bob.append(kWorksField, static_cast<long long>(entry.works));
+    {
+        BSONArrayBuilder indexesBuilder(bob.subarrayStart(kIndexesField));
+        for (auto&& indexName : indexNames) {
+            indexesBuilder.append(indexName);
+        }
+    }
+    bob.append(kSnapshotTimeField, snapshotTime);
+    return bob.obj();
+}
+
+class PlanCacheSnapshotJob : public BackgroundJob {
+public:
+    std::string name() const override {
+        return "PlanCacheSnapshot";
+    }
+
+    void run() override {
+        Client::initThread(name().c_str());
+        ON_BLOCK_EXIT([] { Client::destroy(); });
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+        while (!globalInShutdownDeprecated()) {
+            {
+                MONGO_IDLE_THREAD_BLOCK;
+                sleepsecs(planCacheSnapshotIntervalSecs.load());
+            }
+
+            if (!planCacheSnapshotEnabled.load()) {
+                LOG(2) << "plan cache snapshots disabled";
+                continue;
+            }
+
+            try {
+                doPass();
+            } catch (const DBException& ex) {
+                warning() << "plan cache snapshot pass failed: " << redact(ex.toStatus());
+            }
+        }
+    }
+
+private:
+    void doPass() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext* opCtx = opCtxPtr.get();
+
+        auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+
+        // If part of replSet but not in a readable state (e.g. during initial sync), skip.
+        if (replCoord->getReplicationMode() == repl::ReplicationCoordinator::modeReplSet &&
+            !replCoord->getMemberState().readable())
+            return;
+
+        planCacheSnapshotPasses.increment();
+
+        const bool canWriteSnapshot =
+            replCoord->canAcceptWritesForDatabase(opCtx, NamespaceString::kConfigDb);
+
+        // The query shapes of the last snapshot are restored once after startup. A secondary keeps
+        // reading the snapshot in order to pick up the shapes newly published by its primary, but
+        // never re-plans a shape it has already restored.
+        if (!_rehydrated || (!canWriteSnapshot && planCacheSnapshotWarmSecondaries.load())) {
+            rehydrate(opCtx);
+            _rehydrated = true;
+        }
+
+        if (canWriteSnapshot) {
+            writeSnapshot(opCtx);
+        }
+    }
+
+    /**
+     * Persists the active entries of every collection's plan cache, replacing the documents
+     * written by the previous pass.
+     */
+    void writeSnapshot(OperationContext* opCtx) {
+        const Date_t snapshotTime = Date_t::now();
+
+        std::vector<std::string> dbNames;
+        opCtx->getServiceContext()->getStorageEngine()->listDatabases(&dbNames);
+
+        DBDirectClient client(opCtx);
+        for (auto&& dbName : dbNames) {
+            if (dbName == NamespaceString::kLocalDb) {
+                continue;
+            }
+
+            std::vector<NamespaceString> namespaces;
+            {
+                AutoGetDb autoDb(opCtx, dbName, MODE_IS);
+                Database* db = autoDb.getDb();
+                if (!db) {
+                    continue;
+                }
+                for (auto&& collection : *db) {
+                    if (collection->ns() != kPlanCacheSnapshotNamespace) {
+                        namespaces.push_back(collection->ns());
+                    }
+                }
+            }
+
+            for (auto&& nss : namespaces) {
+                std::vector<BSONObj> docs;
+                {
+                    AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+                    Collection* collection = autoColl.getCollection();
+                    if (!collection) {
+                        continue;
+                    }
+
+                    PlanCache* planCache = collection->infoCache()->getPlanCache();
+                    for (auto&& entry : planCache->getAllEntries()) {
+                        // Inactive entries have not yet been vetted and are not worth restoring.
+                        if (entry->isActive) {
+                            docs.push_back(makeSnapshotDocument(nss, *entry, snapshotTime));
+                        }
+                    }
+                }
+
+                client.remove(kPlanCacheSnapshotNamespace.ns(), BSON(kNsField << nss.ns()));
+                if (!docs.empty()) {
+                    client.insert(kPlanCacheSnapshotNamespace.ns(), docs);
+                    planCacheSnapshotEntriesWritten.increment(docs.size());
+                }
+            }
+        }
+
+        // Clear out the documents of collections which were dropped since the previous pass.
+        client.remove(kPlanCacheSnapshotNamespace.ns(),
+                      BSON(kSnapshotTimeField << BSON("$lt" << snapshotTime)));
+    }
+
+    /**
+     * Re-plans every query shape found in the snapshot which was not restored by an earlier pass.
+     * The plans themselves are not persisted: planning the shape again against the current catalog
+     * and data means a restored entry can never refer to an index which has since been dropped,
+     * and goes through the same vetting as any other plan cache entry.
+     */
+    void rehydrate(OperationContext* opCtx) {
+        DBDirectClient client(opCtx);
+        auto cursor = client.query(kPlanCacheSnapshotNamespace, Query());
+        if (!cursor) {
+            return;
+        }
+
+        while (cursor->more()) {
+            BSONObj doc = cursor->nextSafe().getOwned();
+
+            // Each shape is restored at most once: from then on its plan cache entry is maintained
+            // by the queries run against this node, like any other entry.
+            if (!_restoredShapes.insert(doc["_id"].wrap()).second) {
+                continue;
+            }
+
+            Status status = rehydrateShape(opCtx, doc);
+            if (!status.isOK()) {
+                LOG(1) << "unable to restore plan cache entry " << redact(doc) << ": "
+                       << redact(status);
+            }
+        }
+    }
+
+    Status rehydrateShape(OperationContext* opCtx, const BSONObj& doc) {
+        const NamespaceString nss(doc.getStringField(kNsField));
+        if (!nss.isValid()) {
+            return {ErrorCodes::InvalidNamespace,
+                    str::stream() << "invalid namespace in plan cache snapshot: " << nss.ns()};
+        }
+
+        AutoGetCollection autoColl(opCtx, nss, MODE_IS);
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return Status::OK();
+        }
+
+        // A new plan cache entry starts out inactive and is only activated when the shape is
+        // planned a second time with no more works, so plan the shape at most twice.
+        for (int attempt = 0; attempt < 2; ++attempt) {
+            auto qr = stdx::make_unique<QueryRequest>(nss);
+            qr->setFilter(doc.getObjectField(kQueryField).getOwned());
+            qr->setSort(doc.getObjectField(kSortField).getOwned());
+            qr->setProj(doc.getObjectField(kProjectionField).getOwned());
+            qr->setCollation(doc.getObjectField(kCollationField).getOwned());
+
+            const ExtensionsCallbackReal extensionsCallback(opCtx, &nss);
+            auto statusWithCQ =
+                CanonicalQuery::canonicalize(opCtx,
+                                             std::move(qr),
+                                             nullptr,
+                                             extensionsCallback,
+                                             MatchExpressionParser::kAllowAllSpecialFeatures);
+            if (!statusWithCQ.isOK()) {
+                return statusWithCQ.getStatus();
+            }
+            std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
+
+            PlanCache* planCache = collection->infoCache()->getPlanCache();
+            if (planCache->get(*cq).state == PlanCache::CacheEntryState::kPresentActive) {
+                return Status::OK();
+            }
+
+            // Building the executor runs the trial period which (re)creates the cache entry.
+            auto statusWithExec = getExecutorFind(opCtx, collection, nss, std::move(cq));
+            if (!statusWithExec.isOK()) {
+                return statusWithExec.getStatus();
+            }
+        }
+
+        planCacheSnapshotShapesRehydrated.increment();
+        return Status::OK();
+    }
+
+    bool _rehydrated = false;
+
+    // The '_id' of every snapshot document whose shape has already been restored.
+    BSONObjSet _restoredShapes = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+};
+
+}  // namespace
+
+void startPlanCacheSnapshotJob() {
+    auto job = new PlanCacheSnapshotJob();
+    job->go();
+}
+
+}  // namespace mongo
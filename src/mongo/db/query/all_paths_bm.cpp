@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/index/all_paths_key_generator.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_test_service_context.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// Builds a document with 'numFields' top-level subdocuments, each holding a scalar and an array.
+BSONObj makeDocument(int numFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < numFields; ++i) {
+        const std::string fieldName = str::stream() << "field" << i;
+        bob.append(fieldName,
+                   BSON("scalar" << i << "nested" << BSON("value" << i) << "array"
+                                 << BSON_ARRAY(i << i + 1 << BSON("inner" << i))));
+    }
+    return bob.obj();
+}
+
+// Generates the $** index keys for a document with 'state.range(0)' top-level fields.
+void BM_AllPathsKeyGeneration(benchmark::State& state) {
+    AllPathsKeyGenerator keyGen(BSON("$**" << 1), BSONObj(), nullptr);
+    BSONObj doc = makeDocument(state.range(0));
+
+    for (auto keepRunning : state) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        BSONObjSet multikeyPaths = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        keyGen.generateKeys(doc, &keys, &multikeyPaths);
+        benchmark::DoNotOptimize(keys);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_AllPathsKeyGeneration)->Arg(1)->Arg(10)->Arg(100);
+
+// Plans a two-predicate query against a $** index which has 'state.range(0)' multikey paths.
+void BM_AllPathsPlan(benchmark::State& state) {
+    QueryTestServiceContext serviceContext;
+    auto opCtx = serviceContext.makeOperationContext();
+
+    std::set<FieldRef> multikeyPathSet;
+    for (int i = 0; i < state.range(0); ++i) {
+        multikeyPathSet.emplace(std::string(str::stream() << "field" << i << ".array"));
+    }
+
+    QueryPlannerParams params;
+    params.indices.push_back(IndexEntry{BSON("$**" << 1),
+                                        IndexType::INDEX_ALLPATHS,
+                                        !multikeyPathSet.empty(),
+                                        {},  // multikeyPaths
+                                        std::move(multikeyPathSet),
+                                        false,  // sparse
+                                        false,  // unique
+                                        IndexEntry::Identifier{"$**_1"},
+                                        nullptr,  // filterExpr
+                                        BSON("wildcardProjection" << BSONObj()),
+                                        nullptr});  // collator
+
+    const BSONObj filter = fromjson("{'field0.array': {$gt: 5}, 'field1.scalar': 3}");
+    const boost::intrusive_ptr<ExpressionContext> expCtx;
+
+    for (auto keepRunning : state) {
+        auto qr = stdx::make_unique<QueryRequest>(NamespaceString("test.coll"));
+        qr->setFilter(filter);
+        auto cq = uassertStatusOK(
+            CanonicalQuery::canonicalize(opCtx.get(),
+                                         std::move(qr),
+                                         expCtx,
+                                         ExtensionsCallbackNoop(),
+                                         MatchExpressionParser::kAllowAllSpecialFeatures));
+        benchmark::DoNotOptimize(uassertStatusOK(QueryPlanner::plan(*cq, params)));
+    }
+}
+
+BENCHMARK(BM_AllPathsPlan)->Arg(0)->Arg(10)->Arg(1000);
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collation/collator_interface_caching.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+const size_t CollatorInterfaceCaching::kMaxCachedStringSize = 256;
+const size_t CollatorInterfaceCaching::kMaxCachedBytes = 1024 * 1024;
+
+CollatorInterfaceCaching::CollatorInterfaceCaching(const CollatorInterface* underlying)
+    : CollatorInterface(underlying->getSpec()), _underlying(underlying) {
+    invariant(_underlying);
+}
+
+std::unique_ptr<CollatorInterface> CollatorInterfaceCaching::clone() const {
+    return _underlying->clone();
+}
+
+int CollatorInterfaceCaching::compare(StringData left, StringData right) const {
+    // Strings which are binary equal are equal under every collation.
+    if (left == right) {
+        return 0;
+    }
+
+    // Caching the right key may rehash the cache and move the left key, so the left key is looked
+    // up again once both are cached.
+    const std::string* rightKey = nullptr;
+    if (!getCachedKey(left) || !(rightKey = getCachedKey(right))) {
+        return _underlying->compare(left, right);
+    }
+
+    return getCachedKey(left)->compare(*rightKey);
+}
+
+CollatorInterface::ComparisonKey CollatorInterfaceCaching::getComparisonKey(
+    StringData stringData) const {
+    if (auto cachedKey = getCachedKey(stringData)) {
+        return makeComparisonKey(*cachedKey);
+    }
+    return _underlying->getComparisonKey(stringData);
+}
+
+const std::string* CollatorInterfaceCaching::getCachedKey(StringData stringData) const {
+    auto it = _cache.find(stringData);
+    if (it != _cache.end()) {
+        return &it->second;
+    }
+
+    if (stringData.size() > kMaxCachedStringSize || _cachedBytes >= kMaxCachedBytes) {
+        return nullptr;
+    }
+
+    auto key = _underlying->getComparisonKey(stringData).getKeyData().toString();
+    _cachedBytes += stringData.size() + key.size();
+    return &_cache.try_emplace(stringData, std::move(key)).first->second;
+}
+
+}  // namespace mongo
@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * A CollatorInterface which remembers the comparison keys that another collator produced, so that
+ * a string which is seen repeatedly is only handed to the underlying collator once. Comparisons
+ * between strings whose comparison keys are cached are a lexicographic comparison of the keys.
+ * This makes sorting and key generation on low-cardinality string fields under a non-simple
+ * collation cost close to the same work under the simple collation.
+ *
+ * The cache is bounded, and strings that do not fit in it are delegated to the underlying
+ * collator on every call.
+ *
+ * Unlike other CollatorInterface implementations, this class is NOT thread-safe. It is meant to be
+ * owned by a single operation, for example by the SortKeyGenerator of one query.
+ */
+class CollatorInterfaceCaching final : public CollatorInterface {
+public:
+    // Strings longer than this many bytes are never cached.
+    static const size_t kMaxCachedStringSize;
+
+    // The maximum combined size, in bytes, of the strings and comparison keys in the cache.
+    static const size_t kMaxCachedBytes;
+
+    /**
+     * Constructs a collator with the same semantics as 'underlying'. Does not take ownership of
+     * 'underlying', which must outlive this collator.
+     */
+    explicit CollatorInterfaceCaching(const CollatorInterface* underlying);
+
+    /**
+     * Returns a clone of the underlying collator. The cache is not carried over.
+     */
+    std::unique_ptr<CollatorInterface> clone() const final;
+
+    int compare(StringData left, StringData right) const final;
+
+    ComparisonKey getComparisonKey(StringData stringData) const final;
+
+    const CollatorInterface* getUnderlying() const {
+        return _underlying;
+    }
+
+    /**
+     * Returns the number of strings whose comparison keys are cached.
+     */
+    size_t numCachedKeys() const {
+        return _cache.size();
+    }
+
+private:
+    /**
+     * Returns the cached comparison key for 'stringData', computing and caching it if there is
+     * room. Returns nullptr if 'stringData' is not cached and cannot be. The returned pointer is
+     * invalidated by the next call which adds a key to the cache.
+     */
+    const std::string* getCachedKey(StringData stringData) const;
+
+    const CollatorInterface* const _underlying;
+
+    // Maps strings to the bytes of their comparison keys.
+    mutable StringMap<std::string> _cache;
+
+    // The combined size of the strings and comparison keys in '_cache'.
+    mutable size_t _cachedBytes = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collation/collator_interface_caching.h"
+
+#include <string>
+
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+TEST(CollatorInterfaceCachingTest, HasSameSemanticsAsUnderlyingCollator) {
+    CollatorInterfaceMock reverseMock(CollatorInterfaceMock::MockType::kReverseString);
+    CollatorInterfaceCaching caching(&reverseMock);
+    ASSERT(caching == reverseMock);
+    ASSERT(*caching.clone() == reverseMock);
+}
+
+TEST(CollatorInterfaceCachingTest, ComparesLikeUnderlyingCollator) {
+    CollatorInterfaceMock reverseMock(CollatorInterfaceMock::MockType::kReverseString);
+    CollatorInterfaceCaching caching(&reverseMock);
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_LT(caching.compare("ba", "ab"), 0);
+        ASSERT_GT(caching.compare("ab", "ba"), 0);
+        ASSERT_EQ(caching.compare("abc", "abc"), 0);
+    }
+    ASSERT_EQ(caching.numCachedKeys(), 2U);
+}
+
+TEST(CollatorInterfaceCachingTest, TreatsStringsEqualUnderCollationAsEqual) {
+    CollatorInterfaceMock alwaysEqualMock(CollatorInterfaceMock::MockType::kAlwaysEqual);
+    CollatorInterfaceCaching caching(&alwaysEqualMock);
+    ASSERT_EQ(caching.compare("foo", "bar"), 0);
+    ASSERT_EQ(caching.getComparisonKey("foo").getKeyData(),
+              caching.getComparisonKey("bar").getKeyData());
+}
+
+TEST(CollatorInterfaceCachingTest, ReturnsSameComparisonKeysAsUnderlyingCollator) {
+    CollatorInterfaceMock toLowerMock(CollatorInterfaceMock::MockType::kToLowerString);
+    CollatorInterfaceCaching caching(&toLowerMock);
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(caching.getComparisonKey("FooBar").getKeyData(),
+                  toLowerMock.getComparisonKey("FooBar").getKeyData());
+    }
+    ASSERT_EQ(caching.numCachedKeys(), 1U);
+}
+
+TEST(CollatorInterfaceCachingTest, DoesNotCacheLongStrings) {
+    CollatorInterfaceMock reverseMock(CollatorInterfaceMock::MockType::kReverseString);
+    CollatorInterfaceCaching caching(&reverseMock);
+    std::string longString(CollatorInterfaceCaching::kMaxCachedStringSize + 1, 'a');
+    std::string longerString(CollatorInterfaceCaching::kMaxCachedStringSize + 2, 'a');
+    ASSERT_LT(caching.compare(longString, longerString), 0);
+    ASSERT_EQ(caching.getComparisonKey(longString).getKeyData(),
+              reverseMock.getComparisonKey(longString).getKeyData());
+    ASSERT_EQ(caching.numCachedKeys(), 0U);
+}
+
+TEST(CollatorInterfaceCachingTest, StopsCachingOnceFull) {
+    CollatorInterfaceMock reverseMock(CollatorInterfaceMock::MockType::kReverseString);
+    CollatorInterfaceCaching caching(&reverseMock);
+    std::string str(CollatorInterfaceCaching::kMaxCachedStringSize, 'a');
+    // The key of each string is the reversed string, so each entry takes twice the string size.
+    const size_t entrySize = 2 * str.size();
+    const size_t maxKeys = (CollatorInterfaceCaching::kMaxCachedBytes + entrySize - 1) / entrySize;
+    for (size_t i = 0; i < maxKeys + 10; ++i) {
+        str.back() = 'a' + (i % 26);
+        str[str.size() - 2] = 'a' + (i / 26 % 26);
+        str[str.size() - 3] = 'a' + (i / 26 / 26 % 26);
+        caching.getComparisonKey(str);
+    }
+    ASSERT_EQ(caching.numCachedKeys(), maxKeys);
+
+    // Strings which did not fit in the cache still get the right comparison key.
+    ASSERT_EQ(caching.getComparisonKey(str).getKeyData(),
+              reverseMock.getComparisonKey(str).getKeyData());
+}
+
+}  // namespace
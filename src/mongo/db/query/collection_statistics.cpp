@@ -0,0 +1,254 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/bson/dotted_path_support.h"
+
+namespace mongo {
+
+namespace dps = ::mongo::dotted_path_support;
+
+namespace {
+
+bool elementLessThan(const BSONElement& lhs, const BSONElement& rhs) {
+    return lhs.woCompare(rhs, false) < 0;
+}
+
+/**
+ * Returns true if 'value' lies between 'low' and 'high'.
+ */
+bool isBetween(const BSONElement& value,
+               const BSONElement& low,
+               bool lowInclusive,
+               const BSONElement& high,
+               bool highInclusive) {
+    const int cmpLow = value.woCompare(low, false);
+    const int cmpHigh = value.woCompare(high, false);
+    return (cmpLow > 0 || (cmpLow == 0 && lowInclusive)) &&
+        (cmpHigh < 0 || (cmpHigh == 0 && highInclusive));
+}
+
+}  // namespace
+
+//
+// FieldStatistics
+//
+
+FieldStatistics FieldStatistics::build(const std::vector<BSONObj>& sample,
+                                       StringData path,
+                                       long long numRecords,
+                                       size_t numBuckets) {
+    invariant(numBuckets > 0);
+
+    FieldStatistics stats;
+    stats._sampleSize = sample.size();
+    if (sample.empty()) {
+        return stats;
+    }
+
+    // The elements point into the documents of 'sample', which outlive them.
+    std::vector<BSONElement> values;
+    long long numNull = 0;
+    for (auto&& doc : sample) {
+        BSONElementSet elements;
+        dps::extractAllElementsAlongPath(doc, path, elements);
+
+        bool hasValue = false;
+        for (auto&& elem : elements) {
+            if (elem.isNull() || elem.type() == BSONType::Undefined) {
+                continue;
+            }
+            values.push_back(elem);
+            hasValue = true;
+        }
+        if (!hasValue) {
+            ++numNull;
+        }
+    }
+
+    stats._nullFraction = static_cast<double>(numNull) / sample.size();
+    if (values.empty()) {
+        return stats;
+    }
+
+    std::sort(values.begin(), values.end(), elementLessThan);
+
+    // Count the distinct sampled values, and how many of them were sampled exactly once.
+    double numDistinct = 0;
+    double numSingletons = 0;
+    for (size_t i = 0; i < values.size();) {
+        size_t j = i + 1;
+        while (j < values.size() && values[i].woCompare(values[j], false) == 0) {
+            ++j;
+        }
+        ++numDistinct;
+        if (j - i == 1) {
+            ++numSingletons;
+        }
+        i = j;
+    }
+
+    // Scale the number of distinct values up to the whole collection with the Duj1 estimator of
+    // Haas and Stokes. Values which were sampled only once suggest that there are many more which
+    // were not sampled at all. When the sample covers the whole collection this yields
+    // 'numDistinct'.
+    const double numSampledValues = values.size();
+    const double numValues = numSampledValues *
+        std::max(static_cast<double>(numRecords), static_cast<double>(sample.size())) /
+        sample.size();
+    stats._distinctValues = numSampledValues * numDistinct /
+        (numSampledValues - numSingletons + numSingletons * numSampledValues / numValues);
+
+    const size_t histogramBuckets = std::min(numBuckets, values.size());
+    BSONArrayBuilder bounds;
+    bounds.append(values.front());
+    for (size_t bucket = 1; bucket <= histogramBuckets; ++bucket) {
+        bounds.append(values[(bucket * values.size()) / histogramBuckets - 1]);
+    }
+    stats._boundsObj = bounds.arr();
+    for (auto&& bound : stats._boundsObj) {
+        stats._bounds.push_back(bound);
+    }
+
+    return stats;
+}
+
+double FieldStatistics::_histogramPosition(const BSONElement& value) const {
+    invariant(_bounds.size() >= 2);
+    const size_t numBuckets = _bounds.size() - 1;
+
+    if (value.woCompare(_bounds.front(), false) <= 0) {
+        return 0;
+    }
+    if (value.woCompare(_bounds.back(), false) >= 0) {
+        return numBuckets;
+    }
+
+    // Find the bucket holding 'value', whose upper bound is the first bound not less than it.
+    const size_t bucket =
+        std::lower_bound(_bounds.begin() + 1, _bounds.end(), value, elementLessThan) -
+        _bounds.begin();
+    const BSONElement& low = _bounds[bucket - 1];
+    const BSONElement& high = _bounds[bucket];
+
+    // Assume numbers are spread evenly within a bucket. Other types are assumed to lie in the
+    // middle of it.
+    double withinBucket = 0.5;
+    if (value.isNumber() && low.isNumber() && high.isNumber() &&
+        high.numberDouble() > low.numberDouble()) {
+        withinBucket = (value.numberDouble() - low.numberDouble()) /
+            (high.numberDouble() - low.numberDouble());
+        withinBucket = std::max(0.0, std::min(1.0, withinBucket));
+    }
+
+    return bucket - 1 + withinBucket;
+}
+
+double FieldStatistics::estimateSelectivity(const Interval& interval) const {
+    if (_sampleSize == 0) {
+        return 1.0;
+    }
+
+    BSONElement low = interval.start;
+    bool lowInclusive = interval.startInclusive;
+    BSONElement high = interval.end;
+    bool highInclusive = interval.endInclusive;
+    if (interval.getDirection() == Interval::Direction::kDirectionDescending) {
+        std::swap(low, high);
+        std::swap(lowInclusive, highInclusive);
+    }
+
+    if (interval.isPoint()) {
+        if (low.isNull() || low.type() == BSONType::Undefined) {
+            return _nullFraction;
+        }
+        return (1.0 - _nullFraction) / std::max(_distinctValues, 1.0);
+    }
+
+    double selectivity = 0;
+
+    const BSONObj nullObj = BSON("" << BSONNULL);
+    if (isBetween(nullObj.firstElement(), low, lowInclusive, high, highInclusive)) {
+        selectivity += _nullFraction;
+    }
+
+    if (!_bounds.empty()) {
+        const double numBuckets = _bounds.size() - 1;
+        selectivity += (1.0 - _nullFraction) *
+            (_histogramPosition(high) - _histogramPosition(low)) / numBuckets;
+    }
+
+    return std::max(0.0, std::min(1.0, selectivity));
+}
+
+void FieldStatistics::serialize(BSONObjBuilder* bob) const {
+    bob->appendNumber("sampleSize", _sampleSize);
+    bob->append("nullFraction", _nullFraction);
+    bob->append("distinctValues", _distinctValues);
+    bob->appendArray("histogram", _boundsObj);
+}
+
+//
+// CollectionStatistics
+//
+
+std::shared_ptr<const FieldStatistics> CollectionStatistics::getFieldStatistics(
+    StringData path) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _fields.find(path);
+    if (it == _fields.end()) {
+        return nullptr;
+    }
+    return it->second;
+}
+
+void CollectionStatistics::setFieldStatistics(StringData path, FieldStatistics stats) {
+    auto fieldStats = std::make_shared<const FieldStatistics>(std::move(stats));
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _fields[path] = std::move(fieldStats);
+}
+
+bool CollectionStatistics::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _fields.empty();
+}
+
+void CollectionStatistics::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _fields.clear();
+}
+
+}  // namespace mongo
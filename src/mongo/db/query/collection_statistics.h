@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/interval.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Statistics about the values of one field of a collection, estimated from a random sample of its
+ * documents by the analyze command. Each element of an array value is counted as a separate
+ * value, as it would be by a multikey index.
+ */
+class FieldStatistics {
+public:
+    /**
+     * Builds statistics for the field 'path' from 'sample', a random sample of the documents of a
+     * collection which holds 'numRecords' documents. The histogram has at most 'numBuckets'
+     * buckets.
+     */
+    static FieldStatistics build(const std::vector<BSONObj>& sample,
+                                 StringData path,
+                                 long long numRecords,
+                                 size_t numBuckets);
+
+    /**
+     * Returns the estimated fraction of the collection's documents which have a value of this
+     * field in 'interval', between 0 and 1. Documents in which the field is missing count as
+     * having a null value, matching the keys an index generates for them.
+     */
+    double estimateSelectivity(const Interval& interval) const;
+
+    /**
+     * Returns the estimated number of distinct non-null values of this field in the collection.
+     */
+    double getDistinctValues() const {
+        return _distinctValues;
+    }
+
+    /**
+     * Returns the fraction of the sampled documents in which this field is null or missing.
+     */
+    double getNullFraction() const {
+        return _nullFraction;
+    }
+
+    /**
+     * Appends a description of these statistics to 'bob', for the analyze command's reply.
+     */
+    void serialize(BSONObjBuilder* bob) const;
+
+private:
+    /**
+     * Returns the position of 'value' in the histogram, as a number of buckets between 0 and
+     * _bounds.size() - 1.
+     */
+    double _histogramPosition(const BSONElement& value) const;
+
+    long long _sampleSize = 0;
+
+    double _nullFraction = 0;
+
+    double _distinctValues = 0;
+
+    // An equi-depth histogram of the sampled non-null values. '_bounds' holds the smallest sampled
+    // value followed by the largest value in each bucket, so every bucket holds about the same
+    // number of values. The elements point into '_boundsObj'.
+    BSONObj _boundsObj;
+    std::vector<BSONElement> _bounds;
+};
+
+/**
+ * Holds the field statistics of a collection. Owned by the collection's CollectionInfoCache.
+ */
+class CollectionStatistics {
+    MONGO_DISALLOW_COPYING(CollectionStatistics);
+
+public:
+    CollectionStatistics() = default;
+
+    /**
+     * Returns the statistics for the field 'path', or nullptr if it has not been analyzed.
+     */
+    std::shared_ptr<const FieldStatistics> getFieldStatistics(StringData path) const;
+
+    /**
+     * Adds or replaces the statistics for the field 'path'.
+     */
+    void setFieldStatistics(StringData path, FieldStatistics stats);
+
+    /**
+     * Returns true if no field of the collection has been analyzed.
+     */
+    bool isEmpty() const;
+
+    /**
+     * Removes the statistics of every field.
+     */
+    void clear();
+
+private:
+    StringMap<std::shared_ptr<const FieldStatistics>> _fields;
+
+    // Protects '_fields'.
+    mutable stdx::mutex _mutex;
+};
+
+}  // namespace mongo
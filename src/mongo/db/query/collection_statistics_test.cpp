@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_statistics.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/json.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::vector<BSONObj> makeSample(int numDocs, int numDistinct) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < numDocs; ++i) {
+        sample.push_back(BSON("_id" << i << "a" << i % numDistinct));
+    }
+    return sample;
+}
+
+Interval makeInterval(BSONObj bounds, bool startInclusive, bool endInclusive) {
+    return Interval(bounds, startInclusive, endInclusive);
+}
+
+TEST(FieldStatisticsTest, CountsDistinctValuesOfFullSample) {
+    auto stats = FieldStatistics::build(makeSample(100, 10), "a", 100, 10);
+    ASSERT_EQ(stats.getDistinctValues(), 10);
+    ASSERT_EQ(stats.getNullFraction(), 0);
+}
+
+TEST(FieldStatisticsTest, ScalesUpDistinctValuesSampledOnce) {
+    // Every sampled value is unique, so the field is probably unique across the collection.
+    auto stats = FieldStatistics::build(makeSample(100, 100), "a", 10000, 10);
+    ASSERT_APPROX_EQUAL(stats.getDistinctValues(), 10000, 1);
+}
+
+TEST(FieldStatisticsTest, CountsMissingAndNullAsNull) {
+    std::vector<BSONObj> sample{fromjson("{a: 1}"), fromjson("{a: null}"), fromjson("{b: 1}"),
+                                fromjson("{a: 2}")};
+    auto stats = FieldStatistics::build(sample, "a", 4, 10);
+    ASSERT_EQ(stats.getNullFraction(), 0.5);
+    ASSERT_EQ(stats.getDistinctValues(), 2);
+
+    ASSERT_EQ(stats.estimateSelectivity(makeInterval(BSON("" << BSONNULL << "" << BSONNULL),
+                                                     true,
+                                                     true)),
+              0.5);
+}
+
+TEST(FieldStatisticsTest, ExpandsArrays) {
+    std::vector<BSONObj> sample{fromjson("{a: [1, 2, 3]}"), fromjson("{a: [3, 4]}")};
+    auto stats = FieldStatistics::build(sample, "a", 2, 10);
+    ASSERT_EQ(stats.getDistinctValues(), 4);
+}
+
+TEST(FieldStatisticsTest, EstimatesPointSelectivityFromDistinctValues) {
+    auto stats = FieldStatistics::build(makeSample(100, 10), "a", 100, 10);
+    ASSERT_APPROX_EQUAL(
+        stats.estimateSelectivity(makeInterval(BSON("" << 3 << "" << 3), true, true)), 0.1, 1e-9);
+}
+
+TEST(FieldStatisticsTest, EstimatesRangeSelectivityFromHistogram) {
+    auto stats = FieldStatistics::build(makeSample(1000, 1000), "a", 1000, 10);
+
+    ASSERT_APPROX_EQUAL(
+        stats.estimateSelectivity(makeInterval(BSON("" << 0 << "" << 499), true, true)), 0.5, 0.01);
+    ASSERT_APPROX_EQUAL(
+        stats.estimateSelectivity(makeInterval(BSON("" << 900 << "" << MAXKEY), true, true)),
+        0.1,
+        0.01);
+    ASSERT_EQ(
+        stats.estimateSelectivity(makeInterval(BSON("" << 2000 << "" << 3000), true, true)), 0);
+    ASSERT_EQ(
+        stats.estimateSelectivity(makeInterval(BSON("" << MINKEY << "" << MAXKEY), true, true)),
+        1);
+}
+
+TEST(FieldStatisticsTest, EstimatesDescendingIntervals) {
+    auto stats = FieldStatistics::build(makeSample(1000, 1000), "a", 1000, 10);
+    ASSERT_APPROX_EQUAL(
+        stats.estimateSelectivity(makeInterval(BSON("" << 499 << "" << 0), true, true)), 0.5, 0.01);
+}
+
+TEST(FieldStatisticsTest, SerializesHistogram) {
+    auto stats = FieldStatistics::build(makeSample(4, 4), "a", 4, 2);
+    BSONObjBuilder bob;
+    stats.serialize(&bob);
+    ASSERT_BSONOBJ_EQ(bob.obj(),
+                      fromjson("{sampleSize: 4, nullFraction: 0.0, distinctValues: 4.0, "
+                               "histogram: [0, 1, 3]}"));
+}
+
+TEST(CollectionStatisticsTest, StoresFieldStatistics) {
+    CollectionStatistics stats;
+    ASSERT_TRUE(stats.isEmpty());
+    ASSERT_FALSE(stats.getFieldStatistics("a"));
+
+    stats.setFieldStatistics("a", FieldStatistics::build(makeSample(10, 5), "a", 10, 10));
+    ASSERT_FALSE(stats.isEmpty());
+    ASSERT_EQ(stats.getFieldStatistics("a")->getDistinctValues(), 5);
+    ASSERT_FALSE(stats.getFieldStatistics("b"));
+
+    stats.clear();
+    ASSERT_TRUE(stats.isEmpty());
+}
+
+}  // namespace
+}  // namespace mongo
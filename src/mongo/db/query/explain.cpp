@@ -51,6 +51,7 @@
 #include "mongo/db/query/stage_builder.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/util/hardware_counters.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/socket_utils.h"
@@ -270,10 +271,9 @@ std::vector<std::unique_ptr<PlanStageStats>> getRejectedPlansTrialStats(PlanExec
 
     // Get the stats from the trial period for all the plans.
     if (mps) {
-        const auto mpsStats = mps->getStats();
-        for (size_t i = 0; i < mpsStats->children.size(); ++i) {
+        for (size_t i = 0; i < mps->getChildren().size(); ++i) {
             if (i != static_cast<size_t>(mps->bestPlanIdx())) {
-                res.emplace_back(std::move(mpsStats->children[i]));
+                res.emplace_back(mps->getCandidateTrialStats(i));
             }
         }
     }
@@ -339,6 +339,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendNumber("seenMemUsage", spec->seenMemUsage);
 
             for (size_t i = 0; i < spec->mapAfterChild.size(); ++i) {
                 bob->appendNumber(string(stream() << "mapAfterChild_" << i),
@@ -352,6 +353,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             for (size_t i = 0; i < spec->failedAnd.size(); ++i) {
                 bob->appendNumber(string(stream() << "failedAnd_" << i), spec->failedAnd[i]);
             }
+            bob->appendNumber("skips", spec->skips);
         }
     } else if (STAGE_COLLSCAN == stats.stageType) {
         CollectionScanStats* spec = static_cast<CollectionScanStats*>(stats.specific.get());
@@ -361,6 +363,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         }
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->docsTested);
+            if (spec->readAhead) {
+                bob->appendNumber("readAheadHits", spec->readAheadHits);
+                bob->appendNumber("readAheadStalls", spec->readAheadStalls);
+            }
         }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
@@ -428,6 +434,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
 
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("keysExamined", spec->keysExamined);
+            bob->appendNumber("seeks", spec->seeks);
         }
     } else if (STAGE_ENSURE_SORTED == stats.stageType) {
         EnsureSortedStats* spec = static_cast<EnsureSortedStats*>(stats.specific.get());
@@ -509,6 +516,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("dupsTested", spec->dupsTested);
             bob->appendNumber("dupsDropped", spec->dupsDropped);
+            bob->appendNumber("dedupMemUsage", spec->dedupMemUsage);
         }
     } else if (STAGE_LIMIT == stats.stageType) {
         LimitStats* spec = static_cast<LimitStats*>(stats.specific.get());
@@ -561,8 +569,15 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (STAGE_TEXT_OR == stats.stageType) {
         TextOrStats* spec = static_cast<TextOrStats*>(stats.specific.get());
 
+        if (spec->limit) {
+            bob->appendNumber("limit", spec->limit);
+        }
+
         if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
             bob->appendNumber("docsExamined", spec->fetches);
+            if (spec->limit) {
+                bob->appendBool("earlyTermination", spec->earlyTermination);
+            }
         }
     } else if (STAGE_UPDATE == stats.stageType) {
         UpdateStats* spec = static_cast<UpdateStats*>(stats.specific.get());
@@ -745,8 +760,7 @@ std::unique_ptr<PlanStageStats> Explain::getWinningPlanTrialStats(PlanExecutor*
     const auto mps = getMultiPlanStage(exec->getRootStage());
 
     if (mps) {
-        const auto mpsStats = mps->getStats();
-        return std::move(mpsStats->children[mps->bestPlanIdx()]);
+        return mps->getCandidateTrialStats(mps->bestPlanIdx());
     }
 
     return nullptr;
@@ -857,11 +871,22 @@ void Explain::explainStages(PlanExecutor* exec,
     auto winningPlanTrialStats = Explain::getWinningPlanTrialStats(exec);
 
     Status executePlanStatus = Status::OK();
+    StatusWith<std::unique_ptr<HardwareCounters>> swHardwareCounters{nullptr};
+    HardwareCounters::Values hardwareCounterValues;
 
     // If we need execution stats, then run the plan in order to gather the stats.
     if (verbosity >= ExplainOptions::Verbosity::kExecStats) {
+        // The plan executes on this thread, so the thread's counters only count this operation.
+        if (verbosity >= ExplainOptions::Verbosity::kHardwareCounters) {
+            swHardwareCounters = HardwareCounters::open(HardwareCounters::Scope::kThread);
+        }
+
         executePlanStatus = exec->executePlan();
 
+        if (swHardwareCounters.isOK() && swHardwareCounters.getValue()) {
+            hardwareCounterValues = swHardwareCounters.getValue()->read();
+        }
+
         // If executing the query failed because it was killed, then the collection may no longer be
         // valid. We indicate this by setting our collection pointer to null.
         if (executePlanStatus == ErrorCodes::QueryPlanKilled) {
@@ -871,6 +896,20 @@ void Explain::explainStages(PlanExecutor* exec,
 
     explainStages(exec, collection, verbosity, executePlanStatus, winningPlanTrialStats.get(), out);
 
+    if (verbosity >= ExplainOptions::Verbosity::kHardwareCounters) {
+        BSONObjBuilder countersBob(out->subobjStart("hardwareCounters"));
+        if (swHardwareCounters.isOK()) {
+            hardwareCounterValues.append(&countersBob);
+            if (hardwareCounterValues.cycles > 0) {
+                countersBob.append("instructionsPerCycle",
+                                   static_cast<double>(hardwareCounterValues.instructions) /
+                                       hardwareCounterValues.cycles);
+            }
+        } else {
+            countersBob.append("errorMessage", swHardwareCounters.getStatus().reason());
+        }
+    }
+
     generateServerInfo(out);
 }
 
@@ -57,6 +57,13 @@ public:
         // At this verbosity level, we generate the execution stats for each rejected plan as well
         // as the winning plan. String alias is "allPlansExecution".
         kExecAllPlans = 2,
+
+        // In addition to everything at the "allPlansExecution" level, we measure the hardware
+        // performance counters of the thread while it executes the winning plan, where they are
+        // available and enabled by the hardwareCountersEnabled startup parameter. Only find,
+        // count, distinct, findAndModify, update and delete report them.
+        // String alias is "hardwareCounters".
+        kHardwareCounters = 3,
     };
 
     static constexpr StringData kVerbosityName = "verbosity"_sd;
@@ -65,6 +72,7 @@ public:
     static constexpr StringData kQueryPlannerVerbosityStr = "queryPlanner"_sd;
     static constexpr StringData kExecStatsVerbosityStr = "executionStats"_sd;
     static constexpr StringData kAllPlansExecutionVerbosityStr = "allPlansExecution"_sd;
+    static constexpr StringData kHardwareCountersVerbosityStr = "hardwareCounters"_sd;
 
     /**
      * Converts an explain verbosity to its string representation.
@@ -37,6 +37,9 @@
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/lru_cache.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -45,9 +48,10 @@ namespace mongo {
 
 using std::set;
 
-BSONObj ExpressionMapping::hash(const BSONElement& value) {
+BSONObj ExpressionMapping::hash(const BSONElement& value, int hashVersion) {
     BSONObjBuilder bob;
-    bob.append("", BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED));
+    bob.append("",
+               BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED, hashVersion));
     return bob.obj();
 }
 
@@ -108,7 +112,60 @@ void ExpressionMapping::cover2d(const R2Region& region,
     GeoHashsToIntervalsWithParents(unorderedCovering, oilOut);
 }
 
-std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
+namespace {
+
+/**
+ * An LRU cache of 2dsphere query coverings shared by all queries. Repeated queries over the same
+ * geometry, such as an application polling a fixed set of polygons, would otherwise run the
+ * region coverer on every plan.
+ */
+class S2CoveringCache {
+public:
+    boost::optional<std::vector<S2CellId>> find(const std::string& key) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_cache) {
+            return boost::none;
+        }
+
+        auto it = _cache->find(key);
+        if (it == _cache->end()) {
+            return boost::none;
+        }
+        return it->second;
+    }
+
+    void add(const std::string& key, const std::vector<S2CellId>& cover, size_t maxSize) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        // The cache is rebuilt empty when its size knob changes, since LRUCache cannot be resized.
+        if (!_cache || _maxSize != maxSize) {
+            _cache = stdx::make_unique<LRUCache<std::string, std::vector<S2CellId>>>(maxSize);
+            _maxSize = maxSize;
+        }
+        _cache->add(key, cover);
+    }
+
+    void clear() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _cache.reset();
+        _maxSize = 0;
+    }
+
+private:
+    stdx::mutex _mutex;
+    std::unique_ptr<LRUCache<std::string, std::vector<S2CellId>>> _cache;
+    size_t _maxSize = 0;
+};
+
+S2CoveringCache s2CoveringCache;
+
+struct S2CoveringLevels {
+    int minLevel;
+    int maxLevel;
+    int maxCells;
+};
+
+S2CoveringLevels getS2CoveringLevels() {
     auto minLevel = internalQueryS2GeoCoarsestLevel.load();
     auto maxLevel = internalQueryS2GeoFinestLevel.load();
 
@@ -116,16 +173,55 @@ std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& reg
     uassert(28740, "Geo finest level must be in range [0,30]", 0 <= maxLevel && maxLevel <= 30);
     uassert(28741, "Geo coarsest level must be less than or equal to finest", minLevel <= maxLevel);
 
+    return {minLevel, maxLevel, internalQueryS2GeoMaxCells.load()};
+}
+
+std::vector<S2CellId> getS2Covering(const S2Region& region, const S2CoveringLevels& levels) {
     S2RegionCoverer coverer;
-    coverer.set_min_level(minLevel);
-    coverer.set_max_level(maxLevel);
-    coverer.set_max_cells(internalQueryS2GeoMaxCells.load());
+    coverer.set_min_level(levels.minLevel);
+    coverer.set_max_level(levels.maxLevel);
+    coverer.set_max_cells(levels.maxCells);
 
     std::vector<S2CellId> cover;
     coverer.GetCovering(region, &cover);
     return cover;
 }
 
+}  // namespace
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const S2Region& region) {
+    return getS2Covering(region, getS2CoveringLevels());
+}
+
+std::vector<S2CellId> ExpressionMapping::get2dsphereCovering(const BSONObj& geometry,
+                                                             const S2Region& region) {
+    auto levels = getS2CoveringLevels();
+
+    const int cacheSize = internalQueryS2GeoCoveringCacheSize.load();
+    if (cacheSize <= 0) {
+        s2CoveringCache.clear();
+        return getS2Covering(region, levels);
+    }
+
+    // The covering is a function of the geometry and the coverer settings alone, so those make up
+    // the cache key.
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("geometry", geometry);
+    keyBuilder.append("minLevel", levels.minLevel);
+    keyBuilder.append("maxLevel", levels.maxLevel);
+    keyBuilder.append("maxCells", levels.maxCells);
+    BSONObj keyObj = keyBuilder.done();
+    std::string key(keyObj.objdata(), keyObj.objsize());
+
+    if (auto cached = s2CoveringCache.find(key)) {
+        return std::move(*cached);
+    }
+
+    std::vector<S2CellId> cover = getS2Covering(region, levels);
+    s2CoveringCache.add(key, cover, static_cast<size_t>(cacheSize));
+    return cover;
+}
+
 void ExpressionMapping::cover2dsphere(const S2Region& region,
                                       const S2IndexingParams& indexingParams,
                                       OrderedIntervalList* oilOut) {
@@ -133,6 +229,14 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+void ExpressionMapping::cover2dsphere(const BSONObj& geometry,
+                                      const S2Region& region,
+                                      const S2IndexingParams& indexingParams,
+                                      OrderedIntervalList* oilOut) {
+    std::vector<S2CellId> cover = get2dsphereCovering(geometry, region);
+    S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
+}
+
 namespace {
 bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
@@ -32,6 +32,7 @@
 
 #include "mongo/db/geo/hash.h"
 #include "mongo/db/geo/shapes.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds_builder.h"  // For OrderedIntervalList
@@ -48,7 +49,12 @@ namespace mongo {
  */
 class ExpressionMapping {
 public:
-    static BSONObj hash(const BSONElement& value);
+    /**
+     * Returns the hashed index key for 'value', using the default seed and the given hash
+     * function version.
+     */
+    static BSONObj hash(const BSONElement& value,
+                        int hashVersion = BSONElementHasher::kMD5HashVersion);
 
     static std::vector<GeoHash> get2dCovering(const R2Region& region,
                                               const BSONObj& indexInfoObj,
@@ -64,6 +70,14 @@ public:
 
     static std::vector<S2CellId> get2dsphereCovering(const S2Region& region);
 
+    /**
+     * Like get2dsphereCovering() above, but first consults a process-wide LRU cache of coverings
+     * keyed by 'geometry', the BSON from which 'region' was parsed, and the covering knobs in
+     * effect. The cache holds at most internalQueryS2GeoCoveringCacheSize entries.
+     */
+    static std::vector<S2CellId> get2dsphereCovering(const BSONObj& geometry,
+                                                     const S2Region& region);
+
     static void S2CellIdsToIntervals(const std::vector<S2CellId>& intervalSet,
                                      const S2IndexVersion indexVersion,
                                      OrderedIntervalList* oilOut);
@@ -77,6 +91,11 @@ public:
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
                               OrderedIntervalList* oilOut);
+
+    static void cover2dsphere(const BSONObj& geometry,
+                              const S2Region& region,
+                              const S2IndexingParams& indexParams,
+                              OrderedIntervalList* oilOut);
 };
 
 }  // namespace mongo
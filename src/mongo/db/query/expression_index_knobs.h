@@ -59,4 +59,7 @@ extern AtomicInt32 internalQueryS2GeoCoarsestLevel;
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern AtomicInt32 internalQueryS2GeoMaxCells;
 
+// How many 2dsphere query coverings do we remember across queries? Zero disables the cache.
+extern AtomicInt32 internalQueryS2GeoCoveringCacheSize;
+
 }  // namespace mongo
@@ -523,13 +523,16 @@ std::string runQuery(OperationContext* opCtx,
 
     // Parse the qm into a CanonicalQuery.
     const boost::intrusive_ptr<ExpressionContext> expCtx;
-    auto cq = uassertStatusOKWithContext(
-        CanonicalQuery::canonicalize(opCtx,
-                                     q,
-                                     expCtx,
-                                     ExtensionsCallbackReal(opCtx, &nss),
-                                     MatchExpressionParser::kAllowAllSpecialFeatures),
-        "Can't canonicalize query");
+    auto cq = [&] {
+        ScopedPhaseTimer parseTimer(opCtx, OpDebug::Phase::kParse);
+        return uassertStatusOKWithContext(
+            CanonicalQuery::canonicalize(opCtx,
+                                         q,
+                                         expCtx,
+                                         ExtensionsCallbackReal(opCtx, &nss),
+                                         MatchExpressionParser::kAllowAllSpecialFeatures),
+            "Can't canonicalize query");
+    }();
     invariant(cq.get());
 
     LOG(5) << "Running query:\n" << redact(cq->toString());
@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/geo/geometry_container.h"
+#include "mongo/db/index/expression_keys_private.h"
+#include "mongo/db/index/expression_params.h"
+#include "mongo/db/index/s2_common.h"
+#include "mongo/db/json.h"
+#include "mongo/db/query/expression_index.h"
+#include "mongo/db/query/expression_index_knobs.h"
+#include "third_party/s2/s2cellid.h"
+
+namespace mongo {
+namespace {
+
+BSONObj makePoint(int i) {
+    return BSON("type"
+                << "Point"
+                << "coordinates"
+                << BSON_ARRAY((i % 360) - 180 << ((i / 360) % 180) - 90));
+}
+
+S2IndexingParams makeS2IndexingParams() {
+    BSONObj infoObj = fromjson("{key: {a: '2dsphere'}, '2dsphereIndexVersion': 3}");
+    S2IndexingParams params;
+    ExpressionParams::initialize2dsphereParams(infoObj, nullptr, &params);
+    return params;
+}
+
+// Generates the keys for a document holding 'state.range(0)' points in a 2dsphere index.
+void BM_S2KeysForPoints(benchmark::State& state) {
+    BSONArrayBuilder points;
+    for (int i = 0; i < state.range(0); ++i) {
+        points.append(makePoint(i));
+    }
+    BSONObj doc = BSON("a" << points.arr());
+    BSONObj keyPattern = fromjson("{a: '2dsphere'}");
+    S2IndexingParams params = makeS2IndexingParams();
+
+    for (auto keepRunning : state) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        ExpressionKeysPrivate::getS2Keys(doc, keyPattern, params, &keys, nullptr);
+        benchmark::DoNotOptimize(keys);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_S2KeysForPoints)->Arg(1)->Arg(100);
+
+// Generates the keys for a document holding one polygon in a 2dsphere index.
+void BM_S2KeysForPolygon(benchmark::State& state) {
+    BSONObj doc = fromjson(
+        "{a: {type: 'Polygon', coordinates: [[[0, 0], [0, 1], [1, 1], [1, 0], [0, 0]]]}}");
+    BSONObj keyPattern = fromjson("{a: '2dsphere'}");
+    S2IndexingParams params = makeS2IndexingParams();
+
+    for (auto keepRunning : state) {
+        BSONObjSet keys = SimpleBSONObjComparator::kInstance.makeBSONObjSet();
+        ExpressionKeysPrivate::getS2Keys(doc, keyPattern, params, &keys, nullptr);
+        benchmark::DoNotOptimize(keys);
+    }
+}
+
+BENCHMARK(BM_S2KeysForPolygon);
+
+// Covers the same query polygon repeatedly with a covering cache of 'state.range(0)' entries.
+void BM_2dsphereQueryCovering(benchmark::State& state) {
+    const int oldCacheSize = internalQueryS2GeoCoveringCacheSize.load();
+    internalQueryS2GeoCoveringCacheSize.store(state.range(0));
+
+    BSONObj geometry = fromjson(
+        "{$geometry: {type: 'Polygon', coordinates: "
+        "[[[-73.99, 40.73], [-73.99, 40.76], [-73.95, 40.76], [-73.95, 40.73], "
+        "[-73.99, 40.73]]]}}");
+    GeometryContainer geoContainer;
+    invariant(geoContainer.parseFromStorage(geometry.firstElement()).isOK());
+    invariant(geoContainer.hasS2Region());
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(
+            ExpressionMapping::get2dsphereCovering(geometry, geoContainer.getS2Region()));
+    }
+
+    internalQueryS2GeoCoveringCacheSize.store(oldCacheSize);
+}
+
+BENCHMARK(BM_2dsphereQueryCovering)->Arg(0)->Arg(1024);
+
+}  // namespace
+}  // namespace mongo
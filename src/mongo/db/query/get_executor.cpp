@@ -39,6 +39,7 @@
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/count.h"
@@ -63,6 +64,7 @@
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cost_estimator.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
@@ -279,6 +281,7 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
                                                     unique_ptr<CanonicalQuery> canonicalQuery,
                                                     size_t plannerOptions) {
     invariant(canonicalQuery);
+    ScopedPhaseTimer planningTimer(opCtx, OpDebug::Phase::kPlanning);
 
     unique_ptr<PlanStage> root;
 
@@ -304,9 +307,10 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
     }
 
     const IndexDescriptor* descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
+    const bool isClustered = collection->getRecordStore()->isClustered();
 
-    // If we have an _id index we can use an idhack plan.
-    if (descriptor && IDHackStage::supportsQuery(collection, *canonicalQuery)) {
+    // If we have an _id index, or the collection is clustered by _id, we can use an idhack plan.
+    if ((descriptor || isClustered) && IDHackStage::supportsQuery(collection, *canonicalQuery)) {
         LOG(2) << "Using idhack: " << redact(canonicalQuery->toStringShort());
 
         root = make_unique<IDHackStage>(opCtx, collection, canonicalQuery.get(), ws, descriptor);
@@ -449,6 +453,23 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // Use the statistics gathered by the analyze command, if any, to discard plans which are
+    // clearly worse than another candidate without spending a trial period on them. The
+    // statistics describe uncollated values, so they cannot be used when the query has a
+    // collation.
+    if (solutions.size() > 1 && internalQueryPlannerEnableCostModel.load() &&
+        !canonicalQuery->getCollator()) {
+        const CollectionStatistics* stats = collection->infoCache()->getCollectionStatistics();
+        if (!stats->isEmpty()) {
+            PlanCostEstimator estimator(stats, collection->numRecords(opCtx));
+            const size_t numPruned = estimator.pruneSolutions(
+                internalQueryPlannerCostModelPruneFactor.load(), &solutions);
+            LOG(2) << "Cost model discarded " << numPruned << " of "
+                   << numPruned + solutions.size()
+                   << " candidate plans for query: " << redact(canonicalQuery->toStringShort());
+        }
+    }
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         PlanStage* rawRoot;
@@ -802,6 +823,7 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
         }
 
         const IndexDescriptor* descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
+        const bool isClustered = collection->getRecordStore()->isClustered();
 
         // Construct delete request collator.
         std::unique_ptr<CollatorInterface> collator;
@@ -816,7 +838,7 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorDelete(
         const bool hasCollectionDefaultCollation = request->getCollation().isEmpty() ||
             CollatorInterface::collatorsMatch(collator.get(), collection->getDefaultCollator());
 
-        if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
+        if ((descriptor || isClustered) && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
             request->getProj().isEmpty() && hasCollectionDefaultCollation) {
             LOG(2) << "Using idhack: " << redact(unparsedQuery);
 
@@ -950,11 +972,12 @@ StatusWith<unique_ptr<PlanExecutor, PlanExecutor::Deleter>> getExecutorUpdate(
         }
 
         const IndexDescriptor* descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
+        const bool isClustered = collection->getRecordStore()->isClustered();
 
         const bool hasCollectionDefaultCollation = CollatorInterface::collatorsMatch(
             parsedUpdate->getCollator(), collection->getDefaultCollator());
 
-        if (descriptor && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
+        if ((descriptor || isClustered) && CanonicalQuery::isSimpleIdQuery(unparsedQuery) &&
             request->getProj().isEmpty() && hasCollectionDefaultCollation) {
             LOG(2) << "Using idhack: " << redact(unparsedQuery);
 
@@ -457,6 +457,20 @@ bool IndexBounds::isValidFor(const BSONObj& keyPattern, int direction) {
     return !it.more();
 }
 
+bool IndexBounds::isSinglePoint(const BSONObj& keyPattern) const {
+    if (isSimpleRange) {
+        return isStartIncludedInBound(boundInclusion) && isEndIncludedInBound(boundInclusion) &&
+            0 == startKey.woCompare(endKey, keyPattern);
+    }
+
+    for (auto&& oil : fields) {
+        if (1 != oil.intervals.size() || !oil.intervals[0].isPoint()) {
+            return false;
+        }
+    }
+    return !fields.empty();
+}
+
 //
 // Iteration over index bounds
 //
@@ -106,6 +106,13 @@ struct IndexBounds {
     // We can traverse this backwards if indexed descending.
     bool isValidFor(const BSONObj& keyPattern, int direction);
 
+    /**
+     * Returns true if the bounds describe a single point of the index with key pattern
+     * 'keyPattern'. Index entries are ordered by RecordId after the key, so a forward scan over
+     * such bounds returns RecordIds in increasing order.
+     */
+    bool isSinglePoint(const BSONObj& keyPattern) const;
+
     // Methods below used for debugging purpose only. Do not use outside testing code.
     size_t size() const;
     std::string getFieldName(size_t i) const;
@@ -119,6 +119,13 @@ const Interval kHashedUndefinedInterval = IndexBoundsBuilder::makePointInterval(
 const Interval kHashedNullInterval =
     IndexBoundsBuilder::makePointInterval(ExpressionMapping::hash(kNullElementObj.firstElement()));
 
+/**
+ * Returns the version of the hash function that the hashed index 'index' uses.
+ */
+int hashVersionOf(const IndexEntry& index) {
+    return index.infoObj["hashVersion"].numberInt();
+}
+
 void makeNullEqualityBounds(const IndexEntry& index,
                             bool isHashed,
                             OrderedIntervalList* oil,
@@ -128,11 +135,19 @@ void makeNullEqualityBounds(const IndexEntry& index,
     *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
 
     // There are two values that could possibly be equal to null in an index: undefined and null.
-    oil->intervals.push_back(isHashed
-                                 ? kHashedUndefinedInterval
-                                 : IndexBoundsBuilder::makePointInterval(kUndefinedElementObj));
-    oil->intervals.push_back(isHashed ? kHashedNullInterval
-                                      : IndexBoundsBuilder::makePointInterval(kNullElementObj));
+    if (isHashed && hashVersionOf(index) != BSONElementHasher::kMD5HashVersion) {
+        const int hashVersion = hashVersionOf(index);
+        oil->intervals.push_back(IndexBoundsBuilder::makePointInterval(
+            ExpressionMapping::hash(kUndefinedElementObj.firstElement(), hashVersion)));
+        oil->intervals.push_back(IndexBoundsBuilder::makePointInterval(
+            ExpressionMapping::hash(kNullElementObj.firstElement(), hashVersion)));
+    } else {
+        oil->intervals.push_back(isHashed
+                                     ? kHashedUndefinedInterval
+                                     : IndexBoundsBuilder::makePointInterval(kUndefinedElementObj));
+        oil->intervals.push_back(isHashed ? kHashedNullInterval
+                                          : IndexBoundsBuilder::makePointInterval(kNullElementObj));
+    }
     // Just to be sure, make sure the bounds are in the right order if the hash values are opposite.
     IndexBoundsBuilder::unionize(oil);
 }
@@ -668,6 +683,10 @@ void IndexBoundsBuilder::_translatePredicate(const MatchExpression* expr,
     } else if (MatchExpression::MATCH_IN == expr->matchType()) {
         const InMatchExpression* ime = static_cast<const InMatchExpression*>(expr);
 
+        if (translateSimpleInList(ime, index, isHashed, oilOut, tightnessOut)) {
+            return;
+        }
+
         *tightnessOut = IndexBoundsBuilder::EXACT;
 
         // Create our various intervals.
@@ -711,7 +730,7 @@ void IndexBoundsBuilder::_translatePredicate(const MatchExpression* expr,
             const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
             S2IndexingParams indexParams;
             ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            ExpressionMapping::cover2dsphere(gme->getRawObj(), region, indexParams, oilOut);
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
@@ -934,6 +953,49 @@ void IndexBoundsBuilder::translateRegex(const RegexMatchExpression* rme,
     oilOut->intervals.push_back(makePointInterval(bob.obj()));
 }
 
+// static
+bool IndexBoundsBuilder::translateSimpleInList(const InMatchExpression* ime,
+                                               const IndexEntry& index,
+                                               bool isHashed,
+                                               OrderedIntervalList* oilOut,
+                                               BoundsTightness* tightnessOut) {
+    const auto minSize = internalQueryMinInListSizeForHashedLookup.load();
+    const auto& equalities = ime->getEqualities();
+    if (minSize <= 0 || equalities.size() < static_cast<size_t>(minSize)) {
+        return false;
+    }
+
+    // Hashed keys are not ordered like the equalities, and a collator may transform strings into
+    // keys that are ordered differently. Nulls and arrays have special bounds.
+    if (isHashed || index.collator || ime->getCollator() || !ime->getRegexes().empty() ||
+        ime->hasNull() || ime->hasEmptyArray() || !oilOut->intervals.empty()) {
+        return false;
+    }
+    for (auto&& equality : equalities) {
+        if (BSONType::Array == equality.type()) {
+            return false;
+        }
+    }
+
+    BSONObjBuilder bob;
+    for (auto&& equality : equalities) {
+        bob.appendAs(equality, "");
+    }
+    BSONObj points = bob.obj();
+
+    oilOut->intervals.reserve(equalities.size());
+    for (auto&& point : points) {
+        Interval ival;
+        ival._intervalData = points;
+        ival.startInclusive = ival.endInclusive = true;
+        ival.start = ival.end = point;
+        oilOut->intervals.push_back(std::move(ival));
+    }
+
+    *tightnessOut = IndexBoundsBuilder::EXACT;
+    return true;
+}
+
 // static
 void IndexBoundsBuilder::translateEquality(const BSONElement& data,
                                            const IndexEntry& index,
@@ -951,7 +1013,7 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
     if (BSONType::Array != data.type()) {
         BSONObj dataObj = objFromElement(data, index.collator);
         if (isHashed) {
-            dataObj = ExpressionMapping::hash(dataObj.firstElement());
+            dataObj = ExpressionMapping::hash(dataObj.firstElement(), hashVersionOf(index));
         }
 
         verify(dataObj.isOwned());
@@ -37,6 +37,7 @@
 namespace mongo {
 
 class CollatorInterface;
+class InMatchExpression;
 
 /**
  * Translates expressions over fields into bounds on an index.
@@ -211,6 +212,18 @@ private:
                                     const IndexEntry& index,
                                     OrderedIntervalList* oilOut,
                                     BoundsTightness* tightnessOut);
+
+    /**
+     * Fast path for translating a large $in whose equalities are all scalars and need no
+     * collation-aware transformation. All point intervals share a single BSONObj, and since the
+     * equalities are already distinct and sorted by the simple comparator, no unionize() pass is
+     * required. Returns false without modifying 'oilOut' if the fast path does not apply.
+     */
+    static bool translateSimpleInList(const InMatchExpression* ime,
+                                      const IndexEntry& index,
+                                      bool isHashed,
+                                      OrderedIntervalList* oilOut,
+                                      BoundsTightness* tightnessOut);
 };
 
 }  // namespace mongo
@@ -38,7 +38,9 @@
 #include "mongo/db/pipeline/expression_context_for_test.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/expression_index.h"
+#include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -952,6 +954,46 @@ TEST(IndexBoundsBuilderTest, TranslateInArray) {
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
 }
 
+TEST(IndexBoundsBuilderTest, TranslateLargeInProducesSortedDistinctPoints) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    BSONArrayBuilder bab;
+    for (int i = 99; i >= 0; --i) {
+        bab.append(i);
+        bab.append(static_cast<double>(i));
+    }
+    BSONObj obj = BSON("a" << BSON("$in" << bab.arr()));
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.name, "a");
+    ASSERT_EQUALS(oil.intervals.size(), 100U);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQUALS(
+            Interval::INTERVAL_EQUALS,
+            oil.intervals[i].compare(Interval(BSON("" << i << "" << i), true, true)));
+    }
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::EXACT);
+}
+
+TEST(IndexBoundsBuilderTest, TranslateLargeInWithNullIsInexact) {
+    IndexEntry testIndex = IndexEntry(BSONObj());
+    BSONArrayBuilder bab;
+    for (int i = 0; i < 50; ++i) {
+        bab.append(i);
+    }
+    bab.appendNull();
+    BSONObj obj = BSON("a" << BSON("$in" << bab.arr()));
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = obj.firstElement();
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+    ASSERT_EQUALS(oil.intervals.size(), 52U);
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+}
+
 TEST(IndexBoundsBuilderTest, TranslateLteBinData) {
     IndexEntry testIndex = IndexEntry(BSONObj());
     BSONObj obj = fromjson(
@@ -2994,4 +3036,44 @@ TEST(IndexBoundsBuilderTest, IntersectizeBasic) {
     ASSERT_TRUE(oil2 == expectedIntersection);
 }
 
+TEST(IndexBoundsBuilderTest, CachedS2CoveringMatchesUncachedCovering) {
+    const int oldCacheSize = internalQueryS2GeoCoveringCacheSize.load();
+    ON_BLOCK_EXIT([&] { internalQueryS2GeoCoveringCacheSize.store(oldCacheSize); });
+
+    BSONObj keyPattern = BSON("a"
+                              << "2dsphere");
+    IndexEntry testIndex = IndexEntry(keyPattern);
+    BSONObj obj = fromjson(
+        "{a: {$geoWithin: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 5], [5, 5], [5, 0], [0, 0]]]}}}}");
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+
+    auto translateGeo = [&] {
+        OrderedIntervalList oil;
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translate(
+            expr.get(), keyPattern.firstElement(), testIndex, &oil, &tightness);
+        ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+        return oil;
+    };
+
+    internalQueryS2GeoCoveringCacheSize.store(0);
+    OrderedIntervalList uncached = translateGeo();
+    ASSERT_FALSE(uncached.intervals.empty());
+
+    // The first translation populates the cache and the second is served from it.
+    internalQueryS2GeoCoveringCacheSize.store(16);
+    ASSERT_TRUE(translateGeo() == uncached);
+    ASSERT_TRUE(translateGeo() == uncached);
+
+    // Changing a covering knob must not return a covering computed under the old setting.
+    const int oldMaxCells = internalQueryS2GeoMaxCells.load();
+    ON_BLOCK_EXIT([&] { internalQueryS2GeoMaxCells.store(oldMaxCells); });
+    internalQueryS2GeoMaxCells.store(1);
+    internalQueryS2GeoCoveringCacheSize.store(0);
+    OrderedIntervalList coarseUncached = translateGeo();
+    internalQueryS2GeoCoveringCacheSize.store(16);
+    ASSERT_TRUE(translateGeo() == coarseUncached);
+}
+
 }  // namespace
@@ -101,7 +101,8 @@ public:
         int options = IXSCAN_DEFAULT);
 
     /**
-     * Returns an IXSCAN => FETCH => DELETE plan.
+     * Returns an IXSCAN => FETCH => DELETE plan, or IXSCAN => FETCH => LIMIT => DELETE if 'limit'
+     * is positive, in which case at most 'limit' documents are deleted.
      */
     static std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> deleteWithIndexScan(
         OperationContext* opCtx,
@@ -112,7 +113,8 @@ public:
         const BSONObj& endKey,
         BoundInclusion boundInclusion,
         PlanExecutor::YieldPolicy yieldPolicy,
-        Direction direction = FORWARD);
+        Direction direction = FORWARD,
+        long long limit = 0);
 
     /**
      * Returns an IDHACK => UPDATE plan.
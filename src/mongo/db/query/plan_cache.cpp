@@ -395,19 +395,17 @@ bool PlanCache::shouldCacheQuery(const CanonicalQuery& query) {
 //
 
 CachedSolution::CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& entry)
-    : plannerData(entry.plannerData.size()),
-      key(key),
+    : key(key),
       query(entry.query.getOwned()),
       sort(entry.sort.getOwned()),
       projection(entry.projection.getOwned()),
       collation(entry.collation.getOwned()),
       decisionWorks(entry.works) {
     // CachedSolution should not having any references into
-    // cache entry. All relevant data should be cloned/copied.
-    for (size_t i = 0; i < entry.plannerData.size(); ++i) {
-        verify(entry.plannerData[i]);
-        plannerData[i] = entry.plannerData[i]->clone();
-    }
+    // cache entry. All relevant data should be cloned/copied. This is done on every cache hit,
+    // so the data of the losing plans, which no user of a CachedSolution looks at, is skipped.
+    verify(!entry.plannerData.empty() && entry.plannerData[0]);
+    plannerData.push_back(entry.plannerData[0]->clone());
 }
 
 CachedSolution::~CachedSolution() {
@@ -548,6 +546,10 @@ std::string PlanCacheIndexTree::toString(int indents) const {
 // SolutionCacheData
 //
 
+SolutionTemplate::SolutionTemplate() : plannerOptions(0) {}
+
+SolutionTemplate::~SolutionTemplate() = default;
+
 SolutionCacheData* SolutionCacheData::clone() const {
     SolutionCacheData* other = new SolutionCacheData();
     if (NULL != this->tree.get()) {
@@ -558,6 +560,7 @@ SolutionCacheData* SolutionCacheData::clone() const {
     other->solnType = this->solnType;
     other->wholeIXSolnDir = this->wholeIXSolnDir;
     other->indexFilterApplied = this->indexFilterApplied;
+    other->solnTemplate = this->solnTemplate;
     return other;
 }
 
@@ -582,11 +585,30 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
+namespace {
+
+// Partitioning a small cache would make its LRU policy too coarse, so every partition holds at
+// least this many entries unless the whole cache is smaller.
+const size_t kMinPartitionCapacity = 64;
+
+const size_t kMaxPartitions = 16;
+
+}  // namespace
+
 PlanCache::PlanCache() : PlanCache(internalQueryCacheSize.load()) {}
 
-PlanCache::PlanCache(size_t size) : _cache(size) {}
+PlanCache::PlanCache(size_t size) {
+    const size_t numPartitions =
+        std::max(size_t(1), std::min(kMaxPartitions, size / kMinPartitionCapacity));
+    for (size_t i = 0; i < numPartitions; ++i) {
+        const size_t capacity = size / numPartitions + (i < size % numPartitions ? 1 : 0);
+        _partitions.push_back(stdx::make_unique<Partition>(capacity));
+    }
+}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize.load()), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns) : PlanCache(internalQueryCacheSize.load()) {
+    _ns = ns;
+}
 
 PlanCache::~PlanCache() {}
 
@@ -836,7 +858,8 @@ Status PlanCache::set(const CanonicalQuery& query,
 
     const auto key = computeKey(query);
     const size_t newWorks = why->stats[0]->common.works;
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
     bool isNewEntryActive = false;
     uint32_t queryHash;
     if (internalQueryCacheDisableInactiveEntries.load()) {
@@ -845,7 +868,7 @@ Status PlanCache::set(const CanonicalQuery& query,
         queryHash = PlanCache::computeQueryHash(key);
     } else {
         PlanCacheEntry* oldEntry = nullptr;
-        Status cacheStatus = _cache.get(key, &oldEntry);
+        Status cacheStatus = partition.cache.get(key, &oldEntry);
         invariant(cacheStatus.isOK() || cacheStatus == ErrorCodes::NoSuchKey);
         if (oldEntry) {
             queryHash = oldEntry->queryHash;
@@ -888,9 +911,10 @@ Status PlanCache::set(const CanonicalQuery& query,
     }
     newEntry->projection = projBuilder.obj();
 
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, newEntry.release());
+    std::unique_ptr<PlanCacheEntry> evictedEntry = partition.cache.add(key, newEntry.release());
 
     if (NULL != evictedEntry.get()) {
+        partition.evictions.addAndFetch(1);
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
                << "removed least recently used entry " << redact(evictedEntry->toString());
     }
@@ -905,9 +929,10 @@ void PlanCache::deactivate(const CanonicalQuery& query) {
     }
 
     PlanCacheKey key = computeKey(query);
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
         return;
@@ -922,14 +947,17 @@ PlanCache::GetResult PlanCache::get(const CanonicalQuery& query) const {
 }
 
 PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
     PlanCacheEntry* entry = nullptr;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         invariant(cacheStatus == ErrorCodes::NoSuchKey);
+        partition.misses.addAndFetch(1);
         return {CacheEntryState::kNotPresent, nullptr};
     }
     invariant(entry);
+    partition.hits.addAndFetch(1);
 
     auto state =
         entry->isActive ? CacheEntryState::kPresentActive : CacheEntryState::kPresentInactive;
@@ -939,9 +967,10 @@ PlanCache::GetResult PlanCache::get(const PlanCacheKey& key) const {
 Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
     PlanCacheKey ck = computeKey(cq);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = getPartition(ck);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(ck, &entry);
+    Status cacheStatus = partition.cache.get(ck, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -956,13 +985,24 @@ Status PlanCache::feedback(const CanonicalQuery& cq, double score) {
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    PlanCacheKey key = computeKey(canonicalQuery);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
+    return partition.cache.remove(key);
 }
 
 void PlanCache::clear() {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    _cache.clear();
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> partitionLock(partition->mutex);
+        partition->cache.clear();
+    }
+}
+
+PlanCache::Partition& PlanCache::getPartition(const PlanCacheKey& key) const {
+    if (_partitions.size() == 1) {
+        return *_partitions.front();
+    }
+    return *_partitions[computeQueryHash(key) % _partitions.size()];
 }
 
 PlanCacheKey PlanCache::computeKey(const CanonicalQuery& cq) const {
@@ -980,9 +1020,10 @@ uint32_t PlanCache::computeQueryHash(const PlanCacheKey& key) {
 StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQuery& query) const {
     PlanCacheKey key = computeKey(query);
 
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    Partition& partition = getPartition(key);
+    stdx::lock_guard<stdx::mutex> partitionLock(partition.mutex);
     PlanCacheEntry* entry;
-    Status cacheStatus = _cache.get(key, &entry);
+    Status cacheStatus = partition.cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
         return cacheStatus;
     }
@@ -992,20 +1033,25 @@ StatusWith<std::unique_ptr<PlanCacheEntry>> PlanCache::getEntry(const CanonicalQ
 }
 
 std::vector<std::unique_ptr<PlanCacheEntry>> PlanCache::getAllEntries() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     std::vector<std::unique_ptr<PlanCacheEntry>> entries;
 
-    for (auto&& cacheEntry : _cache) {
-        auto entry = cacheEntry.second;
-        entries.push_back(std::unique_ptr<PlanCacheEntry>(entry->clone()));
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> partitionLock(partition->mutex);
+        for (auto&& cacheEntry : partition->cache) {
+            entries.push_back(std::unique_ptr<PlanCacheEntry>(cacheEntry.second->clone()));
+        }
     }
 
     return entries;
 }
 
 size_t PlanCache::size() const {
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.size();
+    size_t size = 0;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> partitionLock(partition->mutex);
+        size += partition->cache.size();
+    }
+    return size;
 }
 
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
@@ -1016,17 +1062,31 @@ std::vector<BSONObj> PlanCache::getMatchingStats(
     const std::function<BSONObj(const PlanCacheEntry&)>& serializationFunc,
     const std::function<bool(const BSONObj&)>& filterFunc) const {
     std::vector<BSONObj> results;
-    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
 
-    for (auto&& cacheEntry : _cache) {
-        const auto entry = cacheEntry.second;
-        auto serializedEntry = serializationFunc(*entry);
-        if (filterFunc(serializedEntry)) {
-            results.push_back(serializedEntry);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> partitionLock(partition->mutex);
+        for (auto&& cacheEntry : partition->cache) {
+            auto serializedEntry = serializationFunc(*cacheEntry.second);
+            if (filterFunc(serializedEntry)) {
+                results.push_back(serializedEntry);
+            }
         }
     }
 
     return results;
 }
 
+std::vector<PlanCache::PartitionStats> PlanCache::getPartitionStats() const {
+    std::vector<PartitionStats> stats;
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> partitionLock(partition->mutex);
+        stats.push_back({partition->cache.size(),
+                         partition->capacity,
+                         partition->hits.load(),
+                         partition->misses.load(),
+                         partition->evictions.load()});
+    }
+    return stats;
+}
+
 }  // namespace mongo
@@ -29,7 +29,10 @@
 #pragma once
 
 #include <boost/optional/optional.hpp>
+#include <memory>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
@@ -124,6 +127,26 @@ struct PlanCacheIndexTree {
     std::vector<OrPushdown> orPushdowns;
 };
 
+/**
+ * A solution which can be rebuilt for any query of its shape by binding the query's equality
+ * constants into a copy of its index bounds, without tagging the query and translating its bounds
+ * again. Only recorded for plans which are a single index scan answering every predicate.
+ */
+struct SolutionTemplate {
+    SolutionTemplate();
+    ~SolutionTemplate();
+
+    // Owned here. Never modified once the template is built; copies are bound instead.
+    std::unique_ptr<QuerySolutionNode> root;
+
+    // For each field of the index scanned by 'root', the path of the equality predicate whose
+    // value is the point interval on that field, or empty if the interval is not a parameter.
+    std::vector<std::string> paramPaths;
+
+    // The QueryPlannerParams options the template was planned with.
+    size_t plannerOptions;
+};
+
 /**
  * Data stored inside a QuerySolution which can subsequently be
  * used to create a cache entry. When this data is retrieved
@@ -170,6 +193,9 @@ struct SolutionCacheData {
 
     // True if index filter was applied.
     bool indexFilterApplied;
+
+    // Set if a USE_INDEX_TAGS_SOLN can be rebuilt from a template. Shared by the deep copies.
+    std::shared_ptr<const SolutionTemplate> solnTemplate;
 };
 
 class PlanCacheEntry;
@@ -185,7 +211,8 @@ public:
     CachedSolution(const PlanCacheKey& key, const PlanCacheEntry& entry);
     ~CachedSolution();
 
-    // Owned here.
+    // Owned here. Only holds the data for the winning plan, since that is all the planner needs
+    // to recreate it. The entry itself holds the data of every candidate plan.
     std::vector<SolutionCacheData*> plannerData;
 
     // Key used to provide feedback on the entry.
@@ -318,6 +345,21 @@ public:
         std::unique_ptr<CachedSolution> cachedSolution;
     };
 
+    /**
+     * Describes one partition of the cache. Returned by getPartitionStats().
+     */
+    struct PartitionStats {
+        size_t numEntries;
+        size_t capacity;
+
+        // Lookups which found an entry, active or not, and lookups which did not.
+        long long hits;
+        long long misses;
+
+        // Entries removed to make room for new ones.
+        long long evictions;
+    };
+
     /**
      * We don't want to cache every possible query. This function
      * encapsulates the criteria for what makes a canonical query
@@ -466,7 +508,33 @@ public:
         const std::function<BSONObj(const PlanCacheEntry&)>& serializationFunc,
         const std::function<bool(const BSONObj&)>& filterFunc) const;
 
+    /**
+     * Returns the size and the lookup counters of each partition of the cache.
+     */
+    std::vector<PartitionStats> getPartitionStats() const;
+
 private:
+    /**
+     * An independent shard of the cache, holding the keys whose query hash maps to it. Each
+     * partition has its own mutex and its own LRU list, so that operations on keys in different
+     * partitions do not contend. When a partition is full, adding an entry evicts the least
+     * recently used entry of that partition.
+     */
+    struct Partition {
+        explicit Partition(size_t capacity) : capacity(capacity), cache(capacity) {}
+
+        const size_t capacity;
+
+        LRUKeyValue<PlanCacheKey, PlanCacheEntry> cache;
+
+        // Protects 'cache'.
+        stdx::mutex mutex;
+
+        AtomicInt64 hits;
+        AtomicInt64 misses;
+        AtomicInt64 evictions;
+    };
+
     struct NewEntryState {
         bool shouldBeCreated = false;
         bool shouldBeActive = false;
@@ -482,10 +550,10 @@ private:
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
 
-    LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
+    Partition& getPartition(const PlanCacheKey& key) const;
 
-    // Protects _cache.
-    mutable stdx::mutex _cacheMutex;
+    // Fixed at construction. Owned here.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Full namespace of collection.
     std::string _ns;
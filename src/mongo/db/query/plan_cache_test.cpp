@@ -473,6 +473,23 @@ TEST(PlanCacheTest, InactiveEntriesDisabled) {
     ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kNotPresent);
 }
 
+TEST(PlanCacheTest, CachedSolutionOnlyHoldsWinningPlan) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1, b: 1}"));
+    auto winner = getQuerySolutionForCaching();
+    winner->cacheData->wholeIXSolnDir = -1;
+    auto loser = getQuerySolutionForCaching();
+    std::vector<QuerySolution*> solns = {winner.get(), loser.get()};
+
+    QueryTestServiceContext serviceContext;
+    ASSERT_OK(planCache.set(*cq, solns, createDecision(2U), Date_t{}));
+
+    auto cachedSoln = planCache.getCacheEntryIfActive(planCache.computeKey(*cq));
+    ASSERT(cachedSoln);
+    ASSERT_EQ(cachedSoln->plannerData.size(), 1U);
+    ASSERT_EQ(cachedSoln->plannerData[0]->wholeIXSolnDir, -1);
+}
+
 
 TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     // Use a tiny cache size.
@@ -508,6 +525,57 @@ TEST(PlanCacheTest, PlanCacheLRUPolicyRemovesInactiveEntries) {
     ASSERT_EQ(planCache.get(*cqC).state, PlanCache::CacheEntryState::kPresentInactive);
 }
 
+TEST(PlanCacheTest, PlanCachePartitionStatsCountLookupsAndEvictions) {
+    const size_t kCacheSize = 1;
+    PlanCache planCache(kCacheSize);
+    QueryTestServiceContext serviceContext;
+
+    unique_ptr<CanonicalQuery> cqA(canonicalize("{a: 1}"));
+    ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kNotPresent);
+    addCacheEntryForShape(*cqA.get(), &planCache);
+    ASSERT_EQ(planCache.get(*cqA).state, PlanCache::CacheEntryState::kPresentInactive);
+
+    // Adding a second shape evicts the first.
+    unique_ptr<CanonicalQuery> cqB(canonicalize("{b: 1}"));
+    addCacheEntryForShape(*cqB.get(), &planCache);
+
+    auto stats = planCache.getPartitionStats();
+    ASSERT_EQ(stats.size(), 1U);
+    ASSERT_EQ(stats[0].numEntries, 1U);
+    ASSERT_EQ(stats[0].capacity, kCacheSize);
+    ASSERT_EQ(stats[0].hits, 1);
+    ASSERT_EQ(stats[0].misses, 1);
+    ASSERT_EQ(stats[0].evictions, 1);
+}
+
+TEST(PlanCacheTest, LargePlanCacheIsPartitioned) {
+    const size_t kCacheSize = 5000;
+    PlanCache planCache(kCacheSize);
+    QueryTestServiceContext serviceContext;
+
+    auto stats = planCache.getPartitionStats();
+    ASSERT_GT(stats.size(), 1U);
+    size_t totalCapacity = 0;
+    for (auto&& partition : stats) {
+        totalCapacity += partition.capacity;
+    }
+    ASSERT_EQ(totalCapacity, kCacheSize);
+
+    // Every shape can be found again, whichever partition it lands in.
+    std::vector<unique_ptr<CanonicalQuery>> queries;
+    for (int i = 0; i < 50; ++i) {
+        queries.push_back(canonicalize(BSON("field" + std::to_string(i) << 1)));
+        addCacheEntryForShape(*queries.back(), &planCache);
+    }
+    ASSERT_EQ(planCache.size(), queries.size());
+    for (auto&& cq : queries) {
+        ASSERT_EQ(planCache.get(*cq).state, PlanCache::CacheEntryState::kPresentInactive);
+    }
+
+    planCache.clear();
+    ASSERT_EQ(planCache.size(), 0U);
+}
+
 TEST(PlanCacheTest, PlanCacheRemoveDeletesInactiveEntries) {
     PlanCache planCache;
     unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
@@ -1170,6 +1238,44 @@ TEST_F(CachePlanSelectionTest, EqualityIndexScanWithTrailingFields) {
         BSON("x" << 5), "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
 }
 
+TEST_F(CachePlanSelectionTest, EqualityIndexScanBindsNewConstantsIntoTemplate) {
+    addIndex(BSON("x" << 1 << "y" << 1), "x_1_y_1");
+    runQuery(BSON("x" << 5));
+
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}}}}}");
+    ASSERT(bestSoln->cacheData->solnTemplate);
+
+    auto planSoln = planQueryFromCache(BSON("x" << 7), BSONObj(), BSONObj(), BSONObj(), *bestSoln);
+    assertSolutionMatches(planSoln.get(),
+                          "{fetch: {filter: null, node: {ixscan: {pattern: {x: 1, y: 1}, bounds: "
+                          "{x: [[7, 7, true, true]], y: [['MinKey', 'MaxKey', true, true]]}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, EqualityToNullIsNotBoundIntoTemplate) {
+    addIndex(BSON("x" << 1), "x_1");
+    runQuery(BSON("x" << 5));
+
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {x: 1}}}}}");
+    ASSERT(bestSoln->cacheData->solnTemplate);
+
+    // Equality to null also matches missing values, so the query must be planned from the tags.
+    auto planSoln =
+        planQueryFromCache(BSON("x" << BSONNULL), BSONObj(), BSONObj(), BSONObj(), *bestSoln);
+    assertSolutionMatches(planSoln.get(),
+                          "{fetch: {filter: {x: null}, node: {ixscan: {pattern: {x: 1}}}}}");
+}
+
+TEST_F(CachePlanSelectionTest, RangeQueryHasNoTemplate) {
+    addIndex(BSON("x" << 1), "x_1");
+    runQuery(fromjson("{x: {$gt: 5}}"));
+
+    auto bestSoln =
+        firstMatchingSolution("{fetch: {filter: null, node: {ixscan: {pattern: {x: 1}}}}}");
+    ASSERT_FALSE(bestSoln->cacheData->solnTemplate);
+}
+
 //
 // Geo
 //
@@ -0,0 +1,313 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_tree.h"
+
+namespace mongo {
+
+namespace {
+
+// How many times AND_SORTED steps a child which falls behind before seeking it ahead, as in
+// AndSortedStage.
+const double kAndSortedStepsBeforeSkip = 2;
+
+/**
+ * Returns true if 'oil' includes every key, in either direction.
+ */
+bool isFullRange(const OrderedIntervalList& oil) {
+    if (oil.intervals.size() != 1) {
+        return false;
+    }
+    const Interval& interval = oil.intervals[0];
+    const bool minToMax = interval.start.type() == BSONType::MinKey &&
+        interval.end.type() == BSONType::MaxKey;
+    const bool maxToMin = interval.start.type() == BSONType::MaxKey &&
+        interval.end.type() == BSONType::MinKey;
+    return (minToMax || maxToMin) && interval.startInclusive && interval.endInclusive;
+}
+
+/**
+ * Returns the interval of values of the same type as the operand of 'expr' which it matches, or
+ * boost::none if 'expr' is not a comparison whose interval the statistics can describe.
+ */
+boost::optional<Interval> comparisonInterval(const ComparisonMatchExpression* expr) {
+    const BSONElement& operand = expr->getData();
+    if (operand.type() == BSONType::Array || operand.type() == BSONType::RegEx) {
+        return boost::none;
+    }
+
+    BSONObjBuilder bob;
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+            bob.appendAs(operand, "");
+            bob.appendAs(operand, "");
+            return Interval(bob.obj(), true, true);
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            bob.appendAs(operand, "");
+            bob.appendMaxForType("", operand.type());
+            return Interval(bob.obj(), expr->matchType() == MatchExpression::GTE, true);
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+            bob.appendMinForType("", operand.type());
+            bob.appendAs(operand, "");
+            return Interval(bob.obj(), true, expr->matchType() == MatchExpression::LTE);
+        default:
+            return boost::none;
+    }
+}
+
+/**
+ * Returns true if 'node' is an index scan which AND_SORTED can seek ahead to a RecordId, which is
+ * a forward scan over a single point of the index.
+ */
+bool canSkipToRecordId(const QuerySolutionNode* node) {
+    if (node->getType() != STAGE_IXSCAN) {
+        return false;
+    }
+    auto ixscan = static_cast<const IndexScanNode*>(node);
+    return ixscan->direction == 1 && ixscan->bounds.isSinglePoint(ixscan->index.keyPattern);
+}
+
+}  // namespace
+
+PlanCostEstimator::PlanCostEstimator(const CollectionStatistics* stats, long long numRecords)
+    : _stats(stats), _numRecords(std::max(numRecords, 1LL)) {
+    invariant(_stats);
+}
+
+boost::optional<double> PlanCostEstimator::estimateCost(const QuerySolution& solution) const {
+    auto estimate = _estimate(solution.root.get());
+    if (!estimate) {
+        return boost::none;
+    }
+    return estimate->cost;
+}
+
+size_t PlanCostEstimator::pruneSolutions(
+    double pruneFactor, std::vector<std::unique_ptr<QuerySolution>>* solutions) const {
+    std::vector<double> costs;
+    for (auto&& solution : *solutions) {
+        auto cost = estimateCost(*solution);
+        if (!cost) {
+            return 0;
+        }
+        costs.push_back(*cost);
+    }
+    if (costs.empty()) {
+        return 0;
+    }
+
+    const double maxCost = *std::min_element(costs.begin(), costs.end()) * pruneFactor;
+
+    size_t numKept = 0;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        if (costs[i] <= maxCost) {
+            (*solutions)[numKept++] = std::move((*solutions)[i]);
+        }
+    }
+
+    const size_t numPruned = solutions->size() - numKept;
+    solutions->resize(numKept);
+    return numPruned;
+}
+
+boost::optional<double> PlanCostEstimator::_estimateIndexScanSelectivity(
+    const IndexScanNode* node) const {
+    if (node->index.type != IndexType::INDEX_BTREE || node->bounds.isSimpleRange) {
+        return boost::none;
+    }
+
+    // The scan examines the keys matching a prefix of equalities on the leading fields, together
+    // with the range on the field that follows them. Bounds on later fields only make it skip
+    // keys, which still costs work.
+    double selectivity = 1.0;
+    for (auto&& oil : node->bounds.fields) {
+        if (isFullRange(oil)) {
+            break;
+        }
+
+        auto fieldStats = _stats->getFieldStatistics(oil.name);
+        if (!fieldStats) {
+            return boost::none;
+        }
+
+        double fieldSelectivity = 0;
+        bool allPoints = true;
+        for (auto&& interval : oil.intervals) {
+            fieldSelectivity += fieldStats->estimateSelectivity(interval);
+            allPoints = allPoints && interval.isPoint();
+        }
+        selectivity *= std::min(fieldSelectivity, 1.0);
+
+        if (!allPoints) {
+            break;
+        }
+    }
+    return selectivity;
+}
+
+double PlanCostEstimator::_estimateFilterSelectivity(const MatchExpression* filter) const {
+    if (!filter) {
+        return 1.0;
+    }
+
+    if (filter->matchType() == MatchExpression::AND) {
+        double selectivity = 1.0;
+        for (size_t i = 0; i < filter->numChildren(); ++i) {
+            selectivity *= _estimateFilterSelectivity(filter->getChild(i));
+        }
+        return selectivity;
+    }
+
+    if (ComparisonMatchExpression::isComparisonMatchExpression(filter)) {
+        auto comparison = static_cast<const ComparisonMatchExpression*>(filter);
+        auto interval = comparisonInterval(comparison);
+        auto fieldStats = _stats->getFieldStatistics(comparison->path());
+        if (interval && fieldStats) {
+            return fieldStats->estimateSelectivity(*interval);
+        }
+    }
+
+    // Assume that a predicate the statistics cannot describe keeps every document.
+    return 1.0;
+}
+
+boost::optional<PlanCostEstimator::Estimate> PlanCostEstimator::_estimate(
+    const QuerySolutionNode* node) const {
+    switch (node->getType()) {
+        case STAGE_COLLSCAN: {
+            auto filter = _estimateFilterSelectivity(node->filter.get());
+            return Estimate{_numRecords, _numRecords * filter, 0};
+        }
+        case STAGE_IXSCAN: {
+            auto selectivity =
+                _estimateIndexScanSelectivity(static_cast<const IndexScanNode*>(node));
+            if (!selectivity) {
+                return boost::none;
+            }
+            // Even a scan which finds nothing costs a work() call to discover that.
+            const double numKeys = *selectivity * _numRecords;
+            auto filter = _estimateFilterSelectivity(node->filter.get());
+            return Estimate{std::max(numKeys, 1.0), numKeys * filter, 0};
+        }
+        case STAGE_FETCH: {
+            auto child = _estimate(node->children[0]);
+            if (!child) {
+                return boost::none;
+            }
+            // Every document is fetched, but only those passing the residual filter are returned.
+            auto filter = _estimateFilterSelectivity(node->filter.get());
+            return Estimate{child->cost + child->numResults,
+                            child->numResults * filter,
+                            child->startupCost};
+        }
+        case STAGE_SORT: {
+            auto child = _estimate(node->children[0]);
+            if (!child) {
+                return boost::none;
+            }
+            // A blocking sort does not return anything until it has consumed its whole input.
+            const double sortCost = child->numResults * std::log2(std::max(child->numResults, 2.0));
+            const auto limit = static_cast<const SortNode*>(node)->limit;
+            const double numResults =
+                limit ? std::min(child->numResults, static_cast<double>(limit)) : child->numResults;
+            return Estimate{child->cost + sortCost, numResults, child->cost + sortCost};
+        }
+        case STAGE_AND_HASH:
+        case STAGE_AND_SORTED:
+        case STAGE_OR:
+        case STAGE_SORT_MERGE: {
+            const bool isAnd =
+                node->getType() == STAGE_AND_HASH || node->getType() == STAGE_AND_SORTED;
+            std::vector<Estimate> children;
+            double startupCost = 0;
+            double numResults = isAnd ? _numRecords : 0;
+            for (auto&& childNode : node->children) {
+                auto child = _estimate(childNode);
+                if (!child) {
+                    return boost::none;
+                }
+                children.push_back(*child);
+                startupCost += child->startupCost;
+                numResults = isAnd ? std::min(numResults, child->numResults)
+                                   : numResults + child->numResults;
+            }
+
+            double cost = 0;
+            for (size_t i = 0; i < children.size(); ++i) {
+                // AND_SORTED seeks a forward point scan which falls behind straight to the
+                // RecordId being intersected, after stepping it kAndSortedStepsBeforeSkip times.
+                // Such a scan is worked about that many times, plus once for the seek, per result
+                // of the most selective child, and never more than it would be to read it all.
+                cost += node->getType() == STAGE_AND_SORTED && canSkipToRecordId(node->children[i])
+                    ? std::min(children[i].cost, (kAndSortedStepsBeforeSkip + 1) * numResults + 1)
+                    : children[i].cost;
+            }
+            // An intersection cannot tell how soon it will find its first result, so assume that
+            // it always reads all of its children.
+            return Estimate{cost, std::min(numResults, _numRecords), isAnd ? cost : startupCost};
+        }
+        case STAGE_LIMIT: {
+            auto child = _estimate(node->children[0]);
+            if (!child) {
+                return boost::none;
+            }
+            // The subtree stops once it has returned 'limit' results. Beyond its startup cost, it
+            // is assumed to spend its work evenly over the results it returns.
+            const double limit = static_cast<const LimitNode*>(node)->limit;
+            if (limit >= child->numResults) {
+                return child;
+            }
+            const double streamingCost = child->cost - child->startupCost;
+            return Estimate{child->startupCost + streamingCost * limit / child->numResults,
+                            limit,
+                            child->startupCost};
+        }
+        case STAGE_PROJECTION:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_SKIP:
+        case STAGE_SORT_KEY_GENERATOR:
+            return _estimate(node->children[0]);
+        default:
+            return boost::none;
+    }
+}
+
+}  // namespace mongo
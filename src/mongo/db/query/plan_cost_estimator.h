@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <vector>
+
+#include "mongo/db/query/collection_statistics.h"
+#include "mongo/db/query/query_solution.h"
+
+namespace mongo {
+
+/**
+ * Estimates the cost of executing candidate QuerySolutions from the field statistics gathered by
+ * the analyze command, so that plans which are clearly worse than another candidate can be
+ * discarded before the multi-planner's trial period.
+ *
+ * Costs are measured in expected calls to PlanStage::work(), the same unit in which the trial
+ * period is budgeted. They are rough: the statistics do not describe correlations between fields,
+ * and only the comparisons in residual filters are estimated, any other predicate being assumed to
+ * keep every document. A limit is assumed to cut short the work its subtree does after producing
+ * its first result in proportion to the results it skips.
+ */
+class PlanCostEstimator {
+public:
+    PlanCostEstimator(const CollectionStatistics* stats, long long numRecords);
+
+    /**
+     * Returns the estimated cost of 'solution', or boost::none if it uses a stage or scans an index
+     * over a field whose cost cannot be estimated.
+     */
+    boost::optional<double> estimateCost(const QuerySolution& solution) const;
+
+    /**
+     * Removes from 'solutions' every solution whose estimated cost is more than 'pruneFactor'
+     * times that of the cheapest one, keeping their relative order. Does nothing unless the cost
+     * of every solution can be estimated. Returns the number of solutions removed.
+     */
+    size_t pruneSolutions(double pruneFactor,
+                          std::vector<std::unique_ptr<QuerySolution>>* solutions) const;
+
+private:
+    struct Estimate {
+        // Expected number of work() calls made on the subtree.
+        double cost;
+
+        // Expected number of results returned by the subtree.
+        double numResults;
+
+        // Expected number of work() calls made on the subtree before it returns its first result,
+        // which a limit cannot save.
+        double startupCost;
+    };
+
+    boost::optional<Estimate> _estimate(const QuerySolutionNode* node) const;
+
+    /**
+     * Returns the estimated fraction of documents which pass 'filter', assuming that its
+     * predicates are independent of each other and of the index bounds.
+     */
+    double _estimateFilterSelectivity(const MatchExpression* filter) const;
+
+    /**
+     * Returns the estimated fraction of the collection's documents with keys within the bounds of
+     * 'node' which the index scan must examine.
+     */
+    boost::optional<double> _estimateIndexScanSelectivity(const IndexScanNode* node) const;
+
+    const CollectionStatistics* _stats;
+    const double _numRecords;
+};
+
+}  // namespace mongo
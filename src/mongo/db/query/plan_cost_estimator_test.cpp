@@ -0,0 +1,242 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cost_estimator.h"
+
+#include "mongo/bson/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/pipeline/expression_context_for_test.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const long long kNumRecords = 1000;
+
+/**
+ * Returns statistics in which 'a' has 1000 distinct values and 'b' has 2.
+ */
+std::unique_ptr<CollectionStatistics> makeStatistics() {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < kNumRecords; ++i) {
+        sample.push_back(BSON("a" << i << "b" << i % 2));
+    }
+
+    auto stats = stdx::make_unique<CollectionStatistics>();
+    stats->setFieldStatistics("a", FieldStatistics::build(sample, "a", kNumRecords, 10));
+    stats->setFieldStatistics("b", FieldStatistics::build(sample, "b", kNumRecords, 10));
+    return stats;
+}
+
+std::unique_ptr<QuerySolution> makeFetchSolution(const std::string& field, BSONObj point) {
+    auto ixscan = stdx::make_unique<IndexScanNode>(IndexEntry(BSON(field << 1)));
+    OrderedIntervalList oil(field);
+    oil.intervals.push_back(Interval(BSON("" << point.firstElement() << "" << point.firstElement()),
+                                     true,
+                                     true));
+    ixscan->bounds.fields.push_back(oil);
+
+    auto fetch = stdx::make_unique<FetchNode>();
+    fetch->children.push_back(ixscan.release());
+
+    auto solution = stdx::make_unique<QuerySolution>();
+    solution->root = std::move(fetch);
+    return solution;
+}
+
+std::unique_ptr<IndexScanNode> makePointScan(const std::string& field, int point) {
+    auto ixscan = stdx::make_unique<IndexScanNode>(IndexEntry(BSON(field << 1)));
+    OrderedIntervalList oil(field);
+    oil.intervals.push_back(Interval(BSON("" << point << "" << point), true, true));
+    ixscan->bounds.fields.push_back(oil);
+    return ixscan;
+}
+
+/**
+ * Returns a solution intersecting point scans in 'direction' over a == 5 and b == 1, with an
+ * AND_SORTED stage if 'sorted' is true and an AND_HASH stage otherwise.
+ */
+std::unique_ptr<QuerySolution> makeIntersectionSolution(bool sorted, int direction) {
+    std::unique_ptr<QuerySolutionNode> andNode;
+    if (sorted) {
+        andNode = stdx::make_unique<AndSortedNode>();
+    } else {
+        andNode = stdx::make_unique<AndHashNode>();
+    }
+    for (auto&& field : {"a", "b"}) {
+        auto ixscan = makePointScan(field, field == std::string("a") ? 5 : 1);
+        ixscan->direction = direction;
+        andNode->children.push_back(ixscan.release());
+    }
+
+    auto fetch = stdx::make_unique<FetchNode>();
+    fetch->children.push_back(andNode.release());
+
+    auto solution = stdx::make_unique<QuerySolution>();
+    solution->root = std::move(fetch);
+    return solution;
+}
+
+std::unique_ptr<QuerySolution> makeCollScanSolution() {
+    auto solution = stdx::make_unique<QuerySolution>();
+    solution->root = stdx::make_unique<CollectionScanNode>();
+    return solution;
+}
+
+std::unique_ptr<QuerySolution> addLimit(std::unique_ptr<QuerySolution> solution, long long limit) {
+    auto limitNode = stdx::make_unique<LimitNode>();
+    limitNode->limit = limit;
+    limitNode->children.push_back(solution->root.release());
+    solution->root = std::move(limitNode);
+    return solution;
+}
+
+std::unique_ptr<QuerySolution> addBlockingSort(std::unique_ptr<QuerySolution> solution) {
+    auto sortNode = stdx::make_unique<SortNode>();
+    sortNode->pattern = BSON("a" << 1);
+    sortNode->children.push_back(solution->root.release());
+    solution->root = std::move(sortNode);
+    return solution;
+}
+
+TEST(PlanCostEstimatorTest, SelectiveIndexScanIsCheaperThanCollectionScan) {
+    auto stats = makeStatistics();
+    PlanCostEstimator estimator(stats.get(), kNumRecords);
+
+    auto ixscanCost = estimator.estimateCost(*makeFetchSolution("a", BSON("" << 5)));
+    auto collscanCost = estimator.estimateCost(*makeCollScanSolution());
+    ASSERT(ixscanCost);
+    ASSERT(collscanCost);
+    ASSERT_LT(*ixscanCost, *collscanCost);
+}
+
+TEST(PlanCostEstimatorTest, CannotEstimateFieldWithoutStatistics) {
+    auto stats = makeStatistics();
+    PlanCostEstimator estimator(stats.get(), kNumRecords);
+    ASSERT_FALSE(estimator.estimateCost(*makeFetchSolution("c", BSON("" << 5))));
+}
+
+TEST(PlanCostEstimatorTest, PrunesSolutionsMuchCostlierThanCheapest) {
+    auto stats = makeStatistics();
+    PlanCostEstimator estimator(stats.get(), kNumRecords);
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeFetchSolution("b", BSON("" << 1)));
+    solutions.push_back(makeFetchSolution("a", BSON("" << 5)));
+    solutions.push_back(makeCollScanSolution());
+
+    ASSERT_EQ(estimator.pruneSolutions(10.0, &solutions), 2U);
+    ASSERT_EQ(solutions.size(), 1U);
+    ASSERT_EQ(solutions[0]->root->children[0]->getType(), STAGE_IXSCAN);
+    ASSERT_EQ(static_cast<IndexScanNode*>(solutions[0]->root->children[0])->bounds.fields[0].name,
+              "a");
+}
+
+TEST(PlanCostEstimatorTest, DoesNotPruneWhenAnySolutionCannotBeEstimated) {
+    auto stats = makeStatistics();
+    PlanCostEstimator estimator(stats.get(), kNumRecords);
+
+    std::vector<std::unique_ptr<QuerySolution>> solutions;
+    solutions.push_back(makeFetchSolution("a", BSON("" << 5)));
+    solutions.push_back(makeFetchSolution("c", BSON("" << 5)));
+    solutions.push_back(makeCollScanSolution());
+
+    ASSERT_EQ(estimator.pruneSolutions(10.0, &solutions), 0U);
+    ASSERT_EQ(solutions.size(), 3U);
+}
+
+TEST(PlanCostEstimatorTest, LimitCutsShortStreamingPlan) {
+    auto stats = makeStatistics();
+    PlanCostEstimator estimator(stats.get(), kNumRecords);
+
+    auto fullCost = estimator.estimateCost(*makeCollScanSolution());
+    auto limitedCost = estimator.estimateCost(*addLimit(makeCollScanSolution(), 10));
+    ASSERT(fullCost);
+    ASSERT(limitedCost);
+    ASSERT_APPROX_EQUAL(*fullCost, static_cast<double>(kNumRecords), 1e-9);
+    ASSERT_APPROX_EQUAL(*limitedCost, 10.0, 1e-9);
+}
+
+TEST(PlanCostEstimatorTest, LimitDoesNotCutShortBlockingSort) {
+    auto stats = makeStatistics();
+    PlanCostEstimator estimator(stats.get(), kNumRecords);
+
+    auto sortCost = estimator.estimateCost(*addBlockingSort(makeCollScanSolution()));
+    auto limitedSortCost =
+        estimator.estimateCost(*addLimit(addBlockingSort(makeCollScanSolution()), 10));
+    ASSERT(sortCost);
+    ASSERT(limitedSortCost);
+    ASSERT_APPROX_EQUAL(*limitedSortCost, *sortCost, 1e-9);
+    ASSERT_GT(*sortCost, static_cast<double>(kNumRecords));
+}
+
+TEST(PlanCostEstimatorTest, FetchFilterReducesResultsSeenByLimit) {
+    auto stats = makeStatistics();
+    PlanCostEstimator estimator(stats.get(), kNumRecords);
+
+    // Scanning the index on 'b' for b == 1 examines half of the collection, and the residual
+    // filter on 'a' keeps about a tenth of that. Returning 10 documents should then take about a
+    // fifth of the plan's work, rather than the 2% it would if every fetched document matched.
+    boost::intrusive_ptr<ExpressionContextForTest> expCtx(new ExpressionContextForTest());
+    auto filter =
+        uassertStatusOK(MatchExpressionParser::parse(fromjson("{a: {$lt: 100}}"), expCtx));
+
+    auto solution = makeFetchSolution("b", BSON("" << 1));
+    solution->root->filter = std::move(filter);
+    auto unfilteredCost = estimator.estimateCost(*makeFetchSolution("b", BSON("" << 1)));
+    auto filteredLimitCost = estimator.estimateCost(*addLimit(std::move(solution), 10));
+    ASSERT(unfilteredCost);
+    ASSERT(filteredLimitCost);
+    ASSERT_GT(*filteredLimitCost, *unfilteredCost * 0.1);
+    ASSERT_LT(*filteredLimitCost, *unfilteredCost * 0.4);
+}
+
+TEST(PlanCostEstimatorTest, SortedIntersectionSeeksPastUnselectivePointScan) {
+    auto stats = makeStatistics();
+    PlanCostEstimator estimator(stats.get(), kNumRecords);
+
+    // The scan over b == 1 has about 500 entries, but AND_SORTED seeks it to the few RecordIds
+    // that the scan over a == 5 returns, whereas AND_HASH reads all of it.
+    auto hashCost = estimator.estimateCost(*makeIntersectionSolution(false, 1));
+    auto sortedCost = estimator.estimateCost(*makeIntersectionSolution(true, 1));
+    ASSERT(hashCost);
+    ASSERT(sortedCost);
+    ASSERT_GT(*hashCost, kNumRecords / 4.0);
+    ASSERT_LT(*sortedCost, 20.0);
+
+    // Backward scans cannot be seeked ahead, so they are read in full like AND_HASH reads them.
+    auto backwardSortedCost = estimator.estimateCost(*makeIntersectionSolution(true, -1));
+    ASSERT(backwardSortedCost);
+    ASSERT_APPROX_EQUAL(*backwardSortedCost, *hashCost, 1e-9);
+}
+
+}  // namespace
+}  // namespace mongo
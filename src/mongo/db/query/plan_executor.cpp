@@ -50,6 +50,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/mock_yield_policies.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/service_context.h"
 #include "mongo/stdx/memory.h"
@@ -228,7 +229,9 @@ PlanExecutor::PlanExecutor(OperationContext* opCtx,
       _root(std::move(rt)),
       _nss(std::move(nss)),
       // There's no point in yielding if the collection doesn't exist.
-      _yieldPolicy(makeYieldPolicy(this, collection ? yieldPolicy : NO_YIELD)) {
+      _yieldPolicy(makeYieldPolicy(this, collection ? yieldPolicy : NO_YIELD)),
+      _canWorkInBatches(!getStageByType(_root.get(), STAGE_UPDATE) &&
+                        !getStageByType(_root.get(), STAGE_DELETE)) {
     // We may still need to initialize _nss from either collection or _cq.
     if (!_nss.isEmpty()) {
         return;  // We already have an _nss set, so there's nothing more to do.
@@ -247,6 +250,7 @@ PlanExecutor::PlanExecutor(OperationContext* opCtx,
 
 Status PlanExecutor::pickBestPlan(const Collection* collection) {
     invariant(_currentState == kUsable);
+    ScopedPhaseTimer planningTimer(_opCtx, OpDebug::Phase::kPlanning);
 
     // First check if we need to do subplanning.
     PlanStage* foundStage = getStageByType(_root.get(), STAGE_SUBPLAN);
@@ -347,6 +351,11 @@ void PlanExecutor::saveState() {
     // boundaries.
     WorkingSetCommon::prepareForSnapshotChange(_workingSet.get());
 
+    // Batched results which have not been returned yet may point into storage engine memory.
+    for (size_t i = _batchedResultsPos; i < _batchedResults.size(); ++i) {
+        _workingSet->get(_batchedResults[i])->makeObjOwnedIfNeeded();
+    }
+
     if (!isMarkedAsKilled()) {
         _root->saveState();
     }
@@ -531,7 +540,8 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         //   2) some stage requested a yield, or
         //   3) we need to yield and retry due to a WriteConflictException.
         // In all cases, the actual yielding happens here.
-        if (_yieldPolicy->shouldYieldOrInterrupt()) {
+        const bool haveBatchedResults = _batchedResultsPos < _batchedResults.size();
+        if (!haveBatchedResults && _yieldPolicy->shouldYieldOrInterrupt()) {
             auto yieldStatus = _yieldPolicy->yieldOrInterrupt();
             if (!yieldStatus.isOK()) {
                 if (objOut) {
@@ -543,7 +553,7 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         }
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState code = _root->work(&id);
+        PlanStage::StageState code = workRoot(&id);
 
         if (code != PlanStage::NEED_YIELD)
             writeConflictsInARow = 0;
@@ -631,9 +641,32 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     }
 }
 
+PlanStage::StageState PlanExecutor::workRoot(WorkingSetID* out) {
+    if (_batchedResultsPos == _batchedResults.size()) {
+        const int batchSize = internalQueryExecBatchSize.load();
+        if (!_canWorkInBatches || batchSize <= 1) {
+            return _root->work(out);
+        }
+
+        _batchedResults.clear();
+        _batchedResultsPos = 0;
+        PlanStage::StageState code = _root->workBatch(batchSize, &_batchedResults);
+        if (PlanStage::ADVANCED != code) {
+            *out = _batchedResults.empty() ? WorkingSet::INVALID_ID : _batchedResults.front();
+            _batchedResults.clear();
+            return code;
+        }
+    }
+
+    *out = _batchedResults[_batchedResultsPos++];
+    return PlanStage::ADVANCED;
+}
+
 bool PlanExecutor::isEOF() {
     invariant(_currentState == kUsable);
-    return isMarkedAsKilled() || (_stash.empty() && _root->isEOF());
+    return isMarkedAsKilled() ||
+        (_stash.empty() && _batchedResultsPos == _batchedResults.size() && _root->isEOF() &&
+         !_root->hasPendingBatchState());
 }
 
 void PlanExecutor::markAsKilled(Status killStatus) {
@@ -30,9 +30,11 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/db/catalog/util/partitioned.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/storage/snapshot.h"
 #include "mongo/stdx/unordered_set.h"
@@ -45,7 +47,6 @@ struct CappedInsertNotifierData;
 class Collection;
 class CursorManager;
 class PlanExecutor;
-class PlanStage;
 class PlanYieldPolicy;
 class RecordId;
 struct PlanStageStats;
@@ -498,6 +499,13 @@ private:
 
     ExecState getNextImpl(Snapshotted<BSONObj>* objOut, RecordId* dlOut);
 
+    /**
+     * Obtains the next result of the plan tree. Results are taken from '_batchedResults' while any
+     * remain; otherwise the root is worked for a whole batch when batching is enabled, or for a
+     * single unit when it is not. Has the same contract as PlanStage::work().
+     */
+    PlanStage::StageState workRoot(WorkingSetID* out);
+
     /**
      * New PlanExecutor instances are created with the static make() methods above.
      */
@@ -572,6 +580,15 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // Results produced by the last PlanStage::workBatch() on '_root' which have not yet been
+    // returned. Those at or after '_batchedResultsPos' are still pending.
+    std::vector<WorkingSetID> _batchedResults;
+    size_t _batchedResultsPos = 0;
+
+    // False if the plan tree contains stages, such as writes, that must be driven one unit of work
+    // at a time.
+    const bool _canWorkInBatches;
+
     enum { kUsable, kSaved, kDetached, kDisposed } _currentState = kUsable;
 
     // Set if this PlanExecutor is registered with the CursorManager.
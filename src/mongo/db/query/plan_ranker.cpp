@@ -66,15 +66,6 @@ using std::vector;
 
 // static
 size_t PlanRanker::pickBestPlan(const vector<CandidatePlan>& candidates, PlanRankingDecision* why) {
-    invariant(!candidates.empty());
-    invariant(why);
-
-    // A plan that hits EOF is automatically scored above
-    // its peers. If multiple plans hit EOF during the same
-    // set of round-robin calls to work(), then all such plans
-    // receive the bonus.
-    double eofBonus = 1.0;
-
     // Each plan will have a stat tree.
     std::vector<std::unique_ptr<PlanStageStats>> statTrees;
 
@@ -86,6 +77,23 @@ size_t PlanRanker::pickBestPlan(const vector<CandidatePlan>& candidates, PlanRan
         statTrees.push_back(candidates[i].root->getStats());
     }
 
+    return pickBestPlan(candidates, std::move(statTrees), why);
+}
+
+// static
+size_t PlanRanker::pickBestPlan(const vector<CandidatePlan>& candidates,
+                                std::vector<std::unique_ptr<PlanStageStats>> statTrees,
+                                PlanRankingDecision* why) {
+    invariant(!candidates.empty());
+    invariant(statTrees.size() == candidates.size());
+    invariant(why);
+
+    // A plan that hits EOF is automatically scored above
+    // its peers. If multiple plans hit EOF during the same
+    // set of round-robin calls to work(), then all such plans
+    // receive the bonus.
+    double eofBonus = 1.0;
+
     // Holds (score, candidateInndex).
     // Used to derive scores and candidate ordering.
     vector<std::pair<double, size_t>> scoresAndCandidateindices;
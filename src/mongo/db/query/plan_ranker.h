@@ -57,6 +57,14 @@ public:
     static size_t pickBestPlan(const std::vector<CandidatePlan>& candidates,
                                PlanRankingDecision* why);
 
+    /**
+     * As above, but ranks the candidates using the stats trees in 'statTrees', which must hold one
+     * entry per candidate, rather than the current stats of each candidate's PlanStage tree.
+     */
+    static size_t pickBestPlan(const std::vector<CandidatePlan>& candidates,
+                               std::vector<std::unique_ptr<PlanStageStats>> statTrees,
+                               PlanRankingDecision* why);
+
     /**
      * Assign the stats tree a 'goodness' score. The higher the score, the better
      * the plan. The exact value isn't meaningful except for imposing a ranking.
@@ -30,6 +30,10 @@
 
 #include "mongo/db/query/plan_yield_policy.h"
 
+#include <utility>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/curop_failpoint_helpers.h"
@@ -45,6 +49,12 @@ namespace mongo {
 
 namespace {
 MONGO_FAIL_POINT_DEFINE(setInterruptOnlyPlansCheckForInterruptHang);
+
+// Number of periodic yield points at which an auto-yielding plan kept its locks and snapshot
+// because nothing was contending for them.
+Counter64 yieldsAvoidedCounter;
+ServerStatusMetricField<Counter64> displayYieldsAvoided("query.yieldsAvoided",
+                                                        &yieldsAvoidedCounter);
 }  // namespace
 
 PlanYieldPolicy::PlanYieldPolicy(PlanExecutor* exec, PlanExecutor::YieldPolicy policy)
@@ -54,6 +64,8 @@ PlanYieldPolicy::PlanYieldPolicy(PlanExecutor* exec, PlanExecutor::YieldPolicy p
       _elapsedTracker(exec->getOpCtx()->getServiceContext()->getFastClockSource(),
                       internalQueryExecYieldIterations.load(),
                       Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _clockSource(exec->getOpCtx()->getServiceContext()->getFastClockSource()),
+      _lastYieldTime(_clockSource->now()),
       _planYielding(exec) {}
 
 
@@ -63,6 +75,8 @@ PlanYieldPolicy::PlanYieldPolicy(PlanExecutor::YieldPolicy policy, ClockSource*
       _elapsedTracker(cs,
                       internalQueryExecYieldIterations.load(),
                       Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _clockSource(cs),
+      _lastYieldTime(_clockSource->now()),
       _planYielding(nullptr) {}
 
 bool PlanYieldPolicy::shouldYieldOrInterrupt() {
@@ -78,7 +92,22 @@ bool PlanYieldPolicy::shouldYield() {
     invariant(!_planYielding->getOpCtx()->lockState()->inAWriteUnitOfWork());
     if (_forceYield)
         return true;
-    return _elapsedTracker.intervalHasElapsed();
+    _atPeriodicYieldPoint = _elapsedTracker.intervalHasElapsed();
+    return _atPeriodicYieldPoint;
+}
+
+bool PlanYieldPolicy::yieldWouldHelp() {
+    if (!internalQueryExecYieldOnlyWhenContended.load()) {
+        return true;
+    }
+
+    OperationContext* opCtx = _planYielding->getOpCtx();
+    if (opCtx->lockState()->hasWaitersForHeldResources()) {
+        return true;
+    }
+
+    const auto snapshotAge = _clockSource->now() - _lastYieldTime;
+    return snapshotAge >= Milliseconds(internalQueryExecYieldMaxSnapshotAgeMS.load());
 }
 
 void PlanYieldPolicy::resetTimer() {
@@ -104,6 +133,16 @@ Status PlanYieldPolicy::yieldOrInterrupt(stdx::function<void()> whileYieldingFn)
         return opCtx->checkForInterruptNoAssert();
     }
 
+    // Only a plain periodic yield may be skipped. Forced yields, write conflict retries and yields
+    // which must run a callback while the locks are released always go through.
+    const bool atPeriodicYieldPoint = std::exchange(_atPeriodicYieldPoint, false);
+    if (_policy == PlanExecutor::YIELD_AUTO && atPeriodicYieldPoint && !_forceYield &&
+        !whileYieldingFn && !yieldWouldHelp()) {
+        resetTimer();
+        yieldsAvoidedCounter.increment();
+        return _planYielding->getOpCtx()->checkForInterruptNoAssert();
+    }
+
     return yield(whileYieldingFn);
 }
 
@@ -114,7 +153,10 @@ Status PlanYieldPolicy::yield(stdx::function<void()> whileYieldingFn) {
     // After we finish yielding (or in any early return), call resetTimer() to prevent yielding
     // again right away. We delay the resetTimer() call so that the clock doesn't start ticking
     // until after we return from the yield.
-    ON_BLOCK_EXIT([this]() { resetTimer(); });
+    ON_BLOCK_EXIT([this]() {
+        resetTimer();
+        _lastYieldTime = _clockSource->now();
+    });
 
     _forceYield = false;
 
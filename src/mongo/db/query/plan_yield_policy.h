@@ -139,6 +139,15 @@ private:
     bool _forceYield;
     ElapsedTracker _elapsedTracker;
 
+    ClockSource* const _clockSource;
+
+    // When the plan last actually released its locks or storage engine state.
+    Date_t _lastYieldTime;
+
+    // Set when shouldYield() returned true only because the elapsed tracker fired, as opposed to
+    // a forced yield. Such yields may be skipped when nothing is contending for our resources.
+    bool _atPeriodicYieldPoint = false;
+
     // The plan executor which this yield policy is responsible for yielding. Must
     // not outlive the plan executor.
     PlanExecutor* const _planYielding;
@@ -148,6 +157,10 @@ private:
 
     // Releases locks or storage engine state.
     Status yield(stdx::function<void()> whileYieldingFn);
+
+    // Returns false if a periodic yield can be skipped because no other operation is waiting on
+    // the locks or ticket we hold and our snapshot is still recent.
+    bool yieldWouldHelp();
 };
 
 }  // namespace mongo
@@ -136,6 +136,25 @@ std::vector<bool> canProvideSortWithMergeSort(
     return shouldReverseScan;
 }
 
+/**
+ * Returns true if an INEXACT_COVERED predicate over the 'pos'-th field of 'index' may be attached
+ * as a filter to the index scan rather than evaluated after a fetch.
+ *
+ * This is always the case for a non-multikey index. For a multikey index, a key generated from one
+ * array element does not carry the rest of the array, so a filter over that field could reject a
+ * document that matches. If path-level multikey metadata shows that the field has no multikey
+ * components, though, every key of a document carries the field's whole value, and the filter
+ * gives the same answer for each key as it would for the document.
+ */
+bool canUseCoveredFilter(const IndexEntry& index, size_t pos) {
+    if (!index.multikey) {
+        return true;
+    }
+
+    return INDEX_BTREE == index.type && pos < index.multikeyPaths.size() &&
+        index.multikeyPaths[pos].empty();
+}
+
 }  // namespace
 
 namespace mongo {
@@ -612,8 +631,7 @@ bool QueryPlannerAccess::orNeedsFetch(const ScanBuildingState* scanState) {
         return true;
     } else {
         invariant(scanState->loosestBounds == IndexBoundsBuilder::INEXACT_COVERED);
-        const IndexEntry& index = scanState->indices[scanState->currentIndexNumber];
-        return index.multikey;
+        return scanState->coveredFilterNeedsFetch;
     }
 }
 
@@ -1291,7 +1309,7 @@ std::unique_ptr<QuerySolutionNode> QueryPlannerAccess::_buildIndexedDataAccess(
             if (tightness == IndexBoundsBuilder::EXACT) {
                 return soln;
             } else if (tightness == IndexBoundsBuilder::INEXACT_COVERED &&
-                       !indices[tag->index].multikey) {
+                       canUseCoveredFilter(indices[tag->index], tag->pos)) {
                 verify(NULL == soln->filter.get());
                 soln->filter = std::move(ownedRoot);
                 return soln;
@@ -1419,6 +1437,12 @@ void QueryPlannerAccess::handleFilterOr(ScanBuildingState* scanState) {
             scanState->loosestBounds = scanState->tightness;
         }
 
+        const IndexEntry& index = scanState->indices[scanState->currentIndexNumber];
+        if (scanState->tightness == IndexBoundsBuilder::INEXACT_COVERED &&
+            !canUseCoveredFilter(index, scanState->ixtag->pos)) {
+            scanState->coveredFilterNeedsFetch = true;
+        }
+
         // Detach 'child' and add it to 'curOr'.
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
         scanState->curOr->getChildVector()->push_back(child);
@@ -1439,18 +1463,18 @@ void QueryPlannerAccess::handleFilterAnd(ScanBuildingState* scanState) {
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
         delete child;
     } else if (scanState->tightness == IndexBoundsBuilder::INEXACT_COVERED &&
-               (INDEX_TEXT == index.type || !index.multikey)) {
+               (INDEX_TEXT == index.type || canUseCoveredFilter(index, scanState->ixtag->pos))) {
         // The bounds are not exact, but the information needed to
         // evaluate the predicate is in the index key. Remove the
         // MatchExpression from its parent and attach it to the filter
         // of the index scan we're building.
         //
-        // We can only use this optimization if the index is NOT multikey.
-        // Suppose that we had the multikey index {x: 1} and a document
-        // {x: ["a", "b"]}. Now if we query for {x: /b/} the filter might
-        // ever only be applied to the index key "a". We'd incorrectly
-        // conclude that the document does not match the query :( so we
-        // gotta stick to non-multikey indices.
+        // We can only use this optimization if the predicate's field is
+        // not multikey. Suppose that we had the multikey index {x: 1} and
+        // a document {x: ["a", "b"]}. Now if we query for {x: /b/} the
+        // filter might ever only be applied to the index key "a". We'd
+        // incorrectly conclude that the document does not match the query
+        // :( so we gotta stick to fields without multikey components.
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
 
         addFilterToSolutionNode(scanState->currentScan.get(), child, root->matchType());
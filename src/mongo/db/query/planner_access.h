@@ -160,6 +160,7 @@ private:
             currentIndexNumber = newTag->index;
             tightness = IndexBoundsBuilder::INEXACT_FETCH;
             loosestBounds = IndexBoundsBuilder::EXACT;
+            coveredFilterNeedsFetch = false;
 
             if (MatchExpression::OR == root->matchType()) {
                 curOr = stdx::make_unique<OrMatchExpression>();
@@ -213,6 +214,11 @@ private:
         // INEXACT_FETCH, then 'loosestBounds' is INEXACT_COVERED.
         IndexBoundsBuilder::BoundsTightness loosestBounds;
 
+        // Set if one of the INEXACT_COVERED predicates assigned to the current scan of an $or is
+        // over a field with multikey components, so that 'curOr' cannot be evaluated against the
+        // index keys and a fetch is required.
+        bool coveredFilterNeedsFetch = false;
+
     private:
         // Default constructor is not allowed.
         ScanBuildingState();
@@ -524,6 +524,9 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         return NULL;
     }
 
+    // Remember what the sort reads from, before any fetch or sort key generation is added.
+    QuerySolutionNode* sortInput = solnRoot;
+
     // Add a fetch stage so we have the full object when we hit the sort stage.  TODO: Can we
     // pull the values that we sort by out of the key and if so in what cases?  Perhaps we can
     // avoid a fetch.
@@ -609,6 +612,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A top-k sort on the text score alone only needs the 'limit' best-scoring documents, which the
+    // TEXT stage can find without scoring every posting. This is only safe when the TEXT stage
+    // feeds the sort directly, with nothing in between that could discard documents.
+    if (sort->limit && STAGE_TEXT == sortInput->getType() && 1 == sortObj.nFields() &&
+        QueryRequest::isTextScoreMeta(sortObj.firstElement())) {
+        static_cast<TextNode*>(sortInput)->limit = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
@@ -38,6 +38,15 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationParallelism, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryPlanEvaluationParallelism must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
@@ -57,6 +66,8 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheDisableInactiveEntries, bool, fa
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheListPlansNewOutput, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheUseSolutionTemplates, bool, true);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
@@ -69,6 +80,17 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableIndexIntersection, bool,
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableHashIntersection, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableCostModel, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerCostModelPruneFactor, double, 10.0)
+    ->withValidator([](const double& newVal) {
+        if (newVal < 1.0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryPlannerCostModelPruneFactor must be >= 1.0");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanOrChildrenIndependently, bool, true);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
@@ -79,8 +101,61 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldOnlyWhenContended, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldMaxSnapshotAgeMS, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryExecYieldMaxSnapshotAgeMS must be >= 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCollectionScanReadAheadRecords, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryCollectionScanReadAheadRecords must be >= 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecBatchSize, int, 64)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0) {
+            return Status(ErrorCodes::BadValue, "internalQueryExecBatchSize must be > 0");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecEnableCompiledMatchExpressions, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecEnableIdPointFindFastPath, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecEnableCompiledAggregationExpressions, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecProjectFetchedDocumentsToDependencies, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMinInListSizeForHashedLookup, int, 16)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryMinInListSizeForHashedLookup must be >= 0");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetBufferSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryFacetParallelism, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalQueryFacetParallelism must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSortMaxBlockingSortBytes,
                               long long,
                               100 * 1024 * 1024)
@@ -92,6 +167,25 @@ MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSortMaxBlockingSortBytes,
         return Status::OK();
     });
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSortParallelism, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceSortParallelism must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSortReadAheadBytes, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 64 * 1024 * 1024) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceSortReadAheadBytes must be between 0 and "
+                          "67108864");
+        }
+        return Status::OK();
+    });
+
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupMaxMemoryBytes,
                               long long,
                               100 * 1024 * 1024)
@@ -111,6 +205,83 @@ MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceCursorBatchSizeBytes, int, 4
 
 MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupCacheSizeBytes, int, 100 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMinLocalDocs, long long, 1000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupHashJoinMaxMemoryBytes,
+                              long long,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupBatchSize, int, 100)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 10000) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceLookupBatchSize must be between 1 and 10000");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupBatchMaxMemoryBytes,
+                              long long,
+                              16 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupParallelism, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceGroupParallelism must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupMongosParallelism, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 64) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceGroupMongosParallelism must be between 1 and 64");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupParallelBufferBytes,
+                              int,
+                              4 * 1024 * 1024)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 100 * 1024 * 1024) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceGroupParallelBufferBytes must be between 1 and "
+                          "104857600");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupMaxMemoryBytes,
+                              long long,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupFrontierBatchSize, int, 10000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceGraphLookupFrontierBatchSize must be positive");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSampleBlockSize, int, 1)
+    ->withValidator([](const int& newVal) {
+        // Each block may run into documents already sampled, which $sample must then skip, so
+        // keep blocks well below the number of duplicates it tolerates in a row.
+        if (newVal < 1 || newVal > 50) {
+            return Status(ErrorCodes::BadValue,
+                          "internalDocumentSourceSampleBlockSize must be between 1 and 50");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceSampleMinSizeForBlockSampling,
+                              long long,
+                              10000);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerGenerateCoveredWholeIndexScans, bool, false);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryIgnoreUnknownJSONSchemaKeywords, bool, false);
@@ -48,6 +48,10 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;
 // Stop working plans once a plan returns this many results.
 extern AtomicInt32 internalQueryPlanEvaluationMaxResults;
 
+// The maximum number of threads which work the candidate plans of a single query during the trial
+// period. The default of 1 works all plans on the thread running the query.
+extern AtomicInt32 internalQueryPlanEvaluationParallelism;
+
 // Do we give a big ranking bonus to intersection plans?
 extern AtomicBool internalQueryForceIntersectionPlans;
 
@@ -57,6 +61,13 @@ extern AtomicBool internalQueryPlannerEnableIndexIntersection;
 // Do we use hash-based intersection for rooted $and queries?
 extern AtomicBool internalQueryPlannerEnableHashIntersection;
 
+// Do we use statistics gathered by the analyze command to discard candidate plans before ranking?
+extern AtomicBool internalQueryPlannerEnableCostModel;
+
+// Candidate plans whose estimated cost is more than this many times that of the cheapest
+// candidate are discarded without being ranked.
+extern AtomicDouble internalQueryPlannerCostModelPruneFactor;
+
 //
 // plan cache
 //
@@ -82,6 +93,10 @@ extern AtomicBool internalQueryCacheDisableInactiveEntries;
 // Whether or not planCacheListPlans uses the new output format.
 extern AtomicBool internalQueryCacheListPlansNewOutput;
 
+// Whether or not cached plans for equality queries are rebuilt by binding the query's constants
+// into a solution template, rather than by planning the query from the cached index tags.
+extern AtomicBool internalQueryCacheUseSolutionTemplates;
+
 //
 // Planning and enumeration.
 //
@@ -120,14 +135,62 @@ extern AtomicInt32 internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern AtomicInt32 internalQueryExecYieldPeriodMS;
 
+// When true, an auto-yielding plan that reaches a periodic yield point only releases its locks and
+// snapshot if another operation is waiting on them or the snapshot is older than
+// internalQueryExecYieldMaxSnapshotAgeMS. Interrupts are still checked at every yield point.
+extern AtomicBool internalQueryExecYieldOnlyWhenContended;
+
+// Maximum time an uncontended plan may keep its snapshot before yielding anyway.
+extern AtomicInt32 internalQueryExecYieldMaxSnapshotAgeMS;
+
+// Number of records a forward collection scan should ask the storage engine to read ahead of it.
+// Zero disables read-ahead.
+extern AtomicInt32 internalQueryCollectionScanReadAheadRecords;
+
+// Maximum number of units of work the PlanExecutor asks of the plan tree in a single
+// PlanStage::workBatch() call. A value of 1 disables batched execution.
+extern AtomicInt32 internalQueryExecBatchSize;
+
+// Evaluate filters on full documents with a CompiledMatchExpression rather than by walking the
+// MatchExpression tree.
+extern AtomicBool internalQueryExecEnableCompiledMatchExpressions;
+
+// Answer find commands on a single _id value with a direct lookup in the _id index, rather than by
+// building a CanonicalQuery and a PlanExecutor.
+extern AtomicBool internalQueryExecEnableIdPointFindFastPath;
+
+// Evaluate the expressions of $project, $addFields and $group with a CompiledExpression rather
+// than by walking each Expression tree.
+extern AtomicBool internalQueryExecEnableCompiledAggregationExpressions;
+
+// Have the FETCH stages of an aggregation's plan keep only the top-level fields the pipeline
+// depends on, rather than handing whole documents to the pipeline.
+extern AtomicBool internalQueryExecProjectFetchedDocumentsToDependencies;
+
+// $in lists with at least this many equalities of a single simple type are matched with a hash
+// table and turned into index bounds without a sort. Zero disables the fast paths.
+extern AtomicInt32 internalQueryMinInListSizeForHashedLookup;
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
 // The number of bytes to buffer at once during a $facet stage.
 extern AtomicInt32 internalQueryFacetBufferSizeBytes;
 
+// The maximum number of threads which run the sub-pipelines of a single $facet stage. The default
+// of 1 runs every facet on the thread running the query.
+extern AtomicInt32 internalQueryFacetParallelism;
+
 extern AtomicInt64 internalDocumentSourceSortMaxBlockingSortBytes;
 
+// The number of threads which sort each batch of documents a blocking $sort holds in memory. One
+// sorts on the thread running the query.
+extern AtomicInt32 internalDocumentSourceSortParallelism;
+
+// How many bytes of each file spilled by a $sort are read ahead on a background thread while the
+// files are merged. Zero reads the files synchronously.
+extern AtomicInt32 internalDocumentSourceSortReadAheadBytes;
+
 extern AtomicInt64 internalDocumentSourceGroupMaxMemoryBytes;
 
 extern AtomicInt32 internalInsertMaxBatchSize;
@@ -136,6 +199,49 @@ extern AtomicInt32 internalDocumentSourceCursorBatchSizeBytes;
 
 extern AtomicInt32 internalDocumentSourceLookupCacheSizeBytes;
 
+// A localField/foreignField $lookup switches from one foreign query per local document to a hash
+// join once this many local documents have been joined. Zero or less disables the hash join.
+extern AtomicInt64 internalDocumentSourceLookupHashJoinMinLocalDocs;
+
+// The maximum total size of the foreign documents a $lookup hash join may hold in memory. If the
+// foreign side is larger, the $lookup keeps issuing one query per local document.
+extern AtomicInt64 internalDocumentSourceLookupHashJoinMaxMemoryBytes;
+
+// The number of local documents a localField/foreignField $lookup joins with a single query against
+// the foreign collection, until it switches to a hash join. One disables batching.
+extern AtomicInt32 internalDocumentSourceLookupBatchSize;
+
+// The maximum total size of the foreign documents matched by one batch of a batched $lookup. If a
+// batch matches more, the $lookup goes back to one query per local document.
+extern AtomicInt64 internalDocumentSourceLookupBatchMaxMemoryBytes;
+
+// The number of partitions a blocking $group splits its input into, each grouped on its own
+// thread. One disables parallel grouping.
+extern AtomicInt32 internalDocumentSourceGroupParallelism;
+
+// The counterpart of 'internalDocumentSourceGroupParallelism' for a $group which mongos runs to
+// merge the partial groups produced by the shards.
+extern AtomicInt32 internalDocumentSourceGroupMongosParallelism;
+
+// The number of bytes of input a parallel $group buffers ahead of its partitions, both in its
+// input queue and in each partition's Exchange buffer.
+extern AtomicInt32 internalDocumentSourceGroupParallelBufferBytes;
+
+// The maximum memory $graphLookup may use for the documents it has visited and the frontier of its
+// search. With allowDiskUse, both are spilled to disk instead of exceeding it.
+extern AtomicInt64 internalDocumentSourceGraphLookupMaxMemoryBytes;
+
+// The maximum number of frontier values $graphLookup looks up in the foreign collection with a
+// single $in query.
+extern AtomicInt32 internalDocumentSourceGraphLookupFrontierBatchSize;
+
+// The number of consecutive records an optimized $sample reads after each random seek once the
+// sample holds at least 'internalDocumentSourceSampleMinSizeForBlockSampling' documents. Larger
+// blocks trade the independence of the sampled documents for fewer random reads. Defaults to 1,
+// which takes every document from its own random seek.
+extern AtomicInt32 internalDocumentSourceSampleBlockSize;
+extern AtomicInt64 internalDocumentSourceSampleMinSizeForBlockSampling;
+
 extern AtomicBool internalQueryProhibitBlockingMergeOnMongoS;
 
 //
@@ -42,18 +42,22 @@
 #include "mongo/db/index_names.h"
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/matcher/expression_text.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/collation/collation_index_key.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_enumerator.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/util/log.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -428,6 +432,221 @@ Status QueryPlanner::tagAccordingToCache(MatchExpression* filter,
     return Status::OK();
 }
 
+/**
+ * If every predicate of 'root' is an equality to a constant whose index bounds are the point
+ * interval on that constant, returns the constants by path. Returns boost::none otherwise, or if a
+ * path is constrained more than once.
+ */
+static boost::optional<StringMap<BSONElement>> getEqualityParameters(const MatchExpression* root) {
+    std::vector<const MatchExpression*> predicates;
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            predicates.push_back(root->getChild(i));
+        }
+    } else {
+        predicates.push_back(root);
+    }
+
+    StringMap<BSONElement> parameters;
+    for (auto&& predicate : predicates) {
+        if (MatchExpression::EQ != predicate->matchType()) {
+            return boost::none;
+        }
+
+        // Null and arrays are not point queries, see IndexBoundsBuilder::translateEquality().
+        const auto& value = static_cast<const EqualityMatchExpression*>(predicate)->getData();
+        switch (value.type()) {
+            case NumberInt:
+            case NumberLong:
+            case NumberDouble:
+            case NumberDecimal:
+            case String:
+            case Object:
+            case BinData:
+            case jstOID:
+            case Bool:
+            case Date:
+            case bsonTimestamp:
+                break;
+            default:
+                return boost::none;
+        }
+
+        if (!parameters.try_emplace(predicate->path(), value).second) {
+            return boost::none;
+        }
+    }
+
+    if (parameters.empty()) {
+        return boost::none;
+    }
+    return {std::move(parameters)};
+}
+
+/**
+ * Returns the index scan of 'root' if the solution is an index scan with at most a fetch and a
+ * projection on top of it, and none of them has a filter. Returns nullptr otherwise.
+ */
+static IndexScanNode* getTemplatableIndexScan(QuerySolutionNode* root) {
+    for (QuerySolutionNode* node = root; node; node = node->children.front()) {
+        if (node->filter) {
+            return nullptr;
+        }
+
+        switch (node->getType()) {
+            case STAGE_PROJECTION:
+            case STAGE_FETCH:
+                if (node->children.size() != 1) {
+                    return nullptr;
+                }
+                break;
+            case STAGE_IXSCAN:
+                return static_cast<IndexScanNode*>(node);
+            default:
+                return nullptr;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * Returns true if the bounds on 'index' never depend on anything but the query's equality
+ * constants. Partial indexes are only chosen if the constants satisfy the partial filter.
+ */
+static bool isTemplatableIndex(const IndexEntry& index) {
+    return INDEX_BTREE == index.type && !index.filterExpr && !index.collator;
+}
+
+/**
+ * Returns true if 'query' would have its limit, skip or collation applied by the solution, which
+ * a template can't do since they are not part of the plan cache key.
+ */
+static bool queryNeedsMoreThanTemplate(const CanonicalQuery& query) {
+    const QueryRequest& qr = query.getQueryRequest();
+    return query.getCollator() || qr.getSkip() || qr.getLimit() || qr.getNToReturn();
+}
+
+/**
+ * Returns a template for rebuilding 'soln' with the constants of other queries of the same shape
+ * as 'query', or nullptr if the solution is anything but the simplest equality index scan.
+ */
+static std::shared_ptr<const SolutionTemplate> makeSolutionTemplate(
+    const CanonicalQuery& query, const QueryPlannerParams& params, const QuerySolution& soln) {
+    if (!internalQueryCacheUseSolutionTemplates.load() || queryNeedsMoreThanTemplate(query)) {
+        return nullptr;
+    }
+
+    auto parameters = getEqualityParameters(query.root());
+    if (!parameters) {
+        return nullptr;
+    }
+
+    auto ixscan = getTemplatableIndexScan(soln.root.get());
+    if (!ixscan || !isTemplatableIndex(ixscan->index) || ixscan->bounds.isSimpleRange) {
+        return nullptr;
+    }
+
+    // Each point interval must be the constant of the predicate on the same path, and each
+    // predicate must be answered by one of them.
+    std::vector<std::string> paramPaths;
+    for (auto&& oil : ixscan->bounds.fields) {
+        if (oil.intervals.size() != 1 || !oil.intervals.front().isPoint()) {
+            paramPaths.emplace_back();
+            continue;
+        }
+
+        auto parameter = parameters->find(oil.name);
+        if (parameter == parameters->end() ||
+            oil.intervals.front().start.woCompare(parameter->second, false) != 0) {
+            return nullptr;
+        }
+        paramPaths.push_back(oil.name);
+    }
+
+    const auto numParams = std::count_if(paramPaths.begin(),
+                                         paramPaths.end(),
+                                         [](const std::string& path) { return !path.empty(); });
+    if (static_cast<size_t>(numParams) != parameters->size()) {
+        return nullptr;
+    }
+
+    auto solnTemplate = std::make_shared<SolutionTemplate>();
+    solnTemplate->root.reset(soln.root->clone());
+    solnTemplate->paramPaths = std::move(paramPaths);
+    solnTemplate->plannerOptions = params.options;
+    return solnTemplate;
+}
+
+/**
+ * Builds the solution in 'solnTemplate' with the equality constants of 'query'. Returns nullptr
+ * if the template can't be used for this query, in which case it must be planned from the cached
+ * index tags instead.
+ */
+static std::unique_ptr<QuerySolution> bindSolutionTemplate(const CanonicalQuery& query,
+                                                           const QueryPlannerParams& params,
+                                                           const SolutionTemplate& solnTemplate) {
+    if (!internalQueryCacheUseSolutionTemplates.load() || queryNeedsMoreThanTemplate(query) ||
+        solnTemplate.plannerOptions != params.options) {
+        return nullptr;
+    }
+
+    // The shape of the query doesn't include the types of its constants, so they may not all be
+    // parameters this time.
+    auto parameters = getEqualityParameters(query.root());
+    if (!parameters) {
+        return nullptr;
+    }
+
+    std::unique_ptr<QuerySolutionNode> root(solnTemplate.root->clone());
+    auto ixscan = getTemplatableIndexScan(root.get());
+    invariant(ixscan);
+    invariant(ixscan->bounds.fields.size() == solnTemplate.paramPaths.size());
+
+    // The index may have become multikey since the template was built, which can change the plan.
+    auto index = std::find_if(params.indices.begin(),
+                              params.indices.end(),
+                              [&](const IndexEntry& entry) { return entry == ixscan->index; });
+    if (index == params.indices.end() || !isTemplatableIndex(*index) ||
+        index->multikey != ixscan->index.multikey ||
+        index->multikeyPaths != ixscan->index.multikeyPaths) {
+        return nullptr;
+    }
+    ixscan->index = *index;
+
+    size_t numBound = 0;
+    for (size_t i = 0; i < solnTemplate.paramPaths.size(); ++i) {
+        const auto& path = solnTemplate.paramPaths[i];
+        if (path.empty()) {
+            continue;
+        }
+
+        auto parameter = parameters->find(path);
+        if (parameter == parameters->end()) {
+            return nullptr;
+        }
+
+        auto& intervals = ixscan->bounds.fields[i].intervals;
+        intervals.clear();
+        intervals.push_back(IndexBoundsBuilder::makePointInterval(
+            IndexBoundsBuilder::objFromElement(parameter->second, nullptr)));
+        ++numBound;
+    }
+    if (numBound != parameters->size()) {
+        return nullptr;
+    }
+
+    if (STAGE_PROJECTION == root->getType()) {
+        static_cast<ProjectionNode*>(root.get())->fullExpression = query.root();
+    }
+    root->computeProperties();
+
+    auto soln = stdx::make_unique<QuerySolution>();
+    soln->root = std::move(root);
+    soln->filterData = query.getQueryObj();
+    soln->indexFilterApplied = params.indexFiltersApplied;
+    return soln;
+}
+
 StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
     const CanonicalQuery& query,
     const QueryPlannerParams& params,
@@ -463,7 +682,15 @@ StatusWith<std::unique_ptr<QuerySolution>> QueryPlanner::planFromCache(
 
     // SolutionCacheData::USE_TAGS_SOLN == cacheData->solnType
     // If we're here then this is neither the whole index scan or collection scan
-    // cases, and we proceed by using the PlanCacheIndexTree to tag the query tree.
+    // cases. Equality queries may only need their constants bound into the cached solution,
+    // otherwise we proceed by using the PlanCacheIndexTree to tag the query tree.
+    if (winnerCacheData.solnTemplate) {
+        if (auto soln = bindSolutionTemplate(query, params, *winnerCacheData.solnTemplate)) {
+            LOG(5) << "Planner: solution bound from the cached template:\n"
+                   << redact(soln->toString());
+            return {std::move(soln)};
+        }
+    }
 
     // Create a copy of the expression tree.  We use cachedSoln to annotate this with indices.
     unique_ptr<MatchExpression> clone = query.root()->shallowClone();
@@ -819,6 +1046,7 @@ StatusWith<std::vector<std::unique_ptr<QuerySolution>>> QueryPlanner::plan(
                 if (statusWithCacheData.isOK()) {
                     SolutionCacheData* scd = new SolutionCacheData();
                     scd->tree = std::move(cacheData);
+                    scd->solnTemplate = makeSolutionTemplate(query, params, *soln);
                     soln->cacheData.reset(scd);
                 }
                 out.push_back(std::move(soln));
@@ -2435,6 +2435,67 @@ TEST_F(QueryPlannerTest, CompoundIndexBoundsDottedNotEqualsNullMultiKeyWithProje
         "'c.d':[['MinKey','MaxKey',true,true]]}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, InexactCoveredPredicateOnNonMultikeyFieldIsIndexFilter) {
+    MultikeyPaths multikeyPaths{{0U}, std::set<size_t>{}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+    runQuery(fromjson("{a: 1, b: /foo/}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {a: 1, b: 1}, filter: {b: /foo/}, "
+        "bounds: {a: [[1, 1, true, true]], b: [['', {}, true, false], [/foo/, /foo/, true, true]]}"
+        "}}}}");
+}
+
+TEST_F(QueryPlannerTest, InexactCoveredPredicateOnNonMultikeyFieldIsCovered) {
+    MultikeyPaths multikeyPaths{{0U}, std::set<size_t>{}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+    runQuerySortProj(fromjson("{a: 1, b: /foo/}"), BSONObj(), fromjson("{_id: 0, b: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{proj: {spec: {_id: 0, b: 1}, node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, b: 1}, node: "
+        "{ixscan: {pattern: {a: 1, b: 1}, filter: {b: /foo/}}}}}");
+}
+
+TEST_F(QueryPlannerTest, InexactCoveredPredicateOnMultikeyFieldRequiresFetch) {
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+    runQuerySortProj(fromjson("{a: 1, b: /foo/}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{proj: {spec: {_id: 0, a: 1}, node: {cscan: {dir: 1}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: {fetch: {filter: {b: /foo/}, node: "
+        "{ixscan: {pattern: {a: 1, b: 1}, filter: null}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, OrInexactCoveredOnNonMultikeyFieldIsIndexFilter) {
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("names" << 1 << "tags" << 1), multikeyPaths);
+    runQuery(fromjson("{$or: [{names: 'dave'}, {names: /joe/}]}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {pattern: {names: 1, tags: 1}, "
+        "filter: {$or: [{names: 'dave'}, {names: /joe/}]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, OrInexactCoveredOnMultikeyFieldRequiresFetch) {
+    MultikeyPaths multikeyPaths{{0U}, std::set<size_t>{}};
+    addIndex(BSON("names" << 1 << "tags" << 1), multikeyPaths);
+    runQuery(fromjson("{$or: [{names: 'dave'}, {names: /joe/}]}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {$or: [{names: 'dave'}, {names: /joe/}]}, "
+        "node: {ixscan: {filter: null, pattern: {names: 1, tags: 1}}}}}");
+}
+
 TEST_F(QueryPlannerTest, CompoundIndexBoundsNotEqualsNullReverseIndex) {
     addIndex(BSON("a" << 1 << "b" << -1 << "c" << 1));
     runQuery(fromjson("{a: {$gt: 'foo'}, b: {$ne: null}, c: {$ne: null}}"));
@@ -277,6 +277,11 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If non-zero, the results are consumed by a sort on the text score that keeps only this many
+    // documents, so the text stage may stop reading postings once no unscored document can place
+    // among the best 'limit' results.
+    size_t limit = 0u;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
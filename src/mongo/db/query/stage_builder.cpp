@@ -56,6 +56,7 @@
 #include "mongo/db/exec/text.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -65,6 +66,91 @@ namespace mongo {
 using std::unique_ptr;
 using stdx::make_unique;
 
+namespace {
+
+/**
+ * Returns true if every document produced by 'node' is known from the bounds of the index scan it
+ * reads from to have a shard key inside chunks owned by this shard, in which case the sharding
+ * filter above 'node' doesn't need to look at the documents at all.
+ */
+bool allResultsOwned(const QuerySolutionNode* node, const CollectionMetadata& metadata) {
+    if (STAGE_FETCH == node->getType()) {
+        node = node->children[0];
+    }
+    if (STAGE_IXSCAN != node->getType()) {
+        return false;
+    }
+
+    const IndexScanNode* ixn = static_cast<const IndexScanNode*>(node);
+    if (ixn->bounds.isSimpleRange || ixn->index.type != INDEX_BTREE || ixn->index.collator) {
+        return false;
+    }
+
+    // The shard key must be a prefix of the index so that the bounds of the leading index fields
+    // bound the shard key of every document.
+    const BSONObj shardKeyPattern = metadata.getKeyPattern();
+    BSONObjIterator indexKeyIt(ixn->index.keyPattern);
+    BSONObjBuilder minBuilder;
+    BSONObjBuilder maxBuilder;
+    size_t fieldIndex = 0;
+    for (const auto& shardKeyElt : shardKeyPattern) {
+        // Hashed shard key values are not stored in a btree index on the shard key fields.
+        if (!shardKeyElt.isNumber() || !indexKeyIt.more()) {
+            return false;
+        }
+
+        const auto indexKeyElt = indexKeyIt.next();
+        if (shardKeyElt.fieldNameStringData() != indexKeyElt.fieldNameStringData()) {
+            return false;
+        }
+
+        const auto& intervals = ixn->bounds.fields[fieldIndex++].intervals;
+        if (intervals.empty()) {
+            return false;
+        }
+
+        BSONElement fieldMin = intervals.front().start;
+        BSONElement fieldMax = intervals.front().start;
+        for (const auto& interval : intervals) {
+            for (const auto& endpoint : {interval.start, interval.end}) {
+                if (endpoint.woCompare(fieldMin, false) < 0) {
+                    fieldMin = endpoint;
+                }
+                if (endpoint.woCompare(fieldMax, false) > 0) {
+                    fieldMax = endpoint;
+                }
+            }
+        }
+
+        // Documents missing a shard key field are indexed as null but are never owned, so they
+        // must still be filtered out.
+        if (fieldMin.canonicalType() <= canonicalizeBSONType(jstNULL) &&
+            fieldMax.canonicalType() >= canonicalizeBSONType(jstNULL)) {
+            return false;
+        }
+
+        minBuilder.appendAs(fieldMin, shardKeyElt.fieldNameStringData());
+        maxBuilder.appendAs(fieldMax, shardKeyElt.fieldNameStringData());
+    }
+
+    return metadata.rangeBelongsToMe(minBuilder.obj(), maxBuilder.obj());
+}
+
+/**
+ * Returns how many results a near search for 'cq' is expected to produce before the query stops
+ * reading, or 0 if the query has no limit.
+ */
+long long geoNearLimitHint(const CanonicalQuery& cq) {
+    const QueryRequest& qr = cq.getQueryRequest();
+    const auto limit = qr.getLimit() ? qr.getLimit() : qr.getNToReturn();
+    if (!limit || *limit <= 0) {
+        return 0;
+    }
+    return *limit + qr.getSkip().value_or(0);
+}
+
+}  // namespace
+
 PlanStage* buildStages(OperationContext* opCtx,
                        Collection* collection,
                        const CanonicalQuery& cq,
@@ -81,6 +167,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.direction = (csn->direction == 1) ? CollectionScanParams::FORWARD
                                                      : CollectionScanParams::BACKWARD;
             params.shouldWaitForOplogVisibility = csn->shouldWaitForOplogVisibility;
+            params.readAheadRecords = internalQueryCollectionScanReadAheadRecords.load();
             return new CollectionScan(opCtx, params, ws, csn->filter.get());
         }
         case STAGE_IXSCAN: {
@@ -244,6 +331,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.filter = node->filter.get();
             params.addPointMeta = node->addPointMeta;
             params.addDistMeta = node->addDistMeta;
+            params.limitHint = geoNearLimitHint(cq);
 
             IndexDescriptor* twoDIndex = collection->getIndexCatalog()->findIndexByName(
                 opCtx, node->index.identifier.catalogName);
@@ -263,6 +351,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             params.filter = node->filter.get();
             params.addPointMeta = node->addPointMeta;
             params.addDistMeta = node->addDistMeta;
+            params.limitHint = geoNearLimitHint(cq);
 
             IndexDescriptor* s2Index = collection->getIndexCatalog()->findIndexByName(
                 opCtx, node->index.identifier.catalogName);
@@ -289,6 +378,7 @@ PlanStage* buildStages(OperationContext* opCtx,
             // fail in this case (this improvement is being tracked by SERVER-21510).
             params.query = static_cast<FTSQueryImpl&>(*node->ftsQuery);
             params.wantTextScore = (cq.getProj() && cq.getProj()->wantTextScore());
+            params.limit = node->limit;
             return new TextStage(opCtx, params, ws, node->filter.get());
         }
         case STAGE_SHARDING_FILTER: {
@@ -297,11 +387,12 @@ PlanStage* buildStages(OperationContext* opCtx,
             if (nullptr == childStage) {
                 return nullptr;
             }
+            auto metadata =
+                CollectionShardingState::get(opCtx, collection->ns())->getMetadata(opCtx);
+            const bool skipFiltering =
+                metadata->isSharded() && allResultsOwned(fn->children[0], *metadata);
             return new ShardFilterStage(
-                opCtx,
-                CollectionShardingState::get(opCtx, collection->ns())->getMetadata(opCtx),
-                ws,
-                childStage);
+                opCtx, std::move(metadata), ws, childStage, skipFiltering);
         }
         case STAGE_DISTINCT_SCAN: {
             const DistinctNode* dn = static_cast<const DistinctNode*>(root);
@@ -515,6 +515,11 @@ Status applyOps(OperationContext* opCtx,
 
 // static
 MultiApplier::Operations ApplyOps::extractOperations(const OplogEntry& applyOpsOplogEntry) {
+    return extractOperations(applyOpsOplogEntry, applyOpsOplogEntry);
+}
+
+MultiApplier::Operations ApplyOps::extractOperations(const OplogEntry& applyOpsOplogEntry,
+                                                     const OplogEntry& topLevelOplogEntry) {
     uassert(ErrorCodes::TypeMismatch,
             str::stream() << "ApplyOps::extractOperations(): not a command: "
                           << redact(applyOpsOplogEntry.toBSON()),
@@ -534,7 +539,7 @@ MultiApplier::Operations ApplyOps::extractOperations(const OplogEntry& applyOpsO
 
     MultiApplier::Operations operations;
 
-    auto topLevelDoc = applyOpsOplogEntry.toBSON();
+    auto topLevelDoc = topLevelOplogEntry.toBSON();
     for (const auto& elem : operationDocs) {
         auto operationDoc = elem.Obj();
         BSONObjBuilder builder(operationDoc);
@@ -50,6 +50,14 @@ public:
      * Throws UserException on error.
      */
     static MultiApplier::Operations extractOperations(const OplogEntry& applyOpsOplogEntry);
+
+    /**
+     * Like above, but the extracted operations take their top-level fields, such as the optime,
+     * from 'topLevelOplogEntry' instead. Used to apply the operations of every entry in a chain of
+     * transaction 'applyOps' entries at the optime of the entry that commits them.
+     */
+    static MultiApplier::Operations extractOperations(const OplogEntry& applyOpsOplogEntry,
+                                                      const OplogEntry& topLevelOplogEntry);
 };
 
 /**
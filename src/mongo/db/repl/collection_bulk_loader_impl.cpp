@@ -43,6 +43,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/collection_bulk_loader_impl.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -51,6 +52,10 @@
 namespace mongo {
 namespace repl {
 
+// Whether documents are appended to the empty collection being loaded through the storage
+// engine's bulk loading interface, when it has one.
+MONGO_EXPORT_SERVER_PARAMETER(collectionBulkLoaderUseRecordBulkBuilder, bool, true);
+
 CollectionBulkLoaderImpl::CollectionBulkLoaderImpl(ServiceContext::UniqueClient&& client,
                                                    ServiceContext::UniqueOperationContext&& opCtx,
                                                    std::unique_ptr<AutoGetCollection>&& autoColl,
@@ -100,6 +105,11 @@ Status CollectionBulkLoaderImpl::init(const std::vector<BSONObj>& secondaryIndex
                 _idIndexBlock.reset();
             }
 
+            // Capped collections are loaded with regular inserts, which delete documents as needed.
+            if (collectionBulkLoaderUseRecordBulkBuilder.load() && !coll->isCapped()) {
+                _recordBulkBuilder = coll->getRecordStore()->makeBulkBuilder(_opCtx.get());
+            }
+
             return Status::OK();
         });
 }
@@ -110,15 +120,34 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
     return _runTaskReleaseResourcesOnFailure([&]() -> Status {
         UnreplicatedWritesBlock uwb(_opCtx.get());
 
-        for (auto iter = begin; iter != end; ++iter) {
-            std::vector<MultiIndexBlock*> indexers;
-            if (_idIndexBlock) {
-                indexers.push_back(_idIndexBlock.get());
-            }
-            if (_secondaryIndexesBlock) {
-                indexers.push_back(_secondaryIndexesBlock.get());
+        std::vector<MultiIndexBlock*> indexers;
+        if (_idIndexBlock) {
+            indexers.push_back(_idIndexBlock.get());
+        }
+        if (_secondaryIndexesBlock) {
+            indexers.push_back(_secondaryIndexesBlock.get());
+        }
+
+        if (_recordBulkBuilder) {
+            // Records appended through the bulk builder cannot be rolled back, so the batch is not
+            // retried on write conflict. A single unit of work covers the whole batch.
+            try {
+                WriteUnitOfWork wunit(_opCtx.get());
+                for (auto iter = begin; iter != end; ++iter) {
+                    const auto status = _autoColl->getCollection()->insertDocument(
+                        _opCtx.get(), *iter, indexers, _recordBulkBuilder.get());
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+                wunit.commit();
+            } catch (const DBException& ex) {
+                return ex.toStatus();
             }
+            return Status::OK();
+        }
 
+        for (auto iter = begin; iter != end; ++iter) {
             Status status = writeConflictRetry(
                 _opCtx.get(), "CollectionBulkLoaderImpl::insertDocuments", _nss.ns(), [&] {
                     WriteUnitOfWork wunit(_opCtx.get());
@@ -161,6 +190,12 @@ Status CollectionBulkLoaderImpl::commit() {
         LOG(2) << "Creating indexes for ns: " << _nss.ns();
         UnreplicatedWritesBlock uwb(_opCtx.get());
 
+        // Make the bulk loaded records visible before deleting duplicates below.
+        if (_recordBulkBuilder) {
+            _recordBulkBuilder->commit(_opCtx.get());
+            _recordBulkBuilder.reset();
+        }
+
         // Commit before deleting dups, so the dups will be removed from secondary indexes when
         // deleted.
         if (_secondaryIndexesBlock) {
@@ -222,6 +257,8 @@ Status CollectionBulkLoaderImpl::commit() {
 
 void CollectionBulkLoaderImpl::_releaseResources() {
     invariant(&cc() == _opCtx->getClient());
+    _recordBulkBuilder.reset();
+
     if (_secondaryIndexesBlock) {
         // A valid Client is required to drop unfinished indexes.
         Client::initThreadIfNotAlready();
@@ -38,6 +38,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/repl/collection_bulk_loader.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/storage/record_store.h"
 
 namespace mongo {
 namespace repl {
@@ -45,6 +46,10 @@ namespace repl {
 /**
  * Class in charge of building a collection during data loading (like initial sync).
  *
+ * If the storage engine supports it, records are appended through a RecordStoreBulkBuilder rather
+ * than inserted in a storage transaction each. Index keys are always gathered by MultiIndexBlocks
+ * and bulk loaded into the indexes in sorted order on commit.
+ *
  * Note: Call commit when done inserting documents.
  */
 class CollectionBulkLoaderImpl : public CollectionBulkLoader {
@@ -86,6 +91,7 @@ private:
     ServiceContext::UniqueOperationContext _opCtx;
     std::unique_ptr<AutoGetCollection> _autoColl;
     NamespaceString _nss;
+    std::unique_ptr<RecordStoreBulkBuilder> _recordBulkBuilder;
     std::unique_ptr<MultiIndexBlock> _idIndexBlock;
     std::unique_ptr<MultiIndexBlock> _secondaryIndexesBlock;
     BSONObj _idIndexSpec;
@@ -32,6 +32,8 @@
 
 #include "mongo/db/repl/collection_cloner.h"
 
+#include <algorithm>
+#include <iterator>
 #include <utility>
 
 #include "mongo/base/string_data.h"
@@ -73,6 +75,79 @@ MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListIndexesAttempts, int, 3);
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncCollectionFindAttempts, int, 3);
 // Whether to use the "exhaust cursor" feature when retrieving collection data.
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(collectionClonerUsesExhaust, bool, true);
+
+// The number of cursors, each over its own range of _id values and on its own connection, used to
+// copy a large collection. The default of 1 copies every collection with a single cursor.
+MONGO_EXPORT_SERVER_PARAMETER(collectionClonerRangeQueries, int, 1)
+    ->withValidator([](const int& rangeQueries) {
+        return (rangeQueries >= 1 && rangeQueries <= 64)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream() << "collectionClonerRangeQueries must be between 1 and 64. '"
+                                   << rangeQueries
+                                   << "' is an invalid setting.");
+    });
+
+// The number of bytes of fetched documents that all collection cloners together may hold before
+// they are inserted. Queries stop reading from the sync source while the budget is exhausted.
+MONGO_EXPORT_SERVER_PARAMETER(collectionClonerBufferSizeBytes, int, 256 * 1024 * 1024)
+    ->withValidator([](const int& bufferSizeBytes) {
+        return (bufferSizeBytes > 0)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream() << "collectionClonerBufferSizeBytes must be greater than 0. '"
+                                   << bufferSizeBytes
+                                   << "' is an invalid setting.");
+    });
+
+// A collection is only split into range queries when each range would hold at least this many
+// documents, so small collections do not pay for the extra connections.
+const long long kMinDocumentsPerRangeQuery = 10000;
+
+// The number of _id values sampled per range query to choose the range boundaries.
+const int kSamplesPerRangeQuery = 20;
+
+/**
+ * Bounds the memory used by documents that have been fetched from the sync source but not yet
+ * inserted, across all collection cloners in the process.
+ */
+class ClonerBufferBudget {
+public:
+    /**
+     * Reserves 'bytes' of the budget, waiting up to 'timeout' for other cloners to release theirs.
+     * A reservation is always granted when nothing else is reserved, so a single batch larger
+     * than the budget cannot stall cloning.
+     */
+    bool tryAcquire(size_t bytes, Milliseconds timeout) {
+        UniqueLock lk(_mutex);
+        const auto budgetBytes = static_cast<size_t>(collectionClonerBufferSizeBytes.load());
+        auto fits = [&] { return _reservedBytes == 0 || _reservedBytes + bytes <= budgetBytes; };
+        if (!_condition.wait_for(lk, timeout.toSystemDuration(), fits)) {
+            return false;
+        }
+        _reservedBytes += bytes;
+        return true;
+    }
+
+    void release(size_t bytes) {
+        if (bytes == 0) {
+            return;
+        }
+        {
+            LockGuard lk(_mutex);
+            invariant(_reservedBytes >= bytes);
+            _reservedBytes -= bytes;
+        }
+        _condition.notify_all();
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _condition;
+    size_t _reservedBytes = 0;
+};
+
+ClonerBufferBudget clonerBufferBudget;
 }  // namespace
 
 // Failpoint which causes initial sync to hang before establishing its cursor to clone the
@@ -482,15 +557,13 @@ void CollectionCloner::_beginCollectionCallback(const executor::TaskExecutor::Ca
 
     // The query cannot run on the database work thread, because it needs to be able to
     // schedule work on that thread while still running.
+    {
+        LockGuard lk(_mutex);
+        _activeQueryTasks = 1;
+    }
     auto runQueryCallback =
         _executor->scheduleWork([this](const executor::TaskExecutor::CallbackArgs& callbackData) {
-            ON_BLOCK_EXIT([this] {
-                {
-                    stdx::lock_guard<stdx::mutex> lock(_mutex);
-                    _queryState = QueryState::kFinished;
-                }
-                _condition.notify_all();
-            });
+            ON_BLOCK_EXIT([this] { _queryTaskFinished(); });
             _runQuery(callbackData);
         });
     if (!runQueryCallback.isOK()) {
@@ -530,15 +603,9 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
         }
     }
 
-    auto conn = _createClientFn();
-    Status clientConnectionStatus = conn->connect(_source, StringData());
-    if (!clientConnectionStatus.isOK()) {
-        _finishCallback(clientConnectionStatus);
-        return;
-    }
-    if (!replAuthenticate(conn.get())) {
-        _finishCallback({ErrorCodes::AuthenticationFailed,
-                         str::stream() << "Failed to authenticate to " << _source});
+    auto conn = _connectToSource();
+    if (!conn.isOK()) {
+        _finishCallback(conn.getStatus());
         return;
     }
 
@@ -548,52 +615,245 @@ void CollectionCloner::_runQuery(const executor::TaskExecutor::CallbackArgs& cal
     auto onCompletionGuard =
         std::make_shared<OnCompletionGuard>(cancelRemainingWorkInLock, finishCallbackFn);
 
+    // Each range is [min, max) over the _id index; an empty bound leaves that side open. A single
+    // range with both bounds empty is the plain collection scan.
+    std::vector<std::pair<BSONObj, BSONObj>> ranges;
+    BSONObj lowerBound;
+    for (auto&& splitKey : _chooseRangeQuerySplitKeys(conn.getValue().get())) {
+        ranges.emplace_back(lowerBound, splitKey);
+        lowerBound = splitKey;
+    }
+    ranges.emplace_back(lowerBound, BSONObj());
+
+    {
+        LockGuard lock(_mutex);
+        _outstandingRangeQueries = ranges.size();
+        _stats.rangeQueries = ranges.size();
+    }
+    if (ranges.size() > 1) {
+        log() << "CollectionCloner ns:" << _sourceNss << " copying documents with "
+              << ranges.size() << " range queries";
+    }
+
+    for (size_t i = 1; i < ranges.size(); ++i) {
+        _scheduleRangeQuery(ranges[i].first, ranges[i].second, onCompletionGuard);
+    }
+    _runRangeQuery(conn.getValue().get(), ranges[0].first, ranges[0].second, onCompletionGuard);
+}
+
+StatusWith<std::unique_ptr<DBClientConnection>> CollectionCloner::_connectToSource() {
+    auto conn = _createClientFn();
+    Status clientConnectionStatus = conn->connect(_source, StringData());
+    if (!clientConnectionStatus.isOK()) {
+        return clientConnectionStatus;
+    }
+    if (!replAuthenticate(conn.get())) {
+        return {ErrorCodes::AuthenticationFailed,
+                str::stream() << "Failed to authenticate to " << _source};
+    }
+    return std::move(conn);
+}
+
+std::vector<BSONObj> CollectionCloner::_chooseRangeQuerySplitKeys(DBClientConnection* conn) {
+    const int rangeQueries = collectionClonerRangeQueries.load();
+    {
+        LockGuard lk(_mutex);
+        // Ranges are taken over the _id index, which only orders documents the way the split keys
+        // do when it exists and uses the simple collation. Capped collections are copied in
+        // insertion order.
+        if (rangeQueries <= 1 || _options.capped || _idIndexSpec.isEmpty() ||
+            !_options.collation.isEmpty() ||
+            static_cast<long long>(_stats.documentToCopy) <
+                rangeQueries * kMinDocumentsPerRangeQuery) {
+            return {};
+        }
+    }
+
+    const int sampleSize = rangeQueries * kSamplesPerRangeQuery;
+    BSONObj cmd = BSON("aggregate" << _sourceNss.coll() << "pipeline"
+                                   << BSON_ARRAY(BSON("$sample" << BSON("size" << sampleSize))
+                                                 << BSON("$project" << BSON("_id" << 1))
+                                                 << BSON("$sort" << BSON("_id" << 1)))
+                                   << "cursor"
+                                   << BSON("batchSize" << sampleSize));
+    std::vector<BSONObj> samples;
+    try {
+        BSONObj result;
+        conn->runCommand(_sourceNss.db().toString(), cmd, result, QueryOption_SlaveOk);
+        uassertStatusOK(getStatusFromCommandResult(result));
+        for (auto&& sample : result["cursor"]["firstBatch"].Obj()) {
+            samples.push_back(sample.Obj().getOwned());
+        }
+    } catch (const DBException& ex) {
+        LOG(1) << "CollectionCloner ns:" << _sourceNss
+               << " could not sample _id values, copying with a single query: " << redact(ex);
+        return {};
+    }
+
+    std::vector<BSONObj> splitKeys;
+    for (int i = 1; i < rangeQueries; ++i) {
+        const size_t index = i * samples.size() / rangeQueries;
+        if (index >= samples.size() || samples[index]["_id"].eoo()) {
+            continue;
+        }
+        const BSONObj& splitKey = samples[index];
+        if (!splitKeys.empty() && splitKeys.back().woCompare(splitKey) >= 0) {
+            continue;
+        }
+        splitKeys.push_back(splitKey);
+    }
+    return splitKeys;
+}
+
+void CollectionCloner::_scheduleRangeQuery(const BSONObj& min,
+                                           const BSONObj& max,
+                                           std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    {
+        LockGuard lk(_mutex);
+        ++_activeQueryTasks;
+    }
+    auto scheduleResult = _executor->scheduleWork([this, min, max, onCompletionGuard](
+        const executor::TaskExecutor::CallbackArgs& callbackData) {
+        ON_BLOCK_EXIT([this] { _queryTaskFinished(); });
+        UniqueLock lk(_mutex);
+        if (!callbackData.status.isOK()) {
+            _finishRangeQuery_inlock(lk, onCompletionGuard, callbackData.status);
+            return;
+        }
+        if (_queryState == QueryState::kCanceling) {
+            _finishRangeQuery_inlock(
+                lk,
+                onCompletionGuard,
+                {ErrorCodes::CallbackCanceled, "Collection cloning cancelled."});
+            return;
+        }
+        lk.unlock();
+
+        auto conn = _connectToSource();
+        if (!conn.isOK()) {
+            lk.lock();
+            onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, conn.getStatus());
+            _finishRangeQuery_inlock(lk, onCompletionGuard, conn.getStatus());
+            return;
+        }
+        _runRangeQuery(conn.getValue().get(), min, max, onCompletionGuard);
+    });
+    if (!scheduleResult.isOK()) {
+        UniqueLock lk(_mutex);
+        --_activeQueryTasks;
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, scheduleResult.getStatus());
+        _finishRangeQuery_inlock(lk, onCompletionGuard, scheduleResult.getStatus());
+    }
+}
+
+void CollectionCloner::_runRangeQuery(DBClientConnection* conn,
+                                      const BSONObj& min,
+                                      const BSONObj& max,
+                                      std::shared_ptr<OnCompletionGuard> onCompletionGuard) {
+    Query query;
+    if (!min.isEmpty() || !max.isEmpty()) {
+        query.hint(BSON("_id" << 1));
+        if (!min.isEmpty()) {
+            query.minKey(min);
+        }
+        if (!max.isEmpty()) {
+            query.maxKey(max);
+        }
+    }
+
+    Status queryStatus = Status::OK();
     try {
         conn->query(
             [this, onCompletionGuard](DBClientCursorBatchIterator& iter) {
                 _handleNextBatch(onCompletionGuard, iter);
             },
             NamespaceStringOrUUID(_sourceNss.db().toString(), *_options.uuid),
-            Query(),
+            query,
             nullptr /* fieldsToReturn */,
             QueryOption_NoCursorTimeout | QueryOption_SlaveOk |
                 (collectionClonerUsesExhaust ? QueryOption_Exhaust : 0),
             _collectionClonerBatchSize);
     } catch (const DBException& e) {
-        auto queryStatus = e.toStatus().withContext(str::stream() << "Error querying collection '"
-                                                                  << _sourceNss.ns());
-        stdx::unique_lock<stdx::mutex> lock(_mutex);
-        if (queryStatus.code() == ErrorCodes::OperationFailed ||
-            queryStatus.code() == ErrorCodes::CursorNotFound) {
-            // With these errors, it's possible the collection was dropped while we were
-            // cloning.  If so, we'll execute the drop during oplog application, so it's OK to
-            // just stop cloning.
-            _verifyCollectionWasDropped(lock, queryStatus, onCompletionGuard);
-            return;
-        } else if (queryStatus.code() != ErrorCodes::NamespaceNotFound) {
-            // NamespaceNotFound means the collection was dropped before we started cloning, so
-            // we're OK to ignore the error.  Any other error we must report.
-            onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, queryStatus);
+        queryStatus = e.toStatus().withContext(str::stream() << "Error querying collection '"
+                                                             << _sourceNss.ns());
+    }
+
+    UniqueLock lock(_mutex);
+    if (queryStatus.code() == ErrorCodes::OperationFailed ||
+        queryStatus.code() == ErrorCodes::CursorNotFound) {
+        // With these errors, it's possible the collection was dropped while we were
+        // cloning.  If so, we'll execute the drop during oplog application, so it's OK to
+        // just stop cloning.
+        _verifyCollectionWasDropped(lock, queryStatus, onCompletionGuard);
+    } else if (queryStatus.code() == ErrorCodes::NamespaceNotFound) {
+        // NamespaceNotFound means the collection was dropped before we started cloning, so
+        // we're OK to ignore the error.
+        queryStatus = Status::OK();
+    } else if (!queryStatus.isOK()) {
+        // Any other error we must report.
+        onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, queryStatus);
+    }
+    _finishRangeQuery_inlock(lock, onCompletionGuard, queryStatus);
+}
+
+void CollectionCloner::_finishRangeQuery_inlock(
+    UniqueLock& lk, std::shared_ptr<OnCompletionGuard> onCompletionGuard, const Status& status) {
+    invariant(_outstandingRangeQueries > 0);
+    --_outstandingRangeQueries;
+    if (!status.isOK()) {
+        // The failed query has already set (or is verifying) the result.
+        _rangeQueryFailed = true;
+        return;
+    }
+    if (_outstandingRangeQueries > 0 || _rangeQueryFailed) {
+        return;
+    }
+
+    // The last range query to finish waits for the remaining inserts and completes cloning.
+    lk.unlock();
+    waitForDbWorker();
+    lk.lock();
+    onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, Status::OK());
+}
+
+void CollectionCloner::_queryTaskFinished() {
+    {
+        LockGuard lk(_mutex);
+        invariant(_activeQueryTasks > 0);
+        if (--_activeQueryTasks > 0) {
             return;
         }
+        _queryState = QueryState::kFinished;
     }
-    waitForDbWorker();
-    stdx::lock_guard<stdx::mutex> lock(_mutex);
-    onCompletionGuard->setResultAndCancelRemainingWork_inlock(lock, Status::OK());
+    _condition.notify_all();
 }
 
 void CollectionCloner::_handleNextBatch(std::shared_ptr<OnCompletionGuard> onCompletionGuard,
                                         DBClientCursorBatchIterator& iter) {
-    _stats.receivedBatches++;
+    std::vector<BSONObj> batch;
+    size_t batchBytes = 0;
+    while (iter.moreInCurrentBatch()) {
+        BSONObj o = iter.nextSafe();
+        batchBytes += o.objsize();
+        batch.emplace_back(std::move(o));
+    }
+
+    // Stop reading from the sync source until the inserts of all cloners catch up.
+    while (!clonerBufferBudget.tryAcquire(batchBytes, Milliseconds(100))) {
+        LockGuard lk(_mutex);
+        uassert(ErrorCodes::CallbackCanceled,
+                "Collection cloning cancelled.",
+                _queryState != QueryState::kCanceling);
+    }
+
     {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stats.receivedBatches++;
+        _bufferedBytes += batchBytes;
+        std::move(batch.begin(), batch.end(), std::back_inserter(_documentsToInsert));
         uassert(ErrorCodes::CallbackCanceled,
                 "Collection cloning cancelled.",
                 _queryState != QueryState::kCanceling);
-        while (iter.moreInCurrentBatch()) {
-            BSONObj o = iter.nextSafe();
-            _documentsToInsert.emplace_back(std::move(o));
-        }
     }
 
     // Schedule the next document batch insertion.
@@ -696,15 +956,23 @@ void CollectionCloner::_insertDocumentsCallback(
     UniqueLock lk(_mutex);
     std::vector<BSONObj> docs;
     if (_documentsToInsert.size() == 0) {
-        warning() << "_insertDocumentsCallback, but no documents to insert for ns:" << _destNss;
+        // With several range queries an earlier insert may already have taken these documents.
+        if (_stats.rangeQueries <= 1) {
+            warning() << "_insertDocumentsCallback, but no documents to insert for ns:"
+                      << _destNss;
+        }
         return;
     }
     _documentsToInsert.swap(docs);
+    const size_t bytes = std::exchange(_bufferedBytes, 0);
+    ON_BLOCK_EXIT([bytes] { clonerBufferBudget.release(bytes); });
     _stats.documentsCopied += docs.size();
+    _stats.bytesCopied += bytes;
     ++_stats.fetchedBatches;
     _progressMeter.hit(int(docs.size()));
     invariant(_collLoader);
     const auto status = _collLoader->insertDocuments(docs.cbegin(), docs.cend());
+    _stats.lastInsert = _executor->now();
     if (!status.isOK()) {
         onCompletionGuard->setResultAndCancelRemainingWork_inlock(lk, status);
         return;
@@ -738,6 +1006,10 @@ void CollectionCloner::_finishCallback(const Status& status) {
 
         callCollectionLoader = _collLoader.operator bool();
 
+        // Documents that were fetched but never inserted give their share of the buffer back.
+        _documentsToInsert.clear();
+        clonerBufferBudget.release(std::exchange(_bufferedBytes, 0));
+
         invariant(_onCompletion);
         std::swap(_onCompletion, onCompletion);
     }
@@ -798,8 +1070,21 @@ void CollectionCloner::Stats::append(BSONObjBuilder* builder) const {
             long long elapsedMillis = duration_cast<Milliseconds>(elapsed).count();
             builder->appendNumber("elapsedMillis", elapsedMillis);
         }
+        // Throughput so far, measured up to the most recent insert.
+        const auto copyMillis =
+            duration_cast<Milliseconds>((end != Date_t() ? end : lastInsert) - start).count();
+        if (lastInsert != Date_t() && copyMillis > 0) {
+            builder->appendNumber("documentsPerSecond",
+                                  static_cast<long long>(documentsCopied * 1000 / copyMillis));
+            builder->appendNumber("bytesPerSecond",
+                                  static_cast<long long>(bytesCopied * 1000 / copyMillis));
+        }
     }
     builder->appendNumber("receivedBatches", receivedBatches);
+    builder->appendNumber("bytesCopied", bytesCopied);
+    if (rangeQueries > 1) {
+        builder->appendNumber("rangeQueries", rangeQueries);
+    }
 }
 }  // namespace repl
 }  // namespace mongo
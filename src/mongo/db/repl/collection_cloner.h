@@ -81,6 +81,9 @@ public:
         size_t indexes{0};
         size_t fetchedBatches{0};  // This is actually inserted batches.
         size_t receivedBatches{0};
+        size_t bytesCopied{0};
+        size_t rangeQueries{0};  // The number of _id range queries the documents are copied with.
+        Date_t lastInsert;
 
         std::string toString() const;
         BSONObj toBSON() const;
@@ -217,6 +220,48 @@ private:
      */
     void _runQuery(const executor::TaskExecutor::CallbackArgs& callbackData);
 
+    /**
+     * Creates a connection to the sync source and authenticates it.
+     */
+    StatusWith<std::unique_ptr<DBClientConnection>> _connectToSource();
+
+    /**
+     * Returns the _id values at which to split the collection into 'collectionClonerRangeQueries'
+     * ranges, chosen from a sample of the collection. Returns no split keys, meaning the
+     * collection is copied with a single query, when the collection is too small or cannot be
+     * split on _id.
+     */
+    std::vector<BSONObj> _chooseRangeQuerySplitKeys(DBClientConnection* conn);
+
+    /**
+     * Schedules a query for the documents with _id in [min, max) on its own connection.
+     */
+    void _scheduleRangeQuery(const BSONObj& min,
+                             const BSONObj& max,
+                             std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Executes the query for the documents with _id in [min, max) on 'conn'. An empty bound leaves
+     * that side of the range open. Returns when the query is finished or failed.
+     */
+    void _runRangeQuery(DBClientConnection* conn,
+                        const BSONObj& min,
+                        const BSONObj& max,
+                        std::shared_ptr<OnCompletionGuard> onCompletionGuard);
+
+    /**
+     * Records the end of a range query. Once the last one succeeds, waits for outstanding inserts
+     * and completes cloning. May release 'lk' temporarily.
+     */
+    void _finishRangeQuery_inlock(stdx::unique_lock<stdx::mutex>& lk,
+                                  std::shared_ptr<OnCompletionGuard> onCompletionGuard,
+                                  const Status& status);
+
+    /**
+     * Marks the query as finished once the last task running a query returns.
+     */
+    void _queryTaskFinished();
+
     /**
      * Put all results from a query batch into a buffer to be inserted, and schedule
      * it to be inserted.
@@ -273,6 +318,10 @@ private:
     std::vector<BSONObj> _indexSpecs;             // (M)
     BSONObj _idIndexSpec;                         // (M)
     std::vector<BSONObj> _documentsToInsert;      // (M) Documents read from source to insert.
+    size_t _bufferedBytes = 0;                    // (M) Size of '_documentsToInsert'.
+    size_t _activeQueryTasks = 0;                 // (M) Executor tasks running a query.
+    size_t _outstandingRangeQueries = 0;          // (M) Range queries not yet finished.
+    bool _rangeQueryFailed = false;               // (M) Whether any range query failed.
     TaskRunner _dbWorkTaskRunner;                 // (R)
     ScheduleDbWorkFn
         _scheduleDbWorkFn;  // (RT) Function for scheduling database work using the executor.
@@ -27,6 +27,7 @@
  */
 #include "mongo/platform/basic.h"
 
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include "mongo/db/repl/collection_cloner.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/storage_interface_mock.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/task_executor_proxy.h"
@@ -1055,6 +1057,175 @@ TEST_F(CollectionClonerTest, InsertDocumentsMultipleBatches) {
     ASSERT_FALSE(collectionCloner->isActive());
 }
 
+TEST_F(CollectionClonerTest, InsertDocumentsReportsBytesCopiedWithASingleQuery) {
+    // Set up documents to be returned from upstream node.
+    const auto doc1 = BSON("_id" << 1 << "x" << std::string(100, 'a'));
+    const auto doc2 = BSON("_id" << 2);
+    _server->insert(nss.ns(), doc1);
+    _server->insert(nss.ns(), doc2);
+
+    ASSERT_OK(collectionCloner->startup());
+    ASSERT_TRUE(collectionCloner->isActive());
+
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(2));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+
+    auto stats = collectionCloner->getStats();
+    ASSERT_EQUALS(2u, stats.documentsCopied);
+    ASSERT_EQUALS(static_cast<size_t>(doc1.objsize() + doc2.objsize()), stats.bytesCopied);
+    ASSERT_EQUALS(1u, stats.rangeQueries);
+    auto statsObj = stats.toBSON();
+    ASSERT_EQUALS(doc1.objsize() + doc2.objsize(), statsObj["bytesCopied"].numberInt());
+    ASSERT_FALSE(statsObj.hasField("rangeQueries")) << statsObj;
+}
+
+/**
+ * Copies collections large enough to be split into two _id range queries. Every connection the
+ * cloner creates is a new client, so that each range query can be paused or failed on its own.
+ */
+class CollectionClonerRangeQueryTest : public CollectionClonerTest {
+protected:
+    void setUp() override {
+        CollectionClonerTest::setUp();
+
+        _rangeQueriesParam =
+            ServerParameterSet::getGlobal()->getMap().find("collectionClonerRangeQueries")->second;
+        ASSERT_OK(_rangeQueriesParam->setFromString("2"));
+
+        collectionCloner->setCreateClientFn_forTest([this]() {
+            auto client =
+                stdx::make_unique<FailableMockDBClientConnection>(_server.get(), getNet());
+            stdx::lock_guard<stdx::mutex> lk(_clientsMutex);
+            if (_rangeClients.size() == _pausedClient) {
+                client->pause();
+            }
+            if (_rangeClients.size() == _failingClient) {
+                client->setFailureForQuery({ErrorCodes::HostUnreachable, "injected failure"});
+            }
+            _rangeClients.push_back(client.get());
+            _clientsCondition.notify_all();
+            return std::unique_ptr<DBClientConnection>(std::move(client));
+        });
+
+        // The first connection samples the collection and reads the documents with _id below 3,
+        // the second one those from 3 on.
+        for (int i = 1; i <= 4; ++i) {
+            _server->insert(nss.ns(), BSON("_id" << i));
+        }
+        _server->setCommandReply("aggregate",
+                                 BSON("cursor" << BSON("id" << 0LL << "ns" << nss.ns()
+                                                            << "firstBatch"
+                                                            << BSON_ARRAY(BSON("_id" << 1)
+                                                                          << BSON("_id" << 2)
+                                                                          << BSON("_id" << 3)
+                                                                          << BSON("_id" << 4)))
+                                               << "ok"
+                                               << 1));
+    }
+
+    void tearDown() override {
+        ASSERT_OK(_rangeQueriesParam->setFromString("1"));
+        CollectionClonerTest::tearDown();
+    }
+
+    // Starts the cloner and answers its count and listIndexes requests. The count is large enough
+    // for the collection to be split.
+    void startCloning() {
+        ASSERT_OK(collectionCloner->startup());
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(20000));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+
+    // Returns the client for the 'i'-th connection, waiting for it to be created. The client is
+    // only valid until its query returns.
+    FailableMockDBClientConnection* waitForClient(size_t i) {
+        stdx::unique_lock<stdx::mutex> lk(_clientsMutex);
+        _clientsCondition.wait(lk, [&] { return _rangeClients.size() > i; });
+        return _rangeClients[i];
+    }
+
+    static constexpr size_t kNoClient = std::numeric_limits<size_t>::max();
+
+    size_t _pausedClient = kNoClient;
+    size_t _failingClient = kNoClient;
+    ServerParameter* _rangeQueriesParam;
+
+private:
+    stdx::mutex _clientsMutex;
+    stdx::condition_variable _clientsCondition;
+    std::vector<FailableMockDBClientConnection*> _rangeClients;
+};
+
+constexpr size_t CollectionClonerRangeQueryTest::kNoClient;
+
+TEST_F(CollectionClonerRangeQueryTest, SplitsLargeCollectionIntoRangeQueries) {
+    startCloning();
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+
+    // Each range query read its own half of the collection.
+    ASSERT_EQUALS(2U, _server->getQueryCount());
+    ASSERT_EQUALS(4, collectionStats.insertCount);
+    ASSERT_TRUE(collectionStats.commitCalled);
+
+    auto stats = collectionCloner->getStats();
+    ASSERT_EQUALS(4U, stats.documentsCopied);
+    ASSERT_EQUALS(2U, stats.rangeQueries);
+    ASSERT_EQUALS(2, stats.toBSON()["rangeQueries"].numberInt());
+}
+
+TEST_F(CollectionClonerRangeQueryTest, SmallCollectionIsCopiedWithASingleQuery) {
+    ASSERT_OK(collectionCloner->startup());
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createCountResponse(4));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+
+    ASSERT_EQUALS(1U, _server->getQueryCount());
+    ASSERT_EQUALS(4, collectionStats.insertCount);
+    ASSERT_EQUALS(1U, collectionCloner->getStats().rangeQueries);
+}
+
+TEST_F(CollectionClonerRangeQueryTest, FailureInOneRangeQueryFailsTheClone) {
+    _failingClient = 1;
+    startCloning();
+    collectionCloner->join();
+
+    ASSERT_EQUALS(ErrorCodes::HostUnreachable, getStatus().code());
+    ASSERT_FALSE(collectionCloner->isActive());
+    ASSERT_FALSE(collectionStats.commitCalled);
+}
+
+TEST_F(CollectionClonerRangeQueryTest, LastRangeQueryToFinishCompletesTheClone) {
+    // Hold the first range query until the second one has read its documents.
+    _pausedClient = 0;
+    startCloning();
+
+    MockClientPauser pauser(waitForClient(0));
+    waitForClient(0)->waitForPausedQuery();
+    while (_server->getQueryCount() < 1) {
+        mongo::sleepmillis(10);
+    }
+    ASSERT_TRUE(collectionCloner->isActive());
+    ASSERT_FALSE(collectionStats.commitCalled);
+
+    pauser.resume();
+    collectionCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_EQUALS(2U, _server->getQueryCount());
+    ASSERT_EQUALS(4, collectionStats.insertCount);
+    ASSERT_TRUE(collectionStats.commitCalled);
+}
+
 TEST_F(CollectionClonerTest, CollectionClonerTransitionsToCompleteIfShutdownBeforeStartup) {
     collectionCloner->shutdown();
     ASSERT_EQUALS(ErrorCodes::ShutdownInProgress, collectionCloner->startup());
@@ -81,6 +81,19 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(collectionClonerBatchSize, int, 0)
 // The number of attempts for the listCollections commands.
 MONGO_EXPORT_SERVER_PARAMETER(numInitialSyncListCollectionsAttempts, int, 3);
 
+// The number of collections of a database that are cloned at the same time. Their fetched documents
+// share the memory budget set by 'collectionClonerBufferSizeBytes'.
+MONGO_EXPORT_SERVER_PARAMETER(initialSyncMaxConcurrentCollectionClones, int, 1)
+    ->withValidator([](const int& maxClones) {
+        return (maxClones >= 1)
+            ? Status::OK()
+            : Status(ErrorCodes::BadValue,
+                     str::stream()
+                         << "initialSyncMaxConcurrentCollectionClones must be at least 1. '"
+                         << maxClones
+                         << "' is an invalid setting.");
+    });
+
 // Failpoint which causes initial sync to hang right after listCollections, but before cloning
 // any colelctions in the 'database' database.
 MONGO_FAIL_POINT_DEFINE(initialSyncHangAfterListCollections);
@@ -421,18 +434,32 @@ void DatabaseCloner::_listCollectionsCallback(const StatusWith<Fetcher::QueryRes
         }
     }
 
-    // Start first collection cloner.
-    _currentCollectionClonerIter = _collectionCloners.begin();
+    // Start the first collection cloners.
+    _nextCollectionClonerIter = _collectionCloners.begin();
+    _startCollectionClonerStatus = _startCollectionCloners_inlock();
+    if (!_startCollectionClonerStatus.isOK() && _activeCollectionCloners == 0) {
+        _finishCallback_inlock(lk, _startCollectionClonerStatus);
+        return;
+    }
+}
 
-    LOG(1) << "    cloning collection " << _currentCollectionClonerIter->getSourceNamespace();
+Status DatabaseCloner::_startCollectionCloners_inlock() {
+    const auto maxActive =
+        static_cast<size_t>(std::max(1, initialSyncMaxConcurrentCollectionClones.load()));
+    while (_nextCollectionClonerIter != _collectionCloners.end() &&
+           _activeCollectionCloners < maxActive) {
+        auto& collectionCloner = *_nextCollectionClonerIter++;
+        LOG(1) << "    cloning collection " << collectionCloner.getSourceNamespace();
 
-    Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-    if (!startStatus.isOK()) {
-        LOG(1) << "    failed to start collection cloning on "
-               << _currentCollectionClonerIter->getSourceNamespace() << ": " << redact(startStatus);
-        _finishCallback_inlock(lk, startStatus);
-        return;
+        Status startStatus = _startCollectionCloner(collectionCloner);
+        if (!startStatus.isOK()) {
+            LOG(1) << "    failed to start collection cloning on "
+                   << collectionCloner.getSourceNamespace() << ": " << redact(startStatus);
+            return startStatus;
+        }
+        ++_activeCollectionCloners;
     }
+    return Status::OK();
 }
 
 void DatabaseCloner::_collectionClonerCallback(const Status& status, const NamespaceString& nss) {
@@ -452,17 +479,19 @@ void DatabaseCloner::_collectionClonerCallback(const Status& status, const Names
     lk.unlock();
     _collectionWork(newStatus, nss);
     lk.lock();
-    _currentCollectionClonerIter++;
+    invariant(_activeCollectionCloners > 0);
+    --_activeCollectionCloners;
 
-    if (_currentCollectionClonerIter != _collectionCloners.end()) {
-        Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-        if (!startStatus.isOK()) {
-            LOG(1) << "    failed to start collection cloning on "
-                   << _currentCollectionClonerIter->getSourceNamespace() << ": "
-                   << redact(startStatus);
-            _finishCallback_inlock(lk, startStatus);
-            return;
-        }
+    // No more cloners are started once one has failed to start; the database cloner finishes with
+    // that error when the cloners that are still running are done.
+    if (_startCollectionClonerStatus.isOK()) {
+        _startCollectionClonerStatus = _startCollectionCloners_inlock();
+    }
+    if (_activeCollectionCloners > 0) {
+        return;
+    }
+    if (!_startCollectionClonerStatus.isOK()) {
+        _finishCallback_inlock(lk, _startCollectionClonerStatus);
         return;
     }
 
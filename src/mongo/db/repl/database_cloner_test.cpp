@@ -38,10 +38,12 @@
 #include "mongo/db/repl/base_cloner_test_fixture.h"
 #include "mongo/db/repl/database_cloner.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/dbtests/mock/mock_dbclient_connection.h"
 #include "mongo/unittest/task_executor_proxy.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/uuid.h"
 
 namespace {
@@ -905,4 +907,55 @@ TEST_F(DatabaseClonerTest, CreateCollections) {
     stats.commitCalled = true;
 }
 
+TEST_F(DatabaseClonerTest, CreateCollectionsConcurrently) {
+    auto maxClonesParam = ServerParameterSet::getGlobal()
+                              ->getMap()
+                              .find("initialSyncMaxConcurrentCollectionClones")
+                              ->second;
+    ASSERT_OK(maxClonesParam->setFromString("2"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(maxClonesParam->setFromString("1")); });
+
+    ASSERT_OK(_databaseCloner->startup());
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        processNetworkResponse(createListCollectionsResponse(
+            0,
+            BSON_ARRAY(BSON("name"
+                            << "a"
+                            << "options"
+                            << _options1.toBSON())
+                       << BSON("name"
+                               << "b"
+                               << "options"
+                               << _options2.toBSON()))));
+    }
+    ASSERT_TRUE(_databaseCloner->isActive());
+
+    // Both collection cloners start right away, so both count requests are sent before either
+    // collection has been copied.
+    {
+        executor::NetworkInterfaceMock::InNetworkGuard guard(getNet());
+        auto countA = getNet()->getNextReadyRequest();
+        ASSERT_EQUALS("count", std::string(countA->getRequest().cmdObj.firstElementFieldName()));
+        ASSERT_TRUE(getNet()->hasReadyRequests());
+        auto countB = getNet()->getNextReadyRequest();
+        ASSERT_EQUALS("count", std::string(countB->getRequest().cmdObj.firstElementFieldName()));
+
+        scheduleNetworkResponse(countA, createCountResponse(0));
+        scheduleNetworkResponse(countB, createCountResponse(0));
+        getNet()->runReadyNetworkOperations();
+
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+        processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    }
+
+    _databaseCloner->join();
+    ASSERT_OK(getStatus());
+    ASSERT_EQUALS(DatabaseCloner::State::kComplete, _databaseCloner->getState_forTest());
+
+    ASSERT_EQUALS(2U, _collections.size());
+    ASSERT_OK(_collections[NamespaceString{"db.a"}].status);
+    ASSERT_OK(_collections[NamespaceString{"db.b"}].status);
+}
+
 }  // namespace
@@ -181,8 +181,13 @@ DbCheckHasher::DbCheckHasher(OperationContext* opCtx,
                              const BSONKey& start,
                              const BSONKey& end,
                              int64_t maxCount,
-                             int64_t maxBytes)
-    : _opCtx(opCtx), _maxKey(end), _maxCount(maxCount), _maxBytes(maxBytes) {
+                             int64_t maxBytes,
+                             DbCheckHashAlgorithmEnum algorithm)
+    : _opCtx(opCtx),
+      _algorithm(algorithm),
+      _maxKey(end),
+      _maxCount(maxCount),
+      _maxBytes(maxBytes) {
 
     // Get the MD5 hasher set up.
     md5_init(&_state);
@@ -292,7 +297,11 @@ Status DbCheckHasher::hashAll(void) {
         _bytesSeen += currentObj.objsize();
         _countSeen += 1;
 
-        md5_append(&_state, md5Cast(currentObj.objdata()), currentObj.objsize());
+        if (_algorithm == DbCheckHashAlgorithmEnum::murmur3) {
+            _multiset.add(currentObj.objdata(), currentObj.objsize());
+        } else {
+            md5_append(&_state, md5Cast(currentObj.objdata()), currentObj.objsize());
+        }
     }
 
     // If we got to the end of the collection, set the last key to MaxKey.
@@ -304,6 +313,10 @@ Status DbCheckHasher::hashAll(void) {
 }
 
 std::string DbCheckHasher::total(void) {
+    if (_algorithm == DbCheckHashAlgorithmEnum::murmur3) {
+        return _multiset.toString();
+    }
+
     md5digest digest;
     md5_finish(&_state, digest);
 
@@ -408,7 +421,13 @@ Status dbCheckBatchOnSecondary(OperationContext* opCtx,
     Status status = Status::OK();
     boost::optional<DbCheckHasher> hasher;
     try {
-        hasher.emplace(opCtx, collection, entry.getMinKey(), entry.getMaxKey());
+        hasher.emplace(opCtx,
+                       collection,
+                       entry.getMinKey(),
+                       entry.getMaxKey(),
+                       std::numeric_limits<int64_t>::max(),
+                       std::numeric_limits<int64_t>::max(),
+                       entry.getHashAlgorithm().value_or(DbCheckHashAlgorithmEnum::md5));
     } catch (const DBException& exception) {
         auto logEntry = dbCheckErrorHealthLogEntry(
             entry.getNss(), msg, OplogEntriesEnum::Batch, exception.toStatus());
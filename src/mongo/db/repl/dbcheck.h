@@ -35,6 +35,7 @@
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/repl/dbcheck_gen.h"
 #include "mongo/util/md5.hpp"
+#include "mongo/util/multiset_hash.h"
 
 namespace mongo {
 
@@ -89,7 +90,8 @@ std::unique_ptr<HealthLogEntry> dbCheckCollectionEntry(const NamespaceString& ns
 /**
  * Hashing collections and plans.
  *
- * Provides MD5-based hashing of ranges of documents.  Note that this class does *not* provide
+ * Provides MD5-based hashing of ranges of documents, or with DbCheckHashAlgorithmEnum::murmur3 a
+ * faster, non-cryptographic MultisetHash of them.  Note that this class does *not* provide
  * synchronization: clients must, for example, lock the database to ensure that named collections
  * exist, and hold at least a MODE_IS lock before asking a `DbCheckHasher` to retrieve any
  * documents.
@@ -108,13 +110,15 @@ public:
      * @param end The last key to hash (inclusive).
      * @param maxCount The maximum number of documents to hash.
      * @param maxBytes The maximum number of bytes to hash.
+     * @param algorithm The hash to compute.
      */
     DbCheckHasher(OperationContext* opCtx,
                   Collection* collection,
                   const BSONKey& start,
                   const BSONKey& end,
                   int64_t maxCount = std::numeric_limits<int64_t>::max(),
-                  int64_t maxBytes = std::numeric_limits<int64_t>::max());
+                  int64_t maxBytes = std::numeric_limits<int64_t>::max(),
+                  DbCheckHashAlgorithmEnum algorithm = DbCheckHashAlgorithmEnum::md5);
 
     /**
      * Hash all of our documents.
@@ -145,7 +149,9 @@ private:
 
     OperationContext* _opCtx;
     std::unique_ptr<PlanExecutor, PlanExecutor::Deleter> _exec;
+    DbCheckHashAlgorithmEnum _algorithm;
     md5_state_t _state;
+    MultisetHash _multiset;
 
     BSONKey _maxKey;
     BSONKey _last = BSONKey::min();
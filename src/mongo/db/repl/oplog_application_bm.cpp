@@ -0,0 +1,287 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/client.h"
+#include "mongo/db/repl/drop_pending_collection_reaper.h"
+#include "mongo/db/repl/idempotency_test_fixture.h"
+#include "mongo/db/repl/oplog.h"
+#include "mongo/db/repl/oplog_applier.h"
+#include "mongo/db/repl/replication_consistency_markers_mock.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/repl/storage_interface_impl.h"
+#include "mongo/db/repl/sync_tail.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+constexpr int kBatchSize = 5000;
+constexpr int kNumIndexedFields = 8;
+
+/**
+ * Starts a standalone storage layer on the default test engine and sets it up the way a secondary
+ * applying oplog batches is: with an oplog, consistency markers and a writer thread pool. Each of
+ * the 'numCollections' collections has 'numIndexes' secondary indexes in addition to _id.
+ */
+class OplogApplicationBenchmarkFixture final : public ServiceContextMongoDTest {
+public:
+    OplogApplicationBenchmarkFixture(int numCollections, int numIndexes, int numWriters)
+        : _numWriters(numWriters), _random(numCollections * 1000 + numIndexes) {
+        auto service = getServiceContext();
+        _opCtx = cc().makeOperationContext();
+
+        ReplicationCoordinator::set(service,
+                                    stdx::make_unique<ReplicationCoordinatorMock>(service));
+        auto replCoord = ReplicationCoordinator::get(_opCtx.get());
+        uassertStatusOK(replCoord->setFollowerMode(MemberState::RS_PRIMARY));
+
+        _storageInterface = stdx::make_unique<StorageInterfaceImpl>();
+        DropPendingCollectionReaper::set(
+            service, stdx::make_unique<DropPendingCollectionReaper>(_storageInterface.get()));
+        setOplogCollectionName(service);
+        createOplog(_opCtx.get());
+        _consistencyMarkers = stdx::make_unique<ReplicationConsistencyMarkersMock>();
+
+        // Nothing creates a featureCompatibilityVersion document to initialize this from.
+        serverGlobalParams.featureCompatibility.setVersion(
+            ServerGlobalParams::FeatureCompatibility::Version::kFullyUpgradedTo42);
+
+        for (int i = 0; i < numCollections; ++i) {
+            CollectionState coll;
+            coll.nss = NamespaceString("oplog_application_bm.coll" + std::to_string(i));
+            _createCollection(coll.nss, numIndexes);
+            _collections.push_back(coll);
+        }
+
+        uassertStatusOK(replCoord->setFollowerMode(MemberState::RS_SECONDARY));
+
+        _writerPool = OplogApplier::makeWriterPool(numWriters);
+        _syncTail = stdx::make_unique<SyncTail>(
+            nullptr,
+            _consistencyMarkers.get(),
+            _storageInterface.get(),
+            [this](OperationContext* opCtx,
+                   MultiApplier::OperationPtrs* ops,
+                   SyncTail* st,
+                   WorkerMultikeyPathInfo* workerMultikeyPathInfo) {
+                const auto numOps = static_cast<long long>(ops->size());
+                Timer timer;
+                auto status = multiSyncApply(opCtx, ops, st, workerMultikeyPathInfo);
+                _recordWriterApply(numOps, timer.micros());
+                return status;
+            },
+            _writerPool.get());
+    }
+
+    ~OplogApplicationBenchmarkFixture() {
+        _syncTail.reset();
+        _writerPool->shutdown();
+        _writerPool->join();
+        _opCtx.reset();
+        DropPendingCollectionReaper::set(getServiceContext(), {});
+    }
+
+    /**
+     * Returns a batch of kBatchSize inserts, updates and deletes spread uniformly over the
+     * collections, in a 6:3:1 ratio once the collections have documents to update and delete.
+     * Optimes follow on from the previous batch.
+     */
+    MultiApplier::Operations makeBatch() {
+        MultiApplier::Operations ops;
+        ops.reserve(kBatchSize);
+        ++_batchSeconds;
+        for (int i = 0; i < kBatchSize; ++i) {
+            const OpTime opTime(Timestamp(Seconds(_batchSeconds), i + 1), 1LL);
+            auto& coll = _collections[_random.nextInt32(_collections.size())];
+            const int dice = _random.nextInt32(10);
+            if (dice < 6 || coll.nextIdToDelete == coll.nextIdToInsert) {
+                ops.push_back(makeInsertDocumentOplogEntry(
+                    opTime, coll.nss, _makeDocument(coll.nextIdToInsert++)));
+            } else if (dice < 9) {
+                const long long id = coll.nextIdToDelete +
+                    _random.nextInt64(coll.nextIdToInsert - coll.nextIdToDelete);
+                ops.push_back(makeUpdateDocumentOplogEntry(
+                    opTime,
+                    coll.nss,
+                    BSON("_id" << id),
+                    BSON("$set" << BSON("i0" << _random.nextInt32() << "i1"
+                                             << _random.nextInt32()))));
+            } else {
+                ops.push_back(makeDeleteDocumentOplogEntry(
+                    opTime, coll.nss, BSON("_id" << coll.nextIdToDelete++)));
+            }
+        }
+        return ops;
+    }
+
+    /**
+     * Applies 'ops' as a secondary would, through SyncTail::multiApply() and the writer pool.
+     */
+    void applyBatch(MultiApplier::Operations ops) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _maxOpsForOneWriterInBatch = 0;
+        }
+
+        Timer timer;
+        uassertStatusOK(_syncTail->multiApply(_opCtx.get(), std::move(ops)).getStatus());
+        _applyMicros += timer.micros();
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _maxWriterShareSum += static_cast<double>(_maxOpsForOneWriterInBatch) / kBatchSize;
+        ++_numBatches;
+    }
+
+    /**
+     * Reports the share of the writer threads' time spent applying operations over the whole
+     * multiApply() call, which includes the oplog writes, and the average share of each batch
+     * given to the most loaded writer.
+     */
+    void reportWriterStats(benchmark::State& state) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_numBatches == 0 || _applyMicros == 0) {
+            return;
+        }
+        state.counters["writerUtilization"] =
+            static_cast<double>(_writerBusyMicros) / (_applyMicros * _numWriters);
+        state.counters["maxWriterShare"] = _maxWriterShareSum / _numBatches;
+        state.counters["writersUsedPerBatch"] =
+            static_cast<double>(_writersUsed) / static_cast<double>(_numBatches);
+    }
+
+private:
+    struct CollectionState {
+        NamespaceString nss;
+        // Documents in [nextIdToDelete, nextIdToInsert) exist.
+        long long nextIdToInsert = 0;
+        long long nextIdToDelete = 0;
+    };
+
+    void _doTest() override {}
+
+    void _createCollection(const NamespaceString& nss, int numIndexes) {
+        uassertStatusOK(_storageInterface->createCollection(_opCtx.get(), nss, {}));
+
+        UnreplicatedWritesBlock uwb(_opCtx.get());
+        AutoGetCollection autoColl(_opCtx.get(), nss, MODE_X);
+        auto indexCatalog = autoColl.getCollection()->getIndexCatalog();
+        WriteUnitOfWork wuow(_opCtx.get());
+        for (int i = 0; i < numIndexes; ++i) {
+            const std::string field = "i" + std::to_string(i % kNumIndexedFields);
+            auto spec = BSON("v" << 2 << "key" << BSON(field << 1 << "_id" << 1) << "name"
+                                 << (field + "_" + std::to_string(i))
+                                 << "ns"
+                                 << nss.ns());
+            uassertStatusOK(indexCatalog->createIndexOnEmptyCollection(_opCtx.get(), spec));
+        }
+        wuow.commit();
+    }
+
+    BSONObj _makeDocument(long long id) {
+        BSONObjBuilder builder;
+        builder.append("_id", id);
+        for (int i = 0; i < kNumIndexedFields; ++i) {
+            builder.append("i" + std::to_string(i), _random.nextInt32());
+        }
+        builder.append("padding", std::string(200, 'x'));
+        return builder.obj();
+    }
+
+    void _recordWriterApply(long long numOps, long long micros) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _writerBusyMicros += micros;
+        _maxOpsForOneWriterInBatch = std::max(_maxOpsForOneWriterInBatch, numOps);
+        ++_writersUsed;
+    }
+
+    const int _numWriters;
+    PseudoRandom _random;
+    long long _batchSeconds = 100;
+    std::vector<CollectionState> _collections;
+
+    ServiceContext::UniqueOperationContext _opCtx;
+    std::unique_ptr<StorageInterface> _storageInterface;
+    std::unique_ptr<ReplicationConsistencyMarkers> _consistencyMarkers;
+    std::unique_ptr<ThreadPool> _writerPool;
+    std::unique_ptr<SyncTail> _syncTail;
+
+    long long _applyMicros = 0;
+
+    // Updated by the writer threads.
+    stdx::mutex _mutex;
+    long long _writerBusyMicros = 0;
+    long long _writersUsed = 0;
+    long long _maxOpsForOneWriterInBatch = 0;
+    double _maxWriterShareSum = 0;
+    long long _numBatches = 0;
+};
+
+// Arguments are the number of collections, the number of secondary indexes on each and the number
+// of writer threads.
+void BM_MultiApply(benchmark::State& state) {
+    OplogApplicationBenchmarkFixture fixture(state.range(0), state.range(1), state.range(2));
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto ops = fixture.makeBatch();
+        state.ResumeTiming();
+        fixture.applyBatch(std::move(ops));
+    }
+    state.SetItemsProcessed(state.iterations() * kBatchSize);
+    fixture.reportWriterStats(state);
+}
+
+BENCHMARK(BM_MultiApply)
+    ->Args({1, 0, 16})
+    ->Args({1, 4, 16})
+    ->Args({16, 0, 16})
+    ->Args({16, 4, 16})
+    ->Args({100, 1, 16})
+    ->Args({16, 4, 4})
+    ->Args({16, 4, 1})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/repl/sync_tail.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa_placement.h"
 
 namespace mongo {
 namespace repl {
@@ -85,6 +86,7 @@ std::unique_ptr<ThreadPool> OplogApplier::makeWriterPool(int threadCount) {
         if (!Client::getCurrent()) {
             Client::initThreadIfNotAlready();
             AuthorizationSession::get(cc())->grantInternalAuthorization();
+            NumaPlacement::get().placeCurrentThread(NumaPlacement::ThreadRole::kReplWriter);
         }
     };
     auto pool = stdx::make_unique<ThreadPool>(options);
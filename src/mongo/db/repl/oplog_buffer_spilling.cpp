@@ -0,0 +1,275 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_spilling.h"
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace repl {
+
+OplogBufferSpilling::OplogBufferSpilling(std::unique_ptr<OplogBuffer> memoryBuffer,
+                                         std::unique_ptr<OplogBuffer> spillBuffer,
+                                         Options options,
+                                         Counters* counters)
+    : _memoryBuffer(std::move(memoryBuffer)),
+      _spillBuffer(std::move(spillBuffer)),
+      _options(options),
+      _counters(counters) {
+    invariant(_memoryBuffer);
+    invariant(_spillBuffer);
+}
+
+void OplogBufferSpilling::startup(OperationContext* opCtx) {
+    _memoryBuffer->startup(opCtx);
+    _spillBuffer->startup(opCtx);
+    // Update server status metric to reflect the current oplog buffer's max size.
+    if (_counters) {
+        _counters->setMaxSize(getMaxSize());
+    }
+}
+
+void OplogBufferSpilling::shutdown(OperationContext* opCtx) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _memorySize = 0;
+        _spilling = false;
+        if (_counters) {
+            _counters->clear();
+        }
+    }
+    _cvSpaceAvailable.notify_all();
+    _memoryBuffer->shutdown(opCtx);
+    _spillBuffer->shutdown(opCtx);
+}
+
+void OplogBufferSpilling::pushEvenIfFull(OperationContext* opCtx, const Value& value) {
+    OplogBuffer* buffer = _startPush(std::size_t(value.objsize()));
+    ON_BLOCK_EXIT([&] { _finishPush(buffer); });
+    // Count the operation before it can be popped.
+    if (_counters) {
+        _counters->increment(value);
+    }
+    buffer->pushEvenIfFull(opCtx, value);
+}
+
+void OplogBufferSpilling::push(OperationContext* opCtx, const Value& value) {
+    waitForSpace(opCtx, std::size_t(value.objsize()));
+    pushEvenIfFull(opCtx, value);
+}
+
+void OplogBufferSpilling::pushAllNonBlocking(OperationContext* opCtx,
+                                             Batch::const_iterator begin,
+                                             Batch::const_iterator end) {
+    if (begin == end) {
+        return;
+    }
+    std::size_t size = 0;
+    for (auto it = begin; it != end; ++it) {
+        size += std::size_t(it->objsize());
+    }
+    OplogBuffer* buffer = _startPush(size);
+    ON_BLOCK_EXIT([&] { _finishPush(buffer); });
+    if (_counters) {
+        for (auto it = begin; it != end; ++it) {
+            _counters->increment(*it);
+        }
+    }
+    buffer->pushAllNonBlocking(opCtx, begin, end);
+}
+
+void OplogBufferSpilling::waitForSpace(OperationContext* opCtx, std::size_t size) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _cvSpaceAvailable.wait(lk, [&] {
+        if (!_spilling && _memorySize + size <= _options.memoryLimitBytes) {
+            return true;
+        }
+        if (_options.spillLimitBytes == 0) {
+            return true;
+        }
+        // Always admit operations into an empty spill buffer so that an operation larger than
+        // the limit cannot block the fetcher forever.
+        const auto spillSize = _spillBuffer->getSize();
+        return spillSize == 0 || spillSize + size <= _options.spillLimitBytes;
+    });
+}
+
+bool OplogBufferSpilling::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _isEmpty_inlock();
+}
+
+std::size_t OplogBufferSpilling::getMaxSize() const {
+    if (_options.spillLimitBytes == 0) {
+        return 0;
+    }
+    return _options.memoryLimitBytes + _options.spillLimitBytes;
+}
+
+std::size_t OplogBufferSpilling::getSize() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memoryBuffer->getSize() + _spillBuffer->getSize();
+}
+
+std::size_t OplogBufferSpilling::getCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _memoryBuffer->getCount() + _spillBuffer->getCount();
+}
+
+void OplogBufferSpilling::clear(OperationContext* opCtx) {
+    _memoryBuffer->clear(opCtx);
+    _spillBuffer->clear(opCtx);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _memorySize = 0;
+        _spilling = false;
+        if (_counters) {
+            _counters->clear();
+        }
+    }
+    _cvSpaceAvailable.notify_all();
+}
+
+bool OplogBufferSpilling::tryPop(OperationContext* opCtx, Value* value) {
+    // Operations still in memory were pushed before any of the spilled ones, and nothing is
+    // pushed to memory while there are spilled operations.
+    if (_memoryBuffer->tryPop(opCtx, value)) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            invariant(_memorySize >= std::size_t(value->objsize()));
+            _memorySize -= std::size_t(value->objsize());
+        }
+        if (_counters) {
+            _counters->decrement(*value);
+        }
+    } else if (_spillBuffer->tryPop(opCtx, value)) {
+        _poppedFromSpill(opCtx, *value);
+    } else {
+        return false;
+    }
+    _cvSpaceAvailable.notify_all();
+    return true;
+}
+
+bool OplogBufferSpilling::waitForData(Seconds waitDuration) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    return _cvNoLongerEmpty.wait_for(
+        lk, waitDuration.toSystemDuration(), [this] { return !_isEmpty_inlock(); });
+}
+
+bool OplogBufferSpilling::peek(OperationContext* opCtx, Value* value) {
+    return _memoryBuffer->peek(opCtx, value) || _spillBuffer->peek(opCtx, value);
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferSpilling::lastObjectPushed(
+    OperationContext* opCtx) const {
+    bool spilling;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        spilling = _spilling;
+    }
+    if (spilling) {
+        return _spillBuffer->lastObjectPushed(opCtx);
+    }
+    return _memoryBuffer->lastObjectPushed(opCtx);
+}
+
+bool OplogBufferSpilling::isSpilling() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _spilling;
+}
+
+OplogBuffer* OplogBufferSpilling::_startPush(std::size_t size) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        if (!_spilling && _memorySize + size <= _options.memoryLimitBytes) {
+            _memorySize += size;
+            return _memoryBuffer.get();
+        }
+        if (!_clearingSpill) {
+            break;
+        }
+        _cvSpillCleared.wait(lk);
+    }
+    if (!_spilling) {
+        log() << "Oplog buffer is holding " << _memorySize
+              << " bytes in memory; spilling further operations until application catches up";
+        _spilling = true;
+    }
+    ++_pendingSpillPushes;
+    return _spillBuffer.get();
+}
+
+void OplogBufferSpilling::_finishPush(OplogBuffer* buffer) {
+    if (buffer == _spillBuffer.get()) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        invariant(_pendingSpillPushes > 0);
+        --_pendingSpillPushes;
+    }
+    _cvNoLongerEmpty.notify_all();
+}
+
+void OplogBufferSpilling::_poppedFromSpill(OperationContext* opCtx, const Value& value) {
+    if (_counters) {
+        _counters->decrement(value);
+    }
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        // The memory buffer drained before the spill buffer, so both are empty now, unless a push
+        // to the spill buffer is still under way.
+        if (!_spilling || _pendingSpillPushes > 0 || !_spillBuffer->isEmpty()) {
+            return;
+        }
+        log() << "Oplog buffer drained the spilled operations; buffering in memory again";
+        _spilling = false;
+        _clearingSpill = true;
+    }
+    ON_BLOCK_EXIT([&] {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _clearingSpill = false;
+        }
+        _cvSpillCleared.notify_all();
+    });
+    // Give the space taken by the spilled operations back.
+    _spillBuffer->clear(opCtx);
+}
+
+bool OplogBufferSpilling::_isEmpty_inlock() const {
+    return _memoryBuffer->isEmpty() && _spillBuffer->isEmpty();
+}
+
+}  // namespace repl
+}  // namespace mongo
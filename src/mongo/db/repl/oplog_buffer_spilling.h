@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Oplog buffer that holds operations in a memory buffer up to a limit and spills the rest to a
+ * second, usually collection backed, buffer. This lets the fetcher keep reading from the sync
+ * source while application is behind, instead of stopping once the memory buffer is full.
+ *
+ * Operations are popped in the order they were pushed: once an operation has been spilled, every
+ * operation pushed after it is spilled too, until the spill buffer has been drained. A drained
+ * spill buffer is cleared, so that a collection backed one gives its space back.
+ *
+ * Pushes to and pops from the underlying buffers happen outside of this buffer's mutex, so that
+ * writing spilled operations to storage does not hold up popping operations from memory.
+ */
+class OplogBufferSpilling final : public OplogBuffer {
+public:
+    /**
+     * Structure used to configure an instance of OplogBufferSpilling.
+     */
+    struct Options {
+        // Size of operations, as measured by BSONObj::objsize(), held in the memory buffer before
+        // further operations are spilled.
+        std::size_t memoryLimitBytes = 0;
+        // Size of spilled operations above which waitForSpace() blocks. 0 means no limit.
+        std::size_t spillLimitBytes = 0;
+        Options() {}
+    };
+
+    /**
+     * Takes ownership of both buffers. They must be empty and not started up.
+     */
+    OplogBufferSpilling(std::unique_ptr<OplogBuffer> memoryBuffer,
+                        std::unique_ptr<OplogBuffer> spillBuffer,
+                        Options options,
+                        Counters* counters = nullptr);
+
+    void startup(OperationContext* opCtx) override;
+    void shutdown(OperationContext* opCtx) override;
+    void pushEvenIfFull(OperationContext* opCtx, const Value& value) override;
+    void push(OperationContext* opCtx, const Value& value) override;
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* opCtx) override;
+    bool tryPop(OperationContext* opCtx, Value* value) override;
+    bool waitForData(Seconds waitDuration) override;
+    bool peek(OperationContext* opCtx, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override;
+
+    /**
+     * Returns true if operations are currently being pushed to the spill buffer.
+     */
+    bool isSpilling() const;
+
+private:
+    /**
+     * Returns the buffer that operations of 'size' bytes are pushed to, and starts spilling if
+     * they do not fit into the memory buffer. Waits while a drained spill buffer is being
+     * cleared. Every call must be followed by a call to _finishPush() once the push is done.
+     */
+    OplogBuffer* _startPush(std::size_t size);
+
+    /**
+     * Accounts for a push to 'buffer' having completed, successfully or not.
+     */
+    void _finishPush(OplogBuffer* buffer);
+
+    /**
+     * Accounts for 'value' having been popped from the spill buffer, and clears the spill buffer
+     * if that drained it.
+     */
+    void _poppedFromSpill(OperationContext* opCtx, const Value& value);
+
+    bool _isEmpty_inlock() const;
+
+    const std::unique_ptr<OplogBuffer> _memoryBuffer;
+    const std::unique_ptr<OplogBuffer> _spillBuffer;
+    const Options _options;
+    Counters* const _counters;
+
+    // Protects member data below and the choice of buffer to push to. Not held while pushing to
+    // or popping from either buffer.
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _cvNoLongerEmpty;
+    stdx::condition_variable _cvSpaceAvailable;
+    stdx::condition_variable _cvSpillCleared;
+
+    // Size of operations in the memory buffer.
+    std::size_t _memorySize = 0;
+
+    // Whether operations are pushed to the spill buffer. Stays set until it has been drained.
+    bool _spilling = false;
+
+    // Number of pushes to the spill buffer which have been started but not finished. The spill
+    // buffer is not drained while any are outstanding.
+    std::size_t _pendingSpillPushes = 0;
+
+    // Set while a drained spill buffer is being cleared. Nothing is spilled in the meantime.
+    bool _clearingSpill = false;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,293 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/oplog_buffer_spilling.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+/**
+ * Spill buffer which counts how often it is cleared and whose pushes can be held up.
+ */
+class SpillBufferMock final : public OplogBuffer {
+public:
+    void startup(OperationContext* opCtx) override {
+        _queue.startup(opCtx);
+    }
+    void shutdown(OperationContext* opCtx) override {
+        _queue.shutdown(opCtx);
+    }
+    void pushEvenIfFull(OperationContext* opCtx, const Value& value) override {
+        _waitWhilePushesBlocked();
+        _queue.pushEvenIfFull(opCtx, value);
+    }
+    void push(OperationContext* opCtx, const Value& value) override {
+        _waitWhilePushesBlocked();
+        _queue.push(opCtx, value);
+    }
+    void pushAllNonBlocking(OperationContext* opCtx,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override {
+        _waitWhilePushesBlocked();
+        _queue.pushAllNonBlocking(opCtx, begin, end);
+    }
+    void waitForSpace(OperationContext* opCtx, std::size_t size) override {
+        _queue.waitForSpace(opCtx, size);
+    }
+    bool isEmpty() const override {
+        return _queue.isEmpty();
+    }
+    std::size_t getMaxSize() const override {
+        return _queue.getMaxSize();
+    }
+    std::size_t getSize() const override {
+        return _queue.getSize();
+    }
+    std::size_t getCount() const override {
+        return _queue.getCount();
+    }
+    void clear(OperationContext* opCtx) override {
+        ++numClears;
+        _queue.clear(opCtx);
+    }
+    bool tryPop(OperationContext* opCtx, Value* value) override {
+        return _queue.tryPop(opCtx, value);
+    }
+    bool waitForData(Seconds waitDuration) override {
+        return _queue.waitForData(waitDuration);
+    }
+    bool peek(OperationContext* opCtx, Value* value) override {
+        return _queue.peek(opCtx, value);
+    }
+    boost::optional<Value> lastObjectPushed(OperationContext* opCtx) const override {
+        return _queue.lastObjectPushed(opCtx);
+    }
+
+    /**
+     * Holds up pushes until unblockPushes() is called.
+     */
+    void blockPushes() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _pushesBlocked = true;
+    }
+
+    void unblockPushes() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _pushesBlocked = false;
+        }
+        _cv.notify_all();
+    }
+
+    /**
+     * Waits until a push is being held up.
+     */
+    void waitForBlockedPush() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [&] { return _numBlockedPushes > 0; });
+    }
+
+    int numClears = 0;
+
+private:
+    void _waitWhilePushesBlocked() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        ++_numBlockedPushes;
+        _cv.notify_all();
+        _cv.wait(lk, [&] { return !_pushesBlocked; });
+        --_numBlockedPushes;
+    }
+
+    OplogBufferBlockingQueue _queue;
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    bool _pushesBlocked = false;
+    int _numBlockedPushes = 0;
+};
+
+class OplogBufferSpillingTest : public unittest::Test {
+protected:
+    void setUp() override {
+        auto memoryBuffer = stdx::make_unique<OplogBufferBlockingQueue>();
+        auto spillBuffer = stdx::make_unique<SpillBufferMock>();
+        _memoryBuffer = memoryBuffer.get();
+        _spillBuffer = spillBuffer.get();
+
+        OplogBufferSpilling::Options options;
+        options.memoryLimitBytes = 2 * std::size_t(makeOp(0).objsize());
+        options.spillLimitBytes = 100 * 1024;
+        _buffer = stdx::make_unique<OplogBufferSpilling>(
+            std::move(memoryBuffer), std::move(spillBuffer), options, &_counters);
+        _buffer->startup(nullptr);
+    }
+
+    void tearDown() override {
+        _buffer->shutdown(nullptr);
+    }
+
+    static BSONObj makeOp(int i) {
+        return BSON("ts" << Timestamp(Seconds(i), 0) << "h" << 1LL << "op"
+                         << "n"
+                         << "ns"
+                         << ""
+                         << "o"
+                         << BSONObj());
+    }
+
+    Timestamp pop() {
+        BSONObj op;
+        ASSERT_TRUE(_buffer->tryPop(nullptr, &op));
+        return op["ts"].timestamp();
+    }
+
+    OplogBuffer::Counters _counters;
+    std::unique_ptr<OplogBufferSpilling> _buffer;
+    OplogBuffer* _memoryBuffer = nullptr;
+    SpillBufferMock* _spillBuffer = nullptr;
+};
+
+TEST_F(OplogBufferSpillingTest, OperationsThatFitStayInMemory) {
+    _buffer->push(nullptr, makeOp(1));
+    _buffer->push(nullptr, makeOp(2));
+
+    ASSERT_FALSE(_buffer->isSpilling());
+    ASSERT_EQUALS(2U, _memoryBuffer->getCount());
+    ASSERT_EQUALS(0U, _spillBuffer->getCount());
+    ASSERT_EQUALS(2U, _buffer->getCount());
+    ASSERT_EQUALS(2, _counters.count.get());
+}
+
+TEST_F(OplogBufferSpillingTest, OperationsBeyondTheMemoryLimitAreSpilledAndPoppedInOrder) {
+    OplogBuffer::Batch batch = {makeOp(1), makeOp(2), makeOp(3)};
+    _buffer->pushAllNonBlocking(nullptr, batch.cbegin(), batch.cbegin() + 2);
+    _buffer->pushAllNonBlocking(nullptr, batch.cbegin() + 2, batch.cend());
+
+    ASSERT_TRUE(_buffer->isSpilling());
+    ASSERT_EQUALS(2U, _memoryBuffer->getCount());
+    ASSERT_EQUALS(1U, _spillBuffer->getCount());
+    ASSERT_EQUALS(3, _counters.count.get());
+
+    // Space freed in memory is not used while spilled operations remain, to preserve the order.
+    ASSERT_EQUALS(Timestamp(Seconds(1), 0), pop());
+    _buffer->push(nullptr, makeOp(4));
+    ASSERT_EQUALS(2U, _spillBuffer->getCount());
+
+    BSONObj op;
+    ASSERT_TRUE(_buffer->peek(nullptr, &op));
+    ASSERT_EQUALS(Timestamp(Seconds(2), 0), op["ts"].timestamp());
+    auto lastPushed = _buffer->lastObjectPushed(nullptr);
+    ASSERT_TRUE(lastPushed);
+    ASSERT_EQUALS(Timestamp(Seconds(4), 0), (*lastPushed)["ts"].timestamp());
+
+    ASSERT_EQUALS(Timestamp(Seconds(2), 0), pop());
+    ASSERT_EQUALS(Timestamp(Seconds(3), 0), pop());
+    ASSERT_EQUALS(Timestamp(Seconds(4), 0), pop());
+    ASSERT_FALSE(_buffer->tryPop(nullptr, &op));
+    ASSERT_TRUE(_buffer->isEmpty());
+    ASSERT_EQUALS(0, _counters.count.get());
+
+    // Once the spilled operations are drained, operations are buffered in memory again.
+    ASSERT_FALSE(_buffer->isSpilling());
+    _buffer->push(nullptr, makeOp(5));
+    ASSERT_EQUALS(1U, _memoryBuffer->getCount());
+    ASSERT_EQUALS(0U, _spillBuffer->getCount());
+}
+
+TEST_F(OplogBufferSpillingTest, ClearEmptiesBothBuffersAndStopsSpilling) {
+    OplogBuffer::Batch batch = {makeOp(1), makeOp(2), makeOp(3)};
+    _buffer->pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend());
+    ASSERT_TRUE(_buffer->isSpilling());
+
+    _buffer->clear(nullptr);
+    ASSERT_TRUE(_buffer->isEmpty());
+    ASSERT_FALSE(_buffer->isSpilling());
+    ASSERT_EQUALS(0, _counters.count.get());
+    ASSERT_EQUALS(0, _counters.size.get());
+}
+
+TEST_F(OplogBufferSpillingTest, WaitForSpaceReturnsWhileTheSpillLimitIsNotReached) {
+    OplogBuffer::Batch batch = {makeOp(1), makeOp(2), makeOp(3)};
+    _buffer->pushAllNonBlocking(nullptr, batch.cbegin(), batch.cend());
+    _buffer->waitForSpace(nullptr, std::size_t(makeOp(4).objsize()));
+    ASSERT_TRUE(_buffer->waitForData(Seconds(0)));
+}
+
+TEST_F(OplogBufferSpillingTest, SpillBufferIsClearedOnceDrained) {
+    OplogBuffer::Batch batch = {makeOp(1), makeOp(2), makeOp(3), makeOp(4)};
+    _buffer->pushAllNonBlocking(nullptr, batch.cbegin(), batch.cbegin() + 2);
+    _buffer->pushAllNonBlocking(nullptr, batch.cbegin() + 2, batch.cbegin() + 3);
+    _buffer->pushAllNonBlocking(nullptr, batch.cbegin() + 3, batch.cend());
+    ASSERT_EQUALS(2U, _spillBuffer->getCount());
+
+    ASSERT_EQUALS(Timestamp(Seconds(1), 0), pop());
+    ASSERT_EQUALS(Timestamp(Seconds(2), 0), pop());
+    ASSERT_EQUALS(Timestamp(Seconds(3), 0), pop());
+    ASSERT_EQUALS(0, _spillBuffer->numClears);
+
+    ASSERT_EQUALS(Timestamp(Seconds(4), 0), pop());
+    ASSERT_EQUALS(1, _spillBuffer->numClears);
+    ASSERT_FALSE(_buffer->isSpilling());
+}
+
+TEST_F(OplogBufferSpillingTest, PoppingFromMemoryDoesNotWaitForASpillingPush) {
+    OplogBuffer::Batch batch = {makeOp(1), makeOp(2), makeOp(3)};
+    _buffer->pushAllNonBlocking(nullptr, batch.cbegin(), batch.cbegin() + 2);
+
+    _spillBuffer->blockPushes();
+    stdx::thread pusher(
+        [&] { _buffer->pushAllNonBlocking(nullptr, batch.cbegin() + 2, batch.cend()); });
+    _spillBuffer->waitForBlockedPush();
+
+    // The spilled operation is still being written, so the spill buffer must not be cleared
+    // when the memory buffer drains.
+    ASSERT_TRUE(_buffer->isSpilling());
+    ASSERT_EQUALS(Timestamp(Seconds(1), 0), pop());
+    ASSERT_EQUALS(Timestamp(Seconds(2), 0), pop());
+    BSONObj op;
+    ASSERT_FALSE(_buffer->tryPop(nullptr, &op));
+    ASSERT_TRUE(_buffer->isSpilling());
+
+    _spillBuffer->unblockPushes();
+    pusher.join();
+    ASSERT_EQUALS(Timestamp(Seconds(3), 0), pop());
+    ASSERT_EQUALS(1, _spillBuffer->numClears);
+    ASSERT_FALSE(_buffer->isSpilling());
+}
+}  // namespace
@@ -143,6 +143,7 @@ BSONObj makeOplogEntryDoc(OpTime opTime,
 }  // namespace
 
 const int OplogEntry::kOplogVersion = 2;
+constexpr StringData OplogEntry::kPartialTxnFieldName;
 
 // Static
 ReplOperation OplogEntry::makeInsertOperation(const NamespaceString& nss,
@@ -265,6 +266,11 @@ bool OplogEntry::shouldPrepare() const {
     return getPrepare() && *getPrepare();
 }
 
+bool OplogEntry::isPartialTransaction() const {
+    return isCommand() && getCommandType() == CommandType::kApplyOps &&
+        getObject()[kPartialTxnFieldName].trueValue();
+}
+
 BSONElement OplogEntry::getIdElement() const {
     invariant(isCrudOpType());
     if (getOpType() == OpTypeEnum::kUpdate) {
@@ -314,6 +320,36 @@ std::ostream& operator<<(std::ostream& s, const OplogEntry& o) {
     return s << o.toString();
 }
 
+OplogEntryView::OplogEntryView(const BSONObj& raw) : _raw(raw) {
+    for (auto&& elem : _raw) {
+        const auto fieldName = elem.fieldNameStringData();
+        if (fieldName == OplogEntryBase::kTimestampFieldName) {
+            _ts = elem;
+        } else if (fieldName == OplogEntryBase::kTermFieldName) {
+            _t = elem;
+        } else if (fieldName == OplogEntryBase::kVersionFieldName) {
+            _v = elem;
+        } else if (fieldName == OplogEntryBase::kOpTypeFieldName) {
+            _op = elem;
+        } else if (fieldName == OplogEntryBase::kNssFieldName) {
+            _ns = elem;
+        } else if (fieldName == OplogEntryBase::kObjectFieldName) {
+            _o = elem;
+        } else if (fieldName == OplogEntryBase::kPrepareFieldName) {
+            _prepare = elem;
+        }
+    }
+}
+
+OpTime OplogEntryView::getOpTime() const {
+    return OpTime(getTimestamp(), _t.isNumber() ? _t.numberLong() : OpTime::kUninitializedTerm);
+}
+
+StringData OplogEntryView::getCommandName() const {
+    invariant(isCommand());
+    return _o.type() == Object ? _o.Obj().firstElement().fieldNameStringData() : StringData();
+}
+
 std::ostream& operator<<(std::ostream& s, const ReplOperation& o) {
     return s << o.toBSON().toString();
 }
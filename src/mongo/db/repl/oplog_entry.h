@@ -63,6 +63,10 @@ public:
     // Current oplog version, should be the value of the v field in all oplog entries.
     static const int kOplogVersion;
 
+    // Marks an 'applyOps' entry of an unprepared transaction that is followed by further entries
+    // of the same transaction. Only the last entry of the chain commits the transaction.
+    static constexpr StringData kPartialTxnFieldName = "partialTxn"_sd;
+
     // Helpers to generate ReplOperation.
     static ReplOperation makeInsertOperation(const NamespaceString& nss,
                                              boost::optional<UUID> uuid,
@@ -121,6 +125,12 @@ public:
      */
     bool shouldPrepare() const;
 
+    /**
+     * Returns if this is an 'applyOps' entry holding some, but not the last, of the operations of
+     * a transaction that was written as a chain of 'applyOps' entries.
+     */
+    bool isPartialTransaction() const;
+
     /**
      * Returns the _id of the document being modified. Must be called on CRUD ops.
      */
@@ -163,6 +173,70 @@ private:
 
 std::ostream& operator<<(std::ostream& s, const OplogEntry& o);
 
+/**
+ * A view of an oplog entry document which finds the fields needed to decide how to batch the entry
+ * in one pass over its top-level elements, without the copying, allocation and validation of a
+ * full OplogEntry parse. If the document is not owned, its buffer must outlive the view. Fields
+ * that are missing read as their defaults; entries are validated when they are parsed into an
+ * OplogEntry for application.
+ */
+class OplogEntryView {
+public:
+    explicit OplogEntryView(const BSONObj& raw);
+
+    Timestamp getTimestamp() const {
+        return _ts.type() == bsonTimestamp ? _ts.timestamp() : Timestamp();
+    }
+
+    OpTime getOpTime() const;
+
+    /**
+     * Returns the version of the oplog entry, which defaults to 1 when absent.
+     */
+    long long getVersion() const {
+        return _v.eoo() ? 1 : _v.safeNumberLong();
+    }
+
+    /**
+     * Returns the raw 'op' field, for example "i" or "c".
+     */
+    StringData getOpType() const {
+        return _op.type() == String ? _op.valueStringData() : StringData();
+    }
+
+    bool isCommand() const {
+        return getOpType() == "c"_sd;
+    }
+
+    StringData getNss() const {
+        return _ns.type() == String ? _ns.valueStringData() : StringData();
+    }
+
+    /**
+     * Returns the name of the command, the first field of the 'o' object. Must be called on a
+     * command entry.
+     */
+    StringData getCommandName() const;
+
+    bool shouldPrepare() const {
+        return _prepare.trueValue();
+    }
+
+    int getRawObjSizeBytes() const {
+        return _raw.objsize();
+    }
+
+private:
+    BSONObj _raw;
+    BSONElement _ts;
+    BSONElement _t;
+    BSONElement _v;
+    BSONElement _op;
+    BSONElement _ns;
+    BSONElement _o;
+    BSONElement _prepare;
+};
+
 inline bool operator==(const OplogEntry& lhs, const OplogEntry& rhs) {
     return SimpleBSONObjComparator::kInstance.evaluate(lhs.raw == rhs.raw);
 }
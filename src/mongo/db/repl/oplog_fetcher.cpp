@@ -36,12 +36,15 @@
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/metadata/oplog_query_metadata.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -63,6 +66,93 @@ ServerStatusMetricField<Counter64> displayOpsRead("repl.network.ops", &opsReadSt
 Counter64 networkByteStats;
 ServerStatusMetricField<Counter64> displayBytesRead("repl.network.bytes", &networkByteStats);
 
+/**
+ * Tracks the rate at which batches and bytes are fetched, measured over fixed windows. The rates
+ * reported are those of the last complete window, or 0 if nothing was fetched for a full window.
+ */
+class FetchRates {
+public:
+    void record(long long bytes) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const auto now = Date_t::now();
+        _rollWindow_inlock(now);
+        ++_windowBatches;
+        _windowBytes += bytes;
+    }
+
+    long long batchesPerSecond() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _rollWindow_inlock(Date_t::now());
+        return _batchesPerSecond;
+    }
+
+    long long bytesPerSecond() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _rollWindow_inlock(Date_t::now());
+        return _bytesPerSecond;
+    }
+
+private:
+    void _rollWindow_inlock(Date_t now) {
+        const auto elapsed = now - _windowStart;
+        if (elapsed < kWindow) {
+            return;
+        }
+        if (elapsed >= kWindow * 2) {
+            // Nothing was fetched for a whole window.
+            _batchesPerSecond = 0;
+            _bytesPerSecond = 0;
+        } else {
+            const auto elapsedMillis = durationCount<Milliseconds>(elapsed);
+            _batchesPerSecond = _windowBatches * 1000 / elapsedMillis;
+            _bytesPerSecond = _windowBytes * 1000 / elapsedMillis;
+        }
+        _windowStart = now;
+        _windowBatches = 0;
+        _windowBytes = 0;
+    }
+
+    static constexpr Seconds kWindow{10};
+
+    stdx::mutex _mutex;
+    Date_t _windowStart;
+    long long _windowBatches = 0;
+    long long _windowBytes = 0;
+    long long _batchesPerSecond = 0;
+    long long _bytesPerSecond = 0;
+};
+
+constexpr Seconds FetchRates::kWindow;
+
+FetchRates fetchRates;
+
+class FetchRateMetric : public ServerStatusMetric {
+public:
+    FetchRateMetric(const std::string& name, long long (FetchRates::*rate)())
+        : ServerStatusMetric(name), _rate(rate) {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        b.append(_leafName, (fetchRates.*_rate)());
+    }
+
+private:
+    long long (FetchRates::*const _rate)();
+};
+
+FetchRateMetric displayBatchesPerSecond("repl.network.batchesPerSecond",
+                                        &FetchRates::batchesPerSecond);
+FetchRateMetric displayBytesPerSecond("repl.network.bytesPerSecond", &FetchRates::bytesPerSecond);
+
+// Whether the getMore batch size is lowered while enqueueing fetched operations blocks, because
+// application is behind, and raised back up to the configured batch size once it does not.
+MONGO_EXPORT_SERVER_PARAMETER(oplogFetcherAdaptiveBatchSize, bool, true);
+
+// Enqueueing a batch that takes at least this long means the oplog buffer was full.
+const Milliseconds kEnqueueBackpressureThreshold(100);
+
+// The getMore batch size is never lowered below this number of documents.
+const int kMinAdaptiveBatchSize = 1000;
+
 const Milliseconds maximumAwaitDataTimeoutMS(30 * 1000);
 
 /**
@@ -352,7 +442,8 @@ OplogFetcher::OplogFetcher(executor::TaskExecutor* executor,
       _dataReplicatorExternalState(dataReplicatorExternalState),
       _enqueueDocumentsFn(enqueueDocumentsFn),
       _awaitDataTimeout(calculateAwaitDataTimeout(config)),
-      _batchSize(batchSize) {
+      _batchSize(batchSize),
+      _currentBatchSize(batchSize) {
 
     invariant(config.isInitialized());
     invariant(enqueueDocumentsFn);
@@ -497,12 +588,17 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
 
     // Record time for each batch.
     getmoreReplStats.recordMillis(durationCount<Milliseconds>(queryResponse.elapsedMillis));
+    fetchRates.record(info.networkDocumentBytes);
 
-    // TODO: back pressure handling will be added in SERVER-23499.
+    Timer enqueueTimer;
     auto status = _enqueueDocumentsFn(firstDocToApply, documents.cend(), info);
     if (!status.isOK()) {
         return status;
     }
+    const bool syncSourceAhead = oqMetadata && !documents.empty() &&
+        oqMetadata->getLastOpApplied().getTimestamp() > documents.back()["ts"].timestamp();
+    const auto batchSize = _nextBatchSize(
+        documents.size(), Milliseconds(enqueueTimer.millis()), syncSourceAhead);
 
     if (_dataReplicatorExternalState->shouldStopFetching(
             _getSource(), replSetMetadata, oqMetadata)) {
@@ -530,7 +626,38 @@ StatusWith<BSONObj> OplogFetcher::_onSuccessfulBatch(const Fetcher::QueryRespons
                                     queryResponse.cursorId,
                                     lastCommittedWithCurrentTerm,
                                     _getGetMoreMaxTime(),
-                                    _batchSize);
+                                    batchSize);
+}
+
+int OplogFetcher::_nextBatchSize(std::size_t documentCount,
+                                 Milliseconds enqueueTime,
+                                 bool syncSourceAhead) {
+    if (!oplogFetcherAdaptiveBatchSize.load()) {
+        _currentBatchSize = _batchSize;
+        return _currentBatchSize;
+    }
+
+    const int previousBatchSize = _currentBatchSize;
+    if (enqueueTime >= kEnqueueBackpressureThreshold) {
+        // The buffer was full, so application is slower than fetching. Ask for half of what was
+        // just received so that the fetcher does not hold large batches it cannot enqueue.
+        const auto received = std::min<std::size_t>(documentCount, _currentBatchSize);
+        _currentBatchSize =
+            std::min(_batchSize, std::max<int>(kMinAdaptiveBatchSize, received / 2));
+    } else if (syncSourceAhead) {
+        // We are behind the sync source and application keeps up: fetch as much as possible.
+        _currentBatchSize = _batchSize;
+    } else {
+        _currentBatchSize = static_cast<int>(
+            std::min<long long>(_batchSize, static_cast<long long>(_currentBatchSize) * 2));
+    }
+
+    if (_currentBatchSize != previousBatchSize) {
+        LOG(1) << "oplog fetcher changed its getMore batch size from " << previousBatchSize
+               << " to " << _currentBatchSize << " after enqueueing " << documentCount
+               << " operations took " << enqueueTime;
+    }
+    return _currentBatchSize;
 }
 }  // namespace repl
 }  // namespace mongo
@@ -158,6 +158,12 @@ private:
      */
     StatusWith<BSONObj> _onSuccessfulBatch(const Fetcher::QueryResponse& queryResponse) override;
 
+    /**
+     * Returns the batch size for the next getMore, given the number of documents in the batch just
+     * received, how long enqueueing it took and whether the sync source has more operations.
+     */
+    int _nextBatchSize(std::size_t documentCount, Milliseconds enqueueTime, bool syncSourceAhead);
+
     // The metadata object sent with the Fetcher queries.
     const BSONObj _metadataObject;
 
@@ -174,6 +180,11 @@ private:
     const EnqueueDocumentsFn _enqueueDocumentsFn;
     const Milliseconds _awaitDataTimeout;
     const int _batchSize;
+
+    // The batch size requested by the next getMore. Lowered while enqueueing blocks because
+    // application is behind, and raised back up to '_batchSize' otherwise. Only accessed from
+    // _onSuccessfulBatch(), which runs for one batch at a time.
+    int _currentBatchSize;
 };
 
 }  // namespace repl
@@ -41,6 +41,7 @@
 #include "mongo/unittest/task_executor_proxy.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 
@@ -770,6 +771,50 @@ TEST_F(
                       request.cmdObj["lastKnownCommittedOpTime"].Obj())));
 }
 
+TEST_F(OplogFetcherTest, SlowEnqueueLowersBatchSizeOfNextGetMore) {
+    ShutdownState shutdownState;
+
+    enqueueDocumentsFn = [this](Fetcher::Documents::const_iterator begin,
+                                Fetcher::Documents::const_iterator end,
+                                const OplogFetcher::DocumentsInfo& info) -> Status {
+        // Simulate a full oplog buffer.
+        sleepmillis(100);
+        lastEnqueuedDocuments = {begin, end};
+        return Status::OK();
+    };
+
+    OplogFetcher oplogFetcher(&getExecutor(),
+                              lastFetched,
+                              source,
+                              nss,
+                              _createConfig(),
+                              0,
+                              rbid,
+                              true,
+                              dataReplicatorExternalState.get(),
+                              enqueueDocumentsFn,
+                              stdx::ref(shutdownState),
+                              defaultBatchSize);
+    ASSERT_OK(oplogFetcher.startup());
+
+    auto firstEntry = makeNoopOplogEntry(lastFetched);
+    auto secondEntry = makeNoopOplogEntry({{Seconds(456), 0}, lastFetched.opTime.getTerm()}, 200);
+    auto metadataObj = makeOplogQueryMetadataObject(remoteNewerOpTime, rbid, 2, 2);
+    processNetworkResponse(
+        {concatenate(makeCursorResponse(22LL, {firstEntry, secondEntry}), metadataObj),
+         Milliseconds(0)},
+        true);
+
+    auto thirdEntry = makeNoopOplogEntry({{Seconds(789), 0}, lastFetched.opTime.getTerm()}, 300);
+    auto request = processNetworkResponse(makeCursorResponse(0, {thirdEntry}, false));
+
+    ASSERT_EQUALS(std::string("getMore"), request.cmdObj.firstElementFieldName());
+    ASSERT_LESS_THAN(request.cmdObj.getIntField("batchSize"), defaultBatchSize);
+
+    oplogFetcher.join();
+    ASSERT_OK(shutdownState.getStatus());
+}
+
 TEST_F(OplogFetcherTest, ValidateDocumentsReturnsNoSuchKeyIfTimestampIsNotFoundInAnyDocument) {
     auto firstEntry = makeNoopOplogEntry(Seconds(123), 100);
     auto secondEntry = BSON("o" << BSON("msg"
@@ -0,0 +1,189 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_prefetch.h"
+
+#include "mongo/base/counter.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog_raii.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+// Documents and index entries read ahead of oplog application
+Counter64 prefetchedDocuments;
+ServerStatusMetricField<Counter64> displayPrefetchedDocuments("repl.apply.prefetch.documents",
+                                                              &prefetchedDocuments);
+Counter64 prefetchedIndexEntries;
+ServerStatusMetricField<Counter64> displayPrefetchedIndexEntries(
+    "repl.apply.prefetch.indexEntries", &prefetchedIndexEntries);
+
+enum class Indexes { kIdOnly, kAll, kAllButId };
+
+/**
+ * Reads the entries which 'obj' has in the selected indexes of 'collection'.
+ */
+void prefetchIndexPages(OperationContext* opCtx,
+                        Collection* collection,
+                        const BSONObj& obj,
+                        Indexes indexes) {
+    auto indexCatalog = collection->getIndexCatalog();
+    if (indexes == Indexes::kIdOnly) {
+        if (auto desc = indexCatalog->findIdIndex(opCtx)) {
+            indexCatalog->getIndex(desc)->touch(opCtx, obj).ignore();
+            prefetchedIndexEntries.increment();
+        }
+        return;
+    }
+
+    auto it = indexCatalog->getIndexIterator(opCtx, false);
+    while (it.more()) {
+        auto desc = it.next();
+        if (indexes == Indexes::kAllButId && desc->isIdIndex()) {
+            continue;
+        }
+        indexCatalog->getIndex(desc)->touch(opCtx, obj).ignore();
+        prefetchedIndexEntries.increment();
+    }
+}
+
+class ReplIndexPrefetch : public ServerParameter {
+public:
+    ReplIndexPrefetch() : ServerParameter(ServerParameterSet::getGlobal(), "replIndexPrefetch") {}
+
+    void append(OperationContext* opCtx, BSONObjBuilder& b, const std::string& name) override {
+        auto config = ReplicationCoordinator::get(opCtx)->getIndexPrefetchConfig();
+        switch (config) {
+            case ReplSettings::IndexPrefetchConfig::PREFETCH_ID_ONLY:
+                b.append(name, "_id_only");
+                return;
+            case ReplSettings::IndexPrefetchConfig::PREFETCH_ALL:
+                b.append(name, "all");
+                return;
+            case ReplSettings::IndexPrefetchConfig::UNINITIALIZED:
+            case ReplSettings::IndexPrefetchConfig::PREFETCH_NONE:
+                b.append(name, "none");
+                return;
+        }
+        MONGO_UNREACHABLE;
+    }
+
+    Status set(const BSONElement& newValueElement) override {
+        if (newValueElement.type() != String) {
+            return {ErrorCodes::BadValue, str::stream() << name() << " has to be a string"};
+        }
+        return setFromString(newValueElement.String());
+    }
+
+    Status setFromString(const std::string& prefetch) override {
+        ReplSettings::IndexPrefetchConfig config;
+        if (prefetch == "none") {
+            config = ReplSettings::IndexPrefetchConfig::PREFETCH_NONE;
+        } else if (prefetch == "_id_only") {
+            config = ReplSettings::IndexPrefetchConfig::PREFETCH_ID_ONLY;
+        } else if (prefetch == "all") {
+            config = ReplSettings::IndexPrefetchConfig::PREFETCH_ALL;
+        } else {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "unrecognized " << name() << " setting: " << prefetch
+                                  << "; expected one of none, _id_only or all"};
+        }
+
+        ReplicationCoordinator::get(getGlobalServiceContext())->setIndexPrefetchConfig(config);
+        return Status::OK();
+    }
+} replIndexPrefetch;
+
+}  // namespace
+
+bool prefetchPagesForReplicatedOp(OperationContext* opCtx,
+                                  const OplogEntry& op,
+                                  ReplSettings::IndexPrefetchConfig config) {
+    if (config != ReplSettings::IndexPrefetchConfig::PREFETCH_ID_ONLY &&
+        config != ReplSettings::IndexPrefetchConfig::PREFETCH_ALL) {
+        return false;
+    }
+    if (!op.isCrudOpType()) {
+        return false;
+    }
+
+    const bool idOnly = config == ReplSettings::IndexPrefetchConfig::PREFETCH_ID_ONLY;
+    bool found = false;
+    try {
+        AutoGetCollection autoColl(opCtx, op.getNss(), MODE_IS);
+        auto collection = autoColl.getCollection();
+        if (!collection) {
+            return false;
+        }
+
+        if (op.getOpType() == OpTypeEnum::kInsert) {
+            // There is no document yet, but the index pages where its keys go can be read.
+            prefetchIndexPages(
+                opCtx, collection, op.getObject(), idOnly ? Indexes::kIdOnly : Indexes::kAll);
+        } else {
+            auto id = op.getIdElement();
+            if (!id.eoo()) {
+                // Finding the document by _id reads the _id index entry along with it.
+                auto recordId = Helpers::findById(opCtx, collection, id.wrap());
+                Snapshotted<BSONObj> doc;
+                if (!recordId.isNull() && collection->findDoc(opCtx, recordId, &doc)) {
+                    found = true;
+                    prefetchedDocuments.increment();
+
+                    // The entries for the document's current keys are what the op will remove.
+                    if (!idOnly) {
+                        prefetchIndexPages(opCtx, collection, doc.value(), Indexes::kAllButId);
+                    }
+                }
+            }
+        }
+    } catch (const DBException& ex) {
+        LOG(3) << "Failed to prefetch pages for " << redact(op.toBSON()) << causedBy(redact(ex));
+    }
+
+    opCtx->recoveryUnit()->abandonSnapshot();
+    return found;
+}
+
+}  // namespace repl
+}  // namespace mongo
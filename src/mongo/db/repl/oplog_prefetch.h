@@ -0,0 +1,59 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/repl/repl_settings.h"
+
+namespace mongo {
+
+class OperationContext;
+
+namespace repl {
+
+class OplogEntry;
+
+/**
+ * Reads the pages which applying 'op' will touch into the storage engine's cache, so that the
+ * writer thread applying it doesn't have to wait for them. Depending on 'config', this reads the
+ * document updated or deleted through the _id index, and the index entries the op will insert or
+ * remove.
+ *
+ * This only reads, and errors only mean that there was less to prefetch, so they are swallowed.
+ * Callers should make 'opCtx' not conflict with batch application, and should set a lock timeout
+ * so that prefetching never waits behind the writers.
+ *
+ * Returns whether the document targeted by an update or delete was found.
+ */
+bool prefetchPagesForReplicatedOp(OperationContext* opCtx,
+                                  const OplogEntry& op,
+                                  ReplSettings::IndexPrefetchConfig config);
+
+}  // namespace repl
+}  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/db/repl/replication_coordinator_external_state_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "mongo/base/status_with.h"
@@ -65,6 +66,9 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_applier_impl.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
+#include "mongo/db/repl/oplog_buffer_collection.h"
+#include "mongo/db/repl/oplog_buffer_proxy.h"
+#include "mongo/db/repl/oplog_buffer_spilling.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_process.h"
@@ -147,6 +151,40 @@ MONGO_EXPORT_SERVER_PARAMETER(oplogFetcherInitialSyncMaxFetcherRestarts, int, 10
         return Status::OK();
     });
 
+const char kBlockingQueueOplogBufferName[] = "inMemoryBlockingQueue";
+const char kSpillToCollectionOplogBufferName[] = "spillToCollection";
+
+// Set this to specify how the oplog is buffered between fetching and application during steady
+// state replication. With "spillToCollection", operations that do not fit into the in-memory
+// buffer are written to a temporary collection instead of stopping the fetcher.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(steadyStateOplogBuffer,
+                                      std::string,
+                                      kBlockingQueueOplogBufferName)
+    ->withValidator([](const std::string& potentialNewValue) {
+        if (potentialNewValue != kBlockingQueueOplogBufferName &&
+            potentialNewValue != kSpillToCollectionOplogBufferName) {
+            return Status(ErrorCodes::BadValue,
+                          "unsupported steady state oplog buffer option: " + potentialNewValue);
+        }
+        return Status::OK();
+    });
+
+// Set this to specify the maximum size in megabytes of the operations spilled by the
+// "spillToCollection" oplog buffer before the fetcher waits for application. 0 means no limit.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(steadyStateOplogBufferMaxSpillSizeMB, int, 10 * 1024)
+    ->withValidator([](const int& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "steadyStateOplogBufferMaxSpillSizeMB must be nonnegative");
+        }
+        return Status::OK();
+    });
+
+// Set this to specify size of read ahead buffer of the collection that the oplog is spilled to.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(steadyStateOplogBufferPeekCacheSize, int, 10000);
+
+const NamespaceString kSpilledOplogBufferNamespace("local.temp_steady_state_oplog_buffer");
+
 // The count of items in the buffer
 OplogBuffer::Counters bufferGauge;
 ServerStatusMetricField<Counter64> displayBufferCount("repl.buffer.count", &bufferGauge.count);
@@ -240,10 +278,28 @@ void ReplicationCoordinatorExternalStateImpl::startSteadyStateReplication(
         return;
 
     invariant(replCoord);
-    _oplogBuffer = std::make_unique<OplogBufferBlockingQueue>(&bufferGauge);
-
-    // No need to log OplogBuffer::startup because the blocking queue implementation
-    // does not start any threads or access the storage layer.
+    if (steadyStateOplogBuffer == kSpillToCollectionOplogBufferName) {
+        auto memoryBuffer = std::make_unique<OplogBufferBlockingQueue>();
+        OplogBufferSpilling::Options options;
+        options.memoryLimitBytes = memoryBuffer->getMaxSize();
+        options.spillLimitBytes = std::size_t(steadyStateOplogBufferMaxSpillSizeMB) * 1024 * 1024;
+
+        OplogBufferCollection::Options spillOptions;
+        spillOptions.peekCacheSize = std::size_t(std::max(0, steadyStateOplogBufferPeekCacheSize));
+        auto spillBuffer =
+            std::make_unique<OplogBufferProxy>(std::make_unique<OplogBufferCollection>(
+                _storageInterface, kSpilledOplogBufferNamespace, spillOptions));
+
+        _oplogBuffer = std::make_unique<OplogBufferSpilling>(
+            std::move(memoryBuffer), std::move(spillBuffer), options, &bufferGauge);
+
+        log() << "Starting replication oplog buffer, spilling to " << kSpilledOplogBufferNamespace;
+    } else {
+        _oplogBuffer = std::make_unique<OplogBufferBlockingQueue>(&bufferGauge);
+
+        // No need to log OplogBuffer::startup because the blocking queue implementation
+        // does not start any threads or access the storage layer.
+    }
     _oplogBuffer->startup(opCtx);
 
     invariant(!_oplogApplier);
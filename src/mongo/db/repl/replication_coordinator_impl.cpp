@@ -253,57 +253,72 @@ private:
     Waiter* _waiter;
 };
 
+ReplicationCoordinatorImpl::WaiterList::WaiterKey
+ReplicationCoordinatorImpl::WaiterList::_keyOf(WaiterType waiter) {
+    if (!waiter->writeConcern) {
+        return WaiterKey{0, std::string(), -1};
+    }
+    return WaiterKey{waiter->writeConcern->wNumNodes,
+                     waiter->writeConcern->wMode,
+                     static_cast<int>(waiter->writeConcern->syncMode)};
+}
+
 void ReplicationCoordinatorImpl::WaiterList::add_inlock(WaiterType waiter) {
-    _list.push_back(waiter);
+    _waiters[_keyOf(waiter)].insert(waiter);
 }
 
 void ReplicationCoordinatorImpl::WaiterList::signalIf_inlock(
     stdx::function<bool(WaiterType)> func) {
-    for (auto it = _list.begin(); it != _list.end();) {
-        if (!func(*it)) {
-            // This element doesn't match, so we advance the iterator to the next one.
-            ++it;
-            continue;
-        }
-
-        if (!(*it)->runs_once()) {
-            (*it)->notify_inlock();
-            // Keep the waiter on the list and let the guard remove it instead. Advance the
-            // iterator since we are skipping the removal.
-            ++it;
-            continue;
-        }
+    _signal_inlock(func, false);
+}
 
-        // Remove the waiter from the list if it was only meant to be notified once.
-        WaiterType waiter = std::move(*it);
+void ReplicationCoordinatorImpl::WaiterList::signalUpTo_inlock(
+    stdx::function<bool(WaiterType)> func) {
+    _signal_inlock(func, true);
+}
+
+void ReplicationCoordinatorImpl::WaiterList::_signal_inlock(
+    const stdx::function<bool(WaiterType)>& func, bool stopAtUnsatisfied) {
+    std::vector<WaiterType> satisfied;
+    for (auto groupIt = _waiters.begin(); groupIt != _waiters.end();) {
+        auto& group = groupIt->second;
+        for (auto it = group.begin(); it != group.end();) {
+            if (!func(*it)) {
+                if (stopAtUnsatisfied) {
+                    // Waiters later in this group wait for even later opTimes.
+                    break;
+                }
+                ++it;
+                continue;
+            }
 
-        if (it == std::prev(_list.end())) {
-            // Iterator will be invalid after erasing the last element, so set it to the
-            // next one (i.e. end()).
-            it = _list.erase(it);
-        } else {
-            // Iterator is still valid after pop_back().
-            std::swap(*it, _list.back());
-            _list.pop_back();
+            satisfied.push_back(*it);
+            // Remove the waiter from the list if it was only meant to be notified once. Others
+            // are kept on the list and removed by their guard instead.
+            it = (*it)->runs_once() ? group.erase(it) : std::next(it);
         }
-        // It's important to call notify() after the waiter has been removed from the list
-        // since notify() might remove the waiter itself.
+        groupIt = group.empty() ? _waiters.erase(groupIt) : std::next(groupIt);
+    }
+
+    // It's important to call notify() after the waiter has been removed from the list since
+    // notify() might remove the waiter itself, or change the list.
+    for (auto&& waiter : satisfied) {
         waiter->notify_inlock();
     }
 }
 
-
 void ReplicationCoordinatorImpl::WaiterList::signalAll_inlock() {
     this->signalIf_inlock([](Waiter* waiter) { return true; });
 }
 
 bool ReplicationCoordinatorImpl::WaiterList::remove_inlock(WaiterType waiter) {
-    auto it = std::find(_list.begin(), _list.end(), waiter);
-    if (it == _list.end()) {
+    auto groupIt = _waiters.find(_keyOf(waiter));
+    if (groupIt == _waiters.end() || groupIt->second.erase(waiter) == 0) {
         return false;
     }
-    std::swap(*it, _list.back());
-    _list.pop_back();
+    if (groupIt->second.empty()) {
+        _waiters.erase(groupIt);
+    }
     return true;
 }
 
@@ -362,6 +377,10 @@ ReplicationCoordinatorImpl::ReplicationCoordinatorImpl(
 
     invariant(_service);
 
+    if (settings.isPrefetchIndexModeSet()) {
+        _indexPrefetchConfig = settings.getPrefetchIndexMode();
+    }
+
     if (!isReplEnabled()) {
         return;
     }
@@ -1133,7 +1152,7 @@ void ReplicationCoordinatorImpl::_setMyLastAppliedOpTime_inlock(const OpTime& op
     }
 
     // Signal anyone waiting on optime changes.
-    _opTimeWaiterList.signalIf_inlock(
+    _opTimeWaiterList.signalUpTo_inlock(
         [opTime](Waiter* waiter) { return waiter->opTime <= opTime; });
 
     if (opTime.isNull()) {
@@ -2834,7 +2853,9 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig_inlock(OperationContext* opCtx,
 }
 
 void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock() {
-    _replicationWaiterList.signalIf_inlock([this](Waiter* waiter) {
+    // Whether a write concern is satisfied only gets harder as the waited for opTime grows, so
+    // each write concern's waiters are only checked up to the first one still waiting.
+    _replicationWaiterList.signalUpTo_inlock([this](Waiter* waiter) {
         return _doneWaitingForReplication_inlock(waiter->opTime, *waiter->writeConcern);
     });
 }
@@ -3096,6 +3117,14 @@ boost::optional<OpTime> ReplicationCoordinatorImpl::getStableOpTime_forTest() {
     return _getStableOpTime_inlock();
 }
 
+void ReplicationCoordinatorImpl::addOpTimeCallback_forTest(const OpTime& opTime,
+                                                           stdx::function<void()> callback) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _opTimeCallbacksForTest.push_back(
+        stdx::make_unique<CallbackWaiter>(opTime, std::move(callback)));
+    _opTimeWaiterList.add_inlock(_opTimeCallbacksForTest.back().get());
+}
+
 boost::optional<OpTime> ReplicationCoordinatorImpl::_getStableOpTime_inlock() {
     auto commitPoint = _topCoord->getLastCommittedOpTime();
     if (_currentCommittedSnapshot) {
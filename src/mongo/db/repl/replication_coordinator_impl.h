@@ -28,7 +28,11 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <set>
+#include <string>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -355,6 +359,12 @@ public:
     std::set<OpTime> getStableOpTimeCandidates_forTest();
     boost::optional<OpTime> getStableOpTime_forTest();
 
+    /**
+     * Registers 'callback' to run, while holding _mutex, once the last applied opTime reaches
+     * 'opTime'. The callback runs at most once.
+     */
+    void addOpTimeCallback_forTest(const OpTime& opTime, stdx::function<void()> callback);
+
     /**
      * Non-blocking version of updateTerm.
      * Returns event handle that we can use to wait for the operation to complete.
@@ -501,11 +511,34 @@ private:
         bool remove_inlock(WaiterType waiter);
         // Signals all waiters that satisfy the condition.
         void signalIf_inlock(stdx::function<bool(WaiterType)> fun);
+        // Signals all waiters that satisfy the condition, which must be monotonic in opTime: if it
+        // holds for a waiter, it holds for every waiter with the same write concern and an
+        // earlier or equal opTime. Only the satisfied waiters and the first unsatisfied waiter of
+        // each write concern are visited.
+        void signalUpTo_inlock(stdx::function<bool(WaiterType)> fun);
         // Signals all waiters from the list.
         void signalAll_inlock();
 
     private:
-        std::vector<WaiterType> _list;
+        // Identifies the waiters that are satisfied by the same replication progress: the number
+        // of nodes, the mode and the sync mode of their write concern.
+        using WaiterKey = std::tuple<int, std::string, int>;
+
+        // Orders waiters by opTime, breaking ties by address.
+        struct OpTimeOrder {
+            bool operator()(WaiterType lhs, WaiterType rhs) const {
+                if (lhs->opTime != rhs->opTime) {
+                    return lhs->opTime < rhs->opTime;
+                }
+                return std::less<WaiterType>()(lhs, rhs);
+            }
+        };
+
+        static WaiterKey _keyOf(WaiterType waiter);
+
+        void _signal_inlock(const stdx::function<bool(WaiterType)>& fun, bool stopAtUnsatisfied);
+
+        std::map<WaiterKey, std::set<WaiterType, OpTimeOrder>> _waiters;
     };
 
     typedef std::vector<executor::TaskExecutor::CallbackHandle> HeartbeatHandles;
@@ -1140,6 +1173,9 @@ private:
     // Does *not* own the WaiterInfos.
     WaiterList _opTimeWaiterList;  // (M)
 
+    // Waiters registered on _opTimeWaiterList through addOpTimeCallback_forTest().
+    std::vector<std::unique_ptr<CallbackWaiter>> _opTimeCallbacksForTest;  // (M)
+
     // Set to true when we are in the process of shutting down replication.
     bool _inShutdown;  // (M)
 
@@ -1273,10 +1309,11 @@ private:
     // Source of random numbers used in setting election timeouts, etc.
     PseudoRandom _random;  // (M)
 
-    // This setting affects the Applier prefetcher behavior.
+    // This setting affects the Applier prefetcher behavior. Starts out as --replIndexPrefetch, and
+    // can be changed at runtime through the replIndexPrefetch server parameter.
     mutable stdx::mutex _indexPrefetchMutex;
     ReplSettings::IndexPrefetchConfig _indexPrefetchConfig =
-        ReplSettings::IndexPrefetchConfig::PREFETCH_ALL;  // (I)
+        ReplSettings::IndexPrefetchConfig::PREFETCH_NONE;  // (I)
 
     // The catchup state including all catchup logic. The presence of a non-null pointer indicates
     // that the node is currently in catchup mode.
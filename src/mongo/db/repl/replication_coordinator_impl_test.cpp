@@ -4252,6 +4252,50 @@ TEST_F(ReplCoordTest, NodeReturnsNotAReplicaSetWhenWaitUntilOpTimeIsRunAgainstAS
     ASSERT_EQ(status, ErrorCodes::NotAReplicaSet);
 }
 
+TEST_F(ReplCoordTest, OpTimeWaitersAreSignaledInOpTimeOrderUpToTheAppliedOpTime) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0))),
+                       HostAndPort("node1", 12345));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(10, 1));
+
+    // Records the id of each waiter as it is signaled.
+    auto signaled = std::make_shared<std::vector<int>>();
+    auto addWaiter = [&](int id, const OpTime& opTime) {
+        getReplCoord()->addOpTimeCallback_forTest(opTime,
+                                                  [signaled, id] { signaled->push_back(id); });
+    };
+    addWaiter(0, OpTimeWithTermOne(40, 1));
+    addWaiter(1, OpTimeWithTermOne(30, 1));
+    addWaiter(2, OpTimeWithTermOne(20, 1));
+    // Waiters 3 and 4 wait for the same opTime and must both be kept on the list.
+    addWaiter(3, OpTimeWithTermOne(30, 1));
+    addWaiter(4, OpTimeWithTermOne(30, 1));
+
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(15, 1));
+    ASSERT(signaled->empty());
+
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(30, 1));
+    ASSERT_EQ(4U, signaled->size());
+    ASSERT_EQ(2, signaled->front());
+    // Waiters with equal opTimes are signaled in an unspecified order.
+    ASSERT(std::set<int>({1, 3, 4}) == std::set<int>(signaled->begin() + 1, signaled->end()));
+
+    // The waiter past the applied opTime is still blocked until the opTime reaches it.
+    signaled->clear();
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(35, 1));
+    ASSERT(signaled->empty());
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermOne(40, 1));
+    ASSERT_EQ(1U, signaled->size());
+    ASSERT_EQ(0, signaled->front());
+}
+
 // TODO(dannenberg): revisit these after talking with mathias (redundant with other set?)
 TEST_F(ReplCoordTest, ReadAfterCommittedWhileShutdown) {
     assertStartSuccess(BSON("_id"
@@ -32,10 +32,13 @@
 
 #include "mongo/db/repl/rollback_impl.h"
 
+#include <algorithm>
+
 #include "mongo/db/background.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/uuid_catalog.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
@@ -53,9 +56,11 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/session_catalog.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/s/catalog/type_config_version.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -86,6 +91,50 @@ MONGO_EXPORT_SERVER_PARAMETER(rollbackTimeLimitSecs, int, 60 * 60 * 24)  // Defa
 constexpr auto kInsertCmdName = "insert"_sd;
 constexpr auto kUpdateCmdName = "update"_sd;
 constexpr auto kDeleteCmdName = "delete"_sd;
+
+// The number of times each phase of rollback has run and the total time spent in it.
+TimerStats awaitBgIndexesStats;
+ServerStatusMetricField<TimerStats> displayAwaitBgIndexesStats(
+    "repl.rollback.phases.awaitBackgroundIndexes", &awaitBgIndexesStats);
+TimerStats findCommonPointStats;
+ServerStatusMetricField<TimerStats> displayFindCommonPointStats(
+    "repl.rollback.phases.findCommonPoint", &findCommonPointStats);
+TimerStats findRecordStoreCountsStats;
+ServerStatusMetricField<TimerStats> displayFindRecordStoreCountsStats(
+    "repl.rollback.phases.findRecordStoreCounts", &findRecordStoreCountsStats);
+TimerStats writeRollbackFilesStats;
+ServerStatusMetricField<TimerStats> displayWriteRollbackFilesStats(
+    "repl.rollback.phases.writeRollbackFiles", &writeRollbackFilesStats);
+TimerStats recoverToStableTimestampStats;
+ServerStatusMetricField<TimerStats> displayRecoverToStableTimestampStats(
+    "repl.rollback.phases.recoverToStableTimestamp", &recoverToStableTimestampStats);
+TimerStats recoverFromOplogStats;
+ServerStatusMetricField<TimerStats> displayRecoverFromOplogStats(
+    "repl.rollback.phases.recoverFromOplog", &recoverFromOplogStats);
+
+/**
+ * Times one phase of rollback. On destruction, logs the duration, adds it to the phase's
+ * serverStatus metric and records it for the rollback summary.
+ */
+class RollbackPhaseTimer {
+    MONGO_DISALLOW_COPYING(RollbackPhaseTimer);
+
+public:
+    RollbackPhaseTimer(StringData phase, TimerStats* stats, RollbackStats* rollbackStats)
+        : _phase(phase), _stats(stats), _rollbackStats(rollbackStats) {}
+
+    ~RollbackPhaseTimer() {
+        const Milliseconds elapsed(_stats->record(_timer));
+        log() << "Rollback phase '" << _phase << "' took " << elapsed;
+        _rollbackStats->phaseDurations.emplace_back(_phase.toString(), elapsed);
+    }
+
+private:
+    const StringData _phase;
+    TimerStats* const _stats;
+    RollbackStats* const _rollbackStats;
+    Timer _timer;
+};
 }  // namespace
 
 constexpr const char* RollbackImpl::kRollbackRemoveSaverType;
@@ -152,13 +201,20 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     ON_BLOCK_EXIT([this, opCtx] { _summarizeRollback(opCtx); });
 
     // Wait for all background index builds to complete before starting the rollback process.
-    status = _awaitBgIndexCompletion(opCtx);
+    status = [&] {
+        RollbackPhaseTimer phaseTimer(
+            "await background indexes", &awaitBgIndexesStats, &_rollbackStats);
+        return _awaitBgIndexCompletion(opCtx);
+    }();
     if (!status.isOK()) {
         return status;
     }
     _listener->onBgIndexesComplete();
 
-    auto commonPointSW = _findCommonPoint(opCtx);
+    auto commonPointSW = [&] {
+        RollbackPhaseTimer phaseTimer("find common point", &findCommonPointStats, &_rollbackStats);
+        return _findCommonPoint(opCtx);
+    }();
     if (!commonPointSW.isOK()) {
         return commonPointSW.getStatus();
     }
@@ -180,7 +236,11 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     // point, we keep track of how much each collection's count will change during the rollback.
     // Note: these numbers are relative to the common point, not the stable timestamp, and thus
     // must be set after recovering from the oplog.
-    status = _findRecordStoreCounts(opCtx);
+    status = [&] {
+        RollbackPhaseTimer phaseTimer(
+            "find record store counts", &findRecordStoreCountsStats, &_rollbackStats);
+        return _findRecordStoreCounts(opCtx);
+    }();
     if (!status.isOK()) {
         return status;
     }
@@ -197,7 +257,11 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     if (shouldCreateDataFiles()) {
         // Write a rollback file for each namespace that has documents that would be deleted by
         // rollback.
-        status = _writeRollbackFiles(opCtx);
+        status = [&] {
+            RollbackPhaseTimer phaseTimer(
+                "write rollback files", &writeRollbackFilesStats, &_rollbackStats);
+            return _writeRollbackFiles(opCtx);
+        }();
         if (!status.isOK()) {
             return status;
         }
@@ -206,7 +270,11 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     }
 
     // Recover to the stable timestamp.
-    auto stableTimestampSW = _recoverToStableTimestamp(opCtx);
+    auto stableTimestampSW = [&] {
+        RollbackPhaseTimer phaseTimer(
+            "recover to stable timestamp", &recoverToStableTimestampStats, &_rollbackStats);
+        return _recoverToStableTimestamp(opCtx);
+    }();
     if (!stableTimestampSW.isOK()) {
         return stableTimestampSW.getStatus();
     }
@@ -253,8 +321,12 @@ Status RollbackImpl::runRollback(OperationContext* opCtx) {
     _resetDropPendingState(opCtx);
 
     // Run the recovery process.
-    _replicationProcess->getReplicationRecovery()->recoverFromOplog(opCtx,
-                                                                    stableTimestampSW.getValue());
+    {
+        RollbackPhaseTimer phaseTimer(
+            "recover from oplog", &recoverFromOplogStats, &_rollbackStats);
+        _replicationProcess->getReplicationRecovery()->recoverFromOplog(
+            opCtx, stableTimestampSW.getValue());
+    }
     _listener->onRecoverFromOplog();
 
     // Sets the correct post-rollback counts on any collections whose counts changed during the
@@ -828,7 +900,11 @@ void RollbackImpl::_writeRollbackFileForNamespace(OperationContext* opCtx,
         _rollbackStats.rollbackDataFileDirectory = std::string(newDirectoryPath.begin(), prefixEnd);
     }
 
-    for (auto&& id : idSet) {
+    // Read the documents in _id order, so that the lookups walk the _id index and the collection
+    // sequentially instead of jumping around them for each document of a large rollback.
+    std::vector<BSONObj> ids(idSet.begin(), idSet.end());
+    std::sort(ids.begin(), ids.end(), SimpleBSONObjComparator::kInstance.makeLessThan());
+    for (auto&& id : ids) {
         // StorageInterface::findById() does not respect the collation, but because we are using
         // exact _id fields recorded in the oplog, we can get away with binary string
         // comparisons.
@@ -951,6 +1027,12 @@ void RollbackImpl::_summarizeRollback(OperationContext* opCtx) const {
     for (const auto& entry : _observerInfo.rollbackCommandCounts) {
         log() << "\t\t" << entry.first << ": " << entry.second;
     }
+    if (!_rollbackStats.phaseDurations.empty()) {
+        log() << "\tphase durations:";
+        for (auto&& phase : _rollbackStats.phaseDurations) {
+            log() << "\t\t" << phase.first << ": " << phase.second;
+        }
+    }
     log() << "\ttotal number of entries rolled back (including no-ops): "
           << _observerInfo.numberOfEntriesObserved;
 }
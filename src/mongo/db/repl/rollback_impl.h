@@ -28,6 +28,10 @@
 
 #pragma once
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "mongo/base/status_with.h"
 #include "mongo/db/op_observer.h"
 #include "mongo/db/repl/oplog_entry.h"
@@ -103,6 +107,11 @@ struct RollbackStats {
      * The wall clock time at the common point, if known.
      */
     boost::optional<Date_t> commonPointWallClockTime;
+
+    /**
+     * The duration of each phase of rollback that has finished, in the order they ran.
+     */
+    std::vector<std::pair<std::string, Milliseconds>> phaseDurations;
 };
 
 /**
@@ -257,6 +266,10 @@ public:
         return _namespacesForOp(oplogEntry);
     }
 
+    const RollbackStats& getRollbackStats_forTest() const {
+        return _rollbackStats;
+    }
+
     /**
      * Returns true if the rollback system should write out data files containing documents that
      * will be deleted by rollback.
@@ -29,11 +29,15 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/filesystem.hpp>
 #include <boost/optional.hpp>
+#include <fstream>
+#include <iterator>
 
 #include "mongo/db/catalog/collection_mock.h"
 #include "mongo/db/catalog/drop_collection.h"
 #include "mongo/db/catalog/uuid_catalog.h"
+#include "mongo/db/commands/server_status_internal.h"
 #include "mongo/db/repl/drop_pending_collection_reaper.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/oplog_interface_local.h"
@@ -111,15 +115,27 @@ public:
         return iter->second;
     }
 
+    /**
+     * Makes rollback write its files to the data directory, as a real RollbackImpl does.
+     */
+    void setWriteRollbackFiles_forTest() {
+        _writeRollbackFiles = true;
+    }
+
 protected:
     /**
      * Saves documents that would be deleted in '_uuidToObjsMap', rather than writing them out to a
-     * file.
+     * file, unless setWriteRollbackFiles_forTest() was called.
      */
     void _writeRollbackFileForNamespace(OperationContext* opCtx,
                                         UUID uuid,
                                         NamespaceString nss,
                                         const SimpleBSONObjUnorderedSet& idSet) final {
+        if (_writeRollbackFiles) {
+            RollbackImpl::_writeRollbackFileForNamespace(opCtx, uuid, nss, idSet);
+            return;
+        }
+
         log() << "Simulating writing a rollback file for namespace " << nss.ns() << " with uuid "
               << uuid;
         for (auto&& id : idSet) {
@@ -134,6 +150,7 @@ protected:
 
 private:
     stdx::unordered_map<UUID, std::vector<BSONObj>, UUID::Hash> _uuidToObjsMap;
+    bool _writeRollbackFiles = false;
 };
 
 const std::vector<BSONObj> RollbackImplForTest::kEmptyVector;
@@ -888,6 +905,96 @@ TEST_F(RollbackImplTest, RollbackSavesInsertedDocumentToFile) {
     ASSERT_BSONOBJ_EQ(deletedObjs.front(), obj);
 }
 
+TEST_F(RollbackImplTest, RollbackWritesRollbackFileInIdOrder) {
+    const auto commonOp = makeOpAndRecordId(1);
+    _remoteOplog->setOperations({commonOp});
+    ASSERT_OK(_insertOplogEntry(commonOp.first));
+    _storageInterface->setStableTimestamp(nullptr, Timestamp(1, 1));
+
+    const auto nss = NamespaceString("db.people");
+    const auto uuid = UUID::gen();
+    const auto coll = _initializeCollection(_opCtx.get(), uuid, nss);
+
+    // Insert the documents out of _id order. They take up more than the 1MB that the file is
+    // buffered in, so the file is written in several parts.
+    const int numDocs = 2003;
+    const std::string padding(1024, 'x');
+    for (int i = 0; i < numDocs; ++i) {
+        _insertDocAndGenerateOplogEntry(BSON("_id" << (i * 7919) % numDocs << "padding" << padding),
+                                        uuid,
+                                        nss);
+    }
+
+    _rollback->setWriteRollbackFiles_forTest();
+    ASSERT_OK(_rollback->runRollback(_opCtx.get()));
+
+    const auto& directory = _rollback->getRollbackStats_forTest().rollbackDataFileDirectory;
+    ASSERT(directory);
+    std::vector<boost::filesystem::path> files{
+        boost::filesystem::directory_iterator(boost::filesystem::path(*directory)),
+        boost::filesystem::directory_iterator()};
+    ASSERT_EQ(files.size(), 1UL);
+
+    std::ifstream file(files.front().string(), std::ios_base::in | std::ios_base::binary);
+    const std::string contents{std::istreambuf_iterator<char>(file),
+                               std::istreambuf_iterator<char>()};
+    int expectedId = 0;
+    for (size_t offset = 0; offset < contents.size(); ++expectedId) {
+        BSONObj doc(contents.data() + offset);
+        ASSERT_BSONOBJ_EQ(doc, BSON("_id" << expectedId << "padding" << padding));
+        offset += doc.objsize();
+    }
+    ASSERT_EQ(expectedId, numDocs);
+}
+
+TEST_F(RollbackImplTest, RollbackRecordsTheDurationOfEachPhase) {
+    const auto getPhaseCounts = [] {
+        BSONObjBuilder bob;
+        MetricTree::theMetricTree->appendTo(bob);
+        const auto metrics = bob.obj();
+        std::map<std::string, long long> counts;
+        for (auto&& phase : metrics["metrics"]["repl"]["rollback"]["phases"].Obj()) {
+            counts[phase.fieldName()] = phase["num"].numberLong();
+        }
+        return counts;
+    };
+    auto countsBefore = getPhaseCounts();
+
+    const auto commonOp = makeOpAndRecordId(1);
+    _remoteOplog->setOperations({commonOp});
+    ASSERT_OK(_insertOplogEntry(commonOp.first));
+    ASSERT_OK(_insertOplogEntry(makeOp(2)));
+    _storageInterface->setStableTimestamp(nullptr, Timestamp(1, 1));
+
+    ASSERT_OK(_rollback->runRollback(_opCtx.get()));
+
+    const std::vector<std::string> expectedPhases{"await background indexes",
+                                                  "find common point",
+                                                  "find record store counts",
+                                                  "write rollback files",
+                                                  "recover to stable timestamp",
+                                                  "recover from oplog"};
+    const auto& phaseDurations = _rollback->getRollbackStats_forTest().phaseDurations;
+    ASSERT_EQ(phaseDurations.size(), expectedPhases.size());
+    for (size_t i = 0; i < expectedPhases.size(); ++i) {
+        ASSERT_EQ(phaseDurations[i].first, expectedPhases[i]);
+        ASSERT_GTE(phaseDurations[i].second, Milliseconds(0));
+    }
+
+    // Each phase has run once more according to serverStatus.
+    auto countsAfter = getPhaseCounts();
+    const std::vector<std::string> expectedMetrics{"awaitBackgroundIndexes",
+                                                   "findCommonPoint",
+                                                   "findRecordStoreCounts",
+                                                   "writeRollbackFiles",
+                                                   "recoverToStableTimestamp",
+                                                   "recoverFromOplog"};
+    ASSERT_EQ(countsAfter.size(), expectedMetrics.size());
+    for (auto&& metric : expectedMetrics) {
+        ASSERT_EQ(countsAfter[metric], countsBefore[metric] + 1);
+    }
+}
+
 TEST_F(RollbackImplTest, RollbackSavesLatestVersionOfDocumentWhenThereAreMultipleInserts) {
     const auto commonOp = makeOpAndRecordId(1);
     _remoteOplog->setOperations({commonOp});
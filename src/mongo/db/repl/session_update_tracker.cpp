@@ -56,6 +56,11 @@ void SessionUpdateTracker::_updateSessionInfo(const OplogEntry& entry) {
         return;
     }
 
+    // Only the last entry of a chain of transaction 'applyOps' entries updates the session.
+    if (entry.isPartialTransaction()) {
+        return;
+    }
+
     auto lsid = sessionInfo.getSessionId();
     fassert(50842, lsid.is_initialized());
 
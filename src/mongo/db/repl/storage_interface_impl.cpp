@@ -898,9 +898,9 @@ Status StorageInterfaceImpl::upsertById(OperationContext* opCtx,
         }
 
         // We're using the ID hack to perform the update so we have to disallow collections
-        // without an _id index.
+        // without an _id index, unless they are clustered by _id.
         auto descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
-        if (!descriptor) {
+        if (!descriptor && !collection->getRecordStore()->isClustered()) {
             return Status(ErrorCodes::IndexNotFound,
                           "Unable to update document in a collection without an _id index.");
         }
@@ -33,7 +33,9 @@
 #include "mongo/db/repl/sync_tail.h"
 
 #include "third_party/murmurhash3/MurmurHash3.h"
+#include <algorithm>
 #include <boost/functional/hash.hpp>
+#include <map>
 #include <memory>
 
 #include "mongo/base/counter.h"
@@ -62,6 +64,7 @@
 #include "mongo/db/repl/bgsync.h"
 #include "mongo/db/repl/initial_syncer.h"
 #include "mongo/db/repl/multiapplier.h"
+#include "mongo/db/repl/oplog_prefetch.h"
 #include "mongo/db/repl/oplogreader.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/repl_set_config.h"
@@ -69,15 +72,19 @@
 #include "mongo/db/repl/session_update_tracker.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/session.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/session_txn_record_gen.h"
 #include "mongo/db/stats/timer_stats.h"
+#include "mongo/db/transaction_history_iterator.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/unordered_map.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -102,6 +109,48 @@ ServerStatusMetricField<Counter64> displayAttemptsToBecomeSecondary(
 TimerStats applyBatchStats;
 ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches", &applyBatchStats);
 
+// How evenly the ops of each batch were spread across the writer threads. A batch spread perfectly
+// evenly adds its number of ops divided by the number of writers to 'largestWriterOps'.
+Counter64 writerOpsStats;
+ServerStatusMetricField<Counter64> displayWriterOps("repl.apply.writers.ops", &writerOpsStats);
+Counter64 largestWriterOpsStats;
+ServerStatusMetricField<Counter64> displayLargestWriterOps("repl.apply.writers.largestWriterOps",
+                                                           &largestWriterOpsStats);
+Counter64 idleWritersStats;
+ServerStatusMetricField<Counter64> displayIdleWriters("repl.apply.writers.idleWriters",
+                                                      &idleWritersStats);
+
+// Time each stage of the oplog application pipeline spent on its own work, and waiting on the other
+// stage. Assembling a batch includes waiting for the ops to arrive in the oplog buffer.
+Counter64 batcherAssemblyMicros;
+ServerStatusMetricField<Counter64> displayBatcherAssemblyMicros(
+    "repl.apply.pipeline.batcherAssemblyMicros", &batcherAssemblyMicros);
+Counter64 batcherWaitMicros;
+ServerStatusMetricField<Counter64> displayBatcherWaitMicros("repl.apply.pipeline.batcherWaitMicros",
+                                                            &batcherWaitMicros);
+Counter64 applierWaitMicros;
+ServerStatusMetricField<Counter64> displayApplierWaitMicros("repl.apply.pipeline.applierWaitMicros",
+                                                            &applierWaitMicros);
+Counter64 prefetchMicros;
+ServerStatusMetricField<Counter64> displayPrefetchMicros("repl.apply.pipeline.prefetchMicros",
+                                                         &prefetchMicros);
+
+// How far behind the wall clock time of its last op the most recently applied batch was.
+AtomicInt64 applyLagMillis;
+
+class ApplyLagSSM : public ServerStatusMetric {
+public:
+    ApplyLagSSM() : ServerStatusMetric("repl.apply.lagMillis") {}
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        b.appendNumber(_leafName, applyLagMillis.load());
+    }
+} applyLagSSM;
+
+// Whether the batcher reads the documents that the ops of the next batch update or delete, to pull
+// them into cache while the applier is still busy with the current batch. Setting replIndexPrefetch
+// to "_id_only" or "all" turns this on as well, and extends it to inserts and index entries.
+MONGO_EXPORT_SERVER_PARAMETER(replBatcherPrefetchDocuments, bool, false);
+
 class ApplyBatchFinalizer {
 public:
     ApplyBatchFinalizer(ReplicationCoordinator* replCoord) : _replCoord(replCoord) {}
@@ -476,27 +525,131 @@ private:
     StringMap<CollectionProperties> _cache;
 };
 
+/**
+ * Distributes the ops of a batch to the writer threads. Ops which may conflict share a key, and all
+ * ops with the same key go to the same writer, so that they are applied in oplog order. Each key
+ * seen for the first time goes to the writer which has been given the fewest ops so far, which
+ * keeps the writers evenly loaded even when a few keys account for most of the batch.
+ */
+class WriterAssigner {
+public:
+    explicit WriterAssigner(std::vector<MultiApplier::OperationPtrs>* writerVectors)
+        : _writerVectors(writerVectors) {
+        invariant(!_writerVectors->empty());
+    }
+
+    void assign(uint32_t key, OplogEntry* op) {
+        auto it = _writerForKey.find(key);
+        if (it == _writerForKey.end()) {
+            it = _writerForKey.emplace(key, _leastLoadedWriter()).first;
+        }
+
+        auto& writer = (*_writerVectors)[it->second];
+        if (writer.empty()) {
+            writer.reserve(8);  // Skip a few growth rounds
+        }
+        writer.push_back(op);
+    }
+
+    /**
+     * Records how evenly this batch was spread across the writers.
+     */
+    void recordStats() const {
+        size_t ops = 0;
+        size_t largestWriterOps = 0;
+        size_t idleWriters = 0;
+        for (auto&& writer : *_writerVectors) {
+            ops += writer.size();
+            largestWriterOps = std::max(largestWriterOps, writer.size());
+            if (writer.empty()) {
+                ++idleWriters;
+            }
+        }
+
+        writerOpsStats.increment(ops);
+        largestWriterOpsStats.increment(largestWriterOps);
+        idleWritersStats.increment(idleWriters);
+
+        LOG(2) << "Distributed " << ops << " ops with " << _writerForKey.size()
+               << " distinct keys to " << _writerVectors->size()
+               << " writers; the largest writer got " << largestWriterOps << " ops and "
+               << idleWriters << " writers got none";
+    }
+
+private:
+    size_t _leastLoadedWriter() const {
+        size_t best = 0;
+        for (size_t i = 1; i < _writerVectors->size(); ++i) {
+            if ((*_writerVectors)[i].size() < (*_writerVectors)[best].size()) {
+                best = i;
+            }
+        }
+        return best;
+    }
+
+    std::vector<MultiApplier::OperationPtrs>* const _writerVectors;
+    stdx::unordered_map<uint32_t, size_t> _writerForKey;
+};
+
+/**
+ * Returns the operations of the unprepared transaction committed by 'commitEntry', oldest first.
+ * A large transaction is written as a chain of partial 'applyOps' entries linked through
+ * prevOpTime and ended by 'commitEntry'. The links in the current batch are taken from
+ * 'partialTxnEntries'; the ones from earlier batches have already been written to the oplog and
+ * are read back from there. Every operation is applied at the optime of 'commitEntry'.
+ */
+MultiApplier::Operations extractTransactionOperations(
+    OperationContext* opCtx,
+    const OplogEntry& commitEntry,
+    const std::map<OpTime, const OplogEntry*>& partialTxnEntries) {
+    std::vector<OplogEntry> chain;
+    auto prevOpTime = commitEntry.getPrevWriteOpTimeInTransaction();
+    while (prevOpTime && !prevOpTime->isNull()) {
+        auto it = partialTxnEntries.find(*prevOpTime);
+        auto link = it != partialTxnEntries.end()
+            ? *it->second
+            : TransactionHistoryIterator(*prevOpTime).next(opCtx);
+        if (!link.isPartialTransaction()) {
+            break;
+        }
+        prevOpTime = link.getPrevWriteOpTimeInTransaction();
+        chain.push_back(std::move(link));
+    }
+
+    MultiApplier::Operations operations;
+    for (auto link = chain.rbegin(); link != chain.rend(); ++link) {
+        auto linkOperations = ApplyOps::extractOperations(*link, commitEntry);
+        std::move(linkOperations.begin(), linkOperations.end(), std::back_inserter(operations));
+    }
+    auto commitOperations = ApplyOps::extractOperations(commitEntry);
+    std::move(commitOperations.begin(), commitOperations.end(), std::back_inserter(operations));
+    return operations;
+}
+
 /**
  * ops - This only modifies the isForCappedCollection field on each op. It does not alter the ops
  *      vector in any other way.
- * writerVectors - Set of operations for each worker thread to apply.
+ * writerAssigner - Distributes the operations to the worker threads.
  * derivedOps - If provided, this function inserts a decomposition of applyOps operations
  *      and instructions for updating the transactions table.
  * sessionUpdateTracker - if provided, keeps track of session info from ops.
  */
 void fillWriterVectors(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
-                       std::vector<MultiApplier::OperationPtrs>* writerVectors,
+                       WriterAssigner* writerAssigner,
                        std::vector<MultiApplier::Operations>* derivedOps,
                        SessionUpdateTracker* sessionUpdateTracker) {
     const auto serviceContext = opCtx->getServiceContext();
     const auto storageEngine = serviceContext->getStorageEngine();
 
     const bool supportsDocLocking = storageEngine->supportsDocLocking();
-    const uint32_t numWriters = writerVectors->size();
 
     CachedCollectionProperties collPropertiesCache;
 
+    // Partial transaction 'applyOps' entries seen so far in 'ops', by optime. Their operations are
+    // applied together with the entry that commits their transaction.
+    std::map<OpTime, const OplogEntry*> partialTxnEntries;
+
     for (auto&& op : *ops) {
         StringMapTraits::HashedKey hashedNs(op.getNss().ns());
         uint32_t hash = hashedNs.hash();
@@ -506,7 +659,7 @@ void fillWriterVectors(OperationContext* opCtx,
         if (sessionUpdateTracker) {
             if (auto newOplogWrites = sessionUpdateTracker->updateOrFlush(op)) {
                 derivedOps->emplace_back(std::move(*newOplogWrites));
-                fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                fillWriterVectors(opCtx, &derivedOps->back(), writerAssigner, derivedOps, nullptr);
             }
         }
 
@@ -537,11 +690,16 @@ void fillWriterVectors(OperationContext* opCtx,
         // function.
         if (op.isCommand() && op.getCommandType() == OplogEntry::CommandType::kApplyOps &&
             !op.shouldPrepare()) {
+            if (op.isPartialTransaction()) {
+                partialTxnEntries.emplace(op.getOpTime(), &op);
+                continue;
+            }
             try {
-                derivedOps->emplace_back(ApplyOps::extractOperations(op));
+                derivedOps->emplace_back(
+                    extractTransactionOperations(opCtx, op, partialTxnEntries));
 
                 // Nested entries cannot have different session updates.
-                fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+                fillWriterVectors(opCtx, &derivedOps->back(), writerAssigner, derivedOps, nullptr);
             } catch (...) {
                 fassertFailedWithStatusNoTrace(
                     50711,
@@ -552,11 +710,7 @@ void fillWriterVectors(OperationContext* opCtx,
             continue;
         }
 
-        auto& writer = (*writerVectors)[hash % numWriters];
-        if (writer.empty()) {
-            writer.reserve(8);  // Skip a few growth rounds
-        }
-        writer.push_back(&op);
+        writerAssigner->assign(hash, &op);
     }
 }
 
@@ -564,14 +718,17 @@ void fillWriterVectors(OperationContext* opCtx,
                        MultiApplier::Operations* ops,
                        std::vector<MultiApplier::OperationPtrs>* writerVectors,
                        std::vector<MultiApplier::Operations>* derivedOps) {
+    WriterAssigner writerAssigner(writerVectors);
     SessionUpdateTracker sessionUpdateTracker;
-    fillWriterVectors(opCtx, ops, writerVectors, derivedOps, &sessionUpdateTracker);
+    fillWriterVectors(opCtx, ops, &writerAssigner, derivedOps, &sessionUpdateTracker);
 
     auto newOplogWrites = sessionUpdateTracker.flushAll();
     if (!newOplogWrites.empty()) {
         derivedOps->emplace_back(std::move(newOplogWrites));
-        fillWriterVectors(opCtx, &derivedOps->back(), writerVectors, derivedOps, nullptr);
+        fillWriterVectors(opCtx, &derivedOps->back(), &writerAssigner, derivedOps, nullptr);
     }
+
+    writerAssigner.recordStats();
 }
 
 }  // namespace
@@ -641,15 +798,21 @@ public:
     }
 
     OpQueue getNextBatch(Seconds maxWaitTime) {
+        // The applier is done with its previous batch, so stop prefetching for the next one.
+        _applierBusy.store(false);
+
         stdx::unique_lock<stdx::mutex> lk(_mutex);
         if (_ops.empty() && !_ops.mustShutdown()) {
+            Timer waitTimer;
             // We intentionally don't care about whether this returns due to signaling or timeout
             // since we do the same thing either way: return whatever is in _ops.
             (void)_cv.wait_for(lk, maxWaitTime.toSystemDuration());
+            applierWaitMicros.increment(waitTimer.micros());
         }
 
         OpQueue ops = std::move(_ops);
         _ops = OpQueue(0);
+        _applierBusy.store(!ops.empty());
         _cv.notify_all();
 
         return ops;
@@ -671,6 +834,18 @@ private:
         return fastClockSource->now() - slaveDelay;
     }
 
+    /**
+     * Prefetches the pages 'ops' will touch until the applier asks for the next batch, so that
+     * this never delays it.
+     */
+    void _prefetch(OperationContext* opCtx,
+                   const OpQueue& ops,
+                   ReplSettings::IndexPrefetchConfig config) {
+        Timer timer;
+        SyncTail::prefetchBatch(opCtx, ops, config, [this] { return _applierBusy.load(); });
+        prefetchMicros.increment(timer.micros());
+    }
+
     void run() {
         Client::initThread("ReplBatcher");
 
@@ -688,18 +863,33 @@ private:
             // tryPopAndWaitForMore adds to ops and returns true when we need to end a batch early.
             {
                 auto opCtx = cc().makeOperationContext();
+                Timer assemblyTimer;
                 while (!_syncTail->tryPopAndWaitForMore(
                     opCtx.get(), _oplogBuffer, &ops, batchLimits)) {
                 }
-            }
 
-            if (ops.empty() && !ops.mustShutdown()) {
-                continue;  // Don't emit empty batches.
+                if (ops.empty() && !ops.mustShutdown()) {
+                    continue;  // Don't emit empty batches.
+                }
+                batcherAssemblyMicros.increment(assemblyTimer.micros());
+
+                // While the applier is still working on the previous batch, warm up the cache for
+                // this one.
+                const auto prefetchConfig =
+                    ReplicationCoordinator::get(opCtx.get())->getIndexPrefetchConfig();
+                if (!ops.empty() && _applierBusy.load() &&
+                    (replBatcherPrefetchDocuments.load() ||
+                     prefetchConfig == ReplSettings::IndexPrefetchConfig::PREFETCH_ID_ONLY ||
+                     prefetchConfig == ReplSettings::IndexPrefetchConfig::PREFETCH_ALL)) {
+                    _prefetch(opCtx.get(), ops, prefetchConfig);
+                }
             }
 
             stdx::unique_lock<stdx::mutex> lk(_mutex);
             // Block until the previous batch has been taken.
+            Timer waitTimer;
             _cv.wait(lk, [&] { return _ops.empty(); });
+            batcherWaitMicros.increment(waitTimer.micros());
             _ops = std::move(ops);
             _cv.notify_all();
             if (_ops.mustShutdown()) {
@@ -717,6 +907,9 @@ private:
     stdx::condition_variable _cv;
     OpQueue _ops;
 
+    // Whether the applier is applying a batch, rather than waiting for the next one.
+    AtomicBool _applierBusy{false};
+
     // This only exists so the destructor invariants rather than deadlocking.
     // TODO remove once we trust noexcept enough to mark oplogApplication() as noexcept.
     bool _isDead = false;
@@ -724,6 +917,39 @@ private:
     stdx::thread _thread;  // Must be last so all other members are initialized before starting.
 };
 
+long long SyncTail::prefetchBatch(OperationContext* opCtx,
+                                  const OpQueue& ops,
+                                  ReplSettings::IndexPrefetchConfig config,
+                                  const stdx::function<bool()>& keepGoing) {
+    const bool updatesAndDeletesOnly =
+        config != ReplSettings::IndexPrefetchConfig::PREFETCH_ID_ONLY &&
+        config != ReplSettings::IndexPrefetchConfig::PREFETCH_ALL;
+    if (updatesAndDeletesOnly) {
+        config = ReplSettings::IndexPrefetchConfig::PREFETCH_ID_ONLY;
+    }
+
+    // This only warms up the cache, so it may see the batch being applied half way through and
+    // must not wait for locks held by the applier.
+    ShouldNotConflictWithSecondaryBatchApplicationBlock noConflict(opCtx->lockState());
+    opCtx->lockState()->setMaxLockTimeout(Milliseconds(0));
+    ON_BLOCK_EXIT([&] { opCtx->lockState()->unsetMaxLockTimeout(); });
+
+    long long documents = 0;
+    for (auto&& op : ops.getBatch()) {
+        if (!keepGoing()) {
+            break;
+        }
+        if (!updatesAndDeletesOnly || op.getOpType() == OpTypeEnum::kUpdate ||
+            op.getOpType() == OpTypeEnum::kDelete) {
+            if (prefetchPagesForReplicatedOp(opCtx, op, config)) {
+                ++documents;
+            }
+        }
+    }
+
+    return documents;
+}
+
 void SyncTail::oplogApplication(OplogBuffer* oplogBuffer, ReplicationCoordinator* replCoord) {
     // We don't start data replication for arbiters at all and it's not allowed to reconfig
     // arbiterOnly field for any member.
@@ -792,6 +1018,7 @@ void SyncTail::_oplogApplication(OplogBuffer* oplogBuffer,
         // Extract some info from ops that we'll need after releasing the batch below.
         const auto firstOpTimeInBatch = ops.front().getOpTime();
         const auto lastOpTimeInBatch = ops.back().getOpTime();
+        const auto lastWallClockTimeInBatch = ops.back().getWallClockTime();
         const auto lastAppliedOpTimeAtStartOfBatch = replCoord->getMyLastAppliedOpTime();
 
         // Make sure the oplog doesn't go back in time or repeat an entry.
@@ -851,6 +1078,12 @@ void SyncTail::_oplogApplication(OplogBuffer* oplogBuffer,
             ? ReplicationCoordinator::DataConsistency::Consistent
             : ReplicationCoordinator::DataConsistency::Inconsistent;
         finalizer->record(lastOpTimeInBatch, consistency);
+
+        const auto lastOpWallTime = lastWallClockTimeInBatch
+            ? *lastWallClockTimeInBatch
+            : Date_t::fromDurationSinceEpoch(Seconds(lastOpTimeInBatch.getTimestamp().getSecs()));
+        applyLagMillis.store(
+            std::max<long long>(durationCount<Milliseconds>(Date_t::now() - lastOpWallTime), 0));
     }
 }
 
@@ -865,55 +1098,52 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* opCtx,
                                     OplogBuffer* oplogBuffer,
                                     SyncTail::OpQueue* ops,
                                     const BatchLimits& limits) {
-    {
-        BSONObj op;
-        // Check to see if there are ops waiting in the bgsync queue
-        bool peek_success = oplogBuffer->peek(opCtx, &op);
-        if (!peek_success) {
-            // If we don't have anything in the queue, wait a bit for something to appear.
-            if (ops->empty()) {
-                if (inShutdown()) {
-                    ops->setMustShutdownFlag();
-                } else {
-                    // Block up to 1 second. We still return true in this case because we want this
-                    // op to be the first in a new batch with a new start time.
-                    oplogBuffer->waitForData(Seconds(1));
-                }
+    BSONObj op;
+    // Check to see if there are ops waiting in the bgsync queue
+    bool peek_success = oplogBuffer->peek(opCtx, &op);
+    if (!peek_success) {
+        // If we don't have anything in the queue, wait a bit for something to appear.
+        if (ops->empty()) {
+            if (inShutdown()) {
+                ops->setMustShutdownFlag();
+            } else {
+                // Block up to 1 second. We still return true in this case because we want this
+                // op to be the first in a new batch with a new start time.
+                oplogBuffer->waitForData(Seconds(1));
             }
-
-            return true;
         }
 
-        // If this op would put us over the byte limit don't include it unless the batch is empty.
-        // We allow single-op batches to exceed the byte limit so that large ops are able to be
-        // processed.
-        if (!ops->empty() && (ops->getBytes() + size_t(op.objsize())) > limits.bytes) {
-            return true;  // Return before wasting time parsing the op.
-        }
+        return true;
+    }
 
-        // Don't consume the op if we are told to stop.
-        if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
-            sleepmillis(10);
-            return true;
-        }
+    // If this op would put us over the byte limit don't include it unless the batch is empty.
+    // We allow single-op batches to exceed the byte limit so that large ops are able to be
+    // processed.
+    if (!ops->empty() && (ops->getBytes() + size_t(op.objsize())) > limits.bytes) {
+        return true;  // Return before wasting time parsing the op.
+    }
 
-        ops->emplace_back(std::move(op));  // Parses the op in-place.
+    // Don't consume the op if we are told to stop.
+    if (MONGO_FAIL_POINT(rsSyncApplyStop)) {
+        sleepmillis(10);
+        return true;
     }
 
-    auto& entry = ops->back();
+    // Decide what to do with the op from a view of the few fields involved, so that ops left in
+    // the buffer for a later batch are not parsed.
+    const OplogEntryView entry(op);
 
     // check for oplog version change
-    int curVersion = entry.getVersion();
+    auto curVersion = entry.getVersion();
     if (curVersion != OplogEntry::kOplogVersion) {
         severe() << "expected oplog version " << OplogEntry::kOplogVersion << " but found version "
-                 << curVersion << " in oplog entry: " << redact(entry.toBSON());
+                 << curVersion << " in oplog entry: " << redact(op);
         fassertFailedNoTrace(18820);
     }
 
     auto entryTime = Date_t::fromDurationSinceEpoch(Seconds(entry.getTimestamp().getSecs()));
     if (limits.slaveDelayLatestTimestamp && entryTime > *limits.slaveDelayLatestTimestamp) {
-
-        ops->pop_back();  // Don't do this op yet.
+        // Don't do this op yet.
         if (ops->empty()) {
             // Sleep if we've got nothing to do. Only sleep for 1 second at a time to allow
             // reconfigs and shutdown to occur.
@@ -929,22 +1159,24 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* opCtx,
     // immediately reflects changes for each oplog entry so we can see inconsistent view catalog if
     // multiple oplog entries on 'system.views' are being applied out of the original order.
     if ((entry.isCommand() &&
-         (entry.getCommandType() != OplogEntry::CommandType::kApplyOps || entry.shouldPrepare())) ||
-        entry.getNss().isSystemDotViews()) {
-        if (ops->getCount() == 1) {
+         (entry.getCommandName() != "applyOps"_sd || entry.shouldPrepare())) ||
+        nsToCollectionSubstring(entry.getNss()) == NamespaceString::kSystemDotViewsCollectionName) {
+        if (ops->empty()) {
             // apply commands one-at-a-time
+            ops->emplace_back(std::move(op));  // Parses the op in-place.
             _consume(opCtx, oplogBuffer);
-        } else {
-            // This op must be processed alone, but we already had ops in the queue so we can't
-            // include it in this batch. Since we didn't call consume(), we'll see this again next
-            // time and process it alone.
-            ops->pop_back();
         }
 
+        // Otherwise this op must be processed alone, but we already had ops in the queue so we
+        // can't include it in this batch. Since we didn't call consume(), we'll see this again
+        // next time and process it alone.
+
         // Apply what we have so far.
         return true;
     }
 
+    ops->emplace_back(std::move(op));  // Parses the op in-place.
+
     // We are going to apply this Op.
     _consume(opCtx, oplogBuffer);
 
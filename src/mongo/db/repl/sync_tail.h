@@ -38,6 +38,7 @@
 #include "mongo/db/repl/oplog_applier.h"
 #include "mongo/db/repl/oplog_buffer.h"
 #include "mongo/db/repl/oplog_entry.h"
+#include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_consistency_markers.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/stdx/functional.h"
@@ -204,6 +205,19 @@ public:
                               OpQueue* ops,
                               const BatchLimits& limits);
 
+    /**
+     * Reads the pages which the ops in 'ops' will touch, so that the applier finds them in cache.
+     * Unless 'config' selects what to read, these are the documents which the ops update or
+     * delete, along with their _id index entries. Never waits for a lock, and checks 'keepGoing'
+     * before each op so that the caller can cut it short.
+     *
+     * Returns the number of documents targeted by updates and deletes which were found.
+     */
+    static long long prefetchBatch(OperationContext* opCtx,
+                                   const OpQueue& ops,
+                                   ReplSettings::IndexPrefetchConfig config,
+                                   const stdx::function<bool()>& keepGoing);
+
     /**
      * Fetch a single document referenced in the operation from the sync source.
      *
@@ -43,6 +43,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands/feature_compatibility_version_parser.h"
 #include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
@@ -55,6 +56,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 #include "mongo/db/repl/oplog_interface_local.h"
+#include "mongo/db/repl/oplog_prefetch.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/repl/replication_process.h"
@@ -449,10 +451,8 @@ TEST_F(SyncTailTest,
 }
 
 TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceHash) {
-    // This test relies on implementation details of how multiApply uses hashing to distribute ops
-    // to threads. It is possible for this test to fail, even if the implementation of multiApply is
-    // correct. If it fails, consider adjusting the namespace names (to adjust the hash values) or
-    // the number of threads in the pool.
+    // Each namespace seen for the first time goes to the least loaded writer, so two namespaces
+    // always end up on different writers when there are two of them.
     NamespaceString nss1("test.t0");
     NamespaceString nss2("test.t1");
     auto writerPool = OplogApplier::makeWriterPool(2);
@@ -518,6 +518,175 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_EQUALS(op2, lastEntry);
 }
 
+TEST_F(SyncTailTest, MultiApplyAssignsNewNamespacesToTheLeastLoadedWriterThread) {
+    NamespaceString nss1("test.t0");
+    NamespaceString nss2("test.t1");
+    NamespaceString nss3("test.t2");
+    auto writerPool = OplogApplier::makeWriterPool(2);
+
+    stdx::mutex mutex;
+    std::vector<MultiApplier::Operations> operationsApplied;
+    auto applyOperationFn =
+        [&mutex, &operationsApplied](OperationContext* opCtx,
+                                     MultiApplier::OperationPtrs* operationsForWriterThreadToApply,
+                                     SyncTail* st,
+                                     WorkerMultikeyPathInfo*) -> Status {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsApplied.emplace_back();
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            operationsApplied.back().push_back(*opPtr);
+        }
+        return Status::OK();
+    };
+
+    // The first namespace gets three ops, so the other two have to share the second writer.
+    MultiApplier::Operations ops;
+    for (int i = 1; i <= 3; ++i) {
+        ops.push_back(makeInsertDocumentOplogEntry(
+            {Timestamp(Seconds(i), 0), 1LL}, nss1, BSON("_id" << i)));
+    }
+    ops.push_back(
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(4), 0), 1LL}, nss2, BSON("_id" << 4)));
+    ops.push_back(
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(5), 0), 1LL}, nss3, BSON("_id" << 5)));
+
+    SyncTail syncTail(nullptr,
+                      getConsistencyMarkers(),
+                      getStorageInterface(),
+                      applyOperationFn,
+                      writerPool.get());
+    auto lastOpTime = unittest::assertGet(syncTail.multiApply(_opCtx.get(), ops));
+    ASSERT_EQUALS(ops.back().getOpTime(), lastOpTime);
+
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(operationsApplied.size(), 2U);
+    for (auto&& operationsAppliedByThread : operationsApplied) {
+        ASSERT_FALSE(operationsAppliedByThread.empty());
+        const auto& firstEntry = operationsAppliedByThread.front();
+        if (firstEntry.getNss() == nss1) {
+            ASSERT_EQUALS(3U, operationsAppliedByThread.size());
+            for (size_t i = 0; i < 3; ++i) {
+                ASSERT_EQUALS(ops[i].getOpTime(), operationsAppliedByThread[i].getOpTime());
+            }
+        } else {
+            ASSERT_EQUALS(2U, operationsAppliedByThread.size());
+            ASSERT_EQUALS(nss2, operationsAppliedByThread[0].getNss());
+            ASSERT_EQUALS(nss3, operationsAppliedByThread[1].getNss());
+        }
+    }
+}
+
+TEST_F(SyncTailTest, PrefetchPagesForReplicatedOpReadsTheDocumentsUpdatesAndDeletesTarget) {
+    NamespaceString nss("test.t");
+    createCollection(_opCtx.get(), nss, {});
+    ASSERT_OK(getStorageInterface()->insertDocument(
+        _opCtx.get(),
+        nss,
+        TimestampedBSONObj{BSON("_id" << 1 << "x" << 1), Timestamp()},
+        OpTime::kUninitializedTerm));
+
+    auto update = makeUpdateDocumentOplogEntry(
+        {Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1), BSON("$set" << BSON("x" << 2)));
+    auto deleteOfMissingDoc =
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss, BSON("_id" << 2));
+
+    using Config = ReplSettings::IndexPrefetchConfig;
+    ASSERT_FALSE(prefetchPagesForReplicatedOp(_opCtx.get(), update, Config::PREFETCH_NONE));
+    ASSERT_TRUE(prefetchPagesForReplicatedOp(_opCtx.get(), update, Config::PREFETCH_ID_ONLY));
+    ASSERT_TRUE(prefetchPagesForReplicatedOp(_opCtx.get(), update, Config::PREFETCH_ALL));
+    ASSERT_FALSE(
+        prefetchPagesForReplicatedOp(_opCtx.get(), deleteOfMissingDoc, Config::PREFETCH_ALL));
+}
+
+SyncTail::OpQueue makePrefetchTestBatch(const NamespaceString& nss) {
+    SyncTail::OpQueue ops(0);
+    ops.emplace_back(
+        makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss, BSON("_id" << 1))
+            .toBSON());
+    ops.emplace_back(makeUpdateDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL},
+                                                  nss,
+                                                  BSON("_id" << 1),
+                                                  BSON("$set" << BSON("x" << 2)))
+                         .toBSON());
+    ops.emplace_back(
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL}, nss, BSON("_id" << 2))
+            .toBSON());
+    ops.emplace_back(
+        makeDeleteDocumentOplogEntry({Timestamp(Seconds(4), 0), 1LL}, nss, BSON("_id" << 3))
+            .toBSON());
+    return ops;
+}
+
+TEST_F(SyncTailTest, PrefetchBatchReadsTheDocumentsUpdatesAndDeletesTarget) {
+    NamespaceString nss("test.t");
+    createCollection(_opCtx.get(), nss, {});
+    for (int id = 1; id <= 2; ++id) {
+        ASSERT_OK(getStorageInterface()->insertDocument(
+            _opCtx.get(),
+            nss,
+            TimestampedBSONObj{BSON("_id" << id), Timestamp()},
+            OpTime::kUninitializedTerm));
+    }
+
+    // The update and the first delete find their documents, the second delete's is missing
+    auto ops = makePrefetchTestBatch(nss);
+    ASSERT_EQUALS(2LL,
+                  SyncTail::prefetchBatch(_opCtx.get(),
+                                          ops,
+                                          ReplSettings::IndexPrefetchConfig::PREFETCH_NONE,
+                                          [] { return true; }));
+}
+
+TEST_F(SyncTailTest, PrefetchBatchStopsWhenTheApplierTakesTheBatch) {
+    NamespaceString nss("test.t");
+    createCollection(_opCtx.get(), nss, {});
+    for (int id = 1; id <= 2; ++id) {
+        ASSERT_OK(getStorageInterface()->insertDocument(
+            _opCtx.get(),
+            nss,
+            TimestampedBSONObj{BSON("_id" << id), Timestamp()},
+            OpTime::kUninitializedTerm));
+    }
+
+    // Only the insert and the update are looked at before the applier is done
+    auto ops = makePrefetchTestBatch(nss);
+    int checks = 0;
+    ASSERT_EQUALS(1LL,
+                  SyncTail::prefetchBatch(_opCtx.get(),
+                                          ops,
+                                          ReplSettings::IndexPrefetchConfig::PREFETCH_NONE,
+                                          [&] { return ++checks <= 2; }));
+    ASSERT_EQUALS(3, checks);
+}
+
+TEST_F(SyncTailTest, PrefetchBatchDoesNotWaitForLocksHeldByTheApplier) {
+    NamespaceString nss("test.t");
+    createCollection(_opCtx.get(), nss, {});
+    ASSERT_OK(getStorageInterface()->insertDocument(
+        _opCtx.get(),
+        nss,
+        TimestampedBSONObj{BSON("_id" << 1), Timestamp()},
+        OpTime::kUninitializedTerm));
+
+    // Stands in for a writer thread applying the batch
+    const ResourceId dbResId(RESOURCE_DATABASE, nss.db());
+    LockerImpl applierLocker;
+    ASSERT_EQUALS(LOCK_OK, applierLocker.lockGlobal(MODE_IX));
+    ASSERT_EQUALS(LOCK_OK, applierLocker.lock(dbResId, MODE_X));
+    ON_BLOCK_EXIT([&] {
+        applierLocker.unlock(dbResId);
+        applierLocker.unlockGlobal();
+    });
+
+    auto ops = makePrefetchTestBatch(nss);
+    ASSERT_EQUALS(0LL,
+                  SyncTail::prefetchBatch(_opCtx.get(),
+                                          ops,
+                                          ReplSettings::IndexPrefetchConfig::PREFETCH_ALL,
+                                          [] { return true; }));
+    ASSERT_FALSE(_opCtx->lockState()->isLocked());
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     auto op = makeCreateCollectionOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss);
@@ -1845,6 +2014,72 @@ TEST_F(SyncTailTxnTableTest, MultiApplyUpdatesTheTransactionTable) {
     ASSERT_TRUE(resultNoTxn.isEmpty());
 }
 
+TEST_F(SyncTailTxnTableTest, MultiApplyAppliesChainedTransactionEntriesWithTheCommitEntry) {
+    const auto sessionId = makeLogicalSessionIdForTest();
+    OperationSessionInfo sessionInfo;
+    sessionInfo.setSessionId(sessionId);
+    sessionInfo.setTxnNumber(3);
+    const auto date = Date_t::now();
+
+    auto makeApplyOpsEntry = [&](repl::OpTime opTime,
+                                 repl::OpTime prevOpTime,
+                                 BSONObj doc,
+                                 bool partialTxn) {
+        BSONObjBuilder applyOpsBuilder;
+        applyOpsBuilder.append("applyOps",
+                               BSON_ARRAY(BSON("op"
+                                               << "i"
+                                               << "ns"
+                                               << nss().ns()
+                                               << "o"
+                                               << doc)));
+        if (partialTxn) {
+            applyOpsBuilder.append(OplogEntry::kPartialTxnFieldName, true);
+        }
+        return repl::OplogEntry(opTime,                      // optime
+                                0,                           // hash
+                                repl::OpTypeEnum::kCommand,  // opType
+                                {"admin", "$cmd"},           // namespace
+                                boost::none,                 // uuid
+                                boost::none,                 // fromMigrate
+                                0,                           // version
+                                applyOpsBuilder.obj(),       // o
+                                boost::none,                 // o2
+                                sessionInfo,                 // sessionInfo
+                                boost::none,                 // upsert
+                                date,                        // wall clock time
+                                0,                           // statement id
+                                prevOpTime,                  // optime of previous write
+                                boost::none,                 // pre-image optime
+                                boost::none);                // post-image optime
+    };
+
+    const repl::OpTime firstOpTime(Timestamp(1, 0), 1);
+    const repl::OpTime secondOpTime(Timestamp(2, 0), 1);
+    const repl::OpTime commitOpTime(Timestamp(3, 0), 1);
+    auto firstOp = makeApplyOpsEntry(firstOpTime, repl::OpTime(), BSON("_id" << 1), true);
+    auto secondOp = makeApplyOpsEntry(secondOpTime, firstOpTime, BSON("_id" << 2), true);
+    auto commitOp = makeApplyOpsEntry(commitOpTime, secondOpTime, BSON("_id" << 3), false);
+
+    auto writerPool = OplogApplier::makeWriterPool();
+    SyncTail syncTail(
+        nullptr, getConsistencyMarkers(), getStorageInterface(), multiSyncApply, writerPool.get());
+
+    // The first link arrives in an earlier batch than the rest of the chain, so the commit entry
+    // reads it back from the oplog. Nothing is applied until the commit entry arrives.
+    ASSERT_OK(syncTail.multiApply(_opCtx.get(), {firstOp}));
+    DBDirectClient client(_opCtx.get());
+    ASSERT_EQ(0U, client.count(nss().ns()));
+    ASSERT_TRUE(client
+                    .findOne(NamespaceString::kSessionTransactionsTableNamespace.ns(),
+                             BSON(SessionTxnRecord::kSessionIdFieldName << sessionId.toBSON()))
+                    .isEmpty());
+
+    ASSERT_OK(syncTail.multiApply(_opCtx.get(), {secondOp, commitOp}));
+    ASSERT_EQ(3U, client.count(nss().ns()));
+    checkTxnTable(sessionInfo, commitOpTime, date);
+}
+
 TEST_F(IdempotencyTest, EmptyCappedNamespaceNotFound) {
     // Create a BSON "emptycapped" command.
     auto emptyCappedCmd = BSON("emptycapped" << nss.coll());
@@ -1879,6 +2114,33 @@ TEST_F(IdempotencyTest, ConvertToCappedNamespaceNotFound) {
     ASSERT_FALSE(autoColl.getDb());
 }
 
+TEST(OplogEntryViewTest, ViewAgreesWithParsedEntry) {
+    const NamespaceString nss("test.t");
+    auto insertOp =
+        makeInsertDocumentOplogEntry(OpTime(Timestamp(5, 2), 3), nss, BSON("_id" << 1));
+    OplogEntryView insertView(insertOp.raw);
+    ASSERT_EQ(insertOp.getTimestamp(), insertView.getTimestamp());
+    ASSERT_EQ(insertOp.getOpTime(), insertView.getOpTime());
+    ASSERT_EQ(insertOp.getVersion(), insertView.getVersion());
+    ASSERT_EQ(nss.ns(), insertView.getNss());
+    ASSERT_EQ("i"_sd, insertView.getOpType());
+    ASSERT_FALSE(insertView.isCommand());
+    ASSERT_FALSE(insertView.shouldPrepare());
+    ASSERT_EQ(insertOp.getRawObjSizeBytes(), insertView.getRawObjSizeBytes());
+
+    auto commandOp =
+        makeCommandOplogEntry(OpTime(Timestamp(6, 1), 3), nss, BSON("drop" << nss.coll()));
+    OplogEntryView commandView(commandOp.raw);
+    ASSERT_TRUE(commandView.isCommand());
+    ASSERT_EQ("drop"_sd, commandView.getCommandName());
+    ASSERT_EQ(commandOp.getOpTime(), commandView.getOpTime());
+
+    OplogEntryView emptyView(BSONObj{});
+    ASSERT_EQ(1LL, emptyView.getVersion());
+    ASSERT_EQ(OpTime::kUninitializedTerm, emptyView.getOpTime().getTerm());
+    ASSERT_TRUE(emptyView.getNss().empty());
+}
+
 }  // namespace
 }  // namespace repl
 }  // namespace mongo
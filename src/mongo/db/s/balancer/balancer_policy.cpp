@@ -228,6 +228,11 @@ Status BalancerPolicy::isShardSuitableReceiver(const ClusterStatistics::ShardSta
                 str::stream() << stat.shardId << " is currently draining."};
     }
 
+    if (stat.isUnderPressure) {
+        return {ErrorCodes::IllegalOperation,
+                str::stream() << stat.shardId << " is under I/O or replication pressure."};
+    }
+
     if (!chunkTag.empty() && !stat.shardTags.count(chunkTag)) {
         return {ErrorCodes::IllegalOperation,
                 str::stream() << stat.shardId << " is not in the correct zone " << chunkTag};
@@ -292,6 +297,14 @@ vector<MigrateInfo> BalancerPolicy::balance(const ShardStatisticsVector& shardSt
                                             std::set<ShardId>* usedShards) {
     vector<MigrateInfo> migrations;
 
+    // Migrations add I/O and replication load on both the donor and the recipient, so shards which
+    // are already under pressure are left out of this round as if they had been used
+    for (const auto& stat : shardStats) {
+        if (stat.isUnderPressure) {
+            usedShards->insert(stat.shardId);
+        }
+    }
+
     // 1) Check for shards, which are in draining mode
     {
         for (const auto& stat : shardStats) {
@@ -165,7 +165,8 @@ public:
     /**
      * Determines whether a shard with the specified utilization statistics would be able to accept
      * a chunk with the specified tag. According to the policy a shard cannot accept chunks if its
-     * size is maxed out and if the chunk's tag conflicts with the tag of the shard.
+     * size is maxed out, if it is under I/O or replication pressure and if the chunk's tag
+     * conflicts with the tag of the shard.
      */
     static Status isShardSuitableReceiver(const ClusterStatistics::ShardStatistics& stat,
                                           const std::string& chunkTag);
@@ -183,7 +184,8 @@ public:
      *
      * The usedShards parameter is in/out and it contains the set of shards, which have already been
      * used for migrations. Used so we don't return multiple conflicting migrations for the same
-     * shard.
+     * shard. Shards under I/O or replication pressure are added to it, so that they are neither
+     * donors nor recipients of any migration in the round.
      */
     static std::vector<MigrateInfo> balance(const ShardStatisticsVector& shardStats,
                                             const DistributionStatus& distribution,
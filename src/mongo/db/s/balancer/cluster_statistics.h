@@ -92,6 +92,10 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Whether the shard's primary is under enough I/O or replication pressure that chunks
+        // should neither be moved to nor from it until the pressure subsides
+        bool isUnderPressure{false};
     };
 
     virtual ~ClusterStatistics();
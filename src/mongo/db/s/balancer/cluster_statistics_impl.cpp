@@ -37,6 +37,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/read_preference.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
@@ -47,17 +48,23 @@
 namespace mongo {
 namespace {
 
+// Shards whose majority commit point lags behind their last write by more than this many seconds
+// neither donate nor receive chunks. Zero disables the check.
+MONGO_EXPORT_SERVER_PARAMETER(balancerMaxShardReplicationLagSecs, int, 0);
+
+// Shards whose WiredTiger cache has at least this percentage of dirty data neither donate nor
+// receive chunks. Zero disables the check.
+MONGO_EXPORT_SERVER_PARAMETER(balancerMaxShardCacheDirtyPercent, int, 0);
+
 const char kVersionField[] = "version";
 
 /**
- * Executes the serverStatus command against the specified shard and obtains the version of the
- * running MongoD service.
+ * Executes the serverStatus command against the specified shard.
  *
- * Returns the MongoD version in strig format or an error. Known error codes are:
+ * Returns the serverStatus response or an error. Known error codes are:
  *  ShardNotFound if shard by that id is not available on the registry
- *  NoSuchKey if the version could not be retrieved
  */
-StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, ShardId shardId) {
+StatusWith<BSONObj> retrieveShardServerStatus(OperationContext* opCtx, ShardId shardId) {
     auto shardRegistry = Grid::get(opCtx)->shardRegistry();
     auto shardStatus = shardRegistry->getShard(opCtx, shardId);
     if (!shardStatus.isOK()) {
@@ -78,15 +85,47 @@ StatusWith<std::string> retrieveShardMongoDVersion(OperationContext* opCtx, Shar
         return commandResponse.getValue().commandStatus;
     }
 
-    BSONObj serverStatus = std::move(commandResponse.getValue().response);
+    return std::move(commandResponse.getValue().response);
+}
+
+/**
+ * Uses the serverStatus response of a shard's primary to determine whether migrations to or from
+ * that shard would compete with replication or with eviction of dirty data for I/O.
+ */
+bool isShardUnderPressure(const ShardId& shardId, const BSONObj& serverStatus) {
+    const int maxReplicationLagSecs = balancerMaxShardReplicationLagSecs.load();
+    if (maxReplicationLagSecs > 0) {
+        const auto lastWrite = serverStatus["repl"]["lastWrite"];
+        const auto lastWriteDate = lastWrite["lastWriteDate"];
+        const auto majorityWriteDate = lastWrite["majorityWriteDate"];
+
+        if (lastWriteDate.type() == Date && majorityWriteDate.type() == Date) {
+            const auto lag = lastWriteDate.Date() - majorityWriteDate.Date();
+            if (lag > Seconds(maxReplicationLagSecs)) {
+                log() << "Not using shard " << shardId << " for migrations because its majority "
+                      << "commit point is lagging by " << lag;
+                return true;
+            }
+        }
+    }
 
-    std::string version;
-    Status status = bsonExtractStringField(serverStatus, kVersionField, &version);
-    if (!status.isOK()) {
-        return status;
+    const int maxCacheDirtyPercent = balancerMaxShardCacheDirtyPercent.load();
+    if (maxCacheDirtyPercent > 0) {
+        const auto cache = serverStatus["wiredTiger"]["cache"];
+        const auto dirtyBytes = cache["tracked dirty bytes in the cache"];
+        const auto maxBytes = cache["maximum bytes configured"];
+
+        if (dirtyBytes.isNumber() && maxBytes.isNumber() && maxBytes.safeNumberLong() > 0) {
+            const auto dirtyPercent = 100 * dirtyBytes.safeNumberLong() / maxBytes.safeNumberLong();
+            if (dirtyPercent >= maxCacheDirtyPercent) {
+                log() << "Not using shard " << shardId << " for migrations because " << dirtyPercent
+                      << "% of its cache is dirty";
+                return true;
+            }
+        }
     }
 
-    return version;
+    return false;
 }
 
 }  // namespace
@@ -133,15 +172,26 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
         }
 
         std::string mongoDVersion;
+        bool isUnderPressure = false;
+
+        // Since the serverStatus is only used for reporting and for postponing migrations, there is
+        // no need to fail the entire round if it cannot be retrieved, so just leave the version
+        // empty and treat the shard as not under pressure
+        auto serverStatusStatus = retrieveShardServerStatus(opCtx, shard.getName());
+        if (serverStatusStatus.isOK()) {
+            const auto& serverStatus = serverStatusStatus.getValue();
+
+            Status versionStatus =
+                bsonExtractStringField(serverStatus, kVersionField, &mongoDVersion);
+            if (!versionStatus.isOK()) {
+                log() << "Unable to obtain shard version for " << shard.getName()
+                      << causedBy(versionStatus);
+            }
 
-        auto mongoDVersionStatus = retrieveShardMongoDVersion(opCtx, shard.getName());
-        if (mongoDVersionStatus.isOK()) {
-            mongoDVersion = std::move(mongoDVersionStatus.getValue());
+            isUnderPressure = isShardUnderPressure(shard.getName(), serverStatus);
         } else {
-            // Since the mongod version is only used for reporting, there is no need to fail the
-            // entire round if it cannot be retrieved, so just leave it empty
             log() << "Unable to obtain shard version for " << shard.getName()
-                  << causedBy(mongoDVersionStatus.getStatus());
+                  << causedBy(serverStatusStatus.getStatus());
         }
 
         std::set<std::string> shardTags;
@@ -156,6 +206,7 @@ StatusWith<std::vector<ShardStatistics>> ClusterStatisticsImpl::getStats(Operati
                            shard.getDraining(),
                            std::move(shardTags),
                            std::move(mongoDVersion));
+        stats.back().isUnderPressure = isUnderPressure;
     }
 
     return stats;
@@ -323,7 +323,8 @@ void ChunkSplitter::_runAutosplit(std::shared_ptr<ChunkSplitStateDriver> chunkSp
                                                        boost::none,
                                                        boost::none,
                                                        boost::none,
-                                                       maxChunkSizeBytes));
+                                                       maxChunkSizeBytes,
+                                                       true /* allowSampling */));
 
         if (splitPoints.size() <= 1) {
             LOG(1)
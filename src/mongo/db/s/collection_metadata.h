@@ -129,6 +129,15 @@ public:
         return _cm->keyBelongsToShard(key, _thisShardId);
     }
 
+    /**
+     * Returns true if every shard key value in [min, max] (both bounds inclusive) belongs to this
+     * chunkset.
+     */
+    bool rangeBelongsToMe(const BSONObj& min, const BSONObj& max) const {
+        invariant(isSharded());
+        return _cm->rangeBelongsToShard(min, max, _thisShardId);
+    }
+
     /**
      * Given a key 'lookupKey' in the shard key range, get the next chunk which overlaps or is
      * greater than this key.  Returns true if a chunk exists, false otherwise.
@@ -313,6 +313,32 @@ protected:
     }
 };
 
+TEST_F(ThreeChunkWithRangeGapFixture, RangeBelongsToMe) {
+    auto metadata(makeCollectionMetadata());
+
+    // The same routing table, but looked up as of the latest version rather than a cluster time
+    CollectionMetadata latestMetadata(
+        std::make_shared<ChunkManager>(metadata->getChunkManager()->getRoutingHistory(),
+                                       boost::none),
+        ShardId("thisShard"));
+
+    for (const auto* md : {metadata.get(), &latestMetadata}) {
+        ASSERT(md->rangeBelongsToMe(BSON("a" << MINKEY), BSON("a" << 19)));
+        ASSERT(md->rangeBelongsToMe(BSON("a" << 5), BSON("a" << 15)));
+        ASSERT(md->rangeBelongsToMe(BSON("a" << 12), BSON("a" << 12)));
+        ASSERT(md->rangeBelongsToMe(BSON("a" << 30), BSON("a" << MAXKEY)));
+
+        ASSERT(!md->rangeBelongsToMe(BSON("a" << 15), BSON("a" << 20)));
+        ASSERT(!md->rangeBelongsToMe(BSON("a" << 20), BSON("a" << 29)));
+        ASSERT(!md->rangeBelongsToMe(BSON("a" << 25), BSON("a" << 35)));
+        ASSERT(!md->rangeBelongsToMe(BSON("a" << 0), BSON("a" << 40)));
+
+        ASSERT(md->keyBelongsToMe(BSON("a" << 19)));
+        ASSERT(!md->keyBelongsToMe(BSON("a" << 20)));
+        ASSERT(md->keyBelongsToMe(BSON("a" << 30)));
+    }
+}
+
 TEST_F(ThreeChunkWithRangeGapFixture, GetNextChunkMatch) {
     auto metadata(makeCollectionMetadata());
 
@@ -58,6 +58,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -69,6 +70,24 @@ MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 20)
         return Status::OK();
     });
 
+// Limits on the rate at which the range deleter removes documents, in order to bound the I/O it
+// adds on top of the regular workload. Zero means no limit.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxDocsPerSec, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "rangeDeleterMaxDocsPerSec must not be negative");
+        }
+        return Status::OK();
+    });
+
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterMaxBytesPerSec, long long, 0)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "rangeDeleterMaxBytesPerSec must not be negative");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 using Deletion = CollectionRangeDeleter::Deletion;
@@ -91,6 +110,27 @@ boost::optional<DeleteNotification> checkOverlap(std::list<Deletion> const& dele
     return boost::none;
 }
 
+/**
+ * Returns how long the range deleter should sleep after a batch, which took 'elapsed' to delete
+ * 'docsDeleted' documents of 'bytesDeleted' total size, in order to stay within the configured
+ * deletion rate limits.
+ */
+Milliseconds delayAfterBatch(int docsDeleted, long long bytesDeleted, Milliseconds elapsed) {
+    Milliseconds delay{rangeDeleterBatchDelayMS.load()};
+
+    const auto maxDocsPerSec = rangeDeleterMaxDocsPerSec.load();
+    if (maxDocsPerSec > 0) {
+        delay = std::max(delay, Milliseconds(docsDeleted * 1000LL / maxDocsPerSec) - elapsed);
+    }
+
+    const auto maxBytesPerSec = rangeDeleterMaxBytesPerSec.load();
+    if (maxBytesPerSec > 0) {
+        delay = std::max(delay, Milliseconds(bytesDeleted * 1000 / maxBytesPerSec) - elapsed);
+    }
+
+    return delay;
+}
+
 }  // namespace
 
 CollectionRangeDeleter::CollectionRangeDeleter() = default;
@@ -108,6 +148,8 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     CollectionRangeDeleter* forTestOnly) {
 
     StatusWith<int> wrote = 0;
+    long long bytesDeleted = 0;
+    Timer batchTimer;
 
     auto range = boost::optional<ChunkRange>(boost::none);
     auto notification = DeleteNotification();
@@ -129,6 +171,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
                    << " was reset";
             stdx::lock_guard<stdx::mutex> lk(css->_metadataManager->_managerLock);
             css->_metadataManager->_clearAllCleanups(lk);
+            ShardingStatistics::get(opCtx).noteRangeDeletionFinished(nss);
             return boost::none;
         }
 
@@ -144,6 +187,7 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
 
             stdx::lock_guard<stdx::mutex> lk(css->_metadataManager->_managerLock);
             css->_metadataManager->_clearAllCleanups(lk);
+            ShardingStatistics::get(opCtx).noteRangeDeletionFinished(nss);
             return boost::none;
         }
 
@@ -218,15 +262,21 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
             }
         }
 
+        batchTimer.reset();
         try {
             wrote = self->_doDeletion(
-                opCtx, collection, metadata->getKeyPattern(), *range, maxToDelete);
+                opCtx, collection, metadata->getKeyPattern(), *range, maxToDelete, &bytesDeleted);
         } catch (const DBException& e) {
             wrote = e.toStatus();
             warning() << e.what();
         }
     }  // drop autoColl
 
+    if (wrote.isOK() && wrote.getValue() > 0) {
+        ShardingStatistics::get(opCtx).noteRangeDeletionProgress(
+            nss, range->getMin(), range->getMax(), wrote.getValue(), bytesDeleted);
+    }
+
     if (!wrote.isOK() || wrote.getValue() == 0) {
         if (wrote.isOK()) {
             LOG(0) << "No documents remain to delete in " << nss << " range "
@@ -284,6 +334,8 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
             self->_pop(wrote.getStatus());
         }
 
+        ShardingStatistics::get(opCtx).noteRangeDeletionFinished(nss);
+
         if (!self->_orphans.empty()) {
             LOG(1) << "Deleting " << nss.ns() << " range "
                    << redact(self->_orphans.front().range.toString()) << " next.";
@@ -297,14 +349,16 @@ boost::optional<Date_t> CollectionRangeDeleter::cleanUpNextRange(
     invariant(wrote.getValue() > 0);
 
     notification.abandon();
-    return Date_t::now() + stdx::chrono::milliseconds{rangeDeleterBatchDelayMS.load()};
+    return Date_t::now() +
+        delayAfterBatch(wrote.getValue(), bytesDeleted, Milliseconds(batchTimer.millis()));
 }
 
 StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
                                                     Collection* collection,
                                                     BSONObj const& keyPattern,
                                                     ChunkRange const& range,
-                                                    int maxToDelete) {
+                                                    int maxToDelete,
+                                                    long long* bytesDeleted) {
     invariant(collection != nullptr);
     invariant(!isEmpty());
 
@@ -371,6 +425,8 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
         }
         invariant(PlanExecutor::ADVANCED == state);
 
+        const int docSize = obj.objsize();
+
         exec->saveState();
         writeConflictRetry(opCtx, "delete range", nss.ns(), [&] {
             WriteUnitOfWork wuow(opCtx);
@@ -389,6 +445,7 @@ StatusWith<int> CollectionRangeDeleter::_doDeletion(OperationContext* opCtx,
             break;
         }
         ShardingStatistics::get(opCtx).countDocsDeletedOnDonor.addAndFetch(1);
+        *bytesDeleted += docSize;
 
     } while (++numDeleted < maxToDelete);
 
@@ -179,13 +179,14 @@ private:
      * called under the collection lock.
      *
      * Returns the number of documents deleted, 0 if done with the range, or bad status if deleting
-     * the range failed.
+     * the range failed. The total size of the deleted documents is stored in 'bytesDeleted'.
      */
     StatusWith<int> _doDeletion(OperationContext* opCtx,
                                 Collection* collection,
                                 const BSONObj& keyPattern,
                                 ChunkRange const& range,
-                                int maxToDelete);
+                                int maxToDelete,
+                                long long* bytesDeleted);
 
     /**
      * Removes the latest-scheduled range from the ranges to be cleaned up, and notifies any
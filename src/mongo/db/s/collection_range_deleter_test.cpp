@@ -40,6 +40,7 @@
 #include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/s/collection_sharding_runtime.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/s/sharding_statistics.h"
 #include "mongo/s/balancer_configuration.h"
 #include "mongo/s/chunk_version.h"
 #include "mongo/s/client/shard_registry.h"
@@ -231,6 +232,42 @@ TEST_F(CollectionRangeDeleterTest, MultipleCleanupNextRangeCalls) {
     ASSERT_EQUALS(0ULL, dbclient.count(kAdminSysVer.ns(), BSON(kShardKey << "startRangeDeletion")));
 }
 
+// Tests that the progress of the range being cleaned is reported until the range is finished.
+TEST_F(CollectionRangeDeleterTest, RangeDeletionProgressIsReported) {
+    CollectionRangeDeleter rangeDeleter;
+    DBDirectClient dbclient(operationContext());
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 1));
+    dbclient.insert(kNss.toString(), BSON(kShardKey << 2));
+
+    std::list<Deletion> ranges;
+    ranges.emplace_back(
+        Deletion{ChunkRange(BSON(kShardKey << 0), BSON(kShardKey << 10)), Date_t{}});
+    rangeDeleter.add(std::move(ranges));
+
+    auto rangeDeletionsInProgress = [&] {
+        BSONObjBuilder builder;
+        ShardingStatistics::get(operationContext()).report(&builder);
+        return builder.obj()["rangeDeletionsInProgress"].Obj().getOwned();
+    };
+
+    ASSERT_TRUE(next(rangeDeleter, 1));
+    auto inProgress = rangeDeletionsInProgress();
+    ASSERT_EQ(1, inProgress.nFields());
+    auto progress = inProgress.firstElement().Obj();
+    ASSERT_EQ(kNss.ns(), progress["ns"].String());
+    ASSERT_BSONOBJ_EQ(BSON(kShardKey << 0), progress["min"].Obj());
+    ASSERT_BSONOBJ_EQ(BSON(kShardKey << 10), progress["max"].Obj());
+    ASSERT_EQ(1, progress["docsDeleted"].numberLong());
+    ASSERT_EQ(BSON(kShardKey << 1).objsize(), progress["bytesDeleted"].numberLong());
+
+    ASSERT_TRUE(next(rangeDeleter, 1));
+    ASSERT_EQ(2, rangeDeletionsInProgress().firstElement().Obj()["docsDeleted"].numberLong());
+
+    ASSERT_TRUE(next(rangeDeleter, 1));
+    ASSERT_TRUE(rangeDeletionsInProgress().isEmpty());
+    ASSERT_FALSE(next(rangeDeleter, 1));
+}
+
 // Tests the case that there are two ranges to clean, each containing multiple documents.
 TEST_F(CollectionRangeDeleterTest, MultipleDocumentsInMultipleRangesToClean) {
     CollectionRangeDeleter rangeDeleter;
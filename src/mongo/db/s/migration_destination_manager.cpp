@@ -54,6 +54,7 @@
 #include "mongo/db/s/move_timing_helper.h"
 #include "mongo/db/s/sharding_statistics.h"
 #include "mongo/db/s/start_chunk_clone_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/client/shard_registry.h"
@@ -66,10 +67,32 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/producer_consumer_queue.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
 
+// Number of _migrateClone batches the recipient keeps in flight to the donor during the initial
+// clone, which hides the round-trip latency between the two shards
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneConcurrentFetches, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "migrateCloneConcurrentFetches must be greater than or equal to 1");
+        }
+        return Status::OK();
+    });
+
+// Number of threads, which insert the documents received during the initial clone
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneInsertionThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "migrateCloneInsertionThreads must be greater than or equal to 1");
+        }
+        return Status::OK();
+    });
+
 const auto getMigrationDestinationManager =
     ServiceContext::declareDecoration<MigrationDestinationManager>();
 
@@ -377,48 +400,136 @@ Status MigrationDestinationManager::start(OperationContext* opCtx,
 void MigrationDestinationManager::cloneDocumentsFromDonor(
     OperationContext* opCtx,
     stdx::function<void(OperationContext*, BSONObj)> insertBatchFn,
-    stdx::function<BSONObj(OperationContext*)> fetchBatchFn) {
+    stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+    int numFetchers,
+    int numInserters) {
+    invariant(numFetchers >= 1);
+    invariant(numInserters >= 1);
 
-    ProducerConsumerQueue<BSONObj> batches(1);
-    stdx::thread inserterThread{[&] {
-        Client::initThreadIfNotAlready("chunkInserter");
-        auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
-        auto consumerGuard = MakeGuard([&] { batches.closeConsumerEnd(); });
-        try {
-            while (true) {
-                auto nextBatch = batches.pop(inserterOpCtx.get());
-                auto arr = nextBatch["objects"].Obj();
-                if (arr.isEmpty()) {
-                    return;
+    ProducerConsumerQueue<BSONObj> batches(numInserters);
+
+    // The queue allows only a single producer at a time, so fetchers take turns pushing to it
+    stdx::mutex pushMutex;
+
+    std::vector<stdx::thread> inserterThreads;
+    auto inserterThreadsJoinGuard = MakeGuard([&] {
+        batches.closeProducerEnd();
+        for (auto& inserterThread : inserterThreads) {
+            inserterThread.join();
+        }
+    });
+
+    for (int i = 0; i < numInserters; ++i) {
+        inserterThreads.emplace_back([&] {
+            Client::initThreadIfNotAlready("chunkInserter");
+            auto inserterOpCtx = Client::getCurrent()->makeOperationContext();
+            try {
+                while (true) {
+                    auto nextBatch = batches.pop(inserterOpCtx.get());
+                    insertBatchFn(inserterOpCtx.get(), nextBatch["objects"].Obj());
+                }
+            } catch (const ExceptionFor<ErrorCodes::ProducerConsumerQueueEndClosed>&) {
+                // Either every batch has been inserted, or another inserter failed and has already
+                // interrupted the cloning
+            } catch (...) {
+                {
+                    stdx::lock_guard<Client> lk(*opCtx->getClient());
+                    opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
                 }
-                insertBatchFn(inserterOpCtx.get(), arr);
+                log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
+                batches.closeConsumerEnd();
             }
-        } catch (...) {
-            stdx::lock_guard<Client> lk(*opCtx->getClient());
-            opCtx->getServiceContext()->killOperation(opCtx, exceptionToStatus().code());
-            log() << "Batch insertion failed " << causedBy(redact(exceptionToStatus()));
+        });
+    }
+
+    // Set once the donor has returned an empty batch, which indicates that there is no more initial
+    // clone data, or once any of the fetchers has failed
+    AtomicWord<bool> doneFetching{false};
+
+    auto fetchBatches = [&](OperationContext* fetcherOpCtx) {
+        while (!doneFetching.load()) {
+            fetcherOpCtx->checkForInterrupt();
+
+            auto res = fetchBatchFn(fetcherOpCtx);
+
+            fetcherOpCtx->checkForInterrupt();
+            if (res["objects"].Obj().isEmpty()) {
+                doneFetching.store(true);
+                return;
+            }
+
+            stdx::lock_guard<stdx::mutex> lk(pushMutex);
+            batches.push(res.getOwned(), fetcherOpCtx);
+        }
+    };
+
+    // The calling thread is one of the fetchers, the rest run on their own threads and operation
+    // contexts, which are registered so that they can be interrupted if the cloning fails
+    stdx::mutex fetchersMutex;
+    std::vector<OperationContext*> fetcherOpCtxs;
+    bool fetchersStopped = false;
+    Status fetchersStatus = Status::OK();
+
+    std::vector<stdx::thread> fetcherThreads;
+    auto fetcherThreadsJoinGuard = MakeGuard([&] {
+        doneFetching.store(true);
+        {
+            stdx::lock_guard<stdx::mutex> lk(fetchersMutex);
+            fetchersStopped = true;
+            for (auto fetcherOpCtx : fetcherOpCtxs) {
+                stdx::lock_guard<Client> clientLock(*fetcherOpCtx->getClient());
+                fetcherOpCtx->getServiceContext()->killOperation(fetcherOpCtx);
+            }
+        }
+        for (auto& fetcherThread : fetcherThreads) {
+            fetcherThread.join();
         }
-    }};
-    auto inserterThreadJoinGuard = MakeGuard([&] {
-        batches.closeProducerEnd();
-        inserterThread.join();
     });
 
-    while (true) {
-        opCtx->checkForInterrupt();
+    for (int i = 1; i < numFetchers; ++i) {
+        fetcherThreads.emplace_back([&] {
+            Client::initThreadIfNotAlready("chunkFetcher");
+            auto fetcherOpCtx = Client::getCurrent()->makeOperationContext();
+            {
+                stdx::lock_guard<stdx::mutex> lk(fetchersMutex);
+                if (fetchersStopped) {
+                    return;
+                }
+                fetcherOpCtxs.push_back(fetcherOpCtx.get());
+            }
+            ON_BLOCK_EXIT([&] {
+                stdx::lock_guard<stdx::mutex> lk(fetchersMutex);
+                fetcherOpCtxs.erase(
+                    std::find(fetcherOpCtxs.begin(), fetcherOpCtxs.end(), fetcherOpCtx.get()));
+            });
 
-        auto res = fetchBatchFn(opCtx);
+            try {
+                fetchBatches(fetcherOpCtx.get());
+            } catch (...) {
+                doneFetching.store(true);
+                stdx::lock_guard<stdx::mutex> lk(fetchersMutex);
+                if (fetchersStatus.isOK()) {
+                    fetchersStatus = exceptionToStatus();
+                }
+            }
+        });
+    }
 
-        opCtx->checkForInterrupt();
-        batches.push(res.getOwned(), opCtx);
-        auto arr = res["objects"].Obj();
-        if (arr.isEmpty()) {
-            inserterThreadJoinGuard.Dismiss();
-            inserterThread.join();
-            opCtx->checkForInterrupt();
-            break;
-        }
+    fetchBatches(opCtx);
+
+    // The other fetchers stop once their outstanding requests complete
+    fetcherThreadsJoinGuard.Dismiss();
+    for (auto& fetcherThread : fetcherThreads) {
+        fetcherThread.join();
+    }
+    uassertStatusOK(fetchersStatus);
+
+    inserterThreadsJoinGuard.Dismiss();
+    batches.closeProducerEnd();
+    for (auto& inserterThread : inserterThreads) {
+        inserterThread.join();
     }
+    opCtx->checkForInterrupt();
 }
 
 Status MigrationDestinationManager::abort(const MigrationSessionId& sessionId) {
@@ -831,9 +942,15 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* opCtx) {
             return res.response;
         };
 
-        cloneDocumentsFromDonor(opCtx, insertBatchFn, fetchBatchFn);
+        Timer cloneTimer;
+        cloneDocumentsFromDonor(opCtx,
+                                insertBatchFn,
+                                fetchBatchFn,
+                                migrateCloneConcurrentFetches.load(),
+                                migrateCloneInsertionThreads.load());
 
         timing.done(3);
+        timing.appendCloneStats(_numCloned, _clonedBytes, Milliseconds(cloneTimer.millis()));
         MONGO_FAIL_POINT_PAUSE_WHILE_SET(migrateThreadHangAtStep3);
 
         if (MONGO_FAIL_POINT(failMigrationLeaveOrphans)) {
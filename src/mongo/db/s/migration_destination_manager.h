@@ -108,12 +108,15 @@ public:
                  const WriteConcernOptions& writeConcern);
 
     /**
-     * Clones documents from a donor shard.
+     * Clones documents from a donor shard. Up to 'numFetchers' batches are requested from the donor
+     * concurrently and are inserted by 'numInserters' threads, in no particular order.
      */
     static void cloneDocumentsFromDonor(
         OperationContext* opCtx,
         stdx::function<void(OperationContext*, BSONObj)> insertBatchFn,
-        stdx::function<BSONObj(OperationContext*)> fetchBatchFn);
+        stdx::function<BSONObj(OperationContext*)> fetchBatchFn,
+        int numFetchers = 1,
+        int numInserters = 1);
 
     /**
      * Idempotent method, which causes the current ongoing migration to abort only if it has the
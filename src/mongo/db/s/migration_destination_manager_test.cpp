@@ -104,6 +104,45 @@ TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWorksCorrectly) {
     }
 }
 
+// Tests that every fetched batch is inserted exactly once when several batches are fetched and
+// inserted concurrently.
+TEST_F(MigrationDestinationManagerTest, CloneDocumentsFromDonorWithConcurrentFetchesAndInserts) {
+    const int kNumBatches = 20;
+
+    stdx::mutex mutex;
+    int numBatchesFetched = 0;
+
+    auto fetchBatchFn = [&](OperationContext* opCtx) {
+        BSONObjBuilder fetchBatchResultBuilder;
+
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        if (numBatchesFetched == kNumBatches) {
+            fetchBatchResultBuilder.append("objects", BSONObj());
+        } else {
+            BSONArrayBuilder arrayBuilder(fetchBatchResultBuilder.subarrayStart("objects"));
+            arrayBuilder.append(createDocument(numBatchesFetched++));
+        }
+
+        return fetchBatchResultBuilder.obj();
+    };
+
+    std::set<int> insertedIds;
+
+    auto insertBatchFn = [&](OperationContext* opCtx, BSONObj docs) {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        for (auto&& docToClone : docs) {
+            ASSERT(insertedIds.insert(docToClone.Obj()["_id"].numberInt()).second);
+        }
+    };
+
+    MigrationDestinationManager::cloneDocumentsFromDonor(
+        operationContext(), insertBatchFn, fetchBatchFn, 4, 3);
+
+    ASSERT_EQ(size_t(kNumBatches), insertedIds.size());
+    ASSERT_EQ(0, *insertedIds.begin());
+    ASSERT_EQ(kNumBatches - 1, *insertedIds.rbegin());
+}
+
 // Tests that an exception in the fetch logic will successfully throw an exception on the main
 // thread.
 TEST_F(MigrationDestinationManagerTest, CloneDocumentsThrowsFetchErrors) {
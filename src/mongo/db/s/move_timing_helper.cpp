@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/move_timing_helper.h"
 
+#include <algorithm>
+
 #include "mongo/db/client.h"
 #include "mongo/db/curop.h"
 #include "mongo/s/grid.h"
@@ -113,4 +115,13 @@ void MoveTimingHelper::done(int step) {
     _t.reset();
 }
 
+void MoveTimingHelper::appendCloneStats(long long numDocs,
+                                        long long numBytes,
+                                        Milliseconds elapsed) {
+    _b.appendNumber("clonedDocs", numDocs);
+    _b.appendNumber("clonedBytes", numBytes);
+    _b.appendNumber("cloneBytesPerSec",
+                    numBytes * 1000 / std::max(elapsed.count(), Milliseconds::rep(1)));
+}
+
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/s/shard_id.h"
+#include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -54,6 +55,12 @@ public:
 
     void done(int step);
 
+    /**
+     * Records how much data was copied during the initial clone and the resulting throughput, so
+     * that they are reported in the changelog entry.
+     */
+    void appendCloneStats(long long numDocs, long long numBytes, Milliseconds elapsed);
+
 private:
     // Measures how long the receiving of a chunk takes
     Timer _t;
@@ -34,6 +34,7 @@
 
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/ops/write_ops.h"
+#include "mongo/db/range_arithmetic.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/unique_message.h"
@@ -363,38 +364,73 @@ Status updateShardChunks(OperationContext* opCtx,
          * {_id: 14, max: 19, version 7.1}
          * {_id: 19, max: 22, version 2.0}
          *
+         * The deletes and inserts are issued in bulk, for as many chunks at a time as do not
+         * overlap each other. A chunk which overlaps one already in the batch, which can happen if
+         * the config server returned a range both before and after it changed, starts a new batch,
+         * so that later versions still replace earlier ones.
          */
-        for (auto& chunk : chunks) {
-            invariant(chunk.getVersion().epoch() == currEpoch);
+        std::vector<write_ops::DeleteOpEntry> deletes;
+        std::vector<BSONObj> inserts;
+        RangeMap batchRanges = SimpleBSONObjComparator::kInstance.makeBSONObjIndexedMap<BSONObj>();
+        int batchBytes = 0;
+
+        const auto flushBatch = [&] {
+            if (inserts.empty()) {
+                return;
+            }
 
-            // Delete any overlapping chunk ranges. Overlapping chunks will have a min value
-            // ("_id") between (chunk.min, chunk.max].
-            //
-            // query: { "_id" : {"$gte": chunk.min, "$lt": chunk.max}}
             auto deleteCommandResponse = client.runCommand([&] {
                 write_ops::Delete deleteOp(chunkMetadataNss);
-                deleteOp.setDeletes({[&] {
-                    write_ops::DeleteOpEntry entry;
-                    entry.setQ(BSON(ChunkType::minShardID
-                                    << BSON("$gte" << chunk.getMin() << "$lt" << chunk.getMax())));
-                    entry.setMulti(true);
-                    return entry;
-                }()});
+                deleteOp.setDeletes(std::move(deletes));
                 return deleteOp.serialize({});
             }());
             uassertStatusOK(
                 getStatusFromWriteCommandResponse(deleteCommandResponse->getCommandReply()));
 
-            // Now the document can be expected to cleanly insert without overlap
+            // Now the documents can be expected to cleanly insert without overlap
             auto insertCommandResponse = client.runCommand([&] {
                 write_ops::Insert insertOp(chunkMetadataNss);
-                insertOp.setDocuments({chunk.toShardBSON()});
+                insertOp.setDocuments(std::move(inserts));
                 return insertOp.serialize({});
             }());
             uassertStatusOK(
                 getStatusFromWriteCommandResponse(insertCommandResponse->getCommandReply()));
+
+            deletes.clear();
+            inserts.clear();
+            batchRanges.clear();
+            batchBytes = 0;
+        };
+
+        for (auto& chunk : chunks) {
+            invariant(chunk.getVersion().epoch() == currEpoch);
+
+            auto chunkObj = chunk.toShardBSON();
+
+            // Leave room for the delete entries, which are about as large as the chunk documents.
+            if (inserts.size() >= write_ops::kMaxWriteBatchSize ||
+                batchBytes + chunkObj.objsize() > BSONObjMaxUserSize / 2 ||
+                rangeMapOverlaps(batchRanges, chunk.getMin(), chunk.getMax())) {
+                flushBatch();
+            }
+
+            // Delete any overlapping chunk ranges. Overlapping chunks will have a min value
+            // ("_id") between (chunk.min, chunk.max].
+            //
+            // query: { "_id" : {"$gte": chunk.min, "$lt": chunk.max}}
+            write_ops::DeleteOpEntry entry;
+            entry.setQ(BSON(ChunkType::minShardID
+                            << BSON("$gte" << chunk.getMin() << "$lt" << chunk.getMax())));
+            entry.setMulti(true);
+            deletes.push_back(std::move(entry));
+
+            batchRanges.emplace(chunk.getMin(), chunk.getMax());
+            batchBytes += chunkObj.objsize();
+            inserts.push_back(std::move(chunkObj));
         }
 
+        flushBatch();
+
         return Status::OK();
     } catch (const DBException& ex) {
         return ex.toStatus();
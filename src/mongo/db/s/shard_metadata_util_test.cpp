@@ -318,6 +318,27 @@ TEST_F(ShardMetadataUtilTest, UpdateWithWriteNewChunks) {
     checkChunks(kChunkMetadataNss, chunks);
 }
 
+TEST_F(ShardMetadataUtilTest, UpdateWithOverlappingChunksKeepsLaterVersions) {
+    std::vector<ChunkType> chunks = makeFourChunks();
+    ASSERT_OK(updateShardChunks(operationContext(), kNss, chunks, maxCollVersion.epoch()));
+
+    // The same range before and after a split, as a diff read from a changing config.chunks can
+    // return it. Both are written in the same call.
+    ChunkType unsplitChunk = chunks[1];
+    maxCollVersion.incMinor();
+    unsplitChunk.setVersion(maxCollVersion);
+
+    maxCollVersion.incMinor();
+    ChunkType splitChunk(kNss, {chunks[1].getMin(), BSON("a" << 30)}, maxCollVersion, kShardId);
+
+    ASSERT_OK(updateShardChunks(
+        operationContext(), kNss, {unsplitChunk, splitChunk}, maxCollVersion.epoch()));
+
+    DBDirectClient client(operationContext());
+    ASSERT_EQUALS(4ULL, client.count(kChunkMetadataNss.ns()));
+    checkChunks(kChunkMetadataNss, {chunks[0], splitChunk, chunks[2], chunks[3]});
+}
+
 TEST_F(ShardMetadataUtilTest, DropChunksAndDeleteCollectionsEntry) {
     setUpShardChunkMetadata();
     ASSERT_OK(dropChunksAndDeleteCollectionsEntry(operationContext(), kNss));
@@ -581,7 +581,22 @@ void ShardServerCatalogCacheLoader::_runSecondaryGetChunksSince(
     const ChunkVersion& catalogCacheSinceVersion,
     stdx::function<void(OperationContext*, StatusWith<CollectionAndChangedChunks>)> callbackFn,
     std::shared_ptr<Notification<void>> notify) {
-    forcePrimaryCollectionRefreshAndWaitForReplication(opCtx, nss);
+    // If a refresh by the primary has replicated since this node last loaded the collection, serve
+    // the refresh from the persisted metadata rather than asking the primary to refresh again. If
+    // that is still not recent enough, the next refresh finds the persisted and cached versions
+    // equal and goes to the primary as usual.
+    const auto swRefreshState = getPersistedRefreshFlags(opCtx, nss);
+    const bool persistedMetadataIsNewer = [&] {
+        if (!swRefreshState.isOK() || swRefreshState.getValue().refreshing) {
+            return false;
+        }
+        return catalogCacheSinceVersion.isOlderThan(
+            swRefreshState.getValue().lastRefreshedCollectionVersion);
+    }();
+
+    if (!persistedMetadataIsNewer) {
+        forcePrimaryCollectionRefreshAndWaitForReplication(opCtx, nss);
+    }
 
     // Read the local metadata.
     auto swCollAndChunks =
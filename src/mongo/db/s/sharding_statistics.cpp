@@ -31,6 +31,8 @@
 #include "mongo/db/s/sharding_statistics.h"
 
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/bson/simple_bsonobj_comparator.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 
@@ -49,6 +51,31 @@ ShardingStatistics& ShardingStatistics::get(OperationContext* opCtx) {
     return get(opCtx->getServiceContext());
 }
 
+void ShardingStatistics::noteRangeDeletionProgress(const NamespaceString& nss,
+                                                   const BSONObj& min,
+                                                   const BSONObj& max,
+                                                   long long docsDeleted,
+                                                   long long bytesDeleted) {
+    stdx::lock_guard<stdx::mutex> lk(_rangeDeletionsMutex);
+
+    auto& progress = _rangeDeletions[nss.ns()];
+    if (!SimpleBSONObjComparator::kInstance.evaluate(progress.min == min) ||
+        !SimpleBSONObjComparator::kInstance.evaluate(progress.max == max)) {
+        progress = RangeDeletionProgress();
+        progress.min = min.getOwned();
+        progress.max = max.getOwned();
+        progress.startedAt = Date_t::now();
+    }
+
+    progress.docsDeleted += docsDeleted;
+    progress.bytesDeleted += bytesDeleted;
+}
+
+void ShardingStatistics::noteRangeDeletionFinished(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_rangeDeletionsMutex);
+    _rangeDeletions.erase(nss.ns());
+}
+
 void ShardingStatistics::report(BSONObjBuilder* builder) const {
     builder->append("countStaleConfigErrors", countStaleConfigErrors.load());
 
@@ -61,6 +88,20 @@ void ShardingStatistics::report(BSONObjBuilder* builder) const {
     builder->append("countDocsClonedOnDonor", countDocsClonedOnDonor.load());
     builder->append("countRecipientMoveChunkStarted", countRecipientMoveChunkStarted.load());
     builder->append("countDocsDeletedOnDonor", countDocsDeletedOnDonor.load());
+
+    stdx::lock_guard<stdx::mutex> lk(_rangeDeletionsMutex);
+    BSONArrayBuilder rangeDeletionsBuilder(builder->subarrayStart("rangeDeletionsInProgress"));
+    for (const auto& entry : _rangeDeletions) {
+        const auto& progress = entry.second;
+
+        BSONObjBuilder rangeBuilder(rangeDeletionsBuilder.subobjStart());
+        rangeBuilder.append("ns", entry.first);
+        rangeBuilder.append("min", progress.min);
+        rangeBuilder.append("max", progress.max);
+        rangeBuilder.append("startedAt", progress.startedAt);
+        rangeBuilder.append("docsDeleted", progress.docsDeleted);
+        rangeBuilder.append("bytesDeleted", progress.bytesDeleted);
+    }
 }
 
 }  // namespace mongo
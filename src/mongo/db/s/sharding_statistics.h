@@ -28,11 +28,18 @@
 
 #pragma once
 
+#include <map>
+#include <string>
+
+#include "mongo/bson/bsonobj.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
 class BSONObjBuilder;
+class NamespaceString;
 class OperationContext;
 class ServiceContext;
 
@@ -92,10 +99,41 @@ struct ShardingStatistics {
     static ShardingStatistics& get(ServiceContext* serviceContext);
     static ShardingStatistics& get(OperationContext* opCtx);
 
+    /**
+     * Records that the range deleter removed another 'docsDeleted' documents of 'bytesDeleted'
+     * total size from the range [min, max) of 'nss'. Starts tracking a new range if the collection
+     * was not being cleaned up or was being cleaned up in a different range.
+     */
+    void noteRangeDeletionProgress(const NamespaceString& nss,
+                                   const BSONObj& min,
+                                   const BSONObj& max,
+                                   long long docsDeleted,
+                                   long long bytesDeleted);
+
+    /**
+     * Stops reporting the progress of the range, which was being cleaned up for 'nss'.
+     */
+    void noteRangeDeletionFinished(const NamespaceString& nss);
+
     /**
      * Reports the accumulated statistics for serverStatus.
      */
     void report(BSONObjBuilder* builder) const;
+
+private:
+    struct RangeDeletionProgress {
+        BSONObj min;
+        BSONObj max;
+        Date_t startedAt;
+        long long docsDeleted{0};
+        long long bytesDeleted{0};
+    };
+
+    // Protects '_rangeDeletions'
+    mutable stdx::mutex _rangeDeletionsMutex;
+
+    // The range currently being cleaned up for each collection, keyed by namespace
+    std::map<std::string, RangeDeletionProgress> _rangeDeletions;
 };
 
 }  // namespace mongo
@@ -43,6 +43,8 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -50,12 +52,132 @@ namespace {
 
 const int kMaxObjectPerChunk{250000};
 
+// Number of the chunk's documents, which are sampled when estimating split points. With the
+// default, a split in half is expected to be within 10% of the middle of the chunk, three standard
+// errors out of four. Zero disables sampling.
+MONGO_EXPORT_SERVER_PARAMETER(splitVectorSampleSize, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "splitVectorSampleSize must not be negative");
+        }
+        return Status::OK();
+    });
+
+// Sampling gives up and falls back to scanning the index if fewer than one in this many random
+// documents of the collection fall in the chunk, because then the sample costs more random reads
+// than the scan costs sequential ones
+const int kMaxSampleAttemptsPerSample = 10;
+
+// Chunks are only sampled if they are expected to hold at least this many documents per sampled
+// one. Smaller chunks are cheap enough to scan, and a sample of a large part of them would cost
+// about as much as the scan while only estimating its result.
+const int kMinChunkDocsPerSampledDoc = 10;
+
 BSONObj prettyKey(const BSONObj& keyPattern, const BSONObj& key) {
     return key.replaceFieldNames(keyPattern).clientReadable();
 }
 
+/**
+ * Collects the shard keys of a random sample of the documents in the chunk [min, max), in order to
+ * estimate its split points. Returns boost::none if the storage engine does not support random
+ * cursors, or if the chunk holds too small a portion of the collection to sample efficiently.
+ */
+boost::optional<std::vector<BSONObj>> sampleSplitPoints(OperationContext* opCtx,
+                                                        Collection* collection,
+                                                        const BSONObj& keyPattern,
+                                                        const BSONObj& min,
+                                                        const BSONObj& max,
+                                                        long long recCount,
+                                                        long long keyCount,
+                                                        boost::optional<long long> maxSplitPoints) {
+    const int sampleSize = splitVectorSampleSize.load();
+    if (sampleSize <= 0) {
+        return boost::none;
+    }
+
+    // A chunk is split once it holds about two chunks' worth of 'keyCount' documents
+    if (2 * keyCount < static_cast<long long>(sampleSize) * kMinChunkDocsPerSampledDoc) {
+        return boost::none;
+    }
+
+    auto cursor = collection->getRecordStore()->getRandomCursor(opCtx);
+    if (!cursor) {
+        return boost::none;
+    }
+
+    const ShardKeyPattern shardKeyPattern(keyPattern);
+    const auto& comparator = SimpleBSONObjComparator::kInstance;
+
+    std::vector<BSONObj> sample;
+    long long attempts = 0;
+
+    while (sample.size() < size_t(sampleSize) &&
+           attempts < sampleSize * kMaxSampleAttemptsPerSample) {
+        auto record = cursor->next();
+        if (!record) {
+            break;
+        }
+        ++attempts;
+
+        auto shardKey = shardKeyPattern.extractShardKeyFromDoc(record->data.releaseToBson());
+        if (shardKey.isEmpty() || comparator.evaluate(shardKey < min) ||
+            (!max.isEmpty() && !comparator.evaluate(shardKey < max))) {
+            continue;
+        }
+
+        sample.push_back(shardKey.getOwned());
+    }
+
+    if (sample.size() < size_t(sampleSize)) {
+        LOG(1) << "Not enough documents in the chunk " << redact(min) << " -->> " << redact(max)
+               << " to sample its split points; found " << sample.size() << " in " << attempts
+               << " attempts";
+        return boost::none;
+    }
+
+    std::sort(sample.begin(), sample.end(), comparator.makeLessThan());
+
+    const long long estimatedNumDocs = recCount * static_cast<long long>(sample.size()) / attempts;
+
+    return estimateSplitPointsFromSample(sample, estimatedNumDocs, keyCount, maxSplitPoints);
+}
+
 }  // namespace
 
+std::vector<BSONObj> estimateSplitPointsFromSample(const std::vector<BSONObj>& sortedSample,
+                                                   long long estimatedNumDocs,
+                                                   long long keyCount,
+                                                   boost::optional<long long> maxSplitPoints) {
+    std::vector<BSONObj> splitKeys;
+    if (sortedSample.empty() || estimatedNumDocs <= 0) {
+        return splitKeys;
+    }
+
+    const auto& comparator = SimpleBSONObjComparator::kInstance;
+
+    // The index scan starts a new chunk after every 'keyCount + 1' keys
+    const long long numSplitPoints = (estimatedNumDocs - 1) / (keyCount + 1);
+
+    for (long long i = 1; i <= numSplitPoints; i++) {
+        const auto rank = static_cast<double>(i) * (keyCount + 1) / estimatedNumDocs;
+        const auto& key = sortedSample[std::min(size_t(rank * sortedSample.size()),
+                                                sortedSample.size() - 1)];
+
+        if (comparator.evaluate(key == sortedSample.front()) ||
+            (!splitKeys.empty() && comparator.evaluate(key == splitKeys.back()))) {
+            continue;
+        }
+
+        splitKeys.push_back(key);
+
+        if (maxSplitPoints && *maxSplitPoints && splitKeys.size() >= size_t(*maxSplitPoints)) {
+            break;
+        }
+    }
+
+    return splitKeys;
+}
+
 StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              const NamespaceString& nss,
                                              const BSONObj& keyPattern,
@@ -65,7 +187,8 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              boost::optional<long long> maxSplitPoints,
                                              boost::optional<long long> maxChunkObjects,
                                              boost::optional<long long> maxChunkSize,
-                                             boost::optional<long long> maxChunkSizeBytes) {
+                                             boost::optional<long long> maxChunkSizeBytes,
+                                             bool allowSampling) {
     std::vector<BSONObj> splitKeys;
 
     // Always have a default value for maxChunkObjects
@@ -150,6 +273,18 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
             keyCount = maxChunkObjects.get();
         }
 
+        if (allowSampling && !force) {
+            Timer timer;
+            auto sampledSplitKeys = sampleSplitPoints(
+                opCtx, collection, keyPattern, min, max, recCount, keyCount, maxSplitPoints);
+            if (sampledSplitKeys) {
+                LOG(1) << "Estimated " << sampledSplitKeys->size() << " split points for "
+                       << nss.toString() << " " << redact(minKey) << " -->> " << redact(maxKey)
+                       << " from a sample in " << timer.millis() << "ms";
+                return std::move(*sampledSplitKeys);
+            }
+        }
+
         //
         // Traverse the index and add the keyCount-th key to the result vector. If that key
         // appeared in the vector before, we omit it. The invariant here is that all the
@@ -54,6 +54,11 @@ class StatusWith;
  * be specified.
  * If force is set, split at the halfway point of the chunk. This also effectively
  * makes maxChunkSize equal the size of the chunk.
+ * If allowSampling is set and the storage engine supports random cursors, the split points may be
+ * estimated from a random sample of the chunk's documents instead of scanning the shard key index
+ * (see estimateSplitPointsFromSample). This is only done if the chunk is expected to hold many
+ * times more documents than the sample and a large enough portion of the collection for the sample
+ * to be collected quickly, otherwise the index is scanned.
  */
 StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              const NamespaceString& nss,
@@ -64,6 +69,22 @@ StatusWith<std::vector<BSONObj>> splitVector(OperationContext* opCtx,
                                              boost::optional<long long> maxSplitPoints,
                                              boost::optional<long long> maxChunkObjects,
                                              boost::optional<long long> maxChunkSize,
-                                             boost::optional<long long> maxChunkSizeBytes);
+                                             boost::optional<long long> maxChunkSizeBytes,
+                                             bool allowSampling = false);
+
+/**
+ * Given the sorted shard keys of a uniform random sample of a chunk's documents and the estimated
+ * number of documents in the chunk, returns the split points, which would divide the chunk into
+ * pieces of 'keyCount' documents each, with the remainder in the last one, as the index scan of
+ * splitVector does. Split points equal to the chunk's first sampled key or to the previous split
+ * point are skipped and at most 'maxSplitPoints' are returned, if specified.
+ *
+ * The number of documents estimated to fall between two split points, which are a fraction f of
+ * the chunk apart, has a relative standard error of about sqrt((1 - f) / (f * sampleSize)).
+ */
+std::vector<BSONObj> estimateSplitPointsFromSample(const std::vector<BSONObj>& sortedSample,
+                                                   long long estimatedNumDocs,
+                                                   long long keyCount,
+                                                   boost::optional<long long> maxSplitPoints);
 
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/s/split_vector.h"
+#include "mongo/platform/random.h"
 #include "mongo/s/shard_server_test_fixture.h"
 #include "mongo/unittest/unittest.h"
 
@@ -300,5 +301,91 @@ TEST_F(SplitVectorTest, NoMaxChunkSize) {
     ASSERT_EQUALS(status.code(), ErrorCodes::InvalidOptions);
 }
 
+TEST_F(SplitVectorTest, SamplingFallsBackToIndexScanWithoutRandomCursors) {
+    std::vector<BSONObj> splitKeys = unittest::assertGet(splitVector(operationContext(),
+                                                                     kNss,
+                                                                     BSON(kPattern << 1),
+                                                                     BSON(kPattern << 0),
+                                                                     BSON(kPattern << 100),
+                                                                     false,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     boost::none,
+                                                                     getDocSizeBytes() * 100LL,
+                                                                     true));
+    ASSERT_EQ(1U, splitKeys.size());
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 50), splitKeys.front());
+}
+
+std::vector<BSONObj> makeSortedSample(int numKeys, int step) {
+    std::vector<BSONObj> sample;
+    for (int i = 0; i < numKeys; i++) {
+        sample.push_back(BSON(kPattern << i * step));
+    }
+    return sample;
+}
+
+TEST(EstimateSplitPointsFromSample, SplitsAtSampleQuantiles) {
+    // A sample of every tenth key of a chunk with 1000 documents, to be split into chunks of 250
+    const auto splitKeys =
+        estimateSplitPointsFromSample(makeSortedSample(100, 10), 1000, 249, boost::none);
+    ASSERT_EQ(3U, splitKeys.size());
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 250), splitKeys[0]);
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 500), splitKeys[1]);
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 750), splitKeys[2]);
+}
+
+TEST(EstimateSplitPointsFromSample, NoSplitPointsForSmallChunk) {
+    ASSERT(estimateSplitPointsFromSample(makeSortedSample(100, 1), 100, 100, boost::none).empty());
+}
+
+TEST(EstimateSplitPointsFromSample, MaxSplitPointsObeyed) {
+    const auto splitKeys = estimateSplitPointsFromSample(makeSortedSample(100, 10), 1000, 249, 2LL);
+    ASSERT_EQ(2U, splitKeys.size());
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 250), splitKeys[0]);
+    ASSERT_BSONOBJ_EQ(BSON(kPattern << 500), splitKeys[1]);
+}
+
+TEST(EstimateSplitPointsFromSample, RepeatedKeysAreSkipped) {
+    // Most of the chunk has the same key, so the split at its middle is skipped
+    std::vector<BSONObj> sample(90, BSON(kPattern << 0));
+    for (int i = 1; i <= 10; i++) {
+        sample.push_back(BSON(kPattern << i));
+    }
+
+    const auto splitKeys = estimateSplitPointsFromSample(sample, 1000, 499, boost::none);
+    ASSERT(splitKeys.empty());
+}
+
+TEST(EstimateSplitPointsFromSample, EstimateIsWithinItsStandardError) {
+    // Split a chunk of 100000 documents with keys 0..99999 into quarters from a uniform random
+    // sample of 1000 of them. Each split point's rank has a standard error of
+    // sqrt(f * (1 - f) / 1000) * 100000, at most about 1600 documents, so allow four of them.
+    const int kNumDocs = 100 * 1000;
+    const int kSampleSize = 1000;
+    const int kMaxError = 4 * 1600;
+
+    PseudoRandom random(12345);
+    std::vector<int> keys;
+    for (int i = 0; i < kSampleSize; i++) {
+        keys.push_back(random.nextInt32(kNumDocs));
+    }
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<BSONObj> sample;
+    for (int key : keys) {
+        sample.push_back(BSON(kPattern << key));
+    }
+
+    const auto splitKeys =
+        estimateSplitPointsFromSample(sample, kNumDocs, kNumDocs / 4 - 1, boost::none);
+    ASSERT_EQ(3U, splitKeys.size());
+    for (size_t i = 0; i < splitKeys.size(); i++) {
+        const int expected = (i + 1) * kNumDocs / 4;
+        const int actual = splitKeys[i][kPattern].numberInt();
+        ASSERT_LTE(std::abs(actual - expected), kMaxError) << "split point " << i;
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/transaction_coordinator_service.h"
 #include "mongo/db/transaction_participant.h"
+#include "mongo/s/client/shard_registry.h"
 
 namespace mongo {
 namespace {
@@ -254,15 +255,14 @@ public:
                 participantList.insert(shardId);
             }
 
-            TransactionCoordinatorService::get(opCtx)->coordinateCommit(
-                opCtx,
-                opCtx->getLogicalSessionId().get(),
-                opCtx->getTxnNumber().get(),
-                participantList);
+            const auto localShardId = serverGlobalParams.clusterRole == ClusterRole::ConfigServer
+                ? ShardRegistry::kConfigServerShardId
+                : ShardingState::get(opCtx)->shardId();
 
             // Execute the 'prepare' logic on the local participant (the router does not send a
-            // separate 'prepare' message to the coordinator shard.
-            {
+            // separate 'prepare' message to the coordinator shard). The coordinator runs it while
+            // its prepare requests to the other participants are in flight.
+            auto prepareLocalParticipant = [opCtx] {
                 OperationContextSessionMongod checkOutSession(
                     opCtx, true, false, boost::none, false);
 
@@ -273,11 +273,20 @@ public:
                     txnParticipant->abortActiveUnpreparedOrStashPreparedTransaction(opCtx);
                 });
 
-                txnParticipant->prepareTransaction(opCtx, {});
+                auto prepareTimestamp = txnParticipant->prepareTransaction(opCtx, {});
 
                 txnParticipant->stashTransactionResources(opCtx);
                 guard.Dismiss();
-            }
+                return prepareTimestamp;
+            };
+
+            TransactionCoordinatorService::get(opCtx)->coordinateCommit(
+                opCtx,
+                opCtx->getLogicalSessionId().get(),
+                opCtx->getTxnNumber().get(),
+                participantList,
+                localShardId,
+                prepareLocalParticipant);
         }
 
     private:
@@ -502,6 +502,11 @@ public:
     void setServiceExecutor(std::unique_ptr<transport::ServiceExecutor> exec);
 
 private:
+    friend class Client;
+
+    // Number of spare Client decoration buffers kept for reuse by new Clients
+    static constexpr size_t kClientDecorationStorageCapacity = 32;
+
     class ClientObserverHolder {
     public:
         explicit ClientObserverHolder(std::unique_ptr<ClientObserver> observer)
@@ -556,6 +561,13 @@ private:
     std::vector<ClientObserverHolder> _clientObservers;
     ClientSet _clients;
 
+    /**
+     * Decoration storage of destroyed Clients, reused by new ones. Internal work which creates a
+     * Client for each task, and connection churn, do not allocate it each time. Every Client is
+     * destroyed before its ServiceContext, so the storage always has somewhere to go back to.
+     */
+    DecorationStorageCache _clientDecorationStorage{kClientDecorationStorageCapacity, true};
+
     /**
      * The registered OpObserver.
      */
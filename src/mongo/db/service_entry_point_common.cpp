@@ -513,6 +513,7 @@ bool runCommandImpl(OperationContext* opCtx,
                 return;  // Don't do normal waiting.
             }
 
+            ScopedPhaseTimer writeConcernTimer(opCtx, OpDebug::Phase::kWriteConcernWait);
             behaviors.waitForWriteConcern(opCtx, invocation, lastOpBeforeRun, bb);
         };
 
@@ -604,7 +605,10 @@ void execCommandDatabase(OperationContext* opCtx,
     CommandHelpers::uassertShouldAttemptParse(opCtx, command, request);
     BSONObjBuilder extraFieldsBuilder;
     auto startOperationTime = getClientOperationTime(opCtx);
-    auto invocation = command->parse(opCtx, request);
+    auto invocation = [&] {
+        ScopedPhaseTimer parseTimer(opCtx, OpDebug::Phase::kParse);
+        return command->parse(opCtx, request);
+    }();
     boost::optional<OperationSessionInfoFromClient> sessionOptions = boost::none;
 
     try {
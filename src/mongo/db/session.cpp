@@ -111,6 +111,12 @@ ActiveTransactionHistory fetchActiveTransactionHistory(OperationContext* opCtx,
                 continue;
             }
 
+            // The partial entries of a transaction share the statement id of the entry that
+            // commits it.
+            if (entry.isPartialTransaction()) {
+                continue;
+            }
+
             const auto insertRes =
                 result.committedStatements.emplace(*entry.getStatementId(), entry.getOpTime());
             if (!insertRes.second) {
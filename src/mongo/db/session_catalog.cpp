@@ -55,17 +55,23 @@ const auto operationSessionDecoration =
 
 }  // namespace
 
+constexpr size_t SessionCatalog::kNumShards;
+
 SessionCatalog::~SessionCatalog() {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
-    for (const auto& entry : _sessions) {
-        auto& sri = entry.second;
-        invariant(!sri->checkedOut);
+    for (auto& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lg(shard.mutex);
+        for (const auto& entry : shard.sessions) {
+            auto& sri = entry.second;
+            invariant(!sri->checkedOut);
+        }
     }
 }
 
 void SessionCatalog::reset_forTest() {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
-    _sessions.clear();
+    for (auto& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lg(shard.mutex);
+        shard.sessions.clear();
+    }
 }
 
 SessionCatalog* SessionCatalog::get(OperationContext* opCtx) {
@@ -125,14 +131,24 @@ ScopedCheckedOutSession SessionCatalog::checkOutSession(OperationContext* opCtx)
     invariant(opCtx->getLogicalSessionId());
 
     const auto lsid = *opCtx->getLogicalSessionId();
+    auto& shard = _getShard(lsid);
 
-    stdx::unique_lock<stdx::mutex> ul(_mutex);
+    stdx::unique_lock<stdx::mutex> ul(shard.mutex);
 
     while (!_allowCheckingOutSessions) {
-        opCtx->waitForConditionOrInterrupt(_checkingOutSessionsAllowedCond, ul);
+        // '_mutex' must not be acquired while holding the shard's mutex.
+        ul.unlock();
+        {
+            stdx::unique_lock<stdx::mutex> catalogLock(_mutex);
+            opCtx->waitForConditionOrInterrupt(
+                _checkingOutSessionsAllowedCond, catalogLock, [this] {
+                    return _allowCheckingOutSessions;
+                });
+        }
+        ul.lock();
     }
 
-    auto sri = _getOrCreateSessionRuntimeInfo(ul, opCtx, lsid);
+    auto sri = _getOrCreateSessionRuntimeInfo(ul, shard, opCtx, lsid);
 
     // Wait until the session is no longer checked out
     opCtx->waitForConditionOrInterrupt(
@@ -140,7 +156,7 @@ ScopedCheckedOutSession SessionCatalog::checkOutSession(OperationContext* opCtx)
 
     invariant(!sri->checkedOut);
     sri->checkedOut = true;
-    ++_numCheckedOutSessions;
+    _numCheckedOutSessions.fetchAndAdd(1);
 
     return ScopedCheckedOutSession(opCtx, ScopedSession(std::move(sri)));
 }
@@ -152,8 +168,9 @@ ScopedSession SessionCatalog::getOrCreateSession(OperationContext* opCtx,
     invariant(!opCtx->getTxnNumber());
 
     auto ss = [&] {
-        stdx::unique_lock<stdx::mutex> ul(_mutex);
-        return ScopedSession(_getOrCreateSessionRuntimeInfo(ul, opCtx, lsid));
+        auto& shard = _getShard(lsid);
+        stdx::unique_lock<stdx::mutex> ul(shard.mutex);
+        return ScopedSession(_getOrCreateSessionRuntimeInfo(ul, shard, opCtx, lsid));
     }();
 
     return ss;
@@ -171,31 +188,37 @@ void SessionCatalog::invalidateSessions(OperationContext* opCtx,
                 !opCtx->getLogicalSessionId());
     }
 
-    const auto invalidateSessionFn = [&](WithLock, SessionRuntimeInfoMap::iterator it) {
-        auto& sri = it->second;
-        sri->txnState.invalidate();
-
-        // We cannot remove checked-out sessions from the cache, because operations expect to find
-        // them there to check back in
-        if (!sri->checkedOut) {
-            _sessions.erase(it);
-        }
-    };
+    const auto invalidateSessionFn =
+        [&](WithLock, Shard& shard, SessionRuntimeInfoMap::iterator it) {
+            auto& sri = it->second;
+            sri->txnState.invalidate();
 
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
+            // We cannot remove checked-out sessions from the cache, because operations expect to
+            // find them there to check back in
+            if (!sri->checkedOut) {
+                shard.sessions.erase(it);
+            }
+        };
 
     if (singleSessionDoc) {
         const auto lsid = LogicalSessionId::parse(IDLParserErrorContext("lsid"),
                                                   singleSessionDoc->getField("_id").Obj());
 
-        auto it = _sessions.find(lsid);
-        if (it != _sessions.end()) {
-            invalidateSessionFn(lg, it);
+        auto& shard = _getShard(lsid);
+        stdx::lock_guard<stdx::mutex> lg(shard.mutex);
+
+        auto it = shard.sessions.find(lsid);
+        if (it != shard.sessions.end()) {
+            invalidateSessionFn(lg, shard, it);
         }
     } else {
-        auto it = _sessions.begin();
-        while (it != _sessions.end()) {
-            invalidateSessionFn(lg, it++);
+        for (auto& shard : _shards) {
+            stdx::lock_guard<stdx::mutex> lg(shard.mutex);
+
+            auto it = shard.sessions.begin();
+            while (it != shard.sessions.end()) {
+                invalidateSessionFn(lg, shard, it++);
+            }
         }
     }
 }
@@ -203,46 +226,58 @@ void SessionCatalog::invalidateSessions(OperationContext* opCtx,
 void SessionCatalog::scanSessions(OperationContext* opCtx,
                                   const SessionKiller::Matcher& matcher,
                                   stdx::function<void(OperationContext*, Session*)> workerFn) {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
-
-    LOG(2) << "Beginning scanSessions. Scanning " << _sessions.size() << " sessions.";
-
-    for (auto it = _sessions.begin(); it != _sessions.end(); ++it) {
-        // TODO SERVER-33850: Rename KillAllSessionsByPattern and
-        // ScopedKillAllSessionsByPatternImpersonator to not refer to session kill.
-        if (const KillAllSessionsByPattern* pattern = matcher.match(it->first)) {
-            ScopedKillAllSessionsByPatternImpersonator impersonator(opCtx, *pattern);
-            workerFn(opCtx, &(it->second->txnState));
+    LOG(2) << "Beginning scanSessions.";
+
+    // Each shard is locked while it is scanned, so sessions may be added to or removed from the
+    // shards that were already scanned or are yet to be.
+    for (auto& shard : _shards) {
+        stdx::lock_guard<stdx::mutex> lg(shard.mutex);
+
+        for (auto it = shard.sessions.begin(); it != shard.sessions.end(); ++it) {
+            // TODO SERVER-33850: Rename KillAllSessionsByPattern and
+            // ScopedKillAllSessionsByPatternImpersonator to not refer to session kill.
+            if (const KillAllSessionsByPattern* pattern = matcher.match(it->first)) {
+                ScopedKillAllSessionsByPatternImpersonator impersonator(opCtx, *pattern);
+                workerFn(opCtx, &(it->second->txnState));
+            }
         }
     }
 }
 
 std::shared_ptr<SessionCatalog::SessionRuntimeInfo> SessionCatalog::_getOrCreateSessionRuntimeInfo(
-    WithLock, OperationContext* opCtx, const LogicalSessionId& lsid) {
+    WithLock, Shard& shard, OperationContext* opCtx, const LogicalSessionId& lsid) {
     invariant(!opCtx->lockState()->inAWriteUnitOfWork());
     invariant(_allowCheckingOutSessions);
 
-    auto it = _sessions.find(lsid);
-    if (it == _sessions.end()) {
-        it = _sessions.emplace(lsid, std::make_shared<SessionRuntimeInfo>(lsid)).first;
+    auto it = shard.sessions.find(lsid);
+    if (it == shard.sessions.end()) {
+        it = shard.sessions.emplace(lsid, std::make_shared<SessionRuntimeInfo>(lsid)).first;
     }
 
     return it->second;
 }
 
 void SessionCatalog::_releaseSession(const LogicalSessionId& lsid) {
-    stdx::lock_guard<stdx::mutex> lg(_mutex);
+    bool allSessionsCheckedIn;
+    {
+        auto& shard = _getShard(lsid);
+        stdx::lock_guard<stdx::mutex> lg(shard.mutex);
 
-    auto it = _sessions.find(lsid);
-    invariant(it != _sessions.end());
+        auto it = shard.sessions.find(lsid);
+        invariant(it != shard.sessions.end());
 
-    auto& sri = it->second;
-    invariant(sri->checkedOut);
+        auto& sri = it->second;
+        invariant(sri->checkedOut);
 
-    sri->checkedOut = false;
-    sri->availableCondVar.notify_one();
-    --_numCheckedOutSessions;
-    if (_numCheckedOutSessions == 0) {
+        sri->checkedOut = false;
+        sri->availableCondVar.notify_one();
+        allSessionsCheckedIn = _numCheckedOutSessions.subtractAndFetch(1) == 0;
+    }
+
+    // Taking '_mutex' before signaling ensures that a waiter, which saw sessions still checked
+    // out, is already waiting on the condition variable.
+    if (allSessionsCheckedIn) {
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
         _allSessionsCheckedInCond.notify_all();
     }
 }
@@ -253,15 +288,26 @@ SessionCatalog::PreventCheckingOutSessionsBlock::PreventCheckingOutSessionsBlock
     invariant(sessionCatalog);
 
     stdx::lock_guard<stdx::mutex> lg(sessionCatalog->_mutex);
+    std::vector<stdx::unique_lock<stdx::mutex>> shardLocks;
+    for (auto& shard : sessionCatalog->_shards) {
+        shardLocks.emplace_back(shard.mutex);
+    }
+
     invariant(sessionCatalog->_allowCheckingOutSessions);
     sessionCatalog->_allowCheckingOutSessions = false;
 }
 
 SessionCatalog::PreventCheckingOutSessionsBlock::~PreventCheckingOutSessionsBlock() {
     stdx::lock_guard<stdx::mutex> lg(_sessionCatalog->_mutex);
+    {
+        std::vector<stdx::unique_lock<stdx::mutex>> shardLocks;
+        for (auto& shard : _sessionCatalog->_shards) {
+            shardLocks.emplace_back(shard.mutex);
+        }
 
-    invariant(!_sessionCatalog->_allowCheckingOutSessions);
-    _sessionCatalog->_allowCheckingOutSessions = true;
+        invariant(!_sessionCatalog->_allowCheckingOutSessions);
+        _sessionCatalog->_allowCheckingOutSessions = true;
+    }
     _sessionCatalog->_checkingOutSessionsAllowedCond.notify_all();
 }
 
@@ -270,7 +316,7 @@ void SessionCatalog::PreventCheckingOutSessionsBlock::waitForAllSessionsToBeChec
     stdx::unique_lock<stdx::mutex> ul(_sessionCatalog->_mutex);
 
     invariant(!_sessionCatalog->_allowCheckingOutSessions);
-    while (_sessionCatalog->_numCheckedOutSessions > 0) {
+    while (_sessionCatalog->_numCheckedOutSessions.load() > 0) {
         opCtx->waitForConditionOrInterrupt(_sessionCatalog->_allSessionsCheckedInCond, ul);
     }
 }
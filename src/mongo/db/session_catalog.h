@@ -28,10 +28,13 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/session.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/unordered_map.h"
@@ -137,8 +140,8 @@ private:
         // check it out.
         bool checkedOut{false};
 
-        // Signaled when the state becomes available. Uses the transaction table's mutex to protect
-        // the state transitions.
+        // Signaled when the state becomes available. Uses the mutex of the catalog shard which owns
+        // the session to protect the state transitions.
         stdx::condition_variable availableCondVar;
 
         // Must only be accessed when the state is kInUse and only by the operation context, which
@@ -151,30 +154,50 @@ private:
                                                       LogicalSessionIdHash>;
 
     /**
-     * May release and re-acquire it zero or more times before returning. The returned
-     * 'SessionRuntimeInfo' is guaranteed to be linked on the catalog's _txnTable as long as the
-     * lock is held.
+     * The sessions are split into shards by LogicalSessionIdHash, so that checking out and
+     * releasing different sessions don't contend on the same mutex.
+     */
+    static constexpr size_t kNumShards = 32;
+
+    struct Shard {
+        // Protects the sessions of this shard and their check-out state.
+        stdx::mutex mutex;
+
+        // Owns the Session objects for the sessions of this shard.
+        SessionRuntimeInfoMap sessions;
+    };
+
+    Shard& _getShard(const LogicalSessionId& lsid) {
+        return _shards[LogicalSessionIdHash{}(lsid) % kNumShards];
+    }
+
+    /**
+     * Must be called with the lock of 'shard' held, which must be the shard of 'lsid'. The
+     * returned 'SessionRuntimeInfo' is guaranteed to be linked on the shard's sessions map as long
+     * as the lock is held.
      */
     std::shared_ptr<SessionRuntimeInfo> _getOrCreateSessionRuntimeInfo(
-        WithLock, OperationContext* opCtx, const LogicalSessionId& lsid);
+        WithLock, Shard& shard, OperationContext* opCtx, const LogicalSessionId& lsid);
 
     /**
      * Makes a session, previously checked out through 'checkoutSession', available again.
      */
     void _releaseSession(const LogicalSessionId& lsid);
 
-    // Protects members below.
-    stdx::mutex _mutex;
-
-    // Owns the Session objects for all current Sessions.
-    SessionRuntimeInfoMap _sessions;
+    std::array<Shard, kNumShards> _shards;
 
-    // Count of the number of Sessions that are currently checked out.
-    uint32_t _numCheckedOutSessions{0};
+    // Count of the number of Sessions that are currently checked out. Only changed while holding
+    // the mutex of the shard, which owns the session being checked out or released.
+    AtomicUInt32 _numCheckedOutSessions{0};
 
-    // Set to false to cause all Session checkout or creation requests to block.
+    // Set to false to cause all Session checkout or creation requests to block. Only changed while
+    // holding '_mutex' and the mutexes of all shards, so it may be read under either.
     bool _allowCheckingOutSessions{true};
 
+    // Used to wait on the condition variables below. May be acquired before a shard's mutex, but
+    // never while holding one.
+    stdx::mutex _mutex;
+
     // Condition that is signaled when the number of checked out sessions goes to 0.
     stdx::condition_variable _allSessionsCheckedInCond;
 
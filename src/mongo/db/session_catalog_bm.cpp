@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/locker_noop.h"
+#include "mongo/db/logical_session_id.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/session_catalog.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const int kMaxPerfThreads = 16;
+
+// The number of sessions shared by all threads in BM_CheckOutSharedSessions.
+const int kNumSharedSessions = 64;
+
+/**
+ * A client and an operation context with a no-op locker, as required by the session catalog, for a
+ * single benchmark thread.
+ */
+class ThreadOperation {
+public:
+    explicit ThreadOperation(int threadIndex)
+        : _client(getGlobalServiceContext()->makeClient(str::stream() << "session catalog bm "
+                                                                      << threadIndex)),
+          _opCtx(_client->makeOperationContext()) {
+        _opCtx->setLockState(stdx::make_unique<LockerNoop>());
+    }
+
+    OperationContext* get() const {
+        return _opCtx.get();
+    }
+
+private:
+    ServiceContext::UniqueClient _client;
+    ServiceContext::UniqueOperationContext _opCtx;
+};
+
+void BM_CheckOutDistinctSessions(benchmark::State& state) {
+    ThreadOperation op(state.thread_index);
+    op.get()->setLogicalSessionId(makeLogicalSessionIdForTest());
+    auto catalog = SessionCatalog::get(op.get());
+
+    for (auto keepRunning : state) {
+        auto session = catalog->checkOutSession(op.get());
+        benchmark::DoNotOptimize(session.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_CheckOutSharedSessions(benchmark::State& state) {
+    static std::vector<LogicalSessionId> sessions = [] {
+        std::vector<LogicalSessionId> sessions;
+        for (int i = 0; i < kNumSharedSessions; ++i) {
+            sessions.push_back(makeLogicalSessionIdForTest());
+        }
+        return sessions;
+    }();
+
+    // Each thread walks through all of the shared sessions, starting at a different one, so that
+    // threads only occasionally wait for a session checked out by another thread.
+    std::vector<std::unique_ptr<ThreadOperation>> ops;
+    for (const auto& lsid : sessions) {
+        ops.push_back(stdx::make_unique<ThreadOperation>(state.thread_index));
+        ops.back()->get()->setLogicalSessionId(lsid);
+    }
+    auto catalog = SessionCatalog::get(ops.front()->get());
+
+    size_t next = state.thread_index * (kNumSharedSessions / kMaxPerfThreads);
+    for (auto keepRunning : state) {
+        auto opCtx = ops[next]->get();
+        next = (next + 1) % ops.size();
+
+        auto session = catalog->checkOutSession(opCtx);
+        benchmark::DoNotOptimize(session.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void BM_GetOrCreateSession(benchmark::State& state) {
+    ThreadOperation op(state.thread_index);
+    const auto lsid = makeLogicalSessionIdForTest();
+    auto catalog = SessionCatalog::get(op.get());
+
+    for (auto keepRunning : state) {
+        auto session = catalog->getOrCreateSession(op.get(), lsid);
+        benchmark::DoNotOptimize(session.get());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_CheckOutDistinctSessions)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK(BM_CheckOutSharedSessions)->ThreadRange(1, kMaxPerfThreads);
+BENCHMARK(BM_GetOrCreateSession)->ThreadRange(1, kMaxPerfThreads);
+
+}  // namespace
+}  // namespace mongo
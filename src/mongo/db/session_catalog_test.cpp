@@ -35,8 +35,10 @@
 #include "mongo/db/repl/read_concern_args.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/session_catalog.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
@@ -207,6 +209,115 @@ TEST_F(SessionCatalogTest, ScanSessions) {
     ASSERT_EQ(lsids.front(), lsid2);
 }
 
+TEST_F(SessionCatalogTest, ScanAndInvalidateSessionsCoverEveryShard) {
+    // Enough sessions to land in every shard of the catalog.
+    const size_t kNumSessions = 200;
+
+    LogicalSessionIdSet created;
+    for (size_t i = 0; i < kNumSessions; ++i) {
+        const auto lsid = makeLogicalSessionIdForTest();
+        created.insert(lsid);
+        catalog()->getOrCreateSession(opCtx(), lsid);
+    }
+
+    LogicalSessionIdSet scanned;
+    auto workerFn = [&](OperationContext* opCtx, Session* session) {
+        ASSERT(scanned.insert(session->getSessionId()).second);
+    };
+    SessionKiller::Matcher matcherAllSessions(
+        KillAllSessionsByPatternSet{makeKillAllSessionsByPattern(opCtx())});
+    catalog()->scanSessions(opCtx(), matcherAllSessions, workerFn);
+    ASSERT(created == scanned);
+
+    catalog()->invalidateSessions(opCtx(), boost::none);
+    scanned.clear();
+    catalog()->scanSessions(opCtx(), matcherAllSessions, workerFn);
+    ASSERT(scanned.empty());
+}
+
+TEST_F(SessionCatalogTest, ConcurrentCheckoutsOfDistinctAndSharedSessions) {
+    const int kNumThreads = 8;
+    const int kNumIterations = 100;
+    const auto sharedLsid = makeLogicalSessionIdForTest();
+
+    // The number of threads which have the shared session checked out, which must never be more
+    // than one.
+    AtomicWord<int> sharedSessionHolders{0};
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kNumThreads; ++i) {
+        threads.emplace_back([&] {
+            ON_BLOCK_EXIT([&] { Client::destroy(); });
+            Client::initThreadIfNotAlready();
+            const auto ownLsid = makeLogicalSessionIdForTest();
+
+            for (int j = 0; j < kNumIterations; ++j) {
+                {
+                    auto sideOpCtx = Client::getCurrent()->makeOperationContext();
+                    sideOpCtx->setLogicalSessionId(ownLsid);
+                    auto scopedSession =
+                        SessionCatalog::get(sideOpCtx.get())->checkOutSession(sideOpCtx.get());
+                    ASSERT_EQ(ownLsid, scopedSession->getSessionId());
+                }
+
+                {
+                    auto sideOpCtx = Client::getCurrent()->makeOperationContext();
+                    sideOpCtx->setLogicalSessionId(sharedLsid);
+                    auto scopedSession =
+                        SessionCatalog::get(sideOpCtx.get())->checkOutSession(sideOpCtx.get());
+                    ASSERT_EQ(sharedLsid, scopedSession->getSessionId());
+                    ASSERT_EQ(1, sharedSessionHolders.addAndFetch(1));
+                    ASSERT_EQ(0, sharedSessionHolders.subtractAndFetch(1));
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Every session was checked back in.
+    SessionCatalog::PreventCheckingOutSessionsBlock preventCheckoutBlock(catalog());
+    opCtx()->setDeadlineAfterNowBy(Milliseconds(10), ErrorCodes::MaxTimeMSExpired);
+    preventCheckoutBlock.waitForAllSessionsToBeCheckedIn(opCtx());
+}
+
+TEST_F(SessionCatalogTest, PreventCheckoutBlocksSessionsInEveryShard) {
+    // Enough sessions to land in every shard of the catalog.
+    std::vector<LogicalSessionId> lsids;
+    for (int i = 0; i < 200; ++i) {
+        lsids.push_back(makeLogicalSessionIdForTest());
+    }
+
+    auto checkOutAll = [&](bool expectBlocked) {
+        stdx::async(stdx::launch::async, [&] {
+            ON_BLOCK_EXIT([&] { Client::destroy(); });
+            Client::initThreadIfNotAlready();
+
+            for (const auto& lsid : lsids) {
+                auto sideOpCtx = Client::getCurrent()->makeOperationContext();
+                sideOpCtx->setLogicalSessionId(lsid);
+                auto catalog = SessionCatalog::get(sideOpCtx.get());
+                if (expectBlocked) {
+                    sideOpCtx->setDeadlineAfterNowBy(Milliseconds(1),
+                                                     ErrorCodes::MaxTimeMSExpired);
+                    ASSERT_THROWS_CODE(catalog->checkOutSession(sideOpCtx.get()),
+                                       AssertionException,
+                                       ErrorCodes::MaxTimeMSExpired);
+                } else {
+                    ASSERT_EQ(lsid, catalog->checkOutSession(sideOpCtx.get())->getSessionId());
+                }
+            }
+        }).get();
+    };
+
+    {
+        SessionCatalog::PreventCheckingOutSessionsBlock preventCheckoutBlock(catalog());
+        checkOutAll(true);
+    }
+    checkOutAll(false);
+}
+
 TEST_F(SessionCatalogTest, PreventCheckout) {
     const auto lsid = makeLogicalSessionIdForTest();
     opCtx()->setLogicalSessionId(lsid);
@@ -47,6 +47,14 @@ class OperationContext;
 class SessionsCollection {
 
 public:
+    // This batch size is chosen to ensure that we don't form requests larger than the 16mb limit.
+    // Especially for refreshes, the updates we send include the full user name (user@db), and user
+    // names can be quite large (we enforce a max 10k limit for usernames used with sessions).
+    //
+    // At 1000 elements, a 16mb payload gives us a budget of 16000 bytes per user, which we should
+    // comfortably be able to stay under, even with 10k user names.
+    static constexpr size_t kMaxBatchSize = 1000;
+
     virtual ~SessionsCollection();
 
     /**
@@ -165,6 +165,41 @@ MONGO_COMPILER_VARIABLE_UNUSED auto _exportedCheckCachePressurePeriodSeconds =
             return Status::OK();
         });
 
+MONGO_COMPILER_VARIABLE_UNUSED auto _exportedSnapshotWindowReadDurationPercentile =
+    (new ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+        ServerParameterSet::getGlobal(),
+        "snapshotWindowReadDurationPercentile",
+        &snapshotWindowParams.snapshotWindowReadDurationPercentile))
+        -> withValidator([](const int32_t& potentialNewValue) {
+            if (potentialNewValue < 0 || potentialNewValue > 100) {
+                return Status(ErrorCodes::BadValue,
+                              str::stream() << "snapshotWindowReadDurationPercentile must be "
+                                               "greater than or equal to 0 and less than or equal "
+                                               "to 100. '"
+                                            << potentialNewValue
+                                            << "' is an invalid setting.");
+            }
+
+            return Status::OK();
+        });
+
+MONGO_COMPILER_VARIABLE_UNUSED auto _exportedSnapshotWindowReadDurationHeadroom =
+    (new ExportedServerParameter<double, ServerParameterType::kStartupAndRuntime>(
+        ServerParameterSet::getGlobal(),
+        "snapshotWindowReadDurationHeadroom",
+        &snapshotWindowParams.snapshotWindowReadDurationHeadroom))
+        -> withValidator([](const double& potentialNewValue) {
+            if (potentialNewValue < 1) {
+                return Status(ErrorCodes::BadValue,
+                              str::stream() << "snapshotWindowReadDurationHeadroom must be greater "
+                                               "than or equal to 1. '"
+                                            << potentialNewValue
+                                            << "' is an invalid setting.");
+            }
+
+            return Status::OK();
+        });
+
 /**
  * After startup parameters have been initialized, set targetSnapshotHistoryWindowInSeconds to the
  * value of maxTargetSnapshotHistoryWindowInSeconds, in case the max has been altered. The cache
@@ -101,6 +101,22 @@ struct SnapshotWindowParams {
     // target window size setting must not be decreased too fast because time must be allowed for
     // the storage engine to attempt to act on the new setting.
     AtomicInt32 checkCachePressurePeriodSeconds{5};
+
+    // snapshotWindowReadDurationPercentile (startup & runtime server paramter, range [0, 100]).
+    //
+    // Each checkCachePressurePeriodSeconds, when the cache is not under pressure, the target
+    // snapshot window is sized to this percentile of the durations of recently completed snapshot
+    // transactions, which bounds how old a snapshot they may need to open. The target is raised to
+    // that size right away but only lowered by snapshotWindowMultiplicativeDecrease per period, so
+    // history is released gradually once long snapshot reads stop. 0 disables the adjustment,
+    // leaving the target to SnapshotTooOld errors and cache pressure alone.
+    AtomicInt32 snapshotWindowReadDurationPercentile{99};
+
+    // snapshotWindowReadDurationHeadroom (startup & runtime server paramter, range 1+).
+    //
+    // Multiplier applied to the observed snapshot read duration percentile when computing the
+    // target snapshot window.
+    AtomicDouble snapshotWindowReadDurationHeadroom{1.5};
 };
 
 extern SnapshotWindowParams snapshotWindowParams;
@@ -32,10 +32,15 @@
 
 #include "mongo/db/snapshot_window_util.h"
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/snapshot_window_options.h"
 #include "mongo/db/storage/storage_engine.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/with_lock.h"
 #include "mongo/util/fail_point_service.h"
@@ -57,6 +62,44 @@ stdx::mutex snapshotWindowMutex;
 
 namespace {
 
+// Durations of recently completed snapshot transactions, overwritten round-robin. Slots are
+// written without holding snapshotWindowMutex, so a reader may see a slot that is mid-update,
+// which is harmless for a percentile estimate.
+const size_t kNumReadDurationSamples = 1024;
+
+// Only durations recorded this recently are used to size the window.
+const Seconds kReadDurationSampleHorizon{60};
+
+struct ReadDurationSample {
+    AtomicInt64 durationMillis{0};
+    AtomicInt64 recordedAtMillis{0};
+};
+
+ReadDurationSample readDurationSamples[kNumReadDurationSamples];
+AtomicUInt64 nextReadDurationSample;
+
+/**
+ * Returns the 'percentile' of the read durations recorded since 'since', or zero if there are
+ * none.
+ */
+Milliseconds _readDurationPercentile(Date_t since, int percentile) {
+    std::vector<long long> durations;
+    const long long sinceMillis = since.toMillisSinceEpoch();
+    for (const auto& sample : readDurationSamples) {
+        if (sample.recordedAtMillis.load() >= sinceMillis) {
+            durations.push_back(sample.durationMillis.load());
+        }
+    }
+
+    if (durations.empty()) {
+        return Milliseconds(0);
+    }
+
+    const size_t rank = std::max<size_t>(1, (durations.size() * percentile + 99) / 100);
+    std::nth_element(durations.begin(), durations.begin() + (rank - 1), durations.end());
+    return Milliseconds(durations[rank - 1]);
+}
+
 void _decreaseTargetSnapshotWindowSize(WithLock lock, OperationContext* opCtx) {
     // Tracks the last time that the snapshot window was decreased so that it does not go down so
     // fast that the system does not have time to react and reduce snapshot availability.
@@ -135,9 +178,17 @@ void increaseTargetSnapshotWindowSize(OperationContext* opCtx) {
 
     int increasedSnapshotWindow = snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load() +
         snapshotWindowParams.snapshotWindowAdditiveIncreaseSeconds.load();
-    snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.store(
+    increasedSnapshotWindow =
         std::min(increasedSnapshotWindow,
-                 snapshotWindowParams.maxTargetSnapshotHistoryWindowInSeconds.load()));
+                 snapshotWindowParams.maxTargetSnapshotHistoryWindowInSeconds.load());
+    snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.store(increasedSnapshotWindow);
+
+    // A read failed because the window was too small, so count it as a read that needed the new
+    // window. Otherwise adjustTargetSnapshotWindowSize() would shrink the window straight back.
+    recordSnapshotReadDuration(
+        Milliseconds(static_cast<long long>(
+            increasedSnapshotWindow * 1000 /
+            snapshotWindowParams.snapshotWindowReadDurationHeadroom.load())));
 
     _snapshotWindowLastIncreasedAt = Date_t::now();
 }
@@ -155,5 +206,62 @@ void decreaseTargetSnapshotWindowSize(OperationContext* opCtx) {
     }
 }
 
+void recordSnapshotReadDuration(Milliseconds duration) {
+    auto& sample =
+        readDurationSamples[nextReadDurationSample.fetchAndAdd(1) % kNumReadDurationSamples];
+    sample.durationMillis.store(durationCount<Milliseconds>(duration));
+    sample.recordedAtMillis.store(Date_t::now().toMillisSinceEpoch());
+}
+
+void adjustTargetSnapshotWindowSize(OperationContext* opCtx) {
+    if (MONGO_FAIL_POINT(preventDynamicSnapshotHistoryWindowTargetAdjustments)) {
+        return;
+    }
+
+    stdx::unique_lock<stdx::mutex> lock(snapshotWindowMutex);
+
+    StorageEngine* engine = opCtx->getServiceContext()->getStorageEngine();
+    if (engine && engine->isCacheUnderPressure(opCtx)) {
+        _decreaseTargetSnapshotWindowSize(lock, opCtx);
+        return;
+    }
+
+    const int percentile = snapshotWindowParams.snapshotWindowReadDurationPercentile.load();
+    if (percentile == 0) {
+        return;
+    }
+
+    const Milliseconds readDuration =
+        _readDurationPercentile(Date_t::now() - kReadDurationSampleHorizon, percentile);
+    const double neededSeconds = durationCount<Milliseconds>(readDuration) *
+        snapshotWindowParams.snapshotWindowReadDurationHeadroom.load() / 1000;
+    const int wantedSnapshotWindow =
+        std::min(snapshotWindowParams.maxTargetSnapshotHistoryWindowInSeconds.load(),
+                 static_cast<int>(std::ceil(neededSeconds)));
+
+    const int currentSnapshotWindow =
+        snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load();
+    if (wantedSnapshotWindow > currentSnapshotWindow) {
+        snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.store(wantedSnapshotWindow);
+    } else if (wantedSnapshotWindow < currentSnapshotWindow) {
+        const int decreasedSnapshotWindow = static_cast<int>(
+            currentSnapshotWindow * snapshotWindowParams.snapshotWindowMultiplicativeDecrease.load());
+        snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.store(
+            std::max(wantedSnapshotWindow, decreasedSnapshotWindow));
+
+        // As in _decreaseTargetSnapshotWindowSize(), try to release the history right away.
+        if (engine) {
+            engine->setOldestTimestampFromStable();
+        }
+    }
+}
+
+void resetSnapshotReadDurationsForTest() {
+    for (auto& sample : readDurationSamples) {
+        sample.durationMillis.store(0);
+        sample.recordedAtMillis.store(0);
+    }
+}
+
 }  // namespace SnapshotWindowUtil
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include "mongo/util/duration.h"
+
 namespace mongo {
 
 class OperationContext;
@@ -73,5 +75,27 @@ void increaseTargetSnapshotWindowSize(OperationContext* opCtx);
  */
 void decreaseTargetSnapshotWindowSize(OperationContext* opCtx);
 
+/**
+ * Records the duration of a snapshot transaction that has just committed or aborted. For as long
+ * as a transaction runs, its participants may be asked to open a snapshot as old as its start, so
+ * recent durations tell adjustTargetSnapshotWindowSize() how much history is actually needed.
+ */
+void recordSnapshotReadDuration(Milliseconds duration);
+
+/**
+ * Called periodically to size the target snapshot window from the workload. Under cache pressure
+ * this behaves like decreaseTargetSnapshotWindowSize(). Otherwise the target is set to the
+ * snapshotWindowReadDurationPercentile of the snapshot read durations recorded over the last
+ * minute, scaled by snapshotWindowReadDurationHeadroom: larger targets take effect immediately,
+ * while smaller ones are approached by multiplicative decrease so history is released gradually.
+ * The target never exceeds maxTargetSnapshotHistoryWindowInSeconds.
+ */
+void adjustTargetSnapshotWindowSize(OperationContext* opCtx);
+
+/**
+ * For unit tests only. Forgets all recorded snapshot read durations.
+ */
+void resetSnapshotReadDurationsForTest();
+
 }  // namespace SnapshotWindowUtil
 }  // namespace mongo
@@ -155,5 +155,58 @@ TEST_F(SnapshotWindowTest, DecreaseAndIncreaseSnapshotWindow) {
     ASSERT_EQ(snapshotWindowSecondsFive, maxTargetSnapshotWindowSeconds);
 }
 
+TEST_F(SnapshotWindowTest, AdjustSnapshotWindowToReadDurations) {
+    auto engine = getServiceContext()->getStorageEngine();
+    invariant(engine);
+
+    resetSnapshotReadDurationsForTest();
+    snapshotWindowParams.maxTargetSnapshotHistoryWindowInSeconds.store(100);
+    snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.store(100);
+    snapshotWindowParams.snapshotWindowReadDurationPercentile.store(99);
+    snapshotWindowParams.snapshotWindowReadDurationHeadroom.store(1.5);
+    snapshotWindowParams.snapshotWindowMultiplicativeDecrease.store(0.75);
+
+    auto cachePressureThreshold = snapshotWindowParams.cachePressureThreshold.load();
+    engine->setCachePressureForTest(cachePressureThreshold - 5);
+
+    // Without any snapshot reads, the window shrinks gradually.
+    adjustTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(75, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+    adjustTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(56, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+
+    // It stops shrinking once it fits the observed reads, with headroom.
+    for (int i = 0; i < 100; ++i) {
+        recordSnapshotReadDuration(Seconds(20));
+    }
+    adjustTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(42, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+    adjustTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(31, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+    adjustTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(30, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+    adjustTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(30, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+
+    // Longer reads grow the window immediately, up to the maximum.
+    for (int i = 0; i < 100; ++i) {
+        recordSnapshotReadDuration(Seconds(60));
+    }
+    adjustTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(90, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+
+    recordSnapshotReadDuration(Seconds(1000));
+    snapshotWindowParams.snapshotWindowReadDurationPercentile.store(100);
+    adjustTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(100, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+
+    // Cache pressure takes precedence over the observed reads.
+    snapshotWindowParams.minMillisBetweenSnapshotWindowDec.store(1);
+    sleepmillis(2);
+    engine->setCachePressureForTest(cachePressureThreshold + 5);
+    adjustTargetSnapshotWindowSize(_opCtx.get());
+    ASSERT_EQ(75, snapshotWindowParams.targetSnapshotHistoryWindowInSeconds.load());
+}
+
 }  // namespace
 }  // namespace mongo
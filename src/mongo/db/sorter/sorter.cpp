@@ -47,8 +47,11 @@
 
 #include "mongo/db/sorter/sorter.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
+#include <cstring>
 #include <snappy.h>
+#include <system_error>
 #include <vector>
 
 #include "mongo/base/string_data.h"
@@ -59,9 +62,13 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/is_mongos.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/destructor_guard.h"
+#include "mongo/util/file.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/unowned_ptr.h"
 
@@ -102,16 +109,84 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
+/**
+ * Stably sorts [begin, end) with 'less', splitting the work between up to 'parallelism' threads
+ * which each sort a slice of the range. The sorted slices are then merged on this thread.
+ */
+template <typename Iterator, typename Less>
+void parallelStableSort(Iterator begin, Iterator end, const Less& less, size_t parallelism) {
+    // Starting a thread is not worth it for fewer elements than this.
+    const size_t kMinSliceSize = 16 * 1024;
+
+    const size_t size = std::distance(begin, end);
+    parallelism = std::min(parallelism, size / kMinSliceSize);
+    if (parallelism <= 1) {
+        std::stable_sort(begin, end, less);
+        return;
+    }
+
+    std::vector<Iterator> bounds;
+    for (size_t i = 0; i <= parallelism; i++) {
+        bounds.push_back(begin + size * i / parallelism);
+    }
+
+    std::vector<Status> statuses(parallelism, Status::OK());
+    auto sortSlice = [&](size_t i) {
+        try {
+            std::stable_sort(bounds[i], bounds[i + 1], less);
+        } catch (const DBException& ex) {
+            statuses[i] = ex.toStatus();
+        }
+    };
+
+    // Any slice which could not be given its own thread is sorted on this one.
+    std::vector<stdx::thread> threads;
+    size_t slice = 1;
+    try {
+        for (; slice < parallelism; slice++) {
+            threads.emplace_back(sortSlice, slice);
+        }
+    } catch (const std::system_error&) {
+    }
+    for (; slice < parallelism; slice++) {
+        sortSlice(slice);
+    }
+    sortSlice(0);
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    for (auto&& status : statuses) {
+        uassertStatusOK(status);
+    }
+
+    // Merge neighbouring slices, doubling their width, until a single one is left.
+    for (size_t width = 1; width < parallelism; width *= 2) {
+        for (size_t i = 0; i + width < parallelism; i += 2 * width) {
+            std::inplace_merge(
+                bounds[i], bounds[i + width], bounds[std::min(i + 2 * width, parallelism)], less);
+        }
+    }
+}
+
 /** Ensures a named file is deleted when this object goes out of scope */
 class FileDeleter {
 public:
     FileDeleter(const std::string& fileName) : _fileName(fileName) {}
     ~FileDeleter() {
-        DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName);)
+        if (!_dismissed) {
+            DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName);)
+        }
+    }
+
+    /** Leaves the file in place. */
+    void dismiss() {
+        _dismissed = true;
     }
 
 private:
     const std::string _fileName;
+    bool _dismissed = false;
 };
 
 /** Returns results from sorted in-memory storage */
@@ -154,12 +229,14 @@ public:
 
     FileIterator(const std::string& fileName,
                  const Settings& settings,
-                 std::shared_ptr<FileDeleter> fileDeleter)
+                 std::shared_ptr<FileDeleter> fileDeleter,
+                 size_t readAheadBytes = 0)
         : _settings(settings),
           _done(false),
           _fileName(fileName),
           _fileDeleter(fileDeleter),
-          _file(_fileName.c_str(), std::ios::in | std::ios::binary) {
+          _file(_fileName.c_str(), std::ios::in | std::ios::binary),
+          _readAheadBytes(readAheadBytes) {
         massert(16814,
                 str::stream() << "error opening file \"" << _fileName << "\": "
                               << myErrnoWithDescription(),
@@ -170,6 +247,17 @@ public:
                 boost::filesystem::file_size(_fileName) != 0);
     }
 
+    ~FileIterator() {
+        if (_readAheadThread.joinable()) {
+            {
+                stdx::lock_guard<stdx::mutex> lk(_readAheadMutex);
+                _stopReadAhead = true;
+            }
+            _readAheadCondition.notify_all();
+            _readAheadThread.join();
+        }
+    }
+
     bool more() {
         if (!_done)
             fillIfNeeded();  // may change _done
@@ -249,6 +337,11 @@ private:
 
     // sets _done to true on EOF - asserts on any other error
     void read(void* out, size_t size) {
+        if (_readAheadBytes) {
+            readFromChunks(reinterpret_cast<char*>(out), size);
+            return;
+        }
+
         _file.read(reinterpret_cast<char*>(out), size);
         if (!_file.good()) {
             if (_file.eof()) {
@@ -263,6 +356,79 @@ private:
         verify(_file.gcount() == static_cast<std::streamsize>(size));
     }
 
+    // Like read(), but serves the data from chunks of the file read ahead in the background.
+    void readFromChunks(char* out, size_t size) {
+        while (size > 0) {
+            if (_chunkPos == _chunk.size() && !nextChunk()) {
+                _done = true;
+                return;
+            }
+
+            const size_t toCopy = std::min(size, _chunk.size() - _chunkPos);
+            memcpy(out, _chunk.data() + _chunkPos, toCopy);
+            _chunkPos += toCopy;
+            out += toCopy;
+            size -= toCopy;
+        }
+    }
+
+    // Makes the chunk read in the background current and lets the reader thread start on the one
+    // after it. Returns false at the end of the file.
+    bool nextChunk() {
+        if (!_readAheadThread.joinable())  // nothing has been read yet
+            _readAheadThread = stdx::thread([this] { readAheadLoop(); });
+
+        stdx::unique_lock<stdx::mutex> lk(_readAheadMutex);
+        _readAheadCondition.wait(lk, [&] { return _nextChunkReady; });
+
+        massert(50971,
+                str::stream() << "error reading file \"" << _fileName << "\": "
+                              << _readAheadError,
+                _readAheadError.empty());
+
+        _chunk.swap(_nextChunk);
+        _chunkPos = 0;
+        _nextChunkReady = false;
+        lk.unlock();
+        _readAheadCondition.notify_all();
+        return !_chunk.empty();
+    }
+
+    // Body of '_readAheadThread', which lives as long as this iterator: reads each chunk into
+    // '_nextChunk' once the previous one has been taken, until the end of the file, an error or
+    // the iterator being destroyed.
+    void readAheadLoop() {
+        while (true) {
+            {
+                stdx::unique_lock<stdx::mutex> lk(_readAheadMutex);
+                _readAheadCondition.wait(lk, [&] { return !_nextChunkReady || _stopReadAhead; });
+                if (_stopReadAhead)
+                    return;
+            }
+
+            std::string chunk(_readAheadBytes, '\0');
+            std::string error;
+            _file.read(&chunk[0], chunk.size());
+            if (_file.bad()) {
+                error = myErrnoWithDescription();
+                chunk.clear();
+            } else {
+                chunk.resize(_file.gcount());
+            }
+
+            const bool last = chunk.empty();
+            {
+                stdx::lock_guard<stdx::mutex> lk(_readAheadMutex);
+                _nextChunk = std::move(chunk);
+                _readAheadError = std::move(error);
+                _nextChunkReady = true;
+            }
+            _readAheadCondition.notify_all();
+            if (last)
+                return;
+        }
+    }
+
     const Settings _settings;
     bool _done;
     std::unique_ptr<char[]> _buffer;
@@ -270,6 +436,20 @@ private:
     std::string _fileName;
     std::shared_ptr<FileDeleter> _fileDeleter;  // Must outlive _file
     std::ifstream _file;
+
+    // When nonzero, '_file' is read in chunks of this many bytes by '_readAheadThread', which is
+    // then the only one to touch '_file'. '_nextChunk', '_readAheadError', '_nextChunkReady' and
+    // '_stopReadAhead' are guarded by '_readAheadMutex'.
+    const size_t _readAheadBytes;
+    std::string _chunk;  // The chunk being consumed.
+    size_t _chunkPos = 0;
+    stdx::mutex _readAheadMutex;
+    stdx::condition_variable _readAheadCondition;
+    std::string _nextChunk;
+    std::string _readAheadError;
+    bool _nextChunkReady = false;
+    bool _stopReadAhead = false;
+    stdx::thread _readAheadThread;
 };
 
 /** Merge-sorts results from 0 or more FileIterators */
@@ -412,6 +592,20 @@ public:
         verify(_opts.limit == 0);
     }
 
+    NoLimitSorter(const std::vector<std::string>& runFileNames,
+                  const SortOptions& opts,
+                  const Comparator& comp,
+                  const Settings& settings = Settings())
+        : NoLimitSorter(opts, comp, settings) {
+        for (const auto& fileName : runFileNames) {
+            auto fileDeleter = std::make_shared<FileDeleter>(fileName);
+            _iters.push_back(std::make_shared<FileIterator<Key, Value>>(
+                fileName, _settings, fileDeleter, _opts.readAheadBytes));
+            _runFiles.emplace_back(fileName, std::move(fileDeleter));
+        }
+        this->_usedDisk = !_iters.empty();
+    }
+
     void add(const Key& key, const Value& val) {
         _data.push_back(std::make_pair(key, val));
 
@@ -432,6 +626,29 @@ public:
         return Iterator::merge(_iters, _opts, _comp);
     }
 
+    std::vector<std::string> persistSpilledRuns() {
+        spill();
+
+        std::vector<std::string> fileNames;
+        for (const auto& runFile : _runFiles) {
+            File file;
+            file.open(runFile.first.c_str(), true /* readOnly */);
+            uassert(ErrorCodes::FileNotOpen,
+                    str::stream() << "error opening file \"" << runFile.first << "\": "
+                                  << myErrnoWithDescription(),
+                    !file.bad());
+            file.fsync();
+            fileNames.push_back(runFile.first);
+        }
+        return fileNames;
+    }
+
+    void keepSpilledRuns() {
+        for (const auto& runFile : _runFiles) {
+            runFile.second->dismiss();
+        }
+    }
+
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     int numFiles() const {
         return _iters.size();
@@ -455,7 +672,7 @@ private:
 
     void sort() {
         STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+        parallelStableSort(_data.begin(), _data.end(), less, _opts.parallelism);
 
         // Does 2x more compares than stable_sort
         // TODO test on windows
@@ -488,6 +705,8 @@ private:
         }
 
         _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
+        _runFiles.emplace_back(writer.fileName(), writer.fileDeleter());
+        this->_bytesSpilled += writer.bytesWritten();
 
         _memUsed = 0;
     }
@@ -498,6 +717,9 @@ private:
     size_t _memUsed;
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+
+    // The file holding each of '_iters', along with what deletes it.
+    std::vector<std::pair<std::string, std::shared_ptr<FileDeleter>>> _runFiles;
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -535,6 +757,12 @@ public:
         }
     }
 
+    std::vector<std::string> persistSpilledRuns() {
+        MONGO_UNREACHABLE;
+    }
+
+    void keepSpilledRuns() {}
+
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     int numFiles() const {
         return 0;
@@ -606,6 +834,9 @@ public:
         if (!less(contender, _data.front()))
             return;  // not good enough
 
+        if (_haveCutoff && !less(contender, _cutoff))
+            return;  // not better than what has already been spilled
+
         // Remove the old worst pair and insert the contender, adjusting _memUsed
 
         _memUsed += key.memUsageForSorter();
@@ -632,6 +863,16 @@ public:
         return Iterator::merge(_iters, _opts, _comp);
     }
 
+    std::vector<std::string> persistSpilledRuns() {
+        // Runs which can no longer affect the result are discarded, so a limited sort's spilled
+        // runs do not describe everything it was given.
+        MONGO_UNREACHABLE;
+    }
+
+    void keepSpilledRuns() {
+        MONGO_UNREACHABLE;
+    }
+
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     int numFiles() const {
         return _iters.size();
@@ -765,25 +1006,56 @@ private:
         sort();
         updateCutoff();
 
-        SortedFileWriter<Key, Value> writer(_opts, _settings);
-        for (size_t i = 0; i < _data.size(); i++) {
-            writer.addAlreadySorted(_data[i].first, _data[i].second);
+        STLComparator less(_comp);
+        if (_haveCutoff) {
+            // Values worse than the cutoff could never make it into the result. Values equal to
+            // it must be kept, since they may be among the K values which justified the cutoff.
+            _data.erase(std::upper_bound(_data.begin(), _data.end(), _cutoff, less), _data.end());
+            discardRunsWorseThanCutoff();
+        }
+
+        if (!_data.empty()) {
+            SortedFileWriter<Key, Value> writer(_opts, _settings);
+            for (size_t i = 0; i < _data.size(); i++) {
+                writer.addAlreadySorted(_data[i].first, _data[i].second);
+            }
+
+            _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
+            _runMins.push_back(_data.front());
+            this->_bytesSpilled += writer.bytesWritten();
         }
 
         // clear _data and release backing array's memory
         std::vector<Data>().swap(_data);
 
-        _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
-
         _memUsed = 0;
     }
 
+    // Drops the spilled runs whose best value is worse than _cutoff. None of their values could
+    // make it into the result, and none of them were counted towards the current _cutoff.
+    void discardRunsWorseThanCutoff() {
+        STLComparator less(_comp);
+        size_t kept = 0;
+        for (size_t i = 0; i < _iters.size(); i++) {
+            if (less(_cutoff, _runMins[i])) {
+                this->_numRunsDiscarded++;
+                continue;  // the run's file is deleted along with its iterator
+            }
+            _iters[kept] = std::move(_iters[i]);
+            _runMins[kept] = std::move(_runMins[i]);
+            kept++;
+        }
+        _iters.resize(kept);
+        _runMins.resize(kept);
+    }
+
     const Comparator _comp;
     const Settings _settings;
     SortOptions _opts;
     size_t _memUsed;
     std::vector<Data> _data;  // the "current" data. Organized as max-heap if size == limit.
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+    std::vector<Data> _runMins;                     // the best value of each of _iters
 
     // See updateCutoff() for a full description of how these members are used.
     bool _haveCutoff;
@@ -808,7 +1080,7 @@ inline unsigned nextFileNumber() {
 
 template <typename Key, typename Value>
 SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Settings& settings)
-    : _settings(settings) {
+    : _settings(settings), _readAheadBytes(opts.readAheadBytes) {
     namespace str = mongoutils::str;
 
     // This should be checked by consumers, but if we get here don't allow writes.
@@ -819,11 +1091,13 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Se
             "Attempting to use external sort without setting SortOptions::tempDir",
             !opts.tempDir.empty());
 
-    {
+    // The counter restarts with the process, while the runs of a resumed sort may have been left
+    // in the same directory by an earlier one.
+    do {
         StringBuilder sb;
         sb << opts.tempDir << "/extsort." << sorter::nextFileNumber();
         _fileName = sb.str();
-    }
+    } while (boost::filesystem::exists(_fileName));
 
     boost::filesystem::create_directories(opts.tempDir);
 
@@ -891,6 +1165,7 @@ void SortedFileWriter<Key, Value>::spill() {
     try {
         _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
         _file.write(outBuffer, std::abs(size));
+        _bytesWritten += sizeof(size) + std::abs(size);
 
     } catch (const std::exception&) {
         msgasserted(16821,
@@ -905,7 +1180,8 @@ template <typename Key, typename Value>
 SortIteratorInterface<Key, Value>* SortedFileWriter<Key, Value>::done() {
     spill();
     _file.close();
-    return new sorter::FileIterator<Key, Value>(_fileName, _settings, _fileDeleter);
+    return new sorter::FileIterator<Key, Value>(
+        _fileName, _settings, _fileDeleter, _readAheadBytes);
 }
 
 //
@@ -943,4 +1219,16 @@ Sorter<Key, Value>* Sorter<Key, Value>::make(const SortOptions& opts,
             return new sorter::TopKSorter<Key, Value, Comparator>(opts, comp, settings);
     }
 }
+
+template <typename Key, typename Value>
+template <typename Comparator>
+Sorter<Key, Value>* Sorter<Key, Value>::makeFromSpilledRuns(
+    const std::vector<std::string>& runFileNames,
+    const SortOptions& opts,
+    const Comparator& comp,
+    const Settings& settings) {
+    invariant(opts.limit == 0);
+    invariant(opts.extSortAllowed);
+    return new sorter::NoLimitSorter<Key, Value, Comparator>(runFileNames, opts, comp, settings);
+}
 }
@@ -98,8 +98,16 @@ struct SortOptions {
     bool extSortAllowed;         /// If false, uassert if more mem needed than allowed.
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
+    size_t parallelism;          /// Number of threads sorting each batch of data. 1 for none.
+    size_t readAheadBytes;       /// How much of each spilled file is read ahead on a background
+                                 /// thread while merging. 0 to read synchronously.
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    SortOptions()
+        : limit(0),
+          maxMemoryUsageBytes(64 * 1024 * 1024),
+          extSortAllowed(false),
+          parallelism(1),
+          readAheadBytes(0) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -122,6 +130,16 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& Parallelism(size_t newParallelism) {
+        parallelism = newParallelism;
+        return *this;
+    }
+
+    SortOptions& ReadAheadBytes(size_t newReadAheadBytes) {
+        readAheadBytes = newReadAheadBytes;
+        return *this;
+    }
 };
 
 /// This is the output from the sorting framework
@@ -167,9 +185,33 @@ public:
                         const Comparator& comp,
                         const Settings& settings = Settings());
 
+    /**
+     * Makes a Sorter without a limit which starts out with the runs spilled to 'runFileNames', as
+     * returned by persistSpilledRuns() of an earlier Sorter with the same comparator and settings.
+     * The files are deleted along with the new Sorter, unless keepSpilledRuns() is called.
+     */
+    template <typename Comparator>
+    static Sorter* makeFromSpilledRuns(const std::vector<std::string>& runFileNames,
+                                       const SortOptions& opts,
+                                       const Comparator& comp,
+                                       const Settings& settings = Settings());
+
     virtual void add(const Key&, const Value&) = 0;
     virtual Iterator* done() = 0;  /// Can't add more data after calling done()
 
+    /**
+     * Spills any data held in memory, forces every run spilled so far to disk, and returns the
+     * names of the files holding them. Only Sorters without a limit support this, and only before
+     * done() is called.
+     */
+    virtual std::vector<std::string> persistSpilledRuns() = 0;
+
+    /**
+     * Leaves the files of the spilled runs in place when this Sorter and its iterators are
+     * destroyed, instead of deleting them.
+     */
+    virtual void keepSpilledRuns() = 0;
+
     virtual ~Sorter() {}
 
     // TEMP these are here for compatibility. Will be replaced with a general stats API
@@ -178,10 +220,18 @@ public:
     }
     virtual int numFiles() const = 0;
     virtual size_t memUsed() const = 0;
+    unsigned long long bytesSpilled() const {
+        return _bytesSpilled;
+    }
+    size_t numRunsDiscarded() const {
+        return _numRunsDiscarded;
+    }
 
 protected:
-    bool _usedDisk{false};  // Keeps track of whether the sorter used disk or not
-    Sorter() {}             // can only be constructed as a base
+    bool _usedDisk{false};                // Keeps track of whether the sorter used disk or not
+    unsigned long long _bytesSpilled{0};  // Bytes written to all spilled runs
+    size_t _numRunsDiscarded{0};          // Spilled runs dropped as unable to affect the result
+    Sorter() {}                           // can only be constructed as a base
 };
 
 /// Writes pre-sorted data to a sorted file and hands-back an Iterator over that file.
@@ -200,6 +250,21 @@ public:
     void addAlreadySorted(const Key&, const Value&);
     Iterator* done();  /// Can't add more data after calling done()
 
+    const std::string& fileName() const {
+        return _fileName;
+    }
+
+    /// Deletes the file once neither this nor the Iterator returned by done() refers to it.
+    const std::shared_ptr<sorter::FileDeleter>& fileDeleter() const {
+        return _fileDeleter;
+    }
+
+    /// The number of bytes written to the file so far, including everything done() writes once
+    /// it has been called.
+    unsigned long long bytesWritten() const {
+        return _bytesWritten;
+    }
+
 private:
     void spill();
 
@@ -208,6 +273,8 @@ private:
     std::shared_ptr<sorter::FileDeleter> _fileDeleter;  // Must outlive _file
     std::ofstream _file;
     BufBuilder _buffer;
+    unsigned long long _bytesWritten = 0;
+    const size_t _readAheadBytes;
 };
 }
 
@@ -234,4 +301,10 @@ private:
             const SortOptions& opts,                                                     \
             const Comparator& comp);                                                     \
     template ::mongo::Sorter<Key, Value>* ::mongo::Sorter<Key, Value>::make<Comparator>( \
-        const SortOptions& opts, const Comparator& comp, const Settings& settings);
+        const SortOptions& opts, const Comparator& comp, const Settings& settings);      \
+    template ::mongo::Sorter<Key, Value>*                                                \
+    ::mongo::Sorter<Key, Value>::makeFromSpilledRuns<Comparator>(                        \
+        const std::vector<std::string>& runFileNames,                                    \
+        const SortOptions& opts,                                                         \
+        const Comparator& comp,                                                          \
+        const Settings& settings);
@@ -269,6 +269,29 @@ public:
 };
 
 
+// Abandoning a file read ahead in the background, part way through or before reading it at all,
+// must stop its reader thread and remove the file.
+class FileIteratorAbandonedDuringReadAhead : public ScopedGlobalServiceContextForTest {
+public:
+    void run() {
+        unittest::TempDir tempDir("fileIteratorAbandonedDuringReadAhead");
+        const SortOptions opts = SortOptions().TempDir(tempDir.path()).ReadAheadBytes(1000);
+        for (int toRead : {0, 1, 5000}) {
+            SortedFileWriter<IntWrapper, IntWrapper> sorter(opts);
+            for (int i = 0; i < 100 * 1000; i++)
+                sorter.addAlreadySorted(i, -i);
+
+            std::unique_ptr<IWIterator> it(sorter.done());
+            for (int i = 0; i < toRead; i++) {
+                ASSERT(it->more());
+                ASSERT_EQ(it->next().first, i);
+            }
+        }
+
+        ASSERT(boost::filesystem::is_empty(tempDir.path()));
+    }
+};
+
 class MergeIteratorTests {
 public:
     void run() {
@@ -534,6 +557,101 @@ class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     }
     enum { MEM_LIMIT = 32 * 1024 };
 };
+
+// Sorts each spilled run on several threads, and reads the runs back in chunks smaller than their
+// blocks so that blocks straddle chunk boundaries.
+template <bool Random = true>
+class ParallelRunsWithReadAhead : public LotsOfDataLittleMemory<Random> {
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return opts.MaxMemoryUsageBytes(1024 * 1024)
+            .ExtSortAllowed()
+            .Parallelism(4)
+            .ReadAheadBytes(10 * 1000);
+    }
+};
+
+// Input sorted in the wrong direction produces the best values last, so each new cutoff leaves
+// the runs spilled before it unable to contribute anything.
+class LimitDiscardsRunsWorseThanCutoff : public ScopedGlobalServiceContextForTest {
+public:
+    void run() {
+        unittest::TempDir tempDir("sorterTests");
+        const SortOptions opts = SortOptions()
+                                     .TempDir(tempDir.path())
+                                     .MaxMemoryUsageBytes(MEM_LIMIT)
+                                     .ExtSortAllowed()
+                                     .Limit(LIMIT);
+
+        {
+            std::shared_ptr<IWSorter> sorter(IWSorter::make(opts, IWComparator(ASC)));
+            for (int i = NUM_ITEMS - 1; i >= 0; i--)
+                sorter->add(i, -i);
+
+            std::shared_ptr<IWIterator> done(sorter->done());
+            ASSERT(sorter->usedDisk());
+            ASSERT_GREATER_THAN(sorter->bytesSpilled(), 0ULL);
+            ASSERT_GREATER_THAN(sorter->numRunsDiscarded(), 0UL);
+            ASSERT_LESS_THAN(static_cast<size_t>(sorter->numFiles()),
+                             (NUM_ITEMS * sizeof(IWPair)) / MEM_LIMIT);
+            ASSERT_ITERATORS_EQUIVALENT(done, make_shared<IntIterator>(0, LIMIT));
+        }
+
+        ASSERT(boost::filesystem::is_empty(tempDir.path()));
+    }
+
+    enum Constants {
+        NUM_ITEMS = 100 * 1000,
+        LIMIT = 5000,
+        MEM_LIMIT = 32 * 1024,
+    };
+};
+
+// The runs persisted by one Sorter, which is then destroyed with its data left in place, are
+// picked up by a new Sorter which goes on to sort the rest of the data.
+class ResumeFromSpilledRuns : public ScopedGlobalServiceContextForTest {
+public:
+    void run() {
+        unittest::TempDir tempDir("sorterTests");
+        const SortOptions opts =
+            SortOptions().TempDir(tempDir.path()).MaxMemoryUsageBytes(MEM_LIMIT).ExtSortAllowed();
+
+        // Every other value goes to the first Sorter, including some held in memory when its runs
+        // are persisted.
+        std::vector<std::string> runFileNames;
+        {
+            std::unique_ptr<IWSorter> sorter(IWSorter::make(opts, IWComparator(ASC)));
+            for (int i = 0; i < NUM_ITEMS; i += 2)
+                sorter->add(i, -i);
+            runFileNames = sorter->persistSpilledRuns();
+            ASSERT_GREATER_THAN(runFileNames.size(), 1UL);
+
+            // Values added after the runs were persisted are lost along with the Sorter.
+            sorter->add(NUM_ITEMS, -NUM_ITEMS);
+            sorter->keepSpilledRuns();
+        }
+
+        for (const auto& fileName : runFileNames) {
+            ASSERT(boost::filesystem::exists(fileName));
+        }
+
+        {
+            std::unique_ptr<IWSorter> sorter(
+                IWSorter::makeFromSpilledRuns(runFileNames, opts, IWComparator(ASC)));
+            for (int i = 1; i < NUM_ITEMS; i += 2)
+                sorter->add(i, -i);
+
+            std::shared_ptr<IWIterator> done(sorter->done());
+            ASSERT_ITERATORS_EQUIVALENT(done, make_shared<IntIterator>(0, NUM_ITEMS));
+        }
+
+        ASSERT(boost::filesystem::is_empty(tempDir.path()));
+    }
+
+    enum Constants {
+        NUM_ITEMS = 100 * 1000,
+        MEM_LIMIT = 32 * 1024,
+    };
+};
 }
 
 class SorterSuite : public mongo::unittest::Suite {
@@ -543,6 +661,7 @@ public:
     void setupTests() {
         add<InMemIterTests>();
         add<SortedFileWriterAndFileIteratorTests>();
+        add<FileIteratorAbandonedDuringReadAhead>();
         add<MergeIteratorTests>();
         add<SorterTests::Basic>();
         add<SorterTests::Limit>();
@@ -555,6 +674,10 @@ public:
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/true>>();    // fits in mem
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/false>>();  // spills
         add<SorterTests::LotsOfDataWithLimit<5000, /*random=*/true>>();   // spills
+        add<SorterTests::LimitDiscardsRunsWorseThanCutoff>();
+        add<SorterTests::ResumeFromSpilledRuns>();
+        add<SorterTests::ParallelRunsWithReadAhead</*random=*/false>>();
+        add<SorterTests::ParallelRunsWithReadAhead</*random=*/true>>();
     }
 };
 
@@ -34,10 +34,29 @@
 
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/namespace_string.h"
-#include "mongo/platform/bits.h"
+#include "mongo/db/server_parameters.h"
 
 namespace mongo {
 
+namespace {
+
+// The number of significant decimal digits to which the log-linear buckets resolve a latency, see
+// LogLinearHistogram.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(latencyHistogramSignificantDigits, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > 3) {
+            return Status(ErrorCodes::BadValue,
+                          "latencyHistogramSignificantDigits must be between 1 and 3");
+        }
+        return Status::OK();
+    });
+
+}  // namespace
+
+int OperationLatencyHistogram::_getSignificantDigits() {
+    return latencyHistogramSignificantDigits;
+}
+
 const std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets>
     OperationLatencyHistogram::kLowerBounds = {0,
                                                2,
@@ -111,6 +130,16 @@ void OperationLatencyHistogram::_append(const HistogramData& data,
     }
     histogramBuilder.append("latency", static_cast<long long>(data.sum));
     histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
+    if (_trackPercentiles && data.entryCount > 0) {
+        BSONObjBuilder percentilesBuilder(histogramBuilder.subobjStart("percentiles"));
+        const auto& fine = data.fineBuckets;
+        percentilesBuilder.append("p50", static_cast<long long>(fine.getPercentile(50)));
+        percentilesBuilder.append("p90", static_cast<long long>(fine.getPercentile(90)));
+        percentilesBuilder.append("p99", static_cast<long long>(fine.getPercentile(99)));
+        percentilesBuilder.append("p999", static_cast<long long>(fine.getPercentile(99.9)));
+        percentilesBuilder.append("max", static_cast<long long>(data.max));
+        percentilesBuilder.doneFast();
+    }
     histogramBuilder.doneFast();
 }
 
@@ -148,10 +177,36 @@ int OperationLatencyHistogram::_getBucket(uint64_t value) {
     }
 }
 
+const OperationLatencyHistogram::HistogramData& OperationLatencyHistogram::_getData(
+    Command::ReadWriteType type) const {
+    switch (type) {
+        case Command::ReadWriteType::kRead:
+            return _reads;
+        case Command::ReadWriteType::kWrite:
+            return _writes;
+        case Command::ReadWriteType::kCommand:
+            return _commands;
+        case Command::ReadWriteType::kTransaction:
+            return _transactions;
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+uint64_t OperationLatencyHistogram::getPercentile(double percentile,
+                                                  Command::ReadWriteType type) const {
+    return _getData(type).fineBuckets.getPercentile(percentile);
+}
+
 void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, HistogramData* data) {
     data->buckets[bucket]++;
     data->entryCount++;
     data->sum += latency;
+    data->max = std::max(data->max, latency);
+
+    if (_trackPercentiles) {
+        data->fineBuckets.increment(latency);
+    }
 }
 
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
@@ -174,4 +229,24 @@ void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteTy
     }
 }
 
+void OperationLatencyHistogram::_mergeData(const HistogramData& from, HistogramData* into) {
+    for (int i = 0; i < kMaxBuckets; i++) {
+        into->buckets[i] += from.buckets[i];
+    }
+    into->entryCount += from.entryCount;
+    into->sum += from.sum;
+    into->max = std::max(into->max, from.max);
+
+    if (_trackPercentiles) {
+        into->fineBuckets.merge(from.fineBuckets);
+    }
+}
+
+void OperationLatencyHistogram::merge(const OperationLatencyHistogram& other) {
+    _mergeData(other._reads, &_reads);
+    _mergeData(other._writes, &_writes);
+    _mergeData(other._commands, &_commands);
+    _mergeData(other._transactions, &_transactions);
+}
+
 }  // namespace mongo
@@ -30,6 +30,7 @@
 #include <array>
 
 #include "mongo/db/commands.h"
+#include "mongo/util/log_linear_histogram.h"
 
 namespace mongo {
 
@@ -39,6 +40,12 @@ class BSONObjBuilder;
  * Stores statistics for latencies of read, write, command, and multi-document transaction
  * operations.
  *
+ * If constructed with 'trackPercentiles', latencies are also counted in log-linear buckets whose
+ * resolution is set at startup by the 'latencyHistogramSignificantDigits' server parameter, from
+ * which percentiles are computed. These buckets take up to hundreds of kilobytes per operation
+ * type, so only the server-wide histograms track them, rather than the per-collection ones. They
+ * are allocated the first time a latency of the corresponding operation type is recorded.
+ *
  * Note: This class is not thread-safe.
  */
 class OperationLatencyHistogram {
@@ -48,25 +55,51 @@ public:
     // Inclusive lower bounds of the histogram buckets.
     static const std::array<uint64_t, kMaxBuckets> kLowerBounds;
 
+    explicit OperationLatencyHistogram(bool trackPercentiles = false)
+        : _trackPercentiles(trackPercentiles) {}
+
     /**
      * Increments the bucket of the histogram based on the operation type.
      */
     void increment(uint64_t latency, Command::ReadWriteType type);
 
     /**
-     * Appends the four histograms with latency totals and operation counts.
+     * Adds the counts and latency totals of 'other' to this histogram, and its percentile buckets
+     * if both track percentiles.
+     */
+    void merge(const OperationLatencyHistogram& other);
+
+    /**
+     * Appends the four histograms with latency totals, operation counts and, if tracked,
+     * percentiles.
      */
     void append(bool includeHistograms, BSONObjBuilder* builder) const;
 
+    /**
+     * Returns the smallest latency such that at least 'percentile' percent of the operations of
+     * 'type' took no longer than it, within the resolution of the log-linear buckets. Returns 0 if
+     * no operation of 'type' has been recorded or percentiles are not tracked.
+     */
+    uint64_t getPercentile(double percentile, Command::ReadWriteType type) const;
+
 private:
     struct HistogramData {
         std::array<uint64_t, kMaxBuckets> buckets{};
         uint64_t entryCount = 0;
         uint64_t sum = 0;
+        uint64_t max = 0;
+
+        // The log-linear buckets, not allocated until the first latency is recorded, and never if
+        // percentiles are not tracked.
+        LogLinearHistogram fineBuckets{_getSignificantDigits()};
     };
 
     static int _getBucket(uint64_t latency);
 
+    static int _getSignificantDigits();
+
+    const HistogramData& _getData(Command::ReadWriteType type) const;
+
     static uint64_t _getBucketMicros(int bucket);
 
     void _append(const HistogramData& data,
@@ -76,6 +109,10 @@ private:
 
     void _incrementData(uint64_t latency, int bucket, HistogramData* data);
 
+    void _mergeData(const HistogramData& from, HistogramData* into);
+
+    bool _trackPercentiles;
+
     HistogramData _reads, _writes, _commands, _transactions;
 };
 }  // namespace mongo
@@ -91,4 +91,93 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, MergeAddsCounts) {
+    OperationLatencyHistogram hist, other, expected;
+    for (int i = 0; i < kMaxBuckets; i++) {
+        hist.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        other.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        other.increment(kLowerBounds[i], Command::ReadWriteType::kTransaction);
+        expected.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        expected.increment(kLowerBounds[i], Command::ReadWriteType::kRead);
+        expected.increment(kLowerBounds[i], Command::ReadWriteType::kTransaction);
+    }
+    hist.merge(other);
+
+    BSONObjBuilder outBuilder, expectedBuilder;
+    hist.append(true, &outBuilder);
+    expected.append(true, &expectedBuilder);
+    ASSERT_BSONOBJ_EQ(outBuilder.obj(), expectedBuilder.obj());
+}
+
+TEST(OperationLatencyHistogram, PercentilesAreWithinTenPercent) {
+    OperationLatencyHistogram hist(/*trackPercentiles=*/true);
+    ASSERT_EQUALS(hist.getPercentile(50, Command::ReadWriteType::kRead), 0U);
+
+    // One operation of each latency from 1us to 100000us.
+    for (uint64_t latency = 1; latency <= 100000; latency++) {
+        hist.increment(latency, Command::ReadWriteType::kRead);
+    }
+    for (double percentile : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+        const double exact = percentile * 1000;
+        const auto estimate =
+            static_cast<double>(hist.getPercentile(percentile, Command::ReadWriteType::kRead));
+        ASSERT_GTE(estimate, exact);
+        ASSERT_LTE(estimate, exact * 1.1);
+    }
+    ASSERT_EQUALS(hist.getPercentile(100, Command::ReadWriteType::kRead), 100000U);
+    ASSERT_EQUALS(hist.getPercentile(50, Command::ReadWriteType::kWrite), 0U);
+
+    BSONObjBuilder outBuilder;
+    hist.append(false, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["percentiles"]["p99"].Long(),
+                  static_cast<long long>(hist.getPercentile(99, Command::ReadWriteType::kRead)));
+    ASSERT_EQUALS(out["reads"]["percentiles"]["max"].Long(), 100000);
+    ASSERT_FALSE(out["writes"].Obj().hasField("percentiles"));
+}
+
+TEST(OperationLatencyHistogram, PercentilesOfOutliersAreExact) {
+    OperationLatencyHistogram hist(/*trackPercentiles=*/true);
+    for (int i = 0; i < 999; i++) {
+        hist.increment(100, Command::ReadWriteType::kCommand);
+    }
+    hist.increment(5000000, Command::ReadWriteType::kCommand);
+
+    ASSERT_LTE(hist.getPercentile(99, Command::ReadWriteType::kCommand), 110U);
+    ASSERT_EQUALS(hist.getPercentile(99.95, Command::ReadWriteType::kCommand), 5000000U);
+}
+
+TEST(OperationLatencyHistogram, MergeCombinesPercentiles) {
+    OperationLatencyHistogram fast(/*trackPercentiles=*/true), slow(/*trackPercentiles=*/true);
+    for (int i = 0; i < 50; i++) {
+        fast.increment(10, Command::ReadWriteType::kRead);
+        slow.increment(1000, Command::ReadWriteType::kRead);
+    }
+
+    OperationLatencyHistogram merged(/*trackPercentiles=*/true);
+    merged.merge(fast);
+    merged.merge(slow);
+    ASSERT_EQUALS(merged.getPercentile(50, Command::ReadWriteType::kRead), 10U);
+    ASSERT_EQUALS(merged.getPercentile(51, Command::ReadWriteType::kRead), 1000U);
+}
+
+TEST(OperationLatencyHistogram, PercentilesAreOnlyTrackedIfAskedFor) {
+    OperationLatencyHistogram hist;
+    for (uint64_t latency = 1; latency <= 1000; latency++) {
+        hist.increment(latency, Command::ReadWriteType::kRead);
+    }
+    ASSERT_EQUALS(hist.getPercentile(50, Command::ReadWriteType::kRead), 0U);
+
+    BSONObjBuilder outBuilder;
+    hist.append(false, &outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 1000);
+    ASSERT_FALSE(out["reads"].Obj().hasField("percentiles"));
+
+    // Merging into a histogram which tracks percentiles adds nothing to them.
+    OperationLatencyHistogram merged(/*trackPercentiles=*/true);
+    merged.merge(hist);
+    ASSERT_EQUALS(merged.getPercentile(50, Command::ReadWriteType::kRead), 0U);
+}
 }  // namespace mongo
@@ -0,0 +1,199 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/query_stats_store.h"
+
+#include "mongo/base/simple_string_data_comparator.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryStatsStore = ServiceContext::declareDecoration<QueryStatsStore>();
+
+// The maximum number of query shapes the store keeps across all of its partitions. Zero turns
+// recording off.
+MONGO_EXPORT_SERVER_PARAMETER(queryStatsMaxShapes, int, 5000)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue, "queryStatsMaxShapes must not be negative");
+        }
+        return Status::OK();
+    });
+
+size_t latencyBucket(long long durationMicros) {
+    if (durationMicros <= 0) {
+        return 0;
+    }
+    const size_t bucket = 64 - countLeadingZeros64(static_cast<unsigned long long>(durationMicros));
+    return std::min(bucket, QueryStatsStore::kNumLatencyBuckets - 1);
+}
+
+}  // namespace
+
+void QueryStatsStore::ShapeStats::add(const Sample& sample, Date_t now) {
+    if (count == 0) {
+        firstSeen = now;
+    }
+    lastSeen = now;
+
+    ++count;
+    totalDurationMicros += sample.durationMicros;
+    maxDurationMicros = std::max(maxDurationMicros, sample.durationMicros);
+    docsExamined += sample.docsExamined;
+    keysExamined += sample.keysExamined;
+    nreturned += sample.nreturned;
+    bytesReturned += sample.bytesReturned;
+    ++latencyBuckets[latencyBucket(sample.durationMicros)];
+}
+
+long long QueryStatsStore::ShapeStats::latencyPercentileMicros(double percentile) const {
+    if (count == 0) {
+        return 0;
+    }
+
+    const long long rank = std::max(1LL, static_cast<long long>(count * percentile / 100 + 0.5));
+    long long seen = 0;
+    for (size_t bucket = 0; bucket < kNumLatencyBuckets; ++bucket) {
+        seen += latencyBuckets[bucket];
+        if (seen >= rank) {
+            // Bucket 'b' holds latencies below 2^b microseconds.
+            return bucket == kNumLatencyBuckets - 1
+                ? maxDurationMicros
+                : std::min((1LL << bucket) - 1, maxDurationMicros);
+        }
+    }
+    return maxDurationMicros;
+}
+
+size_t QueryStatsStore::KeyHasher::operator()(const Key& key) const {
+    size_t hash = SimpleStringDataComparator::kInstance.hash(key.ns);
+    return hash ^ (static_cast<size_t>(key.queryHash) * 0x9E3779B97F4A7C15ULL);
+}
+
+QueryStatsStore& QueryStatsStore::get(ServiceContext* service) {
+    return getQueryStatsStore(service);
+}
+
+QueryStatsStore::QueryStatsStore() : _partitions(kNumPartitions) {}
+
+void QueryStatsStore::record(StringData ns,
+                             uint32_t queryHash,
+                             StringData planSummary,
+                             const Sample& sample) {
+    const size_t maxShapes = static_cast<size_t>(queryStatsMaxShapes.load());
+    if (maxShapes == 0) {
+        return;
+    }
+    const size_t maxShapesPerPartition = std::max<size_t>(1, maxShapes / kNumPartitions);
+
+    Key key{ns.toString(), queryHash};
+    Partition& partition = _partitions[KeyHasher()(key) % kNumPartitions];
+    const Date_t now = Date_t::now();
+
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.index.find(key);
+    if (it != partition.index.end()) {
+        partition.shapes.splice(partition.shapes.begin(), partition.shapes, it->second);
+    } else {
+        while (partition.shapes.size() >= maxShapesPerPartition) {
+            partition.index.erase(partition.shapes.back().first);
+            partition.shapes.pop_back();
+        }
+        partition.shapes.emplace_front(key, ShapeStats());
+        partition.index.emplace(std::move(key), partition.shapes.begin());
+    }
+
+    ShapeStats& stats = partition.shapes.front().second;
+    if (stats.planSummary != planSummary) {
+        stats.planSummary = planSummary.toString();
+    }
+    stats.add(sample, now);
+}
+
+std::vector<BSONObj> QueryStatsStore::getStats(StringData ns) const {
+    std::vector<BSONObj> results;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        for (const auto& shape : partition.shapes) {
+            if (shape.first.ns != ns) {
+                continue;
+            }
+
+            const ShapeStats& stats = shape.second;
+            BSONObjBuilder out;
+            out.append("ns", shape.first.ns);
+            out.append("queryHash", unsignedIntToFixedLengthHex(shape.first.queryHash));
+            out.append("planSummary", stats.planSummary);
+            out.appendNumber("count", stats.count);
+            {
+                BSONObjBuilder latency(out.subobjStart("durationMicros"));
+                latency.appendNumber("total", stats.totalDurationMicros);
+                latency.appendNumber("max", stats.maxDurationMicros);
+                latency.appendNumber("p50", stats.latencyPercentileMicros(50));
+                latency.appendNumber("p95", stats.latencyPercentileMicros(95));
+                latency.appendNumber("p99", stats.latencyPercentileMicros(99));
+            }
+            out.appendNumber("docsExamined", stats.docsExamined);
+            out.appendNumber("keysExamined", stats.keysExamined);
+            out.appendNumber("nreturned", stats.nreturned);
+            out.appendNumber("bytesReturned", stats.bytesReturned);
+            out.appendDate("firstSeen", stats.firstSeen);
+            out.appendDate("lastSeen", stats.lastSeen);
+            results.push_back(out.obj());
+        }
+    }
+    return results;
+}
+
+size_t QueryStatsStore::size() const {
+    size_t size = 0;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        size += partition.shapes.size();
+    }
+    return size;
+}
+
+void QueryStatsStore::clear() {
+    for (auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        partition.index.clear();
+        partition.shapes.clear();
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,163 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/with_alignment.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+/**
+ * Aggregates the execution statistics of completed operations per query shape, where a shape is
+ * identified by its namespace and the plan cache query hash of its canonical query.
+ *
+ * The store is bounded by the 'queryStatsMaxShapes' server parameter. Shapes are spread over
+ * partitions by hash, each with its own lock, so that recording an operation only contends with
+ * operations of shapes in the same partition. A full partition evicts its least recently recorded
+ * shape to make room for a new one.
+ */
+class QueryStatsStore {
+    MONGO_DISALLOW_COPYING(QueryStatsStore);
+
+public:
+    static const size_t kNumPartitions = 16;
+
+    // Latencies are bucketed by powers of two microseconds; the last bucket is unbounded.
+    static const size_t kNumLatencyBuckets = 32;
+
+    /**
+     * The statistics of one completed execution of a query shape.
+     */
+    struct Sample {
+        long long durationMicros = 0;
+        long long docsExamined = 0;
+        long long keysExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+    };
+
+    /**
+     * The statistics of every recorded execution of a query shape.
+     */
+    struct ShapeStats {
+        void add(const Sample& sample, Date_t now);
+
+        /**
+         * Returns an upper bound on the latency within which 'percentile' percent of the recorded
+         * executions completed. The bound is exact only up to the bucket granularity.
+         */
+        long long latencyPercentileMicros(double percentile) const;
+
+        std::string planSummary;
+        long long count = 0;
+        long long totalDurationMicros = 0;
+        long long maxDurationMicros = 0;
+        long long docsExamined = 0;
+        long long keysExamined = 0;
+        long long nreturned = 0;
+        long long bytesReturned = 0;
+        std::array<long long, kNumLatencyBuckets> latencyBuckets{};
+        Date_t firstSeen;
+        Date_t lastSeen;
+    };
+
+    static QueryStatsStore& get(ServiceContext* service);
+
+    QueryStatsStore();
+
+    /**
+     * Adds 'sample' to the statistics of the shape with 'queryHash' on namespace 'ns', creating the
+     * shape if this is its first execution. 'planSummary' replaces the shape's previous summary,
+     * so that the statistics show the plan most recently used.
+     *
+     * Does nothing if the server parameter 'queryStatsMaxShapes' is zero.
+     */
+    void record(StringData ns, uint32_t queryHash, StringData planSummary, const Sample& sample);
+
+    /**
+     * Returns one document per shape recorded on namespace 'ns'.
+     */
+    std::vector<BSONObj> getStats(StringData ns) const;
+
+    /**
+     * Returns the number of shapes in the store.
+     */
+    size_t size() const;
+
+    /**
+     * Removes every shape from the store.
+     */
+    void clear();
+
+private:
+    struct Key {
+        bool operator==(const Key& other) const {
+            return queryHash == other.queryHash && ns == other.ns;
+        }
+
+        std::string ns;
+        uint32_t queryHash;
+    };
+
+    struct KeyHasher {
+        size_t operator()(const Key& key) const;
+    };
+
+    using ShapeList = std::list<std::pair<Key, ShapeStats>>;
+
+    struct Partition {
+        mutable stdx::mutex mutex;
+
+        // Ordered from most to least recently recorded.
+        ShapeList shapes;
+        stdx::unordered_map<Key, ShapeList::iterator, KeyHasher> index;
+    };
+
+    template <typename T>
+    using AlignedVector = std::vector<T, boost::alignment::aligned_allocator<T>>;
+
+    AlignedVector<CacheAligned<Partition>> _partitions;
+};
+
+}  // namespace mongo
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/query_stats_store.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Sets the 'queryStatsMaxShapes' server parameter for the lifetime of the object.
+ */
+class MaxShapesGuard {
+public:
+    explicit MaxShapesGuard(int maxShapes)
+        : _param(ServerParameterSet::getGlobal()->getMap().at("queryStatsMaxShapes")) {
+        BSONObjBuilder original;
+        _param->append(nullptr, original, "value");
+        _original = original.obj()["value"].numberInt();
+        ASSERT_OK(_param->setFromString(std::to_string(maxShapes)));
+    }
+
+    ~MaxShapesGuard() {
+        ASSERT_OK(_param->setFromString(std::to_string(_original)));
+    }
+
+private:
+    ServerParameter* const _param;
+    int _original;
+};
+
+QueryStatsStore::Sample makeSample(long long durationMicros) {
+    QueryStatsStore::Sample sample;
+    sample.durationMicros = durationMicros;
+    sample.docsExamined = 10;
+    sample.keysExamined = 5;
+    sample.nreturned = 2;
+    sample.bytesReturned = 100;
+    return sample;
+}
+
+TEST(QueryStatsStoreTest, AggregatesExecutionsOfTheSameShape) {
+    QueryStatsStore store;
+    store.record("db.coll", 0x1234, "COLLSCAN", makeSample(10));
+    store.record("db.coll", 0x1234, "IXSCAN { a: 1 }", makeSample(30));
+
+    auto stats = store.getStats("db.coll");
+    ASSERT_EQ(1u, stats.size());
+    ASSERT_EQ("db.coll", stats[0]["ns"].str());
+    ASSERT_EQ("00001234", stats[0]["queryHash"].str());
+    ASSERT_EQ("IXSCAN { a: 1 }", stats[0]["planSummary"].str());
+    ASSERT_EQ(2, stats[0]["count"].numberLong());
+    ASSERT_EQ(40, stats[0]["durationMicros"]["total"].numberLong());
+    ASSERT_EQ(30, stats[0]["durationMicros"]["max"].numberLong());
+    ASSERT_EQ(20, stats[0]["docsExamined"].numberLong());
+    ASSERT_EQ(10, stats[0]["keysExamined"].numberLong());
+    ASSERT_EQ(4, stats[0]["nreturned"].numberLong());
+    ASSERT_EQ(200, stats[0]["bytesReturned"].numberLong());
+    ASSERT_LTE(stats[0]["firstSeen"].date(), stats[0]["lastSeen"].date());
+}
+
+TEST(QueryStatsStoreTest, KeepsShapesOfEachNamespaceApart) {
+    QueryStatsStore store;
+    store.record("db.a", 1, "COLLSCAN", makeSample(1));
+    store.record("db.a", 2, "COLLSCAN", makeSample(1));
+    store.record("db.b", 1, "COLLSCAN", makeSample(1));
+
+    ASSERT_EQ(3u, store.size());
+    ASSERT_EQ(2u, store.getStats("db.a").size());
+    ASSERT_EQ(1u, store.getStats("db.b").size());
+    ASSERT_EQ(0u, store.getStats("db.c").size());
+
+    store.clear();
+    ASSERT_EQ(0u, store.size());
+}
+
+TEST(QueryStatsStoreTest, LatencyPercentilesAreBoundedByBucket) {
+    QueryStatsStore::ShapeStats stats;
+    const Date_t now = Date_t::now();
+    for (int i = 0; i < 98; ++i) {
+        stats.add(makeSample(100), now);
+    }
+    stats.add(makeSample(5000), now);
+    stats.add(makeSample(100000), now);
+
+    // 100us falls in the bucket of latencies below 128us.
+    ASSERT_EQ(127, stats.latencyPercentileMicros(50));
+    ASSERT_EQ(127, stats.latencyPercentileMicros(95));
+    ASSERT_EQ(8191, stats.latencyPercentileMicros(99));
+    ASSERT_EQ(100000, stats.latencyPercentileMicros(100));
+    ASSERT_EQ(0, QueryStatsStore::ShapeStats().latencyPercentileMicros(50));
+}
+
+TEST(QueryStatsStoreTest, EvictsLeastRecentlyRecordedShapes) {
+    MaxShapesGuard guard(QueryStatsStore::kNumPartitions);
+    QueryStatsStore store;
+    const uint32_t kNumShapes = 20 * QueryStatsStore::kNumPartitions;
+    for (uint32_t hash = 0; hash < kNumShapes; ++hash) {
+        store.record("db.coll", hash, "COLLSCAN", makeSample(1));
+    }
+    // Each partition holds at most one shape.
+    ASSERT_LTE(store.size(), QueryStatsStore::kNumPartitions);
+
+    // The last shape recorded is always resident since it evicted everything older in its
+    // partition.
+    bool foundLast = false;
+    for (auto&& shape : store.getStats("db.coll")) {
+        foundLast = foundLast || shape["queryHash"].str() == "0000013F";
+    }
+    ASSERT(foundLast);
+}
+
+TEST(QueryStatsStoreTest, RecordsNothingWhenMaxShapesIsZero) {
+    MaxShapesGuard guard(0);
+    QueryStatsStore store;
+    store.record("db.coll", 1, "COLLSCAN", makeSample(1));
+    ASSERT_EQ(0u, store.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/service_context.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -67,11 +68,36 @@ Top::CollectionData::CollectionData(const CollectionData& older, const Collectio
       remove(older.remove, newer.remove),
       commands(older.commands, newer.commands) {}
 
+Top::Top() : _partitions(kNumPartitions), _globalHistogramStats(kNumPartitions) {}
+
 // static
 Top& Top::get(ServiceContext* service) {
     return getTop(service);
 }
 
+Top::Partition& Top::_getPartition(const UsageMap::HashedKey& hashedNs) {
+    return _partitions[hashedNs.hash() % kNumPartitions];
+}
+
+Top::HistogramPartition& Top::_getGlobalHistogramPartition() {
+    // Operations are spread over the partitions by the thread that runs them, so that a thread
+    // keeps hitting the same, usually uncontended, partition.
+    const auto threadHash = std::hash<stdx::thread::id>()(stdx::this_thread::get_id());
+    return _globalHistogramStats[threadHash % kNumPartitions];
+}
+
+Top::UsageMap Top::_mergeUsage() const {
+    // Each namespace lives in exactly one partition, so merging is a plain union.
+    UsageMap merged;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.lock);
+        for (const auto& entry : partition.usage) {
+            merged[entry.first] = entry.second;
+        }
+    }
+    return merged;
+}
+
 void Top::record(OperationContext* opCtx,
                  StringData ns,
                  LogicalOp logicalOp,
@@ -83,15 +109,16 @@ void Top::record(OperationContext* opCtx,
         return;
 
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    auto& partition = _getPartition(hashedNs);
+    stdx::lock_guard<SimpleMutex> lk(partition.lock);
 
-    if ((command || logicalOp == LogicalOp::opQuery) &&
-        _collDropNs.find(ns.toString()) != _collDropNs.end()) {
-        _collDropNs.erase(ns.toString());
+    if ((command || logicalOp == LogicalOp::opQuery) && !partition.collDropNs.empty() &&
+        partition.collDropNs.find(ns.toString()) != partition.collDropNs.end()) {
+        partition.collDropNs.erase(ns.toString());
         return;
     }
 
-    CollectionData& coll = _usage[hashedNs];
+    CollectionData& coll = partition.usage[hashedNs];
     _record(opCtx, coll, logicalOp, lockType, micros, readWriteType);
 }
 
@@ -141,24 +168,24 @@ void Top::_record(OperationContext* opCtx,
 }
 
 void Top::collectionDropped(StringData ns, bool databaseDropped) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
+    auto hashedNs = UsageMap::HashedKey(ns);
+    auto& partition = _getPartition(hashedNs);
+    stdx::lock_guard<SimpleMutex> lk(partition.lock);
+    partition.usage.erase(hashedNs);
 
     if (!databaseDropped) {
         // If a collection drop occurred, there will be a subsequent call to record for this
         // collection namespace which must be ignored. This does not apply to a database drop.
-        _collDropNs.insert(ns.toString());
+        partition.collDropNs.insert(ns.toString());
     }
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    out = _usage;
+    out = _mergeUsage();
 }
 
 void Top::append(BSONObjBuilder& b) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _appendToUsageMap(b, _usage);
+    _appendToUsageMap(b, _mergeUsage());
 }
 
 void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
@@ -201,9 +228,13 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
 
 void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
+    auto& partition = _getPartition(hashedNs);
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(includeHistograms, &latencyStatsBuilder);
+    {
+        stdx::lock_guard<SimpleMutex> lk(partition.lock);
+        partition.usage[hashedNs].opLatencyHistogram.append(includeHistograms,
+                                                           &latencyStatsBuilder);
+    }
     builder->append("ns", ns);
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
@@ -211,18 +242,24 @@ void Top::appendLatencyStats(StringData ns, bool includeHistograms, BSONObjBuild
 void Top::incrementGlobalLatencyStats(OperationContext* opCtx,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(opCtx, latency, &_globalHistogramStats, readWriteType);
+    auto& partition = _getGlobalHistogramPartition();
+    stdx::lock_guard<SimpleMutex> guard(partition.lock);
+    _incrementHistogram(opCtx, latency, &partition.histogram, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(includeHistograms, builder);
+    OperationLatencyHistogram merged(/*trackPercentiles=*/true);
+    for (auto& partition : _globalHistogramStats) {
+        stdx::lock_guard<SimpleMutex> guard(partition.lock);
+        merged.merge(partition.histogram);
+    }
+    merged.append(includeHistograms, builder);
 }
 
 void Top::incrementGlobalTransactionLatencyStats(uint64_t latency) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.increment(latency, Command::ReadWriteType::kTransaction);
+    auto& partition = _getGlobalHistogramPartition();
+    stdx::lock_guard<SimpleMutex> guard(partition.lock);
+    partition.histogram.increment(latency, Command::ReadWriteType::kTransaction);
 }
 
 void Top::_incrementHistogram(OperationContext* opCtx,
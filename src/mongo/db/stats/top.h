@@ -29,6 +29,11 @@
 
 #pragma once
 
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
 
 #include "mongo/db/commands.h"
@@ -36,6 +41,7 @@
 #include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
+#include "mongo/util/with_alignment.h"
 
 namespace mongo {
 
@@ -43,12 +49,17 @@ class ServiceContext;
 
 /**
  * tracks usage by collection
+ *
+ * Usage is partitioned by namespace hash and the global latency histogram by recording thread, so
+ * that concurrent operations rarely share a lock. Readers merge the partitions.
  */
 class Top {
 public:
+    static const std::size_t kNumPartitions = 16;
+
     static Top& get(ServiceContext* service);
 
-    Top() = default;
+    Top();
 
     struct UsageData {
         UsageData() : time(0), count(0) {}
@@ -145,10 +156,29 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
-    mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
-    UsageMap _usage;
-    std::set<std::string> _collDropNs;
+    struct Partition {
+        mutable SimpleMutex lock;
+        UsageMap usage;
+        std::set<std::string> collDropNs;
+    };
+
+    struct HistogramPartition {
+        SimpleMutex lock;
+        OperationLatencyHistogram histogram{/*trackPercentiles=*/true};
+    };
+
+    template <typename T>
+    using AlignedVector = std::vector<T, boost::alignment::aligned_allocator<T>>;
+
+    Partition& _getPartition(const UsageMap::HashedKey& hashedNs);
+
+    HistogramPartition& _getGlobalHistogramPartition();
+
+    // Returns a copy of the usage of all namespaces.
+    UsageMap _mergeUsage() const;
+
+    AlignedVector<CacheAligned<Partition>> _partitions;
+    AlignedVector<CacheAligned<HistogramPartition>> _globalHistogramStats;
 };
 
 }  // namespace mongo
@@ -39,4 +39,23 @@ TEST(TopTest, CollectionDropped) {
     Top().collectionDropped("coll");
 }
 
+TEST(TopTest, CloneMapMergesPartitions) {
+    Top top;
+    const int kNumCollections = 4 * Top::kNumPartitions;
+    for (int i = 0; i < kNumCollections; i++) {
+        BSONObjBuilder builder;
+        top.appendLatencyStats(str::stream() << "db.coll" << i, false, &builder);
+    }
+
+    Top::UsageMap usage;
+    top.cloneMap(usage);
+    ASSERT_EQ(static_cast<size_t>(kNumCollections), usage.size());
+
+    top.collectionDropped("db.coll0");
+    top.cloneMap(usage);
+    ASSERT_EQ(static_cast<size_t>(kNumCollections - 1), usage.size());
+    ASSERT(usage.find("db.coll0") == usage.end());
+    ASSERT(usage.find("db.coll1") != usage.end());
+}
+
 }  // namespace
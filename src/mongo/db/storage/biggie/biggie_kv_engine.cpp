@@ -70,18 +70,14 @@ std::unique_ptr<::mongo::RecordStore> KVEngine::getRecordStore(OperationContext*
     return std::make_unique<RecordStore>(ns, ident);
 }
 
-void KVEngine::setMaster_inlock(std::unique_ptr<StringStore> newMaster) {
-    _master.reset(newMaster.release());
+bool KVEngine::trySwapMaster(std::shared_ptr<StringStore> expected,
+                             std::shared_ptr<StringStore> newMaster) {
+    return std::atomic_compare_exchange_strong(&_master, &expected, std::move(newMaster));
 }
 
 std::shared_ptr<StringStore> KVEngine::getMaster() const {
     // TODO : later on this needs to be changed to use their copy function.
-    stdx::lock_guard<stdx::mutex> lk(_masterLock);
-    return _master;
-}
-
-std::shared_ptr<StringStore> KVEngine::getMaster_inlock() const {
-    return _master;
+    return std::atomic_load(&_master);
 }
 
 
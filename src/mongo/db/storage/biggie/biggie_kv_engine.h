@@ -29,7 +29,6 @@
 #pragma once
 
 #include <memory>
-#include <mutex>
 #include <set>
 
 #include "mongo/db/storage/biggie/biggie_record_store.h"
@@ -44,9 +43,10 @@ class JournalListener;
  * The biggie storage engine is intended for unit and performance testing.
  */
 class KVEngine : public ::mongo::KVEngine {
+    // Only accessed through the std::atomic_* functions for shared_ptr, so that committing
+    // transactions can publish a new master without taking a lock.
     std::shared_ptr<StringStore> _master = std::make_shared<StringStore>();
     std::set<StringData> _idents;  // TODO : replace with a query to _master.
-    mutable stdx::mutex _masterLock;
 
 public:
     KVEngine() : ::mongo::KVEngine() {}
@@ -133,20 +133,14 @@ public:
     // Biggie Specific
 
     /**
-     * Used to replace the master branch of the store with an updated copy.
-     * Appropriate lock must be taken externally.
+     * Replaces the master branch of the store with 'newMaster' if the master is still 'expected'.
+     * Returns false and leaves the master unchanged if another commit replaced it first, in which
+     * case the caller should merge with the new master and try again.
      */
-    // TODO: should possibly check store version numbers before setting.
-    void setMaster_inlock(std::unique_ptr<StringStore> newMaster);
+    bool trySwapMaster(std::shared_ptr<StringStore> expected,
+                       std::shared_ptr<StringStore> newMaster);
 
     std::shared_ptr<StringStore> getMaster() const;
-    std::shared_ptr<StringStore> getMaster_inlock() const;
-    /**
-     * Get the lock around the master branch.
-     */
-    stdx::mutex& getMasterLock() {
-        return _masterLock;
-    }
 
 private:
     std::shared_ptr<void> _catalogInfo;
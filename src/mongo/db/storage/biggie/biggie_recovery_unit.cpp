@@ -32,8 +32,6 @@
 
 #include "mongo/db/storage/biggie/biggie_recovery_unit.h"
 
-#include <mutex>
-
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/util/log.h"
 
@@ -46,19 +44,28 @@ RecoveryUnit::RecoveryUnit(KVEngine* parentKVEngine, stdx::function<void()> cb)
 void RecoveryUnit::beginUnitOfWork(OperationContext* opCtx) {}
 
 void RecoveryUnit::commitUnitOfWork() {
-    while (true) {
+    if (_workingCopy) {
+        // Commit optimistically: merge in whatever other transactions committed since the fork
+        // without holding any lock, then publish the result only if the master hasn't moved
+        // again in the meantime.
+        std::shared_ptr<StringStore> workingCopy = std::move(_workingCopy);
         std::shared_ptr<StringStore> master = _KVEngine->getMaster();
-        try {
-            _workingCopy->merge3(*_mergeBase, *master);
-        } catch (const merge_conflict_exception&) {
-            throw WriteConflictException();
-        }
-        stdx::lock_guard<stdx::mutex> lkOnMaster(_KVEngine->getMasterLock());
-        if (_KVEngine->getMaster_inlock() == master) {
-            _KVEngine->setMaster_inlock(std::move(_workingCopy));
-            _mergeBase.reset();
-            break;
+        while (true) {
+            if (master != _mergeBase) {
+                try {
+                    workingCopy->merge3(*_mergeBase, *master);
+                } catch (const merge_conflict_exception&) {
+                    throw WriteConflictException();
+                }
+                // The working copy now contains everything in 'master', so it is the base to
+                // merge against if the swap below loses to another commit.
+                _mergeBase = master;
+            }
+            if (_KVEngine->trySwapMaster(master, workingCopy))
+                break;
+            master = _KVEngine->getMaster();
         }
+        _mergeBase.reset();
     }
     try {
         for (Changes::iterator it = _changes.begin(), end = _changes.end(); it != end; ++it) {
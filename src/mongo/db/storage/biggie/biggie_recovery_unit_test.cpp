@@ -0,0 +1,131 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/biggie/biggie_recovery_unit.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/storage/biggie/biggie_kv_engine.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace biggie {
+namespace {
+
+void insertAndCommit(KVEngine* engine, const std::string& key) {
+    RecoveryUnit ru(engine);
+    ru.forkIfNeeded();
+    ru.getWorkingCopy()->insert(StringStore::value_type(key, "value"));
+    ru.commitUnitOfWork();
+}
+
+TEST(BiggieRecoveryUnitTest, CommitWithoutWritesLeavesMasterUnchanged) {
+    KVEngine engine;
+    auto master = engine.getMaster();
+
+    RecoveryUnit ru(&engine);
+    ru.commitUnitOfWork();
+    ASSERT(engine.getMaster() == master);
+}
+
+TEST(BiggieRecoveryUnitTest, ConcurrentTransactionsOnDifferentKeysBothCommit) {
+    KVEngine engine;
+    insertAndCommit(&engine, "a");
+    insertAndCommit(&engine, "b");
+
+    RecoveryUnit ru1(&engine);
+    RecoveryUnit ru2(&engine);
+    ru1.forkIfNeeded();
+    ru2.forkIfNeeded();
+    ru1.getWorkingCopy()->insert(StringStore::value_type("a1", "value"));
+    ru2.getWorkingCopy()->insert(StringStore::value_type("b1", "value"));
+    ru1.commitUnitOfWork();
+    ru2.commitUnitOfWork();
+
+    auto master = engine.getMaster();
+    ASSERT_EQ(master->size(), StringStore::size_type(4));
+    ASSERT(master->find("a1") != master->end());
+    ASSERT(master->find("b1") != master->end());
+}
+
+TEST(BiggieRecoveryUnitTest, ConcurrentTransactionsOnTheSameKeyConflict) {
+    KVEngine engine;
+
+    RecoveryUnit ru1(&engine);
+    RecoveryUnit ru2(&engine);
+    ru1.forkIfNeeded();
+    ru2.forkIfNeeded();
+    ru1.getWorkingCopy()->insert(StringStore::value_type("a", "1"));
+    ru2.getWorkingCopy()->insert(StringStore::value_type("a", "2"));
+    ru1.commitUnitOfWork();
+    ASSERT_THROWS(ru2.commitUnitOfWork(), WriteConflictException);
+    ru2.abortUnitOfWork();
+
+    auto master = engine.getMaster();
+    ASSERT_EQ(master->size(), StringStore::size_type(1));
+    ASSERT_EQ(master->find("a")->second, "1");
+}
+
+TEST(BiggieRecoveryUnitTest, ConcurrentCommitsFromManyThreads) {
+    const int kThreads = 4;
+    const int kCommitsPerThread = 200;
+
+    // Each thread writes under its own first byte, and that branch already exists, so commits
+    // that race never conflict and every one of them must be published, including the ones that
+    // lost the swap of the master and had to merge again.
+    KVEngine engine;
+    for (int t = 0; t < kThreads; ++t) {
+        insertAndCommit(&engine, std::string(1, 'a' + t));
+    }
+
+    std::vector<stdx::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&engine, t] {
+            for (int i = 0; i < kCommitsPerThread; ++i) {
+                insertAndCommit(&engine, std::string(1, 'a' + t) + std::to_string(i));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(engine.getMaster()->size(),
+              StringStore::size_type(kThreads * (kCommitsPerThread + 1)));
+}
+
+}  // namespace
+}  // namespace biggie
+}  // namespace mongo
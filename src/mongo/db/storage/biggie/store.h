@@ -28,7 +28,7 @@
 
 #pragma once
 
-#include <array>
+#include <algorithm>
 #include <boost/optional.hpp>
 #include <cstring>
 #include <exception>
@@ -37,6 +37,12 @@
 #include <string.h>
 #include <vector>
 
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#endif
+
+#include "mongo/platform/bits.h"
+
 namespace mongo {
 namespace biggie {
 
@@ -51,6 +57,9 @@ class merge_conflict_exception : std::exception {
  * minimize data duplication. Each node has a notion of ownership and if modifications are made to
  * non-uniquely owned nodes, they are copied to prevent dirtying the data for the other owners of
  * the node.
+ *
+ * The children of each node are stored in one of the adaptive node layouts of an Adaptive Radix
+ * Tree (see Node::Children), so sparse nodes stay small and are cheap to copy.
  */
 template <class Key, class T>
 class RadixStore {
@@ -150,25 +159,16 @@ public:
                 context.pop_back();
 
                 // Check the children right of the node that the iterator was at already. This way,
-                // there will be no backtracking in the traversal.
-                for (auto iter = oldKey + 1 + node->children.begin(); iter != node->children.end();
-                     ++iter) {
-
-                    // If the node has a child, then the sub-tree must have a node with data that
-                    // has not yet been visited.
-                    if (*iter != nullptr) {
-
-                        // If the current node has data, return it and exit. If not, continue
-                        // following the nodes to find the next one with data. It is necessary to go
-                        // to the left-most node in this sub-tree.
-                        if ((*iter)->data != boost::none) {
-                            _current = iter->get();
-                            return;
-                        }
-                        _current = iter->get();
+                // there will be no backtracking in the traversal. If the node has such a child,
+                // then the sub-tree must have a node with data that has not yet been visited.
+                if (Node* child = node->children.firstFrom(oldKey + 1)) {
+                    // If the child has data, return it and exit. If not, continue following the
+                    // nodes to find the next one with data. It is necessary to go to the
+                    // left-most node in this sub-tree.
+                    _current = child;
+                    if (child->data == boost::none)
                         _traverseLeftSubtree();
-                        return;
-                    }
+                    return;
                 }
             }
             return;
@@ -179,12 +179,7 @@ public:
             // '_current' is root. However, it cannot return the root, and hence at least 1
             // iteration of the while loop is required.
             do {
-                for (auto child : _current->children) {
-                    if (child != nullptr) {
-                        _current = child.get();
-                        break;
-                    }
-                }
+                _current = _current->children.firstFrom(0);
             } while (_current->data == boost::none);
         }
 
@@ -300,15 +295,12 @@ public:
                 context.pop_back();
 
                 // After moving up in the tree, continue searching for neighboring nodes to see if
-                // they have data, moving from right to left.
-                for (int i = oldKey - 1; i >= 0; i--) {
-                    if (node->children[i] != nullptr) {
-                        // If there is a sub-tree found, it must have data, therefore it's necessary
-                        // to traverse to the right most node.
-                        _current = node->children[i].get();
-                        _traverseRightSubtree();
-                        return;
-                    }
+                // they have data, moving from right to left. If there is a sub-tree found, it must
+                // have data, therefore it's necessary to traverse to the right most node.
+                if (Node* child = node->children.lastBefore(oldKey)) {
+                    _current = child;
+                    _traverseRightSubtree();
+                    return;
                 }
 
                 // If there were no sub-trees that contained data, and the 'current' node has data,
@@ -323,15 +315,9 @@ public:
         void _traverseRightSubtree() {
             // This function traverses the given tree to the right most leaf of the subtree where
             // 'current' is the root.
-            do {
-                for (auto iter = _current->children.rbegin(); iter != _current->children.rend();
-                     ++iter) {
-                    if (*iter != nullptr) {
-                        _current = iter->get();
-                        break;
-                    }
-                }
-            } while (!_current->isLeaf());
+            while (!_current->isLeaf()) {
+                _current = _current->children.lastBefore(Node::Children::kMaxChildren);
+            }
         }
 
         // "_root" is a copy of the root of the tree over which this is iterating.
@@ -430,7 +416,7 @@ public:
         size_t depth = 0;
         while (depth < key.size()) {
             uint8_t c = static_cast<uint8_t>(charKey[depth]);
-            node = node->children[c];
+            node = node->children.get(c);
 
             if (node == nullptr) {
                 return 0;
@@ -460,7 +446,7 @@ public:
             if (isUniquelyOwned) {
                 // If this node is uniquely owned, simply set that child node to null and
                 // "cut" off that branch of our tree
-                last->children[firstChar] = nullptr;
+                last->children.set(firstChar, nullptr);
                 last->_numSubtreeElems -= 1;
                 last->_sizeSubtreeElems -= sizeOfRemovedNode;
                 _compressOnlyChild(last);
@@ -477,7 +463,7 @@ public:
                 std::shared_ptr<Node> child = std::make_shared<Node>(*last);
                 child->_numSubtreeElems = last->_numSubtreeElems - 1;
                 child->_sizeSubtreeElems = last->_sizeSubtreeElems - sizeOfRemovedNode;
-                child->children[firstChar] = nullptr;
+                child->children.set(firstChar, nullptr);
 
                 // 'last' may only have one child, in which case we need to evaluate
                 // whether or not this node is redundant.
@@ -494,7 +480,7 @@ public:
                     node = std::make_shared<Node>(*last);
                     node->_numSubtreeElems = last->_numSubtreeElems - 1;
                     node->_sizeSubtreeElems = last->_sizeSubtreeElems - sizeOfRemovedNode;
-                    node->children[firstChar] = child;
+                    node->children.set(firstChar, child);
                     child = node;
                 }
                 _root = node;
@@ -528,16 +514,11 @@ public:
         if (this->empty())
             return RadixStore::rend();
 
-        auto node = _root;
+        Node* node = _root.get();
         while (!node->isLeaf()) {
-            for (auto iter = node->children.rbegin(); iter != node->children.rend(); ++iter) {
-                if (*iter != nullptr) {
-                    node = *iter;
-                    break;
-                }
-            }
+            node = node->children.lastBefore(Node::Children::kMaxChildren);
         }
-        return RadixStore::const_reverse_iterator(_root, node.get());
+        return RadixStore::const_reverse_iterator(_root, node);
     }
 
     const_iterator end() const noexcept {
@@ -566,18 +547,19 @@ public:
         const char* charKey = key.data();
         // When we search a child array, always search to the right of 'idx' so that
         // when we go back up the tree we never search anything less than something
-        // we already examined.
-        uint8_t idx = '\0';
+        // we already examined. This is wider than a byte so that it can point past a child keyed
+        // on 0xff.
+        unsigned idx = '\0';
         size_t depth = 0;
 
         // Traverse the path given the key to see if the node exists.
         while (depth < key.size()) {
             idx = static_cast<uint8_t>(charKey[depth]);
-            if (node->children[idx] == nullptr) {
+            if (node->children.get(idx) == nullptr) {
                 break;
             }
 
-            node = node->children[idx].get();
+            node = node->children.get(idx).get();
             // We may eventually need to search this node's parent for larger children.
             idx += 1;
             size_t mismatchIdx = _comparePrefix(node->trieKey, charKey + depth, key.size() - depth);
@@ -627,22 +609,14 @@ public:
             node = context.back();
             context.pop_back();
 
-            for (auto iter = idx + node->children.begin(); iter != node->children.end(); ++iter) {
-                if (*iter != nullptr) {
-                    // There exists a node with a key larger than the one given, traverse to
-                    // this node which will be the left-most node in this sub-tree.
-                    node = iter->get();
-                    while (node->data == boost::none) {
-                        for (auto iter = node->children.begin(); iter != node->children.end();
-                             ++iter) {
-                            if (*iter != nullptr) {
-                                node = iter->get();
-                                break;
-                            }
-                        }
-                    }
-                    return const_iterator(_root, node);
+            if (Node* child = node->children.firstFrom(idx)) {
+                // There exists a node with a key larger than the one given, traverse to
+                // this node which will be the left-most node in this sub-tree.
+                node = child;
+                while (node->data == boost::none) {
+                    node = node->children.firstFrom(0);
                 }
+                return const_iterator(_root, node);
             }
 
             if (node->trieKey.empty()) {
@@ -681,32 +655,370 @@ public:
         return _walkTree(_root.get(), 0);
     }
 
+    /**
+     * Returns the number of bytes used by the nodes of this tree, including the ones that are
+     * shared with other trees.
+     */
+    size_t mem_usage_for_test() const {
+        return _memUsage(_root.get());
+    }
+
 private:
     class Node {
         friend class RadixStore;
 
     public:
-        Node() {
-            children.fill(nullptr);
-        }
+        /**
+         * The children of a node, keyed by the first byte of their trieKey. Like the inner nodes
+         * of an Adaptive Radix Tree, the layout grows and shrinks with the number of children:
+         *
+         *  - kNode4 and kNode16 keep up to 4 or 16 sorted key bytes next to their children.
+         *    kNode16 is searched with SIMD where it is available.
+         *  - kNode48 keeps a 256 entry index of child slots for up to 48 children.
+         *  - kNode256 keeps a slot for every possible key byte.
+         *
+         * Nodes without children, which include all leaves, allocate nothing, and copying a node
+         * to preserve it for other owners only copies as many child pointers as it has children.
+         */
+        class Children {
+        public:
+            enum class Kind : uint8_t { kNode4, kNode16, kNode48, kNode256 };
+
+            static constexpr unsigned kMaxChildren = 256;
+
+            Kind kind() const {
+                return _kind;
+            }
+
+            size_t size() const {
+                return _count;
+            }
+
+            bool empty() const {
+                return _count == 0;
+            }
+
+            /**
+             * Returns the child keyed on 'key', or a null pointer if there is none.
+             */
+            const std::shared_ptr<Node>& get(uint8_t key) const {
+                static const std::shared_ptr<Node> kNoChild;
+                int slot = _findSlot(key);
+                return slot < 0 ? kNoChild : _slots[slot];
+            }
+
+            /**
+             * Makes 'child' the child keyed on 'key'. Setting a null child removes the key.
+             */
+            void set(uint8_t key, std::shared_ptr<Node> child) {
+                int slot = _findSlot(key);
+                if (slot >= 0 && child) {
+                    _slots[slot] = std::move(child);
+                } else if (slot >= 0) {
+                    _erase(key, slot);
+                } else if (child) {
+                    _insert(key, std::move(child));
+                }
+            }
+
+            /**
+             * Returns the child with the smallest key that is at least 'key', or nullptr if there
+             * is none. 'key' may be kMaxChildren.
+             */
+            Node* firstFrom(unsigned key) const {
+                switch (_kind) {
+                    case Kind::kNode4:
+                    case Kind::kNode16:
+                        for (size_t i = 0; i < _count; ++i) {
+                            if (_keys[i] >= key)
+                                return _slots[i].get();
+                        }
+                        return nullptr;
+                    case Kind::kNode48:
+                        for (; key < kMaxChildren; ++key) {
+                            if (_keys[key])
+                                return _slots[_keys[key] - 1].get();
+                        }
+                        return nullptr;
+                    case Kind::kNode256:
+                        for (; key < kMaxChildren; ++key) {
+                            if (_slots[key])
+                                return _slots[key].get();
+                        }
+                        return nullptr;
+                }
+                return nullptr;
+            }
+
+            /**
+             * Returns the child with the largest key that is less than 'key', or nullptr if there
+             * is none. Pass kMaxChildren to get the last child.
+             */
+            Node* lastBefore(unsigned key) const {
+                switch (_kind) {
+                    case Kind::kNode4:
+                    case Kind::kNode16:
+                        for (size_t i = _count; i-- > 0;) {
+                            if (_keys[i] < key)
+                                return _slots[i].get();
+                        }
+                        return nullptr;
+                    case Kind::kNode48:
+                        while (key-- > 0) {
+                            if (_keys[key])
+                                return _slots[_keys[key] - 1].get();
+                        }
+                        return nullptr;
+                    case Kind::kNode256:
+                        while (key-- > 0) {
+                            if (_slots[key])
+                                return _slots[key].get();
+                        }
+                        return nullptr;
+                }
+                return nullptr;
+            }
+
+            /**
+             * Returns the number of bytes allocated outside of this object.
+             */
+            size_t allocatedBytes() const {
+                return _keys.capacity() + _slots.capacity() * sizeof(std::shared_ptr<Node>);
+            }
+
+        private:
+            static constexpr size_t kNode4Capacity = 4;
+            static constexpr size_t kNode16Capacity = 16;
+            static constexpr size_t kNode48Capacity = 48;
+
+            // The number of children at which a layout is swapped for the next smaller one. These
+            // are below the capacity of the smaller layout so that a node whose size hovers
+            // around a boundary doesn't convert back and forth on every insert and erase.
+            static constexpr size_t kShrinkToNode48 = 40;
+            static constexpr size_t kShrinkToNode16 = 12;
+            static constexpr size_t kShrinkToNode4 = 3;
+
+            size_t _capacity() const {
+                switch (_kind) {
+                    case Kind::kNode4:
+                        return kNode4Capacity;
+                    case Kind::kNode16:
+                        return kNode16Capacity;
+                    case Kind::kNode48:
+                        return kNode48Capacity;
+                    case Kind::kNode256:
+                        return kMaxChildren;
+                }
+                return kMaxChildren;
+            }
+
+            int _findSlot(uint8_t key) const {
+                switch (_kind) {
+                    case Kind::kNode4:
+                        for (size_t i = 0; i < _count; ++i) {
+                            if (_keys[i] == key)
+                                return i;
+                        }
+                        return -1;
+                    case Kind::kNode16:
+                        return _findSlot16(key);
+                    case Kind::kNode48:
+                        return static_cast<int>(_keys[key]) - 1;
+                    case Kind::kNode256:
+                        return _slots[key] ? key : -1;
+                }
+                return -1;
+            }
+
+            int _findSlot16(uint8_t key) const {
+#if defined(_M_AMD64) || defined(__amd64__)
+                // Compare all 16 key bytes at once and ignore the unused ones past '_count'.
+                const __m128i matches =
+                    _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(key)),
+                                   _mm_loadu_si128(reinterpret_cast<const __m128i*>(_keys.data())));
+                const unsigned mask =
+                    static_cast<unsigned>(_mm_movemask_epi8(matches)) & ((1U << _count) - 1);
+                return mask ? countTrailingZeros64(mask) : -1;
+#else
+                for (size_t i = 0; i < _count; ++i) {
+                    if (_keys[i] == key)
+                        return i;
+                }
+                return -1;
+#endif
+            }
+
+            void _insert(uint8_t key, std::shared_ptr<Node> child) {
+                if (_count == _capacity())
+                    _grow();
+
+                switch (_kind) {
+                    case Kind::kNode4:
+                    case Kind::kNode16: {
+                        if (_keys.empty())
+                            _keys.resize(kNode4Capacity);
+                        size_t pos = 0;
+                        while (pos < _count && _keys[pos] < key)
+                            ++pos;
+                        const auto keys = _keys.begin();
+                        std::copy_backward(keys + pos, keys + _count, keys + _count + 1);
+                        _keys[pos] = key;
+                        _slots.insert(_slots.begin() + pos, std::move(child));
+                        break;
+                    }
+                    case Kind::kNode48:
+                        _slots.push_back(std::move(child));
+                        _keys[key] = _slots.size();
+                        break;
+                    case Kind::kNode256:
+                        _slots[key] = std::move(child);
+                        break;
+                }
+                ++_count;
+            }
+
+            void _erase(uint8_t key, int slot) {
+                switch (_kind) {
+                    case Kind::kNode4:
+                    case Kind::kNode16:
+                        std::copy(
+                            _keys.begin() + slot + 1, _keys.begin() + _count, _keys.begin() + slot);
+                        _slots.erase(_slots.begin() + slot);
+                        break;
+                    case Kind::kNode48: {
+                        // Keep the slots dense by moving the last one into the hole.
+                        const size_t last = _slots.size() - 1;
+                        if (static_cast<size_t>(slot) != last) {
+                            auto lastKey = std::find(_keys.begin(), _keys.end(), last + 1);
+                            *lastKey = slot + 1;
+                            _slots[slot] = std::move(_slots[last]);
+                        }
+                        _slots.pop_back();
+                        _keys[key] = 0;
+                        break;
+                    }
+                    case Kind::kNode256:
+                        _slots[key].reset();
+                        break;
+                }
+                --_count;
+                _shrink();
+            }
+
+            void _grow() {
+                switch (_kind) {
+                    case Kind::kNode4:
+                        _keys.resize(kNode16Capacity);
+                        _kind = Kind::kNode16;
+                        break;
+                    case Kind::kNode16: {
+                        std::vector<uint8_t> index(kMaxChildren, 0);
+                        for (size_t i = 0; i < _count; ++i) {
+                            index[_keys[i]] = i + 1;
+                        }
+                        _keys.swap(index);
+                        _slots.reserve(kNode48Capacity);
+                        _kind = Kind::kNode48;
+                        break;
+                    }
+                    case Kind::kNode48: {
+                        std::vector<std::shared_ptr<Node>> slots(kMaxChildren);
+                        for (unsigned key = 0; key < kMaxChildren; ++key) {
+                            if (_keys[key])
+                                slots[key] = std::move(_slots[_keys[key] - 1]);
+                        }
+                        _slots.swap(slots);
+                        std::vector<uint8_t>().swap(_keys);
+                        _kind = Kind::kNode256;
+                        break;
+                    }
+                    case Kind::kNode256:
+                        break;
+                }
+            }
+
+            void _shrink() {
+                if (_count == 0) {
+                    // Release everything so that a node which lost its last child is as small as
+                    // a leaf.
+                    std::vector<uint8_t>().swap(_keys);
+                    std::vector<std::shared_ptr<Node>>().swap(_slots);
+                    _kind = Kind::kNode4;
+                    return;
+                }
+
+                switch (_kind) {
+                    case Kind::kNode4:
+                        break;
+                    case Kind::kNode16:
+                        if (_count <= kShrinkToNode4) {
+                            _keys.resize(kNode4Capacity);
+                            _keys.shrink_to_fit();
+                            _slots.shrink_to_fit();
+                            _kind = Kind::kNode4;
+                        }
+                        break;
+                    case Kind::kNode48:
+                        if (_count <= kShrinkToNode16) {
+                            std::vector<uint8_t> keys(kNode16Capacity, 0);
+                            std::vector<std::shared_ptr<Node>> slots;
+                            slots.reserve(kNode16Capacity);
+                            for (unsigned key = 0; key < kMaxChildren; ++key) {
+                                if (_keys[key]) {
+                                    keys[slots.size()] = key;
+                                    slots.push_back(std::move(_slots[_keys[key] - 1]));
+                                }
+                            }
+                            _keys.swap(keys);
+                            _slots.swap(slots);
+                            _kind = Kind::kNode16;
+                        }
+                        break;
+                    case Kind::kNode256:
+                        if (_count <= kShrinkToNode48) {
+                            std::vector<uint8_t> index(kMaxChildren, 0);
+                            std::vector<std::shared_ptr<Node>> slots;
+                            slots.reserve(kNode48Capacity);
+                            for (unsigned key = 0; key < kMaxChildren; ++key) {
+                                if (_slots[key]) {
+                                    slots.push_back(std::move(_slots[key]));
+                                    index[key] = slots.size();
+                                }
+                            }
+                            _keys.swap(index);
+                            _slots.swap(slots);
+                            _kind = Kind::kNode48;
+                        }
+                        break;
+                }
+            }
+
+            Kind _kind = Kind::kNode4;
+            uint16_t _count = 0;
+
+            // For kNode4 and kNode16, the sorted key bytes of the children in '_slots', sized to
+            // the layout's capacity. For kNode48, one more than the '_slots' index of each key
+            // byte's child, or 0 if there is none. Unused for kNode256.
+            std::vector<uint8_t> _keys;
+
+            // The children. For kNode256 this is indexed directly by key byte.
+            std::vector<std::shared_ptr<Node>> _slots;
+        };
+
+        Node() = default;
 
         Node(std::vector<uint8_t> key) : trieKey(key) {
-            children.fill(nullptr);
             _numSubtreeElems = 0;
             _sizeSubtreeElems = 0;
         }
 
-        bool isLeaf() {
-            for (auto child : children) {
-                if (child != nullptr)
-                    return false;
-            }
-            return true;
+        bool isLeaf() const {
+            return children.empty();
         }
 
         std::vector<uint8_t> trieKey;
         boost::optional<value_type> data;
-        std::array<std::shared_ptr<Node>, 256> children;
+        Children children;
 
     private:
         size_type _numSubtreeElems = 0;
@@ -738,14 +1050,22 @@ private:
         }
         ret.push_back('\n');
 
-        for (auto child : node->children) {
-            if (child != nullptr) {
-                ret.append(_walkTree(child.get(), depth + 1));
-            }
+        for (Node* child = node->children.firstFrom(0); child != nullptr;
+             child = node->children.firstFrom(child->trieKey.front() + 1)) {
+            ret.append(_walkTree(child, depth + 1));
         }
         return ret;
     }
 
+    size_t _memUsage(const Node* node) const {
+        size_t bytes = sizeof(Node) + node->trieKey.capacity() + node->children.allocatedBytes();
+        for (Node* child = node->children.firstFrom(0); child != nullptr;
+             child = node->children.firstFrom(child->trieKey.front() + 1)) {
+            bytes += _memUsage(child);
+        }
+        return bytes;
+    }
+
     Node* _findNode(const Key& key) const {
         unsigned int depth = 0;
         const char* charKey = key.data();
@@ -762,7 +1082,7 @@ private:
         }
 
         uint8_t childFirstChar = static_cast<uint8_t>(charKey[depth]);
-        auto node = _root->children[childFirstChar];
+        Node* node = _root->children.get(childFirstChar).get();
 
         while (node != nullptr) {
 
@@ -770,13 +1090,13 @@ private:
             if (mismatchIdx != node->trieKey.size()) {
                 return nullptr;
             } else if (mismatchIdx == key.size() - depth && node->data != boost::none) {
-                return node.get();
+                return node;
             }
 
             depth += node->trieKey.size();
 
             childFirstChar = static_cast<uint8_t>(charKey[depth]);
-            node = node->children[childFirstChar];
+            node = node->children.get(childFirstChar).get();
         }
 
         return nullptr;
@@ -817,7 +1137,7 @@ private:
         int depth = 0;
 
         uint8_t childFirstChar = static_cast<uint8_t>(charKey[depth]);
-        std::shared_ptr<Node> node = _root->children[childFirstChar];
+        std::shared_ptr<Node> node = _root->children.get(childFirstChar);
         std::shared_ptr<Node> old = node;
 
         // Copy root if it is not uniquely owned.
@@ -841,7 +1161,7 @@ private:
                 node = std::make_shared<Node>(*old.get());
                 node->_numSubtreeElems = old->_numSubtreeElems;
                 node->_sizeSubtreeElems = old->_sizeSubtreeElems;
-                prev->children[old->trieKey.front()] = node;
+                prev->children.set(old->trieKey.front(), node);
             }
 
             // 'node' is uniquely owned at this point, so we are free to modify it.
@@ -874,7 +1194,7 @@ private:
 
                 // Change the current node's trieKey and make a child of the new node.
                 newKey = _makeKey(node->trieKey, mismatchIdx, node->trieKey.size() - mismatchIdx);
-                newNode->children[newKey.front()] = node;
+                newNode->children.set(newKey.front(), node);
                 node->trieKey = newKey;
 
                 return std::pair<const_iterator, bool>(it, true);
@@ -898,10 +1218,10 @@ private:
             depth += node->trieKey.size();
             childFirstChar = static_cast<const uint8_t>(charKey[depth]);
             prev = node;
-            node = node->children[childFirstChar];
+            node = node->children.get(childFirstChar);
 
             if (old != nullptr) {
-                old = old->children[childFirstChar];
+                old = old->children.get(childFirstChar);
             }
         }
 
@@ -949,11 +1269,11 @@ private:
             newNode->_numSubtreeElems = 1;
             newNode->_sizeSubtreeElems = value->second.size();
         }
-        if (node->children[key.front()] != nullptr) {
-            newNode->_numSubtreeElems = node->children[key.front()]->_numSubtreeElems;
-            newNode->_sizeSubtreeElems = node->children[key.front()]->_sizeSubtreeElems;
+        if (node->children.get(key.front()) != nullptr) {
+            newNode->_numSubtreeElems = node->children.get(key.front())->_numSubtreeElems;
+            newNode->_sizeSubtreeElems = node->children.get(key.front())->_sizeSubtreeElems;
         }
-        node->children[key.front()] = newNode;
+        node->children.set(key.front(), newNode);
         return newNode;
     }
 
@@ -974,7 +1294,7 @@ private:
 
         while (depth < key.size()) {
             uint8_t c = static_cast<uint8_t>(charKey[depth]);
-            node = node->children[c].get();
+            node = node->children.get(c).get();
             context.push_back(node);
             depth = depth + node->trieKey.size();
         }
@@ -1009,15 +1329,11 @@ private:
         }
 
         // Determine if this node has only one child.
-        std::shared_ptr<Node> onlyChild = nullptr;
-        for (size_t i = 0; i < node->children.size(); ++i) {
-            if (node->children[i] != nullptr) {
-                if (onlyChild != nullptr) {
-                    return;
-                }
-                onlyChild = node->children[i];
-            }
+        if (node->children.size() != 1) {
+            return;
         }
+        std::shared_ptr<Node> onlyChild =
+            node->children.get(node->children.firstFrom(0)->trieKey.front());
 
         // Append the child's key onto the parent.
         for (char item : onlyChild->trieKey) {
@@ -1067,7 +1383,7 @@ private:
         for (; idx < context.size(); idx++) {
             node = context[idx];
             newNode = std::make_shared<Node>(*node.get());
-            parent->children[node->trieKey.front()] = newNode;
+            parent->children.set(node->trieKey.front(), newNode);
             parent = newNode;
             context[idx] = newNode;
         }
@@ -1169,10 +1485,12 @@ private:
         int numDelta = 0;
         context.push_back(current);
 
-        for (unsigned int key = 0; key < 256; ++key) {
-            std::shared_ptr<Node> node = current->children[key];
-            std::shared_ptr<Node> baseNode = base->children[key];
-            std::shared_ptr<Node> otherNode = other->children[key];
+        const unsigned kMaxChildren = Node::Children::kMaxChildren;
+        for (unsigned key = _nextChildKey(current, base, other, 0); key < kMaxChildren;
+             key = _nextChildKey(current, base, other, key + 1)) {
+            std::shared_ptr<Node> node = current->children.get(key);
+            std::shared_ptr<Node> baseNode = base->children.get(key);
+            std::shared_ptr<Node> otherNode = other->children.get(key);
             bool unique = node != otherNode && node != baseNode;
 
             // If the current tree does not have this node, check if the other trees do.
@@ -1180,11 +1498,11 @@ private:
                 if (baseNode == nullptr && otherNode != nullptr) {
                     // If base and 'this' do NOT have this branch, but other does, then
                     // merge in the other's branch.
-                    sizeDelta += other->children[key]->_sizeSubtreeElems;
-                    numDelta += other->children[key]->_numSubtreeElems;
+                    sizeDelta += other->children.get(key)->_sizeSubtreeElems;
+                    numDelta += other->children.get(key)->_numSubtreeElems;
 
                     current = _makeBranchUnique(context);
-                    current->children[key] = other->children[key];
+                    current->children.set(key, other->children.get(key));
                 } else if (baseNode != nullptr && otherNode != nullptr && baseNode == otherNode) {
                     // Don't do anything since it means that master + base have a branch
                     // that current does not, indicnating that current removed that branch.
@@ -1204,22 +1522,22 @@ private:
                         // are shared between the three trees.
                     } else if (baseNode != nullptr && otherNode == nullptr) {
                         // Other has a deleted branch that must also be removed from 'this' tree.
-                        sizeDelta -= current->children[key]->_sizeSubtreeElems;
-                        numDelta -= current->children[key]->_numSubtreeElems;
+                        sizeDelta -= current->children.get(key)->_sizeSubtreeElems;
+                        numDelta -= current->children.get(key)->_numSubtreeElems;
 
                         current = _makeBranchUnique(context);
-                        current->children[key] = nullptr;
+                        current->children.set(key, nullptr);
 
                     } else if (baseNode != nullptr && otherNode != nullptr && baseNode == node) {
                         // If other and current point to the same node, then master changed
                         // something.
-                        sizeDelta += other->children[key]->_sizeSubtreeElems -
-                            current->children[key]->_sizeSubtreeElems;
-                        numDelta += other->children[key]->_numSubtreeElems -
-                            current->children[key]->_numSubtreeElems;
+                        sizeDelta += other->children.get(key)->_sizeSubtreeElems -
+                            current->children.get(key)->_sizeSubtreeElems;
+                        numDelta += other->children.get(key)->_numSubtreeElems -
+                            current->children.get(key)->_numSubtreeElems;
 
                         current = _makeBranchUnique(context);
-                        current->children[key] = other->children[key];
+                        current->children.set(key, other->children.get(key));
                     }
                 } else {
                     // Current node is a unique pointer.
@@ -1267,20 +1585,32 @@ private:
         return std::make_pair(numDelta, sizeDelta);
     }
 
+    /**
+     * Returns the smallest key at or after 'key' that has a child in any of 'current', 'base' or
+     * 'other', or kMaxChildren if there is none. This lets a merge skip over the keys that none of
+     * the trees use.
+     */
+    static unsigned _nextChildKey(const std::shared_ptr<Node>& current,
+                                  const std::shared_ptr<Node>& base,
+                                  const std::shared_ptr<Node>& other,
+                                  unsigned key) {
+        unsigned next = Node::Children::kMaxChildren;
+        for (const Node* node : {current.get(), base.get(), other.get()}) {
+            if (Node* child = node->children.firstFrom(key))
+                next = std::min<unsigned>(next, child->trieKey.front());
+        }
+        return next;
+    }
+
     Node* _begin(const std::shared_ptr<Node> root) const noexcept {
-        auto node = root;
+        Node* node = root.get();
         while (node->data == boost::none) {
             if (node->children.empty())
                 return nullptr;
 
-            for (auto child : node->children) {
-                if (child != nullptr) {
-                    node = child;
-                    break;
-                }
-            }
+            node = node->children.firstFrom(0);
         }
-        return node.get();
+        return node;
     }
 
     std::shared_ptr<Node> _root;
@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mongo/db/storage/biggie/store.h"
+
+namespace mongo {
+namespace biggie {
+namespace {
+
+using StringStore = RadixStore<std::string, std::string>;
+
+const int kSampleSize = 10000;
+
+enum KeyShape {
+    // Uniformly random bytes, so the top of the tree is dense.
+    RANDOM,
+    // A few shared prefixes followed by a decimal suffix, like record ids of several idents.
+    PREFIXED,
+};
+
+std::vector<std::string> generateKeys(KeyShape shape) {
+    std::mt19937_64 gen(1234);
+    std::vector<std::string> keys;
+    keys.reserve(kSampleSize);
+    for (int i = 0; i < kSampleSize; ++i) {
+        std::string key;
+        if (shape == RANDOM) {
+            for (int j = 0; j < 8; ++j) {
+                key.push_back(static_cast<char>(gen()));
+            }
+        } else {
+            key = "collection-" + std::to_string(gen() % 4) + "/" + std::to_string(gen());
+        }
+        keys.push_back(std::move(key));
+    }
+    return keys;
+}
+
+StringStore makeStore(const std::vector<std::string>& keys) {
+    StringStore store;
+    for (const auto& key : keys) {
+        store.insert(StringStore::value_type(key, "value"));
+    }
+    return store;
+}
+
+void BM_RadixStoreInsert(benchmark::State& state, KeyShape shape) {
+    const auto keys = generateKeys(shape);
+    size_t memUsage = 0;
+    for (auto _ : state) {
+        StringStore store = makeStore(keys);
+        memUsage = store.mem_usage_for_test();
+        benchmark::DoNotOptimize(store);
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+    state.counters["bytesPerKey"] = double(memUsage) / keys.size();
+}
+
+void BM_RadixStoreFind(benchmark::State& state, KeyShape shape) {
+    const auto keys = generateKeys(shape);
+    const StringStore store = makeStore(keys);
+    for (auto _ : state) {
+        for (const auto& key : keys) {
+            benchmark::DoNotOptimize(store.find(key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+void BM_RadixStoreIterate(benchmark::State& state, KeyShape shape) {
+    const auto keys = generateKeys(shape);
+    const StringStore store = makeStore(keys);
+    for (auto _ : state) {
+        for (const auto& entry : store) {
+            benchmark::DoNotOptimize(entry);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+// Measures the copy-on-write cost of a single write to a snapshot, which copies the path from the
+// root to the modified node.
+void BM_RadixStoreUpdateSnapshot(benchmark::State& state, KeyShape shape) {
+    const auto keys = generateKeys(shape);
+    const StringStore store = makeStore(keys);
+    size_t i = 0;
+    for (auto _ : state) {
+        StringStore snapshot(store);
+        snapshot.update(StringStore::value_type(keys[i++ % keys.size()], "updated"));
+        benchmark::DoNotOptimize(snapshot);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_CAPTURE(BM_RadixStoreInsert, Random, RANDOM);
+BENCHMARK_CAPTURE(BM_RadixStoreInsert, Prefixed, PREFIXED);
+BENCHMARK_CAPTURE(BM_RadixStoreFind, Random, RANDOM);
+BENCHMARK_CAPTURE(BM_RadixStoreFind, Prefixed, PREFIXED);
+BENCHMARK_CAPTURE(BM_RadixStoreIterate, Random, RANDOM);
+BENCHMARK_CAPTURE(BM_RadixStoreIterate, Prefixed, PREFIXED);
+BENCHMARK_CAPTURE(BM_RadixStoreUpdateSnapshot, Random, RANDOM);
+BENCHMARK_CAPTURE(BM_RadixStoreUpdateSnapshot, Prefixed, PREFIXED);
+
+}  // namespace
+}  // namespace biggie
+}  // namespace mongo
@@ -1611,6 +1611,69 @@ TEST_F(RadixStoreTest, PathCompressionTest) {
               "\n food*"
               "\n  ie*\n");
 }
+
+TEST_F(RadixStoreTest, ChildrenGrowAndShrinkTest) {
+    // Give the root a child for every non-zero byte so that it goes through every child layout,
+    // then erase them in an order that empties slots from the middle of each layout.
+    std::vector<std::string> keys;
+    for (int c = 1; c < 256; ++c) {
+        keys.push_back(std::string(1, static_cast<char>(c)) + "key");
+    }
+    for (const auto& key : keys) {
+        thisStore.insert(value_type(key, "1"));
+    }
+    ASSERT_EQ(thisStore.size(), StringStore::size_type(keys.size()));
+
+    StringStore snapshot(thisStore);
+
+    std::vector<std::string> remaining = keys;
+    while (!remaining.empty()) {
+        const std::string key = remaining[remaining.size() / 2];
+        ASSERT_EQ(thisStore.erase(key), StringStore::size_type(1));
+        remaining.erase(std::find(remaining.begin(), remaining.end(), key));
+
+        ASSERT_EQ(thisStore.size(), StringStore::size_type(remaining.size()));
+        auto it = thisStore.begin();
+        for (const auto& expectedKey : remaining) {
+            ASSERT_TRUE(it != thisStore.end());
+            ASSERT_EQ(it->first, expectedKey);
+            ++it;
+        }
+        ASSERT_TRUE(it == thisStore.end());
+
+        auto rit = thisStore.rbegin();
+        for (auto expectedKey = remaining.rbegin(); expectedKey != remaining.rend();
+             ++expectedKey) {
+            ASSERT_TRUE(rit != thisStore.rend());
+            ASSERT_EQ((*rit).first, *expectedKey);
+            ++rit;
+        }
+        ASSERT_TRUE(rit == thisStore.rend());
+        ASSERT_TRUE(thisStore.find(key) == thisStore.end());
+    }
+
+    // The snapshot shared the nodes and must not see any of the erases.
+    ASSERT_EQ(snapshot.size(), StringStore::size_type(keys.size()));
+    auto it = snapshot.begin();
+    for (const auto& key : keys) {
+        ASSERT_TRUE(snapshot.find(key) != snapshot.end());
+        ASSERT_EQ(it->first, key);
+        ++it;
+    }
+}
+
+TEST_F(RadixStoreTest, LowerBoundPastLastByteTest) {
+    value_type value1 = std::make_pair("a", "1");
+    value_type value2 = std::make_pair("\xff\x05", "2");
+
+    thisStore.insert(value_type(value1));
+    thisStore.insert(value_type(value2));
+
+    // There is nothing after a key under the child keyed on 0xff.
+    ASSERT_TRUE(thisStore.lower_bound("\xff\x10") == thisStore.end());
+    ASSERT_TRUE(thisStore.upper_bound("\xff\x05") == thisStore.end());
+    ASSERT_TRUE(*thisStore.lower_bound("\xff") == value2);
+}
 }  // namespace
 }  // mongo namespace
 }  // biggie namespace
@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <benchmark/benchmark.h>
 #include <random>
 #include <vector>
@@ -48,6 +49,7 @@ const int kStrLenMultiplier = 100;
 const int kArrLenMultiplier = 40;
 
 const Ordering ALL_ASCENDING = Ordering::make(BSONObj());
+const Ordering ALL_DESCENDING = Ordering::make(BSON("a" << -1));
 
 struct BsonsAndKeyStrings {
     int bsonSize = 0;
@@ -97,13 +99,14 @@ BSONObj generateBson(BsonValueType bsonValueType) {
 }
 
 static BsonsAndKeyStrings generateBsonsAndKeyStrings(BsonValueType bsonValueType,
-                                                     KeyString::Version version) {
+                                                     KeyString::Version version,
+                                                     Ordering ord) {
     BsonsAndKeyStrings result;
     result.bsonSize = 0;
     result.keystringSize = 0;
     for (int i = 0; i < kSampleSize; i++) {
         BSONObj bson = generateBson(bsonValueType);
-        KeyString ks(version, bson, ALL_ASCENDING);
+        KeyString ks(version, bson, ord);
         result.bsonSize += bson.objsize();
         result.keystringSize += ks.getSize();
         result.bsons[i] = bson;
@@ -114,19 +117,21 @@ static BsonsAndKeyStrings generateBsonsAndKeyStrings(BsonValueType bsonValueType
 
         result.typebits[i] = SharedBuffer::allocate(ks.getTypeBits().getSize());
         memcpy(result.typebits[i].get(), ks.getTypeBits().getBuffer(), ks.getTypeBits().getSize());
-        result.typebitsLens[i] = ks.getSize();
+        result.typebitsLens[i] = ks.getTypeBits().getSize();
     }
     return result;
 }
 
 void BM_BSONToKeyString(benchmark::State& state,
                         const KeyString::Version version,
-                        BsonValueType bsonType) {
-    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+                        BsonValueType bsonType,
+                        Ordering ord = ALL_ASCENDING) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings =
+        generateBsonsAndKeyStrings(bsonType, version, ord);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         for (auto bson : bsonsAndKeyStrings.bsons) {
-            benchmark::DoNotOptimize(KeyString(version, bson, ALL_ASCENDING));
+            benchmark::DoNotOptimize(KeyString(version, bson, ord));
         }
     }
     state.SetBytesProcessed(state.iterations() * bsonsAndKeyStrings.bsonSize);
@@ -135,8 +140,10 @@ void BM_BSONToKeyString(benchmark::State& state,
 
 void BM_KeyStringToBSON(benchmark::State& state,
                         const KeyString::Version version,
-                        BsonValueType bsonType) {
-    const BsonsAndKeyStrings bsonsAndKeyStrings = generateBsonsAndKeyStrings(bsonType, version);
+                        BsonValueType bsonType,
+                        Ordering ord = ALL_ASCENDING) {
+    const BsonsAndKeyStrings bsonsAndKeyStrings =
+        generateBsonsAndKeyStrings(bsonType, version, ord);
     for (auto _ : state) {
         benchmark::ClobberMemory();
         for (size_t i = 0; i < kSampleSize; i++) {
@@ -144,7 +151,7 @@ void BM_KeyStringToBSON(benchmark::State& state,
             benchmark::DoNotOptimize(
                 KeyString::toBson(bsonsAndKeyStrings.keystrings[i].get(),
                                   bsonsAndKeyStrings.keystringLens[i],
-                                  ALL_ASCENDING,
+                                  ord,
                                   KeyString::TypeBits::fromBuffer(version, &buf)));
         }
     }
@@ -152,6 +159,105 @@ void BM_KeyStringToBSON(benchmark::State& state,
     state.SetItemsProcessed(state.iterations() * kSampleSize);
 }
 
+/**
+ * Compound index keys as found in indexes on low-cardinality fields: a few distinct long strings
+ * for the leading field and a handful of values for the next, followed by a unique integer. The
+ * keys are returned in index order, as WiredTiger stores them.
+ */
+struct CompoundKey {
+    BSONObj bson;
+    RecordId recordId;
+    std::string keyString;
+    std::string typeBits;  // Empty if the TypeBits are all zero, as indexes store them.
+};
+
+std::vector<CompoundKey> generateCompoundKeys(KeyString::Version version) {
+    std::mt19937 gen(seedGen());
+    std::uniform_int_distribution<int> prefixDist(0, 3);
+    std::uniform_int_distribution<int> middleDist(0, 15);
+
+    std::vector<CompoundKey> keys(kSampleSize);
+    for (int i = 0; i < kSampleSize; i++) {
+        auto& key = keys[i];
+        key.bson = BSON("" << std::string(40, 'a' + prefixDist(gen)) << ""
+                           << "category" + std::to_string(middleDist(gen)) << "" << i);
+        key.recordId = RecordId(i + 1);
+
+        KeyString ks(version, key.bson, ALL_ASCENDING, key.recordId);
+        key.keyString.assign(ks.getBuffer(), ks.getSize());
+        if (!ks.getTypeBits().isAllZeros()) {
+            key.typeBits.assign(ks.getTypeBits().getBuffer(), ks.getTypeBits().getSize());
+        }
+    }
+    std::sort(keys.begin(), keys.end(), [](const CompoundKey& lhs, const CompoundKey& rhs) {
+        return lhs.keyString < rhs.keyString;
+    });
+    return keys;
+}
+
+void BM_CompoundKeyStringEncode(benchmark::State& state, const KeyString::Version version) {
+    const auto keys = generateCompoundKeys(version);
+    int bsonSize = 0;
+    for (const auto& key : keys) {
+        bsonSize += key.bson.objsize();
+    }
+
+    KeyString ks(version);
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (const auto& key : keys) {
+            ks.resetToKey(key.bson, ALL_ASCENDING, key.recordId);
+            benchmark::DoNotOptimize(ks.getBuffer());
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * bsonSize);
+    state.SetItemsProcessed(state.iterations() * kSampleSize);
+}
+
+void BM_CompoundKeyStringDecode(benchmark::State& state, const KeyString::Version version) {
+    const auto keys = generateCompoundKeys(version);
+
+    // Report the average size of what an index stores per entry: the key, its TypeBits, and the
+    // part of the key not shared with the preceding key, which is roughly what remains of it after
+    // WiredTiger prefix compression.
+    size_t keyBytes = 0;
+    size_t typeBitsBytes = 0;
+    size_t unsharedBytes = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        const auto& key = keys[i].keyString;
+        keyBytes += key.size();
+        typeBitsBytes += keys[i].typeBits.size();
+
+        size_t shared = 0;
+        if (i > 0) {
+            const auto& prev = keys[i - 1].keyString;
+            shared = std::mismatch(key.begin(),
+                                   key.begin() + std::min(key.size(), prev.size()),
+                                   prev.begin())
+                         .first -
+                key.begin();
+        }
+        unsharedBytes += key.size() - shared;
+    }
+
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        for (const auto& key : keys) {
+            BufReader reader(key.typeBits.data(), key.typeBits.size());
+            benchmark::DoNotOptimize(KeyString::toBson(key.keyString.data(),
+                                                       key.keyString.size(),
+                                                       ALL_ASCENDING,
+                                                       KeyString::TypeBits::fromBuffer(version,
+                                                                                       &reader)));
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * keyBytes);
+    state.SetItemsProcessed(state.iterations() * kSampleSize);
+    state.counters["keyBytes"] = double(keyBytes) / keys.size();
+    state.counters["typeBitsBytes"] = double(typeBitsBytes) / keys.size();
+    state.counters["unsharedKeyBytes"] = double(unsharedBytes) / keys.size();
+}
+
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Int, KeyString::Version::V0, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Int, KeyString::Version::V1, INT);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Double, KeyString::Version::V0, DOUBLE);
@@ -159,6 +265,8 @@ BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Double, KeyString::Version::V1, DOUBLE)
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Decimal, KeyString::Version::V1, DECIMAL);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_String, KeyString::Version::V0, STRING);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_String, KeyString::Version::V1, STRING);
+BENCHMARK_CAPTURE(
+    BM_BSONToKeyString, V1_String_Descending, KeyString::Version::V1, STRING, ALL_DESCENDING);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_BSONToKeyString, V1_Array, KeyString::Version::V1, ARRAY);
 
@@ -169,7 +277,14 @@ BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Double, KeyString::Version::V1, DOUBLE)
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Decimal, KeyString::Version::V1, DECIMAL);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_String, KeyString::Version::V0, STRING);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_String, KeyString::Version::V1, STRING);
+BENCHMARK_CAPTURE(
+    BM_KeyStringToBSON, V1_String_Descending, KeyString::Version::V1, STRING, ALL_DESCENDING);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V0_Array, KeyString::Version::V0, ARRAY);
 BENCHMARK_CAPTURE(BM_KeyStringToBSON, V1_Array, KeyString::Version::V1, ARRAY);
+
+BENCHMARK_CAPTURE(BM_CompoundKeyStringEncode, V0, KeyString::Version::V0);
+BENCHMARK_CAPTURE(BM_CompoundKeyStringEncode, V1, KeyString::Version::V1);
+BENCHMARK_CAPTURE(BM_CompoundKeyStringDecode, V0, KeyString::Version::V0);
+BENCHMARK_CAPTURE(BM_CompoundKeyStringDecode, V1, KeyString::Version::V1);
 }  // namespace
 }  // namespace mongo
@@ -1353,6 +1353,29 @@ TEST_F(KeyStringTest, VeryLargeString) {
     ROUNDTRIP(version, obj);
 }
 
+TEST_F(KeyStringTest, StringsOfEveryLengthAroundWordSize) {
+    // Inverted strings are flipped a word at a time with a bytewise tail, so cover every split
+    // between the two, with and without embedded NUL and 0xFF bytes.
+    for (size_t len = 0; len <= 3 * sizeof(uint64_t) + 1; len++) {
+        std::string str;
+        for (size_t i = 0; i < len; i++) {
+            str += char('a' + i);
+        }
+        ROUNDTRIP(version, BSON("" << str));
+        ROUNDTRIP(version, BSON("" << BSONSymbol(str)));
+
+        for (size_t pos = 0; pos < len; pos++) {
+            std::string withNul = str;
+            withNul[pos] = '\0';
+            ROUNDTRIP(version, BSON("" << withNul));
+
+            std::string withFF = str;
+            withFF[pos] = '\xFF';
+            ROUNDTRIP(version, BSON("" << withFF));
+        }
+    }
+}
+
 TEST_F(KeyStringTest, ToBsonSafeShouldNotTerminate) {
     KeyString::TypeBits typeBits(KeyString::Version::V1);
 
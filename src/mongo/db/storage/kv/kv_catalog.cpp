@@ -32,6 +32,7 @@
 
 #include "mongo/db/storage/kv/kv_catalog.h"
 
+#include <algorithm>
 #include <stdlib.h>
 
 #include "mongo/bson/util/bson_extract.h"
@@ -59,6 +60,10 @@ const char kNamespaceFieldName[] = "ns";
 const char kNonRepairableFeaturesFieldName[] = "nonRepairable";
 const char kRepairableFeaturesFieldName[] = "repairable";
 
+// Idents of tables that are not part of any collection start with this, and never live in a
+// per-database directory.
+const char kInternalIdentPrefix[] = "internal-";
+
 void appendPositionsOfBitsSet(uint64_t value, StringBuilder* sb) {
     invariant(sb);
 
@@ -391,6 +396,26 @@ void KVCatalog::getAllCollections(std::vector<std::string>* out) const {
     }
 }
 
+std::vector<std::string> KVCatalog::getAllCollectionsNewestFirst() const {
+    std::vector<std::pair<RecordId, std::string>> byLoc;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_identsLock);
+        for (const auto& entry : _idents) {
+            byLoc.emplace_back(entry.second.storedLoc, entry.first);
+        }
+    }
+    std::sort(byLoc.begin(), byLoc.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.first > rhs.first;
+    });
+
+    std::vector<std::string> out;
+    out.reserve(byLoc.size());
+    for (auto& entry : byLoc) {
+        out.push_back(std::move(entry.second));
+    }
+    return out;
+}
+
 Status KVCatalog::newCollection(OperationContext* opCtx,
                                 StringData ns,
                                 const CollectionOptions& options,
@@ -629,6 +654,16 @@ bool KVCatalog::isCollectionIdent(StringData ident) const {
         ident.find("collection/") != std::string::npos;
 }
 
+std::string KVCatalog::newInternalIdent() {
+    StringBuilder buf;
+    buf << kInternalIdentPrefix << _next.fetchAndAdd(1) << '-' << _rand;
+    return buf.str();
+}
+
+bool KVCatalog::isInternalIdent(StringData ident) const {
+    return ident.startsWith(kInternalIdentPrefix);
+}
+
 StatusWith<std::string> KVCatalog::newOrphanedIdent(OperationContext* opCtx, std::string ident) {
     // The collection will be named local.orphan.xxxxx.
     std::string identNs = ident;
@@ -63,6 +63,12 @@ public:
 
     void getAllCollections(std::vector<std::string>* out) const;
 
+    /**
+     * Like getAllCollections(), but ordered by when the collections were added to the catalog,
+     * most recent first.
+     */
+    std::vector<std::string> getAllCollectionsNewestFirst() const;
+
     /**
      * @return error or ident for instance
      */
@@ -94,6 +100,14 @@ public:
 
     bool isCollectionIdent(StringData ident) const;
 
+    /**
+     * Returns a new ident for a table that is not part of any collection, such as the table of a
+     * TemporaryRecordStore. Such idents are never recorded in the catalog.
+     */
+    std::string newInternalIdent();
+
+    bool isInternalIdent(StringData ident) const;
+
     FeatureTracker* getFeatureTracker() const {
         invariant(_featureTracker);
         return _featureTracker.get();
@@ -43,6 +43,7 @@
 #include "mongo/db/index_names.h"
 #include "mongo/db/storage/kv/kv_collection_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/kv/kv_lazy_open.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
@@ -64,8 +65,22 @@ IndexAccessMethod* KVDatabaseCatalogEntry::getIndex(OperationContext* opCtx,
     std::string ident =
         _engine->getCatalog()->getIndexIdent(opCtx, collection->ns().ns(), desc->indexName());
 
-    SortedDataInterface* sdi =
-        _engine->getEngine()->getGroupedSortedDataInterface(opCtx, ident, desc, index->getPrefix());
+    SortedDataInterface* sdi;
+    KVLazyOpenRegistry* lazyRegistry = _engine->getLazyOpenRegistry();
+    if (lazyRegistry && name() != "local") {
+        KVEngine* kvEngine = _engine->getEngine();
+        const KVPrefix prefix = index->getPrefix();
+        sdi = new KVLazySortedDataInterface(
+            collection->ns().ns(),
+            lazyRegistry,
+            [kvEngine, ident, desc, prefix](OperationContext* opCtx) {
+                return std::unique_ptr<SortedDataInterface>(
+                    kvEngine->getGroupedSortedDataInterface(opCtx, ident, desc, prefix));
+            });
+    } else {
+        sdi = _engine->getEngine()->getGroupedSortedDataInterface(
+            opCtx, ident, desc, index->getPrefix());
+    }
 
     if ("" == type)
         return new BtreeAccessMethod(index, sdi);
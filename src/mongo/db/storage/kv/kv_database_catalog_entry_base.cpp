@@ -37,6 +37,7 @@
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
 #include "mongo/db/storage/kv/kv_collection_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/db/storage/kv/kv_lazy_open.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 #include "mongo/db/storage/recovery_unit.h"
 
@@ -243,19 +244,39 @@ Status KVDatabaseCatalogEntryBase::createCollection(OperationContext* opCtx,
 
 void KVDatabaseCatalogEntryBase::initCollection(OperationContext* opCtx,
                                                 const std::string& ns,
-                                                bool forRepair) {
+                                                bool forRepair,
+                                                std::unique_ptr<RecordStore> rs) {
     invariant(!_collections.count(ns));
 
     const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
 
-    std::unique_ptr<RecordStore> rs;
-    if (forRepair) {
+    if (rs) {
+        invariant(!forRepair);
+    } else if (forRepair) {
         // Using a NULL rs since we don't want to open this record store before it has been
         // repaired. This also ensures that if we try to use it, it will blow up.
         rs = nullptr;
     } else {
         BSONCollectionCatalogEntry::MetaData md = _engine->getCatalog()->getMetaData(opCtx, ns);
-        rs = _engine->getEngine()->getGroupedRecordStore(opCtx, ns, ident, md.options, md.prefix);
+        KVLazyOpenRegistry* lazyRegistry = _engine->getLazyOpenRegistry();
+        if (lazyRegistry && name() != "local" && !md.options.capped) {
+            // Capped collections register callbacks with their record store and the local
+            // database is needed by replication as soon as startup finishes, so only regular
+            // collections wait to be opened.
+            KVEngine* kvEngine = _engine->getEngine();
+            rs = stdx::make_unique<KVLazyRecordStore>(
+                ns,
+                ident,
+                kvEngine,
+                lazyRegistry,
+                [kvEngine, ns, ident, md](OperationContext* opCtx) {
+                    return kvEngine->getGroupedRecordStore(
+                        opCtx, ns, ident, md.options, md.prefix);
+                });
+        } else {
+            rs = _engine->getEngine()->getGroupedRecordStore(
+                opCtx, ns, ident, md.options, md.prefix);
+        }
         invariant(rs);
     }
 
@@ -80,7 +80,14 @@ public:
 
     // --------------
 
-    void initCollection(OperationContext* opCtx, const std::string& ns, bool forRepair);
+    /**
+     * Adds an entry for the existing collection 'ns'. Uses 'rs' as its record store if it was
+     * already opened, otherwise opens it, unless 'forRepair' is true.
+     */
+    void initCollection(OperationContext* opCtx,
+                        const std::string& ns,
+                        bool forRepair,
+                        std::unique_ptr<RecordStore> rs = nullptr);
 
     void initCollectionBeforeRepair(OperationContext* opCtx, const std::string& ns);
     void reinitCollectionAfterRepair(OperationContext* opCtx, const std::string& ns);
@@ -254,6 +254,15 @@ public:
         return true;
     }
 
+    /**
+     * Returns true if record stores created with the 'clusteredIndex' collection option store
+     * each document under the RecordId derived from its _id. This must not change over the
+     * lifetime of the engine.
+     */
+    virtual bool supportsClusteredCollections() const {
+        return false;
+    }
+
     /**
      * Returns true if storage engine supports --directoryperdb.
      * See:
@@ -0,0 +1,427 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/kv/kv_lazy_open.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+OperationContext* getCurrentOperation() {
+    OperationContext* opCtx = haveClient() ? cc().getOperationContext() : nullptr;
+    invariant(opCtx);
+    return opCtx;
+}
+
+}  // namespace
+
+void KVLazyOpenRegistry::add(const std::string& ns, Openable* openable) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _unopened.emplace(ns, openable);
+}
+
+void KVLazyOpenRegistry::remove(const std::string& ns, Openable* openable) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto range = _unopened.equal_range(ns);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second == openable) {
+            _unopened.erase(it);
+            return;
+        }
+    }
+}
+
+std::vector<KVLazyOpenRegistry::Openable*> KVLazyOpenRegistry::getUnopened(
+    const std::string& ns) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    std::vector<Openable*> result;
+    auto range = _unopened.equal_range(ns);
+    for (auto it = range.first; it != range.second; ++it) {
+        result.push_back(it->second);
+    }
+    return result;
+}
+
+size_t KVLazyOpenRegistry::size() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _unopened.size();
+}
+
+KVLazyRecordStore::KVLazyRecordStore(StringData ns,
+                                     StringData ident,
+                                     KVEngine* engine,
+                                     KVLazyOpenRegistry* registry,
+                                     Opener opener)
+    : RecordStore(ns),
+      _ident(ident.toString()),
+      _engine(engine),
+      _registry(registry),
+      _opener(std::move(opener)) {
+    _registry->add(RecordStore::ns(), this);
+}
+
+KVLazyRecordStore::~KVLazyRecordStore() {
+    if (!isOpen()) {
+        _registry->remove(ns(), this);
+    }
+}
+
+void KVLazyRecordStore::open(OperationContext* opCtx) {
+    _get(opCtx);
+}
+
+RecordStore* KVLazyRecordStore::_get(OperationContext* opCtx) const {
+    if (auto rs = _recordStore.load()) {
+        return rs;
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_openMutex);
+        if (auto rs = _recordStore.load()) {
+            return rs;
+        }
+        _owned = _opener(opCtx);
+        invariant(_owned);
+        invariant(!_owned->isCapped());
+        _recordStore.store(_owned.get());
+    }
+
+    // Unregister outside of '_openMutex', since the registry's mutex is held while its entries are
+    // being looked up.
+    _registry->remove(ns(), const_cast<KVLazyRecordStore*>(this));
+    return _recordStore.load();
+}
+
+RecordStore* KVLazyRecordStore::_getForCurrentOperation() const {
+    if (auto rs = _recordStore.load()) {
+        return rs;
+    }
+    return _get(getCurrentOperation());
+}
+
+const char* KVLazyRecordStore::name() const {
+    return _getForCurrentOperation()->name();
+}
+
+const std::string& KVLazyRecordStore::getIdent() const {
+    return _ident;
+}
+
+long long KVLazyRecordStore::dataSize(OperationContext* opCtx) const {
+    return _get(opCtx)->dataSize(opCtx);
+}
+
+long long KVLazyRecordStore::numRecords(OperationContext* opCtx) const {
+    return _get(opCtx)->numRecords(opCtx);
+}
+
+bool KVLazyRecordStore::isCapped() const {
+    return false;
+}
+
+void KVLazyRecordStore::setCappedCallback(CappedCallback* cb) {
+    _getForCurrentOperation()->setCappedCallback(cb);
+}
+
+int64_t KVLazyRecordStore::storageSize(OperationContext* opCtx,
+                                       BSONObjBuilder* extraInfo,
+                                       int infoLevel) const {
+    if (!isOpen() && !extraInfo) {
+        // Listing databases asks every collection for its size, which the engine can answer
+        // without opening the record store.
+        return _engine->getIdentSize(opCtx, _ident);
+    }
+    return _get(opCtx)->storageSize(opCtx, extraInfo, infoLevel);
+}
+
+RecordData KVLazyRecordStore::dataFor(OperationContext* opCtx, const RecordId& loc) const {
+    return _get(opCtx)->dataFor(opCtx, loc);
+}
+
+bool KVLazyRecordStore::findRecord(OperationContext* opCtx,
+                                   const RecordId& loc,
+                                   RecordData* out) const {
+    return _get(opCtx)->findRecord(opCtx, loc, out);
+}
+
+void KVLazyRecordStore::deleteRecord(OperationContext* opCtx, const RecordId& dl) {
+    _get(opCtx)->deleteRecord(opCtx, dl);
+}
+
+StatusWith<RecordId> KVLazyRecordStore::insertRecord(OperationContext* opCtx,
+                                                     const char* data,
+                                                     int len,
+                                                     Timestamp timestamp) {
+    return _get(opCtx)->insertRecord(opCtx, data, len, timestamp);
+}
+
+Status KVLazyRecordStore::insertRecords(OperationContext* opCtx,
+                                        std::vector<Record>* records,
+                                        std::vector<Timestamp>* timestamps) {
+    return _get(opCtx)->insertRecords(opCtx, records, timestamps);
+}
+
+std::unique_ptr<RecordStoreBulkBuilder> KVLazyRecordStore::makeBulkBuilder(
+    OperationContext* opCtx) {
+    return _get(opCtx)->makeBulkBuilder(opCtx);
+}
+
+Status KVLazyRecordStore::insertRecordsWithDocWriter(OperationContext* opCtx,
+                                                     const DocWriter* const* docs,
+                                                     const Timestamp* timestamps,
+                                                     size_t nDocs,
+                                                     RecordId* idsOut) {
+    return _get(opCtx)->insertRecordsWithDocWriter(opCtx, docs, timestamps, nDocs, idsOut);
+}
+
+Status KVLazyRecordStore::updateRecord(OperationContext* opCtx,
+                                       const RecordId& recordId,
+                                       const char* data,
+                                       int len) {
+    return _get(opCtx)->updateRecord(opCtx, recordId, data, len);
+}
+
+bool KVLazyRecordStore::updateWithDamagesSupported() const {
+    return _getForCurrentOperation()->updateWithDamagesSupported();
+}
+
+StatusWith<RecordData> KVLazyRecordStore::updateWithDamages(
+    OperationContext* opCtx,
+    const RecordId& loc,
+    const RecordData& oldRec,
+    const char* damageSource,
+    const mutablebson::DamageVector& damages) {
+    return _get(opCtx)->updateWithDamages(opCtx, loc, oldRec, damageSource, damages);
+}
+
+std::unique_ptr<SeekableRecordCursor> KVLazyRecordStore::getCursor(OperationContext* opCtx,
+                                                                   bool forward) const {
+    return _get(opCtx)->getCursor(opCtx, forward);
+}
+
+std::unique_ptr<RecordCursor> KVLazyRecordStore::getCursorForRepair(
+    OperationContext* opCtx) const {
+    return _get(opCtx)->getCursorForRepair(opCtx);
+}
+
+std::unique_ptr<RecordCursor> KVLazyRecordStore::getRandomCursor(OperationContext* opCtx) const {
+    return _get(opCtx)->getRandomCursor(opCtx);
+}
+
+Status KVLazyRecordStore::truncate(OperationContext* opCtx) {
+    return _get(opCtx)->truncate(opCtx);
+}
+
+void KVLazyRecordStore::cappedTruncateAfter(OperationContext* opCtx,
+                                            RecordId end,
+                                            bool inclusive) {
+    _get(opCtx)->cappedTruncateAfter(opCtx, end, inclusive);
+}
+
+bool KVLazyRecordStore::compactSupported() const {
+    return _getForCurrentOperation()->compactSupported();
+}
+
+bool KVLazyRecordStore::compactsInPlace() const {
+    return _getForCurrentOperation()->compactsInPlace();
+}
+
+Status KVLazyRecordStore::compact(OperationContext* opCtx,
+                                  RecordStoreCompactAdaptor* adaptor,
+                                  const CompactOptions* options,
+                                  CompactStats* stats) {
+    return _get(opCtx)->compact(opCtx, adaptor, options, stats);
+}
+
+StatusWith<bool> KVLazyRecordStore::compactStep(OperationContext* opCtx, Seconds timeout) {
+    return _get(opCtx)->compactStep(opCtx, timeout);
+}
+
+bool KVLazyRecordStore::isInRecordIdOrder() const {
+    return _getForCurrentOperation()->isInRecordIdOrder();
+}
+
+Status KVLazyRecordStore::validate(OperationContext* opCtx,
+                                   ValidateCmdLevel level,
+                                   ValidateAdaptor* adaptor,
+                                   ValidateResults* results,
+                                   BSONObjBuilder* output) {
+    return _get(opCtx)->validate(opCtx, level, adaptor, results, output);
+}
+
+void KVLazyRecordStore::appendCustomStats(OperationContext* opCtx,
+                                          BSONObjBuilder* result,
+                                          double scale) const {
+    _get(opCtx)->appendCustomStats(opCtx, result, scale);
+}
+
+Status KVLazyRecordStore::touch(OperationContext* opCtx, BSONObjBuilder* output) const {
+    return _get(opCtx)->touch(opCtx, output);
+}
+
+boost::optional<RecordId> KVLazyRecordStore::oplogStartHack(
+    OperationContext* opCtx, const RecordId& startingPosition) const {
+    return _get(opCtx)->oplogStartHack(opCtx, startingPosition);
+}
+
+Status KVLazyRecordStore::oplogDiskLocRegister(OperationContext* opCtx,
+                                               const Timestamp& opTime,
+                                               bool orderedCommit) {
+    return _get(opCtx)->oplogDiskLocRegister(opCtx, opTime, orderedCommit);
+}
+
+void KVLazyRecordStore::waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const {
+    _get(opCtx)->waitForAllEarlierOplogWritesToBeVisible(opCtx);
+}
+
+void KVLazyRecordStore::updateStatsAfterRepair(OperationContext* opCtx,
+                                               long long numRecords,
+                                               long long dataSize) {
+    _get(opCtx)->updateStatsAfterRepair(opCtx, numRecords, dataSize);
+}
+
+Status KVLazyRecordStore::updateCappedSize(OperationContext* opCtx, long long cappedSize) {
+    return _get(opCtx)->updateCappedSize(opCtx, cappedSize);
+}
+
+KVLazySortedDataInterface::KVLazySortedDataInterface(StringData ns,
+                                                     KVLazyOpenRegistry* registry,
+                                                     Opener opener)
+    : _ns(ns.toString()), _registry(registry), _opener(std::move(opener)) {
+    _registry->add(_ns, this);
+}
+
+KVLazySortedDataInterface::~KVLazySortedDataInterface() {
+    if (!_index.load()) {
+        _registry->remove(_ns, this);
+    }
+}
+
+void KVLazySortedDataInterface::open(OperationContext* opCtx) {
+    _get(opCtx);
+}
+
+SortedDataInterface* KVLazySortedDataInterface::_get(OperationContext* opCtx) const {
+    if (auto index = _index.load()) {
+        return index;
+    }
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_openMutex);
+        if (auto index = _index.load()) {
+            return index;
+        }
+        _owned = _opener(opCtx);
+        invariant(_owned);
+        _index.store(_owned.get());
+    }
+
+    _registry->remove(_ns, const_cast<KVLazySortedDataInterface*>(this));
+    return _index.load();
+}
+
+SortedDataBuilderInterface* KVLazySortedDataInterface::getBulkBuilder(OperationContext* opCtx,
+                                                                      bool dupsAllowed) {
+    return _get(opCtx)->getBulkBuilder(opCtx, dupsAllowed);
+}
+
+StatusWith<SpecialFormatInserted> KVLazySortedDataInterface::insert(OperationContext* opCtx,
+                                                                    const BSONObj& key,
+                                                                    const RecordId& loc,
+                                                                    bool dupsAllowed) {
+    return _get(opCtx)->insert(opCtx, key, loc, dupsAllowed);
+}
+
+void KVLazySortedDataInterface::unindex(OperationContext* opCtx,
+                                        const BSONObj& key,
+                                        const RecordId& loc,
+                                        bool dupsAllowed) {
+    _get(opCtx)->unindex(opCtx, key, loc, dupsAllowed);
+}
+
+Status KVLazySortedDataInterface::dupKeyCheck(OperationContext* opCtx,
+                                              const BSONObj& key,
+                                              const RecordId& loc) {
+    return _get(opCtx)->dupKeyCheck(opCtx, key, loc);
+}
+
+Status KVLazySortedDataInterface::compact(OperationContext* opCtx) {
+    return _get(opCtx)->compact(opCtx);
+}
+
+StatusWith<bool> KVLazySortedDataInterface::compactStep(OperationContext* opCtx,
+                                                        Seconds timeout) {
+    return _get(opCtx)->compactStep(opCtx, timeout);
+}
+
+void KVLazySortedDataInterface::fullValidate(OperationContext* opCtx,
+                                             long long* numKeysOut,
+                                             ValidateResults* fullResults) const {
+    _get(opCtx)->fullValidate(opCtx, numKeysOut, fullResults);
+}
+
+bool KVLazySortedDataInterface::appendCustomStats(OperationContext* opCtx,
+                                                  BSONObjBuilder* output,
+                                                  double scale) const {
+    return _get(opCtx)->appendCustomStats(opCtx, output, scale);
+}
+
+long long KVLazySortedDataInterface::getSpaceUsedBytes(OperationContext* opCtx) const {
+    return _get(opCtx)->getSpaceUsedBytes(opCtx);
+}
+
+bool KVLazySortedDataInterface::isEmpty(OperationContext* opCtx) {
+    return _get(opCtx)->isEmpty(opCtx);
+}
+
+Status KVLazySortedDataInterface::touch(OperationContext* opCtx) const {
+    return _get(opCtx)->touch(opCtx);
+}
+
+long long KVLazySortedDataInterface::numEntries(OperationContext* opCtx) const {
+    return _get(opCtx)->numEntries(opCtx);
+}
+
+std::unique_ptr<SortedDataInterface::Cursor> KVLazySortedDataInterface::newCursor(
+    OperationContext* opCtx, bool isForward) const {
+    return _get(opCtx)->newCursor(opCtx, isForward);
+}
+
+Status KVLazySortedDataInterface::initAsEmpty(OperationContext* opCtx) {
+    return _get(opCtx)->initAsEmpty(opCtx);
+}
+
+}  // namespace mongo
@@ -0,0 +1,240 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class KVEngine;
+
+/**
+ * Tracks the record stores and indexes that were loaded from the catalog without being opened, by
+ * namespace, so that they can be opened ahead of their first use. Entries remove themselves when
+ * they are opened or destroyed.
+ */
+class KVLazyOpenRegistry {
+public:
+    class Openable {
+    public:
+        virtual ~Openable() = default;
+
+        /**
+         * Opens the underlying record store or index if it hasn't been opened yet.
+         */
+        virtual void open(OperationContext* opCtx) = 0;
+    };
+
+    void add(const std::string& ns, Openable* openable);
+    void remove(const std::string& ns, Openable* openable);
+
+    /**
+     * Returns the unopened entries for 'ns'. The caller must hold a lock on the collection, which
+     * keeps them from being destroyed.
+     */
+    std::vector<Openable*> getUnopened(const std::string& ns) const;
+
+    size_t size() const;
+
+private:
+    mutable stdx::mutex _mutex;
+    std::multimap<std::string, Openable*> _unopened;
+};
+
+/**
+ * A RecordStore for an existing collection that only opens the storage engine's record store
+ * on first use. Only the namespace and ident, and the storage size, are available without opening
+ * it. Must not be used for capped collections, which are opened eagerly.
+ *
+ * Methods that don't take an OperationContext open the record store using the current client's
+ * operation.
+ */
+class KVLazyRecordStore final : public RecordStore, public KVLazyOpenRegistry::Openable {
+public:
+    using Opener = stdx::function<std::unique_ptr<RecordStore>(OperationContext*)>;
+
+    KVLazyRecordStore(StringData ns,
+                      StringData ident,
+                      KVEngine* engine,
+                      KVLazyOpenRegistry* registry,
+                      Opener opener);
+    ~KVLazyRecordStore();
+
+    void open(OperationContext* opCtx) final;
+
+    bool isOpen() const {
+        return _recordStore.load() != nullptr;
+    }
+
+    const char* name() const final;
+    const std::string& getIdent() const final;
+    long long dataSize(OperationContext* opCtx) const final;
+    long long numRecords(OperationContext* opCtx) const final;
+    bool isCapped() const final;
+    void setCappedCallback(CappedCallback* cb) final;
+    int64_t storageSize(OperationContext* opCtx,
+                        BSONObjBuilder* extraInfo = NULL,
+                        int infoLevel = 0) const final;
+    RecordData dataFor(OperationContext* opCtx, const RecordId& loc) const final;
+    bool findRecord(OperationContext* opCtx, const RecordId& loc, RecordData* out) const final;
+    void deleteRecord(OperationContext* opCtx, const RecordId& dl) final;
+    StatusWith<RecordId> insertRecord(OperationContext* opCtx,
+                                      const char* data,
+                                      int len,
+                                      Timestamp timestamp) final;
+    Status insertRecords(OperationContext* opCtx,
+                         std::vector<Record>* records,
+                         std::vector<Timestamp>* timestamps) final;
+    std::unique_ptr<RecordStoreBulkBuilder> makeBulkBuilder(OperationContext* opCtx) final;
+    Status insertRecordsWithDocWriter(OperationContext* opCtx,
+                                      const DocWriter* const* docs,
+                                      const Timestamp* timestamps,
+                                      size_t nDocs,
+                                      RecordId* idsOut = nullptr) final;
+    Status updateRecord(OperationContext* opCtx,
+                        const RecordId& recordId,
+                        const char* data,
+                        int len) final;
+    bool updateWithDamagesSupported() const final;
+    StatusWith<RecordData> updateWithDamages(OperationContext* opCtx,
+                                             const RecordId& loc,
+                                             const RecordData& oldRec,
+                                             const char* damageSource,
+                                             const mutablebson::DamageVector& damages) final;
+    std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* opCtx,
+                                                    bool forward = true) const final;
+    std::unique_ptr<RecordCursor> getCursorForRepair(OperationContext* opCtx) const final;
+    std::unique_ptr<RecordCursor> getRandomCursor(OperationContext* opCtx) const final;
+    Status truncate(OperationContext* opCtx) final;
+    void cappedTruncateAfter(OperationContext* opCtx, RecordId end, bool inclusive) final;
+    bool compactSupported() const final;
+    bool compactsInPlace() const final;
+    Status compact(OperationContext* opCtx,
+                   RecordStoreCompactAdaptor* adaptor,
+                   const CompactOptions* options,
+                   CompactStats* stats) final;
+    StatusWith<bool> compactStep(OperationContext* opCtx, Seconds timeout) final;
+    bool isInRecordIdOrder() const final;
+    Status validate(OperationContext* opCtx,
+                    ValidateCmdLevel level,
+                    ValidateAdaptor* adaptor,
+                    ValidateResults* results,
+                    BSONObjBuilder* output) final;
+    void appendCustomStats(OperationContext* opCtx,
+                           BSONObjBuilder* result,
+                           double scale) const final;
+    Status touch(OperationContext* opCtx, BSONObjBuilder* output) const final;
+    boost::optional<RecordId> oplogStartHack(OperationContext* opCtx,
+                                             const RecordId& startingPosition) const final;
+    Status oplogDiskLocRegister(OperationContext* opCtx,
+                                const Timestamp& opTime,
+                                bool orderedCommit) final;
+    void waitForAllEarlierOplogWritesToBeVisible(OperationContext* opCtx) const final;
+    void updateStatsAfterRepair(OperationContext* opCtx,
+                                long long numRecords,
+                                long long dataSize) final;
+    Status updateCappedSize(OperationContext* opCtx, long long cappedSize) final;
+
+private:
+    RecordStore* _get(OperationContext* opCtx) const;
+    RecordStore* _getForCurrentOperation() const;
+
+    const std::string _ident;
+    KVEngine* const _engine;
+    KVLazyOpenRegistry* const _registry;
+    const Opener _opener;
+
+    mutable stdx::mutex _openMutex;
+    mutable std::unique_ptr<RecordStore> _owned;
+    mutable AtomicWord<RecordStore*> _recordStore{nullptr};
+};
+
+/**
+ * A SortedDataInterface for an existing index that only opens the storage engine's index on first
+ * use.
+ */
+class KVLazySortedDataInterface final : public SortedDataInterface,
+                                        public KVLazyOpenRegistry::Openable {
+public:
+    using Opener = stdx::function<std::unique_ptr<SortedDataInterface>(OperationContext*)>;
+
+    KVLazySortedDataInterface(StringData ns, KVLazyOpenRegistry* registry, Opener opener);
+    ~KVLazySortedDataInterface();
+
+    void open(OperationContext* opCtx) final;
+
+    SortedDataBuilderInterface* getBulkBuilder(OperationContext* opCtx, bool dupsAllowed) final;
+    StatusWith<SpecialFormatInserted> insert(OperationContext* opCtx,
+                                             const BSONObj& key,
+                                             const RecordId& loc,
+                                             bool dupsAllowed) final;
+    void unindex(OperationContext* opCtx,
+                 const BSONObj& key,
+                 const RecordId& loc,
+                 bool dupsAllowed) final;
+    Status dupKeyCheck(OperationContext* opCtx, const BSONObj& key, const RecordId& loc) final;
+    Status compact(OperationContext* opCtx) final;
+    StatusWith<bool> compactStep(OperationContext* opCtx, Seconds timeout) final;
+    void fullValidate(OperationContext* opCtx,
+                      long long* numKeysOut,
+                      ValidateResults* fullResults) const final;
+    bool appendCustomStats(OperationContext* opCtx,
+                           BSONObjBuilder* output,
+                           double scale) const final;
+    long long getSpaceUsedBytes(OperationContext* opCtx) const final;
+    bool isEmpty(OperationContext* opCtx) final;
+    Status touch(OperationContext* opCtx) const final;
+    long long numEntries(OperationContext* opCtx) const final;
+    std::unique_ptr<SortedDataInterface::Cursor> newCursor(OperationContext* opCtx,
+                                                           bool isForward = true) const final;
+    Status initAsEmpty(OperationContext* opCtx) final;
+
+private:
+    SortedDataInterface* _get(OperationContext* opCtx) const;
+
+    const std::string _ns;
+    KVLazyOpenRegistry* const _registry;
+    const Opener _opener;
+
+    mutable stdx::mutex _openMutex;
+    mutable std::unique_ptr<SortedDataInterface> _owned;
+    mutable AtomicWord<SortedDataInterface*> _index{nullptr};
+};
+
+}  // namespace mongo
@@ -0,0 +1,120 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/kv/kv_lazy_open.h"
+
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_engine.h"
+#include "mongo/db/storage/kv/kv_prefix.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class KVLazyOpenTest : public unittest::Test {
+public:
+    void setUp() override {
+        OperationContextNoop opCtx(_engine.newRecoveryUnit());
+        ASSERT_OK(_engine.createGroupedRecordStore(
+            &opCtx, _ns, _ident, CollectionOptions(), KVPrefix::kNotPrefixed));
+    }
+
+    std::unique_ptr<KVLazyRecordStore> makeLazyRecordStore() {
+        return stdx::make_unique<KVLazyRecordStore>(
+            _ns, _ident, &_engine, &_registry, [this](OperationContext* opCtx) {
+                ++_numOpens;
+                return _engine.getGroupedRecordStore(
+                    opCtx, _ns, _ident, CollectionOptions(), KVPrefix::kNotPrefixed);
+            });
+    }
+
+protected:
+    const std::string _ns = "db.coll";
+    const std::string _ident = "collection-db-coll";
+
+    EphemeralForTestEngine _engine;
+    KVLazyOpenRegistry _registry;
+    int _numOpens = 0;
+};
+
+TEST_F(KVLazyOpenTest, RecordStoreIsNotOpenedUntilUsed) {
+    auto rs = makeLazyRecordStore();
+    ASSERT_EQUALS(1U, _registry.size());
+    ASSERT_EQUALS(1U, _registry.getUnopened(_ns).size());
+
+    OperationContextNoop opCtx(_engine.newRecoveryUnit());
+    ASSERT_EQUALS(_ns, rs->ns());
+    ASSERT_EQUALS(_ident, rs->getIdent());
+    ASSERT_FALSE(rs->isCapped());
+    rs->storageSize(&opCtx);
+    ASSERT_FALSE(rs->isOpen());
+    ASSERT_EQUALS(0, _numOpens);
+
+    {
+        WriteUnitOfWork wuow(&opCtx);
+        ASSERT_OK(rs->insertRecord(&opCtx, "abc", 4, Timestamp()).getStatus());
+        wuow.commit();
+    }
+    ASSERT_TRUE(rs->isOpen());
+    ASSERT_EQUALS(1, _numOpens);
+    ASSERT_EQUALS(0U, _registry.size());
+
+    ASSERT_EQUALS(1, rs->numRecords(&opCtx));
+    ASSERT_EQUALS(1, _numOpens);
+}
+
+TEST_F(KVLazyOpenTest, OpenThroughRegistry) {
+    auto rs = makeLazyRecordStore();
+
+    OperationContextNoop opCtx(_engine.newRecoveryUnit());
+    for (auto openable : _registry.getUnopened(_ns)) {
+        openable->open(&opCtx);
+    }
+    ASSERT_TRUE(rs->isOpen());
+    ASSERT_EQUALS(1, _numOpens);
+    ASSERT_EQUALS(0U, _registry.size());
+
+    rs->open(&opCtx);
+    ASSERT_EQUALS(1, _numOpens);
+}
+
+TEST_F(KVLazyOpenTest, UnopenedRecordStoreUnregistersOnDestruction) {
+    auto rs = makeLazyRecordStore();
+    ASSERT_EQUALS(1U, _registry.size());
+    rs.reset();
+    ASSERT_EQUALS(0U, _registry.size());
+    ASSERT_EQUALS(0, _numOpens);
+}
+
+}  // namespace
+}  // namespace mongo
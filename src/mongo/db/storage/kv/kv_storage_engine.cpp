@@ -35,17 +35,24 @@
 #include <algorithm>
 
 #include "mongo/db/catalog/catalog_control.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/kv/kv_catalog_feature_tracker.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/storage_repair_observer.h"
+#include "mongo/db/storage/temporary_record_store.h"
 #include "mongo/db/unclean_shutdown.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -55,7 +62,44 @@ using std::vector;
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
 const auto kCatalogLogLevel = logger::LogSeverity::Debug(2);
-}
+
+// How long the catalog warmer waits for a collection's locks before yielding to other operations
+// and trying again.
+const Milliseconds kCatalogWarmerLockTimeout(100);
+
+/**
+ * A TemporaryRecordStore backed by a table of the KVEngine that is not in the catalog.
+ */
+class TemporaryKVRecordStore : public TemporaryRecordStore {
+public:
+    TemporaryKVRecordStore(KVEngine* kvEngine, std::string ident, std::unique_ptr<RecordStore> rs)
+        : TemporaryRecordStore(std::move(rs)), _kvEngine(kvEngine), _ident(std::move(ident)) {}
+
+    ~TemporaryKVRecordStore() override {
+        if (!_deleted) {
+            log() << "Leaving temporary table " << _ident << " to be dropped on the next startup";
+        }
+    }
+
+    void deleteTemporaryTable(OperationContext* opCtx) override {
+        invariant(!opCtx->lockState()->inAWriteUnitOfWork());
+
+        // The RecordStore must go before its table.
+        _rs.reset();
+        auto status = _kvEngine->dropIdent(opCtx, _ident);
+        if (!status.isOK()) {
+            // The table is dropped on the next startup anyway.
+            warning() << "Failed to drop temporary table " << _ident << ": " << status;
+        }
+        _deleted = true;
+    }
+
+private:
+    KVEngine* const _kvEngine;
+    const std::string _ident;
+    bool _deleted = false;
+};
+}  // namespace
 
 class KVStorageEngine::RemoveDBChange : public RecoveryUnit::Change {
 public:
@@ -85,11 +129,16 @@ KVStorageEngine::KVStorageEngine(
       _engine(engine),
       _supportsDocLocking(_engine->supportsDocLocking()),
       _supportsDBLocking(_engine->supportsDBLocking()),
-      _supportsCappedCollections(_engine->supportsCappedCollections()) {
+      _supportsCappedCollections(_engine->supportsCappedCollections()),
+      _supportsClusteredCollections(_engine->supportsClusteredCollections()) {
     uassert(28601,
             "Storage engine does not support --directoryperdb",
             !(options.directoryPerDB && !engine->supportsDirectoryPerDB()));
 
+    if (options.lazyCatalogLoading && !options.forRepair) {
+        _lazyOpenRegistry = stdx::make_unique<KVLazyOpenRegistry>();
+    }
+
     OperationContextNoop opCtx(_engine->newRecoveryUnit());
     loadCatalog(&opCtx);
 }
@@ -196,6 +245,28 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
         }
     }
 
+    // Opening a record store reads its table's metadata, which dominates loading the catalog on
+    // nodes with many collections. Collections opened here must be ones the loop below opens
+    // eagerly; the local database is left to it, since the oplog's record store starts background
+    // work when it is opened.
+    std::map<std::string, std::unique_ptr<RecordStore>> preopened;
+    if (_options.catalogLoadThreads > 1 && !_options.forRepair && !_lazyOpenRegistry) {
+        std::vector<std::string> toOpen;
+        for (const auto& coll : collectionsKnownToCatalog) {
+            if (NamespaceString(coll).db() == "local") {
+                continue;
+            }
+            if (loadingFromUncleanShutdownOrRepair &&
+                !std::binary_search(identsKnownToStorageEngine.begin(),
+                                    identsKnownToStorageEngine.end(),
+                                    _catalog->getCollectionIdent(coll))) {
+                continue;
+            }
+            toOpen.push_back(coll);
+        }
+        preopened = _openRecordStoresInParallel(opCtx, toOpen);
+    }
+
     KVPrefix maxSeenPrefix = KVPrefix::kNotPrefixed;
     for (const auto& coll : collectionsKnownToCatalog) {
         NamespaceString nss(coll);
@@ -238,7 +309,12 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
             db = _databaseCatalogEntryFactory(dbName, this).release();
         }
 
-        db->initCollection(opCtx, coll, _options.forRepair);
+        std::unique_ptr<RecordStore> rs;
+        auto preopenedIt = preopened.find(coll);
+        if (preopenedIt != preopened.end()) {
+            rs = std::move(preopenedIt->second);
+        }
+        db->initCollection(opCtx, coll, _options.forRepair, std::move(rs));
         auto maxPrefixForCollection = _catalog->getMetaData(opCtx, coll).getMaxPrefix();
         maxSeenPrefix = std::max(maxSeenPrefix, maxPrefixForCollection);
 
@@ -255,6 +331,62 @@ void KVStorageEngine::loadCatalog(OperationContext* opCtx) {
     startingAfterUncleanShutdown(getGlobalServiceContext()) = false;
 }
 
+std::map<std::string, std::unique_ptr<RecordStore>> KVStorageEngine::_openRecordStoresInParallel(
+    OperationContext* opCtx, const std::vector<std::string>& namespaces) {
+    std::map<std::string, std::unique_ptr<RecordStore>> opened;
+    const size_t numThreads = std::min(_options.catalogLoadThreads, namespaces.size());
+    if (numThreads <= 1) {
+        return opened;
+    }
+
+    // Read the metadata up front so that the threads only touch the engine.
+    std::vector<BSONCollectionCatalogEntry::MetaData> metadata;
+    std::vector<std::string> idents;
+    for (const auto& ns : namespaces) {
+        metadata.push_back(_catalog->getMetaData(opCtx, ns));
+        idents.push_back(_catalog->getCollectionIdent(ns));
+    }
+
+    Timer timer;
+    std::vector<std::unique_ptr<RecordStore>> recordStores(namespaces.size());
+
+    ThreadPool::Options poolOptions;
+    poolOptions.poolName = "catalogLoad";
+    poolOptions.minThreads = 0;
+    poolOptions.maxThreads = numThreads;
+    ThreadPool pool(poolOptions);
+    pool.startup();
+    for (size_t thread = 0; thread < numThreads; ++thread) {
+        fassert(50963, pool.schedule([&, thread] {
+            OperationContextNoop threadOpCtx(_engine->newRecoveryUnit());
+            for (size_t i = thread; i < namespaces.size(); i += numThreads) {
+                try {
+                    recordStores[i] = _engine->getGroupedRecordStore(&threadOpCtx,
+                                                                     namespaces[i],
+                                                                     idents[i],
+                                                                     metadata[i].options,
+                                                                     metadata[i].prefix);
+                } catch (const DBException& ex) {
+                    LOG(1) << "Failed to open " << namespaces[i]
+                           << " in parallel, retrying during catalog load: " << redact(ex);
+                }
+                threadOpCtx.recoveryUnit()->abandonSnapshot();
+            }
+        }));
+    }
+    pool.shutdown();
+    pool.join();
+
+    for (size_t i = 0; i < namespaces.size(); ++i) {
+        if (recordStores[i]) {
+            opened.emplace(namespaces[i], std::move(recordStores[i]));
+        }
+    }
+    log() << "Opened " << opened.size() << " collections on " << numThreads << " threads in "
+          << timer.millis() << "ms";
+    return opened;
+}
+
 void KVStorageEngine::closeCatalog(OperationContext* opCtx) {
     dassert(opCtx->lockState()->isLocked());
     if (shouldLog(::mongo::logger::LogComponent::kStorageRecovery, kCatalogLogLevel)) {
@@ -349,6 +481,16 @@ KVStorageEngine::reconcileCatalogAndIdents(OperationContext* opCtx) {
             continue;
         }
 
+        // Internal idents are never in the catalog, and only ever hold data that does not need
+        // to survive a restart.
+        if (_catalog->isInternalIdent(it)) {
+            log() << "Dropping internal ident: " << it;
+            WriteUnitOfWork wuow(opCtx);
+            fassert(50961, _engine->dropIdent(opCtx, it));
+            wuow.commit();
+            continue;
+        }
+
         if (!_catalog->isUserDataIdent(it)) {
             continue;
         }
@@ -453,6 +595,11 @@ KVStorageEngine::reconcileCatalogAndIdents(OperationContext* opCtx) {
 }
 
 void KVStorageEngine::cleanShutdown() {
+    if (_catalogWarmer.joinable()) {
+        _stopCatalogWarmer.store(true);
+        _catalogWarmer.join();
+    }
+
     for (DBMap::const_iterator it = _dbs.begin(); it != _dbs.end(); ++it) {
         delete it->second;
     }
@@ -467,7 +614,62 @@ void KVStorageEngine::cleanShutdown() {
 
 KVStorageEngine::~KVStorageEngine() {}
 
-void KVStorageEngine::finishInit() {}
+void KVStorageEngine::finishInit() {
+    if (!_lazyOpenRegistry || !_options.warmLazyCatalog || _lazyOpenRegistry->size() == 0) {
+        return;
+    }
+
+    // Recently created collections are the most likely to be in use, so open them first.
+    std::vector<std::string> namespaces;
+    for (auto& ns : _catalog->getAllCollectionsNewestFirst()) {
+        if (!_lazyOpenRegistry->getUnopened(ns).empty()) {
+            namespaces.push_back(std::move(ns));
+        }
+    }
+
+    log() << "Opening " << namespaces.size() << " lazily loaded collections in the background";
+    _catalogWarmer = stdx::thread([ this, namespaces = std::move(namespaces) ]() mutable {
+        _warmCatalog(std::move(namespaces));
+    });
+}
+
+void KVStorageEngine::_warmCatalog(std::vector<std::string> namespaces) {
+    Client::initThread("catalogWarmer");
+
+    Timer timer;
+    size_t numOpened = 0;
+    for (const auto& ns : namespaces) {
+        while (!_stopCatalogWarmer.load()) {
+            try {
+                auto opCtx = cc().makeOperationContext();
+                const NamespaceString nss(ns);
+
+                // Give up the locks quickly when they are contended, so that the warmer never
+                // holds up a user operation for long.
+                const auto deadline = Date_t::now() + kCatalogWarmerLockTimeout;
+                Lock::DBLock dbLock(opCtx.get(), nss.db(), MODE_IS, deadline);
+                if (!dbLock.isLocked()) {
+                    continue;
+                }
+                Lock::CollectionLock collLock(opCtx->lockState(), ns, MODE_IS, deadline);
+                if (!collLock.isLocked()) {
+                    continue;
+                }
+
+                for (auto openable : _lazyOpenRegistry->getUnopened(ns)) {
+                    openable->open(opCtx.get());
+                }
+                ++numOpened;
+            } catch (const DBException& ex) {
+                warning() << "Catalog warmer failed to open " << ns << ": " << redact(ex);
+            }
+            break;
+        }
+    }
+
+    log() << "Catalog warmer opened " << numOpened << " of " << namespaces.size()
+          << " lazily loaded collections in " << timer.millis() << "ms";
+}
 
 RecoveryUnit* KVStorageEngine::newRecoveryUnit() {
     if (!_engine) {
@@ -606,6 +808,17 @@ SnapshotManager* KVStorageEngine::getSnapshotManager() const {
     return _engine->getSnapshotManager();
 }
 
+std::unique_ptr<TemporaryRecordStore> KVStorageEngine::makeTemporaryRecordStore(
+    OperationContext* opCtx) {
+    std::string ident = _catalog->newInternalIdent();
+    uassertStatusOK(_engine->createRecordStore(opCtx, ident, ident, CollectionOptions()));
+    auto rs = _engine->getRecordStore(opCtx, ident, ident, CollectionOptions());
+    invariant(rs);
+
+    LOG(2) << "created temporary record store: " << ident;
+    return stdx::make_unique<TemporaryKVRecordStore>(getEngine(), std::move(ident), std::move(rs));
+}
+
 Status KVStorageEngine::repairRecordStore(OperationContext* opCtx, const std::string& ns) {
     auto repairObserver = StorageRepairObserver::get(getGlobalServiceContext());
     invariant(repairObserver->isIncomplete());
@@ -38,11 +38,14 @@
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/kv/kv_catalog.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry_base.h"
+#include "mongo/db/storage/kv/kv_lazy_open.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 
 namespace mongo {
 
@@ -53,6 +56,9 @@ struct KVStorageEngineOptions {
     bool directoryPerDB = false;
     bool directoryForIndexes = false;
     bool forRepair = false;
+    bool lazyCatalogLoading = false;
+    bool warmLazyCatalog = true;
+    size_t catalogLoadThreads = 1;
 };
 
 /*
@@ -100,6 +106,10 @@ public:
         return _supportsCappedCollections;
     }
 
+    virtual bool supportsClusteredCollections() const {
+        return _supportsClusteredCollections;
+    }
+
     virtual Status closeDatabase(OperationContext* opCtx, StringData db);
 
     virtual Status dropDatabase(OperationContext* opCtx, StringData db);
@@ -120,6 +130,9 @@ public:
 
     virtual Status repairRecordStore(OperationContext* opCtx, const std::string& ns);
 
+    std::unique_ptr<TemporaryRecordStore> makeTemporaryRecordStore(
+        OperationContext* opCtx) override;
+
     virtual void cleanShutdown();
 
     virtual void setStableTimestamp(Timestamp stableTimestamp,
@@ -169,6 +182,14 @@ public:
         return _catalog.get();
     }
 
+    /**
+     * Returns the collections and indexes that were loaded from the catalog but haven't been
+     * opened yet, or nullptr if the catalog isn't loaded lazily.
+     */
+    KVLazyOpenRegistry* getLazyOpenRegistry() {
+        return _lazyOpenRegistry.get();
+    }
+
     /**
      * Drop abandoned idents. Returns a parallel list of index name, index spec pairs to rebuild.
      */
@@ -213,6 +234,20 @@ private:
 
     void _dumpCatalog(OperationContext* opCtx);
 
+    /**
+     * Opens the record stores of the collections in 'namespaces' on '_options.catalogLoadThreads'
+     * threads, and returns them by namespace. Record stores that fail to open are left out, so
+     * that the error surfaces when loadCatalog() opens them again itself.
+     */
+    std::map<std::string, std::unique_ptr<RecordStore>> _openRecordStoresInParallel(
+        OperationContext* opCtx, const std::vector<std::string>& namespaces);
+
+    /**
+     * Opens the lazily loaded collections in 'namespaces', in order, until they are all open or
+     * shutdown begins. Runs on '_catalogWarmer'.
+     */
+    void _warmCatalog(std::vector<std::string> namespaces);
+
     class RemoveDBChange;
 
     stdx::function<KVDatabaseCatalogEntryFactory> _databaseCatalogEntryFactory;
@@ -225,8 +260,13 @@ private:
     const bool _supportsDocLocking;
     const bool _supportsDBLocking;
     const bool _supportsCappedCollections;
+    const bool _supportsClusteredCollections;
     Timestamp _initialDataTimestamp = Timestamp::kAllowUnstableCheckpointsSentinel;
 
+    // Declared before the catalog entries so that it outlives the record stores and indexes
+    // registered with it.
+    std::unique_ptr<KVLazyOpenRegistry> _lazyOpenRegistry;
+
     std::unique_ptr<RecordStore> _catalogRecordStore;
     std::unique_ptr<KVCatalog> _catalog;
 
@@ -236,5 +276,8 @@ private:
 
     // Flag variable that states if the storage engine is in backup mode.
     bool _inBackupMode = false;
+
+    stdx::thread _catalogWarmer;
+    AtomicBool _stopCatalogWarmer{false};
 };
 }  // namespace mongo
@@ -374,5 +374,39 @@ TEST_F(KVStorageEngineTest, LoadCatalogDropsOrphans) {
     NamespaceString orphanNs = NamespaceString("local.orphan." + identNs);
     ASSERT(!collectionExists(opCtx.get(), orphanNs));
 }
+TEST_F(KVStorageEngineTest, LoadCatalogOpensRecordStoresInParallel) {
+    auto opCtx = cc().makeOperationContext();
+
+    KVStorageEngineOptions options;
+    options.catalogLoadThreads = 4;
+    KVStorageEngine storageEngine(new EphemeralForTestEngine(), options);
+
+    std::vector<NamespaceString> namespaces;
+    for (int i = 0; i < 10; ++i) {
+        NamespaceString nss("db" + std::to_string(i % 3), "coll" + std::to_string(i));
+        AutoGetDb db(opCtx.get(), nss.db(), LockMode::MODE_X);
+        DatabaseCatalogEntry* dbce = storageEngine.getDatabaseCatalogEntry(opCtx.get(), nss.db());
+        ASSERT_OK(dbce->createCollection(opCtx.get(), nss.ns(), CollectionOptions(), false));
+        namespaces.push_back(nss);
+    }
+
+    {
+        Lock::GlobalWrite writeLock(opCtx.get(), Date_t::max(), Lock::InterruptBehavior::kThrow);
+        storageEngine.closeCatalog(opCtx.get());
+        storageEngine.loadCatalog(opCtx.get());
+    }
+
+    for (const auto& nss : namespaces) {
+        DatabaseCatalogEntry* dbce = storageEngine.getDatabaseCatalogEntry(opCtx.get(), nss.db());
+        CollectionCatalogEntry* cce = dbce->getCollectionCatalogEntry(nss.ns());
+        ASSERT(cce);
+        RecordStore* rs = dbce->getRecordStore(nss.ns());
+        ASSERT(rs);
+        ASSERT_EQUALS(nss.ns(), rs->ns());
+    }
+
+    storageEngine.cleanShutdown();
+}
+
 }  // namespace
 }  // namespace mongo
@@ -102,14 +102,14 @@ StatusWith<SpecialFormatInserted> MobileIndex::doInsert(OperationContext* opCtx,
     }
 
     std::string insertQuery = "INSERT INTO \"" + _ident + "\" (key, value) VALUES (?, ?);";
-    SqliteStatement insertStmt(*session, insertQuery);
+    auto insertStmt = session->getStatementCache()->get(*session, insertQuery);
 
-    insertStmt.bindBlob(0, key.getBuffer(), key.getSize());
-    insertStmt.bindBlob(1, value.getBuffer(), value.getSize());
+    insertStmt->bindBlob(0, key.getBuffer(), key.getSize());
+    insertStmt->bindBlob(1, value.getBuffer(), value.getSize());
 
-    int status = insertStmt.step();
+    int status = insertStmt->step();
     if (status == SQLITE_CONSTRAINT) {
-        insertStmt.setExceptionStatus(status);
+        insertStmt->setExceptionStatus(status);
         if (isUnique()) {
             // Return error if duplicate key inserted in a unique index.
             BSONObj bson =
@@ -150,13 +150,13 @@ void MobileIndex::_doDelete(OperationContext* opCtx, const KeyString& key, KeySt
         deleteQuery << " AND value = ?";
     }
     deleteQuery << ";";
-    SqliteStatement deleteStmt(*session, deleteQuery);
+    auto deleteStmt = session->getStatementCache()->get(*session, deleteQuery);
 
-    deleteStmt.bindBlob(0, key.getBuffer(), key.getSize());
+    deleteStmt->bindBlob(0, key.getBuffer(), key.getSize());
     if (value) {
-        deleteStmt.bindBlob(1, value->getBuffer(), value->getSize());
+        deleteStmt->bindBlob(1, value->getBuffer(), value->getSize());
     }
-    deleteStmt.step(SQLITE_DONE);
+    deleteStmt->step(SQLITE_DONE);
 }
 
 /**
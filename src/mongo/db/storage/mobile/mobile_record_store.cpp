@@ -193,15 +193,7 @@ MobileRecordStore::MobileRecordStore(OperationContext* opCtx,
             "Capped Collections are not supported by the mobile storage engine",
             !options.capped);
 
-    // Determines the nextId to be used for a new record.
-    MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx);
-    std::string maxRecIdQuery = "SELECT IFNULL(MAX(rec_id), 0) FROM \"" + _ident + "\";";
-    SqliteStatement maxRecIdStmt(*session, maxRecIdQuery);
-
-    maxRecIdStmt.step(SQLITE_ROW);
-
-    long long nextId = maxRecIdStmt.getColInt(0);
-    _nextIdNum.store(nextId + 1);
+    // The id for the next new record is looked up on the first insert, see _nextId().
 }
 
 const char* MobileRecordStore::name() const {
@@ -289,41 +281,64 @@ void MobileRecordStore::deleteRecord(OperationContext* opCtx, const RecordId& re
     MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx, false);
     std::string dataSizeQuery =
         "SELECT IFNULL(LENGTH(data), 0) FROM \"" + _ident + "\" WHERE rec_id = ?;";
-    SqliteStatement dataSizeStmt(*session, dataSizeQuery);
-    dataSizeStmt.bindInt(0, recId.repr());
-    dataSizeStmt.step(SQLITE_ROW);
+    auto dataSizeStmt = session->getStatementCache()->get(*session, dataSizeQuery);
+    dataSizeStmt->bindInt(0, recId.repr());
+    dataSizeStmt->step(SQLITE_ROW);
 
-    int64_t dataSizeBefore = dataSizeStmt.getColInt(0);
+    int64_t dataSizeBefore = dataSizeStmt->getColInt(0);
     _changeNumRecs(opCtx, -1);
     _changeDataSize(opCtx, -dataSizeBefore);
 
     std::string deleteQuery = "DELETE FROM \"" + _ident + "\" WHERE rec_id = ?;";
-    SqliteStatement deleteStmt(*session, deleteQuery);
-    deleteStmt.bindInt(0, recId.repr());
-    deleteStmt.step(SQLITE_DONE);
+    auto deleteStmt = session->getStatementCache()->get(*session, deleteQuery);
+    deleteStmt->bindInt(0, recId.repr());
+    deleteStmt->step(SQLITE_DONE);
 }
 
 StatusWith<RecordId> MobileRecordStore::insertRecord(OperationContext* opCtx,
                                                      const char* data,
                                                      int len,
                                                      Timestamp) {
-    // Inserts record into SQLite table (or replaces if duplicate record id).
     MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx, false);
 
     _changeNumRecs(opCtx, 1);
     _changeDataSize(opCtx, len);
 
-    std::string insertQuery =
-        "INSERT OR REPLACE INTO \"" + _ident + "\"(rec_id, data) VALUES(?, ?);";
-    SqliteStatement insertStmt(*session, insertQuery);
-    RecordId recId = _nextId();
-    insertStmt.bindInt(0, recId.repr());
-    insertStmt.bindBlob(1, data, len);
-    insertStmt.step(SQLITE_DONE);
+    auto insertStmt = session->getStatementCache()->get(*session, _insertQuery());
+    RecordId recId = _nextId(session);
+    insertStmt->bindInt(0, recId.repr());
+    insertStmt->bindBlob(1, data, len);
+    insertStmt->step(SQLITE_DONE);
 
     return StatusWith<RecordId>(recId);
 }
 
+Status MobileRecordStore::insertRecords(OperationContext* opCtx,
+                                        std::vector<Record>* records,
+                                        std::vector<Timestamp>* timestamps) {
+    // All of the records are written by the one insert statement, and the record count and data
+    // size are adjusted once for the whole batch.
+    MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx, false);
+
+    int64_t totalSize = 0;
+    for (auto&& record : *records) {
+        totalSize += record.data.size();
+    }
+    _changeNumRecs(opCtx, records->size());
+    _changeDataSize(opCtx, totalSize);
+
+    auto insertStmt = session->getStatementCache()->get(*session, _insertQuery());
+    for (auto&& record : *records) {
+        record.id = _nextId(session);
+        insertStmt->bindInt(0, record.id.repr());
+        insertStmt->bindBlob(1, record.data.data(), record.data.size());
+        insertStmt->step(SQLITE_DONE);
+        insertStmt->reset();
+    }
+
+    return Status::OK();
+}
+
 Status MobileRecordStore::insertRecordsWithDocWriter(OperationContext* opCtx,
                                                      const DocWriter* const* docs,
                                                      const Timestamp* timestamps,
@@ -335,13 +350,24 @@ Status MobileRecordStore::insertRecordsWithDocWriter(OperationContext* opCtx,
         totalSize += docs[i]->documentSize();
     }
 
+    MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx, false);
+    _changeNumRecs(opCtx, nDocs);
+    _changeDataSize(opCtx, totalSize);
+
     std::unique_ptr<char[]> buffer(new char[totalSize]);
     char* pos = buffer.get();
+    auto insertStmt = session->getStatementCache()->get(*session, _insertQuery());
     for (size_t i = 0; i < nDocs; i++) {
         docs[i]->writeDocument(pos);
         size_t docLen = docs[i]->documentSize();
-        StatusWith<RecordId> res = insertRecord(opCtx, pos, docLen, timestamps[i]);
-        idsOut[i] = res.getValue();
+        RecordId recId = _nextId(session);
+        insertStmt->bindInt(0, recId.repr());
+        insertStmt->bindBlob(1, pos, docLen);
+        insertStmt->step(SQLITE_DONE);
+        insertStmt->reset();
+        if (idsOut) {
+            idsOut[i] = recId;
+        }
         pos += docLen;
     }
 
@@ -355,18 +381,18 @@ Status MobileRecordStore::updateRecord(OperationContext* opCtx,
     MobileSession* session = MobileRecoveryUnit::get(opCtx)->getSession(opCtx, false);
     std::string dataSizeQuery =
         "SELECT IFNULL(LENGTH(data), 0) FROM \"" + _ident + "\" WHERE rec_id = ?;";
-    SqliteStatement dataSizeStmt(*session, dataSizeQuery);
-    dataSizeStmt.bindInt(0, recId.repr());
-    dataSizeStmt.step(SQLITE_ROW);
+    auto dataSizeStmt = session->getStatementCache()->get(*session, dataSizeQuery);
+    dataSizeStmt->bindInt(0, recId.repr());
+    dataSizeStmt->step(SQLITE_ROW);
 
-    int64_t dataSizeBefore = dataSizeStmt.getColInt(0);
+    int64_t dataSizeBefore = dataSizeStmt->getColInt(0);
     _changeDataSize(opCtx, -dataSizeBefore + len);
 
     std::string updateQuery = "UPDATE \"" + _ident + "\" SET data = ? " + "WHERE rec_id = ?;";
-    SqliteStatement updateStmt(*session, updateQuery);
-    updateStmt.bindBlob(0, data, len);
-    updateStmt.bindInt(1, recId.repr());
-    updateStmt.step(SQLITE_DONE);
+    auto updateStmt = session->getStatementCache()->get(*session, updateQuery);
+    updateStmt->bindBlob(0, data, len);
+    updateStmt->bindInt(1, recId.repr());
+    updateStmt->step(SQLITE_DONE);
 
     return Status::OK();
 }
@@ -516,7 +542,26 @@ int64_t MobileRecordStore::storageSize(OperationContext* opCtx,
     return dataSize(opCtx);
 }
 
-RecordId MobileRecordStore::_nextId() {
+std::string MobileRecordStore::_insertQuery() const {
+    // Inserts record into SQLite table (or replaces if duplicate record id).
+    return "INSERT OR REPLACE INTO \"" + _ident + "\"(rec_id, data) VALUES(?, ?);";
+}
+
+RecordId MobileRecordStore::_nextId(MobileSession* session) {
+    if (!_isNextIdInitialized.load()) {
+        stdx::lock_guard<stdx::mutex> lock(_nextIdMutex);
+        if (!_isNextIdInitialized.load()) {
+            std::string maxRecIdQuery = "SELECT IFNULL(MAX(rec_id), 0) FROM \"" + _ident + "\";";
+            SqliteStatement maxRecIdStmt(*session, maxRecIdQuery);
+
+            maxRecIdStmt.step(SQLITE_ROW);
+
+            long long nextId = maxRecIdStmt.getColInt(0);
+            _nextIdNum.store(nextId + 1);
+            _isNextIdInitialized.store(true);
+        }
+    }
+
     RecordId out = RecordId(_nextIdNum.fetchAndAdd(1));
     invariant(out.isNormal());
     return out;
@@ -65,6 +65,10 @@ public:
                                       int len,
                                       Timestamp timestamp) override;
 
+    Status insertRecords(OperationContext* opCtx,
+                         std::vector<Record>* records,
+                         std::vector<Timestamp>* timestamps) override;
+
     Status insertRecordsWithDocWriter(OperationContext* opCtx,
                                       const DocWriter* const* docs,
                                       const Timestamp* timestamps,
@@ -159,12 +163,23 @@ private:
 
     class Cursor;
 
-    RecordId _nextId();
+    /**
+     * Returns the statement text shared by every insert into this record store.
+     */
+    std::string _insertQuery() const;
+
+    /**
+     * Returns the id for a new record. The first call finds the largest id in use through
+     * 'session', so that opening a record store at startup does not have to query its table.
+     */
+    RecordId _nextId(MobileSession* session);
 
     const std::string _path;
     const std::string _ident;
 
     AtomicInt64 _nextIdNum;
+    AtomicBool _isNextIdInitialized{false};
+    stdx::mutex _nextIdMutex;  // serializes initializing _nextIdNum
 
     /**
      * Fetches the number of records from the database. _numRecsMutex should be locked before this
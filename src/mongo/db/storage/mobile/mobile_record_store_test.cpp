@@ -41,6 +41,7 @@
 #include "mongo/db/storage/mobile/mobile_sqlite_statement.h"
 #include "mongo/db/storage/mobile/mobile_util.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/write_unit_of_work.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
@@ -99,6 +100,15 @@ public:
             opCtx.get(), ns, _fullPath, ns, CollectionOptions());
     }
 
+    /**
+     * Opens the existing record store 'ns', as loading the catalog at startup does.
+     */
+    std::unique_ptr<RecordStore> openNonCappedRecordStore(const std::string& ns) {
+        ServiceContext::UniqueOperationContext opCtx(this->newOperationContext());
+        return stdx::make_unique<MobileRecordStore>(
+            opCtx.get(), ns, _fullPath, ns, CollectionOptions());
+    }
+
     std::unique_ptr<RecordStore> newCappedRecordStore(int64_t cappedMaxSize,
                                                       int64_t cappedMaxDocs) override {
         inc++;
@@ -139,5 +149,35 @@ MONGO_INITIALIZER(RegisterHarnessFactory)(InitializerContext* const) {
     mongo::registerHarnessHelperFactory(makeHarnessHelper);
     return Status::OK();
 }
+
+RecordId insertRecord(MobileHarnessHelper* harnessHelper, RecordStore* rs) {
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    const std::string data = "data";
+    WriteUnitOfWork uow(opCtx.get());
+    auto res = rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, Timestamp());
+    ASSERT_OK(res.getStatus());
+    uow.commit();
+    return res.getValue();
+}
+
+TEST(MobileRecordStoreTest, ReopenedRecordStoreFindsNextIdOnFirstInsert) {
+    MobileHarnessHelper harnessHelper;
+    auto rs = harnessHelper.newNonCappedRecordStore("a.b");
+
+    // An empty record store starts from the first id.
+    auto reopenedEmpty = harnessHelper.openNonCappedRecordStore("a.b");
+    ASSERT_EQ(RecordId(1), insertRecord(&harnessHelper, reopenedEmpty.get()));
+    reopenedEmpty.reset();
+
+    ASSERT_EQ(RecordId(2), insertRecord(&harnessHelper, rs.get()));
+
+    // Opening a record store doesn't look at its table. The next id is found from the records
+    // that exist at the first insert, including those inserted after it was opened.
+    auto reopened = harnessHelper.openNonCappedRecordStore("a.b");
+    ASSERT_EQ(RecordId(3), insertRecord(&harnessHelper, rs.get()));
+    ASSERT_EQ(RecordId(4), insertRecord(&harnessHelper, rs.get()));
+    ASSERT_EQ(RecordId(5), insertRecord(&harnessHelper, reopened.get()));
+    ASSERT_EQ(RecordId(6), insertRecord(&harnessHelper, reopened.get()));
+}
 }  // namespace
 }  // namespace mongo
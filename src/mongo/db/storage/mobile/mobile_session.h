@@ -36,6 +36,7 @@
 
 namespace mongo {
 class MobileSessionPool;
+class SqliteStatementCache;
 
 /**
  * This class manages a SQLite database connection object.
@@ -44,7 +45,9 @@ class MobileSession final {
     MONGO_DISALLOW_COPYING(MobileSession);
 
 public:
-    MobileSession(sqlite3* session, MobileSessionPool* sessionPool);
+    MobileSession(sqlite3* session,
+                  MobileSessionPool* sessionPool,
+                  SqliteStatementCache* statementCache);
 
     ~MobileSession();
 
@@ -53,8 +56,16 @@ public:
      */
     sqlite3* getSession() const;
 
+    /**
+     * Returns the cache of prepared statements for the underlying SQLite connection.
+     */
+    SqliteStatementCache* getStatementCache() const;
+
 private:
     sqlite3* _session;
     MobileSessionPool* _sessionPool;
+
+    // Owned by the session pool, which keeps it with the connection while it is not in use.
+    SqliteStatementCache* _statementCache;
 };
 }  // namespace mongo
@@ -95,7 +95,11 @@ bool MobileDelayedOpQueue::isEmpty() {
 }
 
 MobileSessionPool::MobileSessionPool(const std::string& path, std::uint64_t maxPoolSize)
-    : _path(path), _maxPoolSize(maxPoolSize) {}
+    : _path(path),
+      _maxPoolSize(maxPoolSize),
+      _walCheckpointer(stdx::make_unique<MobileWalCheckpointer>(path)) {
+    _walCheckpointer->go();
+}
 
 MobileSessionPool::~MobileSessionPool() {
     shutDown();
@@ -111,7 +115,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
     // Checks if there is an open session available.
     if (!_sessions.empty()) {
         sqlite3* session = _popSession_inlock();
-        return stdx::make_unique<MobileSession>(session, this);
+        return _makeSession_inlock(session);
     }
 
     // Checks if a new session can be opened.
@@ -119,8 +123,10 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         sqlite3* session;
         int status = sqlite3_open(_path.c_str(), &session);
         checkStatus(status, SQLITE_OK, "sqlite3_open");
+        _walCheckpointer->attach(session);
+        _statementCaches.emplace(session, stdx::make_unique<SqliteStatementCache>());
         _curPoolSize++;
-        return stdx::make_unique<MobileSession>(session, this);
+        return _makeSession_inlock(session);
     }
 
     // There are no open sessions available and the maxPoolSize has been reached.
@@ -129,7 +135,7 @@ std::unique_ptr<MobileSession> MobileSessionPool::getSession(OperationContext* o
         _releasedSessionNotifier, lk, [&] { return !_sessions.empty(); });
 
     sqlite3* session = _popSession_inlock();
-    return stdx::make_unique<MobileSession>(session, this);
+    return _makeSession_inlock(session);
 }
 
 void MobileSessionPool::releaseSession(MobileSession* session) {
@@ -159,6 +165,12 @@ void MobileSessionPool::shutDown() {
         _releasedSessionNotifier.wait(lk, [&] { return _sessions.size() == _curPoolSize; });
     }
 
+    // No session can commit now, so nothing else will grow the WAL.
+    if (_walCheckpointer) {
+        _walCheckpointer->shutdown();
+        _walCheckpointer.reset();
+    }
+
     // Retry all the drops that have been queued on failure.
     // Create a new sqlite session to do so, all other sessions might have been closed already.
     if (!failedDropsQueue.isEmpty()) {
@@ -166,12 +178,17 @@ void MobileSessionPool::shutDown() {
 
         int status = sqlite3_open(_path.c_str(), &session);
         checkStatus(status, SQLITE_OK, "sqlite3_open");
-        std::unique_ptr<MobileSession> mobSession = stdx::make_unique<MobileSession>(session, this);
-        LOG(MOBILE_LOG_LEVEL_LOW) << "MobileSE: Executing queued drops at shutdown";
-        failedDropsQueue.execAndDequeueAllOps(mobSession.get());
+        {
+            SqliteStatementCache statementCache;
+            MobileSession mobSession(session, this, &statementCache);
+            LOG(MOBILE_LOG_LEVEL_LOW) << "MobileSE: Executing queued drops at shutdown";
+            failedDropsQueue.execAndDequeueAllOps(&mobSession);
+        }
         sqlite3_close(session);
     }
 
+    // Statements must be finalized before the connections that prepared them can be closed.
+    _statementCaches.clear();
     for (auto&& session : _sessions) {
         sqlite3_close(session);
     }
@@ -184,4 +201,11 @@ sqlite3* MobileSessionPool::_popSession_inlock() {
     return session;
 }
 
+// This method should only be called when _sessions is locked.
+std::unique_ptr<MobileSession> MobileSessionPool::_makeSession_inlock(sqlite3* session) {
+    auto it = _statementCaches.find(session);
+    invariant(it != _statementCaches.end());
+    return stdx::make_unique<MobileSession>(session, this, it->second.get());
+}
+
 }  // namespace mongo
@@ -31,15 +31,18 @@
 #include <queue>
 #include <sqlite3.h>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage/mobile/mobile_session.h"
+#include "mongo/db/storage/mobile/mobile_wal_checkpointer.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
 class MobileSession;
+class SqliteStatementCache;
 
 /**
  * This class manages a queue of operations delayed for some reason
@@ -96,6 +99,11 @@ private:
      */
     sqlite3* _popSession_inlock();
 
+    /**
+     * Wraps an open sqlite3* in a MobileSession that shares the connection's statement cache.
+     */
+    std::unique_ptr<MobileSession> _makeSession_inlock(sqlite3* session);
+
     // This is used to lock the _sessions vector.
     stdx::mutex _mutex;
     stdx::condition_variable _releasedSessionNotifier;
@@ -111,5 +119,11 @@ private:
 
     using SessionPool = std::vector<sqlite3*>;
     SessionPool _sessions;
+
+    // Prepared statements are bound to the connection that prepared them, so each open sqlite3*
+    // keeps its own cache for as long as it stays in the pool.
+    std::unordered_map<sqlite3*, std::unique_ptr<SqliteStatementCache>> _statementCaches;
+
+    std::unique_ptr<MobileWalCheckpointer> _walCheckpointer;
 };
 }  // namespace mongo
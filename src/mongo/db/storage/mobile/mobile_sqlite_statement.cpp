@@ -36,6 +36,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/storage/mobile/mobile_sqlite_statement.h"
 #include "mongo/db/storage/mobile/mobile_util.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -118,9 +119,12 @@ int SqliteStatement::step(int desiredStatus) {
         checkStatus(status, desiredStatus, "sqlite3_step");
     }
 
-    char* full_stmt = sqlite3_expanded_sql(_stmt);
-    SQLITE_STMT_TRACE() << sqliteStatusToStr(status) << " - on stepping: " << full_stmt;
-    sqlite3_free(full_stmt);
+    // Expanding the statement allocates, so only do it when it is going to be logged.
+    if (shouldLog(logger::LogSeverity::Debug(MOBILE_TRACE_LEVEL))) {
+        char* full_stmt = sqlite3_expanded_sql(_stmt);
+        SQLITE_STMT_TRACE() << sqliteStatusToStr(status) << " - on stepping: " << full_stmt;
+        sqlite3_free(full_stmt);
+    }
 
     return status;
 }
@@ -166,4 +170,37 @@ void SqliteStatement::reset() {
     checkStatus(status, SQLITE_OK, "sqlite3_reset");
 }
 
+SqliteStatementCache::CachedStatement SqliteStatementCache::get(const MobileSession& session,
+                                                                const std::string& sqlQuery) {
+    auto it = _statements.find(sqlQuery);
+    if (it == _statements.end()) {
+        return CachedStatement(this, stdx::make_unique<SqliteStatement>(session, sqlQuery));
+    }
+
+    std::unique_ptr<SqliteStatement> stmt = std::move(it->second);
+    _statements.erase(it);
+    return CachedStatement(this, std::move(stmt));
+}
+
+void SqliteStatementCache::_release(std::unique_ptr<SqliteStatement> stmt) {
+    // A statement whose last step failed is finalized instead, which checks that the failure was
+    // the one its user expected.
+    if (stmt->_exceptionStatus != SQLITE_OK || _statements.size() >= kMaxCachedStatements) {
+        return;
+    }
+
+    // If the last step failed, the statement is being released while unwinding from that error,
+    // so the error is not thrown again here.
+    if (sqlite3_reset(stmt->_stmt) != SQLITE_OK) {
+        sqlite3_finalize(stmt->_stmt);
+        stmt->_stmt = NULL;
+        return;
+    }
+    stmt->clearBindings();
+
+    // If another statement for the same query was released first, this one is finalized.
+    const std::string sqlQuery = stmt->_sqlQuery;
+    _statements.emplace(sqlQuery, std::move(stmt));
+}
+
 }  // namespace mongo
@@ -28,9 +28,12 @@
 
 #pragma once
 
+#include <memory>
 #include <sqlite3.h>
 #include <string>
+#include <unordered_map>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/mobile/mobile_session.h"
 #include "mongo/platform/atomic_word.h"
 
@@ -129,6 +132,8 @@ public:
     uint64_t _id;
 
 private:
+    friend class SqliteStatementCache;
+
     static AtomicInt64 _nextID;
     sqlite3_stmt* _stmt;
     std::string _sqlQuery;
@@ -138,4 +143,74 @@ private:
     // code returned matches the finalize error code, if there is any.
     int _exceptionStatus = SQLITE_OK;
 };
+
+/**
+ * SqliteStatementCache keeps the prepared statements of a single SQLite connection for reuse,
+ * keyed by their SQL text. Preparing a statement costs about as much as executing a simple write,
+ * so statements that run for every write are prepared once per connection rather than once per
+ * operation.
+ */
+class SqliteStatementCache final {
+    MONGO_DISALLOW_COPYING(SqliteStatementCache);
+
+public:
+    /**
+     * A statement checked out of the cache. When this is destroyed, the statement is reset, its
+     * bindings are cleared, and it is returned to the cache for the next user of the same query.
+     */
+    class CachedStatement final {
+        MONGO_DISALLOW_COPYING(CachedStatement);
+
+    public:
+        CachedStatement(SqliteStatementCache* cache, std::unique_ptr<SqliteStatement> stmt)
+            : _cache(cache), _stmt(std::move(stmt)) {}
+
+        CachedStatement(CachedStatement&& other)
+            : _cache(other._cache), _stmt(std::move(other._stmt)) {}
+
+        ~CachedStatement() {
+            if (_stmt) {
+                _cache->_release(std::move(_stmt));
+            }
+        }
+
+        SqliteStatement* operator->() const {
+            return _stmt.get();
+        }
+
+        SqliteStatement& operator*() const {
+            return *_stmt;
+        }
+
+    private:
+        SqliteStatementCache* _cache;
+        std::unique_ptr<SqliteStatement> _stmt;
+    };
+
+    /**
+     * The maximum number of idle statements kept by one cache. Statements released to a full
+     * cache are finalized.
+     */
+    static const size_t kMaxCachedStatements = 64;
+
+    SqliteStatementCache() = default;
+
+    /**
+     * Returns a prepared statement for 'sqlQuery' on 'session', reusing a cached one if there is
+     * one. If the statement for 'sqlQuery' is already checked out, a new one is prepared.
+     */
+    CachedStatement get(const MobileSession& session, const std::string& sqlQuery);
+
+    /**
+     * Returns the number of idle statements in the cache.
+     */
+    size_t size() const {
+        return _statements.size();
+    }
+
+private:
+    void _release(std::unique_ptr<SqliteStatement> stmt);
+
+    std::unordered_map<std::string, std::unique_ptr<SqliteStatement>> _statements;
+};
 }  // namespace mongo
@@ -0,0 +1,126 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <sqlite3.h>
+#include <string>
+
+#include "mongo/db/storage/mobile/mobile_session.h"
+#include "mongo/db/storage/mobile/mobile_session_pool.h"
+#include "mongo/db/storage/mobile/mobile_sqlite_statement.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class SqliteStatementCacheTest : public unittest::Test {
+protected:
+    SqliteStatementCacheTest()
+        : _dbPath("mobile_sqlite_statement_test"),
+          _sessionPool(_dbPath.path() + "/mobile.sqlite"),
+          _session(_sessionPool.getSession(nullptr)) {
+        SqliteStatement::execQuery(_session.get(),
+                                   "CREATE TABLE t (rec_id INT PRIMARY KEY, data BLOB);");
+    }
+
+    SqliteStatementCache* cache() {
+        return _session->getStatementCache();
+    }
+
+    unittest::TempDir _dbPath;
+    MobileSessionPool _sessionPool;
+    std::unique_ptr<MobileSession> _session;
+};
+
+const std::string kInsertQuery = "INSERT INTO t (rec_id, data) VALUES (?, ?);";
+
+TEST_F(SqliteStatementCacheTest, ReleasedStatementIsReused) {
+    ASSERT_EQ(0U, cache()->size());
+
+    SqliteStatement* first;
+    {
+        auto stmt = cache()->get(*_session, kInsertQuery);
+        first = &*stmt;
+        stmt->bindInt(0, 1);
+        stmt->step(SQLITE_DONE);
+    }
+    ASSERT_EQ(1U, cache()->size());
+
+    {
+        // The statement comes back reset with its bindings cleared.
+        auto stmt = cache()->get(*_session, kInsertQuery);
+        ASSERT_EQ(first, &*stmt);
+        ASSERT_EQ(0U, cache()->size());
+        stmt->bindInt(0, 2);
+        stmt->step(SQLITE_DONE);
+    }
+    ASSERT_EQ(1U, cache()->size());
+}
+
+TEST_F(SqliteStatementCacheTest, CheckedOutStatementIsNotShared) {
+    {
+        auto first = cache()->get(*_session, kInsertQuery);
+        auto second = cache()->get(*_session, kInsertQuery);
+        ASSERT_NOT_EQUALS(&*first, &*second);
+    }
+
+    // Only one idle statement is kept for a query.
+    ASSERT_EQ(1U, cache()->size());
+}
+
+TEST_F(SqliteStatementCacheTest, FailedStatementIsNotCached) {
+    {
+        auto stmt = cache()->get(*_session, kInsertQuery);
+        stmt->bindInt(0, 1);
+        stmt->step(SQLITE_DONE);
+    }
+
+    {
+        auto stmt = cache()->get(*_session, kInsertQuery);
+        stmt->bindInt(0, 1);
+        int status = stmt->step();
+        ASSERT_EQ(SQLITE_CONSTRAINT, status);
+        stmt->setExceptionStatus(status);
+    }
+    ASSERT_EQ(0U, cache()->size());
+}
+
+TEST_F(SqliteStatementCacheTest, CacheIsBounded) {
+    for (size_t i = 0; i <= SqliteStatementCache::kMaxCachedStatements; i++) {
+        std::string query = "SELECT data FROM t WHERE rec_id = " + std::to_string(i) + ";";
+        auto stmt = cache()->get(*_session, query);
+        stmt->step(SQLITE_DONE);
+    }
+    ASSERT_EQ(SqliteStatementCache::kMaxCachedStatements, cache()->size());
+}
+
+}  // namespace
+}  // namespace mongo
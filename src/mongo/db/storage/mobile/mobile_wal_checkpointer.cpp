@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/mobile/mobile_wal_checkpointer.h"
+
+#include <sqlite3.h>
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/mobile/mobile_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// The WAL size, in pages, past which a commit wakes the checkpointer. This matches the threshold
+// of SQLite's own automatic checkpoints.
+AtomicInt32 kMobileWalCheckpointPages(1000);
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    MobileWalCheckpointPagesSetting(ServerParameterSet::getGlobal(),
+                                    "mobileWalCheckpointPages",
+                                    &kMobileWalCheckpointPages);
+
+// How often the WAL is checkpointed regardless of its size. 0 disables the periodic checkpoints.
+AtomicInt32 kMobileWalCheckpointPeriodSecs(60);
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    MobileWalCheckpointPeriodSecsSetting(ServerParameterSet::getGlobal(),
+                                         "mobileWalCheckpointPeriodSecs",
+                                         &kMobileWalCheckpointPeriodSecs);
+}  // namespace
+
+MobileWalCheckpointer::MobileWalCheckpointer(const std::string& path)
+    : BackgroundJob(false /* deleteSelf */), _path(path) {}
+
+void MobileWalCheckpointer::run() {
+    LOG(MOBILE_LOG_LEVEL_LOW) << "MobileSE: starting " << name() << " thread";
+
+    sqlite3* session;
+    int status = sqlite3_open(_path.c_str(), &session);
+    checkStatus(status, SQLITE_OK, "sqlite3_open");
+    ON_BLOCK_EXIT([&session] { sqlite3_close(session); });
+
+    while (true) {
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            const auto wakeUp = [this] { return _checkpointRequested || _shuttingDown.load(); };
+            const int periodSecs = kMobileWalCheckpointPeriodSecs.load();
+            if (periodSecs > 0) {
+                _condvar.wait_for(lock, stdx::chrono::seconds(periodSecs), wakeUp);
+            } else {
+                _condvar.wait(lock, wakeUp);
+            }
+
+            if (_shuttingDown.load())
+                break;
+            _checkpointRequested = false;
+        }
+
+        int walFrames = 0;
+        int checkpointedFrames = 0;
+        status = sqlite3_wal_checkpoint_v2(
+            session, NULL, SQLITE_CHECKPOINT_PASSIVE, &walFrames, &checkpointedFrames);
+        if (status == SQLITE_BUSY || status == SQLITE_LOCKED) {
+            // Another connection is checkpointing or recovering the database; try again later.
+            LOG(MOBILE_TRACE_LEVEL) << "MobileSE: WAL checkpoint skipped: "
+                                    << sqliteStatusToStr(status);
+            continue;
+        }
+        checkStatus(status, SQLITE_OK, "sqlite3_wal_checkpoint_v2");
+
+        LOG(MOBILE_TRACE_LEVEL) << "MobileSE: WAL checkpoint copied " << checkpointedFrames
+                                << " of " << walFrames << " frames";
+    }
+
+    LOG(MOBILE_LOG_LEVEL_LOW) << "MobileSE: stopping " << name() << " thread";
+}
+
+void MobileWalCheckpointer::attach(sqlite3* session) {
+    sqlite3_wal_hook(session, &MobileWalCheckpointer::_walHook, this);
+}
+
+void MobileWalCheckpointer::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        _shuttingDown.store(true);
+        _condvar.notify_one();
+    }
+    wait();
+}
+
+int MobileWalCheckpointer::_walHook(void* checkpointer,
+                                    sqlite3* session,
+                                    const char* dbName,
+                                    int walPages) {
+    if (walPages >= kMobileWalCheckpointPages.load()) {
+        static_cast<MobileWalCheckpointer*>(checkpointer)->_requestCheckpoint();
+    }
+    return SQLITE_OK;
+}
+
+void MobileWalCheckpointer::_requestCheckpoint() {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _checkpointRequested = true;
+    _condvar.notify_one();
+}
+}  // namespace mongo
@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <sqlite3.h>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/background.h"
+
+namespace mongo {
+
+/**
+ * Checkpoints the SQLite write-ahead log from a background thread. By default SQLite checkpoints
+ * on whichever connection commits the transaction that grows the WAL past 1000 pages, which
+ * stalls that write for the length of the checkpoint. Connections attached to this checkpointer
+ * instead wake it once the WAL reaches 'mobileWalCheckpointPages' pages, and it runs a passive
+ * checkpoint on its own connection, which copies as much of the WAL back into the database as it
+ * can without waiting on readers or writers. It also checkpoints every
+ * 'mobileWalCheckpointPeriodSecs' seconds so that the WAL of an idle database is drained.
+ */
+class MobileWalCheckpointer final : public BackgroundJob {
+    MONGO_DISALLOW_COPYING(MobileWalCheckpointer);
+
+public:
+    explicit MobileWalCheckpointer(const std::string& path);
+
+    std::string name() const override {
+        return "MobileWalCheckpointer";
+    }
+
+    void run() override;
+
+    /**
+     * Makes this checkpointer responsible for checkpointing the WAL written through 'session'.
+     * This replaces SQLite's automatic checkpointing on that connection.
+     */
+    void attach(sqlite3* session);
+
+    /**
+     * Stops the checkpointer thread and waits for it to exit.
+     */
+    void shutdown();
+
+private:
+    /**
+     * The sqlite3_wal_hook() callback, invoked after each commit with the size of the WAL.
+     */
+    static int _walHook(void* checkpointer, sqlite3* session, const char* dbName, int walPages);
+
+    void _requestCheckpoint();
+
+    const std::string _path;
+
+    stdx::mutex _mutex;  // protects _checkpointRequested
+    stdx::condition_variable _condvar;
+    bool _checkpointRequested = false;
+    AtomicBool _shuttingDown{false};
+};
+}  // namespace mongo
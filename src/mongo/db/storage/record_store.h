@@ -33,10 +33,12 @@
 #include <boost/optional.hpp>
 
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/base/status_with.h"
 #include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/record_data.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -128,6 +130,18 @@ enum ValidateCmdLevel : int {
  */
 class RecordCursor {
 public:
+    /**
+     * Counters describing how well read-ahead kept up with a cursor. See enableReadAhead().
+     */
+    struct ReadAheadStats {
+        // Records returned by next() which had already been read ahead.
+        long long hits = 0;
+
+        // Records returned by next() which the cursor had to read itself because it had caught
+        // up with the read-ahead.
+        long long stalls = 0;
+    };
+
     virtual ~RecordCursor() = default;
 
     /**
@@ -136,6 +150,25 @@ public:
      */
     virtual boost::optional<Record> next() = 0;
 
+    /**
+     * Asks the storage engine to read up to 'numRecords' records beyond the cursor's position into
+     * memory in the background, so that a scan over data which is not cached does not wait on
+     * each read in turn. Only forward cursors may read ahead.
+     *
+     * This is purely a performance hint: it never changes which records next() returns. Returns
+     * false if the cursor does not support read-ahead.
+     */
+    virtual bool enableReadAhead(long long numRecords) {
+        return false;
+    }
+
+    /**
+     * Returns the read-ahead counters accumulated since enableReadAhead() was called.
+     */
+    virtual ReadAheadStats getReadAheadStats() const {
+        return {};
+    }
+
     //
     // Saving and restoring state
     //
@@ -217,6 +250,28 @@ public:
     }
 };
 
+/**
+ * Appends records to an empty RecordStore, in increasing RecordId order, without the overhead of a
+ * storage transaction per insert. Records written through a bulk builder cannot be rolled back, so
+ * it is only suitable for loads which discard the whole RecordStore on failure, such as cloning a
+ * collection during initial sync.
+ */
+class RecordStoreBulkBuilder {
+public:
+    virtual ~RecordStoreBulkBuilder() = default;
+
+    /**
+     * Appends a record holding 'len' bytes of 'data', returning its RecordId.
+     */
+    virtual StatusWith<RecordId> addRecord(const char* data, int len) = 0;
+
+    /**
+     * Finishes the load. The records added are visible to other readers, and accounted for by
+     * numRecords() and dataSize(), once this returns. No more records may be added afterwards.
+     */
+    virtual void commit(OperationContext* opCtx) = 0;
+};
+
 /**
  * An abstraction used for storing documents in a collection or entries in an index.
  *
@@ -341,6 +396,15 @@ public:
         return Status::OK();
     }
 
+    /**
+     * Returns a builder which appends records to this RecordStore, which must be empty, more
+     * cheaply than insertRecord(). Returns nullptr if the storage engine cannot bulk load this
+     * RecordStore, in which case records should be inserted as usual.
+     */
+    virtual std::unique_ptr<RecordStoreBulkBuilder> makeBulkBuilder(OperationContext* opCtx) {
+        return nullptr;
+    }
+
     /**
      * Inserts nDocs documents into this RecordStore using the DocWriter interface.
      *
@@ -483,6 +547,19 @@ public:
         MONGO_UNREACHABLE;
     }
 
+    /**
+     * Performs a bounded amount of in-place compaction, giving up after roughly 'timeout'. Other
+     * operations may keep using the RecordStore meanwhile, so callers only need intent locks.
+     *
+     * Returns true if compaction ran to completion, or false if it stopped early and another call
+     * may reclaim more space. Only called if compactsInPlace() returns true.
+     */
+    virtual StatusWith<bool> compactStep(OperationContext* opCtx, Seconds timeout) {
+        return {ErrorCodes::CommandNotSupported,
+                std::string("incremental compaction is not supported by record store: ") +
+                    name()};
+    }
+
     /**
      * Does the RecordStore cursor retrieve its document in RecordId Order?
      *
@@ -496,6 +573,16 @@ public:
         return false;
     }
 
+    /**
+     * Returns true if this RecordStore was created for a collection with the 'clusteredIndex'
+     * option. Such a store derives each record's RecordId from the document's _id (see
+     * clustered_id.h) and rejects inserts whose RecordId is already present, standing in for
+     * the unique _id index.
+     */
+    virtual bool isClustered() const {
+        return false;
+    }
+
     /**
      * @return OK if the validate run successfully
      *         OK will be returned even if corruption is found
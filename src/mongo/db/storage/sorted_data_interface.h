@@ -30,10 +30,12 @@
 #include <boost/optional/optional_io.hpp>
 #include <memory>
 
+#include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/util/duration.h"
 
 #pragma once
 
@@ -131,6 +133,14 @@ public:
         return Status::OK();
     }
 
+    /**
+     * Incremental variant of compact(), see RecordStore::compactStep(). Returns true if compaction
+     * ran to completion.
+     */
+    virtual StatusWith<bool> compactStep(OperationContext* opCtx, Seconds timeout) {
+        return true;
+    }
+
     //
     // Information about the tree
     //
@@ -285,6 +295,25 @@ public:
         virtual boost::optional<IndexKeyEntry> seek(const IndexSeekPoint& seekPoint,
                                                     RequestedInfo parts = kKeyAndLoc) = 0;
 
+        /**
+         * Seeks a forward cursor to the first entry at or after 'key' paired with 'loc', and returns
+         * the current position. Entries for a single key are ordered by RecordId, so a scan over
+         * one key can use this to jump to the first RecordId that is not smaller than 'loc'. As
+         * with seek(), the returned entry may belong to a later key.
+         *
+         * The default implementation seeks to 'key' and then steps over the smaller RecordIds.
+         */
+        virtual boost::optional<IndexKeyEntry> seekAtOrPast(const BSONObj& key,
+                                                            const RecordId& loc,
+                                                            RequestedInfo parts = kKeyAndLoc) {
+            auto kv = seek(key, true, kKeyAndLoc);
+            while (kv && kv->loc < loc &&
+                   kv->key.woCompare(key, BSONObj(), /*considerFieldNames*/ false) == 0) {
+                kv = next(kKeyAndLoc);
+            }
+            return kv;
+        }
+
         /**
          * Seeks to a key with a hint to the implementation that you only want exact matches. If
          * an exact match can't be found, boost::none will be returned and the resulting
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -48,6 +49,7 @@ class SnapshotManager;
 struct StorageGlobalParams;
 class StorageEngineLockFile;
 class StorageEngineMetadata;
+class TemporaryRecordStore;
 
 /**
  * The StorageEngine class is the top level interface for creating a new storage
@@ -197,6 +199,14 @@ public:
         return true;
     }
 
+    /**
+     * Returns whether the storage engine supports collections created with 'clusteredIndex',
+     * whose records are keyed by their _id.
+     */
+    virtual bool supportsClusteredCollections() const {
+        return false;
+    }
+
     /**
      * Returns whether the engine supports a journalling concept or not.
      */
@@ -284,6 +294,13 @@ public:
      */
     virtual Status repairRecordStore(OperationContext* opCtx, const std::string& ns) = 0;
 
+    /**
+     * Creates a RecordStore that is not part of any collection, to hold transient data. See
+     * TemporaryRecordStore.
+     */
+    virtual std::unique_ptr<TemporaryRecordStore> makeTemporaryRecordStore(
+        OperationContext* opCtx) = 0;
+
     /**
      * This method will be called before there is a clean shutdown.  Storage engines should
      * override this method if they have clean-up to do that is different from unclean shutdown.
@@ -55,6 +55,9 @@ void StorageGlobalParams::reset() {
     syncdelay = 60.0;
     readOnly = false;
     groupCollections = false;
+    lazyCatalogLoading = false;
+    lazyCatalogWarming = true;
+    catalogLoadThreads = 4;
 }
 
 StorageGlobalParams storageGlobalParams;
@@ -122,5 +125,38 @@ MONGO_COMPILER_VARIABLE_UNUSED auto _exportedJournalCommitInterval =
             }
             return Status::OK();
         });
+
+/**
+ * Defer opening collections and indexes until they are first used, or until the background catalog
+ * warmer gets to them.
+ */
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly> LazyCatalogLoadingSetting(
+    ServerParameterSet::getGlobal(),
+    "lazyCatalogLoading",
+    &storageGlobalParams.lazyCatalogLoading);
+
+ExportedServerParameter<bool, ServerParameterType::kStartupOnly> LazyCatalogWarmingSetting(
+    ServerParameterSet::getGlobal(),
+    "lazyCatalogWarming",
+    &storageGlobalParams.lazyCatalogWarming);
+
+/**
+ * Specify the number of threads used to open collections when loading the catalog. A value of 1
+ * opens them sequentially.
+ */
+MONGO_COMPILER_VARIABLE_UNUSED auto _exportedCatalogLoadThreads =
+    (new ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+        ServerParameterSet::getGlobal(),
+        "catalogLoadThreads",
+        &storageGlobalParams.catalogLoadThreads))
+        -> withValidator([](const int& potentialNewValue) {
+            if (potentialNewValue < 1 || potentialNewValue > 128) {
+                return Status(ErrorCodes::BadValue,
+                              str::stream() << "catalogLoadThreads must be between 1 and 128, "
+                                               "but attempted to set to: "
+                                            << potentialNewValue);
+            }
+            return Status::OK();
+        });
 }  // namespace
 }  // namespace mongo
@@ -108,6 +108,20 @@ struct StorageGlobalParams {
     // an existing underlying MongoDB database level resource if possible. This can improve
     // workloads that rely heavily on creating many collections within a database.
     bool groupCollections;
+
+    // --setParameter lazyCatalogLoading
+    // Load only the catalog metadata at startup and open each collection's record store and
+    // indexes on first use, so that startup time doesn't grow with the number of collections.
+    bool lazyCatalogLoading;
+
+    // --setParameter lazyCatalogWarming
+    // When loading the catalog lazily, open the unopened collections from a background thread
+    // after startup, most recently created first.
+    bool lazyCatalogWarming;
+
+    // --setParameter catalogLoadThreads
+    // The number of threads that open the collections' record stores while the catalog is loaded.
+    int catalogLoadThreads;
 };
 
 extern StorageGlobalParams storageGlobalParams;
@@ -0,0 +1,74 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/storage/record_store.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * A RecordStore for transient data, such as the writes buffered by an index build, that is not
+ * part of any collection and does not survive a restart. Its contents are only durable to the
+ * extent needed to stay consistent with the writes of the units of work that produce them.
+ *
+ * The underlying table should be dropped with deleteTemporaryTable() before this is destroyed.
+ * A table that is left behind, for example by a crash, is dropped on the next startup.
+ */
+class TemporaryRecordStore {
+    MONGO_DISALLOW_COPYING(TemporaryRecordStore);
+
+public:
+    explicit TemporaryRecordStore(std::unique_ptr<RecordStore> rs) : _rs(std::move(rs)) {}
+
+    virtual ~TemporaryRecordStore() = default;
+
+    /**
+     * Drops the underlying table. Must not be called inside of a WriteUnitOfWork.
+     */
+    virtual void deleteTemporaryTable(OperationContext* opCtx) = 0;
+
+    RecordStore* rs() {
+        return _rs.get();
+    }
+
+    const RecordStore* rs() const {
+        return _rs.get();
+    }
+
+protected:
+    std::unique_ptr<RecordStore> _rs;
+};
+
+}  // namespace mongo
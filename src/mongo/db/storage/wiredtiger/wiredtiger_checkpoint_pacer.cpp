@@ -0,0 +1,273 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_pacer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+constexpr int WiredTigerCheckpointPacer::kDefaultDirtyTargetPercent;
+constexpr double WiredTigerCheckpointPacer::kDirtyTriggerRatio;
+constexpr double WiredTigerCheckpointPacer::kFillTriggerRatio;
+constexpr int WiredTigerCheckpointPacer::kMinDirtyTargetPercent;
+constexpr double WiredTigerCheckpointPacer::kDirtyThrottleRange;
+constexpr double WiredTigerCheckpointPacer::kFillThrottleRange;
+
+namespace {
+
+// Whether eviction is asked to write dirty data out ahead of each checkpoint.
+AtomicBool wiredTigerCheckpointPacing(false);
+ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>
+    WiredTigerCheckpointPacingSetting(ServerParameterSet::getGlobal(),
+                                      "wiredTigerCheckpointPacing",
+                                      &wiredTigerCheckpointPacing);
+
+// Whether user writers are slowed down as the cache approaches its eviction triggers.
+AtomicBool wiredTigerWriteThrottle(false);
+ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>
+    WiredTigerWriteThrottleSetting(ServerParameterSet::getGlobal(),
+                                   "wiredTigerWriteThrottle",
+                                   &wiredTigerWriteThrottle);
+
+// The delay a writer waits for when the cache is at an eviction trigger.
+AtomicInt32 wiredTigerWriteThrottleMaxDelayMicros(5000);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerWriteThrottleMaxDelayMicrosSetting(ServerParameterSet::getGlobal(),
+                                                 "wiredTigerWriteThrottleMaxDelayMicros",
+                                                 &wiredTigerWriteThrottleMaxDelayMicros);
+
+// How often the cache is sampled.
+AtomicInt32 wiredTigerCheckpointPacerPeriodMillis(100);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerCheckpointPacerPeriodMillisSetting(ServerParameterSet::getGlobal(),
+                                                 "wiredTigerCheckpointPacerPeriodMillis",
+                                                 &wiredTigerCheckpointPacerPeriodMillis);
+
+double clampRatio(double ratio) {
+    return std::max(0.0, std::min(ratio, 1.0));
+}
+
+}  // namespace
+
+int WiredTigerCheckpointPacer::computeDirtyTargetPercent(const Sample& sample) {
+    if (sample.cacheBytes <= 0 || sample.checkpointInterval <= Seconds(0))
+        return kDefaultDirtyTargetPercent;
+
+    const double remainingSecs =
+        durationCount<Seconds>(std::max(sample.checkpointInterval - sample.sinceLastCheckpoint,
+                                        Seconds(0)));
+    const double projectedDirtyBytes =
+        sample.dirtyBytes + std::max(sample.dirtyBytesPerSecond, 0.0) * remainingSecs;
+    if (projectedDirtyBytes * 100 <= double(sample.cacheBytes) * kMinDirtyTargetPercent)
+        return kDefaultDirtyTargetPercent;
+
+    const double elapsed = clampRatio(double(durationCount<Seconds>(sample.sinceLastCheckpoint)) /
+                                      durationCount<Seconds>(sample.checkpointInterval));
+    const int target = static_cast<int>(
+        kDefaultDirtyTargetPercent -
+        (kDefaultDirtyTargetPercent - kMinDirtyTargetPercent) * elapsed + 0.5);
+    return std::max(kMinDirtyTargetPercent, std::min(target, kDefaultDirtyTargetPercent));
+}
+
+Microseconds WiredTigerCheckpointPacer::computeWriteDelay(double cacheDirtyRatio,
+                                                          double cacheFillRatio,
+                                                          Microseconds maxDelay) {
+    const double dirtyPressure =
+        clampRatio((cacheDirtyRatio - (kDirtyTriggerRatio - kDirtyThrottleRange)) /
+                   kDirtyThrottleRange);
+    const double fillPressure = clampRatio(
+        (cacheFillRatio - (kFillTriggerRatio - kFillThrottleRange)) / kFillThrottleRange);
+    const double pressure = std::max(dirtyPressure, fillPressure);
+    return Microseconds(std::llround(durationCount<Microseconds>(maxDelay) * pressure * pressure));
+}
+
+WiredTigerCheckpointPacer::WiredTigerCheckpointPacer(WT_CONNECTION* conn, bool checkpointsEnabled)
+    : BackgroundJob(false /* deleteSelf */),
+      _conn(conn),
+      _checkpointsEnabled(checkpointsEnabled),
+      _lastCheckpointCompletedMillis(Date_t::now().toMillisSinceEpoch()) {}
+
+void WiredTigerCheckpointPacer::run() {
+    Client::initThread(name().c_str());
+    ON_BLOCK_EXIT([] { Client::destroy(); });
+
+    LOG(1) << "starting " << name() << " thread";
+
+    WiredTigerSession session(_conn);
+    std::int64_t lastBytesWritten = 0;
+    while (!_shuttingDown.load()) {
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            const int ms = std::max(wiredTigerCheckpointPacerPeriodMillis.load(), 1);
+            _condvar.wait_for(
+                lock, stdx::chrono::milliseconds(ms), [this] { return _shuttingDown.load(); });
+        }
+
+        if (_shuttingDown.load())
+            break;
+
+        const bool pacing = _checkpointsEnabled && wiredTigerCheckpointPacing.load();
+        const bool throttle = wiredTigerWriteThrottle.load();
+        if (!pacing)
+            _setDirtyTarget(kDefaultDirtyTargetPercent);
+        if (!throttle)
+            _currentWriteDelayMicros.store(0);
+        if (!pacing && !throttle) {
+            // The dirtying rate must not be computed across a disabled stretch.
+            _lastSampleTime = Date_t();
+            continue;
+        }
+
+        auto statistic = [&](int key) {
+            return WiredTigerUtil::getStatisticsValueAs<long long>(
+                session.getSession(), "statistics:", "statistics=(fast)", key);
+        };
+        auto inUse = statistic(WT_STAT_CONN_CACHE_BYTES_INUSE);
+        auto dirty = statistic(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+        auto written = statistic(WT_STAT_CONN_CACHE_BYTES_WRITE);
+        auto max = statistic(WT_STAT_CONN_CACHE_BYTES_MAX);
+        if (!inUse.isOK() || !dirty.isOK() || !written.isOK() || !max.isOK() ||
+            max.getValue() <= 0) {
+            LOG(2) << "unable to read WiredTiger cache statistics, skipping checkpoint pacing";
+            continue;
+        }
+
+        const double fillRatio = static_cast<double>(inUse.getValue()) / max.getValue();
+        const double dirtyRatio = static_cast<double>(dirty.getValue()) / max.getValue();
+        if (throttle) {
+            const auto delay = computeWriteDelay(
+                dirtyRatio,
+                fillRatio,
+                Microseconds(std::max(wiredTigerWriteThrottleMaxDelayMicros.load(), 0)));
+            _currentWriteDelayMicros.store(durationCount<Microseconds>(delay));
+        }
+
+        // Bytes dirtied since the last sample are those still dirty plus those written out.
+        const Date_t now = Date_t::now();
+        Sample sample;
+        sample.cacheBytes = max.getValue();
+        sample.dirtyBytes = dirty.getValue();
+        if (_lastSampleTime != Date_t() && now > _lastSampleTime) {
+            const double secs = durationCount<Milliseconds>(now - _lastSampleTime) / 1000.0;
+            sample.dirtyBytesPerSecond =
+                (dirty.getValue() - _lastDirtyBytes + written.getValue() - lastBytesWritten) /
+                secs;
+        }
+        _lastDirtyBytes = dirty.getValue();
+        lastBytesWritten = written.getValue();
+        _lastSampleTime = now;
+
+        if (pacing) {
+            sample.sinceLastCheckpoint = duration_cast<Seconds>(
+                now - Date_t::fromMillisSinceEpoch(_lastCheckpointCompletedMillis.load()));
+            sample.checkpointInterval = Seconds(
+                static_cast<std::int64_t>(wiredTigerGlobalOptions.checkpointDelaySecs));
+            _setDirtyTarget(computeDirtyTargetPercent(sample));
+        }
+    }
+
+    _setDirtyTarget(kDefaultDirtyTargetPercent);
+    LOG(1) << "stopping " << name() << " thread";
+}
+
+void WiredTigerCheckpointPacer::_setDirtyTarget(int percent) {
+    if (percent == _dirtyTargetPercent)
+        return;
+
+    const std::string config = str::stream() << "eviction_dirty_target=" << percent;
+    int ret = _conn->reconfigure(_conn, config.c_str());
+    if (ret != 0) {
+        LOG(1) << "failed to set WiredTiger " << config << ": " << wtRCToStatus(ret).reason();
+        return;
+    }
+
+    LOG(2) << "paced WiredTiger eviction_dirty_target from " << _dirtyTargetPercent << " to "
+           << percent;
+    _dirtyTargetPercent = percent;
+    _currentDirtyTargetPercent.store(percent);
+}
+
+void WiredTigerCheckpointPacer::shutdown() {
+    {
+        stdx::unique_lock<stdx::mutex> lock(_mutex);
+        _shuttingDown.store(true);
+        _condvar.notify_one();
+    }
+    wait();
+}
+
+void WiredTigerCheckpointPacer::onCheckpointCompleted(Milliseconds duration) {
+    const long long millis = durationCount<Milliseconds>(duration);
+    _lastCheckpointCompletedMillis.store(Date_t::now().toMillisSinceEpoch());
+    _checkpoints.fetchAndAdd(1);
+    _lastCheckpointMillis.store(millis);
+    _totalCheckpointMillis.fetchAndAdd(millis);
+}
+
+void WiredTigerCheckpointPacer::throttleWriter(OperationContext* opCtx) {
+    const long long delay = _currentWriteDelayMicros.load();
+    if (delay <= 0 || !opCtx->getClient() || !opCtx->getClient()->isFromUserConnection())
+        return;
+
+    // The caller may hold locks, which is why the delay is capped and never interruptible.
+    sleepmicros(delay);
+    _throttledWrites.fetchAndAdd(1);
+    _totalThrottleMicros.fetchAndAdd(delay);
+}
+
+void WiredTigerCheckpointPacer::appendStats(BSONObjBuilder* builder) const {
+    builder->append("checkpoints", _checkpoints.load());
+    builder->append("last checkpoint duration millis", _lastCheckpointMillis.load());
+    builder->append("total checkpoint duration millis", _totalCheckpointMillis.load());
+    builder->append("eviction dirty target percent", _currentDirtyTargetPercent.load());
+    builder->append("current write delay micros", _currentWriteDelayMicros.load());
+    builder->append("throttled writes", _throttledWrites.load());
+    builder->append("total write throttle micros", _totalThrottleMicros.load());
+}
+
+}  // namespace mongo
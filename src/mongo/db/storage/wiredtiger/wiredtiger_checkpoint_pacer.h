@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <wiredtiger.h>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/background.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+
+/**
+ * Smooths out the I/O burst of periodic checkpoints and the latency cliff of WiredTiger's
+ * eviction stalls. Samples the cache every 'wiredTigerCheckpointPacerPeriodMillis' and:
+ *
+ *  - When 'wiredTigerCheckpointPacing' is enabled, lowers 'eviction_dirty_target' as the next
+ *    checkpoint approaches, so that eviction writes dirty pages out over the checkpoint interval
+ *    instead of leaving them all for the checkpoint itself. The target is restored once the
+ *    checkpoint completes.
+ *
+ *  - When 'wiredTigerWriteThrottle' is enabled, computes a delay that user writers sleep for at
+ *    the start of each write unit of work. The delay grows gradually as the dirty or total cache
+ *    usage approaches the point at which WiredTiger pulls application threads into eviction.
+ *
+ * Also records checkpoint durations and time spent throttled for serverStatus.
+ */
+class WiredTigerCheckpointPacer : public BackgroundJob {
+public:
+    /**
+     * The cache state observed by one pacing period.
+     */
+    struct Sample {
+        std::int64_t cacheBytes = 0;       // configured cache size
+        std::int64_t dirtyBytes = 0;       // dirty bytes currently in the cache
+        double dirtyBytesPerSecond = 0;    // growth of 'dirtyBytes' since the previous sample
+        Seconds sinceLastCheckpoint{0};    // time since the last checkpoint completed
+        Seconds checkpointInterval{0};     // time between checkpoints
+    };
+
+    // WiredTiger's defaults for 'eviction_dirty_target' and 'eviction_dirty_trigger', and for
+    // 'eviction_target' and 'eviction_trigger'. mongod does not override them.
+    static constexpr int kDefaultDirtyTargetPercent = 5;
+    static constexpr double kDirtyTriggerRatio = 0.20;
+    static constexpr double kFillTriggerRatio = 0.95;
+
+    // Pacing never asks eviction to keep less than this much of the cache dirty.
+    static constexpr int kMinDirtyTargetPercent = 1;
+
+    // The write throttle starts this far below each trigger and reaches its maximum delay at it.
+    static constexpr double kDirtyThrottleRange = 0.075;
+    static constexpr double kFillThrottleRange = 0.10;
+
+    /**
+     * Returns the 'eviction_dirty_target' percentage to use for the rest of this period. Ramps
+     * linearly from the default down to kMinDirtyTargetPercent over the checkpoint interval, but
+     * only when the data already dirty plus the data expected to be dirtied before the next
+     * checkpoint would exceed the minimum target; otherwise there is nothing worth spreading out.
+     */
+    static int computeDirtyTargetPercent(const Sample& sample);
+
+    /**
+     * Returns how long a writer should wait given the cache usage ratios. Zero until either
+     * ratio comes within range of its trigger, then rises quadratically to 'maxDelay'.
+     */
+    static Microseconds computeWriteDelay(double cacheDirtyRatio,
+                                          double cacheFillRatio,
+                                          Microseconds maxDelay);
+
+    /**
+     * 'checkpointsEnabled' is false for engines that never checkpoint (e.g. in-memory), in which
+     * case only the write throttle is active.
+     */
+    WiredTigerCheckpointPacer(WT_CONNECTION* conn, bool checkpointsEnabled);
+
+    std::string name() const override {
+        return "WTCheckpointPacer";
+    }
+
+    void run() override;
+
+    void shutdown();
+
+    /**
+     * Called by the checkpoint thread with the time the checkpoint took.
+     */
+    void onCheckpointCompleted(Milliseconds duration);
+
+    /**
+     * Sleeps for the current write delay if 'opCtx' belongs to a user connection. Called at the
+     * start of a write unit of work; never throws.
+     */
+    void throttleWriter(OperationContext* opCtx);
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    void _setDirtyTarget(int percent);
+
+    WT_CONNECTION* const _conn;
+    const bool _checkpointsEnabled;
+
+    // Only accessed by the pacer thread.
+    int _dirtyTargetPercent = kDefaultDirtyTargetPercent;
+    std::int64_t _lastDirtyBytes = 0;
+    Date_t _lastSampleTime;
+
+    AtomicWord<long long> _lastCheckpointCompletedMillis;
+    AtomicWord<long long> _currentWriteDelayMicros{0};
+    AtomicWord<int> _currentDirtyTargetPercent{kDefaultDirtyTargetPercent};
+
+    AtomicWord<long long> _checkpoints{0};
+    AtomicWord<long long> _lastCheckpointMillis{0};
+    AtomicWord<long long> _totalCheckpointMillis{0};
+    AtomicWord<long long> _throttledWrites{0};
+    AtomicWord<long long> _totalThrottleMicros{0};
+
+    stdx::mutex _mutex;  // protects _condvar
+    stdx::condition_variable _condvar;
+
+    AtomicBool _shuttingDown{false};
+};
+
+}  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_pacer.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Pacer = WiredTigerCheckpointPacer;
+
+const std::int64_t kCacheBytes = 1024 * 1024 * 1024;
+
+Pacer::Sample busySample(Seconds sinceLastCheckpoint) {
+    Pacer::Sample sample;
+    sample.cacheBytes = kCacheBytes;
+    sample.dirtyBytes = kCacheBytes / 50;
+    sample.dirtyBytesPerSecond = kCacheBytes / 100;
+    sample.sinceLastCheckpoint = sinceLastCheckpoint;
+    sample.checkpointInterval = Seconds(60);
+    return sample;
+}
+
+TEST(WiredTigerCheckpointPacerTest, DefaultTargetRightAfterCheckpoint) {
+    ASSERT_EQ(Pacer::kDefaultDirtyTargetPercent,
+              Pacer::computeDirtyTargetPercent(busySample(Seconds(0))));
+}
+
+TEST(WiredTigerCheckpointPacerTest, TargetFallsAsCheckpointApproaches) {
+    ASSERT_EQ(3, Pacer::computeDirtyTargetPercent(busySample(Seconds(30))));
+    ASSERT_EQ(Pacer::kMinDirtyTargetPercent,
+              Pacer::computeDirtyTargetPercent(busySample(Seconds(60))));
+    ASSERT_EQ(Pacer::kMinDirtyTargetPercent,
+              Pacer::computeDirtyTargetPercent(busySample(Seconds(90))));
+}
+
+TEST(WiredTigerCheckpointPacerTest, DefaultTargetWhenLittleIsDirtied) {
+    auto sample = busySample(Seconds(55));
+    sample.dirtyBytes = kCacheBytes / 1000;
+    sample.dirtyBytesPerSecond = 0;
+    ASSERT_EQ(Pacer::kDefaultDirtyTargetPercent, Pacer::computeDirtyTargetPercent(sample));
+}
+
+TEST(WiredTigerCheckpointPacerTest, DefaultTargetWithoutCheckpointInterval) {
+    auto sample = busySample(Seconds(55));
+    sample.checkpointInterval = Seconds(0);
+    ASSERT_EQ(Pacer::kDefaultDirtyTargetPercent, Pacer::computeDirtyTargetPercent(sample));
+}
+
+TEST(WiredTigerCheckpointPacerTest, NoWriteDelayBelowThrottleRange) {
+    ASSERT_EQ(Microseconds(0), Pacer::computeWriteDelay(0.05, 0.80, Microseconds(5000)));
+}
+
+TEST(WiredTigerCheckpointPacerTest, WriteDelayRisesGraduallyWithDirtyRatio) {
+    const auto halfway = Pacer::kDirtyTriggerRatio - Pacer::kDirtyThrottleRange / 2;
+    ASSERT_EQ(Microseconds(1250), Pacer::computeWriteDelay(halfway, 0.5, Microseconds(5000)));
+    ASSERT_EQ(Microseconds(5000),
+              Pacer::computeWriteDelay(Pacer::kDirtyTriggerRatio, 0.5, Microseconds(5000)));
+    ASSERT_EQ(Microseconds(5000), Pacer::computeWriteDelay(0.5, 0.5, Microseconds(5000)));
+}
+
+TEST(WiredTigerCheckpointPacerTest, WriteDelayFollowsCacheFill) {
+    ASSERT_EQ(Microseconds(5000),
+              Pacer::computeWriteDelay(0.01, Pacer::kFillTriggerRatio, Microseconds(5000)));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,6 +32,12 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 
 namespace mongo {
+namespace {
+
+AtomicUInt64 fastRestores;
+AtomicUInt64 slowRestores;
+
+}  // namespace
 
 WiredTigerCursor::WiredTigerCursor(const std::string& uri,
                                    uint64_t tableID,
@@ -64,4 +70,33 @@ WiredTigerCursor::~WiredTigerCursor() {
 void WiredTigerCursor::reset() {
     invariantWTOK(_cursor->reset(_cursor));
 }
+
+void WiredTigerCursor::save() {
+    if (_ru->inActiveTxn()) {
+        _savedSnapshotId = _ru->getSnapshotId();
+        return;
+    }
+    _savedSnapshotId = SnapshotId();
+    reset();
+}
+
+bool WiredTigerCursor::isPositionRetained(OperationContext* opCtx) {
+    // WiredTiger resets all cursors of a session when its transaction ends, and every new
+    // transaction gets a new SnapshotId, so a matching id means the position is unchanged.
+    const bool retained = !_savedSnapshotId.isNull() && WiredTigerRecoveryUnit::get(opCtx) == _ru &&
+        _ru->inActiveTxn() && _ru->getSnapshotId() == _savedSnapshotId;
+    _savedSnapshotId = SnapshotId();
+
+    if (retained) {
+        fastRestores.fetchAndAdd(1);
+    } else {
+        slowRestores.fetchAndAdd(1);
+    }
+    return retained;
+}
+
+void WiredTigerCursor::appendRestoreStats(BSONObjBuilder* builder) {
+    builder->append("fast", static_cast<long long>(fastRestores.load()));
+    builder->append("slow", static_cast<long long>(slowRestores.load()));
+}
 }  // namespace mongo
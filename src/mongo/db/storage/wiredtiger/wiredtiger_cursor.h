@@ -30,7 +30,9 @@
 
 #include <wiredtiger.h>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/storage/snapshot.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
@@ -64,16 +66,38 @@ public:
 
     void reset();
 
+    /**
+     * Prepares the cursor for its owner being saved. While a transaction is open the cursor keeps
+     * its position, which remains valid for as long as that transaction does. Otherwise the cursor
+     * is reset.
+     */
+    void save();
+
+    /**
+     * Returns true if the transaction this cursor was saved in is still open on 'opCtx', in which
+     * case the cursor has not moved since save() and need not be repositioned. Counts the restore
+     * as fast or slow for appendRestoreStats().
+     */
+    bool isPositionRetained(OperationContext* opCtx);
+
     void assertInActiveTxn() const {
         _ru->assertInActiveTxn();
     }
 
+    /**
+     * Appends the number of cursor restores that could and could not skip repositioning.
+     */
+    static void appendRestoreStats(BSONObjBuilder* builder);
+
 protected:
     uint64_t _tableID;
     WiredTigerRecoveryUnit* _ru;
     WiredTigerSession* _session;
     bool _readOnce;
 
+    // The snapshot of the transaction open when the cursor was last saved, if any.
+    SnapshotId _savedSnapshotId;
+
     WT_CURSOR* _cursor = nullptr;  // Owned
 };
 }
@@ -536,6 +536,11 @@ Status WiredTigerIndex::compact(OperationContext* opCtx) {
     return Status::OK();
 }
 
+StatusWith<bool> WiredTigerIndex::compactStep(OperationContext* opCtx, Seconds timeout) {
+    dassert(opCtx->lockState()->isWriteLocked());
+    return WiredTigerUtil::compactStep(opCtx, uri(), timeout);
+}
+
 /**
  * Base class for WiredTigerIndex bulk builders.
  *
@@ -861,10 +866,24 @@ public:
         return curr(parts);
     }
 
+    boost::optional<IndexKeyEntry> seekAtOrPast(const BSONObj& key,
+                                                const RecordId& loc,
+                                                RequestedInfo parts) override {
+        dassert(_opCtx->lockState()->isReadLocked());
+        invariant(_forward);
+
+        // Standard index entries are the key followed by the RecordId, so a single search lands on
+        // the first entry for 'key' whose RecordId is at least 'loc'.
+        _query.resetToKey(stripFieldNames(key), _idx.ordering(), loc);
+        seekWTCursor(_query);
+        updatePosition();
+        return curr(parts);
+    }
+
     void save() override {
         try {
             if (_cursor)
-                _cursor->reset();
+                _cursor->save();
         } catch (const WriteConflictException&) {
             // Ignore since this is only called when we are about to kill our transaction
             // anyway.
@@ -880,6 +899,12 @@ public:
     }
 
     void restore() override {
+        if (!_eof && _cursor && _cursor->isPositionRetained(_opCtx)) {
+            // The cursor has not moved since it was saved, so neither _key nor
+            // _lastMoveSkippedKey need updating.
+            return;
+        }
+
         if (!_cursor) {
             _cursor.emplace(_idx.uri(), _idx.tableId(), false, _opCtx);
         }
@@ -1136,6 +1161,14 @@ public:
                                 KVPrefix prefix)
         : WiredTigerIndexCursorBase(idx, opCtx, forward, prefix) {}
 
+    boost::optional<IndexKeyEntry> seekAtOrPast(const BSONObj& key,
+                                                const RecordId& loc,
+                                                RequestedInfo parts) override {
+        // Unique index entries may or may not have the RecordId appended to the key, so they
+        // cannot be searched by RecordId. There is at most one live entry per key anyway.
+        return SortedDataInterface::Cursor::seekAtOrPast(key, loc, parts);
+    }
+
     // Called after _key has been filled in, ie a new key to be processed has been fetched.
     // Must not throw WriteConflictException, throwing a WriteConflictException will retry the
     // operation effectively skipping over this key.
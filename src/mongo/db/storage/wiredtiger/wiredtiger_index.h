@@ -118,6 +118,8 @@ public:
 
     virtual Status compact(OperationContext* opCtx);
 
+    StatusWith<bool> compactStep(OperationContext* opCtx, Seconds timeout) override;
+
     const std::string& uri() const {
         return _uri;
     }
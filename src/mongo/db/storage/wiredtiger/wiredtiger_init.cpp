@@ -121,6 +121,9 @@ public:
         options.directoryPerDB = params.directoryperdb;
         options.directoryForIndexes = wiredTigerGlobalOptions.directoryForIndexes;
         options.forRepair = params.repair;
+        options.lazyCatalogLoading = params.lazyCatalogLoading;
+        options.warmLazyCatalog = params.lazyCatalogWarming;
+        options.catalogLoadThreads = params.catalogLoadThreads;
         return new KVStorageEngine(kv, options);
     }
 
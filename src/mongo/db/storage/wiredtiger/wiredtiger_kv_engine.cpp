@@ -73,6 +73,7 @@
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/storage_repair_observer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_pacer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_extensions.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
@@ -81,6 +82,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_adjuster.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/background.h"
@@ -213,6 +215,70 @@ private:
     AtomicBool _shuttingDown{false};
 };
 
+// How often the size storer flusher writes dirty collection sizes back to the size storer table.
+AtomicInt32 kWiredTigerSizeStorerPeriodMillis(1000);
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerSizeStorerPeriodMillisSetting(ServerParameterSet::getGlobal(),
+                                            "wiredTigerSizeStorerPeriodMillis",
+                                            &kWiredTigerSizeStorerPeriodMillis);
+
+/**
+ * Periodically writes the sizes of collections that changed since the previous flush back to the
+ * size storer table, so that threads updating sizes never perform the write themselves.
+ */
+class WiredTigerKVEngine::WiredTigerSizeStorerFlusher : public BackgroundJob {
+public:
+    explicit WiredTigerSizeStorerFlusher(WiredTigerKVEngine* wiredTigerKVEngine)
+        : BackgroundJob(false /* deleteSelf */), _wiredTigerKVEngine(wiredTigerKVEngine) {}
+
+    virtual string name() const {
+        return "WTSizeStorerFlusher";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+        ON_BLOCK_EXIT([] { Client::destroy(); });
+
+        LOG(1) << "starting " << name() << " thread";
+
+        while (!_shuttingDown.load()) {
+            {
+                stdx::unique_lock<stdx::mutex> lock(_mutex);
+                MONGO_IDLE_THREAD_BLOCK;
+                const int ms = std::max(kWiredTigerSizeStorerPeriodMillis.load(), 1);
+                _condvar.wait_for(lock, stdx::chrono::milliseconds(ms), [this] {
+                    return _shuttingDown.load();
+                });
+            }
+
+            // The final flush on shutdown is done synchronously by the engine.
+            if (_shuttingDown.load())
+                break;
+
+            _wiredTigerKVEngine->syncSizeInfo(false);
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            _shuttingDown.store(true);
+            _condvar.notify_one();
+        }
+        wait();
+    }
+
+private:
+    WiredTigerKVEngine* _wiredTigerKVEngine;
+
+    stdx::mutex _mutex;  // protects _condvar
+    stdx::condition_variable _condvar;
+
+    AtomicBool _shuttingDown{false};
+};
+
 class WiredTigerKVEngine::WiredTigerCheckpointThread : public BackgroundJob {
 public:
     explicit WiredTigerCheckpointThread(WiredTigerKVEngine* wiredTigerKVEngine,
@@ -278,7 +344,7 @@ public:
                 if (initialDataTimestamp.asULL() <= 1) {
                     UniqueWiredTigerSession session = _sessionCache->getSession();
                     WT_SESSION* s = session->getSession();
-                    invariantWTOK(s->checkpoint(s, "use_timestamp=false"));
+                    _checkpoint(s, "use_timestamp=false");
                 } else if (stableTimestamp < initialDataTimestamp) {
                     LOG_FOR_RECOVERY(2)
                         << "Stable timestamp is behind the initial data timestamp, skipping "
@@ -294,7 +360,7 @@ public:
 
                     UniqueWiredTigerSession session = _sessionCache->getSession();
                     WT_SESSION* s = session->getSession();
-                    invariantWTOK(s->checkpoint(s, "use_timestamp=true"));
+                    _checkpoint(s, "use_timestamp=true");
 
                     // Now that the checkpoint is durable, publish the previously recorded stable
                     // timestamp and oplog needed to recover from it.
@@ -361,6 +427,17 @@ public:
     }
 
 private:
+    /**
+     * Takes a checkpoint and reports how long it took to the pacer.
+     */
+    void _checkpoint(WT_SESSION* s, const char* config) {
+        const Date_t start = Date_t::now();
+        invariantWTOK(s->checkpoint(s, config));
+        if (auto pacer = _wiredTigerKVEngine->getCheckpointPacer()) {
+            pacer->onCheckpointCompleted(Date_t::now() - start);
+        }
+    }
+
     WiredTigerKVEngine* _wiredTigerKVEngine;
     WiredTigerSessionCache* _sessionCache;
 
@@ -430,6 +507,10 @@ TicketServerParameter openReadTransactionParam(&openReadTransaction,
 stdx::function<bool(StringData)> initRsOplogBackgroundThreadCallback = [](StringData) -> bool {
     fassertFailed(40358);
 };
+
+stdx::function<bool(StringData)> requestCappedDeletionCallback = [](StringData) -> bool {
+    return false;
+};
 }  // namespace
 
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
@@ -445,7 +526,6 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
       _oplogManager(stdx::make_unique<WiredTigerOplogManager>()),
       _canonicalName(canonicalName),
       _path(path),
-      _sizeStorerSyncTracker(cs, 100000, Seconds(60)),
       _durable(durable),
       _ephemeral(ephemeral),
       _inRepairMode(repair),
@@ -548,11 +628,20 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     _sessionCache.reset(new WiredTigerSessionCache(this));
 
+    if (!_ephemeral) {
+        _prefetcher = stdx::make_unique<WiredTigerPrefetcher>(_sessionCache.get());
+    }
+
     if (_durable && !_ephemeral) {
         _journalFlusher = stdx::make_unique<WiredTigerJournalFlusher>(_sessionCache.get());
         _journalFlusher->go();
     }
 
+    if (!_readOnly) {
+        _checkpointPacer = std::make_unique<WiredTigerCheckpointPacer>(_conn, !_ephemeral);
+        _checkpointPacer->go();
+    }
+
     if (!_readOnly && !_ephemeral) {
         if (!_recoveryTimestamp.isNull()) {
             setInitialDataTimestamp(_recoveryTimestamp);
@@ -574,7 +663,16 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
 
+    if (!_readOnly) {
+        _sizeStorerFlusher = std::make_unique<WiredTigerSizeStorerFlusher>(this);
+        _sizeStorerFlusher->go();
+    }
+
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+
+    _ticketAdjuster = std::make_unique<WiredTigerTicketAdjuster>(
+        _conn, &openReadTransaction, &openWriteTransaction);
+    _ticketAdjuster->go();
 }
 
 
@@ -583,6 +681,7 @@ WiredTigerKVEngine::~WiredTigerKVEngine() {
         cleanShutdown();
     }
 
+    _prefetcher.reset();
     _sessionCache.reset(NULL);
 }
 
@@ -593,6 +692,7 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openWriteTransaction.used());
         bbb.append("available", openWriteTransaction.available());
         bbb.append("totalTickets", openWriteTransaction.outof());
+        bbb.append("queued", openWriteTransaction.queued());
         bbb.done();
     }
     {
@@ -600,6 +700,7 @@ void WiredTigerKVEngine::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("out", openReadTransaction.used());
         bbb.append("available", openReadTransaction.available());
         bbb.append("totalTickets", openReadTransaction.outof());
+        bbb.append("queued", openReadTransaction.queued());
         bbb.done();
     }
     bb.done();
@@ -665,6 +766,14 @@ void WiredTigerKVEngine::_openWiredTiger(const std::string& path, const std::str
 
 void WiredTigerKVEngine::cleanShutdown() {
     log() << "WiredTigerKVEngine shutting down";
+    if (_ticketAdjuster) {
+        _ticketAdjuster->shutdown();
+        _ticketAdjuster.reset();
+    }
+    if (_sizeStorerFlusher) {
+        _sizeStorerFlusher->shutdown();
+        _sizeStorerFlusher.reset();
+    }
     if (!_readOnly)
         syncSizeInfo(true);
     if (!_conn) {
@@ -682,6 +791,12 @@ void WiredTigerKVEngine::cleanShutdown() {
         _checkpointThread->shutdown();
         log() << "Finished shutting down checkpoint thread";
     }
+    if (_checkpointPacer) {
+        _checkpointPacer->shutdown();
+    }
+    if (_prefetcher) {
+        _prefetcher->shutdown();
+    }
     LOG_FOR_RECOVERY(2) << "Shutdown timestamps. StableTimestamp: " << _stableTimestamp.load()
                         << " Initial data timestamp: " << _initialDataTimestamp.load();
 
@@ -1054,6 +1169,8 @@ std::unique_ptr<RecordStore> WiredTigerKVEngine::getGroupedRecordStore(
     params.cappedMaxDocs = -1;
     if (options.capped && options.cappedMaxDocs)
         params.cappedMaxDocs = options.cappedMaxDocs;
+    params.cappedAsyncDeletes = options.capped && options.cappedAsyncDeletes;
+    params.isClustered = options.clusteredIndex;
 
     std::unique_ptr<WiredTigerRecordStore> ret;
     if (prefix == KVPrefix::kNotPrefixed) {
@@ -1193,11 +1310,6 @@ bool WiredTigerKVEngine::haveDropsQueued() const {
     Date_t now = _clockSource->now();
     Milliseconds delta = now - _previousCheckedDropsQueued;
 
-    if (!_readOnly && _sizeStorerSyncTracker.intervalHasElapsed()) {
-        _sizeStorerSyncTracker.resetLastTime();
-        syncSizeInfo(false);
-    }
-
     // We only want to check the queue max once per second or we'll thrash
     if (delta < Milliseconds(1000))
         return false;
@@ -1251,6 +1363,10 @@ bool WiredTigerKVEngine::supportsDocLocking() const {
     return true;
 }
 
+bool WiredTigerKVEngine::supportsClusteredCollections() const {
+    return true;
+}
+
 bool WiredTigerKVEngine::supportsDirectoryPerDB() const {
     return true;
 }
@@ -1354,6 +1470,14 @@ bool WiredTigerKVEngine::initRsOplogBackgroundThread(StringData ns) {
     return initRsOplogBackgroundThreadCallback(ns);
 }
 
+void WiredTigerKVEngine::setRequestCappedDeletionCallback(stdx::function<bool(StringData)> cb) {
+    requestCappedDeletionCallback = std::move(cb);
+}
+
+bool WiredTigerKVEngine::requestCappedDeletion(StringData ns) {
+    return requestCappedDeletionCallback(ns);
+}
+
 namespace {
 
 MONGO_FAIL_POINT_DEFINE(WTPreserveSnapshotHistoryIndefinitely);
@@ -1560,6 +1684,11 @@ StatusWith<Timestamp> WiredTigerKVEngine::recoverToStableTimestamp(OperationCont
     }
 
     LOG_FOR_ROLLBACK(2) << "WiredTiger::RecoverToStableTimestamp syncing size storer to disk.";
+    // The size storer is replaced below, so it must not be flushed concurrently.
+    if (_sizeStorerFlusher) {
+        _sizeStorerFlusher->shutdown();
+        _sizeStorerFlusher.reset();
+    }
     syncSizeInfo(true);
 
     if (!_ephemeral) {
@@ -1593,6 +1722,10 @@ StatusWith<Timestamp> WiredTigerKVEngine::recoverToStableTimestamp(OperationCont
     }
 
     _sizeStorer = std::make_unique<WiredTigerSizeStorer>(_conn, _sizeStorerUri, _readOnly);
+    if (!_readOnly) {
+        _sizeStorerFlusher = std::make_unique<WiredTigerSizeStorerFlusher>(this);
+        _sizeStorerFlusher->go();
+    }
 
     return {stableTimestamp};
 }
@@ -42,19 +42,21 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_prefetcher.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
-#include "mongo/util/elapsed_tracker.h"
 
 namespace mongo {
 
 class ClockSource;
 class JournalListener;
+class WiredTigerCheckpointPacer;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
+class WiredTigerTicketAdjuster;
 
 struct WiredTigerFileVersion {
     enum class StartupVersion { IS_34, IS_36, IS_40, IS_42 };
@@ -84,6 +86,8 @@ public:
 
     virtual bool supportsDocLocking() const override;
 
+    bool supportsClusteredCollections() const override;
+
     virtual bool supportsDirectoryPerDB() const override;
 
     virtual bool isDurable() const override {
@@ -272,6 +276,22 @@ public:
         return _oplogManager.get();
     }
 
+    /**
+     * Returns the prefetcher used to read ahead of collection scans, or nullptr if this engine
+     * does not read ahead (for instance, because it is in-memory).
+     */
+    WiredTigerPrefetcher* getPrefetcher() const {
+        return _prefetcher.get();
+    }
+
+    /**
+     * Returns the pacer that spreads out checkpoint writes and throttles writers under cache
+     * pressure, or nullptr if this engine is read-only.
+     */
+    WiredTigerCheckpointPacer* getCheckpointPacer() const {
+        return _checkpointPacer.get();
+    }
+
     /**
      * Sets the implementation for `initRsOplogBackgroundThread` (allowing tests to skip the
      * background job, for example). Intended to be called from a MONGO_INITIALIZER and therefore in
@@ -287,6 +307,19 @@ public:
      */
     static bool initRsOplogBackgroundThread(StringData ns);
 
+    /**
+     * Sets the implementation for `requestCappedDeletion`. Intended to be called from a
+     * MONGO_INITIALIZER and therefore in a single threaded context.
+     */
+    static void setRequestCappedDeletionCallback(stdx::function<bool(StringData)> cb);
+
+    /**
+     * Asks the background capped deleter to remove excess documents from the capped collection
+     * 'ns', which must have been created with 'cappedAsyncDeletes'. Returns false if there is no
+     * background deleter, in which case the caller is responsible for deleting the documents.
+     */
+    static bool requestCappedDeletion(StringData ns);
+
     static void appendGlobalStats(BSONObjBuilder& b);
 
     /**
@@ -334,6 +367,7 @@ public:
 
 private:
     class WiredTigerJournalFlusher;
+    class WiredTigerSizeStorerFlusher;
     class WiredTigerCheckpointThread;
 
     /**
@@ -408,14 +442,17 @@ private:
 
     std::unique_ptr<WiredTigerSizeStorer> _sizeStorer;
     std::string _sizeStorerUri;
-    mutable ElapsedTracker _sizeStorerSyncTracker;
 
     bool _durable;
     bool _ephemeral;  // whether we are using the in-memory mode of the WT engine
     const bool _inRepairMode;
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
-    std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;
+    std::unique_ptr<WiredTigerCheckpointPacer> _checkpointPacer;
+    std::unique_ptr<WiredTigerCheckpointThread> _checkpointThread;  // Depends on _checkpointPacer
+    std::unique_ptr<WiredTigerSizeStorerFlusher> _sizeStorerFlusher;  // Depends on _sizeStorer
+    std::unique_ptr<WiredTigerPrefetcher> _prefetcher;  // Depends on _sessionCache
+    std::unique_ptr<WiredTigerTicketAdjuster> _ticketAdjuster;
 
     std::string _rsOptions;
     std::string _indexOptions;
@@ -34,6 +34,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/path.hpp>
 
+#include "mongo/base/checked_cast.h"
 #include "mongo/base/init.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -46,6 +47,7 @@
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 namespace {
@@ -253,6 +255,24 @@ TEST_F(WiredTigerKVEngineRepairTest, UnrecoverableOrphanedDataFilesAreRebuilt) {
 #endif
 }
 
+TEST_F(WiredTigerKVEngineTest, ReadOnlyEngineShutsDownWithoutSizeStorerFlusher) {
+    unittest::TempDir dbpath("wt-kv-read-only");
+    ClockSourceMock cs;
+
+    // A writable engine creates the files, including the size storer table.
+    auto makeEngine = [&](bool readOnly) {
+        return std::make_unique<WiredTigerKVEngine>(
+            kWiredTigerEngineName, dbpath.path(), &cs, "", 1, false, false, false, readOnly);
+    };
+    makeEngine(false)->cleanShutdown();
+
+    // A read-only engine never starts the size storer flusher, so shutting it down must not
+    // touch it.
+    auto readOnlyEngine = makeEngine(true);
+    readOnlyEngine->cleanShutdown();
+    readOnlyEngine.reset();
+}
+
 TEST_F(WiredTigerKVEngineTest, TestOplogTruncation) {
     auto opCtxPtr = makeOperationContext();
     // The initial data timestamp has to be set to take stable checkpoints. The first stable
@@ -298,6 +318,101 @@ TEST_F(WiredTigerKVEngineTest, TestOplogTruncation) {
     assertPinnedMovesSoon(Timestamp(30, 1));
 }
 
+class WiredTigerKVEngineReadAheadTest : public WiredTigerKVEngineTest {
+protected:
+    void setUp() override {
+        WiredTigerKVEngineTest::setUp();
+
+        auto opCtx = makeOperationContext();
+        CollectionOptions options;
+        ASSERT_OK(_engine->createRecordStore(opCtx.get(), "a.b", "collection-readahead", options));
+        _rs = _engine->getRecordStore(opCtx.get(), "a.b", "collection-readahead", options);
+        ASSERT(_rs);
+
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < kNumRecords; ++i) {
+            const std::string record = str::stream() << "record-" << i;
+            StatusWith<RecordId> res =
+                _rs->insertRecord(opCtx.get(), record.c_str(), record.length() + 1, Timestamp());
+            ASSERT_OK(res.getStatus());
+        }
+        uow.commit();
+    }
+
+    void tearDown() override {
+        _rs.reset();
+        WiredTigerKVEngineTest::tearDown();
+    }
+
+    // Waits for the prefetcher thread to have read 'count' records ahead in total.
+    void waitForReadCount(WiredTigerPrefetcher::ReadAhead* readAhead, long long count) {
+        for (int iterations = 0; iterations < 100; ++iterations) {
+            if (readAhead->readCount.load() >= count) {
+                ASSERT_EQ(count, readAhead->readCount.load());
+                return;
+            }
+            sleepmillis(100);
+        }
+        FAIL(str::stream() << "Expected " << count << " records to be read ahead, but only "
+                           << readAhead->readCount.load() << " were");
+    }
+
+    static constexpr int kNumRecords = 100;
+    std::unique_ptr<RecordStore> _rs;
+};
+
+constexpr int WiredTigerKVEngineReadAheadTest::kNumRecords;
+
+TEST_F(WiredTigerKVEngineReadAheadTest, ReadAheadDoesNotChangeScanResults) {
+    auto opCtx = makeOperationContext();
+
+    auto cursor = _rs->getCursor(opCtx.get(), true);
+    ASSERT(cursor->enableReadAhead(10));
+
+    int count = 0;
+    while (auto record = cursor->next()) {
+        const std::string expected = str::stream() << "record-" << count;
+        ASSERT_EQ(expected, record->data.data());
+        ++count;
+    }
+    ASSERT_EQ(kNumRecords, count);
+
+    const auto stats = cursor->getReadAheadStats();
+    ASSERT_EQ(kNumRecords, stats.hits + stats.stalls);
+}
+
+TEST_F(WiredTigerKVEngineReadAheadTest, ReverseScansDoNotReadAhead) {
+    auto opCtx = makeOperationContext();
+
+    auto cursor = _rs->getCursor(opCtx.get(), false);
+    ASSERT_FALSE(cursor->enableReadAhead(10));
+}
+
+TEST_F(WiredTigerKVEngineReadAheadTest, PrefetcherStaysWithinItsWindow) {
+    auto prefetcher = _engine->getPrefetcher();
+    ASSERT(prefetcher);
+
+    const auto& uri = checked_cast<WiredTigerRecordStore*>(_rs.get())->getURI();
+    auto readAhead = prefetcher->startReadAhead(uri, 10);
+
+    // Without a scan making progress, the prefetcher reads one window ahead and stops there.
+    waitForReadCount(readAhead.get(), 10);
+    sleepmillis(100);
+    ASSERT_EQ(10, readAhead->readCount.load());
+    ASSERT_EQ(10, readAhead->readPosition.load());
+
+    // The records the scan returns have all been read ahead. Once half of the window has been
+    // consumed the prefetcher tops it up again.
+    for (int64_t id = 1; id <= 5; ++id) {
+        ASSERT(prefetcher->recordReturned(readAhead.get(), id));
+    }
+    waitForReadCount(readAhead.get(), 15);
+    ASSERT_EQ(15, readAhead->readPosition.load());
+
+    // A scan that jumps past what has been read ahead stalls.
+    ASSERT_FALSE(prefetcher->recordReturned(readAhead.get(), 16));
+}
+
 std::unique_ptr<KVHarnessHelper> makeHelper() {
     return stdx::make_unique<WiredTigerKVHarnessHelper>();
 }
@@ -33,13 +33,16 @@
 
 #include <cstring>
 
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/bits.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -50,6 +53,8 @@ const uint64_t kMinimumTimestamp = 1;
 
 MONGO_FAIL_POINT_DEFINE(WTPausePrimaryOplogDurabilityLoop);
 
+const int WiredTigerOplogManager::kNumVisibilityDelayBuckets;
+
 void WiredTigerOplogManager::start(OperationContext* opCtx,
                                    const std::string& uri,
                                    WiredTigerRecordStore* oplogRecordStore) {
@@ -129,6 +134,12 @@ void WiredTigerOplogManager::waitForAllEarlierOplogWritesToBeVisible(
     invariant(_opsWaitingForVisibility > 0);
     auto exitGuard = MakeGuard([&] { _opsWaitingForVisibility--; });
 
+    // Wake up a journal thread which is delaying its flush, rather than leaving it to notice this
+    // waiter on its next poll.
+    if (_opsWaitingForJournal) {
+        _opsWaitingForJournalCV.notify_one();
+    }
+
     opCtx->waitForConditionOrInterrupt(_opsBecameVisibleCV, lk, [&] {
         auto newLatestVisibleTimestamp = getOplogReadTimestamp();
         if (newLatestVisibleTimestamp < currentLatestVisibleTimestamp) {
@@ -159,6 +170,9 @@ void WiredTigerOplogManager::triggerJournalFlush() {
         _opsWaitingForJournal = true;
         _opsWaitingForJournalCV.notify_one();
     }
+    if (!_oldestInvisibleCommitMicros) {
+        _oldestInvisibleCommitMicros = curTimeMicros64();
+    }
 }
 
 void WiredTigerOplogManager::_oplogJournalThreadLoop(
@@ -236,6 +250,14 @@ void WiredTigerOplogManager::_oplogJournalThreadLoop(
         auto oldTimestamp = getOplogReadTimestamp();
         if (newTimestamp > oldTimestamp) {
             _setOplogReadTimestamp(lk, newTimestamp);
+
+            // Commits which triggered a flush since this one started may not be covered yet, so
+            // start timing them now.
+            const uint64_t now = curTimeMicros64();
+            if (_oldestInvisibleCommitMicros) {
+                _recordVisibilityDelay(lk, now - std::min(now, _oldestInvisibleCommitMicros));
+            }
+            _oldestInvisibleCommitMicros = _opsWaitingForJournal ? now : 0;
         }
         lk.unlock();
 
@@ -259,6 +281,32 @@ void WiredTigerOplogManager::_setOplogReadTimestamp(WithLock, uint64_t newTimest
     LOG(2) << "setting new oplogReadTimestamp: " << newTimestamp;
 }
 
+void WiredTigerOplogManager::_recordVisibilityDelay(WithLock, uint64_t delayMicros) {
+    const int bucket =
+        std::min(64 - countLeadingZeros64(delayMicros), kNumVisibilityDelayBuckets - 1);
+    ++_visibilityDelayBuckets[bucket];
+    ++_visibilityDelayCount;
+    _visibilityDelayTotalMicros += delayMicros;
+}
+
+void WiredTigerOplogManager::appendVisibilityStats(BSONObjBuilder* builder) const {
+    stdx::lock_guard<stdx::mutex> lk(_oplogVisibilityStateMutex);
+
+    BSONArrayBuilder arrayBuilder(builder->subarrayStart("histogram"));
+    for (int i = 0; i < kNumVisibilityDelayBuckets; i++) {
+        if (_visibilityDelayBuckets[i] == 0)
+            continue;
+        BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+        entryBuilder.append("micros", static_cast<long long>(i == 0 ? 0 : 1ULL << (i - 1)));
+        entryBuilder.append("count", static_cast<long long>(_visibilityDelayBuckets[i]));
+        entryBuilder.doneFast();
+    }
+    arrayBuilder.doneFast();
+
+    builder->append("delayMicros", static_cast<long long>(_visibilityDelayTotalMicros));
+    builder->append("count", static_cast<long long>(_visibilityDelayCount));
+}
+
 uint64_t WiredTigerOplogManager::fetchAllCommittedValue(WT_CONNECTION* conn) {
     // Fetch the latest all_committed value from the storage engine.  This value will be a
     // timestamp that has no holes (uncommitted transactions with lower timestamps) behind it.
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/stdx/condition_variable.h"
@@ -38,6 +40,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerRecordStore;
 class WiredTigerSessionCache;
 
@@ -82,12 +85,18 @@ public:
     // all committed timestamp are committed.
     uint64_t fetchAllCommittedValue(WT_CONNECTION* conn);
 
+    // Appends how long committed oplog writes took to become visible to oplog readers, from the
+    // first uncovered commit to the publication of an oplog read timestamp covering it.
+    void appendVisibilityStats(BSONObjBuilder* builder) const;
+
 private:
     void _oplogJournalThreadLoop(WiredTigerSessionCache* sessionCache,
                                  WiredTigerRecordStore* oplogRecordStore) noexcept;
 
     void _setOplogReadTimestamp(WithLock, uint64_t newTimestamp);
 
+    void _recordVisibilityDelay(WithLock, uint64_t delayMicros);
+
     stdx::thread _oplogJournalThread;
     mutable stdx::mutex _oplogVisibilityStateMutex;
     mutable stdx::condition_variable
@@ -107,6 +116,19 @@ private:
     // journal flushing should not be delayed.
     std::int64_t _opsWaitingForVisibility = 0;  // Guarded by oplogVisibilityStateMutex.
 
+    // When the oldest oplog commit not yet covered by the oplog read timestamp triggered a journal
+    // flush, in microseconds since the epoch. Zero if every commit is visible. Guarded by
+    // oplogVisibilityStateMutex.
+    std::uint64_t _oldestInvisibleCommitMicros = 0;
+
+    // Power of two buckets of visibility delays: bucket 0 counts delays under 1 microsecond, and
+    // bucket i > 0 delays in [2^(i-1), 2^i) microseconds. The last bucket counts all longer delays.
+    // Guarded by oplogVisibilityStateMutex.
+    static const int kNumVisibilityDelayBuckets = 28;
+    std::array<std::uint64_t, kNumVisibilityDelayBuckets> _visibilityDelayBuckets{};
+    std::uint64_t _visibilityDelayCount = 0;
+    std::uint64_t _visibilityDelayTotalMicros = 0;
+
     AtomicUInt64 _oplogReadTimestamp;
 };
 }  // namespace mongo
@@ -0,0 +1,238 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_prefetcher.h"
+
+#include <algorithm>
+
+#include "mongo/db/client.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// Upper bound on the number of records read ahead of one scan before moving on to the next, so
+// that a single fast scan cannot starve the others.
+const long long kMaxRecordsPerPass = 1000;
+
+}  // namespace
+
+WiredTigerPrefetcher::WiredTigerPrefetcher(WiredTigerSessionCache* sessionCache)
+    : _sessionCache(sessionCache) {
+    _thread = stdx::thread(&WiredTigerPrefetcher::_threadLoop, this);
+}
+
+WiredTigerPrefetcher::~WiredTigerPrefetcher() {
+    shutdown();
+}
+
+std::shared_ptr<WiredTigerPrefetcher::ReadAhead> WiredTigerPrefetcher::startReadAhead(
+    const std::string& uri, long long windowRecords) {
+    auto readAhead = std::make_shared<ReadAhead>(uri, windowRecords);
+    readAhead->wakeupRequested.store(true);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _scans.push_back(readAhead);
+    _hasWork = true;
+    _workAvailable.notify_one();
+    return readAhead;
+}
+
+bool WiredTigerPrefetcher::recordReturned(ReadAhead* readAhead, int64_t id) {
+    const long long scanCount = readAhead->scanCount.addAndFetch(1);
+    readAhead->scanPosition.store(id);
+
+    const bool hit = id <= readAhead->readPosition.load();
+    if (readAhead->exhausted.load()) {
+        return hit;
+    }
+
+    // Ask for more once half of the window has been consumed, or straight away if the scan has
+    // overtaken the read-ahead.
+    if (!hit || readAhead->readCount.load() - scanCount <= readAhead->windowRecords / 2) {
+        _wakeup(readAhead);
+    }
+    return hit;
+}
+
+void WiredTigerPrefetcher::shutdown() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_shuttingDown) {
+            return;
+        }
+        _shuttingDown = true;
+        _workAvailable.notify_one();
+    }
+
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void WiredTigerPrefetcher::_wakeup(ReadAhead* readAhead) {
+    if (readAhead->wakeupRequested.swap(true)) {
+        // The thread has already been asked and has not got to this scan yet.
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _hasWork = true;
+    _workAvailable.notify_one();
+}
+
+void WiredTigerPrefetcher::_threadLoop() noexcept {
+    Client::initThread("WTPrefetcher");
+
+    UniqueWiredTigerSession session = _sessionCache->getSession();
+    std::vector<std::shared_ptr<ReadAhead>> scans;
+
+    while (true) {
+        scans.clear();
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            {
+                MONGO_IDLE_THREAD_BLOCK;
+                _workAvailable.wait(lk, [&] { return _shuttingDown || _hasWork; });
+            }
+
+            if (_shuttingDown) {
+                break;
+            }
+            _hasWork = false;
+
+            auto newEnd = std::remove_if(_scans.begin(), _scans.end(), [&](const auto& weak) {
+                auto scan = weak.lock();
+                if (!scan) {
+                    return true;
+                }
+                if (scan->wakeupRequested.load()) {
+                    scans.push_back(std::move(scan));
+                }
+                return false;
+            });
+            _scans.erase(newEnd, _scans.end());
+        }
+
+        bool shortOfWindow = false;
+        for (auto&& scan : scans) {
+            scan->wakeupRequested.store(false);
+            if (_readAheadOf(session->getSession(), scan.get())) {
+                scan->wakeupRequested.store(true);
+                shortOfWindow = true;
+            }
+        }
+
+        if (shortOfWindow) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _hasWork = true;
+        }
+    }
+
+    // Release our session before the session cache can be shut down.
+    scans.clear();
+    session.reset();
+}
+
+bool WiredTigerPrefetcher::_readAheadOf(WT_SESSION* session, ReadAhead* readAhead) {
+    if (readAhead->exhausted.load()) {
+        return false;
+    }
+
+    // If the scan has caught up with us, there is no point reading what it has already read.
+    int64_t start = readAhead->readPosition.load();
+    const int64_t scanPosition = readAhead->scanPosition.load();
+    if (scanPosition >= start) {
+        start = scanPosition;
+        readAhead->readCount.store(readAhead->scanCount.load());
+    }
+
+    const long long wanted = std::min(
+        readAhead->windowRecords - (readAhead->readCount.load() - readAhead->scanCount.load()),
+        kMaxRecordsPerPass);
+    if (wanted <= 0) {
+        return false;
+    }
+
+    // Open and close a cursor for every pass rather than caching one, so that we never keep the
+    // table busy and prevent it from being dropped.
+    WT_CURSOR* cursor;
+    if (session->open_cursor(session, readAhead->uri.c_str(), nullptr, nullptr, &cursor) != 0) {
+        readAhead->exhausted.store(true);
+        return false;
+    }
+    ON_BLOCK_EXIT([&] {
+        cursor->close(cursor);
+        session->reset(session);
+    });
+
+    cursor->set_key(cursor, start);
+    int cmp;
+    int ret = cursor->search_near(cursor, &cmp);
+    if (ret == 0 && cmp <= 0) {
+        // Positioned at or before 'start', which has already been read.
+        ret = cursor->next(cursor);
+    }
+
+    long long numRead = 0;
+    int64_t lastRead = start;
+    while (ret == 0 && numRead < wanted) {
+        WT_ITEM value;
+        if (cursor->get_key(cursor, &lastRead) != 0 || cursor->get_value(cursor, &value) != 0) {
+            break;
+        }
+        ++numRead;
+        ret = cursor->next(cursor);
+    }
+
+    readAhead->readPosition.store(lastRead);
+    readAhead->readCount.fetchAndAdd(numRead);
+
+    if (ret == WT_NOTFOUND) {
+        readAhead->exhausted.store(true);
+        return false;
+    }
+    if (ret != 0 && ret != WT_ROLLBACK) {
+        LOG(1) << "Stopping read-ahead of " << readAhead->uri << ": " << wiredtiger_strerror(ret);
+        readAhead->exhausted.store(true);
+        return false;
+    }
+    return numRead == wanted && readAhead->readCount.load() - readAhead->scanCount.load() <
+        readAhead->windowRecords;
+}
+
+}  // namespace mongo
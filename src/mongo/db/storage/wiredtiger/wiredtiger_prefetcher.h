@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <wiredtiger.h>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+class WiredTigerSessionCache;
+
+/**
+ * Reads ahead of forward collection scans so that the pages they are about to need are brought
+ * into the WiredTiger cache while they are still processing earlier records.
+ *
+ * A scanning cursor registers itself with startReadAhead() and publishes its progress in the
+ * returned ReadAhead object. A single background thread, using its own session, walks each
+ * registered table from the furthest point read so far until it is 'windowRecords' records ahead
+ * of the scan, then sleeps until a scan asks for more. The thread only reads; it never affects the
+ * results or the snapshot of the scans it serves.
+ */
+class WiredTigerPrefetcher {
+    MONGO_DISALLOW_COPYING(WiredTigerPrefetcher);
+
+public:
+    /**
+     * Progress of one scan, shared between the scanning cursor and the prefetcher thread. Record
+     * ids are stored as RecordId::repr() values, which is only valid for tables keyed by int64.
+     */
+    struct ReadAhead {
+        ReadAhead(std::string uri, long long windowRecords)
+            : uri(std::move(uri)), windowRecords(windowRecords) {}
+
+        const std::string uri;
+        const long long windowRecords;
+
+        // Number of records returned by the scan, and the last one returned. Written by the scan.
+        AtomicInt64 scanCount{0};
+        AtomicInt64 scanPosition{0};
+
+        // Number of records read ahead, and the last one read. Written by the prefetcher thread.
+        AtomicInt64 readCount{0};
+        AtomicInt64 readPosition{0};
+
+        // Set once the prefetcher has reached the end of the table or can no longer open it.
+        AtomicWord<bool> exhausted{false};
+
+        // Set by the scan when it has asked the prefetcher thread for more, cleared by the thread.
+        AtomicWord<bool> wakeupRequested{false};
+    };
+
+    explicit WiredTigerPrefetcher(WiredTigerSessionCache* sessionCache);
+    ~WiredTigerPrefetcher();
+
+    /**
+     * Starts reading ahead of a forward scan over the table 'uri'. Reading ahead stops once the
+     * caller releases the returned object.
+     */
+    std::shared_ptr<ReadAhead> startReadAhead(const std::string& uri, long long windowRecords);
+
+    /**
+     * Called by a scan after returning the record 'id' to keep 'readAhead' up to date. Returns
+     * true if the record had already been read ahead.
+     */
+    bool recordReturned(ReadAhead* readAhead, int64_t id);
+
+    /**
+     * Stops the prefetcher thread. Must be called before the session cache shuts down.
+     */
+    void shutdown();
+
+private:
+    void _threadLoop() noexcept;
+
+    /**
+     * Reads up to a window's worth of records ahead of the scan described by 'readAhead'.
+     * Returns true if the scan is still short of its window afterwards.
+     */
+    bool _readAheadOf(WT_SESSION* session, ReadAhead* readAhead);
+
+    void _wakeup(ReadAhead* readAhead);
+
+    WiredTigerSessionCache* const _sessionCache;
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+
+    // Scans to read ahead of. Entries for scans which have finished are pruned by the thread.
+    std::vector<std::weak_ptr<ReadAhead>> _scans;  // Guarded by _mutex.
+    bool _hasWork = false;                         // Guarded by _mutex.
+    bool _shuttingDown = false;                    // Guarded by _mutex.
+
+    stdx::thread _thread;
+};
+
+}  // namespace mongo
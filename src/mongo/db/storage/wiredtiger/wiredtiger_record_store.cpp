@@ -37,9 +37,14 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "mongo/base/checked_cast.h"
+#include "mongo/base/counter.h"
 #include "mongo/base/static_assert.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -47,8 +52,11 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/repl_settings.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/server_recovery.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/clustered_id.h"
+#include "mongo/db/storage/index_entry_comparison.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_global_options.h"
@@ -87,6 +95,110 @@ void checkOplogFormatVersion(OperationContext* opCtx, const std::string& uri) {
 
     fassertNoTrace(39998, appMetadata.getValue().getIntField("oplogKeyExtractionVersion") == 1);
 }
+
+// Oplog entries newer than this many seconds are not truncated, even if the oplog has grown beyond
+// its configured size. Zero retains the oplog by size only.
+AtomicInt32 kWiredTigerOplogMinRetentionSeconds(0);
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerOplogMinRetentionSecondsSetting(ServerParameterSet::getGlobal(),
+                                              "wiredTigerOplogMinRetentionSeconds",
+                                              &kWiredTigerOplogMinRetentionSeconds);
+
+// The rate, in megabytes per second, at which the oplog truncater thread may reclaim oplog stones.
+// Zero disables the limit.
+AtomicInt32 kWiredTigerOplogTruncationMaxMBPerSec(0);
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerOplogTruncationMaxMBPerSecSetting(ServerParameterSet::getGlobal(),
+                                                "wiredTigerOplogTruncationMaxMBPerSec",
+                                                &kWiredTigerOplogTruncationMaxMBPerSec);
+
+Counter64 oplogTruncationCount;
+Counter64 oplogTruncationMicros;
+Counter64 oplogTruncationRecords;
+Counter64 oplogTruncationBytes;
+
+ServerStatusMetricField<Counter64> displayOplogTruncationCount("oplogTruncation.truncateCount",
+                                                               &oplogTruncationCount);
+ServerStatusMetricField<Counter64> displayOplogTruncationMicros(
+    "oplogTruncation.totalTimeTruncatingMicros", &oplogTruncationMicros);
+ServerStatusMetricField<Counter64> displayOplogTruncationRecords(
+    "oplogTruncation.recordsReclaimed", &oplogTruncationRecords);
+ServerStatusMetricField<Counter64> displayOplogTruncationBytes("oplogTruncation.bytesReclaimed",
+                                                               &oplogTruncationBytes);
+
+// When true, updates that rewrite a record only hand the changed byte ranges to WiredTiger via
+// WT_CURSOR::modify, so that small changes to large documents produce small log records.
+AtomicBool kWiredTigerUpdateRecordWithModify(true);
+
+ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>
+    WiredTigerUpdateRecordWithModifySetting(ServerParameterSet::getGlobal(),
+                                            "wiredTigerUpdateRecordWithModify",
+                                            &kWiredTigerUpdateRecordWithModify);
+
+// Records smaller than this are always rewritten in full; a modify saves little for them and
+// makes every later read reassemble the value.
+const size_t kMinRecordSizeForModify = 1024;
+
+// A modify is only used when the bytes it carries are at most this fraction of the new record.
+const size_t kMaxModifyFractionDenominator = 10;
+
+/**
+ * Describes the transition from 'oldData' to 'newData' as at most two WT_MODIFY entries: one for
+ * the BSON length header, which changes whenever the document grows or shrinks, and one covering
+ * everything between the longest common prefix and the longest common suffix of the remainder.
+ *
+ * Returns the number of entries written to 'entries', or 0 if the record should be rewritten in
+ * full instead.
+ */
+int computeModifyEntries(const char* oldData,
+                         size_t oldLen,
+                         const char* newData,
+                         size_t newLen,
+                         WT_MODIFY* entries) {
+    const size_t kHeaderSize = sizeof(int32_t);
+    if (newLen < kMinRecordSizeForModify || oldLen < kHeaderSize)
+        return 0;
+
+    int nentries = 0;
+    if (std::memcmp(oldData, newData, kHeaderSize) != 0) {
+        entries[nentries].data.data = newData;
+        entries[nentries].data.size = kHeaderSize;
+        entries[nentries].offset = 0;
+        entries[nentries].size = kHeaderSize;
+        ++nentries;
+    }
+
+    const size_t commonLen = std::min(oldLen, newLen);
+    size_t prefix = kHeaderSize;
+    while (prefix < commonLen && oldData[prefix] == newData[prefix])
+        ++prefix;
+
+    size_t suffix = 0;
+    while (suffix < commonLen - prefix &&
+           oldData[oldLen - suffix - 1] == newData[newLen - suffix - 1])
+        ++suffix;
+
+    const size_t replacedLen = oldLen - prefix - suffix;
+    const size_t insertedLen = newLen - prefix - suffix;
+    if (replacedLen != 0 || insertedLen != 0) {
+        entries[nentries].data.data = newData + prefix;
+        entries[nentries].data.size = insertedLen;
+        entries[nentries].offset = prefix;
+        entries[nentries].size = replacedLen;
+        ++nentries;
+    }
+
+    const size_t modifiedBytes = insertedLen + (nentries == 2 ? kHeaderSize : 0);
+    if (nentries == 0 || modifiedBytes > newLen / kMaxModifyFractionDenominator)
+        return 0;
+    return nentries;
+}
+
+// How often the oplog truncater thread re-evaluates the oldest stone against the minimum retention
+// window when no new stones are being created.
+const Seconds kRetentionWindowPollInterval(1);
 }  // namespace
 
 MONGO_FAIL_POINT_DEFINE(WTWriteConflictException);
@@ -106,6 +218,10 @@ const std::string kWiredTigerEngineName = "wiredTiger";
 // cursors will be available in the needed session caches.
 static int kCappedDocumentRemoveLimit = 3;
 
+// The number of oplog stones to divide the oplog into, based on its maximum size.
+static const unsigned long long kMinStonesToKeep = 10ULL;
+static const unsigned long long kMaxStonesToKeep = 100ULL;
+
 class WiredTigerRecordStore::OplogStones::InsertChange final : public RecoveryUnit::Change {
 public:
     InsertChange(OplogStones* oplogStones,
@@ -122,8 +238,10 @@ public:
         invariant(_highestInserted.isValid());
 
         _oplogStones->_currentRecords.addAndFetch(_countInserted);
-        int64_t newCurrentBytes = _oplogStones->_currentBytes.addAndFetch(_bytesInserted);
-        if (newCurrentBytes >= _oplogStones->_minBytesPerStone) {
+        _oplogStones->_currentBytes.addAndFetch(_bytesInserted);
+        _oplogStones->_currentStartSecs.compareAndSwap(
+            0, Timestamp(_highestInserted.repr()).getSecs());
+        if (_oplogStones->_isCurrentStoneFull(_highestInserted)) {
             _oplogStones->createNewStoneIfNeeded(_highestInserted);
         }
     }
@@ -144,6 +262,7 @@ public:
     void commit(boost::optional<Timestamp>) final {
         _oplogStones->_currentRecords.store(0);
         _oplogStones->_currentBytes.store(0);
+        _oplogStones->_currentStartSecs.store(0);
 
         stdx::lock_guard<stdx::mutex> lk(_oplogStones->_mutex);
         _oplogStones->_stones.clear();
@@ -163,9 +282,6 @@ WiredTigerRecordStore::OplogStones::OplogStones(OperationContext* opCtx, WiredTi
     invariant(rs->cappedMaxSize() > 0);
     unsigned long long maxSize = rs->cappedMaxSize();
 
-    const unsigned long long kMinStonesToKeep = 10ULL;
-    const unsigned long long kMaxStonesToKeep = 100ULL;
-
     unsigned long long numStones = maxSize / BSONObjMaxInternalSize;
     size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
     _minBytesPerStone = maxSize / numStonesToKeep;
@@ -192,6 +308,7 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
     // Wait until kill() is called or there are too many oplog stones.
     stdx::unique_lock<stdx::mutex> lock(_oplogReclaimMutex);
     while (!_isDead) {
+        bool throttled = false;
         {
             MONGO_IDLE_THREAD_BLOCK;
             stdx::lock_guard<stdx::mutex> lk(_mutex);
@@ -207,12 +324,44 @@ void WiredTigerRecordStore::OplogStones::awaitHasExcessStonesOrDead() {
                 invariant(stone.lastRecord.isValid());
                 if (static_cast<std::uint64_t>(stone.lastRecord.repr()) <
                     _rs->getPinnedOplog().asULL()) {
-                    break;
+                    if (Date_t::now() >= _nextTruncationAllowed) {
+                        break;
+                    }
+                    throttled = true;
                 }
             }
         }
-        _oplogReclaimCv.wait(lock);
+
+        MONGO_IDLE_THREAD_BLOCK;
+        if (throttled) {
+            _oplogReclaimCv.wait_until(lock, _nextTruncationAllowed.toSystemTimePoint());
+        } else if (kWiredTigerOplogMinRetentionSeconds.load() > 0) {
+            // The oldest stone may leave the retention window without any new stones being made.
+            _oplogReclaimCv.wait_for(lock, kRetentionWindowPollInterval.toSystemDuration());
+        } else {
+            _oplogReclaimCv.wait(lock);
+        }
+    }
+}
+
+void WiredTigerRecordStore::OplogStones::recordTruncation(int64_t bytes) {
+    const int32_t maxMBPerSec = kWiredTigerOplogTruncationMaxMBPerSec.load();
+    if (maxMBPerSec <= 0) {
+        return;
+    }
+
+    const auto delay = Microseconds(bytes / maxMBPerSec);  // 1 MB/s == 1 byte per microsecond.
+    stdx::lock_guard<stdx::mutex> lk(_oplogReclaimMutex);
+    _nextTruncationAllowed = std::max(_nextTruncationAllowed, Date_t::now()) + delay;
+}
+
+bool WiredTigerRecordStore::OplogStones::isTruncationAllowed() {
+    if (kWiredTigerOplogTruncationMaxMBPerSec.load() <= 0) {
+        return true;
     }
+
+    stdx::lock_guard<stdx::mutex> lk(_oplogReclaimMutex);
+    return Date_t::now() >= _nextTruncationAllowed;
 }
 
 boost::optional<WiredTigerRecordStore::OplogStones::Stone>
@@ -239,7 +388,7 @@ void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRec
         return;
     }
 
-    if (_currentBytes.load() < _minBytesPerStone) {
+    if (!_isCurrentStoneFull(lastRecord)) {
         // Must have raced to create a new stone, someone else already triggered it.
         return;
     }
@@ -253,11 +402,37 @@ void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRec
 
     LOG(2) << "create new oplogStone, current stones:" << _stones.size();
     OplogStones::Stone stone = {_currentRecords.swap(0), _currentBytes.swap(0), lastRecord};
+    _currentStartSecs.store(Timestamp(lastRecord.repr()).getSecs());
     _stones.push_back(stone);
 
     _pokeReclaimThreadIfNeeded();
 }
 
+bool WiredTigerRecordStore::OplogStones::_isCurrentStoneFull(RecordId highestInserted) const {
+    if (_currentBytes.load() >= _minBytesPerStone) {
+        return true;
+    }
+
+    // With a retention window, also close stones by age so that the oplog of a slow writer is not
+    // held in a few stones spanning much more time than the window.
+    const int32_t retentionSecs = kWiredTigerOplogMinRetentionSeconds.load();
+    const unsigned startSecs = _currentStartSecs.load();
+    if (retentionSecs <= 0 || startSecs == 0 || _currentRecords.load() == 0) {
+        return false;
+    }
+    const unsigned maxStoneSecs = std::max(1U, unsigned(retentionSecs / kMinStonesToKeep));
+    return Timestamp(highestInserted.repr()).getSecs() >= startSecs + maxStoneSecs;
+}
+
+bool WiredTigerRecordStore::OplogStones::_isWithinRetentionWindow(const Stone& stone) const {
+    const int32_t retentionSecs = kWiredTigerOplogMinRetentionSeconds.load();
+    if (retentionSecs <= 0) {
+        return false;
+    }
+    const long long nowSecs = durationCount<Seconds>(Date_t::now().toDurationSinceEpoch());
+    return Timestamp(stone.lastRecord.repr()).getSecs() + (long long)retentionSecs > nowSecs;
+}
+
 void WiredTigerRecordStore::OplogStones::updateCurrentStoneAfterInsertOnCommit(
     OperationContext* opCtx,
     int64_t bytesInserted,
@@ -355,6 +530,7 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesByScanning(OperationCon
                    << Timestamp(record->id.repr()).toStringPretty();
 
             OplogStones::Stone stone = {_currentRecords.swap(0), _currentBytes.swap(0), record->id};
+            _currentStartSecs.store(Timestamp(record->id.repr()).getSecs());
             _stones.push_back(stone);
         }
 
@@ -444,6 +620,9 @@ void WiredTigerRecordStore::OplogStones::_calculateStonesBySampling(OperationCon
     }
 
     // Account for the partially filled chunk.
+    if (!_stones.empty()) {
+        _currentStartSecs.store(Timestamp(_stones.back().lastRecord.repr()).getSecs());
+    }
     _currentRecords.store(_rs->numRecords(opCtx) - estRecordsPerStone * wholeStones);
     _currentBytes.store(_rs->dataSize(opCtx) - estBytesPerStone * wholeStones);
 }
@@ -456,8 +635,6 @@ void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
 
 void WiredTigerRecordStore::OplogStones::adjust(int64_t maxSize) {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    const unsigned long long kMinStonesToKeep = 10ULL;
-    const unsigned long long kMaxStonesToKeep = 100ULL;
 
     unsigned long long numStones = maxSize / BSONObjMaxInternalSize;
     size_t numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
@@ -640,6 +817,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _isCapped(params.isCapped),
       _isEphemeral(params.isEphemeral),
       _isOplog(NamespaceString::oplog(params.ns)),
+      _isClustered(params.isClustered),
       _cappedMaxSize(params.cappedMaxSize),
       _cappedMaxSizeSlack(std::min(params.cappedMaxSize / 10, int64_t(16 * 1024 * 1024))),
       _cappedMaxDocs(params.cappedMaxDocs),
@@ -648,6 +826,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
       _cappedCallback(params.cappedCallback),
       _shuttingDown(false),
       _cappedDeleteCheckCount(0),
+      _cappedAsyncDeletes(params.cappedAsyncDeletes),
       _sizeStorer(params.sizeStorer),
       _kvEngine(kvEngine) {
     Status versionStatus = WiredTigerUtil::checkApplicationMetadataFormatVersion(
@@ -665,9 +844,11 @@ WiredTigerRecordStore::WiredTigerRecordStore(WiredTigerKVEngine* kvEngine,
     if (_isCapped) {
         invariant(_cappedMaxSize > 0);
         invariant(_cappedMaxDocs == -1 || _cappedMaxDocs > 0);
+        invariant(!_cappedAsyncDeletes || (_cappedMaxDocs == -1 && !_isOplog));
     } else {
         invariant(_cappedMaxSize == -1);
         invariant(_cappedMaxDocs == -1);
+        invariant(!_cappedAsyncDeletes);
     }
 
     if (_isOplog) {
@@ -923,6 +1104,9 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
     if (!cappedAndNeedDelete())
         return 0;
 
+    if (_cappedAsyncDeletes && _requestAsyncCappedDelete())
+        return 0;
+
     // ensure only one thread at a time can do deletes, otherwise they'll conflict.
     stdx::unique_lock<stdx::timed_mutex> lock(_cappedDeleterMutex, stdx::defer_lock);
 
@@ -955,6 +1139,64 @@ int64_t WiredTigerRecordStore::_cappedDeleteAsNeeded(OperationContext* opCtx,
     return _cappedDeleteAsNeeded_inlock(opCtx, justInserted);
 }
 
+bool WiredTigerRecordStore::_requestAsyncCappedDelete() {
+    // Only the first inserter to notice the overflow issues the request, unless the background
+    // deleter is falling behind, in which case the request is repeated in case it was lost.
+    const bool farBehind =
+        (_sizeInfo->dataSize.load() - _cappedMaxSize) >= (2 * _cappedMaxSizeSlack);
+    if (!_cappedDeleteRequested.swap(true) || farBehind) {
+        if (!WiredTigerKVEngine::requestCappedDeletion(ns())) {
+            _cappedDeleteRequested.store(false);
+            return false;
+        }
+    }
+
+    if (!farBehind)
+        return true;
+
+    // Apply back-pressure so the overshoot stays bounded. Don't wait forever: we're in a
+    // transaction, we could block eviction.
+    Date_t before = Date_t::now();
+    {
+        stdx::unique_lock<stdx::mutex> lk(_cappedReclaimMutex);
+        _cappedReclaimCV.wait_for(lk, stdx::chrono::milliseconds(200), [&] {
+            return (_sizeInfo->dataSize.load() - _cappedMaxSize) < (2 * _cappedMaxSizeSlack);
+        });
+    }
+    _cappedSleep.fetchAndAdd(1);
+    _cappedSleepMS.fetchAndAdd(durationCount<Milliseconds>(Date_t::now() - before));
+    return true;
+}
+
+int64_t WiredTigerRecordStore::reclaimCapped(OperationContext* opCtx) {
+    invariant(_cappedAsyncDeletes);
+
+    // Clear the request before looking at the size so that an insert racing with the last batch
+    // below issues a new request rather than being lost.
+    _cappedDeleteRequested.store(false);
+
+    int64_t docsRemoved = 0;
+    stdx::lock_guard<stdx::timed_mutex> lock(_cappedDeleterMutex);
+    while (cappedAndNeedDelete() && !inShutdown()) {
+        opCtx->checkForInterrupt();
+
+        // There is no inserted record to protect here: uncommitted inserts are invisible to the
+        // deletion's side transaction, and a truncate that overlaps one write-conflicts and is
+        // retried on the next request.
+        int64_t removed = _cappedDeleteAsNeeded_inlock(opCtx, RecordId::max());
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(_cappedReclaimMutex);
+            _cappedReclaimCV.notify_all();
+        }
+
+        if (removed == 0)
+            break;
+        docsRemoved += removed;
+    }
+    return docsRemoved;
+}
+
 Timestamp WiredTigerRecordStore::getPinnedOplog() const {
     return _kvEngine->getPinnedOplog();
 }
@@ -1176,6 +1418,11 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
         invariant(stone->lastRecord.isValid());
 
+        if (!_oplogStones->isTruncationAllowed()) {
+            // The truncater thread waits out the rate limit without holding any locks.
+            break;
+        }
+
         if (static_cast<std::uint64_t>(stone->lastRecord.repr()) >= mayTruncateUpTo.asULL()) {
             // Do not truncate oplogs needed for replication recovery.
             return;
@@ -1189,6 +1436,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
         WT_SESSION* session = ru->getSession()->getSession();
 
         try {
+            Timer truncateTimer;
             WriteUnitOfWork wuow(opCtx);
 
             WiredTigerCursor cwrap(_uri, _tableId, true, opCtx);
@@ -1210,8 +1458,14 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* opCtx, Timestamp mayT
 
             wuow.commit();
 
+            oplogTruncationCount.increment();
+            oplogTruncationMicros.increment(truncateTimer.micros());
+            oplogTruncationRecords.increment(stone->records);
+            oplogTruncationBytes.increment(stone->bytes);
+
             // Remove the stone after a successful truncation.
             _oplogStones->popOldestStone();
+            _oplogStones->recordTruncation(stone->bytes);
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
@@ -1263,6 +1517,15 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             if (!status.isOK())
                 return status.getStatus();
             record.id = status.getValue();
+        } else if (_isClustered) {
+            StatusWith<RecordId> status =
+                clustered_id::extractKey(record.data.data(), record.data.size());
+            if (!status.isOK())
+                return status.getStatus();
+            record.id = status.getValue();
+            // Clustered RecordIds follow the _id values, so a batch need not be ascending.
+            highestId = std::max(highestId, record.id);
+            continue;
         } else if (_isCapped) {
             record.id = _nextId();
         } else {
@@ -1292,6 +1555,19 @@ Status WiredTigerRecordStore::_insertRecords(OperationContext* opCtx,
             fassert(39001, opCtx->recoveryUnit()->setTimestamp(ts));
         }
         setKey(c, record.id);
+        if (_isClustered) {
+            // There is no _id index to enforce uniqueness, so the record store does it. Concurrent
+            // inserts of the same _id conflict in WiredTiger and one of them is retried.
+            int ret = wiredTigerPrepareConflictRetry(opCtx, [&] { return c->search(c); });
+            if (ret == 0) {
+                const BSONObj doc(record.data.data());
+                return buildDupKeyErrorStatus(
+                    BSON("" << doc["_id"]), ns(), "_id_", BSON("_id" << 1));
+            }
+            if (ret != WT_NOTFOUND)
+                return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecord");
+            setKey(c, record.id);
+        }
         WiredTigerItem value(record.data.data(), record.data.size());
         c->set_value(c, value.Get());
         int ret = WT_OP_CHECK(c->insert(c));
@@ -1323,6 +1599,82 @@ StatusWith<RecordId> WiredTigerRecordStore::insertRecord(OperationContext* opCtx
     return StatusWith<RecordId>(record.id);
 }
 
+class WiredTigerRecordStore::BulkBuilder final : public RecordStoreBulkBuilder {
+public:
+    BulkBuilder(WiredTigerRecordStore* rs, UniqueWiredTigerSession session, WT_CURSOR* cursor)
+        : _rs(rs), _session(std::move(session)), _cursor(cursor) {}
+
+    ~BulkBuilder() {
+        if (_cursor) {
+            invariantWTOK(_cursor->close(_cursor));
+        }
+    }
+
+    StatusWith<RecordId> addRecord(const char* data, int len) override {
+        invariant(_cursor);
+
+        // A bulk cursor only accepts keys in increasing order, which is how new RecordIds are
+        // assigned.
+        const RecordId id = _rs->_nextId();
+        _rs->setKey(_cursor, id);
+        WiredTigerItem value(data, len);
+        _cursor->set_value(_cursor, value.Get());
+        int ret = WT_OP_CHECK(_cursor->insert(_cursor));
+        if (ret)
+            return wtRCToStatus(ret, "WiredTigerRecordStore::BulkBuilder::addRecord");
+
+        ++_numRecords;
+        _dataSize += len;
+        return id;
+    }
+
+    void commit(OperationContext* opCtx) override {
+        invariant(_cursor);
+
+        // The records become visible when the bulk cursor is closed. They were written outside of
+        // any transaction, so the size adjustments must not be rolled back either.
+        invariantWTOK(_cursor->close(_cursor));
+        _cursor = nullptr;
+        _rs->_changeNumRecords(nullptr, _numRecords);
+        _rs->_increaseDataSize(nullptr, _dataSize);
+    }
+
+private:
+    WiredTigerRecordStore* const _rs;
+    UniqueWiredTigerSession const _session;
+    WT_CURSOR* _cursor;
+    int64_t _numRecords = 0;
+    int64_t _dataSize = 0;
+};
+
+std::unique_ptr<RecordStoreBulkBuilder> WiredTigerRecordStore::makeBulkBuilder(
+    OperationContext* opCtx) {
+    dassert(opCtx->lockState()->isCollectionLockedForMode(_ns, MODE_X));
+
+    // Bulk loading requires ascending keys, which clustered RecordIds do not guarantee.
+    if (_isCapped || _isOplog || _isClustered || numRecords(opCtx) != 0) {
+        return nullptr;
+    }
+
+    // Open cursors cause the bulk open_cursor to fail with EBUSY.
+    auto sessionCache = WiredTigerRecoveryUnit::get(opCtx)->getSessionCache();
+    WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn()->closeAllCursors(_uri);
+    sessionCache->closeAllCursors(_uri);
+
+    // Use a different session to ensure we don't hijack an existing transaction, and fail quickly
+    // rather than waiting for a checkpoint to complete.
+    auto session = sessionCache->getSession();
+    WT_SESSION* s = session->getSession();
+    WT_CURSOR* cursor;
+    int ret = s->open_cursor(s, _uri.c_str(), NULL, "bulk,checkpoint_wait=false", &cursor);
+    if (ret) {
+        LOG(1) << "failed to open a WiredTiger bulk cursor on " << _uri
+               << ", inserting records individually: " << wiredtiger_strerror(ret);
+        return nullptr;
+    }
+    return stdx::make_unique<BulkBuilder>(this, std::move(session), cursor);
+}
+
 bool WiredTigerRecordStore::isOpHidden_forTest(const RecordId& id) const {
     invariant(id.repr() > 0);
     invariant(_kvEngine->getOplogManager()->isRunning());
@@ -1409,9 +1761,18 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* opCtx,
         return {ErrorCodes::IllegalOperation, "Cannot change the size of a document in the oplog"};
     }
 
-    WiredTigerItem value(data, len);
-    c->set_value(c, value.Get());
-    ret = WT_OP_CHECK(c->insert(c));
+    WT_MODIFY entries[2];
+    const int nentries = kWiredTigerUpdateRecordWithModify.load()
+        ? computeModifyEntries(
+              static_cast<const char*>(old_value.data), old_value.size, data, len, entries)
+        : 0;
+    if (nentries > 0) {
+        ret = WT_OP_CHECK(c->modify(c, entries, nentries));
+    } else {
+        WiredTigerItem value(data, len);
+        c->set_value(c, value.Get());
+        ret = WT_OP_CHECK(c->insert(c));
+    }
     invariantWTOK(ret);
 
     _increaseDataSize(opCtx, len - old_length);
@@ -1506,6 +1867,11 @@ Status WiredTigerRecordStore::compact(OperationContext* opCtx,
     return Status::OK();
 }
 
+StatusWith<bool> WiredTigerRecordStore::compactStep(OperationContext* opCtx, Seconds timeout) {
+    dassert(opCtx->lockState()->isWriteLocked());
+    return WiredTigerUtil::compactStep(opCtx, getURI(), timeout);
+}
+
 Status WiredTigerRecordStore::validate(OperationContext* opCtx,
                                        ValidateCmdLevel level,
                                        ValidateAdaptor* adaptor,
@@ -1583,6 +1949,8 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* opCtx,
         result->appendIntOrLL("maxSize", static_cast<long long>(_cappedMaxSize / scale));
         result->appendIntOrLL("sleepCount", _cappedSleep.load());
         result->appendIntOrLL("sleepMS", _cappedSleepMS.load());
+        if (_cappedAsyncDeletes)
+            result->appendBool("asyncDeletes", true);
     }
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(opCtx)->getSessionNoTxn();
     WT_SESSION* s = session->getSession();
@@ -1710,7 +2078,8 @@ void WiredTigerRecordStore::_changeNumRecords(OperationContext* opCtx, int64_t d
         return;
     }
 
-    opCtx->recoveryUnit()->registerChange(new NumRecordsChange(this, diff));
+    if (opCtx)
+        opCtx->recoveryUnit()->registerChange(new NumRecordsChange(this, diff));
     if (_sizeInfo->numRecords.fetchAndAdd(diff) < 0)
         _sizeInfo->numRecords.store(std::max(diff, int64_t(0)));
 }
@@ -1914,9 +2283,35 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::next() {
     invariantWTOK(c->get_value(c, &value));
 
     _lastReturnedId = id;
+    if (_readAhead) {
+        auto prefetcher = _rs._kvEngine->getPrefetcher();
+        if (prefetcher->recordReturned(_readAhead.get(), id.repr())) {
+            ++_readAheadStats.hits;
+        } else {
+            ++_readAheadStats.stalls;
+        }
+    }
     return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
 }
 
+bool WiredTigerRecordStoreCursorBase::enableReadAhead(long long numRecords) {
+    // Oplog scans are excluded because their visibility rules mean that reading ahead would
+    // mostly touch entries which the scan cannot see yet.
+    if (!_forward || _rs._isOplog || numRecords <= 0 || !_rs._kvEngine) {
+        return false;
+    }
+
+    auto prefetcher = _rs._kvEngine->getPrefetcher();
+    if (!prefetcher) {
+        return false;
+    }
+
+    if (!_readAhead) {
+        _readAhead = prefetcher->startReadAhead(_rs._uri, numRecords);
+    }
+    return true;
+}
+
 boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordId& id) {
     _skipNextAdvance = false;
     WT_CURSOR* c = _cursor->get();
@@ -1942,7 +2337,7 @@ boost::optional<Record> WiredTigerRecordStoreCursorBase::seekExact(const RecordI
 void WiredTigerRecordStoreCursorBase::save() {
     try {
         if (_cursor)
-            _cursor->reset();
+            _cursor->save();
     } catch (const WriteConflictException&) {
         // Ignore since this is only called when we are about to kill our transaction
         // anyway.
@@ -1959,6 +2354,14 @@ bool WiredTigerRecordStoreCursorBase::restore() {
         WiredTigerRecoveryUnit::get(_opCtx)->setIsOplogReader();
     }
 
+    // If the snapshot was kept, the cursor is still where it was saved and no record can have
+    // appeared or disappeared from under it. Capped collections always reposition so that records
+    // deleted by this transaction are still detected.
+    if (_cursor && !_eof && !_lastReturnedId.isNull() && !_rs._isCapped &&
+        _cursor->isPositionRetained(_opCtx)) {
+        return true;
+    }
+
     if (!_cursor)
         _cursor.emplace(_rs.getURI(), _rs.tableId(), true, _opCtx);
 
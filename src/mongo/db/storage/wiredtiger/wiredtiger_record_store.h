@@ -42,6 +42,7 @@
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_prefetcher.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/platform/atomic_word.h"
@@ -113,6 +114,10 @@ public:
         CappedCallback* cappedCallback;
         WiredTigerSizeStorer* sizeStorer;
         bool isReadOnly;
+        // Excess capped documents are removed by a background thread. See reclaimCapped().
+        bool cappedAsyncDeletes = false;
+        // Records are keyed by the RecordId derived from their _id. See clustered_id.h.
+        bool isClustered = false;
     };
 
     WiredTigerRecordStore(WiredTigerKVEngine* kvEngine, OperationContext* opCtx, Params params);
@@ -157,6 +162,13 @@ public:
                                               size_t nDocs,
                                               RecordId* idsOut);
 
+    /**
+     * Returns a builder which writes through a WiredTiger bulk cursor, or nullptr if this record
+     * store is capped or the table cannot be opened for bulk loading, for example because it is
+     * not empty.
+     */
+    virtual std::unique_ptr<RecordStoreBulkBuilder> makeBulkBuilder(OperationContext* opCtx);
+
     virtual Status updateRecord(OperationContext* opCtx,
                                 const RecordId& recordId,
                                 const char* data,
@@ -194,10 +206,16 @@ public:
                            const CompactOptions* options,
                            CompactStats* stats);
 
+    StatusWith<bool> compactStep(OperationContext* opCtx, Seconds timeout) override;
+
     virtual bool isInRecordIdOrder() const override {
         return true;
     }
 
+    bool isClustered() const override {
+        return _isClustered;
+    }
+
     virtual Status validate(OperationContext* opCtx,
                             ValidateCmdLevel level,
                             ValidateAdaptor* adaptor,
@@ -268,6 +286,13 @@ public:
     // Returns false if the oplog was dropped while waiting for a deletion request.
     bool yieldAndAwaitOplogDeletionRequest(OperationContext* opCtx);
 
+    /**
+     * Removes documents from a capped record store created with 'cappedAsyncDeletes' until it is
+     * back under its size limit. Called by the background capped deleter after an insert has
+     * requested deletion. Returns the number of documents removed.
+     */
+    int64_t reclaimCapped(OperationContext* opCtx);
+
     bool haveCappedWaiters();
 
     void notifyCappedWaitersIfNeeded();
@@ -285,6 +310,7 @@ protected:
     virtual void setKey(WT_CURSOR* cursor, RecordId id) const = 0;
 
 private:
+    class BulkBuilder;
     class RandomCursor;
 
     class NumRecordsChange;
@@ -328,6 +354,8 @@ private:
      *      of zero and will discard all cached size metadata. This assumption is incorrect if there
      *      are pending writes to this ident as part of the recovery process, and so we must
      *      always adjust size metadata for these idents.
+     *
+     * If 'opCtx' is null, the adjustment is not rolled back if the current unit of work aborts.
      */
     void _changeNumRecords(OperationContext* opCtx, int64_t diff);
     void _increaseDataSize(OperationContext* opCtx, int64_t amount);
@@ -341,6 +369,13 @@ private:
     int64_t _cappedDeleteAsNeeded(OperationContext* opCtx, const RecordId& justInserted);
     int64_t _cappedDeleteAsNeeded_inlock(OperationContext* opCtx, const RecordId& justInserted);
 
+    /**
+     * Hands the capped deletion off to the background deleter, blocking the inserter for a bounded
+     * time if the record store has fallen too far behind. Returns false if there is no background
+     * deleter and the deletion must be done inline.
+     */
+    bool _requestAsyncCappedDelete();
+
     const std::string _uri;
     const uint64_t _tableId;  // not persisted
 
@@ -352,6 +387,8 @@ private:
     const bool _isEphemeral;
     // True if the namespace of this record store starts with "local.oplog.", and false otherwise.
     const bool _isOplog;
+    // True if records are keyed by their _id rather than by a generated RecordId.
+    const bool _isClustered;
     int64_t _cappedMaxSize;
     const int64_t _cappedMaxSizeSlack;  // when to start applying backpressure
     const int64_t _cappedMaxDocs;
@@ -366,6 +403,14 @@ private:
     int _cappedDeleteCheckCount;
     mutable stdx::timed_mutex _cappedDeleterMutex;
 
+    // Set for capped collections whose excess documents are removed by a background thread.
+    const bool _cappedAsyncDeletes;
+    // True while a background deletion request is outstanding.
+    AtomicWord<bool> _cappedDeleteRequested{false};
+    // Signalled by reclaimCapped() after each batch so throttled inserters can proceed.
+    stdx::mutex _cappedReclaimMutex;
+    stdx::condition_variable _cappedReclaimCV;
+
     AtomicInt64 _nextIdNum;
 
     WiredTigerSizeStorer* _sizeStorer;  // not owned, can be NULL
@@ -412,6 +457,13 @@ public:
         return _prefix;
     }
 
+    /**
+     * The table backing a prefixed record store is shared, so it can never be bulk loaded.
+     */
+    std::unique_ptr<RecordStoreBulkBuilder> makeBulkBuilder(OperationContext* opCtx) override {
+        return nullptr;
+    }
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const;
 
@@ -441,6 +493,12 @@ public:
 
     void reattachToOperationContext(OperationContext* opCtx);
 
+    bool enableReadAhead(long long numRecords) override;
+
+    ReadAheadStats getReadAheadStats() const override {
+        return _readAheadStats;
+    }
+
 protected:
     virtual RecordId getKey(WT_CURSOR* cursor) const = 0;
 
@@ -468,6 +526,10 @@ protected:
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
 
+    // Set if this cursor is being read ahead of by the engine's WiredTigerPrefetcher.
+    std::shared_ptr<WiredTigerPrefetcher::ReadAhead> _readAhead;
+    ReadAheadStats _readAheadStats;
+
 private:
     bool isVisible(const RecordId& id);
 };
@@ -518,6 +580,11 @@ protected:
 
     virtual void initCursorToBeginning() override;
 
+    bool enableReadAhead(long long numRecords) override {
+        // The prefetcher only understands tables keyed by plain record ids.
+        return false;
+    }
+
 private:
     KVPrefix _prefix;
 };
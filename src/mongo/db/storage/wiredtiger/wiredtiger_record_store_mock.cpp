@@ -45,8 +45,14 @@ bool initRsOplogBackgroundThread(StringData ns) {
     return NamespaceString::oplog(ns);
 }
 
+// Tests drive the deletions themselves by calling WiredTigerRecordStore::reclaimCapped().
+bool requestCappedDeletion(StringData ns) {
+    return true;
+}
+
 MONGO_INITIALIZER(SetInitRsOplogBackgroundThreadCallback)(InitializerContext* context) {
     WiredTigerKVEngine::setInitRsOplogBackgroundThreadCallback(initRsOplogBackgroundThread);
+    WiredTigerKVEngine::setRequestCappedDeletionCallback(requestCappedDeletion);
     return Status::OK();
 }
 
@@ -46,6 +46,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
@@ -166,8 +167,104 @@ bool initRsOplogBackgroundThread(StringData ns) {
     return true;
 }
 
+/**
+ * Removes excess documents from capped collections created with 'cappedAsyncDeletes'. A single
+ * thread serves every such collection; inserts that push a collection over its size limit queue
+ * its namespace and carry on without deleting anything themselves.
+ */
+class CappedDeleterThread : public BackgroundJob {
+public:
+    CappedDeleterThread() : BackgroundJob(true /* deleteSelf */) {}
+
+    virtual std::string name() const {
+        return "WT CappedDeleterThread";
+    }
+
+    void request(const NamespaceString& nss) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_pending.insert(nss).second)
+            _cv.notify_one();
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+        ON_BLOCK_EXIT([] { Client::destroy(); });
+
+        while (!globalInShutdownDeprecated()) {
+            NamespaceString nss;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                if (_pending.empty()) {
+                    // Wake up periodically to notice shutdown.
+                    _cv.wait_for(lk, stdx::chrono::seconds(1));
+                    continue;
+                }
+                nss = *_pending.begin();
+                _pending.erase(_pending.begin());
+            }
+
+            if (!_deleteExcessDocuments(nss)) {
+                sleepmillis(10);  // Back off in case there were problems deleting.
+            }
+        }
+    }
+
+private:
+    /**
+     * Returns true iff any documents were deleted.
+     */
+    bool _deleteExcessDocuments(const NamespaceString& nss) {
+        const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+
+        try {
+            ShouldNotConflictWithSecondaryBatchApplicationBlock shouldNotConflictBlock(
+                opCtx->lockState());
+            AutoGetCollection autoColl(opCtx.get(), nss, MODE_IX);
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                LOG(2) << "no collection " << nss;
+                return false;
+            }
+
+            auto rs = checked_cast<WiredTigerRecordStore*>(collection->getRecordStore());
+            return rs->reclaimCapped(opCtx.get()) > 0;
+        } catch (const ExceptionForCat<ErrorCategory::Interruption>&) {
+            return false;
+        } catch (const DBException& e) {
+            warning() << "error in CappedDeleterThread for " << nss << ": " << redact(e);
+            return false;
+        }
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    std::set<NamespaceString> _pending;
+};
+
+CappedDeleterThread* _cappedDeleterThread = nullptr;
+
+bool requestCappedDeletion(StringData ns) {
+    if (storageGlobalParams.repair || storageGlobalParams.readOnly) {
+        return false;
+    }
+
+    CappedDeleterThread* thread;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_backgroundThreadMutex);
+        if (!_cappedDeleterThread) {
+            log() << "Starting CappedDeleterThread";
+            _cappedDeleterThread = new CappedDeleterThread();
+            _cappedDeleterThread->go();
+        }
+        thread = _cappedDeleterThread;
+    }
+    thread->request(NamespaceString(ns));
+    return true;
+}
+
 MONGO_INITIALIZER(SetInitRsOplogBackgroundThreadCallback)(InitializerContext* context) {
     WiredTigerKVEngine::setInitRsOplogBackgroundThreadCallback(initRsOplogBackgroundThread);
+    WiredTigerKVEngine::setRequestCappedDeletionCallback(requestCappedDeletion);
     return Status::OK();
 }
 
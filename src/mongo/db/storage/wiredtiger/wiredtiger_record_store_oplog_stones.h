@@ -35,6 +35,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -42,7 +43,9 @@ class OperationContext;
 class RecordId;
 
 // Keep "milestones" against the oplog to efficiently remove the old records when the collection
-// grows beyond its desired maximum size.
+// grows beyond its desired maximum size. When a minimum retention window is configured, stones are
+// also closed once they span a fraction of that window, so that a slowly written oplog is still
+// truncated at a fine granularity, and no stone is truncated before it falls out of the window.
 class WiredTigerRecordStore::OplogStones {
 public:
     struct Stone {
@@ -64,7 +67,10 @@ public:
              ++it) {
             total_bytes += it->bytes;
         }
-        return total_bytes > _rs->cappedMaxSize();
+        if (total_bytes <= _rs->cappedMaxSize()) {
+            return false;
+        }
+        return !_isWithinRetentionWindow(_stones.front());
     }
 
     void awaitHasExcessStonesOrDead();
@@ -75,6 +81,18 @@ public:
 
     void createNewStoneIfNeeded(RecordId lastRecord);
 
+    /**
+     * Records that a stone of 'bytes' bytes was truncated, delaying the next truncation as needed
+     * to stay under the configured truncation rate.
+     */
+    void recordTruncation(int64_t bytes);
+
+    /**
+     * Returns false if the configured truncation rate has been used up, in which case the reclaim
+     * thread should wait in awaitHasExcessStonesOrDead() before truncating more stones.
+     */
+    bool isTruncationAllowed();
+
     void updateCurrentStoneAfterInsertOnCommit(OperationContext* opCtx,
                                                int64_t bytesInserted,
                                                RecordId highestInserted,
@@ -125,6 +143,13 @@ private:
 
     void _pokeReclaimThreadIfNeeded();
 
+    // Returns true if the stone being filled should be added to the deque of oplog stones after
+    // inserting 'highestInserted'.
+    bool _isCurrentStoneFull(RecordId highestInserted) const;
+
+    // Returns true if the newest record of 'stone' is within the minimum retention window.
+    bool _isWithinRetentionWindow(const Stone& stone) const;
+
     static const uint64_t kRandomSamplesPerStone = 10;
 
     WiredTigerRecordStore* _rs;
@@ -136,6 +161,9 @@ private:
     // database, and false otherwise.
     bool _isDead = false;
 
+    // The earliest time at which the next stone may be truncated, given the truncation rate limit.
+    Date_t _nextTruncationAllowed;
+
     // Minimum number of bytes the stone being filled should contain before it gets added to the
     // deque of oplog stones.
     int64_t _minBytesPerStone;
@@ -143,6 +171,9 @@ private:
     AtomicInt64 _currentRecords;  // Number of records in the stone being filled.
     AtomicInt64 _currentBytes;    // Number of bytes in the stone being filled.
 
+    // Seconds component of the timestamp where the stone being filled starts, or 0 if unknown.
+    AtomicWord<unsigned> _currentStartSecs;
+
     mutable stdx::mutex _mutex;  // Protects against concurrent access to the deque of oplog stones.
     std::deque<OplogStones::Stone> _stones;  // front = oldest, back = newest.
 };
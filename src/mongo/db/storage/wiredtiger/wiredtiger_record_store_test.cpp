@@ -40,8 +40,10 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -152,6 +154,134 @@ TEST(WiredTigerRecordStoreTest, Isolation1) {
     }
 }
 
+TEST(WiredTigerRecordStoreTest, UpdateRecordOfLargeDocumentAppliesPartialChanges) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    const std::string padding(4096, 'x');
+    const BSONObj original = BSON("a" << padding << "b" << 1 << "c" << padding);
+
+    RecordId id;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), original.objdata(), original.objsize(), Timestamp());
+        ASSERT_OK(res.getStatus());
+        id = res.getValue();
+        uow.commit();
+    }
+
+    // Growing, shrinking and retyping a field in the middle of the document, as well as changing
+    // the very last byte and rewriting the whole document, must all read back exactly.
+    std::vector<BSONObj> updates{BSON("a" << padding << "b" << 1.5 << "c" << padding),
+                                 BSON("a" << padding << "b"
+                                          << "longer string value"
+                                          << "c"
+                                          << padding),
+                                 BSON("a" << padding << "c" << padding),
+                                 BSON("a" << padding << "c" << padding + 'y'),
+                                 BSON("a" << padding << "c" << padding + 'z'),
+                                 BSON("z" << std::string(2048, 'q'))};
+    for (const auto& update : updates) {
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(rs->updateRecord(opCtx.get(), id, update.objdata(), update.objsize()));
+            uow.commit();
+        }
+        ASSERT_BSONOBJ_EQ(update, rs->dataFor(opCtx.get(), id).toBson());
+        ASSERT_EQUALS(update.objsize(), rs->dataSize(opCtx.get()));
+    }
+}
+
+TEST(WiredTigerRecordStoreTest, BulkBuilderAppendsToEmptyRecordStore) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+    auto builder = rs->makeBulkBuilder(opCtx.get());
+    if (dynamic_cast<PrefixedWiredTigerRecordStore*>(rs.get())) {
+        // Prefixed record stores share their table, which cannot be bulk loaded.
+        ASSERT_FALSE(builder);
+        return;
+    }
+    ASSERT(builder);
+
+    std::vector<RecordId> ids;
+    for (auto data : {"a", "b", "c"}) {
+        auto res = builder->addRecord(data, 2);
+        ASSERT_OK(res.getStatus());
+        ids.push_back(res.getValue());
+    }
+    ASSERT_LT(ids[0], ids[1]);
+    ASSERT_LT(ids[1], ids[2]);
+
+    builder->commit(opCtx.get());
+    builder.reset();
+    ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+    ASSERT_EQ(6, rs->dataSize(opCtx.get()));
+    ASSERT_EQ(std::string("b"), rs->dataFor(opCtx.get(), ids[1]).data());
+
+    // Inserts after the bulk load continue from the last RecordId it assigned.
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res = rs->insertRecord(opCtx.get(), "d", 2, Timestamp());
+        ASSERT_OK(res.getStatus());
+        ASSERT_LT(ids[2], res.getValue());
+        uow.commit();
+    }
+
+    // The record store is no longer empty, so it cannot be bulk loaded again.
+    ASSERT_FALSE(rs->makeBulkBuilder(opCtx.get()));
+}
+
+TEST(WiredTigerRecordStoreTest, RestoreInSameSnapshotKeepsCursorPosition) {
+    const auto harnessHelper(newRecordStoreHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    std::vector<RecordId> ids;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (auto data : {"a", "b", "c"}) {
+            auto res = rs->insertRecord(opCtx.get(), data, 2, Timestamp());
+            ASSERT_OK(res.getStatus());
+            ids.push_back(res.getValue());
+        }
+        uow.commit();
+    }
+
+    auto restoreStats = [] {
+        BSONObjBuilder builder;
+        WiredTigerCursor::appendRestoreStats(&builder);
+        return builder.obj();
+    };
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    auto cursor = rs->getCursor(opCtx.get());
+    ASSERT_EQ(ids[0], cursor->next()->id);
+
+    // The snapshot is still open, so the cursor need not be repositioned.
+    auto before = restoreStats();
+    cursor->save();
+    ASSERT(cursor->restore());
+    auto after = restoreStats();
+    ASSERT_EQ(before["fast"].numberLong() + 1, after["fast"].numberLong());
+    ASSERT_EQ(before["slow"].numberLong(), after["slow"].numberLong());
+    ASSERT_EQ(ids[1], cursor->next()->id);
+
+    // Abandoning the snapshot forces the cursor to seek back to where it was.
+    before = after;
+    cursor->save();
+    opCtx->recoveryUnit()->abandonSnapshot();
+    ASSERT(cursor->restore());
+    after = restoreStats();
+    ASSERT_EQ(before["fast"].numberLong(), after["fast"].numberLong());
+    ASSERT_EQ(before["slow"].numberLong() + 1, after["slow"].numberLong());
+    ASSERT_EQ(ids[2], cursor->next()->id);
+    ASSERT_FALSE(cursor->next());
+}
+
 TEST(WiredTigerRecordStoreTest, Isolation2) {
     const auto harnessHelper(newRecordStoreHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -866,5 +996,79 @@ TEST(WiredTigerRecordStoreTest, OplogStones_AscendingOrder) {
     }
 }
 
+// Verify that stones within the minimum retention window are kept even when the oplog is over its
+// maximum size, and that stones are closed by age when a retention window is configured.
+TEST(WiredTigerRecordStoreTest, OplogStones_MinRetentionWindow) {
+    std::unique_ptr<RecordStoreHarnessHelper> harnessHelper = newRecordStoreHarnessHelper();
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_OK(wtrs->updateCappedSize(opCtx.get(), 230U));
+    }
+
+    oplogStones->setMinBytesPerStone(100);
+
+    auto retention = ServerParameterSet::getGlobal()->getMap().find(
+        "wiredTigerOplogMinRetentionSeconds");
+    ASSERT(retention != ServerParameterSet::getGlobal()->getMap().end());
+    ASSERT_OK(retention->second->setFromString("3600"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(retention->second->setFromString("0")); });
+
+    const unsigned now = durationCount<Seconds>(Date_t::now().toDurationSinceEpoch());
+    const unsigned twoHoursAgo = now - 2 * 3600;
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(twoHoursAgo, 1), 100),
+                  RecordId(twoHoursAgo, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(twoHoursAgo, 2), 110),
+                  RecordId(twoHoursAgo, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, 1), 120),
+                  RecordId(now, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, 2), 130),
+                  RecordId(now, 2));
+
+        ASSERT_EQ(4, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(460, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(4U, oplogStones->numStones());
+    }
+
+    // Only the stones older than the retention window are truncated, even though the remaining
+    // stones still exceed cappedMaxSize.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        wtrs->reclaimOplog(opCtx.get(), Timestamp(now, 3));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(250, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+
+    // A stone spanning a tenth of the retention window is closed before reaching its minimum size.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now, 3), 30),
+                  RecordId(now, 3));
+        ASSERT_EQ(2U, oplogStones->numStones());
+        ASSERT_EQ(1, oplogStones->currentRecords());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(now + 360, 1), 30),
+                  RecordId(now + 360, 1));
+        ASSERT_EQ(3U, oplogStones->numStones());
+        ASSERT_EQ(0, oplogStones->currentRecords());
+        ASSERT_EQ(0, oplogStones->currentBytes());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
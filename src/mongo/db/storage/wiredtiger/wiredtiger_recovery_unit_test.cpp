@@ -31,15 +31,18 @@
 #include "mongo/base/checked_cast.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/recovery_unit_test_harness.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/clock_source_mock.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace {
@@ -578,5 +581,94 @@ TEST_F(WiredTigerRecoveryUnitTestFixture, ReadOnceCursorsAreNotCached) {
 
     ASSERT(ru->getReadOnce());
 }
+
+TEST_F(WiredTigerRecoveryUnitTestFixture, SessionReleasedOnAnotherThreadIsReused) {
+    auto sessionCache = ru1->getSessionCache();
+    ASSERT_GTE(sessionCache->getNumPartitions_forTest(), 1U);
+    sessionCache->closeAll();
+
+    // Release a session on another thread, which caches it in that thread's home partition.
+    auto session = sessionCache->getSession();
+    WiredTigerSession* released = session.get();
+    stdx::thread([&] { session.reset(); }).join();
+
+    // This thread finds it whichever partition it was cached in, rather than opening a new one.
+    auto reused = sessionCache->getSession();
+    ASSERT_EQ(released, reused.get());
+
+    BSONObjBuilder builder;
+    sessionCache->appendStats(&builder);
+    auto stats = builder.obj();
+    ASSERT_EQ(0, stats["cached sessions"].numberLong());
+    ASSERT_EQ(sessionCache->getNumPartitions_forTest(),
+              static_cast<size_t>(stats["partitions"].Obj().nFields()));
+}
+
+TEST_F(WiredTigerRecoveryUnitTestFixture, CloseAllFreesSessionsCachedInEveryPartition) {
+    auto sessionCache = ru1->getSessionCache();
+    sessionCache->closeAll();
+
+    // Cache sessions released on several threads, then one which was taken before closeAll().
+    auto outstanding = sessionCache->getSession();
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&] { sessionCache->getSession(); });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    sessionCache->closeAll();
+    outstanding.reset();
+
+    BSONObjBuilder builder;
+    sessionCache->appendStats(&builder);
+    ASSERT_EQ(0, builder.obj()["cached sessions"].numberLong());
+}
+
+TEST_F(WiredTigerRecoveryUnitTestFixture, GroupCommitStatsAccountForEveryFlush) {
+    auto sessionCache = ru1->getSessionCache();
+    auto setParameter = [](StringData name, StringData value) {
+        auto parameter = ServerParameterSet::getGlobal()->getMap().find(name.toString())->second;
+        ASSERT_OK(parameter->setFromString(value.toString()));
+    };
+    setParameter("wiredTigerGroupCommitMaxDelayMicros", "10000");
+    setParameter("wiredTigerGroupCommitMaxBatchSize", "4");
+    ON_BLOCK_EXIT([&] {
+        setParameter("wiredTigerGroupCommitMaxDelayMicros", "0");
+        setParameter("wiredTigerGroupCommitMaxBatchSize", "64");
+    });
+
+    auto flushesSoFar = [&] {
+        BSONObjBuilder builder;
+        sessionCache->appendStats(&builder);
+        return builder.obj()["group commit"]["flushes"].numberLong();
+    };
+    const auto flushesBefore = flushesSoFar();
+
+    // Concurrent callers share flushes, so there is at most one per caller.
+    const int numCallers = 4;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < numCallers; ++i) {
+        threads.emplace_back([&] { sessionCache->waitUntilDurable(false, false); });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    BSONObjBuilder builder;
+    sessionCache->appendStats(&builder);
+    auto groupCommit = builder.obj()["group commit"].Obj().getOwned();
+    const auto flushes = groupCommit["flushes"].numberLong() - flushesBefore;
+    ASSERT_GTE(flushes, 1);
+    ASSERT_LTE(flushes, numCallers);
+
+    // Every flush is counted in exactly one bucket of the histogram.
+    long long grouped = 0;
+    for (auto&& bucket : groupCommit["group sizes"].Obj()) {
+        grouped += bucket.numberLong();
+    }
+    ASSERT_EQ(groupCommit["flushes"].numberLong(), grouped);
+}
 }  // namespace
 }  // namespace mongo
@@ -37,6 +37,8 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_checkpoint_pacer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_cursor.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
@@ -78,6 +80,26 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* opCtx,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    {
+        BSONObjBuilder sessionCacheBuilder(bob.subobjStart("session cache"));
+        WiredTigerRecoveryUnit::get(opCtx)->getSessionCache()->appendStats(&sessionCacheBuilder);
+    }
+
+    {
+        BSONObjBuilder restoresBuilder(bob.subobjStart("cursor restores"));
+        WiredTigerCursor::appendRestoreStats(&restoresBuilder);
+    }
+
+    {
+        BSONObjBuilder visibilityBuilder(bob.subobjStart("oplog visibility"));
+        _engine->getOplogManager()->appendVisibilityStats(&visibilityBuilder);
+    }
+
+    if (auto pacer = _engine->getCheckpointPacer()) {
+        BSONObjBuilder pacingBuilder(bob.subobjStart("checkpoint pacing"));
+        pacer->appendStats(&pacingBuilder);
+    }
+
     WiredTigerUtil::appendSnapshotWindowSettings(_engine, session, &bob);
 
     return bob.obj();
@@ -35,7 +35,10 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/global_settings.h"
 #include "mongo/db/repl/repl_settings.h"
@@ -46,6 +49,8 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -86,6 +91,30 @@ ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
                                      "wiredTigerCursorCacheSize",
                                      &kWiredTigerCursorCacheSize);
 
+// The number of partitions the session cache is split into. Zero or less uses one partition per
+// available core, up to kMaxSessionCachePartitions.
+std::int32_t kWiredTigerSessionCachePartitions = 0;
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupOnly>
+    WiredTigerSessionCachePartitionsSetting(ServerParameterSet::getGlobal(),
+                                            "wiredTigerSessionCachePartitions",
+                                            &kWiredTigerSessionCachePartitions);
+
+// How long the first of a group of concurrent waitUntilDurable() callers waits for others to join
+// before flushing the journal for all of them, and how many may join before it flushes early.
+AtomicInt32 kWiredTigerGroupCommitMaxDelayMicros(0);
+AtomicInt32 kWiredTigerGroupCommitMaxBatchSize(64);
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerGroupCommitMaxDelayMicrosSetting(ServerParameterSet::getGlobal(),
+                                               "wiredTigerGroupCommitMaxDelayMicros",
+                                               &kWiredTigerGroupCommitMaxDelayMicros);
+
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerGroupCommitMaxBatchSizeSetting(ServerParameterSet::getGlobal(),
+                                             "wiredTigerGroupCommitMaxBatchSize",
+                                             &kWiredTigerGroupCommitMaxBatchSize);
+
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, uint64_t epoch, uint64_t cursorEpoch)
     : _epoch(epoch), _cursorEpoch(cursorEpoch), _session(NULL), _cursorGen(0), _cursorsOut(0) {
     invariantWTOK(conn->open_session(conn, NULL, "isolation=snapshot", &_session));
@@ -216,7 +245,22 @@ void WiredTigerSession::closeCursorsForQueuedDrops(WiredTigerKVEngine* engine) {
 
 namespace {
 AtomicUInt64 nextTableId(1);
+
+const int kMaxSessionCachePartitions = 64;
+
+// Threads are given home partitions in the order in which they first use a session cache.
+AtomicUInt32 nextThreadSlot(0);
+thread_local uint32_t threadSlot = 0;
+thread_local bool threadSlotAssigned = false;
+
+size_t numSessionCachePartitions() {
+    int numPartitions = kWiredTigerSessionCachePartitions;
+    if (numPartitions <= 0) {
+        numPartitions = static_cast<int>(ProcessInfo::getNumAvailableCores());
+    }
+    return std::max(1, std::min(numPartitions, kMaxSessionCachePartitions));
 }
+}  // namespace
 // static
 uint64_t WiredTigerSession::genTableId() {
     return nextTableId.fetchAndAdd(1);
@@ -225,10 +269,17 @@ uint64_t WiredTigerSession::genTableId() {
 // -----------------------
 
 WiredTigerSessionCache::WiredTigerSessionCache(WiredTigerKVEngine* engine)
-    : _engine(engine), _conn(engine->getConnection()), _shuttingDown(0) {}
+    : WiredTigerSessionCache(engine->getConnection()) {
+    _engine = engine;
+}
 
 WiredTigerSessionCache::WiredTigerSessionCache(WT_CONNECTION* conn)
-    : _engine(NULL), _conn(conn), _shuttingDown(0) {}
+    : _engine(NULL), _conn(conn), _shuttingDown(0) {
+    const auto numPartitions = numSessionCachePartitions();
+    for (size_t i = 0; i < numPartitions; ++i) {
+        _partitions.push_back(stdx::make_unique<Partition>());
+    }
+}
 
 WiredTigerSessionCache::~WiredTigerSessionCache() {
     shuttingDown();
@@ -293,18 +344,55 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint, bool stableC
         return;
     }
 
-    uint32_t start = _lastSyncTime.load();
-    // Do the remainder in a critical section that ensures only a single thread at a time
-    // will attempt to synchronize.
-    stdx::unique_lock<stdx::mutex> lk(_lastSyncMutex);
-    uint32_t current = _lastSyncTime.loadRelaxed();  // synchronized with writes through mutex
-    if (current != start) {
-        // Someone else synced already since we read lastSyncTime, so we're done!
+    // Join the group of callers to be made durable by the next flush to start. A flush which is
+    // already in progress may have started before our commit, so it cannot be relied upon.
+    stdx::unique_lock<stdx::mutex> lk(_groupCommitMutex);
+    const uint64_t flushNeeded = _flushesStarted + 1;
+    ++_groupCommitWaiters;
+
+    if (_groupCommitLeaderWaiting) {
+        // Another caller will flush on behalf of the group.
+        const auto maxBatchSize = kWiredTigerGroupCommitMaxBatchSize.load();
+        if (maxBatchSize > 0 && _groupCommitWaiters >= static_cast<size_t>(maxBatchSize)) {
+            _groupCommitCond.notify_all();
+        }
+        _groupCommitCond.wait(lk, [&] { return _flushesCompleted >= flushNeeded; });
         return;
     }
-    _lastSyncTime.store(current + 1);
 
-    // Nobody has synched yet, so we have to sync ourselves.
+    // We lead this group. Give other committers a chance to join, then wait for any earlier flush,
+    // since only one may run at a time.
+    _groupCommitLeaderWaiting = true;
+    const auto maxDelay = Microseconds(kWiredTigerGroupCommitMaxDelayMicros.load());
+    if (maxDelay > Microseconds(0)) {
+        const auto maxBatchSize = kWiredTigerGroupCommitMaxBatchSize.load();
+        const auto deadline = Date_t::now() + maxDelay;
+        _groupCommitCond.wait_until(lk, deadline.toSystemTimePoint(), [&] {
+            return maxBatchSize > 0 && _groupCommitWaiters >= static_cast<size_t>(maxBatchSize);
+        });
+    }
+    _groupCommitCond.wait(lk, [&] { return !_flushInProgress; });
+
+    const size_t groupSize = _groupCommitWaiters;
+    _groupCommitWaiters = 0;
+    _groupCommitLeaderWaiting = false;
+    _flushInProgress = true;
+    _flushesStarted = flushNeeded;
+    lk.unlock();
+
+    ON_BLOCK_EXIT([&] {
+        size_t bucket = 0;
+        while (bucket + 1 < kNumGroupCommitBuckets && (groupSize >> (bucket + 1)) != 0) {
+            ++bucket;
+        }
+        {
+            stdx::lock_guard<stdx::mutex> lock(_groupCommitMutex);
+            _flushInProgress = false;
+            _flushesCompleted = flushNeeded;
+            ++_groupCommitSizes[bucket];
+        }
+        _groupCommitCond.notify_all();
+    });
 
     // This gets the token (OpTime) from the last write, before flushing (either the journal, or a
     // checkpoint), and then reports that token (OpTime) as a durable write.
@@ -348,9 +436,13 @@ void WiredTigerSessionCache::notifyPreparedUnitOfWorkHasCommittedOrAborted() {
 
 
 void WiredTigerSessionCache::closeAllCursors(const std::string& uri) {
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeAllCursors(uri);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+        for (SessionCache::iterator i = partition->sessions.begin();
+             i != partition->sessions.end();
+             i++) {
+            (*i)->closeAllCursors(uri);
+        }
     }
 }
 
@@ -358,24 +450,32 @@ void WiredTigerSessionCache::closeCursorsForQueuedDrops() {
     // Increment the cursor epoch so that all cursors from this epoch are closed.
     _cursorEpoch.fetchAndAdd(1);
 
-    stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-    for (SessionCache::iterator i = _sessions.begin(); i != _sessions.end(); i++) {
-        (*i)->closeCursorsForQueuedDrops(_engine);
+    for (auto&& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+        for (SessionCache::iterator i = partition->sessions.begin();
+             i != partition->sessions.end();
+             i++) {
+            (*i)->closeCursorsForQueuedDrops(_engine);
+        }
     }
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch.
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. This happens before
+    // any partition is emptied, so a session released concurrently either sees the new epoch under
+    // its partition lock and is freed, or is cached before that partition is emptied below.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
-    }
+    for (auto&& partition : _partitions) {
+        SessionCache swap;
+        {
+            stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+            partition->sessions.swap(swap);
+        }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+        for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
+            delete (*i);
+        }
     }
 }
 
@@ -388,22 +488,49 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
-            // Get the most recently used session so that if we discard sessions, we're
-            // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+    const size_t home = _homePartition();
+    Partition* homePartition = _partitions[home].get();
+    if (WiredTigerSession* cachedSession = _popSession(homePartition)) {
+        homePartition->hits.fetchAndAdd(1);
+        return UniqueWiredTigerSession(cachedSession);
+    }
+
+    // Take a session from the other partitions before resorting to opening a new one.
+    for (size_t i = 1; i < _partitions.size(); ++i) {
+        auto partition = _partitions[(home + i) % _partitions.size()].get();
+        if (WiredTigerSession* cachedSession = _popSession(partition)) {
+            homePartition->steals.fetchAndAdd(1);
             return UniqueWiredTigerSession(cachedSession);
         }
     }
 
     // Outside of the cache partition lock, but on release will be put back on the cache
+    homePartition->misses.fetchAndAdd(1);
     return UniqueWiredTigerSession(
         new WiredTigerSession(_conn, this, _epoch.load(), _cursorEpoch.load()));
 }
 
+size_t WiredTigerSessionCache::_homePartition() const {
+    if (!threadSlotAssigned) {
+        threadSlot = nextThreadSlot.fetchAndAdd(1);
+        threadSlotAssigned = true;
+    }
+    return threadSlot % _partitions.size();
+}
+
+WiredTigerSession* WiredTigerSessionCache::_popSession(Partition* partition) {
+    stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+    if (partition->sessions.empty()) {
+        return nullptr;
+    }
+
+    // Get the most recently used session so that if we discard sessions, we're discarding older
+    // ones
+    WiredTigerSession* cachedSession = partition->sessions.back();
+    partition->sessions.pop_back();
+    return cachedSession;
+}
+
 void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     invariant(session);
     invariant(session->cursorsOut() == 0);
@@ -453,10 +580,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     session->dropQueuedIdentsAtSessionEndAllowed(true);
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        auto partition = _partitions[_homePartition()].get();
+        stdx::lock_guard<stdx::mutex> lock(partition->mutex);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition->sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -469,6 +597,52 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
 }
 
 
+void WiredTigerSessionCache::appendStats(BSONObjBuilder* builder) const {
+    long long totalCached = 0;
+    BSONArrayBuilder partitionsBuilder(builder->subarrayStart("partitions"));
+    for (auto&& partition : _partitions) {
+        long long cached;
+        {
+            stdx::lock_guard<stdx::mutex> lock(partition->mutex);
+            cached = partition->sessions.size();
+        }
+        totalCached += cached;
+
+        const auto hits = partition->hits.load();
+        const auto steals = partition->steals.load();
+        const auto misses = partition->misses.load();
+        const auto total = hits + steals + misses;
+
+        BSONObjBuilder partitionBuilder(partitionsBuilder.subobjStart());
+        partitionBuilder.append("cached sessions", cached);
+        partitionBuilder.append("hits", static_cast<long long>(hits));
+        partitionBuilder.append("steals", static_cast<long long>(steals));
+        partitionBuilder.append("misses", static_cast<long long>(misses));
+        partitionBuilder.append("hit rate", total ? static_cast<double>(hits) / total : 0.0);
+    }
+    partitionsBuilder.doneFast();
+    builder->append("cached sessions", totalCached);
+
+    long long flushes;
+    std::array<uint64_t, kNumGroupCommitBuckets> groupCommitSizes;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_groupCommitMutex);
+        flushes = _flushesCompleted;
+        groupCommitSizes = _groupCommitSizes;
+    }
+
+    BSONObjBuilder groupCommitBuilder(builder->subobjStart("group commit"));
+    groupCommitBuilder.append("flushes", flushes);
+    BSONObjBuilder sizesBuilder(groupCommitBuilder.subobjStart("group sizes"));
+    for (size_t i = 0; i < kNumGroupCommitBuckets; ++i) {
+        const size_t low = size_t(1) << i;
+        const std::string bucketName = i + 1 < kNumGroupCommitBuckets
+            ? str::stream() << low << "-" << ((low << 1) - 1)
+            : str::stream() << low << "+";
+        sizesBuilder.append(bucketName, static_cast<long long>(groupCommitSizes[i]));
+    }
+}
+
 void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     stdx::unique_lock<stdx::mutex> lk(_journalListenerMutex);
     _journalListener = jl;
@@ -31,19 +31,24 @@
 
 #pragma once
 
+#include <array>
 #include <list>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <wiredtiger.h>
 
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/spin_lock.h"
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -184,6 +189,10 @@ private:
 /**
  *  This cache implements a shared pool of WiredTiger sessions with the goal to amortize the
  *  cost of session creation and destruction over multiple uses.
+ *
+ *  The pool is split into partitions, each with its own lock, so that threads getting and
+ *  releasing sessions concurrently rarely contend with each other. Each thread uses one home
+ *  partition, and takes a session from another partition when its own is empty.
  */
 class WiredTigerSessionCache {
 public:
@@ -240,6 +249,10 @@ public:
      * Waits until all commits that happened before this call are durable, either by flushing
      * the log or forcing a checkpoint if forceCheckpoint is true or the journal is disabled.
      * Uses a temporary session. Safe to call without any locks, even during shutdown.
+     *
+     * Concurrent callers not forcing a checkpoint are grouped behind a single flush. The first
+     * caller of a group waits up to wiredTigerGroupCommitMaxDelayMicros, or until
+     * wiredTigerGroupCommitMaxBatchSize callers have joined, before flushing on behalf of all.
      */
     void waitUntilDurable(bool forceCheckpoint, bool stableCheckpoint);
 
@@ -284,7 +297,45 @@ public:
         return _engine;
     }
 
+    /**
+     * Appends the number of cached sessions and the hit rate of each partition, and the number
+     * and sizes of the groups of waitUntilDurable() callers sharing a flush, to 'builder'.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+    size_t getNumPartitions_forTest() const {
+        return _partitions.size();
+    }
+
 private:
+    typedef std::vector<WiredTigerSession*> SessionCache;
+
+    /**
+     * A share of the cached sessions. A session released by a thread goes to that thread's home
+     * partition.
+     */
+    struct Partition {
+        stdx::mutex mutex;
+        SessionCache sessions;
+
+        // Sessions got by threads at home in this partition: from this partition, from another
+        // partition, or newly opened because every partition was empty.
+        AtomicUInt64 hits;
+        AtomicUInt64 steals;
+        AtomicUInt64 misses;
+    };
+
+    /**
+     * Returns the index of the home partition of the calling thread.
+     */
+    size_t _homePartition() const;
+
+    /**
+     * Removes and returns the most recently released session of 'partition', or nullptr if it is
+     * empty.
+     */
+    static WiredTigerSession* _popSession(Partition* partition);
+
     WiredTigerKVEngine* _engine;  // not owned, might be NULL
     WT_CONNECTION* _conn;         // not owned
     WiredTigerSnapshotManager _snapshotManager;
@@ -295,9 +346,8 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
-    typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+    // Never resized after construction.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
     // Bumped when all open sessions need to be closed
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
@@ -305,9 +355,21 @@ private:
     // Bumped when all open cursors need to be closed
     AtomicUInt64 _cursorEpoch;  // atomic so we can check it outside of the lock
 
-    // Counter and critical section mutex for waitUntilDurable
-    AtomicUInt32 _lastSyncTime;
-    stdx::mutex _lastSyncMutex;
+    // The number of buckets in the histogram of group commit sizes. Bucket i counts groups of
+    // [2^i, 2^(i + 1)) callers, and the last bucket counts all larger groups.
+    static const size_t kNumGroupCommitBuckets = 11;
+
+    // Group commit state for waitUntilDurable, protected by '_groupCommitMutex'. Flushes are
+    // numbered, and a caller waits for the first flush to start after it joined.
+    mutable stdx::mutex _groupCommitMutex;
+    stdx::condition_variable _groupCommitCond;
+    uint64_t _flushesStarted = 0;
+    uint64_t _flushesCompleted = 0;
+    bool _flushInProgress = false;
+    bool _groupCommitLeaderWaiting = false;
+    size_t _groupCommitWaiters = 0;
+
+    std::array<uint64_t, kNumGroupCommitBuckets> _groupCommitSizes{};
 
     // Mutex and cond var for waiting on prepare commit or abort.
     stdx::mutex _prepareCommittedOrAbortedMutex;
@@ -48,11 +48,12 @@ namespace mongo {
  * MongoDB collections. The size storer uses a separate WiredTiger table as key-value store, where
  * the URI serves as key and the value is a BSON document with `numRecords` and `dataSize` fields.
  * This buffering is neccessary to allow concurrent updates of size information without causing
- * write conflicts. The dirty size information is periodically stored written back to the table,
- * including on clean shutdown and/or catalog reload. Crashes or replica-set fail-overs may result
- * in size updates to be lost, so size information is only approximate. Reads use the buffer for
- * pending stores, or otherwise read directly from the WiredTiger table using a dedicated session
- * and cursor.
+ * write conflicts. The dirty size information is periodically written back to the table by a
+ * background thread of the storage engine, as well as on clean shutdown and/or catalog reload, so
+ * threads updating sizes only ever touch the shared SizeInfo counters. Crashes or replica-set
+ * fail-overs may result in size updates to be lost, so size information is only approximate.
+ * Reads use the buffer for pending stores, or otherwise read directly from the WiredTiger table
+ * using a dedicated session and cursor.
  */
 class WiredTigerSizeStorer {
 public:
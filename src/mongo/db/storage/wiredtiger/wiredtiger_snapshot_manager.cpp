@@ -36,15 +36,60 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/hex.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
+WiredTigerSnapshotManager::CommittedSnapshot::CommittedSnapshot(Timestamp timestamp)
+    : timestamp(timestamp),
+      readTimestampConfig("read_timestamp=" + integerToHex(timestamp.asULL()) +
+                          ",round_to_oldest=false") {}
+
+void WiredTigerSnapshotManager::_attachToCommittedSnapshot() const {
+    while (true) {
+        _committedSnapshotReaders.fetchAndAdd(1);
+        if (!_committedSnapshotChanging.load()) {
+            return;
+        }
+
+        // A new committed snapshot is being installed. Get out of its way and wait for it.
+        _detachFromCommittedSnapshot();
+        stdx::unique_lock<stdx::mutex> lock(_committedSnapshotMutex);
+        _committedSnapshotCV.wait(lock, [&] { return !_committedSnapshotChanging.load(); });
+    }
+}
+
+void WiredTigerSnapshotManager::_detachFromCommittedSnapshot() const {
+    if (_committedSnapshotReaders.subtractAndFetch(1) == 0 && _committedSnapshotChanging.load()) {
+        stdx::lock_guard<stdx::mutex> lock(_committedSnapshotMutex);
+        _committedSnapshotCV.notify_all();
+    }
+}
+
+void WiredTigerSnapshotManager::_beginCommittedSnapshotChange(
+    stdx::unique_lock<stdx::mutex>& lock) {
+    _committedSnapshotChanging.store(true);
+    _committedSnapshotCV.wait(lock, [&] { return _committedSnapshotReaders.load() == 0; });
+}
+
+void WiredTigerSnapshotManager::_endCommittedSnapshotChange(WithLock) {
+    _committedSnapshotChanging.store(false);
+    _committedSnapshotCV.notify_all();
+}
+
 void WiredTigerSnapshotManager::setCommittedSnapshot(const Timestamp& timestamp) {
-    stdx::lock_guard<stdx::mutex> lock(_committedSnapshotMutex);
+    stdx::unique_lock<stdx::mutex> lock(_committedSnapshotMutex);
+
+    invariant(!_committedSnapshot || _committedSnapshot->timestamp <= timestamp);
+    if (_committedSnapshot && _committedSnapshot->timestamp == timestamp) {
+        return;
+    }
 
-    invariant(!_committedSnapshot || *_committedSnapshot <= timestamp);
-    _committedSnapshot = timestamp;
+    _beginCommittedSnapshotChange(lock);
+    _committedSnapshot.emplace(timestamp);
+    _endCommittedSnapshotChange(lock);
 }
 
 void WiredTigerSnapshotManager::setLocalSnapshot(const Timestamp& timestamp) {
@@ -58,29 +103,37 @@ boost::optional<Timestamp> WiredTigerSnapshotManager::getLocalSnapshot() {
 }
 
 void WiredTigerSnapshotManager::dropAllSnapshots() {
-    stdx::lock_guard<stdx::mutex> lock(_committedSnapshotMutex);
+    stdx::unique_lock<stdx::mutex> lock(_committedSnapshotMutex);
+    _beginCommittedSnapshotChange(lock);
     _committedSnapshot = boost::none;
+    _endCommittedSnapshotChange(lock);
 }
 
 boost::optional<Timestamp> WiredTigerSnapshotManager::getMinSnapshotForNextCommittedRead() const {
     stdx::lock_guard<stdx::mutex> lock(_committedSnapshotMutex);
-    return _committedSnapshot;
+    if (!_committedSnapshot) {
+        return boost::none;
+    }
+    return _committedSnapshot->timestamp;
 }
 
 Timestamp WiredTigerSnapshotManager::beginTransactionOnCommittedSnapshot(
     WT_SESSION* session, WiredTigerBeginTxnBlock::IgnorePrepared ignorePrepared) const {
     WiredTigerBeginTxnBlock txnOpen(session, ignorePrepared);
 
-    stdx::lock_guard<stdx::mutex> lock(_committedSnapshotMutex);
+    _attachToCommittedSnapshot();
+    ON_BLOCK_EXIT([&] { _detachFromCommittedSnapshot(); });
+
     uassert(ErrorCodes::ReadConcernMajorityNotAvailableYet,
             "Committed view disappeared while running operation",
             _committedSnapshot);
 
-    auto status = txnOpen.setTimestamp(_committedSnapshot.get());
+    auto status = wtRCToStatus(session->timestamp_transaction(
+        session, _committedSnapshot->readTimestampConfig.c_str()));
     fassert(30635, status);
 
     txnOpen.done();
-    return *_committedSnapshot;
+    return _committedSnapshot->timestamp;
 }
 
 Timestamp WiredTigerSnapshotManager::beginTransactionOnLocalSnapshot(
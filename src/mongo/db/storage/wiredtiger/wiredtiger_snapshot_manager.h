@@ -36,7 +36,10 @@
 #include "mongo/bson/timestamp.h"
 #include "mongo/db/storage/snapshot_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_begin_transaction_block.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/with_lock.h"
 
 namespace mongo {
 
@@ -84,9 +87,39 @@ public:
     boost::optional<Timestamp> getMinSnapshotForNextCommittedRead() const;
 
 private:
-    // Snapshot to use for reads at a commit timestamp.
-    mutable stdx::mutex _committedSnapshotMutex;  // Guards _committedSnapshot.
-    boost::optional<Timestamp> _committedSnapshot;
+    struct CommittedSnapshot {
+        explicit CommittedSnapshot(Timestamp timestamp);
+
+        Timestamp timestamp;
+        // Argument to WT_SESSION::timestamp_transaction, built once per committed snapshot rather
+        // than once per read.
+        std::string readTimestampConfig;
+    };
+
+    /**
+     * Majority reads attach to the committed snapshot while they set their read timestamp, so that
+     * they share it without serializing on a mutex. Returns with the caller attached; the caller
+     * must call _detachFromCommittedSnapshot() once its read timestamp is set.
+     */
+    void _attachToCommittedSnapshot() const;
+    void _detachFromCommittedSnapshot() const;
+
+    /**
+     * Waits until no reader is attached to the committed snapshot and keeps new readers from
+     * attaching until _endCommittedSnapshotChange() is called. This stops the committed snapshot,
+     * and therefore the stable and oldest timestamps, from moving past a snapshot that a reader is
+     * about to use.
+     */
+    void _beginCommittedSnapshotChange(stdx::unique_lock<stdx::mutex>& lock);
+    void _endCommittedSnapshotChange(WithLock);
+
+    // Snapshot to use for reads at a commit timestamp. Written with _committedSnapshotMutex held
+    // and no reader attached, read either with the mutex held or while attached.
+    mutable stdx::mutex _committedSnapshotMutex;
+    mutable stdx::condition_variable _committedSnapshotCV;
+    boost::optional<CommittedSnapshot> _committedSnapshot;
+    mutable AtomicWord<int> _committedSnapshotReaders{0};
+    AtomicWord<bool> _committedSnapshotChanging{false};
 
     // Snapshot to use for reads at a local stable timestamp.
     mutable stdx::mutex _localSnapshotMutex;  // Guards _localSnapshot.
@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_snapshot_manager.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+class WiredTigerSnapshotManagerTest : public unittest::Test {
+public:
+    void setUp() override {
+        invariantWTOK(
+            wiredtiger_open(_dbpath.path().c_str(), nullptr, "create,cache_size=10M", &_conn));
+    }
+
+    void tearDown() override {
+        invariantWTOK(_conn->close(_conn, nullptr));
+    }
+
+protected:
+    WT_SESSION* openSession() {
+        WT_SESSION* session;
+        invariantWTOK(_conn->open_session(_conn, nullptr, nullptr, &session));
+        return session;
+    }
+
+    /**
+     * Starts a transaction on the committed snapshot, checks that WiredTiger reads at the returned
+     * timestamp and rolls the transaction back.
+     */
+    Timestamp readCommittedSnapshot(WT_SESSION* session) {
+        const Timestamp timestamp = _snapshotManager.beginTransactionOnCommittedSnapshot(
+            session, WiredTigerBeginTxnBlock::IgnorePrepared::kNoIgnore);
+        ON_BLOCK_EXIT([&] { invariantWTOK(session->rollback_transaction(session, nullptr)); });
+
+        char buf[(2 * 8 /*bytes in hex*/) + 1 /*nul terminator*/];
+        invariantWTOK(session->query_timestamp(session, buf, "get=read"));
+        uint64_t readTimestamp;
+        ASSERT_OK(parseNumberFromStringWithBase(buf, 16, &readTimestamp));
+        ASSERT_EQ(timestamp.asULL(), readTimestamp);
+        return timestamp;
+    }
+
+    unittest::TempDir _dbpath{"wt_snapshot_manager_test"};
+    WT_CONNECTION* _conn = nullptr;
+    WiredTigerSnapshotManager _snapshotManager;
+};
+
+TEST_F(WiredTigerSnapshotManagerTest, ReadWithoutCommittedSnapshotThrows) {
+    WT_SESSION* session = openSession();
+    ON_BLOCK_EXIT([&] { session->close(session, nullptr); });
+
+    ASSERT_THROWS_CODE(readCommittedSnapshot(session),
+                       AssertionException,
+                       ErrorCodes::ReadConcernMajorityNotAvailableYet);
+
+    _snapshotManager.setCommittedSnapshot(Timestamp(1, 1));
+    ASSERT_EQ(Timestamp(1, 1), readCommittedSnapshot(session));
+
+    _snapshotManager.dropAllSnapshots();
+    ASSERT_THROWS_CODE(readCommittedSnapshot(session),
+                       AssertionException,
+                       ErrorCodes::ReadConcernMajorityNotAvailableYet);
+}
+
+TEST_F(WiredTigerSnapshotManagerTest, ConcurrentReadersNeverSeeAnOlderSnapshot) {
+    const int kNumReaders = 4;
+    const unsigned kNumSnapshots = 2000;
+
+    _snapshotManager.setCommittedSnapshot(Timestamp(1, 1));
+
+    // The newest snapshot setCommittedSnapshot() has returned from. A read that starts after
+    // loading it must not use an older one.
+    AtomicWord<unsigned long long> installed{Timestamp(1, 1).asULL()};
+    AtomicWord<bool> done{false};
+    AtomicWord<long long> numReads{0};
+
+    std::vector<stdx::thread> readers;
+    for (int i = 0; i < kNumReaders; ++i) {
+        readers.emplace_back([&] {
+            WT_SESSION* session = openSession();
+            ON_BLOCK_EXIT([&] { session->close(session, nullptr); });
+
+            Timestamp lastRead;
+            while (!done.load()) {
+                const Timestamp atLeast(installed.load());
+                const Timestamp timestamp = readCommittedSnapshot(session);
+                ASSERT_GTE(timestamp, atLeast);
+                ASSERT_GTE(timestamp, lastRead);
+                lastRead = timestamp;
+                numReads.fetchAndAdd(1);
+            }
+        });
+    }
+
+    for (unsigned i = 2; i <= kNumSnapshots; ++i) {
+        const Timestamp timestamp(1, i);
+        _snapshotManager.setCommittedSnapshot(timestamp);
+        // Installing the current snapshot again is a no-op.
+        _snapshotManager.setCommittedSnapshot(timestamp);
+        installed.store(timestamp.asULL());
+        ASSERT_EQ(timestamp, *_snapshotManager.getMinSnapshotForNextCommittedRead());
+    }
+
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    ASSERT_GT(numReads.load(), 0);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -46,7 +46,9 @@
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 #include "mongo/db/storage/kv/kv_prefix.h"
 #include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_oplog_manager.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store_oplog_stones.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
@@ -59,6 +61,8 @@
 #include "mongo/util/clock_source_mock.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -94,6 +98,11 @@ public:
     }
 
     virtual std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns) {
+        const bool isClustered = false;
+        return newNonCappedRecordStore(ns, isClustered);
+    }
+
+    std::unique_ptr<RecordStore> newNonCappedRecordStore(const std::string& ns, bool isClustered) {
         WiredTigerRecoveryUnit* ru =
             dynamic_cast<WiredTigerRecoveryUnit*>(_engine.newRecoveryUnit());
         OperationContextNoop opCtx(ru);
@@ -122,6 +131,7 @@ public:
         params.cappedMaxDocs = -1;
         params.cappedCallback = nullptr;
         params.sizeStorer = nullptr;
+        params.isClustered = isClustered;
 
         auto ret = stdx::make_unique<StandardWiredTigerRecordStore>(&_engine, &opCtx, params);
         ret->postConstructorInit(&opCtx);
@@ -136,6 +146,14 @@ public:
     virtual std::unique_ptr<RecordStore> newCappedRecordStore(const std::string& ns,
                                                               int64_t cappedMaxSize,
                                                               int64_t cappedMaxDocs) {
+        const bool cappedAsyncDeletes = false;
+        return newCappedRecordStore(ns, cappedMaxSize, cappedMaxDocs, cappedAsyncDeletes);
+    }
+
+    std::unique_ptr<RecordStore> newCappedRecordStore(const std::string& ns,
+                                                      int64_t cappedMaxSize,
+                                                      int64_t cappedMaxDocs,
+                                                      bool cappedAsyncDeletes) {
         WiredTigerRecoveryUnit* ru =
             dynamic_cast<WiredTigerRecoveryUnit*>(_engine.newRecoveryUnit());
         OperationContextNoop opCtx(ru);
@@ -167,6 +185,7 @@ public:
         params.cappedMaxDocs = cappedMaxDocs;
         params.cappedCallback = nullptr;
         params.sizeStorer = nullptr;
+        params.cappedAsyncDeletes = cappedAsyncDeletes;
 
         auto ret = stdx::make_unique<StandardWiredTigerRecordStore>(&_engine, &opCtx, params);
         ret->postConstructorInit(&opCtx);
@@ -185,6 +204,10 @@ public:
         return _engine.getConnection();
     }
 
+    WiredTigerKVEngine* getEngine() {
+        return &_engine;
+    }
+
 private:
     unittest::TempDir _dbpath;
     ClockSourceMock _cs;
@@ -209,6 +232,149 @@ TEST(WiredTigerRecordStoreTest, StorageSizeStatisticsDisabled) {
     ASSERT_THROWS(rs->storageSize(opCtx.get()), AssertionException);
 }
 
+TEST(WiredTigerRecordStoreTest, CappedAsyncDeletesLeaveExcessForReclaim) {
+    WiredTigerHarnessHelper harnessHelper;
+    const bool cappedAsyncDeletes = true;
+    unique_ptr<RecordStore> rs(
+        harnessHelper.newCappedRecordStore("a.b", 1000, -1, cappedAsyncDeletes));
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+
+    const std::string data(100, 'x');
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    for (int i = 0; i < 11; i++) {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_OK(rs->insertRecord(opCtx.get(), data.c_str(), data.size(), Timestamp()));
+        uow.commit();
+    }
+
+    // The inserts only requested a deletion, so the collection is over its limit.
+    ASSERT_EQUALS(11, rs->numRecords(opCtx.get()));
+    ASSERT_EQUALS(1100, rs->dataSize(opCtx.get()));
+
+    ASSERT_EQUALS(1, wtrs->reclaimCapped(opCtx.get()));
+    ASSERT_EQUALS(10, rs->numRecords(opCtx.get()));
+    ASSERT_EQUALS(1000, rs->dataSize(opCtx.get()));
+
+    // The oldest records were the ones removed.
+    auto cursor = rs->getCursor(opCtx.get());
+    auto record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQUALS(RecordId(2), record->id);
+}
+
+TEST(WiredTigerRecordStoreTest, ClusteredRecordIdsFollowId) {
+    WiredTigerHarnessHelper harnessHelper;
+    const bool isClustered = true;
+    unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore("a.b", isClustered));
+    ASSERT_TRUE(rs->isClustered());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    auto insert = [&](const BSONObj& doc) {
+        WriteUnitOfWork uow(opCtx.get());
+        auto res = rs->insertRecord(opCtx.get(), doc.objdata(), doc.objsize(), Timestamp());
+        if (res.isOK())
+            uow.commit();
+        return res;
+    };
+
+    auto res = insert(BSON("_id" << 5));
+    ASSERT_OK(res.getStatus());
+    ASSERT_EQUALS(RecordId(5), res.getValue());
+    res = insert(BSON("_id" << 2LL));
+    ASSERT_OK(res.getStatus());
+    ASSERT_EQUALS(RecordId(2), res.getValue());
+
+    // Numerically equal _id values of a different type are duplicates.
+    ASSERT_EQUALS(ErrorCodes::DuplicateKey, insert(BSON("_id" << 5.0)).getStatus());
+    ASSERT_EQUALS(ErrorCodes::BadValue, insert(BSON("_id" << 2.5)).getStatus());
+    ASSERT_EQUALS(ErrorCodes::BadValue, insert(BSON("_id" << 0)).getStatus());
+    ASSERT_EQUALS(ErrorCodes::BadValue, insert(BSON("_id" << BSONNULL)).getStatus());
+    ASSERT_EQUALS(ErrorCodes::BadValue, insert(BSON("x" << 1)).getStatus());
+    ASSERT_EQUALS(2, rs->numRecords(opCtx.get()));
+
+    // A scan returns the records in _id order, regardless of insertion order.
+    auto cursor = rs->getCursor(opCtx.get());
+    auto record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQUALS(RecordId(2), record->id);
+    record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQUALS(RecordId(5), record->id);
+    ASSERT_FALSE(cursor->next());
+}
+
+RecordId insertOplogEntry(OperationContext* opCtx, RecordStore* rs, Timestamp opTime) {
+    WriteUnitOfWork uow(opCtx);
+    ASSERT_OK(rs->oplogDiskLocRegister(opCtx, opTime, false));
+    const BSONObj obj = BSON("ts" << opTime);
+    StatusWith<RecordId> res = rs->insertRecord(opCtx, obj.objdata(), obj.objsize(), opTime);
+    ASSERT_OK(res.getStatus());
+    uow.commit();
+    return res.getValue();
+}
+
+// Test that an operation waiting for oplog visibility does not wait out the delay the journal
+// thread otherwise leaves between flushes.
+TEST(WiredTigerRecordStoreTest, OplogVisibilityWaiterPreemptsJournalDelay) {
+    const int originalJournalCommitIntervalMs = storageGlobalParams.journalCommitIntervalMs.load();
+    ON_BLOCK_EXIT([&] {
+        storageGlobalParams.journalCommitIntervalMs.store(originalJournalCommitIntervalMs);
+    });
+    storageGlobalParams.journalCommitIntervalMs.store(500);
+
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("local.oplog.rs", 100000, -1));
+    auto wtrs = checked_cast<WiredTigerRecordStore*>(rs.get());
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    for (unsigned i = 1; i <= 5; i++) {
+        RecordId id = insertOplogEntry(opCtx.get(), rs.get(), Timestamp(5, i));
+
+        Timer timer;
+        rs->waitForAllEarlierOplogWritesToBeVisible(opCtx.get());
+        ASSERT_FALSE(wtrs->isOpHidden_forTest(id));
+        ASSERT_LT(timer.millis(), 250);
+    }
+}
+
+// Test that the time a committed oplog entry stays hidden is reported in the visibility stats.
+TEST(WiredTigerRecordStoreTest, OplogVisibilityDelayIsReported) {
+    ON_BLOCK_EXIT([] { WTPausePrimaryOplogDurabilityLoop.setMode(FailPoint::off); });
+
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newCappedRecordStore("local.oplog.rs", 100000, -1));
+    auto oplogManager = harnessHelper.getEngine()->getOplogManager();
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    insertOplogEntry(opCtx.get(), rs.get(), Timestamp(5, 1));
+    rs->waitForAllEarlierOplogWritesToBeVisible(opCtx.get());
+
+    // Hold the next entry back from becoming visible for a while.
+    WTPausePrimaryOplogDurabilityLoop.setMode(FailPoint::alwaysOn);
+    insertOplogEntry(opCtx.get(), rs.get(), Timestamp(5, 2));
+    sleepmillis(50);
+    WTPausePrimaryOplogDurabilityLoop.setMode(FailPoint::off);
+    rs->waitForAllEarlierOplogWritesToBeVisible(opCtx.get());
+
+    BSONObjBuilder builder;
+    oplogManager->appendVisibilityStats(&builder);
+    const BSONObj stats = builder.obj();
+
+    const long long count = stats["count"].numberLong();
+    ASSERT_GTE(count, 2) << stats;
+    ASSERT_GTE(stats["delayMicros"].numberLong(), 50 * 1000) << stats;
+
+    // Every delay falls into one bucket, and the held back entry into one of at least 32ms.
+    long long histogramCount = 0;
+    bool sawHeldBackEntry = false;
+    for (const auto& bucket : stats["histogram"].Array()) {
+        histogramCount += bucket["count"].numberLong();
+        sawHeldBackEntry |= bucket["micros"].numberLong() >= (1 << 15);
+    }
+    ASSERT_EQ(count, histogramCount) << stats;
+    ASSERT_TRUE(sawHeldBackEntry) << stats;
+}
+
 TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
@@ -0,0 +1,206 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_adjuster.h"
+
+#include <algorithm>
+
+#include "mongo/db/client.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+constexpr double WiredTigerTicketAdjuster::kDirtyPressureRatio;
+constexpr double WiredTigerTicketAdjuster::kFillPressureRatio;
+constexpr int WiredTigerTicketAdjuster::kAdditiveIncrease;
+const Microseconds WiredTigerTicketAdjuster::kQueueTimeThreshold = Milliseconds(1);
+
+namespace {
+
+// Whether the read and write ticket counts are adjusted automatically. When disabled, the counts
+// are only changed through 'wiredTigerConcurrentReadTransactions' and
+// 'wiredTigerConcurrentWriteTransactions'.
+AtomicBool wiredTigerAdaptiveConcurrentTransactions(false);
+ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>
+    WiredTigerAdaptiveConcurrentTransactionsSetting(ServerParameterSet::getGlobal(),
+                                                    "wiredTigerAdaptiveConcurrentTransactions",
+                                                    &wiredTigerAdaptiveConcurrentTransactions);
+
+// The range within which adaptive mode keeps each ticket count.
+AtomicInt32 wiredTigerAdaptiveConcurrentTransactionsMin(16);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerAdaptiveConcurrentTransactionsMinSetting(
+        ServerParameterSet::getGlobal(),
+        "wiredTigerAdaptiveConcurrentTransactionsMin",
+        &wiredTigerAdaptiveConcurrentTransactionsMin);
+
+AtomicInt32 wiredTigerAdaptiveConcurrentTransactionsMax(512);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerAdaptiveConcurrentTransactionsMaxSetting(
+        ServerParameterSet::getGlobal(),
+        "wiredTigerAdaptiveConcurrentTransactionsMax",
+        &wiredTigerAdaptiveConcurrentTransactionsMax);
+
+// How often the ticket counts are reconsidered.
+AtomicInt32 wiredTigerAdaptiveConcurrentTransactionsPeriodMillis(1000);
+ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>
+    WiredTigerAdaptiveConcurrentTransactionsPeriodMillisSetting(
+        ServerParameterSet::getGlobal(),
+        "wiredTigerAdaptiveConcurrentTransactionsPeriodMillis",
+        &wiredTigerAdaptiveConcurrentTransactionsPeriodMillis);
+
+// TicketHolder::resize() rejects anything smaller.
+const int kMinimumTickets = 5;
+
+}  // namespace
+
+int WiredTigerTicketAdjuster::computeTicketCount(int current,
+                                                 const Sample& sample,
+                                                 int minTickets,
+                                                 int maxTickets) {
+    int next = current;
+    if (sample.cacheDirtyRatio >= kDirtyPressureRatio ||
+        sample.cacheFillRatio >= kFillPressureRatio) {
+        // Admitting fewer operations lets eviction catch up instead of having application threads
+        // pulled into it.
+        next = current - current / 4;
+    } else if (sample.numQueued > 0 &&
+               sample.timeQueued / sample.numQueued >= kQueueTimeThreshold) {
+        next = current + kAdditiveIncrease;
+    }
+
+    // The minimum wins if the bounds are misconfigured.
+    return std::max(minTickets, std::min(next, maxTickets));
+}
+
+WiredTigerTicketAdjuster::WiredTigerTicketAdjuster(WT_CONNECTION* conn,
+                                                   TicketHolder* readTickets,
+                                                   TicketHolder* writeTickets)
+    : BackgroundJob(false /* deleteSelf */),
+      _conn(conn),
+      _read{readTickets, readTickets->totalQueued(), readTickets->totalTimeQueued()},
+      _write{writeTickets, writeTickets->totalQueued(), writeTickets->totalTimeQueued()} {}
+
+void WiredTigerTicketAdjuster::run() {
+    Client::initThread(name().c_str());
+    ON_BLOCK_EXIT([] { Client::destroy(); });
+
+    LOG(1) << "starting " << name() << " thread";
+
+    WiredTigerSession session(_conn);
+    while (!_shuttingDown.load()) {
+        {
+            stdx::unique_lock<stdx::mutex> lock(_mutex);
+            MONGO_IDLE_THREAD_BLOCK;
+            const int ms = std::max(wiredTigerAdaptiveConcurrentTransactionsPeriodMillis.load(), 1);
+            _condvar.wait_for(
+                lock, stdx::chrono::milliseconds(ms), [this] { return _shuttingDown.load(); });
+        }
+
+        if (_shuttingDown.load())
+            break;
+
+        if (!wiredTigerAdaptiveConcurrentTransactions.load()) {
+            // Queueing that happens while disabled must not count once re-enabled.
+            for (auto state : {&_read, &_write}) {
+                state->lastTotalQueued = state->holder->totalQueued();
+                state->lastTotalTimeQueued = state->holder->totalTimeQueued();
+            }
+            continue;
+        }
+
+        auto statistic = [&](int key) {
+            return WiredTigerUtil::getStatisticsValueAs<long long>(
+                session.getSession(), "statistics:", "statistics=(fast)", key);
+        };
+        auto inUse = statistic(WT_STAT_CONN_CACHE_BYTES_INUSE);
+        auto dirty = statistic(WT_STAT_CONN_CACHE_BYTES_DIRTY);
+        auto max = statistic(WT_STAT_CONN_CACHE_BYTES_MAX);
+        if (!inUse.isOK() || !dirty.isOK() || !max.isOK() || max.getValue() <= 0) {
+            LOG(2) << "unable to read WiredTiger cache statistics, skipping ticket adjustment";
+            continue;
+        }
+
+        const double fillRatio = static_cast<double>(inUse.getValue()) / max.getValue();
+        const double dirtyRatio = static_cast<double>(dirty.getValue()) / max.getValue();
+        _adjust(&_read, fillRatio, dirtyRatio);
+        _adjust(&_write, fillRatio, dirtyRatio);
+    }
+    LOG(1) << "stopping " << name() << " thread";
+}
+
+void WiredTigerTicketAdjuster::_adjust(HolderState* state,
+                                       double cacheFillRatio,
+                                       double cacheDirtyRatio) {
+    const auto totalQueued = state->holder->totalQueued();
+    const auto totalTimeQueued = state->holder->totalTimeQueued();
+
+    Sample sample;
+    sample.cacheFillRatio = cacheFillRatio;
+    sample.cacheDirtyRatio = cacheDirtyRatio;
+    sample.numQueued = totalQueued - state->lastTotalQueued;
+    sample.timeQueued = totalTimeQueued - state->lastTotalTimeQueued;
+    state->lastTotalQueued = totalQueued;
+    state->lastTotalTimeQueued = totalTimeQueued;
+
+    const int minTickets =
+        std::max(wiredTigerAdaptiveConcurrentTransactionsMin.load(), kMinimumTickets);
+    const int maxTickets = wiredTigerAdaptiveConcurrentTransactionsMax.load();
+
+    const int current = state->holder->outof();
+    const int next = computeTicketCount(current, sample, minTickets, maxTickets);
+    if (next == current)
+        return;
+
+    LOG(2) << "adjusting WiredTiger tickets from " << current << " to " << next
+           << "; cache fill ratio: " << cacheFillRatio << ", dirty ratio: " << cacheDirtyRatio
+           << ", queued: " << sample.numQueued << ", time queued: " << sample.timeQueued;
+    invariant(state->holder->resize(next));
+}
+
+void WiredTigerTicketAdjuster::shutdown() {
+    {
+        stdx::unique_lock<stdx::mutex> lock(_mutex);
+        _shuttingDown.store(true);
+        _condvar.notify_one();
+    }
+    wait();
+}
+
+}  // namespace mongo
@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <wiredtiger.h>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/background.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class TicketHolder;
+
+/**
+ * Periodically resizes the WiredTiger read and write ticket holders when adaptive concurrency is
+ * enabled through the 'wiredTigerAdaptiveConcurrentTransactions' server parameter. Each holder is
+ * adjusted independently in AIMD fashion: the ticket count backs off multiplicatively while the
+ * WiredTiger cache is under eviction pressure, and grows additively while operations spend a
+ * significant amount of time queued for a ticket.
+ */
+class WiredTigerTicketAdjuster : public BackgroundJob {
+public:
+    /**
+     * The signals observed over one adjustment period for a single ticket holder.
+     */
+    struct Sample {
+        double cacheFillRatio = 0;   // bytes in the cache / configured cache size
+        double cacheDirtyRatio = 0;  // dirty bytes in the cache / configured cache size
+        std::int64_t numQueued = 0;  // operations that had to queue for a ticket
+        Microseconds timeQueued{0};  // total time those operations spent queued
+    };
+
+    static constexpr double kDirtyPressureRatio = 0.20;
+    static constexpr double kFillPressureRatio = 0.95;
+    static constexpr int kAdditiveIncrease = 4;
+    static const Microseconds kQueueTimeThreshold;
+
+    /**
+     * Returns the ticket count to use for the next period given the current count and the
+     * observations for the last period. The result is always within [minTickets, maxTickets].
+     */
+    static int computeTicketCount(int current,
+                                  const Sample& sample,
+                                  int minTickets,
+                                  int maxTickets);
+
+    WiredTigerTicketAdjuster(WT_CONNECTION* conn,
+                             TicketHolder* readTickets,
+                             TicketHolder* writeTickets);
+
+    std::string name() const override {
+        return "WTTicketAdjuster";
+    }
+
+    void run() override;
+
+    void shutdown();
+
+private:
+    struct HolderState {
+        TicketHolder* holder;
+        std::int64_t lastTotalQueued;
+        Microseconds lastTotalTimeQueued;
+    };
+
+    void _adjust(HolderState* state, double cacheFillRatio, double cacheDirtyRatio);
+
+    WT_CONNECTION* const _conn;
+    HolderState _read;
+    HolderState _write;
+
+    stdx::mutex _mutex;  // protects _condvar
+    stdx::condition_variable _condvar;
+
+    AtomicBool _shuttingDown{false};
+};
+
+}  // namespace mongo
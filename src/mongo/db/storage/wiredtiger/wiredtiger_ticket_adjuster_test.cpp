@@ -0,0 +1,99 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_adjuster.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const int kMin = 16;
+const int kMax = 512;
+
+WiredTigerTicketAdjuster::Sample idleSample() {
+    WiredTigerTicketAdjuster::Sample sample;
+    sample.cacheFillRatio = 0.5;
+    sample.cacheDirtyRatio = 0.01;
+    return sample;
+}
+
+TEST(WiredTigerTicketAdjusterTest, UnchangedWhenIdle) {
+    ASSERT_EQ(128, WiredTigerTicketAdjuster::computeTicketCount(128, idleSample(), kMin, kMax));
+}
+
+TEST(WiredTigerTicketAdjusterTest, GrowsAdditivelyWhenQueueing) {
+    auto sample = idleSample();
+    sample.numQueued = 10;
+    sample.timeQueued = Milliseconds(50);
+    ASSERT_EQ(128 + WiredTigerTicketAdjuster::kAdditiveIncrease,
+              WiredTigerTicketAdjuster::computeTicketCount(128, sample, kMin, kMax));
+}
+
+TEST(WiredTigerTicketAdjusterTest, IgnoresShortQueueTimes) {
+    auto sample = idleSample();
+    sample.numQueued = 1000;
+    sample.timeQueued = Microseconds(1000);
+    ASSERT_EQ(128, WiredTigerTicketAdjuster::computeTicketCount(128, sample, kMin, kMax));
+}
+
+TEST(WiredTigerTicketAdjusterTest, ShrinksMultiplicativelyUnderDirtyPressure) {
+    auto sample = idleSample();
+    sample.cacheDirtyRatio = WiredTigerTicketAdjuster::kDirtyPressureRatio;
+    // Cache pressure takes precedence over queueing.
+    sample.numQueued = 10;
+    sample.timeQueued = Milliseconds(50);
+    ASSERT_EQ(96, WiredTigerTicketAdjuster::computeTicketCount(128, sample, kMin, kMax));
+}
+
+TEST(WiredTigerTicketAdjusterTest, ShrinksMultiplicativelyWhenCacheFull) {
+    auto sample = idleSample();
+    sample.cacheFillRatio = 0.99;
+    ASSERT_EQ(96, WiredTigerTicketAdjuster::computeTicketCount(128, sample, kMin, kMax));
+}
+
+TEST(WiredTigerTicketAdjusterTest, StaysWithinBounds) {
+    auto pressure = idleSample();
+    pressure.cacheFillRatio = 1.0;
+    ASSERT_EQ(kMin, WiredTigerTicketAdjuster::computeTicketCount(kMin, pressure, kMin, kMax));
+
+    auto queueing = idleSample();
+    queueing.numQueued = 1;
+    queueing.timeQueued = Seconds(1);
+    ASSERT_EQ(kMax, WiredTigerTicketAdjuster::computeTicketCount(kMax - 1, queueing, kMin, kMax));
+
+    // A count outside the range, e.g. set through wiredTigerConcurrentReadTransactions, is pulled
+    // back into it.
+    ASSERT_EQ(kMax, WiredTigerTicketAdjuster::computeTicketCount(1000, idleSample(), kMin, kMax));
+    ASSERT_EQ(kMin, WiredTigerTicketAdjuster::computeTicketCount(8, idleSample(), kMin, kMax));
+}
+
+}  // namespace
+}  // namespace mongo
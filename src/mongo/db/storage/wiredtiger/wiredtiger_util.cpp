@@ -525,6 +525,30 @@ int WiredTigerUtil::verifyTable(OperationContext* opCtx,
     return (session->verify)(session, uri.c_str(), NULL);
 }
 
+StatusWith<bool> WiredTigerUtil::compactStep(OperationContext* opCtx,
+                                             const std::string& uri,
+                                             Seconds timeout) {
+    invariant(timeout >= Seconds(1));
+
+    auto ru = WiredTigerRecoveryUnit::get(opCtx);
+    if (ru->getSessionCache()->isEphemeral()) {
+        return true;
+    }
+
+    WT_SESSION* session = ru->getSession()->getSession();
+    opCtx->recoveryUnit()->abandonSnapshot();
+
+    const std::string config = str::stream() << "timeout=" << durationCount<Seconds>(timeout);
+    const int ret = session->compact(session, uri.c_str(), config.c_str());
+    if (ret == ETIMEDOUT || ret == EBUSY) {
+        return false;
+    }
+    if (ret != 0) {
+        return wtRCToStatus(ret);
+    }
+    return true;
+}
+
 bool WiredTigerUtil::useTableLogging(NamespaceString ns, bool replEnabled) {
     if (!replEnabled) {
         // All tables on standalones are logged.
@@ -265,6 +265,15 @@ public:
                            const std::string& uri,
                            std::vector<std::string>* errors = NULL);
 
+    /**
+     * Runs WT_SESSION::compact() on 'uri' for at most 'timeout', which must be at least a second.
+     * Returns true if compaction finished, or false if it timed out or the table was busy, in
+     * which case it may be called again to continue. Ephemeral tables are never compacted.
+     */
+    static StatusWith<bool> compactStep(OperationContext* opCtx,
+                                        const std::string& uri,
+                                        Seconds timeout);
+
     static bool useTableLogging(NamespaceString ns, bool replEnabled);
 
 private:
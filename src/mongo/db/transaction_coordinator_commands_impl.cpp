@@ -33,7 +33,11 @@
 #include "mongo/db/transaction_coordinator_commands_impl.h"
 
 #include "mongo/db/commands/txn_cmds_gen.h"
+#include "mongo/db/commands/txn_two_phase_commit_cmds_gen.h"
 #include "mongo/db/operation_context_session_mongod.h"
+#include "mongo/db/repl/repl_client_info.h"
+#include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/write_concern_options.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/async_requests_sender.h"
@@ -104,6 +108,47 @@ std::vector<ShardId> sendCommit(OperationContext* opCtx,
     return ackedParticipants;
 }
 
+/**
+ * Schedules prepareTransaction on 'participants'. Creating the ARS sends the requests immediately,
+ * so the caller can do other work before collecting the responses.
+ */
+std::unique_ptr<AsyncRequestsSender> scheduleSendPrepare(OperationContext* opCtx,
+                                                         const std::set<ShardId>& participants,
+                                                         const ShardId& coordinatorId) {
+    StringBuilder ss;
+    ss << "[";
+
+    PrepareTransaction prepareTransaction;
+    prepareTransaction.setDbName("admin");
+    prepareTransaction.setCoordinatorId(coordinatorId);
+    BSONObj prepareObj = prepareTransaction.toBSON(
+        BSON("lsid" << opCtx->getLogicalSessionId()->toBSON() << "txnNumber"
+                    << *opCtx->getTxnNumber()
+                    << "autocommit"
+                    << false
+                    << WriteConcernOptions::kWriteConcernField
+                    << WriteConcernOptions::Majority));
+
+    std::vector<AsyncRequestsSender::Request> requests;
+    for (const auto& shardId : participants) {
+        requests.emplace_back(shardId, prepareObj);
+        ss << shardId << " ";
+    }
+
+    // TODO (SERVER-36687): Remove log line or demote to lower log level once cross-shard
+    // transactions are stable.
+    ss << "]";
+    LOG(0) << "Coordinator shard sending " << prepareObj << " to " << ss.str();
+
+    return stdx::make_unique<AsyncRequestsSender>(
+        opCtx,
+        Grid::get(opCtx)->getExecutorPool()->getFixedExecutor(),
+        "admin",
+        requests,
+        ReadPreferenceSetting(ReadPreference::PrimaryOnly),
+        Shard::RetryPolicy::kIdempotent);
+}
+
 void sendAbort(OperationContext* opCtx, const std::set<ShardId>& nonAckedParticipants) {
     StringBuilder ss;
     ss << "[";
@@ -233,5 +278,81 @@ void recvVoteAbort(OperationContext* opCtx,
     doAction(opCtx, coordinator, action);
 }
 
+void sendPrepareAndCollectVotes(OperationContext* opCtx,
+                                std::shared_ptr<TransactionCoordinator> coordinator,
+                                const std::set<ShardId>& participantList,
+                                const ShardId& localShardId,
+                                const stdx::function<Timestamp()>& prepareLocalParticipant) {
+    std::set<ShardId> remoteParticipants(participantList);
+    const bool hasLocalParticipant = remoteParticipants.erase(localShardId) > 0;
+
+    std::unique_ptr<AsyncRequestsSender> ars;
+    if (!remoteParticipants.empty()) {
+        ars = scheduleSendPrepare(opCtx, remoteParticipants, localShardId);
+    }
+
+    if (hasLocalParticipant) {
+        Timestamp prepareTimestamp;
+        try {
+            prepareTimestamp = prepareLocalParticipant();
+        } catch (const DBException& ex) {
+            LOG(0) << "Coordinator shard failed to prepare locally: " << ex.toStatus();
+            recvVoteAbort(opCtx, coordinator, localShardId);
+            throw;
+        }
+
+        // Like a remote participant's, the local prepare only counts as a vote once it is majority
+        // committed and so can no longer be rolled back. Otherwise the participant is left without
+        // a vote, to be asked again.
+        const auto prepareOpTime = repl::ReplClientInfo::forClient(opCtx->getClient()).getLastOp();
+        const WriteConcernOptions majority(WriteConcernOptions::kMajority,
+                                           WriteConcernOptions::SyncMode::UNSET,
+                                           WriteConcernOptions::kNoTimeout);
+        auto replCoord = repl::ReplicationCoordinator::get(opCtx);
+        const auto waitStatus = replCoord->awaitReplication(opCtx, prepareOpTime, majority).status;
+        if (waitStatus.isOK()) {
+            recvVoteCommit(opCtx, coordinator, localShardId, prepareTimestamp);
+        } else {
+            // TODO (SERVER-36687): Remove log line or demote to lower log level once cross-shard
+            // transactions are stable.
+            LOG(0) << "Coordinator shard failed to majority commit its local prepare: "
+                   << waitStatus;
+        }
+    }
+
+    while (ars && !ars->done()) {
+        auto response = ars->next();
+
+        if (!response.swResponse.isOK()) {
+            // TODO (SERVER-36687): Remove log line or demote to lower log level once cross-shard
+            // transactions are stable.
+            LOG(0) << "Coordinator shard got response " << response.swResponse.getStatus()
+                   << " for prepareTransaction to " << response.shardId;
+            continue;
+        }
+
+        const auto& responseObj = response.swResponse.getValue().data;
+        auto commandStatus = getStatusFromCommandResult(responseObj);
+
+        // TODO (SERVER-36687): Remove log line or demote to lower log level once cross-shard
+        // transactions are stable.
+        LOG(0) << "Coordinator shard got response " << commandStatus
+               << " for prepareTransaction to " << response.shardId;
+
+        // A prepare that is not yet majority committed could still be rolled back, so it does not
+        // count as a vote. The participant will be asked again.
+        if (commandStatus.isOK() && !getWriteConcernStatusFromCommandResult(responseObj).isOK()) {
+            continue;
+        }
+
+        auto prepareTimestampElem = responseObj["prepareTimestamp"];
+        if (commandStatus.isOK() && prepareTimestampElem.type() == bsonTimestamp) {
+            recvVoteCommit(opCtx, coordinator, response.shardId, prepareTimestampElem.timestamp());
+        } else {
+            recvVoteAbort(opCtx, coordinator, response.shardId);
+        }
+    }
+}
+
 }  // namespace txn
 }  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include "mongo/db/operation_context.h"
 #include "mongo/db/transaction_coordinator.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -50,5 +51,25 @@ void recvVoteAbort(OperationContext* opCtx,
                    std::shared_ptr<TransactionCoordinator> coordinator,
                    const ShardId& shardId);
 
+/**
+ * Sends prepareTransaction to every participant in 'participantList' other than 'localShardId' in
+ * parallel, and runs 'prepareLocalParticipant' on this shard while those requests are in flight.
+ * Each participant's response is delivered to the coordinator as its vote: a prepareTimestamp is
+ * a vote to commit and a command error is a vote to abort. This lets the coordinator reach its
+ * decision as soon as the last prepare completes, instead of waiting for every participant to send
+ * a separate vote message after preparing.
+ *
+ * The local participant only votes to commit once its prepare is majority committed, as the remote
+ * ones are asked to prepare with majority write concern. Participants that cannot be reached, and
+ * a local participant whose prepare fails to become majority committed, are left without a vote,
+ * so they can still vote later.
+ * Rethrows the error from 'prepareLocalParticipant', after voting to abort on its behalf.
+ */
+void sendPrepareAndCollectVotes(OperationContext* opCtx,
+                                std::shared_ptr<TransactionCoordinator> coordinator,
+                                const std::set<ShardId>& participantList,
+                                const ShardId& localShardId,
+                                const stdx::function<Timestamp()>& prepareLocalParticipant);
+
 }  // namespace txn
 }  // namespace mongo
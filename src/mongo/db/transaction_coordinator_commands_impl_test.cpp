@@ -33,6 +33,7 @@
 #include "mongo/client/remote_command_targeter_mock.h"
 #include "mongo/db/commands/txn_cmds_gen.h"
 #include "mongo/db/operation_context_session_mongod.h"
+#include "mongo/db/repl/replication_coordinator_mock.h"
 #include "mongo/db/session_catalog.h"
 #include "mongo/db/transaction_coordinator_commands_impl.h"
 #include "mongo/db/transaction_participant.h"
@@ -131,6 +132,45 @@ protected:
         return simulateHandleRequest(commandFn);
     }
 
+    /**
+     * Simulates coordinateCommitTransaction running on 'localShardId', which prepares the local
+     * participant with 'localPrepareTimestamp' and sends prepare to the other participants.
+     */
+    auto receiveCoordinateCommitAndPrepare(std::set<ShardId> participantList,
+                                           ShardId localShardId,
+                                           Timestamp localPrepareTimestamp) {
+        auto coordinator = _coordinator;
+        return simulateHandleRequest([=](OperationContext* opCtx) {
+            txn::recvCoordinateCommit(opCtx, coordinator, participantList);
+            txn::sendPrepareAndCollectVotes(opCtx,
+                                            coordinator,
+                                            participantList,
+                                            localShardId,
+                                            [=] { return localPrepareTimestamp; });
+        });
+    }
+
+    void expectSendPrepareAndReturnPrepareTimestamp(Timestamp prepareTimestamp) {
+        onCommand([prepareTimestamp](const executor::RemoteCommandRequest& request) {
+            ASSERT_EQUALS("prepareTransaction",
+                          request.cmdObj.firstElement().fieldNameStringData());
+            return BSON("ok" << 1 << "prepareTimestamp" << prepareTimestamp);
+        });
+    }
+
+    void expectSendPrepareAndReturnError() {
+        onCommand([](const executor::RemoteCommandRequest& request) {
+            ASSERT_EQUALS("prepareTransaction",
+                          request.cmdObj.firstElement().fieldNameStringData());
+            return BSON("ok" << 0 << "code" << ErrorCodes::NoSuchTransaction << "errmsg"
+                             << "dummy");
+        });
+    }
+
+    std::shared_ptr<TransactionCoordinator> coordinator() const {
+        return _coordinator;
+    }
+
     void expectSendAbortAndReturnRetryableErrror() {
         for (int i = 0; i <= kMaxNumFailedHostRetryAttempts; i++) {
             onCommand([](const executor::RemoteCommandRequest& request) -> Status {
@@ -471,5 +511,75 @@ TEST_F(TransactionCoordinatorTestFixture,
     future.timed_get(kFutureTimeout);
 }
 
+//
+// Prepare tests
+//
+
+TEST_F(TransactionCoordinatorTestFixture, PrepareResponsesFromAllParticipantsSendCommit) {
+    auto future = receiveCoordinateCommitAndPrepare(
+        {shardIds[0], shardIds[1], shardIds[2]}, shardIds[0], Timestamp(1, 1));
+    expectSendPrepareAndReturnPrepareTimestamp(Timestamp(1, 2));
+    expectSendPrepareAndReturnPrepareTimestamp(Timestamp(1, 3));
+    expectSendCommitAndReturnSuccess();
+    expectSendCommitAndReturnSuccess();
+    expectSendCommitAndReturnSuccess();
+    future.timed_get(kFutureTimeout);
+
+    ASSERT(coordinator()->state() == TransactionCoordinator::StateMachine::State::kCommitted);
+    ASSERT_EQ(Timestamp(1, 3), coordinator()->getCommitTimestamp());
+}
+
+TEST_F(TransactionCoordinatorTestFixture, PrepareErrorFromParticipantSendsAbort) {
+    auto future = receiveCoordinateCommitAndPrepare(
+        {shardIds[0], shardIds[1]}, shardIds[0], Timestamp(1, 1));
+    expectSendPrepareAndReturnError();
+    expectSendAbortAndReturnSuccess();
+    future.timed_get(kFutureTimeout);
+
+    ASSERT(coordinator()->state() == TransactionCoordinator::StateMachine::State::kAborted);
+}
+
+TEST_F(TransactionCoordinatorTestFixture, UnreachableParticipantIsLeftWithoutAVote) {
+    auto future = receiveCoordinateCommitAndPrepare(
+        {shardIds[0], shardIds[1]}, shardIds[0], Timestamp(1, 1));
+    for (int i = 0; i <= kMaxNumFailedHostRetryAttempts; i++) {
+        onCommand([](const executor::RemoteCommandRequest& request) -> Status {
+            ASSERT_EQUALS("prepareTransaction",
+                          request.cmdObj.firstElement().fieldNameStringData());
+            return {ErrorCodes::HostUnreachable, ""};
+        });
+    }
+    future.timed_get(kFutureTimeout);
+
+    ASSERT(coordinator()->state() ==
+           TransactionCoordinator::StateMachine::State::kWaitingForVotes);
+
+    // The participant can still vote once it has prepared.
+    future = receiveVoteCommit(shardIds[1], Timestamp(1, 2));
+    expectSendCommitAndReturnSuccess();
+    expectSendCommitAndReturnSuccess();
+    future.timed_get(kFutureTimeout);
+}
+
+TEST_F(TransactionCoordinatorTestFixture, LocalPrepareIsNotAVoteUntilMajorityCommitted) {
+    replicationCoordinator()->setAwaitReplicationReturnValueFunction([](const repl::OpTime&) {
+        return repl::ReplicationCoordinator::StatusAndDuration(
+            {ErrorCodes::PrimarySteppedDown, "stepped down"}, Milliseconds(0));
+    });
+    auto future = receiveCoordinateCommitAndPrepare(
+        {shardIds[0], shardIds[1]}, shardIds[0], Timestamp(1, 1));
+    expectSendPrepareAndReturnPrepareTimestamp(Timestamp(1, 2));
+    future.timed_get(kFutureTimeout);
+
+    ASSERT(coordinator()->state() ==
+           TransactionCoordinator::StateMachine::State::kWaitingForVotes);
+
+    // The local participant can still vote once its prepare is majority committed.
+    future = receiveVoteCommit(shardIds[0], Timestamp(1, 1));
+    expectSendCommitAndReturnSuccess();
+    expectSendCommitAndReturnSuccess();
+    future.timed_get(kFutureTimeout);
+}
+
 }  // namespace
 }  // namespace mongo
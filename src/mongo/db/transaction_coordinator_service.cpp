@@ -81,7 +81,9 @@ TransactionCoordinatorService::CommitDecision TransactionCoordinatorService::coo
     OperationContext* opCtx,
     LogicalSessionId lsid,
     TxnNumber txnNumber,
-    const std::set<ShardId>& participantList) {
+    const std::set<ShardId>& participantList,
+    const ShardId& localShardId,
+    const stdx::function<Timestamp()>& prepareLocalParticipant) {
 
     auto coordinator = _coordinatorCatalog.get(lsid, txnNumber);
     if (!coordinator) {
@@ -90,6 +92,8 @@ TransactionCoordinatorService::CommitDecision TransactionCoordinatorService::coo
 
     // TODO (SERVER-37017): Execute this asynchronously.
     txn::recvCoordinateCommit(opCtx, coordinator.get(), participantList);
+    txn::sendPrepareAndCollectVotes(
+        opCtx, coordinator.get(), participantList, localShardId, prepareLocalParticipant);
 
     // TODO (SERVER-36640): Return a notification wrapping the decision that the caller can wait on.
     return TransactionCoordinatorService::CommitDecision::kAbort;
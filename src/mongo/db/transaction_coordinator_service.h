@@ -33,6 +33,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/logical_session_id.h"
 #include "mongo/db/transaction_coordinator_catalog.h"
+#include "mongo/stdx/functional.h"
 
 
 namespace mongo {
@@ -68,14 +69,19 @@ public:
     void createCoordinator(LogicalSessionId lsid, TxnNumber txnNumber, Date_t commitDeadline);
 
     /**
-     * Delivers coordinateCommit to the TransactionCoordinator.
+     * Delivers coordinateCommit to the TransactionCoordinator, then prepares the transaction on
+     * all of the participants in parallel and delivers their responses as votes. The local
+     * participant on 'localShardId', if it is in the list, is prepared by calling
+     * 'prepareLocalParticipant' while the remote prepares are in flight.
      *
      * TODO (SERVER-36640): Return Notification<CommitDecision>.
      */
     CommitDecision coordinateCommit(OperationContext* opCtx,
                                     LogicalSessionId lsid,
                                     TxnNumber txnNumber,
-                                    const std::set<ShardId>& participantList);
+                                    const std::set<ShardId>& participantList,
+                                    const ShardId& localShardId,
+                                    const stdx::function<Timestamp()>& prepareLocalParticipant);
 
     /**
      * Delivers voteCommit to the TransactionCoordinator.
@@ -43,6 +43,7 @@
 #include "mongo/db/server_transactions_metrics.h"
 #include "mongo/db/session.h"
 #include "mongo/db/session_catalog.h"
+#include "mongo/db/snapshot_window_util.h"
 #include "mongo/db/stats/fill_locker_info.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -71,6 +72,20 @@ MONGO_EXPORT_SERVER_PARAMETER(transactionLifetimeLimitSeconds, std::int32_t, 60)
         return Status::OK();
     });
 
+// The largest total in-memory size of the operations a transaction may accumulate. Unprepared
+// transactions are written to the oplog as a chain of 'applyOps' entries, so this is only bounded
+// by the memory the server is willing to hold for one transaction rather than by the BSON size
+// limit.
+MONGO_EXPORT_SERVER_PARAMETER(transactionSizeLimitBytes, long long, 64 * 1024 * 1024)
+    ->withValidator([](const auto& potentialNewValue) {
+        if (potentialNewValue < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "transactionSizeLimitBytes must be greater than or equal to 1");
+        }
+
+        return Status::OK();
+    });
+
 namespace {
 
 // Failpoint which will pause an operation just after allocating a point-in-time storage engine
@@ -628,16 +643,17 @@ void TransactionParticipant::addTransactionOperation(OperationContext* opCtx,
     invariant(opCtx->lockState()->inAWriteUnitOfWork());
     _transactionOperations.push_back(operation);
     _transactionOperationBytes += repl::OplogEntry::getReplOperationSize(operation);
-    // _transactionOperationBytes is based on the in-memory size of the operation.  With overhead,
-    // we expect the BSON size of the operation to be larger, so it's possible to make a transaction
-    // just a bit too large and have it fail only in the commit.  It's still useful to fail early
+    // _transactionOperationBytes is based on the in-memory size of the operation. A prepared
+    // transaction is still written as a single oplog entry, so it can fail only once it is
+    // prepared if its operations exceed the BSON size limit.  It's still useful to fail early
     // when possible (e.g. to avoid exhausting server memory).
+    const auto sizeLimit = transactionSizeLimitBytes.load();
     uassert(ErrorCodes::TransactionTooLarge,
             str::stream() << "Total size of all transaction operations must be less than "
-                          << BSONObjMaxInternalSize
+                          << sizeLimit
                           << ". Actual size is "
                           << _transactionOperationBytes,
-            _transactionOperationBytes <= BSONObjMaxInternalSize);
+            static_cast<long long>(_transactionOperationBytes) <= sizeLimit);
 }
 
 std::vector<repl::ReplOperation> TransactionParticipant::endTransactionAndRetrieveOperations(
@@ -1311,13 +1327,22 @@ void TransactionParticipant::_logSlowTransaction(WithLock wl,
                                                  repl::ReadConcernArgs readConcernArgs) {
     // Only log multi-document transactions.
     if (!_txnState.isNone(wl)) {
+        const auto durationMicros =
+            _transactionMetricsObserver.getSingleTransactionStats().getDuration(curTimeMicros64());
+
         // Log the transaction if its duration is longer than the slowMS command threshold.
-        if (_transactionMetricsObserver.getSingleTransactionStats().getDuration(curTimeMicros64()) >
-            serverGlobalParams.slowMS * 1000ULL) {
+        if (durationMicros > serverGlobalParams.slowMS * 1000ULL) {
             log(logger::LogComponent::kTransaction)
                 << "transaction "
                 << _transactionInfoForLog(lockStats, terminationCause, readConcernArgs);
         }
+
+        // Snapshot transactions may open snapshots as old as their start, so their durations feed
+        // the sizing of the snapshot history window.
+        if (readConcernArgs.getLevel() == repl::ReadConcernLevel::kSnapshotReadConcern) {
+            SnapshotWindowUtil::recordSnapshotReadDuration(
+                Milliseconds(static_cast<long long>(durationMicros / 1000)));
+        }
     }
 }
 
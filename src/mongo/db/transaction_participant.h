@@ -52,6 +52,7 @@ namespace mongo {
 class OperationContext;
 
 extern AtomicInt32 transactionLifetimeLimitSeconds;
+extern AtomicInt64 transactionSizeLimitBytes;
 
 enum class SpeculativeTransactionOpTime {
     kLastApplied,
@@ -526,7 +527,8 @@ private:
                                           OperationContext* opCtx,
                                           const std::string& cmdName);
 
-    // Logs the transaction information if it has run slower than the global parameter slowMS. The
+    // Logs the transaction information if it has run slower than the global parameter slowMS, and
+    // records the duration of snapshot transactions for sizing the snapshot history window. The
     // transaction must be committed or aborted when this function is called.
     void _logSlowTransaction(WithLock wl,
                              const SingleThreadedLockStats* lockStats,
@@ -1406,15 +1406,18 @@ TEST_F(TxnParticipantTest, TransactionTooLargeWhileBuilding) {
 
     txnParticipant->unstashTransactionResources(opCtx(), "insert");
 
-    // Two 6MB operations should succeed; three 6MB operations should fail.
+    // 6MB operations should succeed until their total size exceeds 'transactionSizeLimitBytes'.
     constexpr size_t kBigDataSize = 6 * 1024 * 1024;
     std::unique_ptr<uint8_t[]> bigData(new uint8_t[kBigDataSize]());
     auto operation = repl::OplogEntry::makeInsertOperation(
         kNss,
         kUUID,
         BSON("_id" << 0 << "data" << BSONBinData(bigData.get(), kBigDataSize, BinDataGeneral)));
-    txnParticipant->addTransactionOperation(opCtx(), operation);
-    txnParticipant->addTransactionOperation(opCtx(), operation);
+    const long long operationSize = repl::OplogEntry::getReplOperationSize(operation);
+    for (long long totalSize = operationSize; totalSize <= transactionSizeLimitBytes.load();
+         totalSize += operationSize) {
+        txnParticipant->addTransactionOperation(opCtx(), operation);
+    }
     ASSERT_THROWS_CODE(txnParticipant->addTransactionOperation(opCtx(), operation),
                        AssertionException,
                        ErrorCodes::TransactionTooLarge);
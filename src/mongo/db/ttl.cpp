@@ -34,6 +34,10 @@
 
 #include "mongo/db/ttl.h"
 
+#include <algorithm>
+#include <map>
+#include <set>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -44,6 +48,7 @@
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync_locked.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
@@ -55,10 +60,15 @@
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/ttl_collection_cache.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -77,6 +87,135 @@ MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60)
         return Status::OK();
     });  // used for testing
 
+namespace {
+
+const int kMaxTTLMonitorThreads = 16;
+
+}  // namespace
+
+// The number of TTL indexes that a pass deletes from concurrently.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorThreads, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1 || newVal > kMaxTTLMonitorThreads) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "ttlMonitorThreads must be between 1 and "
+                                        << kMaxTTLMonitorThreads);
+        }
+        return Status::OK();
+    });
+
+// The most documents that a pass deletes through any one TTL index, or 0 for no limit. The rest
+// are left for the following passes.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxDeletesPerIndexPerPass, long long, 0)
+    ->withValidator([](const long long& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "ttlMonitorMaxDeletesPerIndexPerPass must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
+// How long a pass may spend deleting, or 0 for no limit. The indexes that a pass doesn't get to
+// are the first ones processed by the next pass.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxPassTimeMS, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "ttlMonitorMaxPassTimeMS must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
+namespace {
+
+ThreadPool* getTTLMonitorThreadPool() {
+    static ThreadPool* const pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitor";
+        options.minThreads = 0;
+        options.maxThreads = kMaxTTLMonitorThreads - 1;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+            AuthorizationSession::get(cc())->grantInternalAuthorization();
+        };
+
+        auto newPool = new ThreadPool(options);
+        newPool->startup();
+        return newPool;
+    }();
+    return pool;
+}
+
+/**
+ * What the last pass did for one TTL index. 'deletionLag' is how long the oldest expired document
+ * had been expired for when the pass reached the index.
+ */
+struct TTLIndexStats {
+    Date_t lastPass;
+    Milliseconds deletionLag{0};
+    long long deletedLastPass = 0;
+    bool budgetExhausted = false;
+};
+
+stdx::mutex ttlIndexStatsMutex;
+std::map<std::pair<std::string, std::string>, TTLIndexStats> ttlIndexStats;
+
+void setTTLIndexStats(const NamespaceString& nss, StringData indexName, TTLIndexStats stats) {
+    stdx::lock_guard<stdx::mutex> lk(ttlIndexStatsMutex);
+    ttlIndexStats[std::make_pair(nss.ns(), indexName.toString())] = std::move(stats);
+}
+
+/**
+ * Forgets the TTL indexes that are no longer in 'ttlIndexes'.
+ */
+void pruneTTLIndexStats(const std::vector<BSONObj>& ttlIndexes) {
+    std::set<std::pair<std::string, std::string>> current;
+    for (const BSONObj& idx : ttlIndexes) {
+        current.emplace(idx["ns"].String(), idx["name"].String());
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(ttlIndexStatsMutex);
+    for (auto it = ttlIndexStats.begin(); it != ttlIndexStats.end();) {
+        if (current.count(it->first)) {
+            ++it;
+        } else {
+            it = ttlIndexStats.erase(it);
+        }
+    }
+}
+
+class TTLServerStatusSection final : public ServerStatusSection {
+public:
+    TTLServerStatusSection() : ServerStatusSection("ttl") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* opCtx,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder result;
+        BSONArrayBuilder indexes(result.subarrayStart("indexes"));
+
+        stdx::lock_guard<stdx::mutex> lk(ttlIndexStatsMutex);
+        for (const auto& entry : ttlIndexStats) {
+            const TTLIndexStats& stats = entry.second;
+            BSONObjBuilder index(indexes.subobjStart());
+            index.append("ns", entry.first.first);
+            index.append("name", entry.first.second);
+            index.append("lastPass", stats.lastPass);
+            index.append("deletionLagMillis", durationCount<Milliseconds>(stats.deletionLag));
+            index.append("deletedLastPass", stats.deletedLastPass);
+            index.append("budgetExhausted", stats.budgetExhausted);
+        }
+        indexes.doneFast();
+
+        return result.obj();
+    }
+} ttlServerStatusSection;
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -123,6 +262,101 @@ public:
 
 private:
     void doTTLPass() {
+        std::vector<BSONObj> ttlIndexes = getTTLIndexes();
+        pruneTTLIndexStats(ttlIndexes);
+        if (ttlIndexes.empty()) {
+            return;
+        }
+
+        // Start where the last pass ran out of time, so that a time budget doesn't starve the
+        // indexes at the end of the list.
+        std::rotate(ttlIndexes.begin(),
+                    ttlIndexes.begin() + _nextIndexOffset % ttlIndexes.size(),
+                    ttlIndexes.end());
+
+        const int maxPassTimeMS = ttlMonitorMaxPassTimeMS.load();
+        const Date_t deadline =
+            maxPassTimeMS > 0 ? Date_t::now() + Milliseconds(maxPassTimeMS) : Date_t::max();
+
+        // Each worker claims the next index that no other worker has started on.
+        AtomicWord<size_t> nextIndex(0);
+        AtomicWord<size_t> numReached(0);
+        auto runWorker = [&] {
+            const ServiceContext::UniqueOperationContext opCtx = cc().makeOperationContext();
+            if (deadline != Date_t::max()) {
+                opCtx->setDeadlineByDate(deadline, ErrorCodes::ExceededTimeLimit);
+            }
+
+            for (size_t i = nextIndex.fetchAndAdd(1); i < ttlIndexes.size();
+                 i = nextIndex.fetchAndAdd(1)) {
+                if (Date_t::now() >= deadline) {
+                    return;
+                }
+                numReached.fetchAndAdd(1);
+
+                try {
+                    doTTLForIndex(opCtx.get(), ttlIndexes[i], deadline);
+                } catch (const DBException& dbex) {
+                    if (Date_t::now() >= deadline) {
+                        LOG(1) << "ran out of time processing ttl index: " << ttlIndexes[i];
+                        return;
+                    }
+                    error() << "Error processing ttl index: " << ttlIndexes[i] << " -- "
+                            << dbex.toString();
+                    // Continue on to the next index.
+                }
+            }
+        };
+
+        const size_t numWorkers =
+            std::min(static_cast<size_t>(ttlMonitorThreads.load()), ttlIndexes.size());
+
+        stdx::mutex mutex;
+        stdx::condition_variable workersFinished;
+        size_t numRunning = 0;
+
+        {
+            // The workers refer to this frame, so it can't be left, even by an exception, until
+            // they have all finished.
+            ON_BLOCK_EXIT([&] {
+                stdx::unique_lock<stdx::mutex> lk(mutex);
+                workersFinished.wait(lk, [&] { return numRunning == 0; });
+            });
+
+            for (size_t worker = 1; worker < numWorkers; ++worker) {
+                {
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    ++numRunning;
+                }
+                auto scheduleStatus = getTTLMonitorThreadPool()->schedule([&] {
+                    ON_BLOCK_EXIT([&] {
+                        stdx::lock_guard<stdx::mutex> lk(mutex);
+                        --numRunning;
+                        workersFinished.notify_all();
+                    });
+
+                    runWorker();
+                });
+
+                if (!scheduleStatus.isOK()) {
+                    // The workers already running, including this thread, pick up the slack.
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    --numRunning;
+                }
+            }
+
+            runWorker();
+        }
+
+        const size_t reached = numReached.load();
+        _nextIndexOffset = reached < ttlIndexes.size() ? _nextIndexOffset + reached : 0;
+    }
+
+    /**
+     * Returns the specs of the TTL indexes of every collection, or nothing if this node can't
+     * serve reads.
+     */
+    std::vector<BSONObj> getTTLIndexes() {
         const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
         OperationContext& opCtx = *opCtxPtr;
 
@@ -130,7 +364,7 @@ private:
         if (repl::ReplicationCoordinator::get(&opCtx)->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
             !repl::ReplicationCoordinator::get(&opCtx)->getMemberState().readable())
-            return;
+            return {};
 
         TTLCollectionCache& ttlCollectionCache = TTLCollectionCache::get(getGlobalServiceContext());
         std::vector<std::string> ttlCollections = ttlCollectionCache.getCollections();
@@ -160,22 +394,15 @@ private:
             }
         }
 
-        for (const BSONObj& idx : ttlIndexes) {
-            try {
-                doTTLForIndex(&opCtx, idx);
-            } catch (const DBException& dbex) {
-                error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
-                // Continue on to the next index.
-                continue;
-            }
-        }
+        return ttlIndexes;
     }
 
     /**
      * Remove documents from the collection using the specified TTL index after a sufficient amount
-     * of time has passed according to its expiry specification.
+     * of time has passed according to its expiry specification. Deletes at most
+     * ttlMonitorMaxDeletesPerIndexPerPass documents, and stops at 'deadline'.
      */
-    void doTTLForIndex(OperationContext* opCtx, BSONObj idx) {
+    void doTTLForIndex(OperationContext* opCtx, BSONObj idx, Date_t deadline) {
         const NamespaceString collectionNSS(idx["ns"].String());
         if (collectionNSS.isDropPendingNamespace()) {
             return;
@@ -252,10 +479,30 @@ private:
         auto canonicalQuery = CanonicalQuery::canonicalize(opCtx, std::move(qr));
         invariant(canonicalQuery.getStatus());
 
+        TTLIndexStats stats;
+        stats.lastPass = Date_t::now();
+
+        // The first key in the scan belongs to the document that expired the longest ago.
+        {
+            auto exec = InternalPlanner::indexScan(opCtx,
+                                                   collection,
+                                                   desc,
+                                                   startKey,
+                                                   endKey,
+                                                   BoundInclusion::kIncludeBothStartAndEndKeys,
+                                                   PlanExecutor::NO_YIELD,
+                                                   direction);
+            BSONObj oldestKey;
+            if (exec->getNext(&oldestKey, nullptr) == PlanExecutor::ADVANCED) {
+                stats.deletionLag = expirationTime - oldestKey.firstElement().date();
+            }
+        }
+
         DeleteStageParams params;
         params.isMulti = true;
         params.canonicalQuery = canonicalQuery.getValue().get();
 
+        const long long maxDeletes = ttlMonitorMaxDeletesPerIndexPerPass.load();
         auto exec =
             InternalPlanner::deleteWithIndexScan(opCtx,
                                                  collection,
@@ -265,19 +512,30 @@ private:
                                                  endKey,
                                                  BoundInclusion::kIncludeBothStartAndEndKeys,
                                                  PlanExecutor::YIELD_AUTO,
-                                                 direction);
+                                                 direction,
+                                                 maxDeletes);
 
         Status result = exec->executePlan();
-        if (!result.isOK()) {
+        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
+        ttlDeletedDocuments.increment(numDeleted);
+
+        stats.deletedLastPass = numDeleted;
+        stats.budgetExhausted = (maxDeletes > 0 && numDeleted >= maxDeletes) ||
+            (result == ErrorCodes::ExceededTimeLimit && Date_t::now() >= deadline);
+        setTTLIndexStats(collectionNSS, desc->indexName(), stats);
+
+        if (!result.isOK() && !stats.budgetExhausted) {
             error() << "ttl query execution for index " << idx
                     << " failed with status: " << redact(result);
             return;
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
-        ttlDeletedDocuments.increment(numDeleted);
-        LOG(1) << "deleted: " << numDeleted;
+        LOG(1) << "deleted: " << numDeleted
+               << (stats.budgetExhausted ? ", leaving the rest for the next pass" : "");
     }
+
+    // Where in the list of TTL indexes the next pass starts.
+    size_t _nextIndexOffset = 0;
 };
 
 namespace {
@@ -30,7 +30,7 @@
 
 #include "mongo/db/update/modifier_node.h"
 
-#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/bson/bsonobj_field_index.h"
 #include "mongo/db/update/path_support.h"
 #include "mongo/db/update/storage_validation.h"
 
@@ -56,6 +56,7 @@ void checkImmutablePathsNotModifiedFromOriginal(mutablebson::Element element,
                                                 FieldRef* pathTaken,
                                                 const FieldRefSet& immutablePaths,
                                                 BSONObj original) {
+    BSONObjFieldIndex originalFields(original);
     for (auto immutablePath = immutablePaths.begin(); immutablePath != immutablePaths.end();
          ++immutablePath) {
         auto prefixSize = pathTaken->commonPrefixSize(**immutablePath);
@@ -75,8 +76,7 @@ void checkImmutablePathsNotModifiedFromOriginal(mutablebson::Element element,
         // 'immutablePath'. We already know that 'pathTaken' is not equal to 'immutablePath', or we
         // would have uasserted.
         if (prefixSize == pathTaken->numParts()) {
-            auto oldElem = dotted_path_support::extractElementAtPath(
-                original, (*immutablePath)->dottedField());
+            auto oldElem = originalFields.extractElementAtPath((*immutablePath)->dottedField());
 
             // We are allowed to modify immutable paths that do not yet exist.
             if (!oldElem.ok()) {
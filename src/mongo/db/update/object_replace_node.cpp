@@ -31,7 +31,7 @@
 #include "mongo/db/update/object_replace_node.h"
 
 #include "mongo/base/data_view.h"
-#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/bson/bsonobj_field_index.h"
 #include "mongo/db/logical_clock.h"
 #include "mongo/db/logical_time.h"
 #include "mongo/db/service_context.h"
@@ -106,6 +106,7 @@ UpdateNode::ApplyResult ObjectReplaceNode::apply(ApplyParams applyParams) const
     }
 
     // Check immutable paths.
+    BSONObjFieldIndex originalFields(original);
     for (auto path = applyParams.immutablePaths.begin(); path != applyParams.immutablePaths.end();
          ++path) {
 
@@ -124,7 +125,7 @@ UpdateNode::ApplyResult ObjectReplaceNode::apply(ApplyParams applyParams) const
                     newElem.getType() != BSONType::Array);
         }
 
-        auto oldElem = dotted_path_support::extractElementAtPath(original, (*path)->dottedField());
+        auto oldElem = originalFields.extractElementAtPath((*path)->dottedField());
 
         uassert(ErrorCodes::ImmutableField,
                 str::stream() << "After applying the update, the '" << (*path)->dottedField()
@@ -30,6 +30,7 @@
 
 #include "mongo/db/update/pull_node.h"
 
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/copyable_match_expression.h"
 #include "mongo/db/query/collation/collator_interface.h"
 
@@ -45,7 +46,8 @@ public:
         : _matchExpr(matchCondition,
                      expCtx,
                      stdx::make_unique<ExtensionsCallbackNoop>(),
-                     MatchExpressionParser::kBanAllSpecialFeatures) {}
+                     MatchExpressionParser::kBanAllSpecialFeatures),
+          _compiledMatchExpr(CompiledMatchExpression::compile(&*_matchExpr)) {}
 
     std::unique_ptr<ElementMatcher> clone() const final {
         return stdx::make_unique<ObjectMatcher>(*this);
@@ -53,7 +55,8 @@ public:
 
     bool match(const mutablebson::ConstElement& element) final {
         if (element.getType() == mongo::Object) {
-            return _matchExpr->matchesBSON(element.getValueObject());
+            return _compiledMatchExpr ? _compiledMatchExpr->matchesBSON(element.getValueObject())
+                                      : _matchExpr->matchesBSON(element.getValueObject());
         } else {
             return false;
         }
@@ -65,6 +68,10 @@ public:
 
 private:
     CopyableMatchExpression _matchExpr;
+
+    // Shared by all copies, like the MatchExpression it was compiled from. Only the collator of
+    // the MatchExpression ever changes, which the compiled program does not depend on.
+    std::shared_ptr<const CompiledMatchExpression> _compiledMatchExpr;
 };
 
 /**
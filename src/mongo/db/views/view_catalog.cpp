@@ -84,6 +84,7 @@ Status ViewCatalog::_reloadIfNeeded_inlock(OperationContext* opCtx) {
 
     // Need to reload, first clear our cache.
     _viewMap.clear();
+    _resolvedViews.clear();
 
     Status status = _durable->iterate(opCtx, [&](const BSONObj& view) -> Status {
         BSONObj collationSpec = view.hasField("collation") ? view["collation"].Obj() : BSONObj();
@@ -159,8 +160,10 @@ Status ViewCatalog::_createOrUpdateView_inlock(OperationContext* opCtx,
 
     _durable->upsert(opCtx, viewName, viewDefBuilder.obj());
     _viewMap[viewName.ns()] = view;
+    _resolvedViews.clear();
     opCtx->recoveryUnit()->onRollback([this, viewName]() {
         this->_viewMap.erase(viewName.ns());
+        this->_resolvedViews.clear();
         this->_viewGraphNeedsRefresh = true;
     });
 
@@ -389,9 +392,11 @@ Status ViewCatalog::dropView(OperationContext* opCtx, const NamespaceString& vie
     _durable->remove(opCtx, viewName);
     _viewGraph.remove(savedDefinition.name());
     _viewMap.erase(viewName.ns());
+    _resolvedViews.clear();
     opCtx->recoveryUnit()->onRollback([this, viewName, savedDefinition]() {
         this->_viewGraphNeedsRefresh = true;
         this->_viewMap[viewName.ns()] = std::make_shared<ViewDefinition>(savedDefinition);
+        this->_resolvedViews.clear();
     });
 
     // We may get invalidated, but we're exclusively locked, so the change must be ours.
@@ -465,6 +470,15 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                 break;
             }
 
+            // Any change to the view definitions clears the cache, so a hit here is as good as
+            // walking the chain again.
+            if (depth == 0) {
+                auto cached = _resolvedViews.find(nss.ns());
+                if (cached != _resolvedViews.end()) {
+                    return cached->second;
+                }
+            }
+
             auto view = _lookup_inlock(opCtx, resolvedNss->ns());
             if (!view) {
                 // Return error status if pipeline is too large.
@@ -477,8 +491,10 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
                             str::stream() << "View pipeline exceeds maximum size; maximum size is "
                                           << ViewGraph::kMaxViewPipelineSizeBytes};
                 }
-                return StatusWith<ResolvedView>(
-                    {*resolvedNss, std::move(resolvedPipeline), std::move(collation.get())});
+                return _cacheResolvedView_inlock(nss,
+                                                 {*resolvedNss,
+                                                  std::move(resolvedPipeline),
+                                                  std::move(collation.get())});
             }
 
             resolvedNss = &view->viewOn();
@@ -493,8 +509,10 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
 
             // If the first stage is a $collStats, then we return early with the viewOn namespace.
             if (toPrepend.size() > 0 && !toPrepend[0]["$collStats"].eoo()) {
-                return StatusWith<ResolvedView>(
-                    {*resolvedNss, std::move(resolvedPipeline), std::move(collation.get())});
+                return _cacheResolvedView_inlock(nss,
+                                                 {*resolvedNss,
+                                                  std::move(resolvedPipeline),
+                                                  std::move(collation.get())});
             }
         }
 
@@ -506,4 +524,11 @@ StatusWith<ResolvedView> ViewCatalog::resolveView(OperationContext* opCtx,
     };
     MONGO_UNREACHABLE;
 }
+
+ResolvedView ViewCatalog::_cacheResolvedView_inlock(const NamespaceString& nss,
+                                                    ResolvedView resolved) {
+    _resolvedViews.erase(nss.ns());
+    _resolvedViews.try_emplace(nss.ns(), resolved);
+    return resolved;
+}
 }  // namespace mongo
@@ -163,6 +163,11 @@ private:
                                      const std::vector<NamespaceString>& refs);
 
     std::shared_ptr<ViewDefinition> _lookup_inlock(OperationContext* opCtx, StringData ns);
+
+    /**
+     * Remembers 'resolved' as the resolution of the view 'nss' and returns it.
+     */
+    ResolvedView _cacheResolvedView_inlock(const NamespaceString& nss, ResolvedView resolved);
     Status _reloadIfNeeded_inlock(OperationContext* opCtx);
 
     void _requireValidCatalog_inlock(OperationContext* opCtx) {
@@ -172,6 +177,8 @@ private:
 
     stdx::mutex _mutex;  // Protects all members, except for _valid.
     ViewMap _viewMap;
+    // Results of resolveView(), by view namespace. Cleared whenever _viewMap changes.
+    StringMap<ResolvedView> _resolvedViews;
     DurableViewCatalog* _durable;
     AtomicBool _valid;
     ViewGraph _viewGraph;
@@ -529,6 +529,44 @@ TEST_F(ViewCatalogFixture, ResolveViewCorrectPipeline) {
     }
 }
 
+TEST_F(ViewCatalogFixture, ResolveViewAfterModifyReturnsNewPipeline) {
+    const NamespaceString view1("db.view1");
+    const NamespaceString view2("db.view2");
+    const NamespaceString viewOn("db.coll");
+    BSONArrayBuilder pipeline1;
+    BSONArrayBuilder pipeline2;
+    BSONArrayBuilder modifiedPipeline;
+
+    pipeline1 << BSON("$match" << BSON("foo" << 1));
+    pipeline2 << BSON("$match" << BSON("foo" << 2));
+    modifiedPipeline << BSON("$match" << BSON("foo" << 3));
+
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view1, viewOn, pipeline1.arr(), emptyCollation));
+    ASSERT_OK(viewCatalog.createView(opCtx.get(), view2, view1, pipeline2.arr(), emptyCollation));
+
+    // Resolve twice so that the second call can be answered from the cache.
+    for (int i = 0; i < 2; ++i) {
+        auto resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+        ASSERT_OK(resolvedView.getStatus());
+        ASSERT_EQ(viewOn, resolvedView.getValue().getNamespace());
+        ASSERT_EQ(2U, resolvedView.getValue().getPipeline().size());
+    }
+
+    // Changing a view further down the chain must be reflected in the resolution.
+    ASSERT_OK(viewCatalog.modifyView(opCtx.get(), view1, viewOn, modifiedPipeline.arr()));
+    auto resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_BSONOBJ_EQ(BSON("$match" << BSON("foo" << 3)),
+                      resolvedView.getValue().getPipeline()[0]);
+
+    // Dropping the view at the end of the chain makes the next one resolve to the view itself.
+    ASSERT_OK(viewCatalog.dropView(opCtx.get(), view1));
+    resolvedView = viewCatalog.resolveView(opCtx.get(), view2);
+    ASSERT_OK(resolvedView.getStatus());
+    ASSERT_EQ(view1, resolvedView.getValue().getNamespace());
+    ASSERT_EQ(1U, resolvedView.getValue().getPipeline().size());
+}
+
 TEST_F(ViewCatalogFixture, ResolveViewCorrectlyExtractsDefaultCollation) {
     const NamespaceString view1("db.view1");
     const NamespaceString view2("db.view2");
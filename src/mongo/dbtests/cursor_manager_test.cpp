@@ -526,6 +526,48 @@ TEST_F(CursorManagerTest, CursorShouldNotTimeOutUntilIdleForLongEnoughAfterBeing
     ASSERT_EQ(0UL, cursorManager->numCursors());
 }
 
+/**
+ * Test that timing out still finds idle cursors after many other cursors were destroyed without
+ * timing out, and that it only destroys the ones that have been idle long enough.
+ */
+TEST_F(CursorManagerTest, CursorsTimeOutAfterChurnOfDestroyedCursors) {
+    CursorManager* cursorManager = useCursorManager();
+    auto clock = useClock();
+
+    for (int i = 0; i < 500; ++i) {
+        auto cursorPin = cursorManager->registerCursor(_opCtx.get(),
+                                                       {makeFakePlanExecutor(),
+                                                        kTestNss,
+                                                        {},
+                                                        repl::ReadConcernLevel::kLocalReadConcern,
+                                                        BSONObj()});
+        cursorPin.deleteUnderlying();
+    }
+    ASSERT_EQ(0UL, cursorManager->numCursors());
+
+    cursorManager->registerCursor(_opCtx.get(),
+                                  {makeFakePlanExecutor(),
+                                   kTestNss,
+                                   {},
+                                   repl::ReadConcernLevel::kLocalReadConcern,
+                                   BSONObj()});
+    clock->advance(Milliseconds(1));
+    cursorManager->registerCursor(_opCtx.get(),
+                                  {makeFakePlanExecutor(),
+                                   kTestNss,
+                                   {},
+                                   repl::ReadConcernLevel::kLocalReadConcern,
+                                   BSONObj()});
+
+    clock->advance(getDefaultCursorTimeoutMillis() - Milliseconds(1));
+    ASSERT_EQ(1UL, cursorManager->timeoutCursors(_opCtx.get(), clock->now()));
+    ASSERT_EQ(1UL, cursorManager->numCursors());
+
+    clock->advance(Milliseconds(1));
+    ASSERT_EQ(1UL, cursorManager->timeoutCursors(_opCtx.get(), clock->now()));
+    ASSERT_EQ(0UL, cursorManager->numCursors());
+}
+
 /**
  * Test that cursors inherit the logical session id from their operation context
  */
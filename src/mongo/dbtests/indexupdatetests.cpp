@@ -30,18 +30,25 @@
 
 #include "mongo/platform/basic.h"
 
+#include <boost/filesystem/operations.hpp>
 #include <cstdint>
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/catalog/index_create.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_engine_init.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/fail_point_service.h"
+#include "mongo/util/scopeguard.h"
 
 namespace IndexUpdateTests {
 
@@ -387,6 +394,291 @@ Status IndexBuildBase::createIndex(const std::string& dbname, const BSONObj& ind
     return Status::OK();
 }
 
+/** A foreground build which generates keys on several threads indexes every document. */
+class InsertBuildParallelKeyGeneration : public IndexBuildBase {
+public:
+    void run() {
+        auto parameter =
+            ServerParameterSet::getGlobal()->getMap().find("maxIndexBuildKeyGenerationThreads")
+                ->second;
+        ON_BLOCK_EXIT([&] { ASSERT_OK(parameter->setFromString("1")); });
+        ASSERT_OK(parameter->setFromString("4"));
+
+        // Enough documents to fill several batches.
+        const int nDocs = 25 * 1000;
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            _ctx.db()->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = _ctx.db()->createCollection(&_opCtx, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < nDocs; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx,
+                    InsertStatement(BSON("_id" << i << "a" << i % 100 << "b"
+                                               << BSON_ARRAY(i << i + 1))),
+                    nullOpDebug,
+                    true));
+            }
+            wunit.commit();
+        }
+
+        auto makeSpec = [&](StringData name, const BSONObj& key) {
+            return BSON("name" << name << "ns" << coll->ns().ns() << "key" << key << "v"
+                               << static_cast<int>(kIndexVersion));
+        };
+        const std::vector<BSONObj> specs{
+            makeSpec("a_1", BSON("a" << 1)),
+            makeSpec("b_1", BSON("b" << 1)),
+            makeSpec("a_-1_b_1", BSON("a" << -1 << "b" << 1)),
+            makeSpec("partial_a_1", BSON("a" << 1 << "_id" << 1))
+                .addField(BSON("partialFilterExpression" << BSON("a" << BSON("$lt" << 50)))
+                              .firstElement())};
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        ASSERT_OK(indexer.init(specs).getStatus());
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        auto countWithHint = [&](const BSONObj& filter, const BSONObj& hint) {
+            return _client.query(NamespaceString(_ns), Query(filter).hint(hint))->itcount();
+        };
+        ASSERT_EQ(nDocs, countWithHint(BSONObj(), BSON("a" << 1)));
+        ASSERT_EQ(nDocs, countWithHint(BSONObj(), BSON("b" << 1)));
+        ASSERT_EQ(nDocs, countWithHint(BSONObj(), BSON("a" << -1 << "b" << 1)));
+        ASSERT_EQ(nDocs / 2,
+                  countWithHint(BSON("a" << BSON("$lt" << 50)), BSON("a" << 1 << "_id" << 1)));
+
+        IndexCatalog* indexCatalog = coll->getIndexCatalog();
+        ASSERT_FALSE(
+            indexCatalog->isMultikey(&_opCtx, indexCatalog->findIndexByName(&_opCtx, "a_1")));
+        ASSERT_TRUE(
+            indexCatalog->isMultikey(&_opCtx, indexCatalog->findIndexByName(&_opCtx, "b_1")));
+    }
+};
+
+/** Writes that arrive during a hybrid background build are applied from the side table. */
+class InsertBuildHybridSideWrites : public IndexBuildBase {
+public:
+    void run() {
+        const int nDocs = 100;
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            _ctx.db()->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = _ctx.db()->createCollection(&_opCtx, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < nDocs; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx, InsertStatement(BSON("_id" << i << "a" << i)), nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        indexer.allowBackgroundBuilding();
+        indexer.allowInterruption();
+
+        const BSONObj spec = BSON("name"
+                                  << "a_1"
+                                  << "ns"
+                                  << coll->ns().ns()
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion)
+                                  << "background"
+                                  << true);
+        ASSERT_OK(indexer.init(spec).getStatus());
+
+        // These writes race with the collection scan and are recorded on the side.
+        _client.insert(_ns, BSON("_id" << nDocs << "a" << nDocs));
+        _client.update(_ns, BSON("_id" << 0), BSON("$set" << BSON("a" << -1)));
+        _client.remove(_ns, BSON("_id" << 1));
+
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        auto countWithHint = [&](const BSONObj& filter) {
+            return _client.query(NamespaceString(_ns), Query(filter).hint(BSON("a" << 1)))
+                ->itcount();
+        };
+        ASSERT_EQ(nDocs, countWithHint(BSONObj()));
+        ASSERT_EQ(1, countWithHint(BSON("a" << -1)));
+        ASSERT_EQ(1, countWithHint(BSON("a" << nDocs)));
+        ASSERT_EQ(0, countWithHint(BSON("a" << 0)));
+        ASSERT_EQ(0, countWithHint(BSON("a" << 1)));
+    }
+};
+
+/**
+ * Writes made after the collection scan has been drained are applied by the drain in commit(),
+ * removing the keys the bulk load inserted for documents that have changed since.
+ */
+class InsertBuildHybridWritesAfterDrain : public IndexBuildBase {
+public:
+    void run() {
+        const int nDocs = 100;
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            _ctx.db()->dropCollection(&_opCtx, _ns).transitional_ignore();
+            coll = _ctx.db()->createCollection(&_opCtx, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < nDocs; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx, InsertStatement(BSON("_id" << i << "a" << i)), nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_opCtx, coll);
+        indexer.allowBackgroundBuilding();
+        indexer.allowInterruption();
+
+        const BSONObj spec = BSON("name"
+                                  << "a_1"
+                                  << "ns"
+                                  << coll->ns().ns()
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "v"
+                                  << static_cast<int>(kIndexVersion)
+                                  << "background"
+                                  << true);
+        ASSERT_OK(indexer.init(spec).getStatus());
+
+        // Bulk loads a key for every document, then drains the (empty) side table.
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+
+        // These writes come after the drain and are left for commit(). The update and the delete
+        // leave stale keys in the bulk loaded index, and the last document is inserted and
+        // deleted again, so its side writes must be applied in order.
+        _client.update(_ns, BSON("_id" << 0), BSON("$set" << BSON("a" << -1)));
+        _client.remove(_ns, BSON("_id" << 1));
+        _client.insert(_ns, BSON("_id" << nDocs << "a" << nDocs));
+        _client.insert(_ns, BSON("_id" << nDocs + 1 << "a" << nDocs + 1));
+        _client.remove(_ns, BSON("_id" << nDocs + 1));
+
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        auto countWithHint = [&](const BSONObj& filter) {
+            return _client.query(NamespaceString(_ns), Query(filter).hint(BSON("a" << 1)))
+                ->itcount();
+        };
+        ASSERT_EQ(nDocs, countWithHint(BSONObj()));
+        ASSERT_EQ(1, countWithHint(BSON("a" << -1)));
+        ASSERT_EQ(0, countWithHint(BSON("a" << 0)));
+        ASSERT_EQ(0, countWithHint(BSON("a" << 1)));
+        ASSERT_EQ(1, countWithHint(BSON("a" << nDocs)));
+        ASSERT_EQ(0, countWithHint(BSON("a" << nDocs + 1)));
+    }
+};
+
+/**
+ * A foreground build interrupted after a checkpoint picks the scan up where the checkpoint left
+ * off when it is retried after a restart.
+ */
+class InsertBuildResumeFromCheckpoint {
+public:
+    void run() {
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+        if (opCtx.getServiceContext()->getStorageEngine()->isEphemeral()) {
+            // Builds on an ephemeral storage engine do not checkpoint.
+            return;
+        }
+
+        // Closing the database to simulate a restart requires the global lock.
+        Lock::GlobalWrite lk(&opCtx);
+        DBDirectClient client(&opCtx);
+        client.dropCollection(_ns);
+        ON_BLOCK_EXIT([&] { client.dropCollection(_ns); });
+
+        const int nDocs = 100;
+        for (int i = 0; i < nDocs; ++i) {
+            client.insert(_ns, BSON("_id" << i << "a" << i));
+        }
+
+        // The first attempt stops after scanning 60 documents. A retry which resumed from its
+        // checkpoint scans only the remaining 40, so it completes, whereas a retry which started
+        // over would be interrupted again.
+        const int nDocsBeforeInterrupt = 60;
+        FailPoint* failPoint =
+            getGlobalFailPointRegistry()->getFailPoint("checkpointAndInterruptIndexBuild");
+        failPoint->setMode(FailPoint::alwaysOn, 0, BSON("numDocs" << nDocsBeforeInterrupt));
+        ON_BLOCK_EXIT([&] { failPoint->setMode(FailPoint::off); });
+
+        std::string checkpointDir;
+        {
+            Collection* coll = DatabaseHolder::getDatabaseHolder()
+                                   .get(&opCtx, _ns)
+                                   ->getCollection(&opCtx, _ns);
+            ASSERT(coll->uuid());
+            checkpointDir = str::stream() << storageGlobalParams.dbpath << "/"
+                                          << kIndexBuildCheckpointsDirName << "/"
+                                          << coll->uuid()->toString();
+
+            MultiIndexBlock indexer(&opCtx, coll);
+            const BSONObj spec = BSON("v" << static_cast<int>(kIndexVersion) << "key"
+                                          << BSON("a" << 1)
+                                          << "name"
+                                          << "a_1"
+                                          << "ns"
+                                          << _ns);
+            ASSERT_OK(indexer.init(spec).getStatus());
+            ASSERT_EQ(ErrorCodes::Interrupted, indexer.insertAllDocumentsInCollection());
+
+            // Leave the unfinished index and its checkpoint behind, as a crash would.
+            indexer.abortWithoutCleanup();
+        }
+        ASSERT(boost::filesystem::exists(checkpointDir + "/checkpoint"));
+
+        DatabaseHolder::getDatabaseHolder().close(&opCtx, _ns, "simulating a restart");
+        Collection* coll =
+            DatabaseHolder::getDatabaseHolder().openDb(&opCtx, _ns)->getCollection(&opCtx, _ns);
+
+        // Retry the build the way the index rebuilder does at startup.
+        MultiIndexBlock indexer(&opCtx, coll);
+        indexer.allowResumingFromCheckpoint();
+        {
+            WriteUnitOfWork wunit(&opCtx);
+            const std::vector<BSONObj> specs =
+                coll->getIndexCatalog()->getAndClearUnfinishedIndexes(&opCtx);
+            ASSERT_EQ(1U, specs.size());
+            ASSERT_OK(indexer.init(specs).getStatus());
+            wunit.commit();
+        }
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+        {
+            WriteUnitOfWork wunit(&opCtx);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        ASSERT_EQ(nDocs,
+                  client.query(NamespaceString(_ns), Query().hint(BSON("a" << 1)))->itcount());
+        ASSERT_EQ(1,
+                  client.query(NamespaceString(_ns), Query(BSON("a" << 0)).hint(BSON("a" << 1)))
+                      ->itcount());
+    }
+};
+
 /**
  * Fixture class that has a basic compound index.
  */
@@ -769,6 +1061,10 @@ public:
         add<InsertBuildIndexInterruptDisallowed>();
         add<InsertBuildIdIndexInterrupt>();
         add<InsertBuildIdIndexInterruptDisallowed>();
+        add<InsertBuildParallelKeyGeneration>();
+        add<InsertBuildHybridSideWrites>();
+        add<InsertBuildHybridWritesAfterDrain>();
+        add<InsertBuildResumeFromCheckpoint>();
         add<SameSpecDifferentOption>();
         add<SameSpecSameOptions>();
         add<DifferentSpecSameName>();
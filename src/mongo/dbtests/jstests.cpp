@@ -41,6 +41,7 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/hasher.h"
 #include "mongo/db/json.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/platform/decimal128.h"
 #include "mongo/scripting/engine.h"
@@ -48,6 +49,7 @@
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/future.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
 
@@ -1057,6 +1059,61 @@ private:
 };
 
 
+/** The idle scopes kept by getPooledScope() are bounded overall and per database. */
+class PooledScopesAreBounded {
+public:
+    void run() {
+        const auto& parameters = ServerParameterSet::getGlobal()->getMap();
+        auto maxPooled = parameters.find("maxPooledJavaScriptScopes")->second;
+        auto maxPooledPerDb = parameters.find("maxPooledJavaScriptScopesPerDatabase")->second;
+        ON_BLOCK_EXIT([&] {
+            ASSERT_OK(maxPooled->setFromString("32"));
+            ASSERT_OK(maxPooledPerDb->setFromString("8"));
+            ScriptEngine::dropScopeCache();
+        });
+        ASSERT_OK(maxPooled->setFromString("4"));
+        ASSERT_OK(maxPooledPerDb->setFromString("2"));
+        ScriptEngine::dropScopeCache();
+
+        const ServiceContext::UniqueOperationContext opCtxPtr = cc().makeOperationContext();
+        OperationContext& opCtx = *opCtxPtr;
+
+        // Uses 'n' scopes of 'db' at once and returns them to the pool.
+        auto useScopes = [&](const std::string& db, int n) {
+            std::vector<std::unique_ptr<Scope>> scopes;
+            for (int i = 0; i < n; ++i) {
+                scopes.push_back(getGlobalScriptEngine()->getPooledScope(&opCtx, db, "test"));
+            }
+        };
+
+        useScopes("pooledScopesA", 3);
+        ASSERT_EQ(2U, ScriptEngine::getNumPooledScopes_forTest("pooledScopesA"));
+
+        // Another database gets its own share.
+        useScopes("pooledScopesB", 3);
+        ASSERT_EQ(2U, ScriptEngine::getNumPooledScopes_forTest("pooledScopesA"));
+        ASSERT_EQ(2U, ScriptEngine::getNumPooledScopes_forTest("pooledScopesB"));
+
+        // Once the pool is full, the least recently used scope of any database is evicted.
+        useScopes("pooledScopesC", 1);
+        ASSERT_EQ(1U, ScriptEngine::getNumPooledScopes_forTest("pooledScopesA"));
+        ASSERT_EQ(2U, ScriptEngine::getNumPooledScopes_forTest("pooledScopesB"));
+        ASSERT_EQ(1U, ScriptEngine::getNumPooledScopes_forTest("pooledScopesC"));
+
+        // A pooled scope is handed out again rather than a new one being created.
+        {
+            auto scope = getGlobalScriptEngine()->getPooledScope(&opCtx, "pooledScopesB", "test");
+            ASSERT_EQ(1U, ScriptEngine::getNumPooledScopes_forTest("pooledScopesB"));
+        }
+        ASSERT_EQ(2U, ScriptEngine::getNumPooledScopes_forTest("pooledScopesB"));
+
+        // A limit of 0 disables pooling.
+        ASSERT_OK(maxPooledPerDb->setFromString("0"));
+        useScopes("pooledScopesD", 1);
+        ASSERT_EQ(0U, ScriptEngine::getNumPooledScopes_forTest("pooledScopesD"));
+    }
+};
+
 class BinDataType {
 public:
     void pp(const char* s, BSONElement e) {
@@ -1506,6 +1563,7 @@ public:
         add<VarTests>();
         add<Speed1>();
         add<Utf8Check>();
+        add<PooledScopesAreBounded>();
         add<ScopeOut>();
         add<NovelNaN>();
         add<NoReturnSpecified>();
@@ -194,8 +194,18 @@ mongo::BSONArray MockRemoteDBServer::query(MockRemoteDBServer::InstanceID id,
 
     auto ns = nsOrUuid.uuid() ? _uuidToNs[*nsOrUuid.uuid()] : nsOrUuid.nss()->ns();
     const vector<BSONObj>& coll = _dataMgr[ns];
+    const BSONObj minKey = query.obj["$min"].isABSONObj() ? query.obj["$min"].Obj() : BSONObj();
+    const BSONObj maxKey = query.obj["$max"].isABSONObj() ? query.obj["$max"].Obj() : BSONObj();
     BSONArrayBuilder result;
     for (vector<BSONObj>::const_iterator iter = coll.begin(); iter != coll.end(); ++iter) {
+        if (!minKey.isEmpty() &&
+            iter->extractFieldsUnDotted(minKey).woCompare(minKey, BSONObj(), false) < 0) {
+            continue;
+        }
+        if (!maxKey.isEmpty() &&
+            iter->extractFieldsUnDotted(maxKey).woCompare(maxKey, BSONObj(), false) >= 0) {
+            continue;
+        }
         result.append(iter->copy());
     }
 
@@ -159,6 +159,10 @@ public:
     //
     rpc::UniqueReply runCommand(InstanceID id, const OpMsgRequest& request);
 
+    /**
+     * Returns the documents of the collection within the $min and $max bounds of 'query', if any.
+     * The filter is ignored.
+     */
     mongo::BSONArray query(InstanceID id,
                            const NamespaceStringOrUUID& nsOrUuid,
                            mongo::Query query = mongo::Query(),
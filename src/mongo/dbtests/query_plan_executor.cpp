@@ -39,8 +39,10 @@
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/limit.h"
 #include "mongo/db/exec/pipeline_proxy.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
@@ -344,6 +346,56 @@ TEST_F(PlanExecutorTest, ShouldReportErrorIfKilledDuringYield) {
     ASSERT_EQ(ErrorCodes::QueryPlanKilled, WorkingSetCommon::getMemberObjectStatus(resultObj));
 }
 
+/**
+ * Returns a stage which produces the documents {_id: 0}, ..., {_id: nDocs - 1} and then fails.
+ * Worked in a batch, it reports the failure on the call after the documents.
+ */
+unique_ptr<QueuedDataStage> makeStageThatFailsAfter(OperationContext* opCtx,
+                                                    WorkingSet* ws,
+                                                    int nDocs) {
+    auto stage = make_unique<QueuedDataStage>(opCtx, ws);
+    for (int i = 0; i < nDocs; ++i) {
+        WorkingSetID id = ws->allocate();
+        WorkingSetMember* member = ws->get(id);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("_id" << i));
+        member->transitionToOwnedObj();
+        stage->pushBack(id);
+    }
+    stage->pushBack(PlanStage::FAILURE);
+    return stage;
+}
+
+TEST_F(PlanExecutorTest, ShouldNotReportEOFWhileABatchedFailureIsPending) {
+    auto ws = make_unique<WorkingSet>();
+    auto root = makeStageThatFailsAfter(&_opCtx, ws.get(), 2);
+    auto exec = unittest::assertGet(PlanExecutor::make(
+        &_opCtx, std::move(ws), std::move(root), nss, PlanExecutor::YieldPolicy::NO_YIELD));
+
+    BSONObj resultObj;
+    ASSERT_EQ(PlanExecutor::ADVANCED, exec->getNext(&resultObj, nullptr));
+    ASSERT_EQ(PlanExecutor::ADVANCED, exec->getNext(&resultObj, nullptr));
+
+    // The stage has run out of queued results, but has yet to report its failure.
+    ASSERT_FALSE(exec->isEOF());
+    ASSERT_EQ(PlanExecutor::FAILURE, exec->getNext(&resultObj, nullptr));
+}
+
+TEST_F(PlanExecutorTest, ShouldNotReportEOFWhileABatchedFailureIsPendingBelowTheRoot) {
+    auto ws = make_unique<WorkingSet>();
+    auto child = makeStageThatFailsAfter(&_opCtx, ws.get(), 2);
+    auto root = make_unique<LimitStage>(&_opCtx, 10, ws.get(), child.release());
+    auto exec = unittest::assertGet(PlanExecutor::make(
+        &_opCtx, std::move(ws), std::move(root), nss, PlanExecutor::YieldPolicy::NO_YIELD));
+
+    BSONObj resultObj;
+    ASSERT_EQ(PlanExecutor::ADVANCED, exec->getNext(&resultObj, nullptr));
+    ASSERT_EQ(PlanExecutor::ADVANCED, exec->getNext(&resultObj, nullptr));
+
+    // The failure is held by the limit's child, which is out of queued results.
+    ASSERT_FALSE(exec->isEOF());
+    ASSERT_EQ(PlanExecutor::FAILURE, exec->getNext(&resultObj, nullptr));
+}
+
 class PlanExecutorSnapshotTest : public PlanExecutorTest {
 protected:
     void setupCollection() {
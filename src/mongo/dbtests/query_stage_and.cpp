@@ -1087,6 +1087,54 @@ public:
     }
 };
 
+// A child that falls far behind the other seeks ahead instead of reading every key in between.
+class QueryStageAndSortedSkipsAhead : public QueryStageAndBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        // Every document matches foo == 1, but only every 20th matches bar == 1.
+        for (int i = 0; i < 200; ++i) {
+            insert(BSON("foo" << 1 << "bar" << (i % 20 == 0 ? 1 : 0)));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+
+        WorkingSet ws;
+        auto ah = make_unique<AndSortedStage>(&_opCtx, &ws, coll);
+
+        // foo == 1
+        auto params = makeIndexScanParams(&_opCtx, getIndex(BSON("foo" << 1), coll));
+        params.bounds.startKey = BSON("" << 1);
+        params.bounds.endKey = BSON("" << 1);
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        // bar == 1
+        params = makeIndexScanParams(&_opCtx, getIndex(BSON("bar" << 1), coll));
+        params.bounds.startKey = BSON("" << 1);
+        params.bounds.endKey = BSON("" << 1);
+        ah->addChild(new IndexScan(&_opCtx, params, &ws, NULL));
+
+        ASSERT_EQUALS(10, countResults(ah.get()));
+
+        auto stats = ah->getStats();
+        auto andStats = static_cast<const AndSortedStats*>(stats->specific.get());
+        ASSERT_GT(andStats->skips, 0U);
+
+        // Without skipping, the scan over foo would read all 200 keys.
+        auto fooStats = static_cast<const IndexScanStats*>(stats->children[0]->specific.get());
+        ASSERT_LT(fooStats->keysExamined, 100U);
+    }
+};
+
 // An AND with an index scan that returns nothing.
 class QueryStageAndSortedWithNothing : public QueryStageAndBase {
 public:
@@ -1351,6 +1399,7 @@ public:
         add<QueryStageAndHashDeadChild>();
         add<QueryStageAndSortedDeleteDuringYield>();
         add<QueryStageAndSortedThreeLeaf>();
+        add<QueryStageAndSortedSkipsAhead>();
         add<QueryStageAndSortedWithNothing>();
         add<QueryStageAndSortedProducesNothing>();
         add<QueryStageAndSortedByLastChild>();
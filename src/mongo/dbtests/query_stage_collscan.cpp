@@ -40,6 +40,7 @@
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/collection_scan.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/namespace_string.h"
@@ -390,6 +391,71 @@ public:
     }
 };
 
+//
+// Asking for read-ahead never changes the results of a scan. Only forward scans read ahead, and
+// every record a scan returns counts as either a read-ahead hit or a stall.
+//
+
+class QueryStageCollscanReadAheadBase : public QueryStageCollectionScanBase {
+protected:
+    void scanWithReadAhead(CollectionScanParams::Direction direction) {
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+
+        CollectionScanParams params;
+        params.collection = ctx.getCollection();
+        params.direction = direction;
+        params.tailable = false;
+        params.readAheadRecords = 10;
+
+        unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
+        unique_ptr<PlanStage> ps = make_unique<CollectionScan>(&_opCtx, params, ws.get(), nullptr);
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_opCtx, std::move(ws), std::move(ps), params.collection, PlanExecutor::NO_YIELD);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        auto exec = std::move(statusWithPlanExecutor.getValue());
+
+        int count = 0;
+        PlanExecutor::ExecState state;
+        for (BSONObj obj; PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL));) {
+            const int expected =
+                (direction == CollectionScanParams::FORWARD) ? count : numObj() - count - 1;
+            ASSERT_EQUALS(expected, obj["foo"].numberInt());
+            ++count;
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
+        ASSERT_EQUALS(numObj(), count);
+
+        auto stats = exec->getRootStage()->getStats();
+        auto spec = static_cast<const CollectionScanStats*>(stats->specific.get());
+        if (direction == CollectionScanParams::BACKWARD) {
+            ASSERT_FALSE(spec->readAhead);
+        }
+
+        // Storage engines which cannot read ahead leave it off.
+        if (spec->readAhead) {
+            ASSERT_EQUALS(numObj(), spec->readAheadHits + spec->readAheadStalls);
+        } else {
+            ASSERT_EQUALS(0, spec->readAheadHits);
+            ASSERT_EQUALS(0, spec->readAheadStalls);
+        }
+    }
+};
+
+class QueryStageCollscanReadAheadForward : public QueryStageCollscanReadAheadBase {
+public:
+    void run() {
+        scanWithReadAhead(CollectionScanParams::FORWARD);
+    }
+};
+
+class QueryStageCollscanReadAheadBackward : public QueryStageCollscanReadAheadBase {
+public:
+    void run() {
+        scanWithReadAhead(CollectionScanParams::BACKWARD);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("QueryStageCollectionScan") {}
@@ -404,6 +470,8 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanDeleteUpcomingObject>();
         add<QueryStageCollscanDeleteUpcomingObjectBackward>();
+        add<QueryStageCollscanReadAheadForward>();
+        add<QueryStageCollscanReadAheadBackward>();
     }
 };
 
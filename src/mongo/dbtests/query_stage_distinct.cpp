@@ -309,6 +309,56 @@ public:
 // XXX: add a test case with bounds where skipping to the next key gets us a result that's not
 // valid w.r.t. our query.
 
+// Tests that distinct reaches the next value without seeking when there are few duplicates.
+class QueryStageDistinctFewDuplicates : public DistinctBase {
+public:
+    void run() {
+        // Insert two documents for each value of 'a'.
+        for (int i = 0; i < 10; ++i) {
+            insert(BSON("a" << i));
+            insert(BSON("a" << i));
+        }
+
+        addIndex(BSON("a" << 1));
+
+        AutoGetCollectionForReadCommand ctx(&_opCtx, nss);
+        Collection* coll = ctx.getCollection();
+
+        std::vector<IndexDescriptor*> indexes;
+        coll->getIndexCatalog()->findIndexesByKeyPattern(&_opCtx, BSON("a" << 1), false, &indexes);
+        ASSERT_EQ(indexes.size(), 1U);
+
+        DistinctParams params;
+        params.descriptor = indexes[0];
+        params.direction = 1;
+        params.fieldNo = 0;
+        params.bounds.isSimpleRange = false;
+        OrderedIntervalList oil("a");
+        oil.intervals.push_back(IndexBoundsBuilder::allValues());
+        params.bounds.fields.push_back(oil);
+
+        WorkingSet ws;
+        DistinctScan distinct(&_opCtx, params, &ws);
+
+        WorkingSetID wsid;
+        PlanStage::StageState state;
+        int expected = 0;
+        while (PlanStage::IS_EOF != (state = distinct.work(&wsid))) {
+            if (PlanStage::ADVANCED == state) {
+                ASSERT_EQUALS(expected++, getIntFieldDotted(ws, wsid, "a"));
+            }
+        }
+        ASSERT_EQUALS(10, expected);
+
+        // Only the initial seek is needed; every other value is reached by stepping over the
+        // duplicate of the previous one.
+        const DistinctScanStats* stats =
+            static_cast<const DistinctScanStats*>(distinct.getSpecificStats());
+        ASSERT_EQUALS(1U, stats->seeks);
+        ASSERT_EQUALS(20U, stats->keysExamined);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_distinct") {}
@@ -317,6 +367,7 @@ public:
         add<QueryStageDistinctBasic>();
         add<QueryStageDistinctMultiKey>();
         add<QueryStageDistinctCompoundIndex>();
+        add<QueryStageDistinctFewDuplicates>();
     }
 };
 
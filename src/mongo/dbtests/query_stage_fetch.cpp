@@ -219,6 +219,65 @@ public:
     }
 };
 
+//
+// Test that the documents passing the filter are trimmed to the fields to return.
+//
+class FetchStageFieldsToReturn : public QueryStageFetchBase {
+public:
+    void run() {
+        dbtests::WriteContextForTests ctx(&_opCtx, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(&_opCtx, ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_opCtx);
+            coll = db->createCollection(&_opCtx, ns());
+            wuow.commit();
+        }
+
+        WorkingSet ws;
+
+        insert(BSON("_id" << 1 << "foo" << 5 << "bar"
+                          << "x"
+                          << "baz"
+                          << BSON("a" << 1)));
+        set<RecordId> recordIds;
+        getRecordIds(&recordIds, coll);
+        ASSERT_EQUALS(size_t(1), recordIds.size());
+
+        auto mockStage = make_unique<QueuedDataStage>(&_opCtx, &ws);
+        {
+            WorkingSetID id = ws.allocate();
+            WorkingSetMember* mockMember = ws.get(id);
+            mockMember->recordId = *recordIds.begin();
+            ws.transitionToRecordIdAndIdx(id);
+            mockStage->pushBack(id);
+        }
+
+        // The filter is on a field which is not returned.
+        BSONObj filterObj = BSON("bar"
+                                 << "x");
+        const CollatorInterface* collator = nullptr;
+        const boost::intrusive_ptr<ExpressionContext> expCtx(
+            new ExpressionContext(&_opCtx, collator));
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(filterObj, expCtx);
+        verify(statusWithMatcher.isOK());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        unique_ptr<FetchStage> fetchStage(
+            new FetchStage(&_opCtx, &ws, mockStage.release(), filterExpr.get(), coll));
+        fetchStage->setFieldsToReturn({"_id", "baz", "missing"});
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        PlanStage::StageState state = fetchStage->work(&id);
+        ASSERT_EQUALS(PlanStage::ADVANCED, state);
+        ASSERT_BSONOBJ_EQ(ws.get(id)->obj.value(), BSON("_id" << 1 << "baz" << BSON("a" << 1)));
+
+        state = fetchStage->work(&id);
+        ASSERT_EQUALS(PlanStage::IS_EOF, state);
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_fetch") {}
@@ -226,6 +285,7 @@ public:
     void setupTests() {
         add<FetchStageAlreadyFetched>();
         add<FetchStageFilter>();
+        add<FetchStageFieldsToReturn>();
     }
 };
 
@@ -87,6 +87,21 @@ int countResults(PlanStage* stage) {
     return count;
 }
 
+int countBatchedResults(PlanStage* stage, size_t batchSize) {
+    int count = 0;
+    std::vector<WorkingSetID> batch;
+    while (!stage->isEOF()) {
+        batch.clear();
+        PlanStage::StageState status = stage->workBatch(batchSize, &batch);
+        if (PlanStage::ADVANCED != status) {
+            continue;
+        }
+        ASSERT_LTE(batch.size(), batchSize);
+        count += batch.size();
+    }
+    return count;
+}
+
 //
 // Insert 50 objects.  Filter/skip 0, 1, 2, ..., 100 objects and expect the right # of results.
 //
@@ -110,12 +125,39 @@ protected:
     OperationContext* const _opCtx = _uniqOpCtx.get();
 };
 
+//
+// Same as above, but driving the stages with workBatch() using a variety of batch sizes.
+//
+class QueryStageLimitSkipBatchedTest {
+public:
+    void run() {
+        for (size_t batchSize : {1, 3, 64}) {
+            for (int i = 0; i < 2 * N; ++i) {
+                WorkingSet ws;
+
+                unique_ptr<PlanStage> skip =
+                    make_unique<SkipStage>(_opCtx, i, &ws, getMS(_opCtx, &ws));
+                ASSERT_EQUALS(max(0, N - i), countBatchedResults(skip.get(), batchSize));
+
+                unique_ptr<PlanStage> limit =
+                    make_unique<LimitStage>(_opCtx, i, &ws, getMS(_opCtx, &ws));
+                ASSERT_EQUALS(min(N, i), countBatchedResults(limit.get(), batchSize));
+            }
+        }
+    }
+
+protected:
+    const ServiceContext::UniqueOperationContext _uniqOpCtx = cc().makeOperationContext();
+    OperationContext* const _opCtx = _uniqOpCtx.get();
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_limit_skip") {}
 
     void setupTests() {
         add<QueryStageLimitSkipBasicTest>();
+        add<QueryStageLimitSkipBatchedTest>();
     }
 };
 
@@ -451,6 +451,68 @@ TEST_F(QueryStageMultiPlanTest, MPSBackupPlan) {
     internalQueryForceIntersectionPlans.store(forceIxisectOldValue);
 }
 
+TEST_F(QueryStageMultiPlanTest, MPSParallelTrialPicksSelectiveIndexAndRunsItFromTheStart) {
+    const int N = 5000;
+    for (int i = 0; i < N; ++i) {
+        insert(BSON("foo" << (i % 10) << "bar" << i));
+    }
+
+    addIndex(BSON("foo" << 1));
+    addIndex(BSON("bar" << 1));
+
+    const int oldParallelism = internalQueryPlanEvaluationParallelism.load();
+    internalQueryPlanEvaluationParallelism.store(2);
+    ON_BLOCK_EXIT([oldParallelism] {
+        internalQueryPlanEvaluationParallelism.store(oldParallelism);
+    });
+
+    AutoGetCollectionForReadCommand ctx(_opCtx.get(), nss);
+    Collection* collection = ctx.getCollection();
+
+    auto cq = makeCanonicalQuery(_opCtx.get(), nss, fromjson("{foo: 7, bar: {$gte: 0}}"));
+
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(_opCtx.get(), collection, cq.get(), &plannerParams);
+    auto statusWithSolutions = QueryPlanner::plan(*cq, plannerParams);
+    ASSERT_OK(statusWithSolutions.getStatus());
+    auto solutions = std::move(statusWithSolutions.getValue());
+    ASSERT_EQUALS(solutions.size(), 2U);
+
+    unique_ptr<MultiPlanStage> mps(new MultiPlanStage(_opCtx.get(), collection, cq.get()));
+    unique_ptr<WorkingSet> ws(new WorkingSet());
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        PlanStage* root;
+        ASSERT(StageBuilder::build(_opCtx.get(), collection, *cq, *solutions[i], ws.get(), &root));
+        mps->addPlan(std::move(solutions[i]), root, ws.get());
+    }
+
+    PlanYieldPolicy yieldPolicy(PlanExecutor::NO_YIELD, _clock);
+    ASSERT_OK(mps->pickBestPlan(&yieldPolicy));
+    ASSERT(mps->bestPlanChosen());
+    ASSERT(QueryPlannerTestLib::solutionMatches(
+        "{fetch: {node: {ixscan: {pattern: {foo: 1}}}}}", mps->bestSolution()->root.get()));
+
+    // Both candidates were worked by the trial, but not through the stage trees given to the
+    // MultiPlanStage.
+    for (size_t i = 0; i < mps->getChildren().size(); ++i) {
+        ASSERT_GT(mps->getCandidateTrialStats(i)->common.works, 0U);
+        ASSERT_EQ(mps->getChildren()[i]->getStats()->common.works, 0U);
+    }
+
+    // The winner still produces all of the results.
+    int results = 0;
+    PlanStage::StageState state = PlanStage::NEED_TIME;
+    while (PlanStage::IS_EOF != state) {
+        WorkingSetID wsid;
+        state = mps->work(&wsid);
+        if (PlanStage::ADVANCED == state) {
+            ASSERT_EQ(ws->get(wsid)->obj.value()["foo"].numberInt(), 7);
+            ++results;
+        }
+    }
+    ASSERT_EQ(results, N / 10);
+}
+
 /**
  * Allocates a new WorkingSetMember with data 'dataObj' in 'ws', and adds the WorkingSetMember
  * to 'qds'.
@@ -579,6 +579,47 @@ public:
     }
 };
 
+/**
+ * Inserts into a capped collection with asynchronous deletes must stay serialized like those into
+ * any other capped collection, so that tailable cursors see them in RecordId order.
+ */
+class CappedAsyncDeletesSerializesInserts : public ClientBase {
+public:
+    ~CappedAsyncDeletesSerializesInserts() {
+        _client.dropCollection("unittests.querytests.CappedAsyncDeletesSerializesInserts");
+    }
+    void run() {
+        // Only storage engines with document level locking take the capped metadata lock.
+        auto storageEngine = getGlobalServiceContext()->getStorageEngine();
+        if (!storageEngine->supportsCappedCollections() || !storageEngine->supportsDocLocking()) {
+            return;
+        }
+
+        const char* ns = "unittests.querytests.CappedAsyncDeletesSerializesInserts";
+        BSONObj info;
+        ASSERT(_client.runCommand("unittests",
+                                  BSON("create"
+                                       << "querytests.CappedAsyncDeletesSerializesInserts"
+                                       << "capped"
+                                       << true
+                                       << "size"
+                                       << 4096
+                                       << "cappedAsyncDeletes"
+                                       << true),
+                                  info));
+
+        AutoGetCollection autoColl(&_opCtx, NamespaceString(ns), MODE_IX);
+        Collection* collection = autoColl.getCollection();
+        ASSERT(collection);
+
+        WriteUnitOfWork wunit(&_opCtx);
+        ASSERT_OK(collection->insertDocument(&_opCtx, InsertStatement(BSON("_id" << 0)), nullptr));
+        const ResourceId metadataResource(RESOURCE_METADATA, StringData(ns));
+        ASSERT(_opCtx.lockState()->isLockHeldForMode(metadataResource, MODE_X));
+        wunit.commit();
+    }
+};
+
 class TailCappedOnly : public ClientBase {
 public:
     ~TailCappedOnly() {
@@ -1826,6 +1867,7 @@ public:
         add<TailableDelete>();
         add<TailableDelete2>();
         add<TailableInsertDelete>();
+        add<CappedAsyncDeletesSerializesInserts>();
         add<TailCappedOnly>();
         add<TailableQueryOnId>();
         add<OplogReplayMode>();
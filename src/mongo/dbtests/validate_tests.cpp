@@ -37,8 +37,10 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/dbtests/dbtests.h"
+#include "mongo/util/scopeguard.h"
 
 namespace ValidateTests {
 
@@ -1149,6 +1151,79 @@ public:
     }
 };
 
+template <bool full, bool background>
+class ValidateIndexesInParallel : public ValidateBase {
+public:
+    ValidateIndexesInParallel() : ValidateBase(full, background) {}
+    void run() {
+
+        // Can't do it in background if the RecordStore is not in RecordId order.
+        if (_background && !_isInRecordIdOrder) {
+            return;
+        }
+
+        auto parameter =
+            ServerParameterSet::getGlobal()->getMap().find("maxValidateIndexThreads")->second;
+        ON_BLOCK_EXIT([&] { ASSERT_OK(parameter->setFromString("1")); });
+        ASSERT_OK(parameter->setFromString("4"));
+
+        // Create a new collection, insert records.
+        lockDb(MODE_X);
+        OpDebug* const nullOpDebug = nullptr;
+        Collection* coll;
+        RecordId id1;
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            ASSERT_OK(_db->dropCollection(&_opCtx, _ns));
+            coll = _db->createCollection(&_opCtx, _ns);
+            for (int i = 0; i < 100; ++i) {
+                ASSERT_OK(coll->insertDocument(
+                    &_opCtx,
+                    InsertStatement(BSON("_id" << i << "a" << i << "b" << -i << "c"
+                                               << BSON_ARRAY(i << i + 1)
+                                               << "d"
+                                               << i % 10)),
+                    nullOpDebug,
+                    true));
+            }
+            id1 = coll->getCursor(&_opCtx)->next()->id;
+            wunit.commit();
+        }
+
+        for (auto&& field : {"a", "b", "c", "d"}) {
+            ASSERT_OK(dbtests::createIndexFromSpec(&_opCtx,
+                                                   coll->ns().ns(),
+                                                   BSON("name" << field << "ns" << coll->ns().ns()
+                                                               << "key"
+                                                               << BSON(field << 1)
+                                                               << "v"
+                                                               << static_cast<int>(kIndexVersion)
+                                                               << "background"
+                                                               << false)));
+        }
+
+        ASSERT_TRUE(checkValid());
+
+        lockDb(MODE_X);
+        RecordStore* rs = coll->getRecordStore();
+
+        // Change the 'd' field of the first document without updating the index, so that only
+        // one of the indexes traversed concurrently is inconsistent. Verify validate fails.
+        {
+            WriteUnitOfWork wunit(&_opCtx);
+            auto doc = BSON("_id" << 0 << "a" << 0 << "b" << 0 << "c" << BSON_ARRAY(0 << 1) << "d"
+                                  << 42);
+            auto updateStatus = rs->updateRecord(&_opCtx, id1, doc.objdata(), doc.objsize());
+
+            ASSERT_OK(updateStatus);
+            wunit.commit();
+        }
+
+        ASSERT_FALSE(checkValid());
+        releaseDb();
+    }
+};
+
 
 class ValidateTests : public Suite {
 public:
@@ -1186,6 +1261,9 @@ public:
         add<ValidateIndexEntry<false, true>>();
         add<ValidateIndexOrdering<false, false>>();
         add<ValidateIndexOrdering<false, true>>();
+        add<ValidateIndexesInParallel<true, false>>();
+        add<ValidateIndexesInParallel<false, false>>();
+        add<ValidateIndexesInParallel<false, true>>();
     }
 } validateTests;
 }  // namespace ValidateTests
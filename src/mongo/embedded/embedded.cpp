@@ -56,6 +56,7 @@
 #include "mongo/db/storage/encryption_hooks.h"
 #include "mongo/db/storage/storage_engine_init.h"
 #include "mongo/db/ttl.h"
+#include "mongo/embedded/embedded_options.h"
 #include "mongo/embedded/logical_session_cache_factory_embedded.h"
 #include "mongo/embedded/periodic_runner_embedded.h"
 #include "mongo/embedded/replication_coordinator_embedded.h"
@@ -68,6 +69,7 @@
 #include "mongo/util/periodic_runner_factory.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 #include <boost/filesystem.hpp>
 
@@ -91,6 +93,28 @@ void initWireSpec() {
 }
 
 
+/**
+ * Measures how long each phase of startup takes, so that they can be reported together once
+ * startup completes.
+ */
+class StartupPhaseTimer {
+public:
+    void endPhase(StringData phase) {
+        _phases.append(phase, _phaseTimer.micros());
+        _phaseTimer.reset();
+    }
+
+    BSONObj done() {
+        _phases.append("total", _totalTimer.micros());
+        return _phases.obj();
+    }
+
+private:
+    Timer _totalTimer;
+    Timer _phaseTimer;
+    BSONObjBuilder _phases;
+};
+
 // Noop, to fulfull dependencies for other initializers
 MONGO_INITIALIZER_GENERAL(ForkServer, ("EndStartupOptionHandling"), ("default"))
 (InitializerContext* context) {
@@ -179,6 +203,7 @@ void shutdown(ServiceContext* srvContext) {
 
 
 ServiceContext* initialize(const char* yaml_config) {
+    StartupPhaseTimer startupTimer;
     srand(static_cast<unsigned>(curTimeMicros64()));
 
     // yaml_config is passed to the options parser through the argc/argv interface that already
@@ -188,6 +213,7 @@ ServiceContext* initialize(const char* yaml_config) {
     Status status = mongo::runGlobalInitializers(yaml_config ? 1 : 0, argv, nullptr);
     uassertStatusOKWithContext(status, "Global initilization failed");
     setGlobalServiceContext(ServiceContext::make());
+    startupTimer.endPhase("globalInitializers");
 
     Client::initThread("initandlisten");
 
@@ -218,6 +244,7 @@ ServiceContext* initialize(const char* yaml_config) {
     DEV log(LogComponent::kControl) << "DEBUG build (which is slower)" << endl;
 
     initializeStorageEngine(serviceContext, StorageEngineInitFlags::kAllowNoLockFile);
+    startupTimer.endPhase("storageEngine");
 
     // Warn if we detect configurations for multiple registered storage engines in the same
     // configuration file/environment.
@@ -292,6 +319,8 @@ ServiceContext* initialize(const char* yaml_config) {
         invariant(serverGlobalParams.featureCompatibility.isVersionInitialized());
     }
 
+    startupTimer.endPhase("repairAndCheckVersion");
+
     if (storageGlobalParams.upgrade) {
         log() << "finished checking dbs";
         exitCleanly(EXIT_CLEAN);
@@ -303,15 +332,22 @@ ServiceContext* initialize(const char* yaml_config) {
     if (!storageGlobalParams.readOnly) {
         restartInProgressIndexesFromLastShutdown(startupOpCtx.get());
     }
-
-    auto periodicRunner = std::make_unique<PeriodicRunnerEmbedded>(
-        serviceContext, serviceContext->getPreciseClockSource());
+    startupTimer.endPhase("restartIndexBuilds");
+
+    // With the fast startup profile, the first refresh of the logical session cache (which
+    // creates the sessions collection) waits a full interval instead of running as part of the
+    // first command.
+    auto periodicRunner =
+        std::make_unique<PeriodicRunnerEmbedded>(serviceContext,
+                                                 serviceContext->getPreciseClockSource(),
+                                                 embeddedGlobalParams.fastStart);
     periodicRunner->startup();
     serviceContext->setPeriodicRunner(std::move(periodicRunner));
 
     // Set up the logical session cache
     auto sessionCache = makeLogicalSessionCacheEmbedded();
     LogicalSessionCache::set(serviceContext, std::move(sessionCache));
+    startupTimer.endPhase("backgroundServices");
 
     // MessageServer::run will return when exit code closes its socket and we don't need the
     // operation context anymore
@@ -322,6 +358,10 @@ ServiceContext* initialize(const char* yaml_config) {
 
     serviceContext->notifyStartupComplete();
 
+    log(LogComponent::kControl) << "startup phase timings in micros"
+                                << (embeddedGlobalParams.fastStart ? " (fast profile)" : "")
+                                << ": " << startupTimer.done();
+
     return serviceContext;
 }
 }  // namespace embedded
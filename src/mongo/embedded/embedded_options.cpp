@@ -42,6 +42,8 @@ namespace embedded {
 
 using std::string;
 
+EmbeddedParams embeddedGlobalParams;
+
 Status addOptions(optionenvironment::OptionSection* options) {
     moe::OptionSection general_options("General options");
 
@@ -77,8 +79,20 @@ Status addOptions(optionenvironment::OptionSection* options) {
 
 #endif
 
+    moe::OptionSection embedded_options("Embedded options");
+
+    embedded_options
+        .addOptionChaining("embedded.startupProfile",
+                           "",
+                           moe::String,
+                           "(default/fast) \"fast\" defers background work until it is first due")
+        .setSources(moe::SourceYAMLConfig)
+        .format("(:?default)|(:?fast)", "(default/fast)")
+        .setDefault(optionenvironment::Value("default"));
+
     options->addSection(general_options).transitional_ignore();
     options->addSection(storage_options).transitional_ignore();
+    options->addSection(embedded_options).transitional_ignore();
 
     return Status::OK();
 }
@@ -107,6 +121,10 @@ Status storeOptions(const moe::Environment& params) {
     if (params.count("storage.dbPath")) {
         storageGlobalParams.dbpath = params["storage.dbPath"].as<string>();
     }
+
+    if (params.count("embedded.startupProfile")) {
+        embeddedGlobalParams.fastStart = params["embedded.startupProfile"].as<string>() == "fast";
+    }
 #ifdef _WIN32
     if (storageGlobalParams.dbpath.size() > 1 &&
         storageGlobalParams.dbpath[storageGlobalParams.dbpath.size() - 1] == '/') {
@@ -131,6 +149,7 @@ Status storeOptions(const moe::Environment& params) {
 
 void resetOptions() {
     storageGlobalParams.reset();
+    embeddedGlobalParams = EmbeddedParams();
 }
 
 }  // namespace embedded
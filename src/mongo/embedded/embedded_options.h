@@ -35,6 +35,14 @@
 namespace mongo {
 namespace embedded {
 
+struct EmbeddedParams {
+    // Set by the "fast" embedded.startupProfile. Defers background work that an application may
+    // never need, such as setting up the sessions collection, until it is first due.
+    bool fastStart = false;
+};
+
+extern EmbeddedParams embeddedGlobalParams;
+
 Status addOptions(optionenvironment::OptionSection* options);
 
 /**
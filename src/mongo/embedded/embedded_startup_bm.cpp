@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/embedded/capi.h"
+
+#include <benchmark/benchmark.h>
+#include <iostream>
+#include <memory>
+#include <yaml-cpp/yaml.h>
+
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/util/quick_exit.h"
+#include "mongo/util/signal_handlers_synchronous.h"
+
+namespace {
+
+/**
+ * Measures a cold start of the embedded library: initializing the library and creating an
+ * instance, as an application does on launch. Shutting down is not timed.
+ *
+ * Arguments: whether the "fast" startup profile is used, and whether the instance starts on a
+ * dbpath left behind by a previous instance rather than an empty one.
+ */
+class EmbeddedStartup {
+public:
+    EmbeddedStartup(const std::string& dbPath, bool fastStart) : _status(nullptr, &destroyStatus) {
+        YAML::Emitter yaml;
+        yaml << YAML::BeginMap;
+
+        yaml << YAML::Key << "storage";
+        yaml << YAML::Value << YAML::BeginMap;
+        yaml << YAML::Key << "dbPath";
+        yaml << YAML::Value << dbPath;
+        yaml << YAML::EndMap;  // storage
+
+        yaml << YAML::Key << "embedded";
+        yaml << YAML::Value << YAML::BeginMap;
+        yaml << YAML::Key << "startupProfile";
+        yaml << YAML::Value << (fastStart ? "fast" : "default");
+        yaml << YAML::EndMap;  // embedded
+
+        yaml << YAML::EndMap;
+        _yaml = yaml.c_str();
+        _status.reset(mongo_embedded_v1_status_create());
+    }
+
+    void start() {
+        mongo_embedded_v1_init_params params{};
+        params.log_flags = MONGO_EMBEDDED_V1_LOG_NONE;
+        params.yaml_config = _yaml.c_str();
+
+        _lib = mongo_embedded_v1_lib_init(&params, _status.get());
+        _check(_lib != nullptr);
+        _instance = mongo_embedded_v1_instance_create(_lib, _yaml.c_str(), _status.get());
+        _check(_instance != nullptr);
+    }
+
+    void stop() {
+        _check(mongo_embedded_v1_instance_destroy(_instance, _status.get()) ==
+               MONGO_EMBEDDED_V1_SUCCESS);
+        _check(mongo_embedded_v1_lib_fini(_lib, _status.get()) == MONGO_EMBEDDED_V1_SUCCESS);
+        _instance = nullptr;
+        _lib = nullptr;
+    }
+
+private:
+    static void destroyStatus(mongo_embedded_v1_status* status) {
+        mongo_embedded_v1_status_destroy(status);
+    }
+
+    void _check(bool ok) {
+        if (ok)
+            return;
+        std::cerr << "embedded startup failed: "
+                  << mongo_embedded_v1_status_get_explanation(_status.get()) << std::endl;
+        mongo::quickExit(EXIT_FAILURE);
+    }
+
+    std::string _yaml;
+    std::unique_ptr<mongo_embedded_v1_status, decltype(&destroyStatus)> _status;
+    mongo_embedded_v1_lib* _lib = nullptr;
+    mongo_embedded_v1_instance* _instance = nullptr;
+};
+
+void BM_EmbeddedColdStart(benchmark::State& state) {
+    const bool fastStart = state.range(0);
+    const bool existingData = state.range(1);
+
+    std::unique_ptr<mongo::unittest::TempDir> dbPath;
+    if (existingData) {
+        dbPath = std::make_unique<mongo::unittest::TempDir>("embedded_startup_bm");
+        EmbeddedStartup previous(dbPath->path(), fastStart);
+        previous.start();
+        previous.stop();
+    }
+
+    for (auto _ : state) {
+        if (!existingData) {
+            state.PauseTiming();
+            dbPath.reset();
+            dbPath = std::make_unique<mongo::unittest::TempDir>("embedded_startup_bm");
+            state.ResumeTiming();
+        }
+
+        EmbeddedStartup startup(dbPath->path(), fastStart);
+        startup.start();
+
+        state.PauseTiming();
+        startup.stop();
+        state.ResumeTiming();
+    }
+}
+
+BENCHMARK(BM_EmbeddedColdStart)
+    ->ArgNames({"fastStart", "existingData"})
+    ->Args({0, 0})
+    ->Args({1, 0})
+    ->Args({0, 1})
+    ->Args({1, 1})
+    ->Unit(benchmark::kMillisecond);
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    ::mongo::clearSignalMask();
+    ::mongo::setupSynchronousSignalHandlers();
+
+    // The library runs the global initializers itself, so this does not use benchmark_main.
+    ::benchmark::Initialize(&argc, argv);
+    if (::benchmark::ReportUnrecognizedArguments(argc, argv))
+        return 1;
+
+    ::benchmark::RunSpecifiedBenchmarks();
+    mongo::quickExit(EXIT_SUCCESS);
+}
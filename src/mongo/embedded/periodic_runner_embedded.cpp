@@ -60,8 +60,10 @@ struct PeriodicRunnerEmbedded::PeriodicJobSorter {
     }
 };
 
-PeriodicRunnerEmbedded::PeriodicRunnerEmbedded(ServiceContext* svc, ClockSource* clockSource)
-    : _svc(svc), _clockSource(clockSource) {}
+PeriodicRunnerEmbedded::PeriodicRunnerEmbedded(ServiceContext* svc,
+                                               ClockSource* clockSource,
+                                               bool deferFirstRuns)
+    : _svc(svc), _clockSource(clockSource), _deferFirstRuns(deferFirstRuns) {}
 
 PeriodicRunnerEmbedded::~PeriodicRunnerEmbedded() {
     PeriodicRunnerEmbedded::shutdown();
@@ -70,6 +72,10 @@ PeriodicRunnerEmbedded::~PeriodicRunnerEmbedded() {
 std::shared_ptr<PeriodicRunnerEmbedded::PeriodicJobImpl> PeriodicRunnerEmbedded::createAndAddJob(
     PeriodicJob job, bool shouldStart) {
     auto impl = std::make_shared<PeriodicJobImpl>(std::move(job), this->_clockSource, this);
+    if (_deferFirstRuns) {
+        // Must be set before the job enters the heap, which is ordered by the last run.
+        impl->_lastRun = _clockSource->now();
+    }
 
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _jobs.push_back(impl);
@@ -45,7 +45,13 @@ namespace mongo {
  */
 class PeriodicRunnerEmbedded : public PeriodicRunner {
 public:
-    PeriodicRunnerEmbedded(ServiceContext* svc, ClockSource* clockSource);
+    /**
+     * Jobs normally first run on the first pump after they are started. With 'deferFirstRuns',
+     * each job instead first runs one interval after it was added.
+     */
+    PeriodicRunnerEmbedded(ServiceContext* svc,
+                           ClockSource* clockSource,
+                           bool deferFirstRuns = false);
     ~PeriodicRunnerEmbedded();
 
     std::unique_ptr<PeriodicRunner::PeriodicJobHandle> makeJob(PeriodicJob job) override;
@@ -113,6 +119,7 @@ private:
 
     ServiceContext* _svc;
     ClockSource* _clockSource;
+    const bool _deferFirstRuns;
 
     // min-heap for running jobs, next job to run in front()
     std::vector<std::shared_ptr<PeriodicJobImpl>> _jobs;
@@ -0,0 +1,136 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/embedded/periodic_runner_embedded.h"
+
+#include "mongo/db/service_context_test_fixture.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+namespace mongo {
+namespace {
+
+class PeriodicRunnerEmbeddedTest : public ServiceContextTest {
+public:
+    void setUp() override {
+        // Start from a realistic time rather than the epoch, like the precise clock source which
+        // the embedded runner is given.
+        _clockSource.reset(Date_t::fromMillisSinceEpoch(1000 * 1000));
+    }
+
+    void tearDown() override {
+        if (_runner) {
+            _runner->shutdown();
+        }
+    }
+
+    ClockSourceMock& clockSource() {
+        return _clockSource;
+    }
+
+    PeriodicRunnerEmbedded& makeRunner(bool deferFirstRuns) {
+        _runner = stdx::make_unique<PeriodicRunnerEmbedded>(
+            getServiceContext(), &_clockSource, deferFirstRuns);
+        _runner->startup();
+        return *_runner;
+    }
+
+private:
+    ClockSourceMock _clockSource;
+    std::unique_ptr<PeriodicRunnerEmbedded> _runner;
+};
+
+TEST_F(PeriodicRunnerEmbeddedTest, JobRunsOnFirstPump) {
+    auto& runner = makeRunner(false);
+
+    int count = 0;
+    const Milliseconds interval{10};
+    runner.scheduleJob({"job", [&count](Client*) { count++; }, interval});
+
+    ASSERT_TRUE(runner.tryPump());
+    ASSERT_EQ(1, count);
+
+    // Not due again until a full interval has passed.
+    runner.tryPump();
+    ASSERT_EQ(1, count);
+    clockSource().advance(interval);
+    runner.tryPump();
+    ASSERT_EQ(2, count);
+}
+
+TEST_F(PeriodicRunnerEmbeddedTest, DeferredJobFirstRunsAfterOneInterval) {
+    auto& runner = makeRunner(true);
+
+    int count = 0;
+    const Milliseconds interval{10};
+    runner.scheduleJob({"job", [&count](Client*) { count++; }, interval});
+
+    runner.tryPump();
+    ASSERT_EQ(0, count);
+
+    clockSource().advance(interval - Milliseconds(1));
+    runner.tryPump();
+    ASSERT_EQ(0, count);
+
+    clockSource().advance(Milliseconds(1));
+    runner.tryPump();
+    ASSERT_EQ(1, count);
+
+    // Later runs keep to the interval.
+    clockSource().advance(interval);
+    runner.tryPump();
+    ASSERT_EQ(2, count);
+}
+
+TEST_F(PeriodicRunnerEmbeddedTest, DeferredJobMadeBeforeStartupIsDeferredFromWhenItWasAdded) {
+    PeriodicRunnerEmbedded runner(getServiceContext(), &clockSource(), true);
+
+    int count = 0;
+    const Milliseconds interval{10};
+    auto handle = runner.makeJob({"job", [&count](Client*) { count++; }, interval});
+
+    // The job is started along with the runner, after some time has passed.
+    clockSource().advance(Milliseconds(5));
+    runner.startup();
+
+    runner.tryPump();
+    ASSERT_EQ(0, count);
+
+    clockSource().advance(interval - Milliseconds(5));
+    runner.tryPump();
+    ASSERT_EQ(1, count);
+
+    runner.shutdown();
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,18 +32,22 @@
 
 #include "mongo/executor/connection_pool.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/destructor_guard.h"
 #include "mongo/util/log.h"
 #include "mongo/util/lru_cache.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 // One interesting implementation note herein concerns how setup() and
-// refresh() are invoked outside of the global lock, but setTimeout is not.
+// refresh() are invoked outside of the specific pool's lock, but setTimeout is not.
 // This implementation detail simplifies mocks, allowing them to return
 // synchronously sometimes, whereas having timeouts fire instantly adds little
 // value. In practice, dumping the locks is always safe (because we restrict
@@ -69,7 +73,7 @@ public:
      *
      * The complexity comes from the need to hold a lock when writing to the
      * _activeClients param on the specific pool.  Because the code beneath the client needs to lock
-     * and unlock the parent mutex (and can leave unlocked), we want to start the client with the
+     * and unlock the pool's mutex (and can leave unlocked), we want to start the client with the
      * lock acquired, move it into the client, then re-acquire to decrement the counter on the way
      * out.
      *
@@ -85,11 +89,11 @@ public:
     template <typename Callback>
     auto guardCallback(Callback&& cb) {
         return [ cb = std::forward<Callback>(cb), anchor = shared_from_this() ](auto&&... args) {
-            stdx::unique_lock<stdx::mutex> lk(anchor->_parent->_mutex);
+            auto lk = anchor->lockPool();
             ++(anchor->_activeClients);
 
             ON_BLOCK_EXIT([anchor]() {
-                stdx::unique_lock<stdx::mutex> lk(anchor->_parent->_mutex);
+                auto lk = anchor->lockPool();
                 --(anchor->_activeClients);
             });
 
@@ -97,17 +101,29 @@ public:
         };
     }
 
-    SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort);
+    SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort, size_t stripe);
     ~SpecificPool();
 
     /**
-     * Gets a connection from the specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Acquires this pool's mutex, recording how often and for how long callers had to wait for
+     * it.
+     */
+    stdx::unique_lock<stdx::mutex> lockPool();
+
+    /**
+     * Gets a connection from the specific pool. Sinks a unique_lock on this
+     * pool's _mutex to preserve the lock
      */
     Future<ConnectionHandle> getConnection(const HostAndPort& hostAndPort,
                                            Milliseconds timeout,
                                            stdx::unique_lock<stdx::mutex> lk);
 
+    /**
+     * Opens connections until the pool holds at least minConnections. Sinks a unique_lock on
+     * this pool's _mutex to preserve the lock
+     */
+    void warmUp(stdx::unique_lock<stdx::mutex> lk);
+
     /**
      * Triggers the shutdown procedure. This function marks the state as kInShutdown
      * and calls processFailure below with the status provided. This may not immediately
@@ -124,8 +140,8 @@ public:
     void processFailure(const Status& status, stdx::unique_lock<stdx::mutex> lk);
 
     /**
-     * Returns a connection to a specific pool. Sinks a unique_lock from the
-     * parent to preserve the lock on _mutex
+     * Returns a connection to a specific pool. Sinks a unique_lock on this
+     * pool's _mutex to preserve the lock
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
@@ -156,6 +172,40 @@ public:
      */
     size_t openConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns the number of times acquiring this pool's mutex had to wait, and the total time
+     * spent waiting.
+     */
+    size_t lockContentions(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _lockContentions;
+    }
+    Microseconds lockWaitTime(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _lockWaitTime;
+    }
+
+    /**
+     * Returns the distribution of how long successful connection setups took.
+     */
+    const ConnectionSetupHistogram& setupLatency(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _setupLatency;
+    }
+
+    /**
+     * Returns true once the pool has started shutting down. A pool in shutdown can not hand out
+     * connections and will delist itself from the parent pool.
+     */
+    bool isShutdown(const stdx::unique_lock<stdx::mutex>& lk) const {
+        return _state == State::kInShutdown;
+    }
+
+    const HostAndPort& getHostAndPort() const {
+        return _hostAndPort;
+    }
+
+    size_t getStripe() const {
+        return _stripe;
+    }
+
     /**
      * Return true if the tags on the specific pool match the passed in tags
      */
@@ -177,10 +227,14 @@ private:
     using OwnedConnection = std::shared_ptr<ConnectionInterface>;
     using OwnershipPool = stdx::unordered_map<ConnectionInterface*, OwnedConnection>;
     using LRUOwnershipPool = LRUCache<OwnershipPool::key_type, OwnershipPool::mapped_type>;
-    using Request = std::pair<Date_t, SharedPromise<ConnectionHandle>>;
+    struct Request {
+        Date_t expiration;
+        Date_t enqueued;
+        SharedPromise<ConnectionHandle> promise;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
@@ -190,6 +244,12 @@ private:
 
     void spawnConnections(stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Folds the wait of a request that is being fulfilled into the moving average of request
+     * waits, and adjusts the number of spare connections kept ahead of demand.
+     */
+    void recordRequestWait(const stdx::unique_lock<stdx::mutex>& lk, Date_t enqueued);
+
     template <typename OwnershipPoolType>
     typename OwnershipPoolType::mapped_type takeFromPool(
         OwnershipPoolType& pool, typename OwnershipPoolType::key_type connPtr);
@@ -203,6 +263,15 @@ private:
 
     const HostAndPort _hostAndPort;
 
+    // The index of this pool within the parent's pools for _hostAndPort
+    const size_t _stripe;
+
+    // Guards all of the state below
+    stdx::mutex _mutex;
+
+    size_t _lockContentions = 0;
+    Microseconds _lockWaitTime{0};
+
     LRUOwnershipPool _readyPool;
     OwnershipPool _processingPool;
     OwnershipPool _droppedProcessingPool;
@@ -219,6 +288,13 @@ private:
 
     size_t _created;
 
+    ConnectionSetupHistogram _setupLatency;
+
+    // Moving average of how long requests waited for a connection, and the number of connections
+    // opened beyond current demand because that average was above adaptiveWaitThreshold
+    double _requestWaitAverageMillis = 0;
+    size_t _spareConnections = 0;
+
     transport::Session::TagMask _tags = transport::Session::kPending;
 
     /**
@@ -283,43 +359,29 @@ void ConnectionPool::shutdown() {
     _factory->shutdown();
 
     // Grab all current pools (under the lock)
-    auto pools = [&] {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-        return _pools;
-    }();
-
-    for (const auto& pair : pools) {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-        pair.second->triggerShutdown(
+    auto pools = _getAllPools();
+
+    for (const auto& pool : pools) {
+        pool->triggerShutdown(
             Status(ErrorCodes::ShutdownInProgress, "Shutting down the connection pool"),
-            std::move(lk));
+            pool->lockPool());
     }
 }
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
-
-    if (iter == _pools.end())
-        return;
-
-    auto pool = iter->second;
-    pool->processFailure(Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
-                         std::move(lk));
+    for (const auto& pool : _getPoolsForHost(hostAndPort)) {
+        pool->processFailure(
+            Status(ErrorCodes::PooledConnectionsDropped, "Pooled connections dropped"),
+            pool->lockPool());
+    }
 }
 
 void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
     // Grab all current pools (under the lock)
-    auto pools = [&] {
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
-        return _pools;
-    }();
-
-    for (const auto& pair : pools) {
-        auto& pool = pair.second;
+    auto pools = _getAllPools();
 
-        stdx::unique_lock<stdx::mutex> lk(_mutex);
+    for (const auto& pool : pools) {
+        auto lk = pool->lockPool();
         if (pool->matchesTags(lk, tags))
             continue;
 
@@ -332,15 +394,10 @@ void ConnectionPool::dropConnections(transport::Session::TagMask tags) {
 void ConnectionPool::mutateTags(
     const HostAndPort& hostAndPort,
     const stdx::function<transport::Session::TagMask(transport::Session::TagMask)>& mutateFunc) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    auto iter = _pools.find(hostAndPort);
-
-    if (iter == _pools.end())
-        return;
-
-    auto pool = iter->second;
-    pool->mutateTags(lk, mutateFunc);
+    for (const auto& pool : _getPoolsForHost(hostAndPort)) {
+        auto lk = pool->lockPool();
+        pool->mutateTags(lk, mutateFunc);
+    }
 }
 
 void ConnectionPool::get(const HostAndPort& hostAndPort,
@@ -351,65 +408,153 @@ void ConnectionPool::get(const HostAndPort& hostAndPort,
 
 Future<ConnectionPool::ConnectionHandle> ConnectionPool::get(const HostAndPort& hostAndPort,
                                                              Milliseconds timeout) {
-    std::shared_ptr<SpecificPool> pool;
-
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    const auto stripe = _stripeForThisThread();
 
-    auto iter = _pools.find(hostAndPort);
+    while (true) {
+        auto pool = _getOrCreatePool(hostAndPort, stripe);
+        auto lk = pool->lockPool();
+        if (!pool->isShutdown(lk)) {
+            return pool->getConnection(hostAndPort, timeout, std::move(lk));
+        }
 
-    if (iter == _pools.end()) {
-        pool = stdx::make_unique<SpecificPool>(this, hostAndPort);
-        _pools[hostAndPort] = pool;
-    } else {
-        pool = iter->second;
+        // The pool started shutting down between the lookup and taking its lock. Delist it so
+        // that the next pass creates a fresh one.
+        lk.unlock();
+        _delistPool(pool.get());
     }
+}
 
-    invariant(pool);
+void ConnectionPool::warmUp(const HostAndPort& hostAndPort) {
+    for (size_t stripe = 0; stripe < std::max<size_t>(_options.poolsPerHost, 1); ++stripe) {
+        while (true) {
+            auto pool = _getOrCreatePool(hostAndPort, stripe);
+            auto lk = pool->lockPool();
+            if (!pool->isShutdown(lk)) {
+                pool->warmUp(std::move(lk));
+                break;
+            }
 
-    return pool->getConnection(hostAndPort, timeout, std::move(lk));
+            lk.unlock();
+            _delistPool(pool.get());
+        }
+    }
 }
 
 void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    for (const auto& kv : _pools) {
-        HostAndPort host = kv.first;
+    auto pools = _getAllPools();
 
-        auto& pool = kv.second;
+    for (const auto& pool : pools) {
+        auto lk = pool->lockPool();
         ConnectionStatsPer hostStats{pool->inUseConnections(lk),
                                      pool->availableConnections(lk),
                                      pool->createdConnections(lk),
                                      pool->refreshingConnections(lk)};
-        stats->updateStatsForHost(_name, host, hostStats);
+        hostStats.lockContentions = pool->lockContentions(lk);
+        hostStats.lockWaitTime = pool->lockWaitTime(lk);
+        hostStats.setupLatency = pool->setupLatency(lk);
+        lk.unlock();
+
+        stats->updateStatsForHost(_name, pool->getHostAndPort(), hostStats);
     }
 }
 
 size_t ConnectionPool::getNumConnectionsPerHost(const HostAndPort& hostAndPort) const {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    size_t total = 0;
+    for (const auto& pool : _getPoolsForHost(hostAndPort)) {
+        auto lk = pool->lockPool();
+        total += pool->openConnections(lk);
+    }
+
+    return total;
+}
+
+std::shared_ptr<ConnectionPool::SpecificPool> ConnectionPool::_getOrCreatePool(
+    const HostAndPort& hostAndPort, size_t stripe) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto& stripes = _pools[hostAndPort];
+    if (stripes.empty()) {
+        stripes.resize(std::max<size_t>(_options.poolsPerHost, 1));
+    }
+
+    auto& slot = stripes[stripe];
+    if (!slot) {
+        slot = std::make_shared<SpecificPool>(this, hostAndPort, stripe);
+    }
+
+    return slot;
+}
+
+std::vector<std::shared_ptr<ConnectionPool::SpecificPool>> ConnectionPool::_getAllPools() const {
+    std::vector<std::shared_ptr<SpecificPool>> out;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& kv : _pools) {
+        for (const auto& pool : kv.second) {
+            if (pool) {
+                out.push_back(pool);
+            }
+        }
+    }
+
+    return out;
+}
+
+std::vector<std::shared_ptr<ConnectionPool::SpecificPool>> ConnectionPool::_getPoolsForHost(
+    const HostAndPort& hostAndPort) const {
+    std::vector<std::shared_ptr<SpecificPool>> out;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
     auto iter = _pools.find(hostAndPort);
-    if (iter != _pools.end()) {
-        return iter->second->openConnections(lk);
+    if (iter == _pools.end())
+        return out;
+
+    for (const auto& pool : iter->second) {
+        if (pool) {
+            out.push_back(pool);
+        }
     }
 
-    return 0;
+    return out;
 }
 
-void ConnectionPool::returnConnection(ConnectionInterface* conn) {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
+void ConnectionPool::_delistPool(SpecificPool* pool) {
+    // Callers keep their own reference to the pool, but release the map's reference outside of
+    // _mutex anyway.
+    std::shared_ptr<SpecificPool> toRelease;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto iter = _pools.find(pool->getHostAndPort());
+    if (iter == _pools.end())
+        return;
+
+    auto& stripes = iter->second;
+    auto& slot = stripes[pool->getStripe()];
+    if (slot.get() != pool)
+        return;
 
-    auto iter = _pools.find(conn->getHostAndPort());
+    toRelease = std::move(slot);
+    slot.reset();
 
-    invariant(iter != _pools.end(),
-              str::stream() << "Tried to return connection but no pool found for "
-                            << conn->getHostAndPort());
+    if (std::none_of(stripes.begin(), stripes.end(), [](const auto& p) { return bool(p); })) {
+        _pools.erase(iter);
+    }
+}
 
-    auto pool = iter->second;
-    pool->returnConnection(conn, std::move(lk));
+size_t ConnectionPool::_stripeForThisThread() const {
+    if (_options.poolsPerHost <= 1)
+        return 0;
+
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % _options.poolsPerHost;
 }
 
-ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent, const HostAndPort& hostAndPort)
+ConnectionPool::SpecificPool::SpecificPool(ConnectionPool* parent,
+                                           const HostAndPort& hostAndPort,
+                                           size_t stripe)
     : _parent(parent),
       _hostAndPort(hostAndPort),
+      _stripe(stripe),
       _readyPool(std::numeric_limits<size_t>::max()),
       _requestTimer(parent->_factory->makeTimer()),
       _activeClients(0),
@@ -426,6 +571,19 @@ ConnectionPool::SpecificPool::~SpecificPool() {
     invariant(_checkedOutPool.empty());
 }
 
+stdx::unique_lock<stdx::mutex> ConnectionPool::SpecificPool::lockPool() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::try_to_lock);
+    if (lk.owns_lock())
+        return lk;
+
+    Timer waitTimer;
+    lk.lock();
+    ++_lockContentions;
+    _lockWaitTime += waitTimer.elapsed();
+
+    return lk;
+}
+
 size_t ConnectionPool::SpecificPool::inUseConnections(const stdx::unique_lock<stdx::mutex>& lk) {
     return _checkedOutPool.size();
 }
@@ -456,10 +614,11 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
         timeout = _parent->_options.refreshTimeout;
     }
 
-    const auto expiration = _parent->_factory->now() + timeout;
+    const auto now = _parent->_factory->now();
+    const auto expiration = now + timeout;
     auto pf = makePromiseFuture<ConnectionHandle>();
 
-    _requests.push_back(make_pair(expiration, pf.promise.share()));
+    _requests.push_back(Request{expiration, now, pf.promise.share()});
     std::push_heap(begin(_requests), end(_requests), RequestComparator{});
 
     updateStateInLock();
@@ -470,6 +629,16 @@ Future<ConnectionPool::ConnectionHandle> ConnectionPool::SpecificPool::getConnec
     return std::move(pf.future);
 }
 
+void ConnectionPool::SpecificPool::warmUp(stdx::unique_lock<stdx::mutex> lk) {
+    invariant(_state != State::kInShutdown);
+
+    // With no requests this arms the host timeout, so a pool that is warmed but never used still
+    // goes away.
+    updateStateInLock();
+
+    spawnConnections(lk);
+}
+
 void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr,
                                                     stdx::unique_lock<stdx::mutex> lk) {
     auto needsRefreshTP = connPtr->getLastUsed() + _parent->_options.refreshRequirement;
@@ -603,6 +772,10 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status,
     // connections
     _generation++;
 
+    // Demand seen before the failure says little about the host from here on
+    _requestWaitAverageMillis = 0;
+    _spareConnections = 0;
+
     // When a connection enters the ready pool, its timer is set to eventually refresh the
     // connection. This requires a lifetime extension of the specific pool because the connection
     // timer is tied to the lifetime of the connection, not the pool. That said, we can destruct
@@ -638,7 +811,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status,
     lk.unlock();
 
     for (auto& request : requestsToFail) {
-        request.second.setError(status);
+        request.promise.setError(status);
     }
 }
 
@@ -652,6 +825,8 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
     _inFulfillRequests = true;
     auto guard = MakeGuard([&] { _inFulfillRequests = false; });
 
+    const auto sparesBefore = _spareConnections;
+
     while (_requests.size()) {
         // _readyPool is an LRUCache, so its begin() object is the MRU item.
         auto iter = _readyPool.begin();
@@ -680,7 +855,8 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         }
 
         // Grab the request and callback
-        auto promise = std::move(_requests.front().second);
+        auto promise = std::move(_requests.front().promise);
+        recordRequestWait(lk, _requests.front().enqueued);
         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
         _requests.pop_back();
 
@@ -702,6 +878,38 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         promise.emplaceValue(std::move(handle));
         lk.lock();
     }
+
+    // Requests have been waiting too long, so open connections ahead of the next ones
+    if (_spareConnections > sparesBefore) {
+        spawnConnections(lk);
+    }
+}
+
+void ConnectionPool::SpecificPool::recordRequestWait(const stdx::unique_lock<stdx::mutex>& lk,
+                                                     Date_t enqueued) {
+    // Weight of the newest sample in the moving average
+    constexpr double kWaitAverageWeight = 0.2;
+
+    const auto wait = _parent->_factory->now() - enqueued;
+    _requestWaitAverageMillis = (1 - kWaitAverageWeight) * _requestWaitAverageMillis +
+        kWaitAverageWeight * durationCount<Milliseconds>(wait);
+
+    const auto threshold = _parent->_options.adaptiveWaitThreshold;
+    if (threshold <= Milliseconds(0))
+        return;
+
+    // Grow while waits trend above the threshold, and only shrink once they have fallen well
+    // below it, so that the spare count doesn't flap around the threshold.
+    // Spares are opened in one go, so keep them within what the pool may have connecting at once.
+    const auto maxSpares =
+        std::min(_parent->_options.maxConnecting, _parent->_options.maxConnections);
+    const double thresholdMillis = durationCount<Milliseconds>(threshold);
+    if (_requestWaitAverageMillis > thresholdMillis) {
+        if (_spareConnections < maxSpares)
+            ++_spareConnections;
+    } else if (_requestWaitAverageMillis < thresholdMillis / 2 && _spareConnections) {
+        --_spareConnections;
+    }
 }
 
 // spawn enough connections to satisfy open requests and minpool, while
@@ -715,11 +923,11 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     _inSpawnConnections = true;
     auto guard = MakeGuard([&] { _inSpawnConnections = false; });
 
-    // We want minConnections <= outstanding requests <= maxConnections
+    // We want minConnections <= outstanding requests + spares <= maxConnections
     auto target = [&] {
-        return std::max(
-            _parent->_options.minConnections,
-            std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
+        return std::max(_parent->_options.minConnections,
+                        std::min(_requests.size() + _checkedOutPool.size() + _spareConnections,
+                                 _parent->_options.maxConnections));
     };
 
     // While all of our inflight connections are less than our target
@@ -744,7 +952,7 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
         lk.unlock();
         handle->setup(
             _parent->_options.refreshTimeout,
-            guardCallback([this](
+            guardCallback([ this, setupTimer = Timer() ](
                 stdx::unique_lock<stdx::mutex> lk, ConnectionInterface* connPtr, Status status) {
                 auto conn = takeFromProcessingPool(connPtr);
 
@@ -753,6 +961,8 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
                     return;
 
                 if (status.isOK()) {
+                    _setupLatency.record(setupTimer.elapsed());
+
                     // If the host and port was dropped, let the connection lapse
                     if (conn->getGeneration() == _generation) {
                         addToReady(lk, std::move(conn));
@@ -806,7 +1016,7 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
         if (_processingPool.empty() && !_activeClients) {
             // If we have no more clients that require access to us, delist from the parent pool
             LOG(2) << "Delisting connection pool for " << _hostAndPort;
-            _parent->_pools.erase(_hostAndPort);
+            _parent->_delistPool(this);
         }
         return;
     }
@@ -816,16 +1026,16 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // If we were already running and the timer is the same as it was
         // before, nothing to do
-        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().first)
+        if (_state == State::kRunning && _requestTimerExpiration == _requests.front().expiration)
             return;
 
         _state = State::kRunning;
 
         _requestTimer->cancelTimeout();
 
-        _requestTimerExpiration = _requests.front().first;
+        _requestTimerExpiration = _requests.front().expiration;
 
-        auto timeout = _requests.front().first - _parent->_factory->now();
+        auto timeout = _requests.front().expiration - _parent->_factory->now();
 
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
@@ -836,8 +1046,8 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
                 while (_requests.size()) {
                     auto& x = _requests.front();
 
-                    if (x.first <= now) {
-                        auto promise = std::move(x.second);
+                    if (x.expiration <= now) {
+                        auto promise = std::move(x.promise);
                         std::pop_heap(begin(_requests), end(_requests), RequestComparator{});
                         _requests.pop_back();
 
@@ -876,7 +1086,7 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // Set the shutdown timer, this gets reset on any request
         _requestTimer->setTimeout(timeout, [ this, anchor = shared_from_this() ]() {
-            stdx::unique_lock<stdx::mutex> lk(anchor->_parent->_mutex);
+            auto lk = anchor->lockPool();
             if (_state != State::kIdle)
                 return;
 
@@ -29,6 +29,7 @@
 
 #include <memory>
 #include <queue>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/executor/egress_tag_closer.h"
@@ -58,6 +59,9 @@ struct ConnectionPoolStats;
  *
  * The overall workflow here is to manage separate pools for each unique
  * HostAndPort. See comments on the various Options for how the pool operates.
+ *
+ * Each of those specific pools has its own mutex. The ConnectionPool's mutex only guards the map
+ * from host to specific pools, and is never held while acquiring a specific pool's mutex.
  */
 class ConnectionPool : public EgressTagCloser {
     class SpecificPool;
@@ -122,6 +126,23 @@ public:
          */
         Milliseconds hostTimeout = kDefaultHostTimeout;
 
+        /**
+         * The number of independent pools to keep for each host. Requests are striped across
+         * them by calling thread, which spreads contention on a busy host over several mutexes.
+         * The connection limits above apply to each of these pools separately.
+         */
+        size_t poolsPerHost = 1;
+
+        /**
+         * If positive, the pool keeps a moving average of how long requests wait for a
+         * connection. While that average is above this threshold, each fulfilled request adds a
+         * spare connection to open ahead of demand, up to the smaller of maxConnecting and
+         * maxConnections spares. Spares count towards maxConnections. One spare is given back for
+         * each request fulfilled while the average is below half the threshold, and idle spares
+         * lapse like any other idle connection.
+         */
+        Milliseconds adaptiveWaitThreshold = Milliseconds(0);
+
         /**
          * An egress tag closer manager which will provide global access to this connection pool.
          * The manager set's tags and potentially drops connections that don't match those tags.
@@ -150,12 +171,42 @@ public:
     Future<ConnectionHandle> get(const HostAndPort& hostAndPort, Milliseconds timeout);
     void get(const HostAndPort& hostAndPort, Milliseconds timeout, GetConnectionCallback cb);
 
+    /**
+     * Opens minConnections connections to the given host ahead of any request, so the first ones
+     * don't wait for connection setup. The warmed pool is subject to hostTimeout as usual.
+     */
+    void warmUp(const HostAndPort& hostAndPort);
+
     void appendConnectionStats(ConnectionPoolStats* stats) const;
 
     size_t getNumConnectionsPerHost(const HostAndPort& hostAndPort) const;
 
 private:
-    void returnConnection(ConnectionInterface* connection);
+    using StripedPools = std::vector<std::shared_ptr<SpecificPool>>;
+
+    /**
+     * Returns the specific pool for a host and stripe, creating it if needed.
+     */
+    std::shared_ptr<SpecificPool> _getOrCreatePool(const HostAndPort& hostAndPort, size_t stripe);
+
+    /**
+     * Returns a snapshot of all current specific pools.
+     */
+    std::vector<std::shared_ptr<SpecificPool>> _getAllPools() const;
+
+    /**
+     * Returns a snapshot of the specific pools for a host, across all stripes.
+     */
+    std::vector<std::shared_ptr<SpecificPool>> _getPoolsForHost(
+        const HostAndPort& hostAndPort) const;
+
+    /**
+     * Removes a specific pool from the map of pools, if it is still listed there. Called by
+     * specific pools with their own mutex held.
+     */
+    void _delistPool(SpecificPool* pool);
+
+    size_t _stripeForThisThread() const;
 
     std::string _name;
 
@@ -165,9 +216,9 @@ private:
 
     const std::shared_ptr<DependentTypeFactoryInterface> _factory;
 
-    // The global mutex for specific pool access and the generation counter
+    // Guards the map of specific pools. Each specific pool has its own mutex for its state.
     mutable stdx::mutex _mutex;
-    stdx::unordered_map<HostAndPort, std::shared_ptr<SpecificPool>> _pools;
+    stdx::unordered_map<HostAndPort, StripedPools> _pools;
 
     EgressTagCloserManager* _manager;
 };
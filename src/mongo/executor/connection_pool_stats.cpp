@@ -30,12 +30,54 @@
 
 #include "mongo/executor/connection_pool_stats.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/bits.h"
 #include "mongo/util/map_util.h"
 
 namespace mongo {
 namespace executor {
 
+constexpr size_t ConnectionSetupHistogram::kNumBuckets;
+
+void ConnectionSetupHistogram::record(Microseconds latency) {
+    const auto micros = static_cast<unsigned long long>(
+        std::max<long long>(durationCount<Microseconds>(latency), 0));
+    const size_t bucket = micros ? 63 - countLeadingZeros64(micros) : 0;
+
+    ++buckets[std::min(bucket, kNumBuckets - 1)];
+    ++count;
+    totalLatency += latency;
+}
+
+ConnectionSetupHistogram& ConnectionSetupHistogram::operator+=(
+    const ConnectionSetupHistogram& other) {
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        buckets[i] += other.buckets[i];
+    }
+    count += other.count;
+    totalLatency += other.totalLatency;
+
+    return *this;
+}
+
+void ConnectionSetupHistogram::appendToBSON(BSONObjBuilder* builder) const {
+    BSONObjBuilder histogramBuilder(builder->subobjStart("connectionSetup"));
+    {
+        BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
+        for (size_t i = 0; i < kNumBuckets; ++i) {
+            if (buckets[i] == 0)
+                continue;
+            BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+            entryBuilder.append("micros", i ? 1LL << i : 0LL);
+            entryBuilder.append("count", static_cast<long long>(buckets[i]));
+        }
+    }
+    histogramBuilder.append("latency", durationCount<Microseconds>(totalLatency));
+    histogramBuilder.append("count", static_cast<long long>(count));
+}
+
 ConnectionStatsPer::ConnectionStatsPer(size_t nInUse,
                                        size_t nAvailable,
                                        size_t nCreated,
@@ -49,10 +91,32 @@ ConnectionStatsPer& ConnectionStatsPer::operator+=(const ConnectionStatsPer& oth
     available += other.available;
     created += other.created;
     refreshing += other.refreshing;
+    lockContentions += other.lockContentions;
+    lockWaitTime += other.lockWaitTime;
+    setupLatency += other.setupLatency;
 
     return *this;
 }
 
+CommandBatchStats& CommandBatchStats::operator+=(const CommandBatchStats& other) {
+    batches += other.batches;
+    commands += other.commands;
+    totalFirstResponseLatency += other.totalFirstResponseLatency;
+    totalLastResponseLatency += other.totalLastResponseLatency;
+
+    return *this;
+}
+
+void CommandBatchStats::appendToBSON(BSONObjBuilder* builder) const {
+    BSONObjBuilder batchInfo(builder->subobjStart("commandBatches"));
+    batchInfo.appendNumber("batches", batches);
+    batchInfo.appendNumber("commands", commands);
+    batchInfo.appendNumber("firstResponseMicros",
+                           durationCount<Microseconds>(totalFirstResponseLatency));
+    batchInfo.appendNumber("lastResponseMicros",
+                           durationCount<Microseconds>(totalLastResponseLatency));
+}
+
 void ConnectionPoolStats::updateStatsForHost(std::string pool,
                                              HostAndPort host,
                                              ConnectionStatsPer newStats) {
@@ -73,6 +137,9 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
     result.appendNumber("totalAvailable", totalAvailable);
     result.appendNumber("totalCreated", totalCreated);
     result.appendNumber("totalRefreshing", totalRefreshing);
+    if (commandBatches.batches) {
+        commandBatches.appendToBSON(&result);
+    }
 
     {
         BSONObjBuilder poolBuilder(result.subobjStart("pools"));
@@ -90,6 +157,10 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
                 hostInfo.appendNumber("available", hostStats.available);
                 hostInfo.appendNumber("created", hostStats.created);
                 hostInfo.appendNumber("refreshing", hostStats.refreshing);
+                hostInfo.appendNumber("lockContentions", hostStats.lockContentions);
+                hostInfo.appendNumber("lockWaitMicros",
+                                      durationCount<Microseconds>(hostStats.lockWaitTime));
+                hostStats.setupLatency.appendToBSON(&hostInfo);
             }
         }
     }
@@ -102,6 +173,10 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
             hostInfo.appendNumber("available", hostStats.available);
             hostInfo.appendNumber("created", hostStats.created);
             hostInfo.appendNumber("refreshing", hostStats.refreshing);
+            hostInfo.appendNumber("lockContentions", hostStats.lockContentions);
+            hostInfo.appendNumber("lockWaitMicros",
+                                  durationCount<Microseconds>(hostStats.lockWaitTime));
+            hostStats.setupLatency.appendToBSON(&hostInfo);
         }
     }
 }
@@ -28,12 +28,37 @@
 
 #pragma once
 
+#include <array>
+
 #include "mongo/stdx/unordered_map.h"
+#include "mongo/util/duration.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
+
+class BSONObjBuilder;
+
 namespace executor {
 
+/**
+ * Histogram of how long new connections took to set up, which covers connecting, the TLS
+ * handshake and authentication. Bucket i counts setups that took at least 2^i microseconds, and
+ * less than 2^(i+1), with the first and last buckets open ended.
+ */
+struct ConnectionSetupHistogram {
+    static constexpr size_t kNumBuckets = 32;
+
+    void record(Microseconds latency);
+
+    ConnectionSetupHistogram& operator+=(const ConnectionSetupHistogram& other);
+
+    void appendToBSON(BSONObjBuilder* builder) const;
+
+    std::array<size_t, kNumBuckets> buckets{};
+    size_t count = 0u;
+    Microseconds totalLatency{0};
+};
+
 /**
  * Holds connection information for a specific pool or remote host. These objects are maintained by
  * a parent ConnectionPoolStats object and should not need to be created directly.
@@ -49,6 +74,27 @@ struct ConnectionStatsPer {
     size_t available = 0u;
     size_t created = 0u;
     size_t refreshing = 0u;
+
+    // How often acquiring a pool's mutex had to wait, and for how long in total
+    size_t lockContentions = 0u;
+    Microseconds lockWaitTime{0};
+
+    ConnectionSetupHistogram setupLatency;
+};
+
+/**
+ * Fan-out latency of the command batches dispatched by the network interfaces, measured from the
+ * start of each batch to its first and to its last response.
+ */
+struct CommandBatchStats {
+    CommandBatchStats& operator+=(const CommandBatchStats& other);
+
+    void appendToBSON(BSONObjBuilder* builder) const;
+
+    size_t batches = 0u;
+    size_t commands = 0u;
+    Microseconds totalFirstResponseLatency{0};
+    Microseconds totalLastResponseLatency{0};
 };
 
 /**
@@ -66,6 +112,8 @@ struct ConnectionPoolStats {
     size_t totalCreated = 0u;
     size_t totalRefreshing = 0u;
 
+    CommandBatchStats commandBatches;
+
     stdx::unordered_map<std::string, ConnectionStatsPer> statsByPool;
     stdx::unordered_map<HostAndPort, ConnectionStatsPer> statsByHost;
     stdx::unordered_map<std::string, stdx::unordered_map<HostAndPort, ConnectionStatsPer>>
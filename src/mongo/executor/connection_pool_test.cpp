@@ -34,8 +34,10 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
 
@@ -1376,6 +1378,157 @@ TEST_F(ConnectionPoolTest, DropConnectionsByTagInMultipleViaManager) {
     dropConnectionsByTagTest(pool, manager);
 }
 
+/**
+ * Verify that with several pools per host, connections from every stripe are counted and
+ * reported for the host.
+ */
+TEST_F(ConnectionPoolTest, StripedPoolsReportPerHost) {
+    ConnectionPool::Options options;
+    options.poolsPerHost = 4;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    HostAndPort hap("a");
+    std::vector<ConnectionPool::ConnectionHandle> connections;
+    const auto guard = MakeGuard([&] {
+        for (auto& conn : connections) {
+            conn->indicateSuccess();
+        }
+    });
+
+    auto getConn = [&] {
+        ConnectionImpl::pushSetup(Status::OK());
+        pool.get(hap, Seconds(1), [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+            ASSERT(swConn.isOK());
+            connections.push_back(std::move(swConn.getValue()));
+        });
+    };
+
+    // Check out one connection from this thread and one from another, which may use a different
+    // stripe. The threads run one after another, so the mocks are never used concurrently.
+    getConn();
+    stdx::thread(getConn).join();
+
+    ASSERT_EQ(2ul, connections.size());
+    ASSERT_EQ(2ul, pool.getNumConnectionsPerHost(hap));
+
+    ConnectionPoolStats stats;
+    pool.appendConnectionStats(&stats);
+    ASSERT_EQ(2ul, stats.statsByHost[hap].inUse);
+    ASSERT_EQ(2ul, stats.statsByHost[hap].created);
+    ASSERT_EQ(2ul, stats.totalInUse);
+    ASSERT_EQ(2ul, stats.statsByHost[hap].setupLatency.count);
+
+    // Return both connections, then drop them from every stripe.
+    for (auto& conn : connections) {
+        conn->indicateSuccess();
+    }
+    connections.clear();
+    ASSERT_EQ(2ul, pool.getNumConnectionsPerHost(hap));
+
+    pool.dropConnections(hap);
+    ASSERT_EQ(0ul, pool.getNumConnectionsPerHost(hap));
+}
+
+/**
+ * Verify that warming up a host opens minConnections without any request.
+ */
+TEST_F(ConnectionPoolTest, WarmUpOpensMinConnections) {
+    ConnectionPool::Options options;
+    options.minConnections = 3;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    HostAndPort hap("a");
+    pool.warmUp(hap);
+    ASSERT_EQ(3ul, ConnectionImpl::setupQueueDepth());
+
+    for (int i = 0; i < 3; ++i) {
+        ConnectionImpl::pushSetup(Status::OK());
+    }
+    ASSERT_EQ(3ul, pool.getNumConnectionsPerHost(hap));
+
+    // Warming an already warm host opens nothing more
+    pool.warmUp(hap);
+    ASSERT_EQ(0ul, ConnectionImpl::setupQueueDepth());
+    ASSERT_EQ(3ul, pool.getNumConnectionsPerHost(hap));
+}
+
+/**
+ * Verify that once requests wait longer than adaptiveWaitThreshold, the pool opens a spare
+ * connection ahead of the next request.
+ */
+TEST_F(ConnectionPoolTest, SlowRequestsGrowPoolAheadOfDemand) {
+    ConnectionPool::Options options;
+    options.adaptiveWaitThreshold = Milliseconds(50);
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    ConnectionPool::ConnectionHandle conn;
+    pool.get(HostAndPort(), Seconds(5), [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+        ASSERT(swConn.isOK());
+        conn = std::move(swConn.getValue());
+    });
+    ASSERT_EQ(1ul, ConnectionImpl::setupQueueDepth());
+
+    // The request waits a full second for its connection to be set up, which puts the average
+    // wait over the threshold.
+    PoolImpl::setNow(now + Seconds(1));
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn);
+
+    // A spare connection is already being opened, though nothing else has asked for one
+    ASSERT_EQ(1ul, ConnectionImpl::setupQueueDepth());
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT_EQ(2ul, pool.getNumConnectionsPerHost(HostAndPort()));
+
+    doneWith(conn);
+}
+
+/**
+ * Verify that the pool keeps no more spare connections than it may have connecting at once.
+ */
+TEST_F(ConnectionPoolTest, SpareConnectionsAreCappedAtMaxConnecting) {
+    ConnectionPool::Options options;
+    options.adaptiveWaitThreshold = Milliseconds(50);
+    options.maxConnecting = 1;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), "test pool", options);
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    ConnectionPool::ConnectionHandle conn1;
+    pool.get(HostAndPort(), Seconds(5), [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+        ASSERT(swConn.isOK());
+        conn1 = std::move(swConn.getValue());
+    });
+
+    // A slow setup opens the one spare connection allowed
+    now += Seconds(1);
+    PoolImpl::setNow(now);
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn1);
+    ASSERT_EQ(1ul, ConnectionImpl::setupQueueDepth());
+    ConnectionImpl::pushSetup(Status::OK());
+
+    // The next request takes the spare while the average wait is still above the threshold, but
+    // no further spare is opened.
+    ConnectionPool::ConnectionHandle conn2;
+    pool.get(HostAndPort(), Seconds(5), [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+        ASSERT(swConn.isOK());
+        conn2 = std::move(swConn.getValue());
+    });
+    ASSERT(conn2);
+    ASSERT_EQ(0ul, ConnectionImpl::setupQueueDepth());
+    ASSERT_EQ(2ul, pool.getNumConnectionsPerHost(HostAndPort()));
+
+    doneWith(conn1);
+    doneWith(conn2);
+}
+
 }  // namespace connection_pool_test_details
 }  // namespace executor
 }  // namespace mongo
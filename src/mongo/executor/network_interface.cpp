@@ -30,13 +30,59 @@
 
 #include "mongo/executor/network_interface.h"
 
+#include "mongo/util/assert_util.h"
+
 
 namespace mongo {
 namespace executor {
 
+namespace {
+thread_local ScopedCommandBatch* currentCommandBatch = nullptr;
+}  // namespace
+
+ScopedCommandBatch::ScopedCommandBatch() : _isOutermost(currentCommandBatch == nullptr) {
+    if (_isOutermost) {
+        currentCommandBatch = this;
+    }
+}
+
+ScopedCommandBatch::~ScopedCommandBatch() {
+    if (!_isOutermost) {
+        return;
+    }
+
+    // Detach first, so that commands started while dispatching aren't deferred into a batch which
+    // is going away.
+    currentCommandBatch = nullptr;
+    for (auto&& entry : _entries) {
+        entry.first->dispatchCommandBatch(std::move(entry.second));
+    }
+}
+
+ScopedCommandBatch* ScopedCommandBatch::get() {
+    return currentCommandBatch;
+}
+
+ScopedCommandBatch::Entry& ScopedCommandBatch::entryFor(NetworkInterface* net) {
+    invariant(_isOutermost);
+    for (auto&& entry : _entries) {
+        if (entry.first == net) {
+            return entry.second;
+        }
+    }
+    _entries.emplace_back(net, Entry{});
+    return _entries.back().second;
+}
+
 NetworkInterface::NetworkInterface() {}
 NetworkInterface::~NetworkInterface() {}
 
+void NetworkInterface::dispatchCommandBatch(ScopedCommandBatch::Entry entry) {
+    for (auto&& work : entry.work) {
+        work();
+    }
+}
+
 MONGO_FAIL_POINT_DEFINE(networkInterfaceDiscardCommandsBeforeAcquireConn);
 MONGO_FAIL_POINT_DEFINE(networkInterfaceDiscardCommandsAfterAcquireConn);
 
@@ -29,7 +29,10 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/executor/task_executor.h"
@@ -47,6 +50,45 @@ namespace executor {
 MONGO_FAIL_POINT_DECLARE(networkInterfaceDiscardCommandsBeforeAcquireConn);
 MONGO_FAIL_POINT_DECLARE(networkInterfaceDiscardCommandsAfterAcquireConn);
 
+class NetworkInterface;
+
+/**
+ * While an instance is in scope, network interfaces that support it defer the connection
+ * acquisition for commands started on the current thread. When the instance goes out of scope,
+ * each network interface dispatches the commands it collected in a single pass, so that a scatter
+ * to many hosts costs one hop onto the networking thread instead of one per command.
+ *
+ * Instances nested inside another one on the same thread join the outer batch.
+ */
+class ScopedCommandBatch {
+    MONGO_DISALLOW_COPYING(ScopedCommandBatch);
+
+public:
+    struct Entry {
+        std::vector<stdx::function<void()>> work;
+
+        // Opaque state the network interface keeps for the whole batch.
+        std::shared_ptr<void> state;
+    };
+
+    ScopedCommandBatch();
+    ~ScopedCommandBatch();
+
+    /**
+     * Returns the batch active on the current thread, or nullptr if there isn't one.
+     */
+    static ScopedCommandBatch* get();
+
+    /**
+     * Returns the entry in which "net" collects its deferred work for this batch.
+     */
+    Entry& entryFor(NetworkInterface* net);
+
+private:
+    const bool _isOutermost;
+    std::vector<std::pair<NetworkInterface*, Entry>> _entries;
+};
+
 /**
  * Interface to networking for use by TaskExecutor implementations.
  */
@@ -206,8 +248,22 @@ public:
      */
     virtual void dropConnections(const HostAndPort& hostAndPort) = 0;
 
+    /**
+     * Opens the connection pool's minimum number of connections to the given host, if the pool
+     * doesn't hold them yet.
+     */
+    virtual void warmUpConnections(const HostAndPort& hostAndPort) = 0;
+
 protected:
+    friend class ScopedCommandBatch;
+
     NetworkInterface();
+
+    /**
+     * Dispatches the work this network interface deferred into a ScopedCommandBatch. The default
+     * implementation runs it inline.
+     */
+    virtual void dispatchCommandBatch(ScopedCommandBatch::Entry entry);
 };
 
 }  // namespace executor
@@ -37,6 +37,7 @@
 #include "mongo/client/connection_string.h"
 #include "mongo/db/commands/test_commands_enabled.h"
 #include "mongo/db/wire_version.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface_integration_fixture.h"
 #include "mongo/executor/test_network_connection_hook.h"
@@ -316,6 +317,33 @@ TEST_F(NetworkInterfaceTest, StartCommand) {
     assertNumOps(0u, 0u, 0u, 1u);
 }
 
+TEST_F(NetworkInterfaceTest, StartCommandsInBatch) {
+    std::vector<Future<RemoteCommandResponse>> deferreds;
+    {
+        ScopedCommandBatch batch;
+        for (int i = 0; i < 3; ++i) {
+            deferreds.push_back(runCommand(makeCallbackHandle(), makeTestCommand()));
+        }
+
+        // Nothing is sent until the batch goes out of scope
+        ASSERT_FALSE(hasIsMaster());
+    }
+
+    for (auto&& deferred : deferreds) {
+        auto res = deferred.get();
+        uassertStatusOK(res.status);
+        ASSERT_EQ(res.data.getIntField("ok"), 1);
+    }
+    assertNumOps(0u, 0u, 0u, 3u);
+
+    ConnectionPoolStats stats;
+    net().appendConnectionStats(&stats);
+    ASSERT_EQ(1u, stats.commandBatches.batches);
+    ASSERT_EQ(3u, stats.commandBatches.commands);
+    ASSERT_LTE(stats.commandBatches.totalFirstResponseLatency,
+               stats.commandBatches.totalLastResponseLatency);
+}
+
 TEST_F(NetworkInterfaceTest, SetAlarm) {
     // set a first alarm, to execute after "expiration"
     Date_t expiration = net().now() + Milliseconds(100);
@@ -39,10 +39,55 @@
 #include "mongo/util/concurrency/idle_thread_block.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/socket_utils.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace executor {
 
+/**
+ * Tracks the responses to the commands of one ScopedCommandBatch, and reports its fan-out latency
+ * once all of them are done.
+ */
+struct NetworkInterfaceTL::CommandBatchState {
+    explicit CommandBatchState(NetworkInterfaceTL* net_) : net(net_) {}
+
+    void addCommand() {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        ++commands;
+        ++outstanding;
+    }
+
+    // Called once per command when it finishes, and once by the batch when it's dispatched
+    void release(bool isResponse) {
+        Microseconds first;
+        Microseconds last{timer.micros()};
+        size_t numCommands;
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (isResponse && !firstResponseLatency) {
+                firstResponseLatency = last;
+            }
+            if (--outstanding) {
+                return;
+            }
+            first = *firstResponseLatency;
+            numCommands = commands;
+        }
+
+        net->_recordCommandBatch(numCommands, first, last);
+    }
+
+    NetworkInterfaceTL* const net;
+    const Timer timer;
+
+    stdx::mutex mutex;
+    size_t commands = 0;
+
+    // Starts out holding a reference for the batch itself, which is dropped on dispatch
+    size_t outstanding = 1;
+    boost::optional<Microseconds> firstResponseLatency;
+};
+
 NetworkInterfaceTL::NetworkInterfaceTL(std::string instanceName,
                                        ConnectionPool::Options connPoolOpts,
                                        ServiceContext* svcCtx,
@@ -69,6 +114,9 @@ void NetworkInterfaceTL::appendConnectionStats(ConnectionPoolStats* stats) const
     }();
     if (pool)
         pool->appendConnectionStats(stats);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    stats->commandBatches += _commandBatchStats;
 }
 
 NetworkInterface::Counters NetworkInterfaceTL::getCounters() const {
@@ -219,7 +267,7 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
     // return on the reactor thread.
     //
     // TODO: get rid of this cruft once we have a connection pool that's executor aware.
-    auto connFuture = _reactor->execute([this, state, request, baton] {
+    auto acquireConn = [this, state, request, baton] {
         return makeReadyFutureWith(
                    [this, request] { return _pool->get(request.target, request.timeout); })
             .tapError([state](Status error) {
@@ -233,10 +281,39 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
                 return std::make_shared<CommandState::ConnHandle>(
                     conn.release(), CommandState::Deleter{deleter, _reactor});
             });
-    });
+    };
+
+    // Inside a ScopedCommandBatch the connection is acquired later, together with those of the
+    // other commands in the batch, when the batch is dispatched in a single reactor task.
+    std::shared_ptr<CommandBatchState> batchState;
+    auto connFuture = [&] {
+        auto batch = ScopedCommandBatch::get();
+        if (!batch) {
+            return _reactor->execute(std::move(acquireConn));
+        }
 
-    auto remainingWork = [ this, state, future = std::move(pf.future), baton, onFinish ](
-        StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) mutable {
+        auto& entry = batch->entryFor(this);
+        if (!entry.state) {
+            entry.state = std::make_shared<CommandBatchState>(this);
+        }
+        batchState = std::static_pointer_cast<CommandBatchState>(entry.state);
+        batchState->addCommand();
+
+        auto connPF = makePromiseFuture<std::shared_ptr<CommandState::ConnHandle>>();
+        entry.work.push_back([ acquireConn, promise = connPF.promise.share() ]() mutable {
+            promise.setFrom(acquireConn());
+        });
+        return std::move(connPF.future);
+    }();
+
+    auto remainingWork = [
+        this,
+        state,
+        future = std::move(pf.future),
+        baton,
+        onFinish,
+        batchState
+    ](StatusWith<std::shared_ptr<CommandState::ConnHandle>> swConn) mutable {
         makeReadyFutureWith([&] {
             return _onAcquireConn(
                 state, std::move(future), std::move(*uassertStatusOK(swConn)), baton);
@@ -249,7 +326,12 @@ Status NetworkInterfaceTL::startCommand(const TaskExecutor::CallbackHandle& cbHa
                 }
                 return error;
             })
-            .getAsync([this, state, onFinish](StatusWith<RemoteCommandResponse> response) {
+            .getAsync([this, state, onFinish, batchState](
+                StatusWith<RemoteCommandResponse> response) {
+                if (batchState) {
+                    batchState->release(true);
+                }
+
                 auto duration = now() - state->start;
                 if (!response.isOK()) {
                     onFinish(RemoteCommandResponse(response.getStatus(), duration));
@@ -397,6 +479,33 @@ void NetworkInterfaceTL::_eraseInUseConn(const TaskExecutor::CallbackHandle& cbH
     _inProgress.erase(cbHandle);
 }
 
+void NetworkInterfaceTL::dispatchCommandBatch(ScopedCommandBatch::Entry entry) {
+    auto batchState = std::static_pointer_cast<CommandBatchState>(entry.state);
+
+    _reactor->schedule(transport::Reactor::kPost, [work = std::move(entry.work)] {
+        for (auto&& acquireConn : work) {
+            acquireConn();
+        }
+    });
+
+    if (batchState) {
+        batchState->release(false);
+    }
+}
+
+void NetworkInterfaceTL::_recordCommandBatch(size_t commands,
+                                             Microseconds firstResponseLatency,
+                                             Microseconds lastResponseLatency) {
+    LOG(2) << "Batch of " << commands << " commands got its first response after "
+           << firstResponseLatency << " and its last after " << lastResponseLatency;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _commandBatchStats.batches++;
+    _commandBatchStats.commands += commands;
+    _commandBatchStats.totalFirstResponseLatency += firstResponseLatency;
+    _commandBatchStats.totalLastResponseLatency += lastResponseLatency;
+}
+
 void NetworkInterfaceTL::cancelCommand(const TaskExecutor::CallbackHandle& cbHandle,
                                        const transport::BatonHandle& baton) {
     stdx::unique_lock<stdx::mutex> lk(_inProgressMutex);
@@ -494,5 +603,9 @@ void NetworkInterfaceTL::dropConnections(const HostAndPort& hostAndPort) {
     _pool->dropConnections(hostAndPort);
 }
 
+void NetworkInterfaceTL::warmUpConnections(const HostAndPort& hostAndPort) {
+    _pool->warmUp(hostAndPort);
+}
+
 }  // namespace executor
 }  // namespace mongo
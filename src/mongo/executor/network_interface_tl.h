@@ -33,6 +33,7 @@
 #include "mongo/client/async_client.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/rpc/metadata/metadata_hook.h"
 #include "mongo/stdx/thread.h"
@@ -77,8 +78,14 @@ public:
     bool onNetworkThread() override;
 
     void dropConnections(const HostAndPort& hostAndPort) override;
+    void warmUpConnections(const HostAndPort& hostAndPort) override;
+
+protected:
+    void dispatchCommandBatch(ScopedCommandBatch::Entry entry) override;
 
 private:
+    struct CommandBatchState;
+
     struct CommandState {
         CommandState(RemoteCommandRequest request_,
                      TaskExecutor::CallbackHandle cbHandle_,
@@ -116,6 +123,9 @@ private:
                                                  Future<RemoteCommandResponse> future,
                                                  CommandState::ConnHandle conn,
                                                  const transport::BatonHandle& baton);
+    void _recordCommandBatch(size_t commands,
+                             Microseconds firstResponseLatency,
+                             Microseconds lastResponseLatency);
 
     std::string _instanceName;
     ServiceContext* _svcCtx;
@@ -129,6 +139,7 @@ private:
     std::unique_ptr<NetworkConnectionHook> _onConnectHook;
     std::unique_ptr<ConnectionPool> _pool;
     Counters _counters;
+    CommandBatchStats _commandBatchStats;
 
     std::unique_ptr<rpc::EgressMetadataHook> _metadataHook;
     AtomicBool _inShutdown;
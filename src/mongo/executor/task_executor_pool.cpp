@@ -106,5 +106,14 @@ void TaskExecutorPool::appendConnectionStats(ConnectionPoolStats* stats) const {
     }
 }
 
+void TaskExecutorPool::warmUpConnections(const std::vector<HostAndPort>& hosts) {
+    for (const auto& host : hosts) {
+        _fixedExecutor->warmUpConnections(host);
+        for (auto&& executor : _executors) {
+            executor->warmUpConnections(host);
+        }
+    }
+}
+
 }  // namespace executor
 }  // namespace mongo
@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/net/hostandport.h"
 
 namespace mongo {
 namespace executor {
@@ -111,6 +112,11 @@ public:
      */
     void appendConnectionStats(ConnectionPoolStats* stats) const;
 
+    /**
+     * Warms up the connection pools of all of the executors in the pool for the given hosts.
+     */
+    void warmUpConnections(const std::vector<HostAndPort>& hosts);
+
 private:
     AtomicUInt32 _counter;
 
@@ -615,5 +615,9 @@ void ThreadPoolTaskExecutor::dropConnections(const HostAndPort& hostAndPort) {
     _net->dropConnections(hostAndPort);
 }
 
+void ThreadPoolTaskExecutor::warmUpConnections(const HostAndPort& hostAndPort) {
+    _net->warmUpConnections(hostAndPort);
+}
+
 }  // namespace executor
 }  // namespace mongo
@@ -88,6 +88,7 @@ public:
     void wait(const CallbackHandle& cbHandle) override;
 
     void appendConnectionStats(ConnectionPoolStats* stats) const override;
+    void warmUpConnections(const HostAndPort& hostAndPort) override;
 
     /**
      * Drops all connections to the given host on the network interface.
@@ -0,0 +1,326 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_appender.h"
+
+#include <algorithm>
+#include <set>
+
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+
+namespace {
+
+// The number of records each thread can have buffered.
+const size_t kThreadBufferSlots = 256;
+
+// How long the writer sleeps when there is nothing to write, unless a logging thread wakes it.
+const Milliseconds kWriterIdleWait{100};
+
+AtomicUInt64 nextAppenderId{1};
+
+stdx::mutex registryMutex;
+std::set<AsyncAppender*>* registry = new std::set<AsyncAppender*>();
+
+// Set while this thread is writing to the wrapped appender, so that a fatal error raised from
+// there does not wait for itself.
+thread_local bool isDraining = false;
+
+// Set once this thread's buffers have been destroyed at thread exit, after which its events are
+// written synchronously.
+thread_local bool threadBuffersDestroyed = false;
+
+}  // namespace
+
+/**
+ * An owned copy of a MessageEventEphemeral.
+ */
+struct AsyncAppender::Record {
+    Record(const MessageEventEphemeral& event, uint64_t sequence)
+        : sequence(sequence),
+          date(event.getDate()),
+          severity(event.getSeverity()),
+          component(event.getComponent()),
+          contextName(event.getContextName().toString()),
+          message(event.getMessage().toString()),
+          isTruncatable(event.isTruncatable()) {}
+
+    int64_t sizeBytes() const {
+        return sizeof(Record) + contextName.size() + message.size();
+    }
+
+    MessageEventEphemeral toEvent() const {
+        MessageEventEphemeral event(date, severity, component, contextName, message);
+        event.setIsTruncatable(isTruncatable);
+        return event;
+    }
+
+    uint64_t sequence;
+    Date_t date;
+    LogSeverity severity;
+    LogComponent component;
+    std::string contextName;
+    std::string message;
+    bool isTruncatable;
+};
+
+/**
+ * A single-producer, single-consumer ring of records. The producer is the thread that owns the
+ * buffer, and the consumer is whichever thread holds _drainMutex.
+ */
+class AsyncAppender::ThreadBuffer {
+public:
+    /**
+     * Returns false, keeping "record", if the ring is full.
+     */
+    bool push(std::unique_ptr<Record>& record) {
+        const uint64_t tail = _tail.load();
+        if (tail - _head.load() == kThreadBufferSlots) {
+            return false;
+        }
+        _slots[tail % kThreadBufferSlots] = std::move(record);
+        _tail.store(tail + 1);
+        return true;
+    }
+
+    /**
+     * Moves every record in the ring to the back of "out".
+     */
+    void popAll(std::vector<std::unique_ptr<Record>>* out) {
+        const uint64_t tail = _tail.load();
+        uint64_t head = _head.load();
+        for (; head != tail; ++head) {
+            out->push_back(std::move(_slots[head % kThreadBufferSlots]));
+        }
+        _head.store(head);
+    }
+
+    bool isEmpty() const {
+        return _head.load() == _tail.load();
+    }
+
+    // Set when the owning thread exits, after which the buffer is dropped once it is drained.
+    AtomicBool abandoned{false};
+
+private:
+    std::unique_ptr<Record> _slots[kThreadBufferSlots];
+    AtomicUInt64 _head{0};  // Written by the consumer.
+    AtomicUInt64 _tail{0};  // Written by the producer.
+};
+
+/**
+ * The buffers of the current thread, keyed by appender id. Marks them abandoned on thread exit.
+ */
+struct AsyncAppender::ThreadBuffers {
+    ~ThreadBuffers() {
+        threadBuffersDestroyed = true;
+        for (auto&& entry : buffers) {
+            entry.second->abandoned.store(true);
+        }
+    }
+
+    std::vector<std::pair<uint64_t, std::shared_ptr<ThreadBuffer>>> buffers;
+};
+
+AsyncAppender::AsyncAppender(std::unique_ptr<EventAppender> appender, size_t maxBufferedBytes)
+    : _appender(std::move(appender)),
+      _maxBufferedBytes(maxBufferedBytes),
+      _id(nextAppenderId.fetchAndAdd(1)) {
+    _writer = stdx::thread([this] { _writerThreadBody(); });
+
+    stdx::lock_guard<stdx::mutex> lk(registryMutex);
+    registry->insert(this);
+}
+
+AsyncAppender::~AsyncAppender() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(registryMutex);
+        registry->erase(this);
+    }
+    {
+        stdx::lock_guard<stdx::mutex> lk(_wakeupMutex);
+        _shuttingDown = true;
+        _wakeup.notify_one();
+    }
+    _writer.join();
+    flush();
+}
+
+Status AsyncAppender::append(const MessageEventEphemeral& event) {
+    _numAppended.fetchAndAdd(1);
+
+    ThreadBuffer* const buffer = _getThreadBuffer();
+    if (!buffer || event.getSeverity() >= LogSeverity::Severe()) {
+        if (isDraining) {
+            return _appender->append(event);
+        }
+        stdx::lock_guard<stdx::mutex> lk(_drainMutex);
+        _drain_inlock();
+        return _appender->append(event);
+    }
+
+    auto record = stdx::make_unique<Record>(event, _nextSequence.fetchAndAdd(1));
+    const int64_t size = record->sizeBytes();
+    if (_bufferedBytes.addAndFetch(size) > static_cast<int64_t>(_maxBufferedBytes) ||
+        !buffer->push(record)) {
+        _bufferedBytes.subtractAndFetch(size);
+        _numDropped.fetchAndAdd(1);
+        return Status::OK();
+    }
+
+    // A wakeup lost to a race with the writer going to sleep only delays writing until the writer
+    // wakes up by itself.
+    if (_writerSleeping.load()) {
+        _wakeup.notify_one();
+    }
+    return Status::OK();
+}
+
+void AsyncAppender::flush() {
+    if (isDraining) {
+        return;
+    }
+    stdx::lock_guard<stdx::mutex> lk(_drainMutex);
+    _drain_inlock();
+}
+
+void AsyncAppender::flushAll() {
+    stdx::lock_guard<stdx::mutex> lk(registryMutex);
+    for (auto&& appender : *registry) {
+        appender->flush();
+    }
+}
+
+AsyncAppender::Stats AsyncAppender::getStats() const {
+    Stats stats;
+    stats.numAppended = _numAppended.load();
+    stats.numDropped = _numDropped.load();
+    stats.bufferedBytes = _bufferedBytes.load();
+    return stats;
+}
+
+AsyncAppender::ThreadBuffer* AsyncAppender::_getThreadBuffer() {
+    if (threadBuffersDestroyed) {
+        return nullptr;
+    }
+
+    thread_local ThreadBuffers threadBuffers;
+    for (auto&& entry : threadBuffers.buffers) {
+        if (entry.first == _id) {
+            return entry.second.get();
+        }
+    }
+
+    auto buffer = std::make_shared<ThreadBuffer>();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_buffersMutex);
+        _buffers.push_back(buffer);
+    }
+    threadBuffers.buffers.emplace_back(_id, buffer);
+    return buffer.get();
+}
+
+size_t AsyncAppender::_drain_inlock() {
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_buffersMutex);
+        // A buffer is only dropped once its thread has exited and it is empty, so that no record
+        // in it can be lost.
+        _buffers.erase(std::remove_if(_buffers.begin(),
+                                      _buffers.end(),
+                                      [](const std::shared_ptr<ThreadBuffer>& buffer) {
+                                          return buffer->abandoned.load() && buffer->isEmpty();
+                                      }),
+                       _buffers.end());
+        buffers = _buffers;
+    }
+
+    std::vector<std::unique_ptr<Record>> records;
+    for (auto&& buffer : buffers) {
+        buffer->popAll(&records);
+    }
+    std::sort(records.begin(),
+              records.end(),
+              [](const std::unique_ptr<Record>& a, const std::unique_ptr<Record>& b) {
+                  return a->sequence < b->sequence;
+              });
+
+    isDraining = true;
+    for (auto&& record : records) {
+        _appender->append(record->toEvent()).transitional_ignore();
+        _bufferedBytes.subtractAndFetch(record->sizeBytes());
+    }
+
+    const int64_t numDropped = _numDropped.load();
+    if (numDropped != _numDropsReported) {
+        const std::string message = str::stream()
+            << "Dropped " << (numDropped - _numDropsReported)
+            << " log messages because the asynchronous log buffer was full";
+        _appender
+            ->append(MessageEventEphemeral(
+                Date_t::now(), LogSeverity::Warning(), getThreadName(), message))
+            .transitional_ignore();
+        _numDropsReported = numDropped;
+    }
+    isDraining = false;
+
+    return records.size();
+}
+
+void AsyncAppender::_writerThreadBody() {
+    setThreadName("AsyncLogWriter");
+    while (true) {
+        size_t numWritten;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_drainMutex);
+            numWritten = _drain_inlock();
+        }
+        if (numWritten > 0) {
+            continue;
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_wakeupMutex);
+        if (_shuttingDown) {
+            return;
+        }
+        _writerSleeping.store(true);
+        _wakeup.wait_for(lk, kWriterIdleWait.toSystemDuration());
+        _writerSleeping.store(false);
+    }
+}
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace logger {
+
+/**
+ * Appender that hands events to another appender from a background thread, so that logging
+ * threads do not wait for the other appender's I/O.
+ *
+ * Each logging thread copies its events into a ring buffer of its own, which only it writes to
+ * and only the background thread reads from, so appending takes no lock. Events that do not fit,
+ * because the thread's ring is full or the total size of buffered events exceeds the memory
+ * budget, are dropped and counted, and the background thread reports the count in the log.
+ *
+ * Severe events are written synchronously, after everything buffered before them, so that the
+ * messages logged on the way to a fatal assertion are on disk before the process dies. flush()
+ * and flushAll() do the same on demand, e.g. at shutdown.
+ */
+class AsyncAppender : public Appender<MessageEventEphemeral> {
+    MONGO_DISALLOW_COPYING(AsyncAppender);
+
+public:
+    using EventAppender = Appender<MessageEventEphemeral>;
+
+    struct Stats {
+        int64_t numAppended = 0;
+        int64_t numDropped = 0;
+        int64_t bufferedBytes = 0;
+    };
+
+    /**
+     * Constructs an appender that writes to "appender" from a background thread, keeping at most
+     * "maxBufferedBytes" of events buffered.
+     */
+    AsyncAppender(std::unique_ptr<EventAppender> appender, size_t maxBufferedBytes);
+
+    /**
+     * Writes every buffered event and stops the background thread.
+     */
+    ~AsyncAppender() override;
+
+    Status append(const MessageEventEphemeral& event) override;
+
+    /**
+     * Writes every event buffered before this call.
+     */
+    void flush();
+
+    /**
+     * Flushes every live AsyncAppender. Called before the process exits.
+     */
+    static void flushAll();
+
+    Stats getStats() const;
+
+private:
+    struct Record;
+    class ThreadBuffer;
+    struct ThreadBuffers;
+
+    /**
+     * Returns this thread's buffer, creating and registering it on first use, or nullptr if the
+     * thread is exiting and its buffers are gone.
+     */
+    ThreadBuffer* _getThreadBuffer();
+
+    /**
+     * Writes every record currently buffered, in the order they were appended, and returns the
+     * number written. Must be called with _drainMutex held.
+     */
+    size_t _drain_inlock();
+
+    void _writerThreadBody();
+
+    const std::unique_ptr<EventAppender> _appender;
+    const size_t _maxBufferedBytes;
+
+    // Distinguishes this appender from ones that lived at the same address, in the thread-local
+    // map from appenders to buffers.
+    const uint64_t _id;
+
+    // Protects _buffers. Only taken when a thread appends for the first time and when draining.
+    stdx::mutex _buffersMutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> _buffers;
+
+    // Held while writing to _appender, so that only one thread consumes from the buffers.
+    stdx::mutex _drainMutex;
+
+    // Orders records from different threads.
+    AtomicUInt64 _nextSequence{0};
+
+    AtomicInt64 _bufferedBytes{0};
+    AtomicInt64 _numAppended{0};
+    AtomicInt64 _numDropped{0};
+
+    // The number of drops already reported in the log. Guarded by _drainMutex.
+    int64_t _numDropsReported = 0;
+
+    stdx::mutex _wakeupMutex;
+    stdx::condition_variable _wakeup;
+    AtomicBool _writerSleeping{false};
+    bool _shuttingDown = false;  // Guarded by _wakeupMutex.
+
+    stdx::thread _writer;
+};
+
+}  // namespace logger
+}  // namespace mongo
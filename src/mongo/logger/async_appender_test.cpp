@@ -0,0 +1,140 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_appender.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+namespace {
+
+/**
+ * Records the messages appended to it.
+ */
+class RecordingAppender : public Appender<MessageEventEphemeral> {
+public:
+    struct State {
+        stdx::mutex mutex;
+        std::vector<std::string> messages;
+    };
+
+    explicit RecordingAppender(State* state) : _state(state) {}
+
+    Status append(const MessageEventEphemeral& event) override {
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        _state->messages.push_back(event.getMessage().toString());
+        return Status::OK();
+    }
+
+private:
+    State* const _state;
+};
+
+MessageEventEphemeral makeEvent(LogSeverity severity, StringData message) {
+    return MessageEventEphemeral(Date_t::now(), severity, "test", message);
+}
+
+TEST(AsyncAppenderTest, FlushWritesEventsInOrder) {
+    RecordingAppender::State state;
+    AsyncAppender appender(stdx::make_unique<RecordingAppender>(&state), 1024 * 1024);
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), std::to_string(i))));
+    }
+    appender.flush();
+
+    stdx::lock_guard<stdx::mutex> lk(state.mutex);
+    ASSERT_EQ(100U, state.messages.size());
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_EQ(std::to_string(i), state.messages[i]);
+    }
+}
+
+TEST(AsyncAppenderTest, EventsFromManyThreadsAreAllWritten) {
+    RecordingAppender::State state;
+    {
+        AsyncAppender appender(stdx::make_unique<RecordingAppender>(&state), 16 * 1024 * 1024);
+        std::vector<stdx::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&] {
+                for (int i = 0; i < 200; ++i) {
+                    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "message")));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        ASSERT_EQ(800, appender.getStats().numAppended);
+    }
+
+    // Destroying the appender writes everything left.
+    stdx::lock_guard<stdx::mutex> lk(state.mutex);
+    ASSERT_EQ(800U, state.messages.size());
+}
+
+TEST(AsyncAppenderTest, SevereEventsAreWrittenAfterEarlierEvents) {
+    RecordingAppender::State state;
+    AsyncAppender appender(stdx::make_unique<RecordingAppender>(&state), 1024 * 1024);
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "first")));
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Severe(), "fatal")));
+
+    // No flush: the severe event was written synchronously.
+    stdx::lock_guard<stdx::mutex> lk(state.mutex);
+    ASSERT_EQ(2U, state.messages.size());
+    ASSERT_EQ("first", state.messages[0]);
+    ASSERT_EQ("fatal", state.messages[1]);
+}
+
+TEST(AsyncAppenderTest, EventsOverTheBudgetAreDroppedAndReported) {
+    RecordingAppender::State state;
+    AsyncAppender appender(stdx::make_unique<RecordingAppender>(&state), 1);
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "dropped")));
+    ASSERT_EQ(1, appender.getStats().numDropped);
+    ASSERT_EQ(0, appender.getStats().bufferedBytes);
+    appender.flush();
+
+    stdx::lock_guard<stdx::mutex> lk(state.mutex);
+    ASSERT_EQ(1U, state.messages.size());
+    ASSERT_EQ("Dropped 1 log messages because the asynchronous log buffer was full",
+              state.messages[0]);
+}
+
+}  // namespace
+}  // namespace logger
+}  // namespace mongo
@@ -32,8 +32,14 @@
 
 #include "mongo/s/async_requests_sender.h"
 
+#include "mongo/base/counter.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/client/replica_set_monitor.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/killcursors_request.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/executor/network_interface.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/s/client/shard_registry.h"
@@ -49,11 +55,89 @@ namespace mongo {
 
 MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderUseBaton, bool, true);
 
+// How long to wait for an idempotent "nearest" or "secondaryPreferred" read before sending it to a
+// second eligible host of the same shard as well. Zero disables hedged reads.
+MONGO_EXPORT_SERVER_PARAMETER(AsyncRequestsSenderHedgeDelayMS, int, 0)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "AsyncRequestsSenderHedgeDelayMS must be greater than or equal to 0");
+        }
+        return Status::OK();
+    });
+
 namespace {
 
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Host selection for the read preferences which are hedged is randomized. It favors the less loaded
+// of two random eligible hosts, and the host already in use counts the outstanding request against
+// it, so a few attempts usually find another host when there is one.
+const int kMaxHedgeHostSelectionAttempts = 5;
+
+Counter64 hedgedReadsIssued;
+Counter64 hedgedReadsWon;
+ServerStatusMetricField<Counter64> displayHedgedReadsIssued("query.hedgedReads.issued",
+                                                            &hedgedReadsIssued);
+ServerStatusMetricField<Counter64> displayHedgedReadsWon("query.hedgedReads.won",
+                                                         &hedgedReadsWon);
+
+/**
+ * Returns the monitor which tracks the members of 'shard', or nullptr if it is not a replica set.
+ */
+std::shared_ptr<ReplicaSetMonitor> getReplicaSetMonitor(const std::shared_ptr<Shard>& shard) {
+    if (!shard || shard->getConnString().type() != ConnectionString::SET) {
+        return nullptr;
+    }
+    return ReplicaSetMonitor::get(shard->getConnString().getSetName());
+}
+
+/**
+ * Returns how long to wait for a remote before hedging requests sent with 'readPreference' and
+ * 'retryPolicy', or zero if they are not hedged. Only idempotent reads which any eligible member of
+ * a shard may serve are hedged.
+ */
+Milliseconds getHedgeDelay(const ReadPreferenceSetting& readPreference,
+                           Shard::RetryPolicy retryPolicy) {
+    const auto hedgeDelayMS = AsyncRequestsSenderHedgeDelayMS.load();
+    if (hedgeDelayMS > 0 && retryPolicy == Shard::RetryPolicy::kIdempotent &&
+        (readPreference.pref == ReadPreference::Nearest ||
+         readPreference.pref == ReadPreference::SecondaryPreferred)) {
+        return Milliseconds(hedgeDelayMS);
+    }
+    return Milliseconds(0);
+}
+
+/**
+ * Makes a best effort to kill the cursor opened by the request which 'cbData' answers, if any,
+ * without waiting for the killCursors command. Used for requests which lost a hedged race.
+ */
+void killCursorOpenedBy(executor::TaskExecutor* executor,
+                        const std::string& db,
+                        const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+    if (!cbData.response.isOK()) {
+        return;
+    }
+
+    auto cursorElem = cbData.response.data["cursor"];
+    if (cursorElem.type() != BSONType::Object) {
+        return;
+    }
+    const CursorId cursorId = cursorElem["id"].safeNumberLong();
+    if (!cursorId || cursorElem["ns"].type() != BSONType::String) {
+        return;
+    }
+
+    const NamespaceString nss(cursorElem["ns"].valueStringData());
+    executor::RemoteCommandRequest request(
+        cbData.request.target, db, KillCursorsRequest(nss, {cursorId}).toBSON(), nullptr);
+    executor
+        ->scheduleRemoteCommand(request,
+                                [](const executor::TaskExecutor::RemoteCommandCallbackArgs&) {})
+        .status_with_transitional_ignore();
+}
+
 }  // namespace
 
 AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
@@ -64,7 +148,8 @@ AsyncRequestsSender::AsyncRequestsSender(OperationContext* opCtx,
                                          Shard::RetryPolicy retryPolicy)
     : _opCtx(opCtx),
       _executor(executor),
-      _baton(opCtx),
+      _hedgeDelay(getHedgeDelay(readPreference, retryPolicy)),
+      _baton(opCtx, _hedgeDelay == Milliseconds(0)),
       _db(dbName.toString()),
       _readPreference(readPreference),
       _retryPolicy(retryPolicy) {
@@ -87,6 +172,18 @@ AsyncRequestsSender::~AsyncRequestsSender() {
     while (!done()) {
         next();
     }
+
+    // Requests which lost a hedged race are not waited for, but their responses may have been
+    // queued before they lost.
+    while (auto job = _responseQueue.tryPop()) {
+        if (*job) {
+            killCursorOpenedBy(_executor, _db, (*job)->cbData);
+        }
+    }
+
+    for (const auto& timer : _hedgeTimers) {
+        _executor->wait(timer);
+    }
 }
 
 AsyncRequestsSender::Response AsyncRequestsSender::next() {
@@ -131,12 +228,22 @@ void AsyncRequestsSender::_cancelPendingRequests() {
         if (remote.cbHandle.isValid()) {
             _executor->cancel(remote.cbHandle);
         }
+        if (remote.hedgeCbHandle.isValid()) {
+            _executor->cancel(remote.hedgeCbHandle);
+        }
+    }
+
+    for (const auto& timer : _hedgeTimers) {
+        _executor->cancel(timer);
     }
 }
 
 boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
     if (!_stopRetrying) {
         _scheduleRequests();
+        if (_hedgeDelay > Milliseconds(0)) {
+            _scheduleHedgedRequests();
+        }
     }
 
     // Check if any remote is ready.
@@ -167,7 +274,17 @@ boost::optional<AsyncRequestsSender::Response> AsyncRequestsSender::_ready() {
 
 void AsyncRequestsSender::_scheduleRequests() {
     invariant(!_stopRetrying);
+
+    auto failRemote = [this](RemoteData& remote, Status status) {
+        remote.swResponse = std::move(status);
+
+        // Push a noop response to the queue to indicate that a remote is ready for
+        // re-processing due to failure.
+        _responseQueue.push(boost::none);
+    };
+
     // Schedule remote work on hosts for which we have not sent a request or need to retry.
+    std::vector<size_t> toSchedule;
     for (size_t i = 0; i < _remotes.size(); ++i) {
         auto& remote = _remotes[i];
 
@@ -205,17 +322,27 @@ void AsyncRequestsSender::_scheduleRequests() {
         }
 
         // If the remote does not have a response or pending request, schedule remote work for it.
+        // Targeting can block on replica set discovery, so do it for every remote before sending
+        // anything.
         if (!remote.swResponse && !remote.cbHandle.isValid()) {
-            auto scheduleStatus = _scheduleRequest(i);
-            if (!scheduleStatus.isOK()) {
-                remote.swResponse = std::move(scheduleStatus);
-
-                // Push a noop response to the queue to indicate that a remote is ready for
-                // re-processing due to failure.
-                _responseQueue.push(boost::none);
+            auto resolveStatus = remote.resolveShardIdToHostAndPort(this, _readPreference);
+            if (!resolveStatus.isOK()) {
+                failRemote(remote, std::move(resolveStatus));
+            } else {
+                toSchedule.push_back(i);
             }
         }
     }
+
+    // Hand the requests to the network in one batch, so that their connections are acquired and
+    // their writes issued together rather than one remote at a time.
+    executor::ScopedCommandBatch commandBatch;
+    for (auto i : toSchedule) {
+        auto scheduleStatus = _scheduleRequest(i);
+        if (!scheduleStatus.isOK()) {
+            failRemote(_remotes[i], std::move(scheduleStatus));
+        }
+    }
 }
 
 Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
@@ -223,27 +350,127 @@ Status AsyncRequestsSender::_scheduleRequest(size_t remoteIndex) {
 
     invariant(!remote.cbHandle.isValid());
     invariant(!remote.swResponse);
+    invariant(remote.shardHostAndPort);
 
-    Status resolveStatus = remote.resolveShardIdToHostAndPort(this, _readPreference);
-    if (!resolveStatus.isOK()) {
-        return resolveStatus;
+    auto requestState = std::make_shared<RequestState>();
+    auto callbackStatus =
+        _scheduleRemoteCommand(remoteIndex, *remote.shardHostAndPort, false, requestState);
+    if (!callbackStatus.isOK()) {
+        return callbackStatus.getStatus();
     }
 
-    executor::RemoteCommandRequest request(
-        *remote.shardHostAndPort, _db, remote.cmdObj, _metadataObj, _opCtx);
+    remote.cbHandle = callbackStatus.getValue();
+    remote.requestState = std::move(requestState);
+    remote.hedgeSent = false;
+
+    if (_hedgeDelay > Milliseconds(0)) {
+        // Wake up next() once it is time to hedge this request.
+        remote.hedgeAt = _executor->now() + _hedgeDelay;
+        auto timerStatus = _executor->scheduleWorkAt(
+            remote.hedgeAt, [this](const executor::TaskExecutor::CallbackArgs& args) {
+                if (args.status.isOK()) {
+                    _responseQueue.push(boost::none);
+                }
+            });
+        if (timerStatus.isOK()) {
+            _hedgeTimers.push_back(std::move(timerStatus.getValue()));
+        } else {
+            // Without a timer the request may never be hedged, which is only a missed optimization.
+            remote.hedgeSent = true;
+        }
+    }
+    return Status::OK();
+}
 
+StatusWith<executor::TaskExecutor::CallbackHandle> AsyncRequestsSender::_scheduleRemoteCommand(
+    size_t remoteIndex,
+    const HostAndPort& host,
+    bool isHedge,
+    std::shared_ptr<RequestState> requestState) {
+    auto& remote = _remotes[remoteIndex];
+    auto monitor = getReplicaSetMonitor(remote.getShard());
+
+    executor::RemoteCommandRequest request(host, _db, remote.cmdObj, _metadataObj, _opCtx);
     auto callbackStatus = _executor->scheduleRemoteCommand(
         request,
-        [remoteIndex, this](const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
-            _responseQueue.push(Job{cbData, remoteIndex});
+        [ this, remoteIndex, isHedge, requestState, monitor, executor = _executor, db = _db ](
+            const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+            if (monitor) {
+                const auto& elapsed = cbData.response.elapsedMillis;
+                monitor->noteCommandFinished(cbData.request.target,
+                                             elapsed ? boost::make_optional(Microseconds(*elapsed))
+                                                     : boost::none);
+            }
+
+            stdx::unique_lock<stdx::mutex> lk(requestState->mutex);
+            if (requestState->abandoned) {
+                lk.unlock();
+                killCursorOpenedBy(executor, db, cbData);
+                return;
+            }
+            _responseQueue.push(Job{cbData, remoteIndex, isHedge, requestState});
         },
         _baton);
-    if (!callbackStatus.isOK()) {
-        return callbackStatus.getStatus();
+
+    if (callbackStatus.isOK() && monitor) {
+        monitor->noteCommandStarted(host);
     }
+    return callbackStatus;
+}
 
-    remote.cbHandle = callbackStatus.getValue();
-    return Status::OK();
+// static
+void AsyncRequestsSender::_abandonRequest(executor::TaskExecutor::CallbackHandle* cbHandle,
+                                          std::shared_ptr<RequestState>* requestState) {
+    {
+        stdx::lock_guard<stdx::mutex> lk((*requestState)->mutex);
+        (*requestState)->abandoned = true;
+    }
+    *cbHandle = executor::TaskExecutor::CallbackHandle();
+    requestState->reset();
+}
+
+void AsyncRequestsSender::_scheduleHedgedRequests() {
+    const auto now = _executor->now();
+
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        auto& remote = _remotes[i];
+
+        // Only hedge an unanswered request once, and not while the hedged copy of an earlier
+        // attempt is still on its way back.
+        if (!remote.cbHandle.isValid() || remote.swResponse || remote.hedgeSent ||
+            remote.hedgeCbHandle.isValid() || now < remote.hedgeAt) {
+            continue;
+        }
+        remote.hedgeSent = true;
+
+        auto shard = remote.getShard();
+        if (!shard) {
+            continue;
+        }
+
+        boost::optional<HostAndPort> hedgeHost;
+        for (int attempt = 0; attempt < kMaxHedgeHostSelectionAttempts && !hedgeHost; ++attempt) {
+            auto swHost = shard->getTargeter()->findHostNoWait(_readPreference);
+            if (swHost.isOK() && swHost.getValue() != *remote.shardHostAndPort) {
+                hedgeHost = std::move(swHost.getValue());
+            }
+        }
+        if (!hedgeHost) {
+            continue;
+        }
+
+        auto requestState = std::make_shared<RequestState>();
+        auto callbackStatus = _scheduleRemoteCommand(i, *hedgeHost, true, requestState);
+        if (!callbackStatus.isOK()) {
+            continue;
+        }
+
+        LOG(1) << "Hedging request to remote " << remote.shardId << " at host "
+               << *remote.shardHostAndPort << " by also sending it to " << *hedgeHost;
+        remote.hedgeCbHandle = callbackStatus.getValue();
+        remote.hedgeRequestState = std::move(requestState);
+        hedgedReadsIssued.increment();
+    }
 }
 
 // Passing opCtx means you'd like to opt into opCtx interruption.  During cleanup we actually don't.
@@ -254,12 +481,46 @@ void AsyncRequestsSender::_makeProgress() {
         return;
     }
 
+    {
+        stdx::unique_lock<stdx::mutex> lk(job->requestState->mutex);
+        if (job->requestState->abandoned) {
+            // The request lost its hedged race after its response was queued.
+            lk.unlock();
+            killCursorOpenedBy(_executor, _db, job->cbData);
+            return;
+        }
+    }
+
     auto& remote = _remotes[job->remoteIndex];
-    invariant(!remote.swResponse);
+
+    if (job->isHedge) {
+        remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
+        remote.hedgeRequestState.reset();
+
+        // A hedged request only stands in for the original request when it succeeds. On failure,
+        // keep waiting for the original request, which is retried as usual if it fails too.
+        const auto& response = job->cbData.response;
+        if (!response.isOK() || !getStatusFromCommandResult(response.data).isOK()) {
+            return;
+        }
+
+        invariant(!remote.swResponse);
+        hedgedReadsWon.increment();
+        remote.swResponse = response;
+        remote.shardHostAndPort = job->cbData.request.target;
+        _abandonRequest(&remote.cbHandle, &remote.requestState);
+        return;
+    }
 
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
     // 'remote'.
     remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    remote.requestState.reset();
+    invariant(!remote.swResponse);
+
+    if (remote.hedgeCbHandle.isValid()) {
+        _abandonRequest(&remote.hedgeCbHandle, &remote.hedgeRequestState);
+    }
 
     // Store the response or error.
     if (job->cbData.response.status.isOK()) {
@@ -310,8 +571,8 @@ std::shared_ptr<Shard> AsyncRequestsSender::RemoteData::getShard() {
     return Grid::get(getGlobalServiceContext())->shardRegistry()->getShardNoReload(shardId);
 }
 
-AsyncRequestsSender::BatonDetacher::BatonDetacher(OperationContext* opCtx)
-    : _baton(AsyncRequestsSenderUseBaton.load()
+AsyncRequestsSender::BatonDetacher::BatonDetacher(OperationContext* opCtx, bool useBaton)
+    : _baton(useBaton && AsyncRequestsSenderUseBaton.load()
                  ? (opCtx->getServiceContext()->getTransportLayer()
                         ? opCtx->getServiceContext()->getTransportLayer()->makeBaton(opCtx)
                         : nullptr)
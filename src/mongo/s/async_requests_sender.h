@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -39,6 +40,7 @@
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/shard_id.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/interruptible.h"
 #include "mongo/util/net/hostandport.h"
 #include "mongo/util/producer_consumer_queue.h"
@@ -77,6 +79,14 @@ namespace mongo {
  *     }
  * }
  *
+ * Idempotent reads which any eligible member of a shard may serve, that is reads with the
+ * "nearest" or "secondaryPreferred" read preference, can be hedged: if a remote has not answered
+ * after 'AsyncRequestsSenderHedgeDelayMS', the same request is sent to a second eligible host and
+ * whichever succeeds first is used. The other request is not canceled, since it may already have
+ * opened a cursor on its host. It is abandoned instead: once it answers, the cursor it opened, if
+ * any, is killed. The ARS does not wait for abandoned requests, neither in next() nor on
+ * destruction.
+ *
  * Does not throw exceptions.
  */
 class AsyncRequestsSender {
@@ -160,6 +170,15 @@ public:
     void stopRetrying();
 
 private:
+    /**
+     * Shared by a request and its callback, so that the request can be abandoned once it has lost
+     * a hedged race. The callback of an abandoned request no longer refers to the ARS.
+     */
+    struct RequestState {
+        stdx::mutex mutex;
+        bool abandoned = false;
+    };
+
     /**
      * We instantiate one of these per remote host.
      */
@@ -197,11 +216,24 @@ private:
         // The number of times we've retried sending the command to this remote.
         int retryCount = 0;
 
-        // The callback handle to an outstanding request for this remote.
+        // The callback handle to an outstanding request for this remote, and the state it shares
+        // with its callback.
         executor::TaskExecutor::CallbackHandle cbHandle;
+        std::shared_ptr<RequestState> requestState;
 
         // Whether this remote's result has been returned.
         bool done = false;
+
+        // When to send a hedged copy of the outstanding request, if it is still unanswered.
+        Date_t hedgeAt;
+
+        // Whether a hedged copy of the outstanding request has been considered yet.
+        bool hedgeSent = false;
+
+        // The callback handle to an outstanding hedged request for this remote, and the state it
+        // shares with its callback. Is reset once either request has answered.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+        std::shared_ptr<RequestState> hedgeRequestState;
     };
 
     /**
@@ -211,6 +243,13 @@ private:
     struct Job {
         executor::TaskExecutor::RemoteCommandCallbackArgs cbData;
         size_t remoteIndex;
+
+        // Whether this is the response to a hedged request.
+        bool isHedge;
+
+        // The state shared with the request. The request may have been abandoned after the job
+        // was queued.
+        std::shared_ptr<RequestState> requestState;
     };
 
     /**
@@ -219,10 +258,13 @@ private:
      * modify it).
      *
      * TODO: work out actual lifetime semantics for a baton.  For now, leaving this as a wort in ARS
+     *
+     * No baton is used when requests are hedged, since the callback of an abandoned request may
+     * run after the ARS is gone.
      */
     class BatonDetacher {
     public:
-        explicit BatonDetacher(OperationContext* opCtx);
+        BatonDetacher(OperationContext* opCtx, bool useBaton);
         ~BatonDetacher();
 
         transport::Baton& operator*() const {
@@ -270,7 +312,7 @@ private:
     void _scheduleRequests();
 
     /**
-     * Helper to schedule a command to a remote.
+     * Helper to schedule a command to a remote, whose host must already be resolved.
      *
      * The 'remoteIndex' gives the position of the remote node from which we are retrieving the
      * batch in '_remotes'.
@@ -279,6 +321,29 @@ private:
      */
     Status _scheduleRequest(size_t remoteIndex);
 
+    /**
+     * Schedules 'remote.cmdObj' of the remote at 'remoteIndex' on 'host'. The callback pushes the
+     * response to '_responseQueue', unless 'requestState' has been abandoned by then.
+     */
+    StatusWith<executor::TaskExecutor::CallbackHandle> _scheduleRemoteCommand(
+        size_t remoteIndex,
+        const HostAndPort& host,
+        bool isHedge,
+        std::shared_ptr<RequestState> requestState);
+
+    /**
+     * Abandons the outstanding request with 'cbHandle' and 'requestState', and resets both. The
+     * request is left to run, and its callback kills the cursor its response opened, if any.
+     */
+    static void _abandonRequest(executor::TaskExecutor::CallbackHandle* cbHandle,
+                                std::shared_ptr<RequestState>* requestState);
+
+    /**
+     * Sends a hedged copy of the request of each remote which has not answered by its 'hedgeAt'
+     * time to a different eligible host, if there is one.
+     */
+    void _scheduleHedgedRequests();
+
     /**
      * Waits for forward progress in gathering responses from a remote.
      *
@@ -289,6 +354,10 @@ private:
     OperationContext* _opCtx;
 
     executor::TaskExecutor* _executor;
+
+    // How long to wait for a remote before hedging its request. Zero if requests are not hedged.
+    const Milliseconds _hedgeDelay;
+
     BatonDetacher _baton;
 
     // The metadata obj to pass along with the command remote. Used to indicate that the command is
@@ -304,6 +373,10 @@ private:
     // The policy to use when deciding whether to retry on an error.
     Shard::RetryPolicy _retryPolicy;
 
+    // The timers which wake up next() to send hedged requests. The destructor waits for them, as
+    // they refer to this object.
+    std::vector<executor::TaskExecutor::CallbackHandle> _hedgeTimers;
+
     // Is set to a non-OK status if the client operation is interrupted.
     // When waiting for a remote to be ready, we only check for interrupt if the _interruptStatus
     // has not already been set to an error (so we can wait for callbacks for (canceled) outstanding
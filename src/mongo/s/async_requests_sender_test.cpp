@@ -0,0 +1,240 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/client/remote_command_targeter_factory_mock.h"
+#include "mongo/client/remote_command_targeter_mock.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/executor/network_interface_mock.h"
+#include "mongo/s/async_requests_sender.h"
+#include "mongo/s/catalog/type_shard.h"
+#include "mongo/s/sharding_router_test_fixture.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+using executor::NetworkInterfaceMock;
+using executor::RemoteCommandRequest;
+
+const HostAndPort kTestConfigShardHost = HostAndPort("FakeConfigHost", 12345);
+const ShardId kTestShardId = ShardId("FakeShard1");
+const HostAndPort kTestShardHost = HostAndPort("FakeShard1Host", 12345);
+const HostAndPort kTestHedgeHost = HostAndPort("FakeShard1OtherHost", 12345);
+
+const Milliseconds kHedgeDelay(100);
+
+class AsyncRequestsSenderTest : public ShardingTestFixture {
+public:
+    AsyncRequestsSenderTest() : _nss("testdb.testcoll") {}
+
+    void setUp() override {
+        ShardingTestFixture::setUp();
+
+        configTargeter()->setFindHostReturnValue(kTestConfigShardHost);
+
+        ShardType shardType;
+        shardType.setName(kTestShardId.toString());
+        shardType.setHost(kTestShardHost.toString());
+
+        auto targeter = stdx::make_unique<RemoteCommandTargeterMock>();
+        _shardTargeter = targeter.get();
+        targeter->setConnectionStringReturnValue(ConnectionString(kTestShardHost));
+        targeter->setFindHostReturnValue(kTestShardHost);
+        targeterFactory()->addTargeterToReturn(ConnectionString(kTestShardHost),
+                                               std::move(targeter));
+
+        setupShards({shardType});
+
+        _hedgeDelayParameter = ServerParameterSet::getGlobal()
+                                   ->getMap()
+                                   .find("AsyncRequestsSenderHedgeDelayMS")
+                                   ->second;
+        ASSERT_OK(_hedgeDelayParameter->setFromString(std::to_string(kHedgeDelay.count())));
+    }
+
+    void tearDown() override {
+        ASSERT_OK(_hedgeDelayParameter->setFromString("0"));
+        ShardingTestFixture::tearDown();
+    }
+
+protected:
+    /**
+     * Sends a find to the test shard with the "nearest" read preference, and returns the host
+     * which answered it.
+     */
+    HostAndPort runFind() {
+        std::vector<AsyncRequestsSender::Request> requests{
+            {kTestShardId, BSON("find" << _nss.coll())}};
+        AsyncRequestsSender ars(operationContext(),
+                                executor(),
+                                _nss.db(),
+                                requests,
+                                ReadPreferenceSetting{ReadPreference::Nearest},
+                                Shard::RetryPolicy::kIdempotent);
+
+        auto response = ars.next();
+        ASSERT_OK(response.swResponse.getStatus());
+        ASSERT(ars.done());
+        return *response.shardHostAndPort;
+    }
+
+    executor::RemoteCommandResponse makeCursorResponse(CursorId cursorId) {
+        return {CursorResponse(_nss, cursorId, {BSON("_id" << 1)})
+                    .toBSON(CursorResponse::ResponseType::InitialResponse),
+                Milliseconds(1)};
+    }
+
+    /**
+     * Waits for the original request, sent to 'kTestShardHost', and, once 'kHedgeDelay' has passed
+     * without a response, for the hedged copy of it sent to 'kTestHedgeHost'. Returns both.
+     */
+    std::pair<NetworkInterfaceMock::NetworkOperationIterator,
+              NetworkInterfaceMock::NetworkOperationIterator>
+    expectHedgedRequest() {
+        auto original = network()->getNextReadyRequest();
+        ASSERT_EQ(kTestShardHost, original->getRequest().target);
+
+        _shardTargeter->setFindHostReturnValue(kTestHedgeHost);
+        network()->runUntil(network()->now() + kHedgeDelay);
+
+        auto hedge = network()->getNextReadyRequest();
+        ASSERT_EQ(kTestHedgeHost, hedge->getRequest().target);
+        ASSERT_BSONOBJ_EQ(original->getRequest().cmdObj, hedge->getRequest().cmdObj);
+        return {original, hedge};
+    }
+
+    /**
+     * Waits for a killCursors command for 'cursorId' sent to 'host'.
+     */
+    void expectKillCursors(const HostAndPort& host, CursorId cursorId) {
+        onCommand([&](const RemoteCommandRequest& request) {
+            ASSERT_EQ(host, request.target);
+            ASSERT_EQ("killCursors", request.cmdObj.firstElementFieldName());
+            ASSERT_EQ(_nss.coll(), request.cmdObj.firstElement().valueStringData());
+            ASSERT_EQ(cursorId, request.cmdObj["cursors"].Array()[0].numberLong());
+            return BSON("ok" << 1);
+        });
+    }
+
+    const NamespaceString _nss;
+
+    RemoteCommandTargeterMock* _shardTargeter = nullptr;
+
+private:
+    ServerParameter* _hedgeDelayParameter = nullptr;
+};
+
+TEST_F(AsyncRequestsSenderTest, HedgedRequestWinsAndCursorOfOriginalRequestIsKilled) {
+    auto future = launchAsync([&] { ASSERT_EQ(kTestHedgeHost, runFind()); });
+
+    network()->enterNetwork();
+    auto requests = expectHedgedRequest();
+    network()->scheduleSuccessfulResponse(requests.second, makeCursorResponse(CursorId(456)));
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    // The sender neither waits for the original request nor cancels it.
+    future.timed_get(kFutureTimeout);
+
+    network()->enterNetwork();
+    network()->scheduleSuccessfulResponse(requests.first, makeCursorResponse(CursorId(123)));
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    expectKillCursors(kTestShardHost, CursorId(123));
+}
+
+TEST_F(AsyncRequestsSenderTest, OriginalRequestWinsAndCursorOfHedgedRequestIsKilled) {
+    auto future = launchAsync([&] { ASSERT_EQ(kTestShardHost, runFind()); });
+
+    network()->enterNetwork();
+    auto requests = expectHedgedRequest();
+    network()->scheduleSuccessfulResponse(requests.first, makeCursorResponse(CursorId(123)));
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    future.timed_get(kFutureTimeout);
+
+    network()->enterNetwork();
+    network()->scheduleSuccessfulResponse(requests.second, makeCursorResponse(CursorId(456)));
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    expectKillCursors(kTestHedgeHost, CursorId(456));
+}
+
+TEST_F(AsyncRequestsSenderTest, FailedHedgedRequestDoesNotReplaceOriginalRequest) {
+    auto future = launchAsync([&] { ASSERT_EQ(kTestShardHost, runFind()); });
+
+    network()->enterNetwork();
+    auto requests = expectHedgedRequest();
+    network()->scheduleErrorResponse(requests.second,
+                                     Status(ErrorCodes::HostUnreachable, "hedge failed"));
+    network()->runReadyNetworkOperations();
+    network()->scheduleSuccessfulResponse(requests.first, makeCursorResponse(CursorId(123)));
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    future.timed_get(kFutureTimeout);
+}
+
+TEST_F(AsyncRequestsSenderTest, PrimaryReadsAreNotHedged) {
+    auto future = launchAsync([&] {
+        std::vector<AsyncRequestsSender::Request> requests{
+            {kTestShardId, BSON("find" << _nss.coll())}};
+        AsyncRequestsSender ars(operationContext(),
+                                executor(),
+                                _nss.db(),
+                                requests,
+                                ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                                Shard::RetryPolicy::kIdempotent);
+        auto response = ars.next();
+        ASSERT_OK(response.swResponse.getStatus());
+        ASSERT_EQ(kTestShardHost, *response.shardHostAndPort);
+    });
+
+    network()->enterNetwork();
+    auto original = network()->getNextReadyRequest();
+    _shardTargeter->setFindHostReturnValue(kTestHedgeHost);
+    network()->runUntil(network()->now() + kHedgeDelay * 2);
+    ASSERT_FALSE(network()->hasReadyRequests());
+    network()->scheduleSuccessfulResponse(original, makeCursorResponse(CursorId(0)));
+    network()->runReadyNetworkOperations();
+    network()->exitNetwork();
+
+    future.timed_get(kFutureTimeout);
+}
+
+}  // namespace
+}  // namespace mongo
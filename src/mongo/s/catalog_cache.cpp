@@ -228,6 +228,8 @@ CatalogCache::RefreshResult CatalogCache::_getCollectionRoutingInfoAt(
                                            std::make_shared<Notification<Status>>());
                 _scheduleCollectionRefresh(ul, collEntry, nss, 1);
                 refreshActionTaken = RefreshAction::kPerformedRefresh;
+            } else {
+                _stats.countRefreshesJoined.addAndFetch(1);
             }
 
             // Wait on the notification outside of the mutex
@@ -357,6 +359,48 @@ void CatalogCache::onStaleShardVersion(CachedCollectionRoutingInfo&& ccriToInval
     }
 }
 
+void CatalogCache::onStaleConfigError(const StaleConfigInfo& staleInfo) {
+    _stats.countStaleConfigErrors.addAndFetch(1);
+
+    const auto& nss = staleInfo.getNss();
+    const auto& wantedVersion = staleInfo.getVersionWanted();
+
+    {
+        stdx::lock_guard<stdx::mutex> lg(_mutex);
+
+        const auto itDb = _collectionsByDb.find(nss.db());
+        if (itDb == _collectionsByDb.end()) {
+            // The database is not cached, so the next request will load it anyway.
+            return;
+        }
+
+        const auto itColl = itDb->second.find(nss.ns());
+        if (itColl != itDb->second.end()) {
+            const auto& collEntry = itColl->second;
+            if (collEntry->needsRefresh) {
+                // Refresh has been scheduled for the collection already
+                return;
+            }
+
+            // A shard which owns no chunks reports an unset version, which says nothing about which
+            // chunks it gave away, so only trust versions which are set.
+            if (collEntry->routingInfo && wantedVersion && wantedVersion->isSet() &&
+                wantedVersion->epoch() == collEntry->routingInfo->getVersion().epoch() &&
+                !collEntry->routingInfo->getVersion().isOlderThan(*wantedVersion)) {
+                LOG_CATALOG_REFRESH(1) << "Not refreshing cached routing info for " << nss
+                                       << " on stale config error, because the cached version "
+                                       << collEntry->routingInfo->getVersion()
+                                       << " is not older than the version " << *wantedVersion
+                                       << " wanted by the shard";
+                _stats.countStaleConfigErrorsWithoutRefresh.addAndFetch(1);
+                return;
+            }
+        }
+    }
+
+    invalidateShardedCollection(nss);
+}
+
 void CatalogCache::invalidateDatabaseEntry(const StringData dbName) {
     stdx::lock_guard<stdx::mutex> lg(_mutex);
     auto itDbEntry = _databases.find(dbName);
@@ -623,6 +667,10 @@ void CatalogCache::Stats::report(BSONObjBuilder* builder) const {
     builder->append("countFullRefreshesStarted", countFullRefreshesStarted.load());
 
     builder->append("countFailedRefreshes", countFailedRefreshes.load());
+
+    builder->append("countRefreshesJoined", countRefreshesJoined.load());
+    builder->append("countStaleConfigErrorsWithoutRefresh",
+                    countStaleConfigErrorsWithoutRefresh.load());
 }
 
 CachedDatabaseInfo::CachedDatabaseInfo(DatabaseType dbt, std::shared_ptr<Shard> primaryShard)
@@ -36,6 +36,7 @@
 #include "mongo/s/chunk_manager.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/database_version_gen.h"
+#include "mongo/s/stale_exception.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/notification.h"
@@ -204,6 +205,16 @@ public:
      */
     void onStaleShardVersion(CachedCollectionRoutingInfo&&);
 
+    /**
+     * Non-blocking method to be called when a StaleConfig error was received for a namespace and
+     * the routing info which was used is no longer at hand. Marks the cached collection entry as
+     * needing refresh, unless the version the shard reported having is not newer than the cached
+     * one. In that case either a concurrent refresh already picked up the change, or the shard
+     * rather than this router was stale, so refreshing again would only add load on the config
+     * server.
+     */
+    void onStaleConfigError(const StaleConfigInfo& staleInfo);
+
     /**
      * Non-blocking method, which indiscriminately causes the database entry for the specified
      * database to be refreshed the next time getDatabase is called.
@@ -359,6 +370,14 @@ private:
         // for whatever reason
         AtomicInt64 countFailedRefreshes{0};
 
+        // Cumulative, always-increasing counter of how many times a thread which needed a refresh
+        // waited for one already started by another thread instead of starting its own
+        AtomicInt64 countRefreshesJoined{0};
+
+        // Cumulative, always-increasing counter of how many stale config errors did not cause a
+        // refresh, because the cache already knew of the version the shard reported
+        AtomicInt64 countStaleConfigErrorsWithoutRefresh{0};
+
         /**
          * Reports the accumulated statistics for serverStatus.
          */
@@ -611,5 +611,64 @@ TEST_F(CatalogCacheRefreshTest, IncrementalLoadAfterMoveLastChunk) {
     ASSERT_EQ(version, cm->getVersion({"1"}));
 }
 
+long long getCountStaleConfigErrorsWithoutRefresh(CatalogCache* catalogCache) {
+    BSONObjBuilder builder;
+    catalogCache->report(&builder);
+    return builder.obj()["catalogCache"]["countStaleConfigErrorsWithoutRefresh"].numberLong();
+}
+
+TEST_F(CatalogCacheRefreshTest, StaleConfigErrorFromStaleShardDoesNotRefresh) {
+    const ShardKeyPattern shardKeyPattern(BSON("_id" << 1));
+
+    auto initialRoutingInfo(makeChunkManager(kNss, shardKeyPattern, nullptr, true, {}));
+    const ChunkVersion version = initialRoutingInfo->getVersion();
+
+    // The shard has not yet caught up with the version this router sent.
+    ChunkVersion received = version;
+    received.incMajor();
+
+    auto const catalogCache = Grid::get(getServiceContext())->catalogCache();
+    catalogCache->onStaleConfigError(StaleConfigInfo(kNss, received, version));
+    ASSERT_EQ(1, getCountStaleConfigErrorsWithoutRefresh(catalogCache));
+
+    // The cached routing info is still usable without going to the config server.
+    auto routingInfo = assertGet(catalogCache->getCollectionRoutingInfo(operationContext(), kNss));
+    ASSERT_EQ(version, routingInfo.cm()->getVersion());
+}
+
+TEST_F(CatalogCacheRefreshTest, StaleConfigErrorWithNewerVersionRefreshes) {
+    const ShardKeyPattern shardKeyPattern(BSON("_id" << 1));
+
+    auto initialRoutingInfo(makeChunkManager(kNss, shardKeyPattern, nullptr, true, {}));
+    ChunkVersion version = initialRoutingInfo->getVersion();
+
+    ChunkVersion wanted = version;
+    wanted.incMajor();
+
+    auto const catalogCache = Grid::get(getServiceContext())->catalogCache();
+    catalogCache->onStaleConfigError(StaleConfigInfo(kNss, version, wanted));
+    ASSERT_EQ(0, getCountStaleConfigErrorsWithoutRefresh(catalogCache));
+
+    auto future = launchAsync([&] {
+        auto client = getServiceContext()->makeClient("Test");
+        auto opCtx = client->makeOperationContext();
+        return boost::make_optional(
+            uassertStatusOK(catalogCache->getCollectionRoutingInfo(opCtx.get(), kNss)));
+    });
+
+    expectGetCollection(version.epoch(), shardKeyPattern);
+    expectFindSendBSONObjVector(kConfigHostAndPort, [&]() {
+        ChunkType chunk(kNss,
+                        {shardKeyPattern.getKeyPattern().globalMin(),
+                         shardKeyPattern.getKeyPattern().globalMax()},
+                        wanted,
+                        {"0"});
+        return std::vector<BSONObj>{chunk.toConfigBSON()};
+    }());
+
+    auto routingInfo = future.timed_get(kFutureTimeout);
+    ASSERT_EQ(wanted, routingInfo->cm()->getVersion());
+}
+
 }  // namespace
 }  // namespace mongo
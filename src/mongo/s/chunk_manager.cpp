@@ -67,8 +67,167 @@ std::string extractKeyStringInternal(const BSONObj& shardKeyValue, Ordering orde
     return {ks.getBuffer(), ks.getSize()};
 }
 
+/**
+ * Returns the range of entries in "map", which is keyed by the max key string of each range it
+ * describes, that overlap [minKey, maxKey] or [minKey, maxKey) depending on "maxInclusive".
+ */
+template <typename RangeMap>
+std::pair<typename RangeMap::const_iterator, typename RangeMap::const_iterator> overlappingEntries(
+    const RangeMap& map, const std::string& minKey, const std::string& maxKey, bool maxInclusive) {
+    const auto itMin = map.upper_bound(minKey);
+    const auto itMax = [&]() {
+        auto it = maxInclusive ? map.upper_bound(maxKey) : map.lower_bound(maxKey);
+        return it == map.end() ? it : ++it;
+    }();
+
+    return {itMin, itMax};
+}
+
 }  // namespace
 
+constexpr std::size_t ChunkInfoMap::kMaxPageSize;
+
+ChunkInfoMap::const_iterator& ChunkInfoMap::const_iterator::operator++() {
+    if (++_index == _map->_pages[_page]->size()) {
+        ++_page;
+        _index = 0;
+    }
+    return *this;
+}
+
+ChunkInfoMap::const_iterator& ChunkInfoMap::const_iterator::operator--() {
+    if (_index == 0) {
+        --_page;
+        _index = _map->_pages[_page]->size();
+    }
+    --_index;
+    return *this;
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::lower_bound(const key_type& key) const {
+    const auto page = std::lower_bound(_pages.begin(),
+                                       _pages.end(),
+                                       key,
+                                       [](const auto& page, const key_type& key) {
+                                           return page->back().first < key;
+                                       });
+    if (page == _pages.end()) {
+        return end();
+    }
+
+    const auto& entries = **page;
+    const auto entry = std::lower_bound(entries.begin(),
+                                        entries.end(),
+                                        key,
+                                        [](const value_type& entry, const key_type& key) {
+                                            return entry.first < key;
+                                        });
+    return {this,
+            static_cast<std::size_t>(page - _pages.begin()),
+            static_cast<std::size_t>(entry - entries.begin())};
+}
+
+ChunkInfoMap::const_iterator ChunkInfoMap::upper_bound(const key_type& key) const {
+    const auto page = std::upper_bound(_pages.begin(),
+                                       _pages.end(),
+                                       key,
+                                       [](const key_type& key, const auto& page) {
+                                           return key < page->back().first;
+                                       });
+    if (page == _pages.end()) {
+        return end();
+    }
+
+    const auto& entries = **page;
+    const auto entry = std::upper_bound(entries.begin(),
+                                        entries.end(),
+                                        key,
+                                        [](const key_type& key, const value_type& entry) {
+                                            return key < entry.first;
+                                        });
+    return {this,
+            static_cast<std::size_t>(page - _pages.begin()),
+            static_cast<std::size_t>(entry - entries.begin())};
+}
+
+void ChunkInfoMap::insert(value_type value) {
+    if (_pages.empty()) {
+        _pages.push_back(std::make_shared<Entries>());
+        _pages.back()->push_back(std::move(value));
+        _size = 1;
+        return;
+    }
+
+    auto pos = lower_bound(value.first);
+    if (pos != end() && pos->first == value.first) {
+        return;
+    }
+
+    // Keys greater than all others go at the end of the last page
+    if (pos == end()) {
+        pos = {this, _pages.size() - 1, _pages.back()->size()};
+    }
+
+    auto& entries = _exclusiveEntries(pos._page);
+    entries.insert(entries.begin() + pos._index, std::move(value));
+    ++_size;
+
+    if (entries.size() > kMaxPageSize) {
+        auto upperHalf = std::make_shared<Entries>(
+            std::make_move_iterator(entries.begin() + entries.size() / 2),
+            std::make_move_iterator(entries.end()));
+        entries.resize(entries.size() / 2);
+        _pages.insert(_pages.begin() + pos._page + 1, std::move(upperHalf));
+    }
+}
+
+void ChunkInfoMap::erase(const_iterator first, const_iterator last) {
+    if (first == last) {
+        return;
+    }
+
+    if (first._page == last._page) {
+        auto& entries = _exclusiveEntries(first._page);
+        entries.erase(entries.begin() + first._index, entries.begin() + last._index);
+        _size -= last._index - first._index;
+        if (entries.empty()) {
+            _pages.erase(_pages.begin() + first._page);
+        }
+        return;
+    }
+
+    // Trim the end of the first page, drop the pages in between and trim the start of the last
+    // page. The pages which end up empty are removed.
+    auto firstRemoved = first._page;
+    if (first._index > 0) {
+        auto& entries = _exclusiveEntries(first._page);
+        _size -= entries.size() - first._index;
+        entries.resize(first._index);
+        ++firstRemoved;
+    }
+
+    for (auto page = firstRemoved; page < last._page; ++page) {
+        _size -= _pages[page]->size();
+    }
+
+    if (last._index > 0) {
+        auto& entries = _exclusiveEntries(last._page);
+        entries.erase(entries.begin(), entries.begin() + last._index);
+        _size -= last._index;
+    }
+
+    _pages.erase(_pages.begin() + firstRemoved, _pages.begin() + last._page);
+}
+
+ChunkInfoMap::Entries& ChunkInfoMap::_exclusiveEntries(std::size_t page) {
+    // A map being modified cannot be copied concurrently, so a use count of one cannot grow
+    auto& entries = _pages[page];
+    if (entries.use_count() > 1) {
+        entries = std::make_shared<Entries>(*entries);
+    }
+    return *entries;
+}
+
 RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
                                          boost::optional<UUID> uuid,
                                          KeyPattern shardKeyPattern,
@@ -86,6 +245,7 @@ RoutingTableHistory::RoutingTableHistory(NamespaceString nss,
       _chunkMap(std::move(chunkMap)),
       _shardVersions(
           _constructShardVersionMap(collectionVersion.epoch(), _chunkMap, _shardKeyOrdering)),
+      _shardRanges(_constructShardRangeMap(_chunkMap)),
       _collectionVersion(collectionVersion) {}
 
 Chunk ChunkManager::findIntersectingChunk(const BSONObj& shardKey, const BSONObj& collation) const {
@@ -112,7 +272,16 @@ bool ChunkManager::keyBelongsToShard(const BSONObj& shardKey, const ShardId& sha
     if (shardKey.isEmpty())
         return false;
 
-    const auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
+    const auto shardKeyString = _rt->_extractKeyString(shardKey);
+
+    if (!_clusterTime) {
+        // The runs of contiguous chunks on the same shard are far fewer than the chunks, so look
+        // the key up in those directly.
+        const auto it = _rt->_shardRanges.upper_bound(shardKeyString);
+        return it != _rt->_shardRanges.end() && it->second == shardId;
+    }
+
+    const auto it = _rt->getChunkMap().upper_bound(shardKeyString);
     if (it == _rt->getChunkMap().end())
         return false;
 
@@ -189,6 +358,20 @@ void ChunkManager::getShardIdsForQuery(OperationContext* opCtx,
 void ChunkManager::getShardIdsForRange(const BSONObj& min,
                                        const BSONObj& max,
                                        std::set<ShardId>* shardIds) const {
+    if (!_clusterTime) {
+        // Without a cluster time the latest owner of each chunk is used, so the merged per-shard
+        // ranges can be consulted instead of every chunk in the range.
+        const auto bounds = _rt->_overlappingShardRanges(min, max, true);
+        for (auto it = bounds.first; it != bounds.second; ++it) {
+            shardIds->insert(it->second);
+
+            if (shardIds->size() == _rt->_shardVersions.size()) {
+                break;
+            }
+        }
+        return;
+    }
+
     const auto bounds = _rt->overlappingRanges(min, max, true);
     for (auto it = bounds.first; it != bounds.second; ++it) {
         shardIds->insert(it->second->getShardIdAt(_clusterTime));
@@ -202,6 +385,13 @@ void ChunkManager::getShardIdsForRange(const BSONObj& min,
 }
 
 bool ChunkManager::rangeOverlapsShard(const ChunkRange& range, const ShardId& shardId) const {
+    if (!_clusterTime) {
+        const auto bounds = _rt->_overlappingShardRanges(range.getMin(), range.getMax(), false);
+        return std::find_if(bounds.first, bounds.second, [&shardId](const auto& entry) {
+                   return entry.second == shardId;
+               }) != bounds.second;
+    }
+
     const auto bounds = _rt->overlappingRanges(range.getMin(), range.getMax(), false);
     const auto it = std::find_if(bounds.first, bounds.second, [this, &shardId](const auto& scr) {
         return scr.second->getShardIdAt(_clusterTime) == shardId;
@@ -210,6 +400,23 @@ bool ChunkManager::rangeOverlapsShard(const ChunkRange& range, const ShardId& sh
     return it != bounds.second;
 }
 
+bool ChunkManager::rangeBelongsToShard(const BSONObj& min,
+                                       const BSONObj& max,
+                                       const ShardId& shardId) const {
+    if (!_clusterTime) {
+        // Runs are maximal, so an owned range must lie within a single run.
+        const auto bounds = _rt->_overlappingShardRanges(min, max, true);
+        return bounds.first != bounds.second && std::next(bounds.first) == bounds.second &&
+            bounds.first->second == shardId;
+    }
+
+    const auto bounds = _rt->overlappingRanges(min, max, true);
+    return bounds.first != bounds.second &&
+        std::all_of(bounds.first, bounds.second, [this, &shardId](const auto& scr) {
+               return scr.second->getShardIdAt(_clusterTime) == shardId;
+           });
+}
+
 ChunkManager::ConstRangeOfChunks ChunkManager::getNextChunkOnShard(const BSONObj& shardKey,
                                                                    const ShardId& shardId) const {
     for (auto it = _rt->getChunkMap().upper_bound(_rt->_extractKeyString(shardKey));
@@ -237,15 +444,16 @@ std::pair<ChunkInfoMap::const_iterator, ChunkInfoMap::const_iterator>
 RoutingTableHistory::overlappingRanges(const BSONObj& min,
                                        const BSONObj& max,
                                        bool isMaxInclusive) const {
+    return overlappingEntries(
+        _chunkMap, _extractKeyString(min), _extractKeyString(max), isMaxInclusive);
+}
 
-    const auto itMin = _chunkMap.upper_bound(_extractKeyString(min));
-    const auto itMax = [this, &max, isMaxInclusive]() {
-        auto it = isMaxInclusive ? _chunkMap.upper_bound(_extractKeyString(max))
-                                 : _chunkMap.lower_bound(_extractKeyString(max));
-        return it == _chunkMap.end() ? it : ++it;
-    }();
-
-    return {itMin, itMax};
+std::pair<ShardRangeMap::const_iterator, ShardRangeMap::const_iterator>
+RoutingTableHistory::_overlappingShardRanges(const BSONObj& min,
+                                             const BSONObj& max,
+                                             bool isMaxInclusive) const {
+    return overlappingEntries(
+        _shardRanges, _extractKeyString(min), _extractKeyString(max), isMaxInclusive);
 }
 
 IndexBounds ChunkManager::getIndexBoundsForQuery(const BSONObj& key,
@@ -487,6 +695,22 @@ ShardVersionMap RoutingTableHistory::_constructShardVersionMap(const OID& epoch,
     return shardVersions;
 }
 
+ShardRangeMap RoutingTableHistory::_constructShardRangeMap(const ChunkInfoMap& chunkMap) {
+    ShardRangeMap shardRanges;
+
+    for (auto it = chunkMap.cbegin(); it != chunkMap.cend(); ++it) {
+        const auto& shardId = it->second->getShardIdAt(boost::none);
+        const auto next = std::next(it);
+
+        // Only the last chunk of each run on the same shard ends a range
+        if (next == chunkMap.cend() || next->second->getShardIdAt(boost::none) != shardId) {
+            shardRanges.emplace_hint(shardRanges.end(), it->first, shardId);
+        }
+    }
+
+    return shardRanges;
+}
+
 std::string RoutingTableHistory::_extractKeyString(const BSONObj& shardKeyValue) const {
     return extractKeyStringInternal(shardKeyValue, _shardKeyOrdering);
 }
@@ -552,7 +776,7 @@ std::shared_ptr<RoutingTableHistory> RoutingTableHistory::makeUpdated(
         // high, but low == chunkMap.end(), and we aren't doing a split in that
         // case.
         auto foundSingleChunk =
-            ((low == high || std::distance(low, high) == 1) && low != chunkMap.end());
+            ((low == high || std::next(low) == high) && low != chunkMap.end());
 
         auto newChunk = std::make_shared<ChunkInfo>(chunk);
         if (foundSingleChunk) {
@@ -28,9 +28,13 @@
 
 #pragma once
 
+#include <cstddef>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
@@ -49,12 +53,128 @@ struct QuerySolutionNode;
 class OperationContext;
 class ChunkManager;
 
-// Ordered map from the max for each chunk to an entry describing the chunk
-using ChunkInfoMap = std::map<std::string, std::shared_ptr<ChunkInfo>>;
+/**
+ * Ordered map from the max key string for each chunk to an entry describing the chunk.
+ *
+ * The entries are kept in sorted pages of bounded size, which are shared between copies of the
+ * map and only copied when a copy modifies them. This makes copying the map proportional to the
+ * number of pages rather than the number of chunks, so that a routing table refresh which changes
+ * a few chunks of a collection with very many chunks only copies the pages those chunks are on.
+ *
+ * Iterators are invalidated by any modification of the map and by moving it.
+ */
+class ChunkInfoMap {
+public:
+    using key_type = std::string;
+    using mapped_type = std::shared_ptr<ChunkInfo>;
+    using value_type = std::pair<key_type, mapped_type>;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = ChunkInfoMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const value_type*;
+        using reference = const value_type&;
+
+        const_iterator() = default;
+
+        reference operator*() const {
+            return (*_map->_pages[_page])[_index];
+        }
+        pointer operator->() const {
+            return &**this;
+        }
+
+        const_iterator& operator++();
+        const_iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+        const_iterator& operator--();
+        const_iterator operator--(int) {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const const_iterator& other) const {
+            return _page == other._page && _index == other._index;
+        }
+        bool operator!=(const const_iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class ChunkInfoMap;
+
+        const_iterator(const ChunkInfoMap* map, std::size_t page, std::size_t index)
+            : _map(map), _page(page), _index(index) {}
+
+        const ChunkInfoMap* _map{nullptr};
+        std::size_t _page{0};
+        std::size_t _index{0};
+    };
+
+    using iterator = const_iterator;
+
+    const_iterator begin() const {
+        return {this, 0, 0};
+    }
+    const_iterator end() const {
+        return {this, _pages.size(), 0};
+    }
+    const_iterator cbegin() const {
+        return begin();
+    }
+    const_iterator cend() const {
+        return end();
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+    bool empty() const {
+        return _size == 0;
+    }
+
+    /**
+     * Same as the std::map methods of the same name.
+     */
+    const_iterator lower_bound(const key_type& key) const;
+    const_iterator upper_bound(const key_type& key) const;
+
+    /**
+     * Inserts "value" unless an entry with the same key already exists. Copies at most one page.
+     */
+    void insert(value_type value);
+
+    /**
+     * Removes the entries in [first, last). Copies at most the two pages at the ends of the range.
+     */
+    void erase(const_iterator first, const_iterator last);
+
+private:
+    using Entries = std::vector<value_type>;
+
+    // Pages which grow beyond this number of entries are split in two
+    static constexpr std::size_t kMaxPageSize = 256;
+
+    // Makes the page at "page" safe to modify, copying its entries if another map references them
+    Entries& _exclusiveEntries(std::size_t page);
+
+    // Sorted, non-empty pages of entries, in the order of their keys
+    std::vector<std::shared_ptr<Entries>> _pages;
+    std::size_t _size{0};
+};
 
 // Map from a shard is to the max chunk version on that shard
 using ShardVersionMap = std::map<ShardId, ChunkVersion>;
 
+// Ordered map from the max of each run of contiguous chunks owned by the same shard to that shard
+using ShardRangeMap = std::map<std::string, ShardId>;
+
 /**
  * In-memory representation of the routing table for a single sharded collection at various points
  * in time.
@@ -157,6 +277,20 @@ private:
                                                      const ChunkInfoMap& chunkMap,
                                                      Ordering shardKeyOrdering);
 
+    /**
+     * Does a single pass over the chunkMap and merges adjacent chunks owned by the same shard into
+     * the ShardRangeMap object.
+     */
+    static ShardRangeMap _constructShardRangeMap(const ChunkInfoMap& chunkMap);
+
+    /**
+     * Same as overlappingRanges(), but over the merged per-shard ranges, so that the number of
+     * entries returned is bounded by the number of shard changes in [min, max] rather than by the
+     * number of chunks. Reflects the latest shard of each chunk only.
+     */
+    std::pair<ShardRangeMap::const_iterator, ShardRangeMap::const_iterator> _overlappingShardRanges(
+        const BSONObj& min, const BSONObj& max, bool isMaxInclusive) const;
+
     RoutingTableHistory(NamespaceString nss,
                         boost::optional<UUID> uuid,
                         KeyPattern shardKeyPattern,
@@ -196,6 +330,11 @@ private:
     // chunks, it won't be present in this map.
     const ShardVersionMap _shardVersions;
 
+    // Map from the max of each run of contiguous chunks on the same shard to that shard, used to
+    // target ranges without visiting every chunk in them. Rebuilt along with '_shardVersions'
+    // whenever the chunk map changes.
+    const ShardRangeMap _shardRanges;
+
     // Max version across all chunks
     const ChunkVersion _collectionVersion;
 
@@ -309,6 +448,13 @@ public:
      */
     bool rangeOverlapsShard(const ChunkRange& range, const ShardId& shardId) const;
 
+    /**
+     * Returns true if every shard key value in [min, max] (both bounds inclusive) belongs to the
+     * shard with the given "shardId", meaning that documents within that range never need to be
+     * checked individually for ownership.
+     */
+    bool rangeBelongsToShard(const BSONObj& min, const BSONObj& max, const ShardId& shardId) const;
+
     /**
      * Given a shardKey, returns the first chunk which is owned by shardId and overlaps or sorts
      * after that shardKey. The returned iterator range always contains one or zero entries. If zero
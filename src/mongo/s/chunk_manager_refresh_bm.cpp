@@ -120,7 +120,42 @@ void BM_IncrementalRefreshOfPessimalBalancedDistribution(benchmark::State& state
     }
 }
 
-BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)->Args({2, 50000});
+BENCHMARK(BM_IncrementalRefreshOfPessimalBalancedDistribution)
+    ->Args({2, 50000})
+    ->Args({2, 500000});
+
+void BM_IncrementalSplitRefreshOfOptimalBalancedDistribution(benchmark::State& state) {
+    const int nShards = state.range(0);
+    const int nChunks = state.range(1);
+    auto cm = makeChunkManagerWithOptimalBalancedDistribution(nShards, nChunks);
+
+    // Split one chunk in the middle of the key space into 10 chunks
+    auto postSplitVersion = cm->getChunkManager()->getVersion();
+    const auto collName = NamespaceString(cm->getChunkManager()->getns());
+    const auto splitRange = getRangeForChunk(nChunks / 2, nChunks);
+    const auto splitMin = splitRange.getMin()["_id"].numberInt();
+    const auto owner = cm->getChunkManager()
+                           ->findIntersectingChunkWithSimpleCollation(splitRange.getMin())
+                           .getShardId();
+    std::vector<ChunkType> newChunks;
+    for (int i = 0; i < 10; ++i) {
+        postSplitVersion.incMinor();
+        newChunks.emplace_back(collName,
+                               ChunkRange{BSON("_id" << splitMin + i * 10),
+                                          i == 9 ? splitRange.getMax()
+                                                 : BSON("_id" << splitMin + (i + 1) * 10)},
+                               postSplitVersion,
+                               owner);
+    }
+
+    for (auto keepRunning : state) {
+        benchmark::DoNotOptimize(runIncrementalUpdate(*cm, newChunks));
+    }
+}
+
+BENCHMARK(BM_IncrementalSplitRefreshOfOptimalBalancedDistribution)
+    ->Args({2, 50000})
+    ->Args({2, 500000});
 
 template <typename ShardSelectorFn>
 auto BM_FullBuildOfChunkManager(benchmark::State& state, ShardSelectorFn selectShard) {
@@ -349,6 +384,15 @@ MONGO_INITIALIZER(RegisterBenchmarks)(InitializerContext* context) {
             ->Args({2, 2});
     }
 
+    // Range targeting on collections with very many chunks, where most ranges span a large number
+    // of chunks.
+    REGISTER_BENCHMARK_CAPTURE(
+        BM_GetShardIdsForRange, Pessimal, makeChunkManagerWithPessimalBalancedDistribution)
+        ->Args({10, 500000});
+    REGISTER_BENCHMARK_CAPTURE(
+        BM_GetShardIdsForRange, Optimal, makeChunkManagerWithOptimalBalancedDistribution)
+        ->Args({10, 500000});
+
     return Status::OK();
 }
 
@@ -42,6 +42,7 @@
 #include "mongo/db/logical_time_metadata_hook.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/network_connection_hook.h"
 #include "mongo/executor/network_interface_factory.h"
 #include "mongo/executor/network_interface_thread_pool.h"
@@ -81,6 +82,22 @@ using CallbackHandle = TaskExecutor::CallbackHandle;
 
 namespace {
 const Seconds kRefreshPeriod(30);
+
+// Whether to open the sharding task executors' minimum pooled connections to shard hosts as soon
+// as the hosts become known, rather than on first use.
+MONGO_EXPORT_SERVER_PARAMETER(warmUpShardConnectionPools, bool, false);
+
+void warmUpShardConnections(const ConnectionString& connString) {
+    if (!warmUpShardConnectionPools.load())
+        return;
+
+    auto executorPool = Grid::get(getGlobalServiceContext())->getExecutorPool();
+    if (!executorPool)
+        return;
+
+    LOG(1) << "Warming up connection pools for " << connString.toString();
+    executorPool->warmUpConnections(connString.getServers());
+}
 }  // namespace
 
 const ShardId ShardRegistry::kConfigServerShardId = ShardId("config");
@@ -198,8 +215,13 @@ void ShardRegistry::updateReplSetHosts(const ConnectionString& newConnString) {
               newConnString.type() == ConnectionString::CUSTOM);  // For dbtests
 
     // to prevent update config shard connection string during init
-    stdx::unique_lock<stdx::mutex> lock(_reloadMutex);
-    _data.rebuildShardIfExists(newConnString, _shardFactory.get());
+    {
+        stdx::unique_lock<stdx::mutex> lock(_reloadMutex);
+        _data.rebuildShardIfExists(newConnString, _shardFactory.get());
+    }
+
+    // Members may have been added, or a new primary elected
+    warmUpShardConnections(newConnString);
 }
 
 void ShardRegistry::init() {
@@ -334,6 +356,18 @@ bool ShardRegistry::reload(OperationContext* opCtx) {
         ReplicaSetMonitor::remove(name);
     }
 
+    // Warm up connections to shards that weren't known before, which is all of them on the first
+    // reload.
+    std::set<ShardId> addedShardIds;
+    _data.getAllShardIds(addedShardIds);
+    currData.shardIdSetDifference(addedShardIds);
+
+    for (auto& shardId : addedShardIds) {
+        if (auto shard = _data.findByShardId(shardId)) {
+            warmUpShardConnections(shard->getConnString());
+        }
+    }
+
     nextReloadState = ReloadState::Idle;
     // first successful reload means that registry is up
     _isUp = true;
@@ -320,6 +320,11 @@ void ClusterExplain::buildExecStats(const vector<Strategy::CommandResult>& shard
             singleShardBob.append(execStats["errorCode"]);
         }
 
+        // Shards report these next to, rather than in, their "executionStats" section.
+        if (auto hardwareCounters = shardResults[i].result["hardwareCounters"]) {
+            singleShardBob.append(hardwareCounters);
+        }
+
         appendIfRoom(&singleShardBob, execStages, "executionStages");
 
         singleShardBob.doneFast();
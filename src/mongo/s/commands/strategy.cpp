@@ -402,7 +402,11 @@ void runCommand(OperationContext* opCtx,
                     ShardConnection::checkMyConnectionVersions(opCtx, staleNs.ns());
                 }
 
-                Grid::get(opCtx)->catalogCache()->invalidateShardedCollection(staleNs);
+                if (auto staleInfo = ex.extraInfo<StaleConfigInfo>()) {
+                    Grid::get(opCtx)->catalogCache()->onStaleConfigError(*staleInfo);
+                } else {
+                    Grid::get(opCtx)->catalogCache()->invalidateShardedCollection(staleNs);
+                }
 
                 // Update transaction tracking state for a possible retry. Throws if the transaction
                 // cannot continue.
@@ -842,7 +846,11 @@ void Strategy::explainFind(OperationContext* opCtx,
                 ShardConnection::checkMyConnectionVersions(opCtx, staleNs.ns());
             }
 
-            Grid::get(opCtx)->catalogCache()->invalidateShardedCollection(staleNs);
+            if (auto staleInfo = ex.extraInfo<StaleConfigInfo>()) {
+                Grid::get(opCtx)->catalogCache()->onStaleConfigError(*staleInfo);
+            } else {
+                Grid::get(opCtx)->catalogCache()->invalidateShardedCollection(staleNs);
+            }
 
             if (canRetry) {
                 continue;
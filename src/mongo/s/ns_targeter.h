@@ -97,6 +97,22 @@ public:
     virtual StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                                    const BSONObj& doc) const = 0;
 
+    /**
+     * Targets the documents at positions [begin, end) of 'docs' for insertion, appending to
+     * 'endpoints' one result per document, which is the same as targetInsert() returns for it.
+     *
+     * Implementations may share work between the documents of the range.
+     */
+    virtual void targetInserts(OperationContext* opCtx,
+                               const std::vector<BSONObj>& docs,
+                               size_t begin,
+                               size_t end,
+                               std::vector<StatusWith<ShardEndpoint>>* endpoints) const {
+        for (size_t i = begin; i < end; ++i) {
+            endpoints->push_back(targetInsert(opCtx, docs[i]));
+        }
+    }
+
     /**
      * Returns a vector of ShardEndpoints for a potentially multi-shard update.
      *
@@ -38,6 +38,7 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/util/assert_util.h"
@@ -53,6 +54,9 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// An Ordering can describe the direction of at most this many sort key fields.
+const int kMaxEncodedSortKeyFields = 32;
+
 /**
  * Returns the sort key out of the $sortKey metadata field in 'obj'. This object is of the form
  * {'': 'firstSortKey', '': 'secondSortKey', ...}.
@@ -78,6 +82,21 @@ int compareSortKeys(BSONObj leftSortKey, BSONObj rightSortKey, BSONObj sortKeyPa
     return leftSortKey.woCompare(rightSortKey, sortKeyPattern, considerFieldName);
 }
 
+/**
+ * Returns the KeyString encoding of 'sortKey', such that comparing the encodings of two sort keys
+ * orders them the same way as compareSortKeys() does with the sort pattern 'ordering' came from.
+ */
+std::string encodeSortKey(const BSONObj& sortKey, Ordering ordering) {
+    // KeyString does not allow field names in the encoded object.
+    BSONObjBuilder unnamed;
+    for (const auto& elem : sortKey) {
+        unnamed.appendAs(elem, ""_sd);
+    }
+
+    KeyString ks(KeyString::Version::V1, unnamed.done(), ordering);
+    return {ks.getBuffer(), ks.getSize()};
+}
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
@@ -90,9 +109,13 @@ AsyncResultsMerger::AsyncResultsMerger(OperationContext* opCtx,
       // since that is not supported we treat boost::none (unspecified) to mean 'kNormal'.
       _tailableMode(params.getTailableMode().value_or(TailableModeEnum::kNormal)),
       _params(std::move(params)),
+      _mergeByEncodedSortKey(_params.getSort() &&
+                             _params.getSort()->nFields() <= kMaxEncodedSortKeyFields),
+      _sortKeyOrdering(Ordering::make(_mergeByEncodedSortKey ? *_params.getSort() : BSONObj())),
       _mergeQueue(MergingComparator(_remotes,
                                     _params.getSort() ? *_params.getSort() : BSONObj(),
-                                    _params.getCompareWholeSortKey())) {
+                                    _params.getCompareWholeSortKey(),
+                                    _mergeByEncodedSortKey)) {
     if (params.getTxnNumber()) {
         invariant(params.getSessionId());
     }
@@ -209,9 +232,21 @@ bool AsyncResultsMerger::_readySorted(WithLock lk) {
     // Tailable non-awaitData cursors cannot have a sort.
     invariant(_tailableMode == TailableModeEnum::kNormal);
 
+    // The smallest buffered result can be returned as soon as no remote can still produce a result
+    // which sorts before it. Remotes with buffered results or exhausted cursors cannot, and neither
+    // can a remote whose last result sorts equal to it, since each remote returns its results in
+    // sort order. This returns runs of equal sort keys without waiting on every remote whose batch
+    // ended inside the run.
+    const std::string* smallestSortKey = nullptr;
+    if (_mergeByEncodedSortKey && !_mergeQueue.empty()) {
+        smallestSortKey = &_remotes[_mergeQueue.top()].sortKeyBuffer.front();
+    }
+
     for (const auto& remote : _remotes) {
         if (!remote.hasNext() && !remote.exhausted()) {
-            return false;
+            if (!smallestSortKey || !remote.lastSortKey || *smallestSortKey > *remote.lastSortKey) {
+                return false;
+            }
         }
     }
 
@@ -292,6 +327,9 @@ ClusterQueryResult AsyncResultsMerger::_nextReadySorted(WithLock) {
 
     ClusterQueryResult front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    if (_mergeByEncodedSortKey) {
+        _remotes[smallestRemote].sortKeyBuffer.pop();
+    }
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -573,6 +611,8 @@ void AsyncResultsMerger::_cleanUpFailedBatch(WithLock lk, Status status, size_t
         // Clear the results buffer and cursor id.
         std::queue<ClusterQueryResult> emptyBuffer;
         std::swap(remote.docBuffer, emptyBuffer);
+        std::queue<std::string> emptySortKeyBuffer;
+        std::swap(remote.sortKeyBuffer, emptySortKeyBuffer);
         remote.cursorId = 0;
     }
 }
@@ -643,6 +683,11 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
                                          << obj);
                 return false;
             }
+
+            if (_mergeByEncodedSortKey) {
+                remote.sortKeyBuffer.push(encodeSortKey(
+                    extractSortKey(obj, _params.getCompareWholeSortKey()), _sortKeyOrdering));
+            }
         }
 
         ClusterQueryResult result(obj);
@@ -653,6 +698,9 @@ bool AsyncResultsMerger::_addBatchToBuffer(WithLock lk,
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the merge
     // queue.
     if (_params.getSort() && !response.getBatch().empty()) {
+        if (_mergeByEncodedSortKey) {
+            remote.lastSortKey = remote.sortKeyBuffer.back();
+        }
         _mergeQueue.push(remoteIndex);
     }
     return true;
@@ -765,6 +813,10 @@ bool AsyncResultsMerger::RemoteCursorData::exhausted() const {
 //
 
 bool AsyncResultsMerger::MergingComparator::operator()(const size_t& lhs, const size_t& rhs) {
+    if (_compareEncodedSortKeys) {
+        return _remotes[lhs].sortKeyBuffer.front() > _remotes[rhs].sortKeyBuffer.front();
+    }
+
     const ClusterQueryResult& leftDoc = _remotes[lhs].docBuffer.front();
     const ClusterQueryResult& rightDoc = _remotes[rhs].docBuffer.front();
 
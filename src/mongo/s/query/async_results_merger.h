@@ -30,11 +30,13 @@
 
 #include <boost/optional.hpp>
 #include <queue>
+#include <string>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/ordering.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/async_results_merger_params_gen.h"
@@ -283,6 +285,15 @@ private:
         // The buffer of results that have been retrieved but not yet returned to the caller.
         std::queue<ClusterQueryResult> docBuffer;
 
+        // KeyString encodings of the sort keys of the results in 'docBuffer', in the same order.
+        // Only populated if the results are merged by encoded sort key, see
+        // '_mergeByEncodedSortKey'.
+        std::queue<std::string> sortKeyBuffer;
+
+        // The encoded sort key of the last result received from this remote. Each remote returns
+        // its results in sort order, so none of its future results can sort before this key.
+        boost::optional<std::string> lastSortKey;
+
         // Is valid if there is currently a pending request to this remote.
         executor::TaskExecutor::CallbackHandle cbHandle;
 
@@ -299,8 +310,12 @@ private:
     public:
         MergingComparator(const std::vector<RemoteCursorData>& remotes,
                           const BSONObj& sort,
-                          bool compareWholeSortKey)
-            : _remotes(remotes), _sort(sort), _compareWholeSortKey(compareWholeSortKey) {}
+                          bool compareWholeSortKey,
+                          bool compareEncodedSortKeys)
+            : _remotes(remotes),
+              _sort(sort),
+              _compareWholeSortKey(compareWholeSortKey),
+              _compareEncodedSortKeys(compareEncodedSortKeys) {}
 
         bool operator()(const size_t& lhs, const size_t& rhs);
 
@@ -313,6 +328,9 @@ private:
         // We extract the sort key {$sortKey: <value>}. The sort key pattern '_sort' is verified to
         // be {$sortKey: 1}.
         const bool _compareWholeSortKey;
+
+        // When true, the remotes' 'sortKeyBuffer's are compared instead of their $sortKey fields.
+        const bool _compareEncodedSortKeys;
     };
 
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
@@ -424,6 +442,12 @@ private:
     TailableModeEnum _tailableMode;
     AsyncResultsMergerParams _params;
 
+    // Whether sorted results are merged by comparing the KeyString encodings of their sort keys,
+    // which are computed once per result as batches arrive. This is the case unless the sort
+    // pattern has more fields than an Ordering can describe.
+    const bool _mergeByEncodedSortKey;
+    const Ordering _sortKeyOrdering;
+
     // Must be acquired before accessing any data members (other than _params, which is read-only).
     mutable stdx::mutex _mutex;
 
@@ -907,8 +907,8 @@ boost::intrusive_ptr<ExpressionContext> makeExpressionContext(OperationContext*
             CollatorFactoryInterface::get(opCtx->getServiceContext())->makeFromBSON(collationObj));
     }
 
-    // Create the expression context, and set 'inMongos' to true. We explicitly do *not* set
-    // mergeCtx->tempDir.
+    // Create the expression context, and set 'inMongos' to true. We only set mergeCtx->tempDir if
+    // mongoS has been configured with a directory to spill to.
     auto mergeCtx = new ExpressionContext(opCtx,
                                           request,
                                           std::move(collation),
@@ -917,6 +917,7 @@ boost::intrusive_ptr<ExpressionContext> makeExpressionContext(OperationContext*
                                           uuid);
 
     mergeCtx->inMongos = true;
+    mergeCtx->tempDir = internalQueryMongosTempDir;
     return mergeCtx;
 }
 
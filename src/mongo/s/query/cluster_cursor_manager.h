@@ -37,6 +37,7 @@
 #include "mongo/db/kill_sessions.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/session_killer.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/random.h"
 #include "mongo/s/query/cluster_client_cursor.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
@@ -66,6 +67,10 @@ class StatusWith;
  * The manager supports killing of registered cursors, either through the PinnedCursor object or
  * with the kill*() suite of methods.
  *
+ * Registered cursors are spread over a fixed number of partitions, each with its own mutex, so that
+ * checking out and checking in different cursors doesn't contend on a single lock. The partition
+ * of a cursor is determined by its cursor id.
+ *
  * No public methods throw exceptions, and all public methods are thread-safe.
  */
 class ClusterCursorManager {
@@ -375,6 +380,9 @@ public:
      * Informs the manager that all mortal cursors with a 'last active' time equal to or earlier
      * than 'cutoff' should be killed.  The cursors need not necessarily be in the 'idle' state.
      *
+     * Visits one partition at a time, so cursors in the other partitions stay available while it
+     * runs.
+     *
      * May block waiting for other threads to finish, but does not block on the network.
      *
      * Returns the number of cursors that were killed due to inactivity.
@@ -430,20 +438,29 @@ public:
     boost::optional<NamespaceString> getNamespaceForCursorId(CursorId cursorId) const;
 
     void incrementCursorsTimedOut(size_t inc) {
-        _cursorsTimedOut += inc;
+        _cursorsTimedOut.fetchAndAdd(inc);
     }
 
     size_t cursorsTimedOut() const {
-        return _cursorsTimedOut;
+        return _cursorsTimedOut.load();
     }
 
 private:
     class CursorEntry;
     struct CursorEntryContainer;
+    struct Partition;
     using CursorEntryMap = stdx::unordered_map<CursorId, CursorEntry>;
     using NssToCursorContainerMap =
         stdx::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>;
 
+    // Number of partitions the cursors are spread over.
+    static constexpr size_t kNumPartitions = 16;
+
+    /**
+     * Returns the partition holding the cursor with id 'cursorId'.
+     */
+    Partition& _getPartition(CursorId cursorId) const;
+
     /**
      * Transfers ownership of the given pinned cursor back to the manager, and moves the cursor to
      * the 'idle' state.
@@ -461,9 +478,10 @@ private:
                        CursorState cursorState);
 
     /**
-     * Will detach a cursor, release the lock and then call kill() on it.
+     * Will detach a cursor, release the lock on its partition and then call kill() on it.
      */
     void detachAndKillCursor(stdx::unique_lock<stdx::mutex> lk,
+                             Partition& partition,
                              OperationContext* opCtx,
                              const NamespaceString& nss,
                              CursorId cursorId);
@@ -472,9 +490,12 @@ private:
      * Returns a pointer to the CursorEntry for the given cursor.  If the given cursor is not
      * registered, returns null.
      *
-     * Not thread-safe.
+     * Requires the lock on 'partition', which must be the partition of 'cursorId'.
      */
-    CursorEntry* _getEntry(WithLock, NamespaceString const& nss, CursorId cursorId);
+    CursorEntry* _getEntry(WithLock,
+                           Partition& partition,
+                           NamespaceString const& nss,
+                           CursorId cursorId);
 
     /**
      * De-registers the given cursor, and returns an owned pointer to the underlying
@@ -483,9 +504,10 @@ private:
      * If the given cursor is pinned, returns an error Status with code CursorInUse.  If the given
      * cursor is not registered, returns an error Status with code CursorNotFound.
      *
-     * Not thread-safe.
+     * Requires the lock on 'partition', which must be the partition of 'cursorId'.
      */
     StatusWith<std::unique_ptr<ClusterClientCursor>> _detachCursor(WithLock,
+                                                                   Partition& partition,
                                                                    NamespaceString const& nss,
                                                                    CursorId cursorId);
 
@@ -495,12 +517,12 @@ private:
     void killOperationUsingCursor(WithLock, CursorEntry* entry);
 
     /**
-     * Kill the cursors satisfying the given predicate. Assumes that 'lk' is held upon entry.
+     * Kill the cursors satisfying the given predicate. Locks one partition at a time, and kills
+     * the cursors found in a partition after releasing its lock.
      *
      * Returns the number of cursors killed.
      */
-    std::size_t killCursorsSatisfying(stdx::unique_lock<stdx::mutex> lk,
-                                      OperationContext* opCtx,
+    std::size_t killCursorsSatisfying(OperationContext* opCtx,
                                       std::function<bool(CursorId, const CursorEntry&)> pred);
 
     /**
@@ -632,43 +654,59 @@ private:
         CursorEntryMap entryMap;
     };
 
+    /**
+     * One slice of the registered cursors, with its own lock.
+     */
+    struct Partition {
+        explicit Partition(int64_t seed) : pseudoRandom(seed) {}
+
+        // Synchronizes access to all state variables below.
+        mutable stdx::mutex mutex;
+
+        // Randomness source.  Used for cursor id generation.
+        PseudoRandom pseudoRandom;
+
+        // Map from cursor id prefix to associated namespace.  Exists only to provide namespace
+        // lookup for (deprecated) getNamespaceForCursorId() method.
+        //
+        // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the
+        // first cursor on a given namespace is registered in a partition, it is given a CursorId
+        // with a prefix that is unique to that namespace and congruent to the partition's index
+        // modulo kNumPartitions, and an arbitrary suffix.  Cursors subsequently registered on that
+        // namespace in the same partition will all share the same prefix.
+        //
+        // Entries are added when the first cursor on the given namespace is registered in this
+        // partition, and removed when the last such cursor is destroyed.
+        stdx::unordered_map<uint32_t, NamespaceString> cursorIdPrefixToNamespaceMap;
+
+        // Map from namespace to the CursorEntryContainer for that namespace in this partition.
+        //
+        // Entries are added and removed along with those in 'cursorIdPrefixToNamespaceMap'.
+        NssToCursorContainerMap namespaceToContainerMap;
+    };
+
     /**
      * Erase the container that 'it' points to and return an iterator to the next one. Assumes 'it'
-     * is an iterator in '_namespaceToContainerMap'.
+     * is an iterator in the 'namespaceToContainerMap' of 'partition'.
      */
-    NssToCursorContainerMap::iterator eraseContainer(NssToCursorContainerMap::iterator it);
+    NssToCursorContainerMap::iterator eraseContainer(Partition& partition,
+                                                     NssToCursorContainerMap::iterator it);
 
     // Clock source.  Used when the 'last active' time for a cursor needs to be set/updated.  May be
     // concurrently accessed by multiple threads.
     ClockSource* _clockSource;
 
-    // Synchronizes access to all private state variables below.
-    mutable stdx::mutex _mutex;
+    // Set before shutdown kills the registered cursors. Read under a partition lock when
+    // registering, so that a cursor is either rejected or seen by the kill.
+    AtomicBool _inShutdown{false};
 
-    bool _inShutdown{false};
+    // The partitions, indexed by cursor id prefix modulo kNumPartitions.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 
-    // Randomness source.  Used for cursor id generation.
-    PseudoRandom _pseudoRandom;
-
-    // Map from cursor id prefix to associated namespace.  Exists only to provide namespace lookup
-    // for (deprecated) getNamespaceForCursorId() method.
-    //
-    // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the first
-    // cursor on a given namespace is registered, it is given a CursorId with a prefix that is
-    // unique to that namespace, and an arbitrary suffix.  Cursors subsequently registered on that
-    // namespace will all share the same prefix.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    stdx::unordered_map<uint32_t, NamespaceString> _cursorIdPrefixToNamespaceMap;
-
-    // Map from namespace to the CursorEntryContainer for that namespace.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    NssToCursorContainerMap _namespaceToContainerMap;
+    // New cursors are placed in the partitions in turn.
+    AtomicWord<unsigned> _nextPartition{0};
 
-    size_t _cursorsTimedOut = 0;
+    AtomicWord<size_t> _cursorsTimedOut{0};
 };
 
 }  // namespace
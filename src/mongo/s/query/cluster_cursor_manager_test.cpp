@@ -542,6 +542,42 @@ TEST_F(ClusterCursorManagerTest, KillAllCursors) {
     }
 }
 
+// Test that cursors on one namespace spread over the manager's partitions can each be checked out
+// by id, are all counted, and are all killed by killAllCursors().
+TEST_F(ClusterCursorManagerTest, ManyCursorsSameNamespaceAcrossPartitions) {
+    const size_t numCursors = 100;
+    std::vector<CursorId> cursorIds(numCursors);
+    for (size_t i = 0; i < numCursors; ++i) {
+        cursorIds[i] =
+            assertGet(getManager()->registerCursor(_opCtx.get(),
+                                                   allocateMockCursor(),
+                                                   nss,
+                                                   ClusterCursorManager::CursorType::SingleTarget,
+                                                   ClusterCursorManager::CursorLifetime::Mortal,
+                                                   UserNameIterator()));
+    }
+    ASSERT_EQ(numCursors, getManager()->stats().cursorsSingleTarget);
+
+    for (size_t i = 0; i < numCursors; ++i) {
+        auto cursorNamespace = getManager()->getNamespaceForCursorId(cursorIds[i]);
+        ASSERT(cursorNamespace);
+        ASSERT_EQ(nss.ns(), cursorNamespace->ns());
+
+        auto pinnedCursor =
+            getManager()->checkOutCursor(nss, cursorIds[i], _opCtx.get(), successAuthChecker);
+        ASSERT_OK(pinnedCursor.getStatus());
+        ASSERT_EQ(cursorIds[i], pinnedCursor.getValue().getCursorId());
+        pinnedCursor.getValue().returnCursor(ClusterCursorManager::CursorState::NotExhausted);
+    }
+
+    getManager()->killAllCursors(_opCtx.get());
+    for (size_t i = 0; i < numCursors; ++i) {
+        ASSERT(isMockCursorKilled(i));
+        ASSERT_FALSE(getManager()->getNamespaceForCursorId(cursorIds[i]));
+    }
+    ASSERT_EQ(0U, getManager()->stats().cursorsSingleTarget);
+}
+
 // Test that a new ClusterCursorManager's stats() is initially zero for the cursor counts.
 TEST_F(ClusterCursorManagerTest, StatsInitAsZero) {
     ASSERT_EQ(0U, getManager()->stats().cursorsMultiTarget);
@@ -37,5 +37,6 @@ namespace mongo {
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryAlwaysMergeOnPrimaryShard, bool, false);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryProhibitMergingOnMongoS, bool, false);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryDisableExchange, bool, false);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(internalQueryMongosTempDir, std::string, "");
 
 }  // namespace mongo
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/platform/atomic_word.h"
 
 namespace mongo {
@@ -48,4 +50,9 @@ extern AtomicBool internalQueryProhibitMergingOnMongoS;
 // If set to true on mongos then the cluster query planner will not produce plans with the exchange.
 // False by default, so the queries run with exchanges.
 extern AtomicBool internalQueryDisableExchange;
+
+// The directory in which mongos stages such as $sort and $group may spill to disk when run with
+// 'allowDiskUse'. If empty, the default, mongos never spills, and pipelines which may need to do so
+// merge on a shard instead.
+extern std::string internalQueryMongosTempDir;
 }  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include "mongo/client/remote_command_retry_scheduler.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
@@ -44,6 +45,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -67,12 +69,27 @@ std::vector<RemoteCursor> establishCursors(OperationContext* opCtx,
                                                 readPref,
                                                 Shard::RetryPolicy::kIdempotent);
 
+    // Record how long each shard took to respond, so that the slow query log can show which shards
+    // held up the establishment of the cursors.
+    Timer timer;
+    BSONObjBuilder establishMillisBuilder;
+    ON_BLOCK_EXIT([&] {
+        // An operation may establish cursors more than once, for instance on the shards and then
+        // on a merging shard. Keep the first time recorded for each shard.
+        auto& cursorEstablishMillis = CurOp::get(opCtx)->debug().cursorEstablishMillis;
+        BSONObjBuilder merged;
+        merged.appendElements(cursorEstablishMillis);
+        merged.appendElementsUnique(establishMillisBuilder.obj());
+        cursorEstablishMillis = merged.obj();
+    });
+
     std::vector<RemoteCursor> remoteCursors;
     try {
         // Get the responses
         while (!ars.done()) {
             try {
                 auto response = ars.next();
+                establishMillisBuilder.appendNumber(response.shardId.toString(), timer.millis());
                 // Note the shardHostAndPort may not be populated if there was an error, so be sure
                 // to do this after parsing the cursor response to ensure the response was ok.
                 // Additionally, be careful not to push into 'remoteCursors' until we are sure we
@@ -30,6 +30,7 @@
 
 #include "mongo/client/remote_command_targeter_factory_mock.h"
 #include "mongo/client/remote_command_targeter_mock.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/json.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/s/catalog/type_shard.h"
@@ -126,6 +127,37 @@ TEST_F(EstablishCursorsTest, SingleRemoteRespondsWithSuccess) {
     future.timed_get(kFutureTimeout);
 }
 
+TEST_F(EstablishCursorsTest, RecordsEstablishTimeForEachRemote) {
+    BSONObj cmdObj = fromjson("{find: 'testcoll'}");
+    std::vector<std::pair<ShardId, BSONObj>> remotes{{kTestShardIds[0], cmdObj},
+                                                     {kTestShardIds[1], cmdObj}};
+
+    auto future = launchAsync([&] {
+        auto cursors = establishCursors(operationContext(),
+                                        executor(),
+                                        _nss,
+                                        ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                                        remotes,
+                                        false);  // allowPartialResults
+        ASSERT_EQUALS(remotes.size(), cursors.size());
+
+        auto establishMillis = CurOp::get(operationContext())->debug().cursorEstablishMillis;
+        ASSERT_EQ(establishMillis.nFields(), 2);
+        ASSERT_TRUE(establishMillis[kTestShardIds[0].toString()].isNumber());
+        ASSERT_TRUE(establishMillis[kTestShardIds[1].toString()].isNumber());
+    });
+
+    for (size_t i = 0; i < remotes.size(); ++i) {
+        onCommand([this](const RemoteCommandRequest& request) {
+            std::vector<BSONObj> batch = {fromjson("{_id: 1}")};
+            CursorResponse cursorResponse(_nss, CursorId(123), batch);
+            return cursorResponse.toBSON(CursorResponse::ResponseType::InitialResponse);
+        });
+    }
+
+    future.timed_get(kFutureTimeout);
+}
+
 TEST_F(EstablishCursorsTest, SingleRemoteRespondsWithNonretriableError) {
     BSONObj cmdObj = fromjson("{find: 'testcoll'}");
     std::vector<std::pair<ShardId, BSONObj>> remotes{{kTestShardIds[0], cmdObj}};
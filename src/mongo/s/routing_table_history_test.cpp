@@ -317,5 +317,114 @@ TEST_F(RoutingTableHistoryTestThreeInitialChunks,
                               expectedBytesInChunksNotSplit);
 }
 
+TEST(RoutingTableHistoryShardRanges, GetShardIdsForRangeSpanningAdjacentChunksOnTheSameShard) {
+    const OID epoch = OID::gen();
+    const KeyPattern shardKeyPattern(BSON("a" << 1));
+    const ShardId shard0("shard0");
+    const ShardId shard1("shard1");
+
+    ChunkVersion version{1, 0, epoch};
+    auto makeChunk = [&](BSONObj min, BSONObj max, const ShardId& shardId) {
+        version.incMajor();
+        return ChunkType{kNss, ChunkRange{min, max}, version, shardId};
+    };
+
+    std::vector<ChunkType> chunks;
+    chunks.push_back(makeChunk(shardKeyPattern.globalMin(), BSON("a" << 10), shard0));
+    chunks.push_back(makeChunk(BSON("a" << 10), BSON("a" << 20), shard0));
+    chunks.push_back(makeChunk(BSON("a" << 20), BSON("a" << 30), shard1));
+    chunks.push_back(makeChunk(BSON("a" << 30), shardKeyPattern.globalMax(), shard0));
+
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), shardKeyPattern, nullptr, false, epoch, chunks);
+    ChunkManager cm(rt, boost::none);
+
+    std::set<ShardId> shardIds;
+    cm.getShardIdsForRange(BSON("a" << 0), BSON("a" << 19), &shardIds);
+    ASSERT(std::set<ShardId>{shard0} == shardIds);
+
+    shardIds.clear();
+    cm.getShardIdsForRange(BSON("a" << 0), BSON("a" << 20), &shardIds);
+    ASSERT((std::set<ShardId>{shard0, shard1} == shardIds));
+
+    shardIds.clear();
+    cm.getShardIdsForRange(BSON("a" << 25), BSON("a" << 26), &shardIds);
+    ASSERT(std::set<ShardId>{shard1} == shardIds);
+
+    ASSERT(cm.rangeOverlapsShard(ChunkRange(BSON("a" << 15), BSON("a" << 21)), shard1));
+    ASSERT_FALSE(cm.rangeOverlapsShard(ChunkRange(BSON("a" << 15), BSON("a" << 20)), shard1));
+
+    // Moving the only chunk on shard1 to shard0 merges everything into a single range
+    auto updatedRt = rt->makeUpdated({makeChunk(BSON("a" << 20), BSON("a" << 30), shard0)});
+    ChunkManager updatedCm(updatedRt, boost::none);
+
+    shardIds.clear();
+    updatedCm.getShardIdsForRange(
+        shardKeyPattern.globalMin(), shardKeyPattern.globalMax(), &shardIds);
+    ASSERT(std::set<ShardId>{shard0} == shardIds);
+    ASSERT_FALSE(
+        updatedCm.rangeOverlapsShard(ChunkRange(BSON("a" << 20), BSON("a" << 30)), shard1));
+}
+
+/**
+ * Asserts that the chunks in "rt" cover the whole key space in order and returns their number.
+ */
+size_t assertChunksAreContiguous(const RoutingTableHistory& rt, const KeyPattern& shardKeyPattern) {
+    size_t numChunks = 0;
+    BSONObj expectedMin = shardKeyPattern.globalMin();
+    for (const auto& kv : rt.getChunkMap()) {
+        ASSERT_BSONOBJ_EQ(expectedMin, kv.second->getMin());
+        expectedMin = kv.second->getMax();
+        ++numChunks;
+    }
+    ASSERT_BSONOBJ_EQ(shardKeyPattern.globalMax(), expectedMin);
+    ASSERT_EQ(numChunks, rt.getChunkMap().size());
+    return numChunks;
+}
+
+TEST(RoutingTableHistoryUpdates, UpdatesSpanningManyChunksLeaveThePreviousRoutingTableIntact) {
+    const OID epoch = OID::gen();
+    const KeyPattern shardKeyPattern(BSON("a" << 1));
+    const int numChunks = 2000;
+
+    ChunkVersion version{1, 0, epoch};
+    std::vector<ChunkType> chunks;
+    for (int i = 0; i < numChunks; ++i) {
+        const auto min = i == 0 ? shardKeyPattern.globalMin() : BSON("a" << i);
+        const auto max = i == numChunks - 1 ? shardKeyPattern.globalMax() : BSON("a" << i + 1);
+        version.incMajor();
+        chunks.emplace_back(kNss, ChunkRange{min, max}, version, kThisShard);
+    }
+
+    auto rt = RoutingTableHistory::makeNew(
+        kNss, UUID::gen(), shardKeyPattern, nullptr, false, epoch, chunks);
+    ASSERT_EQ(size_t(numChunks), assertChunksAreContiguous(*rt, shardKeyPattern));
+
+    // Merge a range which spans several pages of the chunk map and move another chunk
+    const ShardId otherShard("otherShard");
+    version.incMajor();
+    const ChunkType mergedChunk{
+        kNss, ChunkRange{BSON("a" << 100), BSON("a" << 1500)}, version, otherShard};
+    version.incMajor();
+    const ChunkType movedChunk{
+        kNss, ChunkRange{BSON("a" << 1700), BSON("a" << 1701)}, version, otherShard};
+
+    auto updatedRt = rt->makeUpdated({mergedChunk, movedChunk});
+    ASSERT_EQ(size_t(numChunks), assertChunksAreContiguous(*rt, shardKeyPattern));
+    ASSERT_EQ(size_t(numChunks - 1400 + 1),
+              assertChunksAreContiguous(*updatedRt, shardKeyPattern));
+
+    ChunkManager cm(rt, boost::none);
+    ChunkManager updatedCm(updatedRt, boost::none);
+    for (int key : {99, 100, 1000, 1500, 1700, 1701}) {
+        const bool moved = (key >= 100 && key < 1500) || key == 1700;
+        ASSERT_EQ(kThisShard,
+                  cm.findIntersectingChunkWithSimpleCollation(BSON("a" << key)).getShardId());
+        ASSERT_EQ(moved ? otherShard : kThisShard,
+                  updatedCm.findIntersectingChunkWithSimpleCollation(BSON("a" << key))
+                      .getShardId());
+    }
+}
+
 }  // namespace
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 #include <vector>
 
+#include "mongo/db/bson/bsonobj_field_index.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/field_ref_set.h"
 #include "mongo/db/hasher.h"
@@ -132,6 +133,55 @@ BSONElement extractKeyElementFromMatchable(const MatchableDocument& matchable, S
     return matchEl;
 }
 
+/**
+ * Returns the element at 'path' in the document behind 'fieldIndex', with the same semantics as
+ * extractKeyElementFromMatchable(): arrays are not traversed, so a path which descends through an
+ * array yields EOO, while an array at the end of the path is returned as-is.
+ */
+BSONElement extractKeyElementFromDoc(const BSONObjFieldIndex& fieldIndex, StringData path) {
+    size_t dotOffset = path.find('.');
+    BSONElement elem = fieldIndex.getField(path.substr(0, dotOffset));
+    while (dotOffset != std::string::npos) {
+        if (elem.type() != BSONType::Object)
+            return BSONElement();
+
+        path = path.substr(dotOffset + 1);
+        dotOffset = path.find('.');
+        elem = elem.Obj().getField(path.substr(0, dotOffset));
+    }
+    return elem;
+}
+
+/**
+ * Builds the shard key for 'keyPattern', calling 'extractKeyElement' to find the value of each
+ * field in the pattern. Returns an empty object if any of the values is missing or an array.
+ */
+template <typename ExtractKeyElementFn>
+BSONObj extractShardKey(const BSONObj& keyPattern, ExtractKeyElementFn&& extractKeyElement) {
+    BSONObjBuilder keyBuilder;
+
+    BSONObjIterator patternIt(keyPattern);
+    while (patternIt.more()) {
+        BSONElement patternEl = patternIt.next();
+        BSONElement matchEl = extractKeyElement(patternEl.fieldNameStringData());
+
+        if (!isValidShardKeyElement(matchEl))
+            return BSONObj();
+
+        if (ShardKeyPattern::isHashedPatternEl(patternEl)) {
+            keyBuilder.append(
+                patternEl.fieldName(),
+                BSONElementHasher::hash64(matchEl, BSONElementHasher::DEFAULT_HASH_SEED));
+        } else {
+            // NOTE: The matched element may *not* have the same field name as the path -
+            // index keys don't contain field names, for example
+            keyBuilder.appendAs(matchEl, patternEl.fieldName());
+        }
+    }
+
+    return keyBuilder.obj();
+}
+
 BSONElement findEqualityElement(const EqualityMatches& equalities, const FieldRef& path) {
     int parentPathPart;
     const BSONElement parentEl =
@@ -244,42 +294,29 @@ BSONObj ShardKeyPattern::normalizeShardKey(const BSONObj& shardKey) const {
 }
 
 BSONObj ShardKeyPattern::extractShardKeyFromMatchable(const MatchableDocument& matchable) const {
-    BSONObjBuilder keyBuilder;
-
-    BSONObjIterator patternIt(_keyPattern.toBSON());
-    while (patternIt.more()) {
-        BSONElement patternEl = patternIt.next();
-        BSONElement matchEl =
-            extractKeyElementFromMatchable(matchable, patternEl.fieldNameStringData());
-
-        if (!isValidShardKeyElement(matchEl))
-            return BSONObj();
-
-        if (isHashedPatternEl(patternEl)) {
-            keyBuilder.append(
-                patternEl.fieldName(),
-                BSONElementHasher::hash64(matchEl, BSONElementHasher::DEFAULT_HASH_SEED));
-        } else {
-            // NOTE: The matched element may *not* have the same field name as the path -
-            // index keys don't contain field names, for example
-            keyBuilder.appendAs(matchEl, patternEl.fieldName());
-        }
-    }
-
-    dassert(isShardKey(keyBuilder.asTempObj()));
-    return keyBuilder.obj();
+    BSONObj shardKey = extractShardKey(_keyPattern.toBSON(), [&](StringData path) {
+        return extractKeyElementFromMatchable(matchable, path);
+    });
+    dassert(shardKey.isEmpty() || isShardKey(shardKey));
+    return shardKey;
 }
 
 BSONObj ShardKeyPattern::extractShardKeyFromDoc(const BSONObj& doc) const {
-    BSONMatchableDocument matchable(doc);
-    return extractShardKeyFromMatchable(matchable);
+    // Walk the document directly rather than through a BSONMatchableDocument, which allocates an
+    // iterator for every field of the key.
+    BSONObjFieldIndex fieldIndex(doc);
+    BSONObj shardKey = extractShardKey(_keyPattern.toBSON(), [&](StringData path) {
+        return extractKeyElementFromDoc(fieldIndex, path);
+    });
+    dassert(shardKey.isEmpty() || isShardKey(shardKey));
+    return shardKey;
 }
 
 std::vector<StringData> ShardKeyPattern::findMissingShardKeyFieldsFromDoc(const BSONObj doc) const {
     std::vector<StringData> missingFields;
-    BSONMatchableDocument matchable(doc);
+    BSONObjFieldIndex fieldIndex(doc);
     for (const auto& skField : _keyPattern.toBSON()) {
-        auto matchEl = extractKeyElementFromMatchable(matchable, skField.fieldNameStringData());
+        auto matchEl = extractKeyElementFromDoc(fieldIndex, skField.fieldNameStringData());
         if (!isValidShardKeyElement(matchEl))
             missingFields.emplace_back(skField.fieldNameStringData());
     }
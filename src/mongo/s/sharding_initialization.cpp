@@ -32,6 +32,7 @@
 
 #include "mongo/s/sharding_initialization.h"
 
+#include <algorithm>
 #include <string>
 
 #include "mongo/base/status.h"
@@ -96,6 +97,14 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolRefreshTimeoutMS,
                                       int,
                                       ConnectionPool::kDefaultRefreshTimeout.count());
 
+// Number of independent pools kept per host in each task executor's connection pool, to spread
+// lock contention on busy hosts. Connection limits apply to each of these pools.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolStripesPerHost, int, 1);
+
+// If positive, pools open spare connections while the average wait for a connection is above
+// this many milliseconds. At most ShardingTaskExecutorPoolMaxConnecting spares are kept per pool.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ShardingTaskExecutorPoolAdaptiveWaitThresholdMS, int, 0);
+
 namespace {
 
 using executor::NetworkInterface;
@@ -191,6 +200,10 @@ Status initializeGlobalShardingState(OperationContext* opCtx,
     connPoolOptions.minConnections = ShardingTaskExecutorPoolMinSize;
     connPoolOptions.refreshRequirement = Milliseconds(ShardingTaskExecutorPoolRefreshRequirementMS);
     connPoolOptions.refreshTimeout = Milliseconds(ShardingTaskExecutorPoolRefreshTimeoutMS);
+    connPoolOptions.poolsPerHost =
+        static_cast<size_t>(std::max(ShardingTaskExecutorPoolStripesPerHost, 1));
+    connPoolOptions.adaptiveWaitThreshold =
+        Milliseconds(ShardingTaskExecutorPoolAdaptiveWaitThresholdMS);
 
     if (connPoolOptions.refreshRequirement <= connPoolOptions.refreshTimeout) {
         auto newRefreshTimeout = connPoolOptions.refreshRequirement - Milliseconds(1);
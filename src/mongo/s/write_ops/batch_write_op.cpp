@@ -30,15 +30,26 @@
 
 #include "mongo/s/write_ops/batch_write_op.h"
 
+#include <algorithm>
 #include <numeric>
 
 #include "mongo/base/error_codes.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/transitional_tools_do_not_use/vector_spooling.h"
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(maxPipelinedOrderedWriteBatches, int, 1)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 1) {
+            return Status(ErrorCodes::BadValue,
+                          "maxPipelinedOrderedWriteBatches must be greater than or equal to 1");
+        }
+        return Status::OK();
+    });
+
 using std::unique_ptr;
 using std::set;
 using std::stringstream;
@@ -66,6 +77,51 @@ struct WriteErrorDetailComp {
 const int kEstUpdateOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 const int kEstDeleteOverheadBytes = (BSONObjMaxInternalSize - BSONObjMaxUserSize) / 100;
 
+/**
+ * Targets the documents of an insert batch in windows of consecutive documents, so that the
+ * targeter can share work between them. The window starts small and doubles each time it is used
+ * up, so that an ordered batch which stops at a document going to a different shard does little
+ * targeting work for documents it does not send in this round.
+ */
+class InsertTargetingWindow {
+public:
+    InsertTargetingWindow(OperationContext* opCtx,
+                          const NSTargeter& targeter,
+                          const std::vector<BSONObj>& docs)
+        : _opCtx(opCtx), _targeter(targeter), _docs(docs) {}
+
+    /**
+     * Returns the targeting result for the document at 'index'. Must be called with increasing
+     * indexes, at most once each.
+     */
+    StatusWith<ShardEndpoint> target(size_t index) {
+        if (index < _begin || index >= _begin + _endpoints.size()) {
+            _begin = index;
+            _endpoints.clear();
+            _targeter.targetInserts(
+                _opCtx, _docs, index, std::min(_docs.size(), index + _windowSize), &_endpoints);
+            _windowSize = std::min(_windowSize * 2, kMaxWindowSize);
+        }
+
+        return std::move(_endpoints[index - _begin]);
+    }
+
+private:
+    static constexpr size_t kInitialWindowSize = 16;
+    static constexpr size_t kMaxWindowSize = 1024;
+
+    OperationContext* const _opCtx;
+    const NSTargeter& _targeter;
+    const std::vector<BSONObj>& _docs;
+
+    size_t _windowSize{kInitialWindowSize};
+    size_t _begin{0};
+    std::vector<StatusWith<ShardEndpoint>> _endpoints;
+};
+
+constexpr size_t InsertTargetingWindow::kInitialWindowSize;
+constexpr size_t InsertTargetingWindow::kMaxWindowSize;
+
 /**
  * Returns a new write concern that has the copy of every field from the original
  * document but with a w set to 1. This is intended for upgrading { w: 0 } write
@@ -93,17 +149,29 @@ void buildTargetError(const Status& errStatus, WriteErrorDetail* details) {
 }
 
 /**
- * Helper to determine whether a number of targeted writes require a new targeted batch.
+ * Helper to determine whether a number of targeted writes of an ordered batch can be added to the
+ * batches targeted so far. Writes can only be appended to the most recently started batch, or, if
+ * pipelining allows for another batch, start a new batch to a shard which has not been targeted
+ * yet. A write which targets several shards is always sent on its own.
  */
-bool isNewBatchRequiredOrdered(const std::vector<TargetedWrite*>& writes,
-                               const TargetedBatchMap& batchMap) {
-    for (const auto write : writes) {
-        if (batchMap.find(&write->endpoint) == batchMap.end()) {
-            return true;
-        }
+bool canAddToBatchesOrdered(const std::vector<TargetedWrite*>& writes,
+                            const TargetedBatchMap& batchMap,
+                            const std::set<ShardId>& targetedShards,
+                            const TargetedWriteBatch* lastBatch,
+                            size_t maxBatches) {
+    if (writes.size() != 1u) {
+        return false;
     }
 
-    return false;
+    const ShardEndpoint& endpoint = writes.front()->endpoint;
+
+    TargetedBatchMap::const_iterator it = batchMap.find(&endpoint);
+    if (it != batchMap.end()) {
+        return it->second == lastBatch;
+    }
+
+    return batchMap.size() < maxBatches &&
+        targetedShards.find(endpoint.shardName) == targetedShards.end();
 }
 
 /**
@@ -270,6 +338,10 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
     // Subsequent single-shard write operations can be batched together if they go to the same
     // place.
     //
+    // If 'maxPipelinedOrderedWriteBatches' allows, consecutive runs of single-shard write
+    // operations going to different shards are sent together as one targeted batch per shard,
+    // instead of one shard per round. Each shard is only targeted by one run in a round.
+    //
     // Ex: ShardA : { skey : a->k }, ShardB : { skey : k->z }
     //
     // Ordered insert batch of: [{ skey : a }, { skey : b }, { skey : x }]
@@ -290,14 +362,24 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
     //
 
     const bool ordered = _clientRequest.getWriteCommandBase().getOrdered();
+    const size_t maxOrderedBatches = maxPipelinedOrderedWriteBatches.load();
 
     TargetedBatchMap batchMap;
     std::set<ShardId> targetedShards;
 
+    // The batch which the last write of an ordered batch was added to
+    const TargetedWriteBatch* lastOrderedBatch = nullptr;
+
     int numTargetErrors = 0;
 
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
 
+    // Inserts are targeted a window of documents at a time
+    boost::optional<InsertTargetingWindow> insertTargeting;
+    if (_clientRequest.getBatchType() == BatchedCommandRequest::BatchType_Insert) {
+        insertTargeting.emplace(_opCtx, targeter, _clientRequest.getInsertRequest().getDocuments());
+    }
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -313,7 +395,9 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(_opCtx, targeter, &writes);
+        Status targetStatus = insertTargeting
+            ? writeOp.targetInsertWrites(insertTargeting->target(i), &writes)
+            : writeOp.targetWrites(_opCtx, targeter, &writes);
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
@@ -349,8 +433,8 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
         //
 
         if (ordered && !batchMap.empty()) {
-            dassert(batchMap.size() == 1u);
-            if (isNewBatchRequiredOrdered(writes, batchMap)) {
+            if (!canAddToBatchesOrdered(
+                    writes, batchMap, targetedShards, lastOrderedBatch, maxOrderedBatches)) {
                 writeOp.cancelWrites(NULL);
                 break;
             }
@@ -387,17 +471,18 @@ Status BatchWriteOp::targetBatch(const NSTargeter& targeter,
 
             TargetedWriteBatch* batch = batchIt->second;
             batch->addWrite(write, writeSizeBytes);
+            lastOrderedBatch = batch;
         }
 
         // Relinquish ownership of TargetedWrites, now the TargetedBatches own them
         writesOwned.mutableVector().clear();
 
         //
-        // Break if we're ordered and we have more than one endpoint - later writes cannot be
-        // enforced as ordered across multiple shard endpoints.
+        // Break if we're ordered and this write went to more than one endpoint - later writes
+        // cannot be enforced as ordered across multiple shard endpoints.
         //
 
-        if (ordered && batchMap.size() > 1u)
+        if (ordered && writes.size() > 1u)
             break;
     }
 
@@ -715,12 +800,18 @@ void BatchWriteOp::buildClientResponse(BatchedCommandResponse* batchResp) {
 
     vector<WriteOp*> errOps;
 
+    const bool orderedOps = _clientRequest.getWriteCommandBase().getOrdered();
     const size_t numWriteOps = _clientRequest.sizeWriteOps();
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
         if (writeOp.getWriteState() == WriteOpState_Error) {
             errOps.push_back(&writeOp);
+
+            // Batches of an ordered write which were pipelined may have failed after the first
+            // error, only the first one is reported
+            if (orderedOps)
+                break;
         }
     }
 
@@ -739,7 +830,6 @@ void BatchWriteOp::buildClientResponse(BatchedCommandResponse* batchResp) {
 
     // Only return a write concern error if everything succeeded (unordered or ordered)
     // OR if something succeeded and we're unordered
-    const bool orderedOps = _clientRequest.getWriteCommandBase().getOrdered();
     const bool reportWCError =
         errOps.empty() || (!orderedOps && errOps.size() < _clientRequest.sizeWriteOps());
     if (!_wcErrors.empty() && reportWCError) {
@@ -36,6 +36,7 @@
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
 #include "mongo/db/logical_session_id.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/rpc/write_concern_error_detail.h"
 #include "mongo/s/ns_targeter.h"
 #include "mongo/s/write_ops/batched_command_request.h"
@@ -50,6 +51,16 @@ class OperationContext;
 class TargetedWriteBatch;
 class TrackedErrors;
 
+/**
+ * Maximum number of child batches of an ordered write which may be dispatched to different shards
+ * in the same round. The default of 1 sends the batches of an ordered write one at a time.
+ *
+ * Above 1, writes after an error on one shard may already have been applied by a batch which was
+ * dispatched speculatively to another shard. These are not rolled back - they are counted in 'n',
+ * but only the first error is reported, with its index in the client's batch.
+ */
+extern AtomicInt32 maxPipelinedOrderedWriteBatches;
+
 /**
  * Simple struct for storing an error with an endpoint.
  *
@@ -473,6 +473,126 @@ void verifyTargetedBatches(std::map<ShardId, size_t> expected,
     ASSERT(expected.empty());
 }
 
+/**
+ * Sets 'maxPipelinedOrderedWriteBatches' for the lifetime of the object.
+ */
+class ScopedMaxPipelinedOrderedWriteBatches {
+public:
+    explicit ScopedMaxPipelinedOrderedWriteBatches(int value)
+        : _oldValue(maxPipelinedOrderedWriteBatches.swap(value)) {}
+
+    ~ScopedMaxPipelinedOrderedWriteBatches() {
+        maxPipelinedOrderedWriteBatches.store(_oldValue);
+    }
+
+private:
+    const int _oldValue;
+};
+
+// Multi-op, multi-endpoint targeting test (ordered, pipelined). Consecutive runs of writes going to
+// different shards are sent in the same round, until a shard would be targeted by a second run.
+TEST_F(BatchWriteOpTest, MultiOpTwoShardsOrderedPipelined) {
+    ScopedMaxPipelinedOrderedWriteBatches pipelining(2);
+
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setDocuments(
+            {BSON("x" << -1), BSON("x" << -2), BSON("x" << 1), BSON("x" << 2), BSON("x" << -3)});
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT(!batchOp.isFinished());
+    ASSERT_EQUALS(targeted.size(), 2u);
+    verifyTargetedBatches({{endpointA.shardName, 2u}, {endpointB.shardName, 2u}}, targeted);
+
+    BatchedCommandResponse response;
+    buildResponse(2, &response);
+
+    batchOp.noteBatchResponse(*targeted[endpointA.shardName], response, NULL);
+    batchOp.noteBatchResponse(*targeted[endpointB.shardName], response, NULL);
+    ASSERT(!batchOp.isFinished());
+
+    targetedOwned.clear();
+
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT_EQUALS(targeted.size(), 1u);
+    ASSERT_EQUALS(targeted.begin()->second->getWrites().size(), 1u);
+    assertEndpointsEqual(targeted.begin()->second->getEndpoint(), endpointA);
+
+    buildResponse(1, &response);
+    batchOp.noteBatchResponse(*targeted.begin()->second, response, NULL);
+    ASSERT(batchOp.isFinished());
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), 5);
+}
+
+// Ordered, pipelined batch where both shards report an error. Only the first error of the client
+// batch is reported, and the writes applied by the speculatively sent batch are counted.
+TEST_F(BatchWriteOpTest, MultiOpTwoShardErrorsOrderedPipelined) {
+    ScopedMaxPipelinedOrderedWriteBatches pipelining(2);
+
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setDocuments({BSON("x" << -1),
+                               BSON("x" << -2),
+                               BSON("x" << -3),
+                               BSON("x" << 1),
+                               BSON("x" << 2),
+                               BSON("x" << 3)});
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT_EQUALS(targeted.size(), 2u);
+    verifyTargetedBatches({{endpointA.shardName, 3u}, {endpointB.shardName, 3u}}, targeted);
+
+    // The second shard responds first, with an error on its second write
+    BatchedCommandResponse responseB;
+    buildResponse(1, &responseB);
+    addError(ErrorCodes::DuplicateKey, "mock error B", 1, &responseB);
+    batchOp.noteBatchResponse(*targeted[endpointB.shardName], responseB, NULL);
+
+    // The first shard fails on its second write as well
+    BatchedCommandResponse responseA;
+    buildResponse(1, &responseA);
+    addError(ErrorCodes::DuplicateKey, "mock error A", 1, &responseA);
+    batchOp.noteBatchResponse(*targeted[endpointA.shardName], responseA, NULL);
+    ASSERT(batchOp.isFinished());
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), 2);
+    ASSERT(clientResponse.isErrDetailsSet());
+    ASSERT_EQUALS(clientResponse.sizeErrDetails(), 1u);
+    ASSERT_EQUALS(clientResponse.getErrDetailsAt(0)->toStatus().reason(), "mock error A");
+    ASSERT_EQUALS(clientResponse.getErrDetailsAt(0)->getIndex(), 1);
+}
+
 // Multi-op, multi-endpoint targeting test (unordered). There should be one set of two batches (one
 // to each shard).
 TEST_F(BatchWriteOpTest, MultiOpTwoShardsUnordered) {
@@ -519,6 +639,65 @@ TEST_F(BatchWriteOpTest, MultiOpTwoShardsUnordered) {
     ASSERT_EQUALS(clientResponse.getN(), 2);
 }
 
+// Unordered insert of more documents than fit in a single targeting window, alternating between
+// two shards. Every document should be targeted to its own shard.
+TEST_F(BatchWriteOpTest, ManyInsertsTwoShardsUnordered) {
+    NamespaceString nss("foo.bar");
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+    MockNSTargeter targeter;
+    initTargeterSplitRange(nss, endpointA, endpointB, &targeter);
+
+    const int numDocs = 100;
+
+    BatchedCommandRequest request([&] {
+        write_ops::Insert insertOp(nss);
+        insertOp.setWriteCommandBase([] {
+            write_ops::WriteCommandBase wcb;
+            wcb.setOrdered(false);
+            return wcb;
+        }());
+        std::vector<BSONObj> docs;
+        for (int i = 0; i < numDocs; ++i) {
+            docs.push_back(BSON("x" << (i % 2 == 0 ? -(i + 1) : i)));
+        }
+        insertOp.setDocuments(docs);
+        return insertOp;
+    }());
+
+    BatchWriteOp batchOp(operationContext(), request);
+
+    OwnedPointerMap<ShardId, TargetedWriteBatch> targetedOwned;
+    std::map<ShardId, TargetedWriteBatch*>& targeted = targetedOwned.mutableMap();
+    ASSERT_OK(batchOp.targetBatch(targeter, false, &targeted));
+    ASSERT(!batchOp.isFinished());
+    ASSERT_EQUALS(targeted.size(), 2u);
+    verifyTargetedBatches(
+        {{endpointA.shardName, numDocs / 2}, {endpointB.shardName, numDocs / 2}}, targeted);
+
+    for (auto it = targeted.begin(); it != targeted.end(); ++it) {
+        const auto& writes = it->second->getWrites();
+        for (size_t i = 0; i < writes.size(); ++i) {
+            const int index = writes[i]->writeOpRef.first;
+            ASSERT_EQUALS(it->first, index % 2 == 0 ? endpointA.shardName : endpointB.shardName);
+        }
+    }
+
+    BatchedCommandResponse response;
+    buildResponse(numDocs / 2, &response);
+
+    for (auto it = targeted.begin(); it != targeted.end(); ++it) {
+        ASSERT(!batchOp.isFinished());
+        batchOp.noteBatchResponse(*it->second, response, NULL);
+    }
+    ASSERT(batchOp.isFinished());
+
+    BatchedCommandResponse clientResponse;
+    batchOp.buildClientResponse(&clientResponse);
+    ASSERT(clientResponse.getOk());
+    ASSERT_EQUALS(clientResponse.getN(), numDocs);
+}
+
 // Multi-op (ordered) targeting test where each op goes to both shards. There should be two sets of
 // two batches to each shard (two for each delete op).
 TEST_F(BatchWriteOpTest, MultiOpTwoShardsEachOrdered) {
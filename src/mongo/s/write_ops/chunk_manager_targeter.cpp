@@ -340,31 +340,40 @@ const NamespaceString& ChunkManagerTargeter::getNS() const {
     return _nss;
 }
 
+StatusWith<BSONObj> ChunkManagerTargeter::_extractInsertShardKey(const BSONObj& doc) const {
+    //
+    // Sharded collections have the following requirements for targeting:
+    //
+    // Inserts must contain the exact shard key.
+    //
+
+    BSONObj shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
+
+    // Check shard key exists
+    if (shardKey.isEmpty()) {
+        return {ErrorCodes::ShardKeyNotFound,
+                str::stream() << "document " << doc << " does not contain shard key for pattern "
+                              << _routingInfo->cm()->getShardKeyPattern().toString()};
+    }
+
+    // Check shard key size on insert
+    Status status = ShardKeyPattern::checkShardKeySize(shardKey);
+    if (!status.isOK())
+        return status;
+
+    return shardKey;
+}
+
 StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* opCtx,
                                                              const BSONObj& doc) const {
     BSONObj shardKey;
 
     if (_routingInfo->cm()) {
-        //
-        // Sharded collections have the following requirements for targeting:
-        //
-        // Inserts must contain the exact shard key.
-        //
-
-        shardKey = _routingInfo->cm()->getShardKeyPattern().extractShardKeyFromDoc(doc);
-
-        // Check shard key exists
-        if (shardKey.isEmpty()) {
-            return {ErrorCodes::ShardKeyNotFound,
-                    str::stream() << "document " << doc
-                                  << " does not contain shard key for pattern "
-                                  << _routingInfo->cm()->getShardKeyPattern().toString()};
-        }
+        auto swShardKey = _extractInsertShardKey(doc);
+        if (!swShardKey.isOK())
+            return swShardKey.getStatus();
 
-        // Check shard key size on insert
-        Status status = ShardKeyPattern::checkShardKeySize(shardKey);
-        if (!status.isOK())
-            return status;
+        shardKey = std::move(swShardKey.getValue());
     }
 
     // Target the shard key or database primary
@@ -383,6 +392,40 @@ StatusWith<ShardEndpoint> ChunkManagerTargeter::targetInsert(OperationContext* o
     return Status::OK();
 }
 
+void ChunkManagerTargeter::targetInserts(OperationContext* opCtx,
+                                         const std::vector<BSONObj>& docs,
+                                         size_t begin,
+                                         size_t end,
+                                         std::vector<StatusWith<ShardEndpoint>>* endpoints) const {
+    const auto& cm = _routingInfo->cm();
+    if (!cm) {
+        NSTargeter::targetInserts(opCtx, docs, begin, end, endpoints);
+        return;
+    }
+
+    // Bulk inserts often have consecutive documents in the same chunk, for example when the shard
+    // key increases monotonically, so the last chunk targeted is checked before looking the shard
+    // key up in the routing table.
+    boost::optional<Chunk> lastChunk;
+    boost::optional<ShardEndpoint> lastEndpoint;
+
+    for (size_t i = begin; i < end; ++i) {
+        auto swShardKey = _extractInsertShardKey(docs[i]);
+        if (!swShardKey.isOK()) {
+            endpoints->push_back(swShardKey.getStatus());
+            continue;
+        }
+
+        const auto& shardKey = swShardKey.getValue();
+        if (!lastChunk || !lastChunk->containsKey(shardKey)) {
+            lastChunk.emplace(cm->findIntersectingChunk(shardKey, CollationSpec::kSimpleSpec));
+            lastEndpoint.emplace(lastChunk->getShardId(), cm->getVersion(lastChunk->getShardId()));
+        }
+
+        endpoints->push_back(*lastEndpoint);
+    }
+}
+
 StatusWith<std::vector<ShardEndpoint>> ChunkManagerTargeter::targetUpdate(
     OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const {
     //
@@ -72,6 +72,13 @@ public:
     StatusWith<ShardEndpoint> targetInsert(OperationContext* opCtx,
                                            const BSONObj& doc) const override;
 
+    // Consecutive documents with shard keys in the same chunk share a routing table lookup.
+    void targetInserts(OperationContext* opCtx,
+                       const std::vector<BSONObj>& docs,
+                       size_t begin,
+                       size_t end,
+                       std::vector<StatusWith<ShardEndpoint>>* endpoints) const override;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     StatusWith<std::vector<ShardEndpoint>> targetUpdate(
         OperationContext* opCtx, const write_ops::UpdateOpEntry& updateDoc) const override;
@@ -108,6 +115,12 @@ private:
      */
     Status _refreshNow(OperationContext* opCtx);
 
+    /**
+     * Returns the shard key of 'doc' for inserting it into a sharded collection, or
+     * ShardKeyNotFound if it does not contain the full shard key.
+     */
+    StatusWith<BSONObj> _extractInsertShardKey(const BSONObj& doc) const;
+
     /**
      * Attempts to route an update operation by extracting an exact shard key from the given query
      * and/or update expression. Should only be called on sharded collections, and with a valid
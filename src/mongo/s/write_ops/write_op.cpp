@@ -82,8 +82,23 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
     if (!swEndpoints.isOK())
         return swEndpoints.getStatus();
 
-    auto& endpoints = swEndpoints.getValue();
+    _addChildWrites(std::move(swEndpoints.getValue()), targetedWrites);
+    return Status::OK();
+}
+
+Status WriteOp::targetInsertWrites(StatusWith<ShardEndpoint> swEndpoint,
+                                   std::vector<TargetedWrite*>* targetedWrites) {
+    invariant(_itemRef.getOpType() == BatchedCommandRequest::BatchType_Insert);
+
+    if (!swEndpoint.isOK())
+        return swEndpoint.getStatus();
 
+    _addChildWrites({std::move(swEndpoint.getValue())}, targetedWrites);
+    return Status::OK();
+}
+
+void WriteOp::_addChildWrites(std::vector<ShardEndpoint> endpoints,
+                              std::vector<TargetedWrite*>* targetedWrites) {
     for (auto&& endpoint : endpoints) {
         _childOps.emplace_back(this);
 
@@ -101,7 +116,6 @@ Status WriteOp::targetWrites(OperationContext* opCtx,
     }
 
     _state = WriteOpState_Pending;
-    return Status::OK();
 }
 
 size_t WriteOp::getNumTargeted() {
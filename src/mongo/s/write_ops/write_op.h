@@ -121,6 +121,13 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as targetWrites() for an insert write item whose document was already targeted to
+     * 'swEndpoint', for example by NSTargeter::targetInserts().
+     */
+    Status targetInsertWrites(StatusWith<ShardEndpoint> swEndpoint,
+                              std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -164,6 +171,12 @@ private:
      */
     void _updateOpState();
 
+    /**
+     * Creates a child write for each of 'endpoints' and appends it to 'targetedWrites'.
+     */
+    void _addChildWrites(std::vector<ShardEndpoint> endpoints,
+                         std::vector<TargetedWrite*>* targetedWrites);
+
     // Owned elsewhere, reference to a batch with a write item
     const BatchItemRef _itemRef;
 
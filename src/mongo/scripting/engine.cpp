@@ -31,12 +31,14 @@
 
 #include "mongo/scripting/engine.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <cctype>
 
 #include "mongo/client/dbclient_base.h"
 #include "mongo/client/dbclient_cursor.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/scripting/dbdirectclient_factory.h"
 #include "mongo/util/fail_point_service.h"
@@ -324,9 +326,32 @@ void Scope::execCoreFiles() {
 }
 
 namespace {
+
+// Bounds on the idle scopes kept for reuse by getPooledScope(). Creating a scope means starting a
+// JS runtime and running the core shell files, so keeping enough of them around matters for
+// workloads that run $where on every query.
+MONGO_EXPORT_SERVER_PARAMETER(maxPooledJavaScriptScopes, int, 32)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "maxPooledJavaScriptScopes must be between 0 and 1000");
+        }
+        return Status::OK();
+    });
+
+// Keeps one busy database from evicting the idle scopes of every other database.
+MONGO_EXPORT_SERVER_PARAMETER(maxPooledJavaScriptScopesPerDatabase, int, 8)
+    ->withValidator([](const int& newVal) {
+        if (newVal < 0 || newVal > 1000) {
+            return Status(ErrorCodes::BadValue,
+                          "maxPooledJavaScriptScopesPerDatabase must be between 0 and 1000");
+        }
+        return Status::OK();
+    });
+
 class ScopeCache {
 public:
-    void release(const string& poolName, const std::shared_ptr<Scope>& scope) {
+    void release(const string& db, const string& poolName, const std::shared_ptr<Scope>& scope) {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
 
         if (scope->hasOutOfMemoryException()) {
@@ -339,16 +364,35 @@ public:
         if (scope->getTimesUsed() > kMaxScopeReuse)
             return;  // used too many times to save
 
+        if (scope->getNumCachedFunctions() > kMaxCachedFunctions)
+            return;  // don't let the compiled function cache grow without bound
+
         if (!scope->getError().empty())
             return;  // not saving errored scopes
 
-        if (_pools.size() >= kMaxPoolSize) {
-            // prefer to keep recently-used scopes
+        const size_t maxPoolSize = maxPooledJavaScriptScopes.load();
+        const size_t maxPerDatabase = maxPooledJavaScriptScopesPerDatabase.load();
+        if (maxPoolSize == 0 || maxPerDatabase == 0)
+            return;
+
+        // prefer to keep recently-used scopes, first within the database and then overall
+        auto lastForDb = _pools.end();
+        size_t numForDb = 0;
+        for (auto it = _pools.begin(); it != _pools.end(); ++it) {
+            if (it->db == db) {
+                lastForDb = it;
+                ++numForDb;
+            }
+        }
+        if (numForDb >= maxPerDatabase) {
+            _pools.erase(lastForDb);
+        }
+        while (_pools.size() >= maxPoolSize) {
             _pools.pop_back();
         }
 
         scope->reset();
-        ScopeAndPool toStore = {scope, poolName};
+        ScopeAndPool toStore = {scope, db, poolName};
         _pools.push_front(toStore);
     }
 
@@ -375,15 +419,26 @@ public:
         _pools.clear();
     }
 
+    size_t numPooled(const string& db) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        return std::count_if(_pools.begin(), _pools.end(), [&](const ScopeAndPool& entry) {
+            return entry.db == db;
+        });
+    }
+
 private:
     struct ScopeAndPool {
         std::shared_ptr<Scope> scope;
+        string db;
         string poolName;
     };
 
-    // Note: if these numbers change, reconsider choice of datastructure for _pools
-    static const unsigned kMaxPoolSize = 10;
-    static const int kMaxScopeReuse = 10;
+    // Pooled scopes keep the functions they have compiled, so a reused scope can skip compiling
+    // the same $where predicate again. These bound how much a single scope may accumulate.
+    // Note: _pools is searched linearly; reconsider its datastructure if the pool grows large.
+    static const int kMaxScopeReuse = 100;
+    static const size_t kMaxCachedFunctions = 1000;
 
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
@@ -397,13 +452,17 @@ void ScriptEngine::dropScopeCache() {
     scopeCache.clear();
 }
 
+size_t ScriptEngine::getNumPooledScopes_forTest(const std::string& db) {
+    return scopeCache.numPooled(db);
+}
+
 class PooledScope : public Scope {
 public:
-    PooledScope(const std::string& pool, const std::shared_ptr<Scope>& real)
-        : _pool(pool), _real(real) {}
+    PooledScope(const std::string& db, const std::string& pool, const std::shared_ptr<Scope>& real)
+        : _db(db), _pool(pool), _real(real) {}
 
     virtual ~PooledScope() {
-        scopeCache.release(_pool, _real);
+        scopeCache.release(_db, _pool, _real);
     }
 
     // wrappers for the derived (_real) scope
@@ -534,6 +593,7 @@ protected:
     }
 
 private:
+    string _db;
     string _pool;
     std::shared_ptr<Scope> _real;
 };
@@ -550,7 +610,7 @@ unique_ptr<Scope> ScriptEngine::getPooledScope(OperationContext* opCtx,
     }
 
     unique_ptr<Scope> p;
-    p.reset(new PooledScope(fullPoolName, s));
+    p.reset(new PooledScope(db, fullPoolName, s));
     p->setLocalDB(db);
     p->loadStored(opCtx, true);
     return p;
@@ -183,6 +183,11 @@ public:
         return _numTimesUsed;
     }
 
+    /** gets the number of functions compiled and cached by createFunction() */
+    size_t getNumCachedFunctions() const {
+        return _cachedFunctions.size();
+    }
+
     /** return true if last invoke() return'd native code */
     virtual bool isLastRetNativeCode() {
         return _lastRetIsNativeCode;
@@ -253,6 +258,9 @@ public:
     static void setup();
     static void dropScopeCache();
 
+    /** gets the number of idle scopes pooled for the db 'db' */
+    static size_t getNumPooledScopes_forTest(const std::string& db);
+
     /** gets a scope from the pool or a new one if pool is empty
      * @param db The db name
      * @param scopeType A unique id to limit scope sharing.
@@ -32,6 +32,7 @@
 
 #include "mongo/shell/bench.h"
 
+#include <algorithm>
 #include <pcrecpp.h>
 
 #include "mongo/client/dbclient_cursor.h"
@@ -328,6 +329,30 @@ BenchRunEventCounter::BenchRunEventCounter() = default;
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
     _numEvents += other._numEvents;
     _totalTimeMicros += other._totalTimeMicros;
+    _maxTimeMicros = std::max(_maxTimeMicros, other._maxTimeMicros);
+    _histogram.merge(other._histogram);
+}
+
+void BenchRunEventCounter::_recordInHistogram(long long timeMicros) {
+    _maxTimeMicros = std::max(_maxTimeMicros, timeMicros);
+    _histogram.increment(static_cast<uint64_t>(std::max(timeMicros, 0LL)));
+}
+
+long long BenchRunEventCounter::getPercentileMicros(double percentile) const {
+    return static_cast<long long>(_histogram.getPercentile(percentile));
+}
+
+void BenchRunEventCounter::appendLatencyStats(BSONObjBuilder* builder) const {
+    builder->append("count", _numEvents);
+    if (_numEvents == 0) {
+        return;
+    }
+    builder->append("mean", static_cast<double>(_totalTimeMicros) / _numEvents);
+    builder->append("p50", getPercentileMicros(50));
+    builder->append("p90", getPercentileMicros(90));
+    builder->append("p99", getPercentileMicros(99));
+    builder->append("p999", getPercentileMicros(99.9));
+    builder->append("max", _maxTimeMicros);
 }
 
 void BenchRunStats::updateFrom(const BenchRunStats& other) {
@@ -343,6 +368,10 @@ void BenchRunStats::updateFrom(const BenchRunStats& other) {
     queryCounter.updateFrom(other.queryCounter);
     commandCounter.updateFrom(other.commandCounter);
 
+    for (const auto& opLatencyCounter : other.opLatencyCounters) {
+        opLatencyCounters[opLatencyCounter.first].updateFrom(opLatencyCounter.second);
+    }
+
     for (const auto& trappedError : other.trappedErrors) {
         trappedErrors.push_back(trappedError);
     }
@@ -696,6 +725,16 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.isNumber());
             delayMillisOnFailedOperation = Milliseconds(arg.numberInt());
+        } else if (name == "opsPerSecond") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name << "' should be a positive number",
+                    arg.isNumber() && arg.number() > 0);
+            opsPerSecond = arg.number();
+        } else if (name == "warmupSeconds") {
+            uassert(ErrorCodes::BadValue,
+                    str::stream() << "Field '" << name << "' should be a non-negative number",
+                    arg.isNumber() && arg.number() >= 0);
+            warmupSeconds = arg.number();
         } else if (name == "hideResults") {
             hideResults = arg.trueValue();
         } else if (name == "handleErrors") {
@@ -880,6 +919,14 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
 
     BenchRunOp::State opState(&_rng, &bsonTemplateEvaluator, &_statsBlackHole);
 
+    // When running open-loop, this worker's share of the target rate starts an operation every
+    // 'scheduleIntervalMicros', measured from when the worker started.
+    const bool openLoop = _config->opsPerSecond > 0;
+    const double scheduleIntervalMicros =
+        openLoop ? 1000 * 1000 * _config->parallel / _config->opsPerSecond : 0;
+    long long numScheduled = 0;
+    Timer scheduleTimer;
+
     ON_BLOCK_EXIT([&] {
         // Executing the transaction with a new txnNumber would end the previous transaction
         // automatically, but we have to end the last transaction manually with an abort command.
@@ -893,10 +940,26 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
             if (shouldStop())
                 break;
 
+            long long scheduledStartMicros = scheduleTimer.micros();
+            if (openLoop) {
+                scheduledStartMicros =
+                    static_cast<long long>(numScheduled++ * scheduleIntervalMicros);
+                // Sleep in short steps so that a low target rate doesn't hold up stopping.
+                for (auto untilScheduled = scheduledStartMicros - scheduleTimer.micros();
+                     untilScheduled > 0 && !shouldStop();
+                     untilScheduled = scheduledStartMicros - scheduleTimer.micros()) {
+                    sleepmicros(std::min(untilScheduled, 100 * 1000LL));
+                }
+                if (shouldStop())
+                    break;
+            }
+
             opState.stats = shouldCollectStats() ? &_stats : &_statsBlackHole;
 
             try {
                 op.executeOnce(conn, lsid, *_config, &opState);
+                opState.stats->opLatencyCounters[op.op].countOne(scheduleTimer.micros() -
+                                                                 scheduledStartMicros);
             } catch (const DBException& ex) {
                 if (!_config->hideErrors || op.showError) {
                     bool yesWatch =
@@ -1385,6 +1448,10 @@ void BenchRunner::start() {
 
         _brState.waitForState(BenchRunState::BRS_RUNNING);
 
+        if (_config->warmupSeconds > 0) {
+            sleepmillis(static_cast<long long>(_config->warmupSeconds * 1000));
+        }
+
         // initial stats
         _brState.tellWorkersToCollectStats();
         _brTimer.emplace();
@@ -1492,6 +1559,19 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     buf.append("queries", stats.queryCounter.getNumEvents());
     buf.append("commands", stats.commandCounter.getNumEvents());
 
+    if (runner->config().opsPerSecond > 0) {
+        buf.append("targetOpsPerSecond", runner->config().opsPerSecond);
+    }
+
+    {
+        BSONObjBuilder latencyBuilder(buf.subobjStart("opLatencyMicros"));
+        for (const auto& opLatencyCounter : stats.opLatencyCounters) {
+            BSONObjBuilder opBuilder(
+                latencyBuilder.subobjStart(kOpTypeNames.find(opLatencyCounter.first)->second));
+            opLatencyCounter.second.appendLatencyStats(&opBuilder);
+        }
+    }
+
     BSONObj zoo = buf.obj();
 
     delete runner;
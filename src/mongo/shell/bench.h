@@ -29,7 +29,9 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <map>
 #include <string>
+#include <vector>
 
 #include "mongo/base/shim.h"
 #include "mongo/client/dbclient_base.h"
@@ -39,6 +41,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/log_linear_histogram.h"
 #include "mongo/util/timer.h"
 
 namespace pcrecpp {
@@ -221,6 +224,21 @@ public:
      */
     Milliseconds delayMillisOnFailedOperation{0};
 
+    /**
+     * When greater than zero, the workers run open-loop: each one starts operations on a fixed
+     * schedule that adds up to this many operations per second across all of them, whether or not
+     * earlier operations have completed. An operation's latency is then measured from when it was
+     * scheduled to start rather than from when it was sent, so that time spent queued behind a
+     * stalled operation is counted.
+     */
+    double opsPerSecond{0};
+
+    /**
+     * Seconds to generate load for without collecting statistics before the measured period
+     * starts. BenchRunner::start() blocks for this long.
+     */
+    double warmupSeconds{0};
+
     /// Base random seed for threads
     int64_t randomSeed;
 
@@ -257,6 +275,9 @@ private:
 /**
  * An event counter for events that have an associated duration.
  *
+ * Durations are also counted in a LogLinearHistogram, from which percentiles are estimated to
+ * within 1%. Its buckets are allocated by the first countOne() call.
+ *
  * Not thread safe. Expected use is one instance per thread during parallel execution.
  */
 class BenchRunEventCounter {
@@ -278,6 +299,7 @@ public:
         }
         ++_numEvents;
         _totalTimeMicros += timeMicros;
+        _recordInHistogram(timeMicros);
     }
 
     /**
@@ -294,9 +316,32 @@ public:
         return _numEvents;
     }
 
+    /**
+     * Get the longest duration of any observed event, in microseconds.
+     */
+    long long getMaxTimeMicros() const {
+        return _maxTimeMicros;
+    }
+
+    /**
+     * Get the smallest duration, in microseconds, such that at least 'percentile' percent of the
+     * observed events took no longer than it. Returns 0 if no events have been observed.
+     */
+    long long getPercentileMicros(double percentile) const;
+
+    /**
+     * Appends the number of events, the mean and maximum durations, and the 50th, 90th, 99th and
+     * 99.9th percentile durations in microseconds.
+     */
+    void appendLatencyStats(BSONObjBuilder* builder) const;
+
 private:
+    void _recordInHistogram(long long timeMicros);
+
     long long _totalTimeMicros{0};
     long long _numEvents{0};
+    long long _maxTimeMicros{0};
+    LogLinearHistogram _histogram{2};
 };
 
 /**
@@ -370,6 +415,10 @@ struct BenchRunStats {
     BenchRunEventCounter queryCounter;
     BenchRunEventCounter commandCounter;
 
+    // Time for each executeOnce() call by type of operation, measured from when the operation was
+    // scheduled to start when running open-loop.
+    std::map<OpType, BenchRunEventCounter> opLatencyCounters;
+
     std::map<std::string, long long> opcounters;
     std::vector<BSONObj> trappedErrors;
 };
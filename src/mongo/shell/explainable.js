@@ -18,9 +18,9 @@ var Explainable = (function() {
 
         // If we're here, then the verbosity is a string. We reject invalid strings.
         if (verbosity !== "queryPlanner" && verbosity !== "executionStats" &&
-            verbosity !== "allPlansExecution") {
+            verbosity !== "allPlansExecution" && verbosity !== "hardwareCounters") {
             throw Error("explain verbosity must be one of {" + "'queryPlanner'," +
-                        "'executionStats'," + "'allPlansExecution'}");
+                        "'executionStats'," + "'allPlansExecution'," + "'hardwareCounters'}");
         }
 
         return verbosity;
@@ -65,6 +65,18 @@ Status addMongoeBenchOptions(moe::OptionSection* options) {
     options->addOptionChaining("time", "time,s", moe::Double, "seconds to run benchRun for")
         .setDefault(moe::Value(1.0));
 
+    options->addOptionChaining("warmup",
+                               "warmup",
+                               moe::Double,
+                               "seconds to run benchRun for before collecting stats");
+
+    options->addOptionChaining(
+        "opsPerSecond",
+        "opsPerSecond",
+        moe::Double,
+        "start operations open-loop at this total rate, measuring latencies from their "
+        "scheduled start");
+
     options->addOptionChaining("output",
                                "output,o",
                                moe::String,
@@ -136,6 +148,22 @@ Status storeMongoeBenchOptions(const moe::Environment& params,
         if (params.count("time")) {
             mongoeBenchGlobalParams.opsConfig->seconds = params["time"].as<double>();
         }
+
+        if (params.count("warmup")) {
+            const auto warmupSeconds = params["warmup"].as<double>();
+            if (warmupSeconds < 0) {
+                return {ErrorCodes::BadValue, "--warmup must not be negative"};
+            }
+            mongoeBenchGlobalParams.opsConfig->warmupSeconds = warmupSeconds;
+        }
+
+        if (params.count("opsPerSecond")) {
+            const auto opsPerSecond = params["opsPerSecond"].as<double>();
+            if (opsPerSecond <= 0) {
+                return {ErrorCodes::BadValue, "--opsPerSecond must be positive"};
+            }
+            mongoeBenchGlobalParams.opsConfig->opsPerSecond = opsPerSecond;
+        }
     }
 
     if (params.count("output")) {
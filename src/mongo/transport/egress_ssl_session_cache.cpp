@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/egress_ssl_session_cache.h"
+
+#if defined(MONGO_CONFIG_SSL) && (MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL)
+
+#include <vector>
+
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace transport {
+
+void EgressSSLSessionCache::offerSession(SSL* ssl, const HostAndPort& target) {
+    SessionPtr session;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _sessions.find(target);
+        if (it == _sessions.end())
+            return;
+
+        session = copySession(it->second.get());
+        if (!session) {
+            _sessions.erase(it);
+            return;
+        }
+    }
+
+    // SSL_set_session takes its own reference to the session
+    if (::SSL_set_session(ssl, session.get()) != 1) {
+        dropSession(target);
+    }
+}
+
+void EgressSSLSessionCache::storeSession(SSL* ssl, const HostAndPort& target) {
+    if (::SSL_session_reused(ssl)) {
+        LOG(2) << "Resumed TLS session with " << target;
+    }
+
+    // Resuming a session may also renew its ticket, so keep the latest session either way
+    SessionPtr negotiated(::SSL_get1_session(ssl));
+    if (!negotiated)
+        return;
+
+    auto session = copySession(negotiated.get());
+    if (!session)
+        return;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _sessions[target] = std::move(session);
+}
+
+void EgressSSLSessionCache::dropSession(const HostAndPort& target) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _sessions.erase(target);
+}
+
+EgressSSLSessionCache::SessionPtr EgressSSLSessionCache::copySession(SSL_SESSION* session) {
+    const int length = ::i2d_SSL_SESSION(session, nullptr);
+    if (length <= 0)
+        return nullptr;
+
+    std::vector<unsigned char> buffer(length);
+    unsigned char* out = buffer.data();
+    ::i2d_SSL_SESSION(session, &out);
+
+    const unsigned char* in = buffer.data();
+    return SessionPtr(::d2i_SSL_SESSION(nullptr, &in, length));
+}
+
+}  // namespace transport
+}  // namespace mongo
+
+#endif
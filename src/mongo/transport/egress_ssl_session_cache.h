@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/config.h"
+
+#if defined(MONGO_CONFIG_SSL) && (MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL)
+
+#include <memory>
+
+#include <openssl/ssl.h>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/net/hostandport.h"
+
+namespace mongo {
+namespace transport {
+
+/**
+ * Remembers the last TLS session negotiated with each remote host, so that new egress connections
+ * to that host can offer it for resumption and skip the full handshake. Servers that don't
+ * recognize the session, or don't support resumption, fall back to a full handshake.
+ *
+ * This class is thread-safe.
+ */
+class EgressSSLSessionCache {
+    MONGO_DISALLOW_COPYING(EgressSSLSessionCache);
+
+public:
+    EgressSSLSessionCache() = default;
+
+    /**
+     * Offers the cached session for 'target', if there is one, on 'ssl'. Must be called before
+     * the handshake starts.
+     */
+    void offerSession(SSL* ssl, const HostAndPort& target);
+
+    /**
+     * Remembers the session negotiated on 'ssl' for future connections to 'target', replacing any
+     * session offered for the handshake. Must be called after a successful handshake.
+     */
+    void storeSession(SSL* ssl, const HostAndPort& target);
+
+    /**
+     * Forgets any session for 'target', e.g. after a failed handshake.
+     */
+    void dropSession(const HostAndPort& target);
+
+private:
+    struct SessionDeleter {
+        void operator()(SSL_SESSION* session) const {
+            ::SSL_SESSION_free(session);
+        }
+    };
+    using SessionPtr = std::unique_ptr<SSL_SESSION, SessionDeleter>;
+
+    /**
+     * Returns a copy of 'session' which no connection refers to. OpenSSL marks a session as not
+     * resumable when a connection using it is freed without a clean TLS shutdown, so the cache
+     * never hands out, nor keeps, a session object shared with a connection.
+     */
+    static SessionPtr copySession(SSL_SESSION* session);
+
+    stdx::mutex _mutex;
+    stdx::unordered_map<HostAndPort, SessionPtr> _sessions;
+};
+
+}  // namespace transport
+}  // namespace mongo
+
+#endif
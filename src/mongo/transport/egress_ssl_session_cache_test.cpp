@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/egress_ssl_session_cache.h"
+
+#if defined(MONGO_CONFIG_SSL) && (MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL)
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace transport {
+namespace {
+
+struct SSLContextDeleter {
+    void operator()(SSL_CTX* ctx) const {
+        ::SSL_CTX_free(ctx);
+    }
+};
+using UniqueSSLContext = std::unique_ptr<SSL_CTX, SSLContextDeleter>;
+
+struct SSLDeleter {
+    void operator()(SSL* ssl) const {
+        ::SSL_free(ssl);
+    }
+};
+using UniqueSSL = std::unique_ptr<SSL, SSLDeleter>;
+
+UniqueSSLContext makeContext(bool isServer) {
+    UniqueSSLContext ctx(::SSL_CTX_new(::SSLv23_method()));
+    ASSERT(ctx);
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000L
+    // The test certificates are signed with SHA-1, which newer OpenSSL versions reject by default.
+    ::SSL_CTX_set_security_level(ctx.get(), 0);
+#endif
+
+    if (isServer) {
+        const char* pemFile = "jstests/libs/server.pem";
+        ASSERT_EQ(1, ::SSL_CTX_use_certificate_chain_file(ctx.get(), pemFile));
+        ASSERT_EQ(1, ::SSL_CTX_use_PrivateKey_file(ctx.get(), pemFile, SSL_FILETYPE_PEM));
+
+        const unsigned char sessionIdContext[] = "egress_ssl_session_cache_test";
+        ASSERT_EQ(1,
+                  ::SSL_CTX_set_session_id_context(
+                      ctx.get(), sessionIdContext, sizeof(sessionIdContext) - 1));
+    } else {
+#ifdef TLS1_3_VERSION
+        // TLS 1.3 sends its session tickets after the handshake, which these tests don't read
+        ::SSL_CTX_set_max_proto_version(ctx.get(), TLS1_2_VERSION);
+#endif
+    }
+
+    return ctx;
+}
+
+class EgressSSLSessionCacheTest : public unittest::Test {
+protected:
+    /**
+     * Runs a TLS handshake between a new client connection to 'target' and the test server in
+     * memory, going through 'cache' the way egress sessions do. Returns whether the client resumed
+     * a session. The connections are freed without a TLS shutdown, like a dropped connection.
+     */
+    bool handshake(const HostAndPort& target) {
+        UniqueSSL client(::SSL_new(_clientContext.get()));
+        UniqueSSL server(::SSL_new(_serverContext.get()));
+
+        BIO* clientBio;
+        BIO* serverBio;
+        ASSERT_EQ(1, ::BIO_new_bio_pair(&clientBio, 0, &serverBio, 0));
+        ::SSL_set_bio(client.get(), clientBio, clientBio);
+        ::SSL_set_bio(server.get(), serverBio, serverBio);
+        ::SSL_set_connect_state(client.get());
+        ::SSL_set_accept_state(server.get());
+
+        _cache.offerSession(client.get(), target);
+
+        for (int i = 0; i < 10; ++i) {
+            if (::SSL_is_init_finished(client.get()) && ::SSL_is_init_finished(server.get()))
+                break;
+            ::SSL_do_handshake(client.get());
+            ::SSL_do_handshake(server.get());
+        }
+        ASSERT(::SSL_is_init_finished(client.get()));
+        ASSERT(::SSL_is_init_finished(server.get()));
+
+        _cache.storeSession(client.get(), target);
+        return ::SSL_session_reused(client.get());
+    }
+
+    EgressSSLSessionCache _cache;
+
+private:
+    UniqueSSLContext _clientContext = makeContext(false);
+    UniqueSSLContext _serverContext = makeContext(true);
+};
+
+TEST_F(EgressSSLSessionCacheTest, ResumesSessionWithSameHost) {
+    const HostAndPort host("host1", 27017);
+
+    ASSERT_FALSE(handshake(host));
+    ASSERT_TRUE(handshake(host));
+
+    // The session is still resumable after the connection which resumed it went away
+    ASSERT_TRUE(handshake(host));
+}
+
+TEST_F(EgressSSLSessionCacheTest, SessionsAreKeptPerHost) {
+    const HostAndPort host1("host1", 27017);
+    const HostAndPort host2("host2", 27017);
+
+    ASSERT_FALSE(handshake(host1));
+    ASSERT_FALSE(handshake(host2));
+    ASSERT_TRUE(handshake(host1));
+    ASSERT_TRUE(handshake(host2));
+}
+
+TEST_F(EgressSSLSessionCacheTest, DroppedSessionIsNotOffered) {
+    const HostAndPort host("host1", 27017);
+
+    ASSERT_FALSE(handshake(host));
+    _cache.dropSession(host);
+    ASSERT_FALSE(handshake(host));
+    ASSERT_TRUE(handshake(host));
+}
+
+}  // namespace
+}  // namespace transport
+}  // namespace mongo
+
+#endif
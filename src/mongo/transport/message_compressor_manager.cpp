@@ -40,6 +40,7 @@
 #include "mongo/transport/message_compressor_registry.h"
 #include "mongo/transport/session.h"
 #include "mongo/util/log.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -129,7 +130,9 @@ StatusWith<Message> MessageCompressorManager::compressMessage(
     compressionHeader.serialize(&output);
     ConstDataRange input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
 
+    Timer compressTimer;
     auto sws = compressor->compressData(input, output);
+    compressor->counterHitCompressTime(Microseconds{compressTimer.micros()});
 
     if (!sws.isOK())
         return sws.getStatus();
@@ -176,7 +179,9 @@ StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& m
 
     DataRangeCursor output(outMessage.data(), outMessage.data() + outMessage.dataLen());
 
+    Timer decompressTimer;
     auto sws = compressor->decompressData(input, output);
+    compressor->counterHitDecompressTime(Microseconds{decompressTimer.micros()});
 
     if (!sws.isOK())
         return sws.getStatus();
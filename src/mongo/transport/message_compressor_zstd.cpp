@@ -0,0 +1,262 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#include "mongo/base/init.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+#include <zstd.h>
+
+namespace mongo {
+namespace {
+
+class ZstdCompressionLevelParameter
+    : public ExportedServerParameter<int, ServerParameterType::kStartupOnly> {
+public:
+    ZstdCompressionLevelParameter(StringData name, int* value)
+        : ExportedServerParameter<int, ServerParameterType::kStartupOnly>(
+              ServerParameterSet::getGlobal(), name.toString(), value) {}
+
+    Status validate(const int& newValue) override {
+        if (newValue < 1 || newValue > ZSTD_maxCLevel()) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "zstdCompressionLevel must be between 1 and "
+                                  << ZSTD_maxCLevel()
+                                  << ", but "
+                                  << newValue
+                                  << " was given"};
+        }
+        return Status::OK();
+    }
+};
+
+int zstdCompressionLevel = ZstdMessageCompressor::kDefaultCompressionLevel;
+ZstdCompressionLevelParameter zstdCompressionLevelParam("zstdCompressionLevel",
+                                                        &zstdCompressionLevel);
+
+std::string zstdCompressionDictionaryFile;
+ExportedServerParameter<std::string, ServerParameterType::kStartupOnly>
+    zstdCompressionDictionaryFileParam(ServerParameterSet::getGlobal(),
+                                       "zstdCompressionDictionaryFile",
+                                       &zstdCompressionDictionaryFile);
+
+// zstd contexts are expensive to create and are not thread safe, so each thread that compresses
+// or decompresses messages keeps its own.
+struct CCtxDeleter {
+    void operator()(ZSTD_CCtx* ctx) const {
+        ZSTD_freeCCtx(ctx);
+    }
+};
+
+struct DCtxDeleter {
+    void operator()(ZSTD_DCtx* ctx) const {
+        ZSTD_freeDCtx(ctx);
+    }
+};
+
+ZSTD_CCtx* getCompressionContext() {
+    static thread_local std::unique_ptr<ZSTD_CCtx, CCtxDeleter> ctx(ZSTD_createCCtx());
+    return ctx.get();
+}
+
+ZSTD_DCtx* getDecompressionContext() {
+    static thread_local std::unique_ptr<ZSTD_DCtx, DCtxDeleter> ctx(ZSTD_createDCtx());
+    return ctx.get();
+}
+
+StatusWith<std::string> readDictionaryFile(const std::string& fileName) {
+    std::ifstream dictionaryFile(fileName, std::ios::binary);
+    if (!dictionaryFile.is_open()) {
+        return {ErrorCodes::FileOpenFailed,
+                str::stream() << "Failed to open zstd dictionary file: " << fileName};
+    }
+
+    std::string buf((std::istreambuf_iterator<char>(dictionaryFile)),
+                    std::istreambuf_iterator<char>());
+    if (dictionaryFile.bad() || buf.empty()) {
+        return {ErrorCodes::FileStreamFailed,
+                str::stream() << "Failed to read zstd dictionary file: " << fileName};
+    }
+    return {std::move(buf)};
+}
+
+}  // namespace
+
+void ZstdMessageCompressor::CDictDeleter::operator()(ZSTD_CDict* dict) const {
+    ZSTD_freeCDict(dict);
+}
+
+void ZstdMessageCompressor::DDictDeleter::operator()(ZSTD_DDict* dict) const {
+    ZSTD_freeDDict(dict);
+}
+
+ZstdMessageCompressor::ZstdMessageCompressor(int compressionLevel)
+    : MessageCompressorBase(MessageCompressor::kZstd), _compressionLevel(compressionLevel) {}
+
+ZstdMessageCompressor::~ZstdMessageCompressor() = default;
+
+StatusWith<std::unique_ptr<ZstdMessageCompressor>> ZstdMessageCompressor::makeWithDictionary(
+    int compressionLevel, StringData dictionary) {
+    auto compressor = stdx::make_unique<ZstdMessageCompressor>(compressionLevel);
+
+    compressor->_compressionDictionary.reset(
+        ZSTD_createCDict(dictionary.rawData(), dictionary.size(), compressionLevel));
+    compressor->_decompressionDictionary.reset(
+        ZSTD_createDDict(dictionary.rawData(), dictionary.size()));
+    if (!compressor->_compressionDictionary || !compressor->_decompressionDictionary) {
+        return {ErrorCodes::BadValue, "Could not load zstd dictionary"};
+    }
+    compressor->_dictionaryId = ZSTD_getDictID_fromDict(dictionary.rawData(), dictionary.size());
+
+    return {std::move(compressor)};
+}
+
+std::size_t ZstdMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    return ZSTD_compressBound(inputSize);
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::compressData(ConstDataRange input,
+                                                            DataRange output) {
+    if (output.length() < getMaxCompressedSize(input.length())) {
+        return {ErrorCodes::BadValue, "Output too small for max size of compressed input"};
+    }
+
+    auto ctx = getCompressionContext();
+    if (!ctx) {
+        return {ErrorCodes::ExceededMemoryLimit, "Could not allocate zstd compression context"};
+    }
+
+    auto outPtr = const_cast<char*>(output.data());
+    size_t ret = _compressionDictionary
+        ? ZSTD_compress_usingCDict(ctx,
+                                   outPtr,
+                                   output.length(),
+                                   input.data(),
+                                   input.length(),
+                                   _compressionDictionary.get())
+        : ZSTD_compressCCtx(
+              ctx, outPtr, output.length(), input.data(), input.length(), _compressionLevel);
+
+    if (ZSTD_isError(ret)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Could not compress input: " << ZSTD_getErrorName(ret)};
+    }
+
+    counterHitCompress(input.length(), ret);
+    return {ret};
+}
+
+StatusWith<std::size_t> ZstdMessageCompressor::decompressData(ConstDataRange input,
+                                                              DataRange output) {
+    // A frame compressed without a dictionary decodes the same with one loaded, but a frame that
+    // names a dictionary can only be decoded with that exact dictionary.
+    auto frameDictionaryId = ZSTD_getDictID_fromFrame(input.data(), input.length());
+    if (frameDictionaryId != 0 &&
+        (!_decompressionDictionary || frameDictionaryId != _dictionaryId)) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Compressed message requires zstd dictionary "
+                              << frameDictionaryId
+                              << ", which is not loaded"};
+    }
+
+    auto ctx = getDecompressionContext();
+    if (!ctx) {
+        return {ErrorCodes::ExceededMemoryLimit, "Could not allocate zstd decompression context"};
+    }
+
+    auto outPtr = const_cast<char*>(output.data());
+    size_t ret = _decompressionDictionary
+        ? ZSTD_decompress_usingDDict(ctx,
+                                     outPtr,
+                                     output.length(),
+                                     input.data(),
+                                     input.length(),
+                                     _decompressionDictionary.get())
+        : ZSTD_decompressDCtx(ctx, outPtr, output.length(), input.data(), input.length());
+
+    if (ZSTD_isError(ret)) {
+        return {ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    counterHitDecompress(input.length(), ret);
+    return {ret};
+}
+
+
+MONGO_INITIALIZER_GENERAL(ZstdMessageCompressorInit,
+                          ("EndStartupOptionHandling"),
+                          ("AllCompressorsRegistered"))
+(InitializerContext* context) {
+    auto& compressorRegistry = MessageCompressorRegistry::get();
+
+    // Don't read the dictionary unless zstd is actually going to be used.
+    const auto& names = compressorRegistry.getCompressorNames();
+    const auto name = getMessageCompressorName(MessageCompressor::kZstd).toString();
+    if (std::find(names.begin(), names.end(), name) == names.end()) {
+        return Status::OK();
+    }
+
+    if (zstdCompressionDictionaryFile.empty()) {
+        compressorRegistry.registerImplementation(
+            stdx::make_unique<ZstdMessageCompressor>(zstdCompressionLevel));
+        return Status::OK();
+    }
+
+    auto swDictionary = readDictionaryFile(zstdCompressionDictionaryFile);
+    if (!swDictionary.isOK()) {
+        return swDictionary.getStatus();
+    }
+
+    auto swCompressor =
+        ZstdMessageCompressor::makeWithDictionary(zstdCompressionLevel, swDictionary.getValue());
+    if (!swCompressor.isOK()) {
+        return swCompressor.getStatus().withContext(str::stream()
+                                                    << "Loading zstd dictionary from "
+                                                    << zstdCompressionDictionaryFile);
+    }
+
+    log() << "Loaded zstd network compression dictionary " << zstdCompressionDictionaryFile
+          << " (id " << swCompressor.getValue()->getDictionaryId() << ")";
+    compressorRegistry.registerImplementation(std::move(swCompressor.getValue()));
+    return Status::OK();
+}
+}  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/transport/message_compressor_base.h"
+
+#include <memory>
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+namespace mongo {
+
+/**
+ * Compresses network messages with zstd.
+ *
+ * An optional dictionary, either raw content or one trained with `zstd --train` on sample
+ * messages, is primed into every frame this compressor produces. This mostly helps small
+ * messages, which have too little history of their own to compress well. Both ends of a
+ * connection must load the same dictionary; frames that name a dictionary other than the one
+ * loaded here are rejected.
+ */
+class ZstdMessageCompressor final : public MessageCompressorBase {
+public:
+    static constexpr int kDefaultCompressionLevel = 3;
+
+    explicit ZstdMessageCompressor(int compressionLevel = kDefaultCompressionLevel);
+    ~ZstdMessageCompressor();
+
+    /**
+     * Returns a compressor that uses 'dictionary' for both compression and decompression, or an
+     * error if zstd cannot load it.
+     */
+    static StatusWith<std::unique_ptr<ZstdMessageCompressor>> makeWithDictionary(
+        int compressionLevel, StringData dictionary);
+
+    std::size_t getMaxCompressedSize(size_t inputSize) override;
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override;
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override;
+
+    /**
+     * Returns the id of the loaded dictionary; 0 if none is loaded or it is a raw content
+     * dictionary.
+     */
+    unsigned getDictionaryId() const {
+        return _dictionaryId;
+    }
+
+private:
+    struct CDictDeleter {
+        void operator()(ZSTD_CDict_s* dict) const;
+    };
+
+    struct DDictDeleter {
+        void operator()(ZSTD_DDict_s* dict) const;
+    };
+
+    const int _compressionLevel;
+
+    std::unique_ptr<ZSTD_CDict_s, CDictDeleter> _compressionDictionary;
+    std::unique_ptr<ZSTD_DDict_s, DDictDeleter> _decompressionDictionary;
+    unsigned _dictionaryId = 0;
+};
+
+}  // namespace mongo
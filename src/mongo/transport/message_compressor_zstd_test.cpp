@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zstd.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+// A small OP_MSG-like payload that repeats field names the dictionary also contains.
+const std::string kSmallPayload =
+    "{ insert: \"orders\", ordered: true, $db: \"shop\", documents: [ { _id: 1, sku: \"A-1\" } ] }";
+
+const std::string kDictionary =
+    "{ insert: \"orders\", ordered: true, $db: \"shop\", documents: [ { _id: , sku: \"\" } ] }"
+    "{ find: \"orders\", filter: { sku: \"\" }, $db: \"shop\", lsid: { id: UUID(\"\") } }";
+
+std::vector<char> compress(ZstdMessageCompressor* compressor, const std::string& input) {
+    std::vector<char> output(compressor->getMaxCompressedSize(input.size()));
+    auto sw = compressor->compressData(ConstDataRange(input.data(), input.size()),
+                                       DataRange(output.data(), output.size()));
+    ASSERT_OK(sw.getStatus());
+    output.resize(sw.getValue());
+    return output;
+}
+
+StatusWith<std::string> decompress(ZstdMessageCompressor* compressor,
+                                   const std::vector<char>& input,
+                                   size_t uncompressedSize) {
+    std::string output(uncompressedSize, '\0');
+    auto sw = compressor->decompressData(ConstDataRange(input.data(), input.size()),
+                                         DataRange(&output[0], output.size()));
+    if (!sw.isOK()) {
+        return sw.getStatus();
+    }
+    ASSERT_EQ(sw.getValue(), uncompressedSize);
+    return {std::move(output)};
+}
+
+TEST(ZstdMessageCompressor, Fidelity) {
+    ZstdMessageCompressor compressor;
+    std::string input;
+    for (int i = 0; i < 1000; ++i) {
+        input += kSmallPayload;
+    }
+
+    auto compressed = compress(&compressor, input);
+    ASSERT_LT(compressed.size(), input.size());
+    ASSERT_EQ(unittest::assertGet(decompress(&compressor, compressed, input.size())), input);
+
+    ASSERT_EQ(compressor.getCompressorBytesIn(), static_cast<int64_t>(input.size()));
+    ASSERT_EQ(compressor.getCompressorBytesOut(), static_cast<int64_t>(compressed.size()));
+    ASSERT_EQ(compressor.getDecompressorBytesIn(), static_cast<int64_t>(compressed.size()));
+    ASSERT_EQ(compressor.getDecompressorBytesOut(), static_cast<int64_t>(input.size()));
+}
+
+TEST(ZstdMessageCompressor, Overflow) {
+    ZstdMessageCompressor compressor;
+    std::vector<char> output(compressor.getMaxCompressedSize(kSmallPayload.size()) - 1);
+    auto sw = compressor.compressData(ConstDataRange(kSmallPayload.data(), kSmallPayload.size()),
+                                      DataRange(output.data(), output.size()));
+    ASSERT_NOT_OK(sw.getStatus());
+}
+
+TEST(ZstdMessageCompressor, CorruptInputIsRejected) {
+    ZstdMessageCompressor compressor;
+    auto compressed = compress(&compressor, kSmallPayload);
+    compressed.resize(compressed.size() / 2);
+    ASSERT_NOT_OK(decompress(&compressor, compressed, kSmallPayload.size()).getStatus());
+}
+
+TEST(ZstdMessageCompressor, DictionaryShrinksSmallMessages) {
+    ZstdMessageCompressor plain;
+    auto withDictionary = unittest::assertGet(ZstdMessageCompressor::makeWithDictionary(
+        ZstdMessageCompressor::kDefaultCompressionLevel, kDictionary));
+
+    auto plainCompressed = compress(&plain, kSmallPayload);
+    auto dictCompressed = compress(withDictionary.get(), kSmallPayload);
+    ASSERT_LT(dictCompressed.size(), plainCompressed.size());
+
+    ASSERT_EQ(unittest::assertGet(
+                  decompress(withDictionary.get(), dictCompressed, kSmallPayload.size())),
+              kSmallPayload);
+
+    // Peers that share the dictionary still understand messages compressed without one.
+    ASSERT_EQ(unittest::assertGet(
+                  decompress(withDictionary.get(), plainCompressed, kSmallPayload.size())),
+              kSmallPayload);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -42,6 +42,7 @@
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/duration.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa_placement.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/stringutils.h"
@@ -93,6 +94,13 @@ constexpr auto kStuckDetection = "stuckThreadsDetected"_sd;
 constexpr auto kStarvation = "starvation"_sd;
 constexpr auto kReserveMinimum = "belowReserveMinimum"_sd;
 constexpr auto kThreadReasons = "threadCreationCauses"_sd;
+constexpr auto kTotalQueuedLocally = "totalQueuedLocally"_sd;
+constexpr auto kTotalStolen = "totalStolen"_sd;
+constexpr auto kLocalQueueDepth = "localQueueDepth"_sd;
+
+// The most tasks a worker runs from its local queue before going back to the reactor. Whatever is
+// left is run later by the owner or stolen by another worker.
+constexpr int kMaxLocalQueueBatch = 16;
 
 int64_t ticksToMicros(TickSource::Tick ticks, TickSource* tickSource) {
     invariant(tickSource->getTicksPerSecond() >= 1000000);
@@ -212,35 +220,43 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
 
     auto wrappedTask =
         [ this, task = std::move(task), scheduleTime, pendingCounterPtr, taskName, flags ] {
-        pendingCounterPtr->subtractAndFetch(1);
-        auto start = _tickSource->getTicks();
-        _totalSpentQueued.addAndFetch(start - scheduleTime);
+        {
+            pendingCounterPtr->subtractAndFetch(1);
+            auto start = _tickSource->getTicks();
+            _totalSpentQueued.addAndFetch(start - scheduleTime);
 
-        _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
-            ._totalSpentQueued.addAndFetch(start - scheduleTime);
+            _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
+                ._totalSpentQueued.addAndFetch(start - scheduleTime);
 
-        if (_localThreadState->recursionDepth++ == 0) {
-            _localThreadState->executing.markRunning();
-            _threadsInUse.addAndFetch(1);
-        }
-        const auto guard = MakeGuard([this, taskName] {
-            if (--_localThreadState->recursionDepth == 0) {
-                _localThreadState->executingCurRun += _localThreadState->executing.markStopped();
-                _threadsInUse.subtractAndFetch(1);
+            if (_localThreadState->recursionDepth++ == 0) {
+                _localThreadState->executing.markRunning();
+                _threadsInUse.addAndFetch(1);
             }
-            _totalExecuted.addAndFetch(1);
+            const auto guard = MakeGuard([this, taskName] {
+                if (--_localThreadState->recursionDepth == 0) {
+                    _localThreadState->executingCurRun +=
+                        _localThreadState->executing.markStopped();
+                    _threadsInUse.subtractAndFetch(1);
+                }
+                _totalExecuted.addAndFetch(1);
+                _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
+                    ._totalExecuted.addAndFetch(1);
+            });
+
+            TickTimer _localTimer(_tickSource);
+            task();
             _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
-                ._totalExecuted.addAndFetch(1);
-        });
+                ._totalSpentExecuting.addAndFetch(_localTimer.sinceStartTicks());
 
-        TickTimer _localTimer(_tickSource);
-        task();
-        _localThreadState->threadMetrics[static_cast<size_t>(taskName)]
-            ._totalSpentExecuting.addAndFetch(_localTimer.sinceStartTicks());
+            if ((flags & ServiceExecutor::kMayYieldBeforeSchedule) &&
+                (_localThreadState->markIdleCounter++ & 0xf)) {
+                markThreadIdle();
+            }
+        }
 
-        if ((flags & ServiceExecutor::kMayYieldBeforeSchedule) &&
-            (_localThreadState->markIdleCounter++ & 0xf)) {
-            markThreadIdle();
+        // Once the outermost task is done, run the tasks it scheduled for this thread.
+        if (_localThreadState->recursionDepth == 0) {
+            _drainLocalQueue();
         }
     };
 
@@ -251,9 +267,14 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
     //
     // If the task is allowed to recurse and we are not over the depth limit, dispatch it so it
     // can be called immediately and recursively.
+    //
+    // Otherwise, a task scheduled from a worker thread goes on that thread's local queue, unless
+    // it is deferred and so should not keep the thread from the reactor.
     if ((flags & kMayRecurse) &&
         (_localThreadState->recursionDepth + 1 < _config->recursionLimit())) {
         _reactorHandle->schedule(Reactor::kDispatch, std::move(wrappedTask));
+    } else if (_localThreadState && !(flags & kDeferredTask)) {
+        _scheduleLocal(std::move(wrappedTask));
     } else {
         _reactorHandle->schedule(Reactor::kPost, std::move(wrappedTask));
     }
@@ -274,6 +295,82 @@ Status ServiceExecutorAdaptive::schedule(ServiceExecutorAdaptive::Task task,
     return Status::OK();
 }
 
+void ServiceExecutorAdaptive::_scheduleLocal(Task task) {
+    const auto& queue = _localThreadState->localQueue;
+    bool postSteal = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(queue->mutex);
+        queue->tasks.push_back(std::move(task));
+        if (!queue->stealPosted) {
+            queue->stealPosted = postSteal = true;
+        }
+    }
+    _totalQueuedLocally.addAndFetch(1);
+
+    if (postSteal) {
+        _postSteal(queue);
+    }
+}
+
+void ServiceExecutorAdaptive::_postSteal(std::shared_ptr<LocalQueue> queue) {
+    _reactorHandle->schedule(Reactor::kPost,
+                             [ this, queue = std::move(queue) ] { _runStolenTask(queue); });
+}
+
+void ServiceExecutorAdaptive::_runStolenTask(const std::shared_ptr<LocalQueue>& queue) {
+    Task task;
+    bool repost = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(queue->mutex);
+        queue->stealPosted = false;
+        if (queue->tasks.empty()) {
+            // The owner already ran everything.
+            return;
+        }
+
+        task = std::move(queue->tasks.front());
+        queue->tasks.pop_front();
+        if (!queue->tasks.empty()) {
+            queue->stealPosted = repost = true;
+        }
+    }
+
+    if (repost) {
+        _postSteal(queue);
+    }
+
+    if (queue != _localThreadState->localQueue) {
+        _totalStolen.addAndFetch(1);
+    }
+    task();
+}
+
+void ServiceExecutorAdaptive::_drainLocalQueue() {
+    auto state = _localThreadState;
+    if (state->drainingLocalQueue) {
+        // The tasks run below come back here when they finish.
+        return;
+    }
+
+    state->drainingLocalQueue = true;
+    const auto guard = MakeGuard([state] { state->drainingLocalQueue = false; });
+
+    auto& queue = *state->localQueue;
+    for (int i = 0; i < kMaxLocalQueueBatch; i++) {
+        Task task;
+        {
+            stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+            if (queue.tasks.empty()) {
+                return;
+            }
+
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+        task();
+    }
+}
+
 bool ServiceExecutorAdaptive::_isStarved() const {
     // If threads are still starting, then assume we won't be starved pretty soon, return false
     if (_threadsPending.load() > 0)
@@ -348,8 +445,9 @@ void ServiceExecutorAdaptive::_controllerThreadRoutine() {
             int checkRequests = 0;
             maybeStarved = _scheduleCondition.wait_for(
                 scheduleLk, timeout.toSystemDuration(), [this, &checkRequests] {
+                    // Wake up right away on shutdown rather than when the timeout expires.
                     if (!_isRunning.load())
-                        return false;
+                        return true;
                     checkRequests = _starvationCheckRequests.load();
                     return (checkRequests > 0);
                 });
@@ -559,6 +657,8 @@ void ServiceExecutorAdaptive::_workerThreadRoutine(
         setThreadName(threadName);
     }
 
+    NumaPlacement::get().placeCurrentThread(NumaPlacement::ThreadRole::kServiceWorker);
+
     log() << "Started new database worker thread " << threadId;
 
     bool guardThreadsRunning = true;
@@ -674,7 +774,16 @@ void ServiceExecutorAdaptive::appendStats(BSONObjBuilder* bob) const {
          << ticksToMicros(_getThreadTimerTotal(ThreadTimer::kExecuting, lk), _tickSource)  //
          << kTotalTimeQueuedUs << ticksToMicros(_totalSpentQueued.load(), _tickSource)     //
          << kThreadsRunning << _threadsRunning.load()                                      //
-         << kThreadsPending << _threadsPending.load();
+         << kThreadsPending << _threadsPending.load()                                      //
+         << kTotalQueuedLocally << _totalQueuedLocally.load()                              //
+         << kTotalStolen << _totalStolen.load();
+
+    long long localQueueDepth = 0;
+    for (auto& thread : _threads) {
+        stdx::lock_guard<stdx::mutex> queueLk(thread.localQueue->mutex);
+        localQueueDepth += thread.localQueue->tasks.size();
+    }
+    *bob << kLocalQueueDepth << localQueueDepth;
 
     BSONObjBuilder threadStartReasons(bob->subobjStart(kThreadReasons));
     for (size_t i = 0; i < _threadStartCounters.size(); i++) {
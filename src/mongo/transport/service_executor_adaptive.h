@@ -29,6 +29,8 @@
 #pragma once
 
 #include <array>
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include "mongo/db/service_context.h"
@@ -48,6 +50,11 @@ namespace transport {
  * This is an ASIO-based adaptive ServiceExecutor. It guarantees that threads will not become stuck
  * or deadlocked longer that its configured timeout and that idle threads will terminate themselves
  * if they spend more than its configure idle threshold idle.
+ *
+ * Tasks that a worker thread schedules without recursing are put on that worker's local queue, and
+ * the worker runs them once its current task is done, so that a session's tasks tend to stay on
+ * the same thread. For as long as a local queue is not empty, a single steal request for it is
+ * posted on the reactor, so that any other worker can take over its tasks when the owner is busy.
  */
 class ServiceExecutorAdaptive : public ServiceExecutor {
 public:
@@ -179,8 +186,19 @@ private:
     enum class ThreadCreationReason { kStuckDetection, kStarvation, kReserveMinimum, kMax };
     enum class ThreadTimer { kRunning, kExecuting };
 
+    /**
+     * The tasks a worker thread scheduled for itself. Shared with the steal requests posted for it,
+     * which may outlive the worker.
+     */
+    struct LocalQueue {
+        stdx::mutex mutex;  // protects tasks and stealPosted
+        std::deque<Task> tasks;
+        bool stealPosted = false;
+    };
+
     struct ThreadState {
-        ThreadState(TickSource* ts) : running(ts), executing(ts) {}
+        ThreadState(TickSource* ts)
+            : running(ts), executing(ts), localQueue(std::make_shared<LocalQueue>()) {}
 
         CumulativeTickTimer running;
         TickSource::Tick executingCurRun;
@@ -188,6 +206,8 @@ private:
         MetricsArray threadMetrics;
         std::int64_t markIdleCounter = 0;
         int recursionDepth = 0;
+        const std::shared_ptr<LocalQueue> localQueue;
+        bool drainingLocalQueue = false;
     };
 
     using ThreadList = stdx::list<ThreadState>;
@@ -199,6 +219,11 @@ private:
     bool _isStarved() const;
     Milliseconds _getThreadJitter() const;
 
+    void _scheduleLocal(Task task);
+    void _postSteal(std::shared_ptr<LocalQueue> queue);
+    void _runStolenTask(const std::shared_ptr<LocalQueue>& queue);
+    void _drainLocalQueue();
+
     void _accumulateTaskMetrics(MetricsArray* outArray, const MetricsArray& inputArray) const;
     void _accumulateAllTaskMetrics(MetricsArray* outputMetricsArray,
                                    const stdx::unique_lock<stdx::mutex>& lk) const;
@@ -233,6 +258,8 @@ private:
     AtomicWord<int64_t> _totalQueued{0};
     AtomicWord<int64_t> _totalExecuted{0};
     AtomicWord<TickSource::Tick> _totalSpentQueued{0};
+    AtomicWord<int64_t> _totalQueuedLocally{0};
+    AtomicWord<int64_t> _totalStolen{0};
 
     // Threads signal this condition variable when they exit so we can gracefully shutdown
     // the executor.
@@ -82,6 +82,46 @@ struct TestOptions : public ServiceExecutorAdaptive::Options {
     }
 };
 
+/**
+ * Options under which the controller thread never starts workers of its own during a test, so that
+ * exactly 'threads' workers run and the tests know which of them can take a task.
+ */
+struct WorkStealingTestOptions : public ServiceExecutorAdaptive::Options {
+    explicit WorkStealingTestOptions(int threads) : _threads(threads) {}
+
+    int reservedThreads() const final {
+        return _threads;
+    }
+
+    Milliseconds workerThreadRunTime() const final {
+        return kWorkerThreadRunTime;
+    }
+
+    int runTimeJitter() const final {
+        return 0;
+    }
+
+    Milliseconds stuckThreadTimeout() const final {
+        return Milliseconds{60 * 1000};
+    }
+
+    Microseconds maxQueueLatency() const final {
+        return duration_cast<Microseconds>(Milliseconds{5});
+    }
+
+    // No utilization reaches this, so starvation never starts a thread.
+    int idlePctThreshold() const final {
+        return 101;
+    }
+
+    int recursionLimit() const final {
+        return 0;
+    }
+
+private:
+    const int _threads;
+};
+
 /* This implements the portions of the transport::Reactor based on ASIO, but leaves out
  * the methods not needed by ServiceExecutors.
  *
@@ -163,6 +203,33 @@ protected:
     std::shared_ptr<asio::io_context> asioIOCtx;
 };
 
+class ServiceExecutorAdaptiveWorkStealingFixture : public unittest::Test {
+protected:
+    void setUp() override {
+        setGlobalServiceContext(ServiceContext::make());
+    }
+
+    void startExecutor(int threads) {
+        executor = stdx::make_unique<ServiceExecutorAdaptive>(
+            getGlobalServiceContext(),
+            std::make_shared<ASIOReactor>(),
+            stdx::make_unique<WorkStealingTestOptions>(threads));
+        ASSERT_OK(executor->start());
+    }
+
+    void tearDown() override {
+        ASSERT_OK(executor->shutdown(kShutdownTime));
+    }
+
+    BSONObj getStats() {
+        BSONObjBuilder bob;
+        executor->appendStats(&bob);
+        return bob.obj();
+    }
+
+    std::unique_ptr<ServiceExecutorAdaptive> executor;
+};
+
 class ServiceExecutorSynchronousFixture : public unittest::Test {
 protected:
     void setUp() override {
@@ -205,6 +272,87 @@ TEST_F(ServiceExecutorAdaptiveFixture, ScheduleFailsBeforeStartup) {
     scheduleBasicTask(executor.get(), false);
 }
 
+TEST_F(ServiceExecutorAdaptiveWorkStealingFixture, LocalTaskRunsAfterCurrentTask) {
+    // With a single worker, nothing can steal the task from the local queue.
+    startExecutor(1);
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    bool done = false;
+    bool outerFinished = false;
+    bool innerRanAfterOuter = false;
+    stdx::thread::id outerThread, innerThread;
+
+    auto inner = [&] {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        innerThread = stdx::this_thread::get_id();
+        innerRanAfterOuter = outerFinished;
+        done = true;
+        cond.notify_all();
+    };
+
+    auto outer = [&] {
+        ASSERT_OK(executor->schedule(
+            inner, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMProcessMessage));
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        outerThread = stdx::this_thread::get_id();
+        outerFinished = true;
+    };
+
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    ASSERT_OK(executor->schedule(
+        outer, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMProcessMessage));
+    cond.wait(lk, [&] { return done; });
+
+    ASSERT_TRUE(innerRanAfterOuter);
+    ASSERT_EQ(outerThread, innerThread);
+
+    auto stats = getStats();
+    ASSERT_EQ(stats["totalQueuedLocally"].numberLong(), 1);
+    ASSERT_EQ(stats["totalStolen"].numberLong(), 0);
+    ASSERT_EQ(stats["localQueueDepth"].numberLong(), 0);
+}
+
+TEST_F(ServiceExecutorAdaptiveWorkStealingFixture, IdleWorkerStealsFromBusyWorker) {
+    startExecutor(2);
+
+    stdx::mutex mutex;
+    stdx::condition_variable cond;
+    bool innerDone = false;
+    stdx::thread::id outerThread, innerThread;
+
+    auto inner = [&] {
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        innerThread = stdx::this_thread::get_id();
+        innerDone = true;
+        cond.notify_all();
+    };
+
+    // The outer task doesn't return until the task it queued locally has run, so only the other
+    // worker can run it.
+    auto outer = [&] {
+        ASSERT_OK(executor->schedule(
+            inner, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMProcessMessage));
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        outerThread = stdx::this_thread::get_id();
+        cond.wait(lk, [&] { return innerDone; });
+    };
+
+    ASSERT_OK(executor->schedule(
+        outer, ServiceExecutor::kEmptyFlags, ServiceExecutorTaskName::kSSMProcessMessage));
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cond.wait(lk, [&] { return innerDone; });
+    }
+
+    ASSERT_NOT_EQUALS(outerThread, innerThread);
+
+    auto stats = getStats();
+    ASSERT_EQ(stats["totalQueuedLocally"].numberLong(), 1);
+    ASSERT_EQ(stats["totalStolen"].numberLong(), 1);
+    ASSERT_EQ(stats["localQueueDepth"].numberLong(), 0);
+}
+
 TEST_F(ServiceExecutorSynchronousFixture, BasicTaskRuns) {
     ASSERT_OK(executor->start());
     auto guard = MakeGuard([this] { ASSERT_OK(executor->shutdown(kShutdownTime)); });
@@ -35,6 +35,7 @@
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/rpc/message.h"
 #include "mongo/rpc/op_msg.h"
@@ -55,6 +56,15 @@
 
 namespace mongo {
 namespace {
+
+// When enabled, asynchronous sessions produce the next batch of an exhaust cursor while the
+// previous one is still being sent. See ServiceStateMachine::_startPipelinedSink().
+MONGO_EXPORT_SERVER_PARAMETER(pipelineExhaustBatches, bool, false);
+
+// Smaller replies normally fit in the socket send buffer, so sending them doesn't block long enough
+// to be worth handing off to another worker.
+constexpr int kMinPipelinedSinkBytes = 256 * 1024;
+
 /**
  * Creates and returns a legacy exhaust message, if exhaust is allowed. The returned message is to
  * be used as the subsequent 'synthetic' exhaust request. Returns an empty message if exhaust is not
@@ -445,6 +455,17 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
     // up in currentOp results after the response reaches the client
     opCtx.reset();
 
+    // The previous batch of a pipelined exhaust stream must be fully sent before anything else
+    // happens on the session.
+    auto pipelinedSinkStatus = _waitForPipelinedSink();
+    if (!pipelinedSinkStatus.isOK()) {
+        log() << "Error sending response to client: " << pipelinedSinkStatus
+              << ". Ending connection from " << _session()->remote()
+              << " (connection id: " << _session()->id() << ")";
+        _state.store(State::EndSession);
+        return _runNextInGuard(std::move(guard));
+    }
+
     // Format our response, if we have one
     Message& toSink = dbresponse.response;
     if (!toSink.empty()) {
@@ -470,6 +491,15 @@ void ServiceStateMachine::_processMessage(ThreadGuard guard) {
             uassertStatusOK(swm.getStatus());
             toSink = swm.getValue();
         }
+
+        if (_inExhaust && _shouldPipelineSink(toSink)) {
+            // Stay in the Process state and produce the next batch while this one is sent.
+            _startPipelinedSink(std::move(toSink));
+            return _scheduleNextWithGuard(std::move(guard),
+                                          ServiceExecutor::kDeferredTask |
+                                              ServiceExecutor::kMayYieldBeforeSchedule,
+                                          transport::ServiceExecutorTaskName::kSSMExhaustMessage);
+        }
         _sinkMessage(std::move(guard), std::move(toSink));
 
     } else {
@@ -603,7 +633,46 @@ void ServiceStateMachine::_terminateAndLogIfError(Status status) {
     }
 }
 
+bool ServiceStateMachine::_shouldPipelineSink(const Message& toSink) const {
+    return _transportMode == transport::Mode::kAsynchronous && pipelineExhaustBatches.load() &&
+        toSink.size() >= kMinPipelinedSinkBytes;
+}
+
+void ServiceStateMachine::_startPipelinedSink(Message toSink) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_pipelinedSinkMutex);
+        invariant(!_pipelinedSinkInFlight);
+        _pipelinedSinkInFlight = true;
+    }
+
+    auto finish = [this](Status status) {
+        stdx::lock_guard<stdx::mutex> lk(_pipelinedSinkMutex);
+        _pipelinedSinkStatus = std::move(status);
+        _pipelinedSinkInFlight = false;
+        _pipelinedSinkDone.notify_all();
+    };
+
+    auto sinkTask = [ ssm = shared_from_this(), toSink = std::move(toSink), finish ]() mutable {
+        finish(ssm->_session()->sinkMessage(std::move(toSink)));
+    };
+    auto status = _serviceExecutor->schedule(std::move(sinkTask),
+                                             ServiceExecutor::kEmptyFlags,
+                                             transport::ServiceExecutorTaskName::kSSMPipelinedSink);
+    if (!status.isOK()) {
+        finish(std::move(status));
+    }
+}
+
+Status ServiceStateMachine::_waitForPipelinedSink() {
+    stdx::unique_lock<stdx::mutex> lk(_pipelinedSinkMutex);
+    _pipelinedSinkDone.wait(lk, [&] { return !_pipelinedSinkInFlight; });
+    return std::exchange(_pipelinedSinkStatus, Status::OK());
+}
+
 void ServiceStateMachine::_cleanupSession(ThreadGuard guard) {
+    // The session can't be released while a pipelined sink is still using it.
+    _waitForPipelinedSink().ignore();
+
     _state.store(State::Ended);
 
     _inMessage.reset();
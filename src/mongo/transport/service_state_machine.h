@@ -34,6 +34,7 @@
 #include "mongo/config.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
@@ -74,11 +75,13 @@ public:
                         transport::SessionHandle session,
                         transport::Mode transportMode);
 
+
     /*
      * Any state may transition to EndSession in case of an error, otherwise the valid state
      * transitions are:
      * Source -> SourceWait -> Process -> SinkWait -> Source (standard RPC)
      * Source -> SourceWait -> Process -> SinkWait -> Process -> SinkWait ... (exhaust)
+     * Source -> SourceWait -> Process -> Process -> ... -> SinkWait (pipelined exhaust)
      * Source -> SourceWait -> Process -> Source (fire-and-forget)
      */
     enum class State {
@@ -219,6 +222,22 @@ private:
      */
     void _cleanupSession(ThreadGuard guard);
 
+    /*
+     * With pipelineExhaustBatches enabled, an asynchronous session schedules the send of each
+     * large exhaust batch as a task on the service executor, and produces the next batch while
+     * another worker sends it, instead of waiting for the send to finish first. At most one batch
+     * is in flight, so memory use is bounded by two batches per session. The synchronous executor
+     * runs every task of a session on that session's thread, so it has nothing to pipeline with.
+     */
+    bool _shouldPipelineSink(const Message& toSink) const;
+    void _startPipelinedSink(Message toSink);
+
+    /*
+     * Waits for the batch being sent by _startPipelinedSink(), if any, and returns the result of
+     * sending it.
+     */
+    Status _waitForPipelinedSink();
+
     AtomicWord<State> _state{State::Created};
 
     ServiceEntryPoint* _sep;
@@ -237,6 +256,12 @@ private:
     boost::optional<MessageCompressorId> _compressorId;
     Message _inMessage;
 
+    // Guards the state of the batch being sent by _startPipelinedSink().
+    stdx::mutex _pipelinedSinkMutex;
+    stdx::condition_variable _pipelinedSinkDone;
+    bool _pipelinedSinkInFlight = false;
+    Status _pipelinedSinkStatus = Status::OK();
+
     AtomicWord<Ownership> _owned{Ownership::kUnowned};
 #if MONGO_CONFIG_DEBUG_BUILD
     AtomicWord<stdx::thread::id> _owningThread;
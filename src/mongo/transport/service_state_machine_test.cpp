@@ -35,6 +35,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/client.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/rpc/op_msg.h"
 #include "mongo/stdx/memory.h"
@@ -162,11 +163,17 @@ public:
 
         Status sinkMessage(Message message) override {
             auto tl = checked_cast<MockTL*>(getTransportLayer());
-            ASSERT_EQ(tl->_ssm->state(), ServiceStateMachine::State::SinkWait);
+            if (tl->_allowSinkWhileProcessing &&
+                tl->_ssm->state() == ServiceStateMachine::State::Process) {
+                log() << "In pipelined sinkMessage";
+            } else {
+                ASSERT_EQ(tl->_ssm->state(), ServiceStateMachine::State::SinkWait);
+            }
             tl->_lastTicketSource = false;
 
             log() << "In sinkMessage";
             tl->_ranSink = true;
+            tl->_sinkCount++;
 
             if (tl->_waitHook)
                 tl->_waitHook();
@@ -205,6 +212,15 @@ public:
         return _ranSink;
     }
 
+    int sinkCount() const {
+        return _sinkCount;
+    }
+
+    // Pipelined exhaust batches are sunk while the SSM is processing the next request.
+    void setAllowSinkWhileProcessing() {
+        _allowSinkWhileProcessing = true;
+    }
+
     bool ranSource() const {
         return _ranSource;
     }
@@ -221,6 +237,8 @@ private:
     bool _lastTicketSource = true;
     bool _ranSink = false;
     bool _ranSource = false;
+    int _sinkCount = 0;
+    bool _allowSinkWhileProcessing = false;
     FailureMode _nextShouldFail = Nothing;
     Message _lastSunk;
     ServiceStateMachine* _ssm;
@@ -243,6 +261,12 @@ public:
         return Status::OK();
     }
     Status schedule(Task task, ScheduleFlags flags, ServiceExecutorTaskName taskName) override {
+        // Pipelined sinks would run on another worker; the tests run them when they choose to.
+        if (taskName == ServiceExecutorTaskName::kSSMPipelinedSink) {
+            _pipelinedSinks.push_back(std::move(task));
+            return Status::OK();
+        }
+
         if (!_scheduleHook) {
             return Status::OK();
         } else {
@@ -261,8 +285,19 @@ public:
         _scheduleHook = std::move(hook);
     }
 
+    // Runs the pipelined sinks scheduled so far and returns how many there were.
+    size_t runPipelinedSinks() {
+        auto sinks = std::move(_pipelinedSinks);
+        _pipelinedSinks.clear();
+        for (auto& sink : sinks) {
+            sink();
+        }
+        return sinks.size();
+    }
+
 private:
     ScheduleHook _scheduleHook;
+    std::vector<Task> _pipelinedSinks;
 };
 
 class SimpleEvent {
@@ -476,6 +511,100 @@ TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaust) {
     ASSERT_EQ(firstResponseId, msg.header().getResponseToMsgId());
 }
 
+class PipelinedExhaustFixture : public ServiceStateMachineFixture {
+protected:
+    void setUp() override {
+        ServiceStateMachineFixture::setUp();
+
+        _pipelineParam =
+            ServerParameterSet::getGlobal()->getMap().find("pipelineExhaustBatches")->second;
+        ASSERT_OK(_pipelineParam->setFromString("true"));
+        _tl->setAllowSinkWhileProcessing();
+        _tl->setSourceMessage(getMoreRequestWithExhaust(kNss, kCursorId, 1));
+    }
+
+    void tearDown() override {
+        ASSERT_OK(_pipelineParam->setFromString("false"));
+        ServiceStateMachineFixture::tearDown();
+    }
+
+    // Replaces the synchronous SSM of the fixture with an asynchronous one, which pipelines.
+    void makeAsynchronousSSM() {
+        _ssm = ServiceStateMachine::create(
+            getGlobalServiceContext(), _tl->createSession(), transport::Mode::kAsynchronous);
+        _tl->setSSM(_ssm.get());
+    }
+
+    // A batch large enough to be pipelined.
+    void setLargeBatchResponse() {
+        _sep->setResponseMessage(buildOpMsg(
+            BSON("ok" << 1 << "cursor"
+                      << BSON("id" << kCursorId << "ns" << kNss << "nextBatch"
+                                   << BSON_ARRAY(BSON("x" << std::string(512 * 1024, 'x')))))));
+    }
+
+    const long long kCursorId = 42;
+    const std::string kNss = "test.coll";
+    ServerParameter* _pipelineParam;
+};
+
+TEST_F(PipelinedExhaustFixture, SendsLargeBatchesOnTheServiceExecutor) {
+    makeAsynchronousSSM();
+    setLargeBatchResponse();
+
+    // Source the request, then process it. The response is handed to the service executor to be
+    // sent and the SSM stays in Process to produce the next batch.
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+    _ssm->runNext();
+    ASSERT_FALSE(haveClient());
+    ASSERT_EQ(_ssm->state(), State::Process);
+    ASSERT_EQ(_tl->sinkCount(), 0);
+    ASSERT_EQ(_sexec->runPipelinedSinks(), 1U);
+    ASSERT_EQ(_tl->sinkCount(), 1);
+
+    // The terminal batch is sunk normally once the pipelined one has been sent.
+    BSONObj getMoreTerminalResBody = BSON(
+        "ok" << 1 << "cursor" << BSON("id" << 0 << "ns" << kNss << "nextBatch" << BSONArray()));
+    _sep->setResponseMessage(buildOpMsg(getMoreTerminalResBody));
+    _ssm->runNext();
+    ASSERT_FALSE(haveClient());
+    ASSERT_EQ(_ssm->state(), State::Source);
+    ASSERT_EQ(_tl->sinkCount(), 2);
+    ASSERT_EQ(_sexec->runPipelinedSinks(), 0U);
+
+    auto msg = _tl->getLastSunk();
+    ASSERT_FALSE(OpMsg::isFlagSet(msg, OpMsg::kMoreToCome));
+    ASSERT_BSONOBJ_EQ(getMoreTerminalResBody, OpMsg::parse(msg).body);
+}
+
+TEST_F(PipelinedExhaustFixture, FailedPipelinedSendEndsTheSession) {
+    makeAsynchronousSSM();
+    setLargeBatchResponse();
+
+    _ssm->runNext();
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+
+    _tl->setNextFailure(MockTL::Sink);
+    ASSERT_EQ(_sexec->runPipelinedSinks(), 1U);
+
+    // The next batch is produced, but finds that the previous one could not be sent.
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Ended);
+    ASSERT_EQ(_tl->sinkCount(), 1);
+}
+
+TEST_F(PipelinedExhaustFixture, SynchronousSessionsDoNotPipeline) {
+    setLargeBatchResponse();
+
+    _ssm->runNext();
+    _ssm->runNext();
+    ASSERT_EQ(_ssm->state(), State::Process);
+    ASSERT_EQ(_tl->sinkCount(), 1);
+    ASSERT_EQ(_sexec->runPipelinedSinks(), 0U);
+}
+
 TEST_F(ServiceStateMachineFixture, TestGetMoreWithExhaustAndEmptyResponseNamespace) {
     // Construct a 'getMore' OP_MSG request with the exhaust flag set.
     const int32_t initRequestId = 1;
@@ -221,6 +221,9 @@ protected:
 
         _sslSocket.emplace(
             std::move(_socket), *_tl->_egressSSLContext, removeFQDNRoot(target.host()));
+#if MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+        _tl->_egressSSLSessionCache.offerSession(_sslSocket->native_handle(), target);
+#endif
         lk.unlock();
 
         auto doHandshake = [&] {
@@ -232,17 +235,29 @@ protected:
                 return _sslSocket->async_handshake(asio::ssl::stream_base::client, UseFuture{});
             }
         };
-        return doHandshake().then([this, target] {
-            _ranHandshake = true;
+        return doHandshake()
+            .then([this, target] {
+                _ranHandshake = true;
 
-            auto sslManager = getSSLManager();
-            auto swPeerInfo = uassertStatusOK(sslManager->parseAndValidatePeerCertificate(
-                _sslSocket->native_handle(), target.host(), target));
+                auto sslManager = getSSLManager();
+                auto swPeerInfo = uassertStatusOK(sslManager->parseAndValidatePeerCertificate(
+                    _sslSocket->native_handle(), target.host(), target));
 
-            if (swPeerInfo) {
-                SSLPeerInfo::forSession(shared_from_this()) = std::move(*swPeerInfo);
-            }
-        });
+                if (swPeerInfo) {
+                    SSLPeerInfo::forSession(shared_from_this()) = std::move(*swPeerInfo);
+                }
+
+#if MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+                // Only sessions with a validated peer are kept for resumption
+                _tl->_egressSSLSessionCache.storeSession(_sslSocket->native_handle(), target);
+#endif
+            })
+            .onError([this, target](Status status) {
+#if MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL
+                _tl->_egressSSLSessionCache.dropSession(target);
+#endif
+                return status;
+            });
     }
 
     // For synchronous connections where we don't have an async timer, just take a dummy lock and
@@ -344,6 +359,10 @@ private:
     Future<Message> sourceMessageImpl(const transport::BatonHandle& baton = nullptr) {
         static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
 
+        if (canReadAhead()) {
+            return sourceMessageWithReadAhead(baton);
+        }
+
         auto headerBuffer = SharedBuffer::allocate(kHeaderSize);
         auto ptr = headerBuffer.get();
         return read(asio::buffer(ptr, kHeaderSize), baton)
@@ -385,6 +404,149 @@ private:
             });
     }
 
+    /**
+     * Whether messages may be read with sourceMessageWithReadAhead(). Until a session has been
+     * checked for a TLS handshake, nothing past the first message header may be consumed, and
+     * reads on TLS sessions go through the SSL stream.
+     */
+    bool canReadAhead() const {
+#ifdef MONGO_CONFIG_SSL
+        return _ranHandshake && !_sslSocket;
+#else
+        return true;
+#endif
+    }
+
+    /**
+     * Reads a message with a single recv() of up to kReadAheadBufferSize bytes rather than one for
+     * the header and one for the body, which is enough for most messages. Bytes read past the end
+     * of the message belong to the following ones and are kept in '_readAheadBuffer'.
+     */
+    Future<Message> sourceMessageWithReadAhead(const transport::BatonHandle& baton) {
+        static constexpr auto kHeaderSize = sizeof(MSGHEADER::Value);
+
+        return fillReadAheadBuffer(kHeaderSize, baton).then([this, baton]() -> Future<Message> {
+            if (checkForHTTPRequest(asio::buffer(_readAheadBuffer.get(), kHeaderSize))) {
+                return sendHTTPResponse(baton);
+            }
+
+            const auto msgLen =
+                size_t(MSGHEADER::View(_readAheadBuffer.get()).getMessageLength());
+            if (msgLen < kHeaderSize || msgLen > MaxMessageSizeBytes) {
+                StringBuilder sb;
+                sb << "recv(): message msgLen " << msgLen << " is invalid. "
+                   << "Min " << kHeaderSize << " Max: " << MaxMessageSizeBytes;
+                const auto str = sb.str();
+                LOG(0) << str;
+
+                return Future<Message>::makeReady(Status(ErrorCodes::ProtocolError, str));
+            }
+
+            if (msgLen <= _readAheadBytes) {
+                // The whole message has been read, so hand over the buffer it was read into.
+                auto buffer = std::move(_readAheadBuffer);
+                const auto excess = _readAheadBytes - msgLen;
+                _readAheadBuffer = {};
+                _readAheadBytes = 0;
+                if (excess) {
+                    _readAheadBuffer = takeReadAheadBuffer();
+                    memcpy(_readAheadBuffer.get(), buffer.get() + msgLen, excess);
+                    _readAheadBytes = excess;
+                }
+
+                // Keep a reference so that the buffer can be read into again once the message
+                // has been handled.
+                _spareReadAheadBuffer = buffer;
+
+                if (_isIngressSession) {
+                    networkCounter.hitPhysicalIn(msgLen);
+                }
+                return Future<Message>::makeReady(Message(std::move(buffer)));
+            }
+
+            // Read the rest of a message that does not fit straight into its own buffer, so that
+            // nothing past its end is consumed.
+            auto buffer = SharedBuffer::allocate(msgLen);
+            const auto alreadyRead = _readAheadBytes;
+            memcpy(buffer.get(), _readAheadBuffer.get(), alreadyRead);
+            _readAheadBuffer = {};
+            _readAheadBytes = 0;
+
+            auto ptr = buffer.get();
+            return read(asio::buffer(ptr + alreadyRead, msgLen - alreadyRead), baton)
+                .then([ this, buffer = std::move(buffer), msgLen ]() mutable {
+                    if (_isIngressSession) {
+                        networkCounter.hitPhysicalIn(msgLen);
+                    }
+                    return Message(std::move(buffer));
+                });
+        });
+    }
+
+    /**
+     * Reads from the socket into '_readAheadBuffer' until it holds at least 'minBytes' bytes. No
+     * buffer is held while waiting for an idle session to become readable.
+     */
+    Future<void> fillReadAheadBuffer(size_t minBytes, const transport::BatonHandle& baton) {
+        invariant(minBytes <= kReadAheadBufferSize);
+
+        const bool shortReads =
+            MONGO_FAIL_POINT(transportLayerASIOshortOpportunisticReadWrite) &&
+            _blockingMode == Async;
+
+        std::error_code ec;
+        while (_readAheadBytes < minBytes) {
+            if (!_readAheadBuffer) {
+                _readAheadBuffer = takeReadAheadBuffer();
+            }
+
+            const auto size = shortReads ? 1 : kReadAheadBufferSize - _readAheadBytes;
+            auto buffer = asio::mutable_buffer(_readAheadBuffer.get() + _readAheadBytes, size);
+            _readAheadBytes += _socket.read_some(buffer, ec);
+            if (ec) {
+                break;
+            }
+
+            if (shortReads && _readAheadBytes < minBytes) {
+                ec = asio::error::would_block;
+                break;
+            }
+        }
+
+        if (((ec == asio::error::would_block) || (ec == asio::error::try_again)) &&
+            (_blockingMode == Async)) {
+            if (!_readAheadBytes) {
+                _readAheadBuffer = {};
+                _spareReadAheadBuffer = {};
+            }
+
+            if (baton) {
+                return baton->addSession(*this, Baton::Type::In)
+                    .then([this, minBytes, baton] {
+                        return fillReadAheadBuffer(minBytes, baton);
+                    });
+            }
+
+            return _socket.async_wait(GenericSocket::wait_read, UseFuture{})
+                .then([this, minBytes, baton] { return fillReadAheadBuffer(minBytes, baton); });
+        }
+
+        return futurize(ec);
+    }
+
+    /**
+     * Returns a buffer of kReadAheadBufferSize bytes, reusing the one the previous message was
+     * handed over in if nothing references that message any more.
+     */
+    SharedBuffer takeReadAheadBuffer() {
+        auto spare = std::move(_spareReadAheadBuffer);
+        _spareReadAheadBuffer = {};
+        if (spare && !spare.isShared()) {
+            return spare;
+        }
+        return SharedBuffer::allocate(kReadAheadBufferSize);
+    }
+
     template <typename MutableBufferSequence>
     Future<void> read(const MutableBufferSequence& buffers,
                       const transport::BatonHandle& baton = nullptr) {
@@ -704,6 +866,19 @@ private:
     boost::optional<Milliseconds> _socketTimeout;
 
     GenericSocket _socket;
+
+    // Bytes at the start of '_readAheadBuffer' that were received but not yet consumed. See
+    // sourceMessageWithReadAhead().
+    static constexpr size_t kReadAheadBufferSize = 4096;
+    SharedBuffer _readAheadBuffer;
+    size_t _readAheadBytes = 0;
+
+    // The buffer of the last message handed over whole by sourceMessageWithReadAhead(). Request
+    // and reply usually alternate, so it is free again by the time the next message is read and
+    // can be reused instead of allocating. Dropped along with '_readAheadBuffer' when an
+    // asynchronous session goes idle.
+    SharedBuffer _spareReadAheadBuffer;
+
 #ifdef MONGO_CONFIG_SSL
     boost::optional<asio::ssl::stream<decltype(_socket)>> _sslSocket;
     bool _ranHandshake = false;
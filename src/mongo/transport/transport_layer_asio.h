@@ -38,6 +38,7 @@
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/transport/egress_ssl_session_cache.h"
 #include "mongo/transport/transport_layer.h"
 #include "mongo/transport/transport_mode.h"
 #include "mongo/util/fail_point_service.h"
@@ -189,6 +190,10 @@ private:
     std::unique_ptr<asio::ssl::context> _egressSSLContext;
 #endif
 
+#if defined(MONGO_CONFIG_SSL) && (MONGO_CONFIG_SSL_PROVIDER == MONGO_CONFIG_SSL_PROVIDER_OPENSSL)
+    EgressSSLSessionCache _egressSSLSessionCache;
+#endif
+
     std::vector<std::pair<SockAddr, GenericAcceptor>> _acceptors;
 
     // Only used if _listenerOptions.async is false.
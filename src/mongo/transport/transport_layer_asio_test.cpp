@@ -253,14 +253,23 @@ public:
     }
 
     void sendMessage() {
-        OpMsgBuilder builder;
-        builder.setBody(BSON("ping" << 1));
-        Message msg = builder.finish();
-        msg.header().setResponseToMsgId(0);
-        msg.header().setId(0);
+        sendMessages(1);
+    }
+
+    // Sends 'count' messages with a single write, so that they are likely to be received together.
+    void sendMessages(int count) {
+        std::string bytes;
+        for (int i = 0; i < count; i++) {
+            OpMsgBuilder builder;
+            builder.setBody(BSON("ping" << 1 << "i" << i));
+            Message msg = builder.finish();
+            msg.header().setResponseToMsgId(0);
+            msg.header().setId(i);
+            bytes.append(msg.buf(), msg.size());
+        }
 
         std::error_code ec;
-        asio::write(_sock, asio::buffer(msg.buf(), msg.size()), ec);
+        asio::write(_sock, asio::buffer(bytes.data(), bytes.size()), ec);
         ASSERT_FALSE(ec);
     }
 
@@ -308,6 +317,39 @@ TEST(TransportLayerASIO, SourceSyncTimeoutSucceeds) {
     tla->shutdown();
 }
 
+/* check that messages received in a single segment are each sourced whole and in order */
+class PipelinedSEP : public TimeoutSEP {
+public:
+    static constexpr int kNumMessages = 3;
+
+    void startSession(transport::SessionHandle session) override {
+        log() << "Accepted connection from " << session->remote();
+        stdx::thread([ this, session = std::move(session) ]() mutable {
+            for (int i = 0; i < kNumMessages; i++) {
+                auto swMessage = session->sourceMessage();
+                ASSERT_OK(swMessage.getStatus());
+                ASSERT_EQ(swMessage.getValue().header().getId(), i);
+                auto body = OpMsg::parse(swMessage.getValue()).body;
+                ASSERT_EQ(body["i"].numberInt(), i);
+            }
+
+            session.reset();
+            notifyComplete();
+        }).detach();
+    }
+};
+
+TEST(TransportLayerASIO, SourcePipelinedMessages) {
+    PipelinedSEP sep;
+    auto tla = makeAndStartTL(&sep);
+
+    TimeoutConnector connector(tla->listenerPort(), false);
+    connector.sendMessages(PipelinedSEP::kNumMessages);
+
+    sep.waitForTimeout();
+    tla->shutdown();
+}
+
 /* check that switching from timeouts to no timeouts correctly resets the timeout to unlimited */
 class TimeoutSwitchModesSEP : public TimeoutSEP {
 public:
@@ -117,5 +117,9 @@ void TaskExecutorProxy::appendConnectionStats(executor::ConnectionPoolStats* sta
     _executor->appendConnectionStats(stats);
 }
 
+void TaskExecutorProxy::warmUpConnections(const HostAndPort& hostAndPort) {
+    _executor->warmUpConnections(hostAndPort);
+}
+
 }  // namespace unittest
 }  // namespace mongo
@@ -173,4 +173,12 @@ StringData getThreadName() {
     return threadName;
 }
 
+StringData getThreadNameIfSet() {
+    if (MONGO_unlikely(!mongoInitializersHaveRun)) {
+        return "main"_sd;
+    }
+
+    return threadName;
+}
+
 }  // namespace mongo
@@ -45,4 +45,11 @@ void setThreadName(StringData name);
  */
 StringData getThreadName();
 
+/**
+ * Retrieves the name of the current thread, or an empty StringData if no name was previously set.
+ * Unlike getThreadName(), this never names the thread, so it does not allocate and may be called
+ * from a signal handler.
+ */
+StringData getThreadNameIfSet();
+
 }  // namespace mongo
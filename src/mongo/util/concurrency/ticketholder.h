@@ -26,19 +26,23 @@
  */
 #pragma once
 
-#if defined(__linux__)
-#include <semaphore.h>
-#endif
+#include <list>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
-#include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
 
+/**
+ * Limits the number of threads that can hold a ticket at the same time. Threads that cannot get a
+ * ticket right away are queued, and released tickets are handed to the queued threads in the order
+ * in which they arrived. A thread which finds other threads queued never overtakes them, even if a
+ * ticket is free at that instant.
+ */
 class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
@@ -46,6 +50,9 @@ public:
     explicit TicketHolder(int num);
     ~TicketHolder();
 
+    /**
+     * Acquires a ticket if one is available and no other thread is queued for one.
+     */
     bool tryAcquire();
 
     /**
@@ -71,6 +78,11 @@ public:
     }
     void release();
 
+    /**
+     * Changes the total number of tickets. Growing hands the new tickets to queued threads right
+     * away. Shrinking below the number of tickets in use never blocks: the excess tickets are
+     * retired as they are released.
+     */
     Status resize(int newSize);
 
     int available() const;
@@ -79,21 +91,46 @@ public:
 
     int outof() const;
 
+    /**
+     * Returns the number of threads currently queued for a ticket.
+     */
+    int queued() const;
+
+    /**
+     * Returns the number of times a thread had to queue for a ticket, and the combined time all of
+     * them spent queued, since this TicketHolder was created.
+     */
+    long long totalQueued() const;
+    Microseconds totalTimeQueued() const;
+
 private:
-#if defined(__linux__)
-    mutable sem_t _sem;
+    struct Waiter {
+        stdx::condition_variable cv;
+        bool granted = false;
+    };
 
-    // You can read _outof without a lock, but have to hold _resizeMutex to change.
-    AtomicInt32 _outof;
-    stdx::mutex _resizeMutex;
-#else
-    bool _tryAcquire();
+    bool _tryAcquire_inlock();
+    void _release_inlock();
+
+    /**
+     * Hands out available tickets to the threads at the front of the queue.
+     */
+    void _grantToWaiters_inlock();
 
+    mutable stdx::mutex _mutex;
+
+    // Tickets not currently held. This is negative after the holder was shrunk below the number of
+    // tickets in use.
+    int _available;
+
+    // You can read _outof without a lock, but have to hold _mutex to change.
     AtomicInt32 _outof;
-    int _num;
-    stdx::mutex _mutex;
-    stdx::condition_variable _newTicket;
-#endif
+
+    // Threads waiting for a ticket, oldest first. Each Waiter lives on the stack of its thread.
+    std::list<Waiter*> _queue;
+
+    long long _totalQueued = 0;
+    Microseconds _totalTimeQueued{0};
 };
 
 class ScopedTicket {
@@ -31,6 +31,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <vector>
+
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/ticketholder.h"
 
@@ -70,5 +73,116 @@ TEST(TicketholderTest, BasicTimeout) {
     ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(2)));
     holder.release();
     ASSERT_EQ(holder.used(), 0);
+
+    ASSERT_EQ(holder.queued(), 0);
+    ASSERT_EQ(holder.totalQueued(), 4);
+}
+
+void waitUntilQueued(const TicketHolder& holder, int numQueued) {
+    while (holder.queued() < numQueued) {
+        sleepmillis(1);
+    }
+}
+
+TEST(TicketholderTest, GrantsTicketsInArrivalOrder) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    stdx::mutex mutex;
+    std::vector<int> order;
+
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < 3; i++) {
+        threads.emplace_back([&, i] {
+            holder.waitForTicket();
+            {
+                stdx::lock_guard<stdx::mutex> lk(mutex);
+                order.push_back(i);
+            }
+            holder.release();
+        });
+        waitUntilQueued(holder, i + 1);
+    }
+
+    // A free ticket is not handed to a newcomer while other threads are queued.
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    ASSERT_EQ(order.size(), 3U);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQ(order[i], i);
+    }
+    ASSERT_EQ(holder.used(), 0);
+    ASSERT_EQ(holder.queued(), 0);
+    ASSERT_EQ(holder.totalQueued(), 3);
+}
+
+TEST(TicketholderTest, TimedOutWaiterLeavesQueue) {
+    TicketHolder holder(1);
+    ASSERT(holder.tryAcquire());
+
+    ASSERT_FALSE(holder.waitForTicketUntil(Date_t::now() + Milliseconds(5)));
+    ASSERT_EQ(holder.queued(), 0);
+    ASSERT_GTE(holder.totalTimeQueued(), Milliseconds(5));
+
+    holder.release();
+    ASSERT(holder.tryAcquire());
+    holder.release();
+}
+
+TEST(TicketholderTest, ResizeGrowWakesWaiters) {
+    TicketHolder holder(5);
+    for (int i = 0; i < 5; i++) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    stdx::thread waiter([&] { holder.waitForTicket(); });
+    waitUntilQueued(holder, 1);
+
+    ASSERT_OK(holder.resize(6));
+    waiter.join();
+
+    ASSERT_EQ(holder.used(), 6);
+    ASSERT_EQ(holder.available(), 0);
+    ASSERT_EQ(holder.outof(), 6);
+
+    for (int i = 0; i < 6; i++) {
+        holder.release();
+    }
+    ASSERT_EQ(holder.available(), 6);
+}
+
+TEST(TicketholderTest, ResizeShrinkRetiresTicketsAsReleased) {
+    TicketHolder holder(10);
+    for (int i = 0; i < 8; i++) {
+        ASSERT(holder.tryAcquire());
+    }
+
+    // Shrinking below the number of tickets in use does not block.
+    ASSERT_OK(holder.resize(5));
+    ASSERT_EQ(holder.outof(), 5);
+    ASSERT_EQ(holder.used(), 8);
+    ASSERT_EQ(holder.available(), 0);
+
+    // The first three releases retire the excess tickets.
+    for (int i = 0; i < 3; i++) {
+        holder.release();
+        ASSERT_FALSE(holder.tryAcquire());
+    }
+
+    holder.release();
+    ASSERT_EQ(holder.available(), 1);
+    ASSERT(holder.tryAcquire());
+
+    for (int i = 0; i < 5; i++) {
+        holder.release();
+    }
+    ASSERT_EQ(holder.available(), 5);
+
+    ASSERT_NOT_OK(holder.resize(4));
 }
 }  // namespace
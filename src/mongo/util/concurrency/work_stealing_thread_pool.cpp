@@ -0,0 +1,328 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/status.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/idle_thread_block.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicInt32 nextUnnamedThreadPoolId{1};
+
+// The pool and queue of the worker thread running on this thread, if any.
+thread_local const WorkStealingThreadPool* currentPool = nullptr;
+thread_local size_t currentQueueIndex = 0;
+
+/**
+ * Sets defaults and checks bounds limits on "options", and returns it.
+ */
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "WorkStealingThreadPool"
+                                         << nextUnnamedThreadPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.numThreads < 1) {
+        severe() << "Tried to create pool " << options.poolName << " with "
+                 << options.numThreads << " threads, but it must have at least 1";
+        fassertFailed(50969);
+    }
+    return options;
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))), _queues([this] {
+          std::vector<std::unique_ptr<WorkerQueue>> queues;
+          for (size_t i = 0; i < _options.numThreads; ++i) {
+              queues.push_back(stdx::make_unique<WorkerQueue>());
+          }
+          return queues;
+      }()) {}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+    if (shutdownComplete != _state) {
+        _join_inlock(&lk);
+    }
+
+    if (shutdownComplete != _state) {
+        severe() << "Failed to shutdown pool during destruction";
+        fassertFailed(50968);
+    }
+    invariant(_threads.empty());
+    invariant(_numPendingTasks.load() == 0);
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(50966);
+    }
+    _setState_inlock(running);
+    invariant(_threads.empty());
+    for (size_t i = 0; i < _options.numThreads; ++i) {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << i;
+        _threads.emplace_back([this, i, threadName] {
+            setThreadName(threadName);
+            _options.onCreateThread(threadName);
+            LOG(1) << "starting thread in pool " << _options.poolName;
+            try {
+                _consumeTasks(i);
+            } catch (...) {
+                severe() << "Exception reached top of stack in thread pool "
+                         << _options.poolName << ": " << exceptionToStatus();
+                std::terminate();
+            }
+            LOG(1) << "shutting down thread in pool " << _options.poolName;
+        });
+    }
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+}
+
+void WorkStealingThreadPool::_shutdown_inlock() {
+    switch (_state) {
+        case preStart:
+        case running: {
+            _setState_inlock(joinRequired);
+            _shuttingDown.store(true);
+            stdx::lock_guard<stdx::mutex> parkLock(_parkMutex);
+            _workAvailable.notify_all();
+            return;
+        }
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WorkStealingThreadPool::join() {
+    try {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _join_inlock(&lk);
+    } catch (...) {
+        severe() << "Exception escaped join in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+}
+
+void WorkStealingThreadPool::_join_inlock(stdx::unique_lock<stdx::mutex>* lk) {
+    _stateChange.wait(*lk, [this] {
+        switch (_state) {
+            case preStart:
+                return false;
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                severe() << "Attempted to join pool " << _options.poolName << " more than once";
+                fassertFailed(50967);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+    std::vector<stdx::thread> threadsToJoin;
+    swap(threadsToJoin, _threads);
+    lk->unlock();
+    for (auto& t : threadsToJoin) {
+        t.join();
+    }
+
+    // The workers drain every queue before exiting, so tasks are only left if the pool was never
+    // started. Tasks cannot be run inline because they can create OperationContexts and the
+    // join() caller may already have one associated with the thread.
+    if (_numPendingTasks.load() > 0) {
+        stdx::thread cleanThread([this] {
+            const std::string threadName = str::stream() << _options.threadNamePrefix
+                                                         << _options.numThreads;
+            setThreadName(threadName);
+            _options.onCreateThread(threadName);
+            while (auto task = _takeTask(0)) {
+                _runTask(task);
+            }
+        });
+        cleanThread.join();
+    }
+    lk->lock();
+    invariant(_state == joining);
+    _setState_inlock(shutdownComplete);
+}
+
+Status WorkStealingThreadPool::schedule(Task task) {
+    // Count the task before checking for shutdown, so that workers which see the shutdown also see
+    // the task and wait for it to be queued before exiting.
+    _numPendingTasks.fetchAndAdd(1);
+    if (_shuttingDown.load()) {
+        _numPendingTasks.fetchAndSubtract(1);
+        return Status(ErrorCodes::ShutdownInProgress,
+                      str::stream() << "Shutdown of thread pool " << _options.poolName
+                                    << " in progress");
+    }
+
+    const size_t index = currentPool == this
+        ? currentQueueIndex
+        : static_cast<size_t>(_nextQueue.fetchAndAdd(1) % _queues.size());
+    {
+        auto& queue = *_queues[index];
+        stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+        queue.tasks.emplace_back(std::move(task));
+    }
+
+    _wakeOne();
+    return Status::OK();
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    Stats result;
+    result.numPendingTasks = static_cast<size_t>(std::max(_numPendingTasks.load(), 0LL));
+    result.numStolenTasks = static_cast<size_t>(_numStolenTasks.load());
+    result.numParks = static_cast<size_t>(_numParks.load());
+    return result;
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t index) {
+    currentPool = this;
+    currentQueueIndex = index;
+    ON_BLOCK_EXIT([] { currentPool = nullptr; });
+
+    while (true) {
+        if (auto task = _takeTask(index)) {
+            _runTask(task);
+            continue;
+        }
+
+        if (_shuttingDown.load() && _numPendingTasks.load() == 0) {
+            return;
+        }
+
+        // Look for work for a while before paying for a sleep and the wakeup that ends it.
+        bool workAvailable = false;
+        for (int i = 0; i < _options.spinIterations && !workAvailable; ++i) {
+            workAvailable = _numPendingTasks.load() > 0;
+            if (!workAvailable) {
+                stdx::this_thread::yield();
+            }
+        }
+
+        if (!workAvailable && !_shuttingDown.load()) {
+            _park();
+        }
+    }
+}
+
+WorkStealingThreadPool::Task WorkStealingThreadPool::_takeTask(size_t index) {
+    for (size_t i = 0; i < _queues.size(); ++i) {
+        auto& queue = *_queues[(index + i) % _queues.size()];
+        stdx::lock_guard<stdx::mutex> lk(queue.mutex);
+        if (queue.tasks.empty()) {
+            continue;
+        }
+
+        Task task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+        _numPendingTasks.fetchAndSubtract(1);
+        if (i > 0) {
+            _numStolenTasks.fetchAndAdd(1);
+        }
+        return task;
+    }
+    return Task();
+}
+
+void WorkStealingThreadPool::_park() {
+    stdx::unique_lock<stdx::mutex> lk(_parkMutex);
+
+    // schedule() counts its task before reading _numParkedWorkers, and this thread is counted
+    // before reading _numPendingTasks, so either the task is seen here or this thread is woken.
+    _numParkedWorkers.fetchAndAdd(1);
+    _numParks.fetchAndAdd(1);
+    {
+        MONGO_IDLE_THREAD_BLOCK;
+        _workAvailable.wait(
+            lk, [this] { return _numPendingTasks.load() > 0 || _shuttingDown.load(); });
+    }
+    _numParkedWorkers.fetchAndSubtract(1);
+}
+
+void WorkStealingThreadPool::_runTask(Task& task) {
+    try {
+        LOG(3) << "Executing a task on behalf of pool " << _options.poolName;
+        task();
+    } catch (...) {
+        severe() << "Exception escaped task in thread pool " << _options.poolName << ": "
+                 << exceptionToStatus();
+        std::terminate();
+    }
+}
+
+void WorkStealingThreadPool::_wakeOne() {
+    if (_numParkedWorkers.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_parkMutex);
+        _workAvailable.notify_one();
+    }
+}
+
+void WorkStealingThreadPool::_setState_inlock(const LifecycleState newState) {
+    if (newState == _state) {
+        return;
+    }
+    _state = newState;
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
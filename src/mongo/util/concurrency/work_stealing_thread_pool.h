@@ -0,0 +1,216 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+
+namespace mongo {
+
+class Status;
+
+/**
+ * A thread pool with a fixed number of threads, each of which has its own queue of tasks.
+ *
+ * Tasks scheduled by a task running in the pool go to the queue of the thread running it, and
+ * other tasks are spread over the queues round-robin, so that threads rarely contend for a
+ * queue. A thread whose queue is empty steals from the others' queues, spins for a while looking
+ * for work, and only then goes to sleep, so that bursts of short tasks do not pay for a wakeup
+ * per task.
+ *
+ * Unlike ThreadPool, the pool neither grows nor reaps threads.
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    MONGO_DISALLOW_COPYING(WorkStealingThreadPool);
+
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a
+        // name unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. An integer will be appended to this
+        // string to create the thread name for each thread in the pool. If you leave this empty,
+        // the prefix will be the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of threads in the pool, all of which are started by startup().
+        size_t numThreads = 8;
+
+        // How many times an idle thread looks for work before going to sleep.
+        int spinIterations = 1000;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Structure used to return information about the thread pool via getStats().
+     */
+    struct Stats {
+        // The number of tasks waiting to be executed by the pool.
+        size_t numPendingTasks;
+
+        // The number of tasks which a thread took from the queue of another thread.
+        size_t numStolenTasks;
+
+        // The number of times a thread ran out of work and went to sleep.
+        size_t numParks;
+    };
+
+    /**
+     * Constructs a thread pool, configured with the given "options".
+     */
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    Status schedule(Task task) override;
+
+    /**
+     * Returns statistics about the thread pool's utilization.
+     */
+    Stats getStats() const;
+
+private:
+    /**
+     * Representation of the stage of life of a thread pool, as for ThreadPool.
+     *
+     * preStart -> running -> joinRequired -> joining -> shutdownComplete
+     *        \               ^
+     *         \_____________/
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    /**
+     * The queue of a worker thread. Tasks are taken from the front, by the owner or by thieves.
+     */
+    struct WorkerQueue {
+        stdx::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /**
+     * This is the run loop of the worker thread which owns _queues[index].
+     */
+    void _consumeTasks(size_t index);
+
+    /**
+     * Takes the oldest task of _queues[index], or else steals the oldest task of another queue.
+     * Returns an empty task if every queue is empty.
+     */
+    Task _takeTask(size_t index);
+
+    /**
+     * Puts the calling worker to sleep until there may be work or the pool is shutting down.
+     */
+    void _park();
+
+    /**
+     * Runs "task", terminating the process if it throws.
+     */
+    void _runTask(Task& task);
+
+    /**
+     * Wakes up one sleeping worker, if there is any.
+     */
+    void _wakeOne();
+
+    /**
+     * Implementation of shutdown once _mutex is locked.
+     */
+    void _shutdown_inlock();
+
+    /**
+     * Implementation of join once _mutex is owned by "lk".
+     */
+    void _join_inlock(stdx::unique_lock<stdx::mutex>* lk);
+
+    /**
+     * Changes the lifecycle state (_state) of the pool and wakes up any threads waiting for a state
+     * change. Has no effect if _state == newState.
+     */
+    void _setState_inlock(LifecycleState newState);
+
+    // These are the options with which the pool was configured at construction time.
+    const Options _options;
+
+    // One queue per worker thread, allocated at construction.
+    const std::vector<std::unique_ptr<WorkerQueue>> _queues;
+
+    // Mutex guarding the lifecycle state and the list of threads.
+    mutable stdx::mutex _mutex;
+
+    // This variable represents the lifecycle state of the pool.
+    LifecycleState _state = preStart;
+
+    // Condition variable signaled whenever _state changes.
+    stdx::condition_variable _stateChange;
+
+    // List of threads serving as the worker pool.
+    std::vector<stdx::thread> _threads;
+
+    // Set once shutdown() has been called, so that workers can check for it without taking _mutex.
+    AtomicBool _shuttingDown{false};
+
+    // Number of scheduled tasks not yet taken from a queue.
+    AtomicInt64 _numPendingTasks{0};
+
+    // Mutex and condition variable on which idle workers sleep. A sleeping worker is counted in
+    // _numParkedWorkers, so that schedule() only takes the mutex if there is someone to wake.
+    stdx::mutex _parkMutex;
+    stdx::condition_variable _workAvailable;
+    AtomicInt64 _numParkedWorkers{0};
+
+    // Round-robin cursor over _queues for tasks scheduled from outside the pool.
+    AtomicUInt64 _nextQueue{0};
+
+    AtomicInt64 _numStolenTasks{0};
+    AtomicInt64 _numParks{0};
+};
+
+}  // namespace mongo
@@ -0,0 +1,102 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/death_test.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return stdx::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+TEST(WorkStealingThreadPoolTest, TasksScheduledFromTasksRunWhileTheirThreadIsBusy) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 2;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    // The child task lands in the queue of the thread running the parent, which stays busy until
+    // the child has run, so another thread must steal it.
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    bool childRan = false;
+    ASSERT_OK(pool.schedule([&] {
+        ASSERT_OK(pool.schedule([&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            childRan = true;
+            cv.notify_all();
+        }));
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return childRan; });
+    }));
+
+    pool.shutdown();
+    pool.join();
+    ASSERT_TRUE(childRan);
+    ASSERT_GTE(pool.getStats().numStolenTasks, 1U);
+    ASSERT_EQ(0U, pool.getStats().numPendingTasks);
+}
+
+TEST(WorkStealingThreadPoolTest, PendingTasksRunWhenPoolIsNeverStarted) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 4;
+    WorkStealingThreadPool pool(options);
+
+    int numRun = 0;
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_OK(pool.schedule([&] { ++numRun; }));
+    }
+    ASSERT_EQ(10U, pool.getStats().numPendingTasks);
+
+    pool.shutdown();
+    ASSERT_EQ(ErrorCodes::ShutdownInProgress, pool.schedule([] {}));
+    pool.join();
+    ASSERT_EQ(10, numRun);
+}
+
+DEATH_TEST(WorkStealingThreadPoolTest, NoThreadsDies, "but it must have at least 1") {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 0;
+    WorkStealingThreadPool pool(options);
+}
+
+}  // namespace
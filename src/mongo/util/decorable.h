@@ -133,6 +133,14 @@ public:
 
 protected:
     Decorable() : _decorations(this, getRegistry()) {}
+
+    /**
+     * Takes the storage for the decorations from 'storageCache' when it has some, and returns it
+     * there on destruction. See DecorationStorageCache.
+     */
+    explicit Decorable(DecorationStorageCache* storageCache)
+        : _decorations(this, getRegistry(), storageCache) {}
+
     ~Decorable() = default;
 
 private:
@@ -31,6 +31,7 @@
 #include "mongo/platform/basic.h"
 
 #include <boost/utility.hpp>
+#include <set>
 
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
@@ -135,6 +136,62 @@ TEST(DecorableTest, SimpleDecoration) {
     ASSERT_EQ(4, numDestructedAs);
 }
 
+TEST(DecorableTest, StorageCacheReusesStorage) {
+    numConstructedAs = 0;
+    numDestructedAs = 0;
+    DecorationRegistry<MyDecorable> registry;
+    const auto dd1 = registry.declareDecoration<A>();
+    DecorationStorageCache cache;
+
+    const void* firstStorage;
+    {
+        DecorationContainer<MyDecorable> decorable(nullptr, &registry, &cache);
+        firstStorage = &decorable.getDecoration(dd1);
+        decorable.getDecoration(dd1).value = 1;
+    }
+    ASSERT_EQ(1, numDestructedAs);
+
+    {
+        // The storage is reused, but the decorations are constructed afresh.
+        DecorationContainer<MyDecorable> decorable(nullptr, &registry, &cache);
+        ASSERT_EQ(firstStorage, &decorable.getDecoration(dd1));
+        ASSERT_EQ(0, decorable.getDecoration(dd1).value);
+        ASSERT_EQ(2, numConstructedAs);
+
+        // Nothing is left to reuse while the storage is in use.
+        DecorationContainer<MyDecorable> other(nullptr, &registry, &cache);
+        ASSERT_NE(firstStorage, &other.getDecoration(dd1));
+    }
+    ASSERT_EQ(3, numDestructedAs);
+}
+
+TEST(DecorableTest, SynchronizedStorageCacheKeepsUpToCapacity) {
+    DecorationRegistry<MyDecorable> registry;
+    const auto dd1 = registry.declareDecoration<A>();
+    DecorationStorageCache cache(2, true);
+
+    std::set<const void*> keptStorage;
+    {
+        DecorationContainer<MyDecorable> first(nullptr, &registry, &cache);
+        DecorationContainer<MyDecorable> second(nullptr, &registry, &cache);
+        DecorationContainer<MyDecorable> third(nullptr, &registry, &cache);
+        ASSERT_EQ(0U, cache.numSpares());
+
+        // Destroyed in reverse order, so the first container's storage does not fit.
+        keptStorage = {&second.getDecoration(dd1), &third.getDecoration(dd1)};
+    }
+    ASSERT_EQ(2U, cache.numSpares());
+
+    {
+        DecorationContainer<MyDecorable> first(nullptr, &registry, &cache);
+        DecorationContainer<MyDecorable> second(nullptr, &registry, &cache);
+        ASSERT_EQ(0U, cache.numSpares());
+        ASSERT(keptStorage ==
+               (std::set<const void*>{&first.getDecoration(dd1), &second.getDecoration(dd1)}));
+    }
+    ASSERT_EQ(2U, cache.numSpares());
+}
+
 #ifndef __s390x__
 // TODO(SERVER-34872) Re-enable this test, when we know that s390x will have correct exception
 // unwind handling.
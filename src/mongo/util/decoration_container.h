@@ -30,6 +30,9 @@
 
 #include <cstdint>
 #include <memory>
+#include <vector>
+
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -39,6 +42,68 @@ class DecorationRegistry;
 template <typename DecoratedType>
 class Decorable;
 
+template <typename DecoratedType>
+class DecorationContainer;
+
+/**
+ * Keeps the storage of destroyed DecorationContainers so that the next containers constructed
+ * with this cache reuse it rather than allocating. Containers sharing a cache must all decorate
+ * the same type.
+ *
+ * The default cache keeps the storage of one container, and its containers must be created and
+ * destroyed by one thread at a time. A cache created as 'synchronized' may be shared by
+ * containers created and destroyed concurrently, and keeps up to 'capacity' spare buffers.
+ */
+class DecorationStorageCache {
+    DecorationStorageCache(const DecorationStorageCache&) = delete;
+    DecorationStorageCache& operator=(const DecorationStorageCache&) = delete;
+
+public:
+    DecorationStorageCache() = default;
+
+    DecorationStorageCache(size_t capacity, bool synchronized)
+        : _capacity(capacity), _synchronized(synchronized) {}
+
+    /**
+     * Returns the number of spare buffers held.
+     */
+    size_t numSpares() const {
+        stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::defer_lock);
+        if (_synchronized)
+            lk.lock();
+        return _spares.size();
+    }
+
+private:
+    template <typename DecoratedType>
+    friend class DecorationContainer;
+
+    std::unique_ptr<unsigned char[]> _take() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::defer_lock);
+        if (_synchronized)
+            lk.lock();
+        if (_spares.empty())
+            return nullptr;
+        auto storage = std::move(_spares.back());
+        _spares.pop_back();
+        return storage;
+    }
+
+    void _put(std::unique_ptr<unsigned char[]> storage) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::defer_lock);
+        if (_synchronized)
+            lk.lock();
+        if (_spares.size() < _capacity)
+            _spares.push_back(std::move(storage));
+    }
+
+    const size_t _capacity = 1;
+    const bool _synchronized = false;
+
+    mutable stdx::mutex _mutex;
+    std::vector<std::unique_ptr<unsigned char[]>> _spares;
+};
+
 /**
  * An container for decorations.
  */
@@ -92,11 +157,21 @@ public:
      * The registry must stay in scope for the lifetime of the DecorationContainer, and must not
      * have any declareDecoration() calls made on it while a DecorationContainer dependent on it
      * is in scope.
+     *
+     * If 'storageCache' is given, the storage for the decorations is taken from and returned to it.
+     * Since decorations cannot be declared once a container exists, cached storage always has the
+     * right size.
      */
     explicit DecorationContainer(Decorable<DecoratedType>* const decorated,
-                                 const DecorationRegistry<DecoratedType>* const registry)
+                                 const DecorationRegistry<DecoratedType>* const registry,
+                                 DecorationStorageCache* const storageCache = nullptr)
         : _registry(registry),
-          _decorationData(new unsigned char[registry->getDecorationBufferSizeBytes()]) {
+          _storageCache(storageCache),
+          _decorationData(storageCache ? storageCache->_take() : nullptr) {
+        if (!_decorationData) {
+            _decorationData.reset(new unsigned char[registry->getDecorationBufferSizeBytes()]);
+        }
+
         // Because the decorations live in the externally allocated storage buffer at
         // `_decorationData`, there needs to be a way to get back from a known location within this
         // buffer to the type which owns those decorations.  We place a pointer to ourselves, a
@@ -110,6 +185,9 @@ public:
 
     ~DecorationContainer() {
         _registry->destroy(this);
+        if (_storageCache) {
+            _storageCache->_put(std::move(_decorationData));
+        }
     }
 
     /**
@@ -146,7 +224,8 @@ public:
 
 private:
     const DecorationRegistry<DecoratedType>* const _registry;
-    const std::unique_ptr<unsigned char[]> _decorationData;
+    DecorationStorageCache* const _storageCache;
+    std::unique_ptr<unsigned char[]> _decorationData;
 };
 
 }  // namespace mongo
@@ -30,6 +30,7 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/optional.hpp>
+#include <new>
 #include <type_traits>
 
 #include "mongo/base/checked_cast.h"
@@ -306,6 +307,95 @@ enum class SSBState : uint8_t {
     kFinished,  // This should stay last since we have code like assert(state < kFinished).
 };
 
+class SharedStateBase;
+
+/**
+ * Holds the callback of a SharedStateBase. Callbacks that fit in kInlineSize bytes are stored
+ * inline, so that attaching a continuation only allocates the SharedState it writes to. Since a
+ * SharedStateBase never moves, the callback is never moved or copied once it is set.
+ */
+class SSBCallback {
+public:
+    SSBCallback() = default;
+    SSBCallback(const SSBCallback&) = delete;
+    SSBCallback& operator=(const SSBCallback&) = delete;
+
+    ~SSBCallback() {
+        if (!_impl)
+            return;
+
+        if (_isInline) {
+            _impl->~Impl();
+        } else {
+            delete _impl;
+        }
+    }
+
+    /**
+     * Sets the callback. It may only be set once.
+     */
+    template <typename Func>
+    SSBCallback& operator=(Func&& func) {
+        using Specific = SpecificImpl<std::decay_t<Func>>;
+        invariant(!_impl);
+        emplace<Specific>(std::forward<Func>(func), FitsInline<Specific>{});
+        return *this;
+    }
+
+    explicit operator bool() const noexcept {
+        return _impl;
+    }
+
+    void operator()(SharedStateBase* input) noexcept {
+        _impl->call(input);
+    }
+
+private:
+    // Large enough for the continuations made by Future itself around a callback with a few
+    // captures.
+    enum : size_t { kInlineSize = 8 * sizeof(void*) };
+    using InlineBuffer = std::aligned_storage_t<kInlineSize>;
+
+    struct Impl {
+        virtual ~Impl() = default;
+        virtual void call(SharedStateBase* input) noexcept = 0;
+    };
+
+    template <typename Func>
+    struct SpecificImpl final : Impl {
+        template <typename F>
+        explicit SpecificImpl(F&& f) : func(std::forward<F>(f)) {}
+
+        void call(SharedStateBase* input) noexcept override {
+            func(input);
+        }
+
+        Func func;
+    };
+
+    // Chooses at compile time where a callback of type Specific is stored. This is the C++14
+    // spelling of an 'if constexpr', so that only the branch which applies is instantiated.
+    template <typename Specific>
+    using FitsInline = std::integral_constant<bool,
+                                              sizeof(Specific) <= kInlineSize &&
+                                                  alignof(Specific) <= alignof(InlineBuffer)>;
+
+    template <typename Specific, typename Func>
+    void emplace(Func&& func, std::true_type) {
+        _impl = new (&_buffer) Specific(std::forward<Func>(func));
+        _isInline = true;
+    }
+
+    template <typename Specific, typename Func>
+    void emplace(Func&& func, std::false_type) {
+        _impl = new Specific(std::forward<Func>(func));
+    }
+
+    Impl* _impl = nullptr;
+    bool _isInline = false;
+    InlineBuffer _buffer;
+};
+
 class SharedStateBase : public FutureRefCountable {
 public:
     SharedStateBase(const SharedStateBase&) = delete;
@@ -411,7 +501,7 @@ public:
     boost::intrusive_ptr<SharedStateBase> continuation;  // F
 
     // Takes this as argument and usually writes to continuation.
-    unique_function<void(SharedStateBase* input)> callback;  // F
+    SSBCallback callback;  // F
 
 
     // These are only used to signal completion to blocking waiters. Benchmarks showed that it was
@@ -725,8 +815,8 @@ public:
 
     static Future<T> makeReady(Status status) {
         invariant(!status.isOK());
-        auto out = Future<T>(make_intrusive<SharedState<T>>());
-        out._shared->setError(std::move(status));
+        Future out;
+        out._immediateError = std::move(status);
         return out;
     }
 
@@ -750,7 +840,8 @@ public:
      * timeouts, that is unnecessary if the Future is ready already.
      */
     bool isReady() const {
-        return _immediate || _shared->state.load(std::memory_order_acquire) == SSBState::kFinished;
+        return _immediate || _immediateError ||
+            _shared->state.load(std::memory_order_acquire) == SSBState::kFinished;
     }
 
     /**
@@ -759,7 +850,7 @@ public:
      * Throws if the interruptible passed is interrupted (explicitly or via deadline).
      */
     void wait(Interruptible* interruptible = Interruptible::notInterruptible()) const {
-        if (_immediate) {
+        if (_immediate || _immediateError) {
             return;
         }
 
@@ -773,7 +864,7 @@ public:
      */
     Status waitNoThrow(Interruptible* interruptible = Interruptible::notInterruptible()) const
         noexcept {
-        if (_immediate) {
+        if (_immediate || _immediateError) {
             return Status::OK();
         }
 
@@ -811,6 +902,9 @@ public:
         if (_immediate) {
             return std::move(*_immediate);
         }
+        if (_immediateError) {
+            return std::move(*_immediateError);
+        }
 
         try {
             _shared->wait(interruptible);
@@ -827,6 +921,9 @@ public:
         if (_immediate) {
             return *_immediate;
         }
+        if (_immediateError) {
+            return *_immediateError;
+        }
 
         try {
             _shared->wait(interruptible);
@@ -1043,7 +1140,7 @@ public:
                 (std::is_same<T, FakeVoid>::value && std::is_same<Result, Future<void>>::value),
             "func passed to Future<T>::onError must return T, StatusWith<T>, or Future<T>");
 
-        if (_immediate || (isReady() && _shared->status.isOK()))
+        if (_immediate || (!_immediateError && isReady() && _shared->status.isOK()))
             return std::move(*this);  // Avoid copy/moving func if we know we won't call it.
 
         // TODO in C++17 with constexpr if this can be done cleaner and more efficiently by not
@@ -1146,6 +1243,9 @@ private:
         if (_immediate) {
             return *_immediate;
         }
+        if (_immediateError) {
+            uassertStatusOK(*_immediateError);
+        }
 
         _shared->wait(interruptible);
         uassertStatusOK(_shared->status);
@@ -1159,6 +1259,9 @@ private:
         if (_immediate) {
             return success(std::move(*_immediate));
         }
+        if (_immediateError) {
+            return fail(std::move(*_immediateError));
+        }
 
         if (_shared->state.load(std::memory_order_acquire) == SSBState::kFinished) {
             if (_shared->status.isOK()) {
@@ -1260,8 +1363,10 @@ private:
 
     explicit Future(boost::intrusive_ptr<SharedState<T>> ptr) : _shared(std::move(ptr)) {}
 
-    // At most one of these will be active.
+    // At most one of these will be active. Ready Futures use _immediate or _immediateError so that
+    // chains of continuations on them never allocate.
     boost::optional<T> _immediate;
+    boost::optional<Status> _immediateError;
     boost::intrusive_ptr<SharedState<T>> _shared;
 };
 
@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <array>
 #include <benchmark/benchmark.h>
 
 #include "mongo/bson/inline_decls.h"
@@ -198,6 +199,53 @@ void BM_futureInt4xDeferredThenChained(benchmark::State& state) {
     }
 }
 
+void BM_futureIntReadyThenChain(benchmark::State& state) {
+    for (auto _ : state) {
+        auto fut = makeReadyFut();
+        for (int i = 0; i < state.range(0); ++i) {
+            fut = std::move(fut).then([](int i) { return i + 1; });
+        }
+        benchmark::DoNotOptimize(std::move(fut).get());
+    }
+}
+
+void BM_futureIntReadyErrorThenChain(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        auto fut = Future<int>::makeReady(Status(ErrorCodes::BadValue, "error"));
+        for (int i = 0; i < state.range(0); ++i) {
+            fut = std::move(fut).then([](int i) { return i + 1; });
+        }
+        benchmark::DoNotOptimize(std::move(fut).getNoThrow());
+    }
+}
+
+void BM_futureIntDeferredThenChain(benchmark::State& state) {
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        auto pf = makePromiseFuture<int>();
+        auto fut = std::move(pf.future);
+        for (int i = 0; i < state.range(0); ++i) {
+            fut = std::move(fut).then([](int i) { return i + 1; });
+        }
+        pf.promise.emplaceValue(1);
+        benchmark::DoNotOptimize(std::move(fut).get());
+    }
+}
+
+void BM_futureIntDeferredThenChainLargeCapture(benchmark::State& state) {
+    std::array<int, 32> big{};
+    for (auto _ : state) {
+        benchmark::ClobberMemory();
+        auto pf = makePromiseFuture<int>();
+        auto fut = std::move(pf.future);
+        for (int i = 0; i < state.range(0); ++i) {
+            fut = std::move(fut).then([big](int i) { return i + big[0]; });
+        }
+        pf.promise.emplaceValue(1);
+        benchmark::DoNotOptimize(std::move(fut).get());
+    }
+}
 
 BENCHMARK(BM_plainIntReady);
 BENCHMARK(BM_futureIntReady);
@@ -212,5 +260,9 @@ BENCHMARK(BM_futureInt3xDeferredThenNested);
 BENCHMARK(BM_futureInt3xDeferredThenChained);
 BENCHMARK(BM_futureInt4xDeferredThenNested);
 BENCHMARK(BM_futureInt4xDeferredThenChained);
+BENCHMARK(BM_futureIntReadyThenChain)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_futureIntReadyErrorThenChain)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_futureIntDeferredThenChain)->Arg(1)->Arg(4)->Arg(16);
+BENCHMARK(BM_futureIntDeferredThenChainLargeCapture)->Arg(1)->Arg(4)->Arg(16);
 
 }  // namespace mongo
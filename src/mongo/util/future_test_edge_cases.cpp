@@ -30,6 +30,9 @@
 
 #include "mongo/util/future.h"
 
+#include <array>
+#include <numeric>
+
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/death_test.h"
 #include "mongo/unittest/unittest.h"
@@ -69,6 +72,36 @@ TEST(Future_EdgeCases, looping_onError_with_then) {
     ASSERT_EQ(read().then([](int x) { return x + 0.5; }).get(), 0.5);
 }
 
+// Continuations whose captures are too large to be stored inline in the SharedState must still be
+// run and destroyed correctly.
+TEST(Future_EdgeCases, continuation_with_large_captures) {
+    auto pf = makePromiseFuture<int>();
+    std::array<int, 64> big;
+    big.fill(1);
+    auto shared = std::make_shared<int>(0);
+    auto fut = std::move(pf.future).then([big, shared](int i) {
+        return std::accumulate(big.begin(), big.end(), i) + *shared;
+    });
+    ASSERT_EQ(shared.use_count(), 2);
+    pf.promise.emplaceValue(1);
+    ASSERT_EQ(std::move(fut).get(), 65);
+}
+
+// A ready error skips every callback but the last and must keep its status down the chain.
+TEST(Future_EdgeCases, ready_error_through_long_chain) {
+    auto fut = Future<int>::makeReady(Status(ErrorCodes::BadValue, "oh no!"));
+    for (int i = 0; i < 10; ++i) {
+        fut = std::move(fut).then([](int i) { return i + 1; });
+    }
+    ASSERT_TRUE(fut.isReady());
+    ASSERT_EQ(fut.getNoThrow().getStatus(), ErrorCodes::BadValue);
+    auto recovered = std::move(fut).onError([](Status s) {
+        ASSERT_EQ(s, ErrorCodes::BadValue);
+        return 0;
+    });
+    ASSERT_EQ(std::move(recovered).get(), 0);
+}
+
 // Make sure we actually die if someone throws from the getAsync callback.
 //
 // With gcc 5.8 we terminate, but print "terminate() called. No exception is active". This works in
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/hardware_counters.h"
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// The counters are opened with a system call which security policies may audit or forbid, and the
+// FTDC ones count every thread of the process from startup, so they are only used if asked for.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(hardwareCountersEnabled, bool, false);
+
+}  // namespace
+
+HardwareCounters::Values HardwareCounters::Values::operator-(const Values& other) const {
+    Values diff;
+    diff.instructions = instructions - other.instructions;
+    diff.cycles = cycles - other.cycles;
+    diff.cacheMisses = cacheMisses - other.cacheMisses;
+    diff.branchMisses = branchMisses - other.branchMisses;
+    return diff;
+}
+
+void HardwareCounters::Values::append(BSONObjBuilder* builder) const {
+    builder->append("instructions", instructions);
+    builder->append("cycles", cycles);
+    builder->append("cacheMisses", cacheMisses);
+    builder->append("branchMisses", branchMisses);
+}
+
+HardwareCounters::HardwareCounters(const std::array<int, 4>& fds) : _fds(fds) {}
+
+#if defined(__linux__)
+
+namespace {
+
+// In the order of the members of HardwareCounters::Values.
+const std::array<std::uint64_t, 4> kEvents{PERF_COUNT_HW_INSTRUCTIONS,
+                                           PERF_COUNT_HW_CPU_CYCLES,
+                                           PERF_COUNT_HW_CACHE_MISSES,
+                                           PERF_COUNT_HW_BRANCH_MISSES};
+
+int openEvent(std::uint64_t event, HardwareCounters::Scope scope) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = event;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.inherit = scope == HardwareCounters::Scope::kThreadAndDescendants;
+
+    // The calling thread, on any cpu.
+    return syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+}
+
+long long readEvent(int fd) {
+    std::uint64_t values[3];  // value, time enabled, time running
+    if (::read(fd, values, sizeof(values)) != sizeof(values) || values[2] == 0) {
+        return 0;
+    }
+
+    if (values[2] < values[1]) {
+        return static_cast<long long>(static_cast<double>(values[0]) * values[1] / values[2]);
+    }
+    return static_cast<long long>(values[0]);
+}
+
+}  // namespace
+
+StatusWith<std::unique_ptr<HardwareCounters>> HardwareCounters::open(Scope scope) {
+    if (!hardwareCountersEnabled) {
+        return {ErrorCodes::IllegalOperation,
+                "Hardware performance counters are disabled; start the server with "
+                "--setParameter hardwareCountersEnabled=true to enable them"};
+    }
+
+    std::array<int, 4> fds;
+    for (size_t i = 0; i < kEvents.size(); ++i) {
+        fds[i] = openEvent(kEvents[i], scope);
+        if (fds[i] < 0) {
+            const auto error = errnoWithDescription();
+            for (size_t j = 0; j < i; ++j) {
+                close(fds[j]);
+            }
+            return {ErrorCodes::IllegalOperation,
+                    str::stream() << "Hardware performance counters are not available: "
+                                  << error};
+        }
+    }
+
+    return std::unique_ptr<HardwareCounters>(new HardwareCounters(fds));
+}
+
+HardwareCounters::~HardwareCounters() {
+    for (auto fd : _fds) {
+        close(fd);
+    }
+}
+
+HardwareCounters::Values HardwareCounters::read() const {
+    Values values;
+    values.instructions = readEvent(_fds[0]);
+    values.cycles = readEvent(_fds[1]);
+    values.cacheMisses = readEvent(_fds[2]);
+    values.branchMisses = readEvent(_fds[3]);
+    return values;
+}
+
+#else
+
+StatusWith<std::unique_ptr<HardwareCounters>> HardwareCounters::open(Scope scope) {
+    return {ErrorCodes::IllegalOperation,
+            "Hardware performance counters are only supported on Linux"};
+}
+
+HardwareCounters::~HardwareCounters() = default;
+
+HardwareCounters::Values HardwareCounters::read() const {
+    return Values();
+}
+
+#endif
+
+}  // namespace mongo
@@ -0,0 +1,96 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A set of hardware performance counters (instructions, cycles, last level cache misses and
+ * branch misses) read through perf_event_open(2). Only user space is counted, which does not need
+ * more privileges than the default perf_event_paranoid setting allows.
+ *
+ * Only supported on Linux, on hosts which expose the counters to the process. Virtual machines and
+ * containers commonly do not. Disabled unless the hardwareCountersEnabled startup parameter is set.
+ */
+class HardwareCounters {
+    MONGO_DISALLOW_COPYING(HardwareCounters);
+
+public:
+    enum class Scope {
+        // Counts the calling thread.
+        kThread,
+
+        // Counts the calling thread and every thread it, or a thread counted, starts afterwards.
+        kThreadAndDescendants,
+    };
+
+    struct Values {
+        long long instructions = 0;
+        long long cycles = 0;
+        long long cacheMisses = 0;
+        long long branchMisses = 0;
+
+        Values operator-(const Values& other) const;
+
+        /**
+         * Appends the counts, as integers so that FTDC can store them.
+         */
+        void append(BSONObjBuilder* builder) const;
+    };
+
+    /**
+     * Opens and starts the counters. Returns IllegalOperation when the counters are disabled or
+     * not available.
+     */
+    static StatusWith<std::unique_ptr<HardwareCounters>> open(Scope scope);
+
+    ~HardwareCounters();
+
+    /**
+     * Returns the counts since open(). Counts are scaled up when the kernel had to multiplex the
+     * counters with other users of the performance monitoring unit.
+     */
+    Values read() const;
+
+private:
+    explicit HardwareCounters(const std::array<int, 4>& fds);
+
+    const std::array<int, 4> _fds;
+};
+
+}  // namespace mongo
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/hardware_counters.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+void setHardwareCountersEnabled(bool enabled) {
+    auto param = ServerParameterSet::getGlobal()->getMap().find("hardwareCountersEnabled")->second;
+    ASSERT_OK(param->setFromString(enabled ? "true" : "false"));
+}
+
+/**
+ * Most virtual machines and containers do not expose the counters, in which case open() must fail
+ * cleanly rather than return counters which read as zero.
+ */
+std::unique_ptr<HardwareCounters> openOrSkip(HardwareCounters::Scope scope) {
+    setHardwareCountersEnabled(true);
+    ON_BLOCK_EXIT([] { setHardwareCountersEnabled(false); });
+    auto swCounters = HardwareCounters::open(scope);
+    if (!swCounters.isOK()) {
+        ASSERT_EQ(swCounters.getStatus(), ErrorCodes::IllegalOperation);
+        return nullptr;
+    }
+    return std::move(swCounters.getValue());
+}
+
+TEST(HardwareCountersTest, DisabledByDefault) {
+    for (auto scope :
+         {HardwareCounters::Scope::kThread, HardwareCounters::Scope::kThreadAndDescendants}) {
+        ASSERT_EQ(HardwareCounters::open(scope).getStatus(), ErrorCodes::IllegalOperation);
+    }
+}
+
+TEST(HardwareCountersTest, CountsTheWorkOfTheThread) {
+    auto counters = openOrSkip(HardwareCounters::Scope::kThread);
+    if (!counters) {
+        return;
+    }
+
+    const auto before = counters->read();
+    volatile unsigned long long sum = 0;
+    for (int i = 0; i < 1000 * 1000; ++i) {
+        sum = sum + i;
+    }
+    const auto diff = counters->read() - before;
+
+    ASSERT_GT(diff.instructions, 1000 * 1000);
+    ASSERT_GT(diff.cycles, 0);
+    ASSERT_GTE(diff.cacheMisses, 0);
+    ASSERT_GTE(diff.branchMisses, 0);
+}
+
+TEST(HardwareCountersTest, ValuesSubtractAndAppend) {
+    HardwareCounters::Values later;
+    later.instructions = 100;
+    later.cycles = 50;
+    later.cacheMisses = 7;
+    later.branchMisses = 3;
+
+    HardwareCounters::Values earlier;
+    earlier.instructions = 40;
+    earlier.cycles = 20;
+    earlier.cacheMisses = 2;
+    earlier.branchMisses = 1;
+
+    BSONObjBuilder builder;
+    (later - earlier).append(&builder);
+    ASSERT_BSONOBJ_EQ(builder.obj(),
+                      BSON("instructions" << 60LL << "cycles" << 30LL << "cacheMisses" << 5LL
+                                          << "branchMisses"
+                                          << 2LL));
+}
+
+}  // namespace
+}  // namespace mongo
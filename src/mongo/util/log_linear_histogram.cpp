@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/log_linear_histogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+LogLinearHistogram::LogLinearHistogram(int significantDigits) {
+    invariant(significantDigits >= 1 && significantDigits <= 3);
+
+    const auto largestSingleUnitBucket =
+        2 * static_cast<uint64_t>(std::pow(10, significantDigits)) - 1;
+    _subBucketCountMagnitude = 64 - countLeadingZeros64(largestSingleUnitBucket);
+    _subBucketHalfCountMagnitude = _subBucketCountMagnitude - 1;
+    _subBucketHalfCount = 1ULL << _subBucketHalfCountMagnitude;
+    _subBucketMask = (1ULL << _subBucketCountMagnitude) - 1;
+
+    size_t bucketsNeeded = 1;
+    for (uint64_t smallestUntrackable = _subBucketMask + 1;
+         smallestUntrackable <= kMaxTrackableValue;
+         smallestUntrackable <<= 1) {
+        ++bucketsNeeded;
+    }
+    _numBuckets = (bucketsNeeded + 1) * _subBucketHalfCount;
+}
+
+void LogLinearHistogram::increment(uint64_t value) {
+    if (_buckets.empty()) {
+        _buckets.resize(_numBuckets);
+    }
+    ++_buckets[_getBucket(value)];
+    ++_count;
+    _max = std::max(_max, value);
+}
+
+void LogLinearHistogram::merge(const LogLinearHistogram& other) {
+    invariant(other._numBuckets == _numBuckets);
+    if (other._buckets.empty()) {
+        return;
+    }
+    if (_buckets.empty()) {
+        _buckets.resize(_numBuckets);
+    }
+    for (size_t i = 0; i < _numBuckets; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+    _count += other._count;
+    _max = std::max(_max, other._max);
+}
+
+uint64_t LogLinearHistogram::getPercentile(double percentile) const {
+    if (_count == 0) {
+        return 0;
+    }
+
+    const auto rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percentile / 100 * _count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < _buckets.size(); ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            return std::min(_getBucketUpperBound(i), _max);
+        }
+    }
+    return _max;
+}
+
+// The bucket is found from the position of the highest set bit of the value, and the sub-bucket
+// from the bits just below it.
+size_t LogLinearHistogram::_getBucket(uint64_t value) const {
+    value = std::min(value, kMaxTrackableValue);
+
+    const int pow2Ceiling = 64 - countLeadingZeros64(value | _subBucketMask);
+    const int bucket = pow2Ceiling - _subBucketCountMagnitude;
+    const uint64_t subBucket = value >> bucket;
+    return ((static_cast<size_t>(bucket) + 1) << _subBucketHalfCountMagnitude) +
+        (subBucket - _subBucketHalfCount);
+}
+
+uint64_t LogLinearHistogram::_getBucketUpperBound(size_t index) const {
+    int bucket = static_cast<int>(index >> _subBucketHalfCountMagnitude) - 1;
+    uint64_t subBucket = (index & (_subBucketHalfCount - 1)) + _subBucketHalfCount;
+    if (bucket < 0) {
+        subBucket -= _subBucketHalfCount;
+        bucket = 0;
+    }
+    return (subBucket << bucket) + (1ULL << bucket) - 1;
+}
+
+}  // namespace mongo
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace mongo {
+
+/**
+ * Counts values in log-linear buckets, laid out like those of HdrHistogram, from which percentiles
+ * are estimated. Every value below 2^subBucketCountMagnitude has a bucket of its own. Above that,
+ * each power of two is split into 2^(subBucketCountMagnitude - 1) buckets of equal width, so that
+ * a bucket is never wider than 10^-d of the values in it, with d the number of significant digits.
+ * Every added digit makes the histogram about eight times larger.
+ *
+ * The buckets are allocated by the first increment(), so an unused histogram stays small.
+ *
+ * Not thread safe.
+ */
+class LogLinearHistogram {
+public:
+    // Values above this, which is about 19 hours in microseconds, are counted in the last bucket.
+    static const uint64_t kMaxTrackableValue = (1ULL << 36) - 1;
+
+    /**
+     * 'significantDigits' must be between 1 and 3.
+     */
+    explicit LogLinearHistogram(int significantDigits);
+
+    /**
+     * Counts one occurrence of 'value'.
+     */
+    void increment(uint64_t value);
+
+    /**
+     * Adds the counts of 'other', which must have the same number of significant digits, to this
+     * histogram.
+     */
+    void merge(const LogLinearHistogram& other);
+
+    /**
+     * Returns the number of values counted.
+     */
+    uint64_t getCount() const {
+        return _count;
+    }
+
+    /**
+     * Returns the largest value counted, or 0 if none were.
+     */
+    uint64_t getMax() const {
+        return _max;
+    }
+
+    /**
+     * Returns the smallest value such that at least 'percentile' percent of the values counted are
+     * no larger than it, within the resolution of the buckets. Returns 0 if no values were counted.
+     */
+    uint64_t getPercentile(double percentile) const;
+
+private:
+    size_t _getBucket(uint64_t value) const;
+
+    uint64_t _getBucketUpperBound(size_t bucket) const;
+
+    int _subBucketCountMagnitude;
+    int _subBucketHalfCountMagnitude;
+    uint64_t _subBucketHalfCount;
+    uint64_t _subBucketMask;
+    size_t _numBuckets;
+
+    std::vector<uint64_t> _buckets;
+    uint64_t _count = 0;
+    uint64_t _max = 0;
+};
+
+}  // namespace mongo
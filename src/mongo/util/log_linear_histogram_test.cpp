@@ -0,0 +1,116 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/log_linear_histogram.h"
+
+#include <cmath>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(LogLinearHistogramTest, EmptyHistogram) {
+    LogLinearHistogram hist(2);
+    ASSERT_EQ(hist.getCount(), 0U);
+    ASSERT_EQ(hist.getMax(), 0U);
+    ASSERT_EQ(hist.getPercentile(50), 0U);
+}
+
+TEST(LogLinearHistogramTest, PercentilesAreWithinTheResolution) {
+    for (int digits : {1, 2, 3}) {
+        LogLinearHistogram hist(digits);
+
+        // One occurrence of each value from 1 to 100000.
+        for (uint64_t value = 1; value <= 100000; ++value) {
+            hist.increment(value);
+        }
+        ASSERT_EQ(hist.getCount(), 100000U);
+        ASSERT_EQ(hist.getMax(), 100000U);
+
+        const double resolution = std::pow(10, -digits);
+        for (double percentile : {1.0, 50.0, 90.0, 99.0, 99.9}) {
+            const double exact = percentile * 1000;
+            const auto estimate = static_cast<double>(hist.getPercentile(percentile));
+            ASSERT_GTE(estimate, exact) << digits << " digits, p" << percentile;
+            ASSERT_LTE(estimate, exact * (1 + resolution)) << digits << " digits, p" << percentile;
+        }
+        ASSERT_EQ(hist.getPercentile(100), 100000U);
+    }
+}
+
+TEST(LogLinearHistogramTest, SmallValuesAreExact) {
+    LogLinearHistogram hist(2);
+    for (uint64_t value = 0; value < 100; ++value) {
+        hist.increment(value);
+    }
+    ASSERT_EQ(hist.getPercentile(1), 0U);
+    ASSERT_EQ(hist.getPercentile(50), 49U);
+    ASSERT_EQ(hist.getPercentile(100), 99U);
+}
+
+TEST(LogLinearHistogramTest, OutliersAreCappedAtTheMax) {
+    LogLinearHistogram hist(1);
+    for (int i = 0; i < 999; ++i) {
+        hist.increment(100);
+    }
+    hist.increment(5000000);
+
+    ASSERT_LTE(hist.getPercentile(99), 110U);
+    ASSERT_EQ(hist.getPercentile(99.95), 5000000U);
+}
+
+TEST(LogLinearHistogramTest, ValuesAboveTheTrackableRangeShareTheLastBucket) {
+    LogLinearHistogram hist(1);
+    hist.increment(LogLinearHistogram::kMaxTrackableValue * 4);
+    ASSERT_EQ(hist.getMax(), LogLinearHistogram::kMaxTrackableValue * 4);
+    ASSERT_EQ(hist.getPercentile(50), LogLinearHistogram::kMaxTrackableValue);
+}
+
+TEST(LogLinearHistogramTest, MergeAddsCounts) {
+    LogLinearHistogram fast(2), slow(2), empty(2);
+    for (int i = 0; i < 50; ++i) {
+        fast.increment(10);
+        slow.increment(1000);
+    }
+
+    LogLinearHistogram merged(2);
+    merged.merge(fast);
+    merged.merge(slow);
+    merged.merge(empty);
+    ASSERT_EQ(merged.getCount(), 100U);
+    ASSERT_EQ(merged.getMax(), 1000U);
+    ASSERT_EQ(merged.getPercentile(50), 10U);
+    ASSERT_EQ(merged.getPercentile(51), 1000U);
+}
+
+}  // namespace
+}  // namespace mongo
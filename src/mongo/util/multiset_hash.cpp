@@ -0,0 +1,59 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/multiset_hash.h"
+
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+#include "mongo/base/data_cursor.h"
+#include "mongo/util/hex.h"
+
+namespace mongo {
+
+void MultisetHash::add(const void* data, size_t len) {
+    uint64_t words[2];
+    MurmurHash3_x64_128(data, static_cast<int>(len), 0, words);
+    _addWords(words[0], words[1]);
+}
+
+void MultisetHash::combine(const MultisetHash& other) {
+    _addWords(other._low, other._high);
+}
+
+std::string MultisetHash::toString() const {
+    char buf[16];
+    DataCursor cursor(buf);
+    cursor.writeAndAdvance<BigEndian<uint64_t>>(_high);
+    cursor.writeAndAdvance<BigEndian<uint64_t>>(_low);
+    return toHexLower(buf, sizeof(buf));
+}
+
+}  // namespace mongo
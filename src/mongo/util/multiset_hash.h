@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace mongo {
+
+/**
+ * A 128-bit hash of a multiset of byte strings that does not depend on the order in which the
+ * elements are added. Each element is hashed with MurmurHash3_x64_128 and the element hashes are
+ * summed modulo 2^128, so hashes built over disjoint parts of a set, for example over ranges of a
+ * collection hashed by different threads, can be combined into the hash of the whole set.
+ *
+ * This is not a cryptographic hash. It is meant for cheaply detecting accidental divergence, such
+ * as between the members of a replica set.
+ */
+class MultisetHash {
+public:
+    /**
+     * Adds one element to the set.
+     */
+    void add(const void* data, size_t len);
+
+    /**
+     * Adds all of the elements of 'other' to this set.
+     */
+    void combine(const MultisetHash& other);
+
+    /**
+     * Returns the hash as 32 lowercase hex digits, the same shape as an MD5 digest string.
+     */
+    std::string toString() const;
+
+    bool operator==(const MultisetHash& other) const {
+        return _low == other._low && _high == other._high;
+    }
+
+    bool operator!=(const MultisetHash& other) const {
+        return !(*this == other);
+    }
+
+private:
+    void _addWords(uint64_t low, uint64_t high) {
+        _low += low;
+        _high += high + (_low < low ? 1 : 0);
+    }
+
+    uint64_t _low = 0;
+    uint64_t _high = 0;
+};
+
+}  // namespace mongo
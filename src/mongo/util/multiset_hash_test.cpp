@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/string_data.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/multiset_hash.h"
+
+namespace mongo {
+namespace {
+
+void addString(MultisetHash* hash, StringData str) {
+    hash->add(str.rawData(), str.size());
+}
+
+TEST(MultisetHashTest, EmptyHashIsZero) {
+    ASSERT_EQ(MultisetHash().toString(), std::string(32, '0'));
+}
+
+TEST(MultisetHashTest, OrderDoesNotMatter) {
+    MultisetHash forward;
+    MultisetHash backward;
+    for (auto str : {"a", "bb", "ccc"}) {
+        addString(&forward, str);
+    }
+    for (auto str : {"ccc", "bb", "a"}) {
+        addString(&backward, str);
+    }
+    ASSERT(forward == backward);
+    ASSERT_EQ(forward.toString(), backward.toString());
+}
+
+TEST(MultisetHashTest, ContentsMatter) {
+    MultisetHash first;
+    MultisetHash second;
+    addString(&first, "a");
+    addString(&second, "b");
+    ASSERT(first != second);
+
+    // Duplicates are counted.
+    MultisetHash once;
+    MultisetHash twice;
+    addString(&once, "a");
+    addString(&twice, "a");
+    addString(&twice, "a");
+    ASSERT(once != twice);
+}
+
+TEST(MultisetHashTest, CombinedPartsMatchWhole) {
+    MultisetHash whole;
+    MultisetHash left;
+    MultisetHash right;
+    for (int i = 0; i < 1000; ++i) {
+        whole.add(&i, sizeof(i));
+        (i % 3 ? left : right).add(&i, sizeof(i));
+    }
+    ASSERT(left != whole);
+
+    right.combine(left);
+    ASSERT(right == whole);
+}
+
+TEST(MultisetHashTest, SumCarriesIntoHighWord) {
+    // Many element hashes have their top low-word bit set, so the sum of enough of them must
+    // carry. Check that the combined hash still does not depend on how the set was split.
+    MultisetHash whole;
+    MultisetHash halves[2];
+    for (int i = 0; i < 10000; ++i) {
+        whole.add(&i, sizeof(i));
+        halves[i < 5000].add(&i, sizeof(i));
+    }
+    halves[0].combine(halves[1]);
+    ASSERT_EQ(halves[0].toString(), whole.toString());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,249 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa_placement.h"
+
+#include <algorithm>
+#include <boost/filesystem.hpp>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(numaAwareThreadPlacement, bool, false);
+
+const char kNodeDirectory[] = "/sys/devices/system/node";
+
+const char* const kRoleNames[] = {"serviceWorkers", "replWriters"};
+static_assert(sizeof(kRoleNames) / sizeof(kRoleNames[0]) ==
+                  static_cast<size_t>(NumaPlacement::ThreadRole::kNumRoles),
+              "kRoleNames must have a name for every ThreadRole");
+
+std::string readFile(const std::string& path) {
+    std::ifstream in(path);
+    return std::string(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+/**
+ * Reads the nodes and their CPUs from sysfs. Returns no nodes if the topology is not available.
+ */
+std::vector<NumaPlacement::Node> readTopology() {
+    std::vector<NumaPlacement::Node> nodes;
+
+    try {
+        boost::filesystem::path nodeDirectory(kNodeDirectory);
+        if (!boost::filesystem::is_directory(nodeDirectory))
+            return nodes;
+
+        for (boost::filesystem::directory_iterator it(nodeDirectory), end; it != end; ++it) {
+            const std::string name = it->path().filename().string();
+            if (name.size() <= 4 || name.compare(0, 4, "node") != 0 ||
+                name.find_first_not_of("0123456789", 4) != std::string::npos)
+                continue;
+
+            auto cpus = NumaPlacement::parseCpuList(readFile((it->path() / "cpulist").string()));
+            if (!cpus.isOK()) {
+                warning() << "Failed to read the CPUs of NUMA " << name << ": " << cpus.getStatus();
+                return {};
+            }
+
+            // Memory-only nodes have no CPUs to place threads on
+            if (cpus.getValue().empty())
+                continue;
+
+            nodes.push_back({std::stoi(name.substr(4)), std::move(cpus.getValue())});
+        }
+    } catch (const boost::filesystem::filesystem_error& e) {
+        warning() << "Failed to read the NUMA topology from " << kNodeDirectory << ": "
+                  << e.code().message();
+        return {};
+    }
+
+    std::sort(nodes.begin(), nodes.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.id < rhs.id;
+    });
+    return nodes;
+}
+
+/**
+ * Appends the total and free memory of a node, in kB, from its sysfs meminfo file.
+ */
+void appendNodeMemory(int nodeId, BSONObjBuilder* builder) {
+    std::ifstream in(str::stream() << kNodeDirectory << "/node" << nodeId << "/meminfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        // Lines look like "Node 0 MemTotal:       32827148 kB"
+        for (auto field : {"MemTotal:", "MemFree:"}) {
+            const auto pos = line.find(field);
+            if (pos == std::string::npos)
+                continue;
+
+            const std::string value = line.substr(pos + strlen(field));
+            try {
+                builder->append(StringData(field, strlen(field) - 1) + "KB",
+                                std::stoll(value));
+            } catch (const std::exception&) {
+            }
+        }
+    }
+}
+
+}  // namespace
+
+NumaPlacement& NumaPlacement::get() {
+    static NumaPlacement* const instance = new NumaPlacement(readTopology());
+    return *instance;
+}
+
+StatusWith<std::vector<int>> NumaPlacement::parseCpuList(StringData cpuList) {
+    std::vector<int> cpus;
+
+    const auto parseCpu = [](StringData str) -> StatusWith<int> {
+        if (str.empty() || str.size() > 6 ||
+            str.toString().find_first_not_of("0123456789") != std::string::npos) {
+            return {ErrorCodes::FailedToParse, str::stream() << "Invalid CPU '" << str << "'"};
+        }
+        return std::stoi(str.toString());
+    };
+
+    // The list ends with a newline when read from sysfs
+    while (!cpuList.empty() && std::isspace(cpuList[cpuList.size() - 1]))
+        cpuList = cpuList.substr(0, cpuList.size() - 1);
+
+    while (!cpuList.empty()) {
+        const size_t comma = cpuList.find(',');
+        const StringData range = cpuList.substr(0, comma);
+        cpuList = comma == std::string::npos ? StringData() : cpuList.substr(comma + 1);
+
+        const size_t dash = range.find('-');
+        auto first = parseCpu(range.substr(0, dash));
+        if (!first.isOK())
+            return first.getStatus();
+
+        auto last = dash == std::string::npos ? first : parseCpu(range.substr(dash + 1));
+        if (!last.isOK())
+            return last.getStatus();
+
+        if (last.getValue() < first.getValue()) {
+            return {ErrorCodes::FailedToParse,
+                    str::stream() << "Invalid CPU range '" << range << "'"};
+        }
+
+        for (int cpu = first.getValue(); cpu <= last.getValue(); ++cpu)
+            cpus.push_back(cpu);
+    }
+
+    return cpus;
+}
+
+NumaPlacement::NumaPlacement(std::vector<Node> nodes)
+    : _nodes(std::move(nodes)), _nodeStats(_nodes.size()) {}
+
+bool NumaPlacement::isEnabled() const {
+    return numaAwareThreadPlacement && _nodes.size() > 1;
+}
+
+size_t NumaPlacement::pickNode(ThreadRole role) {
+    invariant(!_nodes.empty());
+    return _nextNode[static_cast<size_t>(role)].fetchAndAdd(1) % _nodes.size();
+}
+
+void NumaPlacement::placeCurrentThread(ThreadRole role) {
+    if (!isEnabled())
+        return;
+
+#if defined(__linux__)
+    const size_t nodeIndex = pickNode(role);
+    const Node& node = _nodes[nodeIndex];
+
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu : node.cpus) {
+        if (cpu < CPU_SETSIZE)
+            CPU_SET(cpu, &cpus);
+    }
+
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+        const int savedErrno = errno;
+        _placementFailures.fetchAndAdd(1);
+        warning() << "Failed to restrict thread to the CPUs of NUMA node " << node.id << ": "
+                  << errnoWithDescription(savedErrno);
+        return;
+    }
+
+    // MPOL_PREFERRED with an empty node mask allocates on the node of the CPU the thread runs on.
+    // The value is spelled out to avoid depending on the libnuma headers.
+    const int kMpolPreferred = 1;
+    if (syscall(SYS_set_mempolicy, kMpolPreferred, nullptr, 0) != 0) {
+        const int savedErrno = errno;
+        _placementFailures.fetchAndAdd(1);
+        warning() << "Failed to set a local memory policy for a thread on NUMA node " << node.id
+                  << ": " << errnoWithDescription(savedErrno);
+    }
+
+    _nodeStats[nodeIndex].threadsPlaced[static_cast<size_t>(role)].fetchAndAdd(1);
+#endif
+}
+
+void NumaPlacement::appendStats(BSONObjBuilder* builder) const {
+    builder->append("enabled", isEnabled());
+    builder->append("placementFailures", _placementFailures.load());
+
+    BSONObjBuilder nodesBuilder(builder->subobjStart("nodes"));
+    for (size_t i = 0; i < _nodes.size(); ++i) {
+        BSONObjBuilder nodeBuilder(nodesBuilder.subobjStart(std::to_string(_nodes[i].id)));
+        nodeBuilder.append("cpus", static_cast<int>(_nodes[i].cpus.size()));
+        appendNodeMemory(_nodes[i].id, &nodeBuilder);
+
+        BSONObjBuilder threadsBuilder(nodeBuilder.subobjStart("threadsPlaced"));
+        for (size_t role = 0; role < kNumRoles; ++role) {
+            threadsBuilder.append(kRoleNames[role], _nodeStats[i].threadsPlaced[role].load());
+        }
+    }
+}
+
+}  // namespace mongo
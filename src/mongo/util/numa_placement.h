@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/base/status_with.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Places long lived worker threads on the NUMA nodes of the host, so that the memory they allocate
+ * for the sessions and operations they run stays local to the node they run on.
+ *
+ * Placement is enabled with the 'numaAwareThreadPlacement' startup parameter. A thread which asks
+ * to be placed is assigned a node round-robin among the threads of the same role, its CPU affinity
+ * is restricted to the CPUs of that node, and its memory policy is set to allocate locally, which
+ * overrides an interleaving policy the process was started with. The memory touched first by a
+ * placed thread, including its allocator's thread cache, therefore comes from its node.
+ *
+ * The topology is read from /sys/devices/system/node. On other platforms, or on hosts with a
+ * single node, placement is a no-op.
+ */
+class NumaPlacement {
+    MONGO_DISALLOW_COPYING(NumaPlacement);
+
+public:
+    /**
+     * The kinds of threads which are placed, counted separately in the statistics.
+     */
+    enum class ThreadRole { kServiceWorker, kReplWriter, kNumRoles };
+
+    struct Node {
+        int id;
+        std::vector<int> cpus;
+    };
+
+    /**
+     * Returns the process-wide instance, reading the topology on first use.
+     */
+    static NumaPlacement& get();
+
+    /**
+     * Parses a CPU list as found in /sys/devices/system/node/node<N>/cpulist, such as
+     * "0-3,8,10-11".
+     */
+    static StatusWith<std::vector<int>> parseCpuList(StringData cpuList);
+
+    explicit NumaPlacement(std::vector<Node> nodes);
+
+    /**
+     * Returns true if threads are placed on nodes: placement was requested and there is more than
+     * one node.
+     */
+    bool isEnabled() const;
+
+    const std::vector<Node>& getNodes() const {
+        return _nodes;
+    }
+
+    /**
+     * Returns the index in getNodes() of the node the next thread with 'role' will be placed on.
+     */
+    size_t pickNode(ThreadRole role);
+
+    /**
+     * Places the calling thread on a node, if enabled. Failing to set the affinity or memory policy
+     * is logged and leaves the thread unplaced.
+     */
+    void placeCurrentThread(ThreadRole role);
+
+    /**
+     * Appends the topology and per-node thread counts for serverStatus.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    static constexpr size_t kNumRoles = static_cast<size_t>(ThreadRole::kNumRoles);
+
+    struct NodeStats {
+        std::array<AtomicWord<long long>, kNumRoles> threadsPlaced;
+    };
+
+    const std::vector<Node> _nodes;
+    std::vector<NodeStats> _nodeStats;
+
+    std::array<AtomicWord<unsigned>, kNumRoles> _nextNode;
+    AtomicWord<long long> _placementFailures{0};
+};
+
+}  // namespace mongo
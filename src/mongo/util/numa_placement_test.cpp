@@ -0,0 +1,81 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa_placement.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(NumaPlacementTest, ParseCpuList) {
+    ASSERT(std::vector<int>({0, 1, 2, 3, 8, 10, 11}) ==
+           unittest::assertGet(NumaPlacement::parseCpuList("0-3,8,10-11\n")));
+    ASSERT(std::vector<int>({5}) == unittest::assertGet(NumaPlacement::parseCpuList("5")));
+    ASSERT(unittest::assertGet(NumaPlacement::parseCpuList("\n")).empty());
+}
+
+TEST(NumaPlacementTest, ParseInvalidCpuList) {
+    ASSERT_EQ(ErrorCodes::FailedToParse, NumaPlacement::parseCpuList("3-1").getStatus());
+    ASSERT_EQ(ErrorCodes::FailedToParse, NumaPlacement::parseCpuList("a-b").getStatus());
+    ASSERT_EQ(ErrorCodes::FailedToParse, NumaPlacement::parseCpuList("0,,1").getStatus());
+    ASSERT_EQ(ErrorCodes::FailedToParse, NumaPlacement::parseCpuList("-1").getStatus());
+}
+
+TEST(NumaPlacementTest, PickNodeRoundRobinPerRole) {
+    NumaPlacement placement({{0, {0, 1}}, {1, {2, 3}}});
+
+    ASSERT_EQ(0u, placement.pickNode(NumaPlacement::ThreadRole::kServiceWorker));
+    ASSERT_EQ(1u, placement.pickNode(NumaPlacement::ThreadRole::kServiceWorker));
+    ASSERT_EQ(0u, placement.pickNode(NumaPlacement::ThreadRole::kReplWriter));
+    ASSERT_EQ(0u, placement.pickNode(NumaPlacement::ThreadRole::kServiceWorker));
+    ASSERT_EQ(1u, placement.pickNode(NumaPlacement::ThreadRole::kReplWriter));
+}
+
+TEST(NumaPlacementTest, DisabledByDefault) {
+    NumaPlacement placement({{0, {0, 1}}, {1, {2, 3}}});
+    ASSERT_FALSE(placement.isEnabled());
+
+    // Placing a thread is a no-op and is not counted
+    placement.placeCurrentThread(NumaPlacement::ThreadRole::kServiceWorker);
+
+    BSONObjBuilder builder;
+    placement.appendStats(&builder);
+    const BSONObj stats = builder.obj();
+    ASSERT_FALSE(stats["enabled"].trueValue());
+    ASSERT_EQ(2, stats["nodes"].Obj().nFields());
+    ASSERT_EQ(2, stats["nodes"]["1"]["cpus"].numberInt());
+    ASSERT_EQ(0, stats["nodes"]["0"]["threadsPlaced"]["serviceWorkers"].numberInt());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,271 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_cpu_profiler.h"
+
+#ifndef _WIN32
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <sys/time.h>
+#endif
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/errno_util.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/stacktrace.h"
+
+namespace mongo {
+
+#ifndef _WIN32
+
+namespace {
+
+// Maximum number of frames recorded per sample.
+constexpr int kMaxFrames = 64;
+
+constexpr std::size_t kMaxThreadNameLength = 32;
+
+// About 12MB, only allocated while a profile runs. At 100 samples per second of CPU time this is
+// enough for a minute of profiling with the process keeping two cores busy.
+constexpr std::uint64_t kMaxSamples = 24 * 1024;
+
+struct Sample {
+    void* frames[kMaxFrames];
+    int numFrames;
+
+    // Index of the interrupted function's frame. The frames before it belong to the signal handler.
+    int firstFrame;
+    char threadName[kMaxThreadNameLength];
+};
+
+// Serializes start() and stop(), and guards 'running'.
+stdx::mutex profilerMutex;
+bool running = false;
+
+// State shared with the signal handler. 'samples' is only written to by the signal handler while
+// 'collecting' is true, and only read by stop() once no handler is running.
+std::unique_ptr<Sample[]> samples;
+AtomicBool collecting{false};
+AtomicUInt64 nextSample{0};
+AtomicInt64 droppedSamples{0};
+AtomicInt32 activeHandlers{0};
+
+/**
+ * Only does async-signal-safe work: getStackTraceAddresses() has been called once outside of the
+ * handler by start() so the unwinder is loaded, and getThreadNameIfSet() does not allocate.
+ */
+void handleSigprof(int) {
+    const int savedErrno = errno;
+    activeHandlers.fetchAndAdd(1);
+
+    if (collecting.load()) {
+        const auto index = nextSample.fetchAndAdd(1);
+        if (index < kMaxSamples) {
+            Sample& sample = samples[index];
+            sample.numFrames = getStackTraceAddresses(sample.frames, kMaxFrames);
+
+            // The handler returns into the signal trampoline, whose frame sits right above the
+            // interrupted function's. How many frames come before it depends on inlining.
+            void* const trampoline = __builtin_return_address(0);
+            sample.firstFrame = 0;
+            for (int i = 0; i < sample.numFrames; ++i) {
+                if (sample.frames[i] == trampoline) {
+                    sample.firstFrame = i + 1;
+                    break;
+                }
+            }
+
+            const auto threadName = getThreadNameIfSet();
+            const auto length = std::min(threadName.size(), kMaxThreadNameLength - 1);
+            std::memcpy(sample.threadName, threadName.rawData(), length);
+            sample.threadName[length] = '\0';
+        } else {
+            droppedSamples.fetchAndAdd(1);
+        }
+    }
+
+    activeHandlers.fetchAndSubtract(1);
+    errno = savedErrno;
+}
+
+/**
+ * Returns the demangled function name of 'address' without its parameters, or the address itself
+ * if it has no symbol. Results are cached in 'symbols', as most samples share most frames.
+ */
+const std::string& symbolize(void* address, std::map<void*, std::string>* symbols) {
+    auto it = symbols->find(address);
+    if (it != symbols->end()) {
+        return it->second;
+    }
+
+    std::string symbol;
+    Dl_info dli;
+    if (dladdr(address, &dli) && dli.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(dli.dli_sname, 0, 0, &status);
+        if (demangled) {
+            // strip off function parameters as they are very verbose and not useful
+            char* p = strchr(demangled, '(');
+            symbol = p ? std::string(demangled, p - demangled) : std::string(demangled);
+            free(demangled);
+        } else {
+            symbol = dli.dli_sname;
+        }
+    } else {
+        symbol = str::stream() << address;
+    }
+
+    return symbols->emplace(address, std::move(symbol)).first->second;
+}
+
+}  // namespace
+
+Status SamplingCpuProfiler::start(int samplesPerSecond) {
+    invariant(samplesPerSecond > 0 && samplesPerSecond <= 1000 * 1000);
+
+    stdx::lock_guard<stdx::mutex> lk(profilerMutex);
+    if (running) {
+        return {ErrorCodes::ConflictingOperationInProgress, "A CPU profile is already running"};
+    }
+
+    // Our handler is left installed once a profile stops, as restoring the default action would
+    // terminate the process on a SIGPROF still pending from the last interval.
+    struct sigaction current;
+    if (sigaction(SIGPROF, nullptr, &current) != 0) {
+        return {ErrorCodes::InternalError,
+                str::stream() << "Failed to read the SIGPROF action: " << errnoWithDescription()};
+    }
+    if (current.sa_handler != SIG_DFL && current.sa_handler != SIG_IGN &&
+        current.sa_handler != handleSigprof) {
+        return {ErrorCodes::IllegalOperation,
+                "SIGPROF is already in use, possibly by the gperftools CPU profiler"};
+    }
+
+    // Loads the unwinder, which the signal handler must not do itself.
+    void* frames[kMaxFrames];
+    if (getStackTraceAddresses(frames, kMaxFrames) == 0) {
+        return {ErrorCodes::IllegalOperation, "Stack traces are not supported on this platform"};
+    }
+
+    samples = stdx::make_unique<Sample[]>(kMaxSamples);
+    nextSample.store(0);
+    droppedSamples.store(0);
+    collecting.store(true);
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handleSigprof;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        collecting.store(false);
+        samples.reset();
+        return {ErrorCodes::InternalError,
+                str::stream() << "Failed to install the SIGPROF handler: "
+                              << errnoWithDescription()};
+    }
+
+    const long intervalMicros = std::max(1000L * 1000L / samplesPerSecond, 1L);
+    struct itimerval timer;
+    timer.it_interval.tv_sec = intervalMicros / (1000 * 1000);
+    timer.it_interval.tv_usec = intervalMicros % (1000 * 1000);
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        collecting.store(false);
+        samples.reset();
+        return {ErrorCodes::InternalError,
+                str::stream() << "Failed to start the profiling timer: " << errnoWithDescription()};
+    }
+
+    running = true;
+    return Status::OK();
+}
+
+SamplingCpuProfiler::Profile SamplingCpuProfiler::stop() {
+    stdx::lock_guard<stdx::mutex> lk(profilerMutex);
+    invariant(running);
+
+    struct itimerval disabled;
+    memset(&disabled, 0, sizeof(disabled));
+    setitimer(ITIMER_PROF, &disabled, nullptr);
+
+    // Wait for the handlers which saw 'collecting' set to finish writing their samples.
+    collecting.store(false);
+    while (activeHandlers.load() > 0) {
+        stdx::this_thread::yield();
+    }
+
+    Profile profile;
+    const auto numSamples = std::min<std::uint64_t>(nextSample.load(), kMaxSamples);
+    profile.samples = static_cast<long long>(numSamples);
+    profile.droppedSamples = droppedSamples.load();
+
+    std::map<void*, std::string> symbols;
+    for (std::uint64_t i = 0; i < numSamples; ++i) {
+        const Sample& sample = samples[i];
+
+        StringBuilder folded;
+        folded << (sample.threadName[0] ? StringData(sample.threadName) : "unnamed"_sd);
+        for (int j = sample.numFrames - 1; j >= sample.firstFrame; --j) {
+            folded << ';' << symbolize(sample.frames[j], &symbols);
+        }
+
+        ++profile.foldedStacks[folded.str()];
+    }
+
+    samples.reset();
+    running = false;
+    return profile;
+}
+
+#else
+
+Status SamplingCpuProfiler::start(int samplesPerSecond) {
+    return {ErrorCodes::IllegalOperation, "CPU profiling is not supported on Windows"};
+}
+
+SamplingCpuProfiler::Profile SamplingCpuProfiler::stop() {
+    MONGO_UNREACHABLE;
+}
+
+#endif
+
+}  // namespace mongo
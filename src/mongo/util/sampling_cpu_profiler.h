@@ -0,0 +1,75 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mongo/base/status.h"
+
+namespace mongo {
+
+/**
+ * A sampling profiler of the CPU time used by the whole process.
+ *
+ * While a profile runs, a SIGPROF interval timer interrupts the thread using the CPU
+ * 'samplesPerSecond' times per second of CPU time, and the signal handler records that thread's
+ * stack and name into a preallocated buffer. Stacks are only symbolized once the profile stops,
+ * and are reported in the "folded" format understood by flame graph tools:
+ *
+ *     threadName;outermostFrame;...;innermostFrame
+ *
+ * Only one profile may run at a time in the process. Not supported on Windows.
+ */
+class SamplingCpuProfiler {
+public:
+    struct Profile {
+        // Number of samples taken of each folded stack.
+        std::map<std::string, long long> foldedStacks;
+
+        // Number of samples recorded, and the number dropped because the sample buffer was full.
+        long long samples = 0;
+        long long droppedSamples = 0;
+    };
+
+    /**
+     * Starts profiling. Returns ConflictingOperationInProgress if a profile is already running,
+     * and IllegalOperation if SIGPROF is used by another profiler or stack traces are not
+     * supported on this platform.
+     */
+    static Status start(int samplesPerSecond);
+
+    /**
+     * Stops the running profile and returns the samples it took. A profile must be running.
+     */
+    static Profile stop();
+};
+
+}  // namespace mongo
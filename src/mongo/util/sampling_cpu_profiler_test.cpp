@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_cpu_profiler.h"
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Keeps a CPU busy for 'duration' of wall clock time.
+ */
+void spin(Milliseconds duration) {
+    const auto deadline = Date_t::now() + duration;
+    volatile unsigned long long counter = 0;
+    while (Date_t::now() < deadline) {
+        for (int i = 0; i < 1000; ++i) {
+            counter = counter + 1;
+        }
+    }
+}
+
+TEST(SamplingCpuProfilerTest, SamplesBusyThreads) {
+    ASSERT_OK(SamplingCpuProfiler::start(1000));
+
+    stdx::thread busyThread([] {
+        setThreadName("busyThread");
+        spin(Milliseconds(500));
+    });
+    busyThread.join();
+
+    auto profile = SamplingCpuProfiler::stop();
+    ASSERT_GT(profile.samples, 0);
+
+    long long busyThreadSamples = 0;
+    long long totalSamples = 0;
+    for (auto&& foldedStack : profile.foldedStacks) {
+        if (StringData(foldedStack.first).startsWith("busyThread;")) {
+            busyThreadSamples += foldedStack.second;
+        }
+        totalSamples += foldedStack.second;
+    }
+    ASSERT_GT(busyThreadSamples, 0);
+    ASSERT_EQ(totalSamples, profile.samples);
+}
+
+TEST(SamplingCpuProfilerTest, OnlyOneProfileRunsAtATime) {
+    ASSERT_OK(SamplingCpuProfiler::start(100));
+    ASSERT_EQ(SamplingCpuProfiler::start(100), ErrorCodes::ConflictingOperationInProgress);
+    SamplingCpuProfiler::stop();
+
+    // A new profile can start once the last one stopped.
+    ASSERT_OK(SamplingCpuProfiler::start(100));
+    spin(Milliseconds(50));
+    SamplingCpuProfiler::stop();
+}
+
+}  // namespace
+}  // namespace mongo
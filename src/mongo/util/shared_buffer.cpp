@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/shared_buffer.h"
+
+#include <array>
+
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+constexpr size_t SharedBuffer::kMinCacheableCapacity;
+constexpr size_t SharedBuffer::kMaxCacheableCapacity;
+constexpr long long SharedBuffer::kDefaultMaxCachedBytes;
+
+namespace {
+
+constexpr int kMinCacheableBits = 15;
+constexpr int kNumSizeClasses = 25 - kMinCacheableBits + 1;
+
+// Total bytes held across every thread's cache, so that many threads cannot pin unbounded memory.
+AtomicWord<long long> totalCachedBytes{0};
+AtomicWord<long long> maxCachedBytes{SharedBuffer::kDefaultMaxCachedBytes};
+
+/**
+ * One slot per power-of-two capacity. The destructor runs at thread exit and hands everything back
+ * to the allocator.
+ */
+class ThreadBufferCache {
+public:
+    ~ThreadBufferCache();
+
+    void*& slot(size_t capacity) {
+        return _slots[countTrailingZeros64(capacity) - kMinCacheableBits];
+    }
+
+    void clear();
+
+private:
+    std::array<void*, kNumSizeClasses> _slots{};
+};
+
+// Buffers may be released on a thread after its cache has been destroyed, for example by other
+// thread_local destructors. This flag has no destructor, so it stays readable until the thread's
+// storage is gone.
+thread_local bool threadBufferCacheDestroyed = false;
+thread_local ThreadBufferCache threadBufferCache;
+
+ThreadBufferCache::~ThreadBufferCache() {
+    clear();
+    threadBufferCacheDestroyed = true;
+}
+
+void ThreadBufferCache::clear() {
+    for (size_t i = 0; i < _slots.size(); ++i) {
+        if (_slots[i]) {
+            free(_slots[i]);
+            _slots[i] = nullptr;
+            totalCachedBytes.subtractAndFetch(static_cast<long long>(size_t{1}
+                                                                     << (i + kMinCacheableBits)));
+        }
+    }
+}
+
+}  // namespace
+
+void* SharedBuffer::takeCachedAllocation(size_t capacity) {
+    dassert(isCacheableCapacity(capacity));
+    if (threadBufferCacheDestroyed) {
+        return nullptr;
+    }
+
+    void*& slot = threadBufferCache.slot(capacity);
+    void* cached = slot;
+    if (cached) {
+        slot = nullptr;
+        totalCachedBytes.subtractAndFetch(static_cast<long long>(capacity));
+    }
+    return cached;
+}
+
+bool SharedBuffer::cacheAllocation(void* holderPrefixedData, size_t capacity) {
+    dassert(isCacheableCapacity(capacity));
+    if (threadBufferCacheDestroyed) {
+        return false;
+    }
+
+    void*& slot = threadBufferCache.slot(capacity);
+    if (slot) {
+        return false;
+    }
+
+    const auto bytes = static_cast<long long>(capacity);
+    if (totalCachedBytes.addAndFetch(bytes) > maxCachedBytes.load()) {
+        totalCachedBytes.subtractAndFetch(bytes);
+        return false;
+    }
+
+    slot = holderPrefixedData;
+    return true;
+}
+
+void SharedBuffer::releaseCachedAllocations() {
+    if (!threadBufferCacheDestroyed) {
+        threadBufferCache.clear();
+    }
+}
+
+void SharedBuffer::setMaxCachedBytes(long long bytes) {
+    maxCachedBytes.store(bytes);
+}
+
+long long SharedBuffer::getMaxCachedBytes() {
+    return maxCachedBytes.load();
+}
+
+}  // namespace mongo
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <boost/intrusive_ptr.hpp>
+#include <cstring>
 
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/allocator.h"
@@ -48,6 +50,11 @@ public:
     }
 
     static SharedBuffer allocate(size_t bytes) {
+        if (isCacheableCapacity(bytes)) {
+            if (void* cached = takeCachedAllocation(bytes)) {
+                return takeOwnership(cached, bytes);
+            }
+        }
         return takeOwnership(mongoMalloc(sizeof(Holder) + bytes), bytes);
     }
 
@@ -62,6 +69,18 @@ public:
     void realloc(size_t size) {
         invariant(!_holder || !_holder->isShared());
 
+        if (isCacheableCapacity(size) && capacity() != size) {
+            if (void* cached = takeCachedAllocation(size)) {
+                auto tmp = SharedBuffer::takeOwnership(cached, size);
+                if (_holder) {
+                    memcpy(tmp.get(), get(), std::min(capacity(), size));
+                }
+                // Releasing the old buffer may in turn return it to the cache.
+                swap(tmp);
+                return;
+            }
+        }
+
         const size_t realSize = size + sizeof(Holder);
         void* newPtr = mongoRealloc(_holder.get(), realSize);
 
@@ -96,7 +115,50 @@ public:
         return _holder ? _holder->_capacity : 0;
     }
 
+    /**
+     * Frees every allocation held in the calling thread's cache of large buffers. See
+     * isCacheableCapacity().
+     */
+    static void releaseCachedAllocations();
+
+    /**
+     * Sets the most memory that the caches of large buffers may hold across all threads. Buffers
+     * already cached are kept, but no more are cached until the total drops below 'bytes'.
+     */
+    static void setMaxCachedBytes(long long bytes);
+    static long long getMaxCachedBytes();
+
+    static constexpr long long kDefaultMaxCachedBytes = 32 << 20;
+
 private:
+    /**
+     * Large buffers are recycled through a small per-thread cache rather than going back to the
+     * allocator, so that a thread which repeatedly builds large replies does not map, fault in and
+     * unmap fresh memory for each one. Only power-of-two capacities in
+     * [kMinCacheableCapacity, kMaxCacheableCapacity] are cached; BufBuilder grows to exactly such
+     * sizes. Each thread keeps at most one buffer of each capacity, and the process as a whole at
+     * most getMaxCachedBytes().
+     */
+    static constexpr size_t kMinCacheableCapacity = size_t{1} << 15;
+    static constexpr size_t kMaxCacheableCapacity = size_t{1} << 25;
+
+    static bool isCacheableCapacity(size_t capacity) {
+        return capacity >= kMinCacheableCapacity && capacity <= kMaxCacheableCapacity &&
+            (capacity & (capacity - 1)) == 0;
+    }
+
+    /**
+     * Returns a Holder-prefixed allocation of 'capacity' bytes from the calling thread's cache, or
+     * nullptr if there is none. 'capacity' must satisfy isCacheableCapacity().
+     */
+    static void* takeCachedAllocation(size_t capacity);
+
+    /**
+     * Offers a Holder-prefixed allocation of 'capacity' bytes to the calling thread's cache.
+     * Returns false if the cache declined it, in which case the caller must free it.
+     */
+    static bool cacheAllocation(void* holderPrefixedData, size_t capacity);
+
     class Holder {
     public:
         explicit Holder(AtomicUInt32::WordType initial, size_t capacity)
@@ -111,10 +173,7 @@ private:
 
         friend void intrusive_ptr_release(Holder* h) {
             if (h->_refCount.subtractAndFetch(1) == 0) {
-                // We placement new'ed a Holder in takeOwnership above,
-                // so we must destroy the object here.
-                h->~Holder();
-                free(h);
+                destroy(h);
             }
         }
 
@@ -130,6 +189,17 @@ private:
             return _refCount.load() > 1;
         }
 
+        static void destroy(Holder* h) {
+            const size_t capacity = h->_capacity;
+
+            // We placement new'ed a Holder in takeOwnership above,
+            // so we must destroy the object here.
+            h->~Holder();
+            if (!isCacheableCapacity(capacity) || !cacheAllocation(h, capacity)) {
+                free(h);
+            }
+        }
+
         AtomicUInt32 _refCount;
         uint32_t _capacity;
     };
@@ -45,6 +45,15 @@ namespace mongo {
 void printStackTrace(std::ostream& os);
 void printStackTrace();
 
+/**
+ * Stores the return addresses of up to 'maxFrames' frames of the calling thread's stack in
+ * 'addresses', innermost first, and returns how many were stored. Returns 0 where stack traces are
+ * not supported.
+ *
+ * The first call may load the unwinder, after which this is safe to call from a signal handler.
+ */
+int getStackTraceAddresses(void** addresses, int maxFrames);
+
 #if defined(_WIN32)
 // Print stack trace (using a specified stack context) to "os", default to the log stream.
 void printWindowsStackTrace(CONTEXT& context, std::ostream& os);
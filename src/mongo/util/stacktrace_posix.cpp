@@ -132,11 +132,19 @@ int backtrace(void** array, int size) {
 }  // namespace
 
 #if defined(MONGO_NO_BACKTRACE)
+int getStackTraceAddresses(void** addresses, int maxFrames) {
+    return 0;
+}
+
 void printStackTrace(std::ostream& os) {
     os << "This platform does not support printing stacktraces" << std::endl;
 }
 
 #else
+int getStackTraceAddresses(void** addresses, int maxFrames) {
+    return backtrace(addresses, maxFrames);
+}
+
 /**
  * Prints a stack backtrace for the current thread to the specified ostream.
  *
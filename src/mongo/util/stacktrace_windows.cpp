@@ -244,6 +244,10 @@ void printStackTrace(std::ostream& os) {
     printWindowsStackTrace(context, os);
 }
 
+int getStackTraceAddresses(void** addresses, int maxFrames) {
+    return CaptureStackBackTrace(0, maxFrames, addresses, nullptr);
+}
+
 
 /**
  * Print stack trace (using a specified stack context) to "os"
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/unordered_map.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+namespace {
+
+std::vector<std::string> makeKeys(int64_t count, const char* prefix) {
+    std::vector<std::string> keys;
+    for (int64_t i = 0; i < count; ++i) {
+        keys.push_back(std::string(prefix) + std::to_string(i));
+    }
+    return keys;
+}
+
+// Adapters let each benchmark run against both StringMap and stdx::unordered_map.
+struct StringMapAdapter {
+    using Map = StringMap<int>;
+    static bool contains(const Map& map, StringData key) {
+        return map.find(key) != map.end();
+    }
+};
+
+struct UnorderedMapAdapter {
+    using Map = stdx::unordered_map<std::string, int>;
+    static bool contains(const Map& map, StringData key) {
+        return map.find(key.toString()) != map.end();
+    }
+};
+
+template <typename Adapter>
+void BM_insert(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    for (auto _ : state) {
+        typename Adapter::Map map;
+        for (const auto& key : keys) {
+            map[key] = 1;
+        }
+        benchmark::DoNotOptimize(map);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Adapter>
+void BM_findHit(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    typename Adapter::Map map;
+    for (const auto& key : keys) {
+        map[key] = 1;
+    }
+    for (auto _ : state) {
+        for (const auto& key : keys) {
+            benchmark::DoNotOptimize(Adapter::contains(map, key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Adapter>
+void BM_findMiss(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    const auto missingKeys = makeKeys(state.range(0), "other");
+    typename Adapter::Map map;
+    for (const auto& key : keys) {
+        map[key] = 1;
+    }
+    for (auto _ : state) {
+        for (const auto& key : missingKeys) {
+            benchmark::DoNotOptimize(Adapter::contains(map, key));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Adapter>
+void BM_insertErase(benchmark::State& state) {
+    const auto keys = makeKeys(state.range(0), "field");
+    typename Adapter::Map map;
+    for (auto _ : state) {
+        for (const auto& key : keys) {
+            map[key] = 1;
+        }
+        for (const auto& key : keys) {
+            map.erase(key);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The small sizes are typical of the field name sets built by the matcher and projections.
+BENCHMARK_TEMPLATE(BM_insert, StringMapAdapter)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_insert, UnorderedMapAdapter)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_findHit, StringMapAdapter)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_findHit, UnorderedMapAdapter)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_findMiss, StringMapAdapter)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_findMiss, UnorderedMapAdapter)->Arg(8)->Arg(64)->Arg(1024)->Arg(65536);
+BENCHMARK_TEMPLATE(BM_insertErase, StringMapAdapter)->Arg(8)->Arg(64)->Arg(1024);
+BENCHMARK_TEMPLATE(BM_insertErase, UnorderedMapAdapter)->Arg(8)->Arg(64)->Arg(1024);
+
+}  // namespace
+}  // namespace mongo
@@ -157,6 +157,70 @@ TEST(StringMapTest, Erase2) {
     ASSERT_EQUALS(true, m.empty());
 }
 
+TEST(StringMapTest, EraseMany) {
+    StringMap<int> m;
+    char buf[64];
+
+    // Erase most entries, leaving tombstones behind, and check that the remaining entries and
+    // reinserted ones can all be found.
+    for (int i = 0; i < 10000; i++) {
+        sprintf(buf, "foo%d", i);
+        m[buf] = i;
+    }
+    for (int i = 0; i < 10000; i++) {
+        if (i % 10 != 0) {
+            sprintf(buf, "foo%d", i);
+            ASSERT_EQUALS(1U, m.erase(buf));
+        }
+    }
+    ASSERT_EQUALS(1000U, m.size());
+    for (int i = 0; i < 10000; i++) {
+        sprintf(buf, "foo%d", i);
+        ASSERT_EQUALS(i % 10 == 0 ? 1U : 0U, m.count(buf));
+    }
+    for (int i = 0; i < 10000; i++) {
+        sprintf(buf, "bar%d", i);
+        m[buf] = i;
+    }
+    ASSERT_EQUALS(11000U, m.size());
+    for (int i = 0; i < 10000; i++) {
+        sprintf(buf, "bar%d", i);
+        ASSERT_EQUALS(i, m[buf]);
+    }
+}
+
+TEST(StringMapTest, EraseWhileIterating) {
+    StringMap<int> m;
+    char buf[64];
+
+    for (int i = 0; i < 1000; i++) {
+        sprintf(buf, "foo%d", i);
+        m[buf] = i;
+    }
+
+    int numVisited = 0;
+    for (StringMap<int>::const_iterator i = m.begin(); i != m.end(); ++i) {
+        ++numVisited;
+        if (i->second % 2) {
+            m.erase(i);
+        }
+    }
+    ASSERT_EQUALS(1000, numVisited);
+    ASSERT_EQUALS(500U, m.size());
+    for (auto&& entry : m) {
+        ASSERT_EQUALS(0, entry.second % 2);
+    }
+}
+
+TEST(StringMapTest, Move) {
+    StringMap<int> m;
+    m["eliot"] = 5;
+    StringMap<int> y = std::move(m);
+    ASSERT_EQUALS(5, y["eliot"]);
+    ASSERT_EQUALS(0U, m.size());
+    ASSERT(m.find("eliot") == m.end());
+}
+
 TEST(StringMapTest, Iterator1) {
     StringMap<int> m;
     ASSERT(m.begin() == m.end());
@@ -30,6 +30,7 @@
 #include "mongo/platform/basic.h"
 
 #include <cctype>
+#include <cstring>
 
 #include "mongo/util/stringutils.h"
 
@@ -186,10 +187,57 @@ int versionCmp(const StringData rhs, const StringData lhs) {
     return LexNumCmp::cmp(rhs, lhs, false);
 }
 
+namespace {
+
+// Returns a word with the high bit set in each byte of 'word' which equals 'c'.
+uint64_t bytesEqualTo(uint64_t word, char c) {
+    const uint64_t x = word ^ (0x0101010101010101ULL * static_cast<unsigned char>(c));
+    return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+}
+
+// Returns the length of the prefix of 'sd' in which no character needs escaping by escape().
+// Eight characters are tested at a time, so that long runs of plain text are skipped quickly.
+size_t plainPrefixLength(StringData sd, bool escape_slash) {
+    const char* const begin = sd.rawData();
+    const char* const end = begin + sd.size();
+    const char* p = begin;
+
+    while (end - p >= static_cast<ptrdiff_t>(sizeof(uint64_t))) {
+        uint64_t word;
+        memcpy(&word, p, sizeof(word));
+        // Sets the high bit of each byte below 0x20, which are the control characters.
+        const uint64_t control = (word - 0x2020202020202020ULL) & ~word & 0x8080808080808080ULL;
+        uint64_t special = control | bytesEqualTo(word, '"') | bytesEqualTo(word, '\\');
+        if (escape_slash) {
+            special |= bytesEqualTo(word, '/');
+        }
+        if (special) {
+            break;
+        }
+        p += sizeof(uint64_t);
+    }
+
+    for (; p < end; ++p) {
+        const unsigned char c = *p;
+        if (c <= 0x1f || c == '"' || c == '\\' || (escape_slash && c == '/')) {
+            break;
+        }
+    }
+    return p - begin;
+}
+
+}  // namespace
+
 std::string escape(StringData sd, bool escape_slash) {
+    const size_t plainLength = plainPrefixLength(sd, escape_slash);
+    if (plainLength == sd.size()) {
+        return sd.toString();
+    }
+
     StringBuilder ret;
     ret.reset(sd.size());
-    for (const auto& c : sd) {
+    ret << sd.substr(0, plainLength);
+    for (const auto& c : sd.substr(plainLength)) {
         switch (c) {
             case '"':
                 ret << "\\\"";
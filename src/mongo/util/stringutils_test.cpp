@@ -201,6 +201,26 @@ TEST(StringUtilsTest, unsignedFixedLengthHex) {
     ASSERT_EQUALS(unsignedIntToFixedLengthHex(123), std::string("0000007B"));
 }
 
+TEST(StringUtilsTest, EscapeSpecialCharacterAtEveryPosition) {
+    for (size_t pos = 0; pos < 20; ++pos) {
+        std::string plain(20, 'a');
+        std::string quoted = plain;
+        quoted[pos] = '"';
+        ASSERT_EQUALS(escape(quoted), plain.substr(0, pos) + "\\\"" + plain.substr(pos + 1));
+
+        std::string control = plain;
+        control[pos] = '\x01';
+        ASSERT_EQUALS(escape(control), plain.substr(0, pos) + "\\u0001" + plain.substr(pos + 1));
+    }
+}
+
+TEST(StringUtilsTest, EscapeLeavesPlainAndNonAsciiTextUnchanged) {
+    const std::string text = "plain text / with a slash and \xc3\xa9 non-ASCII bytes";
+    ASSERT_EQUALS(escape(text), text);
+    ASSERT_EQUALS(escape("a/b", /*escape_slash*/ true), "a\\/b");
+    ASSERT_EQUALS(escape(""), "");
+}
+
 TEST(StringUtilsTest, CanParseZero) {
     boost::optional<size_t> result = parseUnsignedBase10Integer("0");
     ASSERT(result && *result == 0);
@@ -30,6 +30,7 @@
 
 #include "summation.h"
 
+#include <algorithm>
 #include <cmath>
 
 #include "mongo/util/assert_util.h"
@@ -44,6 +45,34 @@ void DoubleDoubleSummation::addLong(long long x) {
     addDouble(high);
 }
 
+namespace {
+// The number of integers addLongs() sums in integer arithmetic before adding the partial sums to
+// the compensated sum. This keeps the partial sums of the high halves below 2**51 in magnitude, so
+// that they and the partial sums of the low halves convert to double exactly.
+const size_t kMaxLongsPerPartialSum = 1 << 20;
+}  // namespace
+
+void DoubleDoubleSummation::addLongs(const long long* values, size_t count) {
+    while (count > 0) {
+        const size_t n = std::min(count, kMaxLongsPerPartialSum);
+
+        // Split each integer like addLong() does, but sum the high and low halves separately. This
+        // loop has no data dependent branches, so the compiler is free to vectorize it.
+        int64_t highSum = 0;
+        int64_t lowSum = 0;
+        for (size_t i = 0; i < n; ++i) {
+            int64_t high = values[i] / (1ll << 32);
+            highSum += high;
+            lowSum += values[i] - high * (1ll << 32);
+        }
+        addDouble(lowSum);
+        addDouble(static_cast<double>(highSum) * (1ll << 32));
+
+        values += n;
+        count -= n;
+    }
+}
+
 /**
  * Returns whether the sum is in range of the 64-bit signed integer long long type.
  */
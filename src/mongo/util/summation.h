@@ -63,6 +63,12 @@ public:
      */
     void addLong(long long x);
 
+    /**
+     * Adds the 'count' integers starting at 'values' to the sum, with the same exactness as calling
+     * addLong() on each of them, but with far fewer compensated additions.
+     */
+    void addLongs(const long long* values, size_t count);
+
     /**
      * Adds x to internal sum. Adds as double as that is more efficient.
      */
@@ -131,6 +131,47 @@ TEST(Summation, AddLongs) {
     }
 }
 
+TEST(Summation, AddLongsIsExact) {
+    for (auto x : longValues) {
+        for (auto y : longValues) {
+            for (auto z : longValues) {
+                DoubleDoubleSummation sum;
+                uint64_t checkUint64 =
+                    static_cast<uint64_t>(x) + static_cast<uint64_t>(y) + static_cast<uint64_t>(z);
+
+                const long long values[] = {x, y, z};
+                sum.addLongs(values, 3);
+                ASSERT(sum.isInteger());
+
+                if (!sum.fitsLong()) {
+                    ASSERT(std::abs(sum.getDouble()) >= limits::max());
+                    // Reduce sum to fit in a 64-bit integer.
+                    while (!sum.fitsLong()) {
+                        sum.addDouble(sum.getDouble() < 0 ? std::ldexp(1, 64) : -std::ldexp(1, 64));
+                    }
+                }
+                ASSERT_EQUALS(static_cast<uint64_t>(sum.getLong()), checkUint64);
+            }
+        }
+    }
+}
+
+TEST(Summation, AddLongsBeyondOnePartialSum) {
+    std::vector<long long> values((1 << 20) + 3, limits::max());
+    values.push_back(limits::min());
+
+    DoubleDoubleSummation sum;
+    sum.addLongs(values.data(), values.size());
+    ASSERT(!sum.fitsLong());
+
+    // Subtract all but one of the maximums back out.
+    for (size_t i = 0; i < values.size() - 2; ++i) {
+        sum.addLong(-limits::max());
+    }
+    ASSERT(sum.fitsLong());
+    ASSERT_EQUALS(sum.getLong(), -1);
+}
+
 TEST(Summation, AddSpecial) {
     for (auto x : specialValues) {
         DoubleDoubleSummation sum;
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/tcmalloc_auto_tuner.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+TcmallocAutoTuner::TcmallocAutoTuner(Params params) : _params(std::move(params)) {}
+
+TcmallocAutoTuner::Decision TcmallocAutoTuner::observe(const Sample& sample) {
+    Decision decision;
+
+    const bool hadBaseline = _hasBaseline;
+    const std::uint64_t lastSpinlockDelayNanos = _lastSpinlockDelayNanos;
+    _hasBaseline = true;
+    _lastSpinlockDelayNanos = sample.spinlockDelayNanos;
+
+    if (!hadBaseline || sample.elapsed <= Milliseconds(0) || sample.heapBytes == 0)
+        return decision;
+
+    const std::uint64_t delayNanos = sample.spinlockDelayNanos >= lastSpinlockDelayNanos
+        ? sample.spinlockDelayNanos - lastSpinlockDelayNanos
+        : 0;
+    const double contention = delayNanos * 1000.0 / durationCount<Milliseconds>(sample.elapsed);
+    _lastContentionNanosPerSecond = contention;
+
+    // Thread caches are considered full once they are within a tenth of their limit
+    const bool threadCachesFull =
+        sample.threadCacheBytes >= sample.maxThreadCacheBytes - sample.maxThreadCacheBytes / 10;
+
+    if (contention > _params.contentionNanosPerSecond) {
+        _calmPeriods = 0;
+
+        if (threadCachesFull && sample.maxThreadCacheBytes < _params.ceilingBytes) {
+            decision.maxThreadCacheBytes = std::min(
+                _params.ceilingBytes, sample.maxThreadCacheBytes + sample.maxThreadCacheBytes / 4);
+            decision.reason = str::stream() << "spinlock contention of "
+                                            << static_cast<long long>(contention)
+                                            << "ns/s with full thread caches";
+            ++_numGrown;
+        }
+        return decision;
+    }
+
+    if (contention > _params.contentionNanosPerSecond / 4) {
+        _calmPeriods = 0;
+        return decision;
+    }
+
+    if (++_calmPeriods < _params.calmPeriodsBeforeShrink)
+        return decision;
+
+    const std::size_t freeBytes = sample.centralFreeBytes + sample.pageHeapFreeBytes;
+    const double fragmentation = static_cast<double>(freeBytes) / sample.heapBytes;
+    if (fragmentation <= _params.fragmentationRatio)
+        return decision;
+
+    _calmPeriods = 0;
+
+    if (sample.maxThreadCacheBytes > _params.floorBytes) {
+        decision.maxThreadCacheBytes = std::max(
+            _params.floorBytes, sample.maxThreadCacheBytes - sample.maxThreadCacheBytes / 5);
+        ++_numShrunk;
+    }
+
+    const std::size_t retainedBytes =
+        static_cast<std::size_t>(sample.heapBytes * _params.retainedFreeRatio);
+    if (sample.pageHeapFreeBytes > retainedBytes) {
+        decision.bytesToRelease = sample.pageHeapFreeBytes - retainedBytes;
+        ++_numReleases;
+        _totalBytesReleased += decision.bytesToRelease;
+    }
+
+    if (decision.maxThreadCacheBytes || decision.bytesToRelease) {
+        decision.reason = str::stream() << "low contention with "
+                                        << static_cast<int>(fragmentation * 100)
+                                        << "% of the heap free";
+    }
+    return decision;
+}
+
+void TcmallocAutoTuner::reset() {
+    _hasBaseline = false;
+    _calmPeriods = 0;
+}
+
+void TcmallocAutoTuner::appendStats(BSONObjBuilder* builder) const {
+    builder->append("contentionNanosPerSecond",
+                    static_cast<long long>(_lastContentionNanosPerSecond));
+    builder->append("threadCacheGrowths", _numGrown);
+    builder->append("threadCacheShrinks", _numShrunk);
+    builder->append("releases", _numReleases);
+    builder->append("bytesReleased", _totalBytesReleased);
+}
+
+}  // namespace mongo
@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Decides how to adjust tcmalloc's aggregate thread cache size and when to return free memory to
+ * the operating system, from periodic samples of the allocator's statistics.
+ *
+ *  - Time spent spinning on tcmalloc's spinlocks, most of which are the central free list locks,
+ *    rises when thread caches are too small to absorb the allocation churn and keep going to the
+ *    central free lists. If that time grows faster than 'contentionNanosPerSecond' while the
+ *    thread caches are at their limit, the limit is raised by a quarter, up to 'ceilingBytes'.
+ *
+ *  - Once contention has stayed low for 'calmPeriodsBeforeShrink' samples and a large share of
+ *    the heap is free memory which is not handed out (fragmentation), the limit is lowered by a
+ *    fifth, down to 'floorBytes', and page heap memory above 'retainedFreeRatio' of the heap is
+ *    released to the operating system.
+ *
+ * This class only makes decisions; the caller reads the samples and applies them.
+ */
+class TcmallocAutoTuner {
+public:
+    struct Params {
+        std::size_t floorBytes = 0;
+        std::size_t ceilingBytes = 0;
+        double contentionNanosPerSecond = 1000 * 1000;
+        double fragmentationRatio = 0.25;
+        double retainedFreeRatio = 0.10;
+        int calmPeriodsBeforeShrink = 10;
+    };
+
+    /**
+     * The allocator statistics observed by one period.
+     */
+    struct Sample {
+        Milliseconds elapsed{0};                   // time since the previous sample
+        std::uint64_t spinlockDelayNanos = 0;      // cumulative, tcmalloc.spinlock_total_delay_ns
+        std::size_t heapBytes = 0;                 // generic.heap_size
+        std::size_t maxThreadCacheBytes = 0;       // tcmalloc.max_total_thread_cache_bytes
+        std::size_t threadCacheBytes = 0;          // tcmalloc.current_total_thread_cache_bytes
+        std::size_t centralFreeBytes = 0;          // central and transfer cache free bytes
+        std::size_t pageHeapFreeBytes = 0;         // tcmalloc.pageheap_free_bytes
+    };
+
+    struct Decision {
+        std::size_t maxThreadCacheBytes = 0;  // new limit, 0 to leave it unchanged
+        std::size_t bytesToRelease = 0;       // page heap bytes to release, 0 for none
+        std::string reason;
+    };
+
+    explicit TcmallocAutoTuner(Params params);
+
+    /**
+     * Consumes the next sample and returns the adjustment to make, if any. The first sample only
+     * establishes a baseline.
+     */
+    Decision observe(const Sample& sample);
+
+    /**
+     * Forgets the previous sample, for example after tuning was switched off for a while.
+     */
+    void reset();
+
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    const Params _params;
+
+    bool _hasBaseline = false;
+    std::uint64_t _lastSpinlockDelayNanos = 0;
+    int _calmPeriods = 0;
+
+    long long _numGrown = 0;
+    long long _numShrunk = 0;
+    long long _numReleases = 0;
+    long long _totalBytesReleased = 0;
+    double _lastContentionNanosPerSecond = 0;
+};
+
+}  // namespace mongo
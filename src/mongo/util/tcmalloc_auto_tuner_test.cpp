@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/tcmalloc_auto_tuner.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const std::size_t kMB = 1024 * 1024;
+
+TcmallocAutoTuner::Params makeParams() {
+    TcmallocAutoTuner::Params params;
+    params.floorBytes = 64 * kMB;
+    params.ceilingBytes = 256 * kMB;
+    params.contentionNanosPerSecond = 1000 * 1000;
+    params.calmPeriodsBeforeShrink = 3;
+    return params;
+}
+
+TcmallocAutoTuner::Sample makeSample(std::uint64_t spinlockDelayNanos, std::size_t maxThreadCache) {
+    TcmallocAutoTuner::Sample sample;
+    sample.elapsed = Milliseconds(1000);
+    sample.spinlockDelayNanos = spinlockDelayNanos;
+    sample.heapBytes = 1024 * kMB;
+    sample.maxThreadCacheBytes = maxThreadCache;
+    sample.threadCacheBytes = maxThreadCache;
+    sample.centralFreeBytes = 0;
+    sample.pageHeapFreeBytes = 0;
+    return sample;
+}
+
+TEST(TcmallocAutoTunerTest, FirstSampleIsBaseline) {
+    TcmallocAutoTuner tuner(makeParams());
+    auto decision = tuner.observe(makeSample(100 * 1000 * 1000, 128 * kMB));
+    ASSERT_EQ(0u, decision.maxThreadCacheBytes);
+    ASSERT_EQ(0u, decision.bytesToRelease);
+}
+
+TEST(TcmallocAutoTunerTest, GrowsFullThreadCachesUnderContention) {
+    TcmallocAutoTuner tuner(makeParams());
+    tuner.observe(makeSample(0, 128 * kMB));
+
+    auto decision = tuner.observe(makeSample(5 * 1000 * 1000, 128 * kMB));
+    ASSERT_EQ(160 * kMB, decision.maxThreadCacheBytes);
+    ASSERT_FALSE(decision.reason.empty());
+
+    // Capped at the ceiling, and not grown any further once there
+    decision = tuner.observe(makeSample(10 * 1000 * 1000, 240 * kMB));
+    ASSERT_EQ(256 * kMB, decision.maxThreadCacheBytes);
+    decision = tuner.observe(makeSample(15 * 1000 * 1000, 256 * kMB));
+    ASSERT_EQ(0u, decision.maxThreadCacheBytes);
+}
+
+TEST(TcmallocAutoTunerTest, DoesNotGrowThreadCachesWithRoom) {
+    TcmallocAutoTuner tuner(makeParams());
+    tuner.observe(makeSample(0, 128 * kMB));
+
+    auto sample = makeSample(5 * 1000 * 1000, 128 * kMB);
+    sample.threadCacheBytes = 64 * kMB;
+    ASSERT_EQ(0u, tuner.observe(sample).maxThreadCacheBytes);
+}
+
+TEST(TcmallocAutoTunerTest, ShrinksAndReleasesAfterCalmPeriods) {
+    TcmallocAutoTuner tuner(makeParams());
+    tuner.observe(makeSample(0, 160 * kMB));
+
+    auto sample = makeSample(0, 160 * kMB);
+    sample.pageHeapFreeBytes = 400 * kMB;
+
+    ASSERT_EQ(0u, tuner.observe(sample).maxThreadCacheBytes);
+    ASSERT_EQ(0u, tuner.observe(sample).maxThreadCacheBytes);
+
+    auto decision = tuner.observe(sample);
+    ASSERT_EQ(128 * kMB, decision.maxThreadCacheBytes);
+    ASSERT_EQ(400 * kMB - static_cast<std::size_t>(1024 * kMB * 0.10), decision.bytesToRelease);
+
+    // Waits for another calm streak before acting again
+    ASSERT_EQ(0u, tuner.observe(sample).bytesToRelease);
+}
+
+TEST(TcmallocAutoTunerTest, ContentionInterruptsCalmStreak) {
+    TcmallocAutoTuner tuner(makeParams());
+    tuner.observe(makeSample(0, 64 * kMB));
+
+    auto sample = makeSample(0, 64 * kMB);
+    sample.threadCacheBytes = 0;
+    sample.pageHeapFreeBytes = 400 * kMB;
+    tuner.observe(sample);
+    tuner.observe(sample);
+
+    // Moderate contention, below the growth threshold, still resets the streak
+    sample.spinlockDelayNanos = 500 * 1000;
+    ASSERT_EQ(0u, tuner.observe(sample).bytesToRelease);
+
+    tuner.observe(sample);
+    tuner.observe(sample);
+    auto decision = tuner.observe(sample);
+
+    // At the floor already, so only memory is released
+    ASSERT_EQ(0u, decision.maxThreadCacheBytes);
+    ASSERT_GT(decision.bytesToRelease, 0u);
+}
+
+TEST(TcmallocAutoTunerTest, ResetRequiresNewBaseline) {
+    TcmallocAutoTuner tuner(makeParams());
+    tuner.observe(makeSample(0, 128 * kMB));
+    tuner.reset();
+
+    // The delay accumulated while not sampling is not mistaken for contention
+    ASSERT_EQ(0u, tuner.observe(makeSample(50 * 1000 * 1000, 128 * kMB)).maxThreadCacheBytes);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -42,7 +42,12 @@
 #include "mongo/db/service_context.h"
 #include "mongo/transport/service_entry_point.h"
 #include "mongo/transport/thread_idle_callback.h"
+#include "mongo/util/background.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/processinfo.h"
+#include "mongo/util/tcmalloc_auto_tuner.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -57,6 +62,19 @@ stdx::mutex tcmallocCleanupLock;
 
 MONGO_EXPORT_SERVER_PARAMETER(tcmallocEnableMarkThreadTemporarilyIdle, bool, false);
 
+// Lets the auto-tuner adjust tcmalloc.max_total_thread_cache_bytes and release free memory to the
+// operating system, see TcmallocAutoTuner.
+MONGO_EXPORT_SERVER_PARAMETER(tcmallocAutoTuning, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(tcmallocAutoTunerPeriodMillis, int, 1000)
+    ->withValidator([](const int& newVal) {
+        if (newVal <= 0) {
+            return Status(ErrorCodes::BadValue,
+                          "tcmallocAutoTunerPeriodMillis must be greater than 0");
+        }
+        return Status::OK();
+    });
+
 /**
  *  Callback to allow TCMalloc to release freed memory to the central list at
  *  favorable times. Ideally would do some milder cleanup or scavenge...
@@ -98,6 +116,104 @@ MONGO_INITIALIZER(TCMallocThreadIdleListener)(InitializerContext*) {
     return Status::OK();
 }
 
+size_t getNumericProperty(const char* property) {
+    size_t value = 0;
+    MallocExtension::instance()->GetNumericProperty(property, &value);
+    return value;
+}
+
+/**
+ * Samples the allocator every 'tcmallocAutoTunerPeriodMillis' while 'tcmallocAutoTuning' is
+ * enabled, and applies the decisions of a TcmallocAutoTuner.
+ */
+class TcmallocAutoTunerJob : public BackgroundJob {
+public:
+    explicit TcmallocAutoTunerJob(TcmallocAutoTuner::Params params) : _tuner(std::move(params)) {}
+
+    std::string name() const override {
+        return "TcmallocAutoTuner";
+    }
+
+    void run() override {
+        Date_t lastSample = Date_t::now();
+
+        while (!globalInShutdownDeprecated()) {
+            sleepmillis(tcmallocAutoTunerPeriodMillis.load());
+
+            const Date_t now = Date_t::now();
+            const Milliseconds elapsed = now - lastSample;
+            lastSample = now;
+
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+            if (!tcmallocAutoTuning.load()) {
+                _tuner.reset();
+                continue;
+            }
+
+            TcmallocAutoTuner::Sample sample;
+            sample.elapsed = elapsed;
+            sample.spinlockDelayNanos = getNumericProperty("tcmalloc.spinlock_total_delay_ns");
+            sample.heapBytes = getNumericProperty("generic.heap_size");
+            sample.maxThreadCacheBytes =
+                getNumericProperty("tcmalloc.max_total_thread_cache_bytes");
+            sample.threadCacheBytes =
+                getNumericProperty("tcmalloc.current_total_thread_cache_bytes");
+            sample.centralFreeBytes = getNumericProperty("tcmalloc.central_cache_free_bytes") +
+                getNumericProperty("tcmalloc.transfer_cache_free_bytes");
+            sample.pageHeapFreeBytes = getNumericProperty("tcmalloc.pageheap_free_bytes");
+
+            const auto decision = _tuner.observe(sample);
+
+            if (decision.maxThreadCacheBytes) {
+                log() << "tcmalloc auto-tuner changing max_total_thread_cache_bytes from "
+                      << sample.maxThreadCacheBytes << " to " << decision.maxThreadCacheBytes
+                      << ": " << decision.reason;
+                MallocExtension::instance()->SetNumericProperty(
+                    "tcmalloc.max_total_thread_cache_bytes", decision.maxThreadCacheBytes);
+            }
+
+            if (decision.bytesToRelease) {
+                log() << "tcmalloc auto-tuner releasing " << decision.bytesToRelease
+                      << " bytes of free memory to the operating system: " << decision.reason;
+                MallocExtension::instance()->ReleaseToSystem(decision.bytesToRelease);
+            }
+        }
+    }
+
+    void appendStats(BSONObjBuilder* builder) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        builder->append("enabled", tcmallocAutoTuning.load());
+        _tuner.appendStats(builder);
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    TcmallocAutoTuner _tuner;
+};
+
+TcmallocAutoTunerJob* tcmallocAutoTunerJob = nullptr;
+
+// Started once the server has forked, so that the thread belongs to the daemon process
+MONGO_INITIALIZER_GENERAL(StartTcmallocAutoTuner, ("ForkServer"), ("default"))
+(InitializerContext*) {
+    if (RUNNING_ON_VALGRIND)
+        return Status::OK();
+
+    // Let the auto-tuner move the limit between half and four times the configured value, but not
+    // beyond a quarter of the system memory.
+    const size_t configured = getNumericProperty("tcmalloc.max_total_thread_cache_bytes");
+    const size_t systemMemory = ProcessInfo().getMemSizeMB() * 1024 * 1024;
+
+    TcmallocAutoTuner::Params params;
+    params.floorBytes = configured / 2;
+    params.ceilingBytes = std::max(configured, std::min(configured * 4, systemMemory / 4));
+
+    tcmallocAutoTunerJob = new TcmallocAutoTunerJob(std::move(params));
+    tcmallocAutoTunerJob->go();
+    return Status::OK();
+}
+
 class TCMallocServerStatusSection : public ServerStatusSection {
 public:
     TCMallocServerStatusSection() : ServerStatusSection("tcmalloc") {}
@@ -181,6 +297,11 @@ public:
             appendNumericPropertyIfAvailable(
                 sub, "spinlock_total_delay_ns", "tcmalloc.spinlock_total_delay_ns");
 
+            if (tcmallocAutoTunerJob) {
+                BSONObjBuilder autoTuner(sub.subobjStart("autoTuner"));
+                tcmallocAutoTunerJob->appendStats(&autoTuner);
+            }
+
 #if MONGO_HAVE_GPERFTOOLS_SIZE_CLASS_STATS
             if (verbosity >= 2) {
                 // Size class information
@@ -0,0 +1,150 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <benchmark/benchmark.h>
+
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace mongo {
+namespace {
+
+const int kNumThreads = 8;
+const int kTasksPerBatch = 1000;
+
+std::unique_ptr<ThreadPoolInterface> makeThreadPool() {
+    ThreadPool::Options options;
+    options.minThreads = kNumThreads;
+    options.maxThreads = kNumThreads;
+    return stdx::make_unique<ThreadPool>(options);
+}
+
+std::unique_ptr<ThreadPoolInterface> makeWorkStealingThreadPool() {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = kNumThreads;
+    return stdx::make_unique<WorkStealingThreadPool>(options);
+}
+
+/**
+ * Counts down from "count", so that the scheduling thread can wait for a batch of tasks.
+ */
+class Latch {
+public:
+    explicit Latch(int count) : _count(count) {}
+
+    void countDown() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (--_count == 0) {
+            _cv.notify_all();
+        }
+    }
+
+    void wait() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [&] { return _count == 0; });
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    int _count;
+};
+
+/**
+ * Schedules batches of empty tasks from outside the pool and waits for each batch to finish.
+ */
+template <std::unique_ptr<ThreadPoolInterface> (*makePool)()>
+void BM_taskThroughput(benchmark::State& state) {
+    auto pool = makePool();
+    pool->startup();
+    for (auto _ : state) {
+        Latch latch(kTasksPerBatch);
+        for (int i = 0; i < kTasksPerBatch; ++i) {
+            invariant(pool->schedule([&] { latch.countDown(); }));
+        }
+        latch.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * kTasksPerBatch);
+    pool->shutdown();
+    pool->join();
+}
+
+/**
+ * Schedules a batch of tasks which each schedule a child task from inside the pool.
+ */
+template <std::unique_ptr<ThreadPoolInterface> (*makePool)()>
+void BM_nestedTaskThroughput(benchmark::State& state) {
+    auto pool = makePool();
+    pool->startup();
+    for (auto _ : state) {
+        Latch latch(kTasksPerBatch);
+        for (int i = 0; i < kTasksPerBatch / 2; ++i) {
+            invariant(pool->schedule([&] {
+                invariant(pool->schedule([&] { latch.countDown(); }));
+                latch.countDown();
+            }));
+        }
+        latch.wait();
+    }
+    state.SetItemsProcessed(state.iterations() * kTasksPerBatch);
+    pool->shutdown();
+    pool->join();
+}
+
+/**
+ * Schedules one task at a time into an otherwise idle pool and waits for it to run, which measures
+ * the time to hand a task to an idle thread.
+ */
+template <std::unique_ptr<ThreadPoolInterface> (*makePool)()>
+void BM_wakeupLatency(benchmark::State& state) {
+    auto pool = makePool();
+    pool->startup();
+    for (auto _ : state) {
+        Latch latch(1);
+        invariant(pool->schedule([&] { latch.countDown(); }));
+        latch.wait();
+    }
+    pool->shutdown();
+    pool->join();
+}
+
+BENCHMARK_TEMPLATE(BM_taskThroughput, makeThreadPool)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_taskThroughput, makeWorkStealingThreadPool)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_nestedTaskThroughput, makeThreadPool)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_nestedTaskThroughput, makeWorkStealingThreadPool)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_wakeupLatency, makeThreadPool)->UseRealTime();
+BENCHMARK_TEMPLATE(BM_wakeupLatency, makeWorkStealingThreadPool)->UseRealTime();
+
+}  // namespace
+}  // namespace mongo
@@ -35,6 +35,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/unordered_fast_key_table_group.h"
 
 namespace mongo {
 
@@ -70,104 +71,56 @@ public:
     using HashedKey = typename Traits::HashedKey;
 
 private:
-    class Entry {
-    public:
-        Entry() = default;
-
-        Entry(const Entry& other)
-            : _used(other._used), _everUsed(other.everUsed), _curHash(other._curHash) {
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
-            }
-        }
-
-        Entry& operator=(const Entry& other) {
-            if (this == &other) {
-                return *this;
-            }
-
-            if (isUsed()) {
-                unUse();
-            }
-
-            _used = other._used;
-            _everUsed = other._everUsed;
-            _curHash = other._curHash;
-
-            if (other.isUsed()) {
-                new (&_data) value_type(other.getData());
-            }
-
-            return *this;
-        }
-
-        ~Entry() {
-            if (isUsed()) {
-                unUse();
-            }
-        }
+    using Ctrl = unordered_fast_key_table_details::Ctrl;
+    using Group = unordered_fast_key_table_details::Group;
 
+    /**
+     * Storage for one entry. Whether it holds a value is recorded in the Area's control bytes.
+     */
+    struct Slot {
         template <typename... Args>
         void emplaceData(const HashedKey& key, Args&&... args) {
-            dassert(!isUsed());
-            _used = true;
-            _everUsed = true;
-            _curHash = key.hash();
             new (&_data) value_type(std::piecewise_construct,
                                     std::forward_as_tuple(Traits::toStorage(key.key())),
                                     std::forward_as_tuple(std::forward<Args>(args)...));
+            curHash = key.hash();
         }
 
-        bool isUsed() const {
-            return _used;
-        }
-
-        bool wasEverUsed() const {
-            return _everUsed;
-        }
-
-        uint32_t getCurHash() const {
-            dassert(isUsed());
-            return _curHash;
-        }
-
-        void unUse() {
-            dassert(isUsed());
-            _used = false;
-            reinterpret_cast<value_type*>(&_data)->~value_type();
+        void destroyData() {
+            getData().~value_type();
         }
 
         value_type& getData() {
-            dassert(isUsed());
             return *reinterpret_cast<value_type*>(&_data);
         }
 
         const value_type& getData() const {
-            dassert(isUsed());
             return *reinterpret_cast<const value_type*>(&_data);
         }
 
+        uint32_t curHash;
+
     private:
-        bool _used = false;
-        bool _everUsed = false;
-        uint32_t _curHash;
         typename std::aligned_storage<sizeof(value_type),
                                       std::alignment_of<value_type>::value>::type _data;
     };
 
+    /**
+     * An open-addressing table in the style of Abseil's "Swiss tables". Slots are split into
+     * groups of Group::kWidth, whose control bytes are probed at once. A lookup probes groups in
+     * a triangular sequence until it finds a group with an empty slot. Erased slots become
+     * tombstones unless their group already has an empty slot, and tombstones are cleared when
+     * the table is rehashed.
+     */
     struct Area {
         Area() = default;  // TODO constexpr
 
-        Area(unsigned capacity, unsigned maxProbe)
-            : _hashMask(capacity - 1),
-              _maxProbe(maxProbe),
-              _entries(capacity ? new Entry[capacity] : nullptr) {
-            // Capacity must be a power of two or zero. See the comment on _hashMask for why.
-            dassert((capacity & (capacity - 1)) == 0);
-        }
+        explicit Area(unsigned capacity);
+
+        Area(const Area& other);
 
-        Area(const Area& other) : Area(other.capacity(), other._maxProbe) {
-            std::copy(other.begin(), other.end(), begin());
+        Area(Area&& other) noexcept {
+            swap(&other);
         }
 
         Area& operator=(const Area& other) {
@@ -175,42 +128,69 @@ private:
             return *this;
         }
 
-        int find(const HashedKey& key, int* firstEmpty) const;
+        Area& operator=(Area&& other) noexcept {
+            Area(std::move(other)).swap(this);
+            return *this;
+        }
+
+        ~Area();
+
+        /**
+         * Returns the position of "key", or -1 if it is not in the table.
+         */
+        int find(const HashedKey& key) const;
 
-        bool transfer(Area* newArea) const;
+        /**
+         * Returns the first empty or deleted slot on the probe sequence of "hash".
+         */
+        unsigned findInsertPosition(uint32_t hash) const;
+
+        /**
+         * Moves every entry into newArea, which must be empty and large enough to hold them.
+         */
+        void transfer(Area* newArea);
+
+        /**
+         * Destroys the entry at "pos" and marks its slot as free.
+         */
+        void erase(unsigned pos);
 
         void swap(Area* other) {
             using std::swap;
             swap(_hashMask, other->_hashMask);
-            swap(_maxProbe, other->_maxProbe);
-            swap(_entries, other->_entries);
+            swap(_growthLeft, other->_growthLeft);
+            swap(_ctrl, other->_ctrl);
+            swap(_slots, other->_slots);
         }
 
         unsigned capacity() const {
             return _hashMask + 1;
         }
 
-        Entry* begin() {
-            return _entries.get();
-        }
-        Entry* end() {
-            return _entries.get() + capacity();
+        bool isFull(unsigned pos) const {
+            return unordered_fast_key_table_details::isFull(_ctrl[pos]);
         }
 
-        const Entry* begin() const {
-            return _entries.get();
-        }
-        const Entry* end() const {
-            return _entries.get() + capacity();
+        /**
+         * The number of entries an Area with "capacity" slots can hold before it is rehashed. The
+         * table is never more than 7/8 full, so every probe sequence ends at an empty slot.
+         */
+        static unsigned maxLoad(unsigned capacity) {
+            return capacity - capacity / 8;
         }
 
-        // Capacity is always a power of two. This means that the operation (hash % capacity) can be
-        // preformed by (hash & (capacity - 1)). Since we need the mask more than the capacity we
-        // store it directly and derive the capacity from it. The default capacity is 0 so the
-        // default hashMask is -1.
+        // Capacity is always a power of two and a multiple of Group::kWidth. This means that the
+        // operation (hash % capacity) can be preformed by (hash & (capacity - 1)). Since we need
+        // the mask more than the capacity we store it directly and derive the capacity from it.
+        // The default capacity is 0 so the default hashMask is -1.
         unsigned _hashMask = -1;
-        unsigned _maxProbe = 0;
-        std::unique_ptr<Entry[]> _entries = {};
+
+        // The number of empty slots that can still be filled before a rehash. Reusing a deleted
+        // slot does not count against it.
+        unsigned _growthLeft = 0;
+
+        std::unique_ptr<Ctrl[]> _ctrl = {};
+        std::unique_ptr<Slot[]> _slots = {};
     };
 
 public:
@@ -218,6 +198,19 @@ public:
 
     UnorderedFastKeyTable(std::initializer_list<std::pair<key_type, mapped_type>> entries);
 
+    UnorderedFastKeyTable(const UnorderedFastKeyTable&) = default;
+    UnorderedFastKeyTable& operator=(const UnorderedFastKeyTable&) = default;
+
+    // A moved-from table is empty.
+    UnorderedFastKeyTable(UnorderedFastKeyTable&& other) noexcept {
+        swap(other);
+    }
+
+    UnorderedFastKeyTable& operator=(UnorderedFastKeyTable&& other) noexcept {
+        UnorderedFastKeyTable(std::move(other)).swap(*this);
+        return *this;
+    }
+
     /**
      * @return number of elements in map
      */
@@ -263,7 +256,7 @@ public:
     }
 
     template <typename AreaPtr,
-              typename reference = decltype(AreaPtr()->begin()->getData()),
+              typename reference = decltype(AreaPtr()->_slots[0].getData()),
               typename pointer = typename std::add_pointer<reference>::type>
     class iterator_impl
         : public std::
@@ -291,11 +284,11 @@ public:
             : _area(other._area), _position(other._position), _max(other._max) {}
 
         pointer operator->() const {
-            return &_area->_entries[_position].getData();
+            return &_area->_slots[_position].getData();
         }
 
         reference operator*() const {
-            return _area->_entries[_position].getData();
+            return _area->_slots[_position].getData();
         }
 
         iterator_impl& operator++() {
@@ -326,7 +319,7 @@ public:
                     _position = -1;
                     break;
                 }
-                if (_area->_entries[_position].isUsed())
+                if (_area->isFull(_position))
                     break;
                 ++_position;
             }
@@ -348,37 +341,37 @@ public:
     const_iterator find(const K_L& key) const {
         if (empty())
             return end();  // Don't waste time hashing.
-        return const_iterator(&_area, _area.find(HashedKey(key), nullptr));
+        return const_iterator(&_area, _area.find(HashedKey(key)));
     }
 
     const_iterator find(const HashedKey& key) const {
         if (empty())
             return end();
-        return const_iterator(&_area, _area.find(key, nullptr));
+        return const_iterator(&_area, _area.find(key));
     }
 
     iterator find(const K_L& key) {
         if (empty())
             return end();  // Don't waste time hashing.
-        return iterator(&_area, _area.find(HashedKey(key), nullptr));
+        return iterator(&_area, _area.find(HashedKey(key)));
     }
 
     iterator find(const HashedKey& key) {
         if (empty())
             return end();
-        return iterator(&_area, _area.find(key, nullptr));
+        return iterator(&_area, _area.find(key));
     }
 
     size_t count(const K_L& key) const {
         if (empty())
             return 0;  // Don't waste time hashing.
-        return _area.find(HashedKey(key), nullptr) != -1;
+        return _area.find(HashedKey(key)) != -1;
     }
 
     size_t count(const HashedKey& key) const {
         if (empty())
             return 0;
-        return _area.find(key, nullptr) != -1;
+        return _area.find(key) != -1;
     }
 
     const_iterator begin() const {
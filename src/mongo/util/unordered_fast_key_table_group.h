@@ -0,0 +1,190 @@
+/**
+ *    Copyright (C) 2018 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+// TODO replace this with #if BOOST_HW_SIMD_X86 >= BOOST_HW_SIMD_X86_SSE2_VERSION in boost 1.60
+#if defined(_M_AMD64) || defined(__amd64__)
+#include <emmintrin.h>
+#define MONGO_UNORDERED_FAST_KEY_TABLE_SSE2
+#endif
+
+#include "mongo/base/data_type_endian.h"
+#include "mongo/base/data_view.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+namespace unordered_fast_key_table_details {
+
+/**
+ * Each slot of an UnorderedFastKeyTable has a control byte saying whether it is empty, deleted or
+ * full. A full slot's control byte holds 7 bits of the hash of its key, so that most slots can be
+ * rejected without looking at the slot itself.
+ */
+using Ctrl = int8_t;
+
+const Ctrl kEmpty = -128;  // 0b10000000
+const Ctrl kDeleted = -2;  // 0b11111110
+
+inline bool isFull(Ctrl ctrl) {
+    return ctrl >= 0;
+}
+
+/**
+ * The high bits of a hash, which pick the group where probing for a key starts.
+ */
+inline uint32_t H1(uint32_t hash) {
+    return hash >> 7;
+}
+
+/**
+ * The low 7 bits of a hash, which are stored in the control byte of a full slot.
+ */
+inline Ctrl H2(uint32_t hash) {
+    return static_cast<Ctrl>(hash & 0x7F);
+}
+
+/**
+ * The set of slots of a group matching some condition. Slot i of the group is represented by bit
+ * (i << Shift) of the mask.
+ */
+template <int Shift>
+class BitMask {
+public:
+    explicit BitMask(uint64_t mask) : _mask(mask) {}
+
+    explicit operator bool() const {
+        return _mask != 0;
+    }
+
+    /**
+     * Returns the index of the first matching slot. The mask must not be empty.
+     */
+    int lowest() const {
+        return countTrailingZeros64(_mask) >> Shift;
+    }
+
+    void removeLowest() {
+        _mask &= _mask - 1;
+    }
+
+private:
+    uint64_t _mask;
+};
+
+#if defined(MONGO_UNORDERED_FAST_KEY_TABLE_SSE2)
+
+/**
+ * The control bytes of kWidth consecutive slots, which are probed together with SSE2.
+ */
+class Group {
+public:
+    static const unsigned kWidth = 16;
+
+    using Mask = BitMask<0>;
+
+    explicit Group(const Ctrl* ctrl)
+        : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+    /**
+     * Returns the slots whose control byte is "h2".
+     */
+    Mask match(Ctrl h2) const {
+        return Mask(static_cast<uint32_t>(
+            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _ctrl))));
+    }
+
+    Mask matchEmpty() const {
+        return match(kEmpty);
+    }
+
+    /**
+     * Empty and deleted are the only control bytes with the high bit set.
+     */
+    Mask matchEmptyOrDeleted() const {
+        return Mask(static_cast<uint32_t>(_mm_movemask_epi8(_ctrl)));
+    }
+
+private:
+    __m128i _ctrl;
+};
+
+#else
+
+/**
+ * The control bytes of kWidth consecutive slots, which are probed together using bit operations
+ * on a 64-bit word. Byte i of the word holds the control byte of slot i on every platform.
+ */
+class Group {
+public:
+    static const unsigned kWidth = 8;
+
+    using Mask = BitMask<3>;
+
+    explicit Group(const Ctrl* ctrl)
+        : _ctrl(ConstDataView(reinterpret_cast<const char*>(ctrl))
+                    .read<LittleEndian<uint64_t>>()) {}
+
+    /**
+     * Returns the slots whose control byte is "h2". This sets the high bit of exactly the bytes
+     * of "x" which are zero.
+     */
+    Mask match(Ctrl h2) const {
+        const uint64_t x = _ctrl ^ (kLsbs * static_cast<uint8_t>(h2));
+        return Mask(~(((x & kLow7Bits) + kLow7Bits) | x | kLow7Bits));
+    }
+
+    /**
+     * An empty control byte is the only one with its high bit set and its second-lowest bit unset.
+     */
+    Mask matchEmpty() const {
+        return Mask(_ctrl & ~(_ctrl << 6) & kMsbs);
+    }
+
+    /**
+     * Empty and deleted are the only control bytes with the high bit set.
+     */
+    Mask matchEmptyOrDeleted() const {
+        return Mask(_ctrl & kMsbs);
+    }
+
+private:
+    static const uint64_t kLsbs = 0x0101010101010101ULL;
+    static const uint64_t kMsbs = 0x8080808080808080ULL;
+    static const uint64_t kLow7Bits = 0x7F7F7F7F7F7F7F7FULL;
+
+    uint64_t _ctrl;
+};
+
+#endif
+
+}  // namespace unordered_fast_key_table_details
+}  // namespace mongo
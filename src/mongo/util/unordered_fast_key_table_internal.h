@@ -30,65 +30,135 @@
 
 #pragma once
 
+#include <algorithm>
+
 #include "mongo/util/unordered_fast_key_table.h"
 
 namespace mongo {
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKey& key,
-                                                                  int* firstEmpty) const {
-    dassert(capacity());                        // Caller must special-case empty tables.
-    dassert(!firstEmpty || *firstEmpty == -1);  // Caller must initialize *firstEmpty.
-
-    unsigned probe = 0;
-    do {
-        unsigned pos = (key.hash() + probe) & _hashMask;
-
-        if (!_entries[pos].isUsed()) {
-            // space is empty
-            if (firstEmpty && *firstEmpty == -1)
-                *firstEmpty = pos;
-            if (!_entries[pos].wasEverUsed())
-                return -1;
-            continue;
-        }
+inline UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::Area(unsigned capacity)
+    : _hashMask(capacity - 1),
+      _growthLeft(maxLoad(capacity)),
+      _ctrl(new Ctrl[capacity]),
+      _slots(new Slot[capacity]) {
+    // Capacity must be a power of two. See the comment on _hashMask for why.
+    dassert((capacity & (capacity - 1)) == 0);
+    dassert(capacity >= Group::kWidth);
+    std::fill(_ctrl.get(), _ctrl.get() + capacity, unordered_fast_key_table_details::kEmpty);
+}
 
-        if (_entries[pos].getCurHash() != key.hash()) {
-            // space has something else
-            continue;
-        }
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::Area(const Area& other) {
+    if (!other._ctrl)
+        return;
 
-        if (!Traits::equals(key.key(), Traits::toLookup(_entries[pos].getData().first))) {
-            // hashes match
-            // strings are not equals
+    // Slots are only marked full once they are constructed, so that this Area can be destroyed
+    // safely if copying an entry throws.
+    Area copy(other.capacity());
+    for (unsigned pos = 0; pos < other.capacity(); ++pos) {
+        if (!other.isFull(pos))
             continue;
+
+        const Slot& slot = other._slots[pos];
+        new (&copy._slots[pos].getData()) value_type(slot.getData());
+        copy._slots[pos].curHash = slot.curHash;
+        copy._ctrl[pos] = other._ctrl[pos];
+    }
+    std::copy(other._ctrl.get(), other._ctrl.get() + other.capacity(), copy._ctrl.get());
+    copy._growthLeft = other._growthLeft;
+    swap(&copy);
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::~Area() {
+    if (!_ctrl || std::is_trivially_destructible<value_type>::value)
+        return;
+
+    for (unsigned pos = 0; pos < capacity(); ++pos) {
+        if (isFull(pos))
+            _slots[pos].destroyData();
+    }
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline int UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::find(const HashedKey& key) const {
+    dassert(capacity());  // Caller must special-case empty tables.
+
+    using namespace unordered_fast_key_table_details;
+    const unsigned groupMask = _hashMask / Group::kWidth;
+    unsigned group = H1(key.hash()) & groupMask;
+    for (unsigned probe = 1;; ++probe) {
+        const unsigned groupStart = group * Group::kWidth;
+        const Group ctrl(&_ctrl[groupStart]);
+        for (auto match = ctrl.match(H2(key.hash())); match; match.removeLowest()) {
+            const unsigned pos = groupStart + match.lowest();
+            const Slot& slot = _slots[pos];
+            if (slot.curHash == key.hash() &&
+                Traits::equals(key.key(), Traits::toLookup(slot.getData().first))) {
+                return pos;
+            }
         }
 
-        // hashes and strings are equal
-        // yay!
-        return pos;
-    } while (++probe < _maxProbe);
-    return -1;
+        // Inserts fill the first free slot on the probe sequence, so the key would be here.
+        if (ctrl.matchEmpty())
+            return -1;
+
+        // Triangular probing visits every group since the number of groups is a power of two.
+        group = (group + probe) & groupMask;
+    }
+}
+
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline unsigned UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::findInsertPosition(
+    uint32_t hash) const {
+    dassert(capacity());
+
+    using namespace unordered_fast_key_table_details;
+    const unsigned groupMask = _hashMask / Group::kWidth;
+    unsigned group = H1(hash) & groupMask;
+    for (unsigned probe = 1;; ++probe) {
+        const unsigned groupStart = group * Group::kWidth;
+        const auto match = Group(&_ctrl[groupStart]).matchEmptyOrDeleted();
+        if (match)
+            return groupStart + match.lowest();
+
+        group = (group + probe) & groupMask;
+    }
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
-inline bool UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) const {
-    for (auto&& entry : *this) {
-        if (!entry.isUsed())
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::transfer(Area* newArea) {
+    // Entries are moved rather than copied where possible, but are only destroyed along with this
+    // Area, so that a throwing move leaves this Area intact.
+    for (unsigned pos = 0; pos < capacity(); ++pos) {
+        if (!isFull(pos))
             continue;
 
-        int firstEmpty = -1;
-        int loc = newArea->find(
-            HashedKey(Traits::toLookup(entry.getData().first), entry.getCurHash()), &firstEmpty);
+        Slot& slot = _slots[pos];
+        const unsigned newPos = newArea->findInsertPosition(slot.curHash);
+        new (&newArea->_slots[newPos].getData()) value_type(std::move(slot.getData()));
+        newArea->_slots[newPos].curHash = slot.curHash;
+        newArea->_ctrl[newPos] = _ctrl[pos];
+        --newArea->_growthLeft;
+    }
+}
 
-        verify(loc == -1);
-        if (firstEmpty < 0) {
-            return false;
-        }
+template <typename K_L, typename K_S, typename V, typename Traits>
+inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::Area::erase(unsigned pos) {
+    using namespace unordered_fast_key_table_details;
+    dassert(isFull(pos));
+    _slots[pos].destroyData();
 
-        newArea->_entries[firstEmpty] = entry;
+    // A probe only continues past a group with no empty slot, so if this group already has one,
+    // no probe sequence depends on this slot staying occupied and it can become empty again.
+    const unsigned groupStart = pos & ~(Group::kWidth - 1);
+    if (Group(&_ctrl[groupStart]).matchEmpty()) {
+        _ctrl[pos] = kEmpty;
+        ++_growthLeft;
+    } else {
+        _ctrl[pos] = kDeleted;
     }
-    return true;
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -115,13 +185,13 @@ inline size_t UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const HashedKey&
     if (_size == 0)
         return 0;  // Nothing to delete.
 
-    int pos = _area.find(key, nullptr);
+    int pos = _area.find(key);
 
     if (pos < 0)
         return 0;
 
     --_size;
-    _area._entries[pos].unUse();
+    _area.erase(pos);
     return 1;
 }
 
@@ -131,7 +201,7 @@ void UnorderedFastKeyTable<K_L, K_S, V, Traits>::erase(const_iterator it) {
     dassert(it._area == &_area);
 
     --_size;
-    _area._entries[it._position].unUse();
+    _area.erase(it._position);
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
@@ -139,58 +209,50 @@ template <typename... Args>
 inline auto UnorderedFastKeyTable<K_L, K_S, V, Traits>::try_emplace(const HashedKey& key,
                                                                     Args&&... args)
     -> std::pair<iterator, bool> {
-    if (!_area._entries) {
+    if (!_area._ctrl) {
         // This is the first insert ever. Need to allocate initial space.
         dassert(_area.capacity() == 0);
         _grow();
-    }
-
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        int firstEmpty = -1;
-        int pos = _area.find(key, &firstEmpty);
+    } else {
+        int pos = _area.find(key);
         if (pos >= 0) {
-            // This is only possible the first pass through the loop, since you're allocating space
-            // for a new element after that.
-            dassert(numGrowTries == 0);
             return {iterator(&_area, pos), false};
         }
+    }
 
-        // key not in map
-        // need to add
-        if (firstEmpty >= 0) {
-            _size++;
-            _area._entries[firstEmpty].emplaceData(key, std::forward<Args>(args)...);
-            return {iterator(&_area, firstEmpty), true};
-        }
-
-        // no space left in map
+    // key not in map
+    // need to add
+    unsigned pos = _area.findInsertPosition(key.hash());
+    const bool fillsEmptySlot = _area._ctrl[pos] == unordered_fast_key_table_details::kEmpty;
+    if (fillsEmptySlot && _area._growthLeft == 0) {
         _grow();
+        pos = _area.findInsertPosition(key.hash());
+    }
+
+    _area._slots[pos].emplaceData(key, std::forward<Args>(args)...);
+    if (_area._ctrl[pos] == unordered_fast_key_table_details::kEmpty) {
+        --_area._growthLeft;
     }
-    msgasserted(16471, "UnorderedFastKeyTable couldn't add entry after growing many times");
+    _area._ctrl[pos] = unordered_fast_key_table_details::H2(key.hash());
+    _size++;
+    return {iterator(&_area, pos), true};
 }
 
 template <typename K_L, typename K_S, typename V, typename Traits>
 inline void UnorderedFastKeyTable<K_L, K_S, V, Traits>::_grow() {
     unsigned capacity = _area.capacity();
-    for (int numGrowTries = 0; numGrowTries < 5; numGrowTries++) {
-        if (capacity == 0) {
-            const unsigned kDefaultStartingCapacity = 16;
-            capacity = kDefaultStartingCapacity;
-        } else {
-            capacity *= 2;
-        }
-
-        const double kMaxProbeRatio = 0.05;
-        unsigned maxProbes = (capacity * kMaxProbeRatio) + 1;  // Round up
-
-        Area newArea(capacity, maxProbes);
-        bool success = _area.transfer(&newArea);
-        if (!success) {
-            continue;
-        }
-        _area.swap(&newArea);
-        return;
+    if (capacity == 0) {
+        const unsigned kDefaultStartingCapacity = 16;
+        capacity = kDefaultStartingCapacity;
+    } else if (_size >= Area::maxLoad(capacity) / 2) {
+        // Otherwise most of the table is tombstones, and rehashing at the same capacity clears
+        // them.
+        massert(16845, "UnorderedFastKeyTable cannot grow any larger", capacity <= (1U << 30));
+        capacity *= 2;
     }
-    msgasserted(16845, "UnorderedFastKeyTable::_grow couldn't add entry after growing many times");
+
+    Area newArea(capacity);
+    _area.transfer(&newArea);
+    _area.swap(&newArea);
 }
 }